@@ -0,0 +1,22 @@
+'use strict';
+const common = require('../common.js');
+
+const bench = common.createBenchmark(main, {
+  op: ['encode', 'decode'],
+  len: [64, 4096, 1 << 20],
+  n: [64 << 20],
+});
+
+function main({ op, len, n }) {
+  const buffer = Buffer.alloc(len, 'abcdefghijklmnopqrstuvwxyz');
+  const encoded = buffer.toString('base64');
+  const iterations = Math.max(1, Math.floor(n / len));
+
+  bench.start();
+  if (op === 'encode') {
+    for (let i = 0; i < iterations; i++) buffer.toString('base64');
+  } else {
+    for (let i = 0; i < iterations; i++) Buffer.from(encoded, 'base64');
+  }
+  bench.end(iterations);
+}
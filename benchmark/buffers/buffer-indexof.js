@@ -0,0 +1,22 @@
+'use strict';
+const common = require('../common.js');
+
+const bench = common.createBenchmark(main, {
+  needle: ['a', 'the', 'Gryphon', 'found it'],
+  len: [4096, 1 << 20],
+  n: [256 << 20],
+});
+
+function main({ needle, len, n }) {
+  // Text with frequent partial matches, so that the search does more than
+  // scan for the first byte.
+  const text = 'the quick brown fox jumps over the lazy dog, said the Gryphon. ';
+  const haystack = Buffer.from(text.repeat(Math.ceil(len / text.length)))
+    .subarray(0, len - needle.length);
+  const buffer = Buffer.concat([haystack, Buffer.from(needle)]);
+  const iterations = Math.max(1, Math.floor(n / len));
+
+  bench.start();
+  for (let i = 0; i < iterations; i++) buffer.indexOf(needle);
+  bench.end(iterations);
+}
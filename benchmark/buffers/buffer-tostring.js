@@ -0,0 +1,19 @@
+'use strict';
+const common = require('../common.js');
+
+const bench = common.createBenchmark(main, {
+  encoding: ['utf8', 'latin1', 'ascii', 'hex', 'ucs2'],
+  len: [16, 1024, 1 << 20],
+  n: [64 << 20],
+});
+
+function main({ encoding, len, n }) {
+  // Mostly ASCII with some multi-byte characters, as in typical text.
+  const buffer = Buffer.from('Hello, wörld! '.repeat(Math.ceil(len / 15)))
+    .subarray(0, len);
+  const iterations = Math.max(1, Math.floor(n / len));
+
+  bench.start();
+  for (let i = 0; i < iterations; i++) buffer.toString(encoding);
+  bench.end(iterations);
+}
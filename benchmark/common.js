@@ -0,0 +1,222 @@
+'use strict';
+
+// The harness that every benchmark in this directory is written against.
+//
+//   const bench = common.createBenchmark(main, { n: [1e6], len: [16, 1024] });
+//   function main({ n, len }) {
+//     bench.start();
+//     ...
+//     bench.end(n);
+//   }
+//
+// Run on its own, a benchmark runs main() once for each combination of the
+// configuration values, each in its own child process, and prints one line
+// per combination with the number of operations per second. Values can be
+// pinned on the command line, as in `node benchmark/buffers/buffer-base64.js
+// len=1024`. When it is run by compare.js, it reports its results to that
+// instead.
+
+const child_process = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const kRunConfig = 'NODE_RUN_BENCHMARK_FN';
+const buildType = process.features.debug ? 'Debug' : 'Release';
+
+function parseValue(value) {
+  if (/^-?\d+(\.\d+)?(e\d+)?$/.test(value)) return Number(value);
+  if (value === 'true') return true;
+  if (value === 'false') return false;
+  return value;
+}
+
+function parseArgs(argv) {
+  const args = {};
+  for (const arg of argv) {
+    const match = /^([^=]+)=(.*)$/s.exec(arg);
+    if (match === null) throw new Error(`Unexpected argument: ${arg}`);
+    args[match[1]] = parseValue(match[2]);
+  }
+  return args;
+}
+
+function formatConfig(config) {
+  return Object.entries(config)
+    .map(([key, value]) => {
+      return `${key}=${typeof value === 'string' ? JSON.stringify(value) : value}`;
+    })
+    .join(' ');
+}
+
+class Benchmark {
+  constructor(fn, configs, options = {}) {
+    this.name = path.relative(__dirname, require.main.filename)
+      .split(path.sep).join('/');
+    this.options = options;
+    this.configs = configs;
+    this._startTime = null;
+    this._ended = false;
+
+    const args = parseArgs(process.argv.slice(2));
+    if (process.env[kRunConfig] !== undefined) {
+      // This is the child process that runs one combination.
+      this.config = {};
+      for (const key of Object.keys(configs)) {
+        this.config[key] = key in args ? args[key] : configs[key][0];
+      }
+      process.nextTick(() => fn(this.config));
+      return;
+    }
+
+    this.queue = this._queue(args);
+    process.nextTick(() => this._run());
+  }
+
+  // Returns every combination of the configuration values, with the ones
+  // given on the command line pinned.
+  _queue(args) {
+    let queue = [{}];
+    for (const [key, values] of Object.entries(this.configs)) {
+      if (!Array.isArray(values) || values.length === 0) {
+        throw new TypeError(`Configuration ${key} must be a non-empty array`);
+      }
+      const choices = key in args ? [args[key]] : values;
+      const next = [];
+      for (const config of queue) {
+        for (const value of choices) next.push({ ...config, [key]: value });
+      }
+      queue = next;
+    }
+    return queue;
+  }
+
+  async _run() {
+    for (const config of this.queue) {
+      const args = Object.entries(config).map(([key, value]) => {
+        return `${key}=${value}`;
+      });
+      const child = child_process.fork(require.main.filename, args, {
+        env: { ...process.env, [kRunConfig]: '' },
+        execArgv: [...process.execArgv, ...(this.options.flags || [])],
+      });
+      child.on('message', (data) => {
+        if (data.type !== 'report') return;
+        if (process.send) {
+          process.send(data);
+        } else {
+          console.log(`${data.name} ${formatConfig(data.conf)}: ${data.rate}`);
+        }
+      });
+      const code = await new Promise((resolve) => child.on('exit', resolve));
+      if (code !== 0) process.exit(code);
+    }
+  }
+
+  start() {
+    if (this._startTime !== null) {
+      throw new Error('Called start more than once in a single benchmark');
+    }
+    this._startTime = process.hrtime.bigint();
+  }
+
+  end(operations) {
+    if (this._startTime === null) {
+      throw new Error('Called end without start');
+    }
+    const elapsed = process.hrtime.bigint() - this._startTime;
+    if (this._ended) throw new Error('Called end more than once');
+    if (typeof operations !== 'number' || !(operations > 0)) {
+      throw new TypeError('Called end() with an invalid number of operations');
+    }
+    this._ended = true;
+    const seconds = Number(elapsed) / 1e9;
+    this.report(operations / seconds, seconds);
+  }
+
+  // For benchmarks that measure their rate themselves, such as the HTTP ones.
+  report(rate, seconds) {
+    const data = {
+      type: 'report',
+      name: this.name,
+      conf: this.config,
+      rate,
+      time: seconds,
+    };
+    if (process.send) {
+      process.send(data);
+    } else {
+      console.log(`${data.name} ${formatConfig(data.conf)}: ${data.rate}`);
+    }
+  }
+
+  // Puts load on a server of the benchmark's own with http_load, reports its
+  // number of responses per second and calls back with all of its results.
+  // The same http_load should be used for all the binaries being compared,
+  // so one set with HTTP_LOAD takes precedence over the one built with them.
+  http(options, callback) {
+    const args = [
+      `--connections=${options.connections ?? 10}`,
+      `--pipeline=${options.pipeline ?? 1}`,
+      `--duration=${options.duration ?? 5}`,
+      `--method=${options.method ?? 'GET'}`,
+      '--json',
+    ];
+    for (const [name, value] of Object.entries(options.headers ?? {})) {
+      args.push(`--header=${name}: ${value}`);
+    }
+    if (options.body !== undefined) args.push(`--body=${options.body}`);
+    if (options.h2) args.push('--h2');
+    if (options.keepalive === false) args.push('--no-keepalive');
+    args.push(options.url);
+
+    child_process.execFile(httpLoadPath(), args, (err, stdout) => {
+      if (err) throw err;
+      const result = JSON.parse(stdout);
+      this.report(result.rate, result.duration);
+      if (callback) callback(result);
+    });
+  }
+}
+
+function httpLoadPath() {
+  if (process.env.HTTP_LOAD) return process.env.HTTP_LOAD;
+  const name = process.platform === 'win32' ? 'http_load.exe' : 'http_load';
+  const candidates = [
+    path.join(path.dirname(process.execPath), name),
+    path.join(__dirname, '..', 'out', buildType, name),
+  ];
+  const found = candidates.find((file) => fs.existsSync(file));
+  if (found === undefined) {
+    throw new Error('http_load was not found, build it with `make` or ' +
+                    'point HTTP_LOAD at it');
+  }
+  return found;
+}
+
+// Returns a self-signed key and certificate for localhost, made with the
+// openssl command (or OPENSSL) the first time and kept in the temporary
+// directory after that.
+function tlsKeyPair() {
+  const keyFile = path.join(os.tmpdir(), 'node-benchmark-key.pem');
+  const certFile = path.join(os.tmpdir(), 'node-benchmark-cert.pem');
+  if (!fs.existsSync(keyFile) || !fs.existsSync(certFile)) {
+    child_process.execFileSync(process.env.OPENSSL || 'openssl', [
+      'req', '-x509', '-newkey', 'rsa:2048', '-nodes', '-days', '30',
+      '-subj', '/CN=localhost', '-keyout', keyFile, '-out', certFile,
+    ], { stdio: 'ignore' });
+  }
+  return { key: fs.readFileSync(keyFile), cert: fs.readFileSync(certFile) };
+}
+
+function createBenchmark(fn, configs, options) {
+  return new Benchmark(fn, configs, options);
+}
+
+module.exports = {
+  buildType,
+  createBenchmark,
+  formatConfig,
+  parseArgs,
+  tlsKeyPair,
+};
@@ -0,0 +1,226 @@
+'use strict';
+
+// Reads the CSV that compare.js prints and prints, for each benchmark
+// configuration, the mean rate on each binary, and how the other binaries
+// compare with the first one: the relative change, a 95% confidence interval
+// for it, and the p-value of Welch's t-test for the two means being equal.
+//
+//   node benchmark/compare.js --old ./node-old --new ./node-new buffers \
+//     > buffers.csv
+//   node benchmark/compare-report.js < buffers.csv
+//
+// Changes are marked with *, ** or *** when p < 0.05, 0.01 or 0.001. With
+// many configurations some will be marked by chance alone, so a single
+// starred row among many unstarred ones is weak evidence.
+
+const fs = require('fs');
+const readline = require('readline');
+
+function parseCsvLine(line) {
+  const fields = [];
+  const re = /"((?:[^"]|"")*)"|([^,]*)/y;
+  let pos = 0;
+  for (;;) {
+    re.lastIndex = pos;
+    const match = re.exec(line);
+    fields.push(match[1] !== undefined ? match[1].replace(/""/g, '"') :
+      match[2]);
+    pos = re.lastIndex;
+    if (pos >= line.length || line[pos] !== ',') break;
+    pos++;
+  }
+  return fields;
+}
+
+// Continued fraction for the regularized incomplete beta function, from
+// Numerical Recipes.
+function betacf(a, b, x) {
+  const kEpsilon = 1e-14;
+  const kTiny = 1e-300;
+  let c = 1;
+  let d = 1 - (a + b) * x / (a + 1);
+  if (Math.abs(d) < kTiny) d = kTiny;
+  d = 1 / d;
+  let h = d;
+  for (let m = 1; m <= 300; m++) {
+    const m2 = 2 * m;
+    let aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+    d = 1 + aa * d;
+    if (Math.abs(d) < kTiny) d = kTiny;
+    c = 1 + aa / c;
+    if (Math.abs(c) < kTiny) c = kTiny;
+    d = 1 / d;
+    h *= d * c;
+    aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+    d = 1 + aa * d;
+    if (Math.abs(d) < kTiny) d = kTiny;
+    c = 1 + aa / c;
+    if (Math.abs(c) < kTiny) c = kTiny;
+    d = 1 / d;
+    const delta = d * c;
+    h *= delta;
+    if (Math.abs(delta - 1) < kEpsilon) break;
+  }
+  return h;
+}
+
+function logGamma(x) {
+  // Lanczos approximation, g = 7.
+  const g = [
+    0.99999999999980993, 676.5203681218851, -1259.1392167224028,
+    771.32342877765313, -176.61502916214059, 12.507343278686905,
+    -0.13857109526572012, 9.9843695780195716e-6, 1.5056327351493116e-7,
+  ];
+  if (x < 0.5) {
+    return Math.log(Math.PI / Math.sin(Math.PI * x)) - logGamma(1 - x);
+  }
+  x -= 1;
+  let sum = g[0];
+  for (let i = 1; i < 9; i++) sum += g[i] / (x + i);
+  const t = x + 7.5;
+  return 0.5 * Math.log(2 * Math.PI) + (x + 0.5) * Math.log(t) - t +
+    Math.log(sum);
+}
+
+function incompleteBeta(a, b, x) {
+  if (x <= 0) return 0;
+  if (x >= 1) return 1;
+  const front = Math.exp(logGamma(a + b) - logGamma(a) - logGamma(b) +
+    a * Math.log(x) + b * Math.log(1 - x));
+  if (x < (a + 1) / (a + b + 2)) return front * betacf(a, b, x) / a;
+  return 1 - front * betacf(b, a, 1 - x) / b;
+}
+
+// Two-sided p-value of Student's t distribution with df degrees of freedom.
+function tPValue(t, df) {
+  return incompleteBeta(df / 2, 0.5, df / (df + t * t));
+}
+
+// The t value with a two-sided p-value of p, by bisection.
+function tQuantile(p, df) {
+  let low = 0;
+  let high = 1e3;
+  for (let i = 0; i < 100; i++) {
+    const mid = (low + high) / 2;
+    if (tPValue(mid, df) > p) low = mid;
+    else high = mid;
+  }
+  return (low + high) / 2;
+}
+
+function summarize(values) {
+  const n = values.length;
+  const mean = values.reduce((a, b) => a + b, 0) / n;
+  const variance = n < 2 ? 0 :
+    values.reduce((a, b) => a + (b - mean) ** 2, 0) / (n - 1);
+  return { n, mean, variance };
+}
+
+function welch(base, other) {
+  const seBase = base.variance / base.n;
+  const seOther = other.variance / other.n;
+  const se = Math.sqrt(seBase + seOther);
+  if (base.n < 2 || other.n < 2 || se === 0) return null;
+  const df = (seBase + seOther) ** 2 /
+    (seBase ** 2 / (base.n - 1) + seOther ** 2 / (other.n - 1));
+  const diff = other.mean - base.mean;
+  const margin = tQuantile(0.05, df) * se;
+  return {
+    p: tPValue(diff / se, df),
+    low: (diff - margin) / base.mean,
+    high: (diff + margin) / base.mean,
+  };
+}
+
+function formatPercent(fraction) {
+  const sign = fraction >= 0 ? '+' : '';
+  return `${sign}${(fraction * 100).toFixed(2)}%`;
+}
+
+function stars(p) {
+  if (p < 0.001) return '***';
+  if (p < 0.01) return '**';
+  if (p < 0.05) return '*';
+  return '';
+}
+
+function formatRate(rate) {
+  return rate >= 100 ? rate.toFixed(0) : rate.toPrecision(3);
+}
+
+function printTable(rows) {
+  const widths = rows[0].map((_, i) => {
+    return Math.max(...rows.map((row) => row[i].length));
+  });
+  for (const row of rows) {
+    console.log(row.map((cell, i) => {
+      // Left-align the benchmark column, right-align the numbers.
+      return i === 0 ? cell.padEnd(widths[i]) : cell.padStart(widths[i]);
+    }).join('  ').trimEnd());
+  }
+}
+
+async function main() {
+  const input = process.argv[2] ?
+    fs.createReadStream(process.argv[2]) : process.stdin;
+  const lines = readline.createInterface({ input, crlfDelay: Infinity });
+  const binaries = [];
+  // Keyed by "filename configuration", in the order first seen.
+  const results = new Map();
+  let header = null;
+  for await (const line of lines) {
+    if (line.trim() === '') continue;
+    const fields = parseCsvLine(line);
+    if (header === null) {
+      header = fields;
+      continue;
+    }
+    const row = Object.fromEntries(header.map((name, i) => [name, fields[i]]));
+    if (!binaries.includes(row.binary)) binaries.push(row.binary);
+    const key = `${row.filename} ${row.configuration}`;
+    if (!results.has(key)) results.set(key, new Map());
+    const byBinary = results.get(key);
+    if (!byBinary.has(row.binary)) byBinary.set(row.binary, []);
+    byBinary.get(row.binary).push(Number(row.rate));
+  }
+  if (binaries.length === 0) {
+    process.stderr.write('No results to report\n');
+    process.exit(1);
+  }
+
+  const [base, ...others] = binaries;
+  const heading = ['', ...binaries];
+  for (const other of others) {
+    heading.push(`${other} vs ${base}`, '95% CI', 'p');
+  }
+  const rows = [heading];
+  for (const [key, byBinary] of results) {
+    const row = [key];
+    const stats = binaries.map((binary) => {
+      return byBinary.has(binary) ? summarize(byBinary.get(binary)) : null;
+    });
+    for (const stat of stats) row.push(stat ? formatRate(stat.mean) : '-');
+    for (let i = 1; i < binaries.length; i++) {
+      const test = stats[0] && stats[i] ? welch(stats[0], stats[i]) : null;
+      if (test === null) {
+        row.push('-', '-', '-');
+        continue;
+      }
+      const change = (stats[i].mean - stats[0].mean) / stats[0].mean;
+      row.push(
+        `${formatPercent(change)} ${stars(test.p)}`.trimEnd(),
+        `[${formatPercent(test.low)}, ${formatPercent(test.high)}]`,
+        test.p < 0.001 ? '<0.001' : test.p.toFixed(3),
+      );
+    }
+    rows.push(row);
+  }
+  printTable(rows);
+  const runs = Math.min(...[...results.values()].flatMap((byBinary) => {
+    return [...byBinary.values()].map((values) => values.length);
+  }));
+  console.log(`\nRates are operations per second, means of at least ${runs} ` +
+              'runs; * p < 0.05, ** p < 0.01, *** p < 0.001 (Welch\'s t-test).');
+}
+
+main();
@@ -0,0 +1,176 @@
+'use strict';
+
+// Runs benchmarks against several node binaries and prints the results as
+// CSV, for compare-report.js (or compare.R) to turn into a table:
+//
+//   node benchmark/compare.js --bin sse2=./node-sse2 --bin 3dnow=./node-3dnow \
+//     buffers zlib | node benchmark/compare-report.js
+//
+// `--old a --new b` is short for `--bin old=a --bin new=b`. Every run of a
+// benchmark file runs all its configurations on every binary, with the
+// binaries in a new random order each run so that drift in the machine's
+// state does not favour one of them.
+
+const { fork } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const { formatConfig } = require('./common.js');
+
+const usage = `usage: node benchmark/compare.js [options] <category>...
+
+  --bin <name>=<path>   a binary to benchmark, can be repeated
+  --old <path>          same as --bin old=<path>
+  --new <path>          same as --bin new=<path>
+  --runs <n>            number of runs of each file (default: 30)
+  --filter <string>     only run files whose name contains the string
+  --set <key>=<value>   pin a configuration value, can be repeated
+  --help                print this message
+`;
+
+function parseCommandLine(argv) {
+  const options = { binaries: [], runs: 30, filters: [], set: [], dirs: [] };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = () => {
+      if (i + 1 === argv.length) throw new Error(`Missing value for ${arg}`);
+      return argv[++i];
+    };
+    switch (arg) {
+      case '--bin': {
+        const spec = value();
+        const eq = spec.indexOf('=');
+        if (eq <= 0) throw new Error(`Expected --bin name=path, got ${spec}`);
+        options.binaries.push({
+          name: spec.slice(0, eq),
+          path: spec.slice(eq + 1),
+        });
+        break;
+      }
+      case '--old':
+      case '--new':
+        options.binaries.push({ name: arg.slice(2), path: value() });
+        break;
+      case '--runs':
+        options.runs = Number(value());
+        if (!Number.isInteger(options.runs) || options.runs < 1) {
+          throw new Error('--runs must be a positive integer');
+        }
+        break;
+      case '--filter':
+        options.filters.push(value());
+        break;
+      case '--set':
+        options.set.push(value());
+        break;
+      case '--help':
+        process.stdout.write(usage);
+        process.exit(0);
+        break;
+      default:
+        if (arg.startsWith('--')) throw new Error(`Unknown option ${arg}`);
+        options.dirs.push(arg);
+    }
+  }
+  if (options.binaries.length < 2) {
+    throw new Error('At least two binaries are needed to compare');
+  }
+  const names = new Set(options.binaries.map((binary) => binary.name));
+  if (names.size !== options.binaries.length) {
+    throw new Error('Binary names must be unique');
+  }
+  if (options.dirs.length === 0) throw new Error('No categories given');
+  return options;
+}
+
+function listBenchmarks(dirs, filters) {
+  const files = [];
+  for (const dir of dirs) {
+    const full = path.resolve(__dirname, dir);
+    const names = fs.statSync(full).isDirectory() ?
+      fs.readdirSync(full).filter((name) => name.endsWith('.js')).sort() :
+      [path.basename(full)];
+    const base = fs.statSync(full).isDirectory() ? full : path.dirname(full);
+    for (const name of names) {
+      const file = path.relative(__dirname, path.join(base, name))
+        .split(path.sep).join('/');
+      if (filters.length === 0 || filters.some((f) => file.includes(f))) {
+        files.push(file);
+      }
+    }
+  }
+  return files;
+}
+
+function shuffle(array) {
+  for (let i = array.length - 1; i > 0; i--) {
+    const j = Math.floor(Math.random() * (i + 1));
+    [array[i], array[j]] = [array[j], array[i]];
+  }
+  return array;
+}
+
+function csvQuote(value) {
+  return `"${String(value).replace(/"/g, '""')}"`;
+}
+
+function runOnce(binary, file, set, output) {
+  return new Promise((resolve, reject) => {
+    const child = fork(path.join(__dirname, file), set, {
+      execPath: path.resolve(binary.path),
+      stdio: ['ignore', 'inherit', 'inherit', 'ipc'],
+    });
+    child.on('message', (data) => {
+      if (data.type !== 'report') return;
+      output.push([
+        binary.name,
+        file,
+        formatConfig(data.conf),
+        data.rate.toFixed(6),
+        data.time.toFixed(6),
+      ].map(csvQuote).join(','));
+    });
+    child.on('error', reject);
+    child.on('exit', (code, signal) => {
+      if (code === 0) return resolve();
+      reject(new Error(`${file} failed on ${binary.name} ` +
+                       `(${signal || `exit code ${code}`})`));
+    });
+  });
+}
+
+async function main() {
+  let options;
+  try {
+    options = parseCommandLine(process.argv.slice(2));
+  } catch (err) {
+    process.stderr.write(`${err.message}\n\n${usage}`);
+    process.exit(1);
+  }
+  for (const binary of options.binaries) {
+    fs.accessSync(binary.path, fs.constants.X_OK);
+  }
+  const files = listBenchmarks(options.dirs, options.filters);
+  const total = files.length * options.runs * options.binaries.length;
+  let done = 0;
+
+  console.log('"binary","filename","configuration","rate","time"');
+  for (const file of files) {
+    for (let run = 0; run < options.runs; run++) {
+      // Print the results in the order of the command line, so that the
+      // report compares with the first binary given.
+      const output = options.binaries.map(() => []);
+      for (const binary of shuffle([...options.binaries])) {
+        process.stderr.write(`[${++done}/${total}] ${file} ` +
+                             `run ${run + 1} on ${binary.name}\n`);
+        const index = options.binaries.indexOf(binary);
+        await runOnce(binary, file, options.set, output[index]);
+      }
+      for (const line of output.flat()) console.log(line);
+    }
+  }
+}
+
+main().catch((err) => {
+  process.stderr.write(`${err.message}\n`);
+  process.exit(1);
+});
@@ -0,0 +1,27 @@
+'use strict';
+const common = require('../common.js');
+const crypto = require('crypto');
+
+const bench = common.createBenchmark(main, {
+  cipher: ['aes-128-gcm', 'aes-256-cbc', 'chacha20-poly1305'],
+  len: [1024, 1 << 20],
+  n: [256 << 20],
+});
+
+function main({ cipher, len, n }) {
+  const keyLength = cipher.startsWith('aes-128') ? 16 : 32;
+  const ivLength = cipher === 'aes-256-cbc' ? 16 : 12;
+  const key = crypto.randomBytes(keyLength);
+  const iv = crypto.randomBytes(ivLength);
+  const options = cipher === 'chacha20-poly1305' ? { authTagLength: 16 } : {};
+  const data = Buffer.alloc(len, 'x');
+  const iterations = Math.max(1, Math.floor(n / len));
+
+  bench.start();
+  for (let i = 0; i < iterations; i++) {
+    const c = crypto.createCipheriv(cipher, key, iv, options);
+    c.update(data);
+    c.final();
+  }
+  bench.end(iterations);
+}
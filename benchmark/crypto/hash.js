@@ -0,0 +1,20 @@
+'use strict';
+const common = require('../common.js');
+const crypto = require('crypto');
+
+const bench = common.createBenchmark(main, {
+  algorithm: ['md5', 'sha1', 'sha256', 'sha512'],
+  len: [64, 4096, 1 << 20],
+  n: [256 << 20],
+});
+
+function main({ algorithm, len, n }) {
+  const data = Buffer.alloc(len, 'x');
+  const iterations = Math.max(1, Math.floor(n / len));
+
+  bench.start();
+  for (let i = 0; i < iterations; i++) {
+    crypto.createHash(algorithm).update(data).digest();
+  }
+  bench.end(iterations);
+}
@@ -0,0 +1,47 @@
+'use strict';
+const common = require('../common.js');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const bench = common.createBenchmark(main, {
+  api: ['sync', 'callback', 'promises'],
+  encoding: ['buffer', 'utf8'],
+  len: [1024, 1 << 20],
+  n: [2000],
+});
+
+function main({ api, encoding, len, n }) {
+  const filename = path.join(os.tmpdir(), `.node-bench-readfile-${process.pid}`);
+  fs.writeFileSync(filename, 'x'.repeat(len));
+  process.on('exit', () => fs.rmSync(filename, { force: true }));
+  const options = encoding === 'buffer' ? {} : { encoding };
+
+  if (api === 'sync') {
+    bench.start();
+    for (let i = 0; i < n; i++) fs.readFileSync(filename, options);
+    bench.end(n);
+    return;
+  }
+
+  // Keep a few reads in flight, as a server would.
+  const concurrency = 4;
+  let started = 0;
+  let finished = 0;
+  const read = api === 'callback' ?
+    (done) => fs.readFile(filename, options, done) :
+    (done) => fs.promises.readFile(filename, options).then(
+      (data) => done(null, data), done);
+  function next(err) {
+    if (err) throw err;
+    if (++finished === n) return bench.end(n);
+    if (started < n) {
+      started++;
+      read(next);
+    }
+  }
+  // The first call to next() only starts the reads.
+  finished = -concurrency;
+  bench.start();
+  for (let i = 0; i < concurrency; i++) next(null);
+}
@@ -0,0 +1,33 @@
+'use strict';
+const common = require('../common.js');
+const http = require('http');
+
+const bench = common.createBenchmark(main, {
+  len: [64, 16 << 10],
+  connections: [10, 100],
+  mode: ['keepalive', 'pipeline', 'close'],
+  duration: [5],
+});
+
+// Puts http_load on the server: one request at a time over each keep-alive
+// connection, ten pipelined ones, or a new connection for every request.
+function main({ len, connections, mode, duration }) {
+  const body = Buffer.alloc(len, 'x');
+  const server = http.createServer((req, res) => {
+    res.writeHead(200, {
+      'Content-Type': 'text/plain',
+      'Content-Length': body.length,
+    });
+    res.end(body);
+  });
+
+  server.listen(0, '127.0.0.1', () => {
+    bench.http({
+      url: `http://127.0.0.1:${server.address().port}/`,
+      connections,
+      pipeline: mode === 'pipeline' ? 10 : 1,
+      keepalive: mode !== 'close',
+      duration,
+    }, () => server.close());
+  });
+}
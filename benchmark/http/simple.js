@@ -0,0 +1,63 @@
+'use strict';
+const common = require('../common.js');
+const http = require('http');
+
+const bench = common.createBenchmark(main, {
+  type: ['buffer', 'string', 'chunked'],
+  len: [64, 16 << 10],
+  connections: [1, 50],
+  duration: [5],
+});
+
+// Serves requests over keep-alive connections from an in-process client,
+// and reports the number of responses per second, so that no load generator
+// has to be installed on the machines being compared.
+function main({ type, len, connections, duration }) {
+  const body = 'x'.repeat(len);
+  const bufferBody = Buffer.from(body);
+  const server = http.createServer((req, res) => {
+    if (type === 'chunked') {
+      res.writeHead(200, { 'Content-Type': 'text/plain' });
+      res.write(body.slice(0, len >> 1));
+      res.end(body.slice(len >> 1));
+      return;
+    }
+    const data = type === 'buffer' ? bufferBody : body;
+    res.writeHead(200, {
+      'Content-Type': 'text/plain',
+      'Content-Length': Buffer.byteLength(data),
+    });
+    res.end(data);
+  });
+
+  server.listen(0, '127.0.0.1', () => {
+    const agent = new http.Agent({ keepAlive: true, maxSockets: connections });
+    const { port } = server.address();
+    let responses = 0;
+    let running = connections;
+
+    function request() {
+      http.get({ host: '127.0.0.1', port, path: '/', agent }, (res) => {
+        res.resume();
+        res.on('end', () => {
+          responses++;
+          if (stopped === false) return request();
+          // Let the requests in flight finish before closing the sockets.
+          if (--running === 0) {
+            agent.destroy();
+            server.close();
+          }
+        });
+      });
+    }
+
+    let stopped = false;
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < connections; i++) request();
+    setTimeout(() => {
+      stopped = true;
+      const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+      bench.report(responses / seconds, seconds);
+    }, duration * 1000);
+  });
+}
@@ -0,0 +1,40 @@
+'use strict';
+const common = require('../common.js');
+const http2 = require('http2');
+
+const bench = common.createBenchmark(main, {
+  len: [64, 16 << 10],
+  connections: [1, 10],
+  streams: [1, 100],
+  secure: [false, true],
+  duration: [5],
+});
+
+// Keeps `streams` concurrent requests open on each HTTP/2 session, over TLS
+// or in the clear.
+function main({ len, connections, streams, secure, duration }) {
+  const body = Buffer.alloc(len, 'x');
+  const onStream = (stream) => {
+    stream.respond({
+      ':status': 200,
+      'content-type': 'text/plain',
+      'content-length': body.length,
+    });
+    stream.end(body);
+  };
+  const server = secure ?
+    http2.createSecureServer(common.tlsKeyPair()) :
+    http2.createServer();
+  server.on('stream', onStream);
+
+  server.listen(0, '127.0.0.1', () => {
+    const scheme = secure ? 'https' : 'http';
+    bench.http({
+      url: `${scheme}://127.0.0.1:${server.address().port}/`,
+      connections,
+      pipeline: streams,
+      h2: true,
+      duration,
+    }, () => server.close());
+  });
+}
@@ -0,0 +1,906 @@
+// A load generator for HTTP servers, so that the throughput of http.Server,
+// https.Server and the HTTP/2 server can be measured on machines that wrk and
+// autocannon do not run on. It is built from the libuv, llhttp, nghttp2 and
+// OpenSSL that node itself uses:
+//
+//   out/Release/http_load [--connections=<n>] [--pipeline=<n>]
+//                         [--duration=<seconds>] [--method=<method>]
+//                         [--header=<name: value>]... [--body=<string>]
+//                         [--h2] [--no-keepalive] [--json] <url>
+//
+// Each of the connections keeps --pipeline requests in flight: pipelined
+// HTTP/1.1 requests that are written together, or concurrent streams with
+// --h2. Without keep-alive, every request is made on a new connection. The
+// url can be http:// or https://; --h2 over http:// assumes that the server
+// speaks HTTP/2 without an upgrade, and over https:// requires the server to
+// select it with ALPN. Certificates are not verified.
+//
+// The report has the number of responses per second, the bytes read per
+// second and the distribution of the time from writing a request to the end
+// of its response. With --json, it is a single JSON object instead, which is
+// what benchmark/common.js reads.
+
+#include "hdr/hdr_histogram.h"
+#include "llhttp.h"
+#include "nghttp2/nghttp2.h"
+#include "uv.h"
+
+#if HAVE_OPENSSL
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Options {
+  std::string url;
+  size_t connections = 10;
+  size_t pipeline = 1;
+  double duration = 10;
+  std::string method = "GET";
+  std::vector<std::pair<std::string, std::string>> headers;
+  std::string body;
+  bool h2 = false;
+  bool keepalive = true;
+  bool json = false;
+};
+
+struct Target {
+  bool tls = false;
+  std::string host;
+  std::string authority;
+  std::string path;
+  int port = 0;
+  sockaddr_storage address;
+};
+
+struct Stats {
+  uint64_t responses = 0;
+  uint64_t non_2xx = 0;
+  uint64_t bytes = 0;
+  uint64_t connect_errors = 0;
+  uint64_t read_errors = 0;
+  uint64_t write_errors = 0;
+  uint64_t timeouts = 0;
+  hdr_histogram* latency = nullptr;  // In microseconds.
+};
+
+Options options;
+Target target;
+Stats stats;
+uv_loop_t* loop;
+bool stopped = false;
+uint64_t start_time;
+uint64_t end_time;
+
+// The requests are the same for every connection, so they are put together
+// once before the first one is sent.
+std::string http1_request;
+std::vector<nghttp2_nv> http2_headers;
+std::vector<std::pair<std::string, std::string>> http2_header_strings;
+
+#if HAVE_OPENSSL
+SSL_CTX* ssl_ctx = nullptr;
+#endif
+
+constexpr uint64_t kRetryDelayMs = 100;
+constexpr int32_t kHttp2WindowSize = 16 << 20;
+
+void RecordResponse(int status, uint64_t start) {
+  stats.responses++;
+  if (status < 200 || status > 299) stats.non_2xx++;
+  const int64_t micros = static_cast<int64_t>((uv_hrtime() - start) / 1000);
+  hdr_record_value(stats.latency, std::max<int64_t>(micros, 1));
+}
+
+class Connection {
+ public:
+  Connection() {
+    uv_timer_init(loop, &retry_timer_);
+    retry_timer_.data = this;
+    llhttp_settings_init(&http1_settings_);
+    http1_settings_.on_headers_complete = OnHeadersComplete;
+    http1_settings_.on_message_complete = OnMessageComplete;
+  }
+
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+
+  void Connect() {
+    uv_tcp_init(loop, &tcp_);
+    tcp_.data = this;
+    open_ = true;
+    uv_tcp_nodelay(&tcp_, 1);
+    connect_req_.data = this;
+    int err = uv_tcp_connect(&connect_req_,
+                             &tcp_,
+                             reinterpret_cast<sockaddr*>(&target.address),
+                             OnConnect);
+    if (err != 0) {
+      stats.connect_errors++;
+      Close(true);
+    }
+  }
+
+  // Closes the connection and all of its handles for good.
+  void Stop() {
+    uv_close(reinterpret_cast<uv_handle_t*>(&retry_timer_), nullptr);
+    Close(false);
+  }
+
+ private:
+  struct WriteReq {
+    uv_write_t req;
+    std::string data;
+  };
+
+  struct Http2Stream {
+    uint64_t start;
+    size_t body_offset;
+    int status;
+  };
+
+  static void OnConnect(uv_connect_t* req, int status) {
+    Connection* conn = static_cast<Connection*>(req->data);
+    if (status < 0) {
+      if (status != UV_ECANCELED) stats.connect_errors++;
+      conn->Close(true);
+      return;
+    }
+    uv_read_start(
+        reinterpret_cast<uv_stream_t*>(&conn->tcp_), OnAlloc, OnRead);
+#if HAVE_OPENSSL
+    if (target.tls) {
+      conn->StartTls();
+      return;
+    }
+#endif
+    conn->Start();
+  }
+
+  static void OnAlloc(uv_handle_t*, size_t, uv_buf_t* buf) {
+    // Reads are handled before the next one is made, so they can all share
+    // one buffer.
+    static char buffer[64 * 1024];
+    *buf = uv_buf_init(buffer, sizeof(buffer));
+  }
+
+  static void OnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    Connection* conn = static_cast<Connection*>(stream->data);
+    if (nread == 0) return;
+    if (nread < 0) {
+      conn->OnEnd(nread);
+      return;
+    }
+    stats.bytes += nread;
+#if HAVE_OPENSSL
+    if (conn->ssl_ != nullptr) {
+      conn->OnTlsData(buf->base, nread);
+      return;
+    }
+#endif
+    conn->OnData(buf->base, nread);
+  }
+
+  static void OnWrite(uv_write_t* req, int status) {
+    WriteReq* write = reinterpret_cast<WriteReq*>(req);
+    if (status < 0 && status != UV_ECANCELED && !stopped) {
+      stats.write_errors++;
+    }
+    delete write;
+  }
+
+  static void OnClose(uv_handle_t* handle) {
+    Connection* conn = static_cast<Connection*>(handle->data);
+    conn->open_ = false;
+    conn->Reset();
+    if (stopped) return;
+    if (conn->retry_) {
+      // Do not retry in a tight loop when the server is not there.
+      uv_timer_start(&conn->retry_timer_, OnRetry, kRetryDelayMs, 0);
+    } else {
+      conn->Connect();
+    }
+  }
+
+  static void OnRetry(uv_timer_t* timer) {
+    static_cast<Connection*>(timer->data)->Connect();
+  }
+
+  void Close(bool retry) {
+    if (!open_ || closing_) return;
+    closing_ = true;
+    retry_ = retry;
+    uv_close(reinterpret_cast<uv_handle_t*>(&tcp_), OnClose);
+  }
+
+  void Reset() {
+    closing_ = false;
+    started_ = false;
+    in_flight_ = 0;
+    send_times_.clear();
+    http2_streams_.clear();
+    if (session_ != nullptr) {
+      nghttp2_session_del(session_);
+      session_ = nullptr;
+    }
+#if HAVE_OPENSSL
+    if (ssl_ != nullptr) {
+      SSL_free(ssl_);
+      ssl_ = nullptr;
+    }
+#endif
+  }
+
+  // Starts sending requests once the connection is there, and its TLS
+  // handshake is done.
+  void Start() {
+    started_ = true;
+    http1_keepalive_ = true;
+    if (options.h2) {
+      StartHttp2();
+    } else {
+      llhttp_init(&http1_parser_, HTTP_RESPONSE, &http1_settings_);
+      http1_parser_.data = this;
+    }
+    Fill();
+  }
+
+  void Fill() {
+    if (stopped || closing_ || !started_) return;
+    if (options.h2) {
+      FillHttp2();
+    } else {
+      FillHttp1();
+    }
+  }
+
+  void OnData(const char* data, size_t length) {
+    if (!started_) return;
+    if (options.h2) {
+      OnHttp2Data(data, length);
+    } else {
+      OnHttp1Data(data, length);
+    }
+  }
+
+  void OnEnd(ssize_t error) {
+    if (closing_) return;
+    if (started_ && !options.h2) {
+      // Responses without a length end with the connection.
+      llhttp_finish(&http1_parser_);
+    }
+    if (in_flight_ != 0 && !stopped) {
+      if (error == UV_ETIMEDOUT) {
+        stats.timeouts++;
+      } else {
+        stats.read_errors++;
+      }
+    }
+    Close(false);
+  }
+
+  void Send(std::string data) {
+#if HAVE_OPENSSL
+    if (ssl_ != nullptr) {
+      // The memory BIO takes all of it, and the records are flushed below.
+      SSL_write(ssl_, data.data(), static_cast<int>(data.size()));
+      FlushTls();
+      return;
+    }
+#endif
+    Write(std::move(data));
+  }
+
+  void Write(std::string data) {
+    WriteReq* write = new WriteReq{{}, std::move(data)};
+    uv_buf_t buf = uv_buf_init(write->data.data(), write->data.size());
+    int err = uv_write(&write->req,
+                       reinterpret_cast<uv_stream_t*>(&tcp_),
+                       &buf,
+                       1,
+                       OnWrite);
+    if (err != 0) {
+      delete write;
+      stats.write_errors++;
+      Close(false);
+    }
+  }
+
+  // HTTP/1.1
+
+  static int OnHeadersComplete(llhttp_t* parser) {
+    Connection* conn = static_cast<Connection*>(parser->data);
+    conn->http1_status_ = llhttp_get_status_code(parser);
+    // Responses to HEAD have no body, whatever their headers say.
+    return options.method == "HEAD" ? 1 : 0;
+  }
+
+  static int OnMessageComplete(llhttp_t* parser) {
+    Connection* conn = static_cast<Connection*>(parser->data);
+    if (conn->send_times_.empty()) return HPE_USER;
+    if (!stopped) {
+      RecordResponse(conn->http1_status_, conn->send_times_.front());
+    }
+    conn->send_times_.pop_front();
+    conn->in_flight_--;
+    conn->http1_keepalive_ = llhttp_should_keep_alive(parser);
+    return HPE_OK;
+  }
+
+  void FillHttp1() {
+    const size_t pipeline = options.keepalive ? options.pipeline : 1;
+    if (in_flight_ >= pipeline) return;
+    std::string batch;
+    const uint64_t now = uv_hrtime();
+    while (in_flight_ < pipeline) {
+      batch += http1_request;
+      send_times_.push_back(now);
+      in_flight_++;
+    }
+    Send(std::move(batch));
+  }
+
+  void OnHttp1Data(const char* data, size_t length) {
+    llhttp_errno_t err = llhttp_execute(&http1_parser_, data, length);
+    if (err != HPE_OK) {
+      if (!stopped) stats.read_errors++;
+      Close(false);
+      return;
+    }
+    if (!http1_keepalive_) {
+      // The server closes the connection after this response, so the
+      // requests behind it have to be made again on a new one.
+      if (in_flight_ != 0 && !stopped) stats.read_errors++;
+      Close(false);
+      return;
+    }
+    Fill();
+  }
+
+  // HTTP/2
+
+  static int OnHttp2Header(nghttp2_session*,
+                           const nghttp2_frame* frame,
+                           const uint8_t* name,
+                           size_t namelen,
+                           const uint8_t* value,
+                           size_t valuelen,
+                           uint8_t,
+                           void* user_data) {
+    Connection* conn = static_cast<Connection*>(user_data);
+    if (frame->hd.type != NGHTTP2_HEADERS || namelen != 7 ||
+        memcmp(name, ":status", 7) != 0) {
+      return 0;
+    }
+    auto it = conn->http2_streams_.find(frame->hd.stream_id);
+    if (it != conn->http2_streams_.end()) {
+      it->second.status = atoi(std::string(
+          reinterpret_cast<const char*>(value), valuelen).c_str());
+    }
+    return 0;
+  }
+
+  static int OnHttp2StreamClose(nghttp2_session*,
+                                int32_t stream_id,
+                                uint32_t error_code,
+                                void* user_data) {
+    Connection* conn = static_cast<Connection*>(user_data);
+    auto it = conn->http2_streams_.find(stream_id);
+    if (it == conn->http2_streams_.end()) return 0;
+    if (!stopped) {
+      if (error_code == NGHTTP2_NO_ERROR) {
+        RecordResponse(it->second.status, it->second.start);
+      } else {
+        stats.read_errors++;
+      }
+    }
+    conn->http2_streams_.erase(it);
+    conn->in_flight_--;
+    return 0;
+  }
+
+  static nghttp2_ssize ReadHttp2Body(nghttp2_session*,
+                                     int32_t stream_id,
+                                     uint8_t* buf,
+                                     size_t length,
+                                     uint32_t* data_flags,
+                                     nghttp2_data_source* source,
+                                     void*) {
+    Connection* conn = static_cast<Connection*>(source->ptr);
+    auto it = conn->http2_streams_.find(stream_id);
+    if (it == conn->http2_streams_.end()) {
+      return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+    }
+    size_t& offset = it->second.body_offset;
+    const size_t n = std::min(length, options.body.size() - offset);
+    memcpy(buf, options.body.data() + offset, n);
+    offset += n;
+    if (offset == options.body.size()) *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+    return static_cast<nghttp2_ssize>(n);
+  }
+
+  void StartHttp2() {
+    nghttp2_session_callbacks* callbacks;
+    nghttp2_session_callbacks_new(&callbacks);
+    nghttp2_session_callbacks_set_on_header_callback(callbacks, OnHttp2Header);
+    nghttp2_session_callbacks_set_on_stream_close_callback(callbacks,
+                                                           OnHttp2StreamClose);
+    nghttp2_session_client_new(&session_, callbacks, this);
+    nghttp2_session_callbacks_del(callbacks);
+
+    // Large windows keep flow control from limiting big responses.
+    const nghttp2_settings_entry settings[] = {
+        {NGHTTP2_SETTINGS_ENABLE_PUSH, 0},
+        {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, kHttp2WindowSize},
+    };
+    nghttp2_submit_settings(session_,
+                            NGHTTP2_FLAG_NONE,
+                            settings,
+                            sizeof(settings) / sizeof(settings[0]));
+    nghttp2_session_set_local_window_size(
+        session_, NGHTTP2_FLAG_NONE, 0, kHttp2WindowSize);
+  }
+
+  void FillHttp2() {
+    while (in_flight_ < options.pipeline &&
+           nghttp2_session_check_request_allowed(session_)) {
+      nghttp2_data_provider2 provider;
+      provider.source.ptr = this;
+      provider.read_callback = ReadHttp2Body;
+      int32_t stream_id =
+          nghttp2_submit_request2(session_,
+                                  nullptr,
+                                  http2_headers.data(),
+                                  http2_headers.size(),
+                                  options.body.empty() ? nullptr : &provider,
+                                  nullptr);
+      if (stream_id < 0) break;
+      http2_streams_[stream_id] = {uv_hrtime(), 0, 0};
+      in_flight_++;
+    }
+    FlushHttp2();
+  }
+
+  void FlushHttp2() {
+    std::string out;
+    for (;;) {
+      const uint8_t* data;
+      nghttp2_ssize n = nghttp2_session_mem_send2(session_, &data);
+      if (n < 0) {
+        if (!stopped) stats.write_errors++;
+        Close(false);
+        return;
+      }
+      if (n == 0) break;
+      out.append(reinterpret_cast<const char*>(data), n);
+    }
+    if (!out.empty()) Send(std::move(out));
+    if (!nghttp2_session_want_read(session_) &&
+        !nghttp2_session_want_write(session_)) {
+      // The server sent a GOAWAY and everything before it is done.
+      Close(false);
+    }
+  }
+
+  void OnHttp2Data(const char* data, size_t length) {
+    nghttp2_ssize n = nghttp2_session_mem_recv2(
+        session_, reinterpret_cast<const uint8_t*>(data), length);
+    if (n < 0) {
+      if (!stopped) stats.read_errors++;
+      Close(false);
+      return;
+    }
+    Fill();
+    // Fill() stops early once the session does not allow new requests, but
+    // the frames that answer the server's still have to go out.
+    if (!closing_ && session_ != nullptr) FlushHttp2();
+  }
+
+  // TLS
+
+#if HAVE_OPENSSL
+  void StartTls() {
+    ssl_ = SSL_new(ssl_ctx);
+    SSL_set_bio(ssl_, BIO_new(BIO_s_mem()), BIO_new(BIO_s_mem()));
+    SSL_set_connect_state(ssl_);
+    // Server names are only sent for host names, not for addresses.
+    unsigned char scratch[sizeof(in6_addr)];
+    if (uv_inet_pton(AF_INET, target.host.c_str(), scratch) != 0 &&
+        uv_inet_pton(AF_INET6, target.host.c_str(), scratch) != 0) {
+      SSL_set_tlsext_host_name(ssl_, target.host.c_str());
+    }
+    Handshake();
+  }
+
+  void Handshake() {
+    int ret = SSL_do_handshake(ssl_);
+    FlushTls();
+    if (ret == 1) {
+      if (options.h2) {
+        const unsigned char* protocol;
+        unsigned int length;
+        SSL_get0_alpn_selected(ssl_, &protocol, &length);
+        if (length != 2 || memcmp(protocol, "h2", 2) != 0) {
+          fprintf(stderr, "http_load: the server did not select h2\n");
+          exit(1);
+        }
+      }
+      Start();
+      return;
+    }
+    int err = SSL_get_error(ssl_, ret);
+    if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+      ERR_clear_error();
+      if (!stopped) stats.connect_errors++;
+      Close(true);
+    }
+  }
+
+  void OnTlsData(const char* data, size_t length) {
+    BIO_write(SSL_get_rbio(ssl_), data, static_cast<int>(length));
+    if (!started_) {
+      Handshake();
+      if (!started_ || closing_) return;
+    }
+    char plain[16 * 1024];
+    for (;;) {
+      int n = SSL_read(ssl_, plain, sizeof(plain));
+      if (n <= 0) {
+        int err = SSL_get_error(ssl_, n);
+        if (err == SSL_ERROR_WANT_READ) break;
+        ERR_clear_error();
+        OnEnd(UV_EOF);
+        return;
+      }
+      OnData(plain, n);
+      if (closing_) return;
+    }
+    FlushTls();
+  }
+
+  void FlushTls() {
+    BIO* wbio = SSL_get_wbio(ssl_);
+    size_t pending = BIO_ctrl_pending(wbio);
+    if (pending == 0) return;
+    std::string out(pending, '\0');
+    BIO_read(wbio, out.data(), static_cast<int>(pending));
+    Write(std::move(out));
+  }
+#endif
+
+  uv_tcp_t tcp_;
+  uv_connect_t connect_req_;
+  uv_timer_t retry_timer_;
+  bool open_ = false;
+  bool closing_ = false;
+  bool retry_ = false;
+  bool started_ = false;
+  size_t in_flight_ = 0;
+
+  llhttp_t http1_parser_;
+  llhttp_settings_t http1_settings_;
+  int http1_status_ = 0;
+  bool http1_keepalive_ = true;
+  // The times at which the requests in flight were written, oldest first.
+  std::deque<uint64_t> send_times_;
+
+  nghttp2_session* session_ = nullptr;
+  std::unordered_map<int32_t, Http2Stream> http2_streams_;
+
+#if HAVE_OPENSSL
+  SSL* ssl_ = nullptr;
+#endif
+};
+
+bool ParseUrl(const std::string& url) {
+  size_t rest;
+  if (url.compare(0, 7, "http://") == 0) {
+    rest = 7;
+  } else if (url.compare(0, 8, "https://") == 0) {
+    target.tls = true;
+    rest = 8;
+  } else {
+    return false;
+  }
+  size_t slash = url.find('/', rest);
+  target.authority = url.substr(rest, slash - rest);
+  target.path = slash == std::string::npos ? "/" : url.substr(slash);
+  std::string port;
+  if (target.authority.compare(0, 1, "[") == 0) {
+    size_t bracket = target.authority.find(']');
+    if (bracket == std::string::npos) return false;
+    target.host = target.authority.substr(1, bracket - 1);
+    if (target.authority.compare(bracket + 1, 1, ":") == 0) {
+      port = target.authority.substr(bracket + 2);
+    }
+  } else {
+    size_t colon = target.authority.find(':');
+    target.host = target.authority.substr(0, colon);
+    if (colon != std::string::npos) port = target.authority.substr(colon + 1);
+  }
+  target.port = port.empty() ? (target.tls ? 443 : 80) : atoi(port.c_str());
+  return !target.host.empty() && target.port > 0 && target.port < 65536;
+}
+
+bool Resolve() {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  uv_getaddrinfo_t req;
+  std::string port = std::to_string(target.port);
+  int err = uv_getaddrinfo(
+      loop, &req, nullptr, target.host.c_str(), port.c_str(), &hints);
+  if (err != 0) {
+    fprintf(stderr,
+            "http_load: cannot resolve %s: %s\n",
+            target.host.c_str(),
+            uv_strerror(err));
+    return false;
+  }
+  memcpy(&target.address, req.addrinfo->ai_addr, req.addrinfo->ai_addrlen);
+  uv_freeaddrinfo(req.addrinfo);
+  return true;
+}
+
+std::string ToLower(std::string value) {
+  for (char& c : value) {
+    if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+  }
+  return value;
+}
+
+void PrepareRequests() {
+  bool has_host = false;
+  bool has_length = false;
+  for (const auto& [name, value] : options.headers) {
+    if (ToLower(name) == "host") has_host = true;
+    if (ToLower(name) == "content-length") has_length = true;
+  }
+
+  http1_request = options.method + " " + target.path + " HTTP/1.1\r\n";
+  if (!has_host) http1_request += "Host: " + target.authority + "\r\n";
+  for (const auto& [name, value] : options.headers) {
+    http1_request += name + ": " + value + "\r\n";
+  }
+  if (!options.body.empty() && !has_length) {
+    http1_request +=
+        "Content-Length: " + std::to_string(options.body.size()) + "\r\n";
+  }
+  if (!options.keepalive) http1_request += "Connection: close\r\n";
+  http1_request += "\r\n" + options.body;
+
+  http2_header_strings = {
+      {":method", options.method},
+      {":scheme", target.tls ? "https" : "http"},
+      {":authority", target.authority},
+      {":path", target.path},
+  };
+  for (const auto& [name, value] : options.headers) {
+    const std::string lower = ToLower(name);
+    // These are connection specific, which HTTP/2 does not allow.
+    if (lower == "host" || lower == "connection" || lower == "keep-alive" ||
+        lower == "transfer-encoding") {
+      continue;
+    }
+    http2_header_strings.emplace_back(lower, value);
+  }
+  if (!options.body.empty() && !has_length) {
+    http2_header_strings.emplace_back("content-length",
+                                      std::to_string(options.body.size()));
+  }
+  for (auto& [name, value] : http2_header_strings) {
+    http2_headers.push_back({reinterpret_cast<uint8_t*>(name.data()),
+                             reinterpret_cast<uint8_t*>(value.data()),
+                             name.size(),
+                             value.size(),
+                             NGHTTP2_NV_FLAG_NO_COPY_NAME |
+                                 NGHTTP2_NV_FLAG_NO_COPY_VALUE});
+  }
+}
+
+#if HAVE_OPENSSL
+bool InitTls() {
+  ssl_ctx = SSL_CTX_new(TLS_client_method());
+  if (ssl_ctx == nullptr) return false;
+  SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_NONE, nullptr);
+  static const unsigned char kH2[] = "\x02h2";
+  static const unsigned char kHttp1[] = "\x08http/1.1";
+  if (options.h2) {
+    SSL_CTX_set_alpn_protos(ssl_ctx, kH2, sizeof(kH2) - 1);
+  } else {
+    SSL_CTX_set_alpn_protos(ssl_ctx, kHttp1, sizeof(kHttp1) - 1);
+  }
+  return true;
+}
+#endif
+
+std::string FormatBytes(double bytes) {
+  static const char* const kUnits[] = {"B", "KB", "MB", "GB"};
+  size_t unit = 0;
+  while (bytes >= 1024 && unit < 3) {
+    bytes /= 1024;
+    unit++;
+  }
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.2f %s", bytes, kUnits[unit]);
+  return buf;
+}
+
+void Report(double seconds) {
+  const double kPercentiles[] = {50, 90, 99, 99.9};
+  double percentiles[4];
+  for (size_t i = 0; i < 4; i++) {
+    percentiles[i] =
+        hdr_value_at_percentile(stats.latency, kPercentiles[i]) / 1e3;
+  }
+  const bool empty = stats.responses == 0;
+  const double mean = empty ? 0 : hdr_mean(stats.latency) / 1e3;
+  const double stdev = empty ? 0 : hdr_stddev(stats.latency) / 1e3;
+  const double max = empty ? 0 : hdr_max(stats.latency) / 1e3;
+  const double rate = stats.responses / seconds;
+  const double throughput = stats.bytes / seconds;
+
+  if (options.json) {
+    // Latencies are in milliseconds.
+    printf("{\"duration\":%.3f,\"requests\":%" PRIu64 ",\"rate\":%.1f,"
+           "\"bytes\":%" PRIu64 ",\"throughput\":%.1f,"
+           "\"latency\":{\"mean\":%.3f,\"stdev\":%.3f,\"max\":%.3f,"
+           "\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"p999\":%.3f},"
+           "\"non2xx\":%" PRIu64 ",\"errors\":{\"connect\":%" PRIu64
+           ",\"read\":%" PRIu64 ",\"write\":%" PRIu64
+           ",\"timeout\":%" PRIu64 "}}\n",
+           seconds, stats.responses, rate, stats.bytes, throughput,
+           mean, stdev, max,
+           percentiles[0], percentiles[1], percentiles[2], percentiles[3],
+           stats.non_2xx, stats.connect_errors, stats.read_errors,
+           stats.write_errors, stats.timeouts);
+    return;
+  }
+
+  printf("%.2fs against %s\n", seconds, options.url.c_str());
+  printf("  %zu connections, %zu %s each, %s%s\n",
+         options.connections,
+         options.pipeline,
+         options.h2 ? "streams" : "pipelined requests",
+         options.h2 ? "HTTP/2" : "HTTP/1.1",
+         options.keepalive ? "" : " without keep-alive");
+  printf("  Requests:  %" PRIu64 " (%.1f/s)\n", stats.responses, rate);
+  printf("  Transfer:  %s (%s/s)\n",
+         FormatBytes(stats.bytes).c_str(),
+         FormatBytes(throughput).c_str());
+  printf("  Latency:   mean %.3f ms, stdev %.3f ms, max %.3f ms\n",
+         mean, stdev, max);
+  printf("             p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, p99.9 %.3f ms\n",
+         percentiles[0], percentiles[1], percentiles[2], percentiles[3]);
+  if (stats.non_2xx != 0) {
+    printf("  Non-2xx:   %" PRIu64 "\n", stats.non_2xx);
+  }
+  if (stats.connect_errors + stats.read_errors + stats.write_errors +
+          stats.timeouts != 0) {
+    printf("  Errors:    connect %" PRIu64 ", read %" PRIu64
+           ", write %" PRIu64 ", timeout %" PRIu64 "\n",
+           stats.connect_errors, stats.read_errors, stats.write_errors,
+           stats.timeouts);
+  }
+}
+
+void OnDuration(uv_timer_t* timer) {
+  stopped = true;
+  end_time = uv_hrtime();
+  // Requests still in flight are not counted, and closing the connections
+  // lets uv_run() return.
+  auto* connections =
+      static_cast<std::vector<std::unique_ptr<Connection>>*>(timer->data);
+  for (auto& conn : *connections) conn->Stop();
+  uv_close(reinterpret_cast<uv_handle_t*>(timer), nullptr);
+}
+
+const char* Flag(const char* arg, const char* name) {
+  const size_t length = strlen(name);
+  if (strncmp(arg, name, length) != 0 || arg[length] != '=') return nullptr;
+  return arg + length + 1;
+}
+
+bool ParseOptions(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value;
+    if ((value = Flag(arg, "--connections")) != nullptr) {
+      options.connections = strtoul(value, nullptr, 10);
+    } else if ((value = Flag(arg, "--pipeline")) != nullptr) {
+      options.pipeline = strtoul(value, nullptr, 10);
+    } else if ((value = Flag(arg, "--duration")) != nullptr) {
+      options.duration = strtod(value, nullptr);
+    } else if ((value = Flag(arg, "--method")) != nullptr) {
+      options.method = value;
+    } else if ((value = Flag(arg, "--header")) != nullptr) {
+      const char* colon = strchr(value, ':');
+      if (colon == nullptr) return false;
+      const char* start = colon + 1;
+      while (*start == ' ') start++;
+      options.headers.emplace_back(std::string(value, colon - value), start);
+    } else if ((value = Flag(arg, "--body")) != nullptr) {
+      options.body = value;
+    } else if (strcmp(arg, "--h2") == 0) {
+      options.h2 = true;
+    } else if (strcmp(arg, "--no-keepalive") == 0) {
+      options.keepalive = false;
+    } else if (strcmp(arg, "--json") == 0) {
+      options.json = true;
+    } else if (arg[0] != '-' && options.url.empty()) {
+      options.url = arg;
+    } else {
+      return false;
+    }
+  }
+  if (options.h2 && !options.keepalive) return false;
+  return !options.url.empty() && options.connections > 0 &&
+         options.pipeline > 0 && options.duration > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (!ParseOptions(argc, argv)) {
+    fprintf(stderr,
+            "usage: %s [--connections=<n>] [--pipeline=<n>] "
+            "[--duration=<seconds>]\n"
+            "       [--method=<method>] [--header=<name: value>]... "
+            "[--body=<string>]\n"
+            "       [--h2] [--no-keepalive] [--json] <url>\n",
+            argv[0]);
+    return 1;
+  }
+  if (!ParseUrl(options.url)) {
+    fprintf(stderr, "http_load: invalid url %s\n", options.url.c_str());
+    return 1;
+  }
+#if HAVE_OPENSSL
+  if (target.tls && !InitTls()) {
+    fprintf(stderr, "http_load: cannot create a TLS context\n");
+    return 1;
+  }
+#else
+  if (target.tls) {
+    fprintf(stderr, "http_load: built without OpenSSL\n");
+    return 1;
+  }
+#endif
+
+  loop = uv_default_loop();
+  if (!Resolve()) return 1;
+  PrepareRequests();
+  hdr_init(1, 60 * 1000 * 1000, 3, &stats.latency);
+
+  std::vector<std::unique_ptr<Connection>> connections;
+  for (size_t i = 0; i < options.connections; i++) {
+    connections.push_back(std::make_unique<Connection>());
+    connections.back()->Connect();
+  }
+
+  uv_timer_t timer;
+  uv_timer_init(loop, &timer);
+  timer.data = &connections;
+  start_time = uv_hrtime();
+  uv_timer_start(
+      &timer, OnDuration, static_cast<uint64_t>(options.duration * 1000), 0);
+
+  uv_run(loop, UV_RUN_DEFAULT);
+  Report((end_time - start_time) / 1e9);
+  hdr_close(stats.latency);
+  return 0;
+}
@@ -0,0 +1,32 @@
+'use strict';
+const common = require('../common.js');
+const https = require('https');
+
+const bench = common.createBenchmark(main, {
+  len: [64, 16 << 10],
+  connections: [10, 100],
+  mode: ['keepalive', 'close'],
+  duration: [5],
+});
+
+// Like http/load.js, where closing the connections after every request
+// measures the TLS handshakes.
+function main({ len, connections, mode, duration }) {
+  const body = Buffer.alloc(len, 'x');
+  const server = https.createServer(common.tlsKeyPair(), (req, res) => {
+    res.writeHead(200, {
+      'Content-Type': 'text/plain',
+      'Content-Length': body.length,
+    });
+    res.end(body);
+  });
+
+  server.listen(0, '127.0.0.1', () => {
+    bench.http({
+      url: `https://127.0.0.1:${server.address().port}/`,
+      connections,
+      keepalive: mode !== 'close',
+      duration,
+    }, () => server.close());
+  });
+}
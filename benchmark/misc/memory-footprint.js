@@ -0,0 +1,84 @@
+'use strict';
+const common = require('../common.js');
+const http2 = require('http2');
+const net = require('net');
+const tls = require('tls');
+const zlib = require('zlib');
+
+const bench = common.createBenchmark(main, {
+  subsystem: ['zlib', 'tls', 'http2', 'streams'],
+  n: [100],
+}, { flags: ['--expose-gc'] });
+
+// Reports the native memory that each of n zlib streams, secure contexts,
+// HTTP/2 client sessions or connected sockets adds, in bytes, so that lower
+// is better here. Where process.memoryBreakdown() is not available, that is
+// in older versions, the growth of the resident set size is reported instead.
+function main({ subsystem, n }) {
+  const retained = [];
+  const before = measure(subsystem);
+  create[subsystem](n, retained, (done) => {
+    const after = measure(subsystem);
+    bench.report((after - before) / n, 0);
+    done();
+  });
+}
+
+function measure(subsystem) {
+  globalThis.gc();
+  if (typeof process.memoryBreakdown === 'function') {
+    return process.memoryBreakdown()[subsystem];
+  }
+  return process.memoryUsage().rss;
+}
+
+const create = {
+  zlib(n, retained, callback) {
+    for (let i = 0; i < n; i++) retained.push(zlib.createDeflate());
+    callback(() => {});
+  },
+
+  tls(n, retained, callback) {
+    const keyPair = common.tlsKeyPair();
+    for (let i = 0; i < n; i++) retained.push(tls.createSecureContext(keyPair));
+    callback(() => {});
+  },
+
+  http2(n, retained, callback) {
+    const server = http2.createServer();
+    server.listen(0, '127.0.0.1', () => {
+      const url = `http://127.0.0.1:${server.address().port}`;
+      let pending = n;
+      for (let i = 0; i < n; i++) {
+        const session = http2.connect(url, () => {
+          if (--pending === 0) {
+            callback(() => {
+              for (const s of retained) s.close();
+              server.close();
+            });
+          }
+        });
+        retained.push(session);
+      }
+    });
+  },
+
+  streams(n, retained, callback) {
+    const server = net.createServer((socket) => retained.push(socket));
+    server.listen(0, '127.0.0.1', () => {
+      const { port } = server.address();
+      let pending = n;
+      for (let i = 0; i < n; i++) {
+        const socket = net.connect(port, '127.0.0.1', () => {
+          if (--pending === 0) {
+            callback(() => {
+              for (const s of retained) s.destroy();
+              server.close();
+            });
+          }
+        });
+        retained.push(socket);
+      }
+    });
+  },
+};
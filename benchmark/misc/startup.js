@@ -0,0 +1,31 @@
+'use strict';
+const common = require('../common.js');
+const { spawnSync } = require('child_process');
+const path = require('path');
+
+const bench = common.createBenchmark(main, {
+  script: ['empty', 'require-builtins'],
+  n: [30],
+});
+
+const scripts = {
+  'empty': '0',
+  'require-builtins': [
+    'fs', 'http', 'net', 'crypto', 'zlib', 'stream', 'url', 'util',
+  ].map((name) => `require('${name}');`).join(''),
+};
+
+// Measures the time from spawning the binary to its exit, including
+// deserializing the startup snapshot.
+function main({ script, n }) {
+  const code = scripts[script];
+  const cwd = path.dirname(process.execPath);
+  bench.start();
+  for (let i = 0; i < n; i++) {
+    const child = spawnSync(process.execPath, ['-e', code], { cwd });
+    if (child.status !== 0) {
+      throw new Error(`Startup failed: ${child.stderr}`);
+    }
+  }
+  bench.end(n);
+}
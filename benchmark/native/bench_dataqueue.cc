@@ -0,0 +1,93 @@
+#include "dataqueue/queue.h"
+#include "node_bench.h"
+#include "node_bob-inl.h"
+#include "util-inl.h"
+#include "v8.h"
+
+#include <memory>
+#include <vector>
+
+using node::DataQueue;
+using v8::ArrayBuffer;
+using v8::BackingStore;
+
+namespace {
+
+constexpr size_t kChunkSize = 16 * 1024;
+
+std::shared_ptr<BackingStore> NewStore() {
+  static char chunk[kChunkSize];
+  return ArrayBuffer::NewBackingStore(
+      chunk, sizeof(chunk), [](void*, size_t, void*) {}, nullptr);
+}
+
+// Reads the whole queue synchronously and returns the number of bytes.
+uint64_t Drain(DataQueue::Reader* reader) {
+  uint64_t total = 0;
+  int status;
+  do {
+    status = reader->Pull(
+        [&](int, const DataQueue::Vec* vecs, size_t count, auto done) {
+          for (size_t i = 0; i < count; i++) total += vecs[i].len;
+          if (done) std::move(done)(0);
+        },
+        node::bob::OPTIONS_SYNC,
+        nullptr,
+        0,
+        node::bob::kMaxCountHint);
+  } while (status == node::bob::STATUS_CONTINUE);
+  CHECK_EQ(status, node::bob::STATUS_EOS);
+  return total;
+}
+
+}  // namespace
+
+// Appends state->arg() chunks to a new non-idempotent queue, as a request
+// body is, and reads them back out.
+NODE_BENCHMARK(DataQueueAppendAndRead, 1, 16, 256) {
+  std::shared_ptr<BackingStore> store = NewStore();
+  state->SetBytesPerIteration(state->arg() * kChunkSize);
+  while (state->KeepRunning()) {
+    std::shared_ptr<DataQueue> queue = DataQueue::Create();
+    for (int64_t i = 0; i < state->arg(); i++) {
+      queue->append(
+          DataQueue::CreateInMemoryEntryFromBackingStore(store, 0, kChunkSize));
+    }
+    queue->cap();
+    std::shared_ptr<DataQueue::Reader> reader = queue->get_reader();
+    node_bench::DoNotOptimize(Drain(reader.get()));
+  }
+}
+
+// Reads an idempotent queue, as a Blob is, with a new reader each time.
+NODE_BENCHMARK(DataQueueIdempotentRead, 1, 16, 256) {
+  std::shared_ptr<BackingStore> store = NewStore();
+  std::vector<std::unique_ptr<DataQueue::Entry>> entries;
+  for (int64_t i = 0; i < state->arg(); i++) {
+    entries.push_back(
+        DataQueue::CreateInMemoryEntryFromBackingStore(store, 0, kChunkSize));
+  }
+  std::shared_ptr<DataQueue> queue =
+      DataQueue::CreateIdempotent(std::move(entries));
+  state->SetBytesPerIteration(state->arg() * kChunkSize);
+  while (state->KeepRunning()) {
+    std::shared_ptr<DataQueue::Reader> reader = queue->get_reader();
+    node_bench::DoNotOptimize(Drain(reader.get()));
+  }
+}
+
+// Slices an idempotent queue's entries, as Blob.prototype.slice() does.
+NODE_BENCHMARK(DataQueueSlice, 16, 256) {
+  std::shared_ptr<BackingStore> store = NewStore();
+  std::vector<std::unique_ptr<DataQueue::Entry>> entries;
+  for (int64_t i = 0; i < state->arg(); i++) {
+    entries.push_back(
+        DataQueue::CreateInMemoryEntryFromBackingStore(store, 0, kChunkSize));
+  }
+  std::shared_ptr<DataQueue> queue =
+      DataQueue::CreateIdempotent(std::move(entries));
+  const uint64_t size = queue->size().value();
+  while (state->KeepRunning()) {
+    node_bench::DoNotOptimize(queue->slice(size / 3, size / 3 * 2));
+  }
+}
@@ -0,0 +1,75 @@
+#include "node_bench.h"
+#include "permission/fs_permission.h"
+
+#include <string>
+#include <vector>
+
+using node::permission::FSPermission;
+
+namespace {
+
+// Paths like the ones --allow-fs-read is given, a mix of directories with
+// wildcards and single files, spread over a few roots.
+std::vector<std::string> MakeAllowList(int64_t count) {
+  static const char* const kRoots[] = {
+      "/home/user/project/", "/usr/lib/node_modules/", "/tmp/", "/etc/"};
+  std::vector<std::string> paths;
+  for (int64_t i = 0; i < count; i++) {
+    std::string path = kRoots[i % 4];
+    path += "dir-" + std::to_string(i / 4) + "/";
+    if (i % 3 == 0) {
+      path += "*";
+    } else {
+      path += "file-" + std::to_string(i) + ".js";
+    }
+    paths.push_back(std::move(path));
+  }
+  return paths;
+}
+
+}  // namespace
+
+// Builds a tree from state->arg() paths, as --allow-fs-read does at startup.
+NODE_BENCHMARK(FSPermissionInsert, 4, 64, 512) {
+  std::vector<std::string> paths = MakeAllowList(state->arg());
+  state->SetItemsPerIteration(state->arg());
+  while (state->KeepRunning()) {
+    FSPermission::RadixTree tree;
+    for (const std::string& path : paths) tree.Insert(path);
+    node_bench::DoNotOptimize(tree);
+  }
+}
+
+// Checks paths that the tree grants, through a wildcard or exactly.
+NODE_BENCHMARK(FSPermissionLookupGranted, 4, 64, 512) {
+  std::vector<std::string> paths = MakeAllowList(state->arg());
+  FSPermission::RadixTree tree;
+  for (const std::string& path : paths) tree.Insert(path);
+  std::vector<std::string> queries;
+  for (const std::string& path : paths) {
+    if (path.back() == '*') {
+      queries.push_back(path.substr(0, path.size() - 1) + "lib/deep/index.js");
+    } else {
+      queries.push_back(path);
+    }
+  }
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    node_bench::DoNotOptimize(tree.Lookup(queries[i++ % queries.size()]));
+  }
+}
+
+// Checks paths that share long prefixes with granted ones but are denied.
+NODE_BENCHMARK(FSPermissionLookupDenied, 4, 64, 512) {
+  std::vector<std::string> paths = MakeAllowList(state->arg());
+  FSPermission::RadixTree tree;
+  for (const std::string& path : paths) tree.Insert(path);
+  std::vector<std::string> queries;
+  for (const std::string& path : paths) {
+    queries.push_back(path.substr(0, path.rfind('/')) + "x/other.js");
+  }
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    node_bench::DoNotOptimize(tree.Lookup(queries[i++ % queries.size()]));
+  }
+}
@@ -0,0 +1,76 @@
+#include "histogram-inl.h"
+#include "node_bench.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using node::Histogram;
+
+namespace {
+
+// Values like event loop delays in nanoseconds, spread over a few orders of
+// magnitude.
+std::vector<int64_t> MakeValues() {
+  std::vector<int64_t> values;
+  uint64_t seed = 42;
+  for (int i = 0; i < 4096; i++) {
+    seed = seed * 6364136223846793005 + 1442695040888963407;
+    values.push_back(1000 + static_cast<int64_t>((seed >> 33) % (1 << 24)));
+  }
+  return values;
+}
+
+}  // namespace
+
+NODE_BENCHMARK(HistogramRecord, 0) {
+  Histogram histogram(Histogram::Options{});
+  std::vector<int64_t> values = MakeValues();
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    histogram.Record(values[i++ % values.size()]);
+  }
+}
+
+// The timing that the event loop delay monitor records on every tick.
+NODE_BENCHMARK(HistogramRecordDelta, 0) {
+  Histogram histogram(Histogram::Options{});
+  while (state->KeepRunning()) {
+    node_bench::DoNotOptimize(histogram.RecordDelta());
+  }
+}
+
+// State->arg() threads record into one histogram at the same time.
+NODE_BENCHMARK(HistogramRecordContended, 2, 4, 8) {
+  Histogram histogram(Histogram::Options{});
+  std::vector<int64_t> values = MakeValues();
+  const int64_t threads = state->arg();
+  const uint64_t iterations = state->iterations();
+  state->SetItemsPerIteration(threads);
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  for (int64_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      for (uint64_t i = 0; i < iterations; i++) {
+        histogram.Record(values[(i + t * 97) % values.size()]);
+      }
+    });
+  }
+  // The threads run all the iterations, between the first and the last call
+  // to KeepRunning().
+  if (!state->KeepRunning()) return;
+  go.store(true, std::memory_order_release);
+  for (auto& worker : workers) worker.join();
+  while (state->KeepRunning()) {}
+}
+
+NODE_BENCHMARK(HistogramPercentile, 0) {
+  Histogram histogram(Histogram::Options{});
+  for (int64_t value : MakeValues()) histogram.Record(value);
+  static const double kPercentiles[] = {50, 90, 99, 99.9};
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    node_bench::DoNotOptimize(histogram.Percentile(kPercentiles[i++ % 4]));
+  }
+}
@@ -0,0 +1,82 @@
+#include "node_bench.h"
+#include "util-inl.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+// ConnectionsList lives in node_http_parser.cc and only works with the
+// parsers it tracks there, so these measure the structure it is built from:
+// connections linked into an intrusive ListHead, in per-second buckets of a
+// std::map.
+
+namespace {
+
+struct Connection {
+  uint64_t bucket = 0;
+  node::ListNode<Connection> all_node;
+  node::ListNode<Connection> active_node;
+};
+
+using AllList = node::ListHead<Connection, &Connection::all_node>;
+using BucketList = node::ListHead<Connection, &Connection::active_node>;
+
+}  // namespace
+
+// Adds and removes a connection in a list of state->arg() others, as a
+// server does when a client connects and disconnects.
+NODE_BENCHMARK(ConnectionListAddRemove, 16, 1024, 65536) {
+  std::vector<std::unique_ptr<Connection>> connections;
+  AllList all;
+  for (int64_t i = 0; i < state->arg(); i++) {
+    connections.push_back(std::make_unique<Connection>());
+    all.PushBack(connections.back().get());
+  }
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    Connection* connection = connections[i++ % connections.size()].get();
+    connection->all_node.Remove();
+    all.PushBack(connection);
+  }
+}
+
+// Moves a connection to the newest bucket, as every new request on a
+// keep-alive connection does.
+NODE_BENCHMARK(ConnectionListTouch, 16, 1024, 65536) {
+  std::vector<std::unique_ptr<Connection>> connections;
+  std::map<uint64_t, BucketList> buckets;
+  for (int64_t i = 0; i < state->arg(); i++) {
+    connections.push_back(std::make_unique<Connection>());
+    connections.back()->bucket = i % 8;
+    buckets[i % 8].PushBack(connections.back().get());
+  }
+  uint64_t now = 8;
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    Connection* connection = connections[i++ % connections.size()].get();
+    connection->active_node.Remove();
+    if (buckets[connection->bucket].IsEmpty()) {
+      buckets.erase(connection->bucket);
+    }
+    // A new bucket every thousand requests, as the buckets span a second.
+    if (i % 1000 == 0) now++;
+    connection->bucket = now;
+    buckets[now].PushBack(connection);
+  }
+}
+
+// Walks all connections, as closeIdleConnections() does.
+NODE_BENCHMARK(ConnectionListWalk, 16, 1024, 65536) {
+  std::vector<std::unique_ptr<Connection>> connections;
+  AllList all;
+  for (int64_t i = 0; i < state->arg(); i++) {
+    connections.push_back(std::make_unique<Connection>());
+    all.PushBack(connections.back().get());
+  }
+  state->SetItemsPerIteration(state->arg());
+  while (state->KeepRunning()) {
+    uint64_t sum = 0;
+    for (Connection* connection : all) sum += connection->bucket;
+    node_bench::DoNotOptimize(sum);
+  }
+}
@@ -0,0 +1,58 @@
+#include "lru_cache-inl.h"
+#include "node_bench.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// Keys shaped like the file names the caches in src/ are keyed by.
+std::vector<std::string> MakeKeys(int64_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (int64_t i = 0; i < count; i++) {
+    keys.push_back("/home/user/project/node_modules/package-" +
+                   std::to_string(i) + "/lib/index.js");
+  }
+  return keys;
+}
+
+}  // namespace
+
+// Looks up keys that are all in the cache, in a cycle.
+NODE_BENCHMARK(LRUCacheGetHit, 16, 256, 4096) {
+  const int64_t capacity = state->arg();
+  std::vector<std::string> keys = MakeKeys(capacity);
+  LRUCache<std::string, int> cache(capacity);
+  for (int64_t i = 0; i < capacity; i++) cache.Put(keys[i], i);
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    const std::string& key = keys[i++ % keys.size()];
+    if (cache.Exists(key)) node_bench::DoNotOptimize(cache.Get(key));
+  }
+}
+
+// Looks up keys that are not in the cache.
+NODE_BENCHMARK(LRUCacheGetMiss, 16, 4096) {
+  const int64_t capacity = state->arg();
+  std::vector<std::string> keys = MakeKeys(capacity * 2);
+  LRUCache<std::string, int> cache(capacity);
+  for (int64_t i = 0; i < capacity; i++) cache.Put(keys[i], i);
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    const std::string& key = keys[capacity + i++ % capacity];
+    node_bench::DoNotOptimize(cache.Exists(key));
+  }
+}
+
+// Inserts new keys into a full cache, so that each one evicts the oldest.
+NODE_BENCHMARK(LRUCachePutEvict, 16, 256, 4096) {
+  const int64_t capacity = state->arg();
+  std::vector<std::string> keys = MakeKeys(capacity * 4);
+  LRUCache<std::string, int> cache(capacity);
+  size_t i = 0;
+  while (state->KeepRunning()) {
+    cache.Put(keys[i++ % keys.size()], 0);
+  }
+  node_bench::DoNotOptimize(cache.Size());
+}
@@ -0,0 +1,136 @@
+#include "node_bench.h"
+#include "node_mutex.h"
+#include "node_platform.h"
+#include "v8-platform.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using node::TaskQueue;
+using node::TaskQueueEntry;
+using node::WorkStealingDeque;
+
+namespace {
+
+class NoopTask : public v8::Task {
+ public:
+  void Run() override {}
+};
+
+std::unique_ptr<TaskQueueEntry> NewEntry() {
+  return std::make_unique<TaskQueueEntry>(std::make_unique<NoopTask>(),
+                                          v8::TaskPriority::kUserVisible);
+}
+
+class CountdownTask : public v8::Task {
+ public:
+  CountdownTask(std::atomic<int64_t>* remaining,
+                node::Mutex* mutex,
+                node::ConditionVariable* done)
+      : remaining_(remaining), mutex_(mutex), done_(done) {}
+
+  void Run() override {
+    if (remaining_->fetch_sub(1) == 1) {
+      node::Mutex::ScopedLock lock(*mutex_);
+      done_->Signal(lock);
+    }
+  }
+
+ private:
+  std::atomic<int64_t>* remaining_;
+  node::Mutex* mutex_;
+  node::ConditionVariable* done_;
+};
+
+}  // namespace
+
+// Pushes a batch of tasks and pops them again, from a single thread.
+NODE_BENCHMARK(TaskQueuePushPop, 1, 64, 1024) {
+  TaskQueue<TaskQueueEntry> queue;
+  std::vector<std::unique_ptr<TaskQueueEntry>> entries;
+  for (int64_t i = 0; i < state->arg(); i++) entries.push_back(NewEntry());
+  state->SetItemsPerIteration(state->arg());
+  while (state->KeepRunning()) {
+    for (auto& entry : entries) queue.Lock().Push(std::move(entry));
+    for (auto& entry : entries) entry = queue.Lock().Pop();
+  }
+}
+
+// The same with the queue's lock held for the whole batch.
+NODE_BENCHMARK(TaskQueuePushPopBatched, 64, 1024) {
+  TaskQueue<TaskQueueEntry> queue;
+  std::vector<std::unique_ptr<TaskQueueEntry>> entries;
+  for (int64_t i = 0; i < state->arg(); i++) entries.push_back(NewEntry());
+  state->SetItemsPerIteration(state->arg());
+  while (state->KeepRunning()) {
+    auto locked = queue.Lock();
+    for (auto& entry : entries) locked.Push(std::move(entry));
+    for (auto& entry : entries) entry = locked.Pop();
+  }
+}
+
+// The owner's side of a worker's deque, which takes no lock.
+NODE_BENCHMARK(WorkStealingDequePushPop, 1, 64, 1024) {
+  WorkStealingDeque<TaskQueueEntry> deque;
+  std::vector<std::unique_ptr<TaskQueueEntry>> entries;
+  for (int64_t i = 0; i < state->arg(); i++) entries.push_back(NewEntry());
+  state->SetItemsPerIteration(state->arg());
+  while (state->KeepRunning()) {
+    for (auto& entry : entries) deque.Push(std::move(entry));
+    for (auto& entry : entries) entry = deque.Pop();
+  }
+}
+
+// State->arg() threads push into and pop from one queue at the same time,
+// as the platform's worker threads do.
+NODE_BENCHMARK(TaskQueueContended, 2, 4, 8) {
+  TaskQueue<TaskQueueEntry> queue;
+  constexpr int kBatch = 256;
+  const int64_t threads = state->arg();
+  state->SetItemsPerIteration(kBatch * threads);
+  const uint64_t iterations = state->iterations();
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  for (int64_t t = 0; t < threads; t++) {
+    workers.emplace_back([&]() {
+      std::vector<std::unique_ptr<TaskQueueEntry>> entries;
+      for (int i = 0; i < kBatch; i++) entries.push_back(NewEntry());
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      for (uint64_t i = 0; i < iterations; i++) {
+        for (auto& entry : entries) queue.Lock().Push(std::move(entry));
+        // Another thread may take ours, but every thread gets kBatch back.
+        for (auto& entry : entries) {
+          while (!(entry = queue.Lock().Pop())) std::this_thread::yield();
+        }
+      }
+    });
+  }
+  // The threads run all the iterations, between the first and the last call
+  // to KeepRunning().
+  if (!state->KeepRunning()) return;
+  go.store(true, std::memory_order_release);
+  for (auto& worker : workers) worker.join();
+  while (state->KeepRunning()) {}
+}
+
+// Posts a batch of tasks to the platform's worker threads and waits for all
+// of them to have run.
+NODE_BENCHMARK(PlatformWorkerTasks, 1, 64, 1024) {
+  v8::Platform* platform = node_bench::platform();
+  node::Mutex mutex;
+  node::ConditionVariable done;
+  std::atomic<int64_t> remaining{0};
+  state->SetItemsPerIteration(state->arg());
+  while (state->KeepRunning()) {
+    remaining.store(state->arg());
+    for (int64_t i = 0; i < state->arg(); i++) {
+      platform->PostTaskOnWorkerThread(
+          v8::TaskPriority::kUserVisible,
+          std::make_unique<CountdownTask>(&remaining, &mutex, &done));
+    }
+    node::Mutex::ScopedLock lock(mutex);
+    while (remaining.load() != 0) done.Wait(lock);
+  }
+}
@@ -0,0 +1,200 @@
+// The driver for the benchmarks in this directory:
+//
+//   out/Release/node_bench [--filter=<substring>] [--min-time=<ms>]
+//                          [--repetitions=<n>] [--list]
+//
+// For each benchmark and argument it works out how many iterations take
+// --min-time (100ms by default), runs that many --repetitions times (5) and
+// prints the fastest and the median time per iteration, and the rate of
+// items or bytes when the benchmark reports one.
+
+#include "node_bench.h"
+
+#include "cppgc/platform.h"
+#include "libplatform/libplatform.h"
+#include "node.h"
+#include "util.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace node_bench {
+
+void State::PauseTiming() {
+  if (!running_) return;
+  elapsed_ns_ += uv_hrtime() - start_ns_;
+  running_ = false;
+}
+
+void State::ResumeTiming() {
+  if (running_) return;
+  running_ = true;
+  start_ns_ = uv_hrtime();
+}
+
+std::vector<Benchmark>* Registry() {
+  static std::vector<Benchmark> benchmarks;
+  return &benchmarks;
+}
+
+namespace {
+v8::Platform* current_platform = nullptr;
+}  // namespace
+
+v8::Platform* platform() {
+  return current_platform;
+}
+
+void SetPlatform(v8::Platform* platform) {
+  current_platform = platform;
+}
+
+namespace {
+
+struct Options {
+  std::string filter;
+  uint64_t min_time_ns = 100 * 1000 * 1000;
+  int repetitions = 5;
+  bool list = false;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (strncmp(arg, "--filter=", 9) == 0) {
+      options->filter = arg + 9;
+    } else if (strncmp(arg, "--min-time=", 11) == 0) {
+      options->min_time_ns = strtoull(arg + 11, nullptr, 10) * 1000 * 1000;
+    } else if (strncmp(arg, "--repetitions=", 14) == 0) {
+      options->repetitions = std::max(1, atoi(arg + 14));
+    } else if (strcmp(arg, "--list") == 0) {
+      options->list = true;
+    } else {
+      fprintf(stderr,
+              "Usage: %s [--filter=<substring>] [--min-time=<ms>] "
+              "[--repetitions=<n>] [--list]\n",
+              argv[0]);
+      return false;
+    }
+  }
+  return options->min_time_ns > 0;
+}
+
+State RunOnce(const Benchmark& benchmark, int64_t arg, uint64_t iterations) {
+  State state(arg, iterations);
+  benchmark.function(&state);
+  return state;
+}
+
+// Doubles the number of iterations until a run takes a tenth of the target
+// time, then scales it to the target.
+uint64_t Calibrate(const Benchmark& benchmark,
+                   int64_t arg,
+                   uint64_t min_time_ns) {
+  uint64_t iterations = 1;
+  for (;;) {
+    State state = RunOnce(benchmark, arg, iterations);
+    const uint64_t elapsed = std::max<uint64_t>(state.elapsed_ns(), 1);
+    if (elapsed >= min_time_ns / 10 || iterations >= (uint64_t{1} << 40)) {
+      const double scale = static_cast<double>(min_time_ns) / elapsed;
+      return std::max<uint64_t>(1, iterations * scale);
+    }
+    iterations *= 2;
+  }
+}
+
+std::string FormatRate(double per_second, const char* unit) {
+  static const char* const kPrefixes[] = {"", "k", "M", "G", "T"};
+  size_t prefix = 0;
+  while (per_second >= 1000 && prefix + 1 < node::arraysize(kPrefixes)) {
+    per_second /= 1000;
+    prefix++;
+  }
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.2f %s%s/s", per_second,
+           kPrefixes[prefix], unit);
+  return buffer;
+}
+
+void Run(const Benchmark& benchmark, int64_t arg, const Options& options) {
+  const uint64_t iterations = Calibrate(benchmark, arg, options.min_time_ns);
+  std::vector<double> ns_per_iteration;
+  State last(arg, 0);
+  for (int i = 0; i < options.repetitions; i++) {
+    last = RunOnce(benchmark, arg, iterations);
+    ns_per_iteration.push_back(static_cast<double>(last.elapsed_ns()) /
+                               iterations);
+  }
+  std::sort(ns_per_iteration.begin(), ns_per_iteration.end());
+  const double best = ns_per_iteration.front();
+  const double median = ns_per_iteration[ns_per_iteration.size() / 2];
+
+  std::string rate;
+  if (last.bytes_per_iteration() > 0) {
+    rate = FormatRate(last.bytes_per_iteration() * 1e9 / median, "B");
+  } else if (last.items_per_iteration() > 0) {
+    rate = FormatRate(last.items_per_iteration() * 1e9 / median, "items");
+  }
+  const std::string name = std::string(benchmark.name) + "/" +
+                           std::to_string(arg);
+  printf("%-44s %12.1f ns %12.1f ns %12" PRIu64 "  %s\n",
+         name.c_str(), best, median, iterations, rate.c_str());
+  fflush(stdout);
+}
+
+}  // namespace
+
+}  // namespace node_bench
+
+int main(int argc, char** argv) {
+  using node_bench::Benchmark;
+
+  node_bench::Options options;
+  if (!node_bench::ParseOptions(argc, argv, &options)) return 1;
+
+  std::vector<Benchmark> benchmarks = *node_bench::Registry();
+  std::sort(benchmarks.begin(), benchmarks.end(),
+            [](const Benchmark& a, const Benchmark& b) {
+              return strcmp(a.name, b.name) < 0;
+            });
+  if (options.list) {
+    for (const Benchmark& benchmark : benchmarks) {
+      printf("%s\n", benchmark.name);
+    }
+    return 0;
+  }
+
+  // Some of the structures need V8, e.g. for BackingStores, or a platform
+  // to post tasks to. Set them up as the cctest harness does.
+  std::unique_ptr<node::MultiIsolatePlatform> platform =
+      node::MultiIsolatePlatform::Create(4);
+  v8::V8::InitializePlatform(platform.get());
+  cppgc::InitializeProcess(platform->GetPageAllocator());
+  v8::V8::Initialize();
+  node_bench::SetPlatform(platform.get());
+
+  printf("%-44s %15s %15s %12s  %s\n",
+         "benchmark", "best", "median", "iterations", "rate");
+  for (const Benchmark& benchmark : benchmarks) {
+    if (!options.filter.empty() &&
+        strstr(benchmark.name, options.filter.c_str()) == nullptr) {
+      continue;
+    }
+    for (int64_t arg : benchmark.args) {
+      node_bench::Run(benchmark, arg, options);
+    }
+  }
+
+  node_bench::SetPlatform(nullptr);
+  cppgc::ShutdownProcess();
+  v8::V8::Dispose();
+  v8::V8::DisposePlatform();
+  return 0;
+}
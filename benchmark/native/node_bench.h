@@ -0,0 +1,117 @@
+#ifndef BENCHMARK_NATIVE_NODE_BENCH_H_
+#define BENCHMARK_NATIVE_NODE_BENCH_H_
+
+// A small harness for benchmarking Node.js internals from C++, in the style
+// of Google Benchmark, which is not in deps/. A benchmark is a function that
+// sets up what it needs, then runs the code to measure until KeepRunning()
+// returns false:
+//
+//   NODE_BENCHMARK(LRUCacheGet, 16, 4096) {
+//     LRUCache<int, int> cache(state->arg());
+//     for (int i = 0; i < state->arg(); i++) cache.Put(i, i);
+//     int i = 0;
+//     while (state->KeepRunning()) {
+//       node_bench::DoNotOptimize(cache.Get(i++ % state->arg()));
+//     }
+//   }
+//
+// It runs once for each of its arguments, and is called several times for
+// each as the harness works out how many iterations fill the target time.
+// So whatever it sets up must be cheap next to the time it runs for, or be
+// excluded with PauseTiming() and ResumeTiming().
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace v8 {
+class Platform;
+}  // namespace v8
+
+namespace node_bench {
+
+class State {
+ public:
+  State(int64_t arg, uint64_t iterations)
+      : arg_(arg), max_iterations_(iterations) {}
+
+  int64_t arg() const { return arg_; }
+  uint64_t iterations() const { return max_iterations_; }
+
+  bool KeepRunning() {
+    if (done_ < max_iterations_) {
+      if (done_++ == 0) ResumeTiming();
+      return true;
+    }
+    PauseTiming();
+    return false;
+  }
+
+  void PauseTiming();
+  void ResumeTiming();
+
+  // Reports a rate of items or bytes per second, for iterations that each
+  // process more than one of something.
+  void SetItemsPerIteration(int64_t items) { items_per_iteration_ = items; }
+  void SetBytesPerIteration(int64_t bytes) { bytes_per_iteration_ = bytes; }
+
+  uint64_t elapsed_ns() const { return elapsed_ns_; }
+  int64_t items_per_iteration() const { return items_per_iteration_; }
+  int64_t bytes_per_iteration() const { return bytes_per_iteration_; }
+
+ private:
+  int64_t arg_;
+  uint64_t max_iterations_;
+  uint64_t done_ = 0;
+  bool running_ = false;
+  uint64_t start_ns_ = 0;
+  uint64_t elapsed_ns_ = 0;
+  int64_t items_per_iteration_ = 0;
+  int64_t bytes_per_iteration_ = 0;
+};
+
+using Function = void (*)(State* state);
+
+struct Benchmark {
+  const char* name;
+  Function function;
+  std::vector<int64_t> args;
+};
+
+std::vector<Benchmark>* Registry();
+
+// The platform that main() initializes V8 with, for benchmarks that post
+// tasks to its worker threads.
+v8::Platform* platform();
+void SetPlatform(v8::Platform* platform);
+
+struct Registration {
+  Registration(const char* name,
+               Function function,
+               std::initializer_list<int64_t> args) {
+    Registry()->push_back({name, function, args});
+  }
+};
+
+// Keeps the compiler from optimizing away the computation of value.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+}  // namespace node_bench
+
+// The arguments are passed to the benchmark as state->arg(), use 0 for
+// benchmarks that do not take one.
+#define NODE_BENCHMARK(name, ...)                                             \
+  static void NodeBenchmark_##name(node_bench::State* state);                 \
+  static const node_bench::Registration node_bench_registration_##name(      \
+      #name, NodeBenchmark_##name, {__VA_ARGS__});                            \
+  static void NodeBenchmark_##name(node_bench::State* state)
+
+#endif  // BENCHMARK_NATIVE_NODE_BENCH_H_
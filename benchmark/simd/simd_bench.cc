@@ -0,0 +1,355 @@
+// Micro-benchmarks for the SIMD accelerated kernels.
+//
+// Every kernel runs once per implementation the running CPU supports, so an
+// Athlon XP build reports its 3DNow!/MMX kernels next to the scalar ones:
+//
+//   out/Release/simd_bench [--filter=<substring>] [--size=<bytes>]
+//
+// Each line reports <kernel>/<implementation>, the buffer size, and
+// throughput in bytes per cycle (from the time stamp counter on x86, the time
+// base on PowerPC) and in MB/s. The V8 string hasher and Swiss table probe
+// are selected when V8 is compiled and cannot be swapped at runtime, so they
+// are not covered here.
+
+#include "simd_abstraction.h"
+#include "simdjson.h"
+#include "simdutf.h"
+#include "zlib.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) ||          \
+    defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace {
+
+uint64_t ReadCycleCounter() {
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) ||          \
+    defined(_M_X64)
+  return __rdtsc();
+#elif (defined(__powerpc__) || defined(__PPC__)) && defined(__GNUC__)
+  // The time base ticks at a fixed, model specific fraction of the core
+  // clock, so only compare PowerPC numbers with each other.
+  return __builtin_ppc_get_timebase();
+#else
+  return 0;
+#endif
+}
+
+struct Options {
+  std::string filter;
+  size_t size = 64 * 1024;
+};
+
+struct Result {
+  double bytes_per_cycle;
+  double megabytes_per_second;
+};
+
+// Times fn(), which processes `bytes` bytes, in five rounds of roughly 100ms
+// each and reports the fastest round.
+Result Measure(size_t bytes, const std::function<void()>& fn) {
+  using Clock = std::chrono::steady_clock;
+  size_t iterations = 1;
+  for (;;) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) fn();
+    if (Clock::now() - start >= std::chrono::milliseconds(20)) break;
+    iterations *= 2;
+  }
+  iterations *= 5;
+
+  Result best = {0, 0};
+  for (int round = 0; round < 5; round++) {
+    Clock::time_point start = Clock::now();
+    uint64_t cycles_start = ReadCycleCounter();
+    for (size_t i = 0; i < iterations; i++) fn();
+    uint64_t cycles = ReadCycleCounter() - cycles_start;
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    double total = static_cast<double>(bytes) * iterations;
+    Result result = {cycles != 0 ? total / cycles : 0, total / seconds / 1e6};
+    if (result.megabytes_per_second > best.megabytes_per_second) best = result;
+  }
+  return best;
+}
+
+void Report(const Options& options,
+            const std::string& kernel,
+            const std::string& implementation,
+            size_t bytes,
+            const std::function<void()>& fn) {
+  std::string name = kernel + "/" + implementation;
+  if (name.find(options.filter) == std::string::npos) return;
+  Result result = Measure(bytes, fn);
+  printf("%-32s %9zu bytes %8.3f bytes/cycle %10.1f MB/s\n",
+         name.c_str(),
+         bytes,
+         result.bytes_per_cycle,
+         result.megabytes_per_second);
+}
+
+volatile uint64_t result_sink;
+
+// Keeps the compiler from dropping the result of a benchmarked call.
+template <typename T>
+void DoNotOptimize(T value) {
+  static_assert(sizeof(value) <= sizeof(uint64_t));
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(value));
+  result_sink = bits;
+}
+
+std::vector<uint8_t> RandomBytes(size_t length, uint32_t seed) {
+  std::vector<uint8_t> data(length);
+  for (size_t i = 0; i < length; i++) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = static_cast<uint8_t>(seed >> 16);
+  }
+  return data;
+}
+
+// Mostly ASCII text with a two and a three byte sequence every 64 bytes.
+std::string Utf8Text(size_t length) {
+  static const char kPattern[] =
+      "The quick brown fox jumps over the lazy dog, caf\xc3\xa9 \xe2\x82\xac ";
+  std::string text;
+  while (text.size() + sizeof(kPattern) - 1 <= length) text += kPattern;
+  text.append(length - text.size(), 'a');
+  return text;
+}
+
+std::string JsonDocument(size_t length) {
+  std::string json = "[";
+  for (int i = 0; json.size() + 80 < length; i++) {
+    if (i != 0) json += ',';
+    json += "{\"id\":" + std::to_string(i) +
+            ",\"name\":\"item \\\"" + std::to_string(i * 7) +
+            "\\\"\",\"tags\":[\"a\",\"b\"],\"ok\":true}";
+  }
+  json += "]";
+  return json;
+}
+
+void BenchSimdKernels(const Options& options) {
+  std::vector<uint8_t> a = RandomBytes(options.size, 1);
+  std::vector<uint8_t> b = a;
+  const std::vector<uint8_t> same = a;
+  std::vector<uint8_t> ascii = a;
+  for (uint8_t& byte : ascii) byte &= 0x7f;
+  const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+
+  for (simd_instruction_set_t isa : {SIMD_SSE2,
+                                     SIMD_3DNOWEXT,
+                                     SIMD_3DNOW,
+                                     SIMD_MMXEXT,
+                                     SIMD_ALTIVEC,
+                                     SIMD_SCALAR}) {
+    const simd_functions_t* funcs = get_simd_functions_for(isa);
+    if (funcs == nullptr) continue;
+    std::string impl = get_simd_instruction_set_name(isa);
+    size_t size = options.size;
+
+    if (funcs->find_byte != nullptr) {
+      Report(options, "simd.find_byte", impl, size, [&] {
+        // No byte of ascii has its top bit set, so this scans all of it.
+        DoNotOptimize(funcs->find_byte(ascii.data(), size, 0x80));
+      });
+    }
+    if (funcs->find_last_byte != nullptr) {
+      Report(options, "simd.find_last_byte", impl, size, [&] {
+        DoNotOptimize(funcs->find_last_byte(ascii.data(), size, 0x80));
+      });
+    }
+    if (funcs->find_byte_pair != nullptr) {
+      // The first byte matches everywhere, the last one nowhere, which is
+      // the worst case for the filter in front of Buffer#indexOf().
+      std::vector<uint8_t> first(size, 'a');
+      Report(options, "simd.find_byte_pair", impl, size - 15, [&] {
+        DoNotOptimize(funcs->find_byte_pair(first.data(), size - 15, 'a', 'b',
+                                            15));
+      });
+    }
+    if (funcs->compare_bytes != nullptr) {
+      Report(options, "simd.compare_bytes", impl, size, [&] {
+        DoNotOptimize(funcs->compare_bytes(a.data(), same.data(), size));
+      });
+    }
+    if (funcs->xor_bytes != nullptr) {
+      Report(options, "simd.xor_bytes", impl, size, [&] {
+        funcs->xor_bytes(b.data(), a.data(), size);
+      });
+    }
+    if (funcs->mask_bytes != nullptr) {
+      Report(options, "simd.mask_bytes", impl, size, [&] {
+        funcs->mask_bytes(b.data(), a.data(), size, mask);
+      });
+    }
+    if (funcs->sum_bytes != nullptr) {
+      Report(options, "simd.sum_bytes", impl, size, [&] {
+        DoNotOptimize(funcs->sum_bytes(a.data(), size));
+      });
+    }
+    if (funcs->min_max_bytes != nullptr) {
+      Report(options, "simd.min_max_bytes", impl, size, [&] {
+        uint8_t min, max;
+        funcs->min_max_bytes(a.data(), size, &min, &max);
+        DoNotOptimize(min ^ max);
+      });
+    }
+    if (funcs->swap_bytes16 != nullptr) {
+      Report(options, "simd.swap_bytes16", impl, size, [&] {
+        funcs->swap_bytes16(b.data(), size / 2);
+      });
+    }
+    if (funcs->swap_bytes32 != nullptr) {
+      Report(options, "simd.swap_bytes32", impl, size, [&] {
+        funcs->swap_bytes32(b.data(), size / 4);
+      });
+    }
+    if (funcs->swap_bytes64 != nullptr) {
+      Report(options, "simd.swap_bytes64", impl, size, [&] {
+        funcs->swap_bytes64(b.data(), size / 8);
+      });
+    }
+    if (funcs->validate_ascii != nullptr) {
+      Report(options, "simd.validate_ascii", impl, size, [&] {
+        DoNotOptimize(funcs->validate_ascii(ascii.data(), size));
+      });
+    }
+    if (funcs->hex_encode != nullptr) {
+      std::string hex(2 * size, '\0');
+      Report(options, "simd.hex_encode", impl, size, [&] {
+        funcs->hex_encode(hex.data(), a.data(), size);
+      });
+    }
+  }
+}
+
+// zlib picks its kernels from the cpu_features.c flags, so clearing a flag
+// runs the next implementation down on the same CPU.
+void BenchZlib(const Options& options) {
+  std::vector<uint8_t> data = RandomBytes(options.size, 2);
+  uInt size = static_cast<uInt>(options.size);
+  cpu_check_features();
+
+  auto adler32_bench = [&](const char* impl) {
+    Report(options, "zlib.adler32", impl, size, [&] {
+      DoNotOptimize(adler32(1, data.data(), size));
+    });
+  };
+  adler32_bench(cpu_features_adler32_impl());
+#if defined(SIMD_ARCH_X86)
+  if (x86_cpu_enable_ssse3) {
+    x86_cpu_enable_ssse3 = 0;
+    adler32_bench(cpu_features_adler32_impl());
+    x86_cpu_enable_ssse3 = 1;
+  }
+#elif defined(SIMD_ARCH_PPC)
+  if (ppc_cpu_enable_altivec) {
+    ppc_cpu_enable_altivec = 0;
+    adler32_bench(cpu_features_adler32_impl());
+    ppc_cpu_enable_altivec = 1;
+  }
+#endif
+
+  Report(options, "zlib.crc32", cpu_features_crc32_impl(), size, [&] {
+    DoNotOptimize(crc32(0, data.data(), size));
+  });
+
+  // slide_hash only runs when deflate moves its window, which happens
+  // every 32K of input, so it is measured as part of level 1 deflate.
+  std::vector<uint8_t> text(options.size);
+  std::string pattern = Utf8Text(options.size);
+  memcpy(text.data(), pattern.data(), text.size());
+  std::vector<uint8_t> compressed(compressBound(size));
+  Report(options, "zlib.deflate", cpu_features_slide_hash_impl(), size, [&] {
+    uLongf length = compressed.size();
+    compress2(compressed.data(), &length, text.data(), size, 1);
+    DoNotOptimize(length);
+  });
+}
+
+void BenchSimdjson(const Options& options) {
+  simdjson::padded_string json(JsonDocument(options.size));
+  for (const simdjson::implementation* impl :
+       simdjson::get_available_implementations()) {
+    if (!impl->supported_by_runtime_system()) continue;
+    std::unique_ptr<simdjson::internal::dom_parser_implementation> parser;
+    if (impl->create_dom_parser_implementation(
+            json.size(), simdjson::DEFAULT_MAX_DEPTH, parser) !=
+        simdjson::SUCCESS) {
+      continue;
+    }
+    Report(options, "simdjson.stage1", impl->name(), json.size(), [&] {
+      DoNotOptimize(parser->stage1(reinterpret_cast<const uint8_t*>(
+                                       json.data()),
+                                   json.size(),
+                                   simdjson::stage1_mode::regular));
+    });
+  }
+}
+
+void BenchSimdutf(const Options& options) {
+  std::string text = Utf8Text(options.size);
+  std::vector<char16_t> utf16(text.size());
+  std::string base64(simdutf::base64_length_from_binary(text.size()), '\0');
+  simdutf::binary_to_base64(text.data(), text.size(), base64.data());
+  std::vector<char> binary(text.size());
+  for (const simdutf::implementation* impl :
+       simdutf::get_available_implementations()) {
+    if (!impl->supported_by_runtime_system()) continue;
+    Report(options, "simdutf.validate_utf8", impl->name(), text.size(), [&] {
+      DoNotOptimize(impl->validate_utf8(text.data(), text.size()));
+    });
+    Report(options, "simdutf.utf8_to_utf16", impl->name(), text.size(), [&] {
+      DoNotOptimize(
+          impl->convert_utf8_to_utf16le(text.data(), text.size(), utf16.data()));
+    });
+    Report(options, "simdutf.base64_encode", impl->name(), text.size(), [&] {
+      DoNotOptimize(
+          impl->binary_to_base64(text.data(), text.size(), base64.data()));
+    });
+    Report(options, "simdutf.base64_decode", impl->name(), base64.size(), [&] {
+      DoNotOptimize(
+          impl->base64_to_binary(base64.data(), base64.size(), binary.data())
+              .count);
+    });
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--filter=", 9) == 0) {
+      options.filter = argv[i] + 9;
+    } else if (strncmp(argv[i], "--size=", 7) == 0) {
+      options.size = strtoul(argv[i] + 7, nullptr, 10);
+    } else {
+      fprintf(stderr, "usage: %s [--filter=<substring>] [--size=<bytes>]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (options.size < 64) options.size = 64;
+
+  BenchSimdKernels(options);
+  BenchZlib(options);
+  BenchSimdjson(options);
+  BenchSimdutf(options);
+  return 0;
+}
@@ -0,0 +1,991 @@
+// Differential checks and per-length throughput for the SIMD kernels.
+//
+// Every implementation the running CPU supports is run in turn against the
+// scalar one (zlib's against its portable code, simdutf's against its
+// fallback), first on every length from 0 to 256 at every alignment, then
+// on random lengths and contents, and finally timed per length bucket:
+//
+//   out/Release/simd_fuzz [--filter=<substring>] [--iterations=<count>]
+//                         [--seed=<n>] [--no-bench]
+//
+// Inputs are placed right after an inaccessible page and right before one,
+// so a kernel that reads or writes a single byte outside of its buffer
+// crashes on the spot, and outputs are compared with a few bytes on either
+// side to catch stray stores that stay within a page. Mismatches are printed
+// with the case that produced them and make the exit status 1.
+//
+// The throughput table reports MB/s for each bucket and marks with '!' the
+// buckets in which an implementation is slower than the scalar one, which
+// are the lengths below which callers should not use it (see
+// node --simd-calibrate). The V8 string hasher and Swiss table probe are
+// selected when V8 is compiled and cannot be swapped at runtime, and
+// deflate's slide_hash is picked at compile time too, so they are not
+// covered here.
+
+#include "simd_abstraction.h"
+#include "simdutf.h"
+#include "zlib.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t kMaxExhaustiveLength = 256;
+constexpr size_t kMaxRandomLength = 64 * 1024;
+// Alignments are tried modulo the widest vector a kernel loads.
+constexpr size_t kAlignments = 16;
+// Bytes on either side of an output that must be left alone.
+constexpr size_t kSlack = 32;
+
+struct Options {
+  std::string filter;
+  size_t iterations = 20000;
+  uint32_t seed = 1;
+  bool bench = true;
+};
+
+// Memory between two inaccessible pages.
+class GuardedBuffer {
+ public:
+  explicit GuardedBuffer(size_t size) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    page_size_ = info.dwPageSize;
+#else
+    page_size_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    size_ = (size + page_size_ - 1) / page_size_ * page_size_;
+    mapping_size_ = size_ + 2 * page_size_;
+#ifdef _WIN32
+    mapping_ = static_cast<uint8_t*>(VirtualAlloc(
+        nullptr, mapping_size_, MEM_RESERVE | MEM_COMMIT, PAGE_NOACCESS));
+    DWORD old_protection;
+    if (mapping_ == nullptr ||
+        !VirtualProtect(mapping_ + page_size_, size_, PAGE_READWRITE,
+                        &old_protection)) {
+      fprintf(stderr, "simd_fuzz: could not map guarded memory\n");
+      exit(2);
+    }
+#else
+    void* mapping = mmap(nullptr, mapping_size_, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED ||
+        mprotect(static_cast<uint8_t*>(mapping) + page_size_, size_,
+                 PROT_READ | PROT_WRITE) != 0) {
+      fprintf(stderr, "simd_fuzz: could not map guarded memory\n");
+      exit(2);
+    }
+    mapping_ = static_cast<uint8_t*>(mapping);
+#endif
+  }
+
+  ~GuardedBuffer() {
+#ifdef _WIN32
+    VirtualFree(mapping_, 0, MEM_RELEASE);
+#else
+    munmap(mapping_, mapping_size_);
+#endif
+  }
+
+  GuardedBuffer(const GuardedBuffer&) = delete;
+  GuardedBuffer& operator=(const GuardedBuffer&) = delete;
+
+  uint8_t* begin() const { return mapping_ + page_size_; }
+  uint8_t* end() const { return begin() + size_; }
+
+  // Room for length bytes, misalign bytes from the start of the buffer or,
+  // if at_end, misalign bytes from its end.
+  uint8_t* Place(size_t length, size_t misalign, bool at_end) const {
+    return at_end ? end() - length - misalign : begin() + misalign;
+  }
+
+ private:
+  size_t page_size_;
+  size_t size_;
+  size_t mapping_size_;
+  uint8_t* mapping_;
+};
+
+enum class Pattern {
+  kRandom,
+  kZeros,
+  kOnes,
+  // The background byte everywhere but at one position, which holds the
+  // needle; these exercise every tail position of the search kernels.
+  kNeedleFirst,
+  kNeedleMiddle,
+  kNeedleLast,
+};
+
+constexpr Pattern kPatterns[] = {Pattern::kRandom,
+                                 Pattern::kZeros,
+                                 Pattern::kOnes,
+                                 Pattern::kNeedleFirst,
+                                 Pattern::kNeedleMiddle,
+                                 Pattern::kNeedleLast};
+
+constexpr uint8_t kBackground = 'a';
+// Not ASCII, so validate_ascii finds it as well.
+constexpr uint8_t kNeedle = 0xe2;
+
+const char* PatternName(Pattern pattern) {
+  switch (pattern) {
+    case Pattern::kRandom: return "random";
+    case Pattern::kZeros: return "zeros";
+    case Pattern::kOnes: return "ones";
+    case Pattern::kNeedleFirst: return "needle-first";
+    case Pattern::kNeedleMiddle: return "needle-middle";
+    case Pattern::kNeedleLast: return "needle-last";
+  }
+  return "";
+}
+
+class Random {
+ public:
+  explicit Random(uint32_t seed) : state_(seed * 2654435761u + 1) {}
+
+  uint32_t Next() {
+    // xorshift32
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  size_t Below(size_t limit) { return limit == 0 ? 0 : Next() % limit; }
+
+  void Fill(uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) data[i] = static_cast<uint8_t>(Next());
+  }
+
+ private:
+  uint32_t state_;
+};
+
+void FillPattern(uint8_t* data, size_t length, Pattern pattern, uint32_t seed) {
+  switch (pattern) {
+    case Pattern::kRandom:
+      Random(seed).Fill(data, length);
+      return;
+    case Pattern::kZeros:
+      memset(data, 0, length);
+      return;
+    case Pattern::kOnes:
+      memset(data, 0xff, length);
+      return;
+    default:
+      break;
+  }
+  memset(data, kBackground, length);
+  if (length == 0) return;
+  size_t position = pattern == Pattern::kNeedleFirst ? 0
+                    : pattern == Pattern::kNeedleLast ? length - 1
+                                                      : length / 2;
+  data[position] = kNeedle;
+}
+
+// The case being checked, for the report of a mismatch or a crash.
+struct Case {
+  const char* kernel = "";
+  const char* implementation = "";
+  size_t length = 0;
+  size_t misalign = 0;
+  bool at_end = false;
+  Pattern pattern = Pattern::kRandom;
+  uint32_t seed = 0;
+};
+
+Case current;
+const Options* options;
+size_t failures = 0;
+
+void PrintCase(FILE* out, const Case& c) {
+  fprintf(out,
+          "%s/%s length=%zu misalign=%zu placement=%s pattern=%s seed=%u",
+          c.kernel,
+          c.implementation,
+          c.length,
+          c.misalign,
+          c.at_end ? "end" : "start",
+          PatternName(c.pattern),
+          c.seed);
+}
+
+void OnCrash(int signal) {
+  // Not async-signal-safe, but the process is going down anyway and this
+  // is the one thing worth knowing.
+  fprintf(stderr, "simd_fuzz: signal %d while checking ", signal);
+  PrintCase(stderr, current);
+  fprintf(stderr, "\n");
+  fflush(stderr);
+  std::signal(signal, SIG_DFL);
+  std::raise(signal);
+}
+
+void Fail(const std::string& detail) {
+  if (failures++ < 50) {
+    printf("MISMATCH ");
+    PrintCase(stdout, current);
+    printf(": %s\n", detail.c_str());
+  }
+}
+
+template <typename T>
+void Expect(const T& actual, const T& expected, const char* what) {
+  if (actual == expected) return;
+  Fail(std::string(what) + " is " + std::to_string(actual) + ", expected " +
+       std::to_string(expected));
+}
+
+bool Selected(const char* kernel) {
+  return strstr(kernel, options->filter.c_str()) != nullptr;
+}
+
+// Runs a kernel that writes out_length bytes on a window of `out` and on a
+// copy of it in ordinary memory, with the same initial contents, and
+// compares the whole window including kSlack bytes on either side. `initial`
+// is what in-place kernels start from; other outputs start out as junk.
+// run(dst, reference) runs the scalar kernel if reference is true.
+template <typename Run>
+void CheckOutput(const GuardedBuffer& out,
+                 size_t out_length,
+                 const uint8_t* initial,
+                 Run&& run) {
+  // Vary the alignment of the output relative to the input.
+  uint8_t* dst = out.Place(out_length,
+                           (current.misalign * 7 + 3) % kAlignments,
+                           current.at_end);
+  size_t before = std::min<size_t>(kSlack, dst - out.begin());
+  size_t after = std::min<size_t>(kSlack, out.end() - (dst + out_length));
+  std::vector<uint8_t> expected(before + out_length + after);
+  Random(current.seed ^ 0x5bd1e995).Fill(expected.data(), expected.size());
+  if (initial != nullptr && out_length > 0) {
+    memcpy(expected.data() + before, initial, out_length);
+  }
+  memcpy(dst - before, expected.data(), expected.size());
+
+  run(expected.data() + before, true);
+  run(dst, false);
+
+  const uint8_t* actual = dst - before;
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (actual[i] == expected[i]) continue;
+    long offset = static_cast<long>(i) - static_cast<long>(before);
+    Fail("byte " + std::to_string(offset) + " of the output is " +
+         std::to_string(actual[i]) + ", expected " +
+         std::to_string(expected[i]));
+    return;
+  }
+}
+
+// Offsets into data of what a search kernel returned, or -1 for NULL.
+long Offset(const uint8_t* result, const uint8_t* data) {
+  return result == nullptr ? -1 : static_cast<long>(result - data);
+}
+
+int Sign(int value) {
+  return (value > 0) - (value < 0);
+}
+
+// Checks every span kernel of funcs against scalar on current.length bytes
+// at data, with `other` and `out` for second inputs and outputs.
+void CheckSpanKernels(const simd_functions_t* funcs,
+                      const simd_functions_t* scalar,
+                      const uint8_t* data,
+                      const GuardedBuffer& other,
+                      const GuardedBuffer& out) {
+  const size_t length = current.length;
+  const uint8_t probe =
+      current.pattern == Pattern::kRandom ? (length > 0 ? data[length / 2] : 0)
+                                          : kNeedle;
+
+  if (funcs->find_byte != nullptr && Selected("find_byte")) {
+    current.kernel = "find_byte";
+    for (uint8_t value : {probe, uint8_t{0}, uint8_t{0xff}}) {
+      Expect(Offset(funcs->find_byte(data, length, value), data),
+             Offset(scalar->find_byte(data, length, value), data),
+             "offset");
+    }
+  }
+
+  if (funcs->find_last_byte != nullptr && Selected("find_last_byte")) {
+    current.kernel = "find_last_byte";
+    for (uint8_t value : {probe, uint8_t{0}, uint8_t{0xff}}) {
+      Expect(Offset(funcs->find_last_byte(data, length, value), data),
+             Offset(scalar->find_last_byte(data, length, value), data),
+             "offset");
+    }
+  }
+
+  if (funcs->find_byte_pair != nullptr && Selected("find_byte_pair")) {
+    current.kernel = "find_byte_pair";
+    for (size_t distance : {1, 2, 3, 7, 15, 16, 17, 31, 64}) {
+      if (distance > length) continue;
+      // data[count + distance - 1] is the last byte of the input.
+      const size_t count = length - distance;
+      for (auto [first, last] : {std::make_pair(kBackground, kNeedle),
+                                 std::make_pair(kNeedle, kBackground),
+                                 std::make_pair(probe, probe)}) {
+        Expect(Offset(funcs->find_byte_pair(data, count, first, last,
+                                            distance), data),
+               Offset(scalar->find_byte_pair(data, count, first, last,
+                                             distance), data),
+               ("offset at distance " + std::to_string(distance)).c_str());
+      }
+    }
+  }
+
+  if (funcs->compare_bytes != nullptr && Selected("compare_bytes")) {
+    current.kernel = "compare_bytes";
+    uint8_t* copy = other.Place(length, current.misalign ^ 5, current.at_end);
+    if (length > 0) memcpy(copy, data, length);
+    Expect(Sign(funcs->compare_bytes(data, copy, length)), 0, "sign");
+    // One differing byte at each of the needle positions.
+    if (length > 0) {
+      size_t position = current.pattern == Pattern::kNeedleFirst ? 0
+                        : current.pattern == Pattern::kNeedleLast
+                            ? length - 1
+                            : length / 2;
+      copy[position] ^= 0x80;
+      Expect(Sign(funcs->compare_bytes(data, copy, length)),
+             Sign(scalar->compare_bytes(data, copy, length)),
+             "sign");
+      Expect(Sign(funcs->compare_bytes(copy, data, length)),
+             Sign(scalar->compare_bytes(copy, data, length)),
+             "reversed sign");
+    }
+  }
+
+  if (funcs->copy_bytes != nullptr && Selected("copy_bytes")) {
+    current.kernel = "copy_bytes";
+    CheckOutput(out, length, nullptr, [&](uint8_t* dst, bool reference) {
+      (reference ? scalar : funcs)->copy_bytes(dst, data, length);
+    });
+  }
+
+  if (funcs->fill_bytes != nullptr && Selected("fill_bytes")) {
+    current.kernel = "fill_bytes";
+    for (uint8_t value : {probe, uint8_t{0}}) {
+      CheckOutput(out, length, nullptr, [&](uint8_t* dst, bool reference) {
+        (reference ? scalar : funcs)->fill_bytes(dst, value, length);
+      });
+    }
+  }
+
+  if (funcs->xor_bytes != nullptr && Selected("xor_bytes")) {
+    current.kernel = "xor_bytes";
+    CheckOutput(out, length, nullptr, [&](uint8_t* dst, bool reference) {
+      (reference ? scalar : funcs)->xor_bytes(dst, data, length);
+    });
+  }
+
+  if (funcs->mask_bytes != nullptr && Selected("mask_bytes")) {
+    current.kernel = "mask_bytes";
+    uint8_t mask[4];
+    Random(current.seed).Fill(mask, sizeof(mask));
+    CheckOutput(out, length, nullptr, [&](uint8_t* dst, bool reference) {
+      (reference ? scalar : funcs)->mask_bytes(dst, data, length, mask);
+    });
+    // In place.
+    CheckOutput(out, length, data, [&](uint8_t* dst, bool reference) {
+      (reference ? scalar : funcs)->mask_bytes(dst, dst, length, mask);
+    });
+  }
+
+  if (funcs->sum_bytes != nullptr && Selected("sum_bytes")) {
+    current.kernel = "sum_bytes";
+    Expect(funcs->sum_bytes(data, length), scalar->sum_bytes(data, length),
+           "sum");
+  }
+
+  if (funcs->min_max_bytes != nullptr && Selected("min_max_bytes")) {
+    current.kernel = "min_max_bytes";
+    uint8_t min, max, expected_min, expected_max;
+    funcs->min_max_bytes(data, length, &min, &max);
+    scalar->min_max_bytes(data, length, &expected_min, &expected_max);
+    Expect(min, expected_min, "min");
+    Expect(max, expected_max, "max");
+  }
+
+  if (funcs->validate_ascii != nullptr && Selected("validate_ascii")) {
+    current.kernel = "validate_ascii";
+    Expect(funcs->validate_ascii(data, length) != 0,
+           scalar->validate_ascii(data, length) != 0,
+           "result");
+  }
+
+  if (funcs->hex_encode != nullptr && Selected("hex_encode")) {
+    current.kernel = "hex_encode";
+    CheckOutput(out, 2 * length, nullptr, [&](uint8_t* dst, bool reference) {
+      (reference ? scalar : funcs)
+          ->hex_encode(reinterpret_cast<char*>(dst), data, length);
+    });
+  }
+
+  auto check_swap = [&](const char* kernel, auto member, size_t size) {
+    if (funcs->*member == nullptr || !Selected(kernel)) return;
+    current.kernel = kernel;
+    const size_t count = length / size;
+    CheckOutput(out, count * size, data, [&](uint8_t* dst, bool reference) {
+      ((reference ? scalar : funcs)->*member)(dst, count);
+    });
+  };
+  check_swap("swap_bytes16", &simd_functions_t::swap_bytes16, 2);
+  check_swap("swap_bytes32", &simd_functions_t::swap_bytes32, 4);
+  check_swap("swap_bytes64", &simd_functions_t::swap_bytes64, 8);
+}
+
+// Float results may differ in the last place: 3DNow! is not IEEE exact.
+bool CloseEnough(float actual, float expected) {
+  int32_t a, b;
+  memcpy(&a, &actual, sizeof(a));
+  memcpy(&b, &expected, sizeof(b));
+  if (a == b) return true;
+  if ((a < 0) != (b < 0)) return actual == expected;  // +0 and -0
+  return std::abs(static_cast<int64_t>(a) - b) <= 1;
+}
+
+// Checks the single vector kernels of funcs on unaligned random values.
+void CheckVectorKernels(const simd_functions_t* funcs,
+                        const simd_functions_t* scalar,
+                        const GuardedBuffer& memory) {
+  Random random(current.seed);
+  // Kept finite and normal: 3DNow! has no infinities, NaNs or denormals.
+  auto random_float = [&] {
+    int32_t integer = static_cast<int32_t>(random.Next() % 2000001) - 1000000;
+    return static_cast<float>(integer) / 64.0f;
+  };
+  uint8_t* base = memory.Place(64, current.misalign, current.at_end);
+  uint8_t* a = base;
+  uint8_t* b = base + 16;
+  uint8_t* result = base + 32;
+  float fa[4], fb[4], expected[4], actual[4];
+  for (int i = 0; i < 4; i++) {
+    fa[i] = random_float();
+    fb[i] = random_float();
+  }
+
+  struct FloatKernel {
+    const char* name;
+    void (*simd_functions_t::*member)(void*, void*, void*);
+  };
+  for (const FloatKernel& kernel :
+       {FloatKernel{"add_ps", &simd_functions_t::add_ps},
+        FloatKernel{"mul_ps", &simd_functions_t::mul_ps},
+        FloatKernel{"sub_ps", &simd_functions_t::sub_ps}}) {
+    if (funcs->*kernel.member == nullptr || !Selected(kernel.name)) continue;
+    current.kernel = kernel.name;
+    (scalar->*kernel.member)(fa, fb, expected);
+    memcpy(a, fa, sizeof(fa));
+    memcpy(b, fb, sizeof(fb));
+    (funcs->*kernel.member)(a, b, result);
+    memcpy(actual, result, sizeof(actual));
+    for (int i = 0; i < 4; i++) {
+      if (!CloseEnough(actual[i], expected[i])) {
+        Fail("lane " + std::to_string(i) + " is " + std::to_string(actual[i]) +
+             ", expected " + std::to_string(expected[i]));
+      }
+    }
+  }
+
+  int32_t ia[4], ib[4], iexpected[4], iactual[4];
+  for (int i = 0; i < 4; i++) {
+    ia[i] = static_cast<int32_t>(random.Next());
+    ib[i] = static_cast<int32_t>(random.Next());
+  }
+  memcpy(a, ia, sizeof(ia));
+  memcpy(b, ib, sizeof(ib));
+  if (funcs->add_epi32 != nullptr && Selected("add_epi32")) {
+    current.kernel = "add_epi32";
+    scalar->add_epi32(ia, ib, iexpected);
+    funcs->add_epi32(a, b, result);
+    memcpy(iactual, result, sizeof(iactual));
+    for (int i = 0; i < 4; i++) Expect(iactual[i], iexpected[i], "lane");
+  }
+  if (funcs->shuffle_epi32 != nullptr && Selected("shuffle_epi32")) {
+    current.kernel = "shuffle_epi32";
+    const int mask = static_cast<int>(random.Next() & 0xff);
+    scalar->shuffle_epi32(ia, mask, iexpected);
+    funcs->shuffle_epi32(a, mask, result);
+    memcpy(iactual, result, sizeof(iactual));
+    for (int i = 0; i < 4; i++) Expect(iactual[i], iexpected[i], "lane");
+    // In place, as callers are allowed to do.
+    funcs->shuffle_epi32(a, mask, a);
+    memcpy(iactual, a, sizeof(iactual));
+    for (int i = 0; i < 4; i++) {
+      Expect(iactual[i], iexpected[i], "in place lane");
+    }
+  }
+}
+
+// Every instruction set compiled in and supported by this CPU, scalar last.
+std::vector<std::pair<simd_instruction_set_t, const simd_functions_t*>>
+Implementations() {
+  std::vector<std::pair<simd_instruction_set_t, const simd_functions_t*>> ret;
+  for (simd_instruction_set_t isa : {SIMD_SSE2,
+                                     SIMD_3DNOWEXT,
+                                     SIMD_3DNOW,
+                                     SIMD_MMXEXT,
+                                     SIMD_ALTIVEC,
+                                     SIMD_SCALAR}) {
+    const simd_functions_t* funcs = get_simd_functions_for(isa);
+    if (funcs != nullptr) ret.emplace_back(isa, funcs);
+  }
+  return ret;
+}
+
+// A length for the random phase: mostly short, sometimes up to the maximum,
+// so that both the tails and the main loops get their share.
+size_t RandomLength(Random* random) {
+  const size_t bits = random->Below(17);
+  return random->Below((size_t{1} << bits) + 1);
+}
+
+void CheckSimdKernels(const GuardedBuffer& input,
+                      const GuardedBuffer& other,
+                      const GuardedBuffer& out) {
+  const simd_functions_t* scalar = get_simd_functions_for(SIMD_SCALAR);
+  for (const auto& [isa, funcs] : Implementations()) {
+    if (isa == SIMD_SCALAR) continue;
+    current.implementation = get_simd_instruction_set_name(isa);
+
+    for (size_t length = 0; length <= kMaxExhaustiveLength; length++) {
+      for (size_t misalign = 0; misalign < kAlignments; misalign++) {
+        for (bool at_end : {false, true}) {
+          for (Pattern pattern : kPatterns) {
+            current.length = length;
+            current.misalign = misalign;
+            current.at_end = at_end;
+            current.pattern = pattern;
+            current.seed = static_cast<uint32_t>(length * 131 + misalign);
+            uint8_t* data = input.Place(length, misalign, at_end);
+            FillPattern(data, length, pattern, current.seed);
+            CheckSpanKernels(funcs, scalar, data, other, out);
+          }
+        }
+      }
+    }
+
+    Random random(options->seed);
+    for (size_t i = 0; i < options->iterations; i++) {
+      current.length = RandomLength(&random);
+      current.misalign = random.Below(kAlignments);
+      current.at_end = (random.Next() & 1) != 0;
+      current.pattern = kPatterns[random.Below(std::size(kPatterns))];
+      current.seed = random.Next();
+      uint8_t* data =
+          input.Place(current.length, current.misalign, current.at_end);
+      FillPattern(data, current.length, current.pattern, current.seed);
+      CheckSpanKernels(funcs, scalar, data, other, out);
+      CheckVectorKernels(funcs, scalar, out);
+    }
+  }
+}
+
+struct ZlibFlag {
+  const char* name;
+  int* flag;
+};
+
+// The flags zlib dispatches adler32 and crc32 on, best first. Clearing them
+// one at a time runs each implementation down to the portable one.
+std::vector<ZlibFlag> ZlibFlags() {
+  std::vector<ZlibFlag> flags;
+#if defined(SIMD_ARCH_X86)
+  if (x86_cpu_enable_avx512) {
+    flags.push_back({"avx512", &x86_cpu_enable_avx512});
+  }
+  if (x86_cpu_enable_simd) {
+    flags.push_back({"sse42-pclmul", &x86_cpu_enable_simd});
+  }
+  if (x86_cpu_enable_ssse3) {
+    flags.push_back({"ssse3", &x86_cpu_enable_ssse3});
+  }
+#elif defined(SIMD_ARCH_PPC)
+  if (ppc_cpu_enable_altivec) {
+    flags.push_back({"altivec", &ppc_cpu_enable_altivec});
+  }
+#endif
+  return flags;
+}
+
+void CheckZlib(const GuardedBuffer& input) {
+  cpu_check_features();
+  std::vector<ZlibFlag> flags = ZlibFlags();
+  if (flags.empty()) return;
+
+  // Each case is run with every flag set and then with fewer and fewer of
+  // them, down to none, which is the reference.
+  auto check = [&](const uint8_t* data, size_t length) {
+    const uInt size = static_cast<uInt>(length);
+    std::vector<std::pair<uLong, uLong>> results;
+    for (size_t cleared = 0; cleared <= flags.size(); cleared++) {
+      results.emplace_back(adler32(1, data, size), crc32(0, data, size));
+      if (cleared < flags.size()) *flags[cleared].flag = 0;
+    }
+    for (const ZlibFlag& flag : flags) *flag.flag = 1;
+    const auto& [expected_adler, expected_crc] = results.back();
+    for (size_t i = 0; i + 1 < results.size(); i++) {
+      current.implementation = flags[i].name;
+      if (Selected("adler32")) {
+        current.kernel = "adler32";
+        Expect(results[i].first, expected_adler, "checksum");
+      }
+      if (Selected("crc32")) {
+        current.kernel = "crc32";
+        Expect(results[i].second, expected_crc, "checksum");
+      }
+    }
+  };
+
+  for (size_t length = 0; length <= kMaxExhaustiveLength; length++) {
+    for (size_t misalign = 0; misalign < kAlignments; misalign++) {
+      for (bool at_end : {false, true}) {
+        current.length = length;
+        current.misalign = misalign;
+        current.at_end = at_end;
+        current.pattern = Pattern::kRandom;
+        current.seed = static_cast<uint32_t>(length * 131 + misalign);
+        uint8_t* data = input.Place(length, misalign, at_end);
+        FillPattern(data, length, Pattern::kRandom, current.seed);
+        check(data, length);
+      }
+    }
+  }
+
+  Random random(options->seed);
+  for (size_t i = 0; i < options->iterations / 10; i++) {
+    current.length = RandomLength(&random);
+    current.misalign = random.Below(kAlignments);
+    current.at_end = (random.Next() & 1) != 0;
+    current.pattern = kPatterns[random.Below(std::size(kPatterns))];
+    current.seed = random.Next();
+    uint8_t* data =
+        input.Place(current.length, current.misalign, current.at_end);
+    FillPattern(data, current.length, current.pattern, current.seed);
+    check(data, current.length);
+  }
+}
+
+// Valid UTF-8 with one to four byte sequences, cut at length, so that the
+// tail is as likely to hold a truncated sequence as a complete one.
+void FillUtf8(uint8_t* data, size_t length, uint32_t seed) {
+  static const char* const kSequences[] = {
+      "a", "Z", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", " "};
+  Random random(seed);
+  size_t i = 0;
+  while (i < length) {
+    const char* sequence = kSequences[random.Below(std::size(kSequences))];
+    for (; *sequence != '\0' && i < length; sequence++) data[i++] = *sequence;
+  }
+}
+
+void CheckSimdutf(const GuardedBuffer& input, const GuardedBuffer& out) {
+  const simdutf::implementation* fallback =
+      simdutf::get_available_implementations()["fallback"];
+  if (fallback == nullptr) return;
+
+  auto check = [&](const simdutf::implementation* impl, const uint8_t* data) {
+    const char* text = reinterpret_cast<const char*>(data);
+    const size_t length = current.length;
+    if (Selected("validate_utf8")) {
+      current.kernel = "validate_utf8";
+      Expect(impl->validate_utf8(text, length),
+             fallback->validate_utf8(text, length),
+             "result");
+    }
+    if (Selected("validate_ascii")) {
+      current.kernel = "validate_ascii";
+      Expect(impl->validate_ascii(text, length),
+             fallback->validate_ascii(text, length),
+             "result");
+    }
+    if (Selected("base64_encode")) {
+      current.kernel = "base64_encode";
+      const size_t out_length = simdutf::base64_length_from_binary(length);
+      CheckOutput(out, out_length, nullptr, [&](uint8_t* dst, bool reference) {
+        (reference ? fallback : impl)
+            ->binary_to_base64(text, length, reinterpret_cast<char*>(dst));
+      });
+    }
+  };
+
+  for (const simdutf::implementation* impl :
+       simdutf::get_available_implementations()) {
+    if (!impl->supported_by_runtime_system() || impl == fallback) continue;
+    const std::string name = impl->name();
+    current.implementation = name.c_str();
+
+    for (size_t length = 0; length <= kMaxExhaustiveLength; length++) {
+      for (size_t misalign = 0; misalign < kAlignments; misalign++) {
+        for (bool at_end : {false, true}) {
+          current.length = length;
+          current.misalign = misalign;
+          current.at_end = at_end;
+          current.pattern = Pattern::kRandom;
+          current.seed = static_cast<uint32_t>(length * 131 + misalign);
+          uint8_t* data = input.Place(length, misalign, at_end);
+          FillUtf8(data, length, current.seed);
+          check(impl, data);
+        }
+      }
+    }
+
+    Random random(options->seed);
+    for (size_t i = 0; i < options->iterations / 10; i++) {
+      current.length = RandomLength(&random);
+      current.misalign = random.Below(kAlignments);
+      current.at_end = (random.Next() & 1) != 0;
+      current.pattern = kPatterns[random.Below(std::size(kPatterns))];
+      current.seed = random.Next();
+      uint8_t* data =
+          input.Place(current.length, current.misalign, current.at_end);
+      // Half text that is valid up to its tail, half the usual patterns.
+      if ((current.seed & 1) != 0) {
+        FillUtf8(data, current.length, current.seed);
+      } else {
+        FillPattern(data, current.length, current.pattern, current.seed);
+      }
+      check(impl, data);
+    }
+  }
+}
+
+struct Bucket {
+  size_t min;
+  size_t max;
+  const char* name;
+};
+
+constexpr Bucket kBuckets[] = {{1, 16, "1-16"},
+                               {17, 64, "17-64"},
+                               {65, 256, "65-256"},
+                               {257, 4096, "257-4K"},
+                               {4097, 64 * 1024, "4K-64K"}};
+
+// Runs a span kernel on (src, dst, length).
+using Runner = std::function<void(const uint8_t*, uint8_t*, size_t)>;
+
+// Up to 64 lengths spread evenly over the bucket; the time of a pass over
+// all of them, at varying alignments, gives the bucket's throughput.
+std::vector<size_t> BucketLengths(const Bucket& bucket) {
+  std::vector<size_t> lengths;
+  const size_t count = std::min<size_t>(64, bucket.max - bucket.min + 1);
+  for (size_t i = 0; i < count; i++) {
+    lengths.push_back(bucket.min + (bucket.max - bucket.min) * i /
+                                       std::max<size_t>(count - 1, 1));
+  }
+  return lengths;
+}
+
+// Returns MB/s of run(src, dst, length) over the lengths of the bucket, at
+// the best of three rounds of at least 10ms each.
+double MeasureBucket(const Bucket& bucket,
+                     const GuardedBuffer& input,
+                     const GuardedBuffer& out,
+                     const Runner& run) {
+  using Clock = std::chrono::steady_clock;
+  const std::vector<size_t> lengths = BucketLengths(bucket);
+  size_t bytes_per_pass = 0;
+  for (size_t length : lengths) bytes_per_pass += length;
+  auto pass = [&] {
+    size_t misalign = 0;
+    for (size_t length : lengths) {
+      run(input.begin() + misalign, out.begin() + misalign, length);
+      misalign = (misalign + 1) % kAlignments;
+    }
+  };
+
+  size_t passes = 1;
+  for (;;) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < passes; i++) pass();
+    if (Clock::now() - start >= std::chrono::milliseconds(10)) break;
+    passes *= 2;
+  }
+
+  double best = 0;
+  for (int round = 0; round < 3; round++) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < passes; i++) pass();
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    best = std::max(best, bytes_per_pass * passes / seconds / 1e6);
+  }
+  return best;
+}
+
+volatile uint64_t result_sink;
+
+// The span kernels of funcs that this CPU runs, as comparable runners.
+std::vector<std::pair<const char*, Runner>> SpanRunners(
+    const simd_functions_t* funcs) {
+  std::vector<std::pair<const char*, Runner>> runners;
+  auto add = [&](const char* name, bool present, Runner runner) {
+    if (present && Selected(name)) runners.emplace_back(name, runner);
+  };
+  // The inputs hold no 0x80 byte, so the searches scan all of them.
+  add("find_byte", funcs->find_byte != nullptr,
+      [funcs](const uint8_t* src, uint8_t*, size_t length) {
+        result_sink = reinterpret_cast<uintptr_t>(
+            funcs->find_byte(src, length, 0x80));
+      });
+  add("find_last_byte", funcs->find_last_byte != nullptr,
+      [funcs](const uint8_t* src, uint8_t*, size_t length) {
+        result_sink = reinterpret_cast<uintptr_t>(
+            funcs->find_last_byte(src, length, 0x80));
+      });
+  add("compare_bytes", funcs->compare_bytes != nullptr,
+      [funcs](const uint8_t* src, uint8_t*, size_t length) {
+        result_sink = funcs->compare_bytes(src, src, length);
+      });
+  add("copy_bytes", funcs->copy_bytes != nullptr,
+      [funcs](const uint8_t* src, uint8_t* dst, size_t length) {
+        funcs->copy_bytes(dst, src, length);
+      });
+  add("fill_bytes", funcs->fill_bytes != nullptr,
+      [funcs](const uint8_t*, uint8_t* dst, size_t length) {
+        funcs->fill_bytes(dst, 0x41, length);
+      });
+  add("xor_bytes", funcs->xor_bytes != nullptr,
+      [funcs](const uint8_t* src, uint8_t* dst, size_t length) {
+        funcs->xor_bytes(dst, src, length);
+      });
+  add("mask_bytes", funcs->mask_bytes != nullptr,
+      [funcs](const uint8_t* src, uint8_t* dst, size_t length) {
+        static const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+        funcs->mask_bytes(dst, src, length, mask);
+      });
+  add("sum_bytes", funcs->sum_bytes != nullptr,
+      [funcs](const uint8_t* src, uint8_t*, size_t length) {
+        result_sink = funcs->sum_bytes(src, length);
+      });
+  add("min_max_bytes", funcs->min_max_bytes != nullptr,
+      [funcs](const uint8_t* src, uint8_t*, size_t length) {
+        uint8_t min, max;
+        funcs->min_max_bytes(src, length, &min, &max);
+        result_sink = min ^ max;
+      });
+  add("swap_bytes16", funcs->swap_bytes16 != nullptr,
+      [funcs](const uint8_t*, uint8_t* dst, size_t length) {
+        funcs->swap_bytes16(dst, length / 2);
+      });
+  add("swap_bytes32", funcs->swap_bytes32 != nullptr,
+      [funcs](const uint8_t*, uint8_t* dst, size_t length) {
+        funcs->swap_bytes32(dst, length / 4);
+      });
+  add("swap_bytes64", funcs->swap_bytes64 != nullptr,
+      [funcs](const uint8_t*, uint8_t* dst, size_t length) {
+        funcs->swap_bytes64(dst, length / 8);
+      });
+  add("validate_ascii", funcs->validate_ascii != nullptr,
+      [funcs](const uint8_t* src, uint8_t*, size_t length) {
+        result_sink = funcs->validate_ascii(src, length);
+      });
+  add("hex_encode", funcs->hex_encode != nullptr,
+      [funcs](const uint8_t* src, uint8_t* dst, size_t length) {
+        funcs->hex_encode(reinterpret_cast<char*>(dst), src, length);
+      });
+  return runners;
+}
+
+void Bench(const GuardedBuffer& input, const GuardedBuffer& out) {
+  for (size_t i = 0; i < kMaxRandomLength + kAlignments; i++) {
+    input.begin()[i] = static_cast<uint8_t>(i * 31) & 0x7f;
+  }
+
+  printf("\n%-24s", "MB/s");
+  for (const Bucket& bucket : kBuckets) printf(" %11s", bucket.name);
+  printf("\n");
+
+  const simd_functions_t* scalar = get_simd_functions_for(SIMD_SCALAR);
+  std::vector<std::pair<const char*, Runner>> scalar_runners =
+      SpanRunners(scalar);
+  std::vector<std::vector<double>> scalar_rates;
+  for (const auto& [name, runner] : scalar_runners) {
+    std::vector<double> rates;
+    for (const Bucket& bucket : kBuckets) {
+      rates.push_back(MeasureBucket(bucket, input, out, runner));
+    }
+    scalar_rates.push_back(std::move(rates));
+  }
+
+  for (const auto& [isa, funcs] : Implementations()) {
+    const char* implementation = get_simd_instruction_set_name(isa);
+    std::vector<std::pair<const char*, Runner>> runners = SpanRunners(funcs);
+    for (size_t k = 0; k < runners.size(); k++) {
+      const auto& [name, runner] = runners[k];
+      std::string label = std::string(name) + "/" + implementation;
+      printf("%-24s", label.c_str());
+      // The scalar table has every kernel, in the same order.
+      size_t s = 0;
+      while (strcmp(scalar_runners[s].first, name) != 0) s++;
+      for (size_t b = 0; b < std::size(kBuckets); b++) {
+        double rate = isa == SIMD_SCALAR
+                          ? scalar_rates[s][b]
+                          : MeasureBucket(kBuckets[b], input, out, runner);
+        printf(" %10.1f%c", rate, rate < scalar_rates[s][b] ? '!' : ' ');
+      }
+      printf("\n");
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options parsed;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--filter=", 9) == 0) {
+      parsed.filter = argv[i] + 9;
+    } else if (strncmp(argv[i], "--iterations=", 13) == 0) {
+      parsed.iterations = strtoul(argv[i] + 13, nullptr, 10);
+    } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+      parsed.seed = static_cast<uint32_t>(strtoul(argv[i] + 7, nullptr, 10));
+    } else if (strcmp(argv[i], "--no-bench") == 0) {
+      parsed.bench = false;
+    } else {
+      fprintf(stderr,
+              "usage: %s [--filter=<substring>] [--iterations=<count>] "
+              "[--seed=<n>] [--no-bench]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  options = &parsed;
+
+  std::signal(SIGSEGV, OnCrash);
+#ifdef SIGBUS
+  std::signal(SIGBUS, OnCrash);
+#endif
+
+  GuardedBuffer input(kMaxRandomLength + kAlignments);
+  GuardedBuffer other(kMaxRandomLength + kAlignments);
+  GuardedBuffer out(2 * kMaxRandomLength + kAlignments);
+
+  CheckSimdKernels(input, other, out);
+  CheckZlib(input);
+  CheckSimdutf(input, out);
+  printf("%zu mismatches (seed %u)\n", failures, parsed.seed);
+
+  if (parsed.bench) Bench(input, out);
+  return failures == 0 ? 0 : 1;
+}
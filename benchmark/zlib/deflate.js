@@ -0,0 +1,30 @@
+'use strict';
+const common = require('../common.js');
+const zlib = require('zlib');
+
+const bench = common.createBenchmark(main, {
+  method: ['deflateSync', 'inflateSync', 'gzipSync', 'gunzipSync'],
+  level: [1, 6],
+  len: [1024, 1 << 20],
+  n: [64 << 20],
+});
+
+function main({ method, level, len, n }) {
+  // Compressible, but not trivially so.
+  const words = ['alpha', 'beta', 'gamma', 'delta', 'epsilon', 'zeta', 'eta'];
+  let text = '';
+  for (let i = 0; text.length < len; i++) {
+    text += words[(i * 7919) % words.length] + (i % 13 === 0 ? '\n' : ' ');
+  }
+  const input = Buffer.from(text.slice(0, len));
+  const options = { level };
+  let data = input;
+  if (method === 'inflateSync') data = zlib.deflateSync(input, options);
+  if (method === 'gunzipSync') data = zlib.gzipSync(input, options);
+  const fn = zlib[method];
+  const iterations = Math.max(1, Math.floor(n / len));
+
+  bench.start();
+  for (let i = 0; i < iterations; i++) fn(data, options);
+  bench.end(iterations);
+}
@@ -72,11 +72,11 @@ fi
 # Set environment variables to use 64-bit PowerPC compilation with AltiVec support
 # Do NOT use -mvsx flag as Power Mac G5 doesn't support VSX instructions
 # Also define the correct endianness for PowerPC (big-endian) to fix OpenSSL endianness issue
-# Disable PowerPC-specific simdjson implementation that requires VSX instructions
+# simdjson's ppc64 kernel falls back to AltiVec-only code when VSX is not enabled
 # Disable problematic V8 write barrier optimizations that cause issues on PowerPC64
-export CC="gcc -m64 -mcpu=G5 -mtune=G5 -maltivec -mabi=altivec -DSIMDUTF_NO_VSX -DSIMDJSON_IMPLEMENTATION_PPC64=0"
-export CXX="g++ -m64 -mcpu=G5 -mtune=G5 -maltivec -mabi=altivec -DSIMDUTF_NO_VSX -DSIMDJSON_IMPLEMENTATION_PPC64=0"
-export CPP="cpp -m64 -mcpu=G5 -mtune=G5 -maltivec -mabi=altivec -DSIMDUTF_NO_VSX -DSIMDJSON_IMPLEMENTATION_PPC64=0"
+export CC="gcc -m64 -mcpu=G5 -mtune=G5 -maltivec -mabi=altivec -DSIMDUTF_NO_VSX"
+export CXX="g++ -m64 -mcpu=G5 -mtune=G5 -maltivec -mabi=altivec -DSIMDUTF_NO_VSX"
+export CPP="cpp -m64 -mcpu=G5 -mtune=G5 -maltivec -mabi=altivec -DSIMDUTF_NO_VSX"
 
 # Additionally set the architecture for GYP to ensure correct OpenSSL config is used
 # Include endianness information to help Node.js build system make correct decisions
@@ -91,9 +91,10 @@ export GYP_LDFLAGS="'-m64' '-mminimal-toc'"
 export GYP_ARFLAGS="rcs"
 
 # Apply endianness correction flags specifically for OpenSSL and other affected libraries
-# Also reduce optimization levels to avoid problematic code generation on PowerPC64
-export CFLAGS="$CFLAGS -DB_ENDIAN -UL_ENDIAN -O1"
-export CXXFLAGS="$CXXFLAGS -DB_ENDIAN -UL_ENDIAN -O1"
+# The optimization level is left to the gyp files: code GCC miscompiles on
+# PowerPC64, and the targets too large to build at -O3, are handled there
+export CFLAGS="$CFLAGS -DB_ENDIAN -UL_ENDIAN"
+export CXXFLAGS="$CXXFLAGS -DB_ENDIAN -UL_ENDIAN"
 export CPPFLAGS="$CPPFLAGS -DB_ENDIAN -UL_ENDIAN"
 export LDFLAGS="$LDFLAGS -m64 -mminimal-toc"
 
@@ -111,9 +112,27 @@ CONFIGURE_CMD=("/usr/bin/env" "python3" "./configure")
 CONFIGURE_CMD+=("--dest-cpu=ppc64")
 CONFIGURE_CMD+=("--dest-os=linux")
 CONFIGURE_CMD+=("--without-inspector")
-CONFIGURE_CMD+=("--without-node-snapshot")
+# The startup snapshot and the builtin code cache are generated by running
+# the freshly built node_mksnapshot, which is a ppc64 binary. Elsewhere it is
+# run under qemu-user when available. Either way they are written in the G5's
+# byte order and loaded without conversions.
+if [ "$(uname -m)" != "ppc64" ]; then
+  if command -v qemu-ppc64 > /dev/null; then
+    CONFIGURE_CMD+=("--node-mksnapshot-runner=qemu-ppc64 -L ${QEMU_LD_PREFIX:-/usr/powerpc64-linux-gnu}")
+  else
+    echo "qemu-ppc64 not found, configuring without the startup snapshot"
+    CONFIGURE_CMD+=("--without-node-snapshot")
+  fi
+fi
 CONFIGURE_CMD+=("--with-simd-support=altivec")
-CONFIGURE_CMD+=("--openssl-no-asm")
+CONFIGURE_CMD+=("--with-memory-profile=low")
+# OpenSSL's ppc64 perlasm (AltiVec/VSX AES, GHASH, ChaCha20) dispatches at
+# runtime through OPENSSL_ppccap, so only fall back to the C code when the
+# generated asm configuration is not available.
+if [ ! -f deps/openssl/config/archs/linux-ppc64/asm/openssl.gypi ]; then
+  echo "Warning: no ppc64 asm configuration for OpenSSL, using --openssl-no-asm"
+  CONFIGURE_CMD+=("--openssl-no-asm")
+fi
 
 if [ "$WITH_NPM" = false ]; then
   CONFIGURE_CMD+=("--without-npm")
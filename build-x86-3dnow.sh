@@ -76,8 +76,15 @@ CONFIGURE_CMD=("/usr/bin/env" "python3" "./configure")
 CONFIGURE_CMD+=("--dest-cpu=ia32")
 CONFIGURE_CMD+=("--dest-os=linux")
 CONFIGURE_CMD+=("--without-inspector")
-CONFIGURE_CMD+=("--without-node-snapshot")
+# Building the snapshot on the Athlon itself runs out of memory. An x86-64
+# host can run the ia32 node_mksnapshot directly, given 32-bit libraries.
+if [ "$(uname -m)" = "x86_64" ]; then
+  CONFIGURE_CMD+=("--node-mksnapshot-runner=env")
+else
+  CONFIGURE_CMD+=("--without-node-snapshot")
+fi
 CONFIGURE_CMD+=("--with-simd-support=3dnow")
+CONFIGURE_CMD+=("--with-memory-profile=low")
 
 if [ "$WITH_NPM" = false ]; then
   CONFIGURE_CMD+=("--without-npm")
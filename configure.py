@@ -120,6 +120,13 @@ parser.add_argument('--with-simd-support',
     default='auto',
     help="SIMD instruction set support to enable (sse2, 3dnow, altivec, auto, none) [default: %(default)s]")
 
+parser.add_argument('--with-memory-profile',
+    action='store',
+    dest='memory_profile',
+    choices=['default', 'low'],
+    default='default',
+    help='default value of the --memory-profile runtime option [default: %(default)s]')
+
 parser.add_argument('--cross-compiling',
     action='store_true',
     dest='cross_compiling',
@@ -813,6 +820,15 @@ parser.add_argument('--without-node-code-cache',
     default=None,
     help='Turn off V8 Code cache integration.')
 
+parser.add_argument('--node-mksnapshot-runner',
+    action='store',
+    dest='node_mksnapshot_runner',
+    default=None,
+    help='command to run the target node_mksnapshot with when cross '
+         'compiling, e.g. "qemu-ppc64 -L /usr/powerpc64-linux-gnu", or "env" '
+         'when the host can run target binaries directly. This lets cross '
+         'builds include the startup snapshot and code cache.')
+
 intl_optgroup.add_argument('--download',
     action='store',
     dest='download_list',
@@ -842,6 +858,18 @@ parser.add_argument('--without-amaro',
     default=None,
     help='do not install the bundled Amaro (TypeScript utils)')
 
+parser.add_argument('--with-usdt',
+    action='store_true',
+    dest='with_usdt',
+    default=None,
+    help='build with USDT probes for bpftrace and SystemTap (needs <sys/sdt.h>)')
+
+parser.add_argument('--with-allocation-counting',
+    action='store_true',
+    dest='with_allocation_counting',
+    default=None,
+    help='count native allocations per async callback (Linux/glibc only)')
+
 parser.add_argument('--without-npm',
     action='store_true',
     dest='without_npm',
@@ -1566,6 +1594,11 @@ def configure_node(o):
   o['variables']['node_install_corepack'] = b(options.with_corepack)
   o['variables']['control_flow_guard'] = b(options.enable_cfg)
   o['variables']['node_use_amaro'] = b(not options.without_amaro)
+  o['variables']['node_use_usdt'] = b(options.with_usdt)
+  if options.with_allocation_counting and flavor != 'linux':
+    error('--with-allocation-counting is only supported on Linux')
+  o['variables']['node_use_allocation_counting'] = \
+    b(options.with_allocation_counting)
   o['variables']['debug_node'] = b(options.debug_node)
   o['variables']['build_type%'] = 'Debug' if options.debug else 'Release'
   o['default_configuration'] = 'Debug' if options.debug else 'Release'
@@ -1626,6 +1659,7 @@ def configure_node(o):
     o['variables']['node_enable_altivec'] = 'false'
 
   o['variables']['node_simd_support'] = simd_support
+  o['variables']['node_default_memory_profile'] = options.memory_profile
 
   cross_compiling = (options.cross_compiling
                      if options.cross_compiling is not None
@@ -1648,15 +1682,23 @@ def configure_node(o):
     if options.without_node_snapshot:
       error('--node-snapshot-main is incompatible with ' +
             '--without-node-snapshot')
-    if cross_compiling:
-      error('--node-snapshot-main is incompatible with cross compilation')
+    if cross_compiling and options.node_mksnapshot_runner is None:
+      error('--node-snapshot-main is incompatible with cross compilation '
+            'without --node-mksnapshot-runner')
     o['variables']['node_snapshot_main'] = options.node_snapshot_main
 
+  # node_mksnapshot is built for the target, so a cross build can only run
+  # it through a runner, such as qemu-user.
+  can_run_mksnapshot = (not cross_compiling or
+                        options.node_mksnapshot_runner is not None)
+  o['variables']['node_mksnapshot_runner'] = shlex.split(
+      options.node_mksnapshot_runner or '')
+
   if options.without_node_snapshot or options.node_builtin_modules_path:
     o['variables']['node_use_node_snapshot'] = 'false'
   else:
     o['variables']['node_use_node_snapshot'] = b(
-      not cross_compiling and not options.shared)
+      can_run_mksnapshot and not options.shared)
 
   # Do not use code cache when Node.js is built for collecting coverage of itself, this allows more
   # precise coverage for the JS built-ins.
@@ -1665,7 +1707,7 @@ def configure_node(o):
   else:
     # TODO(refack): fix this when implementing embedded code-cache when cross-compiling.
     o['variables']['node_use_node_code_cache'] = b(
-      not cross_compiling and not options.shared)
+      can_run_mksnapshot and not options.shared)
 
   if options.write_snapshot_as_array_literals is not None:
      o['variables']['node_write_snapshot_as_array_literals'] = b(options.write_snapshot_as_array_literals)
@@ -1976,6 +2018,14 @@ def configure_openssl(o):
     warn('''--openssl-no-asm will result in binaries that do not take advantage
          of modern CPU cryptographic instructions and will therefore be slower.
          Please refer to BUILDING.md''')
+    # OpenSSL's perlasm code picks its MMX/SSE2/AltiVec paths at runtime
+    # (OPENSSL_ia32cap, OPENSSL_ppccap), so it is the asm build, not the
+    # SIMD switch, that decides whether TLS uses them.
+    if variables.get('node_simd_support', 'none') != 'none':
+      warn(f'''--with-simd-support={variables['node_simd_support']} does not
+         apply to OpenSSL when it is built with --openssl-no-asm. Its assembly
+         selects SIMD code at runtime and can be restricted with the
+         OPENSSL_ia32cap or OPENSSL_ppccap environment variables instead.''')
 
   if options.openssl_no_asm and options.shared_openssl:
     error('--openssl-no-asm is incompatible with --shared-openssl')
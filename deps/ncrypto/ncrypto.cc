@@ -1921,9 +1921,14 @@ DataPointer argon2(const Buffer<const char>& pass,
                    uint32_t version,
                    const Buffer<const unsigned char>& secret,
                    const Buffer<const unsigned char>& ad,
-                   Argon2Type type) {
+                   Argon2Type type,
+                   uint32_t threads) {
   ClearErrorOnReturn clearErrorOnReturn;
 
+  // Lanes are computed in parallel by up to `threads` threads, one per lane
+  // when it is zero. The result does not depend on the thread count.
+  if (threads == 0 || threads > lanes) threads = lanes;
+
   std::string_view algorithm;
   switch (type) {
     case Argon2Type::ARGON2I:
@@ -1947,7 +1952,7 @@ DataPointer argon2(const Buffer<const char>& pass,
   }
 
   // required if threads > 1
-  if (lanes > 1 && OSSL_set_max_threads(ctx.get(), lanes) != 1) {
+  if (threads > 1 && OSSL_set_max_threads(ctx.get(), threads) != 1) {
     return {};
   }
 
@@ -1972,7 +1977,8 @@ DataPointer argon2(const Buffer<const char>& pass,
       pass.len));
   params.push_back(OSSL_PARAM_construct_octet_string(
       OSSL_KDF_PARAM_SALT, const_cast<unsigned char*>(salt.data), salt.len));
-  params.push_back(OSSL_PARAM_construct_uint32(OSSL_KDF_PARAM_THREADS, &lanes));
+  params.push_back(
+      OSSL_PARAM_construct_uint32(OSSL_KDF_PARAM_THREADS, &threads));
   params.push_back(
       OSSL_PARAM_construct_uint32(OSSL_KDF_PARAM_ARGON2_LANES, &lanes));
   params.push_back(
@@ -1637,7 +1637,8 @@ DataPointer argon2(const Buffer<const char>& pass,
                    uint32_t version,
                    const Buffer<const unsigned char>& secret,
                    const Buffer<const unsigned char>& ad,
-                   Argon2Type type);
+                   Argon2Type type,
+                   uint32_t threads = 0);
 #endif
 #endif
 
@@ -28494,6 +28494,22 @@ simdjson_inline internal::value128 full_multiplication(uint64_t value1, uint64_t
 
 #include <type_traits>
 
+// A G5 (PPC970) has AltiVec but neither VSX nor the other POWER8 additions
+// used below: unaligned lxvw4x/stxvw4x loads and stores, vbpermq for the
+// movemask and 64-bit lanes. Without VSX, loads go through lvsl/vperm,
+// stores through memory, and the movemask is a vec_sum4s/vec_sum2s gather.
+// Every such processor runs big endian.
+#ifndef SIMDJSON_PPC64_VSX
+#if defined(__VSX__)
+#define SIMDJSON_PPC64_VSX 1
+#else
+#define SIMDJSON_PPC64_VSX 0
+#endif
+#endif
+#if !SIMDJSON_PPC64_VSX && defined(__LITTLE_ENDIAN__)
+#error "the ppc64 kernel requires VSX on little endian"
+#endif
+
 namespace simdjson {
 namespace ppc64 {
 namespace {
@@ -28501,6 +28517,23 @@ namespace simd {
 
 using __m128i = __vector unsigned char;
 
+#if !SIMDJSON_PPC64_VSX
+// The second lvx only touches the block that holds src[15], which is
+// always readable when src[15] is.
+simdjson_inline __m128i load_unaligned(const uint8_t *src) {
+  return vec_perm(vec_ld(0, src), vec_ld(15, src), vec_lvsl(0, src));
+}
+
+simdjson_inline void store_unaligned(const __m128i value, uint8_t *dst) {
+  union {
+    __m128i v;
+    uint8_t bytes[16];
+  } u;
+  u.v = value;
+  std::memcpy(dst, u.bytes, sizeof(u.bytes));
+}
+#endif // !SIMDJSON_PPC64_VSX
+
 template <typename Child> struct base {
   __m128i value;
 
@@ -28589,6 +28622,7 @@ template <> struct simd8<bool> : base8<bool> {
       : base8<bool>(splat(_value)) {}
 
   simdjson_inline int to_bitmask() const {
+#if SIMDJSON_PPC64_VSX
     __vector unsigned long long result;
     const __m128i perm_mask = {0x78, 0x70, 0x68, 0x60, 0x58, 0x50, 0x48, 0x40,
                                0x38, 0x30, 0x28, 0x20, 0x18, 0x10, 0x08, 0x00};
@@ -28599,6 +28633,20 @@ template <> struct simd8<bool> : base8<bool> {
     return static_cast<int>(result[1]);
 #else
     return static_cast<int>(result[0]);
+#endif
+#else
+    // Weight each byte by its bit, then add up the bytes of each half.
+    // Element 0 is the lowest address, on big endian.
+    const __m128i weights = {1, 2, 4, 8, 16, 32, 64, 128,
+                             1, 2, 4, 8, 16, 32, 64, 128};
+    __vector unsigned int sums = vec_sum4s(vec_and(this->value, weights),
+                                           vec_splat_u32(0));
+    union {
+      int32_t words[4];
+      __vector signed int v;
+    } halves;
+    halves.v = vec_sum2s((__vector signed int)sums, vec_splat_s32(0));
+    return halves.words[1] | (halves.words[3] << 8);
 #endif
   }
   simdjson_inline bool any() const {
@@ -28616,7 +28664,11 @@ template <typename T> struct base8_numeric : base8<T> {
   }
   static simdjson_inline simd8<T> zero() { return splat(0); }
   static simdjson_inline simd8<T> load(const T values[16]) {
+#if SIMDJSON_PPC64_VSX
     return (__m128i)(vec_vsx_ld(0, reinterpret_cast<const uint8_t *>(values)));
+#else
+    return load_unaligned(reinterpret_cast<const uint8_t *>(values));
+#endif
   }
   // Repeat 16 values as many times as necessary (usually for lookup tables)
   static simdjson_inline simd8<T> repeat_16(T v0, T v1, T v2, T v3, T v4,
@@ -28633,7 +28685,11 @@ template <typename T> struct base8_numeric : base8<T> {
 
   // Store to array
   simdjson_inline void store(T dst[16]) const {
+#if SIMDJSON_PPC64_VSX
     vec_vsx_st(this->value, 0, reinterpret_cast<__m128i *>(dst));
+#else
+    store_unaligned(this->value, reinterpret_cast<uint8_t *>(dst));
+#endif
   }
 
   // Override to distinguish from bool version
@@ -28683,10 +28739,20 @@ template <typename T> struct base8_numeric : base8<T> {
 #ifdef __LITTLE_ENDIAN__
     __m128i shufmask = (__m128i)(__vector unsigned long long){
         thintable_epi8[mask1], thintable_epi8[mask2]};
-#else
+#elif SIMDJSON_PPC64_VSX
     __m128i shufmask = (__m128i)(__vector unsigned long long){
         thintable_epi8[mask2], thintable_epi8[mask1]};
     shufmask = (__m128i)vec_reve((__m128i)shufmask);
+#else
+    // No 64-bit lanes: byte swap the entries so that their first index is
+    // at the lowest address.
+    union {
+      uint64_t words[2];
+      __m128i v;
+    } thin;
+    thin.words[0] = __builtin_bswap64(thintable_epi8[mask1]);
+    thin.words[1] = __builtin_bswap64(thintable_epi8[mask2]);
+    __m128i shufmask = thin.v;
 #endif
     // we increment by 0x08 the second half of the mask
     shufmask = ((__m128i)shufmask) +
@@ -28701,10 +28767,16 @@ template <typename T> struct base8_numeric : base8<T> {
     // only the first pop1 bytes from the first 8 bytes, and then
     // it fills in with the bytes from the second 8 bytes + some filling
     // at the end.
+#if SIMDJSON_PPC64_VSX
     __m128i compactmask =
         vec_vsx_ld(0, reinterpret_cast<const uint8_t *>(pshufb_combine_table + pop1 * 8));
     __m128i answer = vec_perm(pruned, (__m128i)vec_splats(0), compactmask);
     vec_vsx_st(answer, 0, reinterpret_cast<__m128i *>(output));
+#else
+    __m128i compactmask = load_unaligned(pshufb_combine_table + pop1 * 8);
+    __m128i answer = vec_perm(pruned, (__m128i)vec_splats(0), compactmask);
+    store_unaligned(answer, reinterpret_cast<uint8_t *>(output));
+#endif
   }
 
   template <typename L>
@@ -31341,6 +31413,22 @@ simdjson_inline internal::value128 full_multiplication(uint64_t value1, uint64_t
 
 #include <type_traits>
 
+// A G5 (PPC970) has AltiVec but neither VSX nor the other POWER8 additions
+// used below: unaligned lxvw4x/stxvw4x loads and stores, vbpermq for the
+// movemask and 64-bit lanes. Without VSX, loads go through lvsl/vperm,
+// stores through memory, and the movemask is a vec_sum4s/vec_sum2s gather.
+// Every such processor runs big endian.
+#ifndef SIMDJSON_PPC64_VSX
+#if defined(__VSX__)
+#define SIMDJSON_PPC64_VSX 1
+#else
+#define SIMDJSON_PPC64_VSX 0
+#endif
+#endif
+#if !SIMDJSON_PPC64_VSX && defined(__LITTLE_ENDIAN__)
+#error "the ppc64 kernel requires VSX on little endian"
+#endif
+
 namespace simdjson {
 namespace ppc64 {
 namespace {
@@ -31348,6 +31436,23 @@ namespace simd {
 
 using __m128i = __vector unsigned char;
 
+#if !SIMDJSON_PPC64_VSX
+// The second lvx only touches the block that holds src[15], which is
+// always readable when src[15] is.
+simdjson_inline __m128i load_unaligned(const uint8_t *src) {
+  return vec_perm(vec_ld(0, src), vec_ld(15, src), vec_lvsl(0, src));
+}
+
+simdjson_inline void store_unaligned(const __m128i value, uint8_t *dst) {
+  union {
+    __m128i v;
+    uint8_t bytes[16];
+  } u;
+  u.v = value;
+  std::memcpy(dst, u.bytes, sizeof(u.bytes));
+}
+#endif // !SIMDJSON_PPC64_VSX
+
 template <typename Child> struct base {
   __m128i value;
 
@@ -31436,6 +31541,7 @@ template <> struct simd8<bool> : base8<bool> {
       : base8<bool>(splat(_value)) {}
 
   simdjson_inline int to_bitmask() const {
+#if SIMDJSON_PPC64_VSX
     __vector unsigned long long result;
     const __m128i perm_mask = {0x78, 0x70, 0x68, 0x60, 0x58, 0x50, 0x48, 0x40,
                                0x38, 0x30, 0x28, 0x20, 0x18, 0x10, 0x08, 0x00};
@@ -31446,6 +31552,20 @@ template <> struct simd8<bool> : base8<bool> {
     return static_cast<int>(result[1]);
 #else
     return static_cast<int>(result[0]);
+#endif
+#else
+    // Weight each byte by its bit, then add up the bytes of each half.
+    // Element 0 is the lowest address, on big endian.
+    const __m128i weights = {1, 2, 4, 8, 16, 32, 64, 128,
+                             1, 2, 4, 8, 16, 32, 64, 128};
+    __vector unsigned int sums = vec_sum4s(vec_and(this->value, weights),
+                                           vec_splat_u32(0));
+    union {
+      int32_t words[4];
+      __vector signed int v;
+    } halves;
+    halves.v = vec_sum2s((__vector signed int)sums, vec_splat_s32(0));
+    return halves.words[1] | (halves.words[3] << 8);
 #endif
   }
   simdjson_inline bool any() const {
@@ -31463,7 +31583,11 @@ template <typename T> struct base8_numeric : base8<T> {
   }
   static simdjson_inline simd8<T> zero() { return splat(0); }
   static simdjson_inline simd8<T> load(const T values[16]) {
+#if SIMDJSON_PPC64_VSX
     return (__m128i)(vec_vsx_ld(0, reinterpret_cast<const uint8_t *>(values)));
+#else
+    return load_unaligned(reinterpret_cast<const uint8_t *>(values));
+#endif
   }
   // Repeat 16 values as many times as necessary (usually for lookup tables)
   static simdjson_inline simd8<T> repeat_16(T v0, T v1, T v2, T v3, T v4,
@@ -31480,7 +31604,11 @@ template <typename T> struct base8_numeric : base8<T> {
 
   // Store to array
   simdjson_inline void store(T dst[16]) const {
+#if SIMDJSON_PPC64_VSX
     vec_vsx_st(this->value, 0, reinterpret_cast<__m128i *>(dst));
+#else
+    store_unaligned(this->value, reinterpret_cast<uint8_t *>(dst));
+#endif
   }
 
   // Override to distinguish from bool version
@@ -31530,10 +31658,20 @@ template <typename T> struct base8_numeric : base8<T> {
 #ifdef __LITTLE_ENDIAN__
     __m128i shufmask = (__m128i)(__vector unsigned long long){
         thintable_epi8[mask1], thintable_epi8[mask2]};
-#else
+#elif SIMDJSON_PPC64_VSX
     __m128i shufmask = (__m128i)(__vector unsigned long long){
         thintable_epi8[mask2], thintable_epi8[mask1]};
     shufmask = (__m128i)vec_reve((__m128i)shufmask);
+#else
+    // No 64-bit lanes: byte swap the entries so that their first index is
+    // at the lowest address.
+    union {
+      uint64_t words[2];
+      __m128i v;
+    } thin;
+    thin.words[0] = __builtin_bswap64(thintable_epi8[mask1]);
+    thin.words[1] = __builtin_bswap64(thintable_epi8[mask2]);
+    __m128i shufmask = thin.v;
 #endif
     // we increment by 0x08 the second half of the mask
     shufmask = ((__m128i)shufmask) +
@@ -31548,10 +31686,16 @@ template <typename T> struct base8_numeric : base8<T> {
     // only the first pop1 bytes from the first 8 bytes, and then
     // it fills in with the bytes from the second 8 bytes + some filling
     // at the end.
+#if SIMDJSON_PPC64_VSX
     __m128i compactmask =
         vec_vsx_ld(0, reinterpret_cast<const uint8_t *>(pshufb_combine_table + pop1 * 8));
     __m128i answer = vec_perm(pruned, (__m128i)vec_splats(0), compactmask);
     vec_vsx_st(answer, 0, reinterpret_cast<__m128i *>(output));
+#else
+    __m128i compactmask = load_unaligned(pshufb_combine_table + pop1 * 8);
+    __m128i answer = vec_perm(pruned, (__m128i)vec_splats(0), compactmask);
+    store_unaligned(answer, reinterpret_cast<uint8_t *>(output));
+#endif
   }
 
   template <typename L>
@@ -54373,10 +54517,167 @@ simdjson_inline int leading_zeroes(uint64_t input_num) {
 /* amalgamation skipped (editor-only): #include "simdjson/fallback/base.h" */
 /* amalgamation skipped (editor-only): #endif // SIMDJSON_CONDITIONAL_INCLUDE */
 
+// On CPUs simdjson has no kernel for (a 32-bit PowerPC G4, a pre-SSE2 Athlon) the
+// fallback kernel is the one On-Demand is built against, so let it scan
+// strings a vector at a time with what those CPUs do have: 16-byte AltiVec
+// or 8-byte MMX blocks. Both read up to a block past the current position,
+// which SIMDJSON_PADDING covers.
+#ifndef SIMDJSON_FALLBACK_ALTIVEC
+#if defined(__ALTIVEC__) && defined(__BIG_ENDIAN__)
+#define SIMDJSON_FALLBACK_ALTIVEC 1
+#else
+#define SIMDJSON_FALLBACK_ALTIVEC 0
+#endif
+#endif
+
+#ifndef SIMDJSON_FALLBACK_MMX
+#if !SIMDJSON_FALLBACK_ALTIVEC && (defined(__i386__) || defined(_M_IX86)) && defined(__MMX__) && defined(__GNUC__)
+#define SIMDJSON_FALLBACK_MMX 1
+#else
+#define SIMDJSON_FALLBACK_MMX 0
+#endif
+#endif
+
+#if SIMDJSON_FALLBACK_ALTIVEC
+#include <altivec.h>
+
+// These are defined by altivec.h in GCC toolchain, it is safe to undef them.
+#ifdef bool
+#undef bool
+#endif
+
+#ifdef vector
+#undef vector
+#endif
+#elif SIMDJSON_FALLBACK_MMX
+#include <mmintrin.h>
+#endif
+
 namespace simdjson {
 namespace fallback {
 namespace {
 
+#if SIMDJSON_FALLBACK_ALTIVEC || SIMDJSON_FALLBACK_MMX
+#if SIMDJSON_FALLBACK_ALTIVEC
+static constexpr uint32_t STRING_BLOCK_SIZE = 16;
+typedef __vector unsigned char string_block;
+
+simdjson_inline string_block load_string_block(const uint8_t *src) {
+  // lvsl/vperm unaligned load; the second lvx only touches the block that
+  // holds src[15], which is still inside the padding.
+  return vec_perm(vec_ld(0, src), vec_ld(15, src), vec_lvsl(0, src));
+}
+
+simdjson_inline uint32_t string_block_bitmask(__vector __bool char m) {
+  // AltiVec has no movemask: weight each byte by its bit, then add the
+  // bytes of each half. Element 0 is the lowest address on big endian.
+  const string_block weights = {1, 2, 4, 8, 16, 32, 64, 128,
+                                1, 2, 4, 8, 16, 32, 64, 128};
+  __vector unsigned int sums = vec_sum4s(vec_and((string_block)m, weights),
+                                         vec_splat_u32(0));
+  union {
+    int32_t words[4];
+    __vector signed int v;
+  } halves;
+  halves.v = vec_sum2s((__vector signed int)sums, vec_splat_s32(0));
+  return uint32_t(halves.words[1]) | (uint32_t(halves.words[3]) << 8);
+}
+
+simdjson_inline uint32_t string_block_match(string_block v, uint8_t c) {
+  return string_block_bitmask(vec_cmpeq(v, vec_splats((unsigned char)(c))));
+}
+
+// '"', '\\', control characters and non-ASCII bytes: everything a string
+// scan has to stop at. Signed, both of the last two are below 0x20.
+simdjson_inline uint32_t string_block_stops(string_block v) {
+  __vector __bool char low = vec_cmplt((__vector signed char)v,
+                                       vec_splats((signed char)(0x20)));
+  __vector __bool char quote = vec_cmpeq(v, vec_splats((unsigned char)('"')));
+  __vector __bool char bs = vec_cmpeq(v, vec_splats((unsigned char)('\\')));
+  return string_block_bitmask(vec_or(low, vec_or(quote, bs)));
+}
+
+simdjson_inline void leave_string_blocks() {}
+#else // SIMDJSON_FALLBACK_MMX
+static constexpr uint32_t STRING_BLOCK_SIZE = 8;
+typedef __m64 string_block;
+
+simdjson_inline string_block load_string_block(const uint8_t *src) {
+  string_block v;
+  std::memcpy(&v, src, sizeof(v));
+  return v;
+}
+
+simdjson_inline uint32_t string_block_bitmask(__m64 m) {
+#if !defined(__clang__) && (defined(__3dNOW_A__) || defined(__SSE__))
+  return uint32_t(__builtin_ia32_pmovmskb((__v8qi)m));
+#else
+  // Plain MMX has no pmovmskb: gather the top bit of each byte of a half
+  // with one multiply (the partial products never overlap).
+  uint32_t lo = uint32_t(_mm_cvtsi64_si32(m)) & 0x80808080;
+  uint32_t hi = uint32_t(_mm_cvtsi64_si32(_mm_srli_si64(m, 32))) & 0x80808080;
+  return ((lo * 0x00204081) >> 28) | (((hi * 0x00204081) >> 28) << 4);
+#endif
+}
+
+simdjson_inline uint32_t string_block_match(string_block v, uint8_t c) {
+  return string_block_bitmask(_mm_cmpeq_pi8(v, _mm_set1_pi8(char(c))));
+}
+
+// '"', '\\', control characters and non-ASCII bytes: everything a string
+// scan has to stop at. Signed, both of the last two are below 0x20.
+simdjson_inline uint32_t string_block_stops(string_block v) {
+  __m64 low = _mm_cmpgt_pi8(_mm_set1_pi8(0x20), v);
+  __m64 quote = _mm_cmpeq_pi8(v, _mm_set1_pi8('"'));
+  __m64 bs = _mm_cmpeq_pi8(v, _mm_set1_pi8('\\'));
+  return string_block_bitmask(_mm_or_si64(low, _mm_or_si64(quote, bs)));
+}
+
+// The MMX registers alias the x87 stack: empty them before any scalar code
+// that might use floating point runs.
+simdjson_inline void leave_string_blocks() { _mm_empty(); }
+#endif
+
+// Returns the index of the first byte at or after idx that
+// string_block_stops() flags, or len if there is none before len.
+simdjson_inline uint32_t find_string_stop(const uint8_t *buf, uint32_t idx, uint32_t len) {
+  while (idx < len) {
+    uint32_t stops = string_block_stops(load_string_block(buf + idx));
+    if (stops) {
+      idx += uint32_t(__builtin_ctz(stops));
+      break;
+    }
+    idx += STRING_BLOCK_SIZE;
+  }
+  leave_string_blocks();
+  return idx < len ? idx : len;
+}
+
+// Holds backslashes and quotes locations.
+struct backslash_and_quote {
+public:
+  static constexpr uint32_t BYTES_PROCESSED = STRING_BLOCK_SIZE;
+  simdjson_inline backslash_and_quote copy_and_find(const uint8_t *src, uint8_t *dst);
+
+  simdjson_inline bool has_quote_first() { return ((bs_bits - 1) & quote_bits) != 0; }
+  simdjson_inline bool has_backslash() { return bs_bits != 0; }
+  simdjson_inline int quote_index() { return __builtin_ctz(quote_bits); }
+  simdjson_inline int backslash_index() { return __builtin_ctz(bs_bits); }
+
+  uint32_t bs_bits;
+  uint32_t quote_bits;
+}; // struct backslash_and_quote
+
+simdjson_inline backslash_and_quote backslash_and_quote::copy_and_find(const uint8_t *src, uint8_t *dst) {
+  static_assert(SIMDJSON_PADDING >= (BYTES_PROCESSED - 1), "backslash and quote finder must process fewer than SIMDJSON_PADDING bytes");
+  // store to dest unconditionally - we can overwrite the bits we don't like later
+  std::memcpy(dst, src, BYTES_PROCESSED);
+  string_block v = load_string_block(src);
+  backslash_and_quote result = { string_block_match(v, '\\'), string_block_match(v, '"') };
+  leave_string_blocks();
+  return result;
+}
+#else
 // Holds backslashes and quotes locations.
 struct backslash_and_quote {
 public:
@@ -54396,6 +54697,7 @@ simdjson_inline backslash_and_quote backslash_and_quote::copy_and_find(const uin
   dst[0] = src[0];
   return { src[0] };
 }
+#endif // SIMDJSON_FALLBACK_ALTIVEC || SIMDJSON_FALLBACK_MMX
 
 
 struct escaping {
@@ -56602,10 +56904,167 @@ simdjson_inline int leading_zeroes(uint64_t input_num) {
 /* amalgamation skipped (editor-only): #include "simdjson/fallback/base.h" */
 /* amalgamation skipped (editor-only): #endif // SIMDJSON_CONDITIONAL_INCLUDE */
 
+// On CPUs simdjson has no kernel for (a 32-bit PowerPC G4, a pre-SSE2 Athlon) the
+// fallback kernel is the one On-Demand is built against, so let it scan
+// strings a vector at a time with what those CPUs do have: 16-byte AltiVec
+// or 8-byte MMX blocks. Both read up to a block past the current position,
+// which SIMDJSON_PADDING covers.
+#ifndef SIMDJSON_FALLBACK_ALTIVEC
+#if defined(__ALTIVEC__) && defined(__BIG_ENDIAN__)
+#define SIMDJSON_FALLBACK_ALTIVEC 1
+#else
+#define SIMDJSON_FALLBACK_ALTIVEC 0
+#endif
+#endif
+
+#ifndef SIMDJSON_FALLBACK_MMX
+#if !SIMDJSON_FALLBACK_ALTIVEC && (defined(__i386__) || defined(_M_IX86)) && defined(__MMX__) && defined(__GNUC__)
+#define SIMDJSON_FALLBACK_MMX 1
+#else
+#define SIMDJSON_FALLBACK_MMX 0
+#endif
+#endif
+
+#if SIMDJSON_FALLBACK_ALTIVEC
+#include <altivec.h>
+
+// These are defined by altivec.h in GCC toolchain, it is safe to undef them.
+#ifdef bool
+#undef bool
+#endif
+
+#ifdef vector
+#undef vector
+#endif
+#elif SIMDJSON_FALLBACK_MMX
+#include <mmintrin.h>
+#endif
+
 namespace simdjson {
 namespace fallback {
 namespace {
 
+#if SIMDJSON_FALLBACK_ALTIVEC || SIMDJSON_FALLBACK_MMX
+#if SIMDJSON_FALLBACK_ALTIVEC
+static constexpr uint32_t STRING_BLOCK_SIZE = 16;
+typedef __vector unsigned char string_block;
+
+simdjson_inline string_block load_string_block(const uint8_t *src) {
+  // lvsl/vperm unaligned load; the second lvx only touches the block that
+  // holds src[15], which is still inside the padding.
+  return vec_perm(vec_ld(0, src), vec_ld(15, src), vec_lvsl(0, src));
+}
+
+simdjson_inline uint32_t string_block_bitmask(__vector __bool char m) {
+  // AltiVec has no movemask: weight each byte by its bit, then add the
+  // bytes of each half. Element 0 is the lowest address on big endian.
+  const string_block weights = {1, 2, 4, 8, 16, 32, 64, 128,
+                                1, 2, 4, 8, 16, 32, 64, 128};
+  __vector unsigned int sums = vec_sum4s(vec_and((string_block)m, weights),
+                                         vec_splat_u32(0));
+  union {
+    int32_t words[4];
+    __vector signed int v;
+  } halves;
+  halves.v = vec_sum2s((__vector signed int)sums, vec_splat_s32(0));
+  return uint32_t(halves.words[1]) | (uint32_t(halves.words[3]) << 8);
+}
+
+simdjson_inline uint32_t string_block_match(string_block v, uint8_t c) {
+  return string_block_bitmask(vec_cmpeq(v, vec_splats((unsigned char)(c))));
+}
+
+// '"', '\\', control characters and non-ASCII bytes: everything a string
+// scan has to stop at. Signed, both of the last two are below 0x20.
+simdjson_inline uint32_t string_block_stops(string_block v) {
+  __vector __bool char low = vec_cmplt((__vector signed char)v,
+                                       vec_splats((signed char)(0x20)));
+  __vector __bool char quote = vec_cmpeq(v, vec_splats((unsigned char)('"')));
+  __vector __bool char bs = vec_cmpeq(v, vec_splats((unsigned char)('\\')));
+  return string_block_bitmask(vec_or(low, vec_or(quote, bs)));
+}
+
+simdjson_inline void leave_string_blocks() {}
+#else // SIMDJSON_FALLBACK_MMX
+static constexpr uint32_t STRING_BLOCK_SIZE = 8;
+typedef __m64 string_block;
+
+simdjson_inline string_block load_string_block(const uint8_t *src) {
+  string_block v;
+  std::memcpy(&v, src, sizeof(v));
+  return v;
+}
+
+simdjson_inline uint32_t string_block_bitmask(__m64 m) {
+#if !defined(__clang__) && (defined(__3dNOW_A__) || defined(__SSE__))
+  return uint32_t(__builtin_ia32_pmovmskb((__v8qi)m));
+#else
+  // Plain MMX has no pmovmskb: gather the top bit of each byte of a half
+  // with one multiply (the partial products never overlap).
+  uint32_t lo = uint32_t(_mm_cvtsi64_si32(m)) & 0x80808080;
+  uint32_t hi = uint32_t(_mm_cvtsi64_si32(_mm_srli_si64(m, 32))) & 0x80808080;
+  return ((lo * 0x00204081) >> 28) | (((hi * 0x00204081) >> 28) << 4);
+#endif
+}
+
+simdjson_inline uint32_t string_block_match(string_block v, uint8_t c) {
+  return string_block_bitmask(_mm_cmpeq_pi8(v, _mm_set1_pi8(char(c))));
+}
+
+// '"', '\\', control characters and non-ASCII bytes: everything a string
+// scan has to stop at. Signed, both of the last two are below 0x20.
+simdjson_inline uint32_t string_block_stops(string_block v) {
+  __m64 low = _mm_cmpgt_pi8(_mm_set1_pi8(0x20), v);
+  __m64 quote = _mm_cmpeq_pi8(v, _mm_set1_pi8('"'));
+  __m64 bs = _mm_cmpeq_pi8(v, _mm_set1_pi8('\\'));
+  return string_block_bitmask(_mm_or_si64(low, _mm_or_si64(quote, bs)));
+}
+
+// The MMX registers alias the x87 stack: empty them before any scalar code
+// that might use floating point runs.
+simdjson_inline void leave_string_blocks() { _mm_empty(); }
+#endif
+
+// Returns the index of the first byte at or after idx that
+// string_block_stops() flags, or len if there is none before len.
+simdjson_inline uint32_t find_string_stop(const uint8_t *buf, uint32_t idx, uint32_t len) {
+  while (idx < len) {
+    uint32_t stops = string_block_stops(load_string_block(buf + idx));
+    if (stops) {
+      idx += uint32_t(__builtin_ctz(stops));
+      break;
+    }
+    idx += STRING_BLOCK_SIZE;
+  }
+  leave_string_blocks();
+  return idx < len ? idx : len;
+}
+
+// Holds backslashes and quotes locations.
+struct backslash_and_quote {
+public:
+  static constexpr uint32_t BYTES_PROCESSED = STRING_BLOCK_SIZE;
+  simdjson_inline backslash_and_quote copy_and_find(const uint8_t *src, uint8_t *dst);
+
+  simdjson_inline bool has_quote_first() { return ((bs_bits - 1) & quote_bits) != 0; }
+  simdjson_inline bool has_backslash() { return bs_bits != 0; }
+  simdjson_inline int quote_index() { return __builtin_ctz(quote_bits); }
+  simdjson_inline int backslash_index() { return __builtin_ctz(bs_bits); }
+
+  uint32_t bs_bits;
+  uint32_t quote_bits;
+}; // struct backslash_and_quote
+
+simdjson_inline backslash_and_quote backslash_and_quote::copy_and_find(const uint8_t *src, uint8_t *dst) {
+  static_assert(SIMDJSON_PADDING >= (BYTES_PROCESSED - 1), "backslash and quote finder must process fewer than SIMDJSON_PADDING bytes");
+  // store to dest unconditionally - we can overwrite the bits we don't like later
+  std::memcpy(dst, src, BYTES_PROCESSED);
+  string_block v = load_string_block(src);
+  backslash_and_quote result = { string_block_match(v, '\\'), string_block_match(v, '"') };
+  leave_string_blocks();
+  return result;
+}
+#else
 // Holds backslashes and quotes locations.
 struct backslash_and_quote {
 public:
@@ -56625,6 +57084,7 @@ simdjson_inline backslash_and_quote backslash_and_quote::copy_and_find(const uin
   dst[0] = src[0];
   return { src[0] };
 }
+#endif // SIMDJSON_FALLBACK_ALTIVEC || SIMDJSON_FALLBACK_MMX
 
 
 struct escaping {
@@ -58123,10 +58583,14 @@ simdjson_inline bool char_is_ascii_stop(uint8_t c) {
 simdjson_inline bool validate_string() {
   idx++; // skip first quote
   while (idx < len) {
+#if SIMDJSON_FALLBACK_ALTIVEC || SIMDJSON_FALLBACK_MMX
+    idx = find_string_stop(buf, idx, len);
+#else
     do {
       if (char_is_ascii_stop(buf[idx])) { break; }
       idx++;
     } while (idx < len);
+#endif
     if (idx >= len) { return true; }
     if (buf[idx] == '"') {
       return false;
@@ -263,8 +263,10 @@ typedef struct uv_metrics_s uv_metrics_t;
 typedef enum {
   UV_LOOP_BLOCK_SIGNAL = 0,
   UV_METRICS_IDLE_TIME,
-  UV_LOOP_USE_IO_URING_SQPOLL
+  UV_LOOP_USE_IO_URING_SQPOLL,
 #define UV_LOOP_USE_IO_URING_SQPOLL UV_LOOP_USE_IO_URING_SQPOLL
+  UV_METRICS_PHASE_TIME
+#define UV_METRICS_PHASE_TIME UV_METRICS_PHASE_TIME
 } uv_loop_option;
 
 typedef enum {
@@ -1191,6 +1193,27 @@ UV_EXTERN int uv_queue_work(uv_loop_t* loop,
                             uv_work_cb work_cb,
                             uv_after_work_cb after_work_cb);
 
+/*
+ * The kind of work passed to uv_queue_work_ex(). uv_queue_work() always
+ * queues UV_WORK_CPU work. The threadpool runs UV_WORK_SLOW_IO work on at
+ * most UV_THREADPOOL_SLOW_IO_SIZE threads (half the pool by default) and
+ * UV_WORK_CPU work on at most UV_THREADPOOL_CPU_SIZE threads (the whole pool
+ * by default), so that the remaining threads stay available for file system
+ * requests.
+ */
+typedef enum {
+  UV_WORK_CPU,
+  UV_WORK_FAST_IO,
+  UV_WORK_SLOW_IO
+} uv_work_kind;
+#define UV_HAVE_QUEUE_WORK_EX 1
+
+UV_EXTERN int uv_queue_work_ex(uv_loop_t* loop,
+                               uv_work_t* req,
+                               uv_work_kind kind,
+                               uv_work_cb work_cb,
+                               uv_after_work_cb after_work_cb);
+
 UV_EXTERN int uv_cancel(uv_req_t* req);
 
 
@@ -1391,6 +1414,27 @@ struct uv_metrics_s {
 UV_EXTERN int uv_metrics_info(uv_loop_t* loop, uv_metrics_t* metrics);
 UV_EXTERN uint64_t uv_metrics_idle_time(uv_loop_t* loop);
 
+/* The phases of a loop iteration, in the order in which uv_run() runs them.
+ * UV_METRICS_PHASE_POLL includes the time spent blocked waiting for events,
+ * which is what uv_metrics_idle_time() reports when UV_METRICS_IDLE_TIME is
+ * also set.
+ */
+typedef enum {
+  UV_METRICS_PHASE_PENDING,
+  UV_METRICS_PHASE_IDLE_PREPARE,
+  UV_METRICS_PHASE_POLL,
+  UV_METRICS_PHASE_CHECK,
+  UV_METRICS_PHASE_CLOSING,
+  UV_METRICS_PHASE_TIMERS,
+  UV_METRICS_PHASE_MAX
+} uv_metrics_phase;
+
+/* Total time spent in `phase`, in nanoseconds, since the loop was configured
+ * with UV_METRICS_PHASE_TIME. Must be called from the loop's thread.
+ */
+UV_EXTERN uint64_t uv_metrics_phase_time(uv_loop_t* loop,
+                                         uv_metrics_phase phase);
+
 typedef enum {
   UV_FS_UNKNOWN = -1,
   UV_FS_CUSTOM,
@@ -29,21 +29,60 @@
 
 #define MAX_THREADPOOL_SIZE 1024
 
+/* Work of a throttled kind waits in its own pending queue. A single run
+ * message stands in for all of it in the shared queue, and a worker only
+ * takes work from it while fewer than `threshold` threads are running work
+ * of that kind. This keeps slow DNS lookups, and optionally CPU bound work,
+ * from occupying every thread and stalling file system requests.
+ */
+struct throttled_work {
+  struct uv__queue pending_wq;
+  struct uv__queue run_message;
+  unsigned int running;
+  unsigned int threshold;
+};
+
 static uv_once_t once = UV_ONCE_INIT;
 static uv_cond_t cond;
 static uv_mutex_t mutex;
 static unsigned int idle_threads;
-static unsigned int slow_io_work_running;
 static unsigned int nthreads;
 static uv_thread_t* threads;
 static uv_thread_t default_threads[4];
 static struct uv__queue exit_message;
 static struct uv__queue wq;
-static struct uv__queue run_slow_work_message;
-static struct uv__queue slow_io_pending_wq;
+static struct throttled_work slow_io_work;
+static struct throttled_work cpu_work;
+
+static struct throttled_work* throttled_work_for(enum uv__work_kind kind) {
+  if (kind == UV__WORK_SLOW_IO)
+    return &slow_io_work;
+  /* CPU work is only throttled if UV_THREADPOOL_CPU_SIZE asks for it. */
+  if (kind == UV__WORK_CPU && cpu_work.threshold < nthreads)
+    return &cpu_work;
+  return NULL;
+}
+
+static struct throttled_work* throttled_work_of(struct uv__queue* q) {
+  if (q == &slow_io_work.run_message)
+    return &slow_io_work;
+  if (q == &cpu_work.run_message)
+    return &cpu_work;
+  return NULL;
+}
 
-static unsigned int slow_work_thread_threshold(void) {
-  return (nthreads + 1) / 2;
+/* Whether `wq` holds anything that a worker may run right now. */
+static int work_available(void) {
+  struct throttled_work* t;
+  struct uv__queue* q;
+
+  uv__queue_foreach(q, &wq) {
+    t = throttled_work_of(q);
+    if (t == NULL || t->running < t->threshold)
+      return 1;
+  }
+
+  return 0;
 }
 
 static void uv__cancelled(struct uv__work* w) {
@@ -55,9 +94,9 @@ static void uv__cancelled(struct uv__work* w) {
  * never holds the global mutex and the loop-local mutex at the same time.
  */
 static void worker(void* arg) {
+  struct throttled_work* throttled;
   struct uv__work* w;
   struct uv__queue* q;
-  int is_slow_work;
 
   uv_thread_setname("libuv-worker");
   uv_sem_post((uv_sem_t*) arg);
@@ -67,12 +106,9 @@ static void worker(void* arg) {
   for (;;) {
     /* `mutex` should always be locked at this point. */
 
-    /* Keep waiting while either no work is present or only slow I/O
-       and we're at the threshold for that. */
-    while (uv__queue_empty(&wq) ||
-           (uv__queue_head(&wq) == &run_slow_work_message &&
-            uv__queue_next(&run_slow_work_message) == &wq &&
-            slow_io_work_running >= slow_work_thread_threshold())) {
+    /* Keep waiting while either no work is present or only throttled work
+       whose kind is at its threshold. */
+    while (!work_available()) {
       idle_threads += 1;
       uv_cond_wait(&cond, &mutex);
       idle_threads -= 1;
@@ -88,30 +124,29 @@ static void worker(void* arg) {
     uv__queue_remove(q);
     uv__queue_init(q);  /* Signal uv_cancel() that the work req is executing. */
 
-    is_slow_work = 0;
-    if (q == &run_slow_work_message) {
-      /* If we're at the slow I/O threshold, re-schedule until after all
-         other work in the queue is done. */
-      if (slow_io_work_running >= slow_work_thread_threshold()) {
+    throttled = throttled_work_of(q);
+    if (throttled != NULL) {
+      /* If we're at the threshold for this kind of work, re-schedule until
+         after all other work in the queue is done. */
+      if (throttled->running >= throttled->threshold) {
         uv__queue_insert_tail(&wq, q);
         continue;
       }
 
-      /* If we encountered a request to run slow I/O work but there is none
+      /* If we encountered a request to run throttled work but there is none
          to run, that means it's cancelled => Start over. */
-      if (uv__queue_empty(&slow_io_pending_wq))
+      if (uv__queue_empty(&throttled->pending_wq))
         continue;
 
-      is_slow_work = 1;
-      slow_io_work_running++;
+      throttled->running++;
 
-      q = uv__queue_head(&slow_io_pending_wq);
+      q = uv__queue_head(&throttled->pending_wq);
       uv__queue_remove(q);
       uv__queue_init(q);
 
-      /* If there is more slow I/O work, schedule it to be run as well. */
-      if (!uv__queue_empty(&slow_io_pending_wq)) {
-        uv__queue_insert_tail(&wq, &run_slow_work_message);
+      /* If there is more work of this kind, schedule it to be run as well. */
+      if (!uv__queue_empty(&throttled->pending_wq)) {
+        uv__queue_insert_tail(&wq, &throttled->run_message);
         if (idle_threads > 0)
           uv_cond_signal(&cond);
       }
@@ -132,26 +167,29 @@ static void worker(void* arg) {
     /* Lock `mutex` since that is expected at the start of the next
      * iteration. */
     uv_mutex_lock(&mutex);
-    if (is_slow_work) {
-      /* `slow_io_work_running` is protected by `mutex`. */
-      slow_io_work_running--;
+    if (throttled != NULL) {
+      /* `running` is protected by `mutex`. */
+      throttled->running--;
     }
   }
 }
 
 
 static void post(struct uv__queue* q, enum uv__work_kind kind) {
+  struct throttled_work* throttled;
+
   uv_mutex_lock(&mutex);
-  if (kind == UV__WORK_SLOW_IO) {
+  throttled = throttled_work_for(kind);
+  if (throttled != NULL) {
     /* Insert into a separate queue. */
-    uv__queue_insert_tail(&slow_io_pending_wq, q);
-    if (!uv__queue_empty(&run_slow_work_message)) {
-      /* Running slow I/O tasks is already scheduled => Nothing to do here.
+    uv__queue_insert_tail(&throttled->pending_wq, q);
+    if (!uv__queue_empty(&throttled->run_message)) {
+      /* Running work of this kind is already scheduled => Nothing to do here.
          The worker that runs said other task will schedule this one as well. */
       uv_mutex_unlock(&mutex);
       return;
     }
-    q = &run_slow_work_message;
+    q = &throttled->run_message;
   }
 
   uv__queue_insert_tail(&wq, q);
@@ -173,7 +211,7 @@ void uv__threadpool_cleanup(void) {
 
 #ifndef __MVS__
   /* TODO(gabylb) - zos: revisit when Woz compiler is available. */
-  post(&exit_message, UV__WORK_CPU);
+  post(&exit_message, UV__WORK_FAST_IO);
 #endif
 
   for (i = 0; i < nthreads; i++)
@@ -191,6 +229,24 @@ void uv__threadpool_cleanup(void) {
 }
 
 
+/* Reads a thread count from the environment, capped at `nthreads`. */
+static unsigned int threshold_from_env(const char* name,
+                                       unsigned int fallback) {
+  const char* val;
+  unsigned int n;
+
+  n = fallback;
+  val = getenv(name);
+  if (val != NULL)
+    n = atoi(val);
+  if (n == 0)
+    n = 1;
+  if (n > nthreads)
+    n = nthreads;
+  return n;
+}
+
+
 static void init_threads(void) {
   uv_thread_options_t config;
   unsigned int i;
@@ -222,14 +278,24 @@ static void init_threads(void) {
     abort();
 
   uv__queue_init(&wq);
-  uv__queue_init(&slow_io_pending_wq);
-  uv__queue_init(&run_slow_work_message);
+  uv__queue_init(&slow_io_work.pending_wq);
+  uv__queue_init(&slow_io_work.run_message);
+  uv__queue_init(&cpu_work.pending_wq);
+  uv__queue_init(&cpu_work.run_message);
+  slow_io_work.running = 0;
+  cpu_work.running = 0;
+  slow_io_work.threshold =
+      threshold_from_env("UV_THREADPOOL_SLOW_IO_SIZE", (nthreads + 1) / 2);
+  cpu_work.threshold = threshold_from_env("UV_THREADPOOL_CPU_SIZE", nthreads);
 
   if (uv_sem_init(&sem, 0))
     abort();
 
   config.flags = UV_THREAD_HAS_STACK_SIZE;
   config.stack_size = 8u << 20;  /* 8 MB */
+  val = getenv("UV_THREADPOOL_STACK_SIZE");
+  if (val != NULL && atoi(val) > 0)
+    config.stack_size = (size_t) atoi(val);
 
   for (i = 0; i < nthreads; i++)
     if (uv_thread_create_ex(threads + i, &config, worker, &sem))
@@ -386,6 +452,43 @@ int uv_queue_work(uv_loop_t* loop,
 }
 
 
+int uv_queue_work_ex(uv_loop_t* loop,
+                     uv_work_t* req,
+                     uv_work_kind kind,
+                     uv_work_cb work_cb,
+                     uv_after_work_cb after_work_cb) {
+  enum uv__work_kind work_kind;
+
+  if (work_cb == NULL)
+    return UV_EINVAL;
+
+  switch (kind) {
+  case UV_WORK_CPU:
+    work_kind = UV__WORK_CPU;
+    break;
+  case UV_WORK_FAST_IO:
+    work_kind = UV__WORK_FAST_IO;
+    break;
+  case UV_WORK_SLOW_IO:
+    work_kind = UV__WORK_SLOW_IO;
+    break;
+  default:
+    return UV_EINVAL;
+  }
+
+  uv__req_init(loop, req, UV_WORK);
+  req->loop = loop;
+  req->work_cb = work_cb;
+  req->after_work_cb = after_work_cb;
+  uv__work_submit(loop,
+                  &req->work_req,
+                  work_kind,
+                  uv__queue_work,
+                  uv__queue_done);
+  return 0;
+}
+
+
 int uv_cancel(uv_req_t* req) {
   struct uv__work* wreq;
   uv_loop_t* loop;
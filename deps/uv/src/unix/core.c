@@ -425,6 +425,7 @@ int uv_loop_alive(const uv_loop_t* loop) {
 
 
 int uv_run(uv_loop_t* loop, uv_run_mode mode) {
+  uint64_t phase_start;
   int timeout;
   int r;
   int can_sleep;
@@ -438,8 +439,10 @@ int uv_run(uv_loop_t* loop, uv_run_mode mode) {
    * once, which should be done after polling in order to maintain proper
    * execution order of the conceptual event loop. */
   if (mode == UV_RUN_DEFAULT && r != 0 && loop->stop_flag == 0) {
+    phase_start = uv__metrics_phase_start(loop);
     uv__update_time(loop);
     uv__run_timers(loop);
+    uv__metrics_phase_end(loop, UV_METRICS_PHASE_TIMERS, phase_start);
   }
 
   while (r != 0 && loop->stop_flag == 0) {
@@ -447,9 +450,14 @@ int uv_run(uv_loop_t* loop, uv_run_mode mode) {
         uv__queue_empty(&loop->pending_queue) &&
         uv__queue_empty(&loop->idle_handles);
 
+    phase_start = uv__metrics_phase_start(loop);
     uv__run_pending(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_PENDING, phase_start);
     uv__run_idle(loop);
     uv__run_prepare(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_IDLE_PREPARE, phase_start);
 
     timeout = 0;
     if ((mode == UV_RUN_ONCE && can_sleep) || mode == UV_RUN_DEFAULT)
@@ -458,11 +466,15 @@ int uv_run(uv_loop_t* loop, uv_run_mode mode) {
     uv__metrics_inc_loop_count(loop);
 
     uv__io_poll(loop, timeout);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_POLL, phase_start);
 
     /* Process immediate callbacks (e.g. write_cb) a small fixed number of
      * times to avoid loop starvation.*/
     for (r = 0; r < 8 && !uv__queue_empty(&loop->pending_queue); r++)
       uv__run_pending(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_PENDING, phase_start);
 
     /* Run one final update on the provider_idle_time in case uv__io_poll
      * returned because the timeout expired, but no events were received. This
@@ -472,10 +484,15 @@ int uv_run(uv_loop_t* loop, uv_run_mode mode) {
     uv__metrics_update_idle_time(loop);
 
     uv__run_check(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_CHECK, phase_start);
     uv__run_closing_handles(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_CLOSING, phase_start);
 
     uv__update_time(loop);
     uv__run_timers(loop);
+    uv__metrics_phase_end(loop, UV_METRICS_PHASE_TIMERS, phase_start);
 
     r = uv__loop_alive(loop);
     if (mode == UV_RUN_ONCE || mode == UV_RUN_NOWAIT)
@@ -1046,7 +1046,10 @@ static ssize_t uv__fs_sendfile(uv_fs_t* req) {
 
 #ifdef __linux__
     r = uv__fs_try_copy_file_range(in_fd, &off, out_fd, len);
-    try_sendfile = (r == -1 && errno == ENOSYS);
+    /* EINVAL: out_fd is a socket or pipe, which only sendfile() can do
+     * without copying through userspace.
+     */
+    try_sendfile = (r == -1 && (errno == ENOSYS || errno == EINVAL));
 #endif
 
     if (try_sendfile)
@@ -490,7 +490,7 @@ static int uv__use_io_uring(uint32_t flags) {
 
   if (use == 0) {
     val = getenv("UV_USE_IO_URING");
-    use = val != NULL && atoi(val) > 0 ? 1 : -1;
+    use = val == NULL || atoi(val) > 0 ? 1 : -1;
     atomic_store_explicit(&use_io_uring, use, memory_order_relaxed);
   }
 
@@ -221,6 +221,11 @@ int uv__loop_configure(uv_loop_t* loop, uv_loop_option option, va_list ap) {
     return 0;
   }
 
+  if (option == UV_METRICS_PHASE_TIME) {
+    lfields->flags |= UV__METRICS_PHASE_TIME;
+    return 0;
+  }
+
 #if defined(__linux__)
   if (option == UV_LOOP_USE_IO_URING_SQPOLL) {
     loop->flags |= UV_LOOP_ENABLE_IO_URING_SQPOLL;
@@ -60,6 +60,12 @@ extern char **environ;
 # include <grp.h>
 #endif
 
+#if defined(__linux__)
+# include <sched.h>
+# include <stdatomic.h>
+# include <sys/mman.h>
+#endif
+
 #if defined(__MVS__)
 # include "zos-base.h"
 #endif
@@ -284,10 +290,97 @@ static void uv__write_errno(int error_fd) {
 }
 
 
+#if defined(__linux__)
+/* execvp() for a child that shares the parent's memory. It cannot assign
+ * environ the way the fork() flow does before calling execvp(), so it looks
+ * PATH up in the child's environment itself, which is what execvp() does
+ * after that assignment. Returns with errno set if nothing could be run. */
+static void uv__execvpe(const char* file, char* const* args, char** env) {
+  char b[PATH_MAX + NAME_MAX];
+  const char* path;
+  const char* p;
+  const char* z;
+  char** e;
+  size_t k;
+  int argc;
+  int seen_eacces;
+
+  path = NULL;
+  seen_eacces = 0;
+
+  k = strnlen(file, NAME_MAX + 1);
+  if (k > NAME_MAX) {
+    errno = ENAMETOOLONG;
+    return;
+  }
+
+  if (strchr(file, '/') == NULL) {
+    for (e = env; *e != NULL; e++)
+      if (strncmp(*e, "PATH=", 5) == 0)
+        path = *e + 5;
+    if (path == NULL)
+      path = "/bin:/usr/bin";
+  }
+
+  for (p = path;; p = z) {
+    if (p == NULL) {
+      memcpy(b, file, k + 1);
+    } else {
+      z = strchr(p, ':');
+      if (z == NULL)
+        z = p + strlen(p);
+      if ((size_t) (z - p) >= PATH_MAX) {
+        if (!*z++)
+          break;
+        continue;
+      }
+      memcpy(b, p, z - p);
+      b[z - p] = '/';
+      memcpy(b + (z - p) + (z > p), file, k + 1);
+    }
+
+    execve(b, args, env);
+
+    if (errno == ENOEXEC) {
+      /* Not a binary and without #!, so like execvp() run it with sh. */
+      argc = 0;
+      while (args[argc] != NULL)
+        argc++;
+      {
+        char* sh_args[argc + 3];
+        sh_args[0] = (char*) "/bin/sh";
+        sh_args[1] = b;
+        memcpy(sh_args + 2, args + 1, argc * sizeof(*args));
+        if (argc == 0)
+          sh_args[2] = NULL;
+        execve("/bin/sh", sh_args, env);
+      }
+      return;
+    }
+
+    if (p == NULL)
+      return;
+    if (errno == EACCES)
+      seen_eacces = 1;
+    else if (errno != ENOENT && errno != ENOTDIR)
+      return;
+    if (!*z++)
+      break;
+  }
+
+  if (seen_eacces)
+    errno = EACCES;
+}
+#endif
+
+
+/* With shares_memory set, the child runs in the parent's memory until it
+ * calls execve(), so it must not write anything the parent reads. */
 static void uv__process_child_init(const uv_process_options_t* options,
                                    int stdio_count,
                                    int (*pipes)[2],
-                                   int error_fd) {
+                                   int error_fd,
+                                   int shares_memory) {
   sigset_t signewset;
   int close_fd;
   int use_fd;
@@ -399,6 +492,19 @@ static void uv__process_child_init(const uv_process_options_t* options,
   if ((options->flags & UV_PROCESS_SETUID) && setuid(options->uid))
     uv__write_errno(error_fd);
 
+  if (shares_memory) {
+#if defined(__linux__)
+    sigemptyset(&signewset);
+    if (sigprocmask(SIG_SETMASK, &signewset, NULL) != 0)
+      abort();
+    uv__execvpe(options->file,
+                options->args,
+                options->env != NULL ? options->env : environ);
+    uv__write_errno(error_fd);
+#endif
+    abort();
+  }
+
   if (options->env != NULL)
     environ = options->env;
 
@@ -842,7 +948,7 @@ static int uv__spawn_and_init_child_fork(const uv_process_options_t* options,
 
   if (*pid == 0) {
     /* Fork succeeded, in the child process */
-    uv__process_child_init(options, stdio_count, pipes, error_fd);
+    uv__process_child_init(options, stdio_count, pipes, error_fd, 0);
     abort();
   }
 
@@ -857,6 +963,129 @@ static int uv__spawn_and_init_child_fork(const uv_process_options_t* options,
   return 0;
 }
 
+#if defined(__linux__)
+typedef struct {
+  const uv_process_options_t* options;
+  int stdio_count;
+  int (*pipes)[2];
+  int error_fd;
+} uv__spawn_clone_args_t;
+
+
+static int uv__spawn_clone_child(void* arg) {
+  uv__spawn_clone_args_t* args;
+
+  args = arg;
+  {
+    /* The child replaces pipe fds with duplicates, which must not show up in
+     * the parent's copy. */
+    int pipes[args->stdio_count][2];
+    memcpy(pipes, args->pipes, sizeof(pipes));
+    uv__process_child_init(args->options,
+                           args->stdio_count,
+                           pipes,
+                           args->error_fd,
+                           1);
+  }
+  abort();
+  return 0;
+}
+
+
+/* Whether uv__spawn_and_init_child_clone() may be used. setuid() and
+ * setgid() must not run in a child that shares the parent's memory: the C
+ * library applies them to every thread it knows of, which are the parent's.
+ * UV_SPAWN_USE_FORK=1 in the environment restores fork() everywhere. */
+static int uv__spawn_can_clone(const uv_process_options_t* options) {
+  static _Atomic int use_fork = -1;
+  const char* val;
+  int use;
+
+  if (options->flags & (UV_PROCESS_SETUID | UV_PROCESS_SETGID))
+    return 0;
+
+  use = atomic_load_explicit(&use_fork, memory_order_relaxed);
+  if (use == -1) {
+    val = getenv("UV_SPAWN_USE_FORK");
+    use = val != NULL && atoi(val) > 0;
+    atomic_store_explicit(&use_fork, use, memory_order_relaxed);
+  }
+
+  return !use;
+}
+
+
+/* Start the child with clone(CLONE_VM | CLONE_VFORK), as glibc's
+ * posix_spawn() does, instead of fork(). The parent is suspended until the
+ * child calls execve() or exits, but no page tables are copied, so spawning
+ * takes the same time however much memory the parent has mapped. */
+static int uv__spawn_and_init_child_clone(const uv_process_options_t* options,
+                                          int stdio_count,
+                                          int (*pipes)[2],
+                                          int error_fd,
+                                          pid_t* pid) {
+  uv__spawn_clone_args_t args;
+  sigset_t signewset;
+  sigset_t sigoldset;
+  size_t stack_size;
+  size_t argc;
+  void* stack;
+  int err;
+
+  argc = 0;
+  while (options->args[argc] != NULL)
+    argc++;
+
+  /* Room for uv__execvpe()'s path buffer and sh fallback arguments, the copy
+   * of pipes, and the C library. Untouched pages are never allocated. */
+  stack_size = 64 * 1024 + PATH_MAX + NAME_MAX +
+               (argc + 3) * sizeof(char*) + stdio_count * sizeof(*pipes);
+  stack_size = (stack_size + 4095) & ~(size_t) 4095;
+  stack = mmap(NULL,
+               stack_size,
+               PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK | MAP_NORESERVE,
+               -1,
+               0);
+  if (stack == MAP_FAILED) {
+    *pid = -1;
+    return UV__ERR(errno);
+  }
+
+  args.options = options;
+  args.stdio_count = stdio_count;
+  args.pipes = pipes;
+  args.error_fd = error_fd;
+
+  /* As in uv__spawn_and_init_child_fork(): no signal handler may run in the
+   * child, where it would run on the parent's memory. */
+  sigfillset(&signewset);
+  sigdelset(&signewset, SIGKILL);
+  sigdelset(&signewset, SIGSTOP);
+  sigdelset(&signewset, SIGTRAP);
+  sigdelset(&signewset, SIGSEGV);
+  sigdelset(&signewset, SIGBUS);
+  sigdelset(&signewset, SIGILL);
+  sigdelset(&signewset, SIGSYS);
+  sigdelset(&signewset, SIGABRT);
+  if (pthread_sigmask(SIG_BLOCK, &signewset, &sigoldset) != 0)
+    abort();
+
+  /* The stack grows down on every architecture Linux runs Node.js on. */
+  *pid = clone(uv__spawn_clone_child,
+               (char*) stack + stack_size,
+               CLONE_VM | CLONE_VFORK | SIGCHLD,
+               &args);
+  err = *pid == -1 ? UV__ERR(errno) : 0;
+
+  if (pthread_sigmask(SIG_SETMASK, &sigoldset, NULL) != 0)
+    abort();
+
+  munmap(stack, stack_size);
+  return err;
+}
+#endif
+
 static int uv__spawn_and_init_child(
     uv_loop_t* loop,
     const uv_process_options_t* options,
@@ -926,6 +1155,15 @@ static int uv__spawn_and_init_child(
   /* Acquire write lock to prevent opening new fds in worker threads */
   uv_rwlock_wrlock(&loop->cloexec_lock);
 
+#if defined(__linux__)
+  if (uv__spawn_can_clone(options))
+    err = uv__spawn_and_init_child_clone(options,
+                                         stdio_count,
+                                         pipes,
+                                         signal_pipe[1],
+                                         pid);
+  else
+#endif
   err = uv__spawn_and_init_child_fork(options, stdio_count, pipes, signal_pipe[1], pid);
 
   /* Release lock in parent process */
@@ -1025,6 +1025,36 @@ void uv__metrics_set_provider_entry_time(uv_loop_t* loop) {
 }
 
 
+uint64_t uv__metrics_phase_start(uv_loop_t* loop) {
+  if (!(uv__get_internal_fields(loop)->flags & UV__METRICS_PHASE_TIME))
+    return 0;
+
+  return uv_hrtime();
+}
+
+
+uint64_t uv__metrics_phase_end(uv_loop_t* loop,
+                               uv_metrics_phase phase,
+                               uint64_t start) {
+  uint64_t now;
+
+  if (start == 0)
+    return 0;
+
+  now = uv_hrtime();
+  uv__get_loop_metrics(loop)->phase_time[phase] += now - start;
+  return now;
+}
+
+
+uint64_t uv_metrics_phase_time(uv_loop_t* loop, uv_metrics_phase phase) {
+  if (phase < 0 || phase >= UV_METRICS_PHASE_MAX)
+    return 0;
+
+  return uv__get_loop_metrics(loop)->phase_time[phase];
+}
+
+
 int uv_metrics_info(uv_loop_t* loop, uv_metrics_t* metrics) {
   memcpy(metrics,
          &uv__get_loop_metrics(loop)->metrics,
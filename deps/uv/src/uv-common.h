@@ -402,11 +402,26 @@ struct uv__loop_metrics_s {
   uint64_t provider_entry_time;
   uint64_t provider_idle_time;
   uv_mutex_t lock;
+  uint64_t phase_time[UV_METRICS_PHASE_MAX];
 };
 
+/* uv__loop_internal_fields_t flags. UV_METRICS_IDLE_TIME is used as-is. */
+#define UV__METRICS_PHASE_TIME 0x2
+
 void uv__metrics_update_idle_time(uv_loop_t* loop);
 void uv__metrics_set_provider_entry_time(uv_loop_t* loop);
 
+/* Returns a start time for uv__metrics_phase_end(), or 0 if the loop does
+ * not record phase times.
+ */
+uint64_t uv__metrics_phase_start(uv_loop_t* loop);
+/* Adds the time since `start` to `phase` and returns the current time, so
+ * that it can be passed on as the start of the next phase.
+ */
+uint64_t uv__metrics_phase_end(uv_loop_t* loop,
+                               uv_metrics_phase phase,
+                               uint64_t start);
+
 #ifdef __linux__
 struct uv__iou {
   uint32_t* sqhead;
@@ -384,6 +384,11 @@ int uv__loop_configure(uv_loop_t* loop, uv_loop_option option, va_list ap) {
     return 0;
   }
 
+  if (option == UV_METRICS_PHASE_TIME) {
+    lfields->flags |= UV__METRICS_PHASE_TIME;
+    return 0;
+  }
+
   return UV_ENOSYS;
 }
 
@@ -526,6 +531,7 @@ static void uv__poll(uv_loop_t* loop, DWORD timeout) {
 
 
 int uv_run(uv_loop_t *loop, uv_run_mode mode) {
+  uint64_t phase_start;
   DWORD timeout;
   int r;
   int can_sleep;
@@ -539,16 +545,23 @@ int uv_run(uv_loop_t *loop, uv_run_mode mode) {
    * once, which should be done after polling in order to maintain proper
    * execution order of the conceptual event loop. */
   if (mode == UV_RUN_DEFAULT && r != 0 && loop->stop_flag == 0) {
+    phase_start = uv__metrics_phase_start(loop);
     uv_update_time(loop);
     uv__run_timers(loop);
+    uv__metrics_phase_end(loop, UV_METRICS_PHASE_TIMERS, phase_start);
   }
 
   while (r != 0 && loop->stop_flag == 0) {
     can_sleep = loop->pending_reqs_tail == NULL && loop->idle_handles == NULL;
 
+    phase_start = uv__metrics_phase_start(loop);
     uv__process_reqs(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_PENDING, phase_start);
     uv__idle_invoke(loop);
     uv__prepare_invoke(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_IDLE_PREPARE, phase_start);
 
     timeout = 0;
     if ((mode == UV_RUN_ONCE && can_sleep) || mode == UV_RUN_DEFAULT)
@@ -557,11 +570,15 @@ int uv_run(uv_loop_t *loop, uv_run_mode mode) {
     uv__metrics_inc_loop_count(loop);
 
     uv__poll(loop, timeout);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_POLL, phase_start);
 
     /* Process immediate callbacks (e.g. write_cb) a small fixed number of
      * times to avoid loop starvation.*/
     for (r = 0; r < 8 && loop->pending_reqs_tail != NULL; r++)
       uv__process_reqs(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_PENDING, phase_start);
 
     /* Run one final update on the provider_idle_time in case uv__poll*
      * returned because the timeout expired, but no events were received. This
@@ -571,10 +588,15 @@ int uv_run(uv_loop_t *loop, uv_run_mode mode) {
     uv__metrics_update_idle_time(loop);
 
     uv__check_invoke(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_CHECK, phase_start);
     uv__process_endgames(loop);
+    phase_start =
+        uv__metrics_phase_end(loop, UV_METRICS_PHASE_CLOSING, phase_start);
 
     uv_update_time(loop);
     uv__run_timers(loop);
+    uv__metrics_phase_end(loop, UV_METRICS_PHASE_TIMERS, phase_start);
 
     r = uv__loop_alive(loop);
     if (mode == UV_RUN_ONCE || mode == UV_RUN_NOWAIT)
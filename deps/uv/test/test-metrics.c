@@ -388,3 +388,63 @@ TEST_IMPL(metrics_pool_events) {
   MAKE_VALGRIND_HAPPY(uv_default_loop());
   return 0;
 }
+
+
+static void check_spin_cb(uv_check_t* handle) {
+  uint64_t t;
+
+  t = uv_hrtime();
+  while (uv_hrtime() - t < 50 * UV_NS_TO_MS) { }
+  uv_close((uv_handle_t*) handle, NULL);
+}
+
+
+static void timer_short_spin_cb(uv_timer_t* handle) {
+  uint64_t t;
+
+  (*(int*) handle->data)++;
+  t = uv_hrtime();
+  while (uv_hrtime() - t < 100 * UV_NS_TO_MS) { }
+}
+
+
+TEST_IMPL(metrics_phase_time) {
+  uv_loop_t loop;
+  uv_timer_t timer;
+  uv_check_t check;
+  uint64_t total;
+  int cntr;
+  int i;
+
+  ASSERT_OK(uv_loop_init(&loop));
+  for (i = 0; i < UV_METRICS_PHASE_MAX; i++)
+    ASSERT_UINT64_EQ(0, uv_metrics_phase_time(&loop, i));
+
+  cntr = 0;
+  timer.data = &cntr;
+  ASSERT_OK(uv_loop_configure(&loop, UV_METRICS_PHASE_TIME));
+  ASSERT_OK(uv_timer_init(&loop, &timer));
+  ASSERT_OK(uv_timer_start(&timer, timer_short_spin_cb, 20, 0));
+  ASSERT_OK(uv_check_init(&loop, &check));
+  ASSERT_OK(uv_check_start(&check, check_spin_cb));
+
+  ASSERT_OK(uv_run(&loop, UV_RUN_DEFAULT));
+  ASSERT_EQ(1, cntr);
+
+  ASSERT_GE(uv_metrics_phase_time(&loop, UV_METRICS_PHASE_TIMERS),
+            100 * UV_NS_TO_MS);
+  ASSERT_GE(uv_metrics_phase_time(&loop, UV_METRICS_PHASE_CHECK),
+            50 * UV_NS_TO_MS);
+  ASSERT_LT(uv_metrics_phase_time(&loop, UV_METRICS_PHASE_CHECK),
+            100 * UV_NS_TO_MS);
+
+  total = 0;
+  for (i = 0; i < UV_METRICS_PHASE_MAX; i++)
+    total += uv_metrics_phase_time(&loop, i);
+  /* Plus the time spent blocked in poll waiting for the timer. */
+  ASSERT_GE(total, 150 * UV_NS_TO_MS);
+  ASSERT_UINT64_EQ(0, uv_metrics_phase_time(&loop, UV_METRICS_PHASE_MAX));
+
+  MAKE_VALGRIND_HAPPY(&loop);
+  return 0;
+}
@@ -74,3 +74,81 @@ TEST_IMPL(threadpool_queue_work_einval) {
   MAKE_VALGRIND_HAPPY(uv_default_loop());
   return 0;
 }
+
+
+static uv_sem_t cpu_size_sem;
+static uv_mutex_t cpu_size_mutex;
+static int cpu_size_running;
+static int cpu_size_max_running;
+static int cpu_size_done;
+
+
+static void cpu_size_cpu_cb(uv_work_t* req) {
+  uv_mutex_lock(&cpu_size_mutex);
+  cpu_size_running++;
+  if (cpu_size_running > cpu_size_max_running)
+    cpu_size_max_running = cpu_size_running;
+  uv_mutex_unlock(&cpu_size_mutex);
+
+  /* The first CPU work only finishes once the I/O work has run, which
+   * deadlocks unless the CPU limit left a thread for it. */
+  if (req->data != NULL)
+    uv_sem_wait(&cpu_size_sem);
+
+  uv_mutex_lock(&cpu_size_mutex);
+  cpu_size_running--;
+  uv_mutex_unlock(&cpu_size_mutex);
+}
+
+
+static void cpu_size_io_cb(uv_work_t* req) {
+  uv_sem_post(&cpu_size_sem);
+}
+
+
+static void cpu_size_after_cb(uv_work_t* req, int status) {
+  ASSERT_OK(status);
+  cpu_size_done++;
+}
+
+
+TEST_IMPL(threadpool_queue_work_ex_cpu_size) {
+  uv_work_t cpu_reqs[3];
+  uv_work_t io_req;
+  int i;
+
+  /* Must be set before the threadpool starts. */
+  ASSERT_OK(uv_os_setenv("UV_THREADPOOL_SIZE", "4"));
+  ASSERT_OK(uv_os_setenv("UV_THREADPOOL_CPU_SIZE", "1"));
+  ASSERT_OK(uv_sem_init(&cpu_size_sem, 0));
+  ASSERT_OK(uv_mutex_init(&cpu_size_mutex));
+
+  for (i = 0; i < 3; i++) {
+    cpu_reqs[i].data = i == 0 ? &data : NULL;
+    ASSERT_OK(uv_queue_work_ex(uv_default_loop(),
+                               &cpu_reqs[i],
+                               UV_WORK_CPU,
+                               cpu_size_cpu_cb,
+                               cpu_size_after_cb));
+  }
+  ASSERT_OK(uv_queue_work_ex(uv_default_loop(),
+                             &io_req,
+                             UV_WORK_FAST_IO,
+                             cpu_size_io_cb,
+                             cpu_size_after_cb));
+  ASSERT_EQ(UV_EINVAL, uv_queue_work_ex(uv_default_loop(),
+                                        &io_req,
+                                        UV_WORK_FAST_IO,
+                                        NULL,
+                                        cpu_size_after_cb));
+
+  ASSERT_OK(uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT_EQ(4, cpu_size_done);
+  ASSERT_EQ(1, cpu_size_max_running);
+
+  uv_mutex_destroy(&cpu_size_mutex);
+  uv_sem_destroy(&cpu_size_sem);
+  MAKE_VALGRIND_HAPPY(uv_default_loop());
+  return 0;
+}
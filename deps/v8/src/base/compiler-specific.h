@@ -18,6 +18,13 @@
 #define V8_ALLOW_UNUSED
 #endif
 
+// Hint the CPU to start loading the cache line that holds addr for reading.
+#if defined(__GNUC__)
+#define V8_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#define V8_PREFETCH(addr) ((void)(addr))
+#endif
+
 // Tell the compiler a function is using a printf-style format string.
 // |format_param| is the one-based index of the format string parameter;
 // |dots_param| is the one-based index of the "..." parameter.
@@ -124,8 +124,16 @@ bool CpuFeatures::SupportsWasmSimd128() {
 
 void CpuFeatures::ProbeImpl(bool cross_compile) {
   base::CPU cpu;
-  CHECK(cpu.has_sse2());  // SSE2 support is mandatory.
-  CHECK(cpu.has_cmov());  // CMOV support is mandatory.
+  // SSE2 and CMOV support are mandatory. Every ia32 code generator, including
+  // the one that produced the embedded builtins the interpreter runs on, uses
+  // SSE2 for double arithmetic, so --jitless does not help either. Say so
+  // instead of failing an anonymous CHECK.
+  if (!cpu.has_sse2()) {
+    FATAL(
+        "V8 on ia32 requires a CPU with SSE2; there is no x87 code "
+        "generator");
+  }
+  CHECK(cpu.has_cmov());
 
   // Only use statically determined features for cross compile (snapshot).
   if (cross_compile) return;
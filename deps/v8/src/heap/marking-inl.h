@@ -368,6 +368,11 @@ bool MarkingHelper::TryMarkAndPush(Heap* heap,
   DCHECK(heap->Contains(object));
   if (marking_state->TryMark(object)) {
     if (V8_LIKELY(target_worklist == WorklistTarget::kRegular)) {
+#ifdef V8_HEAP_MARKING_PREFETCH
+      // The object's map is loaded when it is popped, which tends to be soon
+      // after it is pushed; start that load now.
+      V8_PREFETCH(reinterpret_cast<const void*>(object.address()));
+#endif
       marking_worklist->Push(object);
     }
     return true;
@@ -85,9 +85,18 @@ class V8_EXPORT_PRIVATE StubCache {
   // the static_assert below, in {entry(...)}).
   static const int kCacheIndexShift = Name::HashBits::kShift;
 
-  static const int kPrimaryTableBits = 11;
+  // Without a JIT, every property access that is not monomorphic or
+  // polymorphic goes through this cache, so builds that mostly run
+  // --jitless can ask for larger tables.
+#ifndef V8_STUB_CACHE_PRIMARY_TABLE_BITS
+#define V8_STUB_CACHE_PRIMARY_TABLE_BITS 11
+#endif
+#ifndef V8_STUB_CACHE_SECONDARY_TABLE_BITS
+#define V8_STUB_CACHE_SECONDARY_TABLE_BITS 9
+#endif
+  static const int kPrimaryTableBits = V8_STUB_CACHE_PRIMARY_TABLE_BITS;
   static const int kPrimaryTableSize = (1 << kPrimaryTableBits);
-  static const int kSecondaryTableBits = 9;
+  static const int kSecondaryTableBits = V8_STUB_CACHE_SECONDARY_TABLE_BITS;
   static const int kSecondaryTableSize = (1 << kSecondaryTableBits);
 
   static int PrimaryOffsetForTesting(Tagged<Name> name, Tagged<Map> map);
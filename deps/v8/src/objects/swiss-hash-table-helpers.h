@@ -263,24 +263,25 @@ struct GroupAltivecImpl {
   __vector signed char ctrl;
 };
 #elif defined(__3dNOW__)
+// MMX version for Athlon-class CPUs without SSE2. The group stays 16 slots
+// wide so that the table layout matches the one the builtins (which target
+// SSE2 group widths on ia32) expect: each 8-byte half of the group is matched
+// with pcmpeqb and turned into a bitmask with pmovmskb from the MMX
+// Extensions, or with a multiply on plain MMX CPUs.
 struct Group3dNowImpl {
   static constexpr size_t kWidth = 16;  // the number of slots per group
 
-  explicit Group3dNowImpl(const ctrl_t* pos) {
-    ctrl = *reinterpret_cast<const __m64*>(pos);
-  }
+  explicit Group3dNowImpl(const ctrl_t* pos) { memcpy(ctrl_, pos, kWidth); }
 
   // Returns a bitmask representing the positions of slots that match |hash|.
   BitMask<uint32_t, kWidth> Match(h2_t hash) const {
-    // This is a simplified implementation for 3DNow!
-    // In reality, 3DNow! doesn't work well for this use case, so we'll use a hybrid approach
-    uint32_t mask = 0;
-    for (size_t i = 0; i < kWidth; i++) {
-      if (((const ctrl_t*)&ctrl)[i] == hash) {
-        mask |= 1u << i;
-      }
-    }
-    _m_empty();  // Clean up 3DNow! state
+    const __m64 match = _mm_set1_pi8(static_cast<char>(hash));
+    __m64 low, high;
+    memcpy(&low, ctrl_, sizeof(low));
+    memcpy(&high, ctrl_ + 8, sizeof(high));
+    uint32_t mask = MoveMask(_mm_cmpeq_pi8(low, match)) |
+                    (MoveMask(_mm_cmpeq_pi8(high, match)) << 8);
+    _m_femms();  // Leave MMX state before any x87 code runs.
     return BitMask<uint32_t, kWidth>(mask);
   }
 
@@ -289,7 +290,22 @@ struct Group3dNowImpl {
     return Match(static_cast<h2_t>(kEmpty));
   }
 
-  __m64 ctrl;
+ private:
+  // Collects the top bit of every byte, like SSE2's _mm_movemask_epi8.
+  static uint32_t MoveMask(__m64 bytes) {
+#if defined(__3dNOW_A__) && defined(__GNUC__) && !defined(__clang__)
+    return static_cast<uint32_t>(
+        __builtin_ia32_pmovmskb(reinterpret_cast<__v8qi>(bytes)));
+#else
+    // Move bit 7 of byte i to bit 56 + i, then shift the byte down.
+    uint64_t value;
+    memcpy(&value, &bytes, sizeof(value));
+    return static_cast<uint32_t>(
+        ((value & 0x8080808080808080ULL) * 0x0002040810204081ULL) >> 56);
+#endif
+  }
+
+  ctrl_t ctrl_[kWidth];
 };
 #elif V8_SWISS_TABLE_HAVE_SSE2_HOST
 struct GroupSse2Impl {
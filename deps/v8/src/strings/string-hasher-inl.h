@@ -46,7 +46,16 @@ uint32_t ConvertRawHashToUsableHash(T raw_hash) {
   return hash == 0 ? StringHasher::kZeroHash : hash;
 }
 
+#if defined(__3dNOW__) && !defined(__SSE2__)
+// MMX scan for Athlon-class CPUs without SSE2; out of line because it has to
+// leave MMX state (femms) before returning.
+V8_EXPORT_PRIVATE bool IsOnly8BitMMX(const uint16_t* chars, unsigned len);
+#endif
+
 V8_INLINE bool IsOnly8Bit(const uint16_t* chars, unsigned len) {
+#if defined(__3dNOW__) && !defined(__SSE2__)
+  if (len >= 16) return IsOnly8BitMMX(chars, len);
+#endif
   // TODO(leszeks): This could be SIMD for efficiency on large strings, if we
   // need it.
   for (unsigned i = 0; i < len; ++i) {
@@ -59,7 +68,11 @@ V8_INLINE bool IsOnly8Bit(const uint16_t* chars, unsigned len) {
 
 V8_INLINE uint64_t GetRapidHash(const uint8_t* chars, uint32_t length,
                                 uint64_t seed, const uint64_t secret[3]) {
+#if V8_USE_RAPIDHASH32
+  return rapidhash32(chars, length, seed, secret);
+#else
   return rapidhash(chars, length, seed, secret);
+#endif
 }
 
 V8_INLINE uint64_t GetRapidHash(const uint16_t* chars, uint32_t length,
@@ -69,8 +82,13 @@ V8_INLINE uint64_t GetRapidHash(const uint16_t* chars, uint32_t length,
   if (V8_UNLIKELY(IsOnly8Bit(chars, length))) {
     return detail::HashConvertingTo8Bit(chars, length, seed, secret);
   }
+#if V8_USE_RAPIDHASH32
+  return rapidhash32(reinterpret_cast<const uint8_t*>(chars), 2 * length, seed,
+                     secret);
+#else
   return rapidhash(reinterpret_cast<const uint8_t*>(chars), 2 * length, seed,
                    secret);
+#endif
 }
 
 template <typename uchar>
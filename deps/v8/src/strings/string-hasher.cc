@@ -35,13 +35,15 @@ struct ConvertTo8BitHashReader {
     result = converter.u64[0];
     return result;
 #elif defined(__3dNOW__)
-    // 3DNow! implementation for AMD Athlon processors
-    // Since _m_packuswb isn't always available, we'll use a manual approach
-    uint64_t result = 0;
-    for (int i = 0; i < 8; ++i) {
-        result |= (static_cast<uint64_t>(p[i]) & 0xFF) << (i * 8);
-    }
-    _m_empty();  // Clean up 3DNow! state
+    // MMX packuswb narrows four 16-bit lanes per register to bytes; the
+    // DCHECKs above guarantee that no lane saturates.
+    __m64 x_low, x_high;
+    memcpy(&x_low, p, sizeof(x_low));
+    memcpy(&x_high, p + 4, sizeof(x_high));
+    __m64 packed = _mm_packs_pu16(x_low, x_high);
+    uint64_t result;
+    memcpy(&result, &packed, sizeof(result));
+    _m_femms();  // Leave MMX state before any x87 code runs.
     return result;
 #elif defined(__SSE2__)
     // Load 16-bit values into 2 64-bit registers and pack them to 8-bit values
@@ -89,14 +91,12 @@ struct ConvertTo8BitHashReader {
     union { __vector unsigned char v; uint32_t u32[4]; } converter = { .v = packed };
     return static_cast<uint64_t>(converter.u32[0]);
 #elif defined(__3dNOW__)
-    // 3DNow! implementation for AMD Athlon processors
-    // Since _m_packuswb isn't always available, we'll use a manual approach
-    uint64_t result = 0;
-    for (int i = 0; i < 4; ++i) {
-        result |= (static_cast<uint64_t>(p[i]) & 0xFF) << (i * 8);
-    }
-    _m_empty();  // Clean up 3DNow! state
-    return result;
+    __m64 x;
+    memcpy(&x, p, sizeof(x));
+    uint32_t result =
+        static_cast<uint32_t>(_mm_cvtsi64_si32(_mm_packs_pu16(x, x)));
+    _m_femms();  // Leave MMX state before any x87 code runs.
+    return static_cast<uint64_t>(result);
 #elif defined(__SSE2__)
     // Load 16-bit values and pack them to 8-bit values
     // Only pack first 4 16-bit values to get 4 8-bit values
@@ -135,10 +135,43 @@ struct ConvertTo8BitHashReader {
 };
 
 namespace detail {
+#if defined(__3dNOW__) && !defined(__SSE2__)
+bool IsOnly8BitMMX(const uint16_t* chars, unsigned len) {
+  // OR the characters together eight at a time with two independent
+  // accumulators, then look at the high bytes once.
+  __m64 acc0 = _mm_setzero_si64();
+  __m64 acc1 = _mm_setzero_si64();
+  unsigned i = 0;
+  for (; i + 8 <= len; i += 8) {
+    __m64 x_low, x_high;
+    memcpy(&x_low, chars + i, sizeof(x_low));
+    memcpy(&x_high, chars + i + 4, sizeof(x_high));
+    acc0 = _mm_or_si64(acc0, x_low);
+    acc1 = _mm_or_si64(acc1, x_high);
+  }
+  // Shifting leaves each lane's high byte (<= 0xff), so the packuswb fold
+  // into 32 bits is lossless.
+  __m64 high = _mm_srli_pi16(_mm_or_si64(acc0, acc1), 8);
+  uint32_t any_high =
+      static_cast<uint32_t>(_mm_cvtsi64_si32(_mm_packs_pu16(high, high)));
+  _m_femms();
+  if (any_high != 0) return false;
+  for (; i < len; ++i) {
+    if (chars[i] > 255) return false;
+  }
+  return true;
+}
+#endif
+
 uint64_t HashConvertingTo8Bit(const uint16_t* chars, uint32_t length,
                               uint64_t seed, const uint64_t secret[3]) {
+#if V8_USE_RAPIDHASH32
+  return rapidhash32<ConvertTo8BitHashReader>(
+      reinterpret_cast<const uint8_t*>(chars), length, seed, secret);
+#else
   return rapidhash<ConvertTo8BitHashReader>(
       reinterpret_cast<const uint8_t*>(chars), length, seed, secret);
+#endif
 }
 }  // namespace detail
 
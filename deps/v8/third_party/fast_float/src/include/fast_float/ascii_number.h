@@ -18,6 +18,24 @@
 #include <arm_neon.h>
 #endif
 
+#ifdef FASTFLOAT_MMX
+#include <mmintrin.h>
+#endif
+
+#ifdef FASTFLOAT_ALTIVEC
+#include <altivec.h>
+// These are defined by altivec.h in GCC toolchain, it is safe to undef them.
+#ifdef bool
+#undef bool
+#endif
+#ifdef vector
+#undef vector
+#endif
+#ifdef pixel
+#undef pixel
+#endif
+#endif
+
 namespace fast_float {
 
 template <typename UC> fastfloat_really_inline constexpr bool has_simd_opt() {
@@ -67,34 +85,14 @@ read8_to_u64(const UC *chars) {
 
 fastfloat_really_inline uint64_t simd_read8_to_u64(const __m128i data) {
   FASTFLOAT_SIMD_DISABLE_WARNINGS
-#ifdef __ALTIVEC__
-  // Altivec implementation for PowerPC systems (like G5)
-  vector unsigned short v_data = (vector unsigned short)data;
-  vector unsigned char packed = vec_pack(v_data, v_data);
-  uint64_t result;
-  vec_ste((vector unsigned long long)packed, 0, (unsigned long long*)&result);
-  return result;
-#elif defined(__3dNOW__)
-  // 3DNow! implementation for AMD Athlon processors
-  __m64 low = *(__m64*)&data;  // Get lower 64 bits
-  __m64 result = _mm_packs_pu16(low, low);  // Pack with 3DNow! instruction
-  uint64_t ret = *reinterpret_cast<uint32_t*>(&result);
-  _m_empty();  // Clean up 3DNow! state
-  return ret;
-#elif defined(__SSE2__)
   const __m128i packed = _mm_packus_epi16(data, data);
-#if defined(__x86_64__) || defined(_M_X64)
+#ifdef FASTFLOAT_64BIT
   return uint64_t(_mm_cvtsi128_si64(packed));
 #else
-  // On 32-bit x86 systems or other architectures, use alternative method
-  // Extract lower 64 bits using alternative method
-  return _mm_cvtsi128_si32(packed) | (static_cast<uint64_t>(_mm_cvtsi128_si32(_mm_shuffle_epi32(packed, 1))) << 32);
-#endif
-#else
-  // Fallback: process without SIMD
-  const uint16_t* ptr = (const uint16_t*)&data;
-  return (uint64_t{ptr[0]}) | (uint64_t{ptr[1]} << 16) | 
-         (uint64_t{ptr[2]} << 32) | (uint64_t{ptr[3]} << 48);
+  // _mm_cvtsi128_si64 needs a 64-bit general purpose register.
+  return uint64_t(uint32_t(_mm_cvtsi128_si32(packed))) |
+         (uint64_t(uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(packed, 4))))
+          << 32);
 #endif
   FASTFLOAT_SIMD_RESTORE_WARNINGS
 }
@@ -122,19 +120,73 @@ fastfloat_really_inline uint64_t simd_read8_to_u64(const char16_t *chars) {
   FASTFLOAT_SIMD_RESTORE_WARNINGS
 }
 
-#endif // FASTFLOAT_SSE2
+#elif defined(FASTFLOAT_MMX)
+
+// There are no 64-bit general purpose registers to run the SWAR code below
+// in, so the digits are combined in MMX registers instead: lo and hi hold
+// digits 0-3 and 4-7 as 16-bit values in 0-9, and two pmaddwd steps turn
+// them into two four-digit halves. Leaves the FPU usable again.
+fastfloat_really_inline uint32_t mmx_combine_eight_digits(__m64 lo, __m64 hi) {
+  const __m64 tens = _mm_set_pi16(1, 10, 1, 10);
+  const __m64 hundreds = _mm_set_pi16(1, 100, 1, 100);
+  const __m64 pairs =
+      _mm_packs_pi32(_mm_madd_pi16(lo, tens), _mm_madd_pi16(hi, tens));
+  const __m64 quads = _mm_madd_pi16(pairs, hundreds);
+  const uint32_t high = uint32_t(_mm_cvtsi64_si32(quads));
+  const uint32_t low = uint32_t(_mm_cvtsi64_si32(_mm_srli_si64(quads, 32)));
+  _mm_empty();
+  return high * 10000 + low;
+}
 
-// MSVC SFINAE is broken pre-VS2017
-#if defined(_MSC_VER) && _MSC_VER <= 1900
-template <typename UC>
-#else
-template <typename UC, FASTFLOAT_ENABLE_IF(!has_simd_opt<UC>()) = 0>
-#endif
-// dummy for compile
-uint64_t simd_read8_to_u64(UC const *) {
-  return 0;
+fastfloat_really_inline void mmx_load8(const char16_t *chars, __m64 &lo,
+                                       __m64 &hi) {
+  ::memcpy(&lo, chars, sizeof(lo));
+  ::memcpy(&hi, chars + 4, sizeof(hi));
+}
+
+fastfloat_really_inline uint32_t simd_parse_eight_digits(const char16_t *chars) {
+  __m64 lo, hi;
+  mmx_load8(chars, lo, hi);
+  const __m64 zero = _mm_set1_pi16('0');
+  return mmx_combine_eight_digits(_mm_sub_pi16(lo, zero),
+                                  _mm_sub_pi16(hi, zero));
 }
 
+#elif defined(FASTFLOAT_ALTIVEC)
+
+// chars may be unaligned. Both loads stay within the 16-byte blocks that
+// hold chars[0] and chars[7], so nothing past the eighth char is touched.
+fastfloat_really_inline __vector unsigned short
+altivec_load8(const char16_t *chars) {
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(chars);
+  const __vector unsigned char first = vec_ld(0, p);
+  const __vector unsigned char last = vec_ld(15, p);
+  return (__vector unsigned short)vec_perm(first, last, vec_lvsl(0, p));
+}
+
+// digits holds eight 16-bit values in 0-9, most significant first.
+fastfloat_really_inline uint32_t
+altivec_combine_eight_digits(__vector unsigned short digits) {
+  const __vector unsigned short tens = {10, 1, 10, 1, 10, 1, 10, 1};
+  const __vector unsigned short hundreds = {100, 1, 100, 1, 100, 1, 100, 1};
+  const __vector unsigned int zero = vec_splat_u32(0);
+  const __vector unsigned int pairs = vec_msum(digits, tens, zero);
+  union {
+    __vector unsigned int v;
+    uint32_t u[4];
+  } quads;
+  quads.v = vec_msum(vec_pack(pairs, pairs), hundreds, zero);
+  return quads.u[0] * 10000 + quads.u[1];
+}
+
+fastfloat_really_inline uint32_t simd_parse_eight_digits(const char16_t *chars) {
+  const __vector unsigned short zero = {'0', '0', '0', '0',
+                                        '0', '0', '0', '0'};
+  return altivec_combine_eight_digits(vec_sub(altivec_load8(chars), zero));
+}
+
+#endif // FASTFLOAT_SSE2
+
 // credit  @aqrit
 fastfloat_really_inline FASTFLOAT_CONSTEXPR14 uint32_t
 parse_eight_digits_unrolled(uint64_t val) {
@@ -147,6 +199,25 @@ parse_eight_digits_unrolled(uint64_t val) {
   return uint32_t(val);
 }
 
+#if defined(FASTFLOAT_SSE2) || defined(FASTFLOAT_NEON)
+
+fastfloat_really_inline uint32_t simd_parse_eight_digits(const char16_t *chars) {
+  return parse_eight_digits_unrolled(simd_read8_to_u64(chars));
+}
+
+#endif // defined(FASTFLOAT_SSE2) || defined(FASTFLOAT_NEON)
+
+// MSVC SFINAE is broken pre-VS2017
+#if defined(_MSC_VER) && _MSC_VER <= 1900
+template <typename UC>
+#else
+template <typename UC, FASTFLOAT_ENABLE_IF(!has_simd_opt<UC>()) = 0>
+#endif
+// dummy for compile
+uint32_t simd_parse_eight_digits(UC const *) {
+  return 0;
+}
+
 // Call this if chars are definitely 8 digits.
 template <typename UC>
 fastfloat_really_inline FASTFLOAT_CONSTEXPR20 uint32_t
@@ -154,7 +225,7 @@ parse_eight_digits_unrolled(UC const *chars) noexcept {
   if (cpp20_and_in_constexpr() || !has_simd_opt<UC>()) {
     return parse_eight_digits_unrolled(read8_to_u64(chars)); // truncation okay
   }
-  return parse_eight_digits_unrolled(simd_read8_to_u64(chars));
+  return simd_parse_eight_digits(chars);
 }
 
 // credit @aqrit
@@ -206,6 +277,38 @@ simd_parse_if_eight_digits_unrolled(const char16_t *chars,
   } else
     return false;
   FASTFLOAT_SIMD_RESTORE_WARNINGS
+#elif defined(FASTFLOAT_MMX)
+  __m64 lo, hi;
+  mmx_load8(chars, lo, hi);
+
+  // (x - '0') <= 9, as in the SSE2 version. Without pmovmskb the 16-bit
+  // masks are narrowed to bytes and read back as one 32-bit word.
+  const __m64 bias = _mm_set1_pi16(32720);
+  const __m64 limit = _mm_set1_pi16(-32759);
+  const __m64 bad = _mm_or_si64(_mm_cmpgt_pi16(_mm_add_pi16(lo, bias), limit),
+                                _mm_cmpgt_pi16(_mm_add_pi16(hi, bias), limit));
+
+  if (_mm_cvtsi64_si32(_mm_packs_pi16(bad, bad)) == 0) {
+    const __m64 zero = _mm_set1_pi16('0');
+    i = i * 100000000 + mmx_combine_eight_digits(_mm_sub_pi16(lo, zero),
+                                                 _mm_sub_pi16(hi, zero));
+    return true;
+  }
+  _mm_empty();
+  return false;
+#elif defined(FASTFLOAT_ALTIVEC)
+  const __vector unsigned short zero = {'0', '0', '0', '0',
+                                        '0', '0', '0', '0'};
+  const __vector unsigned short nine = vec_splat_u16(9);
+
+  // (x - '0') <= 9, with wrap-around taking everything below '0' out of range.
+  const __vector unsigned short digits = vec_sub(altivec_load8(chars), zero);
+
+  if (vec_all_le(digits, nine)) {
+    i = i * 100000000 + altivec_combine_eight_digits(digits);
+    return true;
+  }
+  return false;
 #else
   (void)chars;
   (void)i;
@@ -239,6 +342,69 @@ loop_parse_if_eight_digits(const UC *&p, const UC *const pend, uint64_t &i) {
   }
 }
 
+#if (defined(FASTFLOAT_MMX) || defined(FASTFLOAT_ALTIVEC)) &&                  \
+    !defined(FASTFLOAT_64BIT)
+
+// On 32-bit targets every 64-bit multiply in parse_eight_digits_unrolled()
+// becomes three, so check and combine the digits in vector registers, the
+// same way as for char16_t once they are widened to 16 bits.
+fastfloat_really_inline FASTFLOAT_CONSTEXPR20 bool
+simd_parse_if_eight_digits_unrolled(const char *chars, uint64_t &i) noexcept {
+  if (cpp20_and_in_constexpr()) {
+    return false;
+  }
+#ifdef FASTFLOAT_MMX
+  __m64 data;
+  ::memcpy(&data, chars, sizeof(data));
+
+  // (x - '0') <= 9: the bias moves '0'...'9' to the bottom of the signed
+  // byte range, so anything else compares greater than the biased '9'.
+  const __m64 t0 = _mm_add_pi8(data, _mm_set1_pi8(0x80 - '0'));
+  const __m64 bad = _mm_cmpgt_pi8(t0, _mm_set1_pi8(char(0x80 + 9)));
+
+  if ((_mm_cvtsi64_si32(bad) | _mm_cvtsi64_si32(_mm_srli_si64(bad, 32))) ==
+      0) {
+    const __m64 digits = _mm_sub_pi8(data, _mm_set1_pi8('0'));
+    const __m64 zero = _mm_setzero_si64();
+    i = i * 100000000 +
+        mmx_combine_eight_digits(_mm_unpacklo_pi8(digits, zero),
+                                 _mm_unpackhi_pi8(digits, zero));
+    return true;
+  }
+  _mm_empty();
+  return false;
+#else
+  // Only the first eight bytes are valid; loading the block that holds the
+  // eighth keeps the read within them, and merging with zero widens them to
+  // 16-bit lanes and drops the rest.
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(chars);
+  const __vector unsigned char bytes =
+      vec_perm(vec_ld(0, p), vec_ld(7, p), vec_lvsl(0, p));
+  const __vector unsigned short zero = {'0', '0', '0', '0',
+                                        '0', '0', '0', '0'};
+  const __vector unsigned short digits = vec_sub(
+      (__vector unsigned short)vec_mergeh(vec_splat_u8(0), bytes), zero);
+
+  if (vec_all_le(digits, vec_splat_u16(9))) {
+    i = i * 100000000 + altivec_combine_eight_digits(digits);
+    return true;
+  }
+  return false;
+#endif
+}
+
+fastfloat_really_inline FASTFLOAT_CONSTEXPR20 void
+loop_parse_if_eight_digits(const char *&p, const char *const pend,
+                           uint64_t &i) {
+  while ((std::distance(p, pend) >= 8) &&
+         simd_parse_if_eight_digits_unrolled(
+             p, i)) { // in rare cases, this will overflow, but that's ok
+    p += 8;
+  }
+}
+
+#else
+
 fastfloat_really_inline FASTFLOAT_CONSTEXPR20 void
 loop_parse_if_eight_digits(const char *&p, const char *const pend,
                            uint64_t &i) {
@@ -252,6 +418,8 @@ loop_parse_if_eight_digits(const char *&p, const char *const pend,
   }
 }
 
+#endif
+
 enum class parse_error {
   no_error,
   // [JSON-only] The minus sign must be followed by an integer.
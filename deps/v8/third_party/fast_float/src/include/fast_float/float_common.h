@@ -146,7 +146,21 @@ using parse_options = parse_options_t<char>;
 #define FASTFLOAT_NEON 1
 #endif
 
-#if defined(FASTFLOAT_SSE2) || defined(FASTFLOAT_NEON)
+// 32-bit x86 without SSE2 (Pentium MMX up to Athlon XP) parses UTF-16
+// digits four at a time with MMX. Only GCC and Clang provide the MMX
+// intrinsics for these targets.
+#if !defined(FASTFLOAT_SSE2) && defined(__i386__) && defined(__MMX__) &&      \
+    defined(__GNUC__)
+#define FASTFLOAT_MMX 1
+#endif
+
+// Big-endian PowerPC with AltiVec (G4, G5).
+#if defined(__ALTIVEC__) && FASTFLOAT_IS_BIG_ENDIAN
+#define FASTFLOAT_ALTIVEC 1
+#endif
+
+#if defined(FASTFLOAT_SSE2) || defined(FASTFLOAT_NEON) ||                      \
+    defined(FASTFLOAT_MMX) || defined(FASTFLOAT_ALTIVEC)
 #define FASTFLOAT_HAS_SIMD 1
 #endif
 
@@ -206,6 +206,36 @@ inline uint64_t rapid_mix(uint64_t A, uint64_t B) {
   return A ^ B;
 }
 
+/*
+ *  32*32 -> 64bit multiply and mix function, for rapidhash32.
+ *
+ *  @param A   32-bit number, replaced by the low half of the product.
+ *  @param B   32-bit number, replaced by the high half of the product.
+ *  @param ka  32-bit secret mixed into A.
+ *  @param kb  32-bit secret mixed into B.
+ */
+inline void rapid_mix32(uint32_t& A, uint32_t& B, uint32_t ka, uint32_t kb) {
+  uint64_t c = static_cast<uint64_t>(A ^ ka) * (B ^ kb);
+  A = static_cast<uint32_t>(c);
+  B = static_cast<uint32_t>(c >> 32);
+}
+
+/*
+ *  Whether V8 hashes strings with rapidhash32 rather than rapidhash. 32-bit
+ *  x86 has no 64*64 -> 128bit multiply, so rapid_mul128 costs four 32-bit
+ *  multiplies and the carry chain between them; rapidhash32 only needs one
+ *  32*32 -> 64bit multiply per 8 bytes. This is keyed on the target rather
+ *  than the host architecture, so that mksnapshot always agrees with the
+ *  binary that loads its snapshot.
+ */
+#ifndef V8_USE_RAPIDHASH32
+#if defined(V8_TARGET_ARCH_IA32)
+#define V8_USE_RAPIDHASH32 1
+#else
+#define V8_USE_RAPIDHASH32 0
+#endif
+#endif
+
 /*
  *  rapidhash main function.
  *
@@ -293,6 +323,81 @@ V8_INLINE uint64_t rapidhash(const uint8_t* p, const size_t len, uint64_t seed,
   return rapid_mix(a ^ secret[0] ^ len, b ^ secret[1]);
 }
 
+/*
+ *  rapidhash32, a variant of rapidhash for 32-bit CPUs, after wyhash32.
+ *
+ *  @param key     Buffer to be hashed.
+ *  @param len     Number of input bytes coming from the reader.
+ *  @param seed    64-bit seed used to alter the hash result predictably.
+ *  @param secret  Triplet of 64-bit secrets used to alter hash result
+ *                 predictably.
+ *
+ *  Returns a 32-bit hash.
+ *
+ *  The state is two 32-bit halves that are multiplied together after every
+ *  8 bytes of input, with both factors keyed by the secret, and the seed
+ *  folded in first; so as with rapidhash, hash flooding needs knowledge of
+ *  the seed and secret. Inputs over 16 bytes are hashed 16 bytes at a time
+ *  on two independent states, so that the multiplies of consecutive words
+ *  overlap in the pipeline instead of waiting on each other.
+ *
+ *  The same reader rules as for rapidhash apply, and the data flow is kept
+ *  separate from the pointer in the same way.
+ */
+template <class Reader = PlainHashReader>
+V8_INLINE uint32_t rapidhash32(const uint8_t* p, const size_t len,
+                               uint64_t seed, const uint64_t secret[3]) {
+  // For brevity.
+  constexpr unsigned x = Reader::kCompressionFactor;
+  constexpr unsigned y = Reader::kExpansionFactor;
+  DCHECK_EQ(len % y, 0u);
+
+  const uint32_t k0 = static_cast<uint32_t>(secret[0]);
+  const uint32_t k1 = static_cast<uint32_t>(secret[0] >> 32);
+  const uint32_t k2 = static_cast<uint32_t>(secret[1]);
+  const uint32_t k3 = static_cast<uint32_t>(secret[1] >> 32);
+  uint32_t a = static_cast<uint32_t>(seed) ^ static_cast<uint32_t>(secret[2]);
+  uint32_t b = static_cast<uint32_t>(seed >> 32) ^ static_cast<uint32_t>(len);
+  rapid_mix32(a, b, k0, k1);
+
+  size_t i = len;
+  if (_unlikely_(i > 16)) {
+    uint32_t c = a ^ static_cast<uint32_t>(secret[2] >> 32), d = b;
+    do {
+      a ^= static_cast<uint32_t>(Reader::Read32(p));
+      b ^= static_cast<uint32_t>(Reader::Read32(p + 4 * x / y));
+      c ^= static_cast<uint32_t>(Reader::Read32(p + 8 * x / y));
+      d ^= static_cast<uint32_t>(Reader::Read32(p + 12 * x / y));
+      rapid_mix32(a, b, k0, k1);
+      rapid_mix32(c, d, k2, k3);
+      p += 16 * x / y;
+      i -= 16;
+    } while (_likely_(i > 16));
+    a ^= c;
+    b ^= d;
+  }
+  if (i > 8) {
+    a ^= static_cast<uint32_t>(Reader::Read32(p));
+    b ^= static_cast<uint32_t>(Reader::Read32(p + 4 * x / y));
+    rapid_mix32(a, b, k2, k3);
+    p += 8 * x / y;
+    i -= 8;
+  }
+  if (_likely_(i >= 4)) {
+    // Read the first and last 32 bits (they may overlap).
+    a ^= static_cast<uint32_t>(Reader::Read32(p));
+    b ^= static_cast<uint32_t>(Reader::Read32(p + (i - 4) * x / y));
+  } else if (i > 0) {
+    // 1, 2 or 3 bytes, which ReadSmall spreads over 64 bits.
+    const uint64_t small = Reader::ReadSmall(p, i);
+    a ^= static_cast<uint32_t>(small >> 32) ^
+         (static_cast<uint32_t>(small) << 16);
+  }
+  rapid_mix32(a, b, k0, k1);
+  rapid_mix32(a, b, k2, k3);
+  return a ^ b;
+}
+
 #undef _likely_
 #undef _unlikely_
 
@@ -7804,8 +7804,18 @@ using vec_i32_t = __vector signed int;
 using vec_u64_t = __vector unsigned long long;
 using vec_i64_t = __vector signed long long;
 #else
-// On older PowerPC systems without VSX (like Power Mac G5), 
-// we'll define fallback behavior for functions that require VSX
+// On older PowerPC systems without VSX (like Power Mac G5) there are no
+// unaligned vector loads or stores, and lvx/stvx silently drop the low four
+// address bits. Load with the lvsl/vperm idiom and store through memcpy.
+template <typename V> simdutf_really_inline V altivec_load(const void *ptr) {
+  const unsigned char *src = reinterpret_cast<const unsigned char *>(ptr);
+  return (V)vec_perm(vec_ld(0, src), vec_ld(15, src), vec_lvsl(0, src));
+}
+
+template <typename V>
+simdutf_really_inline void altivec_store(V value, size_t offset, void *ptr) {
+  std::memcpy(reinterpret_cast<char *>(ptr) + offset, &value, sizeof(value));
+}
 #endif
 
 // clang-format off
@@ -7863,18 +7873,19 @@ template <typename T> uint16_t move_mask_u8(T vec) {
 #endif
 }
 #else
-// Fallback implementation for systems without VSX (like Power Mac G5)
+// Systems without VSX (like Power Mac G5) have no vbpermq: move the top bit
+// of byte i to bit i % 8 of that byte, then add up each half with
+// vec_sum4s/vec_sum2s. Element 0 is the lowest address on big endian.
 template <typename T> uint16_t move_mask_u8(T vec) {
-  // Implement a scalar fallback for move_mask_u8 functionality
-  uint16_t result = 0;
-  vec_u8_t v = (vec_u8_t)vec;
-  for (int i = 0; i < 16; i++) {
-    // Extract the high bit of each byte and set corresponding bit in result
-    if (v[i] & 0x80) {
-      result |= (1 << i);
-    }
-  }
-  return result;
+  const vec_u8_t shifts = {0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7};
+  const vec_u8_t bits = vec_sl(vec_sr((vec_u8_t)vec, vec_splat_u8(7)), shifts);
+  const vec_u32_t sums = vec_sum4s(bits, vec_splat_u32(0));
+  union {
+    int32_t words[4];
+    vec_i32_t v;
+  } halves;
+  halves.v = vec_sum2s((vec_i32_t)sums, vec_splat_s32(0));
+  return static_cast<uint16_t>(halves.words[1] | (halves.words[3] << 8));
 }
 #endif
 
@@ -7907,17 +7918,7 @@ template <typename T> struct base8 {
   }
 #else
   template <typename U> simdutf_really_inline void store(U *ptr) const {
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    T* dst = reinterpret_cast<T *>(ptr);
-    if (sizeof(T) == 1) {
-      // For 8-bit elements, use vec_ste (store element) in a loop
-      for (int i = 0; i < 16; i++) {
-        dst[i] = vec_extract((vec_u8_t)value, i);
-      }
-    } else {
-      // For other types, store the full vector
-      *(vector_type*)dst = this->value;
-    }
+    altivec_store(value, 0, ptr);
   }
 #endif
 
@@ -7969,10 +7970,8 @@ template <typename T> struct base8 {
       vec_xst(v1, 16, reinterpret_cast<vector_type *>(p));
 #endif // defined(__clang__)
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    for (int i = 0; i < 8; i++) {
-      reinterpret_cast<T *>(p)[i] = vec_extract((vec_u8_t)value, i);
-    }
+      altivec_store(v0, 0, p);
+      altivec_store(v1, 16, p);
 #endif
     } else {
       const vec_u8_t perm_lo = {0, 16, 1, 16, 2, 16, 3, 16,
@@ -7992,10 +7991,8 @@ template <typename T> struct base8 {
       vec_xst(v1, 16, reinterpret_cast<vector_type *>(p));
 #endif // defined(__clang__)
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    for (int i = 0; i < 8; i++) {
-      reinterpret_cast<T *>(p)[i] = vec_extract((vec_u8_t)value, i);
-    }
+      altivec_store(v0, 0, p);
+      altivec_store(v1, 16, p);
 #endif
     }
   }
@@ -8054,10 +8051,10 @@ template <typename T> struct base8 {
     vec_xst(v3, 3 * n, reinterpret_cast<vector_type *>(p));
 #endif // defined(__clang__)
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    for (int i = 0; i < 16; i++) {
-      reinterpret_cast<char32_t *>(p)[i] = vec_extract((vec_u8_t)value, i);
-    }
+    altivec_store(v0, 0 * n, p);
+    altivec_store(v1, 1 * n, p);
+    altivec_store(v2, 2 * n, p);
+    altivec_store(v3, 3 * n, p);
 #endif
   }
 
@@ -8090,10 +8087,8 @@ template <typename T> struct base8 {
     vec_xst(v1, 1 * n, reinterpret_cast<vector_type *>(p));
 #endif // defined(__clang__)
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    for (int i = 0; i < 8; i++) {
-      reinterpret_cast<char32_t *>(p)[i] = vec_extract((vec_u8_t)value, i);
-    }
+    altivec_store(v0, 0 * n, p);
+    altivec_store(v1, 1 * n, p);
 #endif
   }
 
@@ -8171,21 +8166,7 @@ template <typename T> struct base8_numeric : base8<T> {
 #else
   template <typename U>
   static simdutf_really_inline simd8<T> load(const U *values) {
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    const T* src = reinterpret_cast<const T *>(values);
-    if (sizeof(T) == 1) {
-      // For 8-bit elements, use AltiVec load and store functions
-      vec_u8_t v1 = vec_ld(0, (unsigned char*)src);
-      vec_u8_t v2 = vec_ld(15, (unsigned char*)src);  // Get overlapping bytes to complete 16 bytes
-      return (vector_type)vec_perm(v1, v2, vec_lvsl(0, (unsigned char*)src));
-    } else {
-      // For other types, implement a manual load
-      T temp[16 / sizeof(T)];
-      for (int i = 0; i < (16 / sizeof(T)); i++) {
-        temp[i] = src[i];
-      }
-      return *(vector_type*)temp;
-    }
+    return altivec_load<vector_type>(values);
   }
 #endif
 
@@ -8447,19 +8428,9 @@ simd8<bool> operator>=(const simd8<T> a, const simd8<T> b) {
 #if defined(__VSX__) && (defined(__POWER8_VECTOR__) || defined(__GNUC__) && (__GNUC__ > 7 || (__GNUC__ == 7 && __GNUC_MINOR__ >= 0)))
   return vec_cmpge(a.value, b.value);
 #else
-  // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-  // Manually implement comparison for each element - we'll compare and create a mask
-  vec_u8_t a_bytes = (vec_u8_t)a.value;
-  vec_u8_t b_bytes = (vec_u8_t)b.value;
-  vec_u8_t result = {0};
-  for (int i = 0; i < 16; i++) {
-    if (vec_extract(a_bytes, i) >= vec_extract(b_bytes, i)) {
-      result = vec_insert((unsigned char)0xFF, result, i);
-    } else {
-      result = vec_insert((unsigned char)0x00, result, i);
-    }
-  }
-  return result;
+  // a >= b is !(b > a); AltiVec has no vcmpgeub.
+  const auto less = vec_cmpgt(b.value, a.value);
+  return vec_nor(less, less);
 #endif
 }
 
@@ -8602,11 +8573,8 @@ template <typename T> struct base16 {
     uint16_t tmp[8];
     vec_xst(value, 0, reinterpret_cast<vector_type *>(tmp));
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
     uint16_t tmp[8];
-    for (int i = 0; i < 8; i++) {
-      tmp[i] = vec_extract((vec_u16_t)value, i);
-    }
+    altivec_store(value, 0, tmp);
 #endif
     for (int i = 0; i < 8; i++) {
       if (i == 0) {
@@ -8662,15 +8630,7 @@ template <> struct simd16<bool> : base16<bool> {
     const auto tmp = vec_u64_t(value);
     return tmp[0] || tmp[1]; // Note: logical or, not binary one
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    // Check if any of the 8 16-bit elements is non-zero
-    vec_u16_t val = (vec_u16_t)this->value;
-    for (int i = 0; i < 8; i++) {
-      if (vec_extract(val, i)) {
-        return true;
-      }
-    }
-    return false;
+    return vec_any_ne((vec_u16_t)value, vec_splat_u16(0));
 #endif
   }
 
@@ -8679,15 +8639,7 @@ template <> struct simd16<bool> : base16<bool> {
     const auto tmp = vec_u64_t(value);
     return (tmp[0] | tmp[1]) == 0;
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    // Check if all of the 8 16-bit elements are zero
-    vec_u16_t val = (vec_u16_t)this->value;
-    for (int i = 0; i < 8; i++) {
-      if (vec_extract(val, i) != 0) {
-        return false;
-      }
-    }
-    return true;
+    return vec_all_eq((vec_u16_t)value, vec_splat_u16(0));
 #endif
   }
 
@@ -8713,13 +8665,7 @@ template <typename T> struct base16_numeric : base16<T> {
   }
 #else
   static simdutf_really_inline simd16<T> load(const U *ptr) {
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    const T* src = reinterpret_cast<const T *>(ptr);
-    T temp[8];  // 8 elements of 16-bit each = 16 bytes
-    for (int i = 0; i < 8; i++) {
-      temp[i] = src[i];
-    }
-    return *(vector_type*)temp;
+    return altivec_load<vector_type>(ptr);
   }
 #endif
 
@@ -8736,11 +8682,7 @@ template <typename T> struct base16_numeric : base16<T> {
     return vec_xst(this->value, 0, reinterpret_cast<vector_type *>(dst));
 #endif // defined(__clang__)
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    T* ptr = reinterpret_cast<T *>(dst);
-    for (int i = 0; i < 8; i++) {  // 8 elements of 16-bit each = 16 bytes
-      ptr[i] = vec_extract((vec_u16_t)this->value, i);
-    }
+    altivec_store(this->value, 0, dst);
 #endif
   }
 
@@ -8985,15 +8927,8 @@ template <typename T> struct base32 {
       : base32(vec_xl(0, reinterpret_cast<const T *>(ptr))) {}
 #else
   template <typename Pointer>
-  simdutf_really_inline base32(const Pointer *ptr) {
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    const T* src = reinterpret_cast<const T *>(ptr);
-    T temp[4];  // 4 elements of 32-bit each = 16 bytes
-    for (int i = 0; i < 4; i++) {
-      temp[i] = src[i];
-    }
-    this->value = *(vector_type*)temp;
-  }
+  simdutf_really_inline base32(const Pointer *ptr)
+      : base32(altivec_load<vector_type>(ptr)) {}
 #endif
 
   // Store to array
@@ -9005,11 +8940,7 @@ template <typename T> struct base32 {
     return vec_xst(this->value, 0, reinterpret_cast<vector_type *>(dst));
 #endif // defined(__clang__)
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    T* ptr = reinterpret_cast<T *>(dst);
-    for (int i = 0; i < 4; i++) {  // 4 elements of 32-bit each = 16 bytes
-      ptr[i] = vec_extract((vec_u32_t)this->value, i);
-    }
+    altivec_store(this->value, 0, dst);
 #endif
   }
   void dump(const char *name = nullptr) const {
@@ -9022,11 +8953,8 @@ template <typename T> struct base32 {
     uint32_t tmp[4];
     vec_xst(value, 0, reinterpret_cast<vector_type *>(tmp));
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
     uint32_t tmp[4];
-    for (int i = 0; i < 4; i++) {
-      tmp[i] = vec_extract((vec_u32_t)value, i);
-    }
+    altivec_store(value, 0, tmp);
 #endif
     for (int i = 0; i < 4; i++) {
       if (i == 0) {
@@ -9057,13 +8985,7 @@ template <typename T> struct base32_numeric : base32<T> {
 #if defined(__VSX__) && (defined(__POWER8_VECTOR__) || defined(__GNUC__) && (__GNUC__ > 7 || (__GNUC__ == 7 && __GNUC_MINOR__ >= 0)))
     return vec_xl(0, reinterpret_cast<const T *>(values));
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    const T* src = reinterpret_cast<const T *>(values);
-    T temp[4];  // 4 elements of 32-bit each = 16 bytes
-    for (int i = 0; i < 4; i++) {
-      temp[i] = src[i];
-    }
-    return simd32<T>(*(vector_type*)temp);
+    return simd32<T>(altivec_load<vector_type>(values));
 #endif
   }
 
@@ -9135,15 +9057,7 @@ template <> struct simd32<bool> : base32<bool> {
     const vec_u64_t tmp = (vec_u64_t)value;
     return tmp[0] || tmp[1]; // Note: logical or, not binary one
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    // Check if any of the 4 32-bit elements is non-zero
-    vec_u32_t val = (vec_u32_t)this->value;
-    for (int i = 0; i < 4; i++) {
-      if (vec_extract(val, i)) {
-        return true;
-      }
-    }
-    return false;
+    return vec_any_ne((vec_u32_t)value, vec_splat_u32(0));
 #endif
   }
 
@@ -9152,15 +9066,7 @@ template <> struct simd32<bool> : base32<bool> {
     const vec_u64_t tmp = (vec_u64_t)value;
     return (tmp[0] | tmp[1]) == 0;
 #else
-    // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-    // Check if all of the 4 32-bit elements are zero
-    vec_u32_t val = (vec_u32_t)this->value;
-    for (int i = 0; i < 4; i++) {
-      if (vec_extract(val, i) != 0) {
-        return false;
-      }
-    }
-    return true;
+    return vec_all_eq((vec_u32_t)value, vec_splat_u32(0));
 #endif
   }
 
@@ -9243,11 +9149,9 @@ simd32<bool> operator>=(const simd32<T> a, const simd32<T> b) {
 #if defined(__VSX__) && (defined(__POWER8_VECTOR__) || defined(__GNUC__) && (__GNUC__ > 7 || (__GNUC__ == 7 && __GNUC_MINOR__ >= 0)))
   return vec_cmpge(a.value, b.value);
 #else
-  // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-  // Manually implement comparison for each element - using vec_cmpgt and vec_cmpeq
-  auto greater = vec_cmpgt(a.value, b.value); // a > b
-  auto equal = vec_cmpeq(a.value, b.value);   // a == b
-  return vec_or(greater, equal);              // (a > b) OR (a == b) gives (a >= b)
+  // a >= b is !(b > a); AltiVec has no vcmpgeuw.
+  const auto less = vec_cmpgt(b.value, a.value);
+  return vec_nor(less, less);
 #endif
 }
 
@@ -25835,9 +25739,386 @@ const char16_t *implementation::find(const char16_t *start, const char16_t *end,
 // #define SIMDUTF_IMPLEMENTATION fallback
 /* end file src/simdutf/fallback/begin.h */
 
+// There is no SIMD kernel for 32-bit x86 or 32-bit PowerPC, so the fallback
+// kernel is what decodes text there. When the CPU still has MMX (Pentium MMX,
+// every Athlon) or AltiVec (G4), ASCII goes through vector registers 16 bytes
+// at a time and everything else through the scalar code. 64-bit PowerPC is
+// served by the ppc64 kernel instead.
+#ifndef SIMDUTF_FALLBACK_MMX
+  #if (defined(__i386__) || defined(_M_IX86)) && defined(__MMX__) &&          \
+      defined(__GNUC__)
+    #define SIMDUTF_FALLBACK_MMX 1
+  #else
+    #define SIMDUTF_FALLBACK_MMX 0
+  #endif
+#endif
+
+#ifndef SIMDUTF_FALLBACK_ALTIVEC
+  #if defined(__ALTIVEC__) && SIMDUTF_IS_BIG_ENDIAN && !SIMDUTF_FALLBACK_MMX
+    #define SIMDUTF_FALLBACK_ALTIVEC 1
+  #else
+    #define SIMDUTF_FALLBACK_ALTIVEC 0
+  #endif
+#endif
+
+#if SIMDUTF_FALLBACK_MMX
+  #include <mmintrin.h>
+#elif SIMDUTF_FALLBACK_ALTIVEC
+  #include <altivec.h>
+
+// These are defined by altivec.h in GCC toolchain, it is safe to undef them.
+  #ifdef bool
+    #undef bool
+  #endif
+
+  #ifdef vector
+    #undef vector
+  #endif
+#endif
+
 namespace simdutf {
 namespace fallback {
 
+#if SIMDUTF_FALLBACK_MMX || SIMDUTF_FALLBACK_ALTIVEC
+namespace {
+namespace ascii_blocks {
+
+  #if SIMDUTF_FALLBACK_MMX
+simdutf_really_inline __m64 load8(const uint8_t *p) {
+  __m64 v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// True if none of the 16 bytes at p has its high bit set.
+simdutf_really_inline bool is_ascii(const uint8_t *p) {
+  const __m64 high = _mm_and_si64(_mm_or_si64(load8(p), load8(p + 8)),
+                                  _mm_set1_pi8(char(0x80)));
+  // Plain MMX has no pmovmskb, but packsswb keeps nonzero words nonzero.
+  return _mm_cvtsi64_si32(_mm_packs_pi16(high, high)) == 0;
+}
+
+// Zero-extends the 16 bytes at p to 16 UTF-16 code units.
+template <endianness big_endian>
+simdutf_really_inline void widen(const uint8_t *p, char16_t *out) {
+  const __m64 zero = _mm_setzero_si64();
+  for (int i = 0; i < 16; i += 8) {
+    const __m64 v = load8(p + i);
+    const __m64 lo = big_endian == endianness::BIG ? _mm_unpacklo_pi8(zero, v)
+                                                   : _mm_unpacklo_pi8(v, zero);
+    const __m64 hi = big_endian == endianness::BIG ? _mm_unpackhi_pi8(zero, v)
+                                                   : _mm_unpackhi_pi8(v, zero);
+    std::memcpy(out + i, &lo, sizeof(lo));
+    std::memcpy(out + i + 4, &hi, sizeof(hi));
+  }
+}
+
+// The MMX registers alias the x87 stack: empty them before returning.
+simdutf_really_inline void leave() { _mm_empty(); }
+  #else
+simdutf_really_inline __vector unsigned char load16(const uint8_t *p) {
+  // lvsl/vperm unaligned load; the second lvx only touches the block that
+  // holds p[15].
+  return vec_perm(vec_ld(0, p), vec_ld(15, p), vec_lvsl(0, p));
+}
+
+// True if none of the 16 bytes at p has its high bit set.
+simdutf_really_inline bool is_ascii(const uint8_t *p) {
+  return vec_all_lt(load16(p), vec_splats((unsigned char)(0x80)));
+}
+
+// Zero-extends the 16 bytes at p to 16 UTF-16 code units.
+template <endianness big_endian>
+simdutf_really_inline void widen(const uint8_t *p, char16_t *out) {
+  const __vector unsigned char zero = vec_splat_u8(0);
+  const __vector unsigned char v = load16(p);
+  const __vector unsigned char lo =
+      big_endian == endianness::BIG ? vec_mergeh(zero, v) : vec_mergeh(v, zero);
+  const __vector unsigned char hi =
+      big_endian == endianness::BIG ? vec_mergel(zero, v) : vec_mergel(v, zero);
+  std::memcpy(out, &lo, sizeof(lo));
+  std::memcpy(out + 8, &hi, sizeof(hi));
+}
+
+simdutf_really_inline void leave() {}
+  #endif
+
+// Number of bytes at the start of data that are not ASCII.
+simdutf_really_inline size_t non_ascii_run(const uint8_t *data, size_t len) {
+  size_t pos = 0;
+  while (pos < len && data[pos] >= 0x80) {
+    pos++;
+  }
+  return pos;
+}
+
+  #if SIMDUTF_FEATURE_UTF8 || SIMDUTF_FEATURE_DETECT_ENCODING
+simdutf_really_inline bool validate_utf8(const char *buf, size_t len) {
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(buf);
+  size_t pos = 0;
+  bool valid = true;
+  while (pos < len) {
+    if (pos + 16 <= len && is_ascii(data + pos)) {
+      pos += 16;
+      continue;
+    }
+    while (pos < len && data[pos] < 0x80) {
+      pos++;
+    }
+    // A multi-byte sequence never contains an ASCII byte, so each run of
+    // non-ASCII bytes has to be valid UTF-8 on its own.
+    const size_t run = non_ascii_run(data + pos, len - pos);
+    if (!scalar::utf8::validate(buf + pos, run)) {
+      valid = false;
+      break;
+    }
+    pos += run;
+  }
+  leave();
+  return valid;
+}
+  #endif // SIMDUTF_FEATURE_UTF8 || SIMDUTF_FEATURE_DETECT_ENCODING
+
+  #if SIMDUTF_FEATURE_ASCII
+simdutf_really_inline size_t ascii_prefix(const uint8_t *data, size_t len) {
+  size_t pos = 0;
+  while (pos + 16 <= len && is_ascii(data + pos)) {
+    pos += 16;
+  }
+  leave();
+  return pos;
+}
+  #endif // SIMDUTF_FEATURE_ASCII
+
+  #if SIMDUTF_FEATURE_UTF8 && SIMDUTF_FEATURE_UTF16
+template <endianness big_endian>
+simdutf_really_inline size_t convert_utf8_to_utf16(const char *buf, size_t len,
+                                                   char16_t *utf16_output) {
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(buf);
+  char16_t *start{utf16_output};
+  size_t pos = 0;
+  while (pos < len) {
+    if (pos + 16 <= len && is_ascii(data + pos)) {
+      widen<big_endian>(data + pos, utf16_output);
+      pos += 16;
+      utf16_output += 16;
+      continue;
+    }
+    while (pos < len && data[pos] < 0x80) {
+      *utf16_output++ = !match_system(big_endian)
+                            ? char16_t(scalar::u16_swap_bytes(data[pos]))
+                            : char16_t(data[pos]);
+      pos++;
+    }
+    const size_t run = non_ascii_run(data + pos, len - pos);
+    if (run != 0) {
+      const size_t written = scalar::utf8_to_utf16::convert<big_endian>(
+          buf + pos, run, utf16_output);
+      if (written == 0) {
+        leave();
+        return 0;
+      }
+      pos += run;
+      utf16_output += written;
+    }
+  }
+  leave();
+  return utf16_output - start;
+}
+  #endif // SIMDUTF_FEATURE_UTF8 && SIMDUTF_FEATURE_UTF16
+
+  #if SIMDUTF_FEATURE_UTF8 && SIMDUTF_FEATURE_LATIN1
+simdutf_really_inline size_t convert_latin1_to_utf8(const char *buf, size_t len,
+                                                    char *utf8_output) {
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(buf);
+  size_t pos = 0;
+  size_t utf8_pos = 0;
+  while (pos < len) {
+    if (pos + 16 <= len && is_ascii(data + pos)) {
+      std::memcpy(utf8_output + utf8_pos, buf + pos, 16);
+      pos += 16;
+      utf8_pos += 16;
+      continue;
+    }
+    const size_t block = len - pos < 16 ? len - pos : 16;
+    utf8_pos += scalar::latin1_to_utf8::convert(buf + pos, block,
+                                                utf8_output + utf8_pos);
+    pos += block;
+  }
+  leave();
+  return utf8_pos;
+}
+  #endif // SIMDUTF_FEATURE_UTF8 && SIMDUTF_FEATURE_LATIN1
+
+} // namespace ascii_blocks
+
+  #if SIMDUTF_FEATURE_BASE64 && SIMDUTF_FALLBACK_ALTIVEC
+// Base64 sixteen characters at a time: whole blocks of alphabet characters
+// are classified with compares, translated with vperm lookups and packed with
+// shifts. Anything else, whitespace, padding, garbage and the final partial
+// block, is left to the scalar code. There is no MMX counterpart: eight bytes
+// per register, no byte shuffle and no byte mask make it slower than the
+// scalar table decoder.
+namespace base64_blocks {
+
+// Which of the two alphabets' last two characters a decoder accepts, chosen
+// the same way as the scalar decoder picks its tables.
+struct alphabet {
+  bool standard; // '+' and '/'
+  bool url;      // '-' and '_'
+  explicit alphabet(base64_options options)
+      : standard((options & base64_default_or_url) || !(options & base64_url)),
+        url((options & base64_default_or_url) || (options & base64_url)) {}
+};
+
+// Characters per decoded block and input bytes per encoded block.
+constexpr size_t decode_chars = 16;
+constexpr size_t encode_bytes = 12;
+
+simdutf_really_inline __vector unsigned char splat(unsigned char value) {
+  return vec_splats(value);
+}
+
+simdutf_really_inline __vector __bool char
+in_range(__vector unsigned char c, unsigned char lo, unsigned char hi) {
+  return vec_and(vec_cmpgt(c, splat(lo - 1)), vec_cmpgt(splat(hi + 1), c));
+}
+
+// Decodes the sixteen characters at src into twelve bytes at dst, or returns
+// false without writing anything if one of them is not in the alphabet.
+simdutf_really_inline bool decode_block(const char *src, char *dst,
+                                        alphabet chars) {
+  const __vector unsigned char c =
+      ascii_blocks::load16(reinterpret_cast<const uint8_t *>(src));
+  const __vector __bool char upper = in_range(c, 'A', 'Z');
+  const __vector __bool char lower = in_range(c, 'a', 'z');
+  const __vector __bool char digit = in_range(c, '0', '9');
+  __vector __bool char is62 = vec_cmpeq(c, splat(chars.url ? '-' : '+'));
+  __vector __bool char is63 = vec_cmpeq(c, splat(chars.url ? '_' : '/'));
+  if (chars.standard && chars.url) {
+    is62 = vec_or(is62, vec_cmpeq(c, splat('+')));
+    is63 = vec_or(is63, vec_cmpeq(c, splat('/')));
+  }
+  const __vector __bool char valid =
+      vec_or(vec_or(upper, lower), vec_or(digit, vec_or(is62, is63)));
+  if (!vec_all_ne((__vector unsigned char)valid, splat(0))) {
+    return false;
+  }
+
+  // The ranges do not overlap, so OR-ing the masked candidates picks one.
+  __vector unsigned char v = vec_and(vec_sub(c, splat('A')), upper);
+  v = vec_or(v, vec_and(vec_sub(c, splat('a' - 26)), lower));
+  v = vec_or(v, vec_and(vec_add(c, splat(52 - '0')), digit));
+  v = vec_or(v, vec_and(splat(62), is62));
+  v = vec_or(v, vec_and(splat(63), is63));
+
+  // Merge neighbouring 6-bit values into 12 bits, then those into 24 bits.
+  // Big endian: the first character is the top byte of each lane.
+  const __vector unsigned short x = (__vector unsigned short)v;
+  const __vector unsigned short low6 = {0x3f, 0x3f, 0x3f, 0x3f,
+                                        0x3f, 0x3f, 0x3f, 0x3f};
+  const __vector unsigned short high6 = {0xfc0, 0xfc0, 0xfc0, 0xfc0,
+                                         0xfc0, 0xfc0, 0xfc0, 0xfc0};
+  const __vector unsigned int pairs = (__vector unsigned int)vec_or(
+      vec_and(vec_sr(x, vec_splat_u16(2)), high6), vec_and(x, low6));
+  const __vector unsigned int low12 = {0xfff, 0xfff, 0xfff, 0xfff};
+  const __vector unsigned int high12 = {0xfff000, 0xfff000, 0xfff000,
+                                        0xfff000};
+  const __vector unsigned int quads =
+      vec_or(vec_and(vec_sr(pairs, vec_splat_u32(4)), high12),
+             vec_and(pairs, low12));
+  const __vector unsigned char pack = {1,  2,  3,  5,  6,  7,  9,  10,
+                                       11, 13, 14, 15, 0,  0,  0,  0};
+  const __vector unsigned char out =
+      vec_perm((__vector unsigned char)quads, (__vector unsigned char)quads,
+               pack);
+  std::memcpy(dst, &out, 12);
+  return true;
+}
+
+// Encodes the twelve bytes at src into sixteen characters at dst. Reads the
+// full sixteen bytes at src.
+simdutf_really_inline void encode_block(const uint8_t *src, char *dst,
+                                        bool url) {
+  const __vector unsigned char in = ascii_blocks::load16(src);
+  // Each group of three bytes in the top of a 32-bit lane.
+  const __vector unsigned char spread = {0, 1, 2,  0, 3, 4,  5,  0,
+                                         6, 7, 8,  0, 9, 10, 11, 0};
+  const __vector unsigned int w =
+      (__vector unsigned int)vec_perm(in, in, spread);
+  const __vector unsigned int mask = {63, 63, 63, 63};
+  const __vector unsigned int s8 = vec_splat_u32(8);
+  const __vector unsigned int s14 = vec_splat_u32(14);
+  const __vector unsigned int s20 = {20, 20, 20, 20};
+  const __vector unsigned int s26 = {26, 26, 26, 26};
+  const __vector unsigned int s16 = {16, 16, 16, 16};
+  const __vector unsigned int s24 = {24, 24, 24, 24};
+
+  // The four 6-bit fields of each group, first field in the top byte.
+  __vector unsigned int fields = vec_sl(vec_sr(w, s26), s24);
+  fields = vec_or(fields, vec_sl(vec_and(vec_sr(w, s20), mask), s16));
+  fields = vec_or(fields, vec_sl(vec_and(vec_sr(w, s14), mask), s8));
+  fields = vec_or(fields, vec_and(vec_sr(w, s8), mask));
+  const __vector unsigned char idx = (__vector unsigned char)fields;
+
+  // vperm picks from 32 bytes by the low five bits of each index.
+  const __vector unsigned char t0 = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H',
+                                     'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P'};
+  const __vector unsigned char t1 = {'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X',
+                                     'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f'};
+  const __vector unsigned char t2 = {'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n',
+                                     'o', 'p', 'q', 'r', 's', 't', 'u', 'v'};
+  const __vector unsigned char t3_standard = {'w', 'x', 'y', 'z', '0', '1',
+                                              '2', '3', '4', '5', '6', '7',
+                                              '8', '9', '+', '/'};
+  const __vector unsigned char t3_url = {'w', 'x', 'y', 'z', '0', '1',
+                                         '2', '3', '4', '5', '6', '7',
+                                         '8', '9', '-', '_'};
+  const __vector unsigned char low = vec_perm(t0, t1, idx);
+  const __vector unsigned char high =
+      vec_perm(t2, url ? t3_url : t3_standard, idx);
+  const __vector unsigned char out =
+      vec_sel(low, high, vec_cmpgt(idx, splat(31)));
+  std::memcpy(dst, &out, sizeof(out));
+}
+
+// The unaligned load behind encode_block() reads sixteen bytes.
+constexpr size_t encode_readable = 16;
+
+// Decodes whole blocks from the start of src for as long as they consist of
+// alphabet characters only. Returns the number of characters consumed, a
+// multiple of four; the output is three bytes for every four of them.
+simdutf_really_inline size_t decode(const char *src, size_t length, char *dst,
+                                    base64_options options) {
+  const alphabet chars(options);
+  size_t pos = 0;
+  while (pos + decode_chars <= length &&
+         decode_block(src + pos, dst + pos / 4 * 3, chars)) {
+    pos += decode_chars;
+  }
+  return pos;
+}
+
+// Encodes whole blocks from the start of src. Returns the number of bytes
+// consumed, a multiple of three; the output is four characters for every
+// three of them, without padding.
+simdutf_really_inline size_t encode(const char *src, size_t length, char *dst,
+                                    base64_options options) {
+  const bool url = (options & base64_url) != 0;
+  const uint8_t *in = reinterpret_cast<const uint8_t *>(src);
+  size_t pos = 0;
+  for (; pos + encode_readable <= length; pos += encode_bytes) {
+    encode_block(in + pos, dst + pos / 3 * 4, url);
+  }
+  return pos;
+}
+
+} // namespace base64_blocks
+  #endif // SIMDUTF_FEATURE_BASE64 && SIMDUTF_FALLBACK_ALTIVEC
+} // unnamed namespace
+#endif // SIMDUTF_FALLBACK_MMX || SIMDUTF_FALLBACK_ALTIVEC
+
+
 #if SIMDUTF_FEATURE_DETECT_ENCODING
 simdutf_warn_unused int
 implementation::detect_encodings(const char *input,
@@ -25870,7 +26151,11 @@ implementation::detect_encodings(const char *input,
 #if SIMDUTF_FEATURE_UTF8 || SIMDUTF_FEATURE_DETECT_ENCODING
 simdutf_warn_unused bool
 implementation::validate_utf8(const char *buf, size_t len) const noexcept {
+  #if SIMDUTF_FALLBACK_MMX || SIMDUTF_FALLBACK_ALTIVEC
+  return ascii_blocks::validate_utf8(buf, len);
+  #else
   return scalar::utf8::validate(buf, len);
+  #endif
 }
 #endif // SIMDUTF_FEATURE_UTF8 || SIMDUTF_FEATURE_DETECT_ENCODING
 
@@ -25884,12 +26169,26 @@ simdutf_warn_unused result implementation::validate_utf8_with_errors(
 #if SIMDUTF_FEATURE_ASCII
 simdutf_warn_unused bool
 implementation::validate_ascii(const char *buf, size_t len) const noexcept {
+  #if SIMDUTF_FALLBACK_MMX || SIMDUTF_FALLBACK_ALTIVEC
+  const size_t pos =
+      ascii_blocks::ascii_prefix(reinterpret_cast<const uint8_t *>(buf), len);
+  return scalar::ascii::validate(buf + pos, len - pos);
+  #else
   return scalar::ascii::validate(buf, len);
+  #endif
 }
 
 simdutf_warn_unused result implementation::validate_ascii_with_errors(
     const char *buf, size_t len) const noexcept {
+  #if SIMDUTF_FALLBACK_MMX || SIMDUTF_FALLBACK_ALTIVEC
+  const size_t pos =
+      ascii_blocks::ascii_prefix(reinterpret_cast<const uint8_t *>(buf), len);
+  result res = scalar::ascii::validate_with_errors(buf + pos, len - pos);
+  res.count += pos;
+  return res;
+  #else
   return scalar::ascii::validate_with_errors(buf, len);
+  #endif
 }
 #endif // SIMDUTF_FEATURE_ASCII
 
@@ -25948,7 +26247,11 @@ simdutf_warn_unused result implementation::validate_utf32_with_errors(
 #if SIMDUTF_FEATURE_UTF8 && SIMDUTF_FEATURE_LATIN1
 simdutf_warn_unused size_t implementation::convert_latin1_to_utf8(
     const char *buf, size_t len, char *utf8_output) const noexcept {
+  #if SIMDUTF_FALLBACK_MMX || SIMDUTF_FALLBACK_ALTIVEC
+  return ascii_blocks::convert_latin1_to_utf8(buf, len, utf8_output);
+  #else
   return scalar::latin1_to_utf8::convert(buf, len, utf8_output);
+  #endif
 }
 #endif // SIMDUTF_FEATURE_UTF8 && SIMDUTF_FEATURE_LATIN1
 
@@ -25993,14 +26296,24 @@ simdutf_warn_unused size_t implementation::convert_valid_utf8_to_latin1(
 #if SIMDUTF_FEATURE_UTF8 && SIMDUTF_FEATURE_UTF16
 simdutf_warn_unused size_t implementation::convert_utf8_to_utf16le(
     const char *buf, size_t len, char16_t *utf16_output) const noexcept {
+  #if SIMDUTF_FALLBACK_MMX || SIMDUTF_FALLBACK_ALTIVEC
+  return ascii_blocks::convert_utf8_to_utf16<endianness::LITTLE>(buf, len,
+                                                                 utf16_output);
+  #else
   return scalar::utf8_to_utf16::convert<endianness::LITTLE>(buf, len,
                                                             utf16_output);
+  #endif
 }
 
 simdutf_warn_unused size_t implementation::convert_utf8_to_utf16be(
     const char *buf, size_t len, char16_t *utf16_output) const noexcept {
+  #if SIMDUTF_FALLBACK_MMX || SIMDUTF_FALLBACK_ALTIVEC
+  return ascii_blocks::convert_utf8_to_utf16<endianness::BIG>(buf, len,
+                                                              utf16_output);
+  #else
   return scalar::utf8_to_utf16::convert<endianness::BIG>(buf, len,
                                                          utf16_output);
+  #endif
 }
 
 simdutf_warn_unused result implementation::convert_utf8_to_utf16le_with_errors(
@@ -26351,11 +26664,42 @@ simdutf_warn_unused size_t implementation::utf32_length_from_utf8(
 
 #if SIMDUTF_FEATURE_BASE64
 
+  #if SIMDUTF_FALLBACK_ALTIVEC
+namespace {
+// Decodes the leading run of whole vector blocks, then lets the scalar code
+// handle the rest as it would have handled the full input: the run holds
+// alphabet characters only and is a multiple of four characters long, so it
+// changes neither how the padding is judged nor where the last chunk starts.
+// The run stops short of the end of the base64 text, so the scalar code always
+// sees the last of it and has the final say on what follows.
+full_result base64_decode_blocks(
+    const char *input, size_t length, char *output, base64_options options,
+    last_chunk_handling_options last_chunk_options) noexcept {
+  const size_t srclen =
+      simdutf::scalar::base64::find_end(input, length, options).srclen;
+  const size_t consumed =
+      srclen == 0 ? 0 : base64_blocks::decode(input, srclen - 1, output, options);
+  const size_t written = consumed / 4 * 3;
+  full_result r = simdutf::scalar::base64::base64_to_binary_details_impl(
+      input + consumed, length - consumed, output + written, options,
+      last_chunk_options);
+  r.input_count += consumed;
+  r.output_count += written;
+  return r;
+}
+} // unnamed namespace
+  #endif // SIMDUTF_FALLBACK_ALTIVEC
+
 simdutf_warn_unused result implementation::base64_to_binary(
     const char *input, size_t length, char *output, base64_options options,
     last_chunk_handling_options last_chunk_options) const noexcept {
+  #if SIMDUTF_FALLBACK_ALTIVEC
+  return base64_decode_blocks(input, length, output, options,
+                              last_chunk_options);
+  #else
   return simdutf::scalar::base64::base64_to_binary_details_impl(
       input, length, output, options, last_chunk_options);
+  #endif
 }
 
 simdutf_warn_unused result implementation::base64_to_binary(
@@ -26368,8 +26712,13 @@ simdutf_warn_unused result implementation::base64_to_binary(
 simdutf_warn_unused full_result implementation::base64_to_binary_details(
     const char *input, size_t length, char *output, base64_options options,
     last_chunk_handling_options last_chunk_options) const noexcept {
+  #if SIMDUTF_FALLBACK_ALTIVEC
+  return base64_decode_blocks(input, length, output, options,
+                              last_chunk_options);
+  #else
   return simdutf::scalar::base64::base64_to_binary_details_impl(
       input, length, output, options, last_chunk_options);
+  #endif
 }
 
 simdutf_warn_unused full_result implementation::base64_to_binary_details(
@@ -26382,7 +26731,18 @@ simdutf_warn_unused full_result implementation::base64_to_binary_details(
 size_t implementation::binary_to_base64(const char *input, size_t length,
                                         char *output,
                                         base64_options options) const noexcept {
+  #if SIMDUTF_FALLBACK_ALTIVEC
+  // Whole blocks need no padding; the scalar code encodes and pads the rest.
+  const size_t consumed =
+      base64_blocks::encode(input, length, output, options);
+  const size_t written = consumed / 3 * 4;
+  return written + scalar::base64::tail_encode_base64(output + written,
+                                                      input + consumed,
+                                                      length - consumed,
+                                                      options);
+  #else
   return scalar::base64::tail_encode_base64(output, input, length, options);
+  #endif
 }
 
 const char *implementation::find(const char *start, const char *end,
@@ -40776,14 +41136,8 @@ size_t convert_masked_utf8_to_latin1(const char *input,
   const auto tmp = vec_u64_t(latin1_packed.value);
   memcpy(latin1_output, &tmp[0], 8);
 #else
-  // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-  // Extract values manually without using vec_u64_t
-  uint64_t tmp[2];
-  vec_u8_t val = (vec_u8_t)latin1_packed.value;
-  for (int i = 0; i < 8; i++) {
-    ((char*)tmp)[i] = vec_extract(val, i);
-  }
-  memcpy(latin1_output, &tmp[0], 8);
+  // The first doubleword is the first eight bytes on big endian.
+  memcpy(latin1_output, &latin1_packed.value, 8);
 #endif
 #endif
   latin1_output += 6; // We wrote 6 bytes.
@@ -42274,17 +42628,11 @@ static simdutf_really_inline void compress(const vector_u8 data, uint16_t mask,
       tables::base64::thintable_epi8[mask2],
       tables::base64::thintable_epi8[mask1],
   };
-  // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-  // vec_reve is VSX-only, so we need to implement the reversal manually
-  vec_u8_t reversed = {((unsigned char*)tmp_arr)[15], ((unsigned char*)tmp_arr)[14], 
-                       ((unsigned char*)tmp_arr)[13], ((unsigned char*)tmp_arr)[12],
-                       ((unsigned char*)tmp_arr)[11], ((unsigned char*)tmp_arr)[10],
-                       ((unsigned char*)tmp_arr)[9],  ((unsigned char*)tmp_arr)[8],
-                       ((unsigned char*)tmp_arr)[7],  ((unsigned char*)tmp_arr)[6],
-                       ((unsigned char*)tmp_arr)[5],  ((unsigned char*)tmp_arr)[4],
-                       ((unsigned char*)tmp_arr)[3],  ((unsigned char*)tmp_arr)[2],
-                       ((unsigned char*)tmp_arr)[1],  ((unsigned char*)tmp_arr)[0]};
-  auto shufmask = vector_u8(reversed);
+  // vec_reve is VSX-only, so reverse the bytes with vec_perm.
+  const vec_u8_t reverse = {15, 14, 13, 12, 11, 10, 9, 8,
+                            7,  6,  5,  4,  3,  2,  1, 0};
+  const vec_u8_t loaded = altivec_load<vec_u8_t>(tmp_arr);
+  auto shufmask = vector_u8(vec_perm(loaded, loaded, reverse));
 #endif
 
   // we increment by 0x08 the second half of the mask
@@ -42304,8 +42652,7 @@ static simdutf_really_inline void compress(const vector_u8 data, uint16_t mask,
       tables::base64::thintable_epi8[mask1],
       tables::base64::thintable_epi8[mask2],
   };
-  // Use AltiVec-only approach for systems without VSX (like Power Mac G5)
-  auto shufmask = vector_u8(*(vec_u8_t*)tmp_arr);
+  auto shufmask = vector_u8(altivec_load<vec_u8_t>(tmp_arr));
 #endif
 
   // we increment by 0x08 the second half of the mask
@@ -53,7 +53,8 @@
 
 #include "cpu_features.h"
 
-#if defined(DEFLATE_SLIDE_HASH_SSE2) || defined(DEFLATE_SLIDE_HASH_NEON)
+#if defined(DEFLATE_SLIDE_HASH_SSE2) || defined(DEFLATE_SLIDE_HASH_NEON) || \
+    defined(DEFLATE_SLIDE_HASH_ALTIVEC) || defined(DEFLATE_SLIDE_HASH_3DNOW)
 #include "slide_hash_simd.h"
 #endif
 
@@ -178,7 +179,8 @@ local const config configuration_table[10] = {
 #  endif
 #endif
 local void slide_hash(deflate_state *s) {
-#if defined(DEFLATE_SLIDE_HASH_SSE2) || defined(DEFLATE_SLIDE_HASH_NEON)
+#if defined(DEFLATE_SLIDE_HASH_SSE2) || defined(DEFLATE_SLIDE_HASH_NEON) || \
+    defined(DEFLATE_SLIDE_HASH_ALTIVEC) || defined(DEFLATE_SLIDE_HASH_3DNOW)
     slide_hash_simd(s->head, s->prev, s->w_size, s->hash_size);
     return;
 #endif
@@ -58,7 +58,8 @@
 #endif
 
 #include "cpu_features.h"
-#if defined(ADLER32_SIMD_SSSE3) || defined(ADLER32_SIMD_NEON) || defined(ADLER32_SIMD_RVV)
+#if defined(ADLER32_SIMD_SSSE3) || defined(ADLER32_SIMD_NEON) \
+    || defined(ADLER32_SIMD_RVV) || defined(ADLER32_SIMD_ALTIVEC)
 #include "adler32_simd.h"
 #endif
 
@@ -68,13 +69,15 @@ uLong ZEXPORT adler32_z(uLong adler, const Bytef *buf, z_size_t len) {
     unsigned n;
     /* TODO(cavalcantii): verify if this lengths are optimal for current CPUs. */
 #if defined(ADLER32_SIMD_SSSE3) || defined(ADLER32_SIMD_NEON) \
-    || defined(ADLER32_SIMD_RVV)
+    || defined(ADLER32_SIMD_RVV) || defined(ADLER32_SIMD_ALTIVEC)
 #if defined(ADLER32_SIMD_SSSE3)
     if (buf != Z_NULL && len >= 64 && x86_cpu_enable_ssse3)
 #elif defined(ADLER32_SIMD_NEON)
     if (buf != Z_NULL && len >= 64)
 #elif defined(ADLER32_SIMD_RVV)
     if (buf != Z_NULL && len >= 32 && riscv_cpu_enable_rvv)
+#elif defined(ADLER32_SIMD_ALTIVEC)
+    if (buf != Z_NULL && len >= 64 && ppc_cpu_enable_altivec)
 #endif
         return adler32_simd_(adler, buf, len);
 #endif
@@ -95,7 +98,7 @@ uLong ZEXPORT adler32_z(uLong adler, const Bytef *buf, z_size_t len) {
     }
 
 #if defined(ADLER32_SIMD_SSSE3) || defined(ADLER32_SIMD_NEON) \
-    || defined(RISCV_RVV)
+    || defined(RISCV_RVV) || defined(ADLER32_SIMD_ALTIVEC)
     /*
      * Use SIMD to compute the adler32. Since this function can be
      * freely used, check CPU features here. zlib convention is to
@@ -14,7 +14,7 @@
  * SSE2 _mm_sad_epu8() can be used for byte sums (see http://bit.ly/2wpUOeD,
  * for example) and accumulating the byte sums can use SSE shuffle-adds (see
  * the "Integer" section of http://bit.ly/2erPT8t for details). Arm NEON has
- * similar instructions.
+ * similar instructions, and PowerPC AltiVec has vec_sum4s() and vec_msum().
  *
  * The adler32 B value (aka s2) sums the A values from each step:
  *
@@ -363,6 +363,133 @@ uint32_t ZLIB_INTERNAL adler32_simd_(  /* NEON */
     return s1 | (s2 << 16);
 }
 
+#elif defined(ADLER32_SIMD_ALTIVEC)
+
+#include <altivec.h>
+
+uint32_t ZLIB_INTERNAL adler32_simd_(  /* ALTIVEC */
+    uint32_t adler,
+    const unsigned char *buf,
+    z_size_t len)
+{
+    /*
+     * Split Adler-32 into component sums.
+     */
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+
+    /*
+     * Serially compute s1 & s2, until the data is 16-byte aligned: vec_ld
+     * ignores the low four address bits.
+     */
+    if ((uintptr_t)buf & 15) {
+        while ((uintptr_t)buf & 15) {
+            s2 += (s1 += *buf++);
+            --len;
+        }
+
+        if (s1 >= BASE)
+            s1 -= BASE;
+        s2 %= BASE;
+    }
+
+    /*
+     * Process the data in blocks.
+     */
+    const unsigned BLOCK_SIZE = 1 << 4;
+
+    z_size_t blocks = len / BLOCK_SIZE;
+    len -= blocks * BLOCK_SIZE;
+
+    const vector unsigned char v_weights = {
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+    const vector unsigned int v_zero = vec_splat_u32(0);
+
+    while (blocks)
+    {
+        unsigned n = NMAX / BLOCK_SIZE;  /* The NMAX constraint. */
+        if (n > blocks)
+            n = (unsigned) blocks;
+        blocks -= n;
+
+        /*
+         * Every block adds BLOCK_SIZE times the incoming s1 to s2.
+         */
+        s2 += s1 * n * BLOCK_SIZE;
+
+        /*
+         * Process n blocks of data. At most NMAX data bytes can be
+         * processed before s2 must be reduced modulo BASE.
+         */
+        vector unsigned int v_s1 = v_zero;
+        vector unsigned int v_s1_sums = v_zero;
+        vector unsigned int v_s2 = v_zero;
+
+        do {
+            /*
+             * Load 16 input bytes.
+             */
+            const vector unsigned char bytes = vec_ld(0, buf);
+
+            /*
+             * Accumulate the previous block byte sums for s2.
+             */
+            v_s1_sums = vec_add(v_s1_sums, v_s1);
+
+            /*
+             * Add the bytes for s1, four to a lane.
+             */
+            v_s1 = vec_sum4s(bytes, v_s1);
+
+            /*
+             * Multiply-add bytes by [ 16, 15, 14, ... ] for s2.
+             */
+            v_s2 = vec_msum(bytes, v_weights, v_s2);
+
+            buf += BLOCK_SIZE;
+
+        } while (--n);
+
+        v_s2 = vec_add(v_s2, vec_sl(v_s1_sums, vec_splat_u32(4)));
+
+        /*
+         * Sum the epi32 lanes of v_s1(s2) and accumulate in s1(s2). vec_sums
+         * saturates as signed, so add the lanes in scalar code.
+         */
+        union {
+            uint32_t lanes[4];
+            vector unsigned int v;
+        } sum1, sum2;
+        sum1.v = v_s1;
+        sum2.v = v_s2;
+
+        s1 += sum1.lanes[0] + sum1.lanes[1] + sum1.lanes[2] + sum1.lanes[3];
+        s2 += sum2.lanes[0] + sum2.lanes[1] + sum2.lanes[2] + sum2.lanes[3];
+
+        /*
+         * Reduce.
+         */
+        s1 %= BASE;
+        s2 %= BASE;
+    }
+
+    /*
+     * Handle leftover data.
+     */
+    while (len--) {
+        s2 += (s1 += *buf++);
+    }
+
+    if (s1 >= BASE)
+        s1 -= BASE;
+    s2 %= BASE;
+
+    /*
+     * Return the recombined sums.
+     */
+    return s1 | (s2 << 16);
+}
+
 #elif defined(ADLER32_SIMD_RVV)
 #include <riscv_vector.h>
 
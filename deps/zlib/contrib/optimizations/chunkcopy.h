@@ -33,6 +33,13 @@ typedef uint8x16_t z_vec128i_t;
 #elif defined(INFLATE_CHUNK_SIMD_SSE2)
 #include <emmintrin.h>
 typedef __m128i z_vec128i_t;
+#elif defined(INFLATE_CHUNK_SIMD_ALTIVEC)
+#include <altivec.h>
+typedef __vector unsigned char z_vec128i_t;
+#elif defined(INFLATE_CHUNK_SIMD_MMX)
+#include <mmintrin.h>
+/* A chunk is a pair of 8-byte MMX registers; see chunkcopy_leave(). */
+typedef struct { __m64 lo, hi; } z_vec128i_t;
 #elif defined(INFLATE_CHUNK_GENERIC)
 typedef struct { uint8_t x[16]; } z_vec128i_t;
 #else
@@ -65,9 +72,15 @@ Z_STATIC_ASSERT(vector_128_bits_wide,
  */
 static inline z_vec128i_t loadchunk(
     const unsigned char FAR* s) Z_DISABLE_MSAN {
+#if defined(INFLATE_CHUNK_SIMD_ALTIVEC) && defined(__BIG_ENDIAN__)
+  /* lvx ignores the low address bits, so merge the aligned blocks holding
+   * s[0] and s[15]. Both overlap the chunk, so neither can fault. */
+  return vec_perm(vec_ld(0, s), vec_ld(15, s), vec_lvsl(0, s));
+#else
   z_vec128i_t v;
   Z_BUILTIN_MEMCPY(&v, s, sizeof(v));
   return v;
+#endif
 }
 
 /*
@@ -269,6 +282,112 @@ static inline z_vec128i_t v_load8_dup(const void* src) {
 static inline void v_store_128(void* out, const z_vec128i_t vec) {
   _mm_storeu_si128((__m128i*)out, vec);
 }
+#elif defined(INFLATE_CHUNK_SIMD_ALTIVEC)
+/*
+ * v_load64_dup(): load *src as an unaligned 64-bit int and duplicate it in
+ * every 64-bit component of the 128-bit result (64-bit int splat).
+ */
+static inline z_vec128i_t v_load64_dup(const void* src) {
+  const __vector unsigned char dup64 = {
+      0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+  z_vec128i_t v;
+  Z_BUILTIN_MEMCPY(&v, src, 8);
+  return vec_perm(v, v, dup64);
+}
+
+/*
+ * v_load32_dup(): load *src as an unaligned 32-bit int and duplicate it in
+ * every 32-bit component of the 128-bit result (32-bit int splat).
+ */
+static inline z_vec128i_t v_load32_dup(const void* src) {
+  __vector unsigned int v;
+  Z_BUILTIN_MEMCPY(&v, src, 4);
+  return (z_vec128i_t)vec_splat(v, 0);
+}
+
+/*
+ * v_load16_dup(): load *src as an unaligned 16-bit int and duplicate it in
+ * every 16-bit component of the 128-bit result (16-bit int splat).
+ */
+static inline z_vec128i_t v_load16_dup(const void* src) {
+  __vector unsigned short v;
+  Z_BUILTIN_MEMCPY(&v, src, 2);
+  return (z_vec128i_t)vec_splat(v, 0);
+}
+
+/*
+ * v_load8_dup(): load the 8-bit int *src and duplicate it in every 8-bit
+ * component of the 128-bit result (8-bit int splat).
+ */
+static inline z_vec128i_t v_load8_dup(const void* src) {
+  z_vec128i_t v;
+  Z_BUILTIN_MEMCPY(&v, src, 1);
+  return vec_splat(v, 0);
+}
+
+/*
+ * v_store_128(): store the 128-bit vec in a memory destination (that might
+ * not be 16-byte aligned) void* out. AltiVec has no unaligned store.
+ */
+static inline void v_store_128(void* out, const z_vec128i_t vec) {
+  Z_BUILTIN_MEMCPY(out, &vec, sizeof(vec));
+}
+
+#elif defined(INFLATE_CHUNK_SIMD_MMX)
+/*
+ * v_load64_dup(): load *src as an unaligned 64-bit int and duplicate it in
+ * every 64-bit component of the 128-bit result (64-bit int splat).
+ */
+static inline z_vec128i_t v_load64_dup(const void* src) {
+  z_vec128i_t v;
+  Z_BUILTIN_MEMCPY(&v.lo, src, sizeof(v.lo));
+  v.hi = v.lo;
+  return v;
+}
+
+/*
+ * v_load32_dup(): load *src as an unaligned 32-bit int and duplicate it in
+ * every 32-bit component of the 128-bit result (32-bit int splat).
+ */
+static inline z_vec128i_t v_load32_dup(const void* src) {
+  int32_t i32;
+  z_vec128i_t v;
+  Z_BUILTIN_MEMCPY(&i32, src, sizeof(i32));
+  v.lo = v.hi = _mm_set1_pi32(i32);
+  return v;
+}
+
+/*
+ * v_load16_dup(): load *src as an unaligned 16-bit int and duplicate it in
+ * every 16-bit component of the 128-bit result (16-bit int splat).
+ */
+static inline z_vec128i_t v_load16_dup(const void* src) {
+  int16_t i16;
+  z_vec128i_t v;
+  Z_BUILTIN_MEMCPY(&i16, src, sizeof(i16));
+  v.lo = v.hi = _mm_set1_pi16(i16);
+  return v;
+}
+
+/*
+ * v_load8_dup(): load the 8-bit int *src and duplicate it in every 8-bit
+ * component of the 128-bit result (8-bit int splat).
+ */
+static inline z_vec128i_t v_load8_dup(const void* src) {
+  z_vec128i_t v;
+  v.lo = v.hi = _mm_set1_pi8(*(const char*)src);
+  return v;
+}
+
+/*
+ * v_store_128(): store the 128-bit vec in a memory destination (that might
+ * not be 8-byte aligned) void* out.
+ */
+static inline void v_store_128(void* out, const z_vec128i_t vec) {
+  Z_BUILTIN_MEMCPY(out, &vec.lo, sizeof(vec.lo));
+  Z_BUILTIN_MEMCPY((uint8_t*)out + sizeof(vec.lo), &vec.hi, sizeof(vec.hi));
+}
+
 #elif defined(INFLATE_CHUNK_GENERIC)
 /*
  * Default implementations for chunk-copy functions rely on memcpy() being
@@ -556,6 +675,17 @@ typedef unsigned long inflate_holder_t;
 
 #endif /* INFLATE_CHUNK_READ_64LE */
 
+/*
+ * chunkcopy_leave(): the MMX registers alias the x87 stack, so the MMX chunk
+ * type must empty the MMX state before control returns to code that may use
+ * floating point. A no-op for every other chunk type.
+ */
+static inline void chunkcopy_leave(void) {
+#if defined(INFLATE_CHUNK_SIMD_MMX)
+  _mm_empty();
+#endif
+}
+
 #undef Z_STATIC_ASSERT
 #undef Z_RESTRICT
 #undef Z_BUILTIN_MEMCPY
@@ -1275,6 +1275,7 @@ int ZEXPORT inflate(z_streamp strm, int flush) {
    else
       memset(put, 0x55, left);
 #endif
+    chunkcopy_leave();
     RESTORE();
     if (state->wsize || (out != strm->avail_out && state->mode < BAD &&
             (state->mode < CHECK || flush != Z_FINISH)))
@@ -11,7 +11,7 @@
 #include <stdint.h>
 #if defined(_MSC_VER)
 #include <intrin.h>
-#elif defined(ADLER32_SIMD_SSSE3)
+#elif defined(ADLER32_SIMD_SSSE3) || defined(X86_NOT_WINDOWS)
 #include <cpuid.h>
 #endif
 
@@ -33,13 +33,24 @@ int ZLIB_INTERNAL x86_cpu_enable_ssse3 = 0;
 int ZLIB_INTERNAL x86_cpu_enable_simd = 0;
 int ZLIB_INTERNAL x86_cpu_enable_avx512 = 0;
 int ZLIB_INTERNAL x86_cpu_enable_3dnow = 0;    /* 3DNow! support */
+int ZLIB_INTERNAL x86_cpu_enable_3dnowext = 0; /* 3DNow! Extensions support */
+int ZLIB_INTERNAL x86_cpu_enable_mmxext = 0;   /* MMX Extensions support */
 
 int ZLIB_INTERNAL ppc_cpu_enable_altivec = 0;  /* Altivec support */
 
 int ZLIB_INTERNAL riscv_cpu_enable_rvv = 0;
 int ZLIB_INTERNAL riscv_cpu_enable_vclmul = 0;
 
-#ifndef CPU_NO_SIMD
+/* AltiVec detection has no zlib SIMD code depending on it, but it is shared
+ * with V8 and Node's SIMD abstraction layer, so keep it even when zlib itself
+ * is built with CPU_NO_SIMD.
+ */
+#if defined(__PPC__) || defined(__powerpc__) || defined(__ppc__) || \
+    defined(__PPC64__) || defined(__powerpc64__)
+#define PPC_CPU_FEATURES
+#endif
+
+#if !defined(CPU_NO_SIMD) || defined(PPC_CPU_FEATURES)
 
 #if defined(ARMV8_OS_ANDROID) || defined(ARMV8_OS_LINUX) || \
     defined(ARMV8_OS_FUCHSIA) || defined(ARMV8_OS_IOS)
@@ -65,7 +76,8 @@ int ZLIB_INTERNAL riscv_cpu_enable_vclmul = 0;
 #error cpu_features.c CPU feature detection in not defined for your platform
 #endif
 
-#if !defined(CPU_NO_SIMD) && !defined(ARMV8_OS_MACOS)
+#if (!defined(CPU_NO_SIMD) || defined(PPC_CPU_FEATURES)) && \
+    !defined(ARMV8_OS_MACOS)
 static void _cpu_check_features(void);
 #endif
 
@@ -150,10 +162,17 @@ static void _cpu_check_features(void)
 #endif
 }
 #endif
-#elif defined(__PPC__) || defined(__powerpc__) || defined(__ppc__) || defined(__PPC64__) || defined(__powerpc64__)
+#elif defined(PPC_CPU_FEATURES)
 /*
  * PowerPC Altivec detection
  */
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/cputable.h>
+#endif
+
 static void _cpu_check_features(void)
 {
     /* Altivec detection on PowerPC is usually available through various methods
@@ -163,7 +182,6 @@ static void _cpu_check_features(void)
      */
 #if defined(__APPLE__)
     /* On macOS, use sysctl */
-    #include <sys/sysctl.h>
     int has_altivec = 0;
     size_t len = sizeof(has_altivec);
     if (sysctlbyname("hw.optional.altivec", &has_altivec, &len, NULL, 0) == 0) {
@@ -171,8 +189,6 @@ static void _cpu_check_features(void)
     }
 #elif defined(__linux__)
     /* On Linux, use HWCAP */
-    #include <sys/auxv.h>
-    #include <asm/hwcap.h>
     unsigned long hwcap = getauxval(AT_HWCAP);
     #ifdef PPC_FEATURE_HAS_ALTIVEC
         ppc_cpu_enable_altivec = !!(hwcap & PPC_FEATURE_HAS_ALTIVEC);
@@ -226,16 +242,32 @@ static void _cpu_check_features(void)
                           x86_cpu_has_sse42 &&
                           x86_cpu_has_pclmulqdq;
 
-    /* Check for 3DNow! support (AMD-specific extension) */
-    /* 3DNow! is bit 31 of EDX in CPUID function 0x80000001 */
+    /* The integer half of SSE (pshufw, pavgb, pmovmskb, ...) is what AMD
+     * sells as MMX Extensions, so any SSE capable CPU also has it.
+     */
+    x86_cpu_enable_mmxext = abcd[3] & 0x2000000;    /* SSE: bit 25 in EDX */
+
+    /* 3DNow!, 3DNow! Extensions and MMX Extensions are reported in the AMD
+     * extended leaf 0x80000001, which only exists when 0x80000000 says so.
+     */
     int extended_features[4];
 #ifdef _MSC_VER
-    __cpuid(extended_features, 0x80000001);
+    __cpuid(extended_features, 0x80000000);
+#else
+    __cpuid(0x80000000, extended_features[0], extended_features[1], extended_features[2], extended_features[3]);
+#endif
+    if ((unsigned)extended_features[0] >= 0x80000001u) {
+#ifdef _MSC_VER
+        __cpuid(extended_features, 0x80000001);
 #else
-    __cpuid(0x80000001, extended_features[0], extended_features[1], extended_features[2], extended_features[3]);
+        __cpuid(0x80000001, extended_features[0], extended_features[1], extended_features[2], extended_features[3]);
 #endif
-    x86_cpu_has_3dnow = extended_features[3] & 0x80000000;  /* Bit 31 in EDX */
-    x86_cpu_enable_3dnow = x86_cpu_has_3dnow;
+        x86_cpu_has_3dnow = extended_features[3] & 0x80000000;  /* Bit 31 in EDX */
+        x86_cpu_enable_3dnow = x86_cpu_has_3dnow;
+        x86_cpu_enable_3dnowext = x86_cpu_has_3dnow &&
+                                  (extended_features[3] & 0x40000000);  /* Bit 30 */
+        x86_cpu_enable_mmxext |= extended_features[3] & 0x400000;     /* Bit 22 */
+    }
 
 #ifdef CRC32_SIMD_AVX512_PCLMUL
     x86_cpu_enable_avx512 = _xgetbv(0) & 0x00000040;
@@ -260,4 +292,80 @@ static void _cpu_check_features(void)
   riscv_cpu_enable_rvv = !!(features & ZLIB_HWCAP_RVV);
 }
 #endif // ARM | x86 | RISCV
-#endif // NO SIMD CPU
+#endif // NO SIMD CPU || PPC
+
+/* Names of the implementations the runtime and build time selection in
+ * adler32.c, crc32.c, deflate.c (slide_hash_simd.h) and inffast_chunk.c
+ * (chunkcopy.h) ends up with, for diagnostics. The runtime choices are only
+ * meaningful once cpu_check_features() has run.
+ */
+const char* ZLIB_INTERNAL cpu_features_adler32_impl(void)
+{
+#if defined(ADLER32_SIMD_SSSE3)
+    if (x86_cpu_enable_ssse3)
+        return "ssse3";
+#elif defined(ADLER32_SIMD_NEON)
+    return "neon";
+#elif defined(ADLER32_SIMD_RVV)
+    if (riscv_cpu_enable_rvv)
+        return "rvv";
+#elif defined(ADLER32_SIMD_ALTIVEC)
+    if (ppc_cpu_enable_altivec)
+        return "altivec";
+#endif
+    return "scalar";
+}
+
+const char* ZLIB_INTERNAL cpu_features_crc32_impl(void)
+{
+#if defined(CRC32_SIMD_AVX512_PCLMUL)
+    if (x86_cpu_enable_avx512)
+        return "avx512-pclmul";
+#endif
+#if defined(CRC32_SIMD_SSE42_PCLMUL)
+    if (x86_cpu_enable_simd)
+        return "sse42-pclmul";
+#elif defined(CRC32_ARMV8_CRC32)
+    if (arm_cpu_enable_crc32)
+        return arm_cpu_enable_pmull ? "armv8-pmull" : "armv8-crc32";
+#endif
+#if defined(__i386__) || defined(_M_IX86)
+    return "slice-by-8";
+#else
+    return "braid";
+#endif
+}
+
+const char* ZLIB_INTERNAL cpu_features_slide_hash_impl(void)
+{
+#if defined(CPU_NO_SIMD)
+    return "scalar";
+#elif defined(__ALTIVEC__) && defined(DEFLATE_SLIDE_HASH_ALTIVEC)
+    return "altivec";
+#elif defined(__MMX__) && defined(DEFLATE_SLIDE_HASH_3DNOW)
+    return "mmx";
+#elif defined(DEFLATE_SLIDE_HASH_SSE2)
+    return "sse2";
+#elif defined(DEFLATE_SLIDE_HASH_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+const char* ZLIB_INTERNAL cpu_features_inflate_chunk_impl(void)
+{
+#if defined(INFLATE_CHUNK_SIMD_NEON)
+    return "neon";
+#elif defined(INFLATE_CHUNK_SIMD_SSE2)
+    return "sse2";
+#elif defined(INFLATE_CHUNK_SIMD_ALTIVEC)
+    return "altivec";
+#elif defined(INFLATE_CHUNK_SIMD_MMX)
+    return "mmx";
+#elif defined(INFLATE_CHUNK_GENERIC)
+    return "generic";
+#else
+    return "scalar";
+#endif
+}
@@ -16,9 +16,17 @@ extern int x86_cpu_enable_ssse3;
 extern int x86_cpu_enable_simd;
 extern int x86_cpu_enable_avx512;
 extern int x86_cpu_enable_3dnow;    /* 3DNow! support */
+extern int x86_cpu_enable_3dnowext; /* 3DNow! Extensions support */
+extern int x86_cpu_enable_mmxext;   /* MMX Extensions (pshufw, pavgb, ...) */
 extern int ppc_cpu_enable_altivec;  /* Altivec support */
 
 extern int riscv_cpu_enable_rvv;
 extern int riscv_cpu_enable_vclmul;
 
 void cpu_check_features(void);
+
+/* Name of the implementation each accelerated routine uses, e.g. "ssse3" */
+const char* cpu_features_adler32_impl(void);
+const char* cpu_features_crc32_impl(void);
+const char* cpu_features_slide_hash_impl(void);
+const char* cpu_features_inflate_chunk_impl(void);
@@ -59,6 +59,12 @@
 /* Define N */
 #ifdef Z_TESTN
 #  define N Z_TESTN
+#elif (defined(__i386__) || defined(_M_IX86)) && !defined(MAKECRCH)
+   /* Five braids do not fit in the seven usable registers of 32-bit x86 and
+      spill on every step. A single braid of 64-bit words (N=1, W=8) is the
+      classic slice-by-8 loop, which stays in registers on Athlon and
+      Pentium III class CPUs. */
+#  define N 1
 #else
 #  define N 5
 #endif
@@ -85,7 +91,7 @@
 #  ifdef MAKECRCH
 #    define W 8         /* required for MAKECRCH */
 #  else
-#    if defined(__x86_64__) || defined(__aarch64__)
+#    if defined(__x86_64__) || defined(__aarch64__) || N == 1
 #      define W 8
 #    else
 #      define W 4
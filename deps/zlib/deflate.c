@@ -53,7 +53,8 @@
 
 #include "cpu_features.h"
 
-#if defined(DEFLATE_SLIDE_HASH_SSE2) || defined(DEFLATE_SLIDE_HASH_NEON)
+#if defined(DEFLATE_SLIDE_HASH_SSE2) || defined(DEFLATE_SLIDE_HASH_NEON) || \
+    defined(DEFLATE_SLIDE_HASH_ALTIVEC) || defined(DEFLATE_SLIDE_HASH_3DNOW)
 #include "slide_hash_simd.h"
 #endif
 
@@ -63,6 +64,16 @@
 
 #include "contrib/optimizations/insert_string.h"
 
+/* On the Athlon and PowerPC builds, where memory latency dominates,
+ * longest_match() prefetches the next candidate of the hash chain while it
+ * compares the current one. */
+#if defined(__GNUC__) && \
+    (defined(DEFLATE_SLIDE_HASH_3DNOW) || defined(DEFLATE_SLIDE_HASH_ALTIVEC))
+#define Z_PREFETCH(p) __builtin_prefetch((p), 0, 3)
+#else
+#define Z_PREFETCH(p)
+#endif
+
 #ifdef FASTEST
 /* See http://crbug.com/1113596 */
 #error "FASTEST is not supported in Chromium's zlib."
@@ -178,7 +189,8 @@ local const config configuration_table[10] = {
 #  endif
 #endif
 local void slide_hash(deflate_state *s) {
-#if defined(DEFLATE_SLIDE_HASH_SSE2) || defined(DEFLATE_SLIDE_HASH_NEON)
+#if defined(DEFLATE_SLIDE_HASH_SSE2) || defined(DEFLATE_SLIDE_HASH_NEON) || \
+    defined(DEFLATE_SLIDE_HASH_ALTIVEC) || defined(DEFLATE_SLIDE_HASH_3DNOW)
     slide_hash_simd(s->head, s->prev, s->w_size, s->hash_size);
     return;
 #endif
@@ -1486,6 +1498,7 @@ local uInt longest_match(deflate_state *s, IPos cur_match) {
     do {
         Assert(cur_match < s->strstart, "no future");
         match = s->window + cur_match;
+        Z_PREFETCH(s->window + prev[cur_match & wmask] + best_len - 1);
 
         /* Skip to next match if the match length cannot increase
          * or if the match length is less than 2.  Note that the checks below
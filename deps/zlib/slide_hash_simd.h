@@ -22,6 +22,70 @@
 
 #error SIMD has been disabled for your build target
 
+#elif defined(__ALTIVEC__) && defined(DEFLATE_SLIDE_HASH_ALTIVEC)
+
+#include <altivec.h>  /* AltiVec */
+#undef vector
+#undef pixel
+#undef bool
+
+#define Z_SLIDE_INIT_SIMD(wsize) \
+    (__vector unsigned short){(ush)(wsize), (ush)(wsize), (ush)(wsize), \
+        (ush)(wsize), (ush)(wsize), (ush)(wsize), (ush)(wsize), (ush)(wsize)}
+
+/*
+ * vec_ld() and vec_st() ignore the low four address bits, and the zalloc hook
+ * only promises Pos alignment for the tables (Node's prefixes every block with
+ * its size, for one), so slide the entries outside the 16-byte aligned middle
+ * one at a time.
+ */
+local INLINE void slide_hash_altivec_(
+    Posf *table, uInt size, __vector unsigned short vector_wsize) {
+    union {
+        ush lanes[8];
+        __vector unsigned short v;
+    } wsize;
+    Posf *const end = table + size;
+    wsize.v = vector_wsize;
+
+    for (; table != end && ((z_size_t)table & 15) != 0; table++)
+        *table = (Pos)(*table >= wsize.lanes[0] ? *table - wsize.lanes[0] : NIL);
+    for (; end - table >= 8; table += 8) {
+        __vector unsigned short vO = vec_ld(0, (unsigned short*)table);
+        vec_st(vec_subs(vO, vector_wsize), 0, (unsigned short*)table);
+    }
+    for (; table != end; table++)
+        *table = (Pos)(*table >= wsize.lanes[0] ? *table - wsize.lanes[0] : NIL);
+}
+
+#define Z_SLIDE_HASH_SIMD(table, size, vector_wsize) \
+    slide_hash_altivec_(table, size, vector_wsize)
+
+typedef __vector unsigned short z_vec128i_u16x8_t;
+
+#elif defined(__MMX__) && defined(DEFLATE_SLIDE_HASH_3DNOW)
+
+#include <mmintrin.h>  /* MMX, present on every 3DNow! CPU */
+
+#define Z_SLIDE_INIT_SIMD(wsize) _mm_set1_pi16((short)(wsize))
+
+#define Z_SLIDE_HASH_SIMD(table, size, vector_wsize) \
+    for (const Posf* const end = table + size; table != end;) { \
+        __m64 vO, v4; \
+        zmemcpy(&vO, table + 0, sizeof(vO)); \
+        zmemcpy(&v4, table + 4, sizeof(v4)); \
+        vO = _mm_subs_pu16(vO, vector_wsize); \
+        v4 = _mm_subs_pu16(v4, vector_wsize); \
+        zmemcpy(table + 0, &vO, sizeof(vO)); \
+        zmemcpy(table + 4, &v4, sizeof(v4)); \
+        table += 4 + 4; \
+    }
+
+/* The MMX registers alias the x87 stack. */
+#define Z_SLIDE_LEAVE_SIMD() _mm_empty()
+
+typedef __m64 z_vec128i_u16x8_t;
+
 #elif defined(DEFLATE_SLIDE_HASH_SSE2)
 
 #include <emmintrin.h>  /* SSE2 */
@@ -63,6 +127,10 @@ typedef uint16x8_t z_vec128i_u16x8_t;
 
 #endif
 
+#ifndef Z_SLIDE_LEAVE_SIMD
+#define Z_SLIDE_LEAVE_SIMD()
+#endif
+
 /* ===========================================================================
  * Slide the hash table when sliding the window down (could be avoided with 32
  * bit values at the expense of memory usage). We slide even when level == 0 to
@@ -106,10 +174,11 @@ local INLINE void slide_hash_simd(
 #ifndef FASTEST
     Z_SLIDE_HASH_SIMD(prev, w_size, vec_wsize);
 #endif
-
+    Z_SLIDE_LEAVE_SIMD();
 }
 
 #undef z_vec128i_u16x8_t
+#undef Z_SLIDE_LEAVE_SIMD
 #undef Z_SLIDE_HASH_SIMD
 #undef Z_SLIDE_INIT_SIMD
 
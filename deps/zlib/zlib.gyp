@@ -7,6 +7,8 @@
     'ZLIB_ROOT': '.',
     'use_system_zlib%': 0,
     'arm_fpu%': '',
+    'node_enable_3dnow%': 'false',
+    'node_enable_altivec%': 'false',
   },
   'conditions': [
     ['use_system_zlib==0', {
@@ -39,6 +41,14 @@
             ['arm_fpu=="neon"', {
               'defines': [ 'ADLER32_SIMD_NEON' ],
             }],
+            ['target_arch in "ppc ppc64"', {
+              # Selected at runtime from ppc_cpu_enable_altivec.
+              'defines': [ 'ADLER32_SIMD_ALTIVEC' ],
+              'cflags': [ '-maltivec' ],
+              'xcode_settings': {
+                'OTHER_CFLAGS': [ '-maltivec' ],
+              },
+            }],
           ],
           'include_dirs': [ '<(ZLIB_ROOT)' ],
           'direct_dependent_settings': {
@@ -56,6 +66,9 @@
               ['arm_fpu=="neon"', {
                 'defines': [ 'ADLER32_SIMD_NEON' ],
               }],
+              ['target_arch in "ppc ppc64"', {
+                'defines': [ 'ADLER32_SIMD_ALTIVEC' ],
+              }],
             ],
             'include_dirs': [ '<(ZLIB_ROOT)' ],
           },
@@ -142,13 +155,43 @@
           'target_name': 'zlib_data_chunk_simd',
           'type': 'static_library',
           'conditions': [
-            ['target_arch == "ia32" and OS!="ios"', {
-              # For 32-bit x86, we use a different approach since advanced SIMD may not be available
+            ['target_arch == "ia32" and OS!="ios" and node_enable_3dnow!="true"', {
+              # For 32-bit x86, use more conservative SIMD flags
               'defines': [ 'INFLATE_CHUNK_SIMD_SSE2' ],
+              'conditions': [
+                ['OS!="win" or clang==1', {
+                  'cflags': [ '-msse2', '-mfpmath=sse' ],
+                  'xcode_settings': {
+                    'OTHER_CFLAGS': [ '-msse2', '-mfpmath=sse' ],
+                  },
+                }],
+              ],
+            }],
+            ['target_arch == "ia32" and OS!="ios" and node_enable_3dnow=="true"', {
+              # Athlon and K6 class CPUs without SSE2 copy in 8-byte MMX halves.
+              'defines': [ 'INFLATE_CHUNK_SIMD_MMX' ],
+              'cflags': [ '-mmmx' ],
             }],
             ['target_arch == "x64" and OS!="ios"', {
-              'defines': [ 'INFLATE_CHUNK_SIMD_SSE2' ],
-              'defines': [ 'INFLATE_CHUNK_READ_64LE' ],
+              'defines': [
+                'INFLATE_CHUNK_SIMD_SSE2',
+                'INFLATE_CHUNK_READ_64LE',
+              ],
+              'conditions': [
+                ['OS!="win" or clang==1', {
+                  'cflags': [ '-msse4.2' ],
+                  'xcode_settings': {
+                    'OTHER_CFLAGS': [ '-msse4.2' ],
+                  },
+                }],
+              ],
+            }],
+            ['target_arch in "ppc ppc64" and node_enable_altivec=="true"', {
+              'defines': [ 'INFLATE_CHUNK_SIMD_ALTIVEC' ],
+              'cflags': [ '-maltivec' ],
+              'xcode_settings': {
+                'OTHER_CFLAGS': [ '-maltivec' ],
+              },
             }],
             ['arm_fpu=="neon"', {
               'defines': [ 'INFLATE_CHUNK_SIMD_NEON' ],
@@ -166,9 +209,15 @@
                 'defines': [ 'INFLATE_CHUNK_SIMD_SSE2' ],
               }],
               # For 32-bit x86, only apply simpler SIMD features
-              ['target_arch == "ia32" and OS!="ios"', {
+              ['target_arch == "ia32" and OS!="ios" and node_enable_3dnow!="true"', {
                 'defines': [ 'INFLATE_CHUNK_SIMD_SSE2' ],
               }],
+              ['target_arch == "ia32" and OS!="ios" and node_enable_3dnow=="true"', {
+                'defines': [ 'INFLATE_CHUNK_SIMD_MMX' ],
+              }],
+              ['target_arch in "ppc ppc64" and node_enable_altivec=="true"', {
+                'defines': [ 'INFLATE_CHUNK_SIMD_ALTIVEC' ],
+              }],
               ['arm_fpu=="neon"', {
                 'defines': [ 'INFLATE_CHUNK_SIMD_NEON' ],
               }],
@@ -178,30 +227,6 @@
           'sources': [
             '<!@pymod_do_main(GN-scraper "<(ZLIB_ROOT)/BUILD.gn" "\\"zlib_data_chunk_simd\\".*?sources = ")',
           ],
-          'conditions': [
-            # For 32-bit x86 builds, use more conservative SIMD flags
-            ['target_arch == "ia32" and OS!="ios"', {
-              'defines': [ 'INFLATE_CHUNK_SIMD_SSE2' ],  # Define SSE2 support for 32-bit x86
-              'conditions': [
-                ['OS!="win" or clang==1', {
-                  'cflags': [ '-msse2', '-mfpmath=sse' ],
-                  'xcode_settings': {
-                    'OTHER_CFLAGS': [ '-msse2', '-mfpmath=sse' ],
-                  },
-                }],
-              ],
-            }],
-            ['target_arch == "x64" and OS!="ios"', {
-              'conditions': [
-                ['OS!="win" or clang==1', {
-                  'cflags': [ '-msse4.2' ],
-                  'xcode_settings': {
-                    'OTHER_CFLAGS': [ '-msse4.2' ],
-                  },
-                }],
-              ],
-            }],
-          ],
         }, # zlib_data_chunk_simd
         {
           'target_name': 'zlib',
@@ -221,7 +246,7 @@
             }, {
               'defines': [ 'ZLIB_DLL' ]
             }],
-            ['target_arch in "ia32 x64" and OS!="ios"', {
+            ['target_arch in "ia32 x64" and OS!="ios" and node_enable_3dnow!="true"', {
               'conditions': [
                 ['OS!="win" or clang==1', {
                   'cflags': [ '-mssse3', '-msse2', '-msse4.2', '-mpclmul' ],
@@ -240,7 +265,8 @@
               ],
             }],
             # Incorporate optimizations where possible.
-            ['(target_arch in "ia32 x64" and OS!="ios") or arm_fpu=="neon"', {
+            ['(target_arch in "ia32 x64" and OS!="ios") or arm_fpu=="neon" or '
+             '(target_arch in "ppc ppc64" and node_enable_altivec=="true")', {
               'dependencies': [ 'zlib_data_chunk_simd' ],
               'sources': [ '<(ZLIB_ROOT)/slide_hash_simd.h' ],
               'conditions': [
@@ -256,7 +282,7 @@
                   ],
                 }],
                 # For 32-bit x86 builds, use more conservative SIMD flags
-                ['target_arch == "ia32" and OS!="ios"', {
+                ['target_arch == "ia32" and OS!="ios" and node_enable_3dnow!="true"', {
                   'defines': [ 'INFLATE_CHUNK_SIMD_SSE2' ],  # Define SSE2 support for 32-bit x86
                   'conditions': [
                     ['OS!="win" or clang==1', {
@@ -267,6 +293,12 @@
                     }],
                   ],
                 }],
+                ['target_arch == "ia32" and OS!="ios" and node_enable_3dnow=="true"', {
+                  'defines': [ 'INFLATE_CHUNK_SIMD_MMX' ],
+                }],
+                ['target_arch in "ppc ppc64" and node_enable_altivec=="true"', {
+                  'defines': [ 'INFLATE_CHUNK_SIMD_ALTIVEC' ],
+                }],
               ],
             }, {
               'defines': [ 'CPU_NO_SIMD' ],
@@ -279,13 +311,31 @@
                 # See https://github.com/nodejs/node/issues/45268.
                 # 'zlib_crc32_simd',
               ],
-              'defines': [ 'DEFLATE_SLIDE_HASH_SSE2' ],
               'conditions': [
+                ['node_enable_3dnow=="true"', {
+                  # psubusw on the MMX unit of Athlon-class CPUs.
+                  'defines': [ 'DEFLATE_SLIDE_HASH_3DNOW' ],
+                  'cflags': [ '-mmmx' ],
+                }, {
+                  'defines': [ 'DEFLATE_SLIDE_HASH_SSE2' ],
+                }],
                 ['target_arch=="x64"', {
                   'defines': [ 'INFLATE_CHUNK_READ_64LE' ],
                 }],
               ],
             }],
+            ['target_arch in "ppc ppc64"', {
+              'dependencies': [ 'zlib_adler32_simd' ],
+              'conditions': [
+                ['node_enable_altivec=="true"', {
+                  'defines': [ 'DEFLATE_SLIDE_HASH_ALTIVEC' ],
+                  'cflags': [ '-maltivec' ],
+                  'xcode_settings': {
+                    'OTHER_CFLAGS': [ '-maltivec' ],
+                  },
+                }],
+              ],
+            }],
             ['arm_fpu=="neon"', {
               'defines': [
                 '__ARM_NEON__',
@@ -15,6 +15,8 @@
     'ossfuzz' : 'false',
     'node_module_version%': '',
     'node_use_amaro%': 'true',
+    'node_use_usdt%': 'false',
+    'node_use_allocation_counting%': 'false',
     'node_shared_brotli%': 'false',
     'node_shared_zstd%': 'false',
     'node_shared_zlib%': 'false',
@@ -29,6 +31,7 @@
     'node_use_sqlite%': 'true',
     'node_shared_openssl%': 'false',
     'node_v8_options%': '',
+    'node_default_memory_profile%': 'default',
     'node_enable_v8_vtunejit%': 'false',
     'node_core_target_name%': 'node',
     'node_lib_target_name%': 'libnode',
@@ -98,8 +101,11 @@
       'src/js_stream.cc',
       'src/json_utils.cc',
       'src/js_udp_wrap.cc',
+      'src/module_prefetch.cc',
+      'src/module_stat_cache.cc',
       'src/module_wrap.cc',
       'src/node.cc',
+      'src/node_allocation_counter.cc',
       'src/node_api.cc',
       'src/node_binding.cc',
       'src/node_blob.cc',
@@ -109,9 +115,11 @@
       'src/node_config_file.cc',
       'src/node_constants.cc',
       'src/node_contextify.cc',
+      'src/node_continuous_profiler.cc',
       'src/node_credentials.cc',
       'src/node_debug.cc',
       'src/node_dir.cc',
+      'src/node_dns_cache.cc',
       'src/node_dotenv.cc',
       'src/node_env_var.cc',
       'src/node_errors.cc',
@@ -120,11 +128,13 @@
       'src/node_http_parser.cc',
       'src/node_http2.cc',
       'src/node_i18n.cc',
+      'src/node_json.cc',
       'src/node_locks.cc',
       'src/node_main_instance.cc',
       'src/node_messaging.cc',
       'src/node_metadata.cc',
       'src/node_modules.cc',
+      'src/node_multipart.cc',
       'src/node_options.cc',
       'src/node_os.cc',
       'src/node_perf.cc',
@@ -139,8 +149,11 @@
       'src/node_report_utils.cc',
       'src/node_sea.cc',
       'src/node_serdes.cc',
+      'src/node_simd_calibration.cc',
+      'src/node_simd_dispatch.cc',
       'src/node_shadow_realm.cc',
       'src/node_snapshotable.cc',
+      'src/node_startup_phases.cc',
       'src/node_sockaddr.cc',
       'src/node_stat_watcher.cc',
       'src/node_symbols.cc',
@@ -150,6 +163,7 @@
       'src/node_types.cc',
       'src/node_url.cc',
       'src/node_url_pattern.cc',
+      'src/node_usdt.cc',
       'src/node_util.cc',
       'src/node_v8.cc',
       'src/node_wasi.cc',
@@ -168,7 +182,14 @@
       'src/permission/addon_permission.cc',
       'src/pipe_wrap.cc',
       'src/process_wrap.cc',
+      'src/read_buffer_pool.cc',
       'src/signal_wrap.cc',
+      'src/simd_abstraction.c',
+      'src/simd_kernels_3dnow.c',
+      'src/simd_kernels_altivec.c',
+      'src/simd_kernels_mmx.c',
+      'src/simd_kernels_scalar.c',
+      'src/simd_kernels_sse2.c',
       'src/spawn_sync.cc',
       'src/stream_base.cc',
       'src/stream_pipe.cc',
@@ -176,11 +197,14 @@
       'src/string_bytes.cc',
       'src/string_decoder.cc',
       'src/tcp_wrap.cc',
+      'src/threadpool_metrics.cc',
+      'src/timer_wheel.cc',
       'src/timers.cc',
       'src/timer_wrap.cc',
       'src/tracing/agent.cc',
       'src/tracing/node_trace_buffer.cc',
       'src/tracing/node_trace_writer.cc',
+      'src/tracing/perfetto_trace_writer.cc',
       'src/tracing/trace_event.cc',
       'src/tracing/traced_value.cc',
       'src/tty_wrap.cc',
@@ -243,8 +267,11 @@
       'src/large_pages/node_large_page.h',
       'src/memory_tracker.h',
       'src/memory_tracker-inl.h',
+      'src/module_prefetch.h',
+      'src/module_stat_cache.h',
       'src/module_wrap.h',
       'src/node.h',
+      'src/node_allocation_counter.h',
       'src/node_api.h',
       'src/node_api_types.h',
       'src/node_binding.h',
@@ -255,8 +282,10 @@
       'src/node_constants.h',
       'src/node_context_data.h',
       'src/node_contextify.h',
+      'src/node_continuous_profiler.h',
       'src/node_debug.h',
       'src/node_dir.h',
+      'src/node_dns_cache.h',
       'src/node_dotenv.h',
       'src/node_errors.h',
       'src/node_exit_code.h',
@@ -269,6 +298,7 @@
       'src/node_http2_state.h',
       'src/node_i18n.h',
       'src/node_internals.h',
+      'src/node_json.h',
       'src/node_locks.h',
       'src/node_main_instance.h',
       'src/node_mem.h',
@@ -277,6 +307,7 @@
       'src/node_metadata.h',
       'src/node_mutex.h',
       'src/node_modules.h',
+      'src/node_multipart.h',
       'src/node_object_wrap.h',
       'src/node_options.h',
       'src/node_options-inl.h',
@@ -285,6 +316,7 @@
       'src/node_platform.h',
       'src/node_process.h',
       'src/node_process-inl.h',
+      'src/node_protobuf.h',
       'src/node_realm.h',
       'src/node_realm-inl.h',
       'src/node_report.h',
@@ -293,6 +325,9 @@
       'src/node_sea.h',
       'src/node_shadow_realm.h',
       'src/node_snapshotable.h',
+      'src/node_startup_phases.h',
+      'src/node_simd_calibration.h',
+      'src/node_simd_dispatch.h',
       'src/node_snapshot_builder.h',
       'src/node_sockaddr.h',
       'src/node_sockaddr-inl.h',
@@ -300,6 +335,7 @@
       'src/node_union_bytes.h',
       'src/node_url.h',
       'src/node_url_pattern.h',
+      'src/node_usdt.h',
       'src/node_version.h',
       'src/node_v8.h',
       'src/node_v8_platform-inl.h',
@@ -316,8 +352,11 @@
       'src/permission/net_permission.h',
       'src/permission/addon_permission.h',
       'src/pipe_wrap.h',
+      'src/read_buffer_pool.h',
       'src/req_wrap.h',
       'src/req_wrap-inl.h',
+      'src/simd_abstraction.h',
+      'src/simd_kernels.h',
       'src/spawn_sync.h',
       'src/stream_base.h',
       'src/stream_base-inl.h',
@@ -327,10 +366,13 @@
       'src/string_decoder.h',
       'src/string_decoder-inl.h',
       'src/tcp_wrap.h',
+      'src/threadpool_metrics.h',
+      'src/timer_wheel.h',
       'src/timers.h',
       'src/tracing/agent.h',
       'src/tracing/node_trace_buffer.h',
       'src/tracing/node_trace_writer.h',
+      'src/tracing/perfetto_trace_writer.h',
       'src/tracing/trace_event.h',
       'src/tracing/trace_event_common.h',
       'src/tracing/traced_value.h',
@@ -440,6 +482,8 @@
       'src/node_webstorage.h',
     ],
     'node_mksnapshot_exec': '<(PRODUCT_DIR)/<(EXECUTABLE_PREFIX)node_mksnapshot<(EXECUTABLE_SUFFIX)',
+    # Prefixed to node_mksnapshot_exec, e.g. qemu-user when cross compiling.
+    'node_mksnapshot_runner%': [],
     'node_js2c_exec': '<(PRODUCT_DIR)/<(EXECUTABLE_PREFIX)node_js2c<(EXECUTABLE_SUFFIX)',
     'conditions': [
       ['GENERATOR == "ninja"', {
@@ -730,6 +774,7 @@
                     '<(SHARED_INTERMEDIATE_DIR)/node_snapshot.cc',
                   ],
                   'action': [
+                    '<@(node_mksnapshot_runner)',
                     '<(node_mksnapshot_exec)',
                     '--build-snapshot',
                     '<(node_snapshot_main)',
@@ -749,6 +794,7 @@
                     '<(SHARED_INTERMEDIATE_DIR)/node_snapshot.cc',
                   ],
                   'action': [
+                    '<@(node_mksnapshot_runner)',
                     '<@(_inputs)',
                     '<@(_outputs)',
                   ],
@@ -984,6 +1030,12 @@
           ],
           'defines': [ 'HAVE_SQLITE=1' ],
         }],
+        [ 'node_use_usdt=="true"', {
+          'defines': [ 'NODE_HAVE_USDT=1' ],
+        }],
+        [ 'node_use_allocation_counting=="true"', {
+          'defines': [ 'NODE_ALLOCATION_COUNTING=1' ],
+        }],
         [ 'OS in "linux freebsd mac solaris openharmony" and '
           'target_arch=="x64" and '
           'node_target_type=="executable"', {
@@ -1287,6 +1339,160 @@
       ],
     }, # cctest
 
+    {
+      'target_name': 'simd_bench',
+      'type': 'executable',
+
+      'dependencies': [
+        '<(node_lib_target_name)',
+      ],
+
+      'includes': [
+        'node.gypi'
+      ],
+
+      'include_dirs': [
+        'src',
+        'deps/v8/include',
+        'deps/uv/include',
+      ],
+
+      'sources': [ 'benchmark/simd/simd_bench.cc' ],
+
+      'conditions': [
+        [ 'OS=="win" and node_shared=="true"', {
+          'type': 'none',
+        }],
+        # Avoid excessive LTO
+        ['enable_lto=="true"', {
+          'ldflags': [ '-fno-lto' ],
+        }],
+      ],
+    }, # simd_bench
+
+    {
+      'target_name': 'simd_fuzz',
+      'type': 'executable',
+
+      'dependencies': [
+        '<(node_lib_target_name)',
+      ],
+
+      'includes': [
+        'node.gypi'
+      ],
+
+      'include_dirs': [
+        'src',
+        'deps/v8/include',
+        'deps/uv/include',
+      ],
+
+      'sources': [ 'benchmark/simd/simd_fuzz.cc' ],
+
+      'conditions': [
+        [ 'OS=="win" and node_shared=="true"', {
+          'type': 'none',
+        }],
+        # Avoid excessive LTO
+        ['enable_lto=="true"', {
+          'ldflags': [ '-fno-lto' ],
+        }],
+      ],
+    }, # simd_fuzz
+
+    {
+      'target_name': 'node_bench',
+      'type': 'executable',
+
+      'dependencies': [
+        '<(node_lib_target_name)',
+        'deps/histogram/histogram.gyp:histogram',
+        'deps/nbytes/nbytes.gyp:nbytes',
+        'tools/v8_gypfiles/abseil.gyp:abseil',
+      ],
+
+      'includes': [
+        'node.gypi'
+      ],
+
+      'include_dirs': [
+        'src',
+        'deps/v8/include',
+        'deps/uv/include',
+        'benchmark/native',
+      ],
+
+      'defines': [
+        'NODE_WANT_INTERNALS=1',
+      ],
+
+      'sources': [
+        'src/node_snapshot_stub.cc',
+        'benchmark/native/bench_dataqueue.cc',
+        'benchmark/native/bench_fs_permission.cc',
+        'benchmark/native/bench_histogram.cc',
+        'benchmark/native/bench_list_head.cc',
+        'benchmark/native/bench_lru_cache.cc',
+        'benchmark/native/bench_task_queue.cc',
+        'benchmark/native/node_bench.cc',
+        'benchmark/native/node_bench.h',
+      ],
+
+      'conditions': [
+        [ 'node_use_openssl=="true"', {
+          'defines': [
+            'HAVE_OPENSSL=1',
+          ],
+          'dependencies': [
+            'deps/ncrypto/ncrypto.gyp:ncrypto',
+          ],
+        }],
+        [ 'OS=="win" and node_shared=="true"', {
+          'type': 'none',
+        }],
+        # Avoid excessive LTO
+        ['enable_lto=="true"', {
+          'ldflags': [ '-fno-lto' ],
+        }],
+      ],
+    }, # node_bench
+
+    {
+      'target_name': 'http_load',
+      'type': 'executable',
+
+      'dependencies': [
+        '<(node_lib_target_name)',
+        'deps/histogram/histogram.gyp:histogram',
+      ],
+
+      'includes': [
+        'node.gypi'
+      ],
+
+      'include_dirs': [
+        'deps/uv/include',
+      ],
+
+      'sources': [ 'benchmark/http_load/http_load.cc' ],
+
+      'conditions': [
+        [ 'node_use_openssl=="true"', {
+          'defines': [
+            'HAVE_OPENSSL=1',
+          ],
+        }],
+        [ 'OS=="win" and node_shared=="true"', {
+          'type': 'none',
+        }],
+        # Avoid excessive LTO
+        ['enable_lto=="true"', {
+          'ldflags': [ '-fno-lto' ],
+        }],
+      ],
+    }, # http_load
+
     {
       'target_name': 'embedtest',
       'type': 'executable',
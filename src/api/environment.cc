@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #if HAVE_OPENSSL
 #include "crypto/crypto_util.h"
 #endif  // HAVE_OPENSSL
@@ -196,9 +198,136 @@ void DebuggingArrayBufferAllocator::RegisterPointerInternal(void* data,
   allocations_[data] = size;
 }
 
+SlabArrayBufferAllocator::~SlabArrayBufferAllocator() {
+  for (auto& entry : slabs_) {
+    allocator_->Free(entry.second->start, kSlabSize);
+  }
+}
+
+size_t SlabArrayBufferAllocator::SizeClassOf(size_t size) {
+  size_t size_class = 0;
+  for (size_t block_size = kMinBlockSize; block_size < size; block_size *= 2)
+    size_class++;
+  return size_class;
+}
+
+void SlabArrayBufferAllocator::LinkPartial(SizeClass* size_class, Slab* slab) {
+  slab->prev = nullptr;
+  slab->next = size_class->partial;
+  if (slab->next != nullptr) slab->next->prev = slab;
+  size_class->partial = slab;
+}
+
+void SlabArrayBufferAllocator::UnlinkPartial(SizeClass* size_class,
+                                             Slab* slab) {
+  if (slab->prev != nullptr) {
+    slab->prev->next = slab->next;
+  } else {
+    size_class->partial = slab->next;
+  }
+  if (slab->next != nullptr) slab->next->prev = slab->prev;
+  slab->prev = slab->next = nullptr;
+}
+
+void* SlabArrayBufferAllocator::AllocateBlock(size_t size) {
+  SizeClass* size_class = &size_classes_[SizeClassOf(size)];
+  size_t block_size = kMinBlockSize << SizeClassOf(size);
+  Mutex::ScopedLock lock(slab_mutex_);
+
+  Slab* slab = size_class->partial;
+  if (slab == nullptr) {
+    char* start =
+        static_cast<char*>(allocator_->AllocateUninitialized(kSlabSize));
+    if (start == nullptr) return nullptr;
+    auto new_slab = std::make_unique<Slab>();
+    new_slab->start = start;
+    new_slab->block_size = block_size;
+    slab = new_slab.get();
+    slabs_.emplace(reinterpret_cast<uintptr_t>(start), std::move(new_slab));
+    slab_count_.fetch_add(1, std::memory_order_relaxed);
+    LinkPartial(size_class, slab);
+  }
+
+  // Blocks that were never handed out are not on the free list, so that a
+  // new slab does not have to be walked in full.
+  void* block;
+  if (slab->free_list != nullptr) {
+    block = slab->free_list;
+    slab->free_list = *static_cast<void**>(block);
+  } else {
+    block = slab->start + slab->bumped * block_size;
+    slab->bumped++;
+  }
+  slab->used++;
+  if (slab->used == kSlabSize / block_size) UnlinkPartial(size_class, slab);
+  return block;
+}
+
+bool SlabArrayBufferAllocator::FreeBlock(void* data, size_t size) {
+  uintptr_t address = reinterpret_cast<uintptr_t>(data);
+  SizeClass* size_class = &size_classes_[SizeClassOf(size)];
+  Mutex::ScopedLock lock(slab_mutex_);
+
+  auto it = slabs_.upper_bound(address);
+  if (it == slabs_.begin()) return false;
+  --it;
+  Slab* slab = it->second.get();
+  if (address >= it->first + kSlabSize) return false;
+  CHECK_EQ(slab->block_size, kMinBlockSize << SizeClassOf(size));
+
+  bool was_full = slab->used == kSlabSize / slab->block_size;
+  *static_cast<void**>(data) = slab->free_list;
+  slab->free_list = data;
+  slab->used--;
+  if (was_full) LinkPartial(size_class, slab);
+
+  // Keep the slab if it is the only one that new blocks can come from, so
+  // that a single Buffer being created and freed in a loop does not map and
+  // unmap a slab every time.
+  if (slab->used == 0 &&
+      (size_class->partial != slab || slab->next != nullptr)) {
+    UnlinkPartial(size_class, slab);
+    allocator_->Free(slab->start, kSlabSize);
+    slabs_.erase(it);
+    slab_count_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+void* SlabArrayBufferAllocator::Allocate(size_t size) {
+  if (size == 0 || size > kMaxBlockSize)
+    return NodeArrayBufferAllocator::Allocate(size);
+  void* ret = AllocateBlock(size);
+  if (ret == nullptr) [[unlikely]]
+    return NodeArrayBufferAllocator::Allocate(size);
+  if (zero_fill_field_ || per_process::cli_options->zero_fill_all_buffers)
+    memset(ret, 0, size);
+  total_mem_usage_.fetch_add(size, std::memory_order_relaxed);
+  return ret;
+}
+
+void* SlabArrayBufferAllocator::AllocateUninitialized(size_t size) {
+  if (size == 0 || size > kMaxBlockSize)
+    return NodeArrayBufferAllocator::AllocateUninitialized(size);
+  void* ret = AllocateBlock(size);
+  if (ret == nullptr) [[unlikely]]
+    return NodeArrayBufferAllocator::AllocateUninitialized(size);
+  total_mem_usage_.fetch_add(size, std::memory_order_relaxed);
+  return ret;
+}
+
+void SlabArrayBufferAllocator::Free(void* data, size_t size) {
+  // Blocks that fell back to V8's allocator are not in any slab.
+  if (size == 0 || size > kMaxBlockSize || !FreeBlock(data, size))
+    return NodeArrayBufferAllocator::Free(data, size);
+  total_mem_usage_.fetch_sub(size, std::memory_order_relaxed);
+}
+
 std::unique_ptr<ArrayBufferAllocator> ArrayBufferAllocator::Create(bool debug) {
   if (debug || per_process::cli_options->debug_arraybuffer_allocations)
     return std::make_unique<DebuggingArrayBufferAllocator>();
+  else if (per_process::cli_options->arraybuffer_slab_allocator)
+    return std::make_unique<SlabArrayBufferAllocator>();
   else
     return std::make_unique<NodeArrayBufferAllocator>();
 }
@@ -211,6 +340,27 @@ void FreeArrayBufferAllocator(ArrayBufferAllocator* allocator) {
   delete allocator;
 }
 
+// The --heap-policy=container-aware sizing, for a process limited to
+// memory_limit bytes by its cgroup: a young generation of 1/32 of the limit,
+// between 8 and 64 MiB, so that scavenges stay short in small containers
+// without being needlessly frequent in large ones, and an old generation
+// that fills the rest of three quarters of the limit, leaving a quarter
+// for code, stacks and memory outside the V8 heap, such as Buffers.
+static void ConfigureContainerAwareHeap(v8::ResourceConstraints* constraints,
+                                        uint64_t memory_limit) {
+  constexpr uint64_t kMB = 1024 * 1024;
+  uint64_t young_size =
+      std::clamp(memory_limit / 32, uint64_t{8} * kMB, uint64_t{64} * kMB);
+  uint64_t old_size = memory_limit / 4 * 3;
+  old_size = old_size > young_size + 64 * kMB ? old_size - young_size
+                                              : 64 * kMB;
+#ifdef V8_COMPRESS_POINTERS
+  old_size = std::min(old_size, kMaxPointerCompressionHeap - young_size);
+#endif
+  constraints->set_max_young_generation_size_in_bytes(young_size);
+  constraints->set_max_old_generation_size_in_bytes(old_size);
+}
+
 void SetIsolateCreateParamsForNode(Isolate::CreateParams* params) {
   const uint64_t constrained_memory = uv_get_constrained_memory();
   const uint64_t total_memory = constrained_memory > 0 ?
@@ -222,6 +372,22 @@ void SetIsolateCreateParamsForNode(Isolate::CreateParams* params) {
     // This default is based on browser use-cases. Tell V8 to configure the
     // heap based on the actual physical memory.
     params->constraints.ConfigureDefaults(total_memory, 0);
+    // V8's flags, like --max-old-space-size, still take precedence over
+    // these limits.
+    bool is_constrained =
+        constrained_memory > 0 && constrained_memory != UINT64_MAX &&
+        constrained_memory < uv_get_total_memory();
+    if (is_constrained &&
+        per_process::cli_options->heap_policy == "container-aware") {
+      ConfigureContainerAwareHeap(&params->constraints, constrained_memory);
+    }
+  }
+
+  // Lite mode does not generate optimized code, so a much smaller code range
+  // than V8's default of 128 MB is enough for the low memory profile.
+  if (per_process::cli_options->memory_profile == "low" &&
+      params->constraints.code_range_size_in_bytes() == 0) {
+    params->constraints.set_code_range_size_in_bytes(32 * 1024 * 1024);
   }
 
 #ifdef NODE_ENABLE_VTUNE_PROFILING
@@ -1007,6 +1173,9 @@ ThreadId AllocateEnvironmentThreadId() {
 }
 
 void DefaultProcessExitHandlerInternal(Environment* env, ExitCode exit_code) {
+  if (env->is_main_thread() && env->options()->fast_exit) {
+    env->FastExit(exit_code);
+  }
   env->set_stopping(true);
   env->set_can_call_into_js(false);
   env->stop_sub_worker_contexts();
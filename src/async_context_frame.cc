@@ -10,11 +10,21 @@
 
 #include "v8.h"
 
+#include <bit>
+#include <initializer_list>
+
+using v8::Array;
 using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Integer;
 using v8::Isolate;
 using v8::Local;
+using v8::LocalVector;
+using v8::MaybeLocal;
 using v8::Object;
 using v8::String;
+using v8::Uint32;
+using v8::Undefined;
 using v8::Value;
 
 namespace node {
@@ -54,6 +64,329 @@ Local<Value> exchange(Isolate* isolate, Local<Value> value) {
   return prior;
 }
 
+//
+// Frames
+//
+// Frames are hash array mapped tries, in the compressed layout, of plain
+// arrays keyed by the identity hashes of the AsyncLocalStorage instances.
+// Each node holds a bitmap of the slots for the next 5 hash bits that hold an
+// entry, a bitmap of those that hold a child node, the keys and values of
+// its entries and then its children, both in slot order. Nodes past the end
+// of the hash hold the entries whose hashes collide in a plain list. A child
+// always holds at least two entries, so that there is only one shape of
+// trie for each set of entries.
+namespace {
+
+constexpr int kBitsPerLevel = 5;
+constexpr int kHashBits = 32;
+constexpr uint32_t kHeaderSize = 2;
+
+uint32_t Hash(Local<Value> key) {
+  return static_cast<uint32_t>(key.As<Object>()->GetIdentityHash());
+}
+
+uint32_t SlotBit(uint32_t hash, int shift) {
+  return uint32_t{1} << ((hash >> shift) & ((1 << kBitsPerLevel) - 1));
+}
+
+uint32_t SlotIndex(uint32_t map, uint32_t bit) {
+  return std::popcount(map & (bit - 1));
+}
+
+bool ReadNode(Local<Context> context,
+              Local<Array> node,
+              LocalVector<Value>* elements) {
+  const uint32_t length = node->Length();
+  elements->reserve(length + 2);
+  for (uint32_t i = 0; i < length; i++) {
+    Local<Value> element;
+    if (!node->Get(context, i).ToLocal(&element)) return false;
+    elements->push_back(element);
+  }
+  CHECK_GE(elements->size(), kHeaderSize);
+  return true;
+}
+
+uint32_t Bitmap(const LocalVector<Value>& elements, uint32_t index) {
+  return elements[index].As<Uint32>()->Value();
+}
+
+// Returns a copy of elements with count elements at index replaced by
+// insert.
+LocalVector<Value> Splice(Isolate* isolate,
+                          const LocalVector<Value>& elements,
+                          uint32_t index,
+                          uint32_t count,
+                          std::initializer_list<Local<Value>> insert) {
+  LocalVector<Value> result(isolate);
+  result.reserve(elements.size() - count + insert.size());
+  result.insert(result.end(), elements.begin(), elements.begin() + index);
+  result.insert(result.end(), insert);
+  result.insert(
+      result.end(), elements.begin() + index + count, elements.end());
+  return result;
+}
+
+Local<Array> NewNode(Isolate* isolate,
+                     uint32_t datamap,
+                     uint32_t nodemap,
+                     LocalVector<Value>* elements) {
+  (*elements)[0] = Integer::NewFromUnsigned(isolate, datamap);
+  (*elements)[1] = Integer::NewFromUnsigned(isolate, nodemap);
+  return Array::New(isolate, elements->data(), elements->size());
+}
+
+// Returns a node holding two entries whose hashes agree below shift.
+Local<Array> MergeEntries(Isolate* isolate,
+                          Local<Value> key1,
+                          Local<Value> value1,
+                          Local<Value> key2,
+                          Local<Value> value2,
+                          uint32_t hash1,
+                          uint32_t hash2,
+                          int shift) {
+  LocalVector<Value> elements(isolate, kHeaderSize);
+  if (shift >= kHashBits) {
+    elements.insert(elements.end(), {key1, value1, key2, value2});
+    return NewNode(isolate, 0, 0, &elements);
+  }
+  const uint32_t bit1 = SlotBit(hash1, shift);
+  const uint32_t bit2 = SlotBit(hash2, shift);
+  if (bit1 == bit2) {
+    elements.push_back(MergeEntries(isolate,
+                                    key1,
+                                    value1,
+                                    key2,
+                                    value2,
+                                    hash1,
+                                    hash2,
+                                    shift + kBitsPerLevel));
+    return NewNode(isolate, 0, bit1, &elements);
+  }
+  if (bit1 < bit2) {
+    elements.insert(elements.end(), {key1, value1, key2, value2});
+  } else {
+    elements.insert(elements.end(), {key2, value2, key1, value1});
+  }
+  return NewNode(isolate, bit1 | bit2, 0, &elements);
+}
+
+MaybeLocal<Value> SetStoreInNode(Local<Context> context,
+                                 Local<Value> node,
+                                 Local<Object> key,
+                                 Local<Value> value,
+                                 uint32_t hash,
+                                 int shift) {
+  Isolate* isolate = Isolate::GetCurrent();
+  LocalVector<Value> elements(isolate);
+  if (node->IsArray()) {
+    if (!ReadNode(context, node.As<Array>(), &elements)) return {};
+  } else {
+    elements.resize(kHeaderSize);
+    elements[0] = elements[1] = Integer::New(isolate, 0);
+  }
+
+  if (shift >= kHashBits) {
+    for (uint32_t i = kHeaderSize; i < elements.size(); i += 2) {
+      if (elements[i] == key) {
+        elements[i + 1] = value;
+        return NewNode(isolate, 0, 0, &elements);
+      }
+    }
+    elements.insert(elements.end(), {key, value});
+    return NewNode(isolate, 0, 0, &elements);
+  }
+
+  uint32_t datamap = Bitmap(elements, 0);
+  uint32_t nodemap = Bitmap(elements, 1);
+  const uint32_t bit = SlotBit(hash, shift);
+  const uint32_t entry = kHeaderSize + 2 * SlotIndex(datamap, bit);
+  if (datamap & bit) {
+    Local<Value> other_key = elements[entry];
+    if (other_key == key) {
+      elements[entry + 1] = value;
+      return NewNode(isolate, datamap, nodemap, &elements);
+    }
+    // Move both entries into a new child.
+    Local<Array> child = MergeEntries(isolate,
+                                      other_key,
+                                      elements[entry + 1],
+                                      key,
+                                      value,
+                                      Hash(other_key),
+                                      hash,
+                                      shift + kBitsPerLevel);
+    elements = Splice(isolate, elements, entry, 2, {});
+    datamap ^= bit;
+    const uint32_t index = kHeaderSize + 2 * std::popcount(datamap) +
+                           SlotIndex(nodemap, bit);
+    elements = Splice(isolate, elements, index, 0, {child});
+    nodemap |= bit;
+  } else if (nodemap & bit) {
+    const uint32_t index = kHeaderSize + 2 * std::popcount(datamap) +
+                           SlotIndex(nodemap, bit);
+    Local<Value> child;
+    if (!SetStoreInNode(
+             context, elements[index], key, value, hash, shift + kBitsPerLevel)
+             .ToLocal(&child)) {
+      return {};
+    }
+    elements[index] = child;
+  } else {
+    elements = Splice(isolate, elements, entry, 0, {key, value});
+    datamap |= bit;
+  }
+  return NewNode(isolate, datamap, nodemap, &elements);
+}
+
+// Returns node itself if key is not in it, and undefined if it ends up
+// empty.
+MaybeLocal<Value> DeleteStoreInNode(Local<Context> context,
+                                    Local<Value> node,
+                                    Local<Object> key,
+                                    uint32_t hash,
+                                    int shift) {
+  if (!node->IsArray()) return node;
+  Isolate* isolate = Isolate::GetCurrent();
+  LocalVector<Value> elements(isolate);
+  if (!ReadNode(context, node.As<Array>(), &elements)) return {};
+
+  if (shift >= kHashBits) {
+    for (uint32_t i = kHeaderSize; i < elements.size(); i += 2) {
+      if (elements[i] == key) {
+        if (elements.size() == kHeaderSize + 2) return Undefined(isolate);
+        elements = Splice(isolate, elements, i, 2, {});
+        return NewNode(isolate, 0, 0, &elements);
+      }
+    }
+    return node;
+  }
+
+  uint32_t datamap = Bitmap(elements, 0);
+  uint32_t nodemap = Bitmap(elements, 1);
+  const uint32_t bit = SlotBit(hash, shift);
+  const uint32_t entry = kHeaderSize + 2 * SlotIndex(datamap, bit);
+  if (datamap & bit) {
+    if (elements[entry] != key) return node;
+    elements = Splice(isolate, elements, entry, 2, {});
+    datamap ^= bit;
+  } else if (nodemap & bit) {
+    const uint32_t index = kHeaderSize + 2 * std::popcount(datamap) +
+                           SlotIndex(nodemap, bit);
+    Local<Value> old_child = elements[index];
+    Local<Value> child;
+    if (!DeleteStoreInNode(
+             context, old_child, key, hash, shift + kBitsPerLevel)
+             .ToLocal(&child)) {
+      return {};
+    }
+    if (child == old_child) return node;
+
+    // Children hold at least two entries, so this one is not empty now.
+    LocalVector<Value> child_elements(isolate);
+    CHECK(child->IsArray());
+    if (!ReadNode(context, child.As<Array>(), &child_elements)) return {};
+    if (child_elements.size() == kHeaderSize + 2 &&
+        Bitmap(child_elements, 1) == 0) {
+      // Move the last entry of the child up into this node.
+      elements = Splice(isolate, elements, index, 1, {});
+      nodemap ^= bit;
+      elements = Splice(isolate,
+                        elements,
+                        kHeaderSize + 2 * SlotIndex(datamap, bit),
+                        0,
+                        {child_elements[kHeaderSize],
+                         child_elements[kHeaderSize + 1]});
+      datamap |= bit;
+    } else {
+      elements[index] = child;
+    }
+  } else {
+    return node;
+  }
+  if (datamap == 0 && nodemap == 0) return Undefined(isolate);
+  return NewNode(isolate, datamap, nodemap, &elements);
+}
+
+}  // namespace
+
+MaybeLocal<Value> GetStore(Local<Context> context,
+                           Local<Value> frame,
+                           Local<Object> key) {
+  Isolate* isolate = Isolate::GetCurrent();
+  const uint32_t hash = Hash(key);
+  Local<Value> node = frame;
+  for (int shift = 0; node->IsArray(); shift += kBitsPerLevel) {
+    LocalVector<Value> elements(isolate);
+    if (!ReadNode(context, node.As<Array>(), &elements)) return {};
+    if (shift >= kHashBits) {
+      for (uint32_t i = kHeaderSize; i < elements.size(); i += 2) {
+        if (elements[i] == key) return elements[i + 1];
+      }
+      break;
+    }
+    const uint32_t datamap = Bitmap(elements, 0);
+    const uint32_t nodemap = Bitmap(elements, 1);
+    const uint32_t bit = SlotBit(hash, shift);
+    if (datamap & bit) {
+      const uint32_t entry = kHeaderSize + 2 * SlotIndex(datamap, bit);
+      if (elements[entry] == key) return elements[entry + 1];
+      break;
+    }
+    if (!(nodemap & bit)) break;
+    node = elements[kHeaderSize + 2 * std::popcount(datamap) +
+                    SlotIndex(nodemap, bit)];
+  }
+  return Undefined(isolate);
+}
+
+MaybeLocal<Value> SetStore(Local<Context> context,
+                           Local<Value> frame,
+                           Local<Object> key,
+                           Local<Value> value) {
+  return SetStoreInNode(context, frame, key, value, Hash(key), 0);
+}
+
+MaybeLocal<Value> DeleteStore(Local<Context> context,
+                              Local<Value> frame,
+                              Local<Object> key) {
+  return DeleteStoreInNode(context, frame, key, Hash(key), 0);
+}
+
+static void GetStore(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[1]->IsObject());
+  Local<Value> ret;
+  if (GetStore(args.GetIsolate()->GetCurrentContext(),
+               args[0],
+               args[1].As<Object>())
+          .ToLocal(&ret)) {
+    args.GetReturnValue().Set(ret);
+  }
+}
+
+static void SetStore(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[1]->IsObject());
+  Local<Value> ret;
+  if (SetStore(args.GetIsolate()->GetCurrentContext(),
+               args[0],
+               args[1].As<Object>(),
+               args[2])
+          .ToLocal(&ret)) {
+    args.GetReturnValue().Set(ret);
+  }
+}
+
+static void DeleteStore(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[1]->IsObject());
+  Local<Value> ret;
+  if (DeleteStore(args.GetIsolate()->GetCurrentContext(),
+                  args[0],
+                  args[1].As<Object>())
+          .ToLocal(&ret)) {
+    args.GetReturnValue().Set(ret);
+  }
+}
+
 void CreatePerContextProperties(Local<Object> target,
                                 Local<Value> unused,
                                 Local<Context> context,
@@ -80,6 +413,16 @@ void CreatePerContextProperties(Local<Object> target,
             binding->Get(context, setContinuationPreservedEmbedderData)
                 .ToLocalChecked())
       .Check();
+
+  SetMethodNoSideEffect(context, target, "getStore", GetStore);
+  SetMethodNoSideEffect(context, target, "setStore", SetStore);
+  SetMethodNoSideEffect(context, target, "deleteStore", DeleteStore);
+}
+
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(GetStore);
+  registry->Register(SetStore);
+  registry->Register(DeleteStore);
 }
 
 }  // namespace async_context_frame
@@ -87,3 +430,5 @@ void CreatePerContextProperties(Local<Object> target,
 
 NODE_BINDING_CONTEXT_AWARE_INTERNAL(
     async_context_frame, node::async_context_frame::CreatePerContextProperties)
+NODE_BINDING_EXTERNAL_REFERENCE(
+    async_context_frame, node::async_context_frame::RegisterExternalReferences)
@@ -25,6 +25,22 @@ v8::Local<v8::Value> current(v8::Isolate* isolate);
 void set(v8::Isolate* isolate, v8::Local<v8::Value> value);
 v8::Local<v8::Value> exchange(v8::Isolate* isolate, v8::Local<v8::Value> value);
 
+// A frame maps AsyncLocalStorage instances to their stores. Frames are
+// immutable, with undefined as the empty frame: setting or deleting a store
+// returns a new frame that shares all but the path to that store with the
+// old one, so it takes time logarithmic in the number of stores instead of
+// copying all of them.
+v8::MaybeLocal<v8::Value> GetStore(v8::Local<v8::Context> context,
+                                   v8::Local<v8::Value> frame,
+                                   v8::Local<v8::Object> key);
+v8::MaybeLocal<v8::Value> SetStore(v8::Local<v8::Context> context,
+                                   v8::Local<v8::Value> frame,
+                                   v8::Local<v8::Object> key,
+                                   v8::Local<v8::Value> value);
+v8::MaybeLocal<v8::Value> DeleteStore(v8::Local<v8::Context> context,
+                                      v8::Local<v8::Value> frame,
+                                      v8::Local<v8::Object> key);
+
 }  // namespace async_context_frame
 }  // namespace node
 
@@ -22,14 +22,19 @@
 #include "async_wrap.h"  // NOLINT(build/include_inline)
 #include "async_context_frame.h"
 #include "async_wrap-inl.h"
+#include "debug_utils.h"
 #include "env-inl.h"
+#include "histogram.h"
+#include "node_allocation_counter.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
+#include "node_usdt.h"
 #include "tracing/traced_value.h"
 #include "util-inl.h"
 
 #include "v8.h"
 
+using v8::Array;
 using v8::Context;
 using v8::DontDelete;
 using v8::EscapableHandleScope;
@@ -41,6 +46,7 @@ using v8::HandleScope;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
+using v8::LocalVector;
 using v8::MaybeLocal;
 using v8::Nothing;
 using v8::Number;
@@ -49,6 +55,7 @@ using v8::ObjectTemplate;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::String;
+using v8::Uint32;
 using v8::Undefined;
 using v8::Value;
 using v8::WeakCallbackInfo;
@@ -212,6 +219,112 @@ static void GetPromiseHooks(const FunctionCallbackInfo<Value>& args) {
       env->async_hooks()->GetPromiseHooks(args.GetIsolate()));
 }
 
+// Enables the per provider accounting of callbacks, starting from zero, if
+// args[0] is true, and disables it otherwise. In builds with allocation
+// counting, args[1] being true also records where the callbacks allocate.
+static void SetCallbackAccounting(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsBoolean());
+  std::vector<Environment::AsyncCallbackTotals>& totals =
+      env->async_callback_totals();
+  totals.clear();
+  if (args[0]->IsTrue()) totals.resize(AsyncWrap::PROVIDERS_LENGTH);
+  allocation_counter::SetSitesEnabled(args[0]->IsTrue() && args[1]->IsTrue());
+}
+
+// Returns an object with a { count, cpuTime } entry for every provider type
+// that had callbacks, or undefined if accounting is disabled. In builds with
+// allocation counting, the entries also have the number of allocations.
+static void GetCallbackAccounting(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  const std::vector<Environment::AsyncCallbackTotals>& totals =
+      env->async_callback_totals();
+  if (totals.empty()) return;
+
+  Local<Object> result = Object::New(isolate);
+  for (size_t i = 0; i < totals.size(); i++) {
+    if (totals[i].count == 0) continue;
+    Local<Object> entry = Object::New(isolate);
+    if (entry
+            ->Set(context,
+                  FIXED_ONE_BYTE_STRING(isolate, "count"),
+                  Number::New(isolate, static_cast<double>(totals[i].count)))
+            .IsNothing() ||
+        entry
+            ->Set(context,
+                  FIXED_ONE_BYTE_STRING(isolate, "cpuTime"),
+                  Number::New(isolate,
+                              static_cast<double>(totals[i].cpu_time)))
+            .IsNothing() ||
+        (allocation_counter::kAvailable &&
+         entry
+             ->Set(context,
+                   FIXED_ONE_BYTE_STRING(isolate, "allocations"),
+                   Number::New(isolate,
+                               static_cast<double>(totals[i].allocations)))
+             .IsNothing()) ||
+        result->Set(context, OneByteString(isolate, provider_names[i]), entry)
+            .IsNothing()) {
+      return;
+    }
+  }
+  args.GetReturnValue().Set(result);
+}
+
+// Returns the args[0] sites with the most allocations in callbacks since
+// setCallbackAccounting(true, true), as { count, stack } objects where stack
+// is an array of symbolized frames, innermost first. Returns undefined in
+// builds without allocation counting.
+static void GetAllocationSites(const FunctionCallbackInfo<Value>& args) {
+  if (!allocation_counter::kAvailable) return;
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  CHECK(args[0]->IsUint32());
+  const std::vector<allocation_counter::Site> sites =
+      allocation_counter::TopSites(args[0].As<Uint32>()->Value());
+
+  auto symbols = NativeSymbolDebuggingContext::New();
+  LocalVector<Value> entries(isolate);
+  for (const allocation_counter::Site& site : sites) {
+    LocalVector<Value> frames(isolate);
+    for (void* frame : site.frames) {
+      Local<Value> name;
+      if (!ToV8Value(context, symbols->LookupSymbol(frame).Display(), isolate)
+               .ToLocal(&name)) {
+        return;
+      }
+      frames.push_back(name);
+    }
+    Local<Object> entry = Object::New(isolate);
+    if (entry
+            ->Set(context,
+                  FIXED_ONE_BYTE_STRING(isolate, "count"),
+                  Number::New(isolate, static_cast<double>(site.count)))
+            .IsNothing() ||
+        entry
+            ->Set(context,
+                  FIXED_ONE_BYTE_STRING(isolate, "stack"),
+                  Array::New(isolate, frames.data(), frames.size()))
+            .IsNothing()) {
+      return;
+    }
+    entries.push_back(entry);
+  }
+  args.GetReturnValue().Set(
+      Array::New(isolate, entries.data(), entries.size()));
+}
+
+// The CPU time, in nanoseconds, that the calling thread has used.
+static uint64_t ThreadCpuTime() {
+  uv_rusage_t usage;
+  if (uv_getrusage_thread(&usage) != 0) return 0;
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
 class DestroyParam {
  public:
   double asyncId;
@@ -385,6 +498,9 @@ void AsyncWrap::CreatePerIsolateProperties(IsolateData* isolate_data,
   SetMethod(isolate, target, "setPromiseHooks", SetPromiseHooks);
   SetMethod(isolate, target, "getPromiseHooks", GetPromiseHooks);
   SetMethod(isolate, target, "registerDestroyHook", RegisterDestroyHook);
+  SetMethod(isolate, target, "setCallbackAccounting", SetCallbackAccounting);
+  SetMethod(isolate, target, "getCallbackAccounting", GetCallbackAccounting);
+  SetMethod(isolate, target, "getAllocationSites", GetAllocationSites);
   AsyncWrap::GetConstructorTemplate(isolate_data);
 }
 
@@ -491,6 +607,9 @@ void AsyncWrap::RegisterExternalReferences(
   registry->Register(SetPromiseHooks);
   registry->Register(GetPromiseHooks);
   registry->Register(RegisterDestroyHook);
+  registry->Register(SetCallbackAccounting);
+  registry->Register(GetCallbackAccounting);
+  registry->Register(GetAllocationSites);
   registry->Register(AsyncWrap::GetAsyncId);
   registry->Register(AsyncWrap::AsyncReset);
   registry->Register(AsyncWrap::GetProviderType);
@@ -658,6 +777,20 @@ MaybeLocal<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
 
   ProviderType provider = provider_type();
   async_context context { get_async_id(), get_trigger_async_id() };
+  NODE_USDT2(callback__start,
+             static_cast<int>(provider),
+             static_cast<int64_t>(context.async_id));
+  // Only callbacks entered from the event loop are timed, nested ones are
+  // part of the time of their caller.
+  const bool from_loop = env()->async_callback_scope_depth() == 0;
+  uint64_t monitor_start = 0;
+  if (env()->loop_phase_monitor() != nullptr && from_loop) {
+    monitor_start = uv_hrtime();
+  }
+  const bool accounting = from_loop && !env()->async_callback_totals().empty();
+  const uint64_t cpu_start = accounting ? ThreadCpuTime() : 0;
+  const uint64_t allocations_start =
+      accounting ? allocation_counter::Begin() : 0;
   MaybeLocal<Value> ret =
       InternalMakeCallback(env(),
                            object(),
@@ -671,6 +804,28 @@ MaybeLocal<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
   // This is a static call with cached values because the `this` object may
   // no longer be alive at this point.
   EmitTraceEventAfter(provider, context.async_id);
+  NODE_USDT2(callback__done,
+             static_cast<int>(provider),
+             static_cast<int64_t>(context.async_id));
+
+  if (monitor_start != 0) {
+    // The callback may have stopped or replaced the monitor.
+    if (LoopPhaseMonitor* monitor = env()->loop_phase_monitor())
+      monitor->RecordCallback(provider, uv_hrtime() - monitor_start);
+  }
+
+  if (accounting) {
+    const uint64_t allocations = allocation_counter::End() - allocations_start;
+    // The callback may have disabled accounting.
+    std::vector<Environment::AsyncCallbackTotals>& totals =
+        env()->async_callback_totals();
+    if (!totals.empty()) {
+      const uint64_t cpu_end = ThreadCpuTime();
+      totals[provider].count++;
+      if (cpu_end > cpu_start) totals[provider].cpu_time += cpu_end - cpu_start;
+      totals[provider].allocations += allocations;
+    }
+  }
 
   return ret;
 }
@@ -27,9 +27,11 @@
 #include "memory_tracker-inl.h"
 #include "nbytes.h"
 #include "node.h"
+#include "node_dns_cache.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
 #include "req_wrap-inl.h"
+#include "threadpoolwork-inl.h"
 #include "util-inl.h"
 #include "uv.h"
 #include "v8.h"
@@ -37,6 +39,8 @@
 #include <cerrno>
 #include <cstring>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <unordered_set>
 
@@ -1781,46 +1785,63 @@ static void Query(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(err);
 }
 
-void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
-  auto cleanup = OnScopeLeave([&]() { uv_freeaddrinfo(res); });
-  BaseObjectPtr<GetAddrInfoReqWrap> req_wrap{
-      static_cast<GetAddrInfoReqWrap*>(req->data)};
+DnsCache::Result ToLookupResult(int status, const struct addrinfo* res) {
+  DnsCache::Result result;
+  result.status = status;
+  if (status != 0) return result;
+
+  for (auto p = res; p != nullptr; p = p->ai_next) {
+    CHECK_EQ(p->ai_socktype, SOCK_STREAM);
+
+    const char* addr;
+    if (p->ai_family == AF_INET) {
+      addr = reinterpret_cast<char*>(
+          &(reinterpret_cast<struct sockaddr_in*>(p->ai_addr)->sin_addr));
+    } else if (p->ai_family == AF_INET6) {
+      addr = reinterpret_cast<char*>(
+          &(reinterpret_cast<struct sockaddr_in6*>(p->ai_addr)->sin6_addr));
+    } else {
+      continue;
+    }
+
+    char ip[INET6_ADDRSTRLEN];
+    if (uv_inet_ntop(p->ai_family, addr, ip, sizeof(ip)))
+      continue;
+    result.addresses.push_back({p->ai_family, ip});
+  }
+
+  // No responses were found to return
+  if (result.addresses.empty()) result.status = UV_EAI_NODATA;
+  return result;
+}
+
+// Passes result to the oncomplete callback of req_wrap, a GetAddrInfoReqWrap
+// or a ChannelLookupWrap, with the addresses sorted by family as order says.
+void CompleteGetAddrInfo(AsyncWrap* req_wrap,
+                         uint8_t order,
+                         const DnsCache::Result& result) {
   Environment* env = req_wrap->env();
 
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
 
   Local<Value> argv[] = {
-    Integer::New(env->isolate(), status),
+    Integer::New(env->isolate(), result.status),
     Null(env->isolate())
   };
 
   uint32_t n = 0;
-  const uint8_t order = req_wrap->order();
 
-  if (status == 0) {
+  if (result.status == 0) {
     Local<Array> results = Array::New(env->isolate());
 
     auto add = [&](bool want_ipv4, bool want_ipv6) -> Maybe<void> {
-      for (auto p = res; p != nullptr; p = p->ai_next) {
-        CHECK_EQ(p->ai_socktype, SOCK_STREAM);
-
-        const char* addr;
-        if (want_ipv4 && p->ai_family == AF_INET) {
-          addr = reinterpret_cast<char*>(
-              &(reinterpret_cast<struct sockaddr_in*>(p->ai_addr)->sin_addr));
-        } else if (want_ipv6 && p->ai_family == AF_INET6) {
-          addr = reinterpret_cast<char*>(
-              &(reinterpret_cast<struct sockaddr_in6*>(p->ai_addr)->sin6_addr));
-        } else {
+      for (const DnsCache::Address& address : result.addresses) {
+        if (!(want_ipv4 && address.family == AF_INET) &&
+            !(want_ipv6 && address.family == AF_INET6)) {
           continue;
         }
-
-        char ip[INET6_ADDRSTRLEN];
-        if (uv_inet_ntop(p->ai_family, addr, ip, sizeof(ip)))
-          continue;
-
-        Local<String> s = OneByteString(env->isolate(), ip);
+        Local<String> s = OneByteString(env->isolate(), address.ip);
         if (results->Set(env->context(), n, s).IsNothing())
           return Nothing<void>();
         n++;
@@ -1845,17 +1866,12 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
         break;
     }
 
-    // No responses were found to return
-    if (n == 0) {
-      argv[0] = Integer::New(env->isolate(), UV_EAI_NODATA);
-    }
-
     argv[1] = results;
   }
 
   TRACE_EVENT_NESTABLE_ASYNC_END2(TRACING_CATEGORY_NODE2(dns, native),
                                   "lookup",
-                                  req_wrap.get(),
+                                  req_wrap,
                                   "count",
                                   n,
                                   "order",
@@ -1865,6 +1881,78 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
   req_wrap->MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
 }
 
+uint64_t NowMs() {
+  return uv_hrtime() / 1000000;
+}
+
+// The lookups on this thread that others with the same DnsCache key wait on.
+thread_local std::unordered_map<std::string, GetAddrInfoReqWrap*>
+    lookups_in_flight;
+
+// Refreshes a stale DnsCache entry on the thread pool, without a request
+// object for JavaScript to wait on.
+class DnsCacheRefresh final : public ThreadPoolWork {
+ public:
+  DnsCacheRefresh(Environment* env,
+                  std::string key,
+                  std::string hostname,
+                  const struct addrinfo& hints)
+      : ThreadPoolWork(env, "dnscacherefresh", Lane::kSlowIo),
+        key_(std::move(key)),
+        hostname_(std::move(hostname)),
+        hints_(hints) {}
+
+  void DoThreadPoolWork() override {
+    struct addrinfo* res = nullptr;
+    int err = getaddrinfo(hostname_.c_str(), nullptr, &hints_, &res);
+    int status = 0;
+    if (err == EAI_NONAME) {
+      status = UV_EAI_NONAME;
+#ifdef EAI_NODATA
+    } else if (err == EAI_NODATA) {
+      status = UV_EAI_NODATA;
+#endif
+    } else if (err != 0) {
+      // Transient; the stale entry is kept.
+      status = UV_EAI_AGAIN;
+    }
+    result_ = ToLookupResult(status, res);
+    if (res != nullptr) freeaddrinfo(res);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<DnsCacheRefresh> self(this);
+    if (status != 0) result_.status = UV_EAI_AGAIN;
+    DnsCache::Get()->Store(key_, result_, NowMs());
+  }
+
+ private:
+  const std::string key_;
+  const std::string hostname_;
+  const struct addrinfo hints_;
+  DnsCache::Result result_;
+};
+
+void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
+  auto cleanup = OnScopeLeave([&]() { uv_freeaddrinfo(res); });
+  BaseObjectPtr<GetAddrInfoReqWrap> req_wrap{
+      static_cast<GetAddrInfoReqWrap*>(req->data)};
+
+  const DnsCache::Result result = ToLookupResult(status, res);
+  std::vector<BaseObjectPtr<GetAddrInfoReqWrap>> waiters;
+  const std::string& key = req_wrap->cache_key();
+  if (!key.empty()) {
+    DnsCache::Get()->Store(key, result, NowMs());
+    auto it = lookups_in_flight.find(key);
+    if (it != lookups_in_flight.end() && it->second == req_wrap.get())
+      lookups_in_flight.erase(it);
+    waiters = req_wrap->TakeWaiters();
+  }
+
+  CompleteGetAddrInfo(req_wrap.get(), req_wrap->order(), result);
+  for (const auto& waiter : waiters)
+    CompleteGetAddrInfo(waiter.get(), waiter->order(), result);
+}
 
 void AfterGetNameInfo(uv_getnameinfo_t* req,
                       int status,
@@ -1934,6 +2022,19 @@ void ConvertIpv6StringToBuffer(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+int ToAddressFamily(int32_t family) {
+  switch (family) {
+    case 0:
+      return AF_UNSPEC;
+    case 4:
+      return AF_INET;
+    case 6:
+      return AF_INET6;
+    default:
+      UNREACHABLE("bad address family");
+  }
+}
+
 void GetAddrInfo(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -1954,21 +2055,7 @@ void GetAddrInfo(const FunctionCallbackInfo<Value>& args) {
     flags = args[3].As<Int32>()->Value();
   }
 
-  int family;
-
-  switch (args[2].As<Int32>()->Value()) {
-    case 0:
-      family = AF_UNSPEC;
-      break;
-    case 4:
-      family = AF_INET;
-      break;
-    case 6:
-      family = AF_INET6;
-      break;
-    default:
-      UNREACHABLE("bad address family");
-  }
+  int family = ToAddressFamily(args[2].As<Int32>()->Value());
 
   Local<Uint32> order = args[4].As<Uint32>();
 
@@ -1991,16 +2078,209 @@ void GetAddrInfo(const FunctionCallbackInfo<Value>& args) {
                                     : family == AF_INET6 ? "ipv6"
                                                          : "unspec");
 
+  DnsCache* cache = DnsCache::Get();
+  if (cache != nullptr) {
+    std::string key = DnsCache::Key(ascii_hostname, family, flags);
+    DnsCache::Result result;
+    DnsCache::Lookup lookup = cache->Find(key, &result, NowMs());
+    if (lookup != DnsCache::Lookup::kMiss) {
+      if (lookup == DnsCache::Lookup::kRefresh) {
+        (new DnsCacheRefresh(env, key, ascii_hostname, hints))->ScheduleWork();
+      }
+      // The callback must not run before this function returns.
+      env->SetImmediate([req_wrap = BaseObjectPtr<GetAddrInfoReqWrap>(
+                             req_wrap.release()),
+                         result = std::move(result)](Environment* env) {
+        CompleteGetAddrInfo(req_wrap.get(), req_wrap->order(), result);
+      });
+      args.GetReturnValue().Set(0);
+      return;
+    }
+
+    auto it = lookups_in_flight.find(key);
+    if (it != lookups_in_flight.end() && it->second->env() == env) {
+      it->second->AddWaiter(BaseObjectPtr<GetAddrInfoReqWrap>(
+          req_wrap.release()));
+      args.GetReturnValue().Set(0);
+      return;
+    }
+    if (it == lookups_in_flight.end())
+      lookups_in_flight.emplace(key, req_wrap.get());
+    req_wrap->set_cache_key(std::move(key));
+  }
+
   int err = req_wrap->Dispatch(
       uv_getaddrinfo, AfterGetAddrInfo, ascii_hostname.data(), nullptr, &hints);
-  if (err == 0)
+  if (err == 0) {
     // Release ownership of the pointer allowing the ownership to be transferred
     USE(req_wrap.release());
+  } else if (!req_wrap->cache_key().empty()) {
+    auto it = lookups_in_flight.find(req_wrap->cache_key());
+    if (it != lookups_in_flight.end() && it->second == req_wrap.get())
+      lookups_in_flight.erase(it);
+  }
 
   args.GetReturnValue().Set(err);
 }
 
 
+// Maps c-ares status codes to the getaddrinfo() ones that dns.lookup()
+// reports, so that both kinds of lookup fail the same way.
+int ToGetAddrInfoError(int status) {
+  switch (status) {
+    case ARES_SUCCESS:
+      return 0;
+    case ARES_ENOTFOUND:
+    case ARES_ENONAME:
+    case ARES_EBADNAME:
+      return UV_EAI_NONAME;
+    case ARES_ENODATA:
+      return UV_EAI_NODATA;
+    case ARES_EBADFAMILY:
+      return UV_EAI_FAMILY;
+    case ARES_EBADFLAGS:
+      return UV_EAI_BADFLAGS;
+    case ARES_ENOMEM:
+      return UV_EAI_MEMORY;
+    case ARES_ECANCELLED:
+    case ARES_EDESTRUCTION:
+      return UV_EAI_CANCELED;
+    case ARES_ETIMEOUT:
+    case ARES_ECONNREFUSED:
+    case ARES_ESERVFAIL:
+    case ARES_EREFUSED:
+      return UV_EAI_AGAIN;
+    default:
+      return UV_EAI_FAIL;
+  }
+}
+
+}  // namespace
+
+ChannelLookupWrap::ChannelLookupWrap(ChannelWrap* channel,
+                                     Local<Object> req_wrap_obj,
+                                     uint8_t order)
+    : AsyncWrap(channel->env(),
+                req_wrap_obj,
+                AsyncWrap::PROVIDER_GETADDRINFOREQWRAP),
+      channel_(channel),
+      order_(order) {}
+
+ChannelLookupWrap::~ChannelLookupWrap() {
+  if (callback_ptr_ != nullptr) *callback_ptr_ = nullptr;
+}
+
+void ChannelLookupWrap::Lookup(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  ChannelWrap* channel;
+  ASSIGN_OR_RETURN_UNWRAP(&channel, args.This());
+
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsString());
+  CHECK(args[2]->IsInt32());
+  CHECK(args[4]->IsUint32());
+  Local<Object> req_wrap_obj = args[0].As<Object>();
+  node::Utf8Value hostname(env->isolate(), args[1]);
+
+  ERR_ACCESS_DENIED_IF_INSUFFICIENT_PERMISSIONS(
+      env, permission::PermissionScope::kNet, hostname.ToStringView(), args);
+
+  std::string ascii_hostname = ada::idna::to_ascii(hostname.ToStringView());
+
+  int32_t flags = 0;
+  if (args[3]->IsInt32()) {
+    flags = args[3].As<Int32>()->Value();
+  }
+
+  struct ares_addrinfo_hints hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = ToAddressFamily(args[2].As<Int32>()->Value());
+  hints.ai_socktype = SOCK_STREAM;
+  if (flags & AI_ADDRCONFIG) hints.ai_flags |= ARES_AI_ADDRCONFIG;
+  if (flags & AI_V4MAPPED) hints.ai_flags |= ARES_AI_V4MAPPED;
+  if (flags & AI_ALL) hints.ai_flags |= ARES_AI_ALL;
+
+  auto wrap = std::make_unique<ChannelLookupWrap>(
+      channel, req_wrap_obj, args[4].As<Uint32>()->Value());
+
+  TRACE_EVENT_NESTABLE_ASYNC_BEGIN2(TRACING_CATEGORY_NODE2(dns, native),
+                                    "lookup",
+                                    wrap.get(),
+                                    "hostname",
+                                    TRACE_STR_COPY(ascii_hostname.data()),
+                                    "family",
+                                    hints.ai_family == AF_INET    ? "ipv4"
+                                    : hints.ai_family == AF_INET6 ? "ipv6"
+                                                                  : "unspec");
+
+  channel->EnsureServers();
+  channel->ModifyActivityQueryCount(1);
+  CHECK_NULL(wrap->callback_ptr_);
+  wrap->callback_ptr_ = new ChannelLookupWrap*(wrap.get());
+  // The callback may run synchronously, it defers the JavaScript callback.
+  ares_getaddrinfo(channel->cares_channel(),
+                   ascii_hostname.c_str(),
+                   nullptr,
+                   &hints,
+                   Callback,
+                   wrap->callback_ptr_);
+  // Release ownership of the pointer, Callback() takes it.
+  USE(wrap.release());
+
+  args.GetReturnValue().Set(0);
+}
+
+void ChannelLookupWrap::Callback(void* arg,
+                                 int status,
+                                 int timeouts,
+                                 struct ares_addrinfo* res) {
+  auto cleanup = OnScopeLeave([&]() {
+    if (res != nullptr) ares_freeaddrinfo(res);
+  });
+  std::unique_ptr<ChannelLookupWrap*> wrap_ptr{
+      static_cast<ChannelLookupWrap**>(arg)};
+  ChannelLookupWrap* wrap = *wrap_ptr;
+  if (wrap == nullptr) return;
+  wrap->callback_ptr_ = nullptr;
+
+  DnsCache::Result result;
+  result.status = ToGetAddrInfoError(status);
+  if (status == ARES_SUCCESS) {
+    for (auto p = res->nodes; p != nullptr; p = p->ai_next) {
+      const char* addr;
+      if (p->ai_family == AF_INET) {
+        addr = reinterpret_cast<char*>(
+            &(reinterpret_cast<struct sockaddr_in*>(p->ai_addr)->sin_addr));
+      } else if (p->ai_family == AF_INET6) {
+        addr = reinterpret_cast<char*>(
+            &(reinterpret_cast<struct sockaddr_in6*>(p->ai_addr)->sin6_addr));
+      } else {
+        continue;
+      }
+
+      char ip[INET6_ADDRSTRLEN];
+      if (uv_inet_ntop(p->ai_family, addr, ip, sizeof(ip)))
+        continue;
+      result.addresses.push_back({p->ai_family, ip});
+    }
+    if (result.addresses.empty()) result.status = UV_EAI_NODATA;
+  }
+
+  BaseObjectPtr<ChannelLookupWrap> strong_ref{wrap};
+  wrap->env()->SetImmediate(
+      [wrap, strong_ref, result = std::move(result)](Environment*) {
+        CompleteGetAddrInfo(wrap, wrap->order_, result);
+
+        // Delete once strong_ref goes out of scope.
+        wrap->Detach();
+      });
+
+  wrap->channel_->set_query_last_ok(status != ARES_ECONNREFUSED);
+  wrap->channel_->ModifyActivityQueryCount(-1);
+}
+
+namespace {
+
 void GetNameInfo(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -2332,6 +2612,8 @@ void Initialize(Local<Object> target,
   SetProtoMethod(isolate, channel_wrap, "setServers", SetServers);
   SetProtoMethod(isolate, channel_wrap, "setLocalAddress", SetLocalAddress);
   SetProtoMethod(isolate, channel_wrap, "cancel", Cancel);
+  SetProtoMethod(
+      isolate, channel_wrap, "getaddrinfo", ChannelLookupWrap::Lookup);
 
   SetConstructorFunction(context, target, "ChannelWrap", channel_wrap);
 }
@@ -2352,6 +2634,7 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(SetServers);
   registry->Register(SetLocalAddress);
   registry->Register(Cancel);
+  registry->Register(ChannelLookupWrap::Lookup);
 }
 
 }  // namespace cares_wrap
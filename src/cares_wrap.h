@@ -10,6 +10,7 @@
 #include "env.h"
 #include "memory_tracker.h"
 #include "node.h"
+#include "node_dns_cache.h"
 #include "node_internals.h"
 #include "permission/permission.h"
 #include "util.h"
@@ -18,7 +19,9 @@
 #include "v8.h"
 #include "uv.h"
 
+#include <string>
 #include <unordered_set>
+#include <vector>
 
 #ifdef __POSIX__
 # include <netdb.h>
@@ -205,11 +208,64 @@ class GetAddrInfoReqWrap final : public ReqWrap<uv_getaddrinfo_t> {
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(GetAddrInfoReqWrap)
   SET_SELF_SIZE(GetAddrInfoReqWrap)
+  NODE_POOLED_ALLOCATION(GetAddrInfoReqWrap)
 
   uint8_t order() const { return order_; }
 
+  // Set on the lookup whose result is stored in the DnsCache under this key,
+  // empty if the cache is disabled or this lookup waits on another.
+  const std::string& cache_key() const { return cache_key_; }
+  void set_cache_key(std::string key) { cache_key_ = std::move(key); }
+
+  // Lookups of the same key on this thread that complete with this one.
+  void AddWaiter(BaseObjectPtr<GetAddrInfoReqWrap> waiter) {
+    waiters_.push_back(std::move(waiter));
+  }
+  std::vector<BaseObjectPtr<GetAddrInfoReqWrap>> TakeWaiters() {
+    return std::move(waiters_);
+  }
+
  private:
   const uint8_t order_;
+  std::string cache_key_;
+  std::vector<BaseObjectPtr<GetAddrInfoReqWrap>> waiters_;
+};
+
+// A dns.lookup() through a channel's c-ares resolver, with
+// ares_getaddrinfo(). Like getaddrinfo(), that answers from the hosts file
+// (which c-ares re-reads when it changes) or the servers, in the order that
+// nsswitch.conf or resolv.conf configures, and queries A and AAAA in
+// parallel. It takes no thread pool slot. Completes like a
+// GetAddrInfoReqWrap, with getaddrinfo() error codes.
+class ChannelLookupWrap final : public AsyncWrap {
+ public:
+  ChannelLookupWrap(ChannelWrap* channel,
+                    v8::Local<v8::Object> req_wrap_obj,
+                    uint8_t order);
+  ~ChannelLookupWrap() override;
+
+  // channel.getaddrinfo(req, hostname, family, hints, order), with the
+  // arguments of the getaddrinfo() binding.
+  static void Lookup(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("channel", channel_);
+  }
+
+  SET_MEMORY_INFO_NAME(ChannelLookupWrap)
+  SET_SELF_SIZE(ChannelLookupWrap)
+
+ private:
+  static void Callback(void* arg,
+                       int status,
+                       int timeouts,
+                       struct ares_addrinfo* res);
+
+  BaseObjectPtr<ChannelWrap> channel_;
+  const uint8_t order_;
+  // Reset by the destructor, so that Callback() knows 'this' no longer
+  // exists; see QueryWrap.
+  ChannelLookupWrap** callback_ptr_ = nullptr;
 };
 
 class GetNameInfoReqWrap final : public ReqWrap<uv_getnameinfo_t> {
@@ -17,9 +17,9 @@ bool CleanupQueue::empty() const {
   return cleanup_hooks_.empty();
 }
 
-void CleanupQueue::Add(Callback cb, void* arg) {
+void CleanupQueue::Add(Callback cb, void* arg, bool essential) {
   auto insertion_info =
-      cleanup_hooks_.emplace(cb, arg, cleanup_hook_counter_++);
+      cleanup_hooks_.emplace(cb, arg, cleanup_hook_counter_++, essential);
   // Make sure there was no existing element with these values.
   CHECK_EQ(insertion_info.second, true);
 }
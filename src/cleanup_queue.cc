@@ -39,6 +39,17 @@ void CleanupQueue::Drain() {
   }
 }
 
+void CleanupQueue::DrainEssential() {
+  std::vector<CleanupHookCallback> callbacks = GetOrdered();
+
+  for (const CleanupHookCallback& cb : callbacks) {
+    if (!cb.essential_ || cleanup_hooks_.count(cb) == 0) continue;
+
+    cb.fn_(cb.arg_);
+    cleanup_hooks_.erase(cb);
+  }
+}
+
 size_t CleanupQueue::CleanupHookCallback::Hash::operator()(
     const CleanupHookCallback& cb) const {
   return std::hash<void*>()(cb.arg_);
@@ -27,19 +27,25 @@ class CleanupQueue : public MemoryRetainer {
 
   inline bool empty() const;
 
-  inline void Add(Callback cb, void* arg);
+  // Essential hooks are the ones that also run when the process takes the
+  // --fast-exit path, which skips all the others.
+  inline void Add(Callback cb, void* arg, bool essential = false);
   inline void Remove(Callback cb, void* arg);
   void Drain();
+  // Runs and removes only the essential hooks, in the same order as Drain().
+  void DrainEssential();
 
  private:
   class CleanupHookCallback {
    public:
     CleanupHookCallback(Callback fn,
                         void* arg,
-                        uint64_t insertion_order_counter)
+                        uint64_t insertion_order_counter,
+                        bool essential = false)
         : fn_(fn),
           arg_(arg),
-          insertion_order_counter_(insertion_order_counter) {}
+          insertion_order_counter_(insertion_order_counter),
+          essential_(essential) {}
 
     // Only hashes `arg_`, since that is usually enough to identify the hook.
     struct Hash {
@@ -60,6 +66,7 @@ class CleanupQueue : public MemoryRetainer {
     // We keep track of the insertion order for these objects, so that we can
     // call the callbacks in reverse order when we are cleaning up.
     uint64_t insertion_order_counter_;
+    bool essential_;
   };
 
   std::vector<CleanupHookCallback> GetOrdered() const;
@@ -1,9 +1,18 @@
 #include "compile_cache.h"
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <limits>
 #include <string>
+#include <unordered_set>
+#include <vector>
 #include "debug_utils-inl.h"
 #include "env-inl.h"
+#include "memory_tracker-inl.h"
 #include "node_file.h"
 #include "node_internals.h"
+#include "node_mutex.h"
+#include "node_startup_phases.h"
 #include "node_version.h"
 #include "path.h"
 #include "util.h"
@@ -15,14 +24,20 @@
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <sys/mman.h>
 #endif
 namespace node {
 
+using v8::Context;
 using v8::Function;
+using v8::HandleScope;
+using v8::Isolate;
 using v8::Local;
 using v8::Module;
 using v8::ScriptCompiler;
 using v8::String;
+using v8::UnboundScript;
 
 namespace {
 std::string Uint32ToHex(uint32_t crc) {
@@ -77,6 +92,10 @@ inline void CompileCacheHandler::Debug(const char* format,
 
 ScriptCompiler::CachedData* CompileCacheEntry::CopyCache() const {
   DCHECK_NOT_NULL(cache);
+  if (cache->buffer_policy == ScriptCompiler::CachedData::BufferNotOwned) {
+    return new ScriptCompiler::CachedData(
+        cache->data, cache->length, ScriptCompiler::CachedData::BufferNotOwned);
+  }
   int cache_size = cache->length;
   uint8_t* data = new uint8_t[cache_size];
   memcpy(data, cache->data, cache_size);
@@ -100,12 +119,18 @@ const char* CompileCacheEntry::type_name() const {
       return "TransformedTypeScript";
     case CachedCodeType::kTransformedTypeScriptWithSourceMaps:
       return "TransformedTypeScriptWithSourceMaps";
+    case CachedCodeType::kScript:
+      return "Script";
     default:
       UNREACHABLE();
   }
 }
 
 void CompileCacheHandler::ReadCacheFile(CompileCacheEntry* entry) {
+  startup_phases::CounterScope counter_scope(
+      startup_phases::Counter::kCompileCacheRead);
+  if (packed_) return ReadPackedCache(entry);
+
   Debug("[compile cache] reading cache from %s for %s %s...",
         entry->cache_filename,
         entry->type_name(),
@@ -226,6 +251,467 @@ void CompileCacheHandler::ReadCacheFile(CompileCacheEntry* entry) {
   Debug(" success, size=%d\n", total_read);
 }
 
+namespace {
+
+// Layout of the packed cache, in the cache directory:
+//
+//   packed.data: a PackedDataHeader, followed by the caches of all entries,
+//     each aligned to kPackedAlignment so that V8 can use them in place.
+//     New caches are appended; entries that were replaced leave garbage
+//     behind until the file is compacted, i.e. rewritten with only the
+//     caches that are still in use, under a new data_id.
+//   packed.index: a PackedIndexHeader, followed by an open addressing hash
+//     table of slot_count PackedIndexSlots keyed by cache_key, with linear
+//     probing. It is replaced atomically with a rename whenever the cache is
+//     persisted, and only applies to the data file with the same data_id.
+//
+// As with the per-entry files, every cache is checked against the sizes and
+// hashes in its slot before it is used, so that concurrent writers at worst
+// cause cache misses.
+constexpr uint32_t kPackedIndexMagicNumber = 0x8adfdbb3;
+constexpr uint32_t kPackedDataMagicNumber = 0x8adfdbb4;
+constexpr uint32_t kPackedVersion = 1;
+constexpr uint64_t kPackedAlignment = 8;
+// The data file is compacted once it is at least this large and more than
+// half of it is garbage.
+constexpr uint64_t kPackedCompactionMinSize = 1024 * 1024;
+constexpr char kPackedIndexFilename[] = "packed.index";
+constexpr char kPackedDataFilename[] = "packed.data";
+
+struct PackedDataHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t data_id;
+};
+
+struct PackedIndexHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t data_id;
+  uint32_t slot_count;  // A power of two.
+  uint32_t entry_count;
+};
+
+struct PackedIndexSlot {
+  uint32_t cache_key;
+  uint32_t used;
+  uint32_t code_size;
+  uint32_t code_hash;
+  uint32_t cache_size;
+  uint32_t cache_hash;
+  uint64_t data_offset;
+};
+static_assert(sizeof(PackedIndexHeader) % alignof(PackedIndexSlot) == 0);
+
+uint64_t AlignPacked(uint64_t size) {
+  return (size + kPackedAlignment - 1) & ~(kPackedAlignment - 1);
+}
+
+// The whole contents of a file, mapped where mmap is available and read into
+// memory otherwise.
+class FileContents {
+ public:
+  FileContents() = default;
+  FileContents(const FileContents&) = delete;
+  FileContents& operator=(const FileContents&) = delete;
+  ~FileContents() { Reset(); }
+
+  // Returns a libuv error code on failure.
+  int Open(const std::string& path) {
+    Reset();
+    uv_fs_t req;
+    auto cleanup = OnScopeLeave([&req]() { uv_fs_req_cleanup(&req); });
+    uv_file file =
+        uv_fs_open(nullptr, &req, path.c_str(), O_RDONLY, 0, nullptr);
+    if (file < 0) return file;
+    uv_fs_req_cleanup(&req);
+    auto defer_close = OnScopeLeave([file]() {
+      uv_fs_t close_req;
+      uv_fs_close(nullptr, &close_req, file, nullptr);
+      uv_fs_req_cleanup(&close_req);
+    });
+
+    int err = uv_fs_fstat(nullptr, &req, file, nullptr);
+    if (err < 0) return err;
+    if (req.statbuf.st_size == 0 ||
+        req.statbuf.st_size > std::numeric_limits<uint32_t>::max()) {
+      return UV_EINVAL;
+    }
+    size_t size = static_cast<size_t>(req.statbuf.st_size);
+    uv_fs_req_cleanup(&req);
+
+#ifndef _WIN32
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED) return UV_ENOMEM;
+    data_ = static_cast<uint8_t*>(data);
+#else
+    data_ = new uint8_t[size];
+    size_t total_read = 0;
+    while (total_read < size) {
+      uv_buf_t buf = uv_buf_init(reinterpret_cast<char*>(data_ + total_read),
+                                 size - total_read);
+      int bytes_read =
+          uv_fs_read(nullptr, &req, file, &buf, 1, total_read, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (bytes_read <= 0) {
+        delete[] data_;
+        data_ = nullptr;
+        return bytes_read < 0 ? bytes_read : UV_EIO;
+      }
+      total_read += bytes_read;
+    }
+#endif
+    size_ = size;
+    return 0;
+  }
+
+  void Reset() {
+    if (data_ == nullptr) return;
+#ifndef _WIN32
+    munmap(data_, size_);
+#else
+    delete[] data_;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Writes bufs to file starting at offset, resuming after partial writes.
+int WriteBuffers(uv_file file, std::vector<uv_buf_t> bufs, int64_t offset) {
+  size_t i = 0;
+  while (i < bufs.size()) {
+    uv_fs_t req;
+    int written = uv_fs_write(
+        nullptr, &req, file, &bufs[i], bufs.size() - i, offset, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (written < 0) return written;
+    if (written == 0) return UV_EIO;
+    offset += written;
+    for (size_t n = written; n > 0;) {
+      size_t len = std::min<size_t>(n, bufs[i].len);
+      bufs[i].base += len;
+      bufs[i].len -= len;
+      n -= len;
+      if (bufs[i].len == 0) i++;
+    }
+    while (i < bufs.size() && bufs[i].len == 0) i++;
+  }
+  return 0;
+}
+
+// Writes bufs to a temporary file next to path and renames it to path, so
+// that readers see either the old or the new file in full.
+int WriteFileAtomically(const std::string& path,
+                        const std::vector<uv_buf_t>& bufs) {
+  uv_fs_t req;
+  auto cleanup = OnScopeLeave([&req]() { uv_fs_req_cleanup(&req); });
+  std::string tmpl = path + ".XXXXXX";
+  int err = uv_fs_mkstemp(nullptr, &req, tmpl.c_str(), nullptr);
+  if (err < 0) return err;
+  uv_file file = static_cast<uv_file>(req.result);
+  std::string tmp_path = req.path;
+
+  err = WriteBuffers(file, bufs, 0);
+  uv_fs_t close_req;
+  int close_err = uv_fs_close(nullptr, &close_req, file, nullptr);
+  uv_fs_req_cleanup(&close_req);
+  if (err == 0) err = close_err;
+  if (err == 0) {
+    uv_fs_t rename_req;
+    err = uv_fs_rename(
+        nullptr, &rename_req, tmp_path.c_str(), path.c_str(), nullptr);
+    uv_fs_req_cleanup(&rename_req);
+  }
+  if (err < 0) {
+    uv_fs_t unlink_req;
+    uv_fs_unlink(nullptr, &unlink_req, tmp_path.c_str(), nullptr);
+    uv_fs_req_cleanup(&unlink_req);
+  }
+  return err;
+}
+
+}  // namespace
+
+struct CompileCacheHandler::PackedCache {
+  std::string index_path;
+  std::string data_path;
+  FileContents index;
+  FileContents data;
+  // Zero unless both files were found and belong together.
+  uint64_t data_id = 0;
+  const PackedIndexSlot* slots = nullptr;
+  uint32_t slot_count = 0;
+
+  const PackedIndexSlot* Find(uint32_t cache_key) const {
+    const uint32_t mask = slot_count - 1;
+    for (uint32_t i = 0, n = cache_key & mask; i < slot_count;
+         i++, n = (n + 1) & mask) {
+      if (!slots[n].used) return nullptr;
+      if (slots[n].cache_key == cache_key) return &slots[n];
+    }
+    return nullptr;
+  }
+};
+
+void CompileCacheHandler::OpenPackedCache() {
+  packed_ = std::make_unique<PackedCache>();
+  packed_->index_path =
+      compile_cache_dir_ + kPathSeparator + kPackedIndexFilename;
+  packed_->data_path =
+      compile_cache_dir_ + kPathSeparator + kPackedDataFilename;
+
+  Debug("[compile cache] mapping packed cache %s...", packed_->index_path);
+  int err = packed_->index.Open(packed_->index_path);
+  if (err == 0) err = packed_->data.Open(packed_->data_path);
+  if (err < 0) {
+    Debug(" %s\n", uv_strerror(err));
+    return;
+  }
+
+  const auto* index_header =
+      reinterpret_cast<const PackedIndexHeader*>(packed_->index.data());
+  const auto* data_header =
+      reinterpret_cast<const PackedDataHeader*>(packed_->data.data());
+  if (packed_->index.size() < sizeof(PackedIndexHeader) ||
+      packed_->data.size() < sizeof(PackedDataHeader) ||
+      index_header->magic != kPackedIndexMagicNumber ||
+      index_header->version != kPackedVersion ||
+      data_header->magic != kPackedDataMagicNumber ||
+      data_header->version != kPackedVersion) {
+    Debug(" invalid header\n");
+    return;
+  }
+  if (index_header->data_id != data_header->data_id) {
+    Debug(" index is for another data file\n");
+    return;
+  }
+  const uint32_t slot_count = index_header->slot_count;
+  if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0 ||
+      packed_->index.size() != sizeof(PackedIndexHeader) +
+                                   uint64_t{slot_count} *
+                                       sizeof(PackedIndexSlot)) {
+    Debug(" invalid index size\n");
+    return;
+  }
+
+  packed_->data_id = data_header->data_id;
+  packed_->slots = reinterpret_cast<const PackedIndexSlot*>(
+      packed_->index.data() + sizeof(PackedIndexHeader));
+  packed_->slot_count = slot_count;
+  Debug(" %d entries, %d bytes of data\n",
+        index_header->entry_count,
+        packed_->data.size());
+}
+
+void CompileCacheHandler::ReadPackedCache(CompileCacheEntry* entry) {
+  Debug("[compile cache] reading packed cache for %s %s...",
+        entry->type_name(),
+        entry->source_filename);
+  const PackedIndexSlot* slot =
+      packed_->slot_count > 0 ? packed_->Find(entry->cache_key) : nullptr;
+  if (slot == nullptr) {
+    Debug(" not found\n");
+    return;
+  }
+  if (slot->code_size != entry->code_size ||
+      slot->code_hash != entry->code_hash) {
+    Debug(" code mismatch\n");
+    return;
+  }
+  if (slot->data_offset < sizeof(PackedDataHeader) ||
+      slot->data_offset > packed_->data.size() ||
+      slot->cache_size > packed_->data.size() - slot->data_offset) {
+    Debug(" cache out of bounds\n");
+    return;
+  }
+  const uint8_t* cache = packed_->data.data() + slot->data_offset;
+  if (GetHash(reinterpret_cast<const char*>(cache), slot->cache_size) !=
+      slot->cache_hash) {
+    Debug(" cache hash mismatch\n");
+    return;
+  }
+  entry->cache.reset(new ScriptCompiler::CachedData(
+      cache, slot->cache_size, ScriptCompiler::CachedData::BufferNotOwned));
+  Debug(" success, size=%d\n", slot->cache_size);
+}
+
+void CompileCacheHandler::PersistPacked() {
+  std::vector<CompileCacheEntry*> fresh;
+  std::unordered_set<uint32_t> fresh_keys;
+  for (auto& pair : compiler_cache_store_) {
+    CompileCacheEntry* entry = pair.second.get();
+    if (entry->cache == nullptr || !entry->refreshed || entry->persisted) {
+      continue;
+    }
+    DCHECK_EQ(entry->cache->buffer_policy,
+              ScriptCompiler::CachedData::BufferOwned);
+    fresh.push_back(entry);
+    fresh_keys.insert(entry->cache_key);
+  }
+  if (fresh.empty()) {
+    Debug("[compile cache] packed cache is up to date\n");
+    return;
+  }
+
+  // Keep the slots of the current index that were not replaced, and whose
+  // caches lie within what was mapped of the data file.
+  const PackedCache& packed = *packed_;
+  std::vector<PackedIndexSlot> slots;
+  uint64_t live_size = 0;
+  for (uint32_t n = 0; n < packed.slot_count; n++) {
+    const PackedIndexSlot& slot = packed.slots[n];
+    if (!slot.used || fresh_keys.count(slot.cache_key) > 0 ||
+        slot.data_offset > packed.data.size() ||
+        slot.cache_size > packed.data.size() - slot.data_offset) {
+      continue;
+    }
+    slots.push_back(slot);
+    live_size += AlignPacked(slot.cache_size);
+  }
+
+  uint64_t data_id = packed.data_id;
+  uint64_t offset = 0;
+  uv_file append_file = -1;
+  auto close_append_file = OnScopeLeave([&append_file]() {
+    if (append_file < 0) return;
+    uv_fs_t close_req;
+    uv_fs_close(nullptr, &close_req, append_file, nullptr);
+    uv_fs_req_cleanup(&close_req);
+  });
+
+  bool compact = data_id == 0 ||
+                 (packed.data.size() >= kPackedCompactionMinSize &&
+                  packed.data.size() - sizeof(PackedDataHeader) >
+                      2 * live_size);
+  if (!compact) {
+    // Append to the data file, unless it has been replaced since it was
+    // mapped.
+    uv_fs_t req;
+    auto cleanup = OnScopeLeave([&req]() { uv_fs_req_cleanup(&req); });
+    append_file = uv_fs_open(
+        nullptr, &req, packed.data_path.c_str(), O_RDWR, 0, nullptr);
+    uv_fs_req_cleanup(&req);
+    PackedDataHeader header;
+    uv_buf_t header_buf =
+        uv_buf_init(reinterpret_cast<char*>(&header), sizeof(header));
+    if (append_file < 0 ||
+        uv_fs_read(nullptr, &req, append_file, &header_buf, 1, 0, nullptr) !=
+            static_cast<int>(sizeof(header)) ||
+        header.data_id != data_id) {
+      compact = true;
+    } else {
+      uv_fs_req_cleanup(&req);
+      if (uv_fs_fstat(nullptr, &req, append_file, nullptr) < 0) {
+        compact = true;
+      } else {
+        offset = req.statbuf.st_size;
+      }
+    }
+  }
+
+  static const uint8_t padding[kPackedAlignment] = {};
+  std::vector<uv_buf_t> data_bufs;
+  auto add_cache = [&](const uint8_t* cache, uint32_t size) {
+    if (offset != AlignPacked(offset)) {
+      data_bufs.push_back(
+          uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(padding)),
+                      AlignPacked(offset) - offset));
+      offset = AlignPacked(offset);
+    }
+    data_bufs.push_back(uv_buf_init(
+        reinterpret_cast<char*>(const_cast<uint8_t*>(cache)), size));
+    uint64_t cache_offset = offset;
+    offset += size;
+    return cache_offset;
+  };
+
+  PackedDataHeader data_header;
+  if (compact) {
+    Debug("[compile cache] compacting packed cache, %d of %d bytes in use\n",
+          live_size,
+          packed.data.size());
+    do {
+      if (uv_random(nullptr, nullptr, &data_id, sizeof(data_id), 0, nullptr) <
+          0) {
+        data_id = uv_hrtime();
+      }
+    } while (data_id == 0 || data_id == packed.data_id);
+    data_header = {kPackedDataMagicNumber, kPackedVersion, data_id};
+    data_bufs.push_back(uv_buf_init(reinterpret_cast<char*>(&data_header),
+                                    sizeof(data_header)));
+    offset = sizeof(data_header);
+    for (PackedIndexSlot& slot : slots) {
+      slot.data_offset =
+          add_cache(packed.data.data() + slot.data_offset, slot.cache_size);
+    }
+  }
+  const uint64_t append_offset = offset;
+
+  for (CompileCacheEntry* entry : fresh) {
+    PackedIndexSlot slot = {};
+    slot.cache_key = entry->cache_key;
+    slot.used = 1;
+    slot.code_size = entry->code_size;
+    slot.code_hash = entry->code_hash;
+    slot.cache_size = static_cast<uint32_t>(entry->cache->length);
+    slot.cache_hash =
+        GetHash(reinterpret_cast<const char*>(entry->cache->data),
+                entry->cache->length);
+    slot.data_offset = add_cache(entry->cache->data, slot.cache_size);
+    slots.push_back(slot);
+  }
+
+  Debug("[compile cache] writing %d entries to packed cache %s...",
+        fresh.size(),
+        packed.data_path);
+  int err = compact ? WriteFileAtomically(packed.data_path, data_bufs)
+                    : WriteBuffers(append_file, data_bufs, append_offset);
+  if (err < 0) {
+    Debug(" %s\n", uv_strerror(err));
+    return;
+  }
+  Debug(" success\n");
+
+  // The index has at least twice as many slots as entries, so that probe
+  // sequences stay short.
+  uint32_t slot_count = 16;
+  while (slot_count < 2 * slots.size()) slot_count *= 2;
+  std::vector<PackedIndexSlot> table(slot_count);
+  for (const PackedIndexSlot& slot : slots) {
+    uint32_t n = slot.cache_key & (slot_count - 1);
+    while (table[n].used) n = (n + 1) & (slot_count - 1);
+    table[n] = slot;
+  }
+  PackedIndexHeader index_header = {kPackedIndexMagicNumber,
+                                    kPackedVersion,
+                                    data_id,
+                                    slot_count,
+                                    static_cast<uint32_t>(slots.size())};
+  Debug("[compile cache] writing packed index %s with %d entries...",
+        packed.index_path,
+        slots.size());
+  err = WriteFileAtomically(
+      packed.index_path,
+      {uv_buf_init(reinterpret_cast<char*>(&index_header),
+                   sizeof(index_header)),
+       uv_buf_init(reinterpret_cast<char*>(table.data()),
+                   table.size() * sizeof(PackedIndexSlot))});
+  if (err < 0) {
+    Debug(" %s\n", uv_strerror(err));
+    return;
+  }
+  Debug(" success\n");
+  for (CompileCacheEntry* entry : fresh) entry->persisted = true;
+}
+
 static std::string GetRelativePath(std::string_view path,
                                    std::string_view base) {
 // On Windows, the native encoding is UTF-16, so we need to convert
@@ -314,6 +800,30 @@ ScriptCompiler::CachedData* SerializeCodeCache(Local<Module> mod) {
   return ScriptCompiler::CreateCodeCache(mod->GetUnboundModuleScript());
 }
 
+ScriptCompiler::CachedData* SerializeCodeCache(Local<UnboundScript> script) {
+  return ScriptCompiler::CreateCodeCache(script);
+}
+
+void RetainForWarmup(Isolate* isolate,
+                     CompileCacheEntry* entry,
+                     Local<Function> func) {
+  entry->function.Reset(isolate, func);
+}
+
+// The unbound script is retained instead of the module, since it can no
+// longer be obtained once the module has been evaluated.
+void RetainForWarmup(Isolate* isolate,
+                     CompileCacheEntry* entry,
+                     Local<Module> mod) {
+  entry->module_script.Reset(isolate, mod->GetUnboundModuleScript());
+}
+
+void RetainForWarmup(Isolate* isolate,
+                     CompileCacheEntry* entry,
+                     Local<UnboundScript> script) {
+  entry->script.Reset(isolate, script);
+}
+
 template <typename T>
 void CompileCacheHandler::MaybeSaveImpl(CompileCacheEntry* entry,
                                         Local<T> func_or_mod,
@@ -325,6 +835,7 @@ void CompileCacheHandler::MaybeSaveImpl(CompileCacheEntry* entry,
         rejected                    ? "rejected"
         : (entry->cache == nullptr) ? "not initialized"
                                     : "accepted");
+  if (warmup_) RetainForWarmup(isolate_, entry, func_or_mod);
   if (entry->cache != nullptr && !rejected) {  // accepted
     Debug("keeping the in-memory entry\n");
     return;
@@ -335,7 +846,9 @@ void CompileCacheHandler::MaybeSaveImpl(CompileCacheEntry* entry,
   ScriptCompiler::CachedData* data = SerializeCodeCache(func_or_mod);
   DCHECK_EQ(data->buffer_policy, ScriptCompiler::CachedData::BufferOwned);
   entry->refreshed = true;
+  entry->persisted = false;
   entry->cache.reset(data);
+  if (writer_) PersistInBackground(entry);
 }
 
 void CompileCacheHandler::MaybeSave(CompileCacheEntry* entry,
@@ -351,6 +864,13 @@ void CompileCacheHandler::MaybeSave(CompileCacheEntry* entry,
   MaybeSaveImpl(entry, func, rejected);
 }
 
+void CompileCacheHandler::MaybeSave(CompileCacheEntry* entry,
+                                    Local<UnboundScript> script,
+                                    bool rejected) {
+  DCHECK(entry->type == CachedCodeType::kScript);
+  MaybeSaveImpl(entry, script, rejected);
+}
+
 void CompileCacheHandler::MaybeSave(CompileCacheEntry* entry,
                                     std::string_view transpiled) {
   CHECK(entry->type == CachedCodeType::kStrippedTypeScript ||
@@ -368,6 +888,305 @@ void CompileCacheHandler::MaybeSave(CompileCacheEntry* entry,
   entry->cache.reset(new ScriptCompiler::CachedData(
       data, cache_size, ScriptCompiler::CachedData::BufferOwned));
   entry->refreshed = true;
+  entry->persisted = false;
+  if (writer_) PersistInBackground(entry);
+}
+
+// Used for identifying and verifying a file is a compiled WebAssembly module
+// cache file. It has the same headers as the other cache files, with the
+// module bytes in place of the code.
+constexpr uint32_t kWasmCacheMagicNumber = 0x7761736d;
+
+std::string CompileCacheHandler::GetWasmCacheFilename(
+    std::string_view url) const {
+  return compile_cache_dir_ + kPathSeparator + "wasm-" +
+         Uint32ToHex(GetHash(url.data(), url.size())) + ".cache";
+}
+
+bool CompileCacheHandler::ReadWasmCache(
+    const std::string& filename,
+    v8::WasmStreaming::ModuleCachingInterface* caching) const {
+  Debug("[compile cache] reading WebAssembly cache from %s...", filename);
+  FileContents contents;
+  int err = contents.Open(filename);
+  if (err < 0) {
+    Debug(" %s\n", uv_strerror(err));
+    return false;
+  }
+  if (contents.size() < kHeaderCount * sizeof(uint32_t)) {
+    Debug("truncated\n");
+    return false;
+  }
+
+  uint32_t headers[kHeaderCount];
+  memcpy(headers, contents.data(), sizeof(headers));
+  const uint8_t* cache = contents.data() + sizeof(headers);
+  const size_t cache_size = contents.size() - sizeof(headers);
+  v8::MemorySpan<const uint8_t> wire_bytes = caching->GetWireBytes();
+  if (headers[kMagicNumberOffset] != kWasmCacheMagicNumber ||
+      headers[kCacheSizeOffset] != cache_size ||
+      headers[kCodeSizeOffset] != wire_bytes.size()) {
+    Debug("header mismatch\n");
+    return false;
+  }
+  // The module bytes have changed since the module was cached.
+  if (headers[kCodeHashOffset] !=
+      GetHash(reinterpret_cast<const char*>(wire_bytes.data()),
+              wire_bytes.size())) {
+    Debug("module hash mismatch\n");
+    return false;
+  }
+  if (headers[kCacheHashOffset] !=
+      GetHash(reinterpret_cast<const char*>(cache), cache_size)) {
+    Debug("cache hash mismatch\n");
+    return false;
+  }
+
+  // V8 copies what it needs while deserializing the module.
+  bool accepted = caching->SetCachedCompiledModuleBytes({cache, cache_size});
+  Debug("%s\n", accepted ? "success" : "rejected by V8");
+  return accepted;
+}
+
+std::function<void(v8::CompiledWasmModule)>
+CompileCacheHandler::GetWasmCacheWriter(std::string filename) const {
+  // V8 may call this on a background thread after the Environment is gone,
+  // so it only holds on to copies of what it needs.
+  return [filename = std::move(filename),
+          is_debug = is_debug_](v8::CompiledWasmModule module) {
+    v8::OwnedBuffer serialized = module.Serialize();
+    if (serialized.size == 0) return;
+    v8::MemorySpan<const uint8_t> wire_bytes = module.GetWireBytesRef();
+
+    uint32_t headers[kHeaderCount];
+    headers[kMagicNumberOffset] = kWasmCacheMagicNumber;
+    headers[kCodeSizeOffset] = wire_bytes.size();
+    headers[kCacheSizeOffset] = serialized.size;
+    headers[kCodeHashOffset] = GetHash(
+        reinterpret_cast<const char*>(wire_bytes.data()), wire_bytes.size());
+    headers[kCacheHashOffset] =
+        GetHash(reinterpret_cast<const char*>(serialized.buffer.get()),
+                serialized.size);
+    std::vector<uv_buf_t> bufs = {
+        uv_buf_init(reinterpret_cast<char*>(headers), sizeof(headers)),
+        uv_buf_init(const_cast<char*>(reinterpret_cast<const char*>(
+                        serialized.buffer.get())),
+                    serialized.size),
+    };
+    int err = WriteFileAtomically(filename, bufs);
+    if (is_debug) [[unlikely]] {
+      FPrintF(stderr,
+              "[compile cache] writing WebAssembly cache for %s to %s...%s\n",
+              module.source_url(),
+              filename,
+              err < 0 ? uv_strerror(err) : "success");
+    }
+  };
+}
+
+CompileCacheHandler::CacheFileWrite CompileCacheHandler::PrepareCacheFile(
+    const CompileCacheEntry* entry, bool copy) const {
+  DCHECK_EQ(entry->cache->buffer_policy,
+            ScriptCompiler::CachedData::BufferOwned);
+  CacheFileWrite write;
+  write.cache_filename = entry->cache_filename;
+  write.source_filename = entry->source_filename;
+  write.type_name = entry->type_name();
+  write.size = static_cast<uint32_t>(entry->cache->length);
+  if (copy) {
+    write.storage = std::make_unique<char[]>(write.size);
+    memcpy(write.storage.get(), entry->cache->data, write.size);
+    write.data = write.storage.get();
+  } else {
+    write.data = reinterpret_cast<const char*>(entry->cache->data);
+  }
+
+  // Generating headers.
+  write.headers[kMagicNumberOffset] = kCacheMagicNumber;
+  write.headers[kCodeSizeOffset] = entry->code_size;
+  write.headers[kCacheSizeOffset] = write.size;
+  write.headers[kCodeHashOffset] = entry->code_hash;
+  write.headers[kCacheHashOffset] = GetHash(write.data, write.size);
+  return write;
+}
+
+// May be called on the writer thread, so this must not touch anything but
+// the write itself.
+bool CompileCacheHandler::WriteCacheFile(const CacheFileWrite& write) const {
+  // Generate the temporary filename.
+  // The temporary file should be placed in a location like:
+  //
+  // $NODE_COMPILE_CACHE_DIR/v23.0.0-pre-arm64-5fad6d45-501/e7f8ef7f.cache.tcqrsK
+  //
+  // 1. $NODE_COMPILE_CACHE_DIR either comes from the $NODE_COMPILE_CACHE
+  // environment
+  //    variable or `module.enableCompileCache()`.
+  // 2. v23.0.0-pre-arm64-5fad6d45-501 is the sub cache directory and
+  //    e7f8ef7f is the hash for the cache (see
+  //    CompileCacheHandler::Enable()),
+  // 3. tcqrsK is generated by uv_fs_mkstemp() as a temporary identifier.
+  uv_fs_t mkstemp_req;
+  auto cleanup_mkstemp =
+      OnScopeLeave([&mkstemp_req]() { uv_fs_req_cleanup(&mkstemp_req); });
+  std::string cache_filename_tmp = write.cache_filename + ".XXXXXX";
+  Debug("[compile cache] Creating temporary file for cache of %s (%s)...",
+        write.source_filename,
+        write.type_name);
+  int err = uv_fs_mkstemp(
+      nullptr, &mkstemp_req, cache_filename_tmp.c_str(), nullptr);
+  if (err < 0) {
+    Debug("failed. %s\n", uv_strerror(err));
+    return false;
+  }
+  Debug(" -> %s\n", mkstemp_req.path);
+  Debug("[compile cache] writing cache for %s %s to temporary file %s [%d "
+        "%d %d "
+        "%d %d]...",
+        write.type_name,
+        write.source_filename,
+        mkstemp_req.path,
+        write.headers[kMagicNumberOffset],
+        write.headers[kCodeSizeOffset],
+        write.headers[kCacheSizeOffset],
+        write.headers[kCodeHashOffset],
+        write.headers[kCacheHashOffset]);
+
+  // Write to the temporary file.
+  char* headers_ptr =
+      reinterpret_cast<char*>(const_cast<uint32_t*>(write.headers));
+  uv_buf_t headers_buf = uv_buf_init(headers_ptr, sizeof(write.headers));
+  uv_buf_t data_buf = uv_buf_init(const_cast<char*>(write.data), write.size);
+  uv_buf_t bufs[] = {headers_buf, data_buf};
+
+  uv_fs_t write_req;
+  auto cleanup_write =
+      OnScopeLeave([&write_req]() { uv_fs_req_cleanup(&write_req); });
+  err = uv_fs_write(
+      nullptr, &write_req, mkstemp_req.result, bufs, 2, 0, nullptr);
+  if (err < 0) {
+    Debug("failed: %s\n", uv_strerror(err));
+    return false;
+  }
+
+  uv_fs_t close_req;
+  auto cleanup_close =
+      OnScopeLeave([&close_req]() { uv_fs_req_cleanup(&close_req); });
+  err = uv_fs_close(nullptr, &close_req, mkstemp_req.result, nullptr);
+
+  if (err < 0) {
+    Debug("failed: %s\n", uv_strerror(err));
+    return false;
+  }
+
+  Debug("success\n");
+
+  // Rename the temporary file to the actual cache file.
+  uv_fs_t rename_req;
+  auto cleanup_rename =
+      OnScopeLeave([&rename_req]() { uv_fs_req_cleanup(&rename_req); });
+  std::string cache_filename_final = write.cache_filename;
+  Debug("[compile cache] Renaming %s to %s...",
+        mkstemp_req.path,
+        cache_filename_final);
+  err = uv_fs_rename(nullptr,
+                     &rename_req,
+                     mkstemp_req.path,
+                     cache_filename_final.c_str(),
+                     nullptr);
+  if (err < 0) {
+    Debug("failed: %s\n", uv_strerror(err));
+    return false;
+  }
+  Debug("success\n");
+  return true;
+}
+
+// Writes cache files on a dedicated thread, in the order in which they
+// were queued, so that a later refresh of an entry always wins. The queue
+// is bounded by the size of the caches in it, past which Enqueue() blocks
+// until the thread catches up. The destructor finishes the pending writes.
+class CompileCacheHandler::Writer {
+ public:
+  static constexpr size_t kMaxQueuedBytes = 32 * 1024 * 1024;
+
+  explicit Writer(const CompileCacheHandler* handler) : handler_(handler) {}
+
+  ~Writer() {
+    if (!started_) return;
+    {
+      Mutex::ScopedLock lock(mutex_);
+      stopping_ = true;
+      cond_.Broadcast(lock);
+    }
+    CHECK_EQ(uv_thread_join(&thread_), 0);
+  }
+
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  int Start() {
+    int err = uv_thread_create(&thread_, ThreadMain, this);
+    started_ = err == 0;
+    return err;
+  }
+
+  void Enqueue(CacheFileWrite&& write) {
+    Mutex::ScopedLock lock(mutex_);
+    // A cache larger than the limit still goes through on an empty queue.
+    while (!queue_.empty() && queued_bytes_ + write.size > kMaxQueuedBytes) {
+      cond_.Wait(lock);
+    }
+    queued_bytes_ += write.size;
+    queue_.push_back(std::move(write));
+    cond_.Broadcast(lock);
+  }
+
+  // Blocks until everything queued so far has been written.
+  void Drain() {
+    Mutex::ScopedLock lock(mutex_);
+    while (!queue_.empty() || writing_) cond_.Wait(lock);
+  }
+
+ private:
+  static void ThreadMain(void* arg) {
+    Writer* writer = static_cast<Writer*>(arg);
+    Mutex::ScopedLock lock(writer->mutex_);
+    while (true) {
+      while (writer->queue_.empty() && !writer->stopping_) {
+        writer->cond_.Wait(lock);
+      }
+      if (writer->queue_.empty()) return;
+      CacheFileWrite write = std::move(writer->queue_.front());
+      writer->queue_.pop_front();
+      writer->writing_ = true;
+      {
+        Mutex::ScopedUnlock unlock(lock);
+        writer->handler_->WriteCacheFile(write);
+      }
+      writer->writing_ = false;
+      writer->queued_bytes_ -= write.size;
+      writer->cond_.Broadcast(lock);
+    }
+  }
+
+  const CompileCacheHandler* handler_;
+  uv_thread_t thread_;
+  bool started_ = false;
+  Mutex mutex_;
+  ConditionVariable cond_;
+  std::deque<CacheFileWrite> queue_;
+  size_t queued_bytes_ = 0;
+  bool writing_ = false;
+  bool stopping_ = false;
+};
+
+void CompileCacheHandler::PersistInBackground(CompileCacheEntry* entry) {
+  DCHECK(writer_);
+  Debug("[compile cache] queueing cache of %s %s for the writer thread\n",
+        entry->type_name(),
+        entry->source_filename);
+  writer_->Enqueue(PrepareCacheFile(entry, true));
+  entry->persisted = true;
 }
 
 /**
@@ -385,18 +1204,29 @@ void CompileCacheHandler::MaybeSave(CompileCacheEntry* entry,
  *   [uint32_t] cache hash
  *   .... compile cache content ....
  */
-void CompileCacheHandler::Persist() {
+void CompileCacheHandler::Persist(bool after_warmup) {
   DCHECK(!compile_cache_dir_.empty());
 
+  if (after_warmup && warmup_) {
+    RecaptureAfterWarmup();
+  }
+  // Everything compiled from now on is warmed up again from scratch.
+  CloseWarmupTimer();
+
+  if (packed_) {
+    PersistPacked();
+    compiler_cache_store_.clear();
+    // Pick up what was just written. Nothing refers to the old mappings
+    // any more: V8 consumes cached data while compiling.
+    OpenPackedCache();
+    return;
+  }
+
   // TODO(joyeecheung): do this using a separate event loop to utilize the
   // libuv thread pool and do the file system operations concurrently.
-  // TODO(joyeecheung): Currently flushing is triggered by either process
-  // shutdown or user requests. In the future we should simply start the
-  // writes right after module loading on a separate thread, and this method
-  // only blocks until all the pending writes (if any) on the other thread are
-  // finished. In that case, the off-thread writes should finish long
-  // before any attempt of flushing is made so the method would then only
-  // incur a negligible overhead from thread synchronization.
+  // With the background writer, the entries have been handed to the writer
+  // thread as soon as they were refreshed, so this only picks up the ones
+  // left over and waits for the pending writes to finish.
   for (auto& pair : compiler_cache_store_) {
     auto* entry = pair.second.get();
     const char* type_name = entry->type_name();
@@ -422,106 +1252,19 @@ void CompileCacheHandler::Persist() {
       continue;
     }
 
-    DCHECK_EQ(entry->cache->buffer_policy,
-              ScriptCompiler::CachedData::BufferOwned);
-    char* cache_ptr =
-        reinterpret_cast<char*>(const_cast<uint8_t*>(entry->cache->data));
-    uint32_t cache_size = static_cast<uint32_t>(entry->cache->length);
-    uint32_t cache_hash = GetHash(cache_ptr, cache_size);
-
-    // Generating headers.
-    std::vector<uint32_t> headers(kHeaderCount);
-    headers[kMagicNumberOffset] = kCacheMagicNumber;
-    headers[kCodeSizeOffset] = entry->code_size;
-    headers[kCacheSizeOffset] = cache_size;
-    headers[kCodeHashOffset] = entry->code_hash;
-    headers[kCacheHashOffset] = cache_hash;
-
-    // Generate the temporary filename.
-    // The temporary file should be placed in a location like:
-    //
-    // $NODE_COMPILE_CACHE_DIR/v23.0.0-pre-arm64-5fad6d45-501/e7f8ef7f.cache.tcqrsK
-    //
-    // 1. $NODE_COMPILE_CACHE_DIR either comes from the $NODE_COMPILE_CACHE
-    // environment
-    //    variable or `module.enableCompileCache()`.
-    // 2. v23.0.0-pre-arm64-5fad6d45-501 is the sub cache directory and
-    //    e7f8ef7f is the hash for the cache (see
-    //    CompileCacheHandler::Enable()),
-    // 3. tcqrsK is generated by uv_fs_mkstemp() as a temporary identifier.
-    uv_fs_t mkstemp_req;
-    auto cleanup_mkstemp =
-        OnScopeLeave([&mkstemp_req]() { uv_fs_req_cleanup(&mkstemp_req); });
-    std::string cache_filename_tmp = entry->cache_filename + ".XXXXXX";
-    Debug("[compile cache] Creating temporary file for cache of %s (%s)...",
-          entry->source_filename,
-          type_name);
-    int err = uv_fs_mkstemp(
-        nullptr, &mkstemp_req, cache_filename_tmp.c_str(), nullptr);
-    if (err < 0) {
-      Debug("failed. %s\n", uv_strerror(err));
+    if (writer_) {
+      PersistInBackground(entry);
       continue;
     }
-    Debug(" -> %s\n", mkstemp_req.path);
-    Debug("[compile cache] writing cache for %s %s to temporary file %s [%d "
-          "%d %d "
-          "%d %d]...",
-          type_name,
-          entry->source_filename,
-          mkstemp_req.path,
-          headers[kMagicNumberOffset],
-          headers[kCodeSizeOffset],
-          headers[kCacheSizeOffset],
-          headers[kCodeHashOffset],
-          headers[kCacheHashOffset]);
-
-    // Write to the temporary file.
-    uv_buf_t headers_buf = uv_buf_init(reinterpret_cast<char*>(headers.data()),
-                                       headers.size() * sizeof(uint32_t));
-    uv_buf_t data_buf = uv_buf_init(cache_ptr, entry->cache->length);
-    uv_buf_t bufs[] = {headers_buf, data_buf};
-
-    uv_fs_t write_req;
-    auto cleanup_write =
-        OnScopeLeave([&write_req]() { uv_fs_req_cleanup(&write_req); });
-    err = uv_fs_write(
-        nullptr, &write_req, mkstemp_req.result, bufs, 2, 0, nullptr);
-    if (err < 0) {
-      Debug("failed: %s\n", uv_strerror(err));
-      continue;
-    }
-
-    uv_fs_t close_req;
-    auto cleanup_close =
-        OnScopeLeave([&close_req]() { uv_fs_req_cleanup(&close_req); });
-    err = uv_fs_close(nullptr, &close_req, mkstemp_req.result, nullptr);
-
-    if (err < 0) {
-      Debug("failed: %s\n", uv_strerror(err));
-      continue;
+    if (WriteCacheFile(PrepareCacheFile(entry, false))) {
+      entry->persisted = true;
     }
+  }
 
-    Debug("success\n");
-
-    // Rename the temporary file to the actual cache file.
-    uv_fs_t rename_req;
-    auto cleanup_rename =
-        OnScopeLeave([&rename_req]() { uv_fs_req_cleanup(&rename_req); });
-    std::string cache_filename_final = entry->cache_filename;
-    Debug("[compile cache] Renaming %s to %s...",
-          mkstemp_req.path,
-          cache_filename_final);
-    err = uv_fs_rename(nullptr,
-                       &rename_req,
-                       mkstemp_req.path,
-                       cache_filename_final.c_str(),
-                       nullptr);
-    if (err < 0) {
-      Debug("failed: %s\n", uv_strerror(err));
-      continue;
-    }
-    Debug("success\n");
-    entry->persisted = true;
+  if (writer_) {
+    Debug("[compile cache] waiting for pending writes...");
+    writer_->Drain();
+    Debug("done\n");
   }
 
   // Clear the map at the end in one go instead of during the iteration to
@@ -531,10 +1274,82 @@ void CompileCacheHandler::Persist() {
 }
 
 CompileCacheHandler::CompileCacheHandler(Environment* env)
-    : isolate_(env->isolate()),
+    : env_(env),
+      isolate_(env->isolate()),
       is_debug_(
           env->enabled_debug_list()->enabled(DebugCategory::COMPILE_CACHE)) {}
 
+CompileCacheHandler::~CompileCacheHandler() = default;
+
+void CompileCacheHandler::MemoryInfo(MemoryTracker* tracker) const {
+  size_t entries = 0;
+  for (const auto& pair : compiler_cache_store_) {
+    const CompileCacheEntry* entry = pair.second.get();
+    entries += sizeof(*entry) + entry->cache_filename.capacity() +
+               entry->source_filename.capacity();
+    // Caches from the packed cache point into its mapping of the file.
+    const ScriptCompiler::CachedData* cache = entry->cache.get();
+    if (cache != nullptr &&
+        cache->buffer_policy == ScriptCompiler::CachedData::BufferOwned) {
+      entries += cache->length;
+    }
+  }
+  tracker->TrackFieldWithSize(
+      "compiler_cache_store", entries, "CompileCacheEntry");
+  tracker->TrackField("compile_cache_dir", compile_cache_dir_);
+  tracker->TrackField("normalized_compile_cache_dir",
+                      normalized_compile_cache_dir_);
+}
+
+void CompileCacheHandler::RecaptureAfterWarmup() {
+  HandleScope handle_scope(isolate_);
+  for (auto& pair : compiler_cache_store_) {
+    CompileCacheEntry* entry = pair.second.get();
+    ScriptCompiler::CachedData* data;
+    if (!entry->function.IsEmpty()) {
+      data = SerializeCodeCache(entry->function.Get(isolate_));
+    } else if (!entry->module_script.IsEmpty()) {
+      data = ScriptCompiler::CreateCodeCache(
+          entry->module_script.Get(isolate_));
+    } else if (!entry->script.IsEmpty()) {
+      data = SerializeCodeCache(entry->script.Get(isolate_));
+    } else {
+      continue;
+    }
+    entry->function.Reset();
+    entry->module_script.Reset();
+    entry->script.Reset();
+    Debug("[compile cache] re-captured code cache for %s %s after warm-up, "
+          "%d -> %d bytes\n",
+          entry->type_name(),
+          entry->source_filename,
+          entry->cache == nullptr ? 0 : entry->cache->length,
+          data == nullptr ? 0 : data->length);
+    if (data == nullptr) continue;
+    DCHECK_EQ(data->buffer_policy, ScriptCompiler::CachedData::BufferOwned);
+    entry->cache.reset(data);
+    entry->refreshed = true;
+    entry->persisted = false;
+  }
+}
+
+void CompileCacheHandler::OnWarmupTimer(uv_timer_t* handle) {
+  CompileCacheHandler* handler =
+      static_cast<CompileCacheHandler*>(handle->data);
+  Environment* env = handler->env_;
+  if (!env->can_call_into_js()) return;
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  handler->Debug("[compile cache] warm-up timer fired.\n");
+  handler->Persist(true);
+}
+
+void CompileCacheHandler::CloseWarmupTimer() {
+  if (warmup_timer_ == nullptr) return;
+  env_->CloseHandle(warmup_timer_, [](uv_timer_t* handle) { delete handle; });
+  warmup_timer_ = nullptr;
+}
+
 // Directory structure:
 // - Compile cache directory (from NODE_COMPILE_CACHE)
 //   - $NODE_VERSION-$ARCH-$CACHE_DATA_VERSION_TAG-$UID
@@ -594,6 +1409,45 @@ CompileCacheEnableResult CompileCacheHandler::Enable(Environment* env,
     normalized_compile_cache_dir_ =
         NormalizeFileURLOrPath(env, compile_cache_dir_);
   }
+  std::string packed_env;
+  if (credentials::SafeGetenv("NODE_COMPILE_CACHE_PACKED", &packed_env, env) &&
+      packed_env == "1") {
+    OpenPackedCache();
+  }
+  // The packed cache is rewritten as a whole, so it is always persisted
+  // synchronously.
+  std::string background_env;
+  if (!packed_ &&
+      credentials::SafeGetenv(
+          "NODE_COMPILE_CACHE_BACKGROUND", &background_env, env) &&
+      background_env == "1") {
+    writer_ = std::make_unique<Writer>(this);
+    err = writer_->Start();
+    Debug("[compile cache] starting the writer thread...%s\n",
+          err < 0 ? uv_strerror(err) : "success");
+    if (err != 0) writer_.reset();
+  }
+  std::string warmup_env;
+  if (credentials::SafeGetenv("NODE_COMPILE_CACHE_WARMUP", &warmup_env, env) &&
+      !warmup_env.empty()) {
+    warmup_ = true;
+    uint64_t delay = std::strtoull(warmup_env.c_str(), nullptr, 10);
+    if (delay > 0) {
+      warmup_timer_ = new uv_timer_t();
+      warmup_timer_->data = this;
+      CHECK_EQ(0, uv_timer_init(env->event_loop(), warmup_timer_));
+      CHECK_EQ(0, uv_timer_start(warmup_timer_, OnWarmupTimer, delay, 0));
+      // Warming up does not keep the process alive.
+      uv_unref(reinterpret_cast<uv_handle_t*>(warmup_timer_));
+      env->AddCleanupHook(
+          [](void* handler) {
+            static_cast<CompileCacheHandler*>(handler)->CloseWarmupTimer();
+          },
+          this);
+    }
+    Debug("[compile cache] warm-up mode, re-capturing after %dms\n",
+          delay);
+  }
   result.status = CompileCacheEnableStatus::ENABLED;
   return result;
 }
@@ -4,10 +4,13 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include <cinttypes>
+#include <functional>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include "memory_tracker.h"
+#include "uv.h"
 #include "v8.h"
 
 namespace node {
@@ -18,7 +21,8 @@ class Environment;
   V(kESM, 1)                                                                   \
   V(kStrippedTypeScript, 2)                                                    \
   V(kTransformedTypeScript, 3)                                                 \
-  V(kTransformedTypeScriptWithSourceMaps, 4)
+  V(kTransformedTypeScriptWithSourceMaps, 4)                                   \
+  V(kScript, 5)
 
 enum class CachedCodeType : uint8_t {
 #define V(type, value) type = value,
@@ -38,8 +42,15 @@ struct CompileCacheEntry {
   bool refreshed = false;
   bool persisted = false;
 
+  // In warm-up mode, what the code cache is re-captured from once the
+  // code has run for a while. Only one of them is set.
+  v8::Global<v8::Function> function;
+  v8::Global<v8::UnboundModuleScript> module_script;
+  v8::Global<v8::UnboundScript> script;
+
   // Copy the cache into a new store for V8 to consume. Caller takes
-  // ownership.
+  // ownership. Caches read from the packed cache are not copied: the new
+  // store points into the mapping, which outlives the handler's entries.
   v8::ScriptCompiler::CachedData* CopyCache() const;
   const char* type_name() const;
 };
@@ -64,14 +75,22 @@ struct CompileCacheEnableResult {
 
 enum class EnableOption : uint8_t { DEFAULT, PORTABLE };
 
-class CompileCacheHandler {
+class CompileCacheHandler : public MemoryRetainer {
  public:
   explicit CompileCacheHandler(Environment* env);
+  ~CompileCacheHandler();
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(CompileCacheHandler)
+  SET_SELF_SIZE(CompileCacheHandler)
   CompileCacheEnableResult Enable(Environment* env,
                                   const std::string& dir,
                                   EnableOption option = EnableOption::DEFAULT);
 
-  void Persist();
+  // With after_warmup, the code cache is first re-captured from the
+  // functions and modules retained in warm-up mode, so that it includes
+  // the inner functions that were lazily compiled since.
+  void Persist(bool after_warmup = false);
 
   CompileCacheEntry* GetOrInsert(v8::Local<v8::String> code,
                                  v8::Local<v8::String> filename,
@@ -82,12 +101,48 @@ class CompileCacheHandler {
   void MaybeSave(CompileCacheEntry* entry,
                  v8::Local<v8::Module> mod,
                  bool rejected);
+  void MaybeSave(CompileCacheEntry* entry,
+                 v8::Local<v8::UnboundScript> script,
+                 bool rejected);
   void MaybeSave(CompileCacheEntry* entry, std::string_view transpiled);
   std::string_view cache_dir() { return compile_cache_dir_; }
 
+  // Modules compiled by WebAssembly.compileStreaming() are kept in a file
+  // named after their URL, and only reused if the module bytes hash to the
+  // same value as those they were compiled from.
+  std::string GetWasmCacheFilename(std::string_view url) const;
+  bool ReadWasmCache(const std::string& filename,
+                     v8::WasmStreaming::ModuleCachingInterface* caching) const;
+  // Returns a callback for SetMoreFunctionsCanBeSerializedCallback() that
+  // writes the module to filename. It may be called on any thread.
+  std::function<void(v8::CompiledWasmModule)> GetWasmCacheWriter(
+      std::string filename) const;
+
  private:
   void ReadCacheFile(CompileCacheEntry* entry);
 
+  // The packed cache, enabled with NODE_COMPILE_CACHE_PACKED=1, keeps all
+  // entries in one append-only data file and an index over it, both of
+  // which are mapped once when the cache is enabled, instead of one file
+  // per entry.
+  struct PackedCache;
+  void OpenPackedCache();
+  void ReadPackedCache(CompileCacheEntry* entry);
+  void PersistPacked();
+
+  // With NODE_COMPILE_CACHE_BACKGROUND=1, cache files are written on a
+  // dedicated thread as soon as the entries are refreshed, and Persist()
+  // only waits for the pending writes.
+  class Writer;
+  void PersistInBackground(CompileCacheEntry* entry);
+
+  // Warm-up mode is enabled with NODE_COMPILE_CACHE_WARMUP=<ms>. If ms is
+  // not 0, the cache is persisted after warm-up when that many milliseconds
+  // have passed.
+  void RecaptureAfterWarmup();
+  static void OnWarmupTimer(uv_timer_t* handle);
+  void CloseWarmupTimer();
+
   template <typename T>
   void MaybeSaveImpl(CompileCacheEntry* entry,
                      v8::Local<T> func_or_mod,
@@ -103,12 +158,32 @@ class CompileCacheHandler {
   static constexpr size_t kCacheHashOffset = 4;
   static constexpr size_t kHeaderCount = 5;
 
+  // A cache file ready to be written, with the cache either borrowed from
+  // the entry or, when it is handed to the writer thread, a copy of it.
+  struct CacheFileWrite {
+    std::string cache_filename;
+    std::string source_filename;
+    const char* type_name;
+    uint32_t headers[kHeaderCount];
+    const char* data;
+    uint32_t size;
+    std::unique_ptr<char[]> storage;
+  };
+  CacheFileWrite PrepareCacheFile(const CompileCacheEntry* entry,
+                                  bool copy) const;
+  bool WriteCacheFile(const CacheFileWrite& write) const;
+
+  Environment* env_ = nullptr;
   v8::Isolate* isolate_ = nullptr;
   bool is_debug_ = false;
+  bool warmup_ = false;
+  uv_timer_t* warmup_timer_ = nullptr;
 
   std::string compile_cache_dir_;
   std::string normalized_compile_cache_dir_;
   EnableOption portable_ = EnableOption::DEFAULT;
+  std::unique_ptr<PackedCache> packed_;
+  std::unique_ptr<Writer> writer_;
   std::unordered_map<uint32_t, std::unique_ptr<CompileCacheEntry>>
       compiler_cache_store_;
 };
@@ -1,5 +1,6 @@
 #include "crypto/crypto_argon2.h"
 #include "async_wrap-inl.h"
+#include "node_options-inl.h"
 #include "threadpoolwork-inl.h"
 
 #if OPENSSL_VERSION_NUMBER >= 0x30200000L
@@ -28,7 +29,8 @@ Argon2Config::Argon2Config(Argon2Config&& other) noexcept
       iter{other.iter},
       lanes{other.lanes},
       memcost{other.memcost},
-      keylen{other.keylen} {}
+      keylen{other.keylen},
+      threads{other.threads} {}
 
 Argon2Config& Argon2Config::operator=(Argon2Config&& other) noexcept {
   if (&other == this) return *this;
@@ -103,6 +105,8 @@ Maybe<void> Argon2Traits::AdditionalConfig(
   config->iter = args[offset + 5].As<Uint32>()->Value();
   config->type =
       static_cast<ncrypto::Argon2Type>(args[offset + 8].As<Uint32>()->Value());
+  config->threads =
+      static_cast<uint32_t>(per_process::cli_options->kdf_max_threads);
 
   if (!ncrypto::argon2(config->pass,
                        config->salt,
@@ -142,7 +146,8 @@ bool Argon2Traits::DeriveBits(Environment* env,
                             config.version,
                             config.secret,
                             config.ad,
-                            config.type);
+                            config.type,
+                            config.threads);
 
   if (!dp) return false;
   DCHECK(!dp.isSecure());
@@ -32,6 +32,8 @@ struct Argon2Config final : public MemoryRetainer {
   uint32_t memcost;
   uint32_t version = 0x13;
   uint32_t keylen;
+  // Cap on the threads computing lanes in parallel, from --kdf-max-threads.
+  uint32_t threads = 0;
 
   Argon2Config() = default;
 
@@ -1,8 +1,10 @@
 #include "crypto/crypto_cipher.h"
 #include "base_object-inl.h"
 #include "crypto/crypto_util.h"
+#include "dataqueue/queue.h"
 #include "env-inl.h"
 #include "memory_tracker-inl.h"
+#include "node_blob.h"
 #include "node_buffer.h"
 #include "node_internals.h"
 #include "node_process-inl.h"
@@ -151,6 +153,72 @@ void GetCipherInfo(const FunctionCallbackInfo<Value>& args) {
     args.GetReturnValue().Set(info);
   }
 }
+
+// Encrypts or decrypts the contents of a DataQueue with an AEAD stream
+// cipher as the queue is read. Both AES-GCM and ChaCha20-Poly1305 produce
+// exactly one byte of output per byte of input, so the only overhead is
+// the authentication tag that is appended to the ciphertext.
+class AeadTransform final : public DataQueue::Transform {
+ public:
+  AeadTransform(CipherCtxPointer ctx, bool encrypt, size_t auth_tag_len)
+      : ctx_(std::move(ctx)), encrypt_(encrypt), auth_tag_len_(auth_tag_len) {}
+
+  size_t max_overhead() const override {
+    return encrypt_ ? auth_tag_len_ : 0;
+  }
+
+  bool Update(const uint8_t* data,
+              size_t len,
+              std::vector<uint8_t>* out) override {
+    MarkPopErrorOnReturn mark_pop_error_on_return;
+    size_t offset = out->size();
+    out->resize(offset + len);
+    while (len > 0) {
+      size_t chunk = std::min<size_t>(len, INT_MAX);
+      int written = static_cast<int>(chunk);
+      if (!ctx_.update({data, chunk}, out->data() + offset, &written))
+        return false;
+      offset += written;
+      data += chunk;
+      len -= chunk;
+    }
+    out->resize(offset);
+    return true;
+  }
+
+  bool Finish(std::vector<uint8_t>* out) override {
+    MarkPopErrorOnReturn mark_pop_error_on_return;
+    int written = 0;
+    uint8_t unused;
+    if (!ctx_.update({}, &unused, &written, true)) return false;
+    CHECK_EQ(written, 0);
+    if (encrypt_) {
+      size_t offset = out->size();
+      out->resize(offset + auth_tag_len_);
+      if (!ctx_.getAeadTag(auth_tag_len_, out->data() + offset)) return false;
+    }
+    ctx_.reset();
+    return true;
+  }
+
+  std::optional<uint64_t> size(
+      std::optional<uint64_t> input_size) const override {
+    if (!input_size.has_value()) return std::nullopt;
+    return input_size.value() + max_overhead();
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("context", ctx_ ? kSizeOf_EVP_CIPHER_CTX : 0);
+  }
+
+  SET_MEMORY_INFO_NAME(AeadTransform)
+  SET_SELF_SIZE(AeadTransform)
+
+ private:
+  CipherCtxPointer ctx_;
+  const bool encrypt_;
+  const size_t auth_tag_len_;
+};
 }  // namespace
 
 void CipherBase::GetSSLCiphers(const FunctionCallbackInfo<Value>& args) {
@@ -232,6 +300,7 @@ void CipherBase::Initialize(Environment* env, Local<Object> target) {
   SetProtoMethodNoSideEffect(isolate, t, "getAuthTag", GetAuthTag);
   SetProtoMethod(isolate, t, "setAuthTag", SetAuthTag);
   SetProtoMethod(isolate, t, "setAAD", SetAAD);
+  SetProtoMethod(isolate, t, "transformBlob", TransformBlob);
   SetConstructorFunction(context, target, "CipherBase", t);
 
   SetMethodNoSideEffect(context, target, "getSSLCiphers", GetSSLCiphers);
@@ -274,6 +343,7 @@ void CipherBase::RegisterExternalReferences(
   registry->Register(GetAuthTag);
   registry->Register(SetAuthTag);
   registry->Register(SetAAD);
+  registry->Register(TransformBlob);
 
   registry->Register(GetSSLCiphers);
   registry->Register(GetCiphers);
@@ -727,6 +797,51 @@ void CipherBase::Update(const FunctionCallbackInfo<Value>& args) {
       });
 }
 
+// Takes the remaining work of the cipher over to a Blob that encrypts or
+// decrypts the given Blob while it is being read, so that large payloads do
+// not have to pass through update() one JavaScript chunk at a time. Only
+// AES-GCM and ChaCha20-Poly1305 are supported. When encrypting, the
+// authentication tag is appended to the ciphertext. When decrypting, the
+// tag must have been passed to setAuthTag() and a mismatch fails the final
+// read. Like final(), this leaves the cipher unusable.
+void CipherBase::TransformBlob(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CipherBase* cipher;
+  ASSIGN_OR_RETURN_UNWRAP(&cipher, args.This());
+
+  CHECK(Blob::HasInstance(env, args[0]));
+  Blob* blob;
+  ASSIGN_OR_RETURN_UNWRAP(&blob, args[0]);
+
+  if (!cipher->ctx_ ||
+      !(cipher->ctx_.isGcmMode() || cipher->ctx_.isChaCha20Poly1305()) ||
+      (cipher->kind_ == kDecipher &&
+       cipher->auth_tag_state_ != kAuthTagSetByUser)) {
+    return THROW_ERR_CRYPTO_INVALID_STATE(env);
+  }
+
+  std::shared_ptr<DataQueue> source = blob->getDataQueue().slice(0);
+  if (!source) return THROW_ERR_CRYPTO_INVALID_STATE(env);
+
+  if (cipher->kind_ == kCipher && cipher->auth_tag_len_ == kNoAuthTagLength) {
+    CHECK(cipher->ctx_.isGcmMode());
+    cipher->auth_tag_len_ = EVP_GCM_TLS_TAG_LEN;
+  }
+
+  auto transform =
+      std::make_unique<AeadTransform>(std::move(cipher->ctx_),
+                                      cipher->kind_ == kCipher,
+                                      cipher->auth_tag_len_);
+  std::shared_ptr<DataQueue> data_queue = DataQueue::Create();
+  CHECK(data_queue->append(DataQueue::CreateTransformEntry(
+                               std::move(source), std::move(transform)))
+            .value_or(false));
+  data_queue->cap();
+
+  BaseObjectPtr<Blob> result = Blob::Create(env, std::move(data_queue));
+  if (result) args.GetReturnValue().Set(result->object());
+}
+
 bool CipherBase::SetAutoPadding(bool auto_padding) {
   if (!ctx_) return false;
   MarkPopErrorOnReturn mark_pop_error_on_return;
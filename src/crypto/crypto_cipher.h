@@ -75,6 +75,7 @@ class CipherBase : public BaseObject {
   static void GetAuthTag(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetAuthTag(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetAAD(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void TransformBlob(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   CipherBase(Environment* env, v8::Local<v8::Object> wrap, CipherKind kind);
 
@@ -28,6 +28,7 @@
 #endif
 
 #include <set>
+#include <unordered_map>
 
 namespace node {
 
@@ -72,6 +73,7 @@ using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::Signature;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 namespace crypto {
@@ -1229,6 +1231,8 @@ Local<FunctionTemplate> SecureContext::GetConstructorTemplate(
     SetProtoMethod(isolate, tmpl, "close", Close);
     SetProtoMethod(isolate, tmpl, "loadPKCS12", LoadPKCS12);
     SetProtoMethod(isolate, tmpl, "setTicketKeys", SetTicketKeys);
+    SetProtoMethod(
+        isolate, tmpl, "useSharedTicketKeys", UseSharedTicketKeys);
     SetProtoMethod(
         isolate, tmpl, "enableTicketKeyCallback", EnableTicketKeyCallback);
 
@@ -1317,6 +1321,7 @@ void SecureContext::RegisterExternalReferences(
   registry->Register(Close);
   registry->Register(LoadPKCS12);
   registry->Register(SetTicketKeys);
+  registry->Register(UseSharedTicketKeys);
   registry->Register(EnableTicketKeyCallback);
   registry->Register(GetTicketKeys);
   registry->Register(GetCertificate<true>);
@@ -2146,6 +2151,19 @@ void SecureContext::GetTicketKeys(const FunctionCallbackInfo<Value>& args) {
   if (!Buffer::New(wrap->env(), 48).ToLocal(&buff))
     return;
 
+  if (wrap->ticket_key_ring_) {
+    TicketKeyRing::Key key;
+    if (!wrap->ticket_key_ring_->GetEncryptionKey(&key)) {
+      return THROW_ERR_CRYPTO_OPERATION_FAILED(
+          wrap->env(), "Error generating ticket keys");
+    }
+    memcpy(Buffer::Data(buff), key.name, 16);
+    memcpy(Buffer::Data(buff) + 16, key.hmac, 16);
+    memcpy(Buffer::Data(buff) + 32, key.aes, 16);
+    OPENSSL_cleanse(&key, sizeof(key));
+    return args.GetReturnValue().Set(buff);
+  }
+
   memcpy(Buffer::Data(buff), wrap->ticket_key_name_, 16);
   memcpy(Buffer::Data(buff) + 16, wrap->ticket_key_hmac_, 16);
   memcpy(Buffer::Data(buff) + 32, wrap->ticket_key_aes_, 16);
@@ -2163,6 +2181,12 @@ void SecureContext::SetTicketKeys(const FunctionCallbackInfo<Value>& args) {
 
   CHECK_EQ(buf.length(), 48);
 
+  if (wrap->ticket_key_ring_) {
+    wrap->ticket_key_ring_->SetCurrentKey(
+        reinterpret_cast<const unsigned char*>(buf.data()));
+    return args.GetReturnValue().Set(true);
+  }
+
   memcpy(wrap->ticket_key_name_, buf.data(), 16);
   memcpy(wrap->ticket_key_hmac_, buf.data() + 16, 16);
   memcpy(wrap->ticket_key_aes_, buf.data() + 32, 16);
@@ -2170,6 +2194,116 @@ void SecureContext::SetTicketKeys(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(true);
 }
 
+// Joins the process-wide ticket key ring called args[0], rotating its key
+// every args[1] milliseconds (0 for never).
+void SecureContext::UseSharedTicketKeys(
+    const FunctionCallbackInfo<Value>& args) {
+  SecureContext* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.This());
+
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsUint32());
+  Utf8Value name(wrap->env()->isolate(), args[0]);
+
+  wrap->ticket_key_ring_ = TicketKeyRing::Get(name.ToString());
+  wrap->ticket_key_ring_->set_rotation_interval(
+      args[1].As<Uint32>()->Value());
+}
+
+std::shared_ptr<TicketKeyRing> TicketKeyRing::Get(const std::string& name) {
+  // Rings are dropped once no context uses them, taking their keys along.
+  static Mutex registry_mutex;
+  static std::unordered_map<std::string, std::weak_ptr<TicketKeyRing>>
+      registry;
+
+  Mutex::ScopedLock lock(registry_mutex);
+  std::weak_ptr<TicketKeyRing>& entry = registry[name];
+  std::shared_ptr<TicketKeyRing> ring = entry.lock();
+  if (!ring) {
+    ring.reset(new TicketKeyRing());
+    entry = ring;
+  }
+  // Lazily forget entries whose ring is gone.
+  for (auto it = registry.begin(); it != registry.end();) {
+    it = it->second.expired() ? registry.erase(it) : std::next(it);
+  }
+  return ring;
+}
+
+TicketKeyRing::~TicketKeyRing() {
+  OPENSSL_cleanse(keys_.data(), keys_.size() * sizeof(Key));
+}
+
+void TicketKeyRing::set_rotation_interval(uint64_t interval_ms) {
+  Mutex::ScopedLock lock(mutex_);
+  rotation_interval_ms_ = interval_ms;
+}
+
+bool TicketKeyRing::RotateIfNeeded() {
+  uint64_t now = uv_hrtime();
+  if (!keys_.empty() &&
+      (rotation_interval_ms_ == 0 ||
+       now - keys_.front().created < rotation_interval_ms_ * 1000000)) {
+    return true;
+  }
+
+  Key key;
+  if (!ncrypto::CSPRNG(key.name, sizeof(key.name)) ||
+      !ncrypto::CSPRNG(key.hmac, sizeof(key.hmac)) ||
+      !ncrypto::CSPRNG(key.aes, sizeof(key.aes))) {
+    return false;
+  }
+  key.created = now;
+  if (keys_.size() == kMaxKeys) {
+    OPENSSL_cleanse(&keys_.back(), sizeof(Key));
+    keys_.pop_back();
+  }
+  keys_.insert(keys_.begin(), key);
+  OPENSSL_cleanse(&key, sizeof(key));
+  return true;
+}
+
+bool TicketKeyRing::GetEncryptionKey(Key* out) {
+  Mutex::ScopedLock lock(mutex_);
+  if (!RotateIfNeeded()) return false;
+  *out = keys_.front();
+  return true;
+}
+
+int TicketKeyRing::GetDecryptionKey(const unsigned char* name, Key* out) {
+  Mutex::ScopedLock lock(mutex_);
+  for (size_t i = 0; i < keys_.size(); i++) {
+    if (memcmp(name, keys_[i].name, kKeyPartSize) == 0) {
+      *out = keys_[i];
+      return i == 0 ? 1 : 2;
+    }
+  }
+  return 0;
+}
+
+void TicketKeyRing::SetCurrentKey(const unsigned char* keys) {
+  Mutex::ScopedLock lock(mutex_);
+  Key key;
+  memcpy(key.name, keys, kKeyPartSize);
+  memcpy(key.hmac, keys + kKeyPartSize, kKeyPartSize);
+  memcpy(key.aes, keys + 2 * kKeyPartSize, kKeyPartSize);
+  key.created = uv_hrtime();
+  // Re-setting a key that is already known only moves it to the front.
+  for (auto it = keys_.begin(); it != keys_.end(); ++it) {
+    if (memcmp(it->name, key.name, kKeyPartSize) == 0) {
+      OPENSSL_cleanse(&*it, sizeof(Key));
+      keys_.erase(it);
+      break;
+    }
+  }
+  if (keys_.size() == kMaxKeys) {
+    OPENSSL_cleanse(&keys_.back(), sizeof(Key));
+    keys_.pop_back();
+  }
+  keys_.insert(keys_.begin(), key);
+  OPENSSL_cleanse(&key, sizeof(key));
+}
+
 // Currently, EnableTicketKeyCallback and TicketKeyCallback are only present for
 // the regression test in test/parallel/test-https-resume-after-renew.js.
 void SecureContext::EnableTicketKeyCallback(
@@ -2279,6 +2413,35 @@ int SecureContext::TicketCompatibilityCallback(SSL* ssl,
   SecureContext* sc = static_cast<SecureContext*>(
       SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
 
+  if (sc->ticket_key_ring_) {
+    TicketKeyRing::Key key;
+    int r = 1;
+    if (enc) {
+      if (!sc->ticket_key_ring_->GetEncryptionKey(&key)) return -1;
+      memcpy(name, key.name, sizeof(key.name));
+      if (!ncrypto::CSPRNG(iv, 16) ||
+          EVP_EncryptInit_ex(
+              ectx, Cipher::AES_128_CBC, nullptr, key.aes, iv) <= 0) {
+        r = -1;
+      }
+    } else {
+      r = sc->ticket_key_ring_->GetDecryptionKey(name, &key);
+      // The ticket key name does not match. Discard the ticket.
+      if (r == 0) return 0;
+      if (EVP_DecryptInit_ex(
+              ectx, Cipher::AES_128_CBC, nullptr, key.aes, iv) <= 0) {
+        r = -1;
+      }
+    }
+    if (r > 0 &&
+        HMAC_Init_ex(
+            hctx, key.hmac, sizeof(key.hmac), Digest::SHA256, nullptr) <= 0) {
+      r = -1;
+    }
+    OPENSSL_cleanse(&key, sizeof(key));
+    return r;
+  }
+
   if (enc) {
     memcpy(name, sc->ticket_key_name_, sizeof(sc->ticket_key_name_));
     if (!ncrypto::CSPRNG(iv, 16) ||
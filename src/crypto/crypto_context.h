@@ -25,6 +25,53 @@ X509_STORE* GetOrCreateRootCertStore();
 
 ncrypto::BIOPointer LoadBIO(Environment* env, v8::Local<v8::Value> v);
 
+// A named, process-wide set of session ticket keys. Every SecureContext
+// that joins the same ring, from any Worker thread, issues tickets with the
+// same current key and accepts tickets made with recent ones, so a client
+// can resume against any of them. Keys rotate after a configurable period;
+// the previous kMaxKeys - 1 keys stay valid for decryption, and tickets
+// made with them are renewed. Processes share a ring by having one of them
+// distribute the current key with getTicketKeys()/setTicketKeys().
+class TicketKeyRing final {
+ public:
+  static constexpr size_t kKeyPartSize = 16;
+  static constexpr size_t kMaxKeys = 3;
+
+  struct Key {
+    unsigned char name[kKeyPartSize];
+    unsigned char hmac[kKeyPartSize];
+    unsigned char aes[kKeyPartSize];
+    uint64_t created;  // uv_hrtime() timestamp
+  };
+
+  // Returns the ring called name, creating it if no context uses it yet.
+  static std::shared_ptr<TicketKeyRing> Get(const std::string& name);
+
+  ~TicketKeyRing();
+
+  // 0 disables rotation.
+  void set_rotation_interval(uint64_t interval_ms);
+
+  // Copies the key to encrypt new tickets with into out, generating or
+  // rotating it first when needed.
+  bool GetEncryptionKey(Key* out);
+
+  // Looks up the key a ticket was made with. Returns 1 for the current key,
+  // 2 for an older key still accepted, 0 if the ticket should be rejected.
+  int GetDecryptionKey(const unsigned char* name, Key* out);
+
+  // Makes name || hmac || aes (48 bytes) the current key.
+  void SetCurrentKey(const unsigned char* keys);
+
+ private:
+  TicketKeyRing() = default;
+  bool RotateIfNeeded();
+
+  Mutex mutex_;
+  std::vector<Key> keys_;  // Newest first.
+  uint64_t rotation_interval_ms_ = 0;
+};
+
 class SecureContext final : public BaseObject {
  public:
   using GetSessionCb = SSL_SESSION* (*)(SSL*, const unsigned char*, int, int*);
@@ -121,6 +168,8 @@ class SecureContext final : public BaseObject {
   static void SetTicketKeys(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableTicketKeyCallback(
       const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void UseSharedTicketKeys(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void CtxGetter(const v8::FunctionCallbackInfo<v8::Value>& info);
 
   template <bool primary>
@@ -157,6 +206,8 @@ class SecureContext final : public BaseObject {
   unsigned char ticket_key_name_[16];
   unsigned char ticket_key_aes_[16];
   unsigned char ticket_key_hmac_[16];
+  // When set, replaces the ticket_key_* fields above.
+  std::shared_ptr<TicketKeyRing> ticket_key_ring_;
 };
 
 int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
@@ -15,6 +15,8 @@ namespace node {
 
 using ncrypto::Digest;
 using ncrypto::HMACCtxPointer;
+using v8::Array;
+using v8::ArrayBuffer;
 using v8::Boolean;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
@@ -22,6 +24,7 @@ using v8::HandleScope;
 using v8::Isolate;
 using v8::JustVoid;
 using v8::Local;
+using v8::LocalVector;
 using v8::Maybe;
 using v8::MaybeLocal;
 using v8::Nothing;
@@ -53,6 +56,7 @@ void Hmac::Initialize(Environment* env, Local<Object> target) {
   SetConstructorFunction(env->context(), target, "Hmac", t);
 
   HmacJob::Initialize(env, target);
+  HmacBatchJob::Initialize(env, target);
 }
 
 void Hmac::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
@@ -61,6 +65,7 @@ void Hmac::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(HmacUpdate);
   registry->Register(HmacDigest);
   HmacJob::RegisterExternalReferences(registry);
+  HmacBatchJob::RegisterExternalReferences(registry);
 }
 
 void Hmac::New(const FunctionCallbackInfo<Value>& args) {
@@ -97,10 +102,30 @@ void Hmac::HmacInit(const FunctionCallbackInfo<Value>& args) {
   Environment* env = hmac->env();
 
   const node::Utf8Value hash_type(env->isolate(), args[0]);
+  if (KeyObjectHandle::HasInstance(env, args[1])) {
+    KeyObjectHandle* key;
+    ASSIGN_OR_RETURN_UNWRAP(&key, args[1]);
+    return hmac->HmacInit(*hash_type, key->Data());
+  }
   ByteSource key = ByteSource::FromSecretKeyBytes(env, args[1]);
   hmac->HmacInit(*hash_type, key.data<char>(), key.size());
 }
 
+void Hmac::HmacInit(const char* hash_type, const KeyObjectData& key) {
+  HandleScope scope(env()->isolate());
+
+  Digest md = Digest::FromName(hash_type);
+  if (!md) [[unlikely]] {
+    return THROW_ERR_CRYPTO_INVALID_DIGEST(
+        env(), "Invalid digest: %s", hash_type);
+  }
+
+  ctx_ = key.NewHmacContext(md);
+  if (!ctx_) [[unlikely]] {
+    return ThrowCryptoError(env(), ERR_get_error());
+  }
+}
+
 bool Hmac::HmacUpdate(const char* data, size_t len) {
   ncrypto::Buffer<const void> buf{
       .data = data,
@@ -232,13 +257,8 @@ bool HmacTraits::DeriveBits(Environment* env,
                             const HmacConfig& params,
                             ByteSource* out,
                             CryptoJobMode mode) {
-  auto ctx = HMACCtxPointer::New();
-
-  ncrypto::Buffer<const void> key_buf{
-      .data = params.key.GetSymmetricKey(),
-      .len = params.key.GetSymmetricKeySize(),
-  };
-  if (!ctx.init(key_buf, params.digest)) [[unlikely]] {
+  auto ctx = params.key.NewHmacContext(params.digest);
+  if (!ctx) [[unlikely]] {
     return false;
   }
 
@@ -275,5 +295,171 @@ MaybeLocal<Value> HmacTraits::EncodeOutput(Environment* env,
   UNREACHABLE();
 }
 
+HmacBatchConfig::HmacBatchConfig(HmacBatchConfig&& other) noexcept
+    : job_mode(other.job_mode),
+      mode(other.mode),
+      key(std::move(other.key)),
+      data(std::move(other.data)),
+      signatures(std::move(other.signatures)),
+      digest(other.digest) {}
+
+HmacBatchConfig& HmacBatchConfig::operator=(HmacBatchConfig&& other) noexcept {
+  if (&other == this) return *this;
+  this->~HmacBatchConfig();
+  return *new (this) HmacBatchConfig(std::move(other));
+}
+
+void HmacBatchConfig::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField("key", key);
+  // If the job is sync, then the HmacBatchConfig does not own the data
+  if (job_mode == kCryptoJobAsync) {
+    size_t size = 0;
+    for (const auto& item : data) size += item.size();
+    for (const auto& item : signatures) size += item.size();
+    tracker->TrackFieldWithSize("data", size);
+  }
+}
+
+Maybe<void> HmacBatchTraits::AdditionalConfig(
+    CryptoJobMode mode,
+    const FunctionCallbackInfo<Value>& args,
+    unsigned int offset,
+    HmacBatchConfig* params) {
+  Environment* env = Environment::GetCurrent(args);
+
+  params->job_mode = mode;
+
+  CHECK(args[offset]->IsUint32());  // SignConfiguration::Mode
+  params->mode =
+    static_cast<SignConfiguration::Mode>(args[offset].As<Uint32>()->Value());
+
+  CHECK(args[offset + 1]->IsString());  // Hash
+  CHECK(args[offset + 2]->IsObject());  // Key
+  CHECK(args[offset + 3]->IsArray());   // Data
+
+  Utf8Value digest(env->isolate(), args[offset + 1]);
+  params->digest = Digest::FromName(*digest);
+  if (!params->digest) [[unlikely]] {
+    THROW_ERR_CRYPTO_INVALID_DIGEST(env, "Invalid digest: %s", digest);
+    return Nothing<void>();
+  }
+
+  KeyObjectHandle* key;
+  ASSIGN_OR_RETURN_UNWRAP(&key, args[offset + 2], Nothing<void>());
+  params->key = key->Data().addRef();
+
+  auto to_byte_sources = [&](Local<Array> array,
+                             const char* what,
+                             std::vector<ByteSource>* out) {
+    out->reserve(array->Length());
+    for (uint32_t i = 0; i < array->Length(); i++) {
+      Local<Value> item;
+      if (!array->Get(env->context(), i).ToLocal(&item))
+        return false;
+      if (!IsAnyBufferSource(item)) {
+        THROW_ERR_INVALID_ARG_TYPE(env, "%s[%u] must be a buffer", what, i);
+        return false;
+      }
+      ArrayBufferOrViewContents<char> contents(item);
+      if (!contents.CheckSizeInt32()) [[unlikely]] {
+        THROW_ERR_OUT_OF_RANGE(env, "%s[%u] is too big", what, i);
+        return false;
+      }
+      out->push_back(mode == kCryptoJobAsync ? contents.ToCopy()
+                                             : contents.ToByteSource());
+    }
+    return true;
+  };
+
+  if (!to_byte_sources(args[offset + 3].As<Array>(), "data", &params->data))
+    return Nothing<void>();
+
+  if (params->mode == SignConfiguration::Mode::Verify) {
+    CHECK(args[offset + 4]->IsArray());  // Signatures
+    Local<Array> signatures = args[offset + 4].As<Array>();
+    if (signatures->Length() != params->data.size()) {
+      THROW_ERR_INVALID_ARG_VALUE(
+          env, "signatures must have one entry for each data entry");
+      return Nothing<void>();
+    }
+    if (!to_byte_sources(signatures, "signatures", &params->signatures))
+      return Nothing<void>();
+  }
+
+  return JustVoid();
+}
+
+bool HmacBatchTraits::DeriveBits(Environment* env,
+                                 const HmacBatchConfig& params,
+                                 ByteSource* out,
+                                 CryptoJobMode mode) {
+  size_t count = params.data.size();
+  size_t mac_size = EVP_MD_size(params.digest);
+
+  // Each input starts from a copy of the keyed state, which skips hashing
+  // the padded key again.
+  auto keyed = params.key.NewHmacContext(params.digest);
+  if (!keyed) [[unlikely]] {
+    return false;
+  }
+
+  bool sign = params.mode == SignConfiguration::Mode::Sign;
+  size_t out_size = sign ? count * mac_size : count;
+  // Zero-length outputs still need a distinct allocation.
+  char* results = MallocOpenSSL<char>(std::max<size_t>(out_size, 1));
+  ByteSource result = ByteSource::Allocated(results, out_size);
+
+  auto ctx = HMACCtxPointer::New();
+  unsigned char mac[EVP_MAX_MD_SIZE];
+  for (size_t i = 0; i < count; i++) {
+    if (!HMAC_CTX_copy(ctx.get(), keyed.get())) [[unlikely]] {
+      return false;
+    }
+    ncrypto::Buffer<const void> buffer{
+        .data = params.data[i].data(),
+        .len = params.data[i].size(),
+    };
+    ncrypto::Buffer<void> mac_buf{
+        .data = sign ? results + i * mac_size : reinterpret_cast<char*>(mac),
+        .len = mac_size,
+    };
+    if (!ctx.update(buffer) || !ctx.digestInto(&mac_buf)) [[unlikely]] {
+      return false;
+    }
+    if (!sign) {
+      const ByteSource& signature = params.signatures[i];
+      results[i] = signature.size() == mac_size &&
+                   CRYPTO_memcmp(mac, signature.data(), mac_size) == 0;
+    }
+  }
+
+  *out = std::move(result);
+  return true;
+}
+
+MaybeLocal<Value> HmacBatchTraits::EncodeOutput(Environment* env,
+                                                const HmacBatchConfig& params,
+                                                ByteSource* out) {
+  Isolate* isolate = env->isolate();
+  size_t count = params.data.size();
+  LocalVector<Value> results(isolate, count);
+  switch (params.mode) {
+    case SignConfiguration::Mode::Sign: {
+      size_t mac_size = count > 0 ? out->size() / count : 0;
+      for (size_t i = 0; i < count; i++) {
+        Local<ArrayBuffer> mac = ArrayBuffer::New(isolate, mac_size);
+        memcpy(mac->Data(), out->data<char>() + i * mac_size, mac_size);
+        results[i] = mac;
+      }
+      break;
+    }
+    case SignConfiguration::Mode::Verify:
+      for (size_t i = 0; i < count; i++)
+        results[i] = Boolean::New(isolate, out->data<char>()[i] != 0);
+      break;
+  }
+  return Array::New(isolate, results.data(), results.size());
+}
+
 }  // namespace crypto
 }  // namespace node
@@ -24,6 +24,8 @@ class Hmac : public BaseObject {
 
  protected:
   void HmacInit(const char* hash_type, const char* key, int key_len);
+  // Reuses the keyed HMAC template cached on a secret KeyObject.
+  void HmacInit(const char* hash_type, const KeyObjectData& key);
   bool HmacUpdate(const char* data, size_t len);
 
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -85,6 +87,53 @@ struct HmacTraits final {
 
 using HmacJob = DeriveBitsJob<HmacTraits>;
 
+// Signs or verifies many inputs with the same key and digest in a single
+// threadpool work item, resolving with an array of MACs or of booleans.
+struct HmacBatchConfig final : public MemoryRetainer {
+  CryptoJobMode job_mode;
+  SignConfiguration::Mode mode;
+  KeyObjectData key;
+  std::vector<ByteSource> data;
+  std::vector<ByteSource> signatures;
+  ncrypto::Digest digest;
+
+  HmacBatchConfig() = default;
+
+  explicit HmacBatchConfig(HmacBatchConfig&& other) noexcept;
+
+  HmacBatchConfig& operator=(HmacBatchConfig&& other) noexcept;
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(HmacBatchConfig)
+  SET_SELF_SIZE(HmacBatchConfig)
+};
+
+struct HmacBatchTraits final {
+  using AdditionalParameters = HmacBatchConfig;
+  static constexpr const char* JobName = "HmacBatchJob";
+  static constexpr AsyncWrap::ProviderType Provider =
+      AsyncWrap::PROVIDER_SIGNREQUEST;
+
+  static v8::Maybe<void> AdditionalConfig(
+      CryptoJobMode mode,
+      const v8::FunctionCallbackInfo<v8::Value>& args,
+      unsigned int offset,
+      HmacBatchConfig* params);
+
+  // Writes the MACs back to back into out when signing, one 0/1 byte per
+  // input when verifying.
+  static bool DeriveBits(Environment* env,
+                         const HmacBatchConfig& params,
+                         ByteSource* out,
+                         CryptoJobMode mode);
+
+  static v8::MaybeLocal<v8::Value> EncodeOutput(Environment* env,
+                                                const HmacBatchConfig& params,
+                                                ByteSource* out);
+};
+
+using HmacBatchJob = DeriveBitsJob<HmacBatchTraits>;
+
 }  // namespace crypto
 }  // namespace node
 
@@ -20,9 +20,12 @@
 namespace node {
 
 using ncrypto::BIOPointer;
+using ncrypto::Digest;
 using ncrypto::ECKeyPointer;
 using ncrypto::EVPKeyCtxPointer;
 using ncrypto::EVPKeyPointer;
+using ncrypto::EVPMDCtxPointer;
+using ncrypto::HMACCtxPointer;
 using ncrypto::MarkPopErrorOnReturn;
 using ncrypto::PKCS8Pointer;
 using v8::Array;
@@ -602,6 +605,100 @@ size_t KeyObjectData::GetSymmetricKeySize() const {
   return data_->symmetric_key.size();
 }
 
+HMACCtxPointer KeyObjectData::NewHmacContext(const Digest& md) const {
+  CHECK_EQ(key_type_, kKeyTypeSecret);
+  CHECK(data_);
+  // A secret key is used with one or two digests in practice; the list is
+  // capped so that a caller cycling through digests cannot grow it.
+  static constexpr size_t kMaxHmacTemplates = 4;
+  const EVP_MD* evp_md = md;
+
+  Mutex::ScopedLock lock(data_->templates_mutex);
+  HMACCtxPointer* keyed = nullptr;
+  for (auto& entry : data_->hmac_templates) {
+    if (entry.first == evp_md) {
+      keyed = &entry.second;
+      break;
+    }
+  }
+
+  if (keyed == nullptr) {
+    auto ctx = HMACCtxPointer::New();
+    ncrypto::Buffer<const void> key_buf{
+        .data = data_->symmetric_key.data<char>(),
+        .len = data_->symmetric_key.size(),
+    };
+    if (!ctx || !ctx.init(key_buf, md)) [[unlikely]] {
+      return {};
+    }
+    if (data_->hmac_templates.size() >= kMaxHmacTemplates)
+      data_->hmac_templates.erase(data_->hmac_templates.begin());
+    data_->hmac_templates.emplace_back(evp_md, std::move(ctx));
+    keyed = &data_->hmac_templates.back().second;
+  }
+
+  auto ctx = HMACCtxPointer::New();
+  if (!ctx || !HMAC_CTX_copy(ctx.get(), keyed->get())) [[unlikely]] {
+    return {};
+  }
+  return ctx;
+}
+
+namespace {
+// A key is used with a handful of digest and padding combinations in
+// practice; the lists are capped so that arbitrary combinations cannot
+// grow them.
+constexpr size_t kMaxSignTemplates = 8;
+
+template <typename Pointer, typename Copy>
+Pointer NewFromTemplate(
+    std::vector<std::pair<KeyObjectData::SignContextId, Pointer>>* templates,
+    const KeyObjectData::SignContextId& id,
+    const std::function<bool(Pointer*)>& init,
+    Copy copy) {
+  for (const auto& entry : *templates) {
+    if (entry.first == id) return copy(entry.second);
+  }
+  Pointer prepared;
+  if (!init(&prepared) || !prepared) return {};
+  Pointer result = copy(prepared);
+  // Contexts that cannot be duplicated are used once, as before.
+  if (!result) return prepared;
+  if (templates->size() >= kMaxSignTemplates)
+    templates->erase(templates->begin());
+  templates->emplace_back(id, std::move(prepared));
+  return result;
+}
+}  // namespace
+
+EVPMDCtxPointer KeyObjectData::NewDigestSignContext(
+    const SignContextId& id,
+    const std::function<bool(EVPMDCtxPointer*)>& init) const {
+  CHECK(data_);
+  Mutex::ScopedLock lock(data_->templates_mutex);
+  return NewFromTemplate(
+      &data_->digest_sign_templates,
+      id,
+      init,
+      [](const EVPMDCtxPointer& prepared) {
+        auto ctx = EVPMDCtxPointer::New();
+        if (!ctx || EVP_MD_CTX_copy_ex(ctx.get(), prepared.get()) != 1)
+          return EVPMDCtxPointer();
+        return ctx;
+      });
+}
+
+EVPKeyCtxPointer KeyObjectData::NewSignContext(
+    const SignContextId& id,
+    const std::function<bool(EVPKeyCtxPointer*)>& init) const {
+  CHECK(data_);
+  Mutex::ScopedLock lock(data_->templates_mutex);
+  return NewFromTemplate(
+      &data_->sign_templates, id, init, [](const EVPKeyCtxPointer& prepared) {
+        return EVPKeyCtxPointer(EVP_PKEY_CTX_dup(prepared.get()));
+      });
+}
+
 bool KeyObjectHandle::HasInstance(Environment* env, Local<Value> value) {
   auto t = env->crypto_key_object_handle_constructor();
   return !t.IsEmpty() && t->HasInstance(value);
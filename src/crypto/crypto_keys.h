@@ -59,6 +59,32 @@ class KeyObjectData final : public MemoryRetainer {
   const char* GetSymmetricKey() const;
   size_t GetSymmetricKeySize() const;
 
+  // Returns an HMAC context keyed with this secret key. The key is hashed
+  // into a template context once per digest and later calls copy that
+  // template, so repeated MACs with one key skip the key setup.
+  ncrypto::HMACCtxPointer NewHmacContext(const ncrypto::Digest& md) const;
+
+  // Identifies a signing or verification context prepared for this key.
+  struct SignContextId {
+    enum Kind { kDigestSign, kDigestVerify, kSign, kVerify };
+    Kind kind;
+    const EVP_MD* md;
+    int padding;
+    std::optional<int> salt_length;
+    bool operator==(const SignContextId& other) const = default;
+  };
+
+  // Return a copy of the context identified by id, which init prepares
+  // (EVP_DigestSignInit() or EVP_PKEY_sign_init(), padding, digest) on first
+  // use. Later calls skip the algorithm fetch and parameter setup. If init
+  // fails its result is not cached and an empty pointer is returned.
+  ncrypto::EVPMDCtxPointer NewDigestSignContext(
+      const SignContextId& id,
+      const std::function<bool(ncrypto::EVPMDCtxPointer*)>& init) const;
+  ncrypto::EVPKeyCtxPointer NewSignContext(
+      const SignContextId& id,
+      const std::function<bool(ncrypto::EVPKeyCtxPointer*)>& init) const;
+
   void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(KeyObjectData)
   SET_SELF_SIZE(KeyObjectData)
@@ -117,6 +143,14 @@ class KeyObjectData final : public MemoryRetainer {
   struct Data {
     const ByteSource symmetric_key;
     const ncrypto::EVPKeyPointer asymmetric_key;
+    // Prepared contexts, see NewHmacContext() and NewSignContext().
+    mutable Mutex templates_mutex;
+    mutable std::vector<std::pair<const EVP_MD*, ncrypto::HMACCtxPointer>>
+        hmac_templates;
+    mutable std::vector<std::pair<SignContextId, ncrypto::EVPMDCtxPointer>>
+        digest_sign_templates;
+    mutable std::vector<std::pair<SignContextId, ncrypto::EVPKeyCtxPointer>>
+        sign_templates;
     explicit Data(ByteSource symmetric_key)
         : symmetric_key(std::move(symmetric_key)) {}
     explicit Data(ncrypto::EVPKeyPointer asymmetric_key)
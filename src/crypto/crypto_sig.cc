@@ -79,9 +79,10 @@ bool ApplyRSAOptions(const EVPKeyPointer& pkey,
 
 std::unique_ptr<BackingStore> Node_SignFinal(Environment* env,
                                              EVPMDCtxPointer&& mdctx,
-                                             const EVPKeyPointer& pkey,
+                                             const KeyObjectData& key,
                                              int padding,
                                              std::optional<int> pss_salt_len) {
+  const EVPKeyPointer& pkey = key.GetAsymmetricKey();
   auto data = mdctx.digestFinal(mdctx.getExpectedSize());
   if (!data) [[unlikely]]
     return nullptr;
@@ -92,11 +93,18 @@ std::unique_ptr<BackingStore> Node_SignFinal(Environment* env,
       .len = pkey.size(),
   };
 
-  EVPKeyCtxPointer pkctx = pkey.newCtx();
-  if (pkctx.initForSign() > 0 &&
-      ApplyRSAOptions(pkey, pkctx.get(), padding, pss_salt_len) &&
-      pkctx.setSignatureMd(mdctx) && pkctx.signInto(data, &sig_buf))
-      [[likely]] {
+  KeyObjectData::SignContextId id{KeyObjectData::SignContextId::kSign,
+                                  mdctx.getDigest(),
+                                  padding,
+                                  pss_salt_len};
+  EVPKeyCtxPointer pkctx =
+      key.NewSignContext(id, [&](EVPKeyCtxPointer* prepared) {
+        *prepared = pkey.newCtx();
+        return prepared->initForSign() > 0 &&
+               ApplyRSAOptions(pkey, prepared->get(), padding, pss_salt_len) &&
+               prepared->setSignatureMd(mdctx);
+      });
+  if (pkctx && pkctx.signInto(data, &sig_buf)) [[likely]] {
     CHECK_LE(sig_buf.len, sig->ByteLength());
     if (sig_buf.len < sig->ByteLength()) {
       auto new_sig = ArrayBuffer::NewBackingStore(
@@ -368,7 +376,7 @@ void Sign::SignUpdate(const FunctionCallbackInfo<Value>& args) {
   });
 }
 
-Sign::SignResult Sign::SignFinal(const EVPKeyPointer& pkey,
+Sign::SignResult Sign::SignFinal(const KeyObjectData& key,
                                  int padding,
                                  std::optional<int> salt_len,
                                  DSASigEnc dsa_sig_enc) {
@@ -377,13 +385,14 @@ Sign::SignResult Sign::SignFinal(const EVPKeyPointer& pkey,
   }
 
   EVPMDCtxPointer mdctx = std::move(mdctx_);
+  const EVPKeyPointer& pkey = key.GetAsymmetricKey();
 
   if (!pkey.validateDsaParameters()) {
     return SignResult(Error::PrivateKey);
   }
 
   auto buffer =
-      Node_SignFinal(env(), std::move(mdctx), pkey, padding, salt_len);
+      Node_SignFinal(env(), std::move(mdctx), key, padding, salt_len);
   Error error = buffer ? Error::Ok : Error::PrivateKey;
   if (error == Error::Ok && dsa_sig_enc == DSASigEnc::P1363) {
     buffer = ConvertSignatureToP1363(env(), pkey, std::move(buffer));
@@ -420,7 +429,7 @@ void Sign::SignFinal(const FunctionCallbackInfo<Value>& args) {
     return;
   }
 
-  SignResult ret = sign->SignFinal(key, padding, salt_len, dsa_sig_enc);
+  SignResult ret = sign->SignFinal(data, padding, salt_len, dsa_sig_enc);
 
   if (ret.error != Error::Ok) [[unlikely]] {
     return crypto::CheckThrow(env, ret.error);
@@ -480,7 +489,7 @@ void Verify::VerifyUpdate(const FunctionCallbackInfo<Value>& args) {
   });
 }
 
-SignBase::Error Verify::VerifyFinal(const EVPKeyPointer& pkey,
+SignBase::Error Verify::VerifyFinal(const KeyObjectData& key,
                                     const ByteSource& sig,
                                     int padding,
                                     std::optional<int> saltlen,
@@ -495,15 +504,26 @@ SignBase::Error Verify::VerifyFinal(const EVPKeyPointer& pkey,
   if (!data) [[unlikely]]
     return Error::PublicKey;
 
-  EVPKeyCtxPointer pkctx = pkey.newCtx();
+  const EVPKeyPointer& pkey = key.GetAsymmetricKey();
+  int init_ret = 0;
+  KeyObjectData::SignContextId id{KeyObjectData::SignContextId::kVerify,
+                                  mdctx.getDigest(),
+                                  padding,
+                                  saltlen};
+  EVPKeyCtxPointer pkctx =
+      key.NewSignContext(id, [&](EVPKeyCtxPointer* prepared) {
+        *prepared = pkey.newCtx();
+        if (!*prepared) [[unlikely]]
+          return false;
+        init_ret = prepared->initForVerify();
+        return init_ret > 0 &&
+               ApplyRSAOptions(pkey, prepared->get(), padding, saltlen) &&
+               prepared->setSignatureMd(mdctx);
+      });
+  if (init_ret == -2) [[unlikely]]
+    return Error::PublicKey;
   if (pkctx) [[likely]] {
-    const int init_ret = pkctx.initForVerify();
-    if (init_ret == -2) [[unlikely]]
-      return Error::PublicKey;
-    if (init_ret > 0 && ApplyRSAOptions(pkey, pkctx.get(), padding, saltlen) &&
-        pkctx.setSignatureMd(mdctx)) {
-      *verify_result = pkctx.verify(sig, data);
-    }
+    *verify_result = pkctx.verify(sig, data);
   }
 
   return Error::Ok;
@@ -552,7 +572,7 @@ void Verify::VerifyFinal(const FunctionCallbackInfo<Value>& args) {
 
   bool verify_result;
   Error err =
-      verify->VerifyFinal(key, signature, padding, salt_len, &verify_result);
+      verify->VerifyFinal(data, signature, padding, salt_len, &verify_result);
   if (err != Error::Ok) [[unlikely]]
     return crypto::CheckThrow(env, err);
   args.GetReturnValue().Set(verify_result);
@@ -690,9 +710,7 @@ bool SignTraits::DeriveBits(Environment* env,
                             ByteSource* out,
                             CryptoJobMode mode) {
   bool can_throw = mode == CryptoJobMode::kCryptoJobSync;
-  auto context = EVPMDCtxPointer::New();
-  if (!context) [[unlikely]]
-    return false;
+  EVPMDCtxPointer context;
   const auto& key = params.key.GetAsymmetricKey();
 
   bool has_context = (params.flags & SignConfiguration::kHasContextString &&
@@ -703,35 +721,6 @@ bool SignTraits::DeriveBits(Environment* env,
     return false;
   }
 
-  auto ctx = ([&] {
-    if (has_context) {
-      ncrypto::Buffer<const unsigned char> context_buf{
-          .data = params.context_string.data<unsigned char>(),
-          .len = params.context_string.size(),
-      };
-
-      switch (params.mode) {
-        case SignConfiguration::Mode::Sign:
-          return context.signInitWithContext(key, params.digest, context_buf);
-        case SignConfiguration::Mode::Verify:
-          return context.verifyInitWithContext(key, params.digest, context_buf);
-      }
-    } else {
-      switch (params.mode) {
-        case SignConfiguration::Mode::Sign:
-          return context.signInit(key, params.digest);
-        case SignConfiguration::Mode::Verify:
-          return context.verifyInit(key, params.digest);
-      }
-    }
-    UNREACHABLE();
-  })();
-
-  if (!ctx.has_value()) [[unlikely]] {
-    if (can_throw) crypto::CheckThrow(env, SignBase::Error::Init);
-    return false;
-  }
-
   int padding = params.flags & SignConfiguration::kHasPadding
                     ? params.padding
                     : key.getDefaultSignPadding();
@@ -741,9 +730,76 @@ bool SignTraits::DeriveBits(Environment* env,
           ? std::optional<int>(params.salt_length)
           : std::nullopt;
 
-  if (!ApplyRSAOptions(key, *ctx, padding, salt_length)) {
-    if (can_throw) crypto::CheckThrow(env, SignBase::Error::PrivateKey);
-    return false;
+  // Keys are typically used for many operations with the same parameters,
+  // so the initialized context is prepared once per key and copied.
+  // Contexts with a context string, which is per operation, and one-shot
+  // algorithms, whose setup is cheap, are initialized every time.
+  if (!has_context && !key.isOneShotVariant()) {
+    using SignContextId = KeyObjectData::SignContextId;
+    SignBase::Error error = SignBase::Error::Init;
+    SignContextId id{params.mode == SignConfiguration::Mode::Sign
+                         ? SignContextId::kDigestSign
+                         : SignContextId::kDigestVerify,
+                     params.digest,
+                     padding,
+                     salt_length};
+    context = params.key.NewDigestSignContext(
+        id, [&](EVPMDCtxPointer* prepared) {
+          *prepared = EVPMDCtxPointer::New();
+          if (!*prepared) [[unlikely]]
+            return false;
+          auto pkctx = params.mode == SignConfiguration::Mode::Sign
+                           ? prepared->signInit(key, params.digest)
+                           : prepared->verifyInit(key, params.digest);
+          if (!pkctx.has_value()) [[unlikely]]
+            return false;
+          error = SignBase::Error::PrivateKey;
+          return ApplyRSAOptions(key, *pkctx, padding, salt_length);
+        });
+    if (!context) [[unlikely]] {
+      if (can_throw) crypto::CheckThrow(env, error);
+      return false;
+    }
+  } else {
+    context = EVPMDCtxPointer::New();
+    if (!context) [[unlikely]]
+      return false;
+
+    auto ctx = ([&] {
+      if (has_context) {
+        ncrypto::Buffer<const unsigned char> context_buf{
+            .data = params.context_string.data<unsigned char>(),
+            .len = params.context_string.size(),
+        };
+
+        switch (params.mode) {
+          case SignConfiguration::Mode::Sign:
+            return context.signInitWithContext(
+                key, params.digest, context_buf);
+          case SignConfiguration::Mode::Verify:
+            return context.verifyInitWithContext(
+                key, params.digest, context_buf);
+        }
+      } else {
+        switch (params.mode) {
+          case SignConfiguration::Mode::Sign:
+            return context.signInit(key, params.digest);
+          case SignConfiguration::Mode::Verify:
+            return context.verifyInit(key, params.digest);
+        }
+      }
+      UNREACHABLE();
+    })();
+
+    if (!ctx.has_value()) [[unlikely]] {
+      if (can_throw) crypto::CheckThrow(env, SignBase::Error::Init);
+      return false;
+    }
+
+    if (!ApplyRSAOptions(key, *ctx, padding, salt_length)) {
+      if (can_throw) crypto::CheckThrow(env, SignBase::Error::PrivateKey);
+      return false;
+    }
   }
 
   switch (params.mode) {
@@ -57,7 +57,7 @@ class Sign final : public SignBase {
         : error(err), signature(std::move(sig)) {}
   };
 
-  SignResult SignFinal(const ncrypto::EVPKeyPointer& pkey,
+  SignResult SignFinal(const KeyObjectData& key,
                        int padding,
                        std::optional<int> saltlen,
                        DSASigEnc dsa_sig_enc);
@@ -78,7 +78,7 @@ class Verify final : public SignBase {
   static void Initialize(Environment* env, v8::Local<v8::Object> target);
   static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
 
-  Error VerifyFinal(const ncrypto::EVPKeyPointer& key,
+  Error VerifyFinal(const KeyObjectData& key,
                     const ByteSource& sig,
                     int padding,
                     std::optional<int> saltlen,
@@ -847,6 +847,12 @@ void TLSWrap::ClearOut() {
     Local<Value> error;
     int err = SSL_get_error(ssl_.get(), read);
     switch (err) {
+#ifdef SSL_MODE_ASYNC
+      case SSL_ERROR_WANT_ASYNC:
+        WaitForAsyncJob();
+        return;
+#endif  // SSL_MODE_ASYNC
+
       case SSL_ERROR_ZERO_RETURN:
         if (!eof_) {
           eof_ = true;
@@ -929,6 +935,7 @@ void TLSWrap::ClearIn() {
   MarkPopErrorOnReturn mark_pop_error_on_return;
 
   NodeBIO::FromBIO(enc_out_)->set_allocate_tls_hint(bs->ByteLength());
+  UpdateRecordSize(bs->ByteLength());
   int written = SSL_write(ssl_.get(), bs->Data(), bs->ByteLength());
   Debug(this, "Writing %zu bytes, written = %d", bs->ByteLength(), written);
   CHECK(written == -1 || written == static_cast<int>(bs->ByteLength()));
@@ -950,6 +957,10 @@ void TLSWrap::ClearIn() {
     return;
   }
 
+#ifdef SSL_MODE_ASYNC
+  if (err == SSL_ERROR_WANT_ASYNC) WaitForAsyncJob();
+#endif  // SSL_MODE_ASYNC
+
   Debug(this, "Pushing data back");
   // Push back the not-yet-written data. This can be skipped in the error
   // case because no further writes would succeed anyway.
@@ -1097,11 +1108,13 @@ int TLSWrap::DoWrite(WriteWrap* w,
     }
 
     NodeBIO::FromBIO(enc_out_)->set_allocate_tls_hint(length);
+    UpdateRecordSize(length);
     written = SSL_write(ssl_.get(), bs->Data(), length);
   } else {
     // Only one buffer: try to write directly, only store if it fails
     uv_buf_t* buf = &bufs[nonempty_i];
     NodeBIO::FromBIO(enc_out_)->set_allocate_tls_hint(buf->len);
+    UpdateRecordSize(buf->len);
     written = SSL_write(ssl_.get(), buf->base, buf->len);
 
     if (written == -1) {
@@ -1126,6 +1139,10 @@ int TLSWrap::DoWrite(WriteWrap* w,
       return UV_EPROTO;
     }
 
+#ifdef SSL_MODE_ASYNC
+    if (err == SSL_ERROR_WANT_ASYNC) WaitForAsyncJob();
+#endif  // SSL_MODE_ASYNC
+
     Debug(this, "Saving data for later write");
     // Otherwise, save unwritten data so it can be written later by ClearIn().
     CHECK(!pending_cleartext_input_ ||
@@ -1318,6 +1335,9 @@ void TLSWrap::Destroy() {
   InvokeQueued(UV_ECANCELED, "Canceled because of SSL destruction");
 
   env()->external_memory_accounter()->Decrease(env()->isolate(), kExternalSize);
+#ifdef SSL_MODE_ASYNC
+  CloseAsyncPoll();
+#endif  // SSL_MODE_ASYNC
   ssl_.reset();
 
   enc_in_ = nullptr;
@@ -2133,6 +2153,82 @@ void TLSWrap::WritesIssuedByPrevListenerDone(
   w->EncOut();  // resume all of our restrained writes
 }
 
+#ifdef SSL_MODE_ASYNC
+void TLSWrap::EnableAsyncMode(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.This());
+  if (!wrap->ssl_) return;
+  // A paused SSL_write() is retried from pending_cleartext_input_, which
+  // is not the buffer the first attempt was made with.
+  SSL_set_mode(wrap->ssl_.get(),
+               SSL_MODE_ASYNC | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+}
+
+void TLSWrap::WaitForAsyncJob() {
+  if (async_job_pending_) return;
+  async_job_pending_ = true;
+
+  size_t count = 0;
+  std::vector<OSSL_ASYNC_FD> fds;
+  if (SSL_get_all_async_fds(ssl_.get(), nullptr, &count) && count > 0) {
+    fds.resize(count);
+    SSL_get_all_async_fds(ssl_.get(), fds.data(), &count);
+  }
+
+#ifndef _WIN32
+  // With several fds, waiting for the first is enough: the retry fails with
+  // SSL_ERROR_WANT_ASYNC again while the others are still busy.
+  if (!fds.empty()) {
+    if (async_poll_ != nullptr && async_fd_ != fds[0]) CloseAsyncPoll();
+    if (async_poll_ == nullptr) {
+      async_poll_ = new uv_poll_t;
+      if (uv_poll_init(env()->event_loop(), async_poll_, fds[0]) != 0) {
+        delete async_poll_;
+        async_poll_ = nullptr;
+      } else {
+        async_poll_->data = this;
+        async_fd_ = fds[0];
+      }
+    }
+    if (async_poll_ != nullptr) {
+      Debug(this, "Waiting for async job on fd %d", async_fd_);
+      uv_poll_start(async_poll_, UV_READABLE, [](uv_poll_t* handle, int, int) {
+        uv_poll_stop(handle);
+        static_cast<TLSWrap*>(handle->data)->OnAsyncJobReady();
+      });
+      return;
+    }
+  }
+#endif  // !_WIN32
+
+  // Jobs without a pollable wait fd complete without notification, so
+  // retry on the next loop iteration.
+  Debug(this, "Retrying async job on the next tick");
+  env()->SetImmediate([wrap = BaseObjectPtr<TLSWrap>(this)](Environment*) {
+    wrap->OnAsyncJobReady();
+  });
+}
+
+void TLSWrap::OnAsyncJobReady() {
+  async_job_pending_ = false;
+  if (!ssl_) return;
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  InternalCallbackScope callback_scope(this);
+  Cycle();
+}
+
+void TLSWrap::CloseAsyncPoll() {
+  if (async_poll_ == nullptr) return;
+  async_poll_->data = nullptr;
+  uv_close(reinterpret_cast<uv_handle_t*>(async_poll_), [](uv_handle_t* h) {
+    delete reinterpret_cast<uv_poll_t*>(h);
+  });
+  async_poll_ = nullptr;
+  async_fd_ = OSSL_BAD_ASYNC_FD;
+}
+#endif  // SSL_MODE_ASYNC
+
 void TLSWrap::Cycle() {
   // Prevent recursion
   if (++cycle_depth_ > 1)
@@ -2155,11 +2251,45 @@ void TLSWrap::SetMaxSendFragment(const FunctionCallbackInfo<Value>& args) {
   int val;
   if (args[0]->Int32Value(env->context()).To(&val)) {
     int32_t ret = SSL_set_max_send_fragment(w->ssl_.get(), val);
+    // An explicit fragment size takes precedence over dynamic sizing.
+    if (ret == 1) w->dynamic_record_sizing_ = false;
     args.GetReturnValue().Set(ret);
   }
 }
+
+void TLSWrap::EnableDynamicRecordSizing(
+    const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* w;
+  ASSIGN_OR_RETURN_UNWRAP(&w, args.This());
+  w->dynamic_record_sizing_ = true;
+}
 #endif  // SSL_set_max_send_fragment
 
+void TLSWrap::UpdateRecordSize(size_t length) {
+#ifdef SSL_set_max_send_fragment
+  if (!dynamic_record_sizing_ || !ssl_) return;
+
+  // After an idle period the congestion window has likely collapsed, so
+  // start over with small records.
+  uint64_t now = uv_now(env()->event_loop());
+  if (now - last_record_write_ms_ > kRecordSizeIdleResetMs)
+    record_bytes_since_idle_ = 0;
+  last_record_write_ms_ = now;
+
+  // The size only changes between SSL_write() calls, so a write that would
+  // cross the threshold uses full records right away.
+  record_bytes_since_idle_ += length;
+  size_t record_size = record_bytes_since_idle_ <= kRecordSizeBoostThreshold
+                           ? kSmallRecordSize
+                           : kMaxRecordSize;
+  if (record_size != record_size_ &&
+      SSL_set_max_send_fragment(ssl_.get(), record_size) == 1) {
+    Debug(this, "Using %zu byte records", record_size);
+    record_size_ = record_size;
+  }
+#endif  // SSL_set_max_send_fragment
+}
+
 void TLSWrap::Initialize(
     Local<Object> target,
     Local<Value> unused,
@@ -2199,6 +2329,9 @@ void TLSWrap::Initialize(
   SetProtoMethod(isolate, t, "enableKeylogCallback", EnableKeylogCallback);
   SetProtoMethod(isolate, t, "enableSessionCallbacks", EnableSessionCallbacks);
   SetProtoMethod(isolate, t, "enableTrace", EnableTrace);
+#ifdef SSL_MODE_ASYNC
+  SetProtoMethod(isolate, t, "enableAsyncMode", EnableAsyncMode);
+#endif  // SSL_MODE_ASYNC
   SetProtoMethod(isolate, t, "getServername", GetServername);
   SetProtoMethod(isolate, t, "loadSession", LoadSession);
   SetProtoMethod(isolate, t, "newSessionDone", NewSessionDone);
@@ -2242,6 +2375,8 @@ void TLSWrap::Initialize(
 
 #ifdef SSL_set_max_send_fragment
   SetProtoMethod(isolate, t, "setMaxSendFragment", SetMaxSendFragment);
+  SetProtoMethod(
+      isolate, t, "enableDynamicRecordSizing", EnableDynamicRecordSizing);
 #endif  // SSL_set_max_send_fragment
 
 #ifndef OPENSSL_NO_PSK
@@ -2270,6 +2405,9 @@ void TLSWrap::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(EnableKeylogCallback);
   registry->Register(EnableSessionCallbacks);
   registry->Register(EnableTrace);
+#ifdef SSL_MODE_ASYNC
+  registry->Register(EnableAsyncMode);
+#endif  // SSL_MODE_ASYNC
   registry->Register(GetServername);
   registry->Register(LoadSession);
   registry->Register(NewSessionDone);
@@ -2302,6 +2440,7 @@ void TLSWrap::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
 
 #ifdef SSL_set_max_send_fragment
   registry->Register(SetMaxSendFragment);
+  registry->Register(EnableDynamicRecordSizing);
 #endif  // SSL_set_max_send_fragment
 
 #ifndef OPENSSL_NO_PSK
@@ -126,6 +126,16 @@ class TLSWrap : public AsyncWrap,
   // Maximum number of buffers passed to uv_write()
   static constexpr int kSimultaneousBufferCount = 10;
 
+  // Dynamic record sizing: until kRecordSizeBoostThreshold cleartext bytes
+  // have been written since the connection was last idle for
+  // kRecordSizeIdleResetMs, writes use records of kSmallRecordSize, which
+  // fit into a single TCP segment and can be decrypted as soon as it
+  // arrives. Later writes use full kMaxRecordSize records.
+  static constexpr size_t kSmallRecordSize = 1300;
+  static constexpr size_t kMaxRecordSize = 16384;
+  static constexpr size_t kRecordSizeBoostThreshold = 128 * 1024;
+  static constexpr uint64_t kRecordSizeIdleResetMs = 1000;
+
   typedef void (*CertCb)(void* arg);
 
   // Alternative to StreamListener::stream(), that returns a StreamBase instead
@@ -229,8 +239,23 @@ class TLSWrap : public AsyncWrap,
 #ifdef SSL_set_max_send_fragment
   static void SetMaxSendFragment(
       const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableDynamicRecordSizing(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
 #endif  // SSL_set_max_send_fragment
 
+  // Picks the record size before `length` cleartext bytes go to SSL_write().
+  void UpdateRecordSize(size_t length);
+
+#ifdef SSL_MODE_ASYNC
+  // Async mode lets an engine or provider (e.g. QAT) pause a private key
+  // operation: SSL_read()/SSL_write() then fail with SSL_ERROR_WANT_ASYNC
+  // and the operation is resumed once the job's wait fd becomes readable.
+  static void EnableAsyncMode(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void WaitForAsyncJob();
+  void OnAsyncJobReady();
+  void CloseAsyncPoll();
+#endif  // SSL_MODE_ASYNC
+
 #ifndef OPENSSL_NO_PSK
   static void EnablePskCallback(
       const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -286,6 +311,17 @@ class TLSWrap : public AsyncWrap,
 
   int cycle_depth_ = 0;
 
+  bool dynamic_record_sizing_ = false;
+  size_t record_size_ = kMaxRecordSize;
+  size_t record_bytes_since_idle_ = 0;
+  uint64_t last_record_write_ms_ = 0;
+
+#ifdef SSL_MODE_ASYNC
+  bool async_job_pending_ = false;
+  uv_poll_t* async_poll_ = nullptr;
+  OSSL_ASYNC_FD async_fd_ = OSSL_BAD_ASYNC_FD;
+#endif  // SSL_MODE_ASYNC
+
   // SSL_set_cert_cb
   CertCb cert_cb_ = nullptr;
   void* cert_cb_arg_ = nullptr;
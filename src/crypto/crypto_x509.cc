@@ -38,6 +38,7 @@ using v8::EscapableHandleScope;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::Global;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
@@ -765,33 +766,72 @@ MaybeLocal<Object> X509ToObject(Environment* env, const X509View& cert) {
     env->set_x509_dictionary_template(tmpl);
   }
 
+  // Servers with client certificates see the same few certificates on
+  // every connection, so the fields that are strings, numbers or booleans,
+  // which JS cannot mutate, are cached by SHA-256 fingerprint. Objects and
+  // buffers are created anew for every call.
+  static constexpr size_t kCachedFields[] = {
+      2, 3, 4, 5, 6, 8, 9, 10, 11, 13, 15, 17, 18};
+  static constexpr size_t kMaxCachedCertificates = 128;
+
+  auto fingerprint256 = cert.getFingerprint(Digest::SHA256);
+  Environment::X509FieldCacheEntry* cached = nullptr;
+  if (fingerprint256.has_value()) {
+    auto it = env->x509_field_cache_index.find(*fingerprint256);
+    if (it != env->x509_field_cache_index.end()) {
+      env->x509_field_cache.splice(
+          env->x509_field_cache.begin(), env->x509_field_cache, it->second);
+      cached = &env->x509_field_cache.front();
+    }
+  }
+
   MaybeLocal<Value> values[] = {
       GetX509NameObject(env, cert.getSubjectName()),
       GetX509NameObject(env, cert.getIssuerName()),
-      GetSubjectAltNameString(env, cert),
-      GetInfoAccessString(env, cert),
-      Boolean::New(env->isolate(), cert.isCA()),
+      Undefined(env->isolate()),  // subjectaltname
+      Undefined(env->isolate()),  // infoAccess
+      Undefined(env->isolate()),  // ca
       Undefined(env->isolate()),  // modulus
       Undefined(env->isolate()),  // exponent
       Undefined(env->isolate()),  // pubkey
       Undefined(env->isolate()),  // bits
-      GetValidFrom(env, cert),
-      GetValidTo(env, cert),
-      GetFingerprintDigest(env, Digest::SHA1, cert),
-      GetFingerprintDigest(env, Digest::SHA256, cert),
-      GetFingerprintDigest(env, Digest::SHA512, cert),
+      Undefined(env->isolate()),  // valid_from
+      Undefined(env->isolate()),  // valid_to
+      Undefined(env->isolate()),  // fingerprint
+      Undefined(env->isolate()),  // fingerprint256
+      Undefined(env->isolate()),  // fingerprint512
       GetKeyUsage(env, cert),
-      GetSerialNumber(env, cert),
+      Undefined(env->isolate()),  // serialNumber
       GetDer(env, cert),
       Undefined(env->isolate()),  // asn1curve
       Undefined(env->isolate()),  // nistcurve
   };
 
+  if (fingerprint256.has_value()) {
+    values[12] = OneByteString(
+        env->isolate(), fingerprint256->data(), fingerprint256->length());
+  }
+
+  if (cached != nullptr) {
+    for (size_t i = 0; i < arraysize(kCachedFields); i++)
+      values[kCachedFields[i]] = cached->second[i].Get(env->isolate());
+  } else {
+    values[2] = GetSubjectAltNameString(env, cert);
+    values[3] = GetInfoAccessString(env, cert);
+    values[4] = Boolean::New(env->isolate(), cert.isCA());
+    values[9] = GetValidFrom(env, cert);
+    values[10] = GetValidTo(env, cert);
+    values[11] = GetFingerprintDigest(env, Digest::SHA1, cert);
+    values[13] = GetFingerprintDigest(env, Digest::SHA512, cert);
+    values[15] = GetSerialNumber(env, cert);
+  }
+
   cert.ifRsa([&](const ncrypto::Rsa& rsa) {
     auto pub_key = rsa.getPublicKey();
+    values[7] = GetPubKey(env, rsa);  // pubkey
+    if (cached != nullptr) return true;
     values[5] = GetModulusString(env, pub_key.n);   // modulus
     values[6] = GetExponentString(env, pub_key.e);  // exponent
-    values[7] = GetPubKey(env, rsa);                // pubkey
     values[8] = Integer::New(env->isolate(),
                              BignumPointer::GetBitCount(pub_key.n));  // bits
     // TODO(@jasnell): The true response is a left-over from the original
@@ -802,7 +842,8 @@ MaybeLocal<Object> X509ToObject(Environment* env, const X509View& cert) {
   cert.ifEc([&](const ncrypto::Ec& ec) {
     const auto group = ec.getGroup();
     values[7] = GetECPubKey(env, group, ec);  // pubkey
-    values[8] = GetECGroupBits(env, group);   // bits
+    if (cached != nullptr) return true;
+    values[8] = GetECGroupBits(env, group);  // bits
     const int nid = ec.getCurve();
     if (nid != 0) {
       // Curve is well-known, get its OID and NIST nick-name (if it has
@@ -816,6 +857,31 @@ MaybeLocal<Object> X509ToObject(Environment* env, const X509View& cert) {
     return true;
   });
 
+  if (cached == nullptr && fingerprint256.has_value()) {
+    std::vector<Global<Value>> fields;
+    fields.reserve(arraysize(kCachedFields));
+    for (size_t index : kCachedFields) {
+      Local<Value> value;
+      // Failed conversions leave a pending exception; don't cache those.
+      if (!values[index].ToLocal(&value)) {
+        fields.clear();
+        break;
+      }
+      CHECK(!value->IsObject());
+      fields.emplace_back(env->isolate(), value);
+    }
+    if (!fields.empty()) {
+      if (env->x509_field_cache.size() >= kMaxCachedCertificates) {
+        env->x509_field_cache_index.erase(env->x509_field_cache.back().first);
+        env->x509_field_cache.pop_back();
+      }
+      env->x509_field_cache.emplace_front(std::move(*fingerprint256),
+                                          std::move(fields));
+      env->x509_field_cache_index.emplace(env->x509_field_cache.front().first,
+                                          env->x509_field_cache.begin());
+    }
+  }
+
   return scope.EscapeMaybe(NewDictionaryInstance(env->context(), tmpl, values));
 }
 }  // namespace
@@ -13,13 +13,23 @@
 #include <uv.h>
 #include <v8.h>
 #include <algorithm>
+#include <climits>
 #include <deque>
 #include <initializer_list>
+#include <limits>
 #include <memory>
+#include <string>
 #include <vector>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace node {
 
+using v8::ArrayBuffer;
 using v8::ArrayBufferView;
 using v8::BackingStore;
 using v8::Local;
@@ -107,6 +117,11 @@ class DataQueueImpl final : public DataQueue,
 
   bool is_idempotent() const override { return idempotent_; }
 
+  std::unique_ptr<BackingStore> ToBackingStore() override {
+    if (!idempotent_ || entries_.size() != 1) return nullptr;
+    return entries_[0]->ToBackingStore();
+  }
+
   bool is_capped() const override { return capped_size_.has_value(); }
 
   std::optional<bool> append(std::unique_ptr<Entry> entry) override {
@@ -646,8 +661,10 @@ class InMemoryEntry final : public EntryImpl {
 
   InMemoryEntry(std::shared_ptr<BackingStore> backing_store,
                 uint64_t offset,
-                uint64_t byte_length)
+                uint64_t byte_length,
+                std::shared_ptr<void> retainer = nullptr)
       : backing_store_(std::move(backing_store)),
+        retainer_(std::move(retainer)),
         offset_(offset),
         byte_length_(byte_length) {
     // The offset_ + byte_length_ cannot extend beyond the size of the
@@ -674,7 +691,8 @@ class InMemoryEntry final : public EntryImpl {
         return std::make_unique<EmptyEntry>();
       }
 
-      return std::make_unique<InMemoryEntry>(backing_store_, start, len);
+      return std::make_unique<InMemoryEntry>(
+          backing_store_, start, len, retainer_);
     };
 
     start += offset_;
@@ -709,6 +727,7 @@ class InMemoryEntry final : public EntryImpl {
 
  private:
   std::shared_ptr<BackingStore> backing_store_;
+  std::shared_ptr<void> retainer_;
   uint64_t offset_;
   uint64_t byte_length_;
 
@@ -800,6 +819,186 @@ class DataQueueEntry : public EntryImpl {
 
 // ============================================================================
 
+// An entry that passes the contents of a DataQueue through a Transform as
+// it is read. Since the Transform is stateful the entry can only be read
+// once, and so is never idempotent.
+class TransformEntry final : public EntryImpl {
+ public:
+  TransformEntry(std::shared_ptr<DataQueue> data_queue,
+                 std::unique_ptr<DataQueue::Transform> transform)
+      : data_queue_(std::move(data_queue)),
+        transform_(std::move(transform)),
+        size_(transform_->size(data_queue_->size())) {}
+
+  // Disallow moving and copying.
+  TransformEntry(const TransformEntry&) = delete;
+  TransformEntry(TransformEntry&&) = delete;
+  TransformEntry& operator=(const TransformEntry&) = delete;
+  TransformEntry& operator=(TransformEntry&&) = delete;
+
+  std::shared_ptr<DataQueue::Reader> get_reader() override {
+    if (!transform_) return nullptr;
+    std::shared_ptr<DataQueue::Reader> inner = data_queue_->get_reader();
+    if (!inner) return nullptr;
+    return std::make_shared<ReaderImpl>(std::move(inner),
+                                        std::move(transform_));
+  }
+
+  std::unique_ptr<Entry> slice(
+      uint64_t start, std::optional<uint64_t> end = std::nullopt) override {
+    return nullptr;
+  }
+
+  std::optional<uint64_t> size() const override { return size_; }
+
+  bool is_idempotent() const override { return false; }
+
+  void MemoryInfo(node::MemoryTracker* tracker) const override {
+    tracker->TrackField(
+        "data_queue", data_queue_, "std::shared_ptr<DataQueue>");
+  }
+
+  SET_MEMORY_INFO_NAME(TransformEntry)
+  SET_SELF_SIZE(TransformEntry)
+
+ private:
+  std::shared_ptr<DataQueue> data_queue_;
+  std::unique_ptr<DataQueue::Transform> transform_;
+  const std::optional<uint64_t> size_;
+
+  class ReaderImpl : public DataQueue::Reader,
+                     public std::enable_shared_from_this<ReaderImpl> {
+   public:
+    using Buffer = std::shared_ptr<std::vector<uint8_t>>;
+
+    // Output buffers handed back by the consumer are reused for later
+    // chunks, as long as they are not unusually large.
+    static constexpr size_t kMaxPooledBuffers = 4;
+    static constexpr size_t kMaxPooledBufferSize = 256 * 1024;
+
+    ReaderImpl(std::shared_ptr<DataQueue::Reader> inner,
+               std::unique_ptr<DataQueue::Transform> transform)
+        : inner_(std::move(inner)), transform_(std::move(transform)) {}
+
+    int Pull(DataQueue::Reader::Next next,
+             int options,
+             DataQueue::Vec* data,
+             size_t count,
+             size_t max_count_hint) override {
+      auto self = shared_from_this();
+      if (ended_) {
+        std::move(next)(bob::Status::STATUS_EOS, nullptr, 0, [](uint64_t) {});
+        return bob::Status::STATUS_EOS;
+      }
+
+      // The transformed output always goes into our own buffers, so the
+      // buffers the consumer may have offered are not passed along.
+      delivered_status_ = std::nullopt;
+      int status = inner_->Pull(
+          [this, self, next = std::move(next)](int status,
+                                               const DataQueue::Vec* vecs,
+                                               size_t count,
+                                               Done done) mutable {
+            delivered_status_ = OnData(
+                std::move(next), status, vecs, count, std::move(done));
+          },
+          options,
+          nullptr,
+          0,
+          max_count_hint);
+      return delivered_status_.value_or(status);
+    }
+
+    SET_NO_MEMORY_INFO()
+    SET_MEMORY_INFO_NAME(ReaderImpl)
+    SET_SELF_SIZE(ReaderImpl)
+
+   private:
+    int OnData(Next next,
+               int status,
+               const DataQueue::Vec* vecs,
+               size_t count,
+               Done done) {
+      if (status < 0) {
+        ended_ = true;
+        std::move(next)(status, nullptr, 0, [](uint64_t) {});
+        return status;
+      }
+
+      const bool eos = status == bob::Status::STATUS_EOS;
+      uint64_t total = 0;
+      for (size_t n = 0; n < count; n++) total += vecs[n].len;
+
+      Buffer buffer = Acquire(total + transform_->max_overhead());
+      bool ok = true;
+      for (size_t n = 0; ok && n < count; n++)
+        ok = transform_->Update(vecs[n].base, vecs[n].len, buffer.get());
+      // The input has been consumed either way.
+      if (done) std::move(done)(total);
+
+      if (ok && eos) ok = transform_->Finish(buffer.get());
+      const size_t offset = buffer->size();
+
+      if (!ok) {
+        ended_ = true;
+        Release(std::move(buffer));
+        std::move(next)(UV_EPROTO, nullptr, 0, [](uint64_t) {});
+        return UV_EPROTO;
+      }
+      if (offset == 0) {
+        if (eos) ended_ = true;
+        Release(std::move(buffer));
+        std::move(next)(status, nullptr, 0, [](uint64_t) {});
+        return status;
+      }
+
+      // Readers must not deliver data along with STATUS_EOS, so whatever
+      // Finish() produced goes out first and EOS follows on the next pull.
+      if (eos) {
+        ended_ = true;
+        status = bob::Status::STATUS_CONTINUE;
+      }
+
+      DataQueue::Vec vec{buffer->data(), offset};
+      std::weak_ptr<ReaderImpl> weak = weak_from_this();
+      std::move(next)(status, &vec, 1, [weak, buffer](uint64_t) {
+        if (auto reader = weak.lock()) reader->Release(buffer);
+      });
+      return status;
+    }
+
+    Buffer Acquire(size_t size) {
+      Buffer buffer;
+      if (pool_.empty()) {
+        buffer = std::make_shared<std::vector<uint8_t>>();
+      } else {
+        buffer = std::move(pool_.back());
+        pool_.pop_back();
+      }
+      buffer->clear();
+      buffer->reserve(size);
+      return buffer;
+    }
+
+    void Release(Buffer buffer) {
+      if (pool_.size() >= kMaxPooledBuffers ||
+          buffer->capacity() > kMaxPooledBufferSize ||
+          std::find(pool_.begin(), pool_.end(), buffer) != pool_.end()) {
+        return;
+      }
+      pool_.push_back(std::move(buffer));
+    }
+
+    std::shared_ptr<DataQueue::Reader> inner_;
+    std::unique_ptr<DataQueue::Transform> transform_;
+    std::vector<Buffer> pool_;
+    std::optional<int> delivered_status_;
+    bool ended_ = false;
+  };
+};
+
+// ============================================================================
+
 // An FdEntry reads from a file descriptor. A check is made before each read
 // to determine if the fd has changed on disc. This is a best-effort check
 // that only looks at file size, creation, and modification times. The stat
@@ -1064,6 +1263,211 @@ class FdEntry final : public EntryImpl {
 
 // ============================================================================
 
+#ifndef _WIN32
+// A regular file mapped read-only into memory, shared by every
+// MappedFileEntry sliced from it. The file descriptor is kept open so that
+// modifications can be detected and slices can be mapped again privately.
+class MappedFile final {
+ public:
+  static std::shared_ptr<MappedFile> Open(const char* path) {
+    uv_fs_t req = uv_fs_t();
+    auto cleanup = OnScopeLeave([&] { uv_fs_req_cleanup(&req); });
+    int fd = uv_fs_open(nullptr, &req, path, O_RDONLY, 0, nullptr);
+    if (fd < 0) return nullptr;
+    return FromFd(fd);
+  }
+
+  // Maps the file open as fd, taking ownership of the descriptor.
+  static std::shared_ptr<MappedFile> FromFd(int fd) {
+    uv_fs_t req = uv_fs_t();
+    auto cleanup = OnScopeLeave([&] { uv_fs_req_cleanup(&req); });
+    auto close_fd = OnScopeLeave([&] {
+      if (fd < 0) return;
+      uv_fs_t close_req;
+      uv_fs_close(nullptr, &close_req, fd, nullptr);
+      uv_fs_req_cleanup(&close_req);
+    });
+
+    if (uv_fs_fstat(nullptr, &req, fd, nullptr) < 0) return nullptr;
+    const uv_stat_t& stat = req.statbuf;
+    // Empty files cannot be mapped, and files that do not fit in the
+    // address space should not be.
+    if ((stat.st_mode & S_IFMT) != S_IFREG || stat.st_size == 0 ||
+        stat.st_size > std::numeric_limits<size_t>::max()) {
+      return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(stat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) return nullptr;
+
+    auto file = std::make_shared<MappedFile>(
+        fd, stat, static_cast<uint8_t*>(data), size);
+    fd = -1;
+    return file;
+  }
+
+  MappedFile(int fd, const uv_stat_t& stat, uint8_t* data, size_t size)
+      : fd_(fd), stat_(stat), data_(data), size_(size) {}
+
+  ~MappedFile() {
+    munmap(data_, size_);
+    uv_fs_t req;
+    uv_fs_close(nullptr, &req, fd_, nullptr);
+    uv_fs_req_cleanup(&req);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  bool IsModified() const {
+    uv_fs_t req = uv_fs_t();
+    auto cleanup = OnScopeLeave([&] { uv_fs_req_cleanup(&req); });
+    if (uv_fs_fstat(nullptr, &req, fd_, nullptr) < 0) return true;
+    return req.statbuf.st_size != stat_.st_size ||
+           req.statbuf.st_mtim.tv_sec != stat_.st_mtim.tv_sec ||
+           req.statbuf.st_mtim.tv_nsec != stat_.st_mtim.tv_nsec;
+  }
+
+  // Maps [start, start + length) of the file again as a private, writable
+  // view, so that JavaScript can own it without the data being copied and
+  // without writes to it showing through the shared read-only mapping.
+  std::unique_ptr<BackingStore> MapRange(uint64_t start,
+                                         uint64_t length) const {
+    CHECK_LE(start + length, size_);
+#if defined(V8_ENABLE_SANDBOX)
+    // External backing stores are not supported inside the v8 sandbox.
+    return nullptr;
+#else
+    if (length == 0 || length > ArrayBuffer::kMaxByteLength) {
+      return nullptr;
+    }
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t delta = start % page_size;
+    void* base = mmap(nullptr,
+                      delta + length,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE,
+                      fd_,
+                      start - delta);
+    if (base == MAP_FAILED) return nullptr;
+    return ArrayBuffer::NewBackingStore(
+        static_cast<uint8_t*>(base) + delta,
+        length,
+        [](void* data, size_t length, void* deleter_data) {
+          size_t delta = reinterpret_cast<uintptr_t>(deleter_data);
+          munmap(static_cast<uint8_t*>(data) - delta, delta + length);
+        },
+        reinterpret_cast<void*>(static_cast<uintptr_t>(delta)));
+#endif  // defined(V8_ENABLE_SANDBOX)
+  }
+
+ private:
+  int fd_;
+  uv_stat_t stat_;
+  uint8_t* data_;
+  size_t size_;
+};
+
+// An entry over a range of a MappedFile. Reads hand out pointers into the
+// mapping and slices share it, so neither copies nor touches the thread
+// pool. Unlike FdEntry, the entry is not bound to an Environment.
+class MappedFileEntry final : public EntryImpl {
+ public:
+  // Reads are split into chunks of this size so that consumers can start
+  // on the data before all of a large file has been paged in.
+  static constexpr size_t kReadChunkSize = 1024 * 1024;
+
+  class ReaderImpl final : public DataQueue::Reader,
+                           public std::enable_shared_from_this<ReaderImpl> {
+   public:
+    explicit ReaderImpl(const MappedFileEntry& entry)
+        : file_(entry.file_), offset_(entry.start_), end_(entry.end_) {}
+
+    int Pull(Next next,
+             int options,
+             DataQueue::Vec* data,
+             size_t count,
+             size_t max_count_hint = bob::kMaxCountHint) override {
+      auto self = shared_from_this();
+      if (offset_ == end_) {
+        std::move(next)(bob::STATUS_EOS, nullptr, 0, [](uint64_t) {});
+        return bob::STATUS_EOS;
+      }
+
+      if (file_->IsModified()) {
+        offset_ = end_;
+        std::move(next)(UV_EINVAL, nullptr, 0, [](uint64_t) {});
+        return UV_EINVAL;
+      }
+
+      uint64_t len = std::min<uint64_t>(end_ - offset_, kReadChunkSize);
+      DataQueue::Vec vec{file_->data() + offset_, len};
+      offset_ += len;
+      // The done callback keeps the mapping alive until the consumer has
+      // finished with the data, even if the entry is gone by then.
+      std::move(next)(
+          bob::STATUS_CONTINUE, &vec, 1, [file = file_](uint64_t) {});
+      return bob::STATUS_CONTINUE;
+    }
+
+    SET_NO_MEMORY_INFO()
+    SET_MEMORY_INFO_NAME(MappedFileEntry::Reader)
+    SET_SELF_SIZE(ReaderImpl)
+
+   private:
+    std::shared_ptr<MappedFile> file_;
+    uint64_t offset_;
+    uint64_t end_;
+  };
+
+  MappedFileEntry(std::shared_ptr<MappedFile> file,
+                  uint64_t start,
+                  uint64_t end)
+      : file_(std::move(file)), start_(start), end_(end) {
+    CHECK_LE(start_, end_);
+    CHECK_LE(end_, file_->size());
+  }
+
+  std::shared_ptr<DataQueue::Reader> get_reader() override {
+    return std::make_shared<ReaderImpl>(*this);
+  }
+
+  std::unique_ptr<Entry> slice(
+      uint64_t start, std::optional<uint64_t> end = std::nullopt) override {
+    uint64_t new_start = std::min(start_ + start, end_);
+    uint64_t new_end = end_;
+    if (end.has_value()) {
+      new_end = std::max(new_start, std::min(end.value() + start_, end_));
+    }
+    return std::make_unique<MappedFileEntry>(file_, new_start, new_end);
+  }
+
+  std::optional<uint64_t> size() const override { return end_ - start_; }
+
+  bool is_idempotent() const override { return true; }
+
+  std::unique_ptr<BackingStore> ToBackingStore() override {
+    if (file_->IsModified()) return nullptr;
+    return file_->MapRange(start_, end_ - start_);
+  }
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(MappedFileEntry)
+  SET_SELF_SIZE(MappedFileEntry)
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+  uint64_t start_;
+  uint64_t end_;
+};
+#endif  // _WIN32
+
+// ============================================================================
+
 }  // namespace
 
 std::shared_ptr<DataQueue> DataQueue::CreateIdempotent(
@@ -1120,12 +1524,16 @@ std::unique_ptr<DataQueue::Entry> DataQueue::CreateInMemoryEntryFromView(
 
 std::unique_ptr<DataQueue::Entry>
 DataQueue::CreateInMemoryEntryFromBackingStore(
-    std::shared_ptr<BackingStore> store, uint64_t offset, uint64_t length) {
+    std::shared_ptr<BackingStore> store,
+    uint64_t offset,
+    uint64_t length,
+    std::shared_ptr<void> retainer) {
   CHECK(store);
   if (offset + length > store->ByteLength()) {
     return nullptr;
   }
-  return std::make_unique<InMemoryEntry>(std::move(store), offset, length);
+  return std::make_unique<InMemoryEntry>(
+      std::move(store), offset, length, std::move(retainer));
 }
 
 std::unique_ptr<DataQueue::Entry> DataQueue::CreateDataQueueEntry(
@@ -1133,11 +1541,76 @@ std::unique_ptr<DataQueue::Entry> DataQueue::CreateDataQueueEntry(
   return std::make_unique<DataQueueEntry>(std::move(data_queue));
 }
 
+std::unique_ptr<DataQueue::Entry> DataQueue::CreateTransformEntry(
+    std::shared_ptr<DataQueue> data_queue,
+    std::unique_ptr<Transform> transform) {
+  CHECK(data_queue);
+  CHECK(transform);
+  return std::make_unique<TransformEntry>(std::move(data_queue),
+                                          std::move(transform));
+}
+
 std::unique_ptr<DataQueue::Entry> DataQueue::CreateFdEntry(Environment* env,
                                                            Local<Value> path) {
   return FdEntry::Create(env, path);
 }
 
+std::unique_ptr<DataQueue::Entry> DataQueue::CreateMappedFileEntry(
+    const char* path) {
+#ifndef _WIN32
+  std::shared_ptr<MappedFile> file = MappedFile::Open(path);
+  if (!file) return nullptr;
+  size_t size = file->size();
+  return std::make_unique<MappedFileEntry>(std::move(file), 0, size);
+#else
+  return nullptr;
+#endif  // _WIN32
+}
+
+std::unique_ptr<DataQueue::Entry> DataQueue::CreateTempFileEntry(
+    const uint8_t* data, size_t length) {
+#ifndef _WIN32
+  char dir[PATH_MAX];
+  size_t dir_length = sizeof(dir);
+  if (length == 0 || uv_os_tmpdir(dir, &dir_length) != 0) return nullptr;
+  std::string tmpl = std::string(dir, dir_length) + "/node-blob-XXXXXX";
+
+  uv_fs_t req = uv_fs_t();
+  auto cleanup = OnScopeLeave([&] { uv_fs_req_cleanup(&req); });
+  int fd = uv_fs_mkstemp(nullptr, &req, tmpl.c_str(), nullptr);
+  if (fd < 0) return nullptr;
+  // Nothing needs the name, and without it the space is released as soon
+  // as the last entry over the file is gone, even if the process crashes.
+  uv_fs_t unlink_req;
+  uv_fs_unlink(nullptr, &unlink_req, req.path, nullptr);
+  uv_fs_req_cleanup(&unlink_req);
+
+  size_t written = 0;
+  while (written < length) {
+    uv_buf_t buf = uv_buf_init(
+        reinterpret_cast<char*>(const_cast<uint8_t*>(data)) + written,
+        static_cast<unsigned int>(
+            std::min<size_t>(length - written, INT_MAX)));
+    uv_fs_t write_req;
+    int err = uv_fs_write(nullptr, &write_req, fd, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&write_req);
+    if (err <= 0) {
+      uv_fs_t close_req;
+      uv_fs_close(nullptr, &close_req, fd, nullptr);
+      uv_fs_req_cleanup(&close_req);
+      return nullptr;
+    }
+    written += err;
+  }
+
+  std::shared_ptr<MappedFile> file = MappedFile::FromFd(fd);
+  if (!file) return nullptr;
+  return std::make_unique<MappedFileEntry>(std::move(file), 0, length);
+#else
+  return nullptr;
+#endif  // _WIN32
+}
+
 void DataQueue::Initialize(Environment* env, v8::Local<v8::Object> target) {
   // Nothing to do here currently.
 }
@@ -186,6 +186,43 @@ class DataQueue : public MemoryRetainer {
     // idempotent and cannot preserve that quality, subsequent reads
     // must fail with an error when a variance is detected.
     virtual bool is_idempotent() const = 0;
+
+    // Returns a v8::BackingStore exposing the data of this entry without
+    // copying it, or nullptr if the entry cannot provide one. Writes
+    // through the returned store must not be visible to readers of the
+    // entry.
+    virtual std::unique_ptr<v8::BackingStore> ToBackingStore() {
+      return nullptr;
+    }
+  };
+
+  // A DataQueue::Transform rewrites the bytes of a DataQueue as they are
+  // read, e.g. to encrypt them, without handing each chunk to JavaScript.
+  // A Transform is stateful and is driven by exactly one reader, in order.
+  // It must not hold on to an Environment: the queue that owns it can be
+  // transferred to another thread.
+  class Transform : public MemoryRetainer {
+   public:
+    // The number of bytes by which the output for a chunk typically exceeds
+    // its input, used to size output buffers up front. Transforms whose
+    // output has no fixed bound, such as compression, may write more.
+    virtual size_t max_overhead() const = 0;
+
+    // Transforms len bytes from data and appends the result to *out.
+    // Returns false if the data cannot be transformed.
+    virtual bool Update(const uint8_t* data,
+                        size_t len,
+                        std::vector<uint8_t>* out) = 0;
+
+    // Called once after the input has been fully read, appends whatever
+    // output is left to *out. Returns false if the transform failed, e.g.
+    // because the data did not authenticate.
+    virtual bool Finish(std::vector<uint8_t>* out) = 0;
+
+    // Returns the size of the output for an input of the given size,
+    // if it can be known in advance.
+    virtual std::optional<uint64_t> size(
+        std::optional<uint64_t> input_size) const = 0;
   };
 
   // Creates an idempotent DataQueue with a pre-established collection
@@ -212,11 +249,14 @@ class DataQueue : public MemoryRetainer {
   // Creates an idempotent Entry from a v8::BackingStore. It is the
   // callers responsibility to ensure that the BackingStore is not
   // otherwise modified through any other means. If the ArrayBuffer
-  // is not detachable, nullptr will be returned.
+  // is not detachable, nullptr will be returned. The optional retainer
+  // is kept alive for as long as the entry or any slice of it, e.g. to
+  // account for the memory the entry holds.
   static std::unique_ptr<Entry> CreateInMemoryEntryFromBackingStore(
       std::shared_ptr<v8::BackingStore> store,
       uint64_t offset,
-      uint64_t length);
+      uint64_t length,
+      std::shared_ptr<void> retainer = nullptr);
 
   static std::unique_ptr<Entry> CreateDataQueueEntry(
       std::shared_ptr<DataQueue> data_queue);
@@ -224,6 +264,34 @@ class DataQueue : public MemoryRetainer {
   static std::unique_ptr<Entry> CreateFdEntry(Environment* env,
                                               v8::Local<v8::Value> path);
 
+  // Creates an idempotent Entry over a regular file that is mapped into
+  // memory rather than read through the thread pool. Slicing the entry and
+  // reading from it never copy the data, and ToBackingStore() maps the
+  // slice again as a private, copy-on-write view. Like FdEntry, reads fail
+  // once the file has been modified, but a file that is truncated while a
+  // view over it is in use will raise SIGBUS when the missing pages are
+  // touched, so callers must opt in. Returns nullptr if the file cannot be
+  // mapped (it is empty, not a regular file, or mmap is unavailable), in
+  // which case CreateFdEntry() should be used instead.
+  static std::unique_ptr<Entry> CreateMappedFileEntry(const char* path);
+
+  // Creates an idempotent Entry holding a copy of length bytes from data in
+  // an anonymous temporary file, which is mapped like CreateMappedFileEntry()
+  // does. The file is unlinked right away and disappears with the last
+  // entry over it. Lets large data be kept out of process memory, whose
+  // pages the kernel can then write back and drop. Returns nullptr if the
+  // file cannot be created or written, or on Windows.
+  static std::unique_ptr<Entry> CreateTempFileEntry(const uint8_t* data,
+                                                    size_t length);
+
+  // Creates a non-idempotent entry that yields the contents of data_queue
+  // passed through transform. The output is produced into a small pool of
+  // buffers owned by the reader rather than one allocation per chunk. The
+  // entry can be read only once and cannot be sliced.
+  static std::unique_ptr<Entry> CreateTransformEntry(
+      std::shared_ptr<DataQueue> data_queue,
+      std::unique_ptr<Transform> transform);
+
   // Creates a Reader for the given queue. If the queue is idempotent,
   // any number of readers can be created, all of which are guaranteed
   // to provide the same data. Otherwise, only a single reader is
@@ -282,6 +350,11 @@ class DataQueue : public MemoryRetainer {
   // idempotent.
   virtual bool is_idempotent() const = 0;
 
+  // Returns a v8::BackingStore exposing the data of an idempotent queue
+  // without copying it, if the queue consists of a single entry whose
+  // ToBackingStore() can provide one. Returns nullptr otherwise.
+  virtual std::unique_ptr<v8::BackingStore> ToBackingStore() = 0;
+
   // True only if cap is called or the data queue is a limited to a
   // fixed size.
   virtual bool is_capped() const = 0;
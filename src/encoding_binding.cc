@@ -8,7 +8,9 @@
 #include "string_bytes.h"
 #include "v8.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <string>
 
 namespace node {
 namespace encoding_binding {
@@ -19,8 +21,10 @@ using v8::BackingStoreInitializationMode;
 using v8::Context;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
+using v8::Integer;
 using v8::Isolate;
 using v8::Local;
+using v8::MaybeLocal;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::SnapshotCreator;
@@ -187,6 +191,180 @@ void BindingData::DecodeUTF8(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+namespace {
+
+// The number of bytes in the UTF-8 sequence that lead begins, or 0 if lead
+// cannot begin one.
+size_t Utf8SequenceLength(uint8_t lead) {
+  if (lead < 0x80) return 1;
+  if (lead >= 0xC2 && lead <= 0xDF) return 2;
+  if (lead >= 0xE0 && lead <= 0xEF) return 3;
+  if (lead >= 0xF0 && lead <= 0xF4) return 4;
+  return 0;
+}
+
+// Whether byte can be at position index of the sequence that lead begins,
+// which rules out overlong forms, surrogates and code points past U+10FFFF.
+bool IsUtf8Continuation(uint8_t lead, size_t index, uint8_t byte) {
+  uint8_t low = 0x80;
+  uint8_t high = 0xBF;
+  if (index == 1) {
+    if (lead == 0xE0) low = 0xA0;
+    if (lead == 0xED) high = 0x9F;
+    if (lead == 0xF0) low = 0x90;
+    if (lead == 0xF4) high = 0x8F;
+  }
+  return byte >= low && byte <= high;
+}
+
+// The number of bytes at the end of data that are the start of a valid but
+// incomplete sequence.
+size_t IncompleteUtf8Tail(const uint8_t* data, size_t length) {
+  for (size_t n = 1; n <= std::min<size_t>(length, 3); n++) {
+    const uint8_t* start = data + length - n;
+    if ((*start & 0xC0) == 0x80) continue;
+    if (Utf8SequenceLength(*start) <= n) return 0;
+    for (size_t i = 1; i < n; i++) {
+      if (!IsUtf8Continuation(*start, i, start[i])) return 0;
+    }
+    return n;
+  }
+  return 0;
+}
+
+constexpr char kReplacementCharacter[] = "\xEF\xBF\xBD";
+
+}  // namespace
+
+void Utf8StreamDecoder::Reset() {
+  state_[kPendingLength] = 0;
+  state_[kFlags] &= ~kBOMSeen;
+}
+
+MaybeLocal<String> Utf8StreamDecoder::Decode(Isolate* isolate,
+                                             const uint8_t* data,
+                                             size_t length,
+                                             bool flush) {
+  const bool fatal = state_[kFlags] & kFatal;
+  auto fail = [&]() {
+    Reset();
+    THROW_ERR_ENCODING_INVALID_ENCODED_DATA(
+        isolate, "The encoded data was not valid for encoding utf-8");
+    return MaybeLocal<String>();
+  };
+
+  // First complete the character that the previous chunk ended in, if any.
+  // It takes at most three bytes of this chunk.
+  std::string head;
+  size_t consumed = 0;
+  if (state_[kPendingLength] > 0) {
+    uint8_t sequence[4];
+    size_t sequence_length = state_[kPendingLength];
+    std::copy_n(state_ + kPendingBytesStart, sequence_length, sequence);
+    const size_t needed = Utf8SequenceLength(sequence[0]);
+    while (sequence_length < needed && consumed < length &&
+           IsUtf8Continuation(sequence[0], sequence_length, data[consumed])) {
+      sequence[sequence_length++] = data[consumed++];
+    }
+    if (sequence_length == needed) {
+      head.assign(reinterpret_cast<char*>(sequence), sequence_length);
+      state_[kPendingLength] = 0;
+    } else if (consumed < length || flush) {
+      // The sequence was cut short by an invalid byte, which is decoded on
+      // its own, or by the end of the stream.
+      if (fatal) return fail();
+      head = kReplacementCharacter;
+      state_[kPendingLength] = 0;
+    } else {
+      // All of this chunk went into a character that is still incomplete.
+      std::copy_n(sequence, sequence_length, state_ + kPendingBytesStart);
+      state_[kPendingLength] = sequence_length;
+      return String::Empty(isolate);
+    }
+  }
+
+  const uint8_t* body = data + consumed;
+  size_t body_length = length - consumed;
+  if (!flush) {
+    size_t tail = IncompleteUtf8Tail(body, body_length);
+    body_length -= tail;
+    std::copy_n(body + body_length, tail, state_ + kPendingBytesStart);
+    state_[kPendingLength] = tail;
+  }
+
+  if (fatal && !simdutf::validate_utf8(reinterpret_cast<const char*>(body),
+                                       body_length)) {
+    return fail();
+  }
+
+  // The BOM is only skipped if it is the first character of the stream.
+  if (!(state_[kFlags] & (kIgnoreBOM | kBOMSeen)) &&
+      (!head.empty() || body_length > 0)) {
+    state_[kFlags] |= kBOMSeen;
+    if (!head.empty()) {
+      if (head == "\xEF\xBB\xBF") head.clear();
+    } else if (body_length >= 3 && memcmp(body, "\xEF\xBB\xBF", 3) == 0) {
+      body += 3;
+      body_length -= 3;
+    }
+  }
+  if (flush) Reset();
+
+  Local<String> result = String::Empty(isolate);
+  if (!head.empty()) {
+    if (!String::NewFromUtf8(isolate,
+                             head.data(),
+                             v8::NewStringType::kNormal,
+                             head.size())
+             .ToLocal(&result)) {
+      return {};
+    }
+  }
+  if (body_length > 0) {
+    Local<Value> decoded;
+    if (!StringBytes::Encode(isolate,
+                             reinterpret_cast<const char*>(body),
+                             body_length,
+                             UTF8)
+             .ToLocal(&decoded)) {
+      return {};
+    }
+    // A cons string, the body is not copied again.
+    result = head.empty() ? decoded.As<String>()
+                          : String::Concat(isolate, result,
+                                           decoded.As<String>());
+  }
+  return result;
+}
+
+// Decodes the next chunk of a stream: (state, input, flush).
+void BindingData::DecodeUTF8Stream(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  // Buffer::Data() rather than a copy, the state is written to.
+  CHECK(args[0]->IsUint8Array());
+  CHECK_EQ(Buffer::Length(args[0]), sizeof(Utf8StreamDecoder));
+  Utf8StreamDecoder* decoder =
+      reinterpret_cast<Utf8StreamDecoder*>(Buffer::Data(args[0]));
+
+  if (!(args[1]->IsArrayBuffer() || args[1]->IsSharedArrayBuffer() ||
+        args[1]->IsArrayBufferView())) {
+    return node::THROW_ERR_INVALID_ARG_TYPE(
+        env->isolate(),
+        "The \"input\" argument must be an instance of ArrayBuffer, "
+        "SharedArrayBuffer, or ArrayBufferView.");
+  }
+  ArrayBufferViewContents<uint8_t> input(args[1]);
+
+  Local<String> ret;
+  if (decoder
+          ->Decode(env->isolate(), input.data(), input.length(),
+                   args[2]->IsTrue())
+          .ToLocal(&ret)) {
+    args.GetReturnValue().Set(ret);
+  }
+}
+
 void BindingData::ToASCII(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK_GE(args.Length(), 1);
@@ -222,6 +400,17 @@ void BindingData::CreatePerIsolateProperties(IsolateData* isolate_data,
   SetMethodNoSideEffect(isolate, target, "toASCII", ToASCII);
   SetMethodNoSideEffect(isolate, target, "toUnicode", ToUnicode);
   SetMethodNoSideEffect(isolate, target, "decodeLatin1", DecodeLatin1);
+  SetMethod(isolate, target, "decodeUTF8Stream", DecodeUTF8Stream);
+
+#define SET_UTF8_STREAM_DECODER_CONSTANT(name)                                \
+  target->Set(FIXED_ONE_BYTE_STRING(isolate, "kUtf8StreamDecoder" #name),     \
+              Integer::New(isolate, Utf8StreamDecoder::k##name))
+  SET_UTF8_STREAM_DECODER_CONSTANT(Flags);
+  SET_UTF8_STREAM_DECODER_CONSTANT(IgnoreBOM);
+  SET_UTF8_STREAM_DECODER_CONSTANT(Fatal);
+#undef SET_UTF8_STREAM_DECODER_CONSTANT
+  target->Set(FIXED_ONE_BYTE_STRING(isolate, "kUtf8StreamDecoderSize"),
+              Integer::New(isolate, sizeof(Utf8StreamDecoder)));
 }
 
 void BindingData::CreatePerContextProperties(Local<Object> target,
@@ -240,6 +429,7 @@ void BindingData::RegisterTimerExternalReferences(
   registry->Register(ToASCII);
   registry->Register(ToUnicode);
   registry->Register(DecodeLatin1);
+  registry->Register(DecodeUTF8Stream);
 }
 
 void BindingData::DecodeLatin1(const FunctionCallbackInfo<Value>& args) {
@@ -12,6 +12,43 @@ namespace node {
 class ExternalReferenceRegistry;
 
 namespace encoding_binding {
+
+// The state of a streaming WHATWG TextDecoder for UTF-8, kept in a
+// Uint8Array of kNumFields bytes that JS allocates once per decoder, as
+// with StringDecoder. A chunk that ends in the middle of a character
+// leaves the bytes of it here, rather than the chunk being concatenated
+// with the next one.
+class Utf8StreamDecoder {
+ public:
+  // Decodes the next length bytes of the stream. With flush, this is the
+  // end of the stream: an incomplete character is replaced (or, for fatal
+  // decoders, is an error) and the decoder is reset for a new stream.
+  // Returns an empty handle with an exception pending on errors.
+  v8::MaybeLocal<v8::String> Decode(v8::Isolate* isolate,
+                                    const uint8_t* data,
+                                    size_t length,
+                                    bool flush);
+
+  enum Fields {
+    kPendingBytesStart = 0,
+    kPendingBytesEnd = 3,
+    kPendingLength = 3,
+    kFlags = 4,
+    kNumFields = 5
+  };
+
+  enum Flags {
+    kIgnoreBOM = 1 << 0,
+    kFatal = 1 << 1,
+    kBOMSeen = 1 << 2,
+  };
+
+ private:
+  void Reset();
+
+  uint8_t state_[kNumFields] = {};
+};
+
 class BindingData : public SnapshotableObject {
  public:
   struct InternalFieldInfo : public node::InternalFieldInfoBase {
@@ -32,6 +69,8 @@ class BindingData : public SnapshotableObject {
   static void EncodeUtf8String(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DecodeUTF8(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DecodeLatin1(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void DecodeUTF8Stream(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
 
   static void ToASCII(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void ToUnicode(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -478,6 +478,10 @@ inline bool Environment::use_compile_cache() const {
   return compile_cache_handler_.get() != nullptr;
 }
 
+inline loader::ModulePrefetcher* Environment::module_prefetcher() {
+  return module_prefetcher_.get();
+}
+
 #if HAVE_INSPECTOR
 inline void Environment::set_coverage_directory(const char* dir) {
   coverage_directory_ = std::string(dir);
@@ -721,6 +725,16 @@ inline void Environment::remove_sub_worker_context(worker::Worker* context) {
   sub_worker_contexts_.erase(context);
 }
 
+inline const std::shared_ptr<worker::IsolatePool>&
+Environment::worker_isolate_pool() const {
+  return worker_isolate_pool_;
+}
+
+inline void Environment::set_worker_isolate_pool(
+    std::shared_ptr<worker::IsolatePool> pool) {
+  worker_isolate_pool_ = std::move(pool);
+}
+
 template <typename Fn>
 inline void Environment::ForEachWorker(Fn&& iterator) {
   for (worker::Worker* w : sub_worker_contexts_) iterator(w);
@@ -756,6 +770,24 @@ inline performance::PerformanceState* Environment::performance_state() {
   return performance_state_.get();
 }
 
+inline const Environment::NativeImmediateBudgetStats&
+Environment::native_immediate_budget_stats() const {
+  return native_immediate_budget_stats_;
+}
+
+inline LoopPhaseMonitor* Environment::loop_phase_monitor() const {
+  return loop_phase_monitor_;
+}
+
+inline void Environment::set_loop_phase_monitor(LoopPhaseMonitor* monitor) {
+  loop_phase_monitor_ = monitor;
+}
+
+inline std::vector<Environment::AsyncCallbackTotals>&
+Environment::async_callback_totals() {
+  return async_callback_totals_;
+}
+
 inline IsolateData* Environment::isolate_data() const {
   return isolate_data_;
 }
@@ -813,6 +845,11 @@ void Environment::AddCleanupHook(CleanupQueue::Callback fn, void* arg) {
   cleanup_queue_.Add(fn, arg);
 }
 
+void Environment::AddEssentialCleanupHook(CleanupQueue::Callback fn,
+                                          void* arg) {
+  cleanup_queue_.Add(fn, arg, true);
+}
+
 void Environment::RemoveCleanupHook(CleanupQueue::Callback fn, void* arg) {
   cleanup_queue_.Remove(fn, arg);
 }
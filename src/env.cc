@@ -15,9 +15,11 @@
 #include "node_shadow_realm.h"
 #include "node_snapshotable.h"
 #include "node_v8_platform-inl.h"
+#include "node_watchdog.h"
 #include "node_worker.h"
 #include "req_wrap-inl.h"
 #include "stream_base.h"
+#include "stream_wrap.h"
 #include "tracing/agent.h"
 #include "tracing/traced_value.h"
 #include "util-inl.h"
@@ -29,6 +31,7 @@
 #include <atomic>
 #include <cinttypes>
 #include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
 #include <memory>
@@ -746,10 +749,15 @@ void Environment::add_refs(int64_t diff) {
 }
 
 uv_buf_t Environment::allocate_managed_buffer(const size_t suggested_size) {
-  std::unique_ptr<BackingStore> bs = ArrayBuffer::NewBackingStore(
-      isolate(),
-      suggested_size,
-      BackingStoreInitializationMode::kUninitialized);
+  std::unique_ptr<BackingStore> bs;
+  if (ReadBufferPool* pool = read_buffer_pool()) {
+    bs = pool->NewBackingStore(isolate(), suggested_size);
+  } else {
+    bs = ArrayBuffer::NewBackingStore(
+        isolate(),
+        suggested_size,
+        BackingStoreInitializationMode::kUninitialized);
+  }
   uv_buf_t buf = uv_buf_init(static_cast<char*>(bs->Data()), bs->ByteLength());
   released_allocated_buffers_.emplace(buf.base, std::move(bs));
   return buf;
@@ -767,6 +775,12 @@ std::unique_ptr<BackingStore> Environment::release_managed_buffer(
   return bs;
 }
 
+ReadBufferPool* Environment::read_buffer_pool() {
+  if (!read_buffer_pool_ && options()->stream_read_buffer_pool)
+    read_buffer_pool_.reset(ReadBufferPool::Create());
+  return read_buffer_pool_.get();
+}
+
 std::string Environment::GetExecPath(const std::vector<std::string>& argv) {
   char exec_path_buf[2 * PATH_MAX];
   size_t exec_path_len = sizeof(exec_path_buf);
@@ -841,7 +855,10 @@ Environment::Environment(IsolateData* isolate_data,
     per_process::Debug(DebugCategory::CODE_CACHE,
                        "snapshot contains %zu code cache\n",
                        cache_size);
-    if (cache_size > 0) {
+    // The low memory profile compiles builtins lazily instead, without
+    // keeping a copy of the cache for every builtin around.
+    if (cache_size > 0 &&
+        per_process::cli_options->memory_profile != "low") {
       builtin_loader()->RefreshCodeCache(
           isolate_data->snapshot_data()->code_cache);
     }
@@ -977,6 +994,12 @@ Environment::Environment(IsolateData* isolate_data,
       permission()->Apply(this, {"*"}, permission::PermissionScope::kNet);
     }
   }
+
+  // Prefetching reads files that the loader may never load, which the
+  // permission model has no way to check.
+  if (options_->experimental_module_prefetch && !options_->permission) {
+    module_prefetcher_ = std::make_unique<loader::ModulePrefetcher>(this);
+  }
 }
 
 void Environment::InitializeMainContext(Local<Context> context,
@@ -1133,6 +1156,11 @@ void Environment::InitializeLibuv() {
   }
 
   StartProfilerIdleNotifier();
+
+  if (options()->trace_event_loop_stalls > 0) {
+    loop_stall_watchdog_ = std::make_unique<LoopStallWatchdog>(
+        this, options()->trace_event_loop_stalls);
+  }
   env_handle_initialized_ = true;
 }
 
@@ -1195,11 +1223,11 @@ CompileCacheEnableResult Environment::EnableCompileCache(
   return result;
 }
 
-void Environment::FlushCompileCache() {
+void Environment::FlushCompileCache(bool after_warmup) {
   if (!compile_cache_handler_ || compile_cache_handler_->cache_dir().empty()) {
     return;
   }
-  compile_cache_handler_->Persist();
+  compile_cache_handler_->Persist(after_warmup);
 }
 
 void Environment::ExitEnv(StopFlags::Flags flags) {
@@ -1241,6 +1269,7 @@ void Environment::ClosePerEnvHandles() {
   close_and_finish(reinterpret_cast<uv_handle_t*>(&idle_prepare_handle_));
   close_and_finish(reinterpret_cast<uv_handle_t*>(&idle_check_handle_));
   close_and_finish(reinterpret_cast<uv_handle_t*>(&task_queues_async_));
+  if (loop_stall_watchdog_) loop_stall_watchdog_->Close();
 }
 
 void Environment::CleanupHandles() {
@@ -1329,6 +1358,7 @@ void Environment::RunCleanup() {
   while (!cleanup_queue_.empty() || principal_realm_->PendingCleanup() ||
          native_immediates_.size() > 0 ||
          native_immediates_threadsafe_.size() > 0 ||
+         native_immediates_threadsafe_deferred_.size() > 0 ||
          native_immediates_interrupts_.size() > 0) {
     // TODO(legendecas): cleanup handles in per-realm cleanup hooks as well.
     principal_realm_->RunCleanup();
@@ -1422,16 +1452,35 @@ void Environment::RunAndClearNativeImmediates(bool only_refed) {
   // exceptions, so we do not need to handle that.
   RunAndClearInterrupts();
 
+  // The budget does not apply while cleaning up, everything has to run then.
+  // At least one callback runs per call so that deferred work makes progress.
+  const uint64_t max_calls =
+      only_refed ? 0 : options()->native_immediate_budget;
+  const uint64_t max_time =
+      only_refed ? 0 : options()->native_immediate_budget_us * 1000;
+  const uint64_t start_time = max_time != 0 ? uv_hrtime() : 0;
+  uint64_t calls = 0;
+  bool out_of_budget = false;
+  auto has_budget = [&]() {
+    if (calls == 0) return true;
+    out_of_budget = (max_calls != 0 && calls >= max_calls) ||
+                    (max_time != 0 && uv_hrtime() - start_time >= max_time);
+    return !out_of_budget;
+  };
+
   auto drain_list = [&](NativeImmediateQueue* queue) {
     TryCatchScope try_catch(this);
     DebugSealHandleScope seal_handle_scope(isolate());
-    while (auto head = queue->Shift()) {
+    while (!out_of_budget && queue->size() > 0 && has_budget()) {
+      auto head = queue->Shift();
       bool is_refed = head->flags() & CallbackFlags::kRefed;
       if (is_refed)
         ref_count++;
 
-      if (is_refed || !only_refed)
+      if (is_refed || !only_refed) {
         head->Call(this);
+        calls++;
+      }
 
       head.reset();  // Destroy now so that this is also observed by try_catch.
 
@@ -1458,12 +1507,26 @@ void Environment::RunAndClearNativeImmediates(bool only_refed) {
   // This is intentionally placed after the `ref_count` handling, because when
   // refed threadsafe immediates are created, they are not counted towards the
   // count in immediate_info() either.
+  while (drain_list(&native_immediates_threadsafe_deferred_)) {}
   NativeImmediateQueue threadsafe_immediates;
-  if (native_immediates_threadsafe_.size() > 0) {
+  if (!out_of_budget && native_immediates_threadsafe_.size() > 0) {
     Mutex::ScopedLock lock(native_immediates_threadsafe_mutex_);
     threadsafe_immediates.ConcatMove(std::move(native_immediates_threadsafe_));
   }
   while (drain_list(&threadsafe_immediates)) {}
+
+  native_immediates_out_of_budget_ = out_of_budget;
+  if (out_of_budget) [[unlikely]] {
+    native_immediates_threadsafe_deferred_.ConcatMove(
+        std::move(threadsafe_immediates));
+    native_immediate_budget_stats_.exhausted++;
+    native_immediate_budget_stats_.deferred +=
+        native_immediates_.size() +
+        native_immediates_threadsafe_deferred_.size();
+    // Keep the loop from blocking in poll, the check handle picks the rest
+    // up on the next iteration.
+    ToggleImmediateRef(true);
+  }
 }
 
 void Environment::RequestInterruptFromV8() {
@@ -1596,8 +1659,11 @@ void Environment::CheckImmediate(uv_check_t* handle) {
                  {0, 0}).ToLocalChecked();
   } while (env->immediate_info()->has_outstanding() && env->can_call_into_js());
 
-  if (env->immediate_info()->ref_count() == 0)
+  // Native immediates deferred by their budget still need the next iteration.
+  if (env->immediate_info()->ref_count() == 0 &&
+      !env->native_immediates_out_of_budget_) {
     env->ToggleImmediateRef(false);
+  }
 }
 
 void Environment::ToggleImmediateRef(bool ref) {
@@ -1907,9 +1973,25 @@ void Environment::Exit(ExitCode exit_code) {
                                       static_cast<int>(stack_trace_limit()),
                                       StackTrace::kDetailed));
   }
+  // Writes held back by coalescing streams would otherwise be lost.
+  LibuvStreamWrap::FlushAllCoalescedWrites(this);
   process_exit_handler_(this, exit_code);
 }
 
+void Environment::FastExit(ExitCode exit_code) {
+  set_stopping(true);
+  set_can_call_into_js(false);
+  LibuvStreamWrap::FlushAllCoalescedWrites(this);
+  // These write out the compile cache and the --cpu-prof and --heap-prof
+  // profiles, and are empty already if process.exit() ran them.
+  RunAtExitCallbacks();
+  cleanup_queue_.DrainEssential();
+  per_process::v8_platform.StopTracingAgent();
+  fflush(stdout);
+  fflush(stderr);
+  std::_Exit(static_cast<int>(exit_code));
+}
+
 void Environment::stop_sub_worker_contexts() {
   DCHECK_EQ(Isolate::GetCurrent(), isolate());
 
@@ -1919,6 +2001,11 @@ void Environment::stop_sub_worker_contexts() {
     w->Exit(ExitCode::kGenericUserError);
     w->JoinThread();
   }
+
+  if (worker_isolate_pool_) {
+    worker_isolate_pool_->Shutdown();
+    worker_isolate_pool_.reset();
+  }
 }
 
 Environment* Environment::worker_parent_env() const {
@@ -2241,6 +2328,8 @@ void Environment::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("tick_info", tick_info_);
   tracker->TrackField("principal_realm", principal_realm_);
   tracker->TrackField("shadow_realms", shadow_realms_);
+  tracker->TrackInlineField(&permission_, "permission");
+  tracker->TrackField("compile_cache_handler", compile_cache_handler_);
 
   // FIXME(joyeecheung): track other fields in Environment.
   // Currently MemoryTracker is unable to track these
@@ -35,6 +35,7 @@
 #include "debug_utils.h"
 #include "env_properties.h"
 #include "handle_wrap.h"
+#include "module_prefetch.h"
 #include "node.h"
 #include "node_binding.h"
 #include "node_builtins.h"
@@ -45,6 +46,7 @@
 #include "node_realm.h"
 #include "node_snapshotable.h"
 #include "permission/permission.h"
+#include "read_buffer_pool.h"
 #include "req_wrap.h"
 #include "util.h"
 #include "uv.h"
@@ -79,6 +81,7 @@ class ShadowRealm;
 namespace contextify {
 class ContextifyScript;
 class CompiledFnEntry;
+class CompiledScriptCache;
 }
 
 namespace performance {
@@ -102,6 +105,7 @@ class ParentInspectorHandle;
 #endif  // HAVE_INSPECTOR
 
 namespace worker {
+class IsolatePool;
 class Worker;
 }
 
@@ -110,6 +114,8 @@ class ModuleWrap;
 }  // namespace loader
 
 class Environment;
+class LoopPhaseMonitor;
+class LoopStallWatchdog;
 class Realm;
 
 struct IsolateDataSerializeInfo {
@@ -677,6 +683,10 @@ class Environment final : public MemoryRetainer {
 
   void CleanupHandles();
   void Exit(ExitCode code);
+  // The --fast-exit path: runs the AtExit callbacks and the essential cleanup
+  // hooks, flushes stdio and the trace file and then ends the process without
+  // tearing the Environment, the isolate or the platform down.
+  [[noreturn]] void FastExit(ExitCode code);
   void ExitEnv(StopFlags::Flags flags);
   void ClosePerEnvHandles();
 
@@ -771,6 +781,22 @@ class Environment final : public MemoryRetainer {
   EnabledDebugList* enabled_debug_list() { return &enabled_debug_list_; }
 
   inline performance::PerformanceState* performance_state();
+  // The monitor that AsyncWrap::MakeCallback() reports callback durations
+  // to, while one is started.
+  inline LoopPhaseMonitor* loop_phase_monitor() const;
+  inline void set_loop_phase_monitor(LoopPhaseMonitor* monitor);
+
+  // The totals, per AsyncWrap provider type, of the callbacks that
+  // AsyncWrap::MakeCallback() enters from the event loop. The list has an
+  // entry for every provider while accounting is enabled and is empty
+  // otherwise.
+  struct AsyncCallbackTotals {
+    uint64_t count = 0;
+    uint64_t cpu_time = 0;  // In nanoseconds of thread CPU time.
+    // Only counted in builds with allocation counting.
+    uint64_t allocations = 0;
+  };
+  inline std::vector<AsyncCallbackTotals>& async_callback_totals();
 
   v8::Maybe<void> CollectUVExceptionInfo(v8::Local<v8::Value> context,
                                          int errorno,
@@ -818,6 +844,12 @@ class Environment final : public MemoryRetainer {
   inline void add_sub_worker_context(worker::Worker* context);
   inline void remove_sub_worker_context(worker::Worker* context);
   void stop_sub_worker_contexts();
+  // The pool of ready Isolates for Workers started from this Environment,
+  // if any. Shut down by stop_sub_worker_contexts().
+  inline const std::shared_ptr<worker::IsolatePool>& worker_isolate_pool()
+      const;
+  inline void set_worker_isolate_pool(
+      std::shared_ptr<worker::IsolatePool> pool);
   template <typename Fn>
   inline void ForEachWorker(Fn&& iterator);
   // Determine if the environment is stopping. This getter is thread-safe.
@@ -963,6 +995,9 @@ class Environment final : public MemoryRetainer {
   void ToggleTimerRef(bool ref);
 
   inline void AddCleanupHook(CleanupQueue::Callback cb, void* arg);
+  // For hooks that must run even when --fast-exit skips the others, such as
+  // ones that write out data that would otherwise be lost.
+  inline void AddEssentialCleanupHook(CleanupQueue::Callback cb, void* arg);
   inline void RemoveCleanupHook(CleanupQueue::Callback cb, void* arg);
   void RunCleanup();
 
@@ -1025,18 +1060,33 @@ class Environment final : public MemoryRetainer {
 
   inline CompileCacheHandler* compile_cache_handler();
   inline bool use_compile_cache() const;
+  // Returns nullptr unless --experimental-module-prefetch is enabled.
+  inline loader::ModulePrefetcher* module_prefetcher();
   void InitializeCompileCache();
   // Enable built-in compile cache if it has not yet been enabled.
   // The cache will be persisted to disk on exit.
   CompileCacheEnableResult EnableCompileCache(const std::string& cache_dir,
                                               EnableOption option);
-  void FlushCompileCache();
+  void FlushCompileCache(bool after_warmup = false);
 
   void RunAndClearNativeImmediates(bool only_refed = false);
   void RunAndClearInterrupts();
 
+  // How often RunAndClearNativeImmediates() ran out of the budget set by
+  // --native-immediate-budget(-us), and how many callbacks it deferred to a
+  // later loop iteration because of that.
+  struct NativeImmediateBudgetStats {
+    uint64_t exhausted = 0;
+    uint64_t deferred = 0;
+  };
+  inline const NativeImmediateBudgetStats& native_immediate_budget_stats()
+      const;
+
   uv_buf_t allocate_managed_buffer(const size_t suggested_size);
   std::unique_ptr<v8::BackingStore> release_managed_buffer(const uv_buf_t& buf);
+  // The pool stream reads allocate from, or nullptr unless
+  // --stream-read-buffer-pool is set.
+  ReadBufferPool* read_buffer_pool();
 
   void AddUnmanagedFd(int fd);
   void RemoveUnmanagedFd(int fd);
@@ -1072,10 +1122,25 @@ class Environment final : public MemoryRetainer {
 #endif  // OPENSSL_VERSION_MAJOR >= 3
   std::unordered_map<std::string, size_t> alias_to_md_id_map;
   std::vector<std::string> supported_hash_algorithms;
+  // The primitive fields of recently converted X.509 certificates, most
+  // recently used first, by SHA-256 fingerprint. See X509ToObject().
+  using X509FieldCacheEntry =
+      std::pair<std::string, std::vector<v8::Global<v8::Value>>>;
+  std::list<X509FieldCacheEntry> x509_field_cache;
+  std::unordered_map<std::string_view, std::list<X509FieldCacheEntry>::iterator>
+      x509_field_cache_index;
 #endif  // HAVE_OPENSSL
 
   v8::Global<v8::Module> temporary_required_module_facade_original;
 
+  // Contexts for vm.createContext() that were created ahead of time, see
+  // ContextifyContext::SetContextPoolSize().
+  std::vector<v8::Global<v8::Context>> contextify_context_pool;
+  size_t contextify_context_pool_size = 0;
+  bool contextify_context_pool_refill_pending = false;
+  // Created on first use.
+  std::unique_ptr<contextify::CompiledScriptCache> compiled_script_cache;
+
  private:
   inline void ThrowError(v8::Local<v8::Value> (*fun)(v8::Local<v8::String>,
                                                      v8::Local<v8::Value>),
@@ -1133,6 +1198,8 @@ class Environment final : public MemoryRetainer {
 #endif  // HAVE_INSPECTOR
 
   std::unique_ptr<CompileCacheHandler> compile_cache_handler_;
+  std::unique_ptr<LoopStallWatchdog> loop_stall_watchdog_;
+  std::unique_ptr<loader::ModulePrefetcher> module_prefetcher_;
   std::shared_ptr<EnvironmentOptions> options_;
   // options_ contains debug options parsed from CLI arguments,
   // while inspector_host_port_ stores the actual inspector host
@@ -1177,6 +1244,8 @@ class Environment final : public MemoryRetainer {
   // This is the time when the environment is created.
   const uint64_t environment_start_;
   std::unique_ptr<performance::PerformanceState> performance_state_;
+  LoopPhaseMonitor* loop_phase_monitor_ = nullptr;
+  std::vector<AsyncCallbackTotals> async_callback_totals_;
 
   bool has_serialized_options_ = false;
 
@@ -1184,6 +1253,7 @@ class Environment final : public MemoryRetainer {
   uint64_t thread_id_;
   std::string thread_name_;
   std::unordered_set<worker::Worker*> sub_worker_contexts_;
+  std::shared_ptr<worker::IsolatePool> worker_isolate_pool_;
 
 #if HAVE_INSPECTOR
   std::unique_ptr<inspector::Agent> inspector_agent_;
@@ -1225,6 +1295,14 @@ class Environment final : public MemoryRetainer {
   Mutex native_immediates_threadsafe_mutex_;
   NativeImmediateQueue native_immediates_threadsafe_;
   NativeImmediateQueue native_immediates_interrupts_;
+  // Threadsafe immediates that were taken from native_immediates_threadsafe_
+  // but not run because the budget ran out. Only used on the Environment's
+  // thread, and run before newer threadsafe immediates.
+  NativeImmediateQueue native_immediates_threadsafe_deferred_;
+  NativeImmediateBudgetStats native_immediate_budget_stats_;
+  // Whether the last RunAndClearNativeImmediates() left work for the next
+  // loop iteration.
+  bool native_immediates_out_of_budget_ = false;
   // Also guarded by native_immediates_threadsafe_mutex_. This can be used when
   // trying to post tasks from other threads to an Environment, as the libuv
   // handle for the immediate queues (task_queues_async_) may not be initialized
@@ -1252,6 +1330,7 @@ class Environment final : public MemoryRetainer {
   // track of the BackingStore for a given pointer.
   std::unordered_map<char*, std::unique_ptr<v8::BackingStore>>
       released_allocated_buffers_;
+  DeleteFnPtr<ReadBufferPool, ReadBufferPool::Detach> read_buffer_pool_;
 
   v8::CpuProfiler* cpu_profiler_ = nullptr;
   std::vector<v8::ProfilerId> pending_profiles_;
@@ -266,6 +266,7 @@
   V(onhandshakestart_string, "onhandshakestart")                               \
   V(onkeylog_string, "onkeylog")                                               \
   V(onmessage_string, "onmessage")                                             \
+  V(onmessagebatch_string, "onmessagebatch")                                   \
   V(onnewsession_string, "onnewsession")                                       \
   V(onocspresponse_string, "onocspresponse")                                   \
   V(onreadstart_string, "onreadstart")                                         \
@@ -306,6 +307,7 @@
   V(rate_string, "rate")                                                       \
   V(read_host_object_string, "_readHostObject")                                \
   V(readable_string, "readable")                                               \
+  V(readonly_string, "readonly")                                               \
   V(read_bigints_string, "readBigInts")                                        \
   V(reason_string, "reason")                                                   \
   V(remaining_pages_string, "remainingPages")                                  \
@@ -324,6 +326,7 @@
   V(servername_string, "servername")                                           \
   V(session_id_string, "sessionId")                                            \
   V(set_string, "set")                                                         \
+  V(share_string, "share")                                                     \
   V(shared_string, "shared")                                                   \
   V(shell_string, "shell")                                                     \
   V(signal_string, "signal")                                                   \
@@ -384,6 +387,7 @@
   V(blob_constructor_template, v8::FunctionTemplate)                           \
   V(blob_reader_constructor_template, v8::FunctionTemplate)                    \
   V(blocklist_constructor_template, v8::FunctionTemplate)                      \
+  V(buffer_list_constructor_template, v8::FunctionTemplate)                    \
   V(caa_record_template, v8::DictionaryTemplate)                               \
   V(callsite_template, v8::DictionaryTemplate)                                 \
   V(cipherinfo_detail_template, v8::DictionaryTemplate)                        \
@@ -391,6 +395,7 @@
   V(cname_record_template, v8::DictionaryTemplate)                             \
   V(compiled_function_cjs_template, v8::DictionaryTemplate)                    \
   V(compiled_function_template, v8::DictionaryTemplate)                        \
+  V(compressiondictionary_constructor_template, v8::FunctionTemplate)          \
   V(contextify_global_template, v8::ObjectTemplate)                            \
   V(contextify_wrapper_template, v8::ObjectTemplate)                           \
   V(cpu_usage_template, v8::DictionaryTemplate)                                \
@@ -414,6 +419,7 @@
   V(http2ping_constructor_template, v8::ObjectTemplate)                        \
   V(i18n_converter_template, v8::ObjectTemplate)                               \
   V(intervalhistogram_constructor_template, v8::FunctionTemplate)              \
+  V(loopphasemonitor_constructor_template, v8::FunctionTemplate)               \
   V(iter_template, v8::DictionaryTemplate)                                     \
   V(js_transferable_constructor_template, v8::FunctionTemplate)                \
   V(libuv_stream_wrap_ctor_template, v8::FunctionTemplate)                     \
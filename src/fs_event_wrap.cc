@@ -27,6 +27,18 @@
 #include "permission/permission.h"
 #include "string_bytes.h"
 
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#endif  // __linux__
+
 namespace node {
 
 using v8::Context;
@@ -72,8 +84,34 @@ class FSEventWrap: public HandleWrap {
 
   static void OnEvent(uv_fs_event_t* handle, const char* filename, int events,
     int status);
-
-  uv_fs_event_t handle_;
+  void Emit(int status, int events, const char* filename);
+
+#ifdef __linux__
+  // libuv has no recursive watches on Linux. Rather than having JS create a
+  // watcher for every directory in the tree, recursive watches read their
+  // own inotify fd, which has a watch for each directory, and report each
+  // changed path once per read of the fd.
+  int StartRecursive(const char* path);
+  int AddDirectory(const std::string& relative, bool report_contents);
+  void RemoveDirectory(const std::string& relative);
+  void Queue(const std::string& filename, int events);
+  static void OnInotifyEvents(uv_poll_t* handle, int status, int events);
+  void OnClose() override;
+
+  int inotify_fd_ = -1;
+  std::string root_;
+  // Paths relative to root_, by watch descriptor; the root itself is "".
+  std::unordered_map<int, std::string> directories_;
+  std::vector<std::pair<std::string, int>> pending_;
+  std::unordered_map<std::string, size_t> pending_index_;
+#endif  // __linux__
+
+  union {
+    uv_fs_event_t handle_;
+#ifdef __linux__
+    uv_poll_t poll_;
+#endif  // __linux__
+  };
   enum encoding encoding_ = kDefaultEncoding;
 };
 
@@ -157,6 +195,17 @@ void FSEventWrap::Start(const FunctionCallbackInfo<Value>& args) {
 
   wrap->encoding_ = ParseEncoding(env->isolate(), args[3], kDefaultEncoding);
 
+#ifdef __linux__
+  if (flags & UV_FS_EVENT_RECURSIVE) {
+    int err = wrap->StartRecursive(*path);
+    if (err != 0) return args.GetReturnValue().Set(err);
+    if (!args[1]->IsTrue()) {
+      uv_unref(reinterpret_cast<uv_handle_t*>(&wrap->poll_));
+    }
+    return args.GetReturnValue().Set(0);
+  }
+#endif  // __linux__
+
   int err = uv_fs_event_init(wrap->env()->event_loop(), &wrap->handle_);
   if (err != 0) {
     return args.GetReturnValue().Set(err);
@@ -182,6 +231,12 @@ void FSEventWrap::Start(const FunctionCallbackInfo<Value>& args) {
 void FSEventWrap::OnEvent(uv_fs_event_t* handle, const char* filename,
     int events, int status) {
   FSEventWrap* wrap = static_cast<FSEventWrap*>(handle->data);
+  wrap->Emit(status, events, filename);
+}
+
+
+void FSEventWrap::Emit(int status, int events, const char* filename) {
+  FSEventWrap* wrap = this;
   Environment* env = wrap->env();
 
   HandleScope handle_scope(env->isolate());
@@ -239,6 +294,158 @@ void FSEventWrap::OnEvent(uv_fs_event_t* handle, const char* filename,
   wrap->MakeCallback(env->onchange_string(), arraysize(argv), argv);
 }
 
+#ifdef __linux__
+int FSEventWrap::StartRecursive(const char* path) {
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd == -1) return uv_translate_sys_error(errno);
+
+  int err = uv_poll_init(env()->event_loop(), &poll_, fd);
+  if (err != 0) {
+    close(fd);
+    return err;
+  }
+  inotify_fd_ = fd;
+  MarkAsInitialized();
+
+  root_ = path;
+  while (root_.size() > 1 && root_.back() == '/') root_.pop_back();
+  err = AddDirectory("", false);
+  if (err == 0) err = uv_poll_start(&poll_, UV_READABLE, OnInotifyEvents);
+  if (err != 0) {
+    Close();
+    return err;
+  }
+  return 0;
+}
+
+int FSEventWrap::AddDirectory(const std::string& relative,
+                               bool report_contents) {
+  const std::string path = relative.empty() ? root_ : root_ + "/" + relative;
+  constexpr uint32_t kMask = IN_ATTRIB | IN_CREATE | IN_MODIFY | IN_DELETE |
+                             IN_DELETE_SELF | IN_MOVE_SELF | IN_MOVED_FROM |
+                             IN_MOVED_TO | IN_ONLYDIR;
+  const int wd = inotify_add_watch(inotify_fd_, path.c_str(), kMask);
+  // A subdirectory may already be gone again, its removal is reported anyway.
+  if (wd == -1) return uv_translate_sys_error(errno);
+  directories_[wd] = relative;
+
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) return 0;
+  while (const dirent* entry = readdir(dir)) {
+    const char* name = entry->d_name;
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+    const std::string child = relative.empty() ? name : relative + "/" + name;
+    // Entries created before the watch was added have no events of their
+    // own, so report them as if they were created now.
+    if (report_contents) Queue(child, UV_RENAME);
+    bool is_dir = entry->d_type == DT_DIR;
+    if (entry->d_type == DT_UNKNOWN) {
+      struct stat s;
+      is_dir = lstat((root_ + "/" + child).c_str(), &s) == 0 &&
+               S_ISDIR(s.st_mode);
+    }
+    if (is_dir) AddDirectory(child, report_contents);
+  }
+  closedir(dir);
+  return 0;
+}
+
+void FSEventWrap::RemoveDirectory(const std::string& relative) {
+  const std::string prefix = relative + "/";
+  for (auto it = directories_.begin(); it != directories_.end();) {
+    const std::string& dir = it->second;
+    if (dir == relative || dir.compare(0, prefix.size(), prefix) == 0) {
+      inotify_rm_watch(inotify_fd_, it->first);
+      it = directories_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void FSEventWrap::Queue(const std::string& filename, int events) {
+  auto [it, inserted] = pending_index_.try_emplace(filename, pending_.size());
+  if (inserted) {
+    pending_.emplace_back(filename, events);
+  } else {
+    pending_[it->second].second |= events;
+  }
+}
+
+void FSEventWrap::OnInotifyEvents(uv_poll_t* handle, int status, int events) {
+  FSEventWrap* wrap = static_cast<FSEventWrap*>(handle->data);
+  if (status != 0) return wrap->Emit(status, 0, nullptr);
+
+  alignas(inotify_event) char buf[64 * 1024];
+  bool overflow = false;
+  for (;;) {
+    ssize_t size;
+    do {
+      size = read(wrap->inotify_fd_, buf, sizeof(buf));
+    } while (size == -1 && errno == EINTR);
+    if (size <= 0) break;
+
+    const inotify_event* e;
+    for (const char* p = buf; p < buf + size; p += sizeof(*e) + e->len) {
+      e = reinterpret_cast<const inotify_event*>(p);
+      if (e->mask & IN_Q_OVERFLOW) {
+        overflow = true;
+        continue;
+      }
+      auto dir = wrap->directories_.find(e->wd);
+      if (dir == wrap->directories_.end()) continue;
+      if (e->mask & IN_IGNORED) {
+        wrap->directories_.erase(dir);
+        continue;
+      }
+      // The events of a directory itself are also reported by its parent,
+      // except for the root.
+      if (e->len == 0 && !dir->second.empty()) continue;
+      // Copy the path; adding or removing directories can rehash the map.
+      const std::string relative = dir->second;
+      std::string filename;
+      if (e->len != 0) {
+        const char* name = reinterpret_cast<const char*>(e + 1);
+        filename = relative.empty() ? name : relative + "/" + name;
+      } else {
+        const size_t slash = wrap->root_.rfind('/');
+        filename = slash == std::string::npos || wrap->root_.size() == 1
+                       ? wrap->root_
+                       : wrap->root_.substr(slash + 1);
+      }
+
+      wrap->Queue(filename,
+                  e->mask & ~(IN_ATTRIB | IN_MODIFY | IN_ISDIR) ? UV_RENAME
+                                                                : UV_CHANGE);
+      if (e->mask & IN_ISDIR) {
+        if (e->mask & (IN_CREATE | IN_MOVED_TO)) {
+          wrap->AddDirectory(filename, true);
+        } else if (e->mask & IN_MOVED_FROM) {
+          wrap->RemoveDirectory(filename);
+        }
+      }
+    }
+  }
+
+  std::vector<std::pair<std::string, int>> pending = std::move(wrap->pending_);
+  wrap->pending_.clear();
+  wrap->pending_index_.clear();
+  // Too many events to read; all we know is that something changed.
+  if (overflow) pending.emplace_back(std::string(), UV_RENAME);
+  for (const auto& [filename, flags] : pending) {
+    wrap->Emit(0, flags, filename.empty() ? nullptr : filename.c_str());
+    if (wrap->IsHandleClosing()) break;
+  }
+}
+
+void FSEventWrap::OnClose() {
+  if (inotify_fd_ != -1) {
+    close(inotify_fd_);
+    inotify_fd_ = -1;
+  }
+}
+#endif  // __linux__
+
 }  // anonymous namespace
 }  // namespace node
 
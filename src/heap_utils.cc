@@ -7,6 +7,13 @@
 #include "stream_base-inl.h"
 #include "util-inl.h"
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif  // __linux__
+
 // Copied from https://github.com/nodejs/node/blob/b07dc4d19fdbc15b4f76557dc45b3ce3a43ad0c3/src/util.cc#L36-L41.
 #ifdef _WIN32
 #include <io.h>  // _S_IREAD _S_IWRITE
@@ -35,7 +42,9 @@ using v8::JustVoid;
 using v8::Local;
 using v8::Maybe;
 using v8::MaybeLocal;
+using v8::Name;
 using v8::Nothing;
+using v8::Null;
 using v8::Number;
 using v8::Object;
 using v8::ObjectTemplate;
@@ -219,6 +228,158 @@ void BuildEmbedderGraph(const FunctionCallbackInfo<Value>& args) {
     args.GetReturnValue().Set(ret);
 }
 
+// The subsystems that memoryBreakdown() sums native memory by.
+#define MEMORY_BREAKDOWN_CATEGORIES(V)                                         \
+  V(kHttp2, "http2")                                                           \
+  V(kZlib, "zlib")                                                             \
+  V(kTls, "tls")                                                               \
+  V(kStreams, "streams")                                                       \
+  V(kCompileCache, "compileCache")                                             \
+  V(kPermission, "permission")                                                 \
+  V(kOther, "other")
+
+enum class MemoryCategory {
+#define V(category, _) category,
+  MEMORY_BREAKDOWN_CATEGORIES(V)
+#undef V
+  kCount
+};
+
+// Retainers are put into a category by the prefix of their MemoryInfoName().
+const struct {
+  const char* prefix;
+  MemoryCategory category;
+} kMemoryCategoryPrefixes[] = {
+    {"Http2", MemoryCategory::kHttp2},
+    {"NgHttp2", MemoryCategory::kHttp2},
+    {"NgHeader", MemoryCategory::kHttp2},
+    {"NgRcBuf", MemoryCategory::kHttp2},
+    {"Zlib", MemoryCategory::kZlib},
+    {"Brotli", MemoryCategory::kZlib},
+    {"Zstd", MemoryCategory::kZlib},
+    {"Compression", MemoryCategory::kZlib},
+    {"TLS", MemoryCategory::kTls},
+    {"SecureContext", MemoryCategory::kTls},
+    {"NodeBIO", MemoryCategory::kTls},
+    {"TCP", MemoryCategory::kStreams},
+    {"PipeWrap", MemoryCategory::kStreams},
+    {"TTYWrap", MemoryCategory::kStreams},
+    {"JSStream", MemoryCategory::kStreams},
+    {"StreamPipe", MemoryCategory::kStreams},
+    {"SimpleWriteWrap", MemoryCategory::kStreams},
+    {"SimpleShutdownWrap", MemoryCategory::kStreams},
+    {"FileHandle", MemoryCategory::kStreams},
+    {"CompileCache", MemoryCategory::kCompileCache},
+    {"Permission", MemoryCategory::kPermission},
+};
+
+// Collects the nodes and edges that MemoryTracker produces for an
+// Environment, without the JavaScript values, which have no native size, and
+// sums the sizes of the nodes by category. A node that has no category of its
+// own takes the one of the first categorized node that retains it, so the
+// buffers of an Http2Session count as http2, and nodes that are only
+// retained by uncategorized ones count as other.
+class MemoryBreakdownGraph : public EmbedderGraph {
+ public:
+  Node* V8Node(const Local<Data>& value) override { return &js_node_; }
+  Node* V8Node(const Local<Value>& value) override { return &js_node_; }
+
+  Node* AddNode(std::unique_ptr<Node> node) override {
+    nodes_.push_back(std::move(node));
+    return nodes_.back().get();
+  }
+
+  void AddEdge(Node* from, Node* to, const char* name = nullptr) override {
+    if (to->IsEmbedderNode()) edges_[from].push_back(to);
+  }
+
+  void Sum(double totals[static_cast<size_t>(MemoryCategory::kCount)]) const {
+    std::unordered_map<Node*, MemoryCategory> categories;
+    std::vector<Node*> stack;
+    // Nodes are added before the ones they retain.
+    for (const std::unique_ptr<Node>& root : nodes_) {
+      const MemoryCategory category = CategoryOf(root.get());
+      if (category == MemoryCategory::kOther ||
+          !categories.emplace(root.get(), category).second) {
+        continue;
+      }
+      stack.push_back(root.get());
+      while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        auto it = edges_.find(node);
+        if (it == edges_.end()) continue;
+        for (Node* child : it->second) {
+          if (CategoryOf(child) != MemoryCategory::kOther ||
+              !categories.emplace(child, category).second) {
+            continue;
+          }
+          stack.push_back(child);
+        }
+      }
+    }
+
+    for (const std::unique_ptr<Node>& node : nodes_) {
+      auto it = categories.find(node.get());
+      const MemoryCategory category =
+          it == categories.end() ? MemoryCategory::kOther : it->second;
+      totals[static_cast<size_t>(category)] +=
+          static_cast<double>(node->SizeInBytes());
+    }
+  }
+
+ private:
+  class JSNode : public Node {
+   public:
+    const char* Name() override { return "<JS Node>"; }
+    size_t SizeInBytes() override { return 0; }
+    bool IsEmbedderNode() override { return false; }
+  };
+
+  static MemoryCategory CategoryOf(Node* node) {
+    const char* name = node->Name();
+    for (const auto& entry : kMemoryCategoryPrefixes) {
+      if (strncmp(name, entry.prefix, strlen(entry.prefix)) == 0) {
+        return entry.category;
+      }
+    }
+    return MemoryCategory::kOther;
+  }
+
+  JSNode js_node_;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::unordered_map<Node*, std::vector<Node*>> edges_;
+};
+
+// Returns the native memory of the current Environment in bytes, by
+// subsystem and in total. This walks the same MemoryRetainers as a heap
+// snapshot does, but not the JavaScript heap, so it is cheap enough to call
+// periodically.
+void MemoryBreakdown(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  MemoryBreakdownGraph graph;
+  Environment::BuildEmbedderGraph(isolate, &graph, env);
+  double totals[static_cast<size_t>(MemoryCategory::kCount)] = {};
+  graph.Sum(totals);
+
+  double total = 0;
+  for (double bytes : totals) total += bytes;
+  Local<Name> names[] = {
+#define V(_, name) FIXED_ONE_BYTE_STRING(isolate, name),
+      MEMORY_BREAKDOWN_CATEGORIES(V)
+#undef V
+      FIXED_ONE_BYTE_STRING(isolate, "total"),
+  };
+  Local<Value> values[arraysize(names)];
+  for (size_t i = 0; i < arraysize(totals); i++) {
+    values[i] = Number::New(isolate, totals[i]);
+  }
+  values[arraysize(totals)] = Number::New(isolate, total);
+  args.GetReturnValue().Set(Object::New(
+      isolate, Null(isolate), names, values, arraysize(names)));
+}
+
 namespace {
 class FileOutputStream : public v8::OutputStream {
  public:
@@ -350,6 +511,50 @@ inline void TakeSnapshot(Environment* env,
   snapshot->Serialize(out, HeapSnapshot::kJSON);
 }
 
+#ifdef __linux__
+// The snapshot is taken in the child from the state of the heap at the time
+// of the fork. That thread is the only one in the child, so the snapshot can
+// wait forever on GC work that another thread was doing; the child is killed
+// after this many seconds instead.
+constexpr unsigned int kForkedSnapshotTimeoutSeconds = 600;
+
+// Takes the snapshot in a forked copy of the process, so that the memory of
+// the snapshot is never allocated in this one, and waits for it to be
+// written. Returns 0 or a libuv error, and sets syscall to what failed.
+int TakeSnapshotInChild(Environment* env,
+                        FileOutputStream* out,
+                        HeapProfiler::HeapSnapshotOptions options,
+                        const char** syscall) {
+  *syscall = "fork";
+  const pid_t pid = fork();
+  if (pid < 0) return -errno;
+
+  if (pid == 0) {
+    signal(SIGALRM, SIG_DFL);
+    alarm(kForkedSnapshotTimeoutSeconds);
+    // If memory runs out, it is the child that should be killed.
+    const int oom_fd = open("/proc/self/oom_score_adj", O_WRONLY | O_CLOEXEC);
+    if (oom_fd >= 0) {
+      USE(write(oom_fd, "1000", 4));
+      close(oom_fd);
+    }
+    TakeSnapshot(env, out, options);
+    // The libuv errors are negated errno codes, which fit in the status.
+    _exit(-out->status());
+  }
+
+  int status;
+  while (waitpid(pid, &status, 0) == -1) {
+    if (errno != EINTR) return -errno;
+  }
+  if (WIFSIGNALED(status)) {
+    return WTERMSIG(status) == SIGALRM ? UV_ETIMEDOUT : UV_ECANCELED;
+  }
+  *syscall = "write";
+  return -WEXITSTATUS(status);
+}
+#endif  // __linux__
+
 }  // namespace
 
 Maybe<void> WriteSnapshot(Environment* env,
@@ -371,9 +576,20 @@ Maybe<void> WriteSnapshot(Environment* env,
   }
 
   FileOutputStream stream(fd, &req);
+  const char* syscall = "write";
+#ifdef __linux__
+  if (env->options()->heap_snapshot_fork) {
+    err = TakeSnapshotInChild(env, &stream, options, &syscall);
+  } else {
+    TakeSnapshot(env, &stream, options);
+    err = stream.status();
+  }
+#else
   TakeSnapshot(env, &stream, options);
-  if ((err = stream.status()) < 0) {
-    env->ThrowUVException(err, "write", nullptr, filename);
+  err = stream.status();
+#endif  // __linux__
+  if (err < 0) {
+    env->ThrowUVException(err, syscall, nullptr, filename);
     return Nothing<void>();
   }
 
@@ -479,6 +695,7 @@ void Initialize(Local<Object> target,
                 Local<Context> context,
                 void* priv) {
   SetMethod(context, target, "buildEmbedderGraph", BuildEmbedderGraph);
+  SetMethod(context, target, "memoryBreakdown", MemoryBreakdown);
   SetMethod(context, target, "triggerHeapSnapshot", TriggerHeapSnapshot);
   SetMethod(
       context, target, "createHeapSnapshotStream", CreateHeapSnapshotStream);
@@ -486,6 +703,7 @@ void Initialize(Local<Object> target,
 
 void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(BuildEmbedderGraph);
+  registry->Register(MemoryBreakdown);
   registry->Register(TriggerHeapSnapshot);
   registry->Register(CreateHeapSnapshotStream);
 }
@@ -19,16 +19,28 @@ void Histogram::Reset() {
 
 double Histogram::Add(const Histogram& other) {
   Mutex::ScopedLock lock(mutex_);
-  count_ += other.count_;
-  exceeds_ += other.exceeds_;
-  if (other.prev_ > prev_)
-    prev_ = other.prev_;
-  return static_cast<double>(hdr_add(histogram_.get(), other.histogram_.get()));
+  count_.fetch_add(other.Count(), std::memory_order_relaxed);
+  exceeds_.fetch_add(other.Exceeds(), std::memory_order_relaxed);
+  uint64_t other_prev = other.prev_.load(std::memory_order_relaxed);
+  uint64_t prev = prev_.load(std::memory_order_relaxed);
+  while (other_prev > prev &&
+         !prev_.compare_exchange_weak(prev, other_prev,
+                                      std::memory_order_relaxed)) {
+  }
+  // Like hdr_add(), but with atomic increments since values may be recorded
+  // into this histogram at the same time.
+  hdr_iter iter;
+  int64_t dropped = 0;
+  hdr_iter_recorded_init(&iter, other.histogram_.get());
+  while (hdr_iter_next(&iter)) {
+    if (!hdr_record_values_atomic(histogram_.get(), iter.value, iter.count))
+      dropped += iter.count;
+  }
+  return static_cast<double>(dropped);
 }
 
 size_t Histogram::Count() const {
-  Mutex::ScopedLock lock(mutex_);
-  return count_;
+  return count_.load(std::memory_order_relaxed);
 }
 
 int64_t Histogram::Min() const {
@@ -70,28 +82,23 @@ void Histogram::Percentiles(Iterator&& fn) {
 }
 
 bool Histogram::Record(int64_t value) {
-  Mutex::ScopedLock lock(mutex_);
-  bool recorded = hdr_record_value(histogram_.get(), value);
+  bool recorded = hdr_record_value_atomic(histogram_.get(), value);
   if (!recorded)
-    exceeds_++;
+    exceeds_.fetch_add(1, std::memory_order_relaxed);
   else
-    count_++;
+    count_.fetch_add(1, std::memory_order_relaxed);
   return recorded;
 }
 
 uint64_t Histogram::RecordDelta() {
-  Mutex::ScopedLock lock(mutex_);
   uint64_t time = uv_hrtime();
+  uint64_t prev = prev_.exchange(time, std::memory_order_relaxed);
   int64_t delta = 0;
-  if (prev_ > 0) {
-    CHECK_GE(time, prev_);
-    delta = time - prev_;
-    if (hdr_record_value(histogram_.get(), delta))
-      count_++;
-    else
-      exceeds_++;
+  // Another thread may have swapped in a later time first.
+  if (prev > 0 && time >= prev) {
+    delta = time - prev;
+    Record(delta);
   }
-  prev_ = time;
   return delta;
 }
 
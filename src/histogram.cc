@@ -612,4 +612,216 @@ IntervalHistogram::CloneForMessaging() const {
   return std::make_unique<HistogramBase::HistogramTransferData>(histogram());
 }
 
+Local<FunctionTemplate> LoopPhaseMonitor::GetConstructorTemplate(
+    Environment* env) {
+  Local<FunctionTemplate> tmpl = env->loopphasemonitor_constructor_template();
+  if (tmpl.IsEmpty()) {
+    Isolate* isolate = env->isolate();
+    tmpl = NewFunctionTemplate(isolate, nullptr);
+    tmpl->Inherit(HandleWrap::GetConstructorTemplate(env));
+    tmpl->SetClassName(FIXED_ONE_BYTE_STRING(isolate, "LoopPhaseMonitor"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(
+        HandleWrap::kInternalFieldCount);
+    SetProtoMethod(isolate, tmpl, "start", Start);
+    SetProtoMethod(isolate, tmpl, "stop", Stop);
+    SetProtoMethodNoSideEffect(
+        isolate, tmpl, "phaseHistograms", GetPhaseHistograms);
+    SetProtoMethodNoSideEffect(
+        isolate, tmpl, "providerHistograms", GetProviderHistograms);
+    env->set_loopphasemonitor_constructor_template(tmpl);
+  }
+  return tmpl;
+}
+
+void LoopPhaseMonitor::RegisterExternalReferences(
+    ExternalReferenceRegistry* registry) {
+  registry->Register(Start);
+  registry->Register(Stop);
+  registry->Register(GetPhaseHistograms);
+  registry->Register(GetProviderHistograms);
+}
+
+LoopPhaseMonitor::LoopPhaseMonitor(Environment* env, Local<Object> wrap)
+    : HandleWrap(env,
+                 wrap,
+                 reinterpret_cast<uv_handle_t*>(&prepare_),
+                 AsyncWrap::PROVIDER_LOOPPHASEMONITOR) {
+  MakeWeak();
+  for (auto& histogram : phase_histograms_)
+    histogram = std::make_shared<Histogram>(Histogram::Options{});
+  uv_prepare_init(env->event_loop(), &prepare_);
+}
+
+LoopPhaseMonitor::~LoopPhaseMonitor() {
+  if (env()->loop_phase_monitor() == this)
+    env()->set_loop_phase_monitor(nullptr);
+}
+
+BaseObjectPtr<LoopPhaseMonitor> LoopPhaseMonitor::Create(Environment* env) {
+  Local<Object> obj;
+  if (!GetConstructorTemplate(env)
+          ->InstanceTemplate()
+          ->NewInstance(env->context()).ToLocal(&obj)) {
+    return nullptr;
+  }
+
+  return MakeBaseObject<LoopPhaseMonitor>(env, obj);
+}
+
+void LoopPhaseMonitor::Snapshot() {
+  uv_loop_t* loop = env()->event_loop();
+  for (int i = 0; i < UV_METRICS_PHASE_MAX; i++) {
+    last_phase_time_[i] =
+        uv_metrics_phase_time(loop, static_cast<uv_metrics_phase>(i));
+  }
+  last_idle_time_ = uv_metrics_idle_time(loop);
+}
+
+void LoopPhaseMonitor::Reset() {
+  for (auto& histogram : phase_histograms_)
+    histogram->Reset();
+  for (auto& histogram : provider_histograms_) {
+    if (histogram) histogram->Reset();
+  }
+}
+
+void LoopPhaseMonitor::PrepareCB(uv_prepare_t* handle) {
+  LoopPhaseMonitor* monitor = ContainerOf(&LoopPhaseMonitor::prepare_, handle);
+  uv_loop_t* loop = monitor->env()->event_loop();
+
+  // The prepare callbacks run after the pending phase of the iteration that
+  // is starting, so every counter but that one is complete for the previous
+  // iteration.
+  uint64_t delta[UV_METRICS_PHASE_MAX];
+  for (int i = 0; i < UV_METRICS_PHASE_MAX; i++) {
+    uint64_t total =
+        uv_metrics_phase_time(loop, static_cast<uv_metrics_phase>(i));
+    delta[i] = total - monitor->last_phase_time_[i];
+    monitor->last_phase_time_[i] = total;
+  }
+  uint64_t idle_time = uv_metrics_idle_time(loop);
+  uint64_t poll_wait = std::min(idle_time - monitor->last_idle_time_,
+                                delta[UV_METRICS_PHASE_POLL]);
+  monitor->last_idle_time_ = idle_time;
+
+  auto record = [&](Phase phase, uint64_t value) {
+    if (value == 0) return;
+    monitor->phase_histograms_[phase]->Record(
+        static_cast<int64_t>(std::min<uint64_t>(
+            value, std::numeric_limits<int64_t>::max())));
+  };
+  record(kTimers, delta[UV_METRICS_PHASE_TIMERS]);
+  record(kPending, delta[UV_METRICS_PHASE_PENDING]);
+  record(kIdlePrepare, delta[UV_METRICS_PHASE_IDLE_PREPARE]);
+  record(kPollWait, poll_wait);
+  record(kPollWork, delta[UV_METRICS_PHASE_POLL] - poll_wait);
+  record(kCheck, delta[UV_METRICS_PHASE_CHECK]);
+  record(kClosing, delta[UV_METRICS_PHASE_CLOSING]);
+}
+
+void LoopPhaseMonitor::RecordCallback(AsyncWrap::ProviderType provider,
+                                      uint64_t duration) {
+  DCHECK_LT(provider, AsyncWrap::PROVIDERS_LENGTH);
+  std::shared_ptr<Histogram>& histogram = provider_histograms_[provider];
+  if (!histogram)
+    histogram = std::make_shared<Histogram>(Histogram::Options{});
+  histogram->Record(static_cast<int64_t>(std::max<uint64_t>(
+      std::min<uint64_t>(duration, std::numeric_limits<int64_t>::max()), 1)));
+}
+
+void LoopPhaseMonitor::MemoryInfo(MemoryTracker* tracker) const {
+  for (const auto& histogram : phase_histograms_)
+    tracker->TrackField("phase_histogram", histogram);
+  for (const auto& histogram : provider_histograms_) {
+    if (histogram) tracker->TrackField("provider_histogram", histogram);
+  }
+}
+
+void LoopPhaseMonitor::OnStart(bool reset) {
+  if (enabled_ || IsHandleClosing()) return;
+  enabled_ = true;
+  if (reset) Reset();
+  // Enabling the counters is idempotent, and they cost nothing until then.
+  uv_loop_configure(env()->event_loop(), UV_METRICS_PHASE_TIME);
+  Snapshot();
+  uv_prepare_start(&prepare_, PrepareCB);
+  uv_unref(reinterpret_cast<uv_handle_t*>(&prepare_));
+  env()->set_loop_phase_monitor(this);
+}
+
+void LoopPhaseMonitor::OnStop() {
+  if (!enabled_ || IsHandleClosing()) return;
+  enabled_ = false;
+  uv_prepare_stop(&prepare_);
+  if (env()->loop_phase_monitor() == this)
+    env()->set_loop_phase_monitor(nullptr);
+}
+
+void LoopPhaseMonitor::OnClose() {
+  enabled_ = false;
+  if (env()->loop_phase_monitor() == this)
+    env()->set_loop_phase_monitor(nullptr);
+}
+
+void LoopPhaseMonitor::Start(const FunctionCallbackInfo<Value>& args) {
+  LoopPhaseMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.This());
+  monitor->OnStart(args[0]->IsTrue());
+}
+
+void LoopPhaseMonitor::Stop(const FunctionCallbackInfo<Value>& args) {
+  LoopPhaseMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.This());
+  monitor->OnStop();
+}
+
+void LoopPhaseMonitor::GetPhaseHistograms(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  LoopPhaseMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.This());
+  Local<Object> result = Object::New(env->isolate());
+#define V(phase, name)                                                         \
+  {                                                                            \
+    BaseObjectPtr<HistogramBase> histogram =                                   \
+        HistogramBase::Create(env, monitor->phase_histograms_[phase]);         \
+    if (!histogram ||                                                          \
+        result                                                                 \
+            ->Set(env->context(),                                              \
+                  FIXED_ONE_BYTE_STRING(env->isolate(), name),                 \
+                  histogram->object())                                         \
+            .IsNothing()) {                                                    \
+      return;                                                                  \
+    }                                                                          \
+  }
+  LOOP_PHASE_MONITOR_PHASES(V)
+#undef V
+  args.GetReturnValue().Set(result);
+}
+
+void LoopPhaseMonitor::GetProviderHistograms(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  LoopPhaseMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.This());
+  Local<Object> result = Object::New(env->isolate());
+  // Only the provider types that ran a callback since the last reset.
+#define V(PROVIDER)                                                            \
+  if (monitor->provider_histograms_[AsyncWrap::PROVIDER_##PROVIDER]) {         \
+    BaseObjectPtr<HistogramBase> histogram = HistogramBase::Create(            \
+        env, monitor->provider_histograms_[AsyncWrap::PROVIDER_##PROVIDER]);   \
+    if (!histogram ||                                                          \
+        result                                                                 \
+            ->Set(env->context(),                                              \
+                  FIXED_ONE_BYTE_STRING(env->isolate(), #PROVIDER),            \
+                  histogram->object())                                         \
+            .IsNothing()) {                                                    \
+      return;                                                                  \
+    }                                                                          \
+  }
+  NODE_ASYNC_PROVIDER_TYPES(V)
+#undef V
+  args.GetReturnValue().Set(result);
+}
+
 }  // namespace node
@@ -11,6 +11,7 @@
 #include "uv.h"
 #include "v8.h"
 
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <map>
@@ -33,6 +34,10 @@ class Histogram : public MemoryRetainer {
   explicit Histogram(const Options& options);
   virtual ~Histogram() = default;
 
+  // Record() and RecordDelta() do not lock, so that threads can record into
+  // a shared histogram concurrently, and concurrently with the other
+  // methods, which lock. The values that are recorded while the histogram
+  // is being reset may or may not be kept.
   inline bool Record(int64_t value);
   inline void Reset();
   inline int64_t Min() const;
@@ -40,7 +45,9 @@ class Histogram : public MemoryRetainer {
   inline double Mean() const;
   inline double Stddev() const;
   inline int64_t Percentile(double percentile) const;
-  inline size_t Exceeds() const { return exceeds_; }
+  inline size_t Exceeds() const {
+    return exceeds_.load(std::memory_order_relaxed);
+  }
   inline size_t Count() const;
 
   inline uint64_t RecordDelta();
@@ -61,9 +68,10 @@ class Histogram : public MemoryRetainer {
  private:
   using HistogramPointer = DeleteFnPtr<hdr_histogram, hdr_close>;
   HistogramPointer histogram_;
-  uint64_t prev_ = 0;
-  size_t exceeds_ = 0;
-  size_t count_ = 0;
+  std::atomic<uint64_t> prev_ = 0;
+  std::atomic<size_t> exceeds_ = 0;
+  std::atomic<size_t> count_ = 0;
+  // Serializes the methods other than Record() and RecordDelta().
   Mutex mutex_;
 };
 
@@ -256,6 +264,70 @@ class IntervalHistogram final : public HandleWrap, public HistogramImpl {
   static v8::CFunction fast_stop_;
 };
 
+// Times the phases of every event loop iteration, using libuv's
+// UV_METRICS_PHASE_TIME counters, and the top-level callbacks that each
+// AsyncWrap provider type runs from the loop. The time spent in the poll
+// phase is split into the time spent blocked waiting for events, which is
+// the loop's idle time, and the time spent running I/O callbacks.
+class LoopPhaseMonitor final : public HandleWrap {
+ public:
+#define LOOP_PHASE_MONITOR_PHASES(V)                                           \
+  V(kTimers, "timers")                                                         \
+  V(kPending, "pending")                                                       \
+  V(kIdlePrepare, "idlePrepare")                                               \
+  V(kPollWait, "pollWait")                                                     \
+  V(kPollWork, "pollWork")                                                     \
+  V(kCheck, "check")                                                           \
+  V(kClosing, "closing")
+
+  enum Phase {
+#define V(phase, _) phase,
+    LOOP_PHASE_MONITOR_PHASES(V)
+#undef V
+    kPhaseCount
+  };
+
+  static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+  static v8::Local<v8::FunctionTemplate> GetConstructorTemplate(
+      Environment* env);
+
+  static BaseObjectPtr<LoopPhaseMonitor> Create(Environment* env);
+
+  LoopPhaseMonitor(Environment* env, v8::Local<v8::Object> wrap);
+  ~LoopPhaseMonitor() override;
+
+  // Called by AsyncWrap::MakeCallback() for callbacks that were entered
+  // directly from the event loop, i.e. not nested in another callback.
+  void RecordCallback(AsyncWrap::ProviderType provider, uint64_t duration);
+
+  static void Start(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Stop(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetPhaseHistograms(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetProviderHistograms(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(LoopPhaseMonitor)
+  SET_SELF_SIZE(LoopPhaseMonitor)
+
+ private:
+  static void PrepareCB(uv_prepare_t* handle);
+  void OnStart(bool reset);
+  void OnStop();
+  void OnClose() override;
+  void Reset();
+  void Snapshot();
+
+  bool enabled_ = false;
+  uv_prepare_t prepare_;
+  uint64_t last_phase_time_[UV_METRICS_PHASE_MAX] = {};
+  uint64_t last_idle_time_ = 0;
+  std::shared_ptr<Histogram> phase_histograms_[kPhaseCount];
+  std::shared_ptr<Histogram> provider_histograms_[AsyncWrap::PROVIDERS_LENGTH];
+};
+
 }  // namespace node
 
 #endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
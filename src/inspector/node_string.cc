@@ -1,4 +1,5 @@
 #include "node_string.h"
+#include "crdtp/cbor.h"
 #include "crdtp/json.h"
 #include "node/inspector/protocol/Protocol.h"
 #include "simdutf.h"
@@ -58,6 +59,20 @@ String StringUtil::StringViewToUtf8(v8_inspector::StringView view) {
   return fromUTF16(view.characters16(), view.length());
 }
 
+bool StringUtil::IsCBORMessage(v8_inspector::StringView view) {
+  return view.is8Bit() &&
+         crdtp::cbor::IsCBORMessage(
+             crdtp::span<uint8_t>(view.characters8(), view.length()));
+}
+
+String StringUtil::StringViewToJSON(v8_inspector::StringView view) {
+  if (!IsCBORMessage(view)) return StringViewToUtf8(view);
+  std::string json;
+  crdtp::Status status = crdtp::json::ConvertCBORToJSON(
+      crdtp::span<uint8_t>(view.characters8(), view.length()), &json);
+  return status.ok() ? json : "";
+}
+
 String StringUtil::fromUTF16(const uint16_t* data, size_t length) {
   auto casted_data = reinterpret_cast<const char16_t*>(data);
   size_t expected_utf8_length =
@@ -49,6 +49,10 @@ using ProtocolMessage = std::string;
 struct StringUtil {
   // Convert Utf16 in local endianness to Utf8 if needed.
   static String StringViewToUtf8(v8_inspector::StringView view);
+  // Whether the view holds a CBOR encoded protocol message rather than JSON.
+  static bool IsCBORMessage(v8_inspector::StringView view);
+  // Like StringViewToUtf8(), but turns CBOR messages into JSON text.
+  static String StringViewToJSON(v8_inspector::StringView view);
   static String fromUTF16(const uint16_t* data, size_t length);
 
   static String fromUTF8(const uint8_t* data, size_t length);
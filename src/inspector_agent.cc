@@ -292,14 +292,29 @@ class ChannelImpl final : public v8_inspector::V8Inspector::Channel,
   }
 
   void dispatchProtocolMessage(const StringView& message) {
-    std::string raw_message = protocol::StringUtil::StringViewToUtf8(message);
-    per_process::Debug(DebugCategory::INSPECTOR_SERVER,
-                       "[inspector received] %s\n",
-                       raw_message);
+    if (per_process::enabled_debug_list.enabled(
+            DebugCategory::INSPECTOR_SERVER)) {
+      per_process::Debug(DebugCategory::INSPECTOR_SERVER,
+                         "[inspector received] %s\n",
+                         protocol::StringUtil::StringViewToJSON(message));
+    }
 
     std::vector<uint8_t> cbor_buffer;
-    ConvertJSONToCBOR(crdtp::SpanFrom(raw_message), &cbor_buffer);
-    Dispatchable dispatchable(crdtp::SpanFrom(cbor_buffer));
+    crdtp::span<uint8_t> cbor;
+    if (protocol::StringUtil::IsCBORMessage(message)) {
+      // Sessions from the inspector IO thread send CBOR, and V8 as well as
+      // the Node.js agents then reply in CBOR. This keeps converting large
+      // results, like profiles and heap snapshot chunks, to JSON off this
+      // thread.
+      binary_ = true;
+      cbor = crdtp::span<uint8_t>(message.characters8(), message.length());
+    } else {
+      std::string raw_message =
+          protocol::StringUtil::StringViewToUtf8(message);
+      ConvertJSONToCBOR(crdtp::SpanFrom(raw_message), &cbor_buffer);
+      cbor = crdtp::SpanFrom(cbor_buffer);
+    }
+    Dispatchable dispatchable(cbor);
     crdtp::span<uint8_t> method = dispatchable.Method();
     if (v8_inspector::V8InspectorSession::canDispatchMethod(
             StringView(method.data(), method.size()))) {
@@ -369,20 +384,25 @@ class ChannelImpl final : public v8_inspector::V8Inspector::Channel,
   void sendMessageToFrontend(const StringView& message) {
     if (per_process::enabled_debug_list.enabled(
             DebugCategory::INSPECTOR_SERVER)) {
-      std::string raw_message = protocol::StringUtil::StringViewToUtf8(message);
+      std::string raw_message = protocol::StringUtil::StringViewToJSON(message);
       per_process::Debug(DebugCategory::INSPECTOR_SERVER,
                          "[inspector send] %s\n",
                          raw_message);
     }
     std::optional<int> target_session_id = main_thread_->GetTargetSessionId();
     if (target_session_id.has_value()) {
-      std::string raw_message = protocol::StringUtil::StringViewToUtf8(message);
+      std::string raw_message = protocol::StringUtil::StringViewToJSON(message);
       std::unique_ptr<protocol::DictionaryValue> value =
           protocol::DictionaryValue::cast(JsonUtil::parseJSON(raw_message));
       std::string target_session_id_str = std::to_string(*target_session_id);
       value->setString("sessionId", target_session_id_str);
-      std::string json = serializeToJSON(std::move(value));
-      delegate_->SendMessageToFrontend(Utf8ToStringView(json)->string());
+      if (binary_) {
+        std::vector<uint8_t> cbor = value->Serialize();
+        delegate_->SendMessageToFrontend(StringView(cbor.data(), cbor.size()));
+      } else {
+        std::string json = serializeToJSON(std::move(value));
+        delegate_->SendMessageToFrontend(Utf8ToStringView(json)->string());
+      }
     } else {
       delegate_->SendMessageToFrontend(message);
     }
@@ -392,18 +412,27 @@ class ChannelImpl final : public v8_inspector::V8Inspector::Channel,
     sendMessageToFrontend(Utf8ToStringView(message)->string());
   }
 
+  // Binary sessions get the CBOR as it is, the others JSON.
+  void sendMessageToFrontend(std::unique_ptr<Serializable> message) {
+    if (binary_) {
+      std::vector<uint8_t> cbor = message->Serialize();
+      sendMessageToFrontend(StringView(cbor.data(), cbor.size()));
+      return;
+    }
+    std::string json = serializeToJSON(std::move(message));
+    sendMessageToFrontend(json);
+  }
+
   // crdtp::FrontendChannel
   void SendProtocolResponse(int callId,
                             std::unique_ptr<Serializable> message) override {
-    std::string json = serializeToJSON(std::move(message));
-    sendMessageToFrontend(json);
+    sendMessageToFrontend(std::move(message));
   }
 
   // crdtp::FrontendChannel
   void SendProtocolNotification(
       std::unique_ptr<Serializable> message) override {
-    std::string json = serializeToJSON(std::move(message));
-    sendMessageToFrontend(json);
+    sendMessageToFrontend(std::move(message));
   }
 
   // crdtp::FrontendChannel
@@ -425,6 +454,7 @@ class ChannelImpl final : public v8_inspector::V8Inspector::Channel,
   std::shared_ptr<MainThreadHandle> main_thread_;
   bool prevent_shutdown_;
   bool retaining_context_;
+  bool binary_ = false;
 };
 
 class SameThreadInspectorSession : public InspectorSession {
@@ -1,6 +1,7 @@
 #include "inspector_io.h"
 
 #include "base_object-inl.h"
+#include "crdtp/json.h"
 #include "crypto/crypto_util.h"
 #include "debug_utils-inl.h"
 #include "inspector/main_thread_interface.h"
@@ -23,6 +24,7 @@
 namespace node {
 namespace inspector {
 namespace {
+using crdtp::json::ConvertJSONToCBOR;
 using v8_inspector::StringBuffer;
 using v8_inspector::StringView;
 
@@ -82,14 +84,41 @@ class RequestToServer {
         server->Stop();
         break;
       case TransportAction::kSendMessage:
-        server->Send(
-            session_id_,
-            protocol::StringUtil::StringViewToUtf8(message_->string()));
+        SendMessage(server, message_->string());
         break;
     }
   }
 
  private:
+  // Main thread sessions answer in CBOR. It is only turned into JSON here,
+  // on the IO thread, so that large results, such as profiles, do not hold up
+  // the main thread. Clients that send binary frames get it as it is.
+  void SendMessage(InspectorSocketServer* server,
+                   const StringView& message) const {
+    const bool binary = server->IsBinarySession(session_id_);
+    if (protocol::StringUtil::IsCBORMessage(message)) {
+      const char* data = reinterpret_cast<const char*>(message.characters8());
+      if (binary) {
+        server->Send(
+            session_id_, std::string(data, message.length()), true);
+      } else {
+        server->Send(session_id_,
+                     protocol::StringUtil::StringViewToJSON(message));
+      }
+      return;
+    }
+    std::string json = protocol::StringUtil::StringViewToUtf8(message);
+    std::vector<uint8_t> cbor;
+    if (binary && ConvertJSONToCBOR(crdtp::SpanFrom(json), &cbor).ok()) {
+      server->Send(session_id_,
+                   std::string(reinterpret_cast<const char*>(cbor.data()),
+                               cbor.size()),
+                   true);
+    } else {
+      server->Send(session_id_, json);
+    }
+  }
+
   TransportAction action_;
   int session_id_;
   std::unique_ptr<v8_inspector::StringBuffer> message_;
@@ -370,8 +399,12 @@ std::optional<std::string> InspectorIoDelegate::GetTargetSessionId(
 
 void InspectorIoDelegate::MessageReceived(int session_id,
                                           const std::string& message) {
-  std::optional<std::string> target_session_id_str =
-      GetTargetSessionId(message);
+  const StringView message_view(
+      reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  const bool is_cbor = protocol::StringUtil::IsCBORMessage(message_view);
+  const std::string json =
+      is_cbor ? protocol::StringUtil::StringViewToJSON(message_view) : message;
+  std::optional<std::string> target_session_id_str = GetTargetSessionId(json);
   std::shared_ptr<MainThreadHandle> worker = nullptr;
   int merged_session_id = session_id;
   if (target_session_id_str) {
@@ -388,6 +421,21 @@ void InspectorIoDelegate::MessageReceived(int session_id,
     }
   }
 
+  // Workers get JSON, their channels rewrite it. The main thread gets CBOR,
+  // converted here if need be, so that it replies in CBOR.
+  std::unique_ptr<StringBuffer> dispatched;
+  std::vector<uint8_t> cbor;
+  if (worker) {
+    dispatched = Utf8ToStringView(json);
+  } else if (is_cbor) {
+    dispatched = StringBuffer::create(message_view);
+  } else if (ConvertJSONToCBOR(crdtp::SpanFrom(message), &cbor).ok()) {
+    dispatched = StringBuffer::create(StringView(cbor.data(), cbor.size()));
+  } else {
+    // Leave reporting the malformed message to the main thread.
+    dispatched = Utf8ToStringView(message);
+  }
+
   auto session = sessions_.find(merged_session_id);
 
   if (session == sessions_.end()) {
@@ -406,13 +454,12 @@ void InspectorIoDelegate::MessageReceived(int session_id,
 
     if (session) {
       sessions_[merged_session_id] = std::move(session);
-      sessions_[merged_session_id]->Dispatch(
-          Utf8ToStringView(message)->string());
+      sessions_[merged_session_id]->Dispatch(dispatched->string());
     } else {
       fprintf(stderr, "Failed to connect to inspector session.\n");
     }
   } else {
-    session->second->Dispatch(Utf8ToStringView(message)->string());
+    session->second->Dispatch(dispatched->string());
   }
 }
 
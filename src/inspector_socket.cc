@@ -60,7 +60,7 @@ class ProtocolHandler {
   virtual void AcceptUpgrade(const std::string& accept_key) = 0;
   virtual void OnData(std::vector<char>* data) = 0;
   virtual void OnEof() = 0;
-  virtual void Write(const std::vector<char> data) = 0;
+  virtual void Write(const std::vector<char> data, bool binary) = 0;
   virtual void CancelHandshake() = 0;
 
   std::string GetHost() const;
@@ -258,9 +258,10 @@ const size_t kTwoBytePayloadLengthField = 126;
 const size_t kEightBytePayloadLengthField = 127;
 const size_t kMaskingKeyWidthInBytes = 4;
 
-static std::vector<char> encode_frame_hybi17(const std::vector<char>& message) {
+static std::vector<char> encode_frame_hybi17(const std::vector<char>& message,
+                                             bool binary) {
   std::vector<char> frame;
-  OpCode op_code = kOpCodeText;
+  OpCode op_code = binary ? kOpCodeBinary : kOpCodeText;
   frame.push_back(kFinalBit | op_code);
   const size_t data_length = message.size();
   if (data_length <= kMaxSingleBytePayloadLength) {
@@ -290,7 +291,8 @@ static ws_decode_result decode_frame_hybi17(const std::vector<char>& buffer,
                                             bool client_frame,
                                             int* bytes_consumed,
                                             std::vector<char>* output,
-                                            bool* compressed) {
+                                            bool* compressed,
+                                            bool* binary) {
   *bytes_consumed = 0;
   if (buffer.size() < 2)
     return FRAME_INCOMPLETE;
@@ -307,6 +309,7 @@ static ws_decode_result decode_frame_hybi17(const std::vector<char>& buffer,
   int op_code = first_byte & kOpCodeMask;
   bool masked = (second_byte & kMaskBit) != 0;
   *compressed = reserved1;
+  *binary = op_code == kOpCodeBinary;
   if (!final || reserved2 || reserved3)
     return FRAME_ERROR;  // Only compression extension is supported.
 
@@ -316,8 +319,8 @@ static ws_decode_result decode_frame_hybi17(const std::vector<char>& buffer,
       closed = true;
       break;
     case kOpCodeText:
+    case kOpCodeBinary:
       break;
-    case kOpCodeBinary:        // We don't support binary frames yet.
     case kOpCodeContinuation:  // We don't support binary frames yet.
     case kOpCodePing:          // We don't support binary frames yet.
     case kOpCodePong:          // We don't support binary frames yet.
@@ -402,8 +405,8 @@ class WsHandler : public ProtocolHandler {
     } while (processed > 0 && !data->empty());
   }
 
-  void Write(const std::vector<char> data) override {
-    std::vector<char> output = encode_frame_hybi17(data);
+  void Write(const std::vector<char> data, bool binary) override {
+    std::vector<char> output = encode_frame_hybi17(data, binary);
     WriteRaw(output, WriteRequest::Cleanup);
   }
 
@@ -446,11 +449,12 @@ class WsHandler : public ProtocolHandler {
     int bytes_consumed = 0;
     std::vector<char> output;
     bool compressed = false;
+    bool binary = false;
 
     ws_decode_result r =  decode_frame_hybi17(buffer,
                                               true /* client_frame */,
                                               &bytes_consumed, &output,
-                                              &compressed);
+                                              &compressed, &binary);
     // Compressed frame means client is ignoring the headers and misbehaves
     if (compressed || r == FRAME_ERROR) {
       OnEof();
@@ -458,6 +462,8 @@ class WsHandler : public ProtocolHandler {
     } else if (r == FRAME_CLOSE) {
       (this->*OnCloseReceived)();
       bytes_consumed = 0;
+    } else if (r == FRAME_OK && binary) {
+      delegate()->OnWsBinaryFrame(output);
     } else if (r == FRAME_OK) {
       delegate()->OnWsFrame(output);
     }
@@ -564,7 +570,7 @@ class HttpHandler : public ProtocolHandler {
     }
   }
 
-  void Write(const std::vector<char> data) override {
+  void Write(const std::vector<char> data, bool binary) override {
     WriteRaw(data, WriteRequest::Cleanup);
   }
 
@@ -816,8 +822,8 @@ void InspectorSocket::SwitchProtocol(ProtocolHandler* handler) {
   protocol_handler_.reset(std::move(handler));
 }
 
-void InspectorSocket::Write(const char* data, size_t len) {
-  protocol_handler_->Write(std::vector<char>(data, data + len));
+void InspectorSocket::Write(const char* data, size_t len, bool binary) {
+  protocol_handler_->Write(std::vector<char>(data, data + len), binary);
 }
 
 }  // namespace inspector
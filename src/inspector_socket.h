@@ -25,6 +25,10 @@ class InspectorSocket {
                                  const std::string& path,
                                  const std::string& accept_key) = 0;
     virtual void OnWsFrame(const std::vector<char>& frame) = 0;
+    // Binary frames carry CBOR encoded protocol messages.
+    virtual void OnWsBinaryFrame(const std::vector<char>& frame) {
+      OnWsFrame(frame);
+    }
     virtual ~Delegate() = default;
   };
 
@@ -37,7 +41,8 @@ class InspectorSocket {
 
   void AcceptUpgrade(const std::string& accept_key);
   void CancelHandshake();
-  void Write(const char* data, size_t len);
+  // Sends a binary frame instead of a text one once the WebSocket is up.
+  void Write(const char* data, size_t len, bool binary = false);
   void SwitchProtocol(ProtocolHandler* handler);
   std::string GetHost();
 
@@ -157,11 +157,14 @@ class SocketSession {
   void Close() {
     ws_socket_.reset();
   }
-  void Send(const std::string& message);
+  void Send(const std::string& message, bool binary);
   void Own(InspectorSocket::Pointer ws_socket) {
     ws_socket_ = std::move(ws_socket);
   }
   int id() const { return id_; }
+  // Clients that send binary frames get their replies as binary frames.
+  bool binary() const { return binary_; }
+  void set_binary() { binary_ = true; }
   int server_port() {
     return server_port_;
   }
@@ -186,6 +189,7 @@ class SocketSession {
     void OnSocketUpgrade(const std::string& host, const std::string& path,
                          const std::string& ws_key) override;
     void OnWsFrame(const std::vector<char>& data) override;
+    void OnWsBinaryFrame(const std::vector<char>& data) override;
 
    private:
     SocketSession* Session() {
@@ -200,6 +204,7 @@ class SocketSession {
   const int id_;
   InspectorSocket::Pointer ws_socket_;
   const int server_port_;
+  bool binary_ = false;
 };
 
 class ServerSocket {
@@ -479,13 +484,20 @@ void InspectorSocketServer::Accept(int server_port,
   }
 }
 
-void InspectorSocketServer::Send(int session_id, const std::string& message) {
+void InspectorSocketServer::Send(int session_id,
+                                 const std::string& message,
+                                 bool binary) {
   SocketSession* session = Session(session_id);
   if (session != nullptr) {
-    session->Send(message);
+    session->Send(message, binary);
   }
 }
 
+bool InspectorSocketServer::IsBinarySession(int session_id) {
+  SocketSession* session = Session(session_id);
+  return session != nullptr && session->binary();
+}
+
 void InspectorSocketServer::CloseServerSocket(ServerSocket* server) {
   server->Close();
 }
@@ -495,8 +507,8 @@ SocketSession::SocketSession(InspectorSocketServer* server, int id,
                              int server_port)
     : id_(id), server_port_(server_port) {}
 
-void SocketSession::Send(const std::string& message) {
-  ws_socket_->Write(message.data(), message.length());
+void SocketSession::Send(const std::string& message, bool binary) {
+  ws_socket_->Write(message.data(), message.length(), binary);
 }
 
 void SocketSession::Delegate::OnHttpGet(const std::string& host,
@@ -517,6 +529,11 @@ void SocketSession::Delegate::OnWsFrame(const std::vector<char>& data) {
                            std::string(data.data(), data.size()));
 }
 
+void SocketSession::Delegate::OnWsBinaryFrame(const std::vector<char>& data) {
+  Session()->set_binary();
+  OnWsFrame(data);
+}
+
 // ServerSocket implementation
 int ServerSocket::DetectPort() {
   sockaddr_storage addr;
@@ -58,7 +58,10 @@ class InspectorSocketServer {
   //   kKill and kStop
   void Stop();
   //   kSendMessage
-  void Send(int session_id, const std::string& message);
+  void Send(int session_id, const std::string& message, bool binary = false);
+  // Whether the session's client sent CBOR in binary frames and so takes
+  // its messages in that form too.
+  bool IsBinarySession(int session_id);
   //   kKill
   void TerminateConnections();
   int Port() const;
@@ -129,6 +129,23 @@ NAPI_EXTERN napi_status NAPI_CDECL napi_create_function(napi_env env,
                                                         napi_callback cb,
                                                         void* data,
                                                         napi_value* result);
+#ifdef NAPI_EXPERIMENTAL
+#define NODE_API_EXPERIMENTAL_HAS_CREATE_FAST_FUNCTION
+// Creates a function that optimized JavaScript code calls through
+// fast_function, a plain C function that receives an opaque receiver
+// pointer followed by the arguments described by signature. It gets no env
+// and must not call into JavaScript, allocate on the JavaScript heap or
+// throw. Every other call goes through cb, as with napi_create_function.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_create_fast_function(napi_env env,
+                              const char* utf8name,
+                              size_t length,
+                              napi_callback cb,
+                              void* data,
+                              const node_api_fast_signature* signature,
+                              const void* fast_function,
+                              napi_value* result);
+#endif  // NAPI_EXPERIMENTAL
 NAPI_EXTERN napi_status NAPI_CDECL napi_create_error(napi_env env,
                                                      napi_value code,
                                                      napi_value msg,
@@ -181,6 +198,18 @@ NAPI_EXTERN napi_status NAPI_CDECL napi_get_value_string_utf16(napi_env env,
                                                                size_t bufsize,
                                                                size_t* result);
 
+#ifdef NAPI_EXPERIMENTAL
+#define NODE_API_EXPERIMENTAL_HAS_GET_VALUE_STRING_VIEW
+// Calls cb with the contents of a string without copying them, as Latin-1
+// or UTF-16 depending on how the engine stores the string. The pointer is
+// only valid during the call, which must not call back into Node-API.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_get_value_string_view(napi_env env,
+                               napi_value value,
+                               node_api_string_view_callback cb,
+                               void* hint);
+#endif  // NAPI_EXPERIMENTAL
+
 // Methods to coerce values
 // These APIs may execute user scripts
 NAPI_EXTERN napi_status NAPI_CDECL napi_coerce_to_bool(napi_env env,
@@ -235,6 +264,39 @@ NAPI_EXTERN napi_status NAPI_CDECL napi_get_named_property(napi_env env,
                                                            napi_value object,
                                                            const char* utf8name,
                                                            napi_value* result);
+#ifdef NAPI_EXPERIMENTAL
+#define NODE_API_EXPERIMENTAL_HAS_BULK_PROPERTIES
+// Gets or sets property_count properties at once. The keys are best
+// created with node_api_create_property_key_*, so that they are internalized.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_get_properties(napi_env env,
+                        napi_value object,
+                        size_t property_count,
+                        const napi_value* property_names,
+                        napi_value* property_values);
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_set_properties(napi_env env,
+                        napi_value object,
+                        size_t property_count,
+                        const napi_value* property_names,
+                        const napi_value* property_values);
+
+// Objects created from the same template share their hidden class, so that
+// code reading them stays monomorphic.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_create_object_template(napi_env env,
+                                size_t property_count,
+                                const napi_value* property_names,
+                                node_api_object_template* result);
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_new_object_from_template(napi_env env,
+                                  node_api_object_template object_template,
+                                  const napi_value* property_values,
+                                  napi_value* result);
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_delete_object_template(node_api_basic_env env,
+                                node_api_object_template object_template);
+#endif  // NAPI_EXPERIMENTAL
 NAPI_EXTERN napi_status NAPI_CDECL napi_set_element(napi_env env,
                                                     napi_value object,
                                                     uint32_t index,
@@ -345,6 +407,14 @@ napi_create_reference(napi_env env,
                       uint32_t initial_refcount,
                       napi_ref* result);
 
+#ifdef NAPI_EXPERIMENTAL
+#define NODE_API_EXPERIMENTAL_HAS_STRONG_REFERENCE
+// Creates a reference with a refcount of 1 that keeps value alive until it is
+// deleted, whatever its refcount, and so is never weak.
+NAPI_EXTERN napi_status NAPI_CDECL node_api_create_strong_reference(
+    napi_env env, napi_value value, napi_ref* result);
+#endif  // NAPI_EXPERIMENTAL
+
 // Deletes a reference. The referenced value is released, and may
 // be GC'd unless there are other references to it.
 NAPI_EXTERN napi_status NAPI_CDECL napi_delete_reference(node_api_basic_env env,
@@ -238,4 +238,33 @@ typedef struct {
 } napi_type_tag;
 #endif  // NAPI_VERSION >= 8
 
+#ifdef NAPI_EXPERIMENTAL
+// The C types that a function created with node_api_create_fast_function
+// can take and return. 64-bit integers are converted from and to Numbers.
+typedef enum {
+  node_api_fast_void,
+  node_api_fast_bool,
+  node_api_fast_int32,
+  node_api_fast_uint32,
+  node_api_fast_int64,
+  node_api_fast_uint64,
+  node_api_fast_float32,
+  node_api_fast_float64
+} node_api_fast_type;
+
+typedef struct {
+  node_api_fast_type return_type;
+  size_t arg_count;
+  const node_api_fast_type* arg_types;
+} node_api_fast_signature;
+
+// A set of property keys for creating objects of the same shape.
+typedef struct node_api_object_template__* node_api_object_template;
+
+// Receives the contents of a string in place. Exactly one of latin1 and
+// utf16 is non-NULL, and length is in characters.
+typedef void(NAPI_CDECL* node_api_string_view_callback)(
+    const char* latin1, const char16_t* utf16, size_t length, void* hint);
+#endif  // NAPI_EXPERIMENTAL
+
 #endif  // SRC_JS_NATIVE_API_TYPES_H_
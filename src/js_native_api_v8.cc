@@ -369,7 +369,7 @@ inline napi_status Unwrap(napi_env env,
       // When the wrap is been removed, the finalizer should be reset.
       reference->ResetFinalizer();
     } else {
-      delete reference;
+      Reference::Delete(reference);
     }
   }
 
@@ -594,6 +594,37 @@ inline bool CanBeHeldWeakly(v8::Local<v8::Value> value) {
   return value->IsObject() || value->IsSymbol();
 }
 
+inline bool FastTypeToCType(node_api_fast_type type,
+                            v8::CTypeInfo::Type* result) {
+  switch (type) {
+    case node_api_fast_void:
+      *result = v8::CTypeInfo::Type::kVoid;
+      return true;
+    case node_api_fast_bool:
+      *result = v8::CTypeInfo::Type::kBool;
+      return true;
+    case node_api_fast_int32:
+      *result = v8::CTypeInfo::Type::kInt32;
+      return true;
+    case node_api_fast_uint32:
+      *result = v8::CTypeInfo::Type::kUint32;
+      return true;
+    case node_api_fast_int64:
+      *result = v8::CTypeInfo::Type::kInt64;
+      return true;
+    case node_api_fast_uint64:
+      *result = v8::CTypeInfo::Type::kUint64;
+      return true;
+    case node_api_fast_float32:
+      *result = v8::CTypeInfo::Type::kFloat32;
+      return true;
+    case node_api_fast_float64:
+      *result = v8::CTypeInfo::Type::kFloat64;
+      return true;
+  }
+  return false;
+}
+
 }  // end of anonymous namespace
 
 void Finalizer::ResetEnv() {
@@ -656,12 +687,14 @@ void TrackedFinalizer::Finalize() {
 Reference::Reference(napi_env env,
                      v8::Local<v8::Value> value,
                      uint32_t initial_refcount,
-                     ReferenceOwnership ownership)
+                     ReferenceOwnership ownership,
+                     bool strong)
     : RefTracker(),
       persistent_(env->isolate, value),
       refcount_(initial_refcount),
       ownership_(ownership),
-      can_be_weak_(CanBeHeldWeakly(value)) {
+      can_be_weak_(CanBeHeldWeakly(value)),
+      strong_(strong) {
   if (refcount_ == 0) {
     SetWeak();
   }
@@ -678,19 +711,34 @@ Reference::~Reference() {
 Reference* Reference::New(napi_env env,
                           v8::Local<v8::Value> value,
                           uint32_t initial_refcount,
-                          ReferenceOwnership ownership) {
-  Reference* reference = new Reference(env, value, initial_refcount, ownership);
+                          ReferenceOwnership ownership,
+                          bool strong) {
+  static_assert(sizeof(Reference) <= kReferenceBlockSize);
+  void* storage = env->reference_allocator.Allocate();
+  Reference* reference =
+      new (storage) Reference(env, value, initial_refcount, ownership, strong);
+  reference->allocator_ = &env->reference_allocator;
   reference->Link(&env->reflist);
   return reference;
 }
 
+void Reference::Delete(Reference* reference) {
+  SlabAllocator<kReferenceBlockSize>* allocator = reference->allocator_;
+  if (allocator == nullptr) {
+    delete reference;
+    return;
+  }
+  reference->~Reference();
+  allocator->Free(reference);
+}
+
 uint32_t Reference::Ref() {
   // When the persistent_ is cleared in the WeakCallback, and a second pass
   // callback is pending, return 0 unconditionally.
   if (persistent_.IsEmpty()) {
     return 0;
   }
-  if (++refcount_ == 1 && can_be_weak_) {
+  if (++refcount_ == 1 && can_be_weak_ && !strong_) {
     persistent_.ClearWeak();
   }
   return refcount_;
@@ -735,7 +783,7 @@ void Reference::Finalize() {
   CallUserFinalizer();
 
   if (deleteMe) {
-    delete this;
+    Delete(this);
   }
 }
 
@@ -746,6 +794,9 @@ void Reference::InvokeFinalizerFromGC() {
 
 // Mark the reference as weak and eligible for collection by the GC.
 void Reference::SetWeak() {
+  if (strong_) {
+    return;
+  }
   if (can_be_weak_) {
     persistent_.SetWeak(this, WeakCallback, v8::WeakCallbackType::kParameter);
   } else {
@@ -962,6 +1013,79 @@ napi_status NAPI_CDECL napi_create_function(napi_env env,
   return GET_RETURN_STATUS(env);
 }
 
+napi_status NAPI_CDECL
+node_api_create_fast_function(napi_env env,
+                              const char* utf8name,
+                              size_t length,
+                              napi_callback cb,
+                              void* callback_data,
+                              const node_api_fast_signature* signature,
+                              const void* fast_function,
+                              napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+  CHECK_ARG(env, cb);
+  CHECK_ARG(env, signature);
+  CHECK_ARG(env, fast_function);
+  if (signature->arg_count > 0) {
+    CHECK_ARG(env, signature->arg_types);
+  }
+
+  auto info = std::make_unique<v8impl::FastFunctionInfo>();
+  v8::CTypeInfo::Type return_type;
+  RETURN_STATUS_IF_FALSE(
+      env,
+      v8impl::FastTypeToCType(signature->return_type, &return_type),
+      napi_invalid_arg);
+  // The receiver is always passed first, as an opaque value.
+  info->arg_info.reserve(signature->arg_count + 1);
+  info->arg_info.emplace_back(v8::CTypeInfo::Type::kV8Value);
+  for (size_t i = 0; i < signature->arg_count; i++) {
+    v8::CTypeInfo::Type type;
+    RETURN_STATUS_IF_FALSE(
+        env,
+        v8impl::FastTypeToCType(signature->arg_types[i], &type) &&
+            type != v8::CTypeInfo::Type::kVoid,
+        napi_invalid_arg);
+    info->arg_info.emplace_back(type);
+  }
+  info->function_info = std::make_unique<v8::CFunctionInfo>(
+      v8::CTypeInfo(return_type),
+      static_cast<unsigned int>(info->arg_info.size()),
+      info->arg_info.data());
+  v8::CFunction c_function(fast_function, info->function_info.get());
+
+  v8::EscapableHandleScope scope(env->isolate);
+  v8::Local<v8::Value> cbdata =
+      v8impl::CallbackBundle::New(env, cb, callback_data);
+  RETURN_STATUS_IF_FALSE(env, !cbdata.IsEmpty(), napi_generic_failure);
+  v8::Local<v8::FunctionTemplate> tpl =
+      v8::FunctionTemplate::New(env->isolate,
+                                v8impl::FunctionCallbackWrapper::Invoke,
+                                cbdata,
+                                v8::Local<v8::Signature>(),
+                                static_cast<int>(signature->arg_count),
+                                v8::ConstructorBehavior::kThrow,
+                                v8::SideEffectType::kHasSideEffect,
+                                &c_function);
+  v8::MaybeLocal<v8::Function> maybe_function =
+      tpl->GetFunction(env->context());
+  CHECK_MAYBE_EMPTY(env, maybe_function, napi_generic_failure);
+  v8::Local<v8::Function> return_value =
+      scope.Escape(maybe_function.ToLocalChecked());
+
+  if (utf8name != nullptr) {
+    v8::Local<v8::String> name_string;
+    CHECK_NEW_FROM_UTF8_LEN(env, name_string, utf8name, length);
+    return_value->SetName(name_string);
+  }
+
+  env->fast_functions.push_back(std::move(info));
+  *result = v8impl::JsValueFromV8LocalValue(return_value);
+
+  return GET_RETURN_STATUS(env);
+}
+
 napi_status NAPI_CDECL
 napi_define_class(napi_env env,
                   const char* utf8name,
@@ -1326,6 +1450,149 @@ napi_status NAPI_CDECL napi_get_named_property(napi_env env,
   return GET_RETURN_STATUS(env);
 }
 
+napi_status NAPI_CDECL
+node_api_get_properties(napi_env env,
+                        napi_value object,
+                        size_t property_count,
+                        const napi_value* property_names,
+                        napi_value* property_values) {
+  NAPI_PREAMBLE(env);
+  if (property_count > 0) {
+    CHECK_ARG(env, property_names);
+    CHECK_ARG(env, property_values);
+  }
+
+  v8::Local<v8::Context> context = env->context();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  for (size_t i = 0; i < property_count; i++) {
+    v8::Local<v8::Value> k =
+        v8impl::V8LocalValueFromJsValue(property_names[i]);
+    auto get_maybe = obj->Get(context, k);
+
+    CHECK_MAYBE_EMPTY_WITH_PREAMBLE(env, get_maybe, napi_generic_failure);
+
+    property_values[i] =
+        v8impl::JsValueFromV8LocalValue(get_maybe.ToLocalChecked());
+  }
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status NAPI_CDECL
+node_api_set_properties(napi_env env,
+                        napi_value object,
+                        size_t property_count,
+                        const napi_value* property_names,
+                        const napi_value* property_values) {
+  NAPI_PREAMBLE(env);
+  if (property_count > 0) {
+    CHECK_ARG(env, property_names);
+    CHECK_ARG(env, property_values);
+  }
+
+  v8::Local<v8::Context> context = env->context();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  for (size_t i = 0; i < property_count; i++) {
+    v8::Local<v8::Value> k =
+        v8impl::V8LocalValueFromJsValue(property_names[i]);
+    v8::Local<v8::Value> val =
+        v8impl::V8LocalValueFromJsValue(property_values[i]);
+    v8::Maybe<bool> set_maybe = obj->Set(context, k, val);
+
+    RETURN_STATUS_IF_FALSE_WITH_PREAMBLE(
+        env, set_maybe.FromMaybe(false), napi_generic_failure);
+  }
+  return GET_RETURN_STATUS(env);
+}
+
+struct node_api_object_template__ {
+  v8impl::Persistent<v8::ObjectTemplate> object_template;
+  std::vector<v8impl::Persistent<v8::Name>> property_names;
+};
+
+napi_status NAPI_CDECL
+node_api_create_object_template(napi_env env,
+                                size_t property_count,
+                                const napi_value* property_names,
+                                node_api_object_template* result) {
+  CHECK_ENV_NOT_IN_GC(env);
+  CHECK_ARG(env, result);
+  if (property_count > 0) {
+    CHECK_ARG(env, property_names);
+  }
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::ObjectTemplate> tpl = v8::ObjectTemplate::New(isolate);
+  auto object_template = std::make_unique<node_api_object_template__>();
+  object_template->property_names.reserve(property_count);
+  for (size_t i = 0; i < property_count; i++) {
+    v8::Local<v8::Value> name_value =
+        v8impl::V8LocalValueFromJsValue(property_names[i]);
+    RETURN_STATUS_IF_FALSE(env, name_value->IsName(), napi_name_expected);
+    v8::Local<v8::Name> name = name_value.As<v8::Name>();
+    // The placeholder values are overwritten by every new object, which
+    // keeps the properties in the map that the objects start with.
+    tpl->Set(name, v8::Undefined(isolate));
+    object_template->property_names.emplace_back(isolate, name);
+  }
+  object_template->object_template.Reset(isolate, tpl);
+
+  *result = object_template.release();
+  return napi_clear_last_error(env);
+}
+
+napi_status NAPI_CDECL
+node_api_new_object_from_template(napi_env env,
+                                  node_api_object_template object_template,
+                                  const napi_value* property_values,
+                                  napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, object_template);
+  CHECK_ARG(env, result);
+  size_t property_count = object_template->property_names.size();
+  if (property_count > 0) {
+    CHECK_ARG(env, property_values);
+  }
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = env->context();
+  v8::Local<v8::ObjectTemplate> tpl =
+      object_template->object_template.Get(isolate);
+  v8::MaybeLocal<v8::Object> maybe_object = tpl->NewInstance(context);
+  CHECK_MAYBE_EMPTY_WITH_PREAMBLE(env, maybe_object, napi_generic_failure);
+  v8::Local<v8::Object> obj = maybe_object.ToLocalChecked();
+
+  for (size_t i = 0; i < property_count; i++) {
+    v8::Local<v8::Name> name =
+        object_template->property_names[i].Get(isolate);
+    v8::Local<v8::Value> val =
+        v8impl::V8LocalValueFromJsValue(property_values[i]);
+    v8::Maybe<bool> set_maybe = obj->CreateDataProperty(context, name, val);
+
+    RETURN_STATUS_IF_FALSE_WITH_PREAMBLE(
+        env, set_maybe.FromMaybe(false), napi_generic_failure);
+  }
+
+  *result = v8impl::JsValueFromV8LocalValue(obj);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status NAPI_CDECL
+node_api_delete_object_template(node_api_basic_env basic_env,
+                                node_api_object_template object_template) {
+  napi_env env = const_cast<napi_env>(basic_env);
+  CHECK_ENV(env);
+  CHECK_ARG(env, object_template);
+
+  delete object_template;
+  return napi_clear_last_error(env);
+}
+
 napi_status NAPI_CDECL napi_set_element(napi_env env,
                                         napi_value object,
                                         uint32_t index,
@@ -2591,6 +2858,36 @@ napi_status NAPI_CDECL napi_get_value_string_utf16(napi_env env,
   return napi_clear_last_error(env);
 }
 
+napi_status NAPI_CDECL
+node_api_get_value_string_view(napi_env env,
+                               napi_value value,
+                               node_api_string_view_callback cb,
+                               void* hint) {
+  CHECK_ENV_NOT_IN_GC(env);
+  CHECK_ARG(env, value);
+  CHECK_ARG(env, cb);
+
+  v8::Local<v8::Value> val = v8impl::V8LocalValueFromJsValue(value);
+  RETURN_STATUS_IF_FALSE(env, val->IsString(), napi_string_expected);
+
+  // The view flattens the string if needed and keeps the garbage collector
+  // from moving it while cb runs.
+  v8::String::ValueView view(env->isolate, val.As<v8::String>());
+  if (view.is_one_byte()) {
+    cb(reinterpret_cast<const char*>(view.data8()),
+       nullptr,
+       view.length(),
+       hint);
+  } else {
+    cb(nullptr,
+       reinterpret_cast<const char16_t*>(view.data16()),
+       view.length(),
+       hint);
+  }
+
+  return napi_clear_last_error(env);
+}
+
 napi_status NAPI_CDECL napi_coerce_to_bool(napi_env env,
                                            napi_value value,
                                            napi_value* result) {
@@ -2815,6 +3112,26 @@ napi_status NAPI_CDECL napi_create_reference(napi_env env,
   return napi_clear_last_error(env);
 }
 
+napi_status NAPI_CDECL node_api_create_strong_reference(napi_env env,
+                                                        napi_value value,
+                                                        napi_ref* result) {
+  // Omit NAPI_PREAMBLE and GET_RETURN_STATUS because V8 calls here cannot throw
+  // JS exceptions.
+  CHECK_ENV_NOT_IN_GC(env);
+  CHECK_ARG(env, value);
+  CHECK_ARG(env, result);
+
+  v8impl::Reference* reference =
+      v8impl::Reference::New(env,
+                             v8impl::V8LocalValueFromJsValue(value),
+                             1,
+                             v8impl::ReferenceOwnership::kUserland,
+                             true);
+
+  *result = reinterpret_cast<napi_ref>(reference);
+  return napi_clear_last_error(env);
+}
+
 // Deletes a reference. The referenced value is released, and may be GC'd unless
 // there are other references to it.
 // For a napi_reference returned from `napi_wrap`, this must be called in the
@@ -2826,7 +3143,7 @@ napi_status NAPI_CDECL napi_delete_reference(node_api_basic_env env,
   CHECK_ENV(env);
   CHECK_ARG(env, ref);
 
-  delete reinterpret_cast<v8impl::Reference*>(ref);
+  v8impl::Reference::Delete(reinterpret_cast<v8impl::Reference*>(ref));
 
   return napi_clear_last_error(env);
 }
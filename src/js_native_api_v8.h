@@ -1,8 +1,12 @@
 #ifndef SRC_JS_NATIVE_API_V8_H_
 #define SRC_JS_NATIVE_API_V8_H_
 
+#include <cstddef>
+#include <memory>
+#include <vector>
 #include "js_native_api_types.h"
 #include "js_native_api_v8_internals.h"
+#include "v8-fast-api-calls.h"
 
 inline napi_status napi_clear_last_error(node_api_basic_env env);
 
@@ -48,6 +52,60 @@ class RefTracker {
   RefList* prev_ = nullptr;
 };
 
+// Hands out blocks of kBlockSize bytes carved from larger slabs, and keeps
+// the freed ones on an intrusive free list. The slabs are only released when
+// the allocator is destroyed.
+template <size_t kBlockSize, size_t kBlocksPerSlab = 256>
+class SlabAllocator {
+ public:
+  SlabAllocator() = default;
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+  void* Allocate() {
+    if (free_list_ == nullptr) {
+      AddSlab();
+    }
+    Block* block = free_list_;
+    free_list_ = block->next;
+    return block;
+  }
+
+  void Free(void* ptr) {
+    Block* block = static_cast<Block*>(ptr);
+    block->next = free_list_;
+    free_list_ = block;
+  }
+
+ private:
+  union Block {
+    Block* next;
+    alignas(std::max_align_t) char storage[kBlockSize];
+  };
+
+  void AddSlab() {
+    slabs_.emplace_back(new Block[kBlocksPerSlab]);
+    Block* slab = slabs_.back().get();
+    for (size_t i = kBlocksPerSlab; i-- > 0;) {
+      Free(&slab[i]);
+    }
+  }
+
+  Block* free_list_ = nullptr;
+  std::vector<std::unique_ptr<Block[]>> slabs_;
+};
+
+// The size of the blocks that plain references are allocated from.
+constexpr size_t kReferenceBlockSize = 64;
+
+// The type information of a function created with
+// node_api_create_fast_function, which V8 refers to for as long as the
+// function may be optimized.
+struct FastFunctionInfo {
+  std::vector<v8::CTypeInfo> arg_info;
+  std::unique_ptr<v8::CFunctionInfo> function_info;
+};
+
 }  // end of namespace v8impl
 
 struct napi_env__ {
@@ -159,6 +217,8 @@ struct napi_env__ {
   int open_callback_scopes = 0;
   int refs = 1;
   void* instance_data = nullptr;
+  std::vector<std::unique_ptr<v8impl::FastFunctionInfo>> fast_functions;
+  v8impl::SlabAllocator<v8impl::kReferenceBlockSize> reference_allocator;
   int32_t module_api_version = NODE_API_DEFAULT_MODULE_API_VERSION;
   bool in_gc_finalizer = false;
 
@@ -392,10 +452,16 @@ enum class ReferenceOwnership : uint8_t {
 // Wrapper around v8impl::Persistent.
 class Reference : public RefTracker {
  public:
+  // Plain references are allocated from the env's reference_allocator. A
+  // strong reference keeps its value alive even at a refcount of 0, and so
+  // never needs a weak callback.
   static Reference* New(napi_env env,
                         v8::Local<v8::Value> value,
                         uint32_t initial_refcount,
-                        ReferenceOwnership ownership);
+                        ReferenceOwnership ownership,
+                        bool strong = false);
+  // Deletes any kind of reference, returning pooled storage to its allocator.
+  static void Delete(Reference* reference);
   ~Reference() override;
 
   uint32_t Ref();
@@ -412,7 +478,8 @@ class Reference : public RefTracker {
   Reference(napi_env env,
             v8::Local<v8::Value> value,
             uint32_t initial_refcount,
-            ReferenceOwnership ownership);
+            ReferenceOwnership ownership,
+            bool strong = false);
   virtual void CallUserFinalizer() {}
   virtual void InvokeFinalizerFromGC();
 
@@ -423,9 +490,11 @@ class Reference : public RefTracker {
 
  private:
   v8impl::Persistent<v8::Value> persistent_;
+  SlabAllocator<kReferenceBlockSize>* allocator_ = nullptr;
   uint32_t refcount_;
   ReferenceOwnership ownership_;
   bool can_be_weak_;
+  bool strong_;
 };
 
 // Reference that can store additional data.
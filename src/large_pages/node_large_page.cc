@@ -28,7 +28,9 @@
 //    Linux and FreeBSD, `dl_iterate_phdr(3)` is used. When the region is found,
 //    it is "trimmed" as follows:
 //    * Modify the start to point to the very beginning of the Node.js `.text`
-//      section (from symbol `__node_text_start` declared in node_text_start.S).
+//      section (from symbol `__node_text_start` declared in node_text_start.S),
+//      or to V8's embedded builtins if the linker placed them in front of it
+//      (they are emitted into `.text.hot.embedded`).
 //    * Possibly modify the end to account for the `lpstub` section which
 //      contains `MoveTextRegionToLargePages`, the function we do not wish to
 //      move (see below).
@@ -54,6 +56,9 @@
 //      * If successful copy the code to the newly mapped area and protect it to
 //        be readable and executable.
 //      * Unmap the temporary area.
+//
+// Separately, `AdviseCodeRangeLargePages` asks for V8's JIT code range to be
+// backed by transparent huge pages once the isolate has reserved it.
 
 #include "node_large_page.h"
 
@@ -87,6 +92,8 @@
 #include <mach/vm_map.h>
 #endif
 
+#include "v8.h"
+
 #include <climits>  // PATH_MAX
 #include <cstdlib>
 #include <cstdint>
@@ -101,6 +108,8 @@ extern "C" {
 // those files do not supply the symbol.
 extern char __attribute__((weak)) __node_text_start;
 extern char __start_lpstub;
+// Emitted by V8's mksnapshot into embedded.S. Weak for the same reason.
+extern const uint8_t __attribute__((weak)) v8_Default_embedded_blob_code_[];
 }  // extern "C"
 #endif  // defined(__linux__) || defined(__FreeBSD__)
 
@@ -203,7 +212,15 @@ struct text_region FindNodeTextRegion() {
           reinterpret_cast<void*>(dl_params.reference_sym),
           reinterpret_cast<void*>(dl_params.end));
 
+    uintptr_t segment_start = dl_params.start;
     dl_params.start = dl_params.reference_sym;
+    uintptr_t blob_start =
+        reinterpret_cast<uintptr_t>(v8_Default_embedded_blob_code_);
+    if (blob_start >= segment_start && blob_start < dl_params.start) {
+      Debug("Extending start for the embedded builtins: %p\n",
+            reinterpret_cast<void*>(blob_start));
+      dl_params.start = blob_start;
+    }
     if (lpstub_start > dl_params.start && lpstub_start <= dl_params.end) {
       Debug("Trimming end for lpstub: %p\n",
             reinterpret_cast<void*>(lpstub_start));
@@ -438,6 +455,38 @@ int MapStaticCodeToLargePages() {
 #endif
 }
 
+int AdviseCodeRangeLargePages(v8::Isolate* isolate) {
+#if defined(NODE_ENABLE_LARGE_CODE_PAGES) && NODE_ENABLE_LARGE_CODE_PAGES && \
+    defined(__linux__)
+  if (!IsTransparentHugePagesEnabled())
+    return EACCES;
+
+  void* start = nullptr;
+  size_t length = 0;
+  isolate->GetCodeRange(&start, &length);
+  // The range is only reserved here, so khugepaged and the page fault handler
+  // can back it with huge pages as V8 commits code pages in it.
+  char* from = reinterpret_cast<char*>(
+      hugepage_align_up(reinterpret_cast<uintptr_t>(start)));
+  char* to = reinterpret_cast<char*>(
+      hugepage_align_down(reinterpret_cast<uintptr_t>(start) + length));
+  Debug("Code range is %p - %p, aligned to %p - %p\n",
+        start,
+        static_cast<char*>(start) + length,
+        from,
+        to);
+  if (length == 0 || from >= to)
+    return ENOENT;
+  if (madvise(from, to - from, 14 /* MADV_HUGEPAGE */) == -1) {
+    PrintSystemError(errno);
+    return -1;
+  }
+  return 0;
+#else
+  return ENOTSUP;
+#endif
+}
+
 const char* LargePagesError(int status) {
   switch (status) {
     case ENOTSUP:
@@ -25,8 +25,13 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+namespace v8 {
+class Isolate;
+}  // namespace v8
+
 namespace node {
 int MapStaticCodeToLargePages();
+int AdviseCodeRangeLargePages(v8::Isolate* isolate);
 const char* LargePagesError(int status);
 }  // namespace node
 
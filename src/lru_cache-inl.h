@@ -1,6 +1,7 @@
 #ifndef SRC_LRU_CACHE_INL_H_
 #define SRC_LRU_CACHE_INL_H_
 
+#include <cstddef>
 #include <list>
 #include <unordered_map>
 #include <utility>
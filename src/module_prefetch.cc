@@ -0,0 +1,768 @@
+#include "module_prefetch.h"
+#include "ada.h"
+#include "debug_utils-inl.h"
+#include "env-inl.h"
+#include "node_internals.h"
+#include "node_url.h"
+#include "path.h"
+#include "threadpoolwork-inl.h"
+#include "util-inl.h"
+
+#include <cstring>
+
+namespace node {
+namespace loader {
+
+using v8::Context;
+using v8::FixedArray;
+using v8::Function;
+using v8::HandleScope;
+using v8::Isolate;
+using v8::Local;
+using v8::ModuleRequest;
+using v8::PrimitiveArray;
+using v8::Script;
+using v8::ScriptCompiler;
+using v8::ScriptOrigin;
+using v8::ScriptType;
+using v8::String;
+using v8::TryCatch;
+using v8::Value;
+
+namespace {
+
+bool IsIdentifierChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '$' ||
+         static_cast<unsigned char>(c) >= 0x80;
+}
+
+bool IsWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+bool IsQuote(char c) {
+  return c == '\'' || c == '"';
+}
+
+class ImportLexer {
+ public:
+  // With common_js, require() calls are scanned for instead of import and
+  // export declarations.
+  ImportLexer(std::string_view source, bool common_js)
+      : source_(source), common_js_(common_js) {}
+
+  std::vector<std::string> Scan() {
+    // The last significant character, to tell regular expressions from
+    // divisions: a slash starts a regular expression unless it follows an
+    // operand. Identifiers and numbers are recorded as 'a'.
+    char last = '\0';
+    while (pos_ < source_.size()) {
+      char c = source_[pos_];
+      if (IsWhitespace(c) || SkipComment()) {
+        if (IsWhitespace(c)) pos_++;
+        continue;
+      }
+      if (IsQuote(c)) {
+        SkipString(nullptr);
+        last = '"';
+      } else if (c == '`') {
+        SkipTemplate(0);
+        last = '`';
+      } else if (c == '/') {
+        if (last == 'a' || last == ')' || last == ']' || last == '"' ||
+            last == '`') {
+          pos_++;
+          last = '/';
+        } else {
+          SkipRegExp();
+          last = '"';
+        }
+      } else if (IsIdentifierChar(c)) {
+        bool after_dot = last == '.';
+        std::string_view word = ReadIdentifier();
+        last = IsKeywordBeforeExpression(word) ? '=' : 'a';
+        if (after_dot) continue;
+        if (common_js_) {
+          if (word == "require") ScanRequire();
+        } else if (word == "import") {
+          ScanImport();
+          last = ';';
+        } else if (word == "export") {
+          ScanExport();
+          last = ';';
+        }
+      } else {
+        if (c == '{') {
+          depth_++;
+        } else if (c == '}' && --depth_ < 0) {
+          balanced_ = false;
+        }
+        pos_++;
+        last = c;
+      }
+    }
+    return std::move(specifiers_);
+  }
+
+  bool balanced() const { return balanced_ && depth_ == 0; }
+
+ private:
+  // Template literals nest through their substitutions; give up on sources
+  // that nest them deeper than this.
+  static constexpr int kMaxTemplateDepth = 64;
+
+  static bool IsKeywordBeforeExpression(std::string_view word) {
+    return word == "return" || word == "typeof" || word == "case" ||
+           word == "do" || word == "else" || word == "in" || word == "of" ||
+           word == "new" || word == "delete" || word == "void" ||
+           word == "throw" || word == "instanceof" || word == "yield" ||
+           word == "await";
+  }
+
+  char Peek(size_t offset = 0) const {
+    return pos_ + offset < source_.size() ? source_[pos_ + offset] : '\0';
+  }
+
+  bool SkipComment() {
+    if (Peek() != '/') return false;
+    if (Peek(1) == '/') {
+      size_t end = source_.find('\n', pos_);
+      pos_ = end == std::string_view::npos ? source_.size() : end;
+      return true;
+    }
+    if (Peek(1) == '*') {
+      size_t end = source_.find("*/", pos_ + 2);
+      pos_ = end == std::string_view::npos ? source_.size() : end + 2;
+      return true;
+    }
+    return false;
+  }
+
+  void SkipTrivia() {
+    while (pos_ < source_.size()) {
+      if (IsWhitespace(source_[pos_])) {
+        pos_++;
+      } else if (!SkipComment()) {
+        return;
+      }
+    }
+  }
+
+  // Skips the string literal at pos_. If value is not nullptr, stores its
+  // contents there and returns true if it is terminated and contains no
+  // escapes.
+  bool SkipString(std::string* value) {
+    char quote = source_[pos_++];
+    size_t start = pos_;
+    bool escaped = false;
+    while (pos_ < source_.size()) {
+      char c = source_[pos_];
+      if (c == '\\') {
+        escaped = true;
+        pos_ += 2;
+      } else if (c == quote) {
+        if (value != nullptr) {
+          value->assign(source_.substr(start, pos_ - start));
+        }
+        pos_++;
+        return !escaped;
+      } else if (c == '\n') {
+        return false;
+      } else {
+        pos_++;
+      }
+    }
+    return false;
+  }
+
+  void SkipTemplate(int depth) {
+    if (depth > kMaxTemplateDepth) {
+      pos_ = source_.size();
+      return;
+    }
+    pos_++;
+    while (pos_ < source_.size()) {
+      char c = source_[pos_];
+      if (c == '\\') {
+        pos_ += 2;
+      } else if (c == '`') {
+        pos_++;
+        return;
+      } else if (c == '$' && Peek(1) == '{') {
+        pos_ += 2;
+        SkipSubstitution(depth);
+      } else {
+        pos_++;
+      }
+    }
+  }
+
+  // Skips to after the brace that closes a template substitution.
+  void SkipSubstitution(int depth) {
+    int braces = 0;
+    while (pos_ < source_.size()) {
+      char c = source_[pos_];
+      if (IsQuote(c)) {
+        SkipString(nullptr);
+      } else if (c == '`') {
+        SkipTemplate(depth + 1);
+      } else if (SkipComment()) {
+        continue;
+      } else if (c == '{') {
+        braces++;
+        pos_++;
+      } else if (c == '}') {
+        pos_++;
+        if (braces-- == 0) return;
+      } else {
+        pos_++;
+      }
+    }
+  }
+
+  void SkipRegExp() {
+    pos_++;
+    bool in_class = false;
+    while (pos_ < source_.size()) {
+      char c = source_[pos_];
+      if (c == '\\') {
+        pos_ += 2;
+      } else if (c == '\n') {
+        return;
+      } else if (c == '[') {
+        in_class = true;
+        pos_++;
+      } else if (c == ']') {
+        in_class = false;
+        pos_++;
+      } else if (c == '/' && !in_class) {
+        pos_++;
+        while (pos_ < source_.size() && IsIdentifierChar(source_[pos_])) {
+          pos_++;
+        }
+        return;
+      } else {
+        pos_++;
+      }
+    }
+  }
+
+  std::string_view ReadIdentifier() {
+    size_t start = pos_;
+    while (pos_ < source_.size() && IsIdentifierChar(source_[pos_])) pos_++;
+    return source_.substr(start, pos_ - start);
+  }
+
+  void AddSpecifier(std::string&& specifier) {
+    if (!specifier.empty()) specifiers_.push_back(std::move(specifier));
+  }
+
+  // pos_ is after `import`.
+  void ScanImport() {
+    SkipTrivia();
+    char c = Peek();
+    std::string specifier;
+    if (c == '(') {
+      // import('specifier'[, options])
+      pos_++;
+      SkipTrivia();
+      if (!IsQuote(Peek()) || !SkipString(&specifier)) return;
+      SkipTrivia();
+      if (Peek() == ')' || Peek() == ',') AddSpecifier(std::move(specifier));
+    } else if (IsQuote(c)) {
+      // import 'specifier'
+      if (SkipString(&specifier)) AddSpecifier(std::move(specifier));
+    } else if (c != '.') {
+      // Anything but import.meta.
+      ScanFromClause();
+    }
+  }
+
+  // pos_ is after `require`.
+  void ScanRequire() {
+    SkipTrivia();
+    if (Peek() != '(') return;
+    pos_++;
+    SkipTrivia();
+    std::string specifier;
+    if (!IsQuote(Peek()) || !SkipString(&specifier)) return;
+    SkipTrivia();
+    if (Peek() == ')') AddSpecifier(std::move(specifier));
+  }
+
+  // pos_ is after `export`.
+  void ScanExport() {
+    SkipTrivia();
+    // export * [as name] from 'specifier', export { ... } from 'specifier'
+    if (Peek() == '*' || Peek() == '{') ScanFromClause();
+  }
+
+  // Skips the bindings of an import or export declaration up to
+  // `from 'specifier'`, stopping at anything else.
+  void ScanFromClause() {
+    while (pos_ < source_.size()) {
+      SkipTrivia();
+      char c = Peek();
+      if (IsIdentifierChar(c)) {
+        std::string_view word = ReadIdentifier();
+        if (word != "from") continue;
+        SkipTrivia();
+        std::string specifier;
+        if (IsQuote(Peek())) {
+          if (SkipString(&specifier)) AddSpecifier(std::move(specifier));
+          return;
+        }
+      } else if (c == '{' || c == '}' || c == ',' || c == '*') {
+        pos_++;
+      } else if (IsQuote(c)) {
+        // A string export name, as in import { "a-b" as ab } from '...'.
+        SkipString(nullptr);
+      } else {
+        return;
+      }
+    }
+  }
+
+  std::string_view source_;
+  const bool common_js_;
+  size_t pos_ = 0;
+  // The nesting of braces outside of template substitutions.
+  int64_t depth_ = 0;
+  bool balanced_ = true;
+  std::vector<std::string> specifiers_;
+};
+
+// Hands the whole source to V8 in one chunk.
+class SourceStream final : public ScriptCompiler::ExternalSourceStream {
+ public:
+  explicit SourceStream(const std::string* source) : source_(source) {}
+
+  size_t GetMoreData(const uint8_t** src) override {
+    if (done_ || source_->empty()) return 0;
+    done_ = true;
+    // V8 takes ownership of the chunk.
+    uint8_t* chunk = new uint8_t[source_->size()];
+    memcpy(chunk, source_->data(), source_->size());
+    *src = chunk;
+    return source_->size();
+  }
+
+ private:
+  const std::string* source_;
+  bool done_ = false;
+};
+
+// CommonJS modules are streamed as a function expression, since V8 has no
+// streaming form of ScriptCompiler::CompileFunction().
+constexpr std::string_view kCommonJSWrapperPrefix =
+    "(function (exports, require, module, __filename, __dirname) {\n";
+constexpr std::string_view kCommonJSWrapperSuffix = "\n})";
+
+bool IsPrefetchableSpecifier(std::string_view specifier) {
+  return specifier.starts_with("./") || specifier.starts_with("../") ||
+         specifier.starts_with("/") || specifier.starts_with("file:");
+}
+
+}  // namespace
+
+std::vector<std::string> ScanModuleImports(std::string_view source) {
+  return ImportLexer(source, false).Scan();
+}
+
+std::vector<std::string> ScanRequireCalls(std::string_view source,
+                                          bool* balanced) {
+  ImportLexer lexer(source, true);
+  std::vector<std::string> specifiers = lexer.Scan();
+  if (balanced != nullptr) *balanced = lexer.balanced();
+  return specifiers;
+}
+
+// Reads a module, or the first of several candidate files for a CommonJS
+// module, and scans it for the modules it loads. For a CommonJS module that
+// the loader has already compiled, only scans the given source.
+class ModulePrefetcher::ReadWork final : public ThreadPoolWork {
+ public:
+  ReadWork(ModulePrefetcher* prefetcher,
+           bool common_js,
+           std::string key,
+           std::vector<std::string>&& candidates)
+      : ThreadPoolWork(prefetcher->env_, "module_prefetch", Lane::kIo),
+        prefetcher_(prefetcher),
+        common_js_(common_js),
+        key_(std::move(key)),
+        candidates_(std::move(candidates)) {}
+
+  ReadWork(ModulePrefetcher* prefetcher,
+           std::string filename,
+           std::string&& source)
+      : ThreadPoolWork(prefetcher->env_, "module_prefetch", Lane::kCpu),
+        prefetcher_(prefetcher),
+        common_js_(true),
+        scan_only_(true),
+        path_(std::move(filename)),
+        source_(std::move(source)) {}
+
+  void DoThreadPoolWork() override {
+    if (!scan_only_) {
+      err_ = UV_ENOENT;
+      for (const std::string& candidate : candidates_) {
+        err_ = ReadFileSync(&source_, candidate.c_str());
+        if (err_ == 0) {
+          path_ = candidate;
+          break;
+        }
+      }
+      if (err_ < 0) return;
+    }
+    specifiers_ = common_js_ ? ScanRequireCalls(source_, &balanced_)
+                             : ScanModuleImports(source_);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<ReadWork> self(this);
+    if (status < 0) err_ = status;
+    if (common_js_) {
+      prefetcher_->OnCommonJSRead(this);
+    } else {
+      prefetcher_->OnRead(this);
+    }
+  }
+
+ private:
+  friend class ModulePrefetcher;
+
+  ModulePrefetcher* prefetcher_;
+  const bool common_js_;
+  const bool scan_only_ = false;
+  // The URL of an ES module, or the path that a require() resolved to.
+  std::string key_;
+  std::vector<std::string> candidates_;
+  int err_ = 0;
+  std::string path_;
+  std::string source_;
+  std::vector<std::string> specifiers_;
+  bool balanced_ = false;
+};
+
+class ModulePrefetcher::StreamWork final : public ThreadPoolWork {
+ public:
+  StreamWork(ModulePrefetcher* prefetcher, Module* module)
+      : ThreadPoolWork(prefetcher->env_, "module_prefetch", Lane::kCpu),
+        prefetcher_(prefetcher),
+        module_(module) {}
+
+  void DoThreadPoolWork() override { module_->task->Run(); }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<StreamWork> self(this);
+    prefetcher_->OnStreamed(module_);
+  }
+
+ private:
+  ModulePrefetcher* prefetcher_;
+  Module* module_;
+};
+
+ModulePrefetcher::ModulePrefetcher(Environment* env) : env_(env) {}
+
+ModulePrefetcher::~ModulePrefetcher() = default;
+
+bool ModulePrefetcher::HasCapacity() const {
+  return modules_.size() + common_js_requested_.size() < kMaxModules;
+}
+
+void ModulePrefetcher::OnCompiled(Module* module) {
+  if (module->state == Module::State::kReady) {
+    // Compiled from a different source, or by a different loader.
+    Drop(module);
+  } else {
+    module->compiled = true;
+  }
+}
+
+void ModulePrefetcher::OnModuleCompiled(Local<String> url,
+                                        Local<v8::Module> module) {
+  Isolate* isolate = env_->isolate();
+  HandleScope handle_scope(isolate);
+  Utf8Value url_value(isolate, url);
+  std::string href = url_value.ToString();
+  if (!href.starts_with("file:")) return;
+
+  std::unique_ptr<Module>& entry = modules_[href];
+  if (!entry) {
+    entry = std::make_unique<Module>();
+    entry->state = Module::State::kDone;
+  } else {
+    OnCompiled(entry.get());
+  }
+
+  Local<Context> context = env_->context();
+  Local<FixedArray> requests = module->GetModuleRequests();
+  std::vector<std::string> specifiers;
+  specifiers.reserve(requests->Length());
+  for (int i = 0; i < requests->Length(); i++) {
+    Local<ModuleRequest> request =
+        requests->Get(context, i).As<ModuleRequest>();
+    Utf8Value specifier(isolate, request->GetSpecifier());
+    specifiers.push_back(specifier.ToString());
+  }
+  PrefetchImports(href, specifiers);
+}
+
+void ModulePrefetcher::OnCommonJSCompiled(Local<String> filename,
+                                          Local<String> code) {
+  if (env_->is_stopping()) return;
+  Isolate* isolate = env_->isolate();
+  Utf8Value filename_value(isolate, filename);
+  std::string path = filename_value.ToString();
+  if (!IsAbsoluteFilePath(path)) return;
+
+  std::unique_ptr<Module>& entry = common_js_modules_[path];
+  if (!entry) {
+    entry = std::make_unique<Module>();
+    entry->state = Module::State::kDone;
+  } else {
+    OnCompiled(entry.get());
+  }
+
+  Utf8Value code_value(isolate, code);
+  (new ReadWork(this, std::move(path), code_value.ToString()))->ScheduleWork();
+}
+
+void ModulePrefetcher::PrefetchImports(
+    std::string_view parent_url, const std::vector<std::string>& specifiers) {
+  if (env_->is_stopping()) return;
+  auto parent = ada::parse<ada::url_aggregator>(parent_url);
+  if (!parent) return;
+
+  HandleScope handle_scope(env_->isolate());
+  for (const std::string& specifier : specifiers) {
+    if (!HasCapacity()) return;
+    if (!IsPrefetchableSpecifier(specifier)) continue;
+    auto url = ada::parse<ada::url_aggregator>(specifier, &parent.value());
+    if (!url || url->type != ada::scheme::FILE) continue;
+    std::string_view pathname = url->get_pathname();
+    if (!pathname.ends_with(".mjs") && !pathname.ends_with(".js")) continue;
+
+    std::string href(url->get_href());
+    std::unique_ptr<Module>& module = modules_[href];
+    if (module) continue;
+    module = std::make_unique<Module>();
+    // The URLs that the loader would reject are left to it.
+    TryCatch try_catch(env_->isolate());
+    std::optional<std::string> path = url::FileURLToPath(env_, *url);
+    if (!path.has_value()) {
+      module->state = Module::State::kDone;
+      continue;
+    }
+    per_process::Debug(
+        DebugCategory::MODULE, "[module prefetch] reading %s\n", href);
+    std::vector<std::string> candidates{std::move(*path)};
+    (new ReadWork(this, false, std::move(href), std::move(candidates)))
+        ->ScheduleWork();
+  }
+}
+
+void ModulePrefetcher::PrefetchRequires(
+    std::string_view parent_filename,
+    const std::vector<std::string>& specifiers) {
+  if (env_->is_stopping()) return;
+#ifdef _WIN32
+  size_t separator = parent_filename.find_last_of("/\\");
+#else
+  size_t separator = parent_filename.find_last_of('/');
+#endif
+  if (separator == std::string_view::npos) return;
+  std::string_view dirname = parent_filename.substr(0, separator + 1);
+
+  for (const std::string& specifier : specifiers) {
+    if (!HasCapacity()) return;
+    if (!specifier.starts_with("./") && !specifier.starts_with("../")) {
+      continue;
+    }
+    std::string path = PathResolve(env_, {dirname, specifier});
+    if (common_js_modules_.contains(path) ||
+        !common_js_requested_.insert(path).second) {
+      continue;
+    }
+    // The files that require() would try first. Anything else, like
+    // package.json "main" fields or .json and .node files, is left to the
+    // loader.
+    std::vector<std::string> candidates;
+    if (path.ends_with(".js") || path.ends_with(".cjs")) {
+      candidates.push_back(path);
+    } else {
+      candidates.push_back(path + ".js");
+      candidates.push_back(path + kPathSeparator + "index.js");
+    }
+    per_process::Debug(
+        DebugCategory::MODULE, "[module prefetch] reading %s\n", path);
+    (new ReadWork(this, true, std::move(path), std::move(candidates)))
+        ->ScheduleWork();
+  }
+}
+
+void ModulePrefetcher::OnRead(ReadWork* work) {
+  HandleScope handle_scope(env_->isolate());
+  Module* module = modules_[work->key_].get();
+  if (work->err_ < 0 || env_->is_stopping()) {
+    module->state = Module::State::kDone;
+    return;
+  }
+  PrefetchImports(work->key_, work->specifiers_);
+
+  // Compiling from the compile cache is cheaper than streaming.
+  if (module->compiled || source_bytes_ > kMaxSourceBytes ||
+      env_->use_compile_cache()) {
+    module->state = Module::State::kDone;
+    return;
+  }
+  module->source = std::move(work->source_);
+  StartStreaming(module, ScriptType::kModule);
+}
+
+void ModulePrefetcher::OnCommonJSRead(ReadWork* work) {
+  HandleScope handle_scope(env_->isolate());
+  if (work->err_ < 0 || env_->is_stopping()) return;
+  PrefetchRequires(work->path_, work->specifiers_);
+  if (work->scan_only_) return;
+
+  std::unique_ptr<Module>& module = common_js_modules_[work->path_];
+  // Already compiled by the loader, or read for another require().
+  if (module) return;
+  module = std::make_unique<Module>();
+  module->state = Module::State::kDone;
+  // A hashbang is only valid at the start of a script.
+  if (!work->balanced_ || work->source_.starts_with("#!") ||
+      source_bytes_ > kMaxSourceBytes || env_->use_compile_cache()) {
+    return;
+  }
+  module->source.reserve(kCommonJSWrapperPrefix.size() +
+                         work->source_.size() +
+                         kCommonJSWrapperSuffix.size());
+  module->source.append(kCommonJSWrapperPrefix)
+      .append(work->source_)
+      .append(kCommonJSWrapperSuffix);
+  StartStreaming(module.get(), ScriptType::kClassic);
+}
+
+void ModulePrefetcher::StartStreaming(Module* module, ScriptType type) {
+  source_bytes_ += module->source.size();
+  module->streamed = std::make_unique<ScriptCompiler::StreamedSource>(
+      std::make_unique<SourceStream>(&module->source),
+      ScriptCompiler::StreamedSource::UTF8);
+  module->task.reset(ScriptCompiler::StartStreaming(
+      env_->isolate(), module->streamed.get(), type));
+  module->state = Module::State::kStreaming;
+  (new StreamWork(this, module))->ScheduleWork();
+}
+
+void ModulePrefetcher::OnStreamed(Module* module) {
+  module->task.reset();
+  module->state = Module::State::kReady;
+  if (module->compiled || env_->is_stopping()) Drop(module);
+}
+
+void ModulePrefetcher::Drop(Module* module) {
+  CHECK_GE(source_bytes_, module->source.size());
+  source_bytes_ -= module->source.size();
+  module->source = std::string();
+  module->streamed.reset();
+  module->state = Module::State::kDone;
+}
+
+std::unique_ptr<ScriptCompiler::StreamedSource>
+ModulePrefetcher::TakeStreamedSource(Local<String> url, Local<String> source) {
+  Isolate* isolate = env_->isolate();
+  Utf8Value url_value(isolate, url);
+  auto it = modules_.find(url_value.ToString());
+  if (it == modules_.end()) return nullptr;
+  Module* module = it->second.get();
+  if (module->state != Module::State::kReady) return nullptr;
+
+  std::unique_ptr<ScriptCompiler::StreamedSource> result;
+  Utf8Value source_value(isolate, source);
+  if (source_value.ToStringView() == module->source) {
+    result = std::move(module->streamed);
+  }
+  per_process::Debug(DebugCategory::MODULE,
+                     "[module prefetch] %s for %s\n",
+                     result ? "using streamed compilation" : "source changed",
+                     url_value.ToStringView());
+  Drop(module);
+  return result;
+}
+
+bool ModulePrefetcher::CompileCommonJS(
+    Local<Context> context,
+    Local<String> filename,
+    Local<String> code,
+    Local<PrimitiveArray> host_defined_options,
+    Local<Function>* fn) {
+  Isolate* isolate = env_->isolate();
+  Utf8Value filename_value(isolate, filename);
+  auto it = common_js_modules_.find(filename_value.ToString());
+  if (it == common_js_modules_.end()) return false;
+  Module* module = it->second.get();
+  if (module->state != Module::State::kReady) return false;
+
+  std::string_view wrapped = module->source;
+  Utf8Value code_value(isolate, code);
+  bool same_source = wrapped.size() == kCommonJSWrapperPrefix.size() +
+                                           code_value.length() +
+                                           kCommonJSWrapperSuffix.size() &&
+                     wrapped.substr(kCommonJSWrapperPrefix.size(),
+                                    code_value.length()) ==
+                         code_value.ToStringView();
+  std::unique_ptr<ScriptCompiler::StreamedSource> streamed =
+      std::move(module->streamed);
+  Drop(module);
+  if (!same_source) {
+    per_process::Debug(DebugCategory::MODULE,
+                       "[module prefetch] source changed for %s\n",
+                       filename_value.ToStringView());
+    return false;
+  }
+
+  Local<String> full_source = String::Concat(
+      isolate,
+      String::Concat(isolate, OneByteString(isolate, kCommonJSWrapperPrefix),
+                     code),
+      OneByteString(isolate, kCommonJSWrapperSuffix));
+  // The wrapper has a line of its own, so that the positions in the first
+  // line of the module are not shifted.
+  ScriptOrigin origin(filename,
+                      -1,              // line offset
+                      0,               // column offset
+                      true,            // is cross origin
+                      -1,              // script id
+                      Local<Value>(),  // source map URL
+                      false,           // is opaque
+                      false,           // is WASM
+                      false,           // is ES Module
+                      host_defined_options);
+  TryCatch try_catch(isolate);
+  Local<Script> script;
+  Local<Value> result;
+  // Errors are left to the loader to report as it would without the
+  // wrapper. The balanced braces make running the script only evaluate the
+  // function expression, which must start in the wrapper.
+  if (!ScriptCompiler::Compile(context, streamed.get(), full_source, origin)
+           .ToLocal(&script) ||
+      !script->Run(context).ToLocal(&result) || !result->IsFunction() ||
+      result.As<Function>()->GetScriptStartPosition() >=
+          static_cast<int>(kCommonJSWrapperPrefix.size())) {
+    if (try_catch.HasTerminated()) try_catch.ReThrow();
+    return false;
+  }
+  per_process::Debug(DebugCategory::MODULE,
+                     "[module prefetch] using streamed compilation for %s\n",
+                     filename_value.ToStringView());
+  *fn = result.As<Function>();
+  return true;
+}
+
+}  // namespace loader
+}  // namespace node
@@ -0,0 +1,133 @@
+#ifndef SRC_MODULE_PREFETCH_H_
+#define SRC_MODULE_PREFETCH_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "v8-script.h"
+
+namespace node {
+
+class Environment;
+
+namespace loader {
+
+// Returns the specifiers of the static imports and re-exports of an ES
+// module source, and of the dynamic imports of string literals, in the
+// order they appear. This is a lexer, not a parser: it skips comments,
+// strings, template literals and regular expressions, and only recognizes
+// the import and export forms that name a specifier. It is only used to
+// guess which modules will be loaded next, so it may be wrong on unusual
+// sources but never fails.
+std::vector<std::string> ScanModuleImports(std::string_view source);
+
+// Like ScanModuleImports(), for the require() calls of string literals in a
+// CommonJS module. If balanced is not nullptr, it is set to whether the
+// braces outside of strings, comments and template literals are balanced,
+// i.e. whether the source can be wrapped in a function expression without
+// ending it early.
+std::vector<std::string> ScanRequireCalls(std::string_view source,
+                                          bool* balanced = nullptr);
+
+// Loads the static import graph of the ES modules ahead of the loader.
+// When a file: module is compiled, the modules it imports with relative
+// or file: specifiers are read and lexed on the threadpool, in parallel,
+// and so on for their imports. The sources that are read are then parsed
+// and compiled with V8's streaming compiler on the threadpool, so that
+// when the loader gets to them, ModuleWrap only has to finish the
+// compilation. Specifiers that the loader resolves differently, or sources
+// that it transforms before compiling them, only cost the read.
+//
+// The same is done for the relative require() calls of CommonJS modules,
+// which are streamed wrapped in a function expression.
+class ModulePrefetcher {
+ public:
+  // Limits on what is prefetched, for graphs that are much larger than
+  // what is ever loaded.
+  static constexpr size_t kMaxModules = 4096;
+  static constexpr size_t kMaxSourceBytes = 64 * 1024 * 1024;
+
+  explicit ModulePrefetcher(Environment* env);
+  ~ModulePrefetcher();
+
+  ModulePrefetcher(const ModulePrefetcher&) = delete;
+  ModulePrefetcher& operator=(const ModulePrefetcher&) = delete;
+
+  // Called when the loader has compiled the module at url, to prefetch the
+  // modules it imports.
+  void OnModuleCompiled(v8::Local<v8::String> url,
+                        v8::Local<v8::Module> module);
+
+  // Returns the streamed source of the module at url if it has been
+  // compiled in the background from exactly source, or nullptr.
+  std::unique_ptr<v8::ScriptCompiler::StreamedSource> TakeStreamedSource(
+      v8::Local<v8::String> url, v8::Local<v8::String> source);
+
+  // Called when the CommonJS loader has compiled the module at filename,
+  // to prefetch the modules it requires.
+  void OnCommonJSCompiled(v8::Local<v8::String> filename,
+                          v8::Local<v8::String> code);
+
+  // If the CommonJS module at filename has been compiled in the background
+  // from exactly code, finishes the compilation into *fn and returns true.
+  bool CompileCommonJS(v8::Local<v8::Context> context,
+                       v8::Local<v8::String> filename,
+                       v8::Local<v8::String> code,
+                       v8::Local<v8::PrimitiveArray> host_defined_options,
+                       v8::Local<v8::Function>* fn);
+
+ private:
+  class ReadWork;
+  class StreamWork;
+
+  struct Module {
+    enum class State { kReading, kStreaming, kReady, kDone };
+    State state = State::kReading;
+    // Set when the loader compiled the module before it was streamed.
+    bool compiled = false;
+    // The source as read from the file, wrapped for CommonJS modules, until
+    // the module is compiled.
+    std::string source;
+    std::unique_ptr<v8::ScriptCompiler::StreamedSource> streamed;
+    std::unique_ptr<v8::ScriptCompiler::ScriptStreamingTask> task;
+  };
+
+  bool HasCapacity() const;
+  void OnCompiled(Module* module);
+  // Starts prefetching the modules that the module at parent_url imports.
+  void PrefetchImports(std::string_view parent_url,
+                       const std::vector<std::string>& specifiers);
+  // Starts prefetching the modules that the CommonJS module at
+  // parent_filename requires.
+  void PrefetchRequires(std::string_view parent_filename,
+                        const std::vector<std::string>& specifiers);
+  void OnRead(ReadWork* work);
+  void OnCommonJSRead(ReadWork* work);
+  void StartStreaming(Module* module, v8::ScriptType type);
+  void OnStreamed(Module* module);
+  // Frees the source and streamed compilation of a module that will not be
+  // compiled from them.
+  void Drop(Module* module);
+
+  Environment* env_;
+  // Keyed by the href of the module URL.
+  std::unordered_map<std::string, std::unique_ptr<Module>> modules_;
+  // Keyed by the filename of the module.
+  std::unordered_map<std::string, std::unique_ptr<Module>> common_js_modules_;
+  // The paths that require() calls were resolved to, before trying the
+  // extensions.
+  std::unordered_set<std::string> common_js_requested_;
+  size_t source_bytes_ = 0;
+};
+
+}  // namespace loader
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_MODULE_PREFETCH_H_
@@ -0,0 +1,139 @@
+#include "module_stat_cache.h"
+#include "util-inl.h"
+
+#include <sys/stat.h>
+
+#ifndef S_ISDIR
+#define S_ISDIR(mode) (((mode) & S_IFMT) == S_IFDIR)
+#endif
+
+namespace node {
+
+namespace {
+
+#ifdef _WIN32
+constexpr const char* kPathSeparators = "\\/";
+#else
+constexpr const char* kPathSeparators = "/";
+#endif
+
+bool SameTime(const uv_timespec_t& a, const uv_timespec_t& b) {
+  return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+}  // namespace
+
+int InternalModuleStatUncached(uv_loop_t* loop, const char* path) {
+  uv_fs_t req;
+  int rc = uv_fs_stat(loop, &req, path, nullptr);
+  if (rc == 0) {
+    const uv_stat_t* const s = static_cast<const uv_stat_t*>(req.ptr);
+    rc = S_ISDIR(s->st_mode);
+  }
+  uv_fs_req_cleanup(&req);
+  return rc;
+}
+
+ModuleStatCache* ModuleStatCache::GetPerProcess() {
+  static ModuleStatCache cache;
+  return &cache;
+}
+
+int ModuleStatCache::Stat(uv_loop_t* loop, const std::string& path) {
+  std::string validated_dir;
+  return Lookup(loop, path, &validated_dir);
+}
+
+void ModuleStatCache::StatBatch(uv_loop_t* loop,
+                                const std::vector<std::string>& paths,
+                                int32_t* results) {
+  std::string validated_dir;
+  for (size_t i = 0; i < paths.size(); i++)
+    results[i] = Lookup(loop, paths[i], &validated_dir);
+}
+
+int ModuleStatCache::Lookup(uv_loop_t* loop,
+                            const std::string& path,
+                            std::string* validated_dir) {
+  const size_t sep = path.find_last_of(kPathSeparators);
+  // Bare names and paths ending in a separator are rare here and not worth
+  // the special cases.
+  if (sep == std::string::npos || sep + 1 == path.size())
+    return InternalModuleStatUncached(loop, path.c_str());
+
+  std::string dir = path.substr(0, sep == 0 ? 1 : sep);
+  std::string name = path.substr(sep + 1);
+
+  if (dir != *validated_dir) {
+    uv_fs_t req;
+    int rc = uv_fs_stat(loop, &req, dir.c_str(), nullptr);
+    if (rc != 0) {
+      uv_fs_req_cleanup(&req);
+      validated_dir->clear();
+      Mutex::ScopedLock lock(mutex_);
+      auto it = directories_.find(dir);
+      if (it != directories_.end()) {
+        size_ -= it->second.entries.size();
+        directories_.erase(it);
+      }
+      // Whatever went wrong with the directory, the path itself tells.
+      return InternalModuleStatUncached(loop, path.c_str());
+    }
+    const uv_stat_t* const s = static_cast<const uv_stat_t*>(req.ptr);
+    const uv_timespec_t mtime = s->st_mtim;
+    const uv_timespec_t ctime = s->st_ctim;
+    uv_fs_req_cleanup(&req);
+    uv_timespec64_t now;
+    CHECK_EQ(uv_clock_gettime(UV_CLOCK_REALTIME, &now), 0);
+
+    Mutex::ScopedLock lock(mutex_);
+    Directory& entry = directories_[dir];
+    if (!SameTime(entry.mtime, mtime) || !SameTime(entry.ctime, ctime)) {
+      size_ -= entry.entries.size();
+      entry.entries.clear();
+      entry.mtime = mtime;
+      entry.ctime = ctime;
+    }
+    entry.racy = mtime.tv_sec >= now.tv_sec - kRacyIntervalSeconds;
+    *validated_dir = std::move(dir);
+  }
+
+  {
+    Mutex::ScopedLock lock(mutex_);
+    auto dir_it = directories_.find(*validated_dir);
+    if (dir_it != directories_.end()) {
+      auto it = dir_it->second.entries.find(name);
+      if (it != dir_it->second.entries.end()) return it->second;
+    }
+  }
+
+  // Do not hold the lock across the syscall. The directory was validated
+  // before the stat(), so a result raced by a concurrent change is newer
+  // than the timestamps it is filed under, and the next validation drops it.
+  const int rc = InternalModuleStatUncached(loop, path.c_str());
+  // Errors other than a missing path may well be transient.
+  if (rc < 0 && rc != UV_ENOENT && rc != UV_ENOTDIR) return rc;
+
+  Mutex::ScopedLock lock(mutex_);
+  if (size_ >= kMaxEntries) {
+    directories_.clear();
+    size_ = 0;
+  }
+  auto dir_it = directories_.find(*validated_dir);
+  if (dir_it == directories_.end() || dir_it->second.racy) return rc;
+  if (dir_it->second.entries.emplace(std::move(name), rc).second) size_++;
+  return rc;
+}
+
+void ModuleStatCache::Clear() {
+  Mutex::ScopedLock lock(mutex_);
+  directories_.clear();
+  size_ = 0;
+}
+
+size_t ModuleStatCache::size() {
+  Mutex::ScopedLock lock(mutex_);
+  return size_;
+}
+
+}  // namespace node
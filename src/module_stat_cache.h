@@ -0,0 +1,77 @@
+#ifndef SRC_MODULE_STAT_CACHE_H_
+#define SRC_MODULE_STAT_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_mutex.h"
+#include "uv.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace node {
+
+// Remembers what stat() said about the paths module resolution probes,
+// most of which do not exist. Entries are grouped by directory and are only
+// trusted while the directory's mtime and ctime are unchanged: creating,
+// removing or renaming an entry updates both, so one stat() of the
+// directory stands in for one per candidate path. That is a win where a
+// lookup is expensive and directory attributes are cached, as on NFS.
+//
+// File systems take timestamps from a coarse clock, so a directory changed
+// again within the same tick would go unnoticed. Entries of a directory
+// whose mtime is less than kRacyIntervalSeconds old are therefore not kept
+// until it has settled.
+//
+// The cache is per process and shared by all threads.
+class ModuleStatCache {
+ public:
+  // Entries kept at most; the cache starts over when it is full.
+  static constexpr size_t kMaxEntries = 64 * 1024;
+  static constexpr int64_t kRacyIntervalSeconds = 2;
+
+  // Returns 0 for a file, 1 for a directory and a negative libuv error code
+  // otherwise, like internalModuleStat(). Only uses `loop` to issue
+  // synchronous requests.
+  int Stat(uv_loop_t* loop, const std::string& path);
+  // Stat() for each of `paths` into `results`. Consecutive paths in the same
+  // directory share one validation of it, so passing all candidates for a
+  // specifier at once costs one directory stat() plus one per miss.
+  void StatBatch(uv_loop_t* loop,
+                 const std::vector<std::string>& paths,
+                 int32_t* results);
+
+  void Clear();
+  size_t size();
+
+  static ModuleStatCache* GetPerProcess();
+
+ private:
+  struct Directory {
+    uv_timespec_t mtime;
+    uv_timespec_t ctime;
+    bool racy;
+    std::unordered_map<std::string, int> entries;
+  };
+
+  // Looks `path` up, revalidating its directory unless `validated_dir`
+  // already names it. Updates `validated_dir` to the directory validated.
+  int Lookup(uv_loop_t* loop,
+             const std::string& path,
+             std::string* validated_dir);
+
+  Mutex mutex_;
+  std::unordered_map<std::string, Directory> directories_;
+  size_t size_ = 0;
+};
+
+// Plain stat() of `path` with internalModuleStat() semantics.
+int InternalModuleStatUncached(uv_loop_t* loop, const char* path);
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_MODULE_STAT_CACHE_H_
@@ -7,7 +7,9 @@
 #include "node_external_reference.h"
 #include "node_internals.h"
 #include "node_process-inl.h"
+#include "node_sea.h"
 #include "node_url.h"
+#include "node_usdt.h"
 #include "node_watchdog.h"
 #include "util-inl.h"
 
@@ -268,6 +270,10 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
 
   CHECK(args[0]->IsString());
   Local<String> url = args[0].As<String>();
+  if (NODE_USDT_ENABLED(module__load)) {
+    Utf8Value url_value(isolate, url);
+    NODE_USDT1(module__load, *url_value);
+  }
 
   Local<Context> context;
   ContextifyContext* contextify_context = nullptr;
@@ -498,6 +504,11 @@ MaybeLocal<Module> ModuleWrap::CompileSourceTextModule(
     // source will take ownership of cached_data.
     cached_data = cache_entry->CopyCache();
   }
+#ifndef DISABLE_SINGLE_EXECUTABLE_APPLICATION
+  if (cached_data == nullptr && !user_cached_data.has_value()) {
+    cached_data = sea::FindModuleCodeCache(realm->env(), url);
+  }
+#endif
 
   ScriptCompiler::Source source(source_text, origin, cached_data);
   ScriptCompiler::CompileOptions options;
@@ -507,12 +518,29 @@ MaybeLocal<Module> ModuleWrap::CompileSourceTextModule(
     options = ScriptCompiler::kConsumeCodeCache;
   }
 
+  // Only the default loader compiles the modules that were prefetched.
+  ModulePrefetcher* prefetcher = user_cached_data.has_value()
+                                     ? nullptr
+                                     : realm->env()->module_prefetcher();
+  std::unique_ptr<ScriptCompiler::StreamedSource> streamed;
+  if (prefetcher != nullptr && cached_data == nullptr) {
+    streamed = prefetcher->TakeStreamedSource(url, source_text);
+  }
+
   Local<Module> module;
-  if (!ScriptCompiler::CompileModule(isolate, &source, options)
-           .ToLocal(&module)) {
+  if (streamed) {
+    if (!ScriptCompiler::CompileModule(
+             isolate->GetCurrentContext(), streamed.get(), source_text, origin)
+             .ToLocal(&module)) {
+      return scope.EscapeMaybe(MaybeLocal<Module>());
+    }
+  } else if (!ScriptCompiler::CompileModule(isolate, &source, options)
+                  .ToLocal(&module)) {
     return scope.EscapeMaybe(MaybeLocal<Module>());
   }
 
+  if (prefetcher != nullptr) prefetcher->OnModuleCompiled(url, module);
+
   if (options == ScriptCompiler::kConsumeCodeCache) {
     *cache_rejected = source.GetCachedData()->rejected;
   }
@@ -32,6 +32,7 @@
 #include "memory_tracker-inl.h"
 #include "node_binding.h"
 #include "node_builtins.h"
+#include "node_continuous_profiler.h"
 #include "node_errors.h"
 #include "node_internals.h"
 #include "node_main_instance.h"
@@ -43,7 +44,11 @@
 #include "node_report.h"
 #include "node_revert.h"
 #include "node_sea.h"
+#include "node_simd_calibration.h"
+#include "node_simd_dispatch.h"
 #include "node_snapshot_builder.h"
+#include "node_startup_phases.h"
+#include "node_usdt.h"
 #include "node_v8_platform-inl.h"
 #include "node_version.h"
 
@@ -243,6 +248,13 @@ void Environment::InitializeDiagnostics() {
   if (options_->trace_promises) {
     isolate_->SetPromiseHook(TracePromises);
   }
+  if (options_->cpu_prof_continuous) {
+    profiler::ContinuousCpuProfiler::Start(this);
+  }
+  if (options_->heap_prof_continuous) {
+    profiler::ContinuousHeapProfiler::Start(this);
+  }
+  usdt::AddGCProbes(this);
 }
 
 static
@@ -344,6 +356,11 @@ MaybeLocal<Value> StartExecution(Environment* env, StartExecutionCallback cb) {
     per_process::dotenv_file.SetEnvironment(env);
   }
 
+  if (!env->options()->prefetch_builtins.empty()) {
+    env->builtin_loader()->PrefetchBuiltins(env->principal_realm(),
+                                            env->options()->prefetch_builtins);
+  }
+
   // TODO(joyeecheung): move these conditions into JS land and let the
   // deserialize main function take precedence. For workers, we need to
   // move the pre-execution part into a different file that can be
@@ -785,6 +802,13 @@ static ExitCode ProcessGlobalArgsInternal(std::vector<std::string>* args,
     v8_args.emplace_back("--js-source-phase-imports");
   }
 
+  // Insert these right after the program name, so that they can still be
+  // negated by V8 flags passed explicitly, e.g. --no-lite-mode.
+  if (per_process::cli_options->memory_profile == "low" && !v8_args.empty()) {
+    v8_args.insert(v8_args.begin() + 1,
+                   {"--optimize-for-size", "--lite-mode"});
+  }
+
 #ifdef __POSIX__
   // Block SIGPROF signals when sleeping in epoll_wait/kevent/etc.  Avoids the
   // performance penalty of frequent EINTR wakeups when the profiler is running.
@@ -835,6 +859,7 @@ static ExitCode InitializeNodeWithArgsInternal(
 
   // Initialize node_start_time to get relative uptime.
   per_process::node_start_time = uv_hrtime();
+  startup_phases::Begin(startup_phases::Phase::kParseOptions);
 
   // Register built-in bindings
   binding::RegisterBuiltinBindings();
@@ -1003,8 +1028,22 @@ static ExitCode InitializeNodeWithArgsInternal(
   if (!per_process::cli_options->title.empty())
     uv_set_process_title(per_process::cli_options->title.c_str());
 
+  // libuv reads these when the threadpool is first used, which is after
+  // this point. Values set by the user are left alone.
+  if (per_process::cli_options->memory_profile == "low") {
+    std::string value;
+    if (!credentials::SafeGetenv("UV_THREADPOOL_SIZE", &value))
+      uv_os_setenv("UV_THREADPOOL_SIZE", "2");
+    if (!credentials::SafeGetenv("UV_THREADPOOL_STACK_SIZE", &value))
+      uv_os_setenv("UV_THREADPOOL_STACK_SIZE", "1048576");
+  }
+
+  startup_phases::End(startup_phases::Phase::kParseOptions);
+  if (per_process::cli_options->trace_startup_phases) startup_phases::Enable();
+
 #if defined(NODE_HAVE_I18N_SUPPORT)
   if (!(flags & ProcessInitializationFlags::kNoICU)) {
+    startup_phases::PhaseScope phase_scope(startup_phases::Phase::kICU);
     // If the parameter isn't given, use the env variable.
     if (per_process::cli_options->icu_data_dir.empty())
       credentials::SafeGetenv("NODE_ICU_DATA",
@@ -1072,7 +1111,12 @@ InitializeOncePerProcessInternal(const std::vector<std::string>& args,
     per_process::enabled_debug_list.Parse(nullptr);
   }
 
-  PlatformInit(flags);
+  {
+    startup_phases::PhaseScope phase_scope(
+        startup_phases::Phase::kPlatformInit);
+    PlatformInit(flags);
+    simd_dispatch::Initialize();
+  }
 
   // This needs to run *before* V8::Initialize().
   {
@@ -1084,6 +1128,23 @@ InitializeOncePerProcessInternal(const std::vector<std::string>& args,
     }
   }
 
+  // The calibration file is not required to exist, so that it can be set in
+  // NODE_OPTIONS before node --simd-calibrate has been run.
+  if (!per_process::cli_options->simd_calibration_file.empty() &&
+      !per_process::cli_options->simd_calibrate) {
+    const std::string& path = per_process::cli_options->simd_calibration_file;
+    std::string contents;
+    std::string error;
+    if (ReadFileSync(&contents, path.c_str()) == 0 &&
+        !simd_calibration::Load(contents, &error)) {
+      fprintf(stderr,
+              "%s: warning: ignoring %s: %s\n",
+              result->args_.at(0).c_str(),
+              path.c_str(),
+              error.c_str());
+    }
+  }
+
   if (!(flags & ProcessInitializationFlags::kNoUseLargePages) &&
       (per_process::cli_options->use_largepages == "on" ||
        per_process::cli_options->use_largepages == "silent")) {
@@ -1123,9 +1184,32 @@ InitializeOncePerProcessInternal(const std::vector<std::string>& args,
       result->early_return_ = true;
       return result;
     }
+
+    if (per_process::cli_options->print_simd_dispatch) {
+      std::string dispatch = simd_dispatch::ToString();
+      fwrite(dispatch.data(), 1, dispatch.size(), stdout);
+      result->exit_code_ = ExitCode::kNoFailure;
+      result->early_return_ = true;
+      return result;
+    }
+
+    if (per_process::cli_options->simd_calibrate) {
+      std::string calibration = simd_calibration::Calibrate();
+      fwrite(calibration.data(), 1, calibration.size(), stdout);
+      const std::string& path = per_process::cli_options->simd_calibration_file;
+      result->exit_code_ = ExitCode::kNoFailure;
+      uv_buf_t buf = uv_buf_init(calibration.data(), calibration.size());
+      if (!path.empty() && WriteFileSync(path.c_str(), buf) != 0) {
+        fprintf(stderr, "Cannot write %s\n", path.c_str());
+        result->exit_code_ = ExitCode::kGenericUserError;
+      }
+      result->early_return_ = true;
+      return result;
+    }
   }
 
   if (!(flags & ProcessInitializationFlags::kNoInitOpenSSL)) {
+    startup_phases::PhaseScope phase_scope(startup_phases::Phase::kOpenSSL);
 #if HAVE_OPENSSL
 #ifndef OPENSSL_IS_BORINGSSL
     auto GetOpenSSLErrorString = []() -> std::string {
@@ -1235,6 +1319,8 @@ InitializeOncePerProcessInternal(const std::vector<std::string>& args,
 
   if (!(flags & ProcessInitializationFlags::kNoInitializeNodeV8Platform)) {
     uv_thread_setname("MainThread");
+    startup_phases::PhaseScope phase_scope(
+        startup_phases::Phase::kV8Platform);
     per_process::v8_platform.Initialize(
         static_cast<int>(per_process::cli_options->v8_thread_pool_size));
     result->platform_ = per_process::v8_platform.Platform();
@@ -1249,6 +1335,8 @@ InitializeOncePerProcessInternal(const std::vector<std::string>& args,
   }
 
   if (!(flags & ProcessInitializationFlags::kNoInitializeV8)) {
+    startup_phases::PhaseScope phase_scope(
+        startup_phases::Phase::kV8Initialize);
     V8::Initialize();
 
     // Disable absl deadlock detection in V8 as it reports false-positive cases.
@@ -1533,6 +1621,10 @@ static ExitCode StartInternal(int argc, char** argv) {
   });
 
   uv_loop_configure(uv_default_loop(), UV_METRICS_IDLE_TIME);
+  // libuv falls back to the thread pool by itself if the kernel does not
+  // support io_uring or UV_USE_IO_URING=0 is set.
+  if (per_process::cli_options->io_uring)
+    uv_loop_configure(uv_default_loop(), UV_LOOP_USE_IO_URING_SQPOLL);
   std::string sea_config = per_process::cli_options->experimental_sea_config;
   if (!sea_config.empty()) {
 #if !defined(DISABLE_SINGLE_EXECUTABLE_APPLICATION)
@@ -1556,8 +1648,12 @@ static ExitCode StartInternal(int argc, char** argv) {
   }
 
   // Without --build-snapshot, we are in snapshot loading mode.
-  if (!LoadSnapshotData(&snapshot_data)) {
-    return ExitCode::kStartupSnapshotFailure;
+  {
+    startup_phases::PhaseScope phase_scope(
+        startup_phases::Phase::kSnapshotLoad);
+    if (!LoadSnapshotData(&snapshot_data)) {
+      return ExitCode::kStartupSnapshotFailure;
+    }
   }
   NodeMainInstance main_instance(snapshot_data,
                                  uv_default_loop(),
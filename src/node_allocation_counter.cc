@@ -0,0 +1,195 @@
+#include "node_allocation_counter.h"
+
+#if defined(NODE_ALLOCATION_COUNTING) && NODE_ALLOCATION_COUNTING
+#include <errno.h>
+#include <execinfo.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+#endif  // NODE_ALLOCATION_COUNTING
+
+namespace node {
+namespace allocation_counter {
+
+#if defined(NODE_ALLOCATION_COUNTING) && NODE_ALLOCATION_COUNTING
+namespace {
+
+// Nothing here may allocate, since it runs inside malloc(). The thread
+// locals are plain data in the executable's own TLS block, so accessing
+// them does not allocate either.
+thread_local int counting_depth = 0;
+thread_local uint64_t thread_count = 0;
+// Set while a site is recorded, since backtrace() can allocate the first
+// time it is called.
+thread_local bool recording = false;
+
+constexpr int kMaxFrames = 16;
+constexpr size_t kSiteCapacity = 1024;
+
+struct SiteSlot {
+  uint64_t hash;
+  uint64_t count;
+  int depth;
+  void* frames[kMaxFrames];
+};
+
+// An open addressing table, so that recording a site does not allocate.
+// Sites that do not fit once it is full are dropped.
+SiteSlot site_slots[kSiteCapacity];
+std::atomic<bool> sites_enabled{false};
+std::atomic_flag sites_lock = ATOMIC_FLAG_INIT;
+
+class SitesLock {
+ public:
+  SitesLock() {
+    while (sites_lock.test_and_set(std::memory_order_acquire)) {
+    }
+  }
+  ~SitesLock() { sites_lock.clear(std::memory_order_release); }
+};
+
+__attribute__((noinline)) void RecordSite() {
+  recording = true;
+  // The first two frames are this function and the malloc() wrapper.
+  void* frames[kMaxFrames + 2];
+  const int captured = backtrace(frames, kMaxFrames + 2);
+  const int depth = std::max(captured - 2, 0);
+  void** site_frames = frames + 2;
+  uint64_t hash = 14695981039346656037ull;
+  for (int i = 0; i < depth; i++) {
+    hash = (hash ^ reinterpret_cast<uintptr_t>(site_frames[i])) *
+           1099511628211ull;
+  }
+
+  {
+    SitesLock lock;
+    for (size_t probe = 0; probe < kSiteCapacity; probe++) {
+      SiteSlot& slot = site_slots[(hash + probe) % kSiteCapacity];
+      if (slot.count == 0) {
+        slot.hash = hash;
+        slot.depth = depth;
+        memcpy(slot.frames, site_frames, depth * sizeof(void*));
+        slot.count = 1;
+        break;
+      }
+      if (slot.hash == hash && slot.depth == depth &&
+          memcmp(slot.frames, site_frames, depth * sizeof(void*)) == 0) {
+        slot.count++;
+        break;
+      }
+    }
+  }
+  recording = false;
+}
+
+inline void Count() {
+  if (counting_depth == 0 || recording) [[likely]] {
+    return;
+  }
+  thread_count++;
+  if (sites_enabled.load(std::memory_order_relaxed)) RecordSite();
+}
+
+}  // namespace
+
+uint64_t Begin() {
+  counting_depth++;
+  return thread_count;
+}
+
+uint64_t End() {
+  counting_depth--;
+  return thread_count;
+}
+
+void SetSitesEnabled(bool enabled) {
+  if (enabled) {
+    // Load the unwinder now rather than from inside malloc().
+    void* frame;
+    backtrace(&frame, 1);
+    SitesLock lock;
+    memset(site_slots, 0, sizeof(site_slots));
+  }
+  sites_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::vector<Site> TopSites(size_t limit) {
+  std::vector<Site> sites;
+  // Copy the slots first, the vector cannot grow under the lock: its
+  // allocations would try to record themselves.
+  std::vector<SiteSlot> slots(kSiteCapacity);
+  {
+    SitesLock lock;
+    memcpy(slots.data(), site_slots, sizeof(site_slots));
+  }
+  for (const SiteSlot& slot : slots) {
+    if (slot.count == 0) continue;
+    sites.push_back({slot.count, {slot.frames, slot.frames + slot.depth}});
+  }
+  std::sort(sites.begin(), sites.end(), [](const Site& a, const Site& b) {
+    return a.count > b.count;
+  });
+  if (sites.size() > limit) sites.resize(limit);
+  return sites;
+}
+#else
+void SetSitesEnabled(bool enabled) {}
+
+std::vector<Site> TopSites(size_t limit) {
+  return {};
+}
+#endif  // NODE_ALLOCATION_COUNTING
+
+}  // namespace allocation_counter
+}  // namespace node
+
+#if defined(NODE_ALLOCATION_COUNTING) && NODE_ALLOCATION_COUNTING
+// These take the place of glibc's, for the whole process, because they are
+// defined in the executable. free() is glibc's own, which is fine as the
+// memory comes from glibc.
+extern "C" {
+void* malloc(size_t size) {
+  node::allocation_counter::Count();
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+  node::allocation_counter::Count();
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+  node::allocation_counter::Count();
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+  node::allocation_counter::Count();
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+  node::allocation_counter::Count();
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) {
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  node::allocation_counter::Count();
+  void* ptr = __libc_memalign(alignment, size);
+  if (ptr == nullptr) return ENOMEM;
+  *result = ptr;
+  return 0;
+}
+}
+#endif  // NODE_ALLOCATION_COUNTING
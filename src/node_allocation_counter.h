@@ -0,0 +1,56 @@
+#ifndef SRC_NODE_ALLOCATION_COUNTER_H_
+#define SRC_NODE_ALLOCATION_COUNTER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Counts the native allocations that a thread makes while counting is on:
+// malloc() and everything built on it, such as operator new and V8's zones.
+// It is built in with ./configure --with-allocation-counting, on Linux with
+// glibc, which replaces malloc() with wrappers that count and then call
+// glibc's own. Otherwise the functions here do nothing and nothing is
+// replaced.
+//
+// AsyncWrap::MakeCallback() counts the allocations of each callback it
+// enters from the event loop while callback accounting is on, which gives
+// the number of allocations per callback of each provider.
+namespace node {
+namespace allocation_counter {
+
+#if defined(NODE_ALLOCATION_COUNTING) && NODE_ALLOCATION_COUNTING
+constexpr bool kAvailable = true;
+
+// Starts counting the allocations of the calling thread, if it is not
+// counting already, and returns how many it has counted so far.
+uint64_t Begin();
+// Ends the matching Begin() and returns how many allocations the thread has
+// counted so far.
+uint64_t End();
+#else
+constexpr bool kAvailable = false;
+
+inline uint64_t Begin() { return 0; }
+inline uint64_t End() { return 0; }
+#endif
+
+// Where counted allocations were made from, with the innermost frame first.
+struct Site {
+  uint64_t count;
+  std::vector<void*> frames;
+};
+
+// Starts or stops recording the native stack of every counted allocation.
+// Enabling it starts again without any sites.
+void SetSitesEnabled(bool enabled);
+// Returns up to limit of the sites with the most allocations, most first.
+std::vector<Site> TopSites(size_t limit);
+
+}  // namespace allocation_counter
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_ALLOCATION_COUNTER_H_
@@ -297,6 +297,12 @@ class ThreadSafeFunction : public node::AsyncResource {
   }
 
   void EmptyQueueAndDelete() {
+    if (call_js_batch_cb != nullptr) {
+      while (!queue.empty()) {
+        PopBatch();
+        call_js_batch_cb(nullptr, nullptr, context, batch.data(), batch.size());
+      }
+    }
     for (; !queue.empty(); queue.pop()) {
       call_js_cb(nullptr, nullptr, context, queue.front());
     }
@@ -348,6 +354,15 @@ class ThreadSafeFunction : public node::AsyncResource {
     return napi_ok;
   }
 
+  napi_status SetBatching(
+      size_t max_batch_size,
+      node_api_threadsafe_function_call_js_batch call_js_batch_cb_) {
+    this->max_batch_size = max_batch_size;
+    call_js_batch_cb = call_js_batch_cb_;
+    batch.reserve(max_batch_size);
+    return napi_ok;
+  }
+
   inline void* Context() { return context; }
 
  protected:
@@ -372,6 +387,16 @@ class ThreadSafeFunction : public node::AsyncResource {
     }
   }
 
+  // Moves up to max_batch_size items from the queue to batch. The mutex must
+  // be held, unless the queue can no longer be pushed to.
+  void PopBatch() {
+    batch.clear();
+    while (!queue.empty() && batch.size() < max_batch_size) {
+      batch.push_back(queue.front());
+      queue.pop();
+    }
+  }
+
   bool DispatchOne() {
     void* data = nullptr;
     bool popped_value = false;
@@ -383,7 +408,16 @@ class ThreadSafeFunction : public node::AsyncResource {
         CloseHandlesAndMaybeDelete();
       } else {
         size_t size = queue.size();
-        if (size > 0) {
+        if (size > 0 && call_js_batch_cb != nullptr) {
+          // Take the whole batch under a single lock, and wake all of the
+          // threads that may be waiting for the room it frees up.
+          PopBatch();
+          popped_value = true;
+          if (size >= max_queue_size && max_queue_size > 0) {
+            cond->Broadcast(lock);
+          }
+          size -= batch.size();
+        } else if (size > 0) {
           data = queue.front();
           queue.pop();
           popped_value = true;
@@ -416,8 +450,15 @@ class ThreadSafeFunction : public node::AsyncResource {
             v8::Local<v8::Function>::New(env->isolate, ref);
         js_callback = v8impl::JsValueFromV8LocalValue(js_cb);
       }
-      env->CallbackIntoModule<false>(
-          [&](napi_env env) { call_js_cb(env, js_callback, context, data); });
+      if (call_js_batch_cb != nullptr) {
+        env->CallbackIntoModule<false>([&](napi_env env) {
+          call_js_batch_cb(
+              env, js_callback, context, batch.data(), batch.size());
+        });
+      } else {
+        env->CallbackIntoModule<false>(
+            [&](napi_env env) { call_js_cb(env, js_callback, context, data); });
+      }
     }
 
     return has_more;
@@ -527,6 +568,9 @@ class ThreadSafeFunction : public node::AsyncResource {
   void* finalize_data;
   napi_finalize finalize_cb;
   napi_threadsafe_function_call_js call_js_cb;
+  node_api_threadsafe_function_call_js_batch call_js_batch_cb = nullptr;
+  size_t max_batch_size = 1;
+  std::vector<void*> batch;
   bool handles_closing;
 };
 
@@ -1140,6 +1184,23 @@ static napi_status ConvertUVErrorCode(int code) {
   }
 }
 
+class Work;
+
+// One of the items of a batch, each of which runs on the threadpool on its
+// own and reports back to the Work that owns it.
+class BatchItem final : public node::ThreadPoolWork {
+ public:
+  BatchItem(node::Environment* env, Work* work, size_t index)
+      : ThreadPoolWork(env, "node_api"), _work(work), _index(index) {}
+
+  inline void DoThreadPoolWork() override;
+  inline void AfterThreadPoolWork(int status) override;
+
+ private:
+  Work* _work;
+  size_t _index;
+};
+
 // Wrapper around uv_work_t which calls user-provided callbacks.
 class Work : public node::AsyncResource, public node::ThreadPoolWork {
  private:
@@ -1172,8 +1233,71 @@ class Work : public node::AsyncResource, public node::ThreadPoolWork {
         env, async_resource, async_resource_name, execute, complete, data);
   }
 
+  static Work* NewBatch(node_napi_env env,
+                        v8::Local<v8::Object> async_resource,
+                        v8::Local<v8::String> async_resource_name,
+                        size_t count,
+                        node_api_async_execute_batch_callback execute,
+                        napi_async_complete_callback complete,
+                        void* data) {
+    Work* work = new Work(
+        env, async_resource, async_resource_name, nullptr, complete, data);
+    work->_execute_batch = execute;
+    work->_items.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      work->_items.push_back(
+          std::make_unique<BatchItem>(env->node_env(), work, i));
+    }
+    return work;
+  }
+
   static void Delete(Work* work) { delete work; }
 
+  void Queue() {
+    if (_items.empty()) {
+      ScheduleWork();
+      return;
+    }
+    _pending = _items.size();
+    _batch_status = 0;
+    for (const auto& item : _items) {
+      item->ScheduleWork();
+    }
+  }
+
+  // A batch is cancelled if any of its items that have not started yet
+  // could be cancelled. The rest run to completion.
+  int Cancel() {
+    if (_items.empty()) {
+      return CancelWork();
+    }
+    int result = UV_EBUSY;
+    for (const auto& item : _items) {
+      if (item->CancelWork() == 0) {
+        result = 0;
+      }
+    }
+    return result;
+  }
+
+  void SetLane(Lane lane) {
+    set_lane(lane);
+    for (const auto& item : _items) {
+      item->set_lane(lane);
+    }
+  }
+
+  void ExecuteBatchItem(size_t index) { _execute_batch(_env, _data, index); }
+
+  void AfterBatchItem(int status) {
+    if (status != 0 && _batch_status == 0) {
+      _batch_status = status;
+    }
+    if (--_pending == 0) {
+      AfterThreadPoolWork(_batch_status);
+    }
+  }
+
   void DoThreadPoolWork() override { _execute(_env, _data); }
 
   void AfterThreadPoolWork(int status) override {
@@ -1198,8 +1322,20 @@ class Work : public node::AsyncResource, public node::ThreadPoolWork {
   void* _data;
   napi_async_execute_callback _execute;
   napi_async_complete_callback _complete;
+  node_api_async_execute_batch_callback _execute_batch = nullptr;
+  std::vector<std::unique_ptr<BatchItem>> _items;
+  size_t _pending = 0;
+  int _batch_status = 0;
 };
 
+void BatchItem::DoThreadPoolWork() {
+  _work->ExecuteBatchItem(_index);
+}
+
+void BatchItem::AfterThreadPoolWork(int status) {
+  _work->AfterBatchItem(status);
+}
+
 }  // end of namespace uvimpl
 }  // end of anonymous namespace
 
@@ -1248,6 +1384,73 @@ napi_create_async_work(napi_env env,
   return napi_clear_last_error(env);
 }
 
+napi_status NAPI_CDECL
+node_api_create_async_work_batch(napi_env env,
+                                 napi_value async_resource,
+                                 napi_value async_resource_name,
+                                 size_t count,
+                                 node_api_async_execute_batch_callback execute,
+                                 napi_async_complete_callback complete,
+                                 void* data,
+                                 napi_async_work* result) {
+  CHECK_ENV_NOT_IN_GC(env);
+  CHECK_ARG(env, execute);
+  CHECK_ARG(env, result);
+  RETURN_STATUS_IF_FALSE(env, count > 0, napi_invalid_arg);
+
+  v8::Local<v8::Context> context = env->context();
+
+  v8::Local<v8::Object> resource;
+  if (async_resource != nullptr) {
+    CHECK_TO_OBJECT(env, context, resource, async_resource);
+  } else {
+    resource = v8::Object::New(env->isolate);
+  }
+
+  v8::Local<v8::String> resource_name;
+  CHECK_TO_STRING(env, context, resource_name, async_resource_name);
+
+  uvimpl::Work* work =
+      uvimpl::Work::NewBatch(reinterpret_cast<node_napi_env>(env),
+                             resource,
+                             resource_name,
+                             count,
+                             execute,
+                             complete,
+                             data);
+
+  *result = reinterpret_cast<napi_async_work>(work);
+
+  return napi_clear_last_error(env);
+}
+
+napi_status NAPI_CDECL
+node_api_set_async_work_lane(node_api_basic_env basic_env,
+                             napi_async_work work,
+                             node_api_async_work_lane lane) {
+  napi_env env = const_cast<napi_env>(basic_env);
+  CHECK_ENV(env);
+  CHECK_ARG(env, work);
+
+  node::ThreadPoolWork::Lane work_lane;
+  switch (lane) {
+    case node_api_async_work_cpu:
+      work_lane = node::ThreadPoolWork::Lane::kCpu;
+      break;
+    case node_api_async_work_io:
+      work_lane = node::ThreadPoolWork::Lane::kIo;
+      break;
+    case node_api_async_work_slow_io:
+      work_lane = node::ThreadPoolWork::Lane::kSlowIo;
+      break;
+    default:
+      return napi_set_last_error(env, napi_invalid_arg);
+  }
+  reinterpret_cast<uvimpl::Work*>(work)->SetLane(work_lane);
+
+  return napi_clear_last_error(env);
+}
+
 napi_status NAPI_CDECL napi_delete_async_work(napi_env env,
                                               napi_async_work work) {
   CHECK_ENV_NOT_IN_GC(env);
@@ -1277,7 +1480,7 @@ napi_status NAPI_CDECL napi_queue_async_work(node_api_basic_env env,
 
   uvimpl::Work* w = reinterpret_cast<uvimpl::Work*>(work);
 
-  w->ScheduleWork();
+  w->Queue();
 
   return napi_clear_last_error(env);
 }
@@ -1289,7 +1492,7 @@ napi_status NAPI_CDECL napi_cancel_async_work(node_api_basic_env env,
 
   uvimpl::Work* w = reinterpret_cast<uvimpl::Work*>(work);
 
-  CALL_UV(env, w->CancelWork());
+  CALL_UV(env, w->Cancel());
 
   return napi_clear_last_error(env);
 }
@@ -1399,6 +1602,25 @@ napi_status NAPI_CDECL napi_ref_threadsafe_function(
   return reinterpret_cast<v8impl::ThreadSafeFunction*>(func)->Ref();
 }
 
+napi_status NAPI_CDECL node_api_set_threadsafe_function_batching(
+    napi_env env,
+    napi_threadsafe_function func,
+    size_t max_batch_size,
+    node_api_threadsafe_function_call_js_batch call_js_batch_cb) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, func);
+  CHECK_ARG(env, call_js_batch_cb);
+  RETURN_STATUS_IF_FALSE(env, max_batch_size > 0, napi_invalid_arg);
+
+  napi_status status =
+      reinterpret_cast<v8impl::ThreadSafeFunction*>(func)->SetBatching(
+          max_batch_size, call_js_batch_cb);
+  if (status != napi_ok) {
+    return napi_set_last_error(env, status);
+  }
+  return napi_clear_last_error(env);
+}
+
 napi_status NAPI_CDECL node_api_get_module_file_name(
     node_api_basic_env basic_env, const char** result) {
   napi_env env = const_cast<napi_env>(basic_env);
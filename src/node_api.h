@@ -168,6 +168,27 @@ NAPI_EXTERN napi_status NAPI_CDECL napi_queue_async_work(node_api_basic_env env,
 NAPI_EXTERN napi_status NAPI_CDECL
 napi_cancel_async_work(node_api_basic_env env, napi_async_work work);
 
+#ifdef NAPI_EXPERIMENTAL
+#define NODE_API_EXPERIMENTAL_HAS_ASYNC_WORK_BATCH
+// Creates async work that runs execute once for each index below count, in
+// parallel on the threadpool, and then calls complete once. The status
+// passed to complete is that of the first item that failed, if any.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_create_async_work_batch(napi_env env,
+                                 napi_value async_resource,
+                                 napi_value async_resource_name,
+                                 size_t count,
+                                 node_api_async_execute_batch_callback execute,
+                                 napi_async_complete_callback complete,
+                                 void* data,
+                                 napi_async_work* result);
+// Must not be called while the work is queued.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_set_async_work_lane(node_api_basic_env env,
+                             napi_async_work work,
+                             node_api_async_work_lane lane);
+#endif  // NAPI_EXPERIMENTAL
+
 // version management
 NAPI_EXTERN napi_status NAPI_CDECL napi_get_node_version(
     node_api_basic_env env, const napi_node_version** version);
@@ -238,6 +259,18 @@ NAPI_EXTERN napi_status NAPI_CDECL napi_unref_threadsafe_function(
 NAPI_EXTERN napi_status NAPI_CDECL napi_ref_threadsafe_function(
     node_api_basic_env env, napi_threadsafe_function func);
 
+#ifdef NAPI_EXPERIMENTAL
+#define NODE_API_EXPERIMENTAL_HAS_THREADSAFE_FUNCTION_BATCHING
+// Makes the loop thread hand up to max_batch_size queued items at a time
+// to call_js_batch_cb, instead of calling call_js_cb once per item. Must be
+// called on the loop thread.
+NAPI_EXTERN napi_status NAPI_CDECL node_api_set_threadsafe_function_batching(
+    napi_env env,
+    napi_threadsafe_function func,
+    size_t max_batch_size,
+    node_api_threadsafe_function_call_js_batch call_js_batch_cb);
+#endif  // NAPI_EXPERIMENTAL
+
 #endif  // NAPI_VERSION >= 4
 
 #if NAPI_VERSION >= 8
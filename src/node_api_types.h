@@ -32,12 +32,32 @@ typedef enum {
 #endif  // NAPI_VERSION >= 4
 
 typedef void(NAPI_CDECL* napi_async_execute_callback)(napi_env env, void* data);
+#ifdef NAPI_EXPERIMENTAL
+typedef void(NAPI_CDECL* node_api_async_execute_batch_callback)(napi_env env,
+                                                               void* data,
+                                                               size_t index);
+
+// Tells the threadpool what an async work item mostly waits on.
+typedef enum {
+  node_api_async_work_cpu,
+  node_api_async_work_io,
+  node_api_async_work_slow_io
+} node_api_async_work_lane;
+#endif  // NAPI_EXPERIMENTAL
 typedef void(NAPI_CDECL* napi_async_complete_callback)(napi_env env,
                                                        napi_status status,
                                                        void* data);
 #if NAPI_VERSION >= 4
 typedef void(NAPI_CDECL* napi_threadsafe_function_call_js)(
     napi_env env, napi_value js_callback, void* context, void* data);
+#ifdef NAPI_EXPERIMENTAL
+typedef void(NAPI_CDECL* node_api_threadsafe_function_call_js_batch)(
+    napi_env env,
+    napi_value js_callback,
+    void* context,
+    void** data,
+    size_t count);
+#endif  // NAPI_EXPERIMENTAL
 #endif  // NAPI_VERSION >= 4
 
 typedef struct {
@@ -8,12 +8,15 @@
 #include "node_errors.h"
 #include "node_external_reference.h"
 #include "node_file.h"
+#include "node_multipart.h"
+#include "node_options.h"
 #include "path.h"
 #include "permission/permission.h"
 #include "util.h"
 #include "v8.h"
 
 #include <algorithm>
+#include <atomic>
 
 namespace node {
 
@@ -31,7 +34,9 @@ using v8::HandleScope;
 using v8::Int32;
 using v8::Isolate;
 using v8::Local;
+using v8::LocalVector;
 using v8::NewStringType;
+using v8::Number;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::SnapshotCreator;
@@ -95,6 +100,182 @@ void Concat(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(ArrayBuffer::New(isolate, std::move(store)));
 }
 
+// Bytes of ArrayBuffer data that Blobs keep in memory across the process,
+// while spilling is enabled.
+std::atomic<uint64_t> in_memory_blob_bytes{0};
+
+// Counts the bytes of one in-memory Blob part for as long as the entry
+// holding it, or any slice of it, is alive.
+class BlobMemoryCharge final {
+ public:
+  explicit BlobMemoryCharge(uint64_t bytes) : bytes_(bytes) {
+    in_memory_blob_bytes += bytes_;
+  }
+  ~BlobMemoryCharge() { in_memory_blob_bytes -= bytes_; }
+
+  BlobMemoryCharge(const BlobMemoryCharge&) = delete;
+  BlobMemoryCharge& operator=(const BlobMemoryCharge&) = delete;
+
+ private:
+  uint64_t bytes_;
+};
+
+struct BlobSpillOptions {
+  uint64_t threshold;
+  uint64_t budget;
+};
+
+const BlobSpillOptions& GetBlobSpillOptions() {
+  static const BlobSpillOptions options = []() {
+    Mutex::ScopedLock lock(per_process::cli_options_mutex);
+    return BlobSpillOptions{per_process::cli_options->blob_spill_threshold,
+                            per_process::cli_options->blob_memory_budget};
+  }();
+  return options;
+}
+
+// Creates the entry for length bytes at data, which an ArrayBuffer passed
+// to the Blob constructor holds. Once in-memory Blob data would exceed
+// --blob-memory-budget, parts of at least --blob-spill-threshold bytes are
+// written to a temporary file instead, so that concurrent large uploads do
+// not grow RSS without bound. The write is synchronous, but it only copies
+// into the page cache. Returns nullptr if the part should stay in memory.
+std::unique_ptr<DataQueue::Entry> MaybeSpillBlobPart(const uint8_t* data,
+                                                     size_t length) {
+  const BlobSpillOptions& options = GetBlobSpillOptions();
+  if (options.threshold == 0 || length < options.threshold ||
+      in_memory_blob_bytes + length <= options.budget) {
+    return nullptr;
+  }
+  return DataQueue::CreateTempFileEntry(data, length);
+}
+
+std::shared_ptr<void> ChargeBlobPart(size_t length) {
+  if (GetBlobSpillOptions().threshold == 0) return nullptr;
+  return std::make_shared<BlobMemoryCharge>(length);
+}
+
+// Parses the contents of a Blob as a multipart body while reading it, and
+// reports every part as its header block and a slice of the Blob over its
+// body, so that the part bodies are never copied. Calls back with a status
+// (0, UV_EINVAL if the body is malformed or incomplete, or the error that
+// reading failed with), the header blocks and the body slices. The
+// callback is called synchronously if the data is in memory.
+class MultipartBlobParser final
+    : public std::enable_shared_from_this<MultipartBlobParser> {
+ public:
+  static void Start(BaseObjectPtr<Blob> blob,
+                    std::shared_ptr<DataQueue::Reader> reader,
+                    std::string_view boundary,
+                    Local<Function> callback) {
+    auto parser = std::make_shared<MultipartBlobParser>(
+        std::move(blob), std::move(reader), boundary, callback);
+    parser->Pull();
+  }
+
+  MultipartBlobParser(BaseObjectPtr<Blob> blob,
+                      std::shared_ptr<DataQueue::Reader> reader,
+                      std::string_view boundary,
+                      Local<Function> callback)
+      : blob_(std::move(blob)),
+        reader_(std::move(reader)),
+        parser_(boundary),
+        callback_(blob_->env()->isolate(), callback) {}
+
+ private:
+  void Pull() {
+    // As in DataQueueWriter, in-memory data is handled by this loop rather
+    // than recursively.
+    if (pulling_) {
+      pull_again_ = true;
+      return;
+    }
+    std::shared_ptr<MultipartBlobParser> self = shared_from_this();
+    pulling_ = true;
+    do {
+      pull_again_ = false;
+      reader_->Pull(
+          [self](int status,
+                 const DataQueue::Vec* vecs,
+                 size_t count,
+                 bob::Done done) {
+            self->OnData(status, vecs, count, std::move(done));
+          },
+          bob::OPTIONS_NONE,
+          nullptr,
+          0,
+          bob::kMaxCountHint);
+    } while (pull_again_ && !finished_);
+    pulling_ = false;
+  }
+
+  void OnData(int status,
+              const DataQueue::Vec* vecs,
+              size_t count,
+              bob::Done done) {
+    for (size_t n = 0; n < count && !finished_; n++) {
+      if (!parser_.Write(vecs[n].base, vecs[n].len)) Finish(UV_EINVAL);
+    }
+    if (done) std::move(done)(0);
+    if (finished_) return;
+    if (status < 0) return Finish(status);
+    switch (status) {
+      case bob::STATUS_EOS:
+        return Finish(parser_.Finish() ? 0 : UV_EINVAL);
+      case bob::STATUS_CONTINUE:
+        return Pull();
+      default:
+        // Blobs are idempotent, so they never block. STATUS_WAIT means the
+        // reader calls back once there is data.
+        return;
+    }
+  }
+
+  void Finish(int status) {
+    finished_ = true;
+    Environment* env = blob_->env();
+    Isolate* isolate = env->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env->context());
+
+    const auto& parts = parser_.parts();
+    LocalVector<Value> headers(isolate);
+    LocalVector<Value> bodies(isolate);
+    if (status == 0) {
+      headers.reserve(parts.size());
+      bodies.reserve(parts.size());
+      for (const auto& part : parts) {
+        BaseObjectPtr<Blob> body =
+            blob_->Slice(env, part.body_start, part.body_end);
+        if (!body) return;
+        headers.push_back(
+            OneByteString(isolate, part.headers.data(), part.headers.size()));
+        bodies.push_back(body->object());
+      }
+    }
+
+    Local<Value> argv[] = {
+        Int32::New(isolate, status),
+        Array::New(isolate, headers.data(), headers.size()),
+        Array::New(isolate, bodies.data(), bodies.size()),
+    };
+    USE(MakeCallback(isolate,
+                     blob_->object(),
+                     callback_.Get(isolate),
+                     arraysize(argv),
+                     argv,
+                     {0, 0}));
+  }
+
+  BaseObjectPtr<Blob> blob_;
+  std::shared_ptr<DataQueue::Reader> reader_;
+  multipart::MultipartParser parser_;
+  Global<Function> callback_;
+  bool pulling_ = false;
+  bool pull_again_ = false;
+  bool finished_ = false;
+};
+
 void BlobFromFilePath(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   BufferValue path(env->isolate(), args[0]);
@@ -102,7 +283,12 @@ void BlobFromFilePath(const FunctionCallbackInfo<Value>& args) {
   ToNamespacedPath(env, &path);
   THROW_IF_INSUFFICIENT_PERMISSIONS(
       env, permission::PermissionScope::kFileSystemRead, path.ToStringView());
-  auto entry = DataQueue::CreateFdEntry(env, args[0]);
+  // When asked to, map regular files into memory so that slices of the
+  // Blob and reads from it do not copy. Anything that cannot be mapped is
+  // read through the thread pool as usual.
+  std::unique_ptr<DataQueue::Entry> entry;
+  if (args[1]->IsTrue()) entry = DataQueue::CreateMappedFileEntry(*path);
+  if (entry == nullptr) entry = DataQueue::CreateFdEntry(env, args[0]);
   if (entry == nullptr) {
     return THROW_ERR_INVALID_ARG_VALUE(env, "Unable to open file as blob");
   }
@@ -132,6 +318,7 @@ void Blob::CreatePerIsolateProperties(IsolateData* isolate_data,
   SetMethod(isolate, target, "revokeObjectURL", RevokeObjectURL);
   SetMethod(isolate, target, "concat", Concat);
   SetMethod(isolate, target, "createBlobFromFilePath", BlobFromFilePath);
+  SetMethod(isolate, target, "createBufferList", BufferList::New);
 }
 
 void Blob::CreatePerContextProperties(Local<Object> target,
@@ -153,6 +340,8 @@ Local<FunctionTemplate> Blob::GetConstructorTemplate(Environment* env) {
         FIXED_ONE_BYTE_STRING(env->isolate(), "Blob"));
     SetProtoMethod(isolate, tmpl, "getReader", GetReader);
     SetProtoMethod(isolate, tmpl, "slice", ToSlice);
+    SetProtoMethod(isolate, tmpl, "toArrayBuffer", ToArrayBuffer);
+    SetProtoMethod(isolate, tmpl, "parseMultipart", ParseMultipart);
     env->set_blob_constructor_template(tmpl);
   }
   return tmpl;
@@ -200,22 +389,32 @@ void Blob::New(const FunctionCallbackInfo<Value>& args) {
                   size_t byte_length,
                   size_t byte_offset =
                       0) mutable -> std::unique_ptr<DataQueue::Entry> {
+      uint8_t* ptr = static_cast<uint8_t*>(buf->Data()) + byte_offset;
+      if (auto spilled = MaybeSpillBlobPart(ptr, byte_length)) {
+        // The Blob no longer needs the memory, but the ArrayBuffer is still
+        // detached as it would otherwise have been.
+        if (buf->IsDetachable() && buf->Detach(Local<Value>()).IsNothing()) {
+          return nullptr;
+        }
+        return spilled;
+      }
+
       if (buf->IsDetachable()) {
         std::shared_ptr<BackingStore> store = buf->GetBackingStore();
         if (buf->Detach(Local<Value>()).IsNothing()) {
           return nullptr;
         }
         return DataQueue::CreateInMemoryEntryFromBackingStore(
-            std::move(store), byte_offset, byte_length);
+            std::move(store), byte_offset, byte_length,
+            ChargeBlobPart(byte_length));
       }
 
       // If the ArrayBuffer is not detachable, we will copy from it instead.
       std::shared_ptr<BackingStore> store = ArrayBuffer::NewBackingStore(
           isolate, byte_length, BackingStoreInitializationMode::kUninitialized);
-      uint8_t* ptr = static_cast<uint8_t*>(buf->Data()) + byte_offset;
       std::copy(ptr, ptr + byte_length, static_cast<uint8_t*>(store->Data()));
       return DataQueue::CreateInMemoryEntryFromBackingStore(
-          std::move(store), 0, byte_length);
+          std::move(store), 0, byte_length, ChargeBlobPart(byte_length));
     };
 
     // Every entry should be either an ArrayBuffer, ArrayBufferView, or Blob.
@@ -275,6 +474,39 @@ void Blob::ToSlice(const FunctionCallbackInfo<Value>& args) {
     args.GetReturnValue().Set(slice->object());
 }
 
+void Blob::ToArrayBuffer(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Blob* blob;
+  ASSIGN_OR_RETURN_UNWRAP(&blob, args.This());
+  // Returns undefined unless the data can be exposed without a copy, in
+  // which case the caller reads it instead.
+  std::unique_ptr<BackingStore> store = blob->data_queue_->ToBackingStore();
+  if (store)
+    args.GetReturnValue().Set(
+        ArrayBuffer::New(env->isolate(), std::move(store)));
+}
+
+void Blob::ParseMultipart(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Blob* blob;
+  ASSIGN_OR_RETURN_UNWRAP(&blob, args.This());
+  CHECK(args[0]->IsString());   // boundary
+  CHECK(args[1]->IsFunction());  // callback
+
+  Utf8Value boundary(env->isolate(), args[0]);
+  if (!multipart::MultipartParser::IsValidBoundary(boundary.ToStringView())) {
+    return THROW_ERR_INVALID_ARG_VALUE(env, "Invalid multipart boundary");
+  }
+  std::shared_ptr<DataQueue::Reader> reader = blob->data_queue_->get_reader();
+  if (!reader) {
+    return THROW_ERR_INVALID_STATE(env, "Unable to read the Blob");
+  }
+  MultipartBlobParser::Start(BaseObjectPtr<Blob>(blob),
+                             std::move(reader),
+                             boundary.ToStringView(),
+                             args[1].As<Function>());
+}
+
 void Blob::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("data_queue_", data_queue_, "std::shared_ptr<DataQueue>");
 }
@@ -423,6 +655,267 @@ std::unique_ptr<worker::TransferData> Blob::CloneForMessaging() const {
   return std::make_unique<BlobTransferData>(data_queue_);
 }
 
+Local<FunctionTemplate> BufferList::GetConstructorTemplate(Environment* env) {
+  Local<FunctionTemplate> tmpl = env->buffer_list_constructor_template();
+  if (tmpl.IsEmpty()) {
+    Isolate* isolate = env->isolate();
+    tmpl = NewFunctionTemplate(isolate, nullptr);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(
+        BaseObject::kInternalFieldCount);
+    tmpl->SetClassName(FIXED_ONE_BYTE_STRING(isolate, "BufferList"));
+    SetProtoMethod(isolate, tmpl, "append", Append);
+    SetProtoMethodNoSideEffect(isolate, tmpl, "byteLength", GetByteLength);
+    SetProtoMethodNoSideEffect(isolate, tmpl, "slice", Slice);
+    SetProtoMethodNoSideEffect(isolate, tmpl, "indexOf", IndexOf);
+    SetProtoMethod(isolate, tmpl, "toBuffer", ToBuffer);
+    SetProtoMethodNoSideEffect(isolate, tmpl, "toBlob", ToBlob);
+    env->set_buffer_list_constructor_template(tmpl);
+  }
+  return tmpl;
+}
+
+bool BufferList::HasInstance(Environment* env, Local<Value> object) {
+  return GetConstructorTemplate(env)->HasInstance(object);
+}
+
+BaseObjectPtr<BufferList> BufferList::Create(Environment* env,
+                                             std::vector<Chunk> chunks) {
+  HandleScope scope(env->isolate());
+
+  Local<Function> ctor;
+  if (!GetConstructorTemplate(env)->GetFunction(env->context()).ToLocal(&ctor))
+    return nullptr;
+
+  Local<Object> obj;
+  if (!ctor->NewInstance(env->context()).ToLocal(&obj)) return nullptr;
+
+  return MakeBaseObject<BufferList>(env, obj, std::move(chunks));
+}
+
+BufferList::BufferList(Environment* env,
+                       Local<Object> obj,
+                       std::vector<Chunk> chunks)
+    : BaseObject(env, obj) {
+  MakeWeak();
+  chunks_.reserve(chunks.size());
+  for (Chunk& chunk : chunks) AddChunk(std::move(chunk));
+}
+
+void BufferList::MemoryInfo(MemoryTracker* tracker) const {
+  // The backing stores are shared with the Buffers the chunks came from.
+  tracker->TrackFieldWithSize("chunks", chunks_.size() * sizeof(Chunk));
+  if (flattened_) tracker->TrackFieldWithSize("flattened", length_);
+}
+
+void BufferList::AddChunk(Chunk chunk) {
+  if (chunk.length == 0) return;
+  length_ += chunk.length;
+  chunks_.push_back(std::move(chunk));
+  flattened_.reset();
+}
+
+void BufferList::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  BaseObjectPtr<BufferList> list = Create(env);
+  if (list) args.GetReturnValue().Set(list->object());
+}
+
+// list.append(bufferOrList) adds the contents of a Buffer, or of another
+// BufferList, without copying them.
+void BufferList::Append(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  BufferList* list;
+  ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
+
+  if (HasInstance(env, args[0])) {
+    BufferList* other;
+    ASSIGN_OR_RETURN_UNWRAP(&other, args[0]);
+    // Copied first, other may be list itself.
+    std::vector<Chunk> chunks = other->chunks_;
+    for (Chunk& chunk : chunks) list->AddChunk(std::move(chunk));
+    return;
+  }
+
+  CHECK(args[0]->IsArrayBufferView());
+  Local<ArrayBufferView> view = args[0].As<ArrayBufferView>();
+  size_t length = view->ByteLength();
+  if (length == 0) return;
+  Local<ArrayBuffer> buffer = view->Buffer();
+  if (!buffer->IsResizableByUserJavaScript()) {
+    list->AddChunk({buffer->GetBackingStore(), view->ByteOffset(), length});
+    return;
+  }
+
+  // A resizable buffer could shrink under the chunk, so it is copied.
+  std::shared_ptr<BackingStore> store = ArrayBuffer::NewBackingStore(
+      env->isolate(), length, BackingStoreInitializationMode::kUninitialized);
+  view->CopyContents(store->Data(), length);
+  list->AddChunk({std::move(store), 0, length});
+}
+
+void BufferList::GetByteLength(const FunctionCallbackInfo<Value>& args) {
+  BufferList* list;
+  ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
+  args.GetReturnValue().Set(static_cast<double>(list->length_));
+}
+
+std::vector<BufferList::Chunk> BufferList::SliceChunks(size_t start,
+                                                       size_t end) const {
+  std::vector<Chunk> chunks;
+  size_t position = 0;
+  for (const Chunk& chunk : chunks_) {
+    if (position >= end) break;
+    const size_t chunk_end = position + chunk.length;
+    if (chunk_end > start) {
+      const size_t from = std::max(start, position) - position;
+      const size_t to = std::min(end, chunk_end) - position;
+      chunks.push_back({chunk.store, chunk.offset + from, to - from});
+    }
+    position = chunk_end;
+  }
+  return chunks;
+}
+
+// list.slice(start, end) returns a BufferList over the same chunks.
+void BufferList::Slice(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  BufferList* list;
+  ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
+  CHECK(args[0]->IsNumber());
+  CHECK(args[1]->IsNumber());
+  const double length = static_cast<double>(list->length_);
+  const size_t start = static_cast<size_t>(
+      std::clamp(args[0].As<Number>()->Value(), 0.0, length));
+  const size_t end = static_cast<size_t>(
+      std::clamp(args[1].As<Number>()->Value(), 0.0, length));
+
+  BaseObjectPtr<BufferList> slice =
+      Create(env, start < end ? list->SliceChunks(start, end)
+                              : std::vector<Chunk>());
+  if (slice) args.GetReturnValue().Set(slice->object());
+}
+
+bool BufferList::Matches(size_t index,
+                         size_t offset,
+                         const uint8_t* needle,
+                         size_t needle_length) const {
+  while (needle_length > 0) {
+    if (index == chunks_.size()) return false;
+    const Chunk& chunk = chunks_[index];
+    const size_t n = std::min(needle_length, chunk.length - offset);
+    if (memcmp(chunk.data() + offset, needle, n) != 0) return false;
+    needle += n;
+    needle_length -= n;
+    index++;
+    offset = 0;
+  }
+  return true;
+}
+
+int64_t BufferList::Find(const uint8_t* needle,
+                         size_t needle_length,
+                         size_t start) const {
+  if (needle_length == 0) return start <= length_ ? start : length_;
+  if (needle_length > length_ || start > length_ - needle_length) return -1;
+
+  size_t position = 0;
+  for (size_t i = 0; i < chunks_.size(); i++) {
+    const Chunk& chunk = chunks_[i];
+    if (position + chunk.length <= start) {
+      position += chunk.length;
+      continue;
+    }
+    const char* data = chunk.data();
+    size_t offset = start > position ? start - position : 0;
+    // Candidates are found with memchr() within the chunk, and checked
+    // across the chunks that follow if the needle does not fit in it.
+    while (offset < chunk.length) {
+      if (position + offset > length_ - needle_length) return -1;
+      const void* found =
+          memchr(data + offset, needle[0], chunk.length - offset);
+      if (found == nullptr) break;
+      offset = static_cast<const char*>(found) - data;
+      if (Matches(i, offset, needle, needle_length)) {
+        return position + offset;
+      }
+      offset++;
+    }
+    position += chunk.length;
+  }
+  return -1;
+}
+
+// list.indexOf(buffer, byteOffset) returns the offset of the first
+// occurrence of buffer at or after byteOffset, or -1.
+void BufferList::IndexOf(const FunctionCallbackInfo<Value>& args) {
+  BufferList* list;
+  ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
+  CHECK(args[0]->IsArrayBufferView());
+  CHECK(args[1]->IsNumber());
+  ArrayBufferViewContents<uint8_t> needle(args[0]);
+  const size_t start = static_cast<size_t>(std::clamp(
+      args[1].As<Number>()->Value(), 0.0, static_cast<double>(list->length_)));
+  args.GetReturnValue().Set(static_cast<double>(
+      list->Find(needle.data(), needle.length(), start)));
+}
+
+// list.toBuffer() returns the contents as one Buffer. It is a view of the
+// only chunk if there is just one, and copied into one piece otherwise, which
+// is kept until the list is appended to.
+void BufferList::ToBuffer(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  BufferList* list;
+  ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
+
+  std::shared_ptr<BackingStore> store;
+  size_t offset = 0;
+  if (list->chunks_.size() == 1) {
+    store = list->chunks_[0].store;
+    offset = list->chunks_[0].offset;
+  } else {
+    if (!list->flattened_) {
+      std::shared_ptr<BackingStore> flattened = ArrayBuffer::NewBackingStore(
+          isolate,
+          list->length_,
+          BackingStoreInitializationMode::kUninitialized);
+      char* out = static_cast<char*>(flattened->Data());
+      for (const Chunk& chunk : list->chunks_) {
+        memcpy(out, chunk.data(), chunk.length);
+        out += chunk.length;
+      }
+      list->flattened_ = std::move(flattened);
+    }
+    store = list->flattened_;
+  }
+
+  Local<Object> buffer;
+  if (Buffer::New(env,
+                  ArrayBuffer::New(isolate, std::move(store)),
+                  offset,
+                  list->length_)
+          .ToLocal(&buffer)) {
+    args.GetReturnValue().Set(buffer);
+  }
+}
+
+// list.toBlob() returns a Blob handle over the same chunks.
+void BufferList::ToBlob(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  BufferList* list;
+  ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
+
+  std::vector<std::unique_ptr<DataQueue::Entry>> entries;
+  entries.reserve(list->chunks_.size());
+  for (const Chunk& chunk : list->chunks_) {
+    entries.push_back(DataQueue::CreateInMemoryEntryFromBackingStore(
+        chunk.store, chunk.offset, chunk.length));
+  }
+  BaseObjectPtr<Blob> blob =
+      Blob::Create(env, DataQueue::CreateIdempotent(std::move(entries)));
+  if (blob) args.GetReturnValue().Set(blob->object());
+}
+
 void Blob::StoreDataObject(const FunctionCallbackInfo<Value>& args) {
   Realm* realm = Realm::GetCurrent(args);
 
@@ -579,12 +1072,21 @@ void Blob::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(Blob::New);
   registry->Register(Blob::GetReader);
   registry->Register(Blob::ToSlice);
+  registry->Register(Blob::ToArrayBuffer);
+  registry->Register(Blob::ParseMultipart);
   registry->Register(Blob::StoreDataObject);
   registry->Register(Blob::GetDataObject);
   registry->Register(Blob::RevokeObjectURL);
   registry->Register(Blob::Reader::Pull);
   registry->Register(Concat);
   registry->Register(BlobFromFilePath);
+  registry->Register(BufferList::New);
+  registry->Register(BufferList::Append);
+  registry->Register(BufferList::GetByteLength);
+  registry->Register(BufferList::Slice);
+  registry->Register(BufferList::IndexOf);
+  registry->Register(BufferList::ToBuffer);
+  registry->Register(BufferList::ToBlob);
 }
 
 }  // namespace node
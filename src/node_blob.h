@@ -36,6 +36,8 @@ class Blob : public BaseObject {
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetReader(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void ToSlice(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void ToArrayBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void ParseMultipart(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void StoreDataObject(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetDataObject(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RevokeObjectURL(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -110,6 +112,65 @@ class Blob : public BaseObject {
   std::shared_ptr<DataQueue> data_queue_;
 };
 
+// A rope of in-memory chunks, for accumulating a body without copying it
+// into one contiguous Buffer until, if ever, that is needed. Like the
+// in-memory entries of a DataQueue, the chunks share the backing stores of
+// the Buffers they were appended from. Chunks are only ever added, so a
+// list passed to StreamBase::Writev() stays valid while it is referenced.
+class BufferList : public BaseObject {
+ public:
+  struct Chunk {
+    std::shared_ptr<v8::BackingStore> store;
+    size_t offset;
+    size_t length;
+
+    char* data() const { return static_cast<char*>(store->Data()) + offset; }
+  };
+
+  static v8::Local<v8::FunctionTemplate> GetConstructorTemplate(
+      Environment* env);
+  static bool HasInstance(Environment* env, v8::Local<v8::Value> object);
+  static BaseObjectPtr<BufferList> Create(Environment* env,
+                                          std::vector<Chunk> chunks = {});
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Append(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetByteLength(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Slice(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void IndexOf(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void ToBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void ToBlob(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  BufferList(Environment* env,
+             v8::Local<v8::Object> obj,
+             std::vector<Chunk> chunks);
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(BufferList)
+  SET_SELF_SIZE(BufferList)
+
+  const std::vector<Chunk>& chunks() const { return chunks_; }
+  size_t length() const { return length_; }
+
+  std::vector<Chunk> SliceChunks(size_t start, size_t end) const;
+  // Returns the offset of the first occurrence of needle at or after start,
+  // or -1.
+  int64_t Find(const uint8_t* needle, size_t needle_length, size_t start) const;
+
+ private:
+  void AddChunk(Chunk chunk);
+  bool Matches(size_t index,
+               size_t offset,
+               const uint8_t* needle,
+               size_t needle_length) const;
+
+  std::vector<Chunk> chunks_;
+  size_t length_ = 0;
+  // The contents in one piece, once toBuffer() has needed them that way.
+  // Cleared by appending.
+  std::shared_ptr<v8::BackingStore> flattened_;
+};
+
 class BlobBindingData : public SnapshotableObject {
  public:
   explicit BlobBindingData(Realm* realm, v8::Local<v8::Object> wrap);
@@ -27,6 +27,7 @@
 #include "node_external_reference.h"
 #include "node_i18n.h"
 #include "node_internals.h"
+#include "node_json.h"
 
 #include "env-inl.h"
 #include "simdutf.h"
@@ -557,8 +558,20 @@ void StringSlice(const FunctionCallbackInfo<Value>& args) {
   size_t length = end - start;
 
   Local<Value> ret;
-  if (StringBytes::Encode(isolate, buffer.data() + start, length, encoding)
-          .ToLocal(&ret)) {
+  MaybeLocal<Value> maybe_ret;
+  const char* data = buffer.data() + start;
+  const uint64_t threshold = env->options()->zero_copy_string_threshold;
+  Local<ArrayBufferView> view = args.This().As<ArrayBufferView>();
+  // Views without a buffer of their own keep their bytes on the V8 heap,
+  // where they may move, so they are always copied.
+  if ((encoding == ASCII || encoding == LATIN1 || encoding == UTF8) &&
+      threshold != 0 && length >= threshold && view->HasBuffer()) {
+    maybe_ret = StringBytes::EncodeExternal(
+        isolate, view->Buffer()->GetBackingStore(), data, length, encoding);
+  } else {
+    maybe_ret = StringBytes::Encode(isolate, data, length, encoding);
+  }
+  if (maybe_ret.ToLocal(&ret)) {
     args.GetReturnValue().Set(ret);
   }
 }
@@ -571,7 +584,7 @@ void CopyImpl(Local<Value> source_obj,
   ArrayBufferViewContents<char> source(source_obj);
   SPREAD_BUFFER_ARG(target_obj, target);
 
-  memmove(target_data + target_start, source.data() + source_start, to_copy);
+  CopyBytes(target_data + target_start, source.data() + source_start, to_copy);
 }
 
 // Assume caller has properly validated args.
@@ -630,7 +643,7 @@ void Fill(const FunctionCallbackInfo<Value>& args) {
   if (Buffer::HasInstance(args[1])) {
     SPREAD_BUFFER_ARG(args[1], fill_obj);
     str_length = fill_obj_length;
-    memcpy(
+    CopyBytes(
         ts_obj_data + start, fill_obj_data, std::min(str_length, fill_length));
     goto start_fill;
   }
@@ -640,7 +653,7 @@ void Fill(const FunctionCallbackInfo<Value>& args) {
     uint32_t val;
     if (!args[1]->Uint32Value(ctx).To(&val)) return;
     int value = val & 255;
-    memset(ts_obj_data + start, value, fill_length);
+    FillBytes(ts_obj_data + start, value, fill_length);
     return;
   }
 
@@ -660,7 +673,7 @@ void Fill(const FunctionCallbackInfo<Value>& args) {
     str_length = str_obj->Length() * sizeof(uint16_t);
     node::TwoByteValue str(env->isolate(), args[1]);
     if constexpr (IsBigEndian())
-      CHECK(nbytes::SwapBytes16(reinterpret_cast<char*>(&str[0]), str_length));
+      CHECK(SwapBytes16(reinterpret_cast<char*>(&str[0]), str_length));
 
     memcpy(ts_obj_data + start, *str, std::min(str_length, fill_length));
 
@@ -689,13 +702,13 @@ start_fill:
   char* ptr = ts_obj_data + start + str_length;
 
   while (in_there < fill_length - in_there) {
-    memcpy(ptr, ts_obj_data + start, in_there);
+    CopyBytes(ptr, ts_obj_data + start, in_there);
     ptr += in_there;
     in_there *= 2;
   }
 
   if (in_there < fill_length) {
-    memcpy(ptr, ts_obj_data + start, fill_length - in_there);
+    CopyBytes(ptr, ts_obj_data + start, fill_length - in_there);
   }
 }
 
@@ -852,10 +865,9 @@ void CompareOffset(const FunctionCallbackInfo<Value> &args) {
       std::min(std::min(source_end - source_start, target_end - target_start),
                source.length() - source_start);
 
-  int val = normalizeCompareVal(to_cmp > 0 ?
-                                  memcmp(source.data() + source_start,
-                                         target.data() + target_start,
-                                         to_cmp) : 0,
+  int val = normalizeCompareVal(CompareBytes(source.data() + source_start,
+                                             target.data() + target_start,
+                                             to_cmp),
                                 source_end - source_start,
                                 target_end - target_start);
 
@@ -869,7 +881,7 @@ int32_t CompareImpl(Local<Value> a_obj, Local<Value> b_obj) {
   size_t cmp_length = std::min(a.length(), b.length());
 
   return normalizeCompareVal(
-      cmp_length > 0 ? memcmp(a.data(), b.data(), cmp_length) : 0,
+      CompareBytes(a.data(), b.data(), cmp_length),
       a.length(),
       b.length());
 }
@@ -1021,13 +1033,12 @@ void IndexOfString(const FunctionCallbackInfo<Value>& args) {
       return args.GetReturnValue().Set(-1);
     CHECK_GE(needle_length, needle_value.length());
 
-    result = nbytes::SearchString(
-        reinterpret_cast<const uint8_t*>(haystack),
-        haystack_length,
-        reinterpret_cast<const uint8_t*>(needle_value.out()),
-        needle_length,
-        offset,
-        is_forward);
+    result = SearchString(reinterpret_cast<const uint8_t*>(haystack),
+                          haystack_length,
+                          reinterpret_cast<const uint8_t*>(needle_value.out()),
+                          needle_length,
+                          offset,
+                          is_forward);
   } else if (enc == LATIN1) {
     uint8_t* needle_data = node::UncheckedMalloc<uint8_t>(needle_length);
     if (needle_data == nullptr) {
@@ -1039,12 +1050,12 @@ void IndexOfString(const FunctionCallbackInfo<Value>& args) {
                        needle,
                        enc);
 
-    result = nbytes::SearchString(reinterpret_cast<const uint8_t*>(haystack),
-                                  haystack_length,
-                                  needle_data,
-                                  needle_length,
-                                  offset,
-                                  is_forward);
+    result = SearchString(reinterpret_cast<const uint8_t*>(haystack),
+                          haystack_length,
+                          needle_data,
+                          needle_length,
+                          offset,
+                          is_forward);
     free(needle_data);
   }
 
@@ -1112,12 +1123,12 @@ void IndexOfBuffer(const FunctionCallbackInfo<Value>& args) {
                                   is_forward);
     result *= 2;
   } else {
-    result = nbytes::SearchString(reinterpret_cast<const uint8_t*>(haystack),
-                                  haystack_length,
-                                  reinterpret_cast<const uint8_t*>(needle),
-                                  needle_length,
-                                  offset,
-                                  is_forward);
+    result = SearchString(reinterpret_cast<const uint8_t*>(haystack),
+                          haystack_length,
+                          reinterpret_cast<const uint8_t*>(needle),
+                          needle_length,
+                          offset,
+                          is_forward);
   }
 
   args.GetReturnValue().Set(
@@ -1138,14 +1149,10 @@ int32_t IndexOfNumberImpl(Local<Value> buffer_obj,
   size_t offset = static_cast<size_t>(opt_offset);
   CHECK_LT(offset, buffer_length);
 
-  const void* ptr;
-  if (is_forward) {
-    ptr = memchr(buffer_data + offset, needle, buffer_length - offset);
-  } else {
-    ptr = nbytes::stringsearch::MemrchrFill(buffer_data, needle, offset + 1);
-  }
-  const uint8_t* ptr_uint8 = static_cast<const uint8_t*>(ptr);
-  return ptr != nullptr ? static_cast<int32_t>(ptr_uint8 - buffer_data) : -1;
+  const uint8_t needle_byte = static_cast<uint8_t>(needle);
+  size_t result = SearchString(
+      buffer_data, buffer_length, &needle_byte, 1, offset, is_forward);
+  return result != buffer_length ? static_cast<int32_t>(result) : -1;
 }
 
 void SlowIndexOfNumber(const FunctionCallbackInfo<Value>& args) {
@@ -1181,7 +1188,7 @@ void Swap16(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
   SPREAD_BUFFER_ARG(args[0], ts_obj);
-  CHECK(nbytes::SwapBytes16(ts_obj_data, ts_obj_length));
+  CHECK(SwapBytes16(ts_obj_data, ts_obj_length));
   args.GetReturnValue().Set(args[0]);
 }
 
@@ -1190,7 +1197,7 @@ void Swap32(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
   SPREAD_BUFFER_ARG(args[0], ts_obj);
-  CHECK(nbytes::SwapBytes32(ts_obj_data, ts_obj_length));
+  CHECK(SwapBytes32(ts_obj_data, ts_obj_length));
   args.GetReturnValue().Set(args[0]);
 }
 
@@ -1199,7 +1206,7 @@ void Swap64(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
   SPREAD_BUFFER_ARG(args[0], ts_obj);
-  CHECK(nbytes::SwapBytes64(ts_obj_data, ts_obj_length));
+  CHECK(SwapBytes64(ts_obj_data, ts_obj_length));
   args.GetReturnValue().Set(args[0]);
 }
 
@@ -1233,6 +1240,25 @@ static void IsAscii(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(simdutf::validate_ascii(abv.data(), abv.length()));
 }
 
+// parseJSON(view) returns JSON.parse(view.toString()), without the string.
+static void ParseJSON(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK_EQ(args.Length(), 1);
+  CHECK(args[0]->IsTypedArray() || args[0]->IsArrayBuffer() ||
+        args[0]->IsSharedArrayBuffer());
+  ArrayBufferViewContents<char> abv(args[0]);
+
+  if (abv.WasDetached()) {
+    return node::THROW_ERR_INVALID_STATE(env, "Cannot parse a detached buffer");
+  }
+
+  Local<Value> result;
+  if (json::Parse(env->context(), std::string_view(abv.data(), abv.length()))
+          .ToLocal(&result)) {
+    args.GetReturnValue().Set(result);
+  }
+}
+
 void SetBufferPrototype(const FunctionCallbackInfo<Value>& args) {
   Realm* realm = Realm::GetCurrent(args);
 
@@ -1583,6 +1609,7 @@ void Initialize(Local<Object> target,
 
   SetMethodNoSideEffect(context, target, "isUtf8", IsUtf8);
   SetMethodNoSideEffect(context, target, "isAscii", IsAscii);
+  SetMethodNoSideEffect(context, target, "parseJSON", ParseJSON);
 
   target
       ->Set(context,
@@ -1653,6 +1680,7 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
 
   registry->Register(IsUtf8);
   registry->Register(IsAscii);
+  registry->Register(ParseJSON);
 
   registry->Register(StringSlice<ASCII>);
   registry->Register(StringSlice<BASE64>);
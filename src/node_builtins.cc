@@ -5,6 +5,7 @@
 #include "node_errors.h"
 #include "node_external_reference.h"
 #include "node_internals.h"
+#include "node_startup_phases.h"
 #include "node_threadsafe_cow-inl.h"
 #include "quic/guard.h"
 #include "simdutf.h"
@@ -21,6 +22,8 @@ using v8::EscapableHandleScope;
 using v8::FixedArray;
 using v8::Function;
 using v8::FunctionCallbackInfo;
+using v8::Global;
+using v8::HandleScope;
 using v8::IntegrityLevel;
 using v8::Isolate;
 using v8::Local;
@@ -45,6 +48,18 @@ using v8::Value;
 
 BuiltinLoader::BuiltinLoader()
     : config_(GetConfig()), code_cache_(std::make_shared<BuiltinCodeCache>()) {
+  source_ = ProcessSources();
+}
+
+const ThreadsafeCopyOnWrite<BuiltinSourceMap>& BuiltinLoader::ProcessSources() {
+  // Never written to, so that every loader keeps referencing its map until
+  // it adds sources of its own.
+  static const BuiltinLoader* loader = new BuiltinLoader(ProcessSourcesTag{});
+  return loader->source_;
+}
+
+BuiltinLoader::BuiltinLoader(ProcessSourcesTag)
+    : config_(GetConfig()), code_cache_(std::make_shared<BuiltinCodeCache>()) {
   LoadJavaScriptSource();
 #ifdef NODE_SHARED_BUILTIN_CJS_MODULE_LEXER_LEXER_PATH
   AddExternalizedBuiltin(
@@ -289,6 +304,21 @@ MaybeLocal<Data> BuiltinLoader::LookupAndCompile(
     Realm* optional_realm) {
   Isolate* isolate = Isolate::GetCurrent();
   EscapableHandleScope scope(isolate);
+  startup_phases::CounterScope counter_scope(
+      startup_phases::Counter::kBuiltinCompile);
+
+  if (!prefetched_.empty() && optional_realm != nullptr &&
+      optional_realm->kind() == Realm::Kind::kPrincipal) {
+    auto prefetched_it = prefetched_.find(builtin_source->id);
+    if (prefetched_it != prefetched_.end()) {
+      Local<Function> fun = prefetched_it->second.Get(isolate);
+      prefetched_.erase(prefetched_it);
+      per_process::Debug(DebugCategory::CODE_CACHE,
+                         "Using prefetched %s\n",
+                         builtin_source->id);
+      return scope.Escape(fun);
+    }
+  }
 
   BuiltinCodeCacheData cached_data{};
   {
@@ -453,6 +483,49 @@ void BuiltinLoader::SaveCodeCache(const std::string& id, Local<Data> data) {
   }
 }
 
+void BuiltinLoader::PrefetchBuiltins(Realm* realm,
+                                     const std::vector<std::string>& ids) {
+  DCHECK_EQ(realm->kind(), Realm::Kind::kPrincipal);
+  bool scheduled = !prefetch_queue_.empty();
+  prefetch_queue_.insert(prefetch_queue_.begin(), ids.rbegin(), ids.rend());
+  if (!scheduled) SchedulePrefetch(realm);
+}
+
+void BuiltinLoader::SchedulePrefetch(Realm* realm) {
+  realm->env()->SetImmediate(
+      [this, realm](Environment* env) {
+        if (prefetch_queue_.empty() || !env->can_call_into_js()) return;
+        std::string id = std::move(prefetch_queue_.back());
+        prefetch_queue_.pop_back();
+        if (!prefetch_queue_.empty()) SchedulePrefetch(realm);
+
+        // Skip the ones that have been required already.
+        if (realm->builtins_with_cache.contains(id) ||
+            realm->builtins_without_cache.contains(id) ||
+            prefetched_.contains(id)) {
+          return;
+        }
+        Isolate* isolate = env->isolate();
+        const BuiltinSource* builtin_source =
+            LoadBuiltinSource(isolate, id.c_str());
+        if (builtin_source == nullptr ||
+            builtin_source->type == BuiltinSourceType::kSourceTextModule) {
+          return;
+        }
+        HandleScope handle_scope(isolate);
+        Local<Context> context = realm->context();
+        Context::Scope context_scope(context);
+        TryCatch try_catch(isolate);
+        Local<Data> data;
+        per_process::Debug(DebugCategory::CODE_CACHE, "Prefetching %s\n", id);
+        if (LookupAndCompile(context, builtin_source, realm).ToLocal(&data)) {
+          prefetched_.emplace(id,
+                              Global<Function>(isolate, data.As<Function>()));
+        }
+      },
+      CallbackFlags::kUnrefed);
+}
+
 MaybeLocal<Function> BuiltinLoader::LookupAndCompileFunction(
     Local<Context> context, const char* id, Realm* optional_realm) {
   Isolate* isolate = Isolate::GetCurrent();
@@ -135,10 +135,23 @@ class NODE_EXTERN_PRIVATE BuiltinLoader {
 
   void SetEagerCompile() { should_eager_compile_ = true; }
 
+  // Compiles the given built-in modules in the principal realm, one per
+  // iteration of the event loop, without keeping it alive. The compiled
+  // functions are kept until the modules are first required, which then
+  // only picks them up instead of deserializing their code cache.
+  void PrefetchBuiltins(Realm* realm, const std::vector<std::string>& ids);
+
  private:
   // Only allow access from friends.
   friend class CodeCacheBuilder;
 
+  // The embedded and the externalized sources are the same for every loader,
+  // so they are put together once per process and shared copy-on-write by
+  // all loaders, and thus all Workers, instead of each building its own map.
+  struct ProcessSourcesTag {};
+  explicit BuiltinLoader(ProcessSourcesTag);
+  static const ThreadsafeCopyOnWrite<BuiltinSourceMap>& ProcessSources();
+
   // Generated by tools/js2c.cc as node_javascript.cc
   void LoadJavaScriptSource();  // Loads data into source_
   UnionBytes GetConfig();       // Return data for config.gypi
@@ -203,6 +216,8 @@ class NODE_EXTERN_PRIVATE BuiltinLoader {
   const BuiltinSource* AddExternalizedBuiltin(const char* id,
                                               const char* filename);
 
+  void SchedulePrefetch(Realm* realm);
+
   ThreadsafeCopyOnWrite<BuiltinSourceMap> source_;
 
   const UnionBytes config_;
@@ -227,6 +242,11 @@ class NODE_EXTERN_PRIVATE BuiltinLoader {
   std::shared_ptr<BuiltinCodeCache> code_cache_;
 
   std::unordered_map<std::string, v8::Global<v8::Module>> module_cache_;
+
+  // Built-ins left to prefetch, in reverse order, and the functions that
+  // were prefetched but not yet required.
+  std::vector<std::string> prefetch_queue_;
+  std::unordered_map<std::string, v8::Global<v8::Function>> prefetched_;
   friend class ::PerProcessTest;
 };
 
@@ -33,6 +33,7 @@
 #include "node_sea.h"
 #include "node_snapshot_builder.h"
 #include "node_url.h"
+#include "node_usdt.h"
 #include "node_watchdog.h"
 #include "util-inl.h"
 
@@ -50,6 +51,7 @@ using v8::EscapableHandleScope;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::Global;
 using v8::HandleScope;
 using v8::IndexedPropertyHandlerConfiguration;
 using v8::IndexFilter;
@@ -138,14 +140,68 @@ ContextifyContext* ContextifyContext::New(Environment* env,
           : env->isolate()->GetCurrentContext()->GetMicrotaskQueue();
 
   Local<Context> v8_context;
-  if (!(CreateV8Context(env->isolate(), object_template, snapshot_data, queue)
-            .ToLocal(&v8_context))) {
+  std::vector<Global<Context>>& pool = env->contextify_context_pool;
+  if (!object_template.IsEmpty() && !pool.empty() &&
+      queue == env->context()->GetMicrotaskQueue()) {
+    v8_context = pool.back().Get(env->isolate());
+    pool.pop_back();
+    ScheduleContextPoolRefill(env);
+  } else if (!(CreateV8Context(
+                   env->isolate(), object_template, snapshot_data, queue)
+                   .ToLocal(&v8_context))) {
     // Allocation failure, maximum call stack size reached, termination, etc.
     return {};
   }
   return New(v8_context, env, sandbox_obj, options);
 }
 
+void ContextifyContext::FillContextPool(Environment* env) {
+  Isolate* isolate = env->isolate();
+  HandleScope scope(isolate);
+  std::vector<Global<Context>>& pool = env->contextify_context_pool;
+  while (pool.size() < env->contextify_context_pool_size) {
+    Local<Context> v8_context;
+    if (!CreateV8Context(isolate,
+                         env->contextify_global_template(),
+                         env->isolate_data()->snapshot_data(),
+                         env->context()->GetMicrotaskQueue())
+             .ToLocal(&v8_context)) {
+      return;
+    }
+    pool.emplace_back(isolate, v8_context);
+  }
+}
+
+void ContextifyContext::ScheduleContextPoolRefill(Environment* env) {
+  if (env->contextify_context_pool_refill_pending) return;
+  env->contextify_context_pool_refill_pending = true;
+  env->SetImmediate(
+      [](Environment* env) {
+        env->contextify_context_pool_refill_pending = false;
+        FillContextPool(env);
+      },
+      CallbackFlags::kUnrefed);
+}
+
+void ContextifyContext::SetContextPoolSize(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  // Contexts cannot be kept alive across a snapshot.
+  if (env->isolate_data()->is_building_snapshot()) return;
+
+  const size_t size = args[0].As<Uint32>()->Value();
+  env->contextify_context_pool_size = size;
+  if (env->contextify_context_pool.size() > size) {
+    env->contextify_context_pool.resize(size);
+  }
+  TryCatchScope try_catch(env);
+  FillContextPool(env);
+  if (try_catch.HasCaught() && !try_catch.HasTerminated()) {
+    try_catch.ReThrow();
+  }
+}
+
 void ContextifyContext::Trace(cppgc::Visitor* visitor) const {
   CppgcMixin::Trace(visitor);
   visitor->Trace(context_);
@@ -365,11 +421,13 @@ void ContextifyContext::CreatePerIsolateProperties(
     IsolateData* isolate_data, Local<ObjectTemplate> target) {
   Isolate* isolate = isolate_data->isolate();
   SetMethod(isolate, target, "makeContext", MakeContext);
+  SetMethod(isolate, target, "setContextPoolSize", SetContextPoolSize);
 }
 
 void ContextifyContext::RegisterExternalReferences(
     ExternalReferenceRegistry* registry) {
   registry->Register(MakeContext);
+  registry->Register(SetContextPoolSize);
   registry->Register(PropertyQueryCallback);
   registry->Register(PropertyGetterCallback);
   registry->Register(PropertySetterCallback);
@@ -1046,6 +1104,36 @@ void ContextifyScript::New(const FunctionCallbackInfo<Value>& args) {
         data + cached_data_buf->ByteOffset(), cached_data_buf->ByteLength());
   }
 
+  CompiledScriptCache* script_cache = nullptr;
+  Local<UnboundScript> v8_script;
+  if (cached_data == nullptr &&
+      CompiledScriptCache::IsCacheable(env, id_symbol)) {
+    if (!env->compiled_script_cache) {
+      env->compiled_script_cache = std::make_unique<CompiledScriptCache>();
+    }
+    script_cache = env->compiled_script_cache.get();
+    USE(script_cache
+            ->Get(isolate,
+                  code,
+                  filename,
+                  line_offset,
+                  column_offset,
+                  id_symbol)
+            .ToLocal(&v8_script));
+  }
+
+  // Scripts that are not passed cachedData can use the on-disk compile
+  // cache, if it is enabled. That is not reported as cachedDataRejected.
+  CompileCacheEntry* cache_entry = nullptr;
+  if (v8_script.IsEmpty() && cached_data == nullptr &&
+      env->use_compile_cache()) {
+    cache_entry = env->compile_cache_handler()->GetOrInsert(
+        code, filename, CachedCodeType::kScript);
+  }
+  if (cache_entry != nullptr && cache_entry->cache != nullptr) {
+    cached_data = cache_entry->CopyCache();
+  }
+
   Local<PrimitiveArray> host_defined_options =
       PrimitiveArray::New(isolate, loader::HostDefinedOptions::kLength);
   host_defined_options->Set(
@@ -1068,22 +1156,40 @@ void ContextifyScript::New(const FunctionCallbackInfo<Value>& args) {
   if (source.GetCachedData() != nullptr)
     compile_options = ScriptCompiler::kConsumeCodeCache;
 
-  TryCatchScope try_catch(env);
-  ShouldNotAbortOnUncaughtScope no_abort_scope(env);
-  Context::Scope scope(parsing_context);
+  if (v8_script.IsEmpty()) {
+    TryCatchScope try_catch(env);
+    ShouldNotAbortOnUncaughtScope no_abort_scope(env);
+    Context::Scope scope(parsing_context);
 
-  MaybeLocal<UnboundScript> maybe_v8_script =
-      ScriptCompiler::CompileUnboundScript(isolate, &source, compile_options);
+    MaybeLocal<UnboundScript> maybe_v8_script =
+        ScriptCompiler::CompileUnboundScript(isolate, &source, compile_options);
 
-  Local<UnboundScript> v8_script;
-  if (!maybe_v8_script.ToLocal(&v8_script)) {
-    errors::DecorateErrorStack(env, try_catch);
-    no_abort_scope.Close();
-    if (!try_catch.HasTerminated())
-      try_catch.ReThrow();
-    TRACE_EVENT_END0(TRACING_CATEGORY_NODE2(vm, script),
-                     "ContextifyScript::New");
-    return;
+    if (!maybe_v8_script.ToLocal(&v8_script)) {
+      errors::DecorateErrorStack(env, try_catch);
+      no_abort_scope.Close();
+      if (!try_catch.HasTerminated())
+        try_catch.ReThrow();
+      TRACE_EVENT_END0(TRACING_CATEGORY_NODE2(vm, script),
+                       "ContextifyScript::New");
+      return;
+    }
+
+    if (cache_entry != nullptr) {
+      const bool rejected =
+          compile_options == ScriptCompiler::kConsumeCodeCache &&
+          source.GetCachedData()->rejected;
+      env->compile_cache_handler()->MaybeSave(cache_entry, v8_script, rejected);
+      compile_options = ScriptCompiler::kNoCompileOptions;
+    }
+    if (script_cache != nullptr) {
+      script_cache->Put(isolate,
+                        code,
+                        filename,
+                        line_offset,
+                        column_offset,
+                        id_symbol,
+                        v8_script);
+    }
   }
 
   contextify_script->set_unbound_script(v8_script);
@@ -1125,6 +1231,73 @@ void ContextifyScript::New(const FunctionCallbackInfo<Value>& args) {
   TRACE_EVENT_END0(TRACING_CATEGORY_NODE2(vm, script), "ContextifyScript::New");
 }
 
+struct CompiledScriptCache::Entry {
+  Global<String> code;
+  Global<String> filename;
+  Global<Symbol> id_symbol;
+  Global<UnboundScript> script;
+};
+
+CompiledScriptCache::CompiledScriptCache() : entries_(kCapacity) {}
+
+CompiledScriptCache::~CompiledScriptCache() = default;
+
+bool CompiledScriptCache::IsCacheable(Environment* env,
+                                      Local<Symbol> id_symbol) {
+  return !id_symbol.IsEmpty() &&
+         (id_symbol == env->vm_dynamic_import_default_internal() ||
+          id_symbol == env->vm_dynamic_import_main_context_default() ||
+          id_symbol == env->vm_dynamic_import_missing_flag() ||
+          id_symbol == env->vm_dynamic_import_no_callback());
+}
+
+std::string CompiledScriptCache::Key(Local<String> code,
+                                     Local<String> filename,
+                                     int line_offset,
+                                     int column_offset) {
+  // The hashes of strings are computed once and kept with them by V8. Entries
+  // whose keys collide are told apart by comparing the strings.
+  return SPrintF("%d:%d:%d:%d:%d",
+                 code->GetIdentityHash(),
+                 code->Length(),
+                 filename->GetIdentityHash(),
+                 line_offset,
+                 column_offset);
+}
+
+MaybeLocal<UnboundScript> CompiledScriptCache::Get(Isolate* isolate,
+                                                   Local<String> code,
+                                                   Local<String> filename,
+                                                   int line_offset,
+                                                   int column_offset,
+                                                   Local<Symbol> id_symbol) {
+  const std::string key = Key(code, filename, line_offset, column_offset);
+  if (!entries_.Exists(key)) return {};
+  std::shared_ptr<Entry> entry = entries_.Get(key);
+  if (entry->id_symbol.Get(isolate) != id_symbol ||
+      !entry->filename.Get(isolate)->StringEquals(filename) ||
+      !entry->code.Get(isolate)->StringEquals(code)) {
+    return {};
+  }
+  return entry->script.Get(isolate);
+}
+
+void CompiledScriptCache::Put(Isolate* isolate,
+                              Local<String> code,
+                              Local<String> filename,
+                              int line_offset,
+                              int column_offset,
+                              Local<Symbol> id_symbol,
+                              Local<UnboundScript> script) {
+  auto entry = std::make_shared<Entry>();
+  entry->code.Reset(isolate, code);
+  entry->filename.Reset(isolate, filename);
+  entry->id_symbol.Reset(isolate, id_symbol);
+  entry->script.Reset(isolate, script);
+  entries_.Put(Key(code, filename, line_offset, column_offset),
+               std::move(entry));
+}
+
 Maybe<void> StoreCodeCacheResult(
     Environment* env,
     Local<Object> target,
@@ -1696,6 +1869,20 @@ static MaybeLocal<Function> CompileFunctionForCJSLoader(
     // source will take ownership of cached_data.
     cached_data = cache_entry->CopyCache();
   }
+#ifndef DISABLE_SINGLE_EXECUTABLE_APPLICATION
+  if (cached_data == nullptr) {
+    cached_data = sea::FindModuleCodeCache(env, filename);
+  }
+#endif
+
+  Local<Function> fn;
+  loader::ModulePrefetcher* prefetcher =
+      is_cjs_scope ? env->module_prefetcher() : nullptr;
+  if (prefetcher != nullptr && cached_data == nullptr &&
+      prefetcher->CompileCommonJS(context, filename, code, hdo, &fn)) {
+    prefetcher->OnCommonJSCompiled(filename, code);
+    return scope.Escape(fn);
+  }
 
   ScriptCompiler::Source source(code, origin, cached_data);
   ScriptCompiler::CompileOptions options;
@@ -1719,10 +1906,10 @@ static MaybeLocal<Function> CompileFunctionForCJSLoader(
       // TODO(joyeecheung): allow optional eager compilation.
       options);
 
-  Local<Function> fn;
   if (!maybe_fn.ToLocal(&fn)) {
     return scope.EscapeMaybe(MaybeLocal<Function>());
   }
+  if (prefetcher != nullptr) prefetcher->OnCommonJSCompiled(filename, code);
 
   if (options == ScriptCompiler::kConsumeCodeCache) {
     *cache_rejected = source.GetCachedData()->rejected;
@@ -1767,6 +1954,10 @@ static void CompileFunctionForCJSLoader(
   Local<Context> context = isolate->GetCurrentContext();
   Realm* realm = Realm::GetCurrent(context);
   Environment* env = realm->env();
+  if (NODE_USDT_ENABLED(module__load)) {
+    Utf8Value filename_value(isolate, filename);
+    NODE_USDT1(module__load, *filename_value);
+  }
 
   bool cache_rejected = false;
   Local<Function> fn;
@@ -5,6 +5,7 @@
 
 #include "base_object-inl.h"
 #include "cppgc_helpers-inl.h"
+#include "lru_cache-inl.h"
 #include "node_context_data.h"
 #include "node_errors.h"
 
@@ -141,8 +142,19 @@ class ContextifyContext final : CPPGC_MIXIN(ContextifyContext) {
                                 v8::Local<v8::Object> sandbox_obj,
                                 ContextOptions* options);
 
+  // Creates V8 contexts for contextified sandboxes until the pool of
+  // env holds as many as it should.
+  static void FillContextPool(Environment* env);
+  static void ScheduleContextPoolRefill(Environment* env);
+
   static bool IsStillInitializing(const ContextifyContext* ctx);
   static void MakeContext(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // setContextPoolSize(size) keeps up to size V8 contexts created ahead of
+  // time, for makeContext() to use for sandboxes that share the microtask
+  // queue of the main context. The pool is filled right away, and otherwise
+  // refilled from an immediate after a context is taken from it.
+  static void SetContextPoolSize(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void IsContext(const v8::FunctionCallbackInfo<v8::Value>& args);
   static v8::Intercepted PropertyQueryCallback(
       v8::Local<v8::Name> property,
@@ -189,6 +201,44 @@ class ContextifyContext final : CPPGC_MIXIN(ContextifyContext) {
   std::unique_ptr<v8::MicrotaskQueue> microtask_queue_;
 };
 
+// Unbound scripts compiled by new vm.Script(), by source and origin, so that
+// compiling the same source again is a lookup. The host-defined option id is
+// part of a script, so only scripts that use one of the shared ids, that is
+// those without their own importModuleDynamically, are cached.
+class CompiledScriptCache {
+ public:
+  static constexpr size_t kCapacity = 256;
+
+  CompiledScriptCache();
+  ~CompiledScriptCache();
+
+  static bool IsCacheable(Environment* env, v8::Local<v8::Symbol> id_symbol);
+
+  v8::MaybeLocal<v8::UnboundScript> Get(v8::Isolate* isolate,
+                                        v8::Local<v8::String> code,
+                                        v8::Local<v8::String> filename,
+                                        int line_offset,
+                                        int column_offset,
+                                        v8::Local<v8::Symbol> id_symbol);
+  void Put(v8::Isolate* isolate,
+           v8::Local<v8::String> code,
+           v8::Local<v8::String> filename,
+           int line_offset,
+           int column_offset,
+           v8::Local<v8::Symbol> id_symbol,
+           v8::Local<v8::UnboundScript> script);
+
+ private:
+  struct Entry;
+
+  static std::string Key(v8::Local<v8::String> code,
+                         v8::Local<v8::String> filename,
+                         int line_offset,
+                         int column_offset);
+
+  LRUCache<std::string, std::shared_ptr<Entry>> entries_;
+};
+
 class ContextifyScript final : CPPGC_MIXIN(ContextifyScript) {
  public:
   SET_CPPGC_NAME(ContextifyScript)
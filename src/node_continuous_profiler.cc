@@ -0,0 +1,521 @@
+#include "node_continuous_profiler.h"
+#include "diagnosticfilename-inl.h"
+#include "env-inl.h"
+#include "node_file.h"
+#include "node_internals.h"
+#include "node_protobuf.h"
+#include "util-inl.h"
+#include "zlib.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace node {
+namespace profiler {
+
+using v8::AllocationProfile;
+using v8::CpuProfile;
+using v8::CpuProfileNode;
+using v8::CpuProfiler;
+using v8::CpuProfilingMode;
+using v8::CpuProfilingOptions;
+using v8::CpuProfilingResult;
+using v8::CpuProfilingStatus;
+using v8::HandleScope;
+using v8::HeapProfiler;
+using v8::Isolate;
+
+namespace {
+
+// Profile.
+constexpr uint32_t kProfileSampleType = 1;
+constexpr uint32_t kProfileSample = 2;
+constexpr uint32_t kProfileLocation = 4;
+constexpr uint32_t kProfileFunction = 5;
+constexpr uint32_t kProfileStringTable = 6;
+constexpr uint32_t kProfileTimeNanos = 9;
+constexpr uint32_t kProfileDurationNanos = 10;
+constexpr uint32_t kProfilePeriodType = 11;
+constexpr uint32_t kProfilePeriod = 12;
+
+// ValueType.
+constexpr uint32_t kValueTypeType = 1;
+constexpr uint32_t kValueTypeUnit = 2;
+
+// Sample.
+constexpr uint32_t kSampleLocationId = 1;
+constexpr uint32_t kSampleValue = 2;
+
+// Location and Line.
+constexpr uint32_t kLocationId = 1;
+constexpr uint32_t kLocationLine = 4;
+constexpr uint32_t kLineFunctionId = 1;
+constexpr uint32_t kLineLine = 2;
+
+// Function.
+constexpr uint32_t kFunctionId = 1;
+constexpr uint32_t kFunctionName = 2;
+constexpr uint32_t kFunctionSystemName = 3;
+constexpr uint32_t kFunctionFilename = 4;
+constexpr uint32_t kFunctionStartLine = 5;
+
+// Builds a pprof Profile message. The fields can be added in any order,
+// and the string table is appended last.
+class ProfileBuilder {
+ public:
+  ProfileBuilder() { String(""); }
+
+  int64_t String(std::string_view string) {
+    auto [it, inserted] =
+        string_indices_.emplace(std::string(string), strings_.size());
+    if (inserted) strings_.push_back(it->first);
+    return it->second;
+  }
+
+  void AddSampleType(const char* type, const char* unit) {
+    profile_.AppendMessage(kProfileSampleType, ValueType(type, unit));
+  }
+
+  // Returns the id of the function, adding it if this is its first frame.
+  uint64_t Function(const char* name,
+                    const char* filename,
+                    int script_id,
+                    int line,
+                    int column) {
+    if (name == nullptr || name[0] == '\0') name = "(anonymous)";
+    std::string key = std::string(name) + '\0' + filename + '\0' +
+                      std::to_string(script_id) + ':' + std::to_string(line) +
+                      ':' + std::to_string(column);
+    auto [it, inserted] =
+        functions_.try_emplace(std::move(key), functions_.size() + 1);
+    if (inserted) {
+      ProtobufMessage function;
+      function.AppendVarint(kFunctionId, it->second);
+      function.AppendVarint(kFunctionName, String(name));
+      function.AppendVarint(kFunctionSystemName, String(name));
+      function.AppendVarint(kFunctionFilename, String(filename));
+      function.AppendVarint(kFunctionStartLine, std::max(line, 0));
+      profile_.AppendMessage(kProfileFunction, function);
+    }
+    return it->second;
+  }
+
+  // Adds a location with a single line, in function_id.
+  void AddLocation(uint64_t id, uint64_t function_id, int line) {
+    ProtobufMessage line_message;
+    line_message.AppendVarint(kLineFunctionId, function_id);
+    line_message.AppendVarint(kLineLine, std::max(line, 0));
+    ProtobufMessage location;
+    location.AppendVarint(kLocationId, id);
+    location.AppendMessage(kLocationLine, line_message);
+    profile_.AppendMessage(kProfileLocation, location);
+  }
+
+  // location_ids is the stack of the sample, from the leaf up.
+  void AddSample(const std::vector<uint64_t>& location_ids,
+                 std::initializer_list<int64_t> values) {
+    ProtobufMessage sample;
+    sample.AppendPackedVarints(kSampleLocationId, location_ids);
+    sample.AppendPackedVarints(kSampleValue, values);
+    profile_.AppendMessage(kProfileSample, sample);
+  }
+
+  std::string Finish(int64_t time_nanos,
+                     int64_t duration_nanos,
+                     const char* period_type,
+                     const char* period_unit,
+                     int64_t period) {
+    profile_.AppendVarint(kProfileTimeNanos, time_nanos);
+    profile_.AppendVarint(kProfileDurationNanos,
+                          std::max<int64_t>(duration_nanos, 0));
+    profile_.AppendMessage(kProfilePeriodType,
+                           ValueType(period_type, period_unit));
+    profile_.AppendVarint(kProfilePeriod, period);
+    for (const std::string& string : strings_) {
+      profile_.AppendString(kProfileStringTable, string);
+    }
+    return profile_.Release();
+  }
+
+ private:
+  ProtobufMessage ValueType(const char* type, const char* unit) {
+    ProtobufMessage value_type;
+    value_type.AppendVarint(kValueTypeType, String(type));
+    value_type.AppendVarint(kValueTypeUnit, String(unit));
+    return value_type;
+  }
+
+  ProtobufMessage profile_;
+  std::unordered_map<std::string, int64_t> string_indices_;
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint64_t> functions_;
+};
+
+// The frames that are not in a script have no file, so they are given
+// one that tells where they run.
+const char* FilenameOf(const CpuProfileNode* node) {
+  const char* url = node->GetScriptResourceNameStr();
+  if (url != nullptr && url[0] != '\0') return url;
+  switch (node->GetSourceType()) {
+    case CpuProfileNode::kBuiltin:
+      return "(builtin)";
+    case CpuProfileNode::kCallback:
+      return "(native)";
+    case CpuProfileNode::kInternal:
+      return "(v8)";
+    case CpuProfileNode::kUnresolved:
+      return "(unresolved)";
+    default:
+      return "";
+  }
+}
+
+bool Gzip(const std::string& input, std::string* output) {
+  z_stream stream{};
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+  output->resize(deflateBound(&stream, input.size()));
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef*>(output->data());
+  stream.avail_out = output->size();
+  int ret = deflate(&stream, Z_FINISH);
+  output->resize(stream.total_out);
+  deflateEnd(&stream);
+  return ret == Z_STREAM_END;
+}
+
+int64_t WallTimeNanos() {
+  uv_timeval64_t time;
+  CHECK_EQ(uv_gettimeofday(&time), 0);
+  return time.tv_sec * 1000000000 + time.tv_usec * 1000;
+}
+
+// The deepest stacks that the sampling heap profiler records.
+constexpr int kHeapProfileStackDepth = 64;
+
+}  // namespace
+
+ContinuousProfiler::ContinuousProfiler(Environment* env,
+                                       std::string directory,
+                                       uint64_t rotation_ms)
+    : env_(env), directory_(std::move(directory)) {
+  CHECK_EQ(uv_timer_init(env->event_loop(), &timer_), 0);
+  CHECK_EQ(uv_timer_start(&timer_, OnTimer, rotation_ms, rotation_ms), 0);
+  // Profiling does not keep the process alive.
+  uv_unref(reinterpret_cast<uv_handle_t*>(&timer_));
+  // The last profile would be lost if --fast-exit skipped writing it.
+  env->AddEssentialCleanupHook(Cleanup, this);
+}
+
+std::string ContinuousProfiler::EnsureDirectory(Environment* env,
+                                                const std::string& directory) {
+  std::string resolved =
+      directory.empty() ? Environment::GetCwd(env->exec_path()) : directory;
+  fs::FSReqWrapSync req_wrap_sync;
+  int ret =
+      fs::MKDirpSync(nullptr, &req_wrap_sync.req, resolved, 0777, nullptr);
+  if (ret < 0 && ret != UV_EEXIST) {
+    char err_buf[128];
+    uv_err_name_r(ret, err_buf, sizeof(err_buf));
+    fprintf(stderr,
+            "%s: Failed to create profile directory %s\n",
+            err_buf,
+            resolved.c_str());
+    return std::string();
+  }
+  return resolved;
+}
+
+void ContinuousProfiler::WriteProfile(const char* prefix,
+                                      const std::string& profile) {
+  std::string compressed;
+  if (!Gzip(profile, &compressed)) return;
+  DiagnosticFilename filename(env_, prefix, "pb.gz");
+  std::string path = directory_ + kPathSeparator + *filename;
+  uv_buf_t buf = uv_buf_init(compressed.data(), compressed.size());
+  int ret = WriteFileSync(path.c_str(), buf);
+  if (ret != 0) {
+    char err_buf[128];
+    uv_err_name_r(ret, err_buf, sizeof(err_buf));
+    fprintf(stderr, "%s: Failed to write file %s\n", err_buf, path.c_str());
+  }
+}
+
+void ContinuousProfiler::OnTimer(uv_timer_t* timer) {
+  ContinuousProfiler* profiler =
+      ContainerOf(&ContinuousProfiler::timer_, timer);
+  profiler->Rotate(true);
+}
+
+void ContinuousProfiler::Cleanup(void* data) {
+  ContinuousProfiler* profiler = static_cast<ContinuousProfiler*>(data);
+  profiler->Rotate(false);
+  profiler->env_->CloseHandle(&profiler->timer_, [](uv_timer_t* timer) {
+    ContinuousProfiler* profiler =
+        ContainerOf(&ContinuousProfiler::timer_, timer);
+    delete profiler;
+  });
+}
+
+std::string ContinuousCpuProfiler::Serialize(const CpuProfile* profile,
+                                             int64_t start_time_nanos,
+                                             uint64_t sampling_interval_us) {
+  ProfileBuilder builder;
+  builder.AddSampleType("samples", "count");
+  builder.AddSampleType("cpu", "nanoseconds");
+
+  // The samples of the same node have the same stack, so they are
+  // aggregated into one pprof sample, weighted by the time until the next
+  // sample was taken.
+  struct Weight {
+    int64_t count = 0;
+    int64_t nanos = 0;
+  };
+  std::unordered_map<const CpuProfileNode*, Weight> weights;
+  std::vector<const CpuProfileNode*> nodes;
+  int samples_count = profile->GetSamplesCount();
+  for (int i = 0; i < samples_count; i++) {
+    const CpuProfileNode* node = profile->GetSample(i);
+    int64_t micros = static_cast<int64_t>(sampling_interval_us);
+    if (i + 1 < samples_count) {
+      micros = std::max<int64_t>(
+          profile->GetSampleTimestamp(i + 1) - profile->GetSampleTimestamp(i),
+          0);
+    }
+    auto [it, inserted] = weights.try_emplace(node);
+    if (inserted) nodes.push_back(node);
+    it->second.count++;
+    it->second.nanos += micros * 1000;
+  }
+
+  // Every node is a location, and the nodes of the same function share
+  // its Function.
+  std::unordered_set<const CpuProfileNode*> locations;
+  std::vector<uint64_t> location_ids;
+  for (const CpuProfileNode* node : nodes) {
+    // The stack, from the leaf up to but excluding the root node.
+    location_ids.clear();
+    for (const CpuProfileNode* frame = node;
+         frame != nullptr && frame->GetParent() != nullptr;
+         frame = frame->GetParent()) {
+      if (locations.insert(frame).second) {
+        uint64_t function_id = builder.Function(frame->GetFunctionNameStr(),
+                                                FilenameOf(frame),
+                                                frame->GetScriptId(),
+                                                frame->GetLineNumber(),
+                                                frame->GetColumnNumber());
+        builder.AddLocation(
+            frame->GetNodeId(), function_id, frame->GetLineNumber());
+      }
+      location_ids.push_back(frame->GetNodeId());
+    }
+    const Weight& weight = weights[node];
+    builder.AddSample(location_ids, {weight.count, weight.nanos});
+  }
+
+  return builder.Finish(
+      start_time_nanos,
+      (profile->GetEndTime() - profile->GetStartTime()) * 1000,
+      "cpu",
+      "nanoseconds",
+      sampling_interval_us * 1000);
+}
+
+ContinuousCpuProfiler::ContinuousCpuProfiler(Environment* env,
+                                             std::string directory,
+                                             uint64_t sampling_interval_us,
+                                             uint64_t rotation_ms)
+    : ContinuousProfiler(env, std::move(directory), rotation_ms),
+      sampling_interval_us_(sampling_interval_us),
+      profiler_(CpuProfiler::New(env->isolate())) {}
+
+ContinuousCpuProfiler::~ContinuousCpuProfiler() {
+  profiler_->Dispose();
+}
+
+void ContinuousCpuProfiler::Start(Environment* env) {
+  const EnvironmentOptions* options = env->options().get();
+  std::string directory = EnsureDirectory(env, options->cpu_prof_dir);
+  if (directory.empty()) return;
+
+  HandleScope handle_scope(env->isolate());
+  auto* profiler = new ContinuousCpuProfiler(
+      env,
+      std::move(directory),
+      options->cpu_prof_continuous_interval,
+      options->cpu_prof_continuous_rotation * 1000);
+  if (!profiler->StartProfile()) {
+    fprintf(stderr, "Failed to start the continuous CPU profiler\n");
+  }
+}
+
+bool ContinuousCpuProfiler::StartProfile() {
+  CpuProfilingResult result = profiler_->Start(
+      CpuProfilingOptions(CpuProfilingMode::kLeafNodeLineNumbers,
+                          CpuProfilingOptions::kNoSampleLimit,
+                          static_cast<int>(sampling_interval_us_)));
+  if (result.status != CpuProfilingStatus::kStarted) return false;
+  profile_id_ = result.id;
+  profiling_ = true;
+  start_time_nanos_ = WallTimeNanos();
+  return true;
+}
+
+void ContinuousCpuProfiler::Rotate(bool restart) {
+  if (!profiling_) return;
+  HandleScope handle_scope(env()->isolate());
+  v8::ProfilerId profile_id = profile_id_;
+  int64_t start_time_nanos = start_time_nanos_;
+  profiling_ = false;
+  // The next profile is started before this one is stopped, so that no
+  // samples are missed in between.
+  if (restart) StartProfile();
+  CpuProfile* profile = profiler_->Stop(profile_id);
+  if (profile == nullptr) return;
+  if (profile->GetSamplesCount() > 0) {
+    WriteProfile("CPU",
+                 Serialize(profile, start_time_nanos, sampling_interval_us_));
+  }
+  profile->Delete();
+}
+
+std::string ContinuousHeapProfiler::Serialize(Isolate* isolate,
+                                              AllocationProfile* profile,
+                                              bool include_collected,
+                                              int64_t time_nanos,
+                                              int64_t duration_nanos,
+                                              uint64_t sampling_interval) {
+  ProfileBuilder builder;
+  if (include_collected) {
+    builder.AddSampleType("alloc_objects", "count");
+    builder.AddSampleType("alloc_space", "bytes");
+  } else {
+    builder.AddSampleType("inuse_objects", "count");
+    builder.AddSampleType("inuse_space", "bytes");
+  }
+
+  // Every node is a location and, when it has allocations, a sample of
+  // their total, with the stack of the nodes above it. The node ids are
+  // offset by one since a location id cannot be 0.
+  std::vector<uint64_t> stack;
+  std::function<void(AllocationProfile::Node*)> visit =
+      [&](AllocationProfile::Node* node) {
+        Utf8Value name(isolate, node->name);
+        Utf8Value filename(isolate, node->script_name);
+        uint64_t function_id = builder.Function(*name,
+                                                *filename,
+                                                node->script_id,
+                                                node->line_number,
+                                                node->column_number);
+        uint64_t location_id = static_cast<uint64_t>(node->node_id) + 1;
+        builder.AddLocation(location_id, function_id, node->line_number);
+        stack.insert(stack.begin(), location_id);
+
+        int64_t objects = 0;
+        int64_t bytes = 0;
+        for (const AllocationProfile::Allocation& allocation :
+             node->allocations) {
+          objects += allocation.count;
+          bytes += static_cast<int64_t>(allocation.size) * allocation.count;
+        }
+        if (objects > 0) builder.AddSample(stack, {objects, bytes});
+
+        for (AllocationProfile::Node* child : node->children) visit(child);
+        stack.erase(stack.begin());
+      };
+  // The root node is not a frame.
+  for (AllocationProfile::Node* child : profile->GetRootNode()->children) {
+    visit(child);
+  }
+
+  return builder.Finish(time_nanos - duration_nanos,
+                        duration_nanos,
+                        "space",
+                        "bytes",
+                        sampling_interval);
+}
+
+ContinuousHeapProfiler::ContinuousHeapProfiler(Environment* env,
+                                               std::string directory,
+                                               uint64_t sampling_interval,
+                                               bool include_collected,
+                                               uint64_t rotation_ms)
+    : ContinuousProfiler(env, std::move(directory), rotation_ms),
+      sampling_interval_(sampling_interval),
+      include_collected_(include_collected) {}
+
+ContinuousHeapProfiler::~ContinuousHeapProfiler() {
+  if (sampling_) {
+    env()->isolate()->GetHeapProfiler()->StopSamplingHeapProfiler();
+  }
+}
+
+void ContinuousHeapProfiler::Start(Environment* env) {
+  const EnvironmentOptions* options = env->options().get();
+  std::string directory = EnsureDirectory(env, options->heap_prof_dir);
+  if (directory.empty()) return;
+
+  auto* profiler = new ContinuousHeapProfiler(
+      env,
+      std::move(directory),
+      options->heap_prof_continuous_interval,
+      options->heap_prof_continuous_include_collected,
+      options->heap_prof_continuous_rotation * 1000);
+  if (!profiler->StartSampling()) {
+    // There is a single sampling heap profiler per isolate.
+    fprintf(stderr, "Failed to start the continuous heap profiler\n");
+  }
+}
+
+bool ContinuousHeapProfiler::StartSampling() {
+  int flags = HeapProfiler::kSamplingNoFlags;
+  if (include_collected_) {
+    flags |= HeapProfiler::kSamplingIncludeObjectsCollectedByMajorGC |
+             HeapProfiler::kSamplingIncludeObjectsCollectedByMinorGC;
+  }
+  sampling_ = env()->isolate()->GetHeapProfiler()->StartSamplingHeapProfiler(
+      sampling_interval_,
+      kHeapProfileStackDepth,
+      static_cast<HeapProfiler::SamplingFlags>(flags));
+  start_time_nanos_ = WallTimeNanos();
+  return sampling_;
+}
+
+void ContinuousHeapProfiler::Rotate(bool restart) {
+  if (!sampling_) return;
+  Isolate* isolate = env()->isolate();
+  HandleScope handle_scope(isolate);
+  HeapProfiler* heap_profiler = isolate->GetHeapProfiler();
+  std::unique_ptr<AllocationProfile> profile(
+      heap_profiler->GetAllocationProfile());
+  int64_t now = WallTimeNanos();
+  int64_t start_time_nanos = start_time_nanos_;
+  // The profile of the objects that are alive covers the whole run, while
+  // the profile of all the allocations starts over every time.
+  if (include_collected_ || !restart) {
+    heap_profiler->StopSamplingHeapProfiler();
+    sampling_ = false;
+    if (restart) StartSampling();
+  }
+  if (profile && !profile->GetSamples().empty()) {
+    WriteProfile("Heap",
+                 Serialize(isolate,
+                           profile.get(),
+                           include_collected_,
+                           now,
+                           now - start_time_nanos,
+                           sampling_interval_));
+  }
+}
+
+}  // namespace profiler
+}  // namespace node
@@ -0,0 +1,127 @@
+#ifndef SRC_NODE_CONTINUOUS_PROFILER_H_
+#define SRC_NODE_CONTINUOUS_PROFILER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstdint>
+#include <string>
+
+#include "uv.h"
+#include "v8-profiler.h"
+
+namespace node {
+
+class Environment;
+
+namespace profiler {
+
+// Profiles an environment, without an inspector session, for as long as it
+// runs. Every rotation period, and when the environment is cleaned up, the
+// profile is written to disk as a gzipped pprof profile,
+// https://github.com/google/pprof/blob/main/proto/profile.proto. This is
+// meant to be left on in production at a low sampling rate, with the files
+// collected by an agent.
+class ContinuousProfiler {
+ public:
+  ContinuousProfiler(const ContinuousProfiler&) = delete;
+  ContinuousProfiler& operator=(const ContinuousProfiler&) = delete;
+
+ protected:
+  ContinuousProfiler(Environment* env,
+                     std::string directory,
+                     uint64_t rotation_ms);
+  virtual ~ContinuousProfiler() = default;
+
+  // Returns the directory to write the profiles to, creating it if needed,
+  // or an empty string if it could not be created.
+  static std::string EnsureDirectory(Environment* env,
+                                     const std::string& directory);
+
+  // Writes the profile so far, and starts the next one if restart is true.
+  virtual void Rotate(bool restart) = 0;
+  // Writes a serialized profile to a file named after prefix.
+  void WriteProfile(const char* prefix, const std::string& profile);
+
+  Environment* env() const { return env_; }
+
+ private:
+  static void OnTimer(uv_timer_t* timer);
+  static void Cleanup(void* data);
+
+  Environment* env_;
+  std::string directory_;
+  uv_timer_t timer_;
+};
+
+// Samples the environment's thread with v8::CpuProfiler. The next profile is
+// started before the previous one is stopped, so that no samples are missed.
+class ContinuousCpuProfiler final : public ContinuousProfiler {
+ public:
+  // Starts profiling env for its lifetime, with the options that it was
+  // started with.
+  static void Start(Environment* env);
+
+  // Returns profile in the pprof format, uncompressed. start_time_nanos is
+  // the wall clock time at which the profile was started.
+  static std::string Serialize(const v8::CpuProfile* profile,
+                               int64_t start_time_nanos,
+                               uint64_t sampling_interval_us);
+
+ private:
+  ContinuousCpuProfiler(Environment* env,
+                        std::string directory,
+                        uint64_t sampling_interval_us,
+                        uint64_t rotation_ms);
+  ~ContinuousCpuProfiler() override;
+
+  bool StartProfile();
+  void Rotate(bool restart) override;
+
+  uint64_t sampling_interval_us_;
+  v8::CpuProfiler* profiler_;
+  v8::ProfilerId profile_id_ = 0;
+  bool profiling_ = false;
+  int64_t start_time_nanos_ = 0;
+};
+
+// Samples the allocations of the environment's isolate with V8's sampling
+// heap profiler. Each profile has the sampled objects that are still alive,
+// or, if include_collected is set, all of the allocations sampled since the
+// previous profile.
+class ContinuousHeapProfiler final : public ContinuousProfiler {
+ public:
+  static void Start(Environment* env);
+
+  // Returns profile in the pprof format, uncompressed, with the alloc_
+  // sample types if include_collected is true and the inuse_ ones
+  // otherwise. The profile covers the duration_nanos before time_nanos.
+  static std::string Serialize(v8::Isolate* isolate,
+                               v8::AllocationProfile* profile,
+                               bool include_collected,
+                               int64_t time_nanos,
+                               int64_t duration_nanos,
+                               uint64_t sampling_interval);
+
+ private:
+  ContinuousHeapProfiler(Environment* env,
+                         std::string directory,
+                         uint64_t sampling_interval,
+                         bool include_collected,
+                         uint64_t rotation_ms);
+  ~ContinuousHeapProfiler() override;
+
+  bool StartSampling();
+  void Rotate(bool restart) override;
+
+  uint64_t sampling_interval_;
+  bool include_collected_;
+  bool sampling_ = false;
+  int64_t start_time_nanos_ = 0;
+};
+
+}  // namespace profiler
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CONTINUOUS_PROFILER_H_
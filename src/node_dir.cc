@@ -10,6 +10,7 @@
 #include "tracing/trace_event.h"
 
 #include "string_bytes.h"
+#include "threadpoolwork-inl.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
@@ -19,6 +20,9 @@
 #include <climits>
 
 #include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace node {
 
@@ -37,6 +41,7 @@ using v8::HandleScope;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
+using v8::LocalVector;
 using v8::MaybeLocal;
 using v8::Null;
 using v8::Number;
@@ -420,12 +425,227 @@ static void OpenDirSync(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(handle->object().As<Value>());
 }
 
+namespace {
+
+// Walks a directory tree for walk(), scanning up to kConcurrency directories
+// on the threadpool at a time. Returns the entries below the root as a flat
+// list of (path relative to the root, UV_DIRENT_* type) pairs, in no
+// particular order. Symbolic links are reported, not followed.
+class DirWalk {
+ public:
+  // Leaves threadpool threads for other requests.
+  static constexpr size_t kConcurrency = 3;
+
+  DirWalk(Environment* env,
+          BaseObjectPtr<FSReqBase> req_wrap,
+          std::string root,
+          std::unordered_set<std::string> exclude)
+      : env_(env),
+        req_wrap_(std::move(req_wrap)),
+        root_(std::move(root)),
+        exclude_(std::move(exclude)) {}
+
+  void Start() {
+    pending_.emplace_back();
+    Schedule();
+  }
+
+ private:
+  struct Entry {
+    std::string path;
+    int type;
+  };
+
+  class ScanWork final : public ThreadPoolWork {
+   public:
+    ScanWork(DirWalk* walk, std::string relative)
+        : ThreadPoolWork(walk->env_, "fs_dir.walk", Lane::kIo),
+          walk_(walk),
+          relative_(std::move(relative)) {}
+
+    void DoThreadPoolWork() override {
+      const std::string path = walk_->FullPath(relative_);
+      uv_fs_t req;
+      result_ = uv_fs_scandir(nullptr, &req, path.c_str(), 0, nullptr);
+      if (result_ < 0) {
+        uv_fs_req_cleanup(&req);
+        return;
+      }
+      uv_dirent_t ent;
+      while (uv_fs_scandir_next(&req, &ent) != UV_EOF) {
+        if (walk_->exclude_.count(ent.name) != 0) continue;
+        std::string child = relative_.empty()
+                                ? std::string(ent.name)
+                                : relative_ + kPathSeparator + ent.name;
+        int type = ent.type;
+        // Some file systems leave d_type unset.
+        if (type == UV_DIRENT_UNKNOWN) type = LstatType(walk_->FullPath(child));
+        entries_.push_back({std::move(child), type});
+      }
+      uv_fs_req_cleanup(&req);
+    }
+
+    void AfterThreadPoolWork(int status) override {
+      std::unique_ptr<ScanWork> self(this);
+      walk_->OnScanned(this, status);
+    }
+
+   private:
+    static int LstatType(const std::string& path) {
+      uv_fs_t req;
+      int type = UV_DIRENT_UNKNOWN;
+      if (uv_fs_lstat(nullptr, &req, path.c_str(), nullptr) == 0) {
+        const uint64_t mode = req.statbuf.st_mode & S_IFMT;
+        if (mode == S_IFDIR) {
+          type = UV_DIRENT_DIR;
+        } else if (mode == S_IFREG) {
+          type = UV_DIRENT_FILE;
+#ifdef S_IFLNK
+        } else if (mode == S_IFLNK) {
+          type = UV_DIRENT_LINK;
+#endif
+        }
+      }
+      uv_fs_req_cleanup(&req);
+      return type;
+    }
+
+    DirWalk* walk_;
+    std::string relative_;
+    int result_ = 0;
+    std::vector<Entry> entries_;
+
+    friend class DirWalk;
+  };
+
+  std::string FullPath(const std::string& relative) const {
+    return relative.empty() ? root_ : root_ + kPathSeparator + relative;
+  }
+
+  void Schedule() {
+    while (error_ == 0 && !pending_.empty() && in_flight_ < kConcurrency) {
+      (new ScanWork(this, std::move(pending_.back())))->ScheduleWork();
+      pending_.pop_back();
+      in_flight_++;
+    }
+  }
+
+  void OnScanned(ScanWork* work, int status) {
+    in_flight_--;
+    if (status == UV_ECANCELED || !env_->can_call_into_js()) {
+      if (in_flight_ == 0) delete this;
+      return;
+    }
+
+    // Directories that disappear during the walk are skipped, only the root
+    // has to exist.
+    if (work->result_ < 0 && error_ == 0 &&
+        !(work->result_ == UV_ENOENT && !work->relative_.empty())) {
+      error_ = work->result_;
+      error_path_ = FullPath(work->relative_);
+    }
+    if (error_ == 0) {
+      for (Entry& entry : work->entries_) {
+        if (entry.type == UV_DIRENT_DIR) pending_.push_back(entry.path);
+        entries_.push_back(std::move(entry));
+      }
+    }
+    Schedule();
+    if (in_flight_ == 0) Finish();
+  }
+
+  void Finish() {
+    std::unique_ptr<DirWalk> self(this);
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env_->context());
+
+    if (error_ != 0) {
+      return req_wrap_->Reject(UVException(
+          isolate, error_, "scandir", nullptr, error_path_.c_str()));
+    }
+
+    TryCatch try_catch(isolate);
+    LocalVector<Value> list(isolate);
+    list.reserve(entries_.size() * 2);
+    for (const Entry& entry : entries_) {
+      Local<Value> path;
+      if (!StringBytes::Encode(isolate,
+                               entry.path.data(),
+                               entry.path.size(),
+                               req_wrap_->encoding())
+               .ToLocal(&path)) {
+        CHECK(try_catch.CanContinue());
+        return req_wrap_->Reject(try_catch.Exception());
+      }
+      list.push_back(path);
+      list.push_back(Integer::New(isolate, entry.type));
+    }
+    req_wrap_->Resolve(Array::New(isolate, list.data(), list.size()));
+  }
+
+  Environment* env_;
+  BaseObjectPtr<FSReqBase> req_wrap_;
+  const std::string root_;
+  const std::unordered_set<std::string> exclude_;
+  std::vector<std::string> pending_;
+  size_t in_flight_ = 0;
+  std::vector<Entry> entries_;
+  int error_ = 0;
+  std::string error_path_;
+};
+
+}  // namespace
+
+// walk(path, encoding, exclude, req) lists a whole directory tree in one
+// request. Entries named in `exclude`, an array of names, are neither
+// returned nor descended into.
+static void Walk(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  CHECK_GE(args.Length(), 4);
+
+  BufferValue path(isolate, args[0]);
+  CHECK_NOT_NULL(*path);
+  ToNamespacedPath(env, &path);
+
+  const enum encoding encoding = ParseEncoding(isolate, args[1], UTF8);
+
+  std::unordered_set<std::string> exclude;
+  if (args[2]->IsArray()) {
+    Local<Array> names = args[2].As<Array>();
+    for (uint32_t i = 0; i < names->Length(); i++) {
+      Local<Value> name;
+      if (!names->Get(env->context(), i).ToLocal(&name)) return;
+      Utf8Value utf8_name(isolate, name);
+      exclude.emplace(utf8_name.ToStringView());
+    }
+  }
+
+  FSReqBase* req_wrap_async = GetReqWrap(args, 3);
+  CHECK_NOT_NULL(req_wrap_async);
+  ASYNC_THROW_IF_INSUFFICIENT_PERMISSIONS(
+      env,
+      req_wrap_async,
+      permission::PermissionScope::kFileSystemRead,
+      path.ToStringView());
+  req_wrap_async->Init("scandir", nullptr, 0, encoding);
+
+  (new DirWalk(env,
+               BaseObjectPtr<FSReqBase>(req_wrap_async),
+               std::string(path.ToStringView()),
+               std::move(exclude)))
+      ->Start();
+}
+
 void CreatePerIsolateProperties(IsolateData* isolate_data,
                                 Local<ObjectTemplate> target) {
   Isolate* isolate = isolate_data->isolate();
 
   SetMethod(isolate, target, "opendir", OpenDir);
   SetMethod(isolate, target, "opendirSync", OpenDirSync);
+  SetMethod(isolate, target, "walk", Walk);
 
   // Create FunctionTemplate for DirHandle
   Local<FunctionTemplate> dir = NewFunctionTemplate(isolate, DirHandle::New);
@@ -446,6 +666,7 @@ void CreatePerContextProperties(Local<Object> target,
 void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(OpenDir);
   registry->Register(OpenDirSync);
+  registry->Register(Walk);
   registry->Register(DirHandle::New);
   registry->Register(DirHandle::Read);
   registry->Register(DirHandle::Close);
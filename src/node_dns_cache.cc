@@ -0,0 +1,97 @@
+#include "node_dns_cache.h"
+#include "debug_utils-inl.h"
+#include "node_options.h"
+#include "util.h"
+#include "uv.h"
+
+namespace node {
+namespace cares_wrap {
+
+DnsCache* DnsCache::Get() {
+  static DnsCache* const cache = []() -> DnsCache* {
+    Mutex::ScopedLock lock(per_process::cli_options_mutex);
+    const PerProcessOptions* options = per_process::cli_options.get();
+    if (options->dns_cache_ttl == 0) return nullptr;
+    return new DnsCache(Options{options->dns_cache_ttl,
+                                options->dns_cache_negative_ttl,
+                                options->dns_cache_stale_ttl});
+  }();
+  return cache;
+}
+
+std::string DnsCache::Key(const std::string& hostname, int family, int flags) {
+  return SPrintF("%d %d %s", family, flags, hostname);
+}
+
+DnsCache::Lookup DnsCache::Find(const std::string& key,
+                                Result* result,
+                                uint64_t now_ms) {
+  Mutex::ScopedLock lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) return Lookup::kMiss;
+  Entry& entry = it->second;
+  if (now_ms < entry.expires_ms) {
+    *result = entry.result;
+    return Lookup::kHit;
+  }
+  if (entry.result.status != 0 ||
+      now_ms - entry.expires_ms >= options_.stale_ttl_ms) {
+    entries_.erase(it);
+    return Lookup::kMiss;
+  }
+  *result = entry.result;
+  if (entry.refreshing) return Lookup::kHit;
+  entry.refreshing = true;
+  return Lookup::kRefresh;
+}
+
+void DnsCache::Store(const std::string& key,
+                     const Result& result,
+                     uint64_t now_ms) {
+  const bool negative =
+      result.status == UV_EAI_NONAME || result.status == UV_EAI_NODATA;
+  Mutex::ScopedLock lock(mutex_);
+  if (result.status != 0 && !negative) {
+    // Keep serving what we had, if anything, and let a later lookup retry.
+    auto it = entries_.find(key);
+    if (it != entries_.end()) it->second.refreshing = false;
+    return;
+  }
+  const uint64_t ttl_ms = negative ? options_.negative_ttl_ms : options_.ttl_ms;
+  if (ttl_ms == 0) {
+    entries_.erase(key);
+    return;
+  }
+  if (entries_.size() >= kMaxEntries && entries_.count(key) == 0) {
+    Evict(now_ms);
+  }
+  entries_[key] = Entry{result, now_ms + ttl_ms};
+}
+
+size_t DnsCache::size() {
+  Mutex::ScopedLock lock(mutex_);
+  return entries_.size();
+}
+
+void DnsCache::Evict(uint64_t now_ms) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    const Entry& entry = it->second;
+    const uint64_t stale_ms =
+        entry.result.status == 0 ? options_.stale_ttl_ms : 0;
+    if (now_ms >= entry.expires_ms + stale_ms) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  while (entries_.size() >= kMaxEntries) {
+    auto soonest = entries_.begin();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->second.expires_ms < soonest->second.expires_ms) soonest = it;
+    }
+    entries_.erase(soonest);
+  }
+}
+
+}  // namespace cares_wrap
+}  // namespace node
@@ -0,0 +1,88 @@
+#ifndef SRC_NODE_DNS_CACHE_H_
+#define SRC_NODE_DNS_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "node_mutex.h"
+
+namespace node {
+namespace cares_wrap {
+
+// A process-wide cache of getaddrinfo() results for dns.lookup(), shared by
+// the main thread and all workers, enabled with --dns-cache-ttl.
+// getaddrinfo() does not report record TTLs, so successful lookups are kept
+// for --dns-cache-ttl milliseconds, failed ones (the name or its addresses
+// do not exist) for --dns-cache-negative-ttl. An expired entry is still
+// returned for --dns-cache-stale-ttl more milliseconds, while one caller
+// refreshes it in the background; a refresh that fails with anything but a
+// negative answer keeps the stale entry.
+class DnsCache {
+ public:
+  struct Address {
+    int family;  // AF_INET or AF_INET6.
+    std::string ip;
+  };
+
+  struct Result {
+    int status = 0;
+    std::vector<Address> addresses;
+  };
+
+  enum class Lookup {
+    kMiss,
+    kHit,
+    // A stale hit. The caller is expected to refresh the entry and Store()
+    // the new result; other callers get kHit until it does.
+    kRefresh,
+  };
+
+  struct Options {
+    uint64_t ttl_ms;
+    uint64_t negative_ttl_ms;
+    uint64_t stale_ttl_ms;
+  };
+
+  // At most this many hostnames are cached. When full, expired entries are
+  // dropped first, then the ones that expire soonest.
+  static constexpr size_t kMaxEntries = 4096;
+
+  // Returns the process' cache, or nullptr if --dns-cache-ttl is not set.
+  static DnsCache* Get();
+
+  explicit DnsCache(const Options& options) : options_(options) {}
+  DnsCache(const DnsCache&) = delete;
+  DnsCache& operator=(const DnsCache&) = delete;
+
+  // The cache key of a lookup; the hostname must already be in ASCII.
+  static std::string Key(const std::string& hostname, int family, int flags);
+
+  Lookup Find(const std::string& key, Result* result, uint64_t now_ms);
+  // Caches result, unless it is a transient failure.
+  void Store(const std::string& key, const Result& result, uint64_t now_ms);
+  size_t size();
+
+ private:
+  struct Entry {
+    Result result;
+    uint64_t expires_ms;
+    bool refreshing = false;
+  };
+
+  void Evict(uint64_t now_ms);
+
+  const Options options_;
+  Mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace cares_wrap
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_DNS_CACHE_H_
@@ -10,6 +10,7 @@
 #include "node_process-inl.h"
 #include "node_report.h"
 #include "node_v8_platform-inl.h"
+#include "stream_wrap.h"
 #include "util-inl.h"
 
 namespace node {
@@ -229,10 +230,9 @@ MaybeLocal<StackTrace> GetCurrentStackTrace(Isolate* isolate, int frame_count) {
   return scope.Escape(stack);
 }
 
-static std::string FormatStackTrace(
-    Isolate* isolate,
-    Local<StackTrace> stack,
-    StackTracePrefix prefix = StackTracePrefix::kAt) {
+std::string FormatStackTrace(Isolate* isolate,
+                             Local<StackTrace> stack,
+                             StackTracePrefix prefix) {
   std::string result;
   for (int i = 0; i < stack->GetFrameCount(); i++) {
     Local<StackFrame> stack_frame = stack->GetFrame(isolate, i);
@@ -589,6 +589,12 @@ static void ReportFatalException(Environment* env,
     TriggerNodeReport(isolate, message, "FatalError", "", Local<Object>());
   }
 
+  if (isolate != nullptr && isolate->InContext()) {
+    HandleScope handle_scope(isolate);
+    Environment* env = Environment::GetCurrent(isolate);
+    if (env != nullptr) LibuvStreamWrap::FlushAllCoalescedWrites(env);
+  }
+
   fflush(stderr);
   ABORT();
 }
@@ -61,6 +61,7 @@ class ExternalReferenceRegistry {
 };
 
 #define EXTERNAL_REFERENCE_BINDING_LIST_BASE(V)                                \
+  V(async_context_frame)                                                       \
   V(async_wrap)                                                                \
   V(binding)                                                                   \
   V(blob)                                                                      \
@@ -80,6 +81,7 @@ class ExternalReferenceRegistry {
   V(heap_utils)                                                                \
   V(http_parser)                                                               \
   V(internal_only_v8)                                                          \
+  V(json)                                                                      \
   V(locks)                                                                     \
   V(messaging)                                                                 \
   V(mksnapshot)                                                                \
@@ -4,6 +4,7 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include "node_file.h"
+#include "node_usdt.h"
 #include "req_wrap-inl.h"
 
 namespace node {
@@ -216,9 +217,33 @@ FSReqPromise<AliasedBufferT>::FSReqPromise(BindingData* binding_data,
           env()->isolate(),
           static_cast<size_t>(FsStatFsOffset::kFsStatFsFieldsNumber)) {}
 
+template <typename AliasedBufferT>
+bool FSReqPromise<AliasedBufferT>::MaybeDeferSettlement(
+    v8::Local<v8::Value> value, bool reject) {
+  // Inside a callback scope the checkpoint already happens once, at its end.
+  if (!env()->options()->batch_fs_promises ||
+      env()->async_callback_scope_depth() > 0 || !env()->can_call_into_js()) {
+    return false;
+  }
+  env()->SetImmediate(
+      [self = BaseObjectPtr<FSReqPromise>(this),
+       value = v8::Global<v8::Value>(env()->isolate(), value),
+       reject](Environment* env) {
+        v8::HandleScope handle_scope(env->isolate());
+        v8::Local<v8::Value> local = value.Get(env->isolate());
+        if (reject) {
+          self->Reject(local);
+        } else {
+          self->Resolve(local);
+        }
+      });
+  return true;
+}
+
 template <typename AliasedBufferT>
 void FSReqPromise<AliasedBufferT>::Reject(v8::Local<v8::Value> reject) {
   finished_ = true;
+  if (MaybeDeferSettlement(reject, true)) return;
   v8::HandleScope scope(env()->isolate());
   InternalCallbackScope callback_scope(this);
   v8::Local<v8::Value> value;
@@ -237,6 +262,7 @@ void FSReqPromise<AliasedBufferT>::Reject(v8::Local<v8::Value> reject) {
 template <typename AliasedBufferT>
 void FSReqPromise<AliasedBufferT>::Resolve(v8::Local<v8::Value> value) {
   finished_ = true;
+  if (MaybeDeferSettlement(value, false)) return;
   v8::HandleScope scope(env()->isolate());
   InternalCallbackScope callback_scope(this);
   v8::Local<v8::Value> val;
@@ -319,6 +345,7 @@ FSReqBase* AsyncDestCall(Environment* env, FSReqBase* req_wrap,
                          Func fn, Args... fn_args) {
   CHECK_NOT_NULL(req_wrap);
   req_wrap->Init(syscall, dest, len, enc);
+  NODE_USDT2(fs__start, req_wrap, syscall);
   int err = req_wrap->Dispatch(fn, fn_args..., after);
   if (err < 0) {
     uv_fs_t* uv_req = req_wrap->req();
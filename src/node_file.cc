@@ -22,6 +22,7 @@
 #include "ada.h"
 #include "aliased_buffer-inl.h"
 #include "memory_tracker-inl.h"
+#include "module_stat_cache.h"
 #include "node_buffer.h"
 #include "node_debug.h"
 #include "node_errors.h"
@@ -33,6 +34,7 @@
 #include "node_url.h"
 #include "path.h"
 #include "permission/permission.h"
+#include "simdutf.h"
 #include "util-inl.h"
 
 #include "tracing/trace_event.h"
@@ -55,6 +57,8 @@
 #ifdef _WIN32
 #include <windows.h>
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -63,6 +67,7 @@ namespace node {
 namespace fs {
 
 using v8::Array;
+using v8::ArrayBuffer;
 using v8::BigInt;
 using v8::Context;
 using v8::EscapableHandleScope;
@@ -70,6 +75,7 @@ using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Int32;
+using v8::Int32Array;
 using v8::Integer;
 using v8::Isolate;
 using v8::JustVoid;
@@ -91,6 +97,10 @@ using v8::Value;
 # define S_ISDIR(mode)  (((mode) & S_IFMT) == S_IFDIR)
 #endif
 
+#ifndef S_ISREG
+# define S_ISREG(mode)  (((mode) & S_IFMT) == S_IFREG)
+#endif
+
 #ifdef __POSIX__
 constexpr char kPathSeparator = '/';
 #else
@@ -596,77 +606,150 @@ int FileHandle::ReadStart() {
       read_wrap = MakeDetachedBaseObject<FileHandleReadWrap>(this, wrap_obj);
     }
   }
-  int64_t recommended_read = 65536;
+  int64_t recommended_read =
+      sequential_read_ ? sequential_chunk_size_ : kDefaultReadChunkSize;
+  int sendfile_fd = -1;
+#ifndef _WIN32
+  if (sendfile_target_ != -1 && read_offset_ >= 0 && !sendfile_fallback_) {
+    sendfile_fd = dup(sendfile_target_);
+    if (sendfile_fd != -1) recommended_read = kSendfileChunkSize;
+  }
+#endif
   if (read_length_ >= 0 && read_length_ <= recommended_read)
     recommended_read = read_length_;
 
-  read_wrap->buffer_ = EmitAlloc(recommended_read);
-
   current_read_ = std::move(read_wrap);
-  FS_ASYNC_TRACE_BEGIN0(UV_FS_READ, current_read_.get())
-  current_read_->Dispatch(uv_fs_read,
-                          fd_,
-                          &current_read_->buffer_,
-                          1,
-                          read_offset_,
-                          uv_fs_callback_t{[](uv_fs_t* req) {
-    FileHandle* handle;
-    {
-      FileHandleReadWrap* req_wrap = FileHandleReadWrap::from_req(req);
-      FS_ASYNC_TRACE_END1(
-          req->fs_type, req_wrap, "result", static_cast<int>(req->result))
-      handle = req_wrap->file_handle_;
-      CHECK_EQ(handle->current_read_.get(), req_wrap);
-    }
-
-    // ReadStart() checks whether current_read_ is set to determine whether
-    // a read is in progress. Moving it into a local variable makes sure that
-    // the ReadStart() call below doesn't think we're still actively reading.
-    BaseObjectPtr<FileHandleReadWrap> read_wrap =
-        std::move(handle->current_read_);
-
-    ssize_t result = req->result;
-    uv_buf_t buffer = read_wrap->buffer_;
+  current_read_->sendfile_fd_ = sendfile_fd;
+  if (sendfile_fd != -1) {
+    current_read_->buffer_ = uv_buf_init(nullptr, 0);
+    FS_ASYNC_TRACE_BEGIN0(UV_FS_SENDFILE, current_read_.get())
+    current_read_->Dispatch(uv_fs_sendfile,
+                            sendfile_fd,
+                            fd_,
+                            read_offset_,
+                            static_cast<size_t>(recommended_read),
+                            uv_fs_callback_t{AfterRead});
+  } else {
+    current_read_->buffer_ = EmitAlloc(recommended_read);
+    FS_ASYNC_TRACE_BEGIN0(UV_FS_READ, current_read_.get())
+    current_read_->Dispatch(uv_fs_read,
+                            fd_,
+                            &current_read_->buffer_,
+                            1,
+                            read_offset_,
+                            uv_fs_callback_t{AfterRead});
+  }
 
-    uv_fs_req_cleanup(req);
+  return 0;
+}
 
-    // Push the read wrap back to the freelist, or let it be destroyed
-    // once we’re exiting the current scope.
-    constexpr size_t kWantedFreelistFill = 100;
-    auto& freelist = handle->binding_data_->file_handle_read_wrap_freelist;
-    if (freelist.size() < kWantedFreelistFill) {
-      read_wrap->Reset();
-      freelist.emplace_back(std::move(read_wrap));
-    }
+void FileHandle::AfterRead(uv_fs_t* req) {
+  FileHandle* handle;
+  {
+    FileHandleReadWrap* req_wrap = FileHandleReadWrap::from_req(req);
+    FS_ASYNC_TRACE_END1(
+        req->fs_type, req_wrap, "result", static_cast<int>(req->result))
+    handle = req_wrap->file_handle_;
+    CHECK_EQ(handle->current_read_.get(), req_wrap);
+  }
 
-    if (result >= 0) {
-      // Read at most as many bytes as we originally planned to.
-      if (handle->read_length_ >= 0 && handle->read_length_ < result)
-        result = handle->read_length_;
+  // ReadStart() checks whether current_read_ is set to determine whether
+  // a read is in progress. Moving it into a local variable makes sure that
+  // the ReadStart() call below doesn't think we're still actively reading.
+  BaseObjectPtr<FileHandleReadWrap> read_wrap =
+      std::move(handle->current_read_);
 
-      // If we read data and we have an expected length, decrease it by
-      // how much we have read.
-      if (handle->read_length_ >= 0)
-        handle->read_length_ -= result;
+  ssize_t result = req->result;
+  uv_buf_t buffer = read_wrap->buffer_;
+  const bool was_sendfile = read_wrap->sendfile_fd_ != -1;
 
-      // If we have an offset, increase it by how much we have read.
-      if (handle->read_offset_ >= 0)
-        handle->read_offset_ += result;
-    }
+  uv_fs_req_cleanup(req);
 
-    // Reading 0 bytes from a file always means EOF, or that we reached
-    // the end of the requested range.
-    if (result == 0)
-      result = UV_EOF;
+  if (was_sendfile) {
+    uv_fs_t close_req;
+    uv_fs_close(nullptr, &close_req, read_wrap->sendfile_fd_, nullptr);
+    uv_fs_req_cleanup(&close_req);
+    read_wrap->sendfile_fd_ = -1;
+  }
 
-    handle->EmitRead(result, buffer);
+  // Push the read wrap back to the freelist, or let it be destroyed
+  // once we’re exiting the current scope.
+  constexpr size_t kWantedFreelistFill = 100;
+  auto& freelist = handle->binding_data_->file_handle_read_wrap_freelist;
+  if (freelist.size() < kWantedFreelistFill) {
+    read_wrap->Reset();
+    freelist.emplace_back(std::move(read_wrap));
+  }
 
-    // Start over, if EmitRead() didn’t tell us to stop.
-    if (handle->reading_)
-      handle->ReadStart();
-  }});
+  // The socket buffer is full. Read the next chunk into memory instead and
+  // let the stream queue it until the socket becomes writable again.
+  if (was_sendfile && result == UV_EAGAIN) {
+    handle->sendfile_fallback_ = true;
+    if (handle->reading_) handle->ReadStart();
+    return;
+  }
+  handle->sendfile_fallback_ = false;
 
-  return 0;
+  // A read that came back full suggests there is plenty more to come.
+  if (handle->sequential_read_ && !was_sendfile &&
+      result >= handle->sequential_chunk_size_) {
+    handle->sequential_chunk_size_ = std::min(
+        handle->sequential_chunk_size_ * 2, kMaxSequentialChunkSize);
+  }
+
+  if (result >= 0) {
+    // Read at most as many bytes as we originally planned to.
+    if (handle->read_length_ >= 0 && handle->read_length_ < result)
+      result = handle->read_length_;
+
+    // If we read data and we have an expected length, decrease it by
+    // how much we have read.
+    if (handle->read_length_ >= 0)
+      handle->read_length_ -= result;
+
+    // If we have an offset, increase it by how much we have read.
+    if (handle->read_offset_ >= 0)
+      handle->read_offset_ += result;
+  }
+
+  // Reading 0 bytes from a file always means EOF, or that we reached
+  // the end of the requested range.
+  if (result == 0)
+    result = UV_EOF;
+
+  handle->EmitRead(result, buffer);
+
+  // Start over, if EmitRead() didn’t tell us to stop.
+  if (handle->reading_)
+    handle->ReadStart();
+}
+
+void FileHandle::SetSendfileTarget(int fd) {
+  sendfile_target_ = fd;
+}
+
+// setSequentialRead(enable)
+void FileHandle::SetSequentialRead(const FunctionCallbackInfo<Value>& args) {
+  FileHandle* handle;
+  ASSIGN_OR_RETURN_UNWRAP(&handle, args.This());
+  const bool enable = args[0]->IsTrue();
+  handle->sequential_read_ = enable;
+  handle->sequential_chunk_size_ = kDefaultReadChunkSize;
+
+  int err = 0;
+#if defined(POSIX_FADV_SEQUENTIAL)
+  // Doubles the readahead window on Linux, so that the device has the next
+  // chunks queued while the current one is handed out.
+  err = posix_fadvise(handle->fd_,
+                      0,
+                      0,
+                      enable ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_NORMAL);
+  if (err != 0) err = uv_translate_sys_error(err);
+#elif defined(__APPLE__)
+  if (fcntl(handle->fd_, F_RDAHEAD, enable ? 1 : 0) == -1)
+    err = uv_translate_sys_error(errno);
+#endif
+  args.GetReturnValue().Set(err);
 }
 
 int FileHandle::ReadStop() {
@@ -744,6 +827,7 @@ FSReqAfterScope::FSReqAfterScope(FSReqBase* wrap, uv_fs_t* req)
       handle_scope_(wrap->env()->isolate()),
       context_scope_(wrap->env()->context()) {
   CHECK_EQ(wrap_->req(), req);
+  NODE_USDT2(fs__done, wrap, static_cast<int64_t>(req->result));
 }
 
 FSReqAfterScope::~FSReqAfterScope() {
@@ -1073,17 +1157,56 @@ static void InternalModuleStat(const FunctionCallbackInfo<Value>& args) {
   CHECK_NOT_NULL(*path);
   ToNamespacedPath(env, &path);
 
-  uv_fs_t req;
-  int rc = uv_fs_stat(env->event_loop(), &req, *path, nullptr);
-  if (rc == 0) {
-    const uv_stat_t* const s = static_cast<const uv_stat_t*>(req.ptr);
-    rc = S_ISDIR(s->st_mode);
+  int rc;
+  if (env->options()->module_stat_cache) {
+    rc = ModuleStatCache::GetPerProcess()->Stat(
+        env->event_loop(), std::string(path.ToStringView()));
+  } else {
+    rc = InternalModuleStatUncached(env->event_loop(), *path);
   }
-  uv_fs_req_cleanup(&req);
 
   args.GetReturnValue().Set(rc);
 }
 
+// internalModuleStatBatch(paths) returns an Int32Array with what
+// internalModuleStat() would have returned for each path, in order. Meant
+// for the set of candidates tried for one specifier.
+static void InternalModuleStatBatch(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  CHECK_EQ(args.Length(), 1);
+  CHECK(args[0]->IsArray());
+  Local<Array> list = args[0].As<Array>();
+  const uint32_t count = list->Length();
+
+  std::vector<std::string> paths;
+  paths.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> value;
+    if (!list->Get(env->context(), i).ToLocal(&value)) return;
+    CHECK(value->IsString());
+    BufferValue path(isolate, value);
+    CHECK_NOT_NULL(*path);
+    ToNamespacedPath(env, &path);
+    paths.emplace_back(path.ToStringView());
+  }
+
+  Local<ArrayBuffer> ab = ArrayBuffer::New(isolate, count * sizeof(int32_t));
+  int32_t* results = static_cast<int32_t*>(ab->Data());
+  if (env->options()->module_stat_cache) {
+    ModuleStatCache::GetPerProcess()->StatBatch(
+        env->event_loop(), paths, results);
+  } else {
+    for (uint32_t i = 0; i < count; i++) {
+      results[i] =
+          InternalModuleStatUncached(env->event_loop(), paths[i].c_str());
+    }
+  }
+
+  args.GetReturnValue().Set(Int32Array::New(ab, 0, count));
+}
+
 constexpr bool is_uv_error_except_no_entry(int result) {
   return result < 0 && result != UV_ENOENT;
 }
@@ -2682,6 +2805,55 @@ static void Read(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+#ifdef __POSIX__
+namespace {
+// The contents of a read-only file mapping as a one-byte string. Unmaps it
+// when V8 collects the string.
+class MappedOneByteString : public String::ExternalOneByteStringResource {
+ public:
+  MappedOneByteString(void* data, size_t length)
+      : data_(data), length_(length) {}
+  ~MappedOneByteString() override { munmap(data_, length_); }
+
+  const char* data() const override { return static_cast<char*>(data_); }
+  size_t length() const override { return length_; }
+
+ private:
+  void* data_;
+  size_t length_;
+};
+}  // namespace
+
+// With --mmap-read-file-threshold, decodes a large regular file straight
+// from a mapping of it. Pure ASCII content, common for JSON and bundled
+// code, becomes an external string that keeps the mapping, the rest is
+// copied out once. Returns false if the file could not be mapped.
+static bool ReadFileUtf8Mapped(Isolate* isolate,
+                               uv_file file,
+                               size_t size,
+                               Local<Value>* result) {
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+  if (data == MAP_FAILED) return false;
+  const char* chars = static_cast<const char*>(data);
+
+  Local<String> str;
+  if (simdutf::validate_ascii(chars, size)) {
+    auto* resource = new MappedOneByteString(data, size);
+    if (!String::NewExternalOneByte(isolate, resource).ToLocal(&str)) {
+      delete resource;
+      return true;
+    }
+  } else {
+    MaybeLocal<String> maybe_str = String::NewFromUtf8(
+        isolate, chars, v8::NewStringType::kNormal, static_cast<int>(size));
+    munmap(data, size);
+    if (!maybe_str.ToLocal(&str)) return true;
+  }
+  *result = str;
+  return true;
+}
+#endif  // __POSIX__
+
 static void ReadFileUtf8(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   auto isolate = env->isolate();
@@ -2725,12 +2897,42 @@ static void ReadFileUtf8(const FunctionCallbackInfo<Value>& args) {
     uv_fs_req_cleanup(&req);
   });
 
+  // The size of a regular file lets the contents be read in one go, with
+  // room for the read that sees EOF.
+  size_t size_hint = 0;
+  uv_fs_t stat_req;
+  if (uv_fs_fstat(nullptr, &stat_req, file, nullptr) == 0) {
+    const uv_stat_t* const s = static_cast<const uv_stat_t*>(stat_req.ptr);
+    if (S_ISREG(s->st_mode)) size_hint = s->st_size;
+  }
+  uv_fs_req_cleanup(&stat_req);
+
+#ifdef __POSIX__
+  // Only a path is known to be read from its start.
+  const uint64_t mmap_threshold = env->options()->mmap_read_file_threshold;
+  if (!is_fd && mmap_threshold > 0 && size_hint >= mmap_threshold &&
+      size_hint <= static_cast<size_t>(String::kMaxLength)) {
+    Local<Value> val;
+    if (ReadFileUtf8Mapped(isolate, file, size_hint, &val)) {
+      if (!val.IsEmpty()) args.GetReturnValue().Set(val);
+      return;
+    }
+  }
+#endif  // __POSIX__
+
+  constexpr size_t kReadChunk = 8192;
   std::string result{};
-  char buffer[8192];
-  uv_buf_t buf = uv_buf_init(buffer, sizeof(buffer));
+  size_t length = 0;
 
   FS_SYNC_TRACE_BEGIN(read);
   while (true) {
+    if (length == result.size()) {
+      result.resize(length + std::max(kReadChunk, size_hint + 1 - length));
+    }
+    uv_buf_t buf = uv_buf_init(
+        result.data() + length,
+        static_cast<unsigned int>(std::min<size_t>(
+            result.size() - length, std::numeric_limits<int>::max())));
     auto r = uv_fs_read(nullptr, &req, file, &buf, 1, -1, nullptr);
     if (req.result < 0) {
       FS_SYNC_TRACE_END(read);
@@ -2741,9 +2943,10 @@ static void ReadFileUtf8(const FunctionCallbackInfo<Value>& args) {
     if (r <= 0) {
       break;
     }
-    result.append(buf.base, r);
+    length += r;
   }
   FS_SYNC_TRACE_END(read);
+  result.resize(length);
 
   Local<Value> val;
   if (!ToV8Value(env->context(), result, isolate).ToLocal(&val)) {
@@ -3897,6 +4100,8 @@ static void CreatePerIsolateProperties(IsolateData* isolate_data,
   SetMethod(isolate, target, "mkdir", MKDir);
   SetMethod(isolate, target, "readdir", ReadDir);
   SetMethod(isolate, target, "internalModuleStat", InternalModuleStat);
+  SetMethod(
+      isolate, target, "internalModuleStatBatch", InternalModuleStatBatch);
   SetMethod(isolate, target, "stat", Stat);
   SetMethod(isolate, target, "lstat", LStat);
   SetMethod(isolate, target, "fstat", FStat);
@@ -3970,6 +4175,8 @@ static void CreatePerIsolateProperties(IsolateData* isolate_data,
   fd->Inherit(AsyncWrap::GetConstructorTemplate(isolate_data));
   SetProtoMethod(isolate, fd, "close", FileHandle::Close);
   SetProtoMethod(isolate, fd, "releaseFD", FileHandle::ReleaseFD);
+  SetProtoMethod(
+      isolate, fd, "setSequentialRead", FileHandle::SetSequentialRead);
   Local<ObjectTemplate> fdt = fd->InstanceTemplate();
   fdt->SetInternalFieldCount(FileHandle::kInternalFieldCount);
   StreamBase::AddMethods(isolate_data, fd);
@@ -4022,6 +4229,7 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(MKDir);
   registry->Register(ReadDir);
   registry->Register(InternalModuleStat);
+  registry->Register(InternalModuleStatBatch);
   registry->Register(Stat);
   registry->Register(LStat);
   registry->Register(FStat);
@@ -4058,6 +4266,7 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(FileHandle::New);
   registry->Register(FileHandle::Close);
   registry->Register(FileHandle::ReleaseFD);
+  registry->Register(FileHandle::SetSequentialRead);
   StreamBase::RegisterExternalReferences(registry);
 }
 
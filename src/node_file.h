@@ -214,6 +214,7 @@ class FSReqCallback final : public FSReqBase {
 
   SET_MEMORY_INFO_NAME(FSReqCallback)
   SET_SELF_SIZE(FSReqCallback)
+  NODE_POOLED_ALLOCATION(FSReqCallback)
 
   FSReqCallback(const FSReqCallback&) = delete;
   FSReqCallback& operator=(const FSReqCallback&) = delete;
@@ -265,6 +266,13 @@ class FSReqPromise final : public FSReqBase {
                       v8::Local<v8::Object> obj,
                       bool use_bigint);
 
+  // With --batch-fs-promises, settlements that happen directly from the
+  // event loop are queued as native immediates instead. All of them then run
+  // inside the single InternalCallbackScope of RunAndClearNativeImmediates(),
+  // so a loop iteration that completes many requests performs one microtask
+  // checkpoint and one processTicksAndRejections() call, not one per request.
+  inline bool MaybeDeferSettlement(v8::Local<v8::Value> value, bool reject);
+
   bool finished_ = false;
   AliasedBufferT stats_field_array_;
   AliasedBufferT statfs_field_array_;
@@ -312,6 +320,8 @@ class FileHandleReadWrap final : public ReqWrap<uv_fs_t> {
  private:
   FileHandle* file_handle_;
   uv_buf_t buffer_;
+  // A dup() of the sendfile target while a uv_fs_sendfile() is in flight.
+  int sendfile_fd_ = -1;
 
   friend class FileHandle;
 };
@@ -351,6 +361,20 @@ class FileHandle final : public AsyncWrap, public StreamBase {
   int ReadStart() override;
   int ReadStop() override;
 
+  // Makes ReadStart() copy data straight to `fd`, a non-blocking socket or
+  // pipe, with uv_fs_sendfile() instead of reading it into memory. Such reads
+  // reach the stream listener with a null buffer. When the socket cannot take
+  // more data, the next chunk is read into memory as usual. This only applies
+  // to handles read from an explicit offset. Pass -1 to stop. The caller must
+  // update or clear the target before `fd` is closed.
+  void SetSendfileTarget(int fd);
+
+  // In sequential mode the kernel is told to read ahead aggressively, and
+  // reads grow from 64 KiB up to kMaxSequentialChunkSize for as long as the
+  // file keeps filling them.
+  static void SetSequentialRead(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+
   bool IsAlive() override { return !closed_; }
   bool IsClosing() override { return closing_; }
   AsyncWrap* GetAsyncWrap() override { return this; }
@@ -441,6 +465,13 @@ class FileHandle final : public AsyncWrap, public StreamBase {
   // Asynchronous close
   v8::MaybeLocal<v8::Promise> ClosePromise();
 
+  static void AfterRead(uv_fs_t* req);
+
+  // Sending straight to a socket costs no memory, so use larger chunks.
+  static constexpr int64_t kSendfileChunkSize = 1024 * 1024;
+  static constexpr int64_t kDefaultReadChunkSize = 64 * 1024;
+  static constexpr int64_t kMaxSequentialChunkSize = 2 * 1024 * 1024;
+
   std::string original_name_;
   int fd_;
   bool closing_ = false;
@@ -448,6 +479,10 @@ class FileHandle final : public AsyncWrap, public StreamBase {
   bool reading_ = false;
   int64_t read_offset_ = -1;
   int64_t read_length_ = -1;
+  int sendfile_target_ = -1;
+  bool sendfile_fallback_ = false;
+  bool sequential_read_ = false;
+  int64_t sequential_chunk_size_ = kDefaultReadChunkSize;
 
   BaseObjectPtr<FileHandleReadWrap> current_read_;
 
@@ -34,6 +34,7 @@ using v8::EscapableHandleScope;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::Global;
 using v8::HandleScope;
 using v8::Integer;
 using v8::Isolate;
@@ -224,6 +225,13 @@ Http2Options::Http2Options(Http2State* http2_state, SessionType type) {
         static_cast<uint64_t>(buffer[IDX_OPTIONS_STREAM_RESET_BURST]),
         static_cast<uint64_t>(buffer[IDX_OPTIONS_STREAM_RESET_RATE]));
   }
+
+  // Opt-in auto-tuning of the local flow-control windows. The value is the
+  // largest window the session may grow to on its own.
+  if (flags & (1 << IDX_OPTIONS_MAX_AUTO_WINDOW_SIZE)) {
+    set_max_auto_window_size(std::min<uint32_t>(
+        buffer[IDX_OPTIONS_MAX_AUTO_WINDOW_SIZE], NGHTTP2_MAX_WINDOW_SIZE));
+  }
 }
 
 #define GRABSETTING(entries, count, name)                                      \
@@ -581,6 +589,7 @@ Http2Session::Http2Session(Http2State* http2_state,
 
   max_outstanding_pings_ = opts.max_outstanding_pings();
   max_outstanding_settings_ = opts.max_outstanding_settings();
+  max_auto_window_size_ = opts.max_auto_window_size();
 
   local_custom_settings_.number = 0;
   remote_custom_settings_.number = 0;
@@ -629,6 +638,7 @@ Http2Session::~Http2Session() {
     stream->Detach();
   }
   streams_.clear();
+  ClearHeaderStrings();
   // Explicitly reset session_ so the subsequent
   // current_nghttp2_memory_ check passes.
   session_.reset();
@@ -1339,6 +1349,8 @@ int Http2Session::OnDataChunkReceived(nghttp2_session* handle,
   // so that it can send a WINDOW_UPDATE frame. This is a critical part of
   // the flow control process in http2
   CHECK_EQ(nghttp2_session_consume_connection(handle, len), 0);
+  if (session->max_auto_window_size_ != 0)
+    session->SampleBdp(len);
   BaseObjectPtr<Http2Stream> stream = session->FindStream(id);
 
   // If the stream has been destroyed, ignore this chunk
@@ -1517,8 +1529,18 @@ void Http2Session::HandleHeadersFrame(const nghttp2_frame* frame) {
   size_t sensitive_count = 0;
 
   stream->TransferHeaders([&](const Http2Header& header, size_t i) {
-    headers_v[i * 2] = header.GetName(this).ToLocalChecked();
-    headers_v[i * 2 + 1] = header.GetValue(this).ToLocalChecked();
+    headers_v[i * 2] = GetHeaderString(
+        header.name_buf(),
+        [](Http2Session* session, const Http2Header& header) {
+          return header.GetName(session).ToLocalChecked();
+        },
+        header);
+    headers_v[i * 2 + 1] = GetHeaderString(
+        header.value_buf(),
+        [](Http2Session* session, const Http2Header& header) {
+          return header.GetValue(session).ToLocalChecked();
+        },
+        header);
     if (header.flags() & NGHTTP2_NV_FLAG_NO_INDEX)
       sensitive_v[sensitive_count++] = headers_v[i * 2];
   });
@@ -1668,6 +1690,44 @@ void Http2Session::HandleOriginFrame(const nghttp2_frame* frame) {
   MakeCallback(env()->http2session_on_origin_function(), 1, &holder);
 }
 
+// Returns the string for a decoded header name or value, reusing the one
+// created the last time nghttp2 handed out the same buffer. Static table
+// entries are already shared through the isolate's static_str_map.
+Local<String> Http2Session::GetHeaderString(
+    nghttp2_rcbuf* buf,
+    Local<String> (*create)(Http2Session* session, const Http2Header& header),
+    const Http2Header& header) {
+  Isolate* isolate = env()->isolate();
+  if (buf == nullptr || nghttp2_rcbuf_is_static(buf) ||
+      nghttp2_rcbuf_get_buf(buf).len > kMaxCachedHeaderLength) {
+    return create(this, header);
+  }
+
+  auto it = header_strings_.find(buf);
+  if (it != header_strings_.end())
+    return it->second.Get(isolate);
+
+  Local<String> str = create(this, header);
+  nghttp2_rcbuf*& seen =
+      header_seen_[(reinterpret_cast<uintptr_t>(buf) >> 4) % kHeaderSeenSlots];
+  if (seen != buf) {
+    seen = buf;
+    return str;
+  }
+
+  if (header_strings_.size() == kHeaderStringCacheSize)
+    ClearHeaderStrings();
+  nghttp2_rcbuf_incref(buf);
+  header_strings_.emplace(buf, Global<String>(isolate, str));
+  return str;
+}
+
+void Http2Session::ClearHeaderStrings() {
+  for (auto& [buf, str] : header_strings_)
+    nghttp2_rcbuf_decref(buf);
+  header_strings_.clear();
+}
+
 // Called by OnFrameReceived when a complete PING frame has been received.
 void Http2Session::HandlePingFrame(const nghttp2_frame* frame) {
   Isolate* isolate = env()->isolate();
@@ -1677,6 +1737,15 @@ void Http2Session::HandlePingFrame(const nghttp2_frame* frame) {
   Local<Value> arg;
   bool ack = frame->hd.flags & NGHTTP2_FLAG_ACK;
   if (ack) {
+    // Acks for the internal BDP probe are not queued with the user pings.
+    if (bdp_ping_outstanding_ &&
+        memcmp(frame->ping.opaque_data,
+               &bdp_ping_sent_at_,
+               sizeof(bdp_ping_sent_at_)) == 0) {
+      OnBdpPingAck();
+      return;
+    }
+
     BaseObjectPtr<Http2Ping> ping = PopPing();
 
     if (!ping) {
@@ -1703,6 +1772,63 @@ void Http2Session::HandlePingFrame(const nghttp2_frame* frame) {
   MakeCallback(env()->http2session_on_ping_function(), 1, &arg);
 }
 
+// Called for every DATA chunk received while window auto-tuning is enabled.
+// Starts a sample with a PING when none is in flight; the bytes that arrive
+// until its ack approximate what the peer can send in one round trip.
+void Http2Session::SampleBdp(size_t length) {
+  bdp_bytes_ += length;
+  if (bdp_ping_outstanding_)
+    return;
+  bdp_ping_sent_at_ = uv_hrtime();
+  if (nghttp2_submit_ping(session_.get(),
+                          NGHTTP2_FLAG_NONE,
+                          reinterpret_cast<const uint8_t*>(
+                              &bdp_ping_sent_at_)) != 0) {
+    return;
+  }
+  bdp_ping_outstanding_ = true;
+  bdp_bytes_ = length;
+}
+
+// The BDP probe was acknowledged. If the peer filled most of the current
+// window within one round trip, the window is what limits throughput, so
+// grow the connection window and those of the open streams to twice the
+// sample, up to max_auto_window_size_.
+void Http2Session::OnBdpPingAck() {
+  bdp_ping_outstanding_ = false;
+  double rtt_ms = (uv_hrtime() - bdp_ping_sent_at_) / 1e6;
+  smoothed_rtt_ms_ = smoothed_rtt_ms_ == 0
+      ? rtt_ms
+      : smoothed_rtt_ms_ * 7 / 8 + rtt_ms / 8;
+  bdp_estimate_ = static_cast<double>(bdp_bytes_);
+
+  nghttp2_session* s = session_.get();
+  int32_t window = nghttp2_session_get_effective_local_window_size(s);
+  if (window < 0 ||
+      static_cast<uint32_t>(window) >= max_auto_window_size_ ||
+      bdp_bytes_ * 3 < static_cast<uint64_t>(window) * 2) {
+    return;
+  }
+
+  int32_t target = static_cast<int32_t>(
+      std::min<uint64_t>(bdp_bytes_ * 2, max_auto_window_size_));
+  Debug(this, "growing local window from %d to %d (rtt %.3f ms)",
+        window, target, rtt_ms);
+  Http2Scope h2scope(this);
+  if (nghttp2_session_set_local_window_size(
+          s, NGHTTP2_FLAG_NONE, 0, target) != 0) {
+    return;
+  }
+  for (const auto& [id, stream] : streams_) {
+    if (stream->is_destroyed() ||
+        nghttp2_session_get_stream_effective_local_window_size(s, id) >=
+            target) {
+      continue;
+    }
+    nghttp2_session_set_local_window_size(s, NGHTTP2_FLAG_NONE, id, target);
+  }
+}
+
 // Called by OnFrameReceived when a complete SETTINGS frame has been received.
 void Http2Session::HandleSettingsFrame(const nghttp2_frame* frame) {
   Debug(this, "handling settings frame");
@@ -1869,6 +1995,12 @@ void Http2Session::ClearOutgoing(int status) {
         WriteWrap::FromObject(wrap)->Done(0);
       }
     }
+    // Keep the allocation for the next round, unless the callbacks above
+    // have queued new data already.
+    if (outgoing_buffers_.empty()) {
+      current_outgoing_buffers_.clear();
+      outgoing_buffers_.swap(current_outgoing_buffers_);
+    }
   }
 
   // Now that we've finished sending queued data, if there are any pending
@@ -1901,6 +2033,16 @@ void Http2Session::CopyDataIntoOutgoing(const uint8_t* src, size_t src_length) {
   outgoing_storage_.resize(offset + src_length);
   memcpy(&outgoing_storage_[offset], src, src_length);
 
+  // Consecutive copies, e.g. a frame header and the small frames that
+  // follow it, are written as one buffer.
+  if (!outgoing_buffers_.empty() &&
+      outgoing_buffers_.back().buf.base == nullptr &&
+      outgoing_buffers_.back().buf.len > 0) {
+    outgoing_buffers_.back().buf.len += src_length;
+    outgoing_length_ += src_length;
+    return;
+  }
+
   // Store with a base of `nullptr` initially, since future resizes
   // of the outgoing_buffers_ vector may invalidate the pointer.
   // The correct base pointers will be set later, before writing to the
@@ -1910,6 +2052,36 @@ void Http2Session::CopyDataIntoOutgoing(const uint8_t* src, size_t src_length) {
   });
 }
 
+// Queues the first `length` bytes of `write` for sending. Small payloads are
+// copied next to their frame header rather than given a buffer of their
+// own; the write's request, if any, is kept so that it is still completed
+// only once the data has reached the socket.
+void Http2Session::PushOutgoingData(NgHttp2StreamWrite* write,
+                                    size_t length,
+                                    bool consume) {
+  if (length > kMaxCopiedDataLength) {
+    if (consume) {
+      PushOutgoingBuffer(std::move(*write));
+    } else {
+      PushOutgoingBuffer(
+          NgHttp2StreamWrite{uv_buf_init(write->buf.base, length)});
+    }
+    return;
+  }
+
+  CopyDataIntoOutgoing(reinterpret_cast<const uint8_t*>(write->buf.base),
+                       length);
+  if (consume && write->req_wrap) {
+    NgHttp2StreamWrite& last = outgoing_buffers_.back();
+    if (!last.req_wrap) {
+      last.req_wrap = std::move(write->req_wrap);
+    } else {
+      PushOutgoingBuffer(NgHttp2StreamWrite{std::move(write->req_wrap),
+                                            uv_buf_init(nullptr, 0)});
+    }
+  }
+}
+
 // Prompts nghttp2 to begin serializing it's pending data and pushes each
 // chunk out to the i/o socket to be sent. This is a particularly hot method
 // that will generally be called at least twice be event loop iteration.
@@ -1970,6 +2142,8 @@ uint8_t Http2Session::SendPendingData() {
   size_t i = 0;
   for (const NgHttp2StreamWrite& write : outgoing_buffers_) {
     statistics_.data_sent += write.buf.len;
+    // Only carries the request of data that was copied.
+    if (write.buf.len == 0) continue;
     if (write.buf.base == nullptr) {
       bufs[i++] = uv_buf_init(
           reinterpret_cast<char*>(outgoing_storage_.data() + offset),
@@ -1980,6 +2154,8 @@ uint8_t Http2Session::SendPendingData() {
     }
   }
 
+  count = i;
+
   chunks_sent_since_last_write_++;
 
   CHECK(!is_write_in_progress());
@@ -2030,15 +2206,13 @@ int Http2Session::OnSendData(
     if (write.buf.len <= length) {
       // This write does not suffice by itself, so we can consume it completely.
       length -= write.buf.len;
-      session->PushOutgoingBuffer(std::move(write));
+      session->PushOutgoingData(&write, write.buf.len, true);
       stream->queue_.pop();
       continue;
     }
 
     // Slice off `length` bytes of the first write in the queue.
-    session->PushOutgoingBuffer(NgHttp2StreamWrite {
-      uv_buf_init(write.buf.base, length)
-    });
+    session->PushOutgoingData(&write, length, false);
     write.buf.base += length;
     write.buf.len -= length;
     break;
@@ -2850,6 +3024,8 @@ void Http2Session::RefreshState(const FunctionCallbackInfo<Value>& args) {
       static_cast<double>(nghttp2_session_get_hd_deflate_dynamic_table_size(s));
   buffer[IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE] =
       static_cast<double>(nghttp2_session_get_hd_inflate_dynamic_table_size(s));
+  buffer[IDX_SESSION_STATE_BDP_ESTIMATE] = session->bdp_estimate_;
+  buffer[IDX_SESSION_STATE_SMOOTHED_RTT] = session->smoothed_rtt_ms_;
 }
 
 
@@ -234,9 +234,18 @@ class Http2Options {
     return max_session_memory_;
   }
 
+  void set_max_auto_window_size(uint32_t max) {
+    max_auto_window_size_ = max;
+  }
+
+  uint32_t max_auto_window_size() const {
+    return max_auto_window_size_;
+  }
+
  private:
   Nghttp2OptionPointer options_;
   uint64_t max_session_memory_ = kDefaultMaxSessionMemory;
+  uint32_t max_auto_window_size_ = 0;
   uint32_t max_header_pairs_ = DEFAULT_MAX_HEADER_LIST_PAIRS;
   PaddingStrategy padding_strategy_ = PADDING_STRATEGY_NONE;
   size_t max_outstanding_pings_ = kDefaultMaxPings;
@@ -811,11 +820,23 @@ class Http2Session : public AsyncWrap,
   void HandlePriorityFrame(const nghttp2_frame* frame);
   void HandleSettingsFrame(const nghttp2_frame* frame);
   void HandlePingFrame(const nghttp2_frame* frame);
+
+  // Flow-control window auto-tuning
+  void SampleBdp(size_t length);
+  void OnBdpPingAck();
   void HandleAltSvcFrame(const nghttp2_frame* frame);
   void HandleOriginFrame(const nghttp2_frame* frame);
 
   void DecrefHeaders(const nghttp2_frame* frame);
 
+  // Header strings cache
+  v8::Local<v8::String> GetHeaderString(nghttp2_rcbuf* buf,
+                                        v8::Local<v8::String> (*create)(
+                                            Http2Session* session,
+                                            const Http2Header& header),
+                                        const Http2Header& header);
+  void ClearHeaderStrings();
+
   // nghttp2 callbacks
   static int OnBeginHeadersCallback(
       nghttp2_session* session,
@@ -937,6 +958,17 @@ class Http2Session : public AsyncWrap,
   size_t max_outstanding_settings_ = kDefaultMaxSettings;
   std::queue<BaseObjectPtr<Http2Settings>> outstanding_settings_;
 
+  // When non-zero, the local flow-control windows are grown towards the
+  // estimated bandwidth-delay product of the connection, up to this size.
+  // The estimate comes from counting the DATA bytes received during the
+  // round trip of a PING that is sent when the first chunk arrives.
+  uint32_t max_auto_window_size_ = 0;
+  bool bdp_ping_outstanding_ = false;
+  uint64_t bdp_ping_sent_at_ = 0;
+  uint64_t bdp_bytes_ = 0;
+  double bdp_estimate_ = 0;
+  double smoothed_rtt_ms_ = 0;
+
   struct custom_settings_state local_custom_settings_;
   struct custom_settings_state remote_custom_settings_;
 
@@ -952,7 +984,22 @@ class Http2Session : public AsyncWrap,
   // Also use the invalid frame count as a measure for rejecting input frames.
   uint32_t invalid_frame_count_ = 0;
 
+  // Strings for header names and values that keep coming back from the
+  // HPACK dynamic table. nghttp2 hands out the same nghttp2_rcbuf every time
+  // a table entry is referenced, so its address identifies the string; each
+  // cached buffer is referenced so that the address cannot be reused while
+  // the entry exists. Buffers are only cached once they have been seen
+  // twice, which keeps one-off literals out of the cache.
+  static constexpr size_t kHeaderStringCacheSize = 256;
+  static constexpr size_t kMaxCachedHeaderLength = 1024;
+  static constexpr size_t kHeaderSeenSlots = 64;
+  std::unordered_map<nghttp2_rcbuf*, v8::Global<v8::String>> header_strings_;
+  nghttp2_rcbuf* header_seen_[kHeaderSeenSlots] = {};
+
   void PushOutgoingBuffer(NgHttp2StreamWrite&& write);
+  void PushOutgoingData(NgHttp2StreamWrite* write, size_t length, bool consume);
+  // DATA payloads up to this size are copied next to their frame header.
+  static constexpr size_t kMaxCopiedDataLength = 256;
 
   BaseObjectPtr<Http2State> http2_state_;
 
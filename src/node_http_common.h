@@ -512,6 +512,10 @@ class NgHeader final : public NgHeaderBase<typename T::allocator_t> {
   inline size_t length() const override;
   inline uint8_t flags() const override;
 
+  // The underlying buffers, e.g. for caching the strings created from them.
+  rcbuf_t* name_buf() const { return name_.get(); }
+  rcbuf_t* value_buf() const { return value_.get(); }
+
   void MemoryInfo(MemoryTracker* tracker) const override;
 
   SET_MEMORY_INFO_NAME(NgHeader)
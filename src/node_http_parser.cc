@@ -28,11 +28,15 @@
 #include "llhttp.h"
 #include "memory_tracker-inl.h"
 #include "node_external_reference.h"
+#include "node_usdt.h"
 #include "stream_base-inl.h"
 #include "v8.h"
 
 #include <cstdlib>  // free()
+#include <algorithm>
 #include <cstring>  // strdup(), strchr()
+#include <map>
+#include <string_view>
 
 
 // This is a binding to llhttp (https://github.com/nodejs/llhttp)
@@ -51,6 +55,8 @@ namespace node {
 namespace http_parser {  // NOLINT(build/namespaces)
 
 using v8::Array;
+using v8::ArrayBuffer;
+using v8::ArrayBufferView;
 using v8::Boolean;
 using v8::Context;
 using v8::EscapableHandleScope;
@@ -106,6 +112,115 @@ inline bool IsOWS(char c) {
   return c == ' ' || c == '\t';
 }
 
+// Header names and values common enough that the parser hands out one
+// internalized string per realm for them instead of a new string for every
+// request. Only exact matches are replaced, since rawHeaders keeps the
+// casing used on the wire, so names are listed as clients usually spell
+// them.
+#define HTTP_COMMON_HEADER_STRINGS(V)                                          \
+  V("Host")                                                                    \
+  V("host")                                                                    \
+  V("Connection")                                                              \
+  V("connection")                                                              \
+  V("Content-Type")                                                            \
+  V("content-type")                                                            \
+  V("Content-Length")                                                          \
+  V("content-length")                                                          \
+  V("Transfer-Encoding")                                                       \
+  V("transfer-encoding")                                                       \
+  V("Accept")                                                                  \
+  V("accept")                                                                  \
+  V("Accept-Encoding")                                                         \
+  V("accept-encoding")                                                         \
+  V("Accept-Language")                                                         \
+  V("accept-language")                                                         \
+  V("User-Agent")                                                              \
+  V("user-agent")                                                              \
+  V("Cache-Control")                                                           \
+  V("cache-control")                                                           \
+  V("Cookie")                                                                  \
+  V("cookie")                                                                  \
+  V("Set-Cookie")                                                              \
+  V("set-cookie")                                                              \
+  V("Authorization")                                                           \
+  V("authorization")                                                           \
+  V("Referer")                                                                 \
+  V("referer")                                                                 \
+  V("Origin")                                                                  \
+  V("origin")                                                                  \
+  V("Pragma")                                                                  \
+  V("Upgrade")                                                                 \
+  V("upgrade")                                                                 \
+  V("If-None-Match")                                                           \
+  V("if-none-match")                                                           \
+  V("If-Modified-Since")                                                       \
+  V("if-modified-since")                                                       \
+  V("X-Forwarded-For")                                                         \
+  V("x-forwarded-for")                                                         \
+  V("X-Forwarded-Proto")                                                       \
+  V("x-forwarded-proto")                                                       \
+  V("X-Forwarded-Host")                                                        \
+  V("x-forwarded-host")                                                        \
+  V("X-Real-IP")                                                               \
+  V("x-real-ip")                                                               \
+  V("X-Request-ID")                                                            \
+  V("x-request-id")                                                            \
+  V("Date")                                                                    \
+  V("date")                                                                    \
+  V("Server")                                                                  \
+  V("server")                                                                  \
+  V("ETag")                                                                    \
+  V("etag")                                                                    \
+  V("Last-Modified")                                                           \
+  V("last-modified")                                                           \
+  V("Location")                                                                \
+  V("location")                                                                \
+  V("Vary")                                                                    \
+  V("vary")                                                                    \
+  V("Keep-Alive")                                                              \
+  V("keep-alive")                                                              \
+  V("close")                                                                   \
+  V("chunked")                                                                 \
+  V("gzip")                                                                    \
+  V("gzip, deflate")                                                           \
+  V("gzip, deflate, br")                                                       \
+  V("gzip, deflate, br, zstd")                                                 \
+  V("*/*")                                                                     \
+  V("application/json")                                                        \
+  V("no-cache")                                                                \
+  V("max-age=0")                                                               \
+  V("Sec-Fetch-Site")                                                          \
+  V("sec-fetch-site")                                                          \
+  V("Sec-Fetch-Mode")                                                          \
+  V("sec-fetch-mode")                                                          \
+  V("Sec-Fetch-Dest")                                                          \
+  V("sec-fetch-dest")                                                          \
+  V("same-origin")                                                             \
+  V("cors")                                                                    \
+  V("empty")                                                                   \
+  V("navigate")                                                                \
+  V("document")
+
+constexpr std::string_view kCommonHeaderStrings[] = {
+#define V(string) string,
+    HTTP_COMMON_HEADER_STRINGS(V)
+#undef V
+};
+constexpr size_t kCommonHeaderStringCount = arraysize(kCommonHeaderStrings);
+
+// Index into kCommonHeaderStrings of the string equal to `str`, or
+// kCommonHeaderStringCount.
+size_t FindCommonHeaderString(const char* str, size_t size) {
+  for (size_t i = 0; i < kCommonHeaderStringCount; i++) {
+    const std::string_view common = kCommonHeaderStrings[i];
+    if (common.size() == size && common[0] == str[0] &&
+        memcmp(common.data(), str, size) == 0) {
+      return i;
+    }
+  }
+  return kCommonHeaderStringCount;
+}
+
 class BindingData : public BaseObject {
  public:
   BindingData(Realm* realm, Local<Object> obj) : BaseObject(realm, obj) {}
@@ -115,6 +230,24 @@ class BindingData : public BaseObject {
   std::vector<char> parser_buffer;
   bool parser_buffer_in_use = false;
 
+  // Created on first use.
+  v8::Global<String> common_header_strings[kCommonHeaderStringCount];
+
+  Local<String> CommonHeaderString(Isolate* isolate, size_t index) {
+    v8::Global<String>& cached = common_header_strings[index];
+    if (cached.IsEmpty()) {
+      const std::string_view common = kCommonHeaderStrings[index];
+      cached.Reset(isolate,
+                   String::NewFromOneByte(
+                       isolate,
+                       reinterpret_cast<const uint8_t*>(common.data()),
+                       v8::NewStringType::kInternalized,
+                       static_cast<int>(common.size()))
+                       .ToLocalChecked());
+    }
+    return cached.Get(isolate);
+  }
+
   void MemoryInfo(MemoryTracker* tracker) const override {
     tracker->TrackField("parser_buffer", parser_buffer);
   }
@@ -188,12 +321,23 @@ struct StringPtr {
   }
 
 
+  // Like ToString(), but shares the string for common header names and
+  // values.
+  Local<String> ToHeaderString(Environment* env, BindingData* binding_data) {
+    if (size_ != 0) {
+      size_t index = FindCommonHeaderString(str_, size_);
+      if (index != kCommonHeaderStringCount)
+        return binding_data->CommonHeaderString(env->isolate(), index);
+    }
+    return ToString(env);
+  }
+
+
   // Strip trailing OWS (SPC or HTAB) from string.
-  Local<String> ToTrimmedString(Environment* env) {
+  void Trim() {
     while (size_ > 0 && IsOWS(str_[size_ - 1])) {
       size_--;
     }
-    return ToString(env);
   }
 
 
@@ -204,12 +348,26 @@ struct StringPtr {
 
 class Parser;
 
-struct ParserComparator {
-  bool operator()(const Parser* lhs, const Parser* rhs) const;
+// A parser's membership in its ConnectionsList.
+struct ConnectionEntry {
+  explicit ConnectionEntry(Parser* parser) : parser(parser) {}
+
+  Parser* const parser;
+  ListNode<ConnectionEntry> all_node;
+  ListNode<ConnectionEntry> active_node;
+  // Key of the ConnectionsList bucket that active_node is linked into.
+  uint64_t bucket = 0;
 };
 
+// Tracks the connections of a server for closeIdleConnections() and the
+// headersTimeout/requestTimeout checks. Active connections are kept in a
+// timing wheel: one bucket per kBucketNs of message start time, so that
+// adding, touching and removing a connection does not depend on how many
+// there are, and Expired() only visits the buckets old enough to expire.
 class ConnectionsList : public BaseObject {
  public:
+    static constexpr uint64_t kBucketNs = 1000 * 1000 * 1000;
+
     static void New(const FunctionCallbackInfo<Value>& args);
 
     static void All(const FunctionCallbackInfo<Value>& args);
@@ -220,21 +378,14 @@ class ConnectionsList : public BaseObject {
 
     static void Expired(const FunctionCallbackInfo<Value>& args);
 
-    void Push(Parser* parser) {
-      all_connections_.insert(parser);
-    }
-
-    void Pop(Parser* parser) {
-      all_connections_.erase(parser);
-    }
-
-    void PushActive(Parser* parser) {
-      active_connections_.insert(parser);
-    }
+    // Returns [bucket start in ms, connection count, ...], oldest first.
+    static void Buckets(const FunctionCallbackInfo<Value>& args);
 
-    void PopActive(Parser* parser) {
-      active_connections_.erase(parser);
-    }
+    inline void Push(Parser* parser);
+    inline void Pop(Parser* parser);
+    // Files the parser under its current last_message_start_.
+    inline void PushActive(Parser* parser);
+    inline void PopActive(Parser* parser);
 
     SET_NO_MEMORY_INFO()
     SET_MEMORY_INFO_NAME(ConnectionsList)
@@ -246,13 +397,19 @@ class ConnectionsList : public BaseObject {
         MakeWeak();
       }
 
-    std::set<Parser*, ParserComparator> all_connections_;
-    std::set<Parser*, ParserComparator> active_connections_;
+    struct Bucket {
+      ListHead<ConnectionEntry, &ConnectionEntry::active_node> entries;
+      size_t count = 0;
+    };
+
+    ListHead<ConnectionEntry, &ConnectionEntry::all_node> all_connections_;
+    size_t all_count_ = 0;
+    std::map<uint64_t, Bucket> active_buckets_;
+    size_t active_count_ = 0;
 };
 
 class Parser : public AsyncWrap, public StreamListener {
   friend class ConnectionsList;
-  friend struct ParserComparator;
 
  public:
   Parser(BindingData* binding_data, Local<Object> wrap)
@@ -267,8 +424,8 @@ class Parser : public AsyncWrap, public StreamListener {
   SET_SELF_SIZE(Parser)
 
   int on_message_begin() {
-    // Important: Pop from the lists BEFORE resetting the last_message_start_
-    // otherwise std::set.erase will fail.
+    NODE_USDT2(http__message__start, this, static_cast<int>(parser_.type));
+    // The active list is keyed by last_message_start_, so re-file.
     if (connectionsList_ != nullptr) {
       connectionsList_->Pop(this);
       connectionsList_->PopActive(this);
@@ -476,7 +633,8 @@ class Parser : public AsyncWrap, public StreamListener {
     if (!cb->IsFunction())
       return 0;
 
-    Local<Value> buffer = Buffer::Copy(env, at, length).ToLocalChecked();
+    Local<Value> buffer = raw_ ? Slice(at, length)
+                               : Buffer::Copy(env, at, length).ToLocalChecked();
 
     MaybeLocal<Value> r = MakeCallback(cb.As<Function>(), 1, &buffer);
 
@@ -492,9 +650,11 @@ class Parser : public AsyncWrap, public StreamListener {
 
   int on_message_complete() {
     HandleScope scope(env()->isolate());
+    NODE_USDT3(http__message__done,
+               this,
+               static_cast<int>(parser_.method),
+               static_cast<int>(parser_.status_code));
 
-    // Important: Pop from the lists BEFORE resetting the last_message_start_
-    // otherwise std::set.erase will fail.
     if (connectionsList_ != nullptr) {
       connectionsList_->Pop(this);
       connectionsList_->PopActive(this);
@@ -613,7 +773,19 @@ class Parser : public AsyncWrap, public StreamListener {
 
     ArrayBufferViewContents<char> buffer(args[0]);
 
+    // In raw mode, headers and body are handed out as views into the buffer,
+    // which is only possible if it has an ArrayBuffer of its own rather than
+    // on-heap contents that ArrayBufferViewContents copies out.
+    if (parser->raw_ && args[0]->IsArrayBufferView()) {
+      Local<ArrayBufferView> view = args[0].As<ArrayBufferView>();
+      if (view->HasBuffer() && view->Buffer()->IsArrayBuffer()) {
+        parser->current_array_buffer_ = view->Buffer();
+        parser->current_array_buffer_offset_ = view->ByteOffset();
+      }
+    }
+
     Local<Value> ret = parser->Execute(buffer.data(), buffer.length());
+    parser->current_array_buffer_.Clear();
 
     if (!ret.IsEmpty())
       args.GetReturnValue().Set(ret);
@@ -660,6 +832,15 @@ class Parser : public AsyncWrap, public StreamListener {
       ASSIGN_OR_RETURN_UNWRAP(&connectionsList, args[4]);
     }
 
+    // Raw mode, for clients such as undici that keep the raw headers: header
+    // names and values are passed as Buffers instead of strings, and they and
+    // the body are views into the buffer passed to execute() where possible.
+    bool raw = false;
+    if (args.Length() > 5) {
+      CHECK(args[5]->IsBoolean());
+      raw = args[5]->IsTrue();
+    }
+
     llhttp_type_t type =
         static_cast<llhttp_type_t>(args[0].As<Int32>()->Value());
 
@@ -677,6 +858,7 @@ class Parser : public AsyncWrap, public StreamListener {
     parser->set_provider_type(provider);
     parser->AsyncReset(args[1].As<Object>());
     parser->Init(type, max_http_header_size, lenient_flags);
+    parser->raw_ = raw;
 
     if (connectionsList != nullptr) {
       parser->connectionsList_ = connectionsList;
@@ -686,8 +868,8 @@ class Parser : public AsyncWrap, public StreamListener {
       // server.timeout is left to the default value of zero.
       parser->last_message_start_ = uv_hrtime();
 
-      // Important: Push into the lists AFTER setting the last_message_start_
-      // otherwise std::set.erase will fail later.
+      // Push into the lists AFTER setting the last_message_start_, which
+      // picks the bucket.
       parser->connectionsList_->Push(parser);
       parser->connectionsList_->PushActive(parser);
     } else {
@@ -889,13 +1071,38 @@ class Parser : public AsyncWrap, public StreamListener {
     return scope.Escape(nread_obj);
   }
 
+  // Returns a Buffer over at..at+length if that is in the buffer passed to
+  // execute(), or a copy of it, e.g. for headers that were saved from a
+  // previous chunk.
+  Local<Value> Slice(const char* at, size_t length) {
+    if (!current_array_buffer_.IsEmpty() && at >= current_buffer_data_ &&
+        at + length <= current_buffer_data_ + current_buffer_len_) {
+      size_t offset =
+          current_array_buffer_offset_ + (at - current_buffer_data_);
+      return Buffer::New(env(), current_array_buffer_, offset, length)
+          .ToLocalChecked();
+    }
+    return Buffer::Copy(env(), at, length).ToLocalChecked();
+  }
+
   Local<Array> CreateHeaders() {
     // There could be extra entries but the max size should be fixed
     Local<Value> headers_v[kMaxHeaderFieldsCount * 2];
 
+    if (raw_) {
+      for (size_t i = 0; i < num_values_; ++i) {
+        headers_v[i * 2] = Slice(fields_[i].str_, fields_[i].size_);
+        values_[i].Trim();
+        headers_v[i * 2 + 1] = Slice(values_[i].str_, values_[i].size_);
+      }
+      return Array::New(env()->isolate(), headers_v, num_values_ * 2);
+    }
+
     for (size_t i = 0; i < num_values_; ++i) {
-      headers_v[i * 2] = fields_[i].ToString(env());
-      headers_v[i * 2 + 1] = values_[i].ToTrimmedString(env());
+      headers_v[i * 2] = fields_[i].ToHeaderString(env(), binding_data_.get());
+      values_[i].Trim();
+      headers_v[i * 2 + 1] =
+          values_[i].ToHeaderString(env(), binding_data_.get());
     }
 
     return Array::New(env()->isolate(), headers_v, num_values_ * 2);
@@ -1016,6 +1223,10 @@ class Parser : public AsyncWrap, public StreamListener {
   bool got_exception_;
   size_t current_buffer_len_;
   const char* current_buffer_data_;
+  // While execute() runs in raw mode, the ArrayBuffer behind its buffer.
+  Local<ArrayBuffer> current_array_buffer_;
+  size_t current_array_buffer_offset_ = 0;
+  bool raw_ = false;
   bool headers_completed_ = false;
   bool pending_pause_ = false;
   uint64_t header_nread_ = 0;
@@ -1023,6 +1234,7 @@ class Parser : public AsyncWrap, public StreamListener {
   uint64_t max_http_header_size_;
   uint64_t last_message_start_;
   ConnectionsList* connectionsList_;
+  ConnectionEntry connection_entry_{this};
 
   BaseObjectPtr<BindingData> binding_data_;
 
@@ -1047,18 +1259,39 @@ class Parser : public AsyncWrap, public StreamListener {
   static const llhttp_settings_t settings;
 };
 
-bool ParserComparator::operator()(const Parser* lhs, const Parser* rhs) const {
-  if (lhs->last_message_start_ == 0 && rhs->last_message_start_ == 0) {
-    // When both parsers are idle, guarantee strict order by
-    // comparing pointers as ints.
-    return lhs < rhs;
-  } else if (lhs->last_message_start_ == 0) {
-    return true;
-  } else if (rhs->last_message_start_ == 0) {
-    return false;
-  }
+void ConnectionsList::Push(Parser* parser) {
+  ConnectionEntry* entry = &parser->connection_entry_;
+  if (!entry->all_node.IsEmpty()) return;
+  all_connections_.PushBack(entry);
+  all_count_++;
+}
+
+void ConnectionsList::Pop(Parser* parser) {
+  ConnectionEntry* entry = &parser->connection_entry_;
+  if (entry->all_node.IsEmpty()) return;
+  entry->all_node.Remove();
+  all_count_--;
+}
 
-  return lhs->last_message_start_ < rhs->last_message_start_;
+void ConnectionsList::PushActive(Parser* parser) {
+  ConnectionEntry* entry = &parser->connection_entry_;
+  if (!entry->active_node.IsEmpty()) return;
+  entry->bucket = parser->last_message_start_ / kBucketNs;
+  // Start times only grow, so this is nearly always the newest bucket.
+  auto it = active_buckets_.try_emplace(active_buckets_.end(), entry->bucket);
+  it->second.entries.PushBack(entry);
+  it->second.count++;
+  active_count_++;
+}
+
+void ConnectionsList::PopActive(Parser* parser) {
+  ConnectionEntry* entry = &parser->connection_entry_;
+  if (entry->active_node.IsEmpty()) return;
+  entry->active_node.Remove();
+  active_count_--;
+  auto it = active_buckets_.find(entry->bucket);
+  CHECK(it != active_buckets_.end());
+  if (--it->second.count == 0) active_buckets_.erase(it);
 }
 
 void ConnectionsList::New(const FunctionCallbackInfo<Value>& args) {
@@ -1076,9 +1309,9 @@ void ConnectionsList::All(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
 
   LocalVector<Value> result(isolate);
-  result.reserve(list->all_connections_.size());
-  for (auto parser : list->all_connections_) {
-    result.emplace_back(parser->object());
+  result.reserve(list->all_count_);
+  for (ConnectionEntry* entry : list->all_connections_) {
+    result.emplace_back(entry->parser->object());
   }
 
   return args.GetReturnValue().Set(
@@ -1093,10 +1326,10 @@ void ConnectionsList::Idle(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
 
   LocalVector<Value> result(isolate);
-  result.reserve(list->all_connections_.size());
-  for (auto parser : list->all_connections_) {
-    if (parser->last_message_start_ == 0) {
-      result.emplace_back(parser->object());
+  result.reserve(list->all_count_);
+  for (ConnectionEntry* entry : list->all_connections_) {
+    if (entry->parser->last_message_start_ == 0) {
+      result.emplace_back(entry->parser->object());
     }
   }
 
@@ -1112,9 +1345,31 @@ void ConnectionsList::Active(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
 
   LocalVector<Value> result(isolate);
-  result.reserve(list->active_connections_.size());
-  for (auto parser : list->active_connections_) {
-    result.emplace_back(parser->object());
+  result.reserve(list->active_count_);
+  for (auto& [key, bucket] : list->active_buckets_) {
+    for (ConnectionEntry* entry : bucket.entries) {
+      result.emplace_back(entry->parser->object());
+    }
+  }
+
+  return args.GetReturnValue().Set(
+      Array::New(isolate, result.data(), result.size()));
+}
+
+void ConnectionsList::Buckets(const FunctionCallbackInfo<Value>& args) {
+  Isolate* isolate = args.GetIsolate();
+
+  ConnectionsList* list;
+
+  ASSIGN_OR_RETURN_UNWRAP(&list, args.This());
+
+  LocalVector<Value> result(isolate);
+  result.reserve(list->active_buckets_.size() * 2);
+  for (auto& [key, bucket] : list->active_buckets_) {
+    const double start_ms = static_cast<double>(key * (kBucketNs / 1000000));
+    result.emplace_back(Number::New(isolate, start_ms));
+    result.emplace_back(
+        Number::New(isolate, static_cast<double>(bucket.count)));
   }
 
   return args.GetReturnValue().Set(
@@ -1157,27 +1412,39 @@ void ConnectionsList::Expired(const FunctionCallbackInfo<Value>& args) {
     return args.GetReturnValue().Set(Array::New(isolate, 0));
   }
 
-  auto iter = list->active_connections_.begin();
-  auto end = list->active_connections_.end();
+  // headers_timeout <= request_timeout, so nothing that started after the
+  // later of the two deadlines can have expired.
+  const uint64_t latest_deadline = std::max(headers_deadline, request_deadline);
 
   LocalVector<Value> result(isolate);
-  result.reserve(list->active_connections_.size());
-  while (iter != end) {
-    Parser* parser = *iter;
-    iter++;
-
-    // Check for expiration.
-    if (
-      (!parser->headers_completed_ && headers_deadline > 0 &&
-        parser->last_message_start_ < headers_deadline) ||
-      (
-        request_deadline > 0 &&
-        parser->last_message_start_ < request_deadline)
-    ) {
-      result.emplace_back(parser->object());
-
-      list->active_connections_.erase(parser);
+  auto bucket_iter = list->active_buckets_.begin();
+  while (bucket_iter != list->active_buckets_.end() &&
+         bucket_iter->first * kBucketNs < latest_deadline) {
+    // PopActive() unlinks the current entry and erases the bucket with its
+    // last one, so step past both first.
+    auto bucket_next = std::next(bucket_iter);
+    auto iter = bucket_iter->second.entries.begin();
+    auto end = bucket_iter->second.entries.end();
+    while (iter != end) {
+      Parser* parser = (*iter)->parser;
+      ++iter;
+
+      // Check for expiration.
+      if (
+        (!parser->headers_completed_ && headers_deadline > 0 &&
+          parser->last_message_start_ < headers_deadline) ||
+        (
+          request_deadline > 0 &&
+          parser->last_message_start_ < request_deadline)
+      ) {
+        result.emplace_back(parser->object());
+
+        const bool was_last = !(iter != end);
+        list->PopActive(parser);
+        if (was_last) break;
+      }
     }
+    bucket_iter = bucket_next;
   }
 
   return args.GetReturnValue().Set(
@@ -1310,6 +1577,7 @@ void CreatePerIsolateProperties(IsolateData* isolate_data,
   SetProtoMethod(isolate, c, "idle", ConnectionsList::Idle);
   SetProtoMethod(isolate, c, "active", ConnectionsList::Active);
   SetProtoMethod(isolate, c, "expired", ConnectionsList::Expired);
+  SetProtoMethod(isolate, c, "buckets", ConnectionsList::Buckets);
   SetConstructorFunction(isolate, target, "ConnectionsList", c);
 }
 
@@ -1373,6 +1641,7 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(ConnectionsList::Idle);
   registry->Register(ConnectionsList::Active);
   registry->Register(ConnectionsList::Expired);
+  registry->Register(ConnectionsList::Buckets);
 }
 
 }  // namespace http_parser
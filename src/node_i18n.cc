@@ -113,7 +113,7 @@ MaybeLocal<Object> ToBufferEndian(Environment* env, MaybeStackBuffer<T>* buf) {
                 "Currently only one- or two-byte buffers are supported");
   if constexpr (sizeof(T) > 1 && IsBigEndian()) {
     SPREAD_BUFFER_ARG(ret, retbuf);
-    CHECK(nbytes::SwapBytes16(retbuf_data, retbuf_length));
+    CHECK(SwapBytes16(retbuf_data, retbuf_length));
   }
 
   return ret;
@@ -129,7 +129,7 @@ void CopySourceBuffer(MaybeStackBuffer<UChar>* dest,
   char* dst = reinterpret_cast<char*>(**dest);
   memcpy(dst, data, length);
   if constexpr (IsBigEndian()) {
-    CHECK(nbytes::SwapBytes16(dst, length));
+    CHECK(SwapBytes16(dst, length));
   }
 }
 
@@ -511,7 +511,7 @@ void ConverterObject::Decode(const FunctionCallbackInfo<Value>& args) {
     char* value = reinterpret_cast<char*>(output) + beginning;
 
     if constexpr (IsBigEndian()) {
-      CHECK(nbytes::SwapBytes16(value, length));
+      CHECK(SwapBytes16(value, length));
     }
 
     Local<Value> ret;
@@ -36,6 +36,7 @@
 #include <cstdint>
 #include <cstdlib>
 
+#include <map>
 #include <string>
 #include <variant>
 #include <vector>
@@ -95,6 +96,9 @@ void PrintCurrentStackTrace(v8::Isolate* isolate,
 void PrintStackTrace(v8::Isolate* isolate,
                      v8::Local<v8::StackTrace> stack,
                      StackTracePrefix prefix = StackTracePrefix::kAt);
+std::string FormatStackTrace(v8::Isolate* isolate,
+                             v8::Local<v8::StackTrace> stack,
+                             StackTracePrefix prefix = StackTracePrefix::kAt);
 void PrintCaughtException(v8::Isolate* isolate,
                           v8::Local<v8::Context> context,
                           const v8::TryCatch& try_catch);
@@ -141,7 +145,7 @@ class NodeArrayBufferAllocator : public ArrayBufferAllocator {
     return total_mem_usage_.load(std::memory_order_relaxed);
   }
 
- private:
+ protected:
   uint32_t zero_fill_field_ = 1;  // Boolean but exposed as uint32 to JS land.
   std::atomic<size_t> total_mem_usage_ {0};
 
@@ -166,6 +170,55 @@ class DebuggingArrayBufferAllocator final : public NodeArrayBufferAllocator {
   std::unordered_map<void*, size_t> allocations_;
 };
 
+// Serves small allocations from 64 KiB slabs, each split into blocks of one
+// power-of-two size class, so that short-lived Buffers do not fragment the
+// malloc heap. A slab is returned to V8's allocator as soon as it is empty,
+// unless it is the last one of its size class with free blocks.
+class SlabArrayBufferAllocator final : public NodeArrayBufferAllocator {
+ public:
+  static constexpr size_t kSlabSize = 64 * 1024;
+  static constexpr size_t kMinBlockSize = 16;
+  static constexpr size_t kMaxBlockSize = 4096;
+
+  ~SlabArrayBufferAllocator() override;
+  void* Allocate(size_t size) override;
+  void* AllocateUninitialized(size_t size) override;
+  void Free(void* data, size_t size) override;
+
+  inline size_t slab_count() const {
+    return slab_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kSizeClassCount = 9;  // 16 bytes to 4 KiB.
+
+  struct Slab {
+    char* start;
+    size_t block_size;
+    void* free_list = nullptr;
+    size_t used = 0;      // Blocks that are allocated.
+    size_t bumped = 0;    // Blocks that have ever been handed out.
+    Slab* prev = nullptr;  // In the partial list of the size class.
+    Slab* next = nullptr;
+  };
+
+  struct SizeClass {
+    // The slabs that have free blocks.
+    Slab* partial = nullptr;
+  };
+
+  static size_t SizeClassOf(size_t size);
+  void* AllocateBlock(size_t size);
+  bool FreeBlock(void* data, size_t size);
+  void LinkPartial(SizeClass* size_class, Slab* slab);
+  void UnlinkPartial(SizeClass* size_class, Slab* slab);
+
+  Mutex slab_mutex_;
+  SizeClass size_classes_[kSizeClassCount];
+  std::map<uintptr_t, std::unique_ptr<Slab>> slabs_;
+  std::atomic<size_t> slab_count_{0};
+};
+
 namespace Buffer {
 v8::MaybeLocal<v8::Object> Copy(Environment* env, const char* data, size_t len);
 v8::MaybeLocal<v8::Object> New(Environment* env, size_t size);
@@ -299,8 +352,17 @@ class DebugSealHandleScope {
 
 class ThreadPoolWork {
  public:
-  explicit inline ThreadPoolWork(Environment* env, const char* type)
-      : env_(env), type_(type) {
+  // The kind of work, which decides how the libuv threadpool schedules it.
+  // kCpu work runs on at most UV_THREADPOOL_CPU_SIZE threads so that a burst
+  // of it (hashing, compression) leaves threads for file system requests.
+  // kIo is for work that mostly blocks on the file system, kSlowIo for work
+  // that blocks for long periods, like DNS lookups.
+  enum class Lane { kCpu, kIo, kSlowIo };
+
+  explicit inline ThreadPoolWork(Environment* env,
+                                 const char* type,
+                                 Lane lane = Lane::kCpu)
+      : env_(env), type_(type), lane_(lane) {
     CHECK_NOT_NULL(env);
   }
   inline virtual ~ThreadPoolWork() = default;
@@ -312,11 +374,16 @@ class ThreadPoolWork {
   virtual void AfterThreadPoolWork(int status) = 0;
 
   Environment* env() const { return env_; }
+  // Only takes effect the next time the work is scheduled.
+  void set_lane(Lane lane) { lane_ = lane; }
 
  private:
   Environment* env_;
   uv_work_t work_req_;
   const char* type_;
+  Lane lane_;
+  // Set by ScheduleWork() while threadpool metrics are enabled.
+  uint64_t queued_at_ = 0;
 };
 
 #define TRACING_CATEGORY_NODE "node"
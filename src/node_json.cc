@@ -0,0 +1,323 @@
+#include "node_json.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_errors.h"
+#include "node_external_reference.h"
+#include "simdjson.h"
+#include "util-inl.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace node {
+namespace json {
+
+using v8::Array;
+using v8::Boolean;
+using v8::Context;
+using v8::DictionaryTemplate;
+using v8::Exception;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::Isolate;
+using v8::JSON;
+using v8::Local;
+using v8::LocalVector;
+using v8::MaybeLocal;
+using v8::MemorySpan;
+using v8::NewStringType;
+using v8::Null;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+namespace {
+
+// Objects with at most this many properties, all with ASCII names that are
+// not array indices, are created from a DictionaryTemplate per set of names,
+// so that all objects of that shape share one map. Others, and any shapes
+// past the first kMaxShapes, are built property by property.
+constexpr size_t kMaxShapeProperties = 32;
+constexpr size_t kMaxShapes = 1024;
+
+// Documents larger than this do not keep their parser buffers allocated.
+constexpr size_t kMaxRetainedCapacity = 8 * 1024 * 1024;
+
+class ValueBuilder {
+ public:
+  explicit ValueBuilder(Local<Context> context)
+      : isolate_(Isolate::GetCurrent()), context_(context) {}
+
+  MaybeLocal<Value> Build(simdjson::dom::element element);
+
+ private:
+  MaybeLocal<Value> BuildObject(simdjson::dom::object object);
+  MaybeLocal<String> NewString(std::string_view string,
+                               NewStringType type = NewStringType::kNormal);
+  MaybeLocal<String> Key(std::string_view key);
+  static bool CanBeShaped(std::string_view key);
+
+  Isolate* const isolate_;
+  Local<Context> context_;
+  // Property names are internalized once per parse.
+  std::unordered_map<std::string_view, Local<String>> keys_;
+  std::unordered_map<std::string, Local<DictionaryTemplate>> shapes_;
+};
+
+MaybeLocal<Value> ValueBuilder::Build(simdjson::dom::element element) {
+  switch (element.type()) {
+    case simdjson::dom::element_type::OBJECT:
+      return BuildObject(element.get_object().value_unsafe());
+    case simdjson::dom::element_type::ARRAY: {
+      simdjson::dom::array array = element.get_array().value_unsafe();
+      LocalVector<Value> elements(isolate_);
+      elements.reserve(array.size());
+      for (simdjson::dom::element child : array) {
+        Local<Value> value;
+        if (!Build(child).ToLocal(&value)) return {};
+        elements.push_back(value);
+      }
+      return Array::New(isolate_, elements.data(), elements.size());
+    }
+    case simdjson::dom::element_type::STRING:
+      return NewString(element.get_string().value_unsafe());
+    case simdjson::dom::element_type::INT64:
+      return Number::New(
+          isolate_, static_cast<double>(element.get_int64().value_unsafe()));
+    case simdjson::dom::element_type::UINT64:
+      return Number::New(
+          isolate_, static_cast<double>(element.get_uint64().value_unsafe()));
+    case simdjson::dom::element_type::DOUBLE:
+      return Number::New(isolate_, element.get_double().value_unsafe());
+    case simdjson::dom::element_type::BOOL:
+      return Boolean::New(isolate_, element.get_bool().value_unsafe());
+    case simdjson::dom::element_type::NULL_VALUE:
+      return Null(isolate_);
+  }
+  UNREACHABLE();
+}
+
+MaybeLocal<Value> ValueBuilder::BuildObject(simdjson::dom::object object) {
+  std::vector<std::string_view> names;
+  std::vector<MaybeLocal<Value>> values;
+  bool shaped = object.size() <= kMaxShapeProperties;
+  for (simdjson::dom::key_value_pair field : object) {
+    Local<Value> value;
+    if (!Build(field.value).ToLocal(&value)) return {};
+    shaped = shaped && CanBeShaped(field.key);
+    names.push_back(field.key);
+    values.emplace_back(value);
+  }
+  // A repeated name would have its last value win, as with JSON.parse().
+  for (size_t i = 0; shaped && i < names.size(); i++) {
+    for (size_t j = i + 1; j < names.size(); j++) {
+      if (names[i] == names[j]) shaped = false;
+    }
+  }
+
+  if (shaped) {
+    std::string shape;
+    for (std::string_view name : names) {
+      shape += name;
+      shape += '\0';
+    }
+    auto it = shapes_.find(shape);
+    if (it == shapes_.end() && shapes_.size() < kMaxShapes) {
+      it = shapes_
+               .emplace(std::move(shape),
+                        DictionaryTemplate::New(
+                            isolate_,
+                            MemorySpan<const std::string_view>(names.data(),
+                                                               names.size())))
+               .first;
+    }
+    if (it != shapes_.end()) {
+      return it->second->NewInstance(
+          context_,
+          MemorySpan<MaybeLocal<Value>>(values.data(), values.size()));
+    }
+  }
+
+  Local<Object> result = Object::New(isolate_);
+  for (size_t i = 0; i < names.size(); i++) {
+    Local<String> key;
+    if (!Key(names[i]).ToLocal(&key) ||
+        result->CreateDataProperty(context_, key, values[i].ToLocalChecked())
+            .IsNothing()) {
+      return {};
+    }
+  }
+  return result;
+}
+
+MaybeLocal<String> ValueBuilder::NewString(std::string_view string,
+                                           NewStringType type) {
+  Local<String> result;
+  if (string.size() > String::kMaxLength ||
+      !String::NewFromUtf8(
+           isolate_, string.data(), type, static_cast<int>(string.size()))
+           .ToLocal(&result)) {
+    isolate_->ThrowException(ERR_STRING_TOO_LONG(isolate_));
+    return {};
+  }
+  return result;
+}
+
+MaybeLocal<String> ValueBuilder::Key(std::string_view key) {
+  auto it = keys_.find(key);
+  if (it != keys_.end()) return it->second;
+  Local<String> string;
+  if (!NewString(key, NewStringType::kInternalized).ToLocal(&string)) {
+    return {};
+  }
+  keys_.emplace(key, string);
+  return string;
+}
+
+bool ValueBuilder::CanBeShaped(std::string_view key) {
+  // Array indices end up as elements, not named properties, and JSON.parse()
+  // makes "__proto__" an own property rather than the prototype.
+  if (key.empty() || (key[0] >= '0' && key[0] <= '9') || key == "__proto__") {
+    return false;
+  }
+  for (char c : key) {
+    if (static_cast<unsigned char>(c) >= 0x80 || c == '\0') return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+MaybeLocal<Value> Parse(Local<Context> context, std::string_view json) {
+  Isolate* isolate = Isolate::GetCurrent();
+  thread_local simdjson::dom::parser parser;
+  simdjson::dom::element root;
+  MaybeLocal<Value> result;
+  if (parser.parse(json.data(), json.size()).get(root) == simdjson::SUCCESS) {
+    result = ValueBuilder(context).Build(root);
+  } else {
+    Local<String> text;
+    if (json.size() > String::kMaxLength ||
+        !String::NewFromUtf8(isolate,
+                             json.data(),
+                             NewStringType::kNormal,
+                             static_cast<int>(json.size()))
+             .ToLocal(&text)) {
+      isolate->ThrowException(ERR_STRING_TOO_LONG(isolate));
+      return {};
+    }
+    result = JSON::Parse(context, text);
+  }
+  if (parser.capacity() > kMaxRetainedCapacity) {
+    parser = simdjson::dom::parser();
+  }
+  return result;
+}
+
+JSONView::JSONView(Environment* env,
+                   Local<Object> object,
+                   std::string_view json)
+    : BaseObject(env, object), json_(json.data(), json.size()) {
+  MakeWeak();
+  iterate_error_ = parser_.iterate(json_).get(document_);
+}
+
+void JSONView::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<char> contents(args[0]);
+  new JSONView(
+      env, args.This(), std::string_view(contents.data(), contents.length()));
+}
+
+bool JSONView::Find(std::string_view pointer, std::string_view* raw_json) {
+  *raw_json = {};
+  simdjson::error_code error = iterate_error_;
+  if (error == simdjson::SUCCESS) {
+    if (pointer.empty()) {
+      // The whole document, which may be a scalar.
+      *raw_json = std::string_view(json_.data(), json_.size());
+      return true;
+    }
+    simdjson::ondemand::value value;
+    error = document_.at_pointer(pointer).get(value);
+    if (error == simdjson::SUCCESS) error = value.raw_json().get(*raw_json);
+  }
+  switch (error) {
+    case simdjson::SUCCESS:
+    case simdjson::NO_SUCH_FIELD:
+    case simdjson::INDEX_OUT_OF_BOUNDS:
+      return true;
+    case simdjson::INVALID_JSON_POINTER:
+      THROW_ERR_INVALID_ARG_VALUE(
+          env(), "Invalid JSON pointer: %s", std::string(pointer));
+      return false;
+    default: {
+      Isolate* isolate = env()->isolate();
+      isolate->ThrowException(Exception::SyntaxError(
+          OneByteString(isolate, simdjson::error_message(error))));
+      return false;
+    }
+  }
+}
+
+void JSONView::Get(const FunctionCallbackInfo<Value>& args) {
+  JSONView* view;
+  ASSIGN_OR_RETURN_UNWRAP(&view, args.This());
+  CHECK(args[0]->IsString());
+  Utf8Value pointer(args.GetIsolate(), args[0]);
+  std::string_view raw_json;
+  if (!view->Find(pointer.ToStringView(), &raw_json) || raw_json.empty()) {
+    return;
+  }
+  Local<Value> result;
+  if (Parse(view->env()->context(), raw_json).ToLocal(&result)) {
+    args.GetReturnValue().Set(result);
+  }
+}
+
+void JSONView::Has(const FunctionCallbackInfo<Value>& args) {
+  JSONView* view;
+  ASSIGN_OR_RETURN_UNWRAP(&view, args.This());
+  CHECK(args[0]->IsString());
+  Utf8Value pointer(args.GetIsolate(), args[0]);
+  std::string_view raw_json;
+  if (view->Find(pointer.ToStringView(), &raw_json)) {
+    args.GetReturnValue().Set(!raw_json.empty());
+  }
+}
+
+void JSONView::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("json", json_.size());
+  tracker->TrackFieldWithSize("parser", parser_.capacity() * 2);
+}
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context,
+                void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+  Isolate* isolate = env->isolate();
+
+  Local<FunctionTemplate> t = NewFunctionTemplate(isolate, JSONView::New);
+  t->InstanceTemplate()->SetInternalFieldCount(
+      JSONView::kInternalFieldCount);
+  SetProtoMethodNoSideEffect(isolate, t, "get", JSONView::Get);
+  SetProtoMethodNoSideEffect(isolate, t, "has", JSONView::Has);
+  SetConstructorFunction(context, target, "JSONView", t);
+}
+
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(JSONView::New);
+  registry->Register(JSONView::Get);
+  registry->Register(JSONView::Has);
+}
+
+}  // namespace json
+}  // namespace node
+
+NODE_BINDING_CONTEXT_AWARE_INTERNAL(json, node::json::Initialize)
+NODE_BINDING_EXTERNAL_REFERENCE(json, node::json::RegisterExternalReferences)
@@ -0,0 +1,66 @@
+#ifndef SRC_NODE_JSON_H_
+#define SRC_NODE_JSON_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <string_view>
+
+#include "base_object.h"
+#include "simdjson.h"
+#include "v8.h"
+
+namespace node {
+class ExternalReferenceRegistry;
+
+namespace json {
+
+// Parses UTF-8 encoded JSON straight into JavaScript values with simdjson,
+// without decoding it into a JavaScript string first. The result is the same
+// as JSON.parse() of the decoded text; input that simdjson rejects or
+// handles differently (invalid UTF-8, numbers out of range, deep nesting)
+// goes through JSON.parse() after all, so errors are the same, too.
+v8::MaybeLocal<v8::Value> Parse(v8::Local<v8::Context> context,
+                                std::string_view json);
+
+// new JSONView(view) keeps a copy of a JSON document and only indexes it;
+// view.get(pointer) materializes the value at a JSON pointer (RFC 6901),
+// or returns undefined if there is none, and view.has(pointer) checks for
+// one. Malformed JSON is only noticed, with a SyntaxError, as far as lookups
+// read it.
+class JSONView : public BaseObject {
+ public:
+  JSONView(Environment* env,
+           v8::Local<v8::Object> object,
+           std::string_view json);
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Get(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Has(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(JSONView)
+  SET_SELF_SIZE(JSONView)
+
+ private:
+  // Looks up pointer, and returns false after throwing if that fails for any
+  // reason but there being no such value. raw_json is left empty then.
+  bool Find(std::string_view pointer, std::string_view* raw_json);
+
+  simdjson::padded_string json_;
+  simdjson::ondemand::parser parser_;
+  simdjson::ondemand::document document_;
+  simdjson::error_code iterate_error_;
+};
+
+void Initialize(v8::Local<v8::Object> target,
+                v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context,
+                void* priv);
+void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+}  // namespace json
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_JSON_H_
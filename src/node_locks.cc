@@ -170,6 +170,10 @@ void LockManager::CleanupStolenLocks(Environment* env) {
   {
     Mutex::ScopedLock scoped_lock(mutex_);
 
+    // Nothing was stolen since the last time this found no stolen locks.
+    if (!has_stolen_locks_) return;
+    bool has_stolen_locks = false;
+
     for (auto resource_iter = held_locks_.begin();
          resource_iter != held_locks_.end();
          ++resource_iter) {
@@ -178,7 +182,9 @@ void LockManager::CleanupStolenLocks(Environment* env) {
 
       // Check if this resource has stolen locks from other environments
       for (const auto& lock_ptr : resource_locks) {
-        if (lock_ptr->is_stolen() && lock_ptr->env() != env) {
+        if (!lock_ptr->is_stolen()) continue;
+        has_stolen_locks = true;
+        if (lock_ptr->env() != env) {
           has_stolen_from_other_env = true;
           break;
         }
@@ -188,6 +194,8 @@ void LockManager::CleanupStolenLocks(Environment* env) {
         resources_to_clean.push_back(resource_iter->first);
       }
     }
+
+    has_stolen_locks_ = has_stolen_locks;
   }
 
   // Clean up resources
@@ -215,6 +223,73 @@ void LockManager::CleanupStolenLocks(Environment* env) {
   }
 }
 
+// Whether request has to wait for first_for_resource, the earliest pending
+// request for the same resource name.
+static bool MustWaitForEarlierRequest(const LockRequest* request,
+                                      const LockRequest* first_for_resource) {
+  if (first_for_resource == nullptr || first_for_resource == request) {
+    return false;
+  }
+  // Exclusive locks are incompatible with everything, shared requests can
+  // proceed together.
+  return request->mode() == Lock::Mode::Exclusive ||
+         first_for_resource->mode() == Lock::Mode::Exclusive;
+}
+
+// Called with mutex_ held.
+void LockManager::AddPendingRequest(std::unique_ptr<LockRequest> request) {
+  pending_counts_[request->name()]++;
+  // Steal requests get priority by going to front of queue
+  if (request->steal()) {
+    pending_queue_.emplace_front(std::move(request));
+  } else {
+    pending_queue_.push_back(std::move(request));
+  }
+}
+
+// Called with mutex_ held. Removes the request at *iter from pending_queue_
+// and advances *iter past it.
+std::unique_ptr<LockRequest> LockManager::TakePendingRequest(
+    std::deque<std::unique_ptr<LockRequest>>::iterator* iter) {
+  std::unique_ptr<LockRequest> request = std::move(**iter);
+  auto count_iter = pending_counts_.find(request->name());
+  if (--count_iter->second == 0) pending_counts_.erase(count_iter);
+  *iter = pending_queue_.erase(*iter);
+  return request;
+}
+
+// Called with mutex_ held.
+std::shared_ptr<Lock> LockManager::AddHeldLock(Environment* env,
+                                               LockRequest* request) {
+  auto granted_lock = std::make_shared<Lock>(env,
+                                             request->name(),
+                                             request->mode(),
+                                             request->client_id(),
+                                             request->waiting_promise(),
+                                             request->released_promise());
+  held_locks_[request->name()].push_back(granted_lock);
+  return granted_lock;
+}
+
+// Called with mutex_ held. Collects the environments other than env that have
+// a pending request that can be granted now. Only those are woken, so that a
+// release does not make every worker waiting on the same name scan the queue.
+void LockManager::CollectEnvironmentsToWake(
+    Environment* env, std::unordered_set<Environment*>* envs_to_wake) const {
+  std::unordered_map<std::u16string, const LockRequest*>
+      first_seen_for_resource;
+  for (const auto& request : pending_queue_) {
+    const LockRequest*& first_for_resource =
+        first_seen_for_resource[request->name()];
+    if (request->env() != env &&
+        !MustWaitForEarlierRequest(request.get(), first_for_resource) &&
+        IsGrantable(request.get())) {
+      envs_to_wake->insert(request->env());
+    }
+    if (first_for_resource == nullptr) first_for_resource = request.get();
+  }
+}
+
 /**
  * Web Locks algorithm implementation
  * https://w3c.github.io/web-locks/#algorithms
@@ -222,28 +297,27 @@ void LockManager::CleanupStolenLocks(Environment* env) {
 void LockManager::ProcessQueue(Environment* env) {
   Isolate* isolate = env->isolate();
   HandleScope handle_scope(isolate);
-  Local<Context> context = env->context();
 
   // Remove locks that were stolen from this Environment first
   CleanupStolenLocks(env);
 
   while (true) {
-    std::unique_ptr<LockRequest> grantable_request;
-    std::unique_ptr<LockRequest> if_available_request;
+    std::vector<std::pair<std::unique_ptr<LockRequest>, std::shared_ptr<Lock>>>
+        granted_requests;
+    std::vector<std::unique_ptr<LockRequest>> if_available_requests;
+    std::unique_ptr<LockRequest> steal_request;
     std::unordered_set<Environment*> other_envs_to_wake;
 
     /**
-     * First pass over pending_queue_
-     * 1- Build first_seen_for_resource: the oldest pending request
-     *   for every resource name we encounter
-     * 2- Decide what to do with each entry:
-     *     – If it belongs to another Environment, remember that env so we
-     *       can wake it later
-     *     – For our Environment, pick one of:
-     *         * grantable_request  – can be granted now
-     *         * if_available_request – user asked for ifAvailable and the
-     *           resource is currently busy
-     *         * otherwise we skip and keep scanning
+     * A single pass over pending_queue_
+     * 1- Build first_seen_for_resource: the oldest request for every resource
+     *    name we encounter that stays pending
+     * 2- For our Environment, take every request that can be granted now,
+     *    adding its lock to held_locks_ right away so that the requests
+     *    further down the queue see it, and every ifAvailable request whose
+     *    resource is busy
+     * 3- A steal request is taken on its own, since it changes the locks
+     *    that are held
      */
 
     {
@@ -251,58 +325,38 @@ void LockManager::ProcessQueue(Environment* env) {
 
       Mutex::ScopedLock scoped_lock(mutex_);
       for (auto queue_iter = pending_queue_.begin();
-           queue_iter != pending_queue_.end();
-           ++queue_iter) {
+           queue_iter != pending_queue_.end();) {
         LockRequest* request = queue_iter->get();
+        LockRequest*& first_for_resource =
+            first_seen_for_resource[request->name()];
 
-        // Collect unique environments to wake up later
-        if (request->env() != env) {
-          other_envs_to_wake.insert(request->env());
-        }
-
-        // During a single pass, the first time we see a resource name is the
-        // earliest pending request
-        auto& first_for_resource = first_seen_for_resource[request->name()];
-        if (first_for_resource == nullptr) {
-          first_for_resource = request;  // Mark as first seen for this resource
-        }
-
-        bool has_earlier_request_for_same_resource =
-            (first_for_resource != request);
-
-        bool should_wait_for_earlier_requests = false;
-
-        if (has_earlier_request_for_same_resource) {
-          // Check if this request is compatible with the earliest pending
-          // request first_for_resource
-          if (request->mode() == Lock::Mode::Exclusive ||
-              first_for_resource->mode() == Lock::Mode::Exclusive) {
-            // Exclusive locks are incompatible with everything
-            should_wait_for_earlier_requests = true;
+        if (request->env() != env ||
+            MustWaitForEarlierRequest(request, first_for_resource) ||
+            !IsGrantable(request)) {
+          if (request->env() == env && request->if_available()) {
+            // ifAvailable request when resource not available: grant with null
+            if_available_requests.push_back(TakePendingRequest(&queue_iter));
+            continue;
           }
-          // If both are shared, they're compatible and can proceed
-        }
-
-        // Only process requests from the current environment
-        if (request->env() != env) {
+          if (first_for_resource == nullptr) first_for_resource = request;
+          ++queue_iter;
           continue;
         }
 
-        if (should_wait_for_earlier_requests || !IsGrantable(request)) {
-          if (request->if_available()) {
-            // ifAvailable request when resource not available: grant with null
-            if_available_request = std::move(*queue_iter);
-            pending_queue_.erase(queue_iter);
-            break;
+        if (request->steal()) {
+          if (granted_requests.empty() && if_available_requests.empty()) {
+            steal_request = TakePendingRequest(&queue_iter);
           }
-          continue;
+          break;
         }
 
         // Found a request that can be granted normally
-        grantable_request = std::move(*queue_iter);
-        pending_queue_.erase(queue_iter);
-        break;
+        std::shared_ptr<Lock> granted_lock = AddHeldLock(env, request);
+        granted_requests.emplace_back(TakePendingRequest(&queue_iter),
+                                      std::move(granted_lock));
       }
+
+      CollectEnvironmentsToWake(env, &other_envs_to_wake);
     }
 
     // Wake each environment only once
@@ -310,251 +364,279 @@ void LockManager::ProcessQueue(Environment* env) {
       WakeEnvironment(target_env);
     }
 
-    /**
-     * 1- We call the user callback immediately with `null` to signal
-     *    that the lock was not granted - Check wrapCallback function in
-     * locks.js 2- Depending on what the callback returns we settle the two
-     *    internal promises
-     * 3- No lock is added to held_locks_ in this path, so nothing to
-     *    remove later
-     */
-    if (if_available_request) {
-      Local<Value> null_arg = Null(isolate);
-      Local<Value> callback_result;
-      {
-        TryCatchScope try_catch_scope(env);
-        if (!if_available_request->callback()
-                 ->Call(context, Undefined(isolate), 1, &null_arg)
-                 .ToLocal(&callback_result)) {
-          // We don't really need to check the return value here since
-          // we're returning early in either case.
-          USE(RejectBoth(context,
-                         if_available_request->waiting_promise(),
-                         if_available_request->released_promise(),
-                         try_catch_scope.Exception()));
-          return;
-        }
-      }
-      if (callback_result->IsPromise()) {
-        Local<Promise> p = callback_result.As<Promise>();
-
-        Local<Function> on_fulfilled;
-        Local<Function> on_rejected;
-        CHECK(Function::New(context,
-                            OnIfAvailableFulfill,
-                            if_available_request->released_promise())
-                  .ToLocal(&on_fulfilled));
-        CHECK(Function::New(context,
-                            OnIfAvailableReject,
-                            if_available_request->released_promise())
-                  .ToLocal(&on_rejected));
-
-        {
-          TryCatchScope try_catch_scope(env);
-          if (p->Then(context, on_fulfilled, on_rejected).IsEmpty()) {
-            if (!try_catch_scope.CanContinue()) return;
-
-            Local<Value> err_val;
-            if (try_catch_scope.HasCaught() &&
-                !try_catch_scope.Exception().IsEmpty()) {
-              err_val = try_catch_scope.Exception();
-            } else {
-              err_val = Exception::Error(FIXED_ONE_BYTE_STRING(
-                  isolate, "Failed to attach promise handlers"));
-            }
-
-            USE(RejectBoth(context,
-                           if_available_request->waiting_promise(),
-                           if_available_request->released_promise(),
-                           err_val));
-            return;
-          }
-        }
+    if (steal_request) {
+      if (!StealLocks(env, steal_request.get())) return;
+      Mutex::ScopedLock scoped_lock(mutex_);
+      std::shared_ptr<Lock> granted_lock =
+          AddHeldLock(env, steal_request.get());
+      granted_requests.emplace_back(std::move(steal_request),
+                                    std::move(granted_lock));
+    }
 
-        // After handlers are attached, resolve waiting_promise with the
-        // promise.
-        USE(if_available_request->waiting_promise()
-                ->Resolve(context, p)
-                .IsNothing());
-        return;
-      }
+    if (granted_requests.empty() && if_available_requests.empty()) return;
 
-      // Non-promise callback result: settle both promises right away.
-      if (if_available_request->waiting_promise()
-              ->Resolve(context, callback_result)
-              .IsNothing()) {
+    for (auto& request : if_available_requests) {
+      ResolveUnavailableRequest(env, request.get());
+    }
+
+    // If JavaScript cannot run anymore, the locks of the remaining requests
+    // are released when the Environment is cleaned up.
+    for (auto& [request, granted_lock] : granted_requests) {
+      if (!GrantLock(env, request.get(), granted_lock)) return;
+    }
+  }
+}
+
+/**
+ * 1- We call the user callback immediately with `null` to signal
+ *    that the lock was not granted - Check wrapCallback function in
+ *    locks.js
+ * 2- Depending on what the callback returns we settle the two
+ *    internal promises
+ * 3- No lock is added to held_locks_ in this path, so nothing to
+ *    remove later
+ */
+void LockManager::ResolveUnavailableRequest(Environment* env,
+                                            LockRequest* request) {
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+
+  Local<Value> null_arg = Null(isolate);
+  Local<Value> callback_result;
+  {
+    TryCatchScope try_catch_scope(env);
+    if (!request->callback()
+             ->Call(context, Undefined(isolate), 1, &null_arg)
+             .ToLocal(&callback_result)) {
+      // We don't really need to check the return value here since
+      // we're returning early in either case.
+      USE(RejectBoth(context,
+                     request->waiting_promise(),
+                     request->released_promise(),
+                     try_catch_scope.Exception()));
+      return;
+    }
+  }
+  if (callback_result->IsPromise()) {
+    Local<Promise> p = callback_result.As<Promise>();
+
+    Local<Function> on_fulfilled;
+    Local<Function> on_rejected;
+    CHECK(Function::New(
+              context, OnIfAvailableFulfill, request->released_promise())
+              .ToLocal(&on_fulfilled));
+    CHECK(
+        Function::New(context, OnIfAvailableReject, request->released_promise())
+            .ToLocal(&on_rejected));
+
+    {
+      TryCatchScope try_catch_scope(env);
+      if (p->Then(context, on_fulfilled, on_rejected).IsEmpty()) {
+        if (!try_catch_scope.CanContinue()) return;
+
+        Local<Value> err_val;
+        if (try_catch_scope.HasCaught() &&
+            !try_catch_scope.Exception().IsEmpty()) {
+          err_val = try_catch_scope.Exception();
+        } else {
+          err_val = Exception::Error(FIXED_ONE_BYTE_STRING(
+              isolate, "Failed to attach promise handlers"));
+        }
+
+        USE(RejectBoth(context,
+                       request->waiting_promise(),
+                       request->released_promise(),
+                       err_val));
         return;
       }
-      USE(if_available_request->released_promise()
-              ->Resolve(context, callback_result)
-              .IsNothing());
-      return;
     }
 
-    if (!grantable_request) return;
+    // After handlers are attached, resolve waiting_promise with the
+    // promise.
+    USE(request->waiting_promise()->Resolve(context, p).IsNothing());
+    return;
+  }
 
-    /**
-     * 1- We grant the lock immediately even if other envs hold it
-     * 2- All existing locks with the same name are marked stolen, their
-     *    released_promise is rejected, and their owners are woken so they
-     *    can observe the rejection
-     * 3- We remove stolen locks that belong to this env right away; other
-     *    envs will clean up in their next queue pass
-     */
-    if (grantable_request->steal()) {
-      std::unordered_set<Environment*> envs_to_notify;
+  // Non-promise callback result: settle both promises right away.
+  if (request->waiting_promise()
+          ->Resolve(context, callback_result)
+          .IsNothing()) {
+    return;
+  }
+  USE(request->released_promise()
+          ->Resolve(context, callback_result)
+          .IsNothing());
+}
 
-      {
-        Mutex::ScopedLock scoped_lock(mutex_);
-        auto held_locks_iter = held_locks_.find(grantable_request->name());
-        if (held_locks_iter != held_locks_.end()) {
-          // Mark existing locks as stolen and collect environments to notify
-          for (auto& existing_lock : held_locks_iter->second) {
-            existing_lock->mark_stolen();
-            envs_to_notify.insert(existing_lock->env());
-
-            Local<Value> error =
-                Exception::Error(FIXED_ONE_BYTE_STRING(isolate, "LOCK_STOLEN"));
-
-            if (existing_lock->released_promise()
-                    ->Reject(context, error)
-                    .IsNothing())
-              return;
-          }
+/**
+ * 1- We grant the lock immediately even if other envs hold it
+ * 2- All existing locks with the same name are marked stolen, their
+ *    released_promise is rejected, and their owners are woken so they
+ *    can observe the rejection
+ * 3- We remove stolen locks that belong to this env right away; other
+ *    envs will clean up in their next queue pass
+ */
+bool LockManager::StealLocks(Environment* env, LockRequest* request) {
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  std::unordered_set<Environment*> envs_to_notify;
 
-          // Remove stolen locks from current environment immediately
-          for (auto lock_iter = held_locks_iter->second.begin();
-               lock_iter != held_locks_iter->second.end();) {
-            if ((*lock_iter)->env() == env) {
-              lock_iter = held_locks_iter->second.erase(lock_iter);
-            } else {
-              ++lock_iter;
-            }
-          }
+  {
+    Mutex::ScopedLock scoped_lock(mutex_);
+    auto held_locks_iter = held_locks_.find(request->name());
+    if (held_locks_iter != held_locks_.end()) {
+      has_stolen_locks_ = true;
+
+      // Mark existing locks as stolen and collect environments to notify
+      for (auto& existing_lock : held_locks_iter->second) {
+        existing_lock->mark_stolen();
+        envs_to_notify.insert(existing_lock->env());
+
+        Local<Value> error =
+            Exception::Error(FIXED_ONE_BYTE_STRING(isolate, "LOCK_STOLEN"));
+
+        if (existing_lock->released_promise()
+                ->Reject(context, error)
+                .IsNothing())
+          return false;
+      }
 
-          if (held_locks_iter->second.empty()) {
-            held_locks_.erase(held_locks_iter);
-          }
+      // Remove stolen locks from current environment immediately
+      for (auto lock_iter = held_locks_iter->second.begin();
+           lock_iter != held_locks_iter->second.end();) {
+        if ((*lock_iter)->env() == env) {
+          lock_iter = held_locks_iter->second.erase(lock_iter);
+        } else {
+          ++lock_iter;
         }
       }
 
-      // Wake other environments
-      for (Environment* target_env : envs_to_notify) {
-        if (target_env != env) {
-          WakeEnvironment(target_env);
-        }
+      if (held_locks_iter->second.empty()) {
+        held_locks_.erase(held_locks_iter);
       }
     }
+  }
 
-    // Create and store the new granted lock
-    auto granted_lock =
-        std::make_shared<Lock>(env,
-                               grantable_request->name(),
-                               grantable_request->mode(),
-                               grantable_request->client_id(),
-                               grantable_request->waiting_promise(),
-                               grantable_request->released_promise());
-    {
-      Mutex::ScopedLock scoped_lock(mutex_);
-      held_locks_[grantable_request->name()].push_back(granted_lock);
+  // Wake other environments
+  for (Environment* target_env : envs_to_notify) {
+    if (target_env != env) {
+      WakeEnvironment(target_env);
     }
+  }
+  return true;
+}
 
-    // Create and store the new granted lock
-    Local<Object> lock_info;
-    if (!CreateLockInfoObject(env, *grantable_request).ToLocal(&lock_info)) {
-      return;
-    }
+// Calls the user callback of a request whose lock was added to held_locks_.
+// Returns false if JavaScript cannot run anymore.
+bool LockManager::GrantLock(Environment* env,
+                            LockRequest* request,
+                            std::shared_ptr<Lock> granted_lock) {
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
 
-    // Call user callback
-    Local<Value> callback_arg = lock_info;
-    Local<Value> callback_result;
-    {
-      TryCatchScope try_catch_scope(env);
-      if (!grantable_request->callback()
-               ->Call(context, Undefined(isolate), 1, &callback_arg)
-               .ToLocal(&callback_result)) {
-        // We don't really need to check the return value here since
-        // we're returning early in either case.
-        USE(RejectBoth(context,
-                       grantable_request->waiting_promise(),
-                       grantable_request->released_promise(),
-                       try_catch_scope.Exception()));
-        return;
+  Local<Object> lock_info;
+  if (!CreateLockInfoObject(env, *request).ToLocal(&lock_info)) {
+    return false;
+  }
+
+  // Call user callback
+  Local<Value> callback_arg = lock_info;
+  Local<Value> callback_result;
+  bool callback_threw = false;
+  {
+    TryCatchScope try_catch_scope(env);
+    if (!request->callback()
+             ->Call(context, Undefined(isolate), 1, &callback_arg)
+             .ToLocal(&callback_result)) {
+      // The callback threw, so the lock is not going to be released by it.
+      {
+        Mutex::ScopedLock scoped_lock(mutex_);
+        ReleaseLock(granted_lock.get());
       }
+      USE(RejectBoth(context,
+                     request->waiting_promise(),
+                     request->released_promise(),
+                     try_catch_scope.Exception()));
+      if (!try_catch_scope.CanContinue()) return false;
+      callback_threw = true;
     }
+  }
 
-    // Create LockHolder BaseObjects to safely manage the lock's lifetime
-    // until the user's callback promise settles.
-    auto lock_resolve_holder = LockHolder::Create(env, granted_lock);
-    auto lock_reject_holder = LockHolder::Create(env, granted_lock);
-    Local<Function> on_fulfilled_callback;
-    Local<Function> on_rejected_callback;
-
-    // Create fulfilled callback first
-    if (!Function::New(
-             context, OnLockCallbackFulfilled, lock_resolve_holder->object())
-             .ToLocal(&on_fulfilled_callback)) {
-      return;
-    }
+  if (callback_threw) {
+    // Like ReleaseLockAndProcessQueue(), hand the lock on to the requests
+    // waiting for it, in this Environment and in the ones woken up by
+    // ProcessQueue(). This happens outside of the TryCatchScope above so
+    // that their callbacks do not run with its exception still caught.
+    ProcessQueue(env);
+    return true;
+  }
 
-    // Create rejected callback second
-    if (!Function::New(
-             context, OnLockCallbackRejected, lock_reject_holder->object())
-             .ToLocal(&on_rejected_callback)) {
-      return;
-    }
+  // Create LockHolder BaseObjects to safely manage the lock's lifetime
+  // until the user's callback promise settles.
+  auto lock_resolve_holder = LockHolder::Create(env, granted_lock);
+  auto lock_reject_holder = LockHolder::Create(env, granted_lock);
+  Local<Function> on_fulfilled_callback;
+  Local<Function> on_rejected_callback;
+
+  // Create fulfilled callback first
+  if (!Function::New(
+           context, OnLockCallbackFulfilled, lock_resolve_holder->object())
+           .ToLocal(&on_fulfilled_callback)) {
+    return false;
+  }
 
-    // Handle promise chain
-    if (callback_result->IsPromise()) {
-      Local<Promise> promise = callback_result.As<Promise>();
-      {
-        TryCatchScope try_catch_scope(env);
-        if (promise->Then(context, on_fulfilled_callback, on_rejected_callback)
-                .IsEmpty()) {
-          if (!try_catch_scope.CanContinue()) return;
-
-          Local<Value> err_val;
-          if (try_catch_scope.HasCaught() &&
-              !try_catch_scope.Exception().IsEmpty()) {
-            err_val = try_catch_scope.Exception();
-          } else {
-            err_val = Exception::Error(FIXED_ONE_BYTE_STRING(
-                isolate, "Failed to attach promise handlers"));
-          }
+  // Create rejected callback second
+  if (!Function::New(
+           context, OnLockCallbackRejected, lock_reject_holder->object())
+           .ToLocal(&on_rejected_callback)) {
+    return false;
+  }
 
-          USE(RejectBoth(context,
-                         grantable_request->waiting_promise(),
-                         grantable_request->released_promise(),
-                         err_val));
-          return;
+  // Handle promise chain
+  if (callback_result->IsPromise()) {
+    Local<Promise> promise = callback_result.As<Promise>();
+    {
+      TryCatchScope try_catch_scope(env);
+      if (promise->Then(context, on_fulfilled_callback, on_rejected_callback)
+              .IsEmpty()) {
+        if (!try_catch_scope.CanContinue()) return false;
+
+        Local<Value> err_val;
+        if (try_catch_scope.HasCaught() &&
+            !try_catch_scope.Exception().IsEmpty()) {
+          err_val = try_catch_scope.Exception();
+        } else {
+          err_val = Exception::Error(FIXED_ONE_BYTE_STRING(
+              isolate, "Failed to attach promise handlers"));
         }
-      }
 
-      // Lock granted: waiting_promise resolves now with the promise returned
-      // by the callback; on_fulfilled/on_rejected will release the lock when
-      // that promise settles.
-      if (grantable_request->waiting_promise()
-              ->Resolve(context, callback_result)
-              .IsNothing()) {
-        return;
-      }
-    } else {
-      if (grantable_request->waiting_promise()
-              ->Resolve(context, callback_result)
-              .IsNothing()) {
-        return;
-      }
-      Local<Value> promise_args[] = {callback_result};
-      if (on_fulfilled_callback
-              ->Call(context, Undefined(isolate), 1, promise_args)
-              .IsEmpty()) {
-        // Callback threw an error, handle it like a rejected promise
-        // The error is already propagated through the TryCatch in the
-        // callback
-        return;
+        USE(RejectBoth(context,
+                       request->waiting_promise(),
+                       request->released_promise(),
+                       err_val));
+        return false;
       }
     }
+
+    // Lock granted: waiting_promise resolves now with the promise returned
+    // by the callback; on_fulfilled/on_rejected will release the lock when
+    // that promise settles.
+    return request->waiting_promise()
+        ->Resolve(context, callback_result)
+        .IsJust();
+  }
+
+  if (request->waiting_promise()
+          ->Resolve(context, callback_result)
+          .IsNothing()) {
+    return false;
   }
+  Local<Value> promise_args[] = {callback_result};
+  // If this throws, the error is already propagated through the TryCatch in
+  // the callback.
+  return !on_fulfilled_callback
+              ->Call(context, Undefined(isolate), 1, promise_args)
+              .IsEmpty();
 }
 
 /**
@@ -599,7 +681,20 @@ void LockManager::Request(const FunctionCallbackInfo<Value>& args) {
   waiting_promise->GetPromise()->MarkAsHandled();
   released_promise->GetPromise()->MarkAsHandled();
 
+  auto lock_request = std::make_unique<LockRequest>(
+      env,
+      waiting_promise,
+      released_promise,
+      callback,
+      resource_name.ToU16String(),
+      mode.ToStringView() == "shared" ? Lock::Mode::Shared
+                                      : Lock::Mode::Exclusive,
+      client_id.ToString(),
+      steal,
+      if_available);
+
   LockManager* manager = GetCurrent();
+  std::shared_ptr<Lock> granted_lock;
   {
     Mutex::ScopedLock scoped_lock(manager->mutex_);
 
@@ -608,28 +703,35 @@ void LockManager::Request(const FunctionCallbackInfo<Value>& args) {
       env->AddCleanupHook(LockManager::OnEnvironmentCleanup, env);
     }
 
-    auto lock_request = std::make_unique<LockRequest>(
-        env,
-        waiting_promise,
-        released_promise,
-        callback,
-        resource_name.ToU16String(),
-        mode.ToStringView() == "shared" ? Lock::Mode::Shared
-                                        : Lock::Mode::Exclusive,
-        client_id.ToString(),
-        steal,
-        if_available);
-    // Steal requests get priority by going to front of queue
-    if (steal) {
-      manager->pending_queue_.emplace_front(std::move(lock_request));
+    // Uncontended requests, with nothing queued for the same name and nothing
+    // held in their way, are granted right here without going through the
+    // queue. Only contended requests wait in it.
+    if (!steal && !manager->pending_counts_.contains(lock_request->name()) &&
+        manager->IsGrantable(lock_request.get())) {
+      granted_lock = manager->AddHeldLock(env, lock_request.get());
     } else {
-      manager->pending_queue_.push_back(std::move(lock_request));
+      manager->AddPendingRequest(std::move(lock_request));
     }
   }
 
-  manager->ProcessQueue(env);
-
   args.GetReturnValue().Set(released_promise->GetPromise());
+
+  if (!granted_lock) {
+    manager->ProcessQueue(env);
+    return;
+  }
+
+  if (!manager->GrantLock(env, lock_request.get(), granted_lock) &&
+      env->can_call_into_js()) {
+    // The lock was granted but no handler is going to release it, e.g.
+    // because attaching them to the callback's promise failed. Release it
+    // here so that the requests queued behind it do not stall.
+    {
+      Mutex::ScopedLock scoped_lock(manager->mutex_);
+      manager->ReleaseLock(granted_lock.get());
+    }
+    manager->ProcessQueue(env);
+  }
 }
 
 void LockManager::Query(const FunctionCallbackInfo<Value>& args) {
@@ -765,8 +867,21 @@ void LockManager::WakeEnvironment(Environment* target_env) {
 // Remove all held locks and pending requests that belong to an Environment
 // that is being destroyed
 void LockManager::CleanupEnvironment(Environment* env_to_cleanup) {
-  Mutex::ScopedLock scoped_lock(mutex_);
+  std::unordered_set<Environment*> envs_to_wake;
+  {
+    Mutex::ScopedLock scoped_lock(mutex_);
+    CleanupEnvironmentLocked(env_to_cleanup);
+    // The requests that were waiting for this Environment may go ahead now.
+    CollectEnvironmentsToWake(env_to_cleanup, &envs_to_wake);
+  }
+
+  for (Environment* target_env : envs_to_wake) {
+    WakeEnvironment(target_env);
+  }
+}
 
+// Called with mutex_ held.
+void LockManager::CleanupEnvironmentLocked(Environment* env_to_cleanup) {
   // Remove every held lock that belongs to this Environment.
   for (auto resource_iter = held_locks_.begin();
        resource_iter != held_locks_.end();) {
@@ -790,7 +905,7 @@ void LockManager::CleanupEnvironment(Environment* env_to_cleanup) {
   for (auto request_iter = pending_queue_.begin();
        request_iter != pending_queue_.end();) {
     if ((*request_iter)->env() == env_to_cleanup) {
-      request_iter = pending_queue_.erase(request_iter);
+      TakePendingRequest(&request_iter);
     } else {
       ++request_iter;
     }
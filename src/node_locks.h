@@ -165,8 +165,22 @@ class LockManager final {
 
   bool IsGrantable(const LockRequest* req) const;
   void CleanupStolenLocks(Environment* env);
+  void CleanupEnvironmentLocked(Environment* env);
   void ReleaseLock(Lock* lock);
   void WakeEnvironment(Environment* env);
+  void CollectEnvironmentsToWake(
+      Environment* env, std::unordered_set<Environment*>* envs_to_wake) const;
+
+  void AddPendingRequest(std::unique_ptr<LockRequest> request);
+  std::unique_ptr<LockRequest> TakePendingRequest(
+      std::deque<std::unique_ptr<LockRequest>>::iterator* iter);
+  std::shared_ptr<Lock> AddHeldLock(Environment* env, LockRequest* request);
+
+  bool StealLocks(Environment* env, LockRequest* request);
+  bool GrantLock(Environment* env,
+                 LockRequest* request,
+                 std::shared_ptr<Lock> granted_lock);
+  void ResolveUnavailableRequest(Environment* env, LockRequest* request);
 
   static LockManager current_;
 
@@ -175,6 +189,12 @@ class LockManager final {
   std::unordered_map<std::u16string, std::deque<std::shared_ptr<Lock>>>
       held_locks_;
   std::deque<std::unique_ptr<LockRequest>> pending_queue_;
+  // The number of requests in pending_queue_ for each resource name, so that
+  // uncontended requests can be told apart without scanning the queue.
+  std::unordered_map<std::u16string, size_t> pending_counts_;
+  // Cleared by CleanupStolenLocks() when it finds no stolen locks, so that it
+  // does not scan held_locks_ again until the next steal.
+  bool has_stolen_locks_ = false;
   std::unordered_set<Environment*> registered_envs_;
 };
 
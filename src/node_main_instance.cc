@@ -4,6 +4,7 @@
 #include "crypto/crypto_util.h"
 #endif  // HAVE_OPENSSL
 #include "debug_utils-inl.h"
+#include "large_pages/node_large_page.h"
 #include "node_builtins.h"
 #include "node_external_reference.h"
 #include "node_internals.h"
@@ -12,6 +13,7 @@
 #include "node_sea.h"
 #include "node_snapshot_builder.h"
 #include "node_snapshotable.h"
+#include "node_startup_phases.h"
 #include "node_v8_platform-inl.h"
 #include "util-inl.h"
 #if defined(LEAK_SANITIZER)
@@ -45,10 +47,19 @@ NodeMainInstance::NodeMainInstance(const SnapshotData* snapshot_data,
       snapshot_data_(snapshot_data) {
   isolate_params_->array_buffer_allocator = array_buffer_allocator_.get();
 
+  startup_phases::PhaseScope phase_scope(
+      startup_phases::Phase::kIsolateDeserialization);
   isolate_ =
       NewIsolate(isolate_params_.get(), event_loop, platform, snapshot_data);
   CHECK_NOT_NULL(isolate_);
 
+  if (per_process::cli_options->use_largepages_for_jit) {
+    int lp_result = AdviseCodeRangeLargePages(isolate_);
+    if (lp_result != 0) {
+      fprintf(stderr, "%s: %s\n", args[0].c_str(), LargePagesError(lp_result));
+    }
+  }
+
   // If the indexes are not nullptr, we are not deserializing
   isolate_data_.reset(
       CreateIsolateData(isolate_,
@@ -91,8 +102,12 @@ ExitCode NodeMainInstance::Run() {
   HandleScope handle_scope(isolate_);
 
   ExitCode exit_code = ExitCode::kNoFailure;
-  DeleteFnPtr<Environment, FreeEnvironment> env =
-      CreateMainEnvironment(&exit_code);
+  DeleteFnPtr<Environment, FreeEnvironment> env;
+  {
+    startup_phases::PhaseScope phase_scope(
+        startup_phases::Phase::kEnvironmentCreation);
+    env = CreateMainEnvironment(&exit_code);
+  }
   CHECK_NOT_NULL(env);
 
   Context::Scope context_scope(env->context());
@@ -102,9 +117,15 @@ ExitCode NodeMainInstance::Run() {
 
 void NodeMainInstance::Run(ExitCode* exit_code, Environment* env) {
   if (*exit_code == ExitCode::kNoFailure) {
-    if (!sea::MaybeLoadSingleExecutableApplication(env)) {
-      LoadEnvironment(env, StartExecutionCallback{});
+    {
+      startup_phases::PhaseScope phase_scope(
+          startup_phases::Phase::kLoadEnvironment);
+      if (!sea::MaybeLoadSingleExecutableApplication(env)) {
+        LoadEnvironment(env, StartExecutionCallback{});
+      }
     }
+    // What runs from the event loop is the program, not its startup.
+    startup_phases::Print(stderr);
 
     *exit_code =
         SpinEventLoopInternal(env).FromMaybe(ExitCode::kGenericUserError);
@@ -113,6 +134,8 @@ void NodeMainInstance::Run(ExitCode* exit_code, Environment* env) {
 #if defined(LEAK_SANITIZER)
   __lsan_do_leak_check();
 #endif
+
+  if (env->options()->fast_exit) env->FastExit(*exit_code);
 }
 
 DeleteFnPtr<Environment, FreeEnvironment>
@@ -14,6 +14,7 @@ using node::contextify::ContextifyContext;
 using node::errors::TryCatchScope;
 using v8::Array;
 using v8::ArrayBuffer;
+using v8::ArrayBufferView;
 using v8::BackingStore;
 using v8::CompiledWasmModule;
 using v8::Context;
@@ -37,6 +38,7 @@ using v8::SharedArrayBuffer;
 using v8::SharedValueConveyor;
 using v8::String;
 using v8::Symbol;
+using v8::TypedArray;
 using v8::Value;
 using v8::ValueDeserializer;
 using v8::ValueSerializer;
@@ -50,6 +52,32 @@ using TransferMode = BaseObject::TransferMode;
 // Hack to have WriteHostObject inform ReadHostObject that the value
 // should be treated as a regular JS object. Used to transfer process.env.
 static const uint32_t kNormalObject = static_cast<uint32_t>(-1);
+// Written by WriteHostObject instead of a BaseObject index for an
+// ArrayBufferView that is shared in ArrayBufferShareMode::kReadOnly.
+static const uint32_t kSharedArrayBufferView = static_cast<uint32_t>(-2);
+
+// The kinds of ArrayBufferView that ArrayBufferShareMode::kReadOnly
+// re-creates on the receiving side.
+#define SHAREABLE_ARRAY_BUFFER_VIEW_TYPES(V)                                   \
+  V(Int8Array)                                                                 \
+  V(Uint8Array)                                                                \
+  V(Uint8ClampedArray)                                                         \
+  V(Int16Array)                                                                \
+  V(Uint16Array)                                                               \
+  V(Int32Array)                                                                \
+  V(Uint32Array)                                                               \
+  V(Float16Array)                                                              \
+  V(Float32Array)                                                              \
+  V(Float64Array)                                                              \
+  V(BigInt64Array)                                                             \
+  V(BigUint64Array)                                                            \
+  V(DataView)
+
+enum class SharedViewType : uint32_t {
+#define V(Type) k##Type,
+  SHAREABLE_ARRAY_BUFFER_VIEW_TYPES(V)
+#undef V
+};
 
 namespace worker {
 
@@ -58,9 +86,98 @@ Maybe<bool> TransferData::FinalizeTransferWrite(
   return Just(true);
 }
 
+namespace {
+
+// Serialized messages of at least kMinPooledBufferSize bytes are written into
+// buffers from a process-wide pool rather than being grown with realloc().
+// A buffer goes back to the pool once the last receiving port has dropped
+// its Message, so a sender that keeps posting payloads of similar size gets
+// buffers that already fit, and for a given payload size the main thread
+// stops paying for page faults and growth copies.
+constexpr size_t kMinPooledBufferSize = 64 * 1024;
+constexpr size_t kMaxPooledBufferSize = 64 * 1024 * 1024;
+constexpr size_t kMaxCachedBufferBytes = 64 * 1024 * 1024;
+
+class SerializationBufferPool {
+ public:
+  // Returns a malloc()ed buffer of at least `size` bytes, or nullptr, and
+  // stores its actual size in `*capacity`.
+  static char* Acquire(size_t size, size_t* capacity) {
+    if (size > kMaxPooledBufferSize) {
+      *capacity = size;
+      return UncheckedMalloc<char>(size);
+    }
+    size_t bucket = 0;
+    while ((kMinPooledBufferSize << bucket) < size) bucket++;
+    *capacity = kMinPooledBufferSize << bucket;
+
+    State* state = GetState();
+    {
+      Mutex::ScopedLock lock(state->mutex);
+      std::vector<char*>& free_list = state->buckets[bucket];
+      if (!free_list.empty()) {
+        char* buffer = free_list.back();
+        free_list.pop_back();
+        state->cached_bytes -= *capacity;
+        return buffer;
+      }
+    }
+    return UncheckedMalloc<char>(*capacity);
+  }
+
+  // Takes back a buffer returned by Acquire(), or frees it if it is too
+  // large or the pool is already full.
+  static void Release(char* buffer, size_t capacity) {
+    if (capacity <= kMaxPooledBufferSize) {
+      State* state = GetState();
+      Mutex::ScopedLock lock(state->mutex);
+      if (state->cached_bytes + capacity <= kMaxCachedBufferBytes) {
+        size_t bucket = 0;
+        while ((kMinPooledBufferSize << bucket) < capacity) bucket++;
+        state->buckets[bucket].push_back(buffer);
+        state->cached_bytes += capacity;
+        return;
+      }
+    }
+    free(buffer);
+  }
+
+ private:
+  static constexpr size_t kBucketCount = 11;
+  static_assert((kMinPooledBufferSize << (kBucketCount - 1)) ==
+                kMaxPooledBufferSize);
+
+  struct State {
+    Mutex mutex;
+    std::vector<char*> buckets[kBucketCount];
+    size_t cached_bytes = 0;
+  };
+
+  static State* GetState() {
+    // Leaked on purpose: Messages can be destroyed on any thread, including
+    // during process teardown.
+    static State* state = new State();
+    return state;
+  }
+};
+
+// The size of the last message serialized on this thread. The first buffer
+// for the next one is sized after it, so large payloads that are posted
+// repeatedly are written without any reallocation.
+thread_local size_t last_serialized_size = 0;
+
+}  // anonymous namespace
+
 Message::Message(MallocedBuffer<char>&& buffer)
     : main_message_buf_(std::move(buffer)) {}
 
+Message::~Message() {
+  if (main_message_buf_capacity_ != 0 && !main_message_buf_.is_empty()) {
+    SerializationBufferPool::Release(main_message_buf_.release(),
+                                     main_message_buf_capacity_);
+  }
+}
+
 bool Message::IsCloseMessage() const {
   return main_message_buf_.data == nullptr;
 }
@@ -76,11 +193,13 @@ class DeserializerDelegate : public ValueDeserializer::Delegate {
       Environment* env,
       const std::vector<BaseObjectPtr<BaseObject>>& host_objects,
       const LocalVector<SharedArrayBuffer>& shared_array_buffers,
+      const LocalVector<SharedArrayBuffer>& shared_view_buffers,
       const std::vector<CompiledWasmModule>& wasm_modules,
       const std::optional<SharedValueConveyor>& shared_value_conveyor)
       : env_(env),
         host_objects_(host_objects),
         shared_array_buffers_(shared_array_buffers),
+        shared_view_buffers_(shared_view_buffers),
         wasm_modules_(wasm_modules),
         shared_value_conveyor_(shared_value_conveyor) {}
 
@@ -89,6 +208,7 @@ class DeserializerDelegate : public ValueDeserializer::Delegate {
     uint32_t id;
     if (!deserializer->ReadUint32(&id))
       return MaybeLocal<Object>();
+    if (id == kSharedArrayBufferView) return ReadSharedArrayBufferView();
     if (id != kNormalObject) {
       CHECK_LT(id, host_objects_.size());
       Local<Object> object = host_objects_[id]->object(isolate);
@@ -128,9 +248,34 @@ class DeserializerDelegate : public ValueDeserializer::Delegate {
   ValueDeserializer* deserializer = nullptr;
 
  private:
+  MaybeLocal<Object> ReadSharedArrayBufferView() {
+    uint32_t index;
+    uint32_t type;
+    uint64_t byte_offset;
+    uint64_t length;
+    if (!deserializer->ReadUint32(&index) ||
+        !deserializer->ReadUint32(&type) ||
+        !deserializer->ReadUint64(&byte_offset) ||
+        !deserializer->ReadUint64(&length)) {
+      return MaybeLocal<Object>();
+    }
+    CHECK_LT(index, shared_view_buffers_.size());
+    Local<SharedArrayBuffer> buffer = shared_view_buffers_[index];
+
+    switch (static_cast<SharedViewType>(type)) {
+#define V(Type)                                                                \
+  case SharedViewType::k##Type:                                                \
+    return v8::Type::New(buffer, byte_offset, length);
+      SHAREABLE_ARRAY_BUFFER_VIEW_TYPES(V)
+#undef V
+    }
+    UNREACHABLE();
+  }
+
   Environment* env_;
   const std::vector<BaseObjectPtr<BaseObject>>& host_objects_;
   const LocalVector<SharedArrayBuffer>& shared_array_buffers_;
+  const LocalVector<SharedArrayBuffer>& shared_view_buffers_;
   const std::vector<CompiledWasmModule>& wasm_modules_;
   const std::optional<SharedValueConveyor>& shared_value_conveyor_;
 };
@@ -197,10 +342,20 @@ MaybeLocal<Value> Message::Deserialize(Environment* env,
     shared_array_buffers.push_back(sab);
   }
 
+  // These are not moved out of the Message, since a message without
+  // transferables may be delivered to several BroadcastChannels.
+  LocalVector<SharedArrayBuffer> shared_view_buffers(env->isolate());
+  for (const std::shared_ptr<BackingStore>& store :
+       shared_view_backing_stores_) {
+    shared_view_buffers.push_back(
+        SharedArrayBuffer::New(env->isolate(), store));
+  }
+
   DeserializerDelegate delegate(this,
                                 env,
                                 host_objects,
                                 shared_array_buffers,
+                                shared_view_buffers,
                                 wasm_modules_,
                                 shared_value_conveyor_);
   ValueDeserializer deserializer(
@@ -237,6 +392,38 @@ void Message::AddSharedArrayBuffer(
   shared_array_buffers_.emplace_back(std::move(backing_store));
 }
 
+uint32_t Message::AddSharedViewBackingStore(
+    std::shared_ptr<BackingStore> backing_store,
+    size_t byte_offset,
+    size_t byte_length) {
+  void* data = static_cast<char*>(backing_store->Data()) + byte_offset;
+  for (uint32_t i = 0; i < shared_view_backing_stores_.size(); i++) {
+    // Entries wrap, rather than are, the sender's backing stores, so compare
+    // the memory they cover.
+    const std::shared_ptr<BackingStore>& existing =
+        shared_view_backing_stores_[i];
+    if (existing->Data() == data && existing->ByteLength() == byte_length) {
+      return i;
+    }
+  }
+
+  // Wrap only the memory the view covers, so that receivers cannot see the
+  // rest of the buffer (e.g. other Buffers allocated from the same pool).
+  // The wrapper is shared, since only SharedArrayBuffers may be used from
+  // several Isolates at once, and keeps the original backing store alive.
+  // The sender's ArrayBuffer stays usable.
+  auto* keep_alive =
+      new std::shared_ptr<BackingStore>(std::move(backing_store));
+  shared_view_backing_stores_.emplace_back(SharedArrayBuffer::NewBackingStore(
+      data,
+      byte_length,
+      [](void*, size_t, void* keep_alive) {
+        delete static_cast<std::shared_ptr<BackingStore>*>(keep_alive);
+      },
+      keep_alive));
+  return shared_view_backing_stores_.size() - 1;
+}
+
 void Message::AddTransferable(std::unique_ptr<TransferData>&& data) {
   transferables_.emplace_back(std::move(data));
 }
@@ -320,6 +507,11 @@ class SerializerDelegate : public ValueSerializer::Delegate {
   }
 
   Maybe<bool> WriteHostObject(Isolate* isolate, Local<Object> object) override {
+    // V8 only hands ArrayBufferViews to us in ArrayBufferShareMode::kReadOnly,
+    // see Message::Serialize().
+    if (object->IsArrayBufferView())
+      return WriteSharedArrayBufferView(object.As<ArrayBufferView>());
+
     if (BaseObject::IsBaseObject(env_->isolate_data(), object)) {
       return WriteHostObject(
           BaseObjectPtr<BaseObject>{BaseObject::Unwrap<BaseObject>(object)});
@@ -383,6 +575,56 @@ class SerializerDelegate : public ValueSerializer::Delegate {
     return true;
   }
 
+  void* ReallocateBufferMemory(void* old_buffer,
+                               size_t size,
+                               size_t* actual_size) override {
+    CHECK_EQ(old_buffer, buffer_);
+    if (old_buffer == nullptr && last_serialized_size >= kMinPooledBufferSize)
+      size = std::max(size, last_serialized_size);
+
+    if (size < kMinPooledBufferSize) {
+      CHECK(!buffer_is_pooled_);
+      void* new_buffer = realloc(old_buffer, size);
+      if (new_buffer == nullptr) return nullptr;
+      buffer_ = new_buffer;
+      buffer_capacity_ = *actual_size = size;
+      return new_buffer;
+    }
+
+    size_t capacity;
+    char* new_buffer = SerializationBufferPool::Acquire(size, &capacity);
+    if (new_buffer == nullptr) return nullptr;
+    if (old_buffer != nullptr) {
+      memcpy(new_buffer, old_buffer, buffer_capacity_);
+      FreeBufferMemory(old_buffer);
+    }
+    buffer_ = new_buffer;
+    buffer_capacity_ = *actual_size = capacity;
+    buffer_is_pooled_ = true;
+    return new_buffer;
+  }
+
+  void FreeBufferMemory(void* buffer) override {
+    if (buffer == buffer_ && buffer_is_pooled_) {
+      SerializationBufferPool::Release(static_cast<char*>(buffer),
+                                       buffer_capacity_);
+    } else {
+      free(buffer);
+    }
+    if (buffer == buffer_) {
+      buffer_ = nullptr;
+      buffer_capacity_ = 0;
+      buffer_is_pooled_ = false;
+    }
+  }
+
+  // The capacity of the buffer returned by ValueSerializer::Release() if it
+  // needs to go back to the SerializationBufferPool, 0 if it is a plain
+  // malloc()ed one.
+  size_t pooled_buffer_capacity() const {
+    return buffer_is_pooled_ ? buffer_capacity_ : 0;
+  }
+
   Maybe<bool> Finish(Local<Context> context) {
     for (uint32_t i = 0; i < host_objects_.size(); i++) {
       BaseObjectPtr<BaseObject> host_object = std::move(host_objects_[i]);
@@ -425,8 +667,60 @@ class SerializerDelegate : public ValueSerializer::Delegate {
   }
 
   ValueSerializer* serializer = nullptr;
+  // The ArrayBuffers in the transfer list, which cannot also be shared.
+  const LocalVector<ArrayBuffer>* transferred_array_buffers = nullptr;
 
  private:
+  Maybe<bool> WriteSharedArrayBufferView(Local<ArrayBufferView> view) {
+    Isolate* isolate = env_->isolate();
+    Local<Value> buffer = view->Buffer();
+    std::shared_ptr<BackingStore> backing_store;
+    if (buffer->IsSharedArrayBuffer()) {
+      backing_store = buffer.As<SharedArrayBuffer>()->GetBackingStore();
+    } else {
+      Local<ArrayBuffer> array_buffer = buffer.As<ArrayBuffer>();
+      if (array_buffer->WasDetached()) {
+        ThrowDataCloneError(FIXED_ONE_BYTE_STRING(
+            isolate, "Cannot share a view of a detached ArrayBuffer"));
+        return Nothing<bool>();
+      }
+      if (transferred_array_buffers != nullptr &&
+          std::ranges::find(*transferred_array_buffers, array_buffer) !=
+              transferred_array_buffers->end()) {
+        ThrowDataCloneError(FIXED_ONE_BYTE_STRING(
+            isolate, "Cannot share a view of a transferred ArrayBuffer"));
+        return Nothing<bool>();
+      }
+      backing_store = array_buffer->GetBackingStore();
+    }
+    // Shrinking a resizable buffer may release memory that receivers can
+    // still see.
+    if (backing_store->IsResizableByUserJavaScript()) {
+      ThrowDataCloneError(FIXED_ONE_BYTE_STRING(
+          isolate, "Cannot share a view of a resizable ArrayBuffer"));
+      return Nothing<bool>();
+    }
+
+    SharedViewType type = SharedViewType::kDataView;
+    size_t length = view->ByteLength();
+    if (view->IsTypedArray()) {
+      length = view.As<TypedArray>()->Length();
+#define V(Type)                                                                \
+  if (view->Is##Type()) type = SharedViewType::k##Type;
+      SHAREABLE_ARRAY_BUFFER_VIEW_TYPES(V)
+#undef V
+    }
+
+    serializer->WriteUint32(kSharedArrayBufferView);
+    // The receiver's buffer starts where the view does.
+    serializer->WriteUint32(msg_->AddSharedViewBackingStore(
+        std::move(backing_store), view->ByteOffset(), view->ByteLength()));
+    serializer->WriteUint32(static_cast<uint32_t>(type));
+    serializer->WriteUint64(0);
+    serializer->WriteUint64(length);
+    return Just(true);
+  }
+
   Maybe<bool> WriteHostObject(BaseObjectPtr<BaseObject> host_object) {
     BaseObject::TransferMode mode = host_object->GetTransferMode();
     if (mode == TransferMode::kDisallowCloneAndTransfer) {
@@ -459,6 +753,9 @@ class SerializerDelegate : public ValueSerializer::Delegate {
   std::vector<Global<SharedArrayBuffer>> seen_shared_array_buffers_;
   std::vector<BaseObjectPtr<BaseObject>> host_objects_;
   size_t first_cloned_object_index_ = SIZE_MAX;
+  void* buffer_ = nullptr;
+  size_t buffer_capacity_ = 0;
+  bool buffer_is_pooled_ = false;
 
   friend class worker::Message;
 };
@@ -469,7 +766,8 @@ Maybe<bool> Message::Serialize(Environment* env,
                                Local<Context> context,
                                Local<Value> input,
                                const TransferList& transfer_list_v,
-                               Local<Object> source_port) {
+                               Local<Object> source_port,
+                               ArrayBufferShareMode share_mode) {
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(context);
 
@@ -481,6 +779,10 @@ Maybe<bool> Message::Serialize(Environment* env,
   delegate.serializer = &serializer;
 
   LocalVector<ArrayBuffer> array_buffers(env->isolate());
+  if (share_mode == ArrayBufferShareMode::kReadOnly) {
+    serializer.SetTreatArrayBufferViewsAsHostObjects(true);
+    delegate.transferred_array_buffers = &array_buffers;
+  }
   for (uint32_t i = 0; i < transfer_list_v.length(); ++i) {
     Local<Value> entry_val = transfer_list_v[i];
     if (!entry_val->IsObject()) {
@@ -604,17 +906,22 @@ Maybe<bool> Message::Serialize(Environment* env,
   if (delegate.Finish(context).IsNothing())
     return Nothing<bool>();
 
-  // The serializer gave us a buffer allocated using `malloc()`.
+  // The serializer gave us a buffer allocated using `malloc()`, which may
+  // belong to the SerializationBufferPool.
   std::pair<uint8_t*, size_t> data = serializer.Release();
   CHECK_NOT_NULL(data.first);
   main_message_buf_ =
       MallocedBuffer<char>(reinterpret_cast<char*>(data.first), data.second);
+  main_message_buf_capacity_ = delegate.pooled_buffer_capacity();
+  last_serialized_size = data.second;
   return Just(true);
 }
 
 void Message::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("array_buffers_", array_buffers_);
   tracker->TrackField("shared_array_buffers", shared_array_buffers_);
+  tracker->TrackField("shared_view_backing_stores",
+                      shared_view_backing_stores_);
   tracker->TrackField("transferables", transferables_);
 }
 
@@ -630,14 +937,19 @@ MessagePortData::~MessagePortData() {
 void MessagePortData::MemoryInfo(MemoryTracker* tracker) const {
   Mutex::ScopedLock lock(mutex_);
   tracker->TrackField("incoming_messages", incoming_messages_);
+  tracker->TrackField("received_messages", received_messages_);
 }
 
 void MessagePortData::AddToIncomingQueue(std::shared_ptr<Message> message) {
   // This function will be called by other threads.
   Mutex::ScopedLock lock(mutex_);
+  bool was_empty = incoming_messages_.empty();
   incoming_messages_.emplace_back(std::move(message));
 
-  if (owner_ != nullptr) {
+  // The owner keeps reading until it finds incoming_messages_ empty, or
+  // schedules another OnMessage() call itself, so it only needs to be woken
+  // up for the first message of a batch.
+  if (owner_ != nullptr && was_empty) {
     Debug(owner_, "Adding message to incoming queue");
     owner_->TriggerAsync();
   }
@@ -774,8 +1086,14 @@ MaybeLocal<Value> MessagePort::ReceiveMessage(Local<Context> context,
                                               Local<Value>* port_list) {
   std::shared_ptr<Message> received;
   {
-    // Get the head of the message queue.
-    Mutex::ScopedLock lock(data_->mutex_);
+    // Get the head of the message queue. Messages are taken out of
+    // incoming_messages_ in batches, so that senders only contend with this
+    // thread for mutex_ once per batch.
+    std::deque<std::shared_ptr<Message>>& messages = data_->received_messages_;
+    if (messages.empty()) {
+      Mutex::ScopedLock lock(data_->mutex_);
+      messages.swap(data_->incoming_messages_);
+    }
 
     Debug(this, "MessagePort has message");
 
@@ -786,14 +1104,13 @@ MaybeLocal<Value> MessagePort::ReceiveMessage(Local<Context> context,
     // - There are no pending messages
     // - We are not intending to receive messages, and the message we would
     //   receive is not the final "close" message.
-    if (data_->incoming_messages_.empty() ||
-        (!wants_message &&
-         !data_->incoming_messages_.front()->IsCloseMessage())) {
+    if (messages.empty() ||
+        (!wants_message && !messages.front()->IsCloseMessage())) {
       return env()->no_message_symbol();
     }
 
-    received = data_->incoming_messages_.front();
-    data_->incoming_messages_.pop_front();
+    received = std::move(messages.front());
+    messages.pop_front();
   }
 
   if (received->IsCloseMessage()) {
@@ -822,7 +1139,8 @@ void MessagePort::OnMessage(MessageProcessingMode mode) {
   size_t processing_limit;
   if (mode == MessageProcessingMode::kNormalOperation) {
     Mutex::ScopedLock lock(data_->mutex_);
-    processing_limit = std::max(data_->incoming_messages_.size(),
+    processing_limit = std::max(data_->incoming_messages_.size() +
+                                    data_->received_messages_.size(),
                                 static_cast<size_t>(1000));
   } else {
     processing_limit = std::numeric_limits<size_t>::max();
@@ -930,7 +1248,8 @@ BaseObjectPtr<BaseObject> MessagePortData::Deserialize(
 Maybe<bool> MessagePort::PostMessage(Environment* env,
                                      Local<Context> context,
                                      Local<Value> message_v,
-                                     const TransferList& transfer_v) {
+                                     const TransferList& transfer_v,
+                                     ArrayBufferShareMode share_mode) {
   Isolate* isolate = env->isolate();
   Local<Object> obj = object(isolate);
   TryCatchScope try_catch(env);
@@ -941,7 +1260,7 @@ Maybe<bool> MessagePort::PostMessage(Environment* env,
   // serialize the input message, even if the MessagePort is closed or detached.
 
   Maybe<bool> serialization_maybe =
-      msg->Serialize(env, context, message_v, transfer_v, obj);
+      msg->Serialize(env, context, message_v, transfer_v, obj, share_mode);
   if (try_catch.HasCaught() && !try_catch.HasTerminated()) {
     try_catch.ReThrow();
   }
@@ -1075,6 +1394,31 @@ bool GetTransferList(Environment* env,
   return true;
 }
 
+// Reads the non-standard `share` option of postMessage(). Only 'readonly' is
+// accepted besides leaving it out.
+bool GetArrayBufferShareMode(Environment* env,
+                             Local<Context> context,
+                             Local<Value> options_v,
+                             ArrayBufferShareMode* share_mode_out) {
+  *share_mode_out = ArrayBufferShareMode::kCopy;
+  if (!options_v->IsObject()) return true;
+
+  Local<Value> share;
+  if (!options_v.As<Object>()
+           ->Get(context, env->share_string())
+           .ToLocal(&share)) {
+    return false;
+  }
+  if (share->IsUndefined()) return true;
+  if (!share->StrictEquals(env->readonly_string())) {
+    THROW_ERR_INVALID_ARG_VALUE(
+        env, "The \"options.share\" property must be 'readonly'");
+    return false;
+  }
+  *share_mode_out = ArrayBufferShareMode::kReadOnly;
+  return true;
+}
+
 void MessagePort::PostMessage(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   Local<Object> obj = args.This();
@@ -1092,18 +1436,23 @@ void MessagePort::PostMessage(const FunctionCallbackInfo<Value>& args) {
   if (!GetTransferList(env, context, args[1], &transfer_list)) {
     return;
   }
+  ArrayBufferShareMode share_mode;
+  if (!GetArrayBufferShareMode(env, context, args[1], &share_mode)) {
+    return;
+  }
   MessagePort* port = Unwrap<MessagePort>(args.This());
   // Even if the backing MessagePort object has already been deleted, we still
   // want to serialize the message to ensure spec-compliant behavior w.r.t.
   // transfers.
   if (port == nullptr || port->IsHandleClosing()) {
     Message msg;
-    USE(msg.Serialize(env, context, args[0], transfer_list, obj));
+    USE(msg.Serialize(env, context, args[0], transfer_list, obj, share_mode));
     return;
   }
 
   bool res;
-  if (port->PostMessage(env, context, args[0], transfer_list).To(&res)) {
+  if (port->PostMessage(env, context, args[0], transfer_list, share_mode)
+          .To(&res)) {
     args.GetReturnValue().Set(res);
   }
 }
@@ -1112,8 +1461,10 @@ void MessagePort::Start() {
   Debug(this, "Start receiving messages");
   receiving_messages_ = true;
   Mutex::ScopedLock lock(data_->mutex_);
-  if (!data_->incoming_messages_.empty())
+  if (!data_->incoming_messages_.empty() ||
+      !data_->received_messages_.empty()) {
     TriggerAsync();
+  }
 }
 
 void MessagePort::Stop() {
@@ -42,6 +42,17 @@ class TransferData : public MemoryRetainer {
       v8::Local<v8::Context> context, v8::ValueSerializer* serializer);
 };
 
+// How ArrayBuffers that are not in the transfer list reach the receiver.
+enum class ArrayBufferShareMode {
+  // Their contents are copied, as the structured clone algorithm specifies.
+  kCopy,
+  // Views onto them (TypedArrays, DataViews and Buffers) are re-created on
+  // the receiving side on top of a SharedArrayBuffer over the same memory.
+  // Nothing is copied or detached. The sender is expected not to modify the
+  // data any more, since that would be observable by all receivers.
+  kReadOnly,
+};
+
 // Represents a single communication message.
 class Message : public MemoryRetainer {
  public:
@@ -49,7 +60,7 @@ class Message : public MemoryRetainer {
   // V8 ValueSerializer API. If `payload` is empty, this message indicates
   // that the receiving message port should close itself.
   explicit Message(MallocedBuffer<char>&& payload = MallocedBuffer<char>());
-  ~Message() = default;
+  ~Message();
 
   Message(Message&& other) = default;
   Message& operator=(Message&& other) = default;
@@ -72,16 +83,26 @@ class Message : public MemoryRetainer {
   // deserialization.
   // The source_port parameter, if provided, will make Serialize() throw a
   // "DataCloneError" DOMException if source_port is found in transfer_list.
-  v8::Maybe<bool> Serialize(Environment* env,
-                            v8::Local<v8::Context> context,
-                            v8::Local<v8::Value> input,
-                            const TransferList& transfer_list,
-                            v8::Local<v8::Object> source_port =
-                                v8::Local<v8::Object>());
+  // `share_mode` selects how ArrayBuffers outside of transfer_list are sent.
+  v8::Maybe<bool> Serialize(
+      Environment* env,
+      v8::Local<v8::Context> context,
+      v8::Local<v8::Value> input,
+      const TransferList& transfer_list,
+      v8::Local<v8::Object> source_port = v8::Local<v8::Object>(),
+      ArrayBufferShareMode share_mode = ArrayBufferShareMode::kCopy);
 
   // Internal method of Message that is called when a new SharedArrayBuffer
   // object is encountered in the incoming value's structure.
   void AddSharedArrayBuffer(std::shared_ptr<v8::BackingStore> backing_store);
+  // Internal method of Message that is called when an ArrayBufferView is
+  // encountered in ArrayBufferShareMode::kReadOnly. Returns the index of the
+  // shared backing store, covering only the view's `byte_length` bytes at
+  // `byte_offset`, that the receiver re-creates the view on.
+  uint32_t AddSharedViewBackingStore(
+      std::shared_ptr<v8::BackingStore> backing_store,
+      size_t byte_offset,
+      size_t byte_length);
   // Internal method of Message that is called once serialization finishes
   // and that transfers ownership of `data` to this message.
   void AddTransferable(std::unique_ptr<TransferData>&& data);
@@ -110,11 +131,18 @@ class Message : public MemoryRetainer {
 
  private:
   MallocedBuffer<char> main_message_buf_;
+  // Non-zero if main_message_buf_ came from the pool of serialization
+  // buffers it will be returned to, in which case this is its full size.
+  size_t main_message_buf_capacity_ = 0;
   // TODO(addaleax): Make this a std::variant to save storage size in the common
   // case (which is that all of these vectors are empty) once that is available
   // with C++17.
   std::vector<std::shared_ptr<v8::BackingStore>> array_buffers_;
   std::vector<std::shared_ptr<v8::BackingStore>> shared_array_buffers_;
+  // Shared backing stores for the views serialized in
+  // ArrayBufferShareMode::kReadOnly. Unlike array_buffers_, these can be
+  // deserialized by any number of receivers.
+  std::vector<std::shared_ptr<v8::BackingStore>> shared_view_backing_stores_;
   std::vector<std::unique_ptr<TransferData>> transferables_;
   std::vector<v8::CompiledWasmModule> wasm_modules_;
   std::optional<v8::SharedValueConveyor> shared_value_conveyor_;
@@ -207,12 +235,17 @@ class MessagePortData : public TransferData {
 
  private:
   // This mutex protects all fields below it, with the exception of
-  // sibling_.
+  // received_messages_ and sibling_.
   mutable Mutex mutex_;
   // TODO(addaleax): Make this a std::variant<std::shared_ptr, std::unique_ptr>
   // once that is available with C++17, because std::shared_ptr comes with
   // overhead that is only necessary for BroadcastChannel.
   std::deque<std::shared_ptr<Message>> incoming_messages_;
+  // Messages that the owning MessagePort has already moved out of
+  // incoming_messages_ but not read yet. These come before any message in
+  // incoming_messages_. Only accessed by the thread that owns the port, so
+  // not protected by mutex_.
+  std::deque<std::shared_ptr<Message>> received_messages_;
   MessagePort* owner_ = nullptr;
   std::shared_ptr<SiblingGroup> group_;
   friend class MessagePort;
@@ -245,10 +278,12 @@ class MessagePort : public HandleWrap {
   // Send a message, i.e. deliver it into the sibling's incoming queue.
   // If this port is closed, or if there is no sibling, this message is
   // serialized with transfers, then silently discarded.
-  v8::Maybe<bool> PostMessage(Environment* env,
-                              v8::Local<v8::Context> context,
-                              v8::Local<v8::Value> message,
-                              const TransferList& transfer);
+  v8::Maybe<bool> PostMessage(
+      Environment* env,
+      v8::Local<v8::Context> context,
+      v8::Local<v8::Value> message,
+      const TransferList& transfer,
+      ArrayBufferShareMode share_mode = ArrayBufferShareMode::kCopy);
 
   // Start processing messages on this port as a receiving end.
   void Start();
@@ -4,6 +4,7 @@
 #include "compile_cache.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
+#include "node_startup_phases.h"
 #include "node_url.h"
 #include "path.h"
 #include "permission/permission.h"
@@ -16,6 +17,8 @@
 #include "v8.h"
 
 #include "simdjson.h"
+#include "uv.h"
+#include "zlib.h"
 
 namespace node {
 namespace modules {
@@ -48,6 +51,10 @@ BindingData::BindingData(Realm* realm,
                          InternalFieldInfo* info)
     : SnapshotableObject(realm, object, type_int) {}
 
+BindingData::~BindingData() {
+  PersistDiskCache();
+}
+
 bool BindingData::PrepareForSerialization(v8::Local<v8::Context> context,
                                           v8::SnapshotCreator* creator) {
   // Return true because we need to maintain the reference to the binding from
@@ -73,6 +80,291 @@ void BindingData::Deserialize(v8::Local<v8::Context> context,
   CHECK_NOT_NULL(binding);
 }
 
+namespace {
+
+// Layout of the package.json cache file: a header of kDiskCacheMagic,
+// kDiskCacheVersion, the number of entries and the CRC32 of the rest of the
+// file, followed by the entries. Every entry is its kind, the path of the
+// package.json file and the status of the file, or of its directory for
+// kMissing entries, followed by the fields of the config for kConfig
+// entries. The file lives in the versioned compile cache directory, so it is
+// never read by a different Node.js binary.
+constexpr uint32_t kDiskCacheMagic = 0x4e504b47;
+constexpr uint32_t kDiskCacheVersion = 1;
+constexpr char kDiskCacheFileName[] = "package-config.cache";
+enum DiskCacheEntryKind : uint8_t { kConfig = 1, kMissing = 2 };
+enum DiskCacheFieldBits : uint8_t {
+  kHasName = 1 << 0,
+  kHasMain = 1 << 1,
+  kHasExports = 1 << 2,
+  kHasImports = 1 << 3,
+  kHasScripts = 1 << 4,
+};
+
+template <typename T>
+void AppendValue(std::string* out, T value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendString(std::string* out, std::string_view value) {
+  AppendValue(out, static_cast<uint32_t>(value.size()));
+  out->append(value);
+}
+
+// Bounds-checked reads from the cache file, which may have been truncated
+// or corrupted. Once a read fails, all later reads fail too.
+class DiskCacheReader {
+ public:
+  DiskCacheReader(const char* data, size_t size)
+      : data_(data), end_(data + size) {}
+
+  template <typename T>
+  bool Read(T* value) {
+    if (static_cast<size_t>(end_ - data_) < sizeof(T)) return Fail();
+    memcpy(value, data_, sizeof(T));
+    data_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(std::string* value) {
+    uint32_t size;
+    if (!Read(&size) || static_cast<size_t>(end_ - data_) < size) {
+      return Fail();
+    }
+    value->assign(data_, size);
+    data_ += size;
+    return true;
+  }
+
+  bool ReadOptionalString(bool present, std::optional<std::string>* value) {
+    if (!present) return !failed_;
+    std::string str;
+    if (!ReadString(&str)) return false;
+    *value = std::move(str);
+    return true;
+  }
+
+  const char* data() const { return data_; }
+  size_t remaining() const { return end_ - data_; }
+
+ private:
+  bool Fail() {
+    data_ = end_;
+    failed_ = true;
+    return false;
+  }
+
+  const char* data_;
+  const char* end_;
+  bool failed_ = false;
+};
+
+std::string_view ParentDirectory(std::string_view path) {
+#ifdef _WIN32
+  size_t pos = path.find_last_of("/\\");
+#else
+  size_t pos = path.find_last_of('/');
+#endif
+  if (pos == std::string_view::npos) return std::string_view();
+  return path.substr(0, pos);
+}
+
+}  // namespace
+
+std::optional<BindingData::FileStamp> BindingData::StatFile(
+    const char* path) {
+  uv_fs_t req;
+  int err = uv_fs_stat(nullptr, &req, path, nullptr);
+  auto cleanup = OnScopeLeave([&req]() { uv_fs_req_cleanup(&req); });
+  if (err < 0) return std::nullopt;
+  return FileStamp{req.statbuf.st_ino,
+                   req.statbuf.st_size,
+                   static_cast<uint64_t>(req.statbuf.st_mtim.tv_sec),
+                   static_cast<uint64_t>(req.statbuf.st_mtim.tv_nsec)};
+}
+
+void BindingData::LoadDiskCache(Environment* env) {
+  // The compile cache may still be enabled later with
+  // module.enableCompileCache(), so check again on the next lookup.
+  if (!env->use_compile_cache()) return;
+  disk_cache_loaded_ = true;
+  disk_cache_path_ = std::string(env->compile_cache_handler()->cache_dir()) +
+                     kPathSeparator + kDiskCacheFileName;
+
+  std::string contents;
+  if (ReadFileSync(&contents, disk_cache_path_.c_str()) < 0) return;
+  DiskCacheReader reader(contents.data(), contents.size());
+  uint32_t magic, version, count, checksum;
+  if (!reader.Read(&magic) || !reader.Read(&version) ||
+      !reader.Read(&count) || !reader.Read(&checksum) ||
+      magic != kDiskCacheMagic || version != kDiskCacheVersion) {
+    return;
+  }
+  uLong crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc,
+              reinterpret_cast<const Bytef*>(reader.data()),
+              reader.remaining());
+  if (static_cast<uint32_t>(crc) != checksum) return;
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint8_t kind;
+    std::string path;
+    FileStamp stamp;
+    if (!reader.Read(&kind) || !reader.ReadString(&path) ||
+        !reader.Read(&stamp.ino) || !reader.Read(&stamp.size) ||
+        !reader.Read(&stamp.mtime_sec) || !reader.Read(&stamp.mtime_nsec)) {
+      break;
+    }
+    if (kind == kMissing) {
+      disk_missing_.emplace(std::move(path), stamp);
+      continue;
+    }
+    PackageConfig config;
+    uint8_t fields;
+    if (kind != kConfig || !reader.Read(&fields) ||
+        !reader.ReadString(&config.type) ||
+        !reader.ReadOptionalString(fields & kHasName, &config.name) ||
+        !reader.ReadOptionalString(fields & kHasMain, &config.main) ||
+        !reader.ReadOptionalString(fields & kHasExports, &config.exports) ||
+        !reader.ReadOptionalString(fields & kHasImports, &config.imports) ||
+        !reader.ReadOptionalString(fields & kHasScripts, &config.scripts)) {
+      break;
+    }
+    config.file_path = path;
+    disk_configs_.emplace(std::move(path),
+                          std::make_pair(stamp, std::move(config)));
+  }
+  per_process::Debug(DebugCategory::COMPILE_CACHE,
+                     "[package config cache] loaded %d configs and %d missing "
+                     "entries from %s\n",
+                     disk_configs_.size(),
+                     disk_missing_.size(),
+                     disk_cache_path_);
+}
+
+const BindingData::PackageConfig* BindingData::LookupDiskCache(
+    const std::string& path, bool* missing) {
+  *missing = false;
+  auto config = disk_configs_.find(path);
+  if (config != disk_configs_.end()) {
+    std::optional<FileStamp> stamp = StatFile(path.c_str());
+    if (stamp.has_value() && *stamp == config->second.first) {
+      config_stamps_.emplace(path, *stamp);
+      auto cached = package_configs_.insert(
+          {path, std::move(config->second.second)});
+      disk_configs_.erase(config);
+      return &cached.first->second;
+    }
+    disk_configs_.erase(config);
+    disk_cache_dirty_ = true;
+    return nullptr;
+  }
+
+  auto missing_entry = disk_missing_.find(path);
+  if (missing_entry != disk_missing_.end()) {
+    // Creating the file would have updated the directory.
+    std::string dir(ParentDirectory(path));
+    std::optional<FileStamp> stamp = StatFile(dir.c_str());
+    if (stamp.has_value() && *stamp == missing_entry->second) {
+      missing_.emplace(path, *stamp);
+      *missing = true;
+    } else {
+      disk_cache_dirty_ = true;
+    }
+    disk_missing_.erase(missing_entry);
+  }
+  return nullptr;
+}
+
+void BindingData::PersistDiskCache() {
+  if (!disk_cache_dirty_ || disk_cache_path_.empty()) return;
+
+  std::string body;
+  uint32_t count = 0;
+  const auto append_config = [&](const std::string& path,
+                                 const FileStamp& stamp,
+                                 const PackageConfig& config) {
+    AppendValue(&body, kConfig);
+    AppendString(&body, path);
+    AppendValue(&body, stamp);
+    uint8_t fields = (config.name.has_value() ? kHasName : 0) |
+                     (config.main.has_value() ? kHasMain : 0) |
+                     (config.exports.has_value() ? kHasExports : 0) |
+                     (config.imports.has_value() ? kHasImports : 0) |
+                     (config.scripts.has_value() ? kHasScripts : 0);
+    AppendValue(&body, fields);
+    AppendString(&body, config.type);
+    if (config.name.has_value()) AppendString(&body, *config.name);
+    if (config.main.has_value()) AppendString(&body, *config.main);
+    if (config.exports.has_value()) AppendString(&body, *config.exports);
+    if (config.imports.has_value()) AppendString(&body, *config.imports);
+    if (config.scripts.has_value()) AppendString(&body, *config.scripts);
+    count++;
+  };
+  const auto append_missing = [&](const std::string& path,
+                                  const FileStamp& stamp) {
+    AppendValue(&body, kMissing);
+    AppendString(&body, path);
+    AppendValue(&body, stamp);
+    count++;
+  };
+
+  for (const auto& [path, stamp] : config_stamps_) {
+    auto config = package_configs_.find(path);
+    if (config != package_configs_.end()) {
+      append_config(path, stamp, config->second);
+    }
+  }
+  for (const auto& [path, stamp] : missing_) append_missing(path, stamp);
+  // Keep the entries that were not needed in this run.
+  for (const auto& [path, entry] : disk_configs_) {
+    append_config(path, entry.first, entry.second);
+  }
+  for (const auto& [path, stamp] : disk_missing_) append_missing(path, stamp);
+
+  std::string contents;
+  AppendValue(&contents, kDiskCacheMagic);
+  AppendValue(&contents, kDiskCacheVersion);
+  AppendValue(&contents, count);
+  uLong crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc, reinterpret_cast<const Bytef*>(body.data()), body.size());
+  AppendValue(&contents, static_cast<uint32_t>(crc));
+  contents += body;
+
+  // Write to a temporary file and rename it, so that concurrent processes
+  // never read a partially written cache.
+  uv_fs_t mkstemp_req;
+  auto cleanup_mkstemp =
+      OnScopeLeave([&mkstemp_req]() { uv_fs_req_cleanup(&mkstemp_req); });
+  std::string tmpl = disk_cache_path_ + ".XXXXXX";
+  if (uv_fs_mkstemp(nullptr, &mkstemp_req, tmpl.c_str(), nullptr) < 0) {
+    return;
+  }
+  uv_file file = static_cast<uv_file>(mkstemp_req.result);
+  uv_buf_t buf = uv_buf_init(contents.data(), contents.size());
+  uv_fs_t req;
+  int err = uv_fs_write(nullptr, &req, file, &buf, 1, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err >= 0 && static_cast<size_t>(err) != contents.size()) err = UV_EIO;
+  int close_err = uv_fs_close(nullptr, &req, file, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err >= 0) err = close_err;
+  if (err >= 0) {
+    err = uv_fs_rename(
+        nullptr, &req, mkstemp_req.path, disk_cache_path_.c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+  }
+  if (err < 0) {
+    uv_fs_unlink(nullptr, &req, mkstemp_req.path, nullptr);
+    uv_fs_req_cleanup(&req);
+  }
+  per_process::Debug(DebugCategory::COMPILE_CACHE,
+                     "[package config cache] writing %d entries to %s: %s\n",
+                     count,
+                     disk_cache_path_,
+                     err < 0 ? uv_strerror(err) : "success");
+}
+
 Local<Array> BindingData::PackageConfig::Serialize(Realm* realm) const {
   auto isolate = realm->isolate();
   const auto ToString = [isolate](std::string_view input) -> Local<Primitive> {
@@ -100,10 +392,36 @@ const BindingData::PackageConfig* BindingData::GetPackageJSON(
     return &cache_entry->second;
   }
 
+  startup_phases::CounterScope counter_scope(
+      startup_phases::Counter::kPackageJSONRead);
+  if (!binding_data->disk_cache_loaded_) {
+    binding_data->LoadDiskCache(realm->env());
+  }
+  const bool use_disk_cache = !binding_data->disk_cache_path_.empty();
+  std::optional<FileStamp> stamp;
+  if (use_disk_cache) {
+    bool missing;
+    const PackageConfig* config =
+        binding_data->LookupDiskCache(std::string(path), &missing);
+    if (config != nullptr || missing) return config;
+    // Stat before reading, so that a change in between is detected by the
+    // next run.
+    stamp = StatFile(path.data());
+  }
+
   PackageConfig package_config{};
   package_config.file_path = path;
   // No need to exclude BOM since simdjson will skip it.
-  if (ReadFileSync(&package_config.raw_json, path.data()) < 0) {
+  int read_err = ReadFileSync(&package_config.raw_json, path.data());
+  if (read_err < 0) {
+    if (use_disk_cache && (read_err == UV_ENOENT || read_err == UV_ENOTDIR)) {
+      std::string dir(ParentDirectory(path));
+      std::optional<FileStamp> dir_stamp = StatFile(dir.c_str());
+      if (dir_stamp.has_value()) {
+        binding_data->missing_.emplace(std::string(path), *dir_stamp);
+        binding_data->disk_cache_dirty_ = true;
+      }
+    }
     return nullptr;
   }
   simdjson::ondemand::document document;
@@ -237,6 +555,10 @@ const BindingData::PackageConfig* BindingData::GetPackageJSON(
   // copying it.
   auto cached = binding_data->package_configs_.insert(
       {std::string(path), std::move(package_config)});
+  if (stamp.has_value()) {
+    binding_data->config_stamps_.emplace(std::string(path), *stamp);
+    binding_data->disk_cache_dirty_ = true;
+  }
 
   return &cached.first->second;
 }
@@ -443,10 +765,14 @@ void FlushCompileCache(const FunctionCallbackInfo<Value>& args) {
                                "keepDeserializedCache should be a boolean");
     return;
   }
+  if (!args[1]->IsBoolean() && !args[1]->IsUndefined()) {
+    THROW_ERR_INVALID_ARG_TYPE(env, "afterWarmup should be a boolean");
+    return;
+  }
   Debug(env,
         DebugCategory::COMPILE_CACHE,
         "[compile cache] module.flushCompileCache() requested.\n");
-  env->FlushCompileCache();
+  env->FlushCompileCache(args[1]->IsTrue());
   Debug(env,
         DebugCategory::COMPILE_CACHE,
         "[compile cache] module.flushCompileCache() finished.\n");
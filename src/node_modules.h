@@ -47,6 +47,7 @@ class BindingData : public SnapshotableObject {
   BindingData(Realm* realm,
               v8::Local<v8::Object> obj,
               InternalFieldInfo* info = nullptr);
+  ~BindingData() override;
   SERIALIZABLE_OBJECT_METHODS()
   SET_BINDING_ID(modules_binding_data)
 
@@ -81,6 +82,36 @@ class BindingData : public SnapshotableObject {
       ErrorContext* error_context = nullptr);
   static const PackageConfig* TraverseParent(
       Realm* realm, const std::filesystem::path& check_path);
+
+  // When the compile cache is enabled, the outcome of every package.json
+  // lookup is also kept in a file in the compile cache directory, so that
+  // later runs can skip reading and parsing the package.json files, and
+  // the lookups of package.json files that do not exist. Each entry records
+  // the status of the package.json file, or of its directory for missing
+  // ones, and is only used while that still matches.
+  struct FileStamp {
+    uint64_t ino = 0;
+    uint64_t size = 0;
+    uint64_t mtime_sec = 0;
+    uint64_t mtime_nsec = 0;
+    bool operator==(const FileStamp&) const = default;
+  };
+  static std::optional<FileStamp> StatFile(const char* path);
+  void LoadDiskCache(Environment* env);
+  void PersistDiskCache();
+  // Returns the result of the lookup of path if it can be answered from the
+  // disk cache: either the config, or nullptr with *missing set to true.
+  const PackageConfig* LookupDiskCache(const std::string& path, bool* missing);
+
+  bool disk_cache_loaded_ = false;
+  bool disk_cache_dirty_ = false;
+  std::string disk_cache_path_;
+  std::unordered_map<std::string, std::pair<FileStamp, PackageConfig>>
+      disk_configs_;
+  std::unordered_map<std::string, FileStamp> disk_missing_;
+  // What to persist, for the lookups of this run.
+  std::unordered_map<std::string, FileStamp> config_stamps_;
+  std::unordered_map<std::string, FileStamp> missing_;
 };
 
 }  // namespace modules
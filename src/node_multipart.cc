@@ -0,0 +1,175 @@
+#include "node_multipart.h"
+#include "util.h"
+
+#include <algorithm>
+
+namespace node {
+namespace multipart {
+
+bool MultipartParser::IsValidBoundary(std::string_view boundary) {
+  return !boundary.empty() && boundary.size() <= 70;
+}
+
+MultipartParser::MultipartParser(std::string_view boundary)
+    : delimiter_(std::string("\r\n--").append(boundary)),
+      carry_("\r\n"),
+      carry_start_(-2) {
+  CHECK(IsValidBoundary(boundary));
+}
+
+bool MultipartParser::Fail() {
+  state_ = State::kFailed;
+  headers_.clear();
+  carry_.clear();
+  return false;
+}
+
+size_t MultipartParser::FindDelimiter(const uint8_t* data,
+                                      size_t len,
+                                      bool* found,
+                                      uint64_t* delimiter_start) {
+  const uint8_t* delimiter =
+      reinterpret_cast<const uint8_t*>(delimiter_.data());
+  const size_t m = delimiter_.size();
+  *found = false;
+
+  if (!carry_.empty()) {
+    // A delimiter that begins in the carried bytes ends within the first
+    // m - 1 bytes of data.
+    std::string joined = carry_;
+    joined.append(reinterpret_cast<const char*>(data), std::min(len, m - 1));
+    size_t i = SearchString(reinterpret_cast<const uint8_t*>(joined.data()),
+                            joined.size(),
+                            delimiter,
+                            m,
+                            0,
+                            true);
+    if (i < joined.size()) {
+      *found = true;
+      *delimiter_start = carry_start_ + i;
+      size_t consumed = i + m - carry_.size();
+      carry_.clear();
+      return consumed;
+    }
+    if (len < m - 1) {
+      // All of data was appended, keep the last m - 1 bytes of both.
+      size_t keep = std::min(joined.size(), m - 1);
+      carry_start_ += joined.size() - keep;
+      carry_ = joined.substr(joined.size() - keep);
+      return len;
+    }
+    carry_.clear();
+  }
+
+  size_t i = SearchString(data, len, delimiter, m, 0, true);
+  if (i < len) {
+    *found = true;
+    *delimiter_start = position_ + i;
+    return i + m;
+  }
+
+  // No delimiter ends in data, but its last m - 1 bytes may begin one.
+  size_t keep = std::min(len, m - 1);
+  carry_.assign(reinterpret_cast<const char*>(data) + len - keep, keep);
+  carry_start_ = position_ + len - keep;
+  return len;
+}
+
+bool MultipartParser::Write(const uint8_t* data, size_t len) {
+  while (len > 0) {
+    size_t consumed = 1;
+    switch (state_) {
+      case State::kFailed:
+        return false;
+      case State::kPreamble:
+      case State::kBody: {
+        bool found;
+        uint64_t delimiter_start;
+        consumed = FindDelimiter(data, len, &found, &delimiter_start);
+        if (found) {
+          if (state_ == State::kBody) {
+            parts_.push_back(
+                {std::move(headers_), body_start_, delimiter_start});
+            headers_.clear();
+          }
+          state_ = State::kAfterDelimiter;
+        }
+        break;
+      }
+      case State::kAfterDelimiter:
+        // Either "--" for the close delimiter, or optional transport
+        // padding and a CRLF.
+        switch (data[0]) {
+          case '-':
+            state_ = State::kAfterDelimiterDash;
+            break;
+          case ' ':
+          case '\t':
+            state_ = State::kPadding;
+            break;
+          case '\r':
+            state_ = State::kPaddingCR;
+            break;
+          default:
+            return Fail();
+        }
+        break;
+      case State::kAfterDelimiterDash:
+        if (data[0] != '-') return Fail();
+        state_ = State::kEpilogue;
+        break;
+      case State::kPadding:
+        if (data[0] == '\r') {
+          state_ = State::kPaddingCR;
+        } else if (data[0] != ' ' && data[0] != '\t') {
+          return Fail();
+        }
+        break;
+      case State::kPaddingCR:
+        if (data[0] != '\n') return Fail();
+        headers_.clear();
+        state_ = State::kHeaders;
+        break;
+      case State::kHeaders: {
+        // Header blocks are small, copy them up to the blank line.
+        const uint8_t* end = data + len;
+        const uint8_t* p = data;
+        bool done = false;
+        while (p < end && !done) {
+          headers_.push_back(static_cast<char>(*p++));
+          if (headers_.size() == 2 && headers_ == "\r\n") {
+            headers_.clear();
+            done = true;
+          } else if (headers_.size() >= 4 &&
+                     headers_.compare(headers_.size() - 4, 4, "\r\n\r\n") ==
+                         0) {
+            headers_.resize(headers_.size() - 4);
+            done = true;
+          } else if (headers_.size() > kMaxHeaderSize) {
+            return Fail();
+          }
+        }
+        consumed = p - data;
+        if (done) {
+          body_start_ = position_ + consumed;
+          state_ = State::kBody;
+        }
+        break;
+      }
+      case State::kEpilogue:
+        consumed = len;
+        break;
+    }
+    data += consumed;
+    len -= consumed;
+    position_ += consumed;
+  }
+  return state_ != State::kFailed;
+}
+
+bool MultipartParser::Finish() {
+  return state_ == State::kEpilogue;
+}
+
+}  // namespace multipart
+}  // namespace node
@@ -0,0 +1,102 @@
+#ifndef SRC_NODE_MULTIPART_H_
+#define SRC_NODE_MULTIPART_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace node {
+namespace multipart {
+
+// An incremental parser for multipart bodies (RFC 2046, as used by
+// multipart/form-data). The body is fed in chunks of any size; every part
+// is reported as its raw header block and the range of the body it
+// occupies, as offsets from the start of the input, so that callers can
+// slice the part bodies out of the input without copying them. Only the
+// header blocks and up to a boundary's worth of bytes spanning two chunks
+// are copied. Delimiters are found with node::SearchString, which uses the
+// SIMD kernels for boundaries of up to 28 bytes.
+class MultipartParser final {
+ public:
+  // The size of the header block of a part is limited to this many bytes.
+  static constexpr size_t kMaxHeaderSize = 16 * 1024;
+
+  struct Part {
+    // The header lines of the part, separated by CRLF, without the blank
+    // line that ends them. Empty if the part has no headers.
+    std::string headers;
+    uint64_t body_start;
+    uint64_t body_end;
+  };
+
+  // Boundaries must be 1 to 70 characters long (RFC 2046 section 5.1.1).
+  static bool IsValidBoundary(std::string_view boundary);
+
+  explicit MultipartParser(std::string_view boundary);
+
+  MultipartParser(const MultipartParser&) = delete;
+  MultipartParser& operator=(const MultipartParser&) = delete;
+
+  // Parses the next len bytes of the body. Returns false, here and on all
+  // later calls, once the body is known to be malformed.
+  bool Write(const uint8_t* data, size_t len);
+
+  // Returns true if the body was complete, i.e. the close delimiter has
+  // been seen, and it was not malformed.
+  bool Finish();
+
+  // The parts that are complete so far.
+  const std::vector<Part>& parts() const { return parts_; }
+
+  bool failed() const { return state_ == State::kFailed; }
+
+ private:
+  enum class State {
+    kPreamble,
+    kAfterDelimiter,
+    kAfterDelimiterDash,
+    kPadding,
+    kPaddingCR,
+    kHeaders,
+    kBody,
+    kEpilogue,
+    kFailed,
+  };
+
+  // Looks for the delimiter in the next len bytes at data, including one
+  // that starts in earlier input. Returns the number of bytes consumed:
+  // up to the end of the delimiter if it was found, in which case
+  // *delimiter_start is its offset in the input, and len otherwise.
+  size_t FindDelimiter(const uint8_t* data,
+                       size_t len,
+                       bool* found,
+                       uint64_t* delimiter_start);
+
+  bool Fail();
+
+  // CRLF "--" boundary.
+  const std::string delimiter_;
+  State state_ = State::kPreamble;
+  // The offset in the input of the next byte passed to Write().
+  uint64_t position_ = 0;
+  // The last bytes of earlier input that may begin a delimiter, and the
+  // offset in the input of the first of them. The input is treated as if
+  // it started with a CRLF, so that a delimiter right at its start is
+  // found like any other.
+  std::string carry_;
+  int64_t carry_start_ = 0;
+  std::string headers_;
+  uint64_t body_start_ = 0;
+  std::vector<Part> parts_;
+};
+
+}  // namespace multipart
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_MULTIPART_H_
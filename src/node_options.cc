@@ -6,6 +6,7 @@
 #include "node_errors.h"
 #include "node_external_reference.h"
 #include "node_internals.h"
+#include "node_report.h"
 #include "node_sea.h"
 #include "uv.h"
 #if HAVE_OPENSSL
@@ -100,13 +101,31 @@ void PerProcessOptions::CheckOptions(std::vector<std::string>* errors,
       errors->push_back("--secure-heap-min must be a power of 2");
   }
 #endif  // V8_ENABLE_SANDBOX
+  if (kdf_max_threads < 0 ||
+      kdf_max_threads > std::numeric_limits<uint32_t>::max()) {
+    errors->push_back("--kdf-max-threads must be a non-negative 32-bit "
+                      "integer");
+  }
 #endif  // HAVE_OPENSSL
 
+  if (trace_event_format != "json" && trace_event_format != "perfetto") {
+    errors->push_back("--trace-event-format must be 'json' or 'perfetto'");
+  }
+
   if (use_largepages != "off" &&
       use_largepages != "on" &&
       use_largepages != "silent") {
     errors->push_back("invalid value for --use-largepages");
   }
+
+  if (heap_policy != "default" && heap_policy != "container-aware") {
+    errors->push_back(
+        "--heap-policy must be 'default' or 'container-aware'");
+  }
+
+  if (memory_profile != "default" && memory_profile != "low") {
+    errors->push_back("--memory-profile must be 'default' or 'low'");
+  }
   per_isolate->CheckOptions(errors, argv);
 }
 
@@ -199,6 +218,11 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors,
                       "used, not both");
   }
 
+  uint32_t report_sections_mask;
+  if (!report::ParseReportSections(report_sections, &report_sections_mask)) {
+    errors->push_back("invalid value for --report-sections");
+  }
+
   if (heap_snapshot_near_heap_limit < 0) {
     errors->push_back("--heapsnapshot-near-heap-limit must not be negative");
   }
@@ -259,12 +283,38 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors,
 #endif
   }
 
+  if (cpu_prof_continuous) {
+    if (cpu_prof_continuous_interval == 0 ||
+        cpu_prof_continuous_interval > std::numeric_limits<int>::max()) {
+      errors->push_back("--cpu-prof-continuous-interval must be a positive "
+                        "32-bit integer");
+    }
+    if (cpu_prof_continuous_rotation == 0) {
+      errors->push_back("--cpu-prof-continuous-rotation must be positive");
+    }
+    if (cpu_prof_dir.empty() && !diagnostic_dir.empty()) {
+      cpu_prof_dir = diagnostic_dir;
+    }
+  }
+
+  if (heap_prof_continuous) {
+    if (heap_prof_continuous_interval == 0) {
+      errors->push_back("--heap-prof-continuous-interval must be positive");
+    }
+    if (heap_prof_continuous_rotation == 0) {
+      errors->push_back("--heap-prof-continuous-rotation must be positive");
+    }
+    if (heap_prof_dir.empty() && !diagnostic_dir.empty()) {
+      heap_prof_dir = diagnostic_dir;
+    }
+  }
+
 #if HAVE_INSPECTOR
   if (!cpu_prof) {
     if (!cpu_prof_name.empty()) {
       errors->push_back("--cpu-prof-name must be used with --cpu-prof");
     }
-    if (!cpu_prof_dir.empty()) {
+    if (!cpu_prof_dir.empty() && !cpu_prof_continuous) {
       errors->push_back("--cpu-prof-dir must be used with --cpu-prof");
     }
     // We can't catch the case where the value passed is the default value,
@@ -282,7 +332,7 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors,
     if (!heap_prof_name.empty()) {
       errors->push_back("--heap-prof-name must be used with --heap-prof");
     }
-    if (!heap_prof_dir.empty()) {
+    if (!heap_prof_dir.empty() && !heap_prof_continuous) {
       errors->push_back("--heap-prof-dir must be used with --heap-prof");
     }
     // We can't catch the case where the value passed is the default value,
@@ -667,6 +717,12 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             kAllowedInEnvvar,
             true);
   AddOption("--expose-internals", "", &EnvironmentOptions::expose_internals);
+  AddOption("--fast-exit",
+            "when the process exits, run only the exit callbacks and the "
+            "cleanup hooks that write out data, then exit without tearing "
+            "the environment down",
+            &EnvironmentOptions::fast_exit,
+            kAllowedInEnvvar);
   AddOption("--frozen-intrinsics",
             "experimental frozen intrinsics support",
             &EnvironmentOptions::frozen_intrinsics,
@@ -675,6 +731,12 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "Generate heap snapshot on specified signal",
             &EnvironmentOptions::heap_snapshot_signal,
             kAllowedInEnvvar);
+  AddOption("--heapsnapshot-fork",
+            "On Linux, take the heap snapshots that are written to a file "
+            "in a forked copy of the process, so that their memory is not "
+            "allocated by this one",
+            &EnvironmentOptions::heap_snapshot_fork,
+            kAllowedInEnvvar);
   AddOption("--heapsnapshot-near-heap-limit",
             "Generate heap snapshots whenever V8 is approaching "
             "the heap limit. No more than the specified number of "
@@ -759,6 +821,55 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             &EnvironmentOptions::prof_process);
   // Options after --prof-process are passed through to the prof processor.
   AddAlias("--prof-process", {"--prof-process", "--"});
+  AddOption("--cpu-prof-continuous",
+            "sample the CPU at a low rate for the life of the process, and "
+            "write a gzipped pprof profile to --cpu-prof-dir or the current "
+            "working directory every --cpu-prof-continuous-rotation seconds",
+            &EnvironmentOptions::cpu_prof_continuous,
+            kAllowedInEnvvar);
+  AddOption("--cpu-prof-continuous-interval",
+            "sampling interval in microseconds of --cpu-prof-continuous "
+            "(default: 10000)",
+            &EnvironmentOptions::cpu_prof_continuous_interval,
+            kAllowedInEnvvar);
+  AddOption("--cpu-prof-continuous-rotation",
+            "seconds of samples in each profile written by "
+            "--cpu-prof-continuous (default: 60)",
+            &EnvironmentOptions::cpu_prof_continuous_rotation,
+            kAllowedInEnvvar);
+  AddOption("--cpu-prof-dir",
+            "Directory where the V8 profiles generated by --cpu-prof and "
+            "--cpu-prof-continuous will be placed. Does not affect --prof.",
+            &EnvironmentOptions::cpu_prof_dir,
+            kAllowedInEnvvar);
+  AddOption("--heap-prof-continuous",
+            "sample allocations for the life of the process, and write a "
+            "gzipped pprof profile of the sampled objects that are alive to "
+            "--heap-prof-dir or the current working directory every "
+            "--heap-prof-continuous-rotation seconds",
+            &EnvironmentOptions::heap_prof_continuous,
+            kAllowedInEnvvar);
+  AddOption("--heap-prof-continuous-interval",
+            "average number of bytes between the allocations sampled by "
+            "--heap-prof-continuous (default: 512 * 1024)",
+            &EnvironmentOptions::heap_prof_continuous_interval,
+            kAllowedInEnvvar);
+  AddOption("--heap-prof-continuous-rotation",
+            "seconds between the profiles written by --heap-prof-continuous "
+            "(default: 60)",
+            &EnvironmentOptions::heap_prof_continuous_rotation,
+            kAllowedInEnvvar);
+  AddOption("--heap-prof-continuous-include-collected",
+            "make each profile written by --heap-prof-continuous one of all "
+            "the sampled allocations since the previous one, including the "
+            "objects that have been collected",
+            &EnvironmentOptions::heap_prof_continuous_include_collected,
+            kAllowedInEnvvar);
+  AddOption("--heap-prof-dir",
+            "Directory where the V8 heap profiles generated by --heap-prof "
+            "and --heap-prof-continuous will be placed.",
+            &EnvironmentOptions::heap_prof_dir,
+            kAllowedInEnvvar);
 #if HAVE_INSPECTOR
   AddOption("--cpu-prof",
             "Start the V8 CPU profiler on start up, and write the CPU profile "
@@ -776,11 +887,6 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "profile generated with --cpu-prof. (default: 1000)",
             &EnvironmentOptions::cpu_prof_interval,
             kAllowedInEnvvar);
-  AddOption("--cpu-prof-dir",
-            "Directory where the V8 profiles generated by --cpu-prof will be "
-            "placed. Does not affect --prof.",
-            &EnvironmentOptions::cpu_prof_dir,
-            kAllowedInEnvvar);
   AddOption("--experimental-network-inspection",
             "experimental network inspection support",
             &EnvironmentOptions::experimental_network_inspection);
@@ -802,11 +908,6 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "--heap-prof",
             &EnvironmentOptions::heap_prof_name,
             kAllowedInEnvvar);
-  AddOption("--heap-prof-dir",
-            "Directory where the V8 heap profiles generated by --heap-prof "
-            "will be placed.",
-            &EnvironmentOptions::heap_prof_dir,
-            kAllowedInEnvvar);
   AddOption("--heap-prof-interval",
             "specified sampling interval in bytes for the V8 heap "
             "profile generated with --heap-prof. (default: 512 * 1024)",
@@ -817,6 +918,54 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "set the maximum size of HTTP headers (default: 16384 (16KB))",
             &EnvironmentOptions::max_http_header_size,
             kAllowedInEnvvar);
+  AddOption("--mmap-read-file-threshold",
+            "map files of at least this many bytes that are read as utf8 "
+            "from a path instead of reading them; pure ASCII content is "
+            "then kept in the mapping, so such files must not be modified "
+            "or truncated while the string is alive (default: 0, disabled)",
+            &EnvironmentOptions::mmap_read_file_threshold,
+            kAllowedInEnvvar);
+  AddOption("--native-immediate-budget",
+            "run at most this many native immediate callbacks per event "
+            "loop iteration and defer the rest to the next one, so that "
+            "bursts do not delay I/O polling (default: 0, unlimited)",
+            &EnvironmentOptions::native_immediate_budget,
+            kAllowedInEnvvar);
+  AddOption("--native-immediate-budget-us",
+            "like --native-immediate-budget, but stop running native "
+            "immediate callbacks once an iteration has spent this many "
+            "microseconds on them (default: 0, unlimited)",
+            &EnvironmentOptions::native_immediate_budget_us,
+            kAllowedInEnvvar);
+  AddOption("--module-stat-cache",
+            "cache the stat() calls of module resolution per directory, "
+            "revalidated against the directory's timestamps",
+            &EnvironmentOptions::module_stat_cache,
+            kAllowedInEnvvar);
+  AddOption("--stream-read-buffer-pool",
+            "recycle the buffers that sockets, pipes and ttys read into "
+            "through a per-environment pool of 8, 16 and 64 KiB chunks",
+            &EnvironmentOptions::stream_read_buffer_pool,
+            kAllowedInEnvvar);
+  AddOption("--batch-fs-promises",
+            "settle the promises of fs/promises requests that complete in "
+            "the same event loop iteration together, running microtasks "
+            "and process.nextTick() callbacks once for all of them",
+            &EnvironmentOptions::batch_fs_promises,
+            kAllowedInEnvvar);
+  AddOption("--zlib-parallel-threads",
+            "compress deflate, gzip and raw deflate streams without a "
+            "dictionary in 128 KiB blocks on this many threads, pigz-style "
+            "(default: 0, disabled)",
+            &EnvironmentOptions::zlib_parallel_threads,
+            kAllowedInEnvvar);
+  AddOption("--zero-copy-string-threshold",
+            "decode Buffers of at least this many bytes of latin1, or of "
+            "pure ASCII text, to strings that share the Buffer's memory "
+            "instead of copying it; such Buffers must not be modified "
+            "afterwards (default: 0, disabled)",
+            &EnvironmentOptions::zero_copy_string_threshold,
+            kAllowedInEnvvar);
   AddOption("--redirect-warnings",
             "write warnings to file instead of stderr",
             &EnvironmentOptions::redirect_warnings,
@@ -967,6 +1116,12 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "show stack traces on deprecations",
             &EnvironmentOptions::trace_deprecation,
             kAllowedInEnvvar);
+  AddOption("--trace-event-loop-stalls",
+            "print the JavaScript and native stacks of the main thread "
+            "when the event loop does not come round for this many "
+            "milliseconds (default: 0, off)",
+            &EnvironmentOptions::trace_event_loop_stalls,
+            kAllowedInEnvvar);
   AddOption("--trace-exit",
             "show stack trace when an environment exits",
             &EnvironmentOptions::trace_exit,
@@ -1088,6 +1243,16 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "ES module to preload (option can be repeated)",
             &EnvironmentOptions::preload_esm_modules,
             kAllowedInEnvvar);
+  AddOption("--prefetch-builtin",
+            "built-in module to compile while the event loop is idle, so "
+            "that requiring it later does not (option can be repeated)",
+            &EnvironmentOptions::prefetch_builtins,
+            kAllowedInEnvvar);
+  AddOption("--experimental-module-prefetch",
+            "read and compile the modules that a module statically imports "
+            "or requires on the threadpool, ahead of the loader",
+            &EnvironmentOptions::experimental_module_prefetch,
+            kAllowedInEnvvar);
   AddOption("--strip-types",
             "Type-stripping for TypeScript files.",
             &EnvironmentOptions::strip_types,
@@ -1153,6 +1318,17 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             " (default: false)",
             &EnvironmentOptions::report_exclude_network,
             kAllowedInEnvvar);
+  AddOption("--report-sections",
+            "comma-separated sections to include in the report, out of js, "
+            "heap, native, resources, libuv, workers, env and system "
+            "(default: all of them)",
+            &EnvironmentOptions::report_sections,
+            kAllowedInEnvvar);
+  AddOption("--report-summarize-handles",
+            "report the number of libuv handles of each type instead of "
+            "every handle (default: false)",
+            &EnvironmentOptions::report_summarize_handles,
+            kAllowedInEnvvar);
 }
 
 PerIsolateOptionsParser::PerIsolateOptionsParser(
@@ -1254,12 +1430,57 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "data, it supports ${rotation} and ${pid}.",
             &PerProcessOptions::trace_event_file_pattern,
             kAllowedInEnvvar);
+  AddOption("--trace-event-format",
+            "format of the trace-events data, either 'json' (default) or "
+            "'perfetto' for the Perfetto protobuf trace format",
+            &PerProcessOptions::trace_event_format,
+            kAllowedInEnvvar);
   AddAlias("--trace-events-enabled", {
     "--trace-event-categories", "v8,node,node.async_hooks" });
   AddOption("--v8-pool-size",
             "set V8's thread pool size",
             &PerProcessOptions::v8_thread_pool_size,
             kAllowedInEnvvar);
+  AddOption("--compression-context-pool-size",
+            "keep up to this many reset deflate, inflate and zstd states of "
+            "closed zlib streams per set of parameters, for reuse by new "
+            "streams (default: 0, disabled)",
+            &PerProcessOptions::compression_context_pool_size,
+            kAllowedInEnvvar);
+  AddOption("--blob-spill-threshold",
+            "write ArrayBuffer parts of at least this many bytes given to "
+            "new Blobs to an anonymous temporary file instead of keeping "
+            "them in memory (default: 0, disabled)",
+            &PerProcessOptions::blob_spill_threshold,
+            kAllowedInEnvvar);
+  AddOption("--blob-memory-budget",
+            "with --blob-spill-threshold, only spill Blob parts once the "
+            "Blob data held in memory by the process would exceed this "
+            "many bytes (default: 0)",
+            &PerProcessOptions::blob_memory_budget,
+            kAllowedInEnvvar);
+  AddOption("--dns-cache-ttl",
+            "cache the results of dns.lookup() in the process, shared with "
+            "workers, for this many milliseconds (default: 0, disabled)",
+            &PerProcessOptions::dns_cache_ttl,
+            kAllowedInEnvvar);
+  AddOption("--dns-cache-negative-ttl",
+            "with --dns-cache-ttl, cache lookups of names that have no "
+            "addresses for this many milliseconds (default: 1000)",
+            &PerProcessOptions::dns_cache_negative_ttl,
+            kAllowedInEnvvar);
+  AddOption("--dns-cache-stale-ttl",
+            "with --dns-cache-ttl, keep returning an expired result for "
+            "this many more milliseconds while it is refreshed in the "
+            "background (default: 0)",
+            &PerProcessOptions::dns_cache_stale_ttl,
+            kAllowedInEnvvar);
+  AddOption("--experimental-io-uring",
+            "on Linux, submit file system requests to an io_uring with a "
+            "kernel polling thread instead of running them on the libuv "
+            "thread pool",
+            &PerProcessOptions::io_uring,
+            kAllowedInEnvvar);
   AddOption("--zero-fill-buffers",
             "automatically zero-fill all newly allocated Buffer instances",
             &PerProcessOptions::zero_fill_all_buffers,
@@ -1268,6 +1489,10 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "", /* undocumented, only for debugging */
             &PerProcessOptions::debug_arraybuffer_allocations,
             kAllowedInEnvvar);
+  AddOption("--arraybuffer-slab-allocator",
+            "serve ArrayBuffers of up to 4 KiB from per-isolate slabs",
+            &PerProcessOptions::arraybuffer_slab_allocator,
+            kAllowedInEnvvar);
   AddOption("--disable-proto",
             "disable Object.prototype.__proto__",
             &PerProcessOptions::disable_proto,
@@ -1301,6 +1526,19 @@ PerProcessOptionsParser::PerProcessOptionsParser(
   AddOption("--v8-options",
             "print V8 command line options",
             &PerProcessOptions::print_v8_help);
+  AddOption("--print-simd-dispatch",
+            "print the SIMD implementation selected for each accelerated "
+            "subsystem",
+            &PerProcessOptions::print_simd_dispatch);
+  AddOption("--simd-calibrate",
+            "time the SIMD kernels on this machine, use the fastest and print "
+            "the result, writing it to --simd-calibration-file if set",
+            &PerProcessOptions::simd_calibrate);
+  AddOption("--simd-calibration-file",
+            "read the SIMD kernel selection from a file written by "
+            "--simd-calibrate",
+            &PerProcessOptions::simd_calibration_file,
+            kAllowedInEnvvar);
   AddOption("--report-compact",
             "output compact single-line JSON",
             &PerProcessOptions::report_compact,
@@ -1388,6 +1626,11 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             &PerProcessOptions::secure_heap_min,
             kAllowedInEnvvar);
 #endif  // V8_ENABLE_SANDBOX
+  AddOption("--kdf-max-threads",
+            "maximum number of threads one argon2 derivation uses for its "
+            "lanes (default: one per lane)",
+            &PerProcessOptions::kdf_max_threads,
+            kAllowedInEnvvar);
 #endif  // HAVE_OPENSSL
 #if OPENSSL_VERSION_MAJOR >= 3
   AddOption("--openssl-legacy-provider",
@@ -1400,6 +1643,18 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             kAllowedInEnvvar);
 
 #endif  // OPENSSL_VERSION_MAJOR
+  AddOption("--heap-policy",
+            "How to size the V8 heap. Options are 'default' (V8's sizing "
+            "for the available memory) or 'container-aware' (young and old "
+            "generations derived from the cgroup memory limit)",
+            &PerProcessOptions::heap_policy,
+            kAllowedInEnvvar);
+  AddOption("--memory-profile",
+            "Trade speed for a smaller footprint. Options are 'default' or "
+            "'low' (V8 lite mode, a smaller code range, no builtin code "
+            "cache and a two-thread threadpool with 1 MB stacks)",
+            &PerProcessOptions::memory_profile,
+            kAllowedInEnvvar);
   AddOption("--use-largepages",
             "Map the Node.js static code to large pages. Options are "
             "'off' (the default value, meaning do not map), "
@@ -1407,11 +1662,19 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "or 'silent' (map and silently ignore failure)",
             &PerProcessOptions::use_largepages,
             kAllowedInEnvvar);
+  AddOption("--use-largepages-for-jit",
+            "Back V8's JIT code range with transparent huge pages (Linux only)",
+            &PerProcessOptions::use_largepages_for_jit,
+            kAllowedInEnvvar);
 
   AddOption("--trace-sigint",
             "enable printing JavaScript stacktrace on SIGINT",
             &PerProcessOptions::trace_sigint,
             kAllowedInEnvvar);
+  AddOption("--trace-startup-phases",
+            "print the time spent in each phase of startup to stderr",
+            &PerProcessOptions::trace_startup_phases,
+            kAllowedInEnvvar);
 
   Insert(iop, &PerProcessOptions::get_per_isolate_options);
 
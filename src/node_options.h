@@ -16,6 +16,11 @@
 #include "quic/guard.h"
 #endif
 
+// Set by `configure --with-memory-profile`.
+#ifndef NODE_DEFAULT_MEMORY_PROFILE
+#define NODE_DEFAULT_MEMORY_PROFILE "default"
+#endif
+
 namespace node {
 
 class HostPort {
@@ -152,11 +157,20 @@ class EnvironmentOptions : public Options {
   bool expose_internals = false;
   bool force_node_api_uncaught_exceptions_policy = false;
   bool frozen_intrinsics = false;
+  bool heap_snapshot_fork = false;
   int64_t heap_snapshot_near_heap_limit = 0;
   std::string heap_snapshot_signal;
   bool network_family_autoselection = true;
   uint64_t network_family_autoselection_attempt_timeout = 500;
   uint64_t max_http_header_size = 16 * 1024;
+  uint64_t zero_copy_string_threshold = 0;
+  uint64_t mmap_read_file_threshold = 0;
+  uint64_t native_immediate_budget = 0;
+  uint64_t native_immediate_budget_us = 0;
+  bool stream_read_buffer_pool = false;
+  bool batch_fs_promises = false;
+  uint64_t zlib_parallel_threads = 0;
+  bool module_stat_cache = false;
   bool deprecation = true;
   bool force_async_hooks_checks = true;
   bool allow_native_addons = true;
@@ -168,8 +182,16 @@ class EnvironmentOptions : public Options {
   bool preserve_symlinks = false;
   bool preserve_symlinks_main = false;
   bool prof_process = false;
-#if HAVE_INSPECTOR
   std::string cpu_prof_dir;
+  bool cpu_prof_continuous = false;
+  uint64_t cpu_prof_continuous_interval = 10000;
+  uint64_t cpu_prof_continuous_rotation = 60;
+  std::string heap_prof_dir;
+  bool heap_prof_continuous = false;
+  uint64_t heap_prof_continuous_interval = 512 * 1024;
+  uint64_t heap_prof_continuous_rotation = 60;
+  bool heap_prof_continuous_include_collected = false;
+#if HAVE_INSPECTOR
   static const uint64_t kDefaultCpuProfInterval = 1000;
   uint64_t cpu_prof_interval = kDefaultCpuProfInterval;
   std::string cpu_prof_name;
@@ -177,7 +199,6 @@ class EnvironmentOptions : public Options {
   bool experimental_network_inspection = false;
   bool experimental_worker_inspection = false;
   bool experimental_inspector_network_resource = false;
-  std::string heap_prof_dir;
   std::string heap_prof_name;
   static const uint64_t kDefaultHeapProfInterval = 512 * 1024;
   uint64_t heap_prof_interval = kDefaultHeapProfInterval;
@@ -213,7 +234,9 @@ class EnvironmentOptions : public Options {
   bool throw_deprecation = false;
   bool trace_deprecation = false;
   bool trace_exit = false;
+  bool fast_exit = false;
   bool trace_sync_io = false;
+  uint64_t trace_event_loop_stalls = 0;
   bool trace_tls = false;
   bool trace_uncaught = false;
   bool trace_warnings = false;
@@ -259,6 +282,9 @@ class EnvironmentOptions : public Options {
 
   std::vector<std::string> preload_esm_modules;
 
+  std::vector<std::string> prefetch_builtins;
+  bool experimental_module_prefetch = false;
+
   bool strip_types = true;
   bool experimental_transform_types = false;
 
@@ -266,6 +292,8 @@ class EnvironmentOptions : public Options {
 
   bool report_exclude_env = false;
   bool report_exclude_network = false;
+  bool report_summarize_handles = false;
+  std::string report_sections;
   std::string experimental_config_file_path;
   bool experimental_default_config_file = false;
 
@@ -322,9 +350,18 @@ class PerProcessOptions : public Options {
   std::string title;
   std::string trace_event_categories;
   std::string trace_event_file_pattern = "node_trace.${rotation}.log";
+  std::string trace_event_format = "json";
   int64_t v8_thread_pool_size = 4;
+  uint64_t compression_context_pool_size = 0;
+  uint64_t blob_spill_threshold = 0;
+  uint64_t blob_memory_budget = 0;
+  uint64_t dns_cache_ttl = 0;
+  uint64_t dns_cache_negative_ttl = 1000;
+  uint64_t dns_cache_stale_ttl = 0;
+  bool io_uring = false;
   bool zero_fill_all_buffers = false;
   bool debug_arraybuffer_allocations = false;
+  bool arraybuffer_slab_allocator = false;
   std::string disable_proto;
   // We enable the shared read-only heap which currently requires that the
   // snapshot used in different isolates in the same process to be the same.
@@ -335,6 +372,9 @@ class PerProcessOptions : public Options {
   std::vector<std::string> security_reverts;
   bool print_bash_completion = false;
   bool print_help = false;
+  bool print_simd_dispatch = false;
+  bool simd_calibrate = false;
+  std::string simd_calibration_file;
   bool print_v8_help = false;
   bool print_version = false;
   std::string experimental_sea_config;
@@ -351,6 +391,7 @@ class PerProcessOptions : public Options {
   std::string tls_cipher_list = DEFAULT_CIPHER_LIST_CORE;
   int64_t secure_heap = 0;
   int64_t secure_heap_min = 2;
+  int64_t kdf_max_threads = 0;
 #ifdef NODE_OPENSSL_CERT_STORE
   bool ssl_openssl_cert_store = true;
 #else
@@ -377,7 +418,11 @@ class PerProcessOptions : public Options {
 
   // TODO(addaleax): Some of these could probably be per-Environment.
   std::string use_largepages = "off";
+  std::string heap_policy = "default";
+  std::string memory_profile = NODE_DEFAULT_MEMORY_PROFILE;
+  bool use_largepages_for_jit = false;
   bool trace_sigint = false;
+  bool trace_startup_phases = false;
   std::vector<std::string> cmdline;
 
   inline PerIsolateOptions* get_per_isolate_options();
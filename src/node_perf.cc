@@ -7,6 +7,7 @@
 #include "node_external_reference.h"
 #include "node_internals.h"
 #include "node_process-inl.h"
+#include "threadpool_metrics.h"
 #include "util-inl.h"
 
 #include <cinttypes>
@@ -21,10 +22,12 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::GCCallbackFlags;
 using v8::GCType;
+using v8::HeapStatistics;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Number;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::PropertyAttribute;
@@ -57,7 +60,12 @@ PerformanceState::PerformanceState(Isolate* isolate,
                 offsetof(performance_state_internal, observers),
                 NODE_PERFORMANCE_ENTRY_TYPE_INVALID,
                 root,
-                MAYBE_FIELD_PTR(info, observers)) {
+                MAYBE_FIELD_PTR(info, observers)),
+      gc_stats(isolate,
+               offsetof(performance_state_internal, gc_stats),
+               NODE_PERFORMANCE_GC_STAT_INVALID,
+               root,
+               MAYBE_FIELD_PTR(info, gc_stats)) {
   if (info == nullptr) {
     // For performance states initialized from scratch, reset
     // all the milestones and initialize the time origin.
@@ -83,7 +91,8 @@ PerformanceState::SerializeInfo PerformanceState::Serialize(
 
   SerializeInfo info{root.Serialize(context, creator),
                      milestones.Serialize(context, creator),
-                     observers.Serialize(context, creator)};
+                     observers.Serialize(context, creator),
+                     gc_stats.Serialize(context, creator)};
   return info;
 }
 
@@ -105,6 +114,7 @@ void PerformanceState::Deserialize(v8::Local<v8::Context> context,
   root.Deserialize(context);
   milestones.Deserialize(context);
   observers.Deserialize(context);
+  gc_stats.Deserialize(context);
 
   // Re-initialize the time origin and timestamp i.e. the process start time.
   Initialize(time_origin, time_origin_timestamp);
@@ -116,6 +126,7 @@ std::ostream& operator<<(std::ostream& o,
     << "  " << i.root << ",  // root\n"
     << "  " << i.milestones << ",  // milestones\n"
     << "  " << i.observers << ",  // observers\n"
+    << "  " << i.gc_stats << ",  // gc_stats\n"
     << "}";
   return o;
 }
@@ -242,6 +253,105 @@ static void RemoveGarbageCollectionTracking(
   GarbageCollectionCleanupHook(env);
 }
 
+// Starts timing a GC for gcStats.
+void GCStatsPrologue(Isolate* isolate,
+                     GCType type,
+                     GCCallbackFlags flags,
+                     void* data) {
+  Environment* env = static_cast<Environment*>(data);
+  PerformanceState* state = env->performance_state();
+  if (state->gc_stats_current_type != 0) return;
+  HeapStatistics heap_statistics;
+  isolate->GetHeapStatistics(&heap_statistics);
+  state->gc_stats_used_before = heap_statistics.used_heap_size();
+  state->gc_stats_current_type = type;
+  state->gc_stats_start_mark = PERFORMANCE_NOW();
+}
+
+// Adds the GC that ended to gcStats.
+void GCStatsEpilogue(Isolate* isolate,
+                     GCType type,
+                     GCCallbackFlags flags,
+                     void* data) {
+  Environment* env = static_cast<Environment*>(data);
+  PerformanceState* state = env->performance_state();
+  if (type != state->gc_stats_current_type) return;
+  state->gc_stats_current_type = 0;
+  const double duration =
+      static_cast<double>(PERFORMANCE_NOW() - state->gc_stats_start_mark) /
+      NANOS_PER_MILLIS;
+
+  PerformanceGCStat count, total;
+  switch (type) {
+    case GCType::kGCTypeScavenge:
+    case GCType::kGCTypeMinorMarkSweep:
+      count = NODE_PERFORMANCE_GC_STAT_MINOR_COUNT;
+      total = NODE_PERFORMANCE_GC_STAT_MINOR_DURATION;
+      break;
+    case GCType::kGCTypeMarkSweepCompact:
+      count = NODE_PERFORMANCE_GC_STAT_MAJOR_COUNT;
+      total = NODE_PERFORMANCE_GC_STAT_MAJOR_DURATION;
+      break;
+    case GCType::kGCTypeIncrementalMarking:
+      count = NODE_PERFORMANCE_GC_STAT_INCREMENTAL_COUNT;
+      total = NODE_PERFORMANCE_GC_STAT_INCREMENTAL_DURATION;
+      break;
+    default:
+      count = NODE_PERFORMANCE_GC_STAT_WEAKCB_COUNT;
+      total = NODE_PERFORMANCE_GC_STAT_WEAKCB_DURATION;
+      break;
+  }
+  AliasedFloat64Array& stats = state->gc_stats;
+  stats[count] += 1;
+  stats[total] += duration;
+  if (duration > stats[NODE_PERFORMANCE_GC_STAT_MAX_DURATION])
+    stats[NODE_PERFORMANCE_GC_STAT_MAX_DURATION] = duration;
+
+  HeapStatistics heap_statistics;
+  isolate->GetHeapStatistics(&heap_statistics);
+  const size_t used_after = heap_statistics.used_heap_size();
+  if (state->gc_stats_used_before > used_after) {
+    stats[NODE_PERFORMANCE_GC_STAT_FREED_BYTES] +=
+        static_cast<double>(state->gc_stats_used_before - used_after);
+  }
+  stats[NODE_PERFORMANCE_GC_STAT_ALLOCATED_BYTES] =
+      static_cast<double>(heap_statistics.total_allocated_bytes());
+  stats[NODE_PERFORMANCE_GC_STAT_HEAP_USED] = static_cast<double>(used_after);
+}
+
+void GCStatsCleanupHook(void* data) {
+  Environment* env = static_cast<Environment*>(data);
+  env->performance_state()->gc_stats_current_type = 0;
+  env->isolate()->RemoveGCPrologueCallback(GCStatsPrologue, data);
+  env->isolate()->RemoveGCEpilogueCallback(GCStatsEpilogue, data);
+}
+
+// Resets gcStats and keeps it updated until stopGCStats() is called.
+static void StartGCStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  PerformanceState* state = env->performance_state();
+  for (size_t i = 0; i < state->gc_stats.Length(); i++) state->gc_stats[i] = 0;
+  HeapStatistics heap_statistics;
+  env->isolate()->GetHeapStatistics(&heap_statistics);
+  state->gc_stats[NODE_PERFORMANCE_GC_STAT_ALLOCATED_BYTES] =
+      static_cast<double>(heap_statistics.total_allocated_bytes());
+  state->gc_stats[NODE_PERFORMANCE_GC_STAT_HEAP_USED] =
+      static_cast<double>(heap_statistics.used_heap_size());
+
+  // Starting again only resets the totals.
+  env->RemoveCleanupHook(GCStatsCleanupHook, env);
+  GCStatsCleanupHook(env);
+  env->isolate()->AddGCPrologueCallback(GCStatsPrologue, env);
+  env->isolate()->AddGCEpilogueCallback(GCStatsEpilogue, env);
+  env->AddCleanupHook(GCStatsCleanupHook, env);
+}
+
+static void StopGCStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->RemoveCleanupHook(GCStatsCleanupHook, env);
+  GCStatsCleanupHook(env);
+}
+
 // Notify a custom PerformanceEntry to observers
 void Notify(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -278,6 +388,19 @@ void UvMetricsInfo(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(arr);
 }
 
+// Returns [exhausted, deferred], see Environment::NativeImmediateBudgetStats.
+void GetNativeImmediateBudgetStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  const Environment::NativeImmediateBudgetStats& stats =
+      env->native_immediate_budget_stats();
+  Local<Value> data[] = {
+      Number::New(env->isolate(), static_cast<double>(stats.exhausted)),
+      Number::New(env->isolate(), static_cast<double>(stats.deferred)),
+  };
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), data, arraysize(data)));
+}
+
 void CreateELDHistogram(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   int64_t interval = args[0].As<Integer>()->Value();
@@ -299,6 +422,60 @@ void CreateELDHistogram(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(histogram->object());
 }
 
+void CreateLoopPhaseMonitor(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  BaseObjectPtr<LoopPhaseMonitor> monitor = LoopPhaseMonitor::Create(env);
+  if (monitor) args.GetReturnValue().Set(monitor->object());
+}
+
+void SetThreadpoolMetricsEnabled(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsBoolean());
+  threadpool_metrics::SetEnabled(args[0]->IsTrue());
+}
+
+// Returns { fs: { wait, run, total }, crypto: { ... }, ... }, each a
+// RecordableHistogram handle over the process-wide threadpool histograms.
+void GetThreadpoolHistograms(const FunctionCallbackInfo<Value>& args) {
+  using threadpool_metrics::Category;
+  using threadpool_metrics::Phase;
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+
+  static constexpr std::pair<Phase, const char*> kPhases[] = {
+      {Phase::kWait, "wait"},
+      {Phase::kRun, "run"},
+      {Phase::kTotal, "total"},
+  };
+
+  auto add_category = [&](Local<Object> result,
+                          Category category,
+                          const char* name) -> bool {
+    Local<Object> phases = Object::New(isolate);
+    for (const auto& [phase, phase_name] : kPhases) {
+      BaseObjectPtr<HistogramBase> histogram = HistogramBase::Create(
+          env, threadpool_metrics::GetHistogram(category, phase));
+      if (!histogram ||
+          phases
+              ->Set(context,
+                    OneByteString(isolate, phase_name),
+                    histogram->object())
+              .IsNothing()) {
+        return false;
+      }
+    }
+    return result->Set(context, OneByteString(isolate, name), phases)
+        .IsJust();
+  };
+
+  Local<Object> result = Object::New(isolate);
+#define V(category, name)                                                      \
+  if (!add_category(result, Category::category, name)) return;
+  THREADPOOL_METRICS_CATEGORIES(V)
+#undef V
+  args.GetReturnValue().Set(result);
+}
+
 void MarkBootstrapComplete(const FunctionCallbackInfo<Value>& args) {
   Realm* realm = Realm::GetCurrent(args);
   CHECK_EQ(realm->kind(), Realm::Kind::kPrincipal);
@@ -337,11 +514,25 @@ static void CreatePerIsolateProperties(IsolateData* isolate_data,
             target,
             "removeGarbageCollectionTracking",
             RemoveGarbageCollectionTracking);
+  SetMethod(isolate, target, "startGCStats", StartGCStats);
+  SetMethod(isolate, target, "stopGCStats", StopGCStats);
   SetMethod(isolate, target, "notify", Notify);
   SetMethod(isolate, target, "loopIdleTime", LoopIdleTime);
   SetMethod(isolate, target, "createELDHistogram", CreateELDHistogram);
+  SetMethod(
+      isolate, target, "createLoopPhaseMonitor", CreateLoopPhaseMonitor);
   SetMethod(isolate, target, "markBootstrapComplete", MarkBootstrapComplete);
   SetMethod(isolate, target, "uvMetricsInfo", UvMetricsInfo);
+  SetMethod(isolate,
+            target,
+            "getNativeImmediateBudgetStats",
+            GetNativeImmediateBudgetStats);
+  SetMethod(isolate,
+            target,
+            "setThreadpoolMetricsEnabled",
+            SetThreadpoolMetricsEnabled);
+  SetMethod(
+      isolate, target, "getThreadpoolHistograms", GetThreadpoolHistograms);
   SetFastMethodNoSideEffect(
       isolate, target, "now", SlowPerformanceNow, &fast_performance_now);
 }
@@ -360,6 +551,9 @@ void CreatePerContextProperties(Local<Object> target,
   target->Set(context,
               FIXED_ONE_BYTE_STRING(isolate, "milestones"),
               state->milestones.GetJSArray()).Check();
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(isolate, "gcStats"),
+              state->gc_stats.GetJSArray()).Check();
 
   Local<Object> constants = Object::New(isolate);
 
@@ -393,6 +587,11 @@ void CreatePerContextProperties(Local<Object> target,
   NODE_PERFORMANCE_MILESTONES(V)
 #undef V
 
+#define V(name, _)                                                            \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_PERFORMANCE_GC_STAT_##name);
+  NODE_PERFORMANCE_GC_STATS(V)
+#undef V
+
   PropertyAttribute attr =
       static_cast<PropertyAttribute>(ReadOnly | DontDelete);
 
@@ -404,15 +603,22 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(SetupPerformanceObservers);
   registry->Register(InstallGarbageCollectionTracking);
   registry->Register(RemoveGarbageCollectionTracking);
+  registry->Register(StartGCStats);
+  registry->Register(StopGCStats);
   registry->Register(Notify);
   registry->Register(LoopIdleTime);
   registry->Register(CreateELDHistogram);
+  registry->Register(CreateLoopPhaseMonitor);
   registry->Register(MarkBootstrapComplete);
   registry->Register(UvMetricsInfo);
+  registry->Register(GetNativeImmediateBudgetStats);
+  registry->Register(SetThreadpoolMetricsEnabled);
+  registry->Register(GetThreadpoolHistograms);
   registry->Register(SlowPerformanceNow);
   registry->Register(fast_performance_now);
   HistogramBase::RegisterExternalReferences(registry);
   IntervalHistogram::RegisterExternalReferences(registry);
+  LoopPhaseMonitor::RegisterExternalReferences(registry);
 }
 }  // namespace performance
 }  // namespace node
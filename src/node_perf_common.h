@@ -41,6 +41,25 @@ extern uint64_t performance_v8_start;
   V(NET, "net")                                                               \
   V(DNS, "dns")
 
+// Totals of the garbage collections since gcStats was started, which are
+// updated by the GC callbacks so that reading them allocates nothing.
+// Durations are in milliseconds; allocatedBytes is V8's total of the bytes
+// ever allocated on the heap, as of the last GC, and heapUsed is the size of
+// the heap after it.
+#define NODE_PERFORMANCE_GC_STATS(V)                                           \
+  V(MINOR_COUNT, "minorCount")                                                 \
+  V(MINOR_DURATION, "minorDuration")                                           \
+  V(MAJOR_COUNT, "majorCount")                                                 \
+  V(MAJOR_DURATION, "majorDuration")                                           \
+  V(INCREMENTAL_COUNT, "incrementalCount")                                     \
+  V(INCREMENTAL_DURATION, "incrementalDuration")                               \
+  V(WEAKCB_COUNT, "weakcbCount")                                               \
+  V(WEAKCB_DURATION, "weakcbDuration")                                         \
+  V(MAX_DURATION, "maxDuration")                                               \
+  V(FREED_BYTES, "freedBytes")                                                 \
+  V(ALLOCATED_BYTES, "allocatedBytes")                                         \
+  V(HEAP_USED, "heapUsed")
+
 enum PerformanceMilestone {
 #define V(name, _) NODE_PERFORMANCE_MILESTONE_##name,
   NODE_PERFORMANCE_MILESTONES(V)
@@ -48,6 +67,13 @@ enum PerformanceMilestone {
   NODE_PERFORMANCE_MILESTONE_INVALID
 };
 
+enum PerformanceGCStat {
+#define V(name, _) NODE_PERFORMANCE_GC_STAT_##name,
+  NODE_PERFORMANCE_GC_STATS(V)
+#undef V
+  NODE_PERFORMANCE_GC_STAT_INVALID
+};
+
 enum PerformanceEntryType {
 #define V(name, _) NODE_PERFORMANCE_ENTRY_TYPE_##name,
   NODE_PERFORMANCE_ENTRY_TYPES(V)
@@ -61,6 +87,7 @@ class PerformanceState {
     AliasedBufferIndex root;
     AliasedBufferIndex milestones;
     AliasedBufferIndex observers;
+    AliasedBufferIndex gc_stats;
   };
 
   explicit PerformanceState(v8::Isolate* isolate,
@@ -77,10 +104,17 @@ class PerformanceState {
   AliasedUint8Array root;
   AliasedFloat64Array milestones;
   AliasedUint32Array observers;
+  AliasedFloat64Array gc_stats;
 
   uint64_t performance_last_gc_start_mark = 0;
   uint16_t current_gc_type = 0;
 
+  // The GC that gc_stats is timing, which is tracked apart from the one of
+  // the performance entries since either can be enabled alone.
+  uint64_t gc_stats_start_mark = 0;
+  size_t gc_stats_used_before = 0;
+  uint16_t gc_stats_current_type = 0;
+
   void Mark(enum PerformanceMilestone milestone,
             uint64_t ts = PERFORMANCE_NOW());
 
@@ -90,6 +124,7 @@ class PerformanceState {
   struct performance_state_internal {
     // doubles first so that they are always sizeof(double)-aligned
     double milestones[NODE_PERFORMANCE_MILESTONE_INVALID];
+    double gc_stats[NODE_PERFORMANCE_GC_STAT_INVALID];
     uint32_t observers[NODE_PERFORMANCE_ENTRY_TYPE_INVALID];
   };
 };
@@ -18,7 +18,7 @@ using v8::TaskPriority;
 namespace {
 
 struct PlatformWorkerData {
-  TaskQueue<TaskQueueEntry>* task_queue;
+  WorkerThreadsTaskRunner* runner;
   Mutex* platform_workers_mutex;
   ConditionVariable* platform_workers_ready;
   int* pending_platform_workers;
@@ -48,15 +48,34 @@ static void PrintSourceLocation(const v8::SourceLocation& location) {
   }
 }
 
-static void PlatformWorkerThread(void* data) {
+// The runner and index of the platform worker running on this thread, if
+// any. Used to tell tasks posted by a worker, which go to its own deque,
+// from those posted by other threads.
+thread_local WorkerThreadsTaskRunner* current_worker_runner = nullptr;
+thread_local int current_worker_id = -1;
+
+static int GetActualThreadPoolSize(int thread_pool_size) {
+  if (thread_pool_size < 1) {
+    thread_pool_size = uv_available_parallelism() - 1;
+  }
+  return std::max(thread_pool_size, 1);
+}
+
+}  // namespace
+
+void WorkerThreadsTaskRunner::PlatformWorkerThread(void* data) {
   uv_thread_setname("V8Worker");
   std::unique_ptr<PlatformWorkerData>
       worker_data(static_cast<PlatformWorkerData*>(data));
 
-  TaskQueue<TaskQueueEntry>* pending_worker_tasks = worker_data->task_queue;
+  WorkerThreadsTaskRunner* runner = worker_data->runner;
   TRACE_EVENT_METADATA1("__metadata", "thread_name", "name",
                         "PlatformWorkerThread");
 
+  int id = worker_data->id;
+  current_worker_runner = runner;
+  current_worker_id = id;
+
   // Notify the main thread that the platform worker is ready.
   {
     Mutex::ScopedLock lock(*worker_data->platform_workers_mutex);
@@ -66,9 +85,7 @@ static void PlatformWorkerThread(void* data) {
 
   bool debug_log_enabled =
       worker_data->debug_log_level != PlatformDebugLogLevel::kNone;
-  int id = worker_data->id;
-  while (std::unique_ptr<TaskQueueEntry> entry =
-             pending_worker_tasks->Lock().BlockingPop()) {
+  while (std::unique_ptr<TaskQueueEntry> entry = runner->WaitForTask(id)) {
     if (debug_log_enabled) {
       fprintf(stderr,
               "\nPlatformWorkerThread %d running task %p %s\n",
@@ -80,24 +97,18 @@ static void PlatformWorkerThread(void* data) {
     entry->task->Run();
     // See NodePlatform::DrainTasks().
     if (entry->is_outstanding()) {
-      pending_worker_tasks->Lock().NotifyOfOutstandingCompletion();
+      runner->NotifyOfOutstandingCompletion();
     }
   }
-}
 
-static int GetActualThreadPoolSize(int thread_pool_size) {
-  if (thread_pool_size < 1) {
-    thread_pool_size = uv_available_parallelism() - 1;
-  }
-  return std::max(thread_pool_size, 1);
+  current_worker_runner = nullptr;
+  current_worker_id = -1;
 }
 
-}  // namespace
-
 class WorkerThreadsTaskRunner::DelayedTaskScheduler {
  public:
-  explicit DelayedTaskScheduler(TaskQueue<TaskQueueEntry>* tasks)
-      : pending_worker_tasks_(tasks) {}
+  explicit DelayedTaskScheduler(WorkerThreadsTaskRunner* runner)
+      : runner_(runner) {}
 
   std::unique_ptr<uv_thread_t> Start() {
     auto start_thread = [](void* data) {
@@ -213,10 +224,7 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
   static void RunTask(uv_timer_t* timer) {
     DelayedTaskScheduler* scheduler =
         ContainerOf(&DelayedTaskScheduler::loop_, timer->loop);
-    auto entry = scheduler->TakeTimerTask(timer);
-    bool is_outstanding = entry->is_outstanding();
-    scheduler->pending_worker_tasks_->Lock().Push(std::move(entry),
-                                                  is_outstanding);
+    scheduler->runner_->Enqueue(scheduler->TakeTimerTask(timer));
   }
 
   std::unique_ptr<TaskQueueEntry> TakeTimerTask(uv_timer_t* timer) {
@@ -231,9 +239,9 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
   }
 
   uv_sem_t ready_;
-  // Task queue in the worker thread task runner, we push the delayed task back
-  // to it when the timer expires.
-  TaskQueue<TaskQueueEntry>* pending_worker_tasks_;
+  // The worker thread task runner, we push the delayed task back to it when
+  // the timer expires.
+  WorkerThreadsTaskRunner* runner_;
 
   // Locally scheduled tasks to be poped into the worker task runner queue.
   // It is flushed whenever the next closest timer expires.
@@ -252,13 +260,18 @@ WorkerThreadsTaskRunner::WorkerThreadsTaskRunner(
   Mutex::ScopedLock lock(platform_workers_mutex);
   int pending_platform_workers = thread_pool_size;
 
-  delayed_task_scheduler_ = std::make_unique<DelayedTaskScheduler>(
-      &pending_worker_tasks_);
+  delayed_task_scheduler_ = std::make_unique<DelayedTaskScheduler>(this);
   threads_.push_back(delayed_task_scheduler_->Start());
 
+  // The deques must all exist before any worker starts looking for work to
+  // steal.
+  for (int i = 0; i < thread_pool_size; i++) {
+    worker_queues_.push_back(std::make_unique<WorkerQueues>());
+  }
+
   for (int i = 0; i < thread_pool_size; i++) {
     PlatformWorkerData* worker_data =
-        new PlatformWorkerData{&pending_worker_tasks_,
+        new PlatformWorkerData{this,
                                &platform_workers_mutex,
                                &platform_workers_ready,
                                &pending_platform_workers,
@@ -282,9 +295,7 @@ WorkerThreadsTaskRunner::WorkerThreadsTaskRunner(
 void WorkerThreadsTaskRunner::PostTask(v8::TaskPriority priority,
                                        std::unique_ptr<v8::Task> task,
                                        const v8::SourceLocation& location) {
-  auto entry = std::make_unique<TaskQueueEntry>(std::move(task), priority);
-  bool is_outstanding = entry->is_outstanding();
-  pending_worker_tasks_.Lock().Push(std::move(entry), is_outstanding);
+  Enqueue(std::make_unique<TaskQueueEntry>(std::move(task), priority));
 }
 
 void WorkerThreadsTaskRunner::PostDelayedTask(
@@ -296,12 +307,89 @@ void WorkerThreadsTaskRunner::PostDelayedTask(
       priority, std::move(task), delay_in_seconds);
 }
 
+void WorkerThreadsTaskRunner::Enqueue(std::unique_ptr<TaskQueueEntry> entry) {
+  if (entry->is_outstanding()) outstanding_tasks_++;
+  size_t priority = static_cast<size_t>(entry->priority);
+  CHECK_LT(priority, kPriorityCount);
+
+  if (current_worker_runner == this) {
+    worker_queues_[current_worker_id]->lanes[priority].Push(std::move(entry));
+  } else {
+    injected_tasks_[priority].Lock().Push(std::move(entry));
+    injected_task_count_[priority]++;
+  }
+  WakeWorker();
+}
+
+std::unique_ptr<TaskQueueEntry> WorkerThreadsTaskRunner::FindTask(int id) {
+  WorkerQueues* own = worker_queues_[id].get();
+  const size_t worker_count = worker_queues_.size();
+  for (size_t i = kPriorityCount; i-- > 0;) {
+    if (std::unique_ptr<TaskQueueEntry> entry = own->lanes[i].Pop()) {
+      return entry;
+    }
+    if (injected_task_count_[i] > 0) {
+      if (std::unique_ptr<TaskQueueEntry> entry =
+              injected_tasks_[i].Lock().Pop()) {
+        injected_task_count_[i]--;
+        return entry;
+      }
+    }
+    for (size_t n = 1; n < worker_count; n++) {
+      WorkerQueues* victim = worker_queues_[(id + n) % worker_count].get();
+      if (std::unique_ptr<TaskQueueEntry> entry = victim->lanes[i].Steal()) {
+        return entry;
+      }
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<TaskQueueEntry> WorkerThreadsTaskRunner::WaitForTask(int id) {
+  while (!stopped_) {
+    if (std::unique_ptr<TaskQueueEntry> entry = FindTask(id)) return entry;
+
+    Mutex::ScopedLock lock(idle_mutex_);
+    // Announce that this worker is about to sleep before looking one more
+    // time, so that a producer which pushed a task in the meantime either
+    // has it picked up here or sees idle_workers_ and wakes us.
+    idle_workers_++;
+    std::unique_ptr<TaskQueueEntry> entry = FindTask(id);
+    if (!entry && !stopped_) idle_workers_cv_.Wait(lock);
+    idle_workers_--;
+    if (entry && !stopped_) return entry;
+  }
+  return nullptr;
+}
+
+void WorkerThreadsTaskRunner::WakeWorker() {
+  // Pairs with the increment of idle_workers_ in WaitForTask().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (idle_workers_ == 0) return;
+  Mutex::ScopedLock lock(idle_mutex_);
+  idle_workers_cv_.Signal(lock);
+}
+
+void WorkerThreadsTaskRunner::NotifyOfOutstandingCompletion() {
+  if (--outstanding_tasks_ == 0) {
+    Mutex::ScopedLock lock(drain_mutex_);
+    outstanding_tasks_drained_.Broadcast(lock);
+  }
+}
+
 void WorkerThreadsTaskRunner::BlockingDrain() {
-  pending_worker_tasks_.Lock().BlockingDrain();
+  Mutex::ScopedLock lock(drain_mutex_);
+  while (outstanding_tasks_ > 0) {
+    outstanding_tasks_drained_.Wait(lock);
+  }
 }
 
 void WorkerThreadsTaskRunner::Shutdown() {
-  pending_worker_tasks_.Lock().Stop();
+  {
+    Mutex::ScopedLock lock(idle_mutex_);
+    stopped_ = true;
+    idle_workers_cv_.Broadcast(lock);
+  }
   delayed_task_scheduler_->Stop();
   for (size_t i = 0; i < threads_.size(); i++) {
     CHECK_EQ(0, uv_thread_join(threads_[i].get()));
@@ -845,6 +933,107 @@ TaskQueue<T>::PriorityQueue TaskQueue<T>::Locked::PopAll() {
   return result;
 }
 
+template <class T>
+WorkStealingDeque<T>::Buffer::Buffer(int64_t capacity)
+    : capacity(capacity), slots(new std::atomic<T*>[capacity]) {
+  CHECK_EQ(capacity & (capacity - 1), 0);
+}
+
+template <class T>
+WorkStealingDeque<T>::WorkStealingDeque() : top_(0), bottom_(0) {
+  buffers_.push_back(std::make_unique<Buffer>(kInitialCapacity));
+  buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+template <class T>
+WorkStealingDeque<T>::~WorkStealingDeque() {
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+  int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  for (int64_t i = top_.load(std::memory_order_relaxed); i < bottom; i++) {
+    delete buffer->at(i).load(std::memory_order_relaxed);
+  }
+}
+
+template <class T>
+typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::Grow(
+    Buffer* buffer, int64_t bottom, int64_t top) {
+  buffers_.push_back(std::make_unique<Buffer>(buffer->capacity * 2));
+  Buffer* grown = buffers_.back().get();
+  for (int64_t i = top; i < bottom; i++) {
+    grown->at(i).store(buffer->at(i).load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+  }
+  buffer_.store(grown, std::memory_order_release);
+  return grown;
+}
+
+// The memory orderings follow "Correct and Efficient Work-Stealing for Weak
+// Memory Models" (Le et al., PPoPP 2013).
+template <class T>
+void WorkStealingDeque<T>::Push(std::unique_ptr<T> entry) {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  int64_t top = top_.load(std::memory_order_acquire);
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+  if (bottom - top > buffer->capacity - 1) {
+    buffer = Grow(buffer, bottom, top);
+  }
+  buffer->at(bottom).store(entry.release(), std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+template <class T>
+std::unique_ptr<T> WorkStealingDeque<T>::Pop() {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = top_.load(std::memory_order_relaxed);
+
+  if (top > bottom) {
+    // Empty.
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  T* entry = buffer->at(bottom).load(std::memory_order_relaxed);
+  if (top == bottom) {
+    // The last entry, race the thieves for it.
+    if (!top_.compare_exchange_strong(top,
+                                      top + 1,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      entry = nullptr;
+    }
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return std::unique_ptr<T>(entry);
+}
+
+template <class T>
+std::unique_ptr<T> WorkStealingDeque<T>::Steal() {
+  while (true) {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) return nullptr;
+
+    Buffer* buffer = buffer_.load(std::memory_order_acquire);
+    T* entry = buffer->at(top).load(std::memory_order_relaxed);
+    if (top_.compare_exchange_strong(top,
+                                     top + 1,
+                                     std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      return std::unique_ptr<T>(entry);
+    }
+    // Lost the race against the owner or another thief, try again.
+  }
+}
+
+// The queues are only used in this file, but benchmark/native uses them too.
+template class TaskQueue<TaskQueueEntry>;
+template class WorkStealingDeque<TaskQueueEntry>;
+
 void MultiIsolatePlatform::DisposeIsolate(Isolate* isolate) {
   // The order of these calls is important. When the Isolate is disposed,
   // it may still post tasks to the platform, so it must still be registered
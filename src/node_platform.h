@@ -3,7 +3,9 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <queue>
 #include <type_traits>
 #include <unordered_map>
@@ -78,6 +80,45 @@ class TaskQueue {
   PriorityQueue task_queue_;
 };
 
+// A Chase-Lev work-stealing deque. The thread that owns it pushes and pops
+// at the bottom without taking a lock, while any other thread may steal from
+// the top. The deque owns the entries it holds.
+template <class T>
+class WorkStealingDeque {
+ public:
+  WorkStealingDeque();
+  ~WorkStealingDeque();
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // Only the owning thread may call Push() and Pop().
+  void Push(std::unique_ptr<T> entry);
+  std::unique_ptr<T> Pop();
+  // Safe to call from any thread. Returns nullptr if the deque is empty.
+  std::unique_ptr<T> Steal();
+
+ private:
+  struct Buffer {
+    explicit Buffer(int64_t capacity);
+    std::atomic<T*>& at(int64_t index) { return slots[index & (capacity - 1)]; }
+
+    const int64_t capacity;
+    std::unique_ptr<std::atomic<T*>[]> slots;
+  };
+
+  Buffer* Grow(Buffer* buffer, int64_t bottom, int64_t top);
+
+  static constexpr int64_t kInitialCapacity = 64;
+
+  std::atomic<int64_t> top_;
+  std::atomic<int64_t> bottom_;
+  std::atomic<Buffer*> buffer_;
+  // Every buffer the deque has used. A thief may still be reading from an
+  // older one after a Grow(), so they are only freed with the deque.
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
 struct TaskQueueEntry {
   std::unique_ptr<v8::Task> task;
   v8::TaskPriority priority;
@@ -201,15 +242,46 @@ class WorkerThreadsTaskRunner {
   int NumberOfWorkerThreads() const;
 
  private:
-  // A queue shared by all threads. The consumers are the worker threads which
-  // take tasks from it to run in PlatformWorkerThread(). The producers can be
-  // any thread. Both the foreground thread and the worker threads can push
-  // tasks into the queue via v8::Platform::PostTaskOnWorkerThread() which
-  // eventually calls PostTask() on this class. When any thread calls
-  // v8::Platform::PostDelayedTaskOnWorkerThread(), the DelayedTaskScheduler
-  // thread will schedule a timer that pushes the delayed tasks back into this
-  // queue when the timer expires.
-  TaskQueue<TaskQueueEntry> pending_worker_tasks_;
+  static constexpr size_t kPriorityCount =
+      static_cast<size_t>(v8::TaskPriority::kMaxPriority) + 1;
+
+  // The tasks posted by one worker thread, one deque per priority so that a
+  // pile of best-effort work never hides a user-blocking task.
+  struct WorkerQueues {
+    WorkStealingDeque<TaskQueueEntry> lanes[kPriorityCount];
+  };
+
+  static void PlatformWorkerThread(void* data);
+
+  void Enqueue(std::unique_ptr<TaskQueueEntry> entry);
+  std::unique_ptr<TaskQueueEntry> FindTask(int id);
+  std::unique_ptr<TaskQueueEntry> WaitForTask(int id);
+  void WakeWorker();
+  void NotifyOfOutstandingCompletion();
+
+  // Tasks posted by a worker thread go to the bottom of that worker's own
+  // deque, where it picks them up again without taking any lock. Idle
+  // workers steal from the top of the other workers' deques. Tasks posted
+  // by any other thread, i.e. the foreground threads and the
+  // DelayedTaskScheduler thread, go through the injection queues instead.
+  // For each priority, from highest to lowest, a worker looks at its own
+  // deque, then the injection queue, then tries to steal.
+  std::vector<std::unique_ptr<WorkerQueues>> worker_queues_;
+  TaskQueue<TaskQueueEntry> injected_tasks_[kPriorityCount];
+  // Lets workers skip the injection queue locks while they are empty.
+  std::atomic<size_t> injected_task_count_[kPriorityCount] = {};
+
+  // Workers that find nothing to run sleep on idle_workers_cv_. Producers
+  // only take idle_mutex_ to wake one of them when idle_workers_ is not 0.
+  Mutex idle_mutex_;
+  ConditionVariable idle_workers_cv_;
+  std::atomic<int> idle_workers_ = 0;
+  std::atomic<bool> stopped_ = false;
+
+  // See NodePlatform::DrainTasks().
+  Mutex drain_mutex_;
+  ConditionVariable outstanding_tasks_drained_;
+  std::atomic<int> outstanding_tasks_ = 0;
 
   class DelayedTaskScheduler;
   std::unique_ptr<DelayedTaskScheduler> delayed_task_scheduler_;
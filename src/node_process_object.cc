@@ -7,6 +7,7 @@
 #include "node_process-inl.h"
 #include "node_realm-inl.h"
 #include "node_revert.h"
+#include "node_simd_dispatch.h"
 #include "util-inl.h"
 
 #include <climits>  // PATH_MAX
@@ -93,6 +94,19 @@ static void SetVersions(Isolate* isolate, Local<Object> versions) {
   }
 }
 
+static void SetSimdDispatch(Isolate* isolate, Local<Object> simd) {
+  Local<Context> context = isolate->GetCurrentContext();
+
+  for (const auto& [subsystem, implementation] :
+       simd_dispatch::GetSelection()) {
+    simd->DefineOwnProperty(context,
+                            OneByteString(isolate, subsystem),
+                            OneByteString(isolate, implementation),
+                            v8::ReadOnly)
+        .Check();
+  }
+}
+
 MaybeLocal<Object> CreateProcessObject(Realm* realm) {
   Isolate* isolate = realm->isolate();
   EscapableHandleScope scope(isolate);
@@ -241,6 +255,13 @@ void PatchProcessObject(const FunctionCallbackInfo<Value>& args) {
   Local<Object> versions = Object::New(isolate);
   SetVersions(isolate, versions);
   READONLY_PROPERTY(process, "versions", versions);
+
+  // process.simd, set here rather than in CreateProcessObject() so that it
+  // describes the CPU the process runs on, not the one the snapshot was
+  // built on.
+  Local<Object> simd = Object::New(isolate);
+  SetSimdDispatch(isolate, simd);
+  READONLY_PROPERTY(process, "simd", simd);
 }
 
 void RegisterProcessExternalReferences(ExternalReferenceRegistry* registry) {
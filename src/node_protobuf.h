@@ -0,0 +1,88 @@
+#ifndef SRC_NODE_PROTOBUF_H_
+#define SRC_NODE_PROTOBUF_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace node {
+
+// Writes the fields of a protobuf message to a string, for the few trace
+// and profile formats that are written without the protobuf library. A
+// nested message is written to a ProtobufMessage of its own first, since
+// its size has to be known before it is appended to the enclosing one.
+class ProtobufMessage {
+ public:
+  enum WireType : uint32_t {
+    kVarint = 0,
+    kFixed64 = 1,
+    kLengthDelimited = 2,
+  };
+
+  void AppendVarint(uint32_t field, uint64_t value) {
+    AppendTag(field, kVarint);
+    AppendRawVarint(value);
+  }
+
+  void AppendDouble(uint32_t field, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    AppendTag(field, kFixed64);
+    for (int i = 0; i < 8; i++) {
+      data_.push_back(static_cast<char>(bits >> (i * 8)));
+    }
+  }
+
+  void AppendString(uint32_t field, std::string_view value) {
+    AppendTag(field, kLengthDelimited);
+    AppendRawVarint(value.size());
+    data_.append(value);
+  }
+
+  void AppendMessage(uint32_t field, const ProtobufMessage& message) {
+    AppendString(field, message.data_);
+  }
+
+  // Appends the fields of message to this one.
+  void AppendFields(const ProtobufMessage& message) {
+    data_.append(message.data_);
+  }
+
+  // Appends a repeated varint field in the packed encoding.
+  template <typename Iterable>
+  void AppendPackedVarints(uint32_t field, const Iterable& values) {
+    ProtobufMessage packed;
+    for (auto value : values) {
+      packed.AppendRawVarint(static_cast<uint64_t>(value));
+    }
+    AppendMessage(field, packed);
+  }
+
+  bool empty() const { return data_.empty(); }
+  const std::string& data() const { return data_; }
+  std::string Release() { return std::move(data_); }
+
+ private:
+  void AppendTag(uint32_t field, uint32_t wire_type) {
+    AppendRawVarint((static_cast<uint64_t>(field) << 3) | wire_type);
+  }
+
+  void AppendRawVarint(uint64_t value) {
+    while (value >= 0x80) {
+      data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+  }
+
+  std::string data_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_PROTOBUF_H_
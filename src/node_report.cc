@@ -22,12 +22,14 @@
 #include <ctime>
 #include <cwctype>
 #include <fstream>
+#include <memory>
 #include <ranges>
 
 constexpr int NODE_REPORT_VERSION = 5;
 constexpr int NANOS_PER_SEC = 1000 * 1000 * 1000;
 constexpr double SEC_PER_MICROS = 1e-6;
 constexpr int MAX_FRAME_COUNT = node::kMaxFrameCountForLogging;
+constexpr size_t kReportFileBufferSize = 1 << 16;
 
 namespace node {
 using node::worker::Worker;
@@ -53,7 +55,24 @@ using v8::V8;
 using v8::Value;
 
 namespace report {
+// What a report has and how it is formatted, from the options of env, or
+// of the process when there is no env.
+struct ReportSettings {
+  bool compact = false;
+  bool exclude_network = false;
+  bool exclude_env = false;
+  bool summarize_handles = false;
+  uint32_t sections = kReportAllSections;
+};
+
 // Internal/static function declarations
+static ReportSettings GetReportSettings(Environment* env);
+static void WriteLibuvHandles(JSONWriter* writer,
+                              Environment* env,
+                              const ReportSettings& settings);
+static void WriteWorkers(JSONWriter* writer,
+                         Environment* env,
+                         std::string_view trigger);
 static void WriteNodeReport(Isolate* isolate,
                             Environment* env,
                             std::string_view message,
@@ -61,9 +80,7 @@ static void WriteNodeReport(Isolate* isolate,
                             std::string_view filename,
                             std::ostream& out,
                             Local<Value> error,
-                            bool compact,
-                            bool exclude_network = false,
-                            bool exclude_env = false);
+                            const ReportSettings& settings);
 static void PrintVersionInformation(JSONWriter* writer,
                                     bool exclude_network = false);
 static void PrintJavaScriptErrorStack(JSONWriter* writer,
@@ -97,9 +114,10 @@ static void WriteNodeReport(Isolate* isolate,
                             std::string_view filename,
                             std::ostream& out,
                             Local<Value> error,
-                            bool compact,
-                            bool exclude_network,
-                            bool exclude_env) {
+                            const ReportSettings& settings) {
+  const bool exclude_network = settings.exclude_network;
+  const uint32_t sections = settings.sections;
+
   // Obtain the current time and the pid.
   TIME_TYPE tm_struct;
   DiagnosticFilename::LocalTime(&tm_struct);
@@ -112,7 +130,7 @@ static void WriteNodeReport(Isolate* isolate,
   // File stream opened OK, now start printing the report content:
   // the title and header information (event, filename, timestamp and pid)
 
-  JSONWriter writer(out, compact);
+  JSONWriter writer(out, settings.compact);
   writer.json_start();
   writer.json_objectstart("header");
   writer.json_keyvalue("reportVersion", NODE_REPORT_VERSION);
@@ -183,49 +201,81 @@ static void WriteNodeReport(Isolate* isolate,
   PrintVersionInformation(&writer, exclude_network);
   writer.json_objectend();
 
-  if (isolate != nullptr) {
+  if (sections & kReportJavaScriptStack) {
     writer.json_objectstart("javascriptStack");
-    // Report summary JavaScript error stack backtrace
-    PrintJavaScriptErrorStack(&writer, isolate, error, trigger);
-
+    if (isolate != nullptr) {
+      // Report summary JavaScript error stack backtrace
+      PrintJavaScriptErrorStack(&writer, isolate, error, trigger);
+    } else {
+      PrintEmptyJavaScriptStack(&writer);
+    }
     writer.json_objectend();  // the end of 'javascriptStack'
+  }
 
-    // Report V8 Heap and Garbage Collector information
+  // Report V8 Heap and Garbage Collector information
+  if (isolate != nullptr && (sections & kReportJavaScriptHeap)) {
     PrintGCStatistics(&writer, isolate);
-  } else {
-    writer.json_objectstart("javascriptStack");
-    PrintEmptyJavaScriptStack(&writer);
-    writer.json_objectend();  // the end of 'javascriptStack'
   }
 
   // Report native stack backtrace
-  PrintNativeStack(&writer);
+  if (sections & kReportNativeStack) PrintNativeStack(&writer);
 
   // Report OS and current thread resource usage
-  PrintResourceUsage(&writer);
+  if (sections & kReportResourceUsage) PrintResourceUsage(&writer);
+
+  if (sections & kReportLibuv) {
+    WriteLibuvHandles(&writer, env, settings);
+  }
+
+  if (sections & kReportWorkers) {
+    WriteWorkers(&writer, env, trigger);
+  }
+
+  // Report operating system information
+  if (!settings.exclude_env && (sections & kReportEnvironmentVariables)) {
+    PrintEnvironmentVariables(&writer);
+  }
+  if (sections & kReportSystem) PrintSystemInformation(&writer);
+
+  writer.json_objectend();
+
+  // Restore output stream formatting.
+  out.copyfmt(old_state);
+}
 
-  writer.json_arraystart("libuv");
+static void WriteLibuvHandles(JSONWriter* writer,
+                              Environment* env,
+                              const ReportSettings& settings) {
+  writer->json_arraystart("libuv");
   if (env != nullptr) {
-    uv_walk(env->event_loop(),
-            exclude_network ? WalkHandleNoNetwork : WalkHandleNetwork,
-            static_cast<void*>(&writer));
+    if (settings.summarize_handles) {
+      SummarizeHandles(env->event_loop(), writer);
+    } else {
+      uv_walk(env->event_loop(),
+              settings.exclude_network ? WalkHandleNoNetwork
+                                       : WalkHandleNetwork,
+              static_cast<void*>(writer));
+    }
 
-    writer.json_start();
-    writer.json_keyvalue("type", "loop");
-    writer.json_keyvalue("is_active",
+    writer->json_start();
+    writer->json_keyvalue("type", "loop");
+    writer->json_keyvalue("is_active",
         static_cast<bool>(uv_loop_alive(env->event_loop())));
-    writer.json_keyvalue("address",
+    writer->json_keyvalue("address",
         ValueToHexString(reinterpret_cast<int64_t>(env->event_loop())));
 
     // Report Event loop idle time
     uint64_t idle_time = uv_metrics_idle_time(env->event_loop());
-    writer.json_keyvalue("loopIdleTimeSeconds", 1.0 * idle_time / 1e9);
-    writer.json_end();
+    writer->json_keyvalue("loopIdleTimeSeconds", 1.0 * idle_time / 1e9);
+    writer->json_end();
   }
+  writer->json_arrayend();
+}
 
-  writer.json_arrayend();
-
-  writer.json_arraystart("workers");
+static void WriteWorkers(JSONWriter* writer,
+                         Environment* env,
+                         std::string_view trigger) {
+  writer->json_arraystart("workers");
   if (env != nullptr) {
     Mutex workers_mutex;
     ConditionVariable notify;
@@ -250,20 +300,28 @@ static void WriteNodeReport(Isolate* isolate,
     while (worker_infos.size() < expected_results)
       notify.Wait(lock);
     for (const std::string& worker_info : worker_infos)
-      writer.json_element(JSONWriter::ForeignJSON { worker_info });
+      writer->json_element(JSONWriter::ForeignJSON { worker_info });
   }
-  writer.json_arrayend();
+  writer->json_arrayend();
+}
 
-  // Report operating system information
-  if (exclude_env == false) {
-    PrintEnvironmentVariables(&writer);
+static ReportSettings GetReportSettings(Environment* env) {
+  const EnvironmentOptions* options =
+      env != nullptr ? env->options().get()
+                     : per_process::cli_options->per_isolate->per_env.get();
+  ReportSettings settings;
+  {
+    Mutex::ScopedLock lock(per_process::cli_options_mutex);
+    settings.compact = per_process::cli_options->report_compact;
   }
-  PrintSystemInformation(&writer);
-
-  writer.json_objectend();
-
-  // Restore output stream formatting.
-  out.copyfmt(old_state);
+  settings.exclude_network = options->report_exclude_network;
+  settings.exclude_env = options->report_exclude_env;
+  settings.summarize_handles = options->report_summarize_handles;
+  // The list was checked when the options were parsed.
+  if (!ParseReportSections(options->report_sections, &settings.sections)) {
+    settings.sections = kReportAllSections;
+  }
+  return settings;
 }
 
 // Report Node.js version, OS version and machine information.
@@ -863,6 +921,11 @@ std::string TriggerNodeReport(Isolate* isolate,
     }
   }
 
+  // The report is written a few bytes at a time, so a file is given a large
+  // buffer, and a report to stdout/err is written to them all at once.
+  std::unique_ptr<char[]> file_buffer;
+  std::ostringstream console_buffer;
+
   // Open the report file stream for writing. Supports stdout/err,
   // user-specified or (default) generated name
   std::ofstream outfile;
@@ -877,6 +940,8 @@ std::string TriggerNodeReport(Isolate* isolate,
       Mutex::ScopedLock lock(per_process::cli_options_mutex);
       report_directory = per_process::cli_options->report_directory;
     }
+    file_buffer.reset(new char[kReportFileBufferSize]);
+    outfile.rdbuf()->pubsetbuf(file_buffer.get(), kReportFileBufferSize);
     // Regular file. Append filename to directory path if one was specified
     if (report_directory.length() > 0) {
       std::string pathname = report_directory + kPathSeparator + filename;
@@ -898,34 +963,21 @@ std::string TriggerNodeReport(Isolate* isolate,
     std::cerr << "\nWriting Node.js report to file: " << filename;
   }
 
-  bool compact;
-  {
-    Mutex::ScopedLock lock(per_process::cli_options_mutex);
-    compact = per_process::cli_options->report_compact;
-  }
-
-  bool exclude_network = env != nullptr ? env->options()->report_exclude_network
-                                        : per_process::cli_options->per_isolate
-                                              ->per_env->report_exclude_network;
-  bool exclude_env =
-      env != nullptr
-          ? env->report_exclude_env()
-          : per_process::cli_options->per_isolate->per_env->report_exclude_env;
-
-  report::WriteNodeReport(isolate,
-                          env,
-                          message,
-                          trigger,
-                          filename,
-                          *outstream,
-                          error,
-                          compact,
-                          exclude_network,
-                          exclude_env);
+  report::WriteNodeReport(
+      isolate,
+      env,
+      message,
+      trigger,
+      filename,
+      outfile.is_open() ? static_cast<std::ostream&>(outfile) : console_buffer,
+      error,
+      report::GetReportSettings(env));
 
   // Do not close stdout/stderr, only close files we opened.
   if (outfile.is_open()) {
     outfile.close();
+  } else {
+    *outstream << console_buffer.str() << std::flush;
   }
 
   // Do not mix JSON and free-form text on stderr.
@@ -972,23 +1024,10 @@ void GetNodeReport(Isolate* isolate,
   if (isolate != nullptr) {
     env = Environment::GetCurrent(isolate);
   }
-  bool exclude_network = env != nullptr ? env->options()->report_exclude_network
-                                        : per_process::cli_options->per_isolate
-                                              ->per_env->report_exclude_network;
-  bool exclude_env =
-      env != nullptr
-          ? env->report_exclude_env()
-          : per_process::cli_options->per_isolate->per_env->report_exclude_env;
-  report::WriteNodeReport(isolate,
-                          env,
-                          message,
-                          trigger,
-                          "",
-                          out,
-                          error,
-                          false,
-                          exclude_network,
-                          exclude_env);
+  report::ReportSettings settings = report::GetReportSettings(env);
+  settings.compact = false;
+  report::WriteNodeReport(
+      isolate, env, message, trigger, "", out, error, settings);
 }
 
 // External function to trigger a report, writing to a supplied stream.
@@ -1001,23 +1040,10 @@ void GetNodeReport(Environment* env,
   if (env != nullptr) {
     isolate = env->isolate();
   }
-  bool exclude_network = env != nullptr ? env->options()->report_exclude_network
-                                        : per_process::cli_options->per_isolate
-                                              ->per_env->report_exclude_network;
-  bool exclude_env =
-      env != nullptr
-          ? env->report_exclude_env()
-          : per_process::cli_options->per_isolate->per_env->report_exclude_env;
-  report::WriteNodeReport(isolate,
-                          env,
-                          message,
-                          trigger,
-                          "",
-                          out,
-                          error,
-                          false,
-                          exclude_network,
-                          exclude_env);
+  report::ReportSettings settings = report::GetReportSettings(env);
+  settings.compact = false;
+  report::WriteNodeReport(
+      isolate, env, message, trigger, "", out, error, settings);
 }
 
 }  // namespace node
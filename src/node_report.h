@@ -15,12 +15,35 @@
 
 #include <iomanip>
 #include <sstream>
+#include <string_view>
 
 namespace node {
+class JSONWriter;
+
 namespace report {
+// The sections of a report that --report-sections selects. The header is
+// always written.
+enum ReportSection : uint32_t {
+  kReportJavaScriptStack = 1 << 0,
+  kReportJavaScriptHeap = 1 << 1,
+  kReportNativeStack = 1 << 2,
+  kReportResourceUsage = 1 << 3,
+  kReportLibuv = 1 << 4,
+  kReportWorkers = 1 << 5,
+  kReportEnvironmentVariables = 1 << 6,
+  kReportSystem = 1 << 7,
+  kReportAllSections = (1 << 8) - 1,
+};
+
 // Function declarations - utility functions in src/node_report_utils.cc
 void WalkHandleNetwork(uv_handle_t* h, void* arg);
 void WalkHandleNoNetwork(uv_handle_t* h, void* arg);
+// Writes the number of handles of each type, instead of every handle.
+void SummarizeHandles(uv_loop_t* loop, JSONWriter* writer);
+// Parses a comma-separated list of the section names js, heap, native,
+// resources, libuv, workers, env and system into a mask of ReportSections.
+// An empty list selects every section.
+bool ParseReportSections(std::string_view list, uint32_t* sections);
 
 template <typename T>
 std::string ValueToHexString(T value) {
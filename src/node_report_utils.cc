@@ -3,6 +3,10 @@
 #include "node_report.h"
 #include "util-inl.h"
 
+#include <algorithm>
+#include <array>
+#include <utility>
+
 namespace node {
 namespace report {
 
@@ -283,5 +287,66 @@ void WalkHandleNetwork(uv_handle_t* h, void* arg) {
 void WalkHandleNoNetwork(uv_handle_t* h, void* arg) {
   WalkHandle(h, arg, true);
 }
+
+void SummarizeHandles(uv_loop_t* loop, JSONWriter* writer) {
+  struct Counts {
+    size_t count = 0;
+    size_t active = 0;
+    size_t referenced = 0;
+  };
+  std::array<Counts, UV_HANDLE_TYPE_MAX> counts{};
+  uv_walk(
+      loop,
+      [](uv_handle_t* h, void* arg) {
+        Counts& type_counts =
+            (*static_cast<std::array<Counts, UV_HANDLE_TYPE_MAX>*>(
+                arg))[h->type];
+        type_counts.count++;
+        if (uv_is_active(h)) type_counts.active++;
+        if (uv_has_ref(h)) type_counts.referenced++;
+      },
+      &counts);
+
+  for (size_t type = 0; type < counts.size(); type++) {
+    if (counts[type].count == 0) continue;
+    writer->json_start();
+    writer->json_keyvalue(
+        "type", uv_handle_type_name(static_cast<uv_handle_type>(type)));
+    writer->json_keyvalue("count", counts[type].count);
+    writer->json_keyvalue("active", counts[type].active);
+    writer->json_keyvalue("referenced", counts[type].referenced);
+    writer->json_end();
+  }
+}
+
+bool ParseReportSections(std::string_view list, uint32_t* sections) {
+  static constexpr std::pair<std::string_view, ReportSection> kNames[] = {
+      {"js", kReportJavaScriptStack},
+      {"heap", kReportJavaScriptHeap},
+      {"native", kReportNativeStack},
+      {"resources", kReportResourceUsage},
+      {"libuv", kReportLibuv},
+      {"workers", kReportWorkers},
+      {"env", kReportEnvironmentVariables},
+      {"system", kReportSystem},
+  };
+  if (list.empty()) {
+    *sections = kReportAllSections;
+    return true;
+  }
+  *sections = 0;
+  while (true) {
+    size_t comma = list.find(',');
+    std::string_view name = list.substr(0, comma);
+    auto it = std::find_if(
+        std::begin(kNames), std::end(kNames), [&](const auto& entry) {
+          return entry.first == name;
+        });
+    if (it == std::end(kNames)) return false;
+    *sections |= it->second;
+    if (comma == std::string_view::npos) return true;
+    list.remove_prefix(comma + 1);
+  }
+}
 }  // namespace report
 }  // namespace node
@@ -11,6 +11,7 @@
 #include "node_snapshot_builder.h"
 #include "node_union_bytes.h"
 #include "node_v8_platform-inl.h"
+#include "path.h"
 #include "simdjson.h"
 #include "util-inl.h"
 
@@ -40,11 +41,13 @@ using v8::Isolate;
 using v8::Local;
 using v8::LocalVector;
 using v8::MaybeLocal;
+using v8::Module;
 using v8::NewStringType;
 using v8::Object;
 using v8::ScriptCompiler;
 using v8::ScriptOrigin;
 using v8::String;
+using v8::UnboundModuleScript;
 using v8::Value;
 
 namespace node {
@@ -142,6 +145,20 @@ size_t SeaSerializer::Write(const SeaResource& sea) {
       written_total += WriteStringView(arg, StringLogMode::kAddressAndContent);
     }
   }
+
+  if (static_cast<bool>(sea.flags & SeaFlags::kIncludeModuleCodeCache)) {
+    Debug("Write SEA resource module code cache size %zu\n",
+          sea.module_code_cache.size());
+    written_total += WriteArithmetic<size_t>(sea.module_code_cache.size());
+    for (auto const& [path, cache] : sea.module_code_cache) {
+      Debug("Write SEA resource module code cache %s at %p, size=%zu\n",
+            path,
+            cache.data(),
+            cache.size());
+      written_total += WriteStringView(path, StringLogMode::kAddressAndContent);
+      written_total += WriteStringView(cache, StringLogMode::kAddressOnly);
+    }
+  }
   return written_total;
 }
 
@@ -224,13 +241,30 @@ SeaResource SeaDeserializer::Read() {
       exec_argv.emplace_back(arg);
     }
   }
+
+  std::unordered_map<std::string_view, std::string_view> module_code_cache;
+  if (static_cast<bool>(flags & SeaFlags::kIncludeModuleCodeCache)) {
+    size_t module_code_cache_size = ReadArithmetic<size_t>();
+    Debug("Read SEA resource module code cache size %zu\n",
+          module_code_cache_size);
+    for (size_t i = 0; i < module_code_cache_size; ++i) {
+      std::string_view path = ReadStringView(StringLogMode::kAddressAndContent);
+      std::string_view cache = ReadStringView(StringLogMode::kAddressOnly);
+      Debug("Read SEA resource module code cache %s at %p, size=%zu\n",
+            path,
+            cache.data(),
+            cache.size());
+      module_code_cache.emplace(path, cache);
+    }
+  }
   return {flags,
           exec_argv_extension,
           code_path,
           code,
           code_cache,
           assets,
-          exec_argv};
+          exec_argv,
+          module_code_cache};
 }
 
 std::string_view FindSingleExecutableBlob() {
@@ -287,6 +321,52 @@ bool IsSingleExecutable() {
   return postject_has_resource();
 }
 
+namespace {
+// Module code caches are keyed by the path of the module relative to the
+// directory of the executable, normalized and with forward slashes.
+std::string ModuleCodeCacheKey(std::string_view relative_path) {
+  std::string key = NormalizeString(relative_path, true, "/");
+#ifdef _WIN32
+  for (char& c : key) {
+    if (c == '\\') c = '/';
+  }
+#endif
+  return key;
+}
+}  // anonymous namespace
+
+ScriptCompiler::CachedData* FindModuleCodeCache(Environment* env,
+                                                Local<String> filename) {
+  if (!IsSingleExecutable()) {
+    return nullptr;
+  }
+  static const SeaResource sea_resource = FindSingleExecutableResource();
+  if (sea_resource.module_code_cache.empty()) {
+    return nullptr;
+  }
+
+  std::string exec_dir = NormalizeFileURLOrPath(env, env->exec_path());
+  exec_dir.resize(exec_dir.rfind('/') + 1);
+  Utf8Value filename_utf8(env->isolate(), filename);
+  std::string path = NormalizeFileURLOrPath(env, filename_utf8.ToStringView());
+  if (exec_dir.size() <= 1 || !path.starts_with(exec_dir)) {
+    return nullptr;
+  }
+  auto it = sea_resource.module_code_cache.find(
+      std::string_view(path).substr(exec_dir.size()));
+  per_process::Debug(DebugCategory::SEA,
+                     "%s embedded code cache for %s\n",
+                     it == sea_resource.module_code_cache.end() ? "No" : "Use",
+                     path);
+  if (it == sea_resource.module_code_cache.end()) {
+    return nullptr;
+  }
+  return new ScriptCompiler::CachedData(
+      reinterpret_cast<const uint8_t*>(it->second.data()),
+      static_cast<int>(it->second.size()),
+      ScriptCompiler::CachedData::BufferNotOwned);
+}
+
 void IsSea(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(IsSingleExecutable());
 }
@@ -382,6 +462,7 @@ struct SeaConfig {
   SeaExecArgvExtension exec_argv_extension = SeaExecArgvExtension::kEnv;
   std::unordered_map<std::string, std::string> assets;
   std::vector<std::string> exec_argv;
+  std::vector<std::string> module_code_cache;
 };
 
 std::optional<SeaConfig> ParseSingleExecutableConfig(
@@ -523,6 +604,40 @@ std::optional<SeaConfig> ParseSingleExecutableConfig(
         result.flags |= SeaFlags::kIncludeExecArgv;
         result.exec_argv = std::move(exec_argv);
       }
+    } else if (key == "moduleCodeCache") {
+      simdjson::ondemand::array paths_array;
+      if (field.value().get_array().get(paths_array)) {
+        FPrintF(stderr,
+                "\"moduleCodeCache\" field of %s is not an array of strings\n",
+                config_path);
+        return std::nullopt;
+      }
+      std::vector<std::string> paths;
+      for (auto path : paths_array) {
+        std::string_view path_str;
+        if (path.get_string().get(path_str)) {
+          FPrintF(stderr,
+                  "\"moduleCodeCache\" field of %s is not an array of "
+                  "strings\n",
+                  config_path);
+          return std::nullopt;
+        }
+        std::string key = ModuleCodeCacheKey(path_str);
+        if (IsAbsoluteFilePath(path_str) || key.empty() || key == ".." ||
+            key.starts_with("../")) {
+          FPrintF(stderr,
+                  "\"moduleCodeCache\" field of %s contains %s, which is not "
+                  "a path relative to and within the current directory\n",
+                  config_path,
+                  path_str);
+          return std::nullopt;
+        }
+        paths.emplace_back(path_str);
+      }
+      if (!paths.empty()) {
+        result.flags |= SeaFlags::kIncludeModuleCodeCache;
+        result.module_code_cache = std::move(paths);
+      }
     } else if (key == "execArgvExtension") {
       std::string_view extension_str;
       if (field.value().get_string().get(extension_str)) {
@@ -610,20 +725,14 @@ ExitCode GenerateSnapshotForSEA(const SeaConfig& config,
   return ExitCode::kNoFailure;
 }
 
-std::optional<std::string> GenerateCodeCache(std::string_view main_path,
-                                             std::string_view main_script) {
-  RAIIIsolate raii_isolate(SnapshotBuilder::GetEmbeddedSnapshotData());
-  Isolate* isolate = raii_isolate.get();
-
-  v8::Isolate::Scope isolate_scope(isolate);
+// Compiles the source as a CommonJS module, or as an ES module if is_esm
+// is true, and creates its code cache.
+std::optional<std::string> CreateCodeCache(Isolate* isolate,
+                                           Local<Context> context,
+                                           std::string_view main_path,
+                                           std::string_view main_script,
+                                           bool is_esm) {
   HandleScope handle_scope(isolate);
-
-  Local<Context> context = Context::New(isolate);
-  Context::Scope context_scope(context);
-
-  errors::PrinterTryCatch bootstrapCatch(
-      isolate, errors::PrinterTryCatch::kPrintSourceLine);
-
   Local<String> filename;
   if (!String::NewFromUtf8(isolate,
                            main_path.data(),
@@ -642,6 +751,28 @@ std::optional<std::string> GenerateCodeCache(std::string_view main_path,
     return std::nullopt;
   }
 
+  if (is_esm) {
+    ScriptOrigin module_origin(filename,
+                               0,               // line offset
+                               0,               // column offset
+                               true,            // is cross origin
+                               -1,              // script id
+                               Local<Value>(),  // source map URL
+                               false,           // is opaque
+                               false,           // is WASM
+                               true);           // is ES Module
+    ScriptCompiler::Source module_source(content, module_origin);
+    Local<Module> module;
+    if (!ScriptCompiler::CompileModule(isolate, &module_source)
+             .ToLocal(&module)) {
+      return std::nullopt;
+    }
+    Local<UnboundModuleScript> script = module->GetUnboundModuleScript();
+    std::unique_ptr<ScriptCompiler::CachedData> cache{
+        ScriptCompiler::CreateCodeCache(script)};
+    return std::string(cache->data, cache->data + cache->length);
+  }
+
   LocalVector<String> parameters(
       isolate,
       {
@@ -674,6 +805,59 @@ std::optional<std::string> GenerateCodeCache(std::string_view main_path,
   return code_cache;
 }
 
+std::optional<std::string> GenerateCodeCache(std::string_view main_path,
+                                             std::string_view main_script) {
+  RAIIIsolate raii_isolate(SnapshotBuilder::GetEmbeddedSnapshotData());
+  Isolate* isolate = raii_isolate.get();
+
+  v8::Isolate::Scope isolate_scope(isolate);
+  HandleScope handle_scope(isolate);
+
+  Local<Context> context = Context::New(isolate);
+  Context::Scope context_scope(context);
+
+  errors::PrinterTryCatch bootstrapCatch(
+      isolate, errors::PrinterTryCatch::kPrintSourceLine);
+  return CreateCodeCache(isolate, context, main_path, main_script, false);
+}
+
+// Creates the code cache of the modules listed in "moduleCodeCache". Files
+// ending with .mjs are compiled as ES modules, the others as CommonJS.
+// Caches of modules that turn out to be of the other kind are rejected by
+// V8 at run time, since the module flag is part of the source hash that
+// it checks.
+int GenerateModuleCodeCache(const std::vector<std::string>& paths,
+                            std::unordered_map<std::string, std::string>* out) {
+  RAIIIsolate raii_isolate(SnapshotBuilder::GetEmbeddedSnapshotData());
+  Isolate* isolate = raii_isolate.get();
+
+  v8::Isolate::Scope isolate_scope(isolate);
+  HandleScope handle_scope(isolate);
+
+  Local<Context> context = Context::New(isolate);
+  Context::Scope context_scope(context);
+
+  errors::PrinterTryCatch bootstrapCatch(
+      isolate, errors::PrinterTryCatch::kPrintSourceLine);
+  for (const std::string& path : paths) {
+    std::string source;
+    int r = ReadFileSync(&source, path.c_str());
+    if (r != 0) {
+      const char* err = uv_strerror(r);
+      FPrintF(stderr, "Cannot read module %s: %s\n", path, err);
+      return r;
+    }
+    std::optional<std::string> cache = CreateCodeCache(
+        isolate, context, path, source, path.ends_with(".mjs"));
+    if (!cache.has_value()) {
+      FPrintF(stderr, "Cannot generate V8 code cache for %s\n", path);
+      return UV_EINVAL;
+    }
+    out->insert_or_assign(ModuleCodeCacheKey(path), std::move(*cache));
+  }
+  return 0;
+}
+
 int BuildAssets(const std::unordered_map<std::string, std::string>& config,
                 std::unordered_map<std::string, std::string>* assets) {
   for (auto const& [key, path] : config) {
@@ -741,6 +925,17 @@ ExitCode GenerateSingleExecutableBlob(
   for (const auto& arg : config.exec_argv) {
     exec_argv_view.emplace_back(arg);
   }
+  std::unordered_map<std::string, std::string> module_code_cache;
+  if (!config.module_code_cache.empty() &&
+      GenerateModuleCodeCache(config.module_code_cache, &module_code_cache) !=
+          0) {
+    return ExitCode::kGenericUserError;
+  }
+  std::unordered_map<std::string_view, std::string_view>
+      module_code_cache_view;
+  for (auto const& [key, cache] : module_code_cache) {
+    module_code_cache_view.emplace(key, cache);
+  }
   SeaResource sea{
       config.flags,
       config.exec_argv_extension,
@@ -750,7 +945,8 @@ ExitCode GenerateSingleExecutableBlob(
           : std::string_view{main_script.data(), main_script.size()},
       optional_sv_code_cache,
       assets_view,
-      exec_argv_view};
+      exec_argv_view,
+      module_code_cache_view};
 
   SeaSerializer serializer;
   serializer.Write(sea);
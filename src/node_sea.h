@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "node_exit_code.h"
+#include "v8.h"
 
 namespace node {
 class Environment;
@@ -29,6 +30,7 @@ enum class SeaFlags : uint32_t {
   kUseCodeCache = 1 << 2,
   kIncludeAssets = 1 << 3,
   kIncludeExecArgv = 1 << 4,
+  kIncludeModuleCodeCache = 1 << 5,
 };
 
 enum class SeaExecArgvExtension : uint8_t {
@@ -45,6 +47,9 @@ struct SeaResource {
   std::optional<std::string_view> code_cache;
   std::unordered_map<std::string_view, std::string_view> assets;
   std::vector<std::string_view> exec_argv;
+  // Code cache of the application's modules, keyed by their paths relative
+  // to the directory of the executable.
+  std::unordered_map<std::string_view, std::string_view> module_code_cache;
 
   bool use_snapshot() const;
   bool use_code_cache() const;
@@ -61,6 +66,13 @@ node::ExitCode BuildSingleExecutableBlob(
     const std::vector<std::string>& args,
     const std::vector<std::string>& exec_args);
 
+// Returns the code cache embedded for the CommonJS or ES module at filename
+// (a path or a file URL) through the "moduleCodeCache" field of the SEA
+// config, or nullptr. The caller takes ownership of the returned data,
+// which points into the blob.
+v8::ScriptCompiler::CachedData* FindModuleCodeCache(
+    Environment* env, v8::Local<v8::String> filename);
+
 // Try loading the Environment as a single-executable application.
 // Returns true if it is loaded as a single-executable application.
 // Otherwise returns false and the caller is expected to call LoadEnvironment()
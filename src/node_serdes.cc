@@ -5,10 +5,15 @@
 #include "node_internals.h"
 #include "util-inl.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
 namespace node {
 
 using v8::Array;
 using v8::ArrayBuffer;
+using v8::ArrayBufferView;
 using v8::Context;
 using v8::Function;
 using v8::FunctionCallbackInfo;
@@ -23,6 +28,7 @@ using v8::Nothing;
 using v8::Object;
 using v8::SharedArrayBuffer;
 using v8::String;
+using v8::Uint32Array;
 using v8::Value;
 using v8::ValueDeserializer;
 using v8::ValueSerializer;
@@ -35,12 +41,16 @@ class SerializerContext : public BaseObject,
   SerializerContext(Environment* env,
                     Local<Object> wrap);
 
-  ~SerializerContext() override = default;
+  ~SerializerContext() override;
 
   void ThrowDataCloneError(Local<String> message) override;
   Maybe<bool> WriteHostObject(Isolate* isolate, Local<Object> object) override;
   Maybe<uint32_t> GetSharedArrayBufferId(
       Isolate* isolate, Local<SharedArrayBuffer> shared_array_buffer) override;
+  void* ReallocateBufferMemory(void* old_buffer,
+                               size_t size,
+                               size_t* actual_size) override;
+  void FreeBufferMemory(void* buffer) override;
 
   static void SetTreatArrayBufferViewsAsHostObjects(
       const FunctionCallbackInfo<Value>& args);
@@ -55,12 +65,40 @@ class SerializerContext : public BaseObject,
   static void WriteDouble(const FunctionCallbackInfo<Value>& args);
   static void WriteRawBytes(const FunctionCallbackInfo<Value>& args);
 
-  SET_NO_MEMORY_INFO()
+  // serializeInto(value, target, offset) serializes a header and value, the
+  // way v8.serialize() does, and copies them into target at offset if they
+  // fit. It returns the length of the serialized data either way.
+  static void SerializeInto(const FunctionCallbackInfo<Value>& args);
+  // serializeArrayInto(values, target, offset, ends) does the same for each
+  // element of values in turn, storing the offset at which each one ends in
+  // ends. It stops at the first one that does not fit and returns the number
+  // of elements that were written.
+  static void SerializeArrayInto(const FunctionCallbackInfo<Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(SerializerContext)
   SET_SELF_SIZE(SerializerContext)
 
  private:
+  // The serializeInto() family serializes into pool_, which is kept between
+  // calls unless it grows past kMaxPoolSize.
+  static constexpr size_t kInitialPoolSize = 4096;
+  static constexpr size_t kMaxPoolSize = 1024 * 1024;
+
+  // Serializes a header and value into pool_ with a fresh ValueSerializer,
+  // since one cannot be reused once its buffer has been released.
+  Maybe<size_t> SerializeToPool(Local<Value> value);
+  void TrimPool();
+
   ValueSerializer serializer_;
+  // The serializer that the write*() methods write to. This is the one of
+  // SerializeToPool() while it runs, so that writeHostObject() hooks write
+  // to the right place.
+  ValueSerializer* current_ = &serializer_;
+  bool treat_array_buffer_views_as_host_objects_ = false;
+  bool in_pooled_write_ = false;
+  char* pool_ = nullptr;
+  size_t pool_size_ = 0;
 };
 
 class DeserializerContext : public BaseObject,
@@ -101,6 +139,63 @@ SerializerContext::SerializerContext(Environment* env, Local<Object> wrap)
   MakeWeak();
 }
 
+SerializerContext::~SerializerContext() {
+  free(pool_);
+}
+
+void SerializerContext::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("pool", pool_size_);
+}
+
+void* SerializerContext::ReallocateBufferMemory(void* old_buffer,
+                                                size_t size,
+                                                size_t* actual_size) {
+  if (!in_pooled_write_) {
+    return ValueSerializer::Delegate::ReallocateBufferMemory(
+        old_buffer, size, actual_size);
+  }
+  CHECK(old_buffer == nullptr || old_buffer == pool_);
+  if (size > pool_size_) {
+    const size_t new_size = std::max({size, pool_size_ * 2, kInitialPoolSize});
+    char* pool = static_cast<char*>(realloc(pool_, new_size));
+    if (pool == nullptr) return nullptr;
+    pool_ = pool;
+    pool_size_ = new_size;
+  }
+  *actual_size = pool_size_;
+  return pool_;
+}
+
+void SerializerContext::FreeBufferMemory(void* buffer) {
+  // A ValueSerializer that fails while writing to the pool frees it.
+  if (buffer != nullptr && buffer == pool_) return;
+  ValueSerializer::Delegate::FreeBufferMemory(buffer);
+}
+
+Maybe<size_t> SerializerContext::SerializeToPool(Local<Value> value) {
+  ValueSerializer serializer(env()->isolate(), this);
+  serializer.SetTreatArrayBufferViewsAsHostObjects(
+      treat_array_buffer_views_as_host_objects_);
+  current_ = &serializer;
+  in_pooled_write_ = true;
+  serializer.WriteHeader();
+  Maybe<bool> ret = serializer.WriteValue(env()->context(), value);
+  current_ = &serializer_;
+  in_pooled_write_ = false;
+  if (ret.IsNothing()) return Nothing<size_t>();
+
+  std::pair<uint8_t*, size_t> data = serializer.Release();
+  CHECK_EQ(reinterpret_cast<char*>(data.first), pool_);
+  return Just(data.second);
+}
+
+void SerializerContext::TrimPool() {
+  if (pool_size_ <= kMaxPoolSize) return;
+  free(pool_);
+  pool_ = nullptr;
+  pool_size_ = 0;
+}
+
 void SerializerContext::ThrowDataCloneError(Local<String> message) {
   Local<Value> args[1] = { message };
   Local<Value> get_data_clone_error;
@@ -183,14 +278,14 @@ void SerializerContext::New(const FunctionCallbackInfo<Value>& args) {
 void SerializerContext::WriteHeader(const FunctionCallbackInfo<Value>& args) {
   SerializerContext* ctx;
   ASSIGN_OR_RETURN_UNWRAP(&ctx, args.This());
-  ctx->serializer_.WriteHeader();
+  ctx->current_->WriteHeader();
 }
 
 void SerializerContext::WriteValue(const FunctionCallbackInfo<Value>& args) {
   SerializerContext* ctx;
   ASSIGN_OR_RETURN_UNWRAP(&ctx, args.This());
   bool ret;
-  if (ctx->serializer_.WriteValue(ctx->env()->context(), args[0]).To(&ret)) {
+  if (ctx->current_->WriteValue(ctx->env()->context(), args[0]).To(&ret)) {
     args.GetReturnValue().Set(ret);
   }
 }
@@ -201,6 +296,7 @@ void SerializerContext::SetTreatArrayBufferViewsAsHostObjects(
   ASSIGN_OR_RETURN_UNWRAP(&ctx, args.This());
 
   bool value = args[0]->BooleanValue(ctx->env()->isolate());
+  ctx->treat_array_buffer_views_as_host_objects_ = value;
   ctx->serializer_.SetTreatArrayBufferViewsAsHostObjects(value);
 }
 
@@ -234,7 +330,7 @@ void SerializerContext::TransferArrayBuffer(
   }
 
   Local<ArrayBuffer> ab = args[1].As<ArrayBuffer>();
-  ctx->serializer_.TransferArrayBuffer(id, ab);
+  ctx->current_->TransferArrayBuffer(id, ab);
 }
 
 void SerializerContext::WriteUint32(const FunctionCallbackInfo<Value>& args) {
@@ -243,7 +339,7 @@ void SerializerContext::WriteUint32(const FunctionCallbackInfo<Value>& args) {
 
   uint32_t value;
   if (args[0]->Uint32Value(ctx->env()->context()).To(&value)) {
-    ctx->serializer_.WriteUint32(value);
+    ctx->current_->WriteUint32(value);
   }
 }
 
@@ -261,7 +357,7 @@ void SerializerContext::WriteUint64(const FunctionCallbackInfo<Value>& args) {
 
   uint64_t hiu64 = hi;
   uint64_t lou64 = lo;
-  ctx->serializer_.WriteUint64((hiu64 << 32) | lou64);
+  ctx->current_->WriteUint64((hiu64 << 32) | lou64);
 }
 
 void SerializerContext::WriteDouble(const FunctionCallbackInfo<Value>& args) {
@@ -270,7 +366,7 @@ void SerializerContext::WriteDouble(const FunctionCallbackInfo<Value>& args) {
 
   double value;
   if (args[0]->NumberValue(ctx->env()->context()).To(&value)) {
-    ctx->serializer_.WriteDouble(value);
+    ctx->current_->WriteDouble(value);
   }
 }
 
@@ -284,7 +380,105 @@ void SerializerContext::WriteRawBytes(const FunctionCallbackInfo<Value>& args) {
   }
 
   ArrayBufferViewContents<char> bytes(args[0]);
-  ctx->serializer_.WriteRawBytes(bytes.data(), bytes.length());
+  ctx->current_->WriteRawBytes(bytes.data(), bytes.length());
+}
+
+void SerializerContext::SerializeInto(const FunctionCallbackInfo<Value>& args) {
+  SerializerContext* ctx;
+  ASSIGN_OR_RETURN_UNWRAP(&ctx, args.This());
+  Environment* env = ctx->env();
+
+  if (ctx->in_pooled_write_) {
+    return THROW_ERR_INVALID_STATE(
+        env, "serializeInto() cannot be called from a serialization hook");
+  }
+  if (!args[1]->IsArrayBufferView()) {
+    return THROW_ERR_INVALID_ARG_TYPE(
+        env, "target must be a TypedArray or a DataView");
+  }
+  Local<ArrayBufferView> target = args[1].As<ArrayBufferView>();
+  int64_t offset;
+  if (!args[2]->IntegerValue(env->context()).To(&offset)) return;
+  if (offset < 0 || static_cast<uint64_t>(offset) > target->ByteLength()) {
+    return THROW_ERR_OUT_OF_RANGE(env, "offset is out of range");
+  }
+
+  size_t size;
+  if (!ctx->SerializeToPool(args[0]).To(&size)) return;
+  // Look at target only now, hooks may have detached it in the meantime.
+  const size_t target_length = target->ByteLength();
+  if (static_cast<uint64_t>(offset) <= target_length &&
+      size <= target_length - offset) {
+    char* target_data =
+        static_cast<char*>(target->Buffer()->Data()) + target->ByteOffset();
+    memcpy(target_data + offset, ctx->pool_, size);
+  }
+  ctx->TrimPool();
+  args.GetReturnValue().Set(static_cast<double>(size));
+}
+
+void SerializerContext::SerializeArrayInto(
+    const FunctionCallbackInfo<Value>& args) {
+  SerializerContext* ctx;
+  ASSIGN_OR_RETURN_UNWRAP(&ctx, args.This());
+  Environment* env = ctx->env();
+  Local<Context> context = env->context();
+
+  if (ctx->in_pooled_write_) {
+    return THROW_ERR_INVALID_STATE(
+        env, "serializeArrayInto() cannot be called from a serialization hook");
+  }
+  if (!args[0]->IsArray()) {
+    return THROW_ERR_INVALID_ARG_TYPE(env, "values must be an Array");
+  }
+  if (!args[1]->IsArrayBufferView()) {
+    return THROW_ERR_INVALID_ARG_TYPE(
+        env, "target must be a TypedArray or a DataView");
+  }
+  if (!args[3]->IsUint32Array()) {
+    return THROW_ERR_INVALID_ARG_TYPE(env, "ends must be a Uint32Array");
+  }
+  Local<Array> values = args[0].As<Array>();
+  Local<ArrayBufferView> target = args[1].As<ArrayBufferView>();
+  Local<Uint32Array> ends = args[3].As<Uint32Array>();
+  int64_t offset;
+  if (!args[2]->IntegerValue(context).To(&offset)) return;
+  if (offset < 0 || static_cast<uint64_t>(offset) > target->ByteLength()) {
+    return THROW_ERR_OUT_OF_RANGE(env, "offset is out of range");
+  }
+  if (target->ByteLength() > UINT32_MAX) {
+    return THROW_ERR_OUT_OF_RANGE(env, "target is too large");
+  }
+  const uint32_t length = values->Length();
+  if (ends->Length() < length) {
+    return THROW_ERR_OUT_OF_RANGE(env, "ends is too short");
+  }
+
+  size_t position = offset;
+  uint32_t written = 0;
+  for (; written < length; written++) {
+    Local<Value> value;
+    size_t size;
+    if (!values->Get(context, written).ToLocal(&value) ||
+        !ctx->SerializeToPool(value).To(&size)) {
+      return;
+    }
+    // Hooks can detach target and ends, so look at them after each value.
+    const size_t target_length = target->ByteLength();
+    if (position > target_length || size > target_length - position ||
+        ends->Length() <= written) {
+      break;
+    }
+    char* target_data =
+        static_cast<char*>(target->Buffer()->Data()) + target->ByteOffset();
+    memcpy(target_data + position, ctx->pool_, size);
+    position += size;
+    uint32_t* ends_data = reinterpret_cast<uint32_t*>(
+        static_cast<char*>(ends->Buffer()->Data()) + ends->ByteOffset());
+    ends_data[written] = static_cast<uint32_t>(position);
+  }
+  ctx->TrimPool();
+  args.GetReturnValue().Set(written);
 }
 
 DeserializerContext::DeserializerContext(Environment* env,
@@ -487,6 +681,12 @@ void Initialize(Local<Object> target,
   SetProtoMethod(isolate, ser, "writeDouble", SerializerContext::WriteDouble);
   SetProtoMethod(
       isolate, ser, "writeRawBytes", SerializerContext::WriteRawBytes);
+  SetProtoMethod(
+      isolate, ser, "serializeInto", SerializerContext::SerializeInto);
+  SetProtoMethod(isolate,
+                 ser,
+                 "serializeArrayInto",
+                 SerializerContext::SerializeArrayInto);
   SetProtoMethod(isolate,
                  ser,
                  "_setTreatArrayBufferViewsAsHostObjects",
@@ -534,6 +734,8 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(SerializerContext::WriteDouble);
   registry->Register(SerializerContext::WriteRawBytes);
   registry->Register(SerializerContext::SetTreatArrayBufferViewsAsHostObjects);
+  registry->Register(SerializerContext::SerializeInto);
+  registry->Register(SerializerContext::SerializeArrayInto);
 
   registry->Register(DeserializerContext::New);
   registry->Register(DeserializerContext::ReadHeader);
@@ -0,0 +1,293 @@
+#include "node_simd_calibration.h"
+#include "debug_utils-inl.h"
+#include "simd_abstraction.h"
+#include "util.h"
+#include "uv.h"
+
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+namespace node {
+namespace simd_calibration {
+
+namespace {
+
+// Input sizes the span kernels are timed at, in bytes.
+constexpr size_t kSizes[] = {16, 64, 256, 1024, 4096};
+constexpr size_t kMaxSize = 4096;
+
+constexpr simd_instruction_set_t kVectorSets[] = {
+    SIMD_SSE2, SIMD_3DNOWEXT, SIMD_3DNOW, SIMD_MMXEXT, SIMD_ALTIVEC};
+
+constexpr char kHeader[] =
+    "# Written by node --simd-calibrate, read by --simd-calibration-file.\n";
+
+struct Buffers {
+  std::vector<uint8_t> ascii;  // Bytes below 0x80, never 0xff or 0xfe.
+  std::vector<uint8_t> copy;   // Same contents as ascii.
+  std::vector<uint8_t> dst;    // Room for the hex encoding of ascii.
+  alignas(16) float floats[2][4] = {{1, 2, 3, 4}, {5, 6, 7, 8}};
+  alignas(16) uint8_t vector_result[16];
+};
+
+volatile uint64_t sink;
+
+using Runner = void (*)(const simd_functions_t* f, Buffers* b, size_t n);
+
+// One call of a kernel on n bytes of input; n is ignored by the kernels that
+// work on a single 128-bit value.
+struct Kernel {
+  const char* name;
+  bool sized;
+  Runner run;
+};
+
+const Kernel kKernels[] = {
+    {"add_ps", false,
+     [](const simd_functions_t* f, Buffers* b, size_t) {
+       f->add_ps(b->floats[0], b->floats[1], b->vector_result);
+     }},
+    {"mul_ps", false,
+     [](const simd_functions_t* f, Buffers* b, size_t) {
+       f->mul_ps(b->floats[0], b->floats[1], b->vector_result);
+     }},
+    {"sub_ps", false,
+     [](const simd_functions_t* f, Buffers* b, size_t) {
+       f->sub_ps(b->floats[0], b->floats[1], b->vector_result);
+     }},
+    {"add_epi32", false,
+     [](const simd_functions_t* f, Buffers* b, size_t) {
+       f->add_epi32(b->ascii.data(), b->copy.data(), b->vector_result);
+     }},
+    {"shuffle_epi32", false,
+     [](const simd_functions_t* f, Buffers* b, size_t) {
+       f->shuffle_epi32(b->ascii.data(), 0x1b, b->vector_result);
+     }},
+    {"find_byte", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       sink =
+           reinterpret_cast<uintptr_t>(f->find_byte(b->ascii.data(), n, 0xff));
+     }},
+    {"find_last_byte", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       sink = reinterpret_cast<uintptr_t>(
+           f->find_last_byte(b->ascii.data(), n, 0xff));
+     }},
+    {"find_byte_pair", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       sink = reinterpret_cast<uintptr_t>(
+           f->find_byte_pair(b->ascii.data(), n - 8, 0xff, 0xfe, 7));
+     }},
+    {"compare_bytes", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       sink = f->compare_bytes(b->ascii.data(), b->copy.data(), n);
+     }},
+    {"copy_bytes", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       f->copy_bytes(b->dst.data(), b->ascii.data(), n);
+     }},
+    {"fill_bytes", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       f->fill_bytes(b->dst.data(), 0x20, n);
+     }},
+    {"xor_bytes", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       f->xor_bytes(b->dst.data(), b->ascii.data(), n);
+     }},
+    {"mask_bytes", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       static const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+       f->mask_bytes(b->dst.data(), b->ascii.data(), n, mask);
+     }},
+    {"sum_bytes", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       sink = f->sum_bytes(b->ascii.data(), n);
+     }},
+    {"min_max_bytes", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       uint8_t min, max;
+       f->min_max_bytes(b->ascii.data(), n, &min, &max);
+       sink = min ^ max;
+     }},
+    {"swap_bytes16", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       f->swap_bytes16(b->dst.data(), n / 2);
+     }},
+    {"swap_bytes32", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       f->swap_bytes32(b->dst.data(), n / 4);
+     }},
+    {"swap_bytes64", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       f->swap_bytes64(b->dst.data(), n / 8);
+     }},
+    {"validate_ascii", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       sink = f->validate_ascii(b->ascii.data(), n);
+     }},
+    {"hex_encode", true,
+     [](const simd_functions_t* f, Buffers* b, size_t n) {
+       f->hex_encode(reinterpret_cast<char*>(b->dst.data()),
+                     b->ascii.data(),
+                     n);
+     }},
+};
+
+bool Implements(const simd_functions_t* funcs, std::string_view kernel) {
+#define V(name, ret, args)                                                     \
+  if (kernel == #name) return funcs->name != nullptr;
+  SIMD_KERNELS(V)
+#undef V
+  return false;
+}
+
+// Nanoseconds per call, the best of three runs of about 100us each.
+double Time(const Kernel& kernel,
+            const simd_functions_t* funcs,
+            Buffers* buffers,
+            size_t n) {
+  constexpr uint64_t kRunNanos = 100 * 1000;
+  size_t iterations = 1;
+  for (;;) {
+    uint64_t start = uv_hrtime();
+    for (size_t i = 0; i < iterations; i++) kernel.run(funcs, buffers, n);
+    if (uv_hrtime() - start >= kRunNanos / 4) break;
+    iterations *= 2;
+  }
+  iterations *= 4;
+  double best = 0;
+  for (int run = 0; run < 3; run++) {
+    uint64_t start = uv_hrtime();
+    for (size_t i = 0; i < iterations; i++) kernel.run(funcs, buffers, n);
+    double nanos = static_cast<double>(uv_hrtime() - start) / iterations;
+    if (run == 0 || nanos < best) best = nanos;
+  }
+  return best;
+}
+
+}  // namespace
+
+std::string Calibrate() {
+  Buffers buffers;
+  buffers.ascii.resize(kMaxSize);
+  uint32_t seed = 1;
+  for (uint8_t& byte : buffers.ascii) {
+    seed = seed * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(seed >> 16) & 0x7f;
+  }
+  buffers.copy = buffers.ascii;
+  buffers.dst.resize(2 * kMaxSize);
+
+  std::ostringstream out;
+  out << kHeader;
+  out << "cpu " << get_simd_cpu_features() << "\n";
+
+  for (const Kernel& kernel : kKernels) {
+    std::vector<simd_instruction_set_t> candidates = {SIMD_SCALAR};
+    for (simd_instruction_set_t isa : kVectorSets) {
+      const simd_functions_t* funcs = get_simd_functions_for(isa);
+      if (funcs != nullptr && Implements(funcs, kernel.name))
+        candidates.push_back(isa);
+    }
+
+    // times[c][s] is candidate c at kSizes[s], or at one size if unsized.
+    const size_t size_count = kernel.sized ? arraysize(kSizes) : 1;
+    std::vector<std::vector<double>> times(candidates.size());
+    for (size_t c = 0; c < candidates.size(); c++) {
+      const simd_functions_t* funcs = get_simd_functions_for(candidates[c]);
+      for (size_t s = 0; s < size_count; s++) {
+        times[c].push_back(Time(kernel, funcs, &buffers, kSizes[s]));
+      }
+    }
+
+    const size_t last = size_count - 1;
+    size_t winner = 0;
+    for (size_t c = 1; c < candidates.size(); c++) {
+      if (times[c][last] < times[winner][last]) winner = c;
+    }
+    // The smallest size from which the winner beats scalar at every size.
+    size_t threshold = 0;
+    if (kernel.sized && winner != 0) {
+      size_t from = last;
+      while (from > 0 && times[winner][from - 1] < times[0][from - 1]) from--;
+      threshold = kSizes[from];
+    }
+
+    for (size_t s = 0; s < size_count; s++) {
+      out << "# " << kernel.name;
+      if (kernel.sized) out << " " << kSizes[s];
+      for (size_t c = 0; c < candidates.size(); c++) {
+        out << " " << get_simd_instruction_set_name(candidates[c]) << "="
+            << static_cast<uint64_t>(times[c][s] + 0.5) << "ns";
+      }
+      out << "\n";
+    }
+    const char* isa = get_simd_instruction_set_name(candidates[winner]);
+    out << "kernel " << kernel.name << " " << isa << " " << threshold << "\n";
+    CHECK_EQ(simd_set_kernel(kernel.name, candidates[winner], threshold), 0);
+  }
+  return out.str();
+}
+
+bool Load(const std::string& contents, std::string* error) {
+  struct Entry {
+    std::string kernel;
+    simd_instruction_set_t isa;
+    size_t threshold;
+  };
+  std::vector<Entry> entries;
+  bool has_cpu = false;
+
+  std::istringstream in(contents);
+  std::string line;
+  for (size_t line_number = 1; std::getline(in, line); line_number++) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string type;
+    fields >> type;
+    if (type == "cpu") {
+      unsigned features;
+      if (!(fields >> features)) {
+        *error = SPrintF("line %d: invalid cpu features", line_number);
+        return false;
+      }
+      if (features != get_simd_cpu_features()) {
+        *error = "the calibration was made on a CPU with different features";
+        return false;
+      }
+      has_cpu = true;
+    } else if (type == "kernel") {
+      Entry entry;
+      std::string isa;
+      if (!(fields >> entry.kernel >> isa >> entry.threshold)) {
+        *error = SPrintF("line %d: invalid kernel entry", line_number);
+        return false;
+      }
+      entry.isa = parse_simd_instruction_set_name(isa.c_str());
+      const simd_functions_t* funcs = get_simd_functions_for(entry.isa);
+      if (funcs == nullptr || !Implements(funcs, entry.kernel)) {
+        *error = SPrintF(
+            "line %d: no %s kernel %s", line_number, isa, entry.kernel);
+        return false;
+      }
+      entries.push_back(std::move(entry));
+    } else {
+      *error = SPrintF("line %d: unknown entry '%s'", line_number, type);
+      return false;
+    }
+  }
+  if (!has_cpu) {
+    *error = "not a SIMD calibration";
+    return false;
+  }
+
+  for (const Entry& entry : entries) {
+    CHECK_EQ(
+        simd_set_kernel(entry.kernel.c_str(), entry.isa, entry.threshold), 0);
+  }
+  return true;
+}
+
+}  // namespace simd_calibration
+}  // namespace node
@@ -0,0 +1,31 @@
+#ifndef SRC_NODE_SIMD_CALIBRATION_H_
+#define SRC_NODE_SIMD_CALIBRATION_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <string>
+
+namespace node {
+namespace simd_calibration {
+
+// Times every kernel of the SIMD abstraction layer in each instruction set
+// the running CPU supports, against the scalar one, on inputs of 16 bytes to
+// 4 KiB. Each kernel is switched to the instruction set that is fastest on
+// the largest inputs, used from the smallest size at which it keeps beating
+// scalar. Returns the result in the format that Load() reads, with the
+// timings as comments. Backs node --simd-calibrate.
+std::string Calibrate();
+
+// Applies a calibration written by Calibrate() to the process' kernel table.
+// A calibration that was made on a CPU with different features is rejected,
+// as is one that names kernels or instruction sets this binary cannot use;
+// in both cases *error is set and nothing is applied. Only for use during
+// process initialization, see simd_set_kernel().
+bool Load(const std::string& contents, std::string* error);
+
+}  // namespace simd_calibration
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_SIMD_CALIBRATION_H_
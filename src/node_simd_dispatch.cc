@@ -0,0 +1,158 @@
+#include "node_simd_dispatch.h"
+#include "simd_abstraction.h"
+#include "simdjson.h"
+#include "simdutf.h"
+
+namespace node {
+namespace simd_dispatch {
+
+// V8 picks its string hashing and Swiss table kernels at build time from the
+// compiler flags it is built with. Node's own sources share the flags passed
+// through CFLAGS/CXXFLAGS; the NODE_V8_SIMD_* defines from node.gyp stand in
+// for the ones tools/v8_gypfiles/toolchain.gypi only gives to V8.
+#if defined(__3dNOW__) || defined(NODE_V8_SIMD_3DNOW)
+#define NODE_V8_HAS_3DNOW 1
+#else
+#define NODE_V8_HAS_3DNOW 0
+#endif
+
+#if defined(__SSE2__) || defined(NODE_V8_SIMD_SSE2) || defined(_M_X64) ||     \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NODE_V8_HAS_SSE2 1
+#else
+#define NODE_V8_HAS_SSE2 0
+#endif
+
+// Mirrors the #if chain in deps/v8/src/strings/string-hasher.cc.
+static const char* V8StringHasherImpl() {
+#if defined(__ALTIVEC__)
+  return "altivec";
+#elif NODE_V8_HAS_3DNOW
+  return "mmx";
+#elif NODE_V8_HAS_SSE2
+  return "sse2";
+#elif defined(__ARM_NEON__)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+// Mirrors the choice of Group in deps/v8/src/objects/swiss-hash-table-helpers.h.
+static const char* V8SwissTableImpl() {
+#if defined(__ALTIVEC__)
+  return "altivec";
+#elif NODE_V8_HAS_3DNOW
+  return "mmx";
+#elif NODE_V8_HAS_SSE2
+  return "sse2";
+#elif defined(__i386__) || defined(_M_IX86)
+  return "sse2-polyfill";
+#else
+  return "portable";
+#endif
+}
+
+// simdutf runs its fallback kernel on 32-bit x86 and PowerPC, with the MMX or
+// AltiVec ASCII blocks set up at the top of its fallback implementation.
+static std::string SimdutfImpl() {
+  std::string name = simdutf::get_active_implementation()->name();
+  if (name != "fallback") return name;
+#if (defined(__i386__) || defined(_M_IX86)) && defined(__MMX__) &&             \
+    defined(__GNUC__)
+  name += "+mmx";
+#elif defined(__ALTIVEC__) && defined(__BIG_ENDIAN__)
+  name += "+altivec";
+#endif
+  return name;
+}
+
+// On-Demand parsing, which is what Node uses, is bound to the kernel chosen
+// when simdjson was compiled; only the DOM API dispatches at runtime.
+static std::string SimdjsonOnDemandImpl() {
+  std::string name = SIMDJSON_STRINGIFY(SIMDJSON_BUILTIN_IMPLEMENTATION);
+#if defined(SIMDJSON_FALLBACK_ALTIVEC) && SIMDJSON_FALLBACK_ALTIVEC
+  if (name == "fallback") name += "+altivec";
+#elif defined(SIMDJSON_FALLBACK_MMX) && SIMDJSON_FALLBACK_MMX
+  if (name == "fallback") name += "+mmx";
+#endif
+  return name;
+}
+
+static std::string CpuFeatures() {
+  static constexpr struct {
+    unsigned bit;
+    const char* name;
+  } kFeatures[] = {
+      {SIMD_FEATURE_SSE2, "sse2"},
+      {SIMD_FEATURE_SSSE3, "ssse3"},
+      {SIMD_FEATURE_SSE4_2_PCLMUL, "sse4.2+pclmul"},
+      {SIMD_FEATURE_AVX512, "avx512"},
+      {SIMD_FEATURE_3DNOW, "3dnow"},
+      {SIMD_FEATURE_3DNOWEXT, "3dnowext"},
+      {SIMD_FEATURE_MMXEXT, "mmxext"},
+      {SIMD_FEATURE_ALTIVEC, "altivec"},
+  };
+  unsigned features = get_simd_cpu_features();
+  std::string ret;
+  for (const auto& feature : kFeatures) {
+    if ((features & feature.bit) == 0) continue;
+    if (!ret.empty()) ret += ' ';
+    ret += feature.name;
+  }
+  return ret.empty() ? "none" : ret;
+}
+
+void Initialize() {
+  // zlib's cpu_check_features() and the kernel registry.
+  get_simd_cpu_features();
+  // simdutf and simdjson resolve their runtime dispatch on first use.
+  simdutf::get_active_implementation()->name();
+  simdjson::get_active_implementation()->name();
+}
+
+std::vector<std::pair<std::string, std::string>> GetSelection() {
+  std::vector<std::pair<std::string, std::string>> ret;
+  // Runs cpu_check_features(), which the zlib entries below rely on.
+  ret.emplace_back("cpu", CpuFeatures());
+
+  ret.emplace_back(
+      "simd",
+      get_simd_instruction_set_name(get_active_simd_instruction_set()));
+  const simd_kernel_selection_t* selection = get_simd_kernel_selection();
+#define V(name, ret_type, args)                                                \
+  ret.emplace_back("simd." #name,                                              \
+                   get_simd_instruction_set_name(selection->name));
+  SIMD_KERNELS(V)
+#undef V
+
+#ifdef NODE_BUNDLED_ZLIB
+  ret.emplace_back("zlib.adler32", cpu_features_adler32_impl());
+  ret.emplace_back("zlib.crc32", cpu_features_crc32_impl());
+  ret.emplace_back("zlib.slide_hash", cpu_features_slide_hash_impl());
+  ret.emplace_back("zlib.inflate_chunk", cpu_features_inflate_chunk_impl());
+#endif  // NODE_BUNDLED_ZLIB
+
+  ret.emplace_back("simdjson.ondemand", SimdjsonOnDemandImpl());
+  ret.emplace_back("simdjson.dom",
+                   simdjson::get_active_implementation()->name());
+  ret.emplace_back("simdutf", SimdutfImpl());
+
+  ret.emplace_back("v8.string_hasher", V8StringHasherImpl());
+  ret.emplace_back("v8.swiss_table", V8SwissTableImpl());
+  return ret;
+}
+
+std::string ToString() {
+  std::string ret;
+  for (const auto& [subsystem, implementation] : GetSelection()) {
+    ret += subsystem;
+    ret += ": ";
+    ret += implementation;
+    ret += '\n';
+  }
+  return ret;
+}
+
+}  // namespace simd_dispatch
+}  // namespace node
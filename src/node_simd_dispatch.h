@@ -0,0 +1,36 @@
+#ifndef SRC_NODE_SIMD_DISPATCH_H_
+#define SRC_NODE_SIMD_DISPATCH_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace node {
+namespace simd_dispatch {
+
+// Runs the CPU feature detection of zlib, the SIMD abstraction layer,
+// simdutf and simdjson, each of which would otherwise probe lazily on its
+// first call, possibly from a worker thread in the middle of a request.
+// Called once per process, before V8 and the thread pool start. The results
+// are never stored in the startup snapshot: it is built on the build host,
+// not on the CPU that runs it.
+void Initialize();
+
+// The implementation every SIMD accelerated subsystem uses on this CPU, as
+// (subsystem, implementation) pairs in a fixed order, e.g.
+// {"zlib.adler32", "ssse3"}. Runtime dispatched subsystems report what they
+// picked for the running CPU, the others what the build selected. Backs
+// process.simd and --print-simd-dispatch.
+std::vector<std::pair<std::string, std::string>> GetSelection();
+
+// GetSelection() as one "subsystem: implementation" line per entry.
+std::string ToString();
+
+}  // namespace simd_dispatch
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_SIMD_DISPATCH_H_
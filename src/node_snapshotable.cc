@@ -393,6 +393,7 @@ size_t SnapshotSerializer::Write(const ImmediateInfo::SerializeInfo& data) {
 // [ 4/8 bytes ]  snapshot index of root
 // [ 4/8 bytes ]  snapshot index of milestones
 // [ 4/8 bytes ]  snapshot index of observers
+// [ 4/8 bytes ]  snapshot index of gc_stats
 template <>
 performance::PerformanceState::SerializeInfo SnapshotDeserializer::Read() {
   Debug("Read<PerformanceState::SerializeInfo>()\n");
@@ -401,6 +402,7 @@ performance::PerformanceState::SerializeInfo SnapshotDeserializer::Read() {
   result.root = ReadArithmetic<AliasedBufferIndex>();
   result.milestones = ReadArithmetic<AliasedBufferIndex>();
   result.observers = ReadArithmetic<AliasedBufferIndex>();
+  result.gc_stats = ReadArithmetic<AliasedBufferIndex>();
   if (is_debug) {
     std::string str = ToStr(result);
     Debug("Read<PerformanceState::SerializeInfo>() %s\n", str.c_str());
@@ -419,6 +421,7 @@ size_t SnapshotSerializer::Write(
   size_t written_total = WriteArithmetic<AliasedBufferIndex>(data.root);
   written_total += WriteArithmetic<AliasedBufferIndex>(data.milestones);
   written_total += WriteArithmetic<AliasedBufferIndex>(data.observers);
+  written_total += WriteArithmetic<AliasedBufferIndex>(data.gc_stats);
 
   Debug("Write<PerformanceState::SerializeInfo>() wrote %d bytes\n",
         written_total);
@@ -650,6 +653,16 @@ bool SnapshotData::FromBlob(SnapshotData* out, std::string_view in) {
   // Metadata
   uint32_t magic = r.ReadArithmetic<uint32_t>();
   r.Debug("Read magic %" PRIx32 "\n", magic);
+  // Everything in the blob is stored in the byte order of the machine that
+  // built it, so that it can be read without conversions.
+  uint32_t swapped_magic = kMagic;
+  SwapBytes32(reinterpret_cast<char*>(&swapped_magic), sizeof(swapped_magic));
+  if (magic == swapped_magic) {
+    fprintf(stderr,
+            "Failed to load the startup snapshot because it was built on a "
+            "machine with a different byte order.\n");
+    return false;
+  }
   CHECK_EQ(magic, kMagic);
   out->metadata = r.Read<SnapshotMetadata>();
   r.Debug("Read metadata\n");
@@ -13,6 +13,7 @@
 #include "util-inl.h"
 
 #include <cinttypes>
+#include <cmath>
 
 namespace node {
 namespace sqlite {
@@ -21,6 +22,7 @@ using v8::Array;
 using v8::ArrayBuffer;
 using v8::BackingStoreInitializationMode;
 using v8::BigInt;
+using v8::BigInt64Array;
 using v8::Boolean;
 using v8::ConstructorBehavior;
 using v8::Context;
@@ -28,6 +30,7 @@ using v8::DictionaryTemplate;
 using v8::DontDelete;
 using v8::EscapableHandleScope;
 using v8::Exception;
+using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallback;
 using v8::FunctionCallbackInfo;
@@ -52,7 +55,9 @@ using v8::Promise;
 using v8::SideEffectType;
 using v8::String;
 using v8::TryCatch;
+using v8::TypedArray;
 using v8::Uint8Array;
+using v8::Undefined;
 using v8::Value;
 
 #define CHECK_ERROR_OR_THROW(isolate, db, expr, expected, ret)                 \
@@ -122,6 +127,19 @@ using v8::Value;
   } while (0)
 
 namespace {
+inline bool IsSpaceOrSemicolon(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+         c == '\v' || c == ';';
+}
+
+// Reads the element at index of a typed array, which need not be aligned.
+template <typename T>
+inline T ReadElement(const uint8_t* data, size_t index) {
+  T value;
+  memcpy(&value, data + index * sizeof(T), sizeof(T));
+  return value;
+}
+
 Local<DictionaryTemplate> getLazyIterTemplate(Environment* env) {
   auto iter_template = env->iter_template();
   if (iter_template.IsEmpty()) {
@@ -168,10 +186,10 @@ inline MaybeLocal<Object> CreateSQLiteError(Isolate* isolate, int errcode) {
   return e;
 }
 
-inline MaybeLocal<Object> CreateSQLiteError(Isolate* isolate, sqlite3* db) {
-  int errcode = sqlite3_extended_errcode(db);
+inline MaybeLocal<Object> CreateSQLiteError(Isolate* isolate,
+                                            int errcode,
+                                            const char* errmsg) {
   const char* errstr = sqlite3_errstr(errcode);
-  const char* errmsg = sqlite3_errmsg(db);
   Local<String> js_errmsg;
   Local<Object> e;
   Environment* env = Environment::GetCurrent(isolate);
@@ -188,6 +206,11 @@ inline MaybeLocal<Object> CreateSQLiteError(Isolate* isolate, sqlite3* db) {
   return e;
 }
 
+inline MaybeLocal<Object> CreateSQLiteError(Isolate* isolate, sqlite3* db) {
+  return CreateSQLiteError(
+      isolate, sqlite3_extended_errcode(db), sqlite3_errmsg(db));
+}
+
 void JSValueToSQLiteResult(Isolate* isolate,
                            sqlite3_context* ctx,
                            Local<Value> value) {
@@ -451,7 +474,7 @@ class BackupJob : public ThreadPoolWork {
                      std::string dest_db,
                      int pages,
                      Local<Function> progressFunc)
-      : ThreadPoolWork(env, "node_sqlite3.BackupJob"),
+      : ThreadPoolWork(env, "node_sqlite3.BackupJob", Lane::kIo),
         env_(env),
         source_(source),
         pages_(pages),
@@ -670,7 +693,9 @@ DatabaseSync::DatabaseSync(Environment* env,
                            DatabaseOpenConfiguration&& open_config,
                            bool open,
                            bool allow_load_extension)
-    : BaseObject(env, object), open_config_(std::move(open_config)) {
+    : BaseObject(env, object),
+      open_config_(std::move(open_config)),
+      statement_cache_(open_config_.get_statement_cache_size()) {
   MakeWeak();
   connection_ = nullptr;
   allow_load_extension_ = allow_load_extension;
@@ -727,6 +752,11 @@ bool DatabaseSync::Open() {
   int flags = open_config_.get_read_only()
                   ? SQLITE_OPEN_READONLY
                   : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+  // The connections of the process to the same database, including those of
+  // Workers, then share one page cache.
+  if (open_config_.get_shared_cache()) {
+    flags |= SQLITE_OPEN_SHAREDCACHE;
+  }
   int r = sqlite3_open_v2(open_config_.location().c_str(),
                           &connection_,
                           flags | default_flags,
@@ -763,6 +793,21 @@ bool DatabaseSync::Open() {
 
   sqlite3_busy_timeout(connection_, open_config_.get_timeout());
 
+  if (open_config_.get_mmap_size() >= 0) {
+    std::string pragma =
+        "PRAGMA mmap_size = " + std::to_string(open_config_.get_mmap_size());
+    r = sqlite3_exec(connection_, pragma.c_str(), nullptr, nullptr, nullptr);
+    CHECK_ERROR_OR_THROW(env()->isolate(), this, r, SQLITE_OK, false);
+  }
+  if (open_config_.get_page_cache_size() >= 0) {
+    // A negative cache_size is a limit in KiB rather than in pages.
+    std::string pragma =
+        "PRAGMA cache_size = -" +
+        std::to_string(open_config_.get_page_cache_size() / 1024);
+    r = sqlite3_exec(connection_, pragma.c_str(), nullptr, nullptr, nullptr);
+    CHECK_ERROR_OR_THROW(env()->isolate(), this, r, SQLITE_OK, false);
+  }
+
   if (allow_load_extension_) {
     if (env()->permission()->enabled()) [[unlikely]] {
       THROW_ERR_LOAD_SQLITE_EXTENSION(env(),
@@ -793,6 +838,20 @@ void DatabaseSync::FinalizeStatements() {
   }
 
   statements_.clear();
+  statement_cache_.Clear();
+}
+
+std::shared_ptr<sqlite3_stmt> DatabaseSync::GetCachedStatement(
+    const std::string& sql) {
+  if (!statement_cache_.Exists(sql)) {
+    return nullptr;
+  }
+  std::shared_ptr<sqlite3_stmt> stmt = statement_cache_.Get(sql);
+  // A statement that is stepped by an iteration cannot be reset.
+  if (sqlite3_stmt_busy(stmt.get())) {
+    return nullptr;
+  }
+  return stmt;
 }
 
 void DatabaseSync::UntrackStatement(StatementSync* statement) {
@@ -1088,6 +1147,73 @@ void DatabaseSync::New(const FunctionCallbackInfo<Value>& args) {
       }
       open_config.set_enable_defensive(defensive_v.As<Boolean>()->Value());
     }
+
+    Local<Value> statement_cache_size_v;
+    if (!options
+             ->Get(env->context(),
+                   FIXED_ONE_BYTE_STRING(env->isolate(), "statementCacheSize"))
+             .ToLocal(&statement_cache_size_v)) {
+      return;
+    }
+    if (!statement_cache_size_v->IsUndefined()) {
+      if (!statement_cache_size_v->IsInt32() ||
+          statement_cache_size_v.As<Int32>()->Value() < 0) {
+        THROW_ERR_INVALID_ARG_TYPE(
+            env->isolate(),
+            "The \"options.statementCacheSize\" argument must be a "
+            "non-negative integer.");
+        return;
+      }
+      open_config.set_statement_cache_size(
+          statement_cache_size_v.As<Int32>()->Value());
+    }
+
+    const auto get_size = [&](const char* name, int64_t* out) {
+      Local<Value> value;
+      if (!options->Get(env->context(), OneByteString(env->isolate(), name))
+               .ToLocal(&value)) {
+        return false;
+      }
+      if (value->IsUndefined()) {
+        return true;
+      }
+      double size = value->IsNumber() ? value.As<Number>()->Value() : -1;
+      if (!(size >= 0 && size <= kMaxSafeJsInteger) ||
+          std::trunc(size) != size) {
+        THROW_ERR_INVALID_ARG_TYPE(
+            env->isolate(),
+            "The \"options.%s\" argument must be a non-negative integer.",
+            name);
+        return false;
+      }
+      *out = static_cast<int64_t>(size);
+      return true;
+    };
+    int64_t mmap_size = -1;
+    int64_t page_cache_size = -1;
+    if (!get_size("mmapSize", &mmap_size) ||
+        !get_size("pageCacheSize", &page_cache_size)) {
+      return;
+    }
+    open_config.set_mmap_size(mmap_size);
+    open_config.set_page_cache_size(page_cache_size);
+
+    Local<Value> shared_cache_v;
+    if (!options
+             ->Get(env->context(),
+                   FIXED_ONE_BYTE_STRING(env->isolate(), "sharedCache"))
+             .ToLocal(&shared_cache_v)) {
+      return;
+    }
+    if (!shared_cache_v->IsUndefined()) {
+      if (!shared_cache_v->IsBoolean()) {
+        THROW_ERR_INVALID_ARG_TYPE(
+            env->isolate(),
+            "The \"options.sharedCache\" argument must be a boolean.");
+        return;
+      }
+      open_config.set_shared_cache(shared_cache_v.As<Boolean>()->Value());
+    }
   }
 
   new DatabaseSync(
@@ -1148,12 +1274,27 @@ void DatabaseSync::Prepare(const FunctionCallbackInfo<Value>& args) {
   }
 
   Utf8Value sql(env->isolate(), args[0].As<String>());
+  std::shared_ptr<sqlite3_stmt> cached;
   sqlite3_stmt* s = nullptr;
-  int r = sqlite3_prepare_v2(db->connection_, *sql, -1, &s, 0);
+  if (db->statement_cache_.Capacity() > 0) {
+    cached = db->GetCachedStatement(sql.ToString());
+    s = cached.get();
+  }
+  if (s == nullptr) {
+    int r = sqlite3_prepare_v2(db->connection_, *sql, -1, &s, 0);
+    CHECK_ERROR_OR_THROW(env->isolate(), db, r, SQLITE_OK, void());
+    if (s != nullptr && db->statement_cache_.Capacity() > 0) {
+      cached.reset(s, sqlite3_finalize);
+      db->statement_cache_.Put(sql.ToString(), cached);
+    }
+  }
 
-  CHECK_ERROR_OR_THROW(env->isolate(), db, r, SQLITE_OK, void());
   BaseObjectPtr<StatementSync> stmt =
       StatementSync::Create(env, BaseObjectPtr<DatabaseSync>(db), s);
+  if (!stmt) {
+    return;
+  }
+  stmt->cached_statement_ = std::move(cached);
   db->statements_.insert(stmt.get());
   args.GetReturnValue().Set(stmt->object());
 }
@@ -1171,6 +1312,35 @@ void DatabaseSync::Exec(const FunctionCallbackInfo<Value>& args) {
   }
 
   Utf8Value sql(env->isolate(), args[0].As<String>());
+  if (db->statement_cache_.Capacity() > 0) {
+    // Statements are cached one at a time, SQL that has more than one runs
+    // through sqlite3_exec() as usual.
+    std::shared_ptr<sqlite3_stmt> stmt = db->GetCachedStatement(sql.ToString());
+    if (!stmt) {
+      sqlite3_stmt* s = nullptr;
+      const char* tail = nullptr;
+      int r = sqlite3_prepare_v2(db->connection_, *sql, -1, &s, &tail);
+      CHECK_ERROR_OR_THROW(env->isolate(), db, r, SQLITE_OK, void());
+      if (s != nullptr) {
+        stmt.reset(s, sqlite3_finalize);
+        while (IsSpaceOrSemicolon(*tail)) tail++;
+        if (*tail == '\0') {
+          db->statement_cache_.Put(sql.ToString(), stmt);
+        } else {
+          stmt.reset();
+        }
+      }
+    }
+    if (stmt) {
+      auto reset = OnScopeLeave([&]() { sqlite3_reset(stmt.get()); });
+      int r;
+      while ((r = sqlite3_step(stmt.get())) == SQLITE_ROW) {
+      }
+      CHECK_ERROR_OR_THROW(env->isolate(), db, r, SQLITE_DONE, void());
+      return;
+    }
+  }
+
   int r = sqlite3_exec(db->connection_, *sql, nullptr, nullptr, nullptr);
   CHECK_ERROR_OR_THROW(env->isolate(), db, r, SQLITE_OK, void());
 }
@@ -2044,7 +2214,14 @@ StatementSync::~StatementSync() {
 }
 
 void StatementSync::Finalize() {
-  sqlite3_finalize(statement_);
+  if (cached_statement_) {
+    // The statement cache finalizes the statement when it is evicted.
+    sqlite3_reset(statement_);
+    sqlite3_clear_bindings(statement_);
+    cached_statement_.reset();
+  } else {
+    sqlite3_finalize(statement_);
+  }
   statement_ = nullptr;
 }
 
@@ -2052,6 +2229,21 @@ inline bool StatementSync::IsFinalized() {
   return statement_ == nullptr;
 }
 
+void StatementSync::FindAnonymousParams() {
+  if (anonymous_params_.has_value()) {
+    return;
+  }
+  anonymous_params_.emplace();
+  int param_count = sqlite3_bind_parameter_count(statement_);
+  for (int i = 1; i <= param_count; ++i) {
+    const char* param = sqlite3_bind_parameter_name(statement_, i);
+    if (param == nullptr || param[0] == '?') {
+      anonymous_params_->push_back(i);
+    }
+  }
+  bind_kinds_.assign(anonymous_params_->size(), BindKind::kUnknown);
+}
+
 bool StatementSync::BindParams(const FunctionCallbackInfo<Value>& args) {
   int r = sqlite3_clear_bindings(statement_);
   CHECK_ERROR_OR_THROW(env()->isolate(), db_.get(), r, SQLITE_OK, false);
@@ -2137,23 +2329,82 @@ bool StatementSync::BindParams(const FunctionCallbackInfo<Value>& args) {
     anon_start++;
   }
 
+  if (anon_start >= args.Length()) {
+    return true;
+  }
+
+  FindAnonymousParams();
   for (int i = anon_start; i < args.Length(); ++i) {
-    while (1) {
-      const char* param = sqlite3_bind_parameter_name(statement_, anon_idx);
-      if (param == nullptr || param[0] == '?') break;
-      anon_idx++;
+    size_t n = i - anon_start;
+    if (n >= anonymous_params_->size()) {
+      // Past the last parameter, let SQLite report the range error.
+      anon_idx = sqlite3_bind_parameter_count(statement_) + 1 +
+                 static_cast<int>(n - anonymous_params_->size());
+      if (!BindValue(args[i], anon_idx)) {
+        return false;
+      }
+      continue;
     }
 
-    if (!BindValue(args[i], anon_idx)) {
+    if (!BindValue(args[i], (*anonymous_params_)[n], &bind_kinds_[n])) {
       return false;
     }
-
-    anon_idx++;
   }
 
   return true;
 }
 
+bool StatementSync::BindValue(const Local<Value>& value,
+                              const int index,
+                              BindKind* kind) {
+  // Statements are usually bound to values of the same types every time,
+  // check the type of the last value first.
+  int r;
+  switch (*kind) {
+    case BindKind::kNumber:
+      if (!value->IsNumber()) break;
+      r = sqlite3_bind_double(statement_, index, value.As<Number>()->Value());
+      CHECK_ERROR_OR_THROW(env()->isolate(), db_.get(), r, SQLITE_OK, false);
+      return true;
+    case BindKind::kString: {
+      if (!value->IsString()) break;
+      Utf8Value val(env()->isolate(), value.As<String>());
+      r = sqlite3_bind_text(
+          statement_, index, *val, val.length(), SQLITE_TRANSIENT);
+      CHECK_ERROR_OR_THROW(env()->isolate(), db_.get(), r, SQLITE_OK, false);
+      return true;
+    }
+    case BindKind::kNull:
+      if (!value->IsNull()) break;
+      r = sqlite3_bind_null(statement_, index);
+      CHECK_ERROR_OR_THROW(env()->isolate(), db_.get(), r, SQLITE_OK, false);
+      return true;
+    case BindKind::kBlob: {
+      if (!value->IsArrayBufferView()) break;
+      ArrayBufferViewContents<uint8_t> buf(value);
+      r = sqlite3_bind_blob(
+          statement_, index, buf.data(), buf.length(), SQLITE_TRANSIENT);
+      CHECK_ERROR_OR_THROW(env()->isolate(), db_.get(), r, SQLITE_OK, false);
+      return true;
+    }
+    case BindKind::kUnknown:
+      break;
+  }
+
+  if (value->IsNumber()) {
+    *kind = BindKind::kNumber;
+  } else if (value->IsString()) {
+    *kind = BindKind::kString;
+  } else if (value->IsNull()) {
+    *kind = BindKind::kNull;
+  } else if (value->IsArrayBufferView()) {
+    *kind = BindKind::kBlob;
+  } else {
+    *kind = BindKind::kUnknown;
+  }
+  return BindValue(value, index);
+}
+
 bool StatementSync::BindValue(const Local<Value>& value, const int index) {
   // SQLite only supports a subset of JavaScript types. Some JS types such as
   // functions don't make sense to support. Other JS types such as booleans and
@@ -2440,6 +2691,234 @@ void StatementSync::All(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+MaybeLocal<Name> StatementSync::CachedColumnName(const int column) {
+  const char* col_name = sqlite3_column_name(statement_, column);
+  if (col_name == nullptr) {
+    THROW_ERR_INVALID_STATE(env(), "Cannot get name of column %d", column);
+    return MaybeLocal<Name>();
+  }
+
+  Isolate* isolate = env()->isolate();
+  if (static_cast<size_t>(column) >= column_names_.size()) {
+    column_names_.resize(column + 1);
+  }
+  auto& [cached_name, name] = column_names_[column];
+  if (name.IsEmpty() || cached_name != col_name) {
+    Local<Name> key;
+    if (!String::NewFromUtf8(isolate, col_name).ToLocal(&key)) {
+      return MaybeLocal<Name>();
+    }
+    cached_name = col_name;
+    name.Reset(isolate, key);
+  }
+  return name.Get(isolate);
+}
+
+namespace {
+
+// The values of one result column, collected by StepColumnar(). A column is
+// kept as raw numbers for as long as all of its values fit one typed array
+// and as JS values otherwise.
+struct ColumnarColumn {
+  enum class Kind {
+    // Only NULLs so far.
+    kNull,
+    // Numbers, with NULLs as NaN, which SQLite never stores.
+    kNumber,
+    // Integers when reading BigInts, without NULLs.
+    kBigInt,
+    kValues,
+  };
+  Kind kind = Kind::kNull;
+  size_t size = 0;
+  std::vector<double> numbers;
+  std::vector<int64_t> big_ints;
+  std::optional<LocalVector<Value>> values;
+};
+
+}  // namespace
+
+MaybeLocal<Object> StatementSync::StepColumnar() {
+  using Kind = ColumnarColumn::Kind;
+  Environment* env = this->env();
+  Isolate* isolate = env->isolate();
+  EscapableHandleScope scope(isolate);
+  const int num_cols = sqlite3_column_count(statement_);
+  std::vector<ColumnarColumn> columns(num_cols);
+
+  // Switches a column to JS values, converting the ones it already has.
+  const auto to_values = [&](ColumnarColumn* column) {
+    LocalVector<Value> values(isolate);
+    values.reserve(column->size + 1);
+    switch (column->kind) {
+      case Kind::kNull:
+        for (size_t i = 0; i < column->size; i++) {
+          values.push_back(Null(isolate));
+        }
+        break;
+      case Kind::kNumber:
+        for (double number : column->numbers) {
+          values.push_back(std::isnan(number)
+                               ? Null(isolate).As<Value>()
+                               : Number::New(isolate, number).As<Value>());
+        }
+        break;
+      case Kind::kBigInt:
+        for (int64_t number : column->big_ints) {
+          values.push_back(BigInt::New(isolate, number));
+        }
+        break;
+      case Kind::kValues:
+        UNREACHABLE();
+    }
+    column->numbers = {};
+    column->big_ints = {};
+    column->values.emplace(std::move(values));
+    column->kind = Kind::kValues;
+  };
+
+  int r;
+  while ((r = sqlite3_step(statement_)) == SQLITE_ROW) {
+    for (int i = 0; i < num_cols; i++) {
+      ColumnarColumn* column = &columns[i];
+      const int type = sqlite3_column_type(statement_, i);
+      if (column->kind == Kind::kNull && type != SQLITE_NULL) {
+        if (type == SQLITE_INTEGER && use_big_ints_ && column->size == 0) {
+          column->kind = Kind::kBigInt;
+        } else if (type == SQLITE_FLOAT ||
+                   (type == SQLITE_INTEGER && !use_big_ints_)) {
+          column->kind = Kind::kNumber;
+          column->numbers.assign(column->size, NAN);
+        } else {
+          to_values(column);
+        }
+      }
+
+      switch (column->kind) {
+        case Kind::kNull:
+          break;
+        case Kind::kNumber:
+          if (type == SQLITE_FLOAT) {
+            column->numbers.push_back(sqlite3_column_double(statement_, i));
+            break;
+          } else if (type == SQLITE_NULL) {
+            column->numbers.push_back(NAN);
+            break;
+          } else if (type == SQLITE_INTEGER && !use_big_ints_) {
+            sqlite3_int64 val = sqlite3_column_int64(statement_, i);
+            if (std::abs(val) > kMaxSafeJsInteger) {
+              THROW_ERR_OUT_OF_RANGE(isolate,
+                                     "Value is too large to be represented "
+                                     "as a JavaScript number: %" PRId64,
+                                     val);
+              return MaybeLocal<Object>();
+            }
+            column->numbers.push_back(static_cast<double>(val));
+            break;
+          }
+          to_values(column);
+          [[fallthrough]];
+        case Kind::kBigInt:
+          if (column->kind == Kind::kBigInt) {
+            if (type == SQLITE_INTEGER) {
+              column->big_ints.push_back(sqlite3_column_int64(statement_, i));
+              break;
+            }
+            to_values(column);
+          }
+          [[fallthrough]];
+        case Kind::kValues: {
+          Local<Value> value;
+          if (type == SQLITE_TEXT) {
+            // Strings are the common case of value columns, and the size
+            // SQLite already knows saves a strlen().
+            const char* text = reinterpret_cast<const char*>(
+                sqlite3_column_text(statement_, i));
+            if (!String::NewFromUtf8(isolate,
+                                     text,
+                                     NewStringType::kNormal,
+                                     sqlite3_column_bytes(statement_, i))
+                     .ToLocal(&value)) {
+              return MaybeLocal<Object>();
+            }
+          } else if (!ColumnToValue(i).ToLocal(&value)) {
+            return MaybeLocal<Object>();
+          }
+          column->values->push_back(value);
+          break;
+        }
+      }
+      column->size++;
+    }
+  }
+  CHECK_ERROR_OR_THROW(
+      isolate, db_.get(), r, SQLITE_DONE, MaybeLocal<Object>());
+
+  LocalVector<Name> keys(isolate);
+  LocalVector<Value> values(isolate);
+  keys.reserve(num_cols);
+  values.reserve(num_cols);
+  for (int i = 0; i < num_cols; i++) {
+    ColumnarColumn* column = &columns[i];
+    Local<Name> key;
+    if (!CachedColumnName(i).ToLocal(&key)) return MaybeLocal<Object>();
+    keys.push_back(key);
+
+    if (column->kind == Kind::kNull) to_values(column);
+    if (column->kind == Kind::kValues) {
+      values.push_back(
+          Array::New(isolate, column->values->data(), column->values->size()));
+      continue;
+    }
+    const bool big_ints = column->kind == Kind::kBigInt;
+    const size_t byte_length =
+        column->size * (big_ints ? sizeof(int64_t) : sizeof(double));
+    auto store = ArrayBuffer::NewBackingStore(
+        isolate, byte_length, BackingStoreInitializationMode::kUninitialized);
+    if (byte_length > 0) {
+      memcpy(store->Data(),
+             big_ints ? static_cast<const void*>(column->big_ints.data())
+                      : static_cast<const void*>(column->numbers.data()),
+             byte_length);
+    }
+    Local<ArrayBuffer> ab = ArrayBuffer::New(isolate, std::move(store));
+    if (big_ints) {
+      values.push_back(BigInt64Array::New(ab, 0, column->size));
+    } else {
+      values.push_back(Float64Array::New(ab, 0, column->size));
+    }
+  }
+
+  return scope.Escape(Object::New(
+      isolate, Null(isolate), keys.data(), values.data(), num_cols));
+}
+
+// Like all(), but returns the result by column: an object with a property
+// for every result column, which is a Float64Array for columns of numbers
+// and NULLs (as NaN), a BigInt64Array for columns of integers when reading
+// BigInts, and an array of the values otherwise.
+void StatementSync::AllColumnar(const FunctionCallbackInfo<Value>& args) {
+  StatementSync* stmt;
+  ASSIGN_OR_RETURN_UNWRAP(&stmt, args.This());
+  Environment* env = Environment::GetCurrent(args);
+  THROW_AND_RETURN_ON_BAD_STATE(
+      env, stmt->IsFinalized(), "statement has been finalized");
+  Isolate* isolate = env->isolate();
+  int r = sqlite3_reset(stmt->statement_);
+  CHECK_ERROR_OR_THROW(isolate, stmt->db_.get(), r, SQLITE_OK, void());
+
+  if (!stmt->BindParams(args)) {
+    return;
+  }
+
+  auto reset = OnScopeLeave([&]() { sqlite3_reset(stmt->statement_); });
+
+  Local<Object> result;
+  if (stmt->StepColumnar().ToLocal(&result)) {
+    args.GetReturnValue().Set(result);
+  }
+}
+
 void StatementSync::Iterate(const FunctionCallbackInfo<Value>& args) {
   StatementSync* stmt;
   ASSIGN_OR_RETURN_UNWRAP(&stmt, args.This());
@@ -2508,6 +2987,263 @@ void StatementSync::Run(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+bool StatementSync::BindRows(Local<Array> rows,
+                             sqlite3_int64* changes,
+                             sqlite3_int64* last_insert_rowid) {
+  Isolate* isolate = env()->isolate();
+  Local<Context> context = env()->context();
+  size_t num_params = anonymous_params_->size();
+  uint32_t num_rows = rows->Length();
+  for (uint32_t i = 0; i < num_rows; i++) {
+    HandleScope handle_scope(isolate);
+    Local<Value> row_v;
+    if (!rows->Get(context, i).ToLocal(&row_v)) {
+      return false;
+    }
+    if (!row_v->IsArray()) {
+      THROW_ERR_INVALID_ARG_TYPE(
+          isolate, "The \"rows[%d]\" argument must be an array.", i);
+      return false;
+    }
+    Local<Array> row = row_v.As<Array>();
+    if (row->Length() != num_params) {
+      THROW_ERR_INVALID_ARG_VALUE(
+          isolate,
+          "The \"rows[%d]\" argument must have %d values, received %d.",
+          i,
+          num_params,
+          row->Length());
+      return false;
+    }
+
+    for (uint32_t j = 0; j < num_params; j++) {
+      Local<Value> value;
+      if (!row->Get(context, j).ToLocal(&value) ||
+          !BindValue(value, (*anonymous_params_)[j], &bind_kinds_[j])) {
+        return false;
+      }
+    }
+
+    sqlite3_step(statement_);
+    int r = sqlite3_reset(statement_);
+    CHECK_ERROR_OR_THROW(isolate, db_.get(), r, SQLITE_OK, false);
+    *changes += sqlite3_changes64(db_->Connection());
+    *last_insert_rowid = sqlite3_last_insert_rowid(db_->Connection());
+  }
+  return true;
+}
+
+bool StatementSync::BindColumns(Local<Array> columns,
+                                sqlite3_int64* changes,
+                                sqlite3_int64* last_insert_rowid) {
+  Isolate* isolate = env()->isolate();
+  Local<Context> context = env()->context();
+  size_t num_params = anonymous_params_->size();
+  if (columns->Length() != num_params) {
+    THROW_ERR_INVALID_ARG_VALUE(
+        isolate,
+        "The \"columns\" argument must have %d typed arrays, received %d.",
+        num_params,
+        columns->Length());
+    return false;
+  }
+
+  struct Column {
+    enum class Type {
+      kInt8,
+      kUint8,
+      kInt16,
+      kUint16,
+      kInt32,
+      kUint32,
+      kBigInt64,
+      kBigUint64,
+      kFloat32,
+      kFloat64
+    };
+    Type type;
+    const uint8_t* data;
+  };
+  std::vector<Column> cols(num_params);
+  size_t num_rows = 0;
+  for (uint32_t j = 0; j < num_params; j++) {
+    Local<Value> value;
+    if (!columns->Get(context, j).ToLocal(&value)) {
+      return false;
+    }
+    Column::Type type;
+    if (value->IsInt8Array()) {
+      type = Column::Type::kInt8;
+    } else if (value->IsUint8Array() || value->IsUint8ClampedArray()) {
+      type = Column::Type::kUint8;
+    } else if (value->IsInt16Array()) {
+      type = Column::Type::kInt16;
+    } else if (value->IsUint16Array()) {
+      type = Column::Type::kUint16;
+    } else if (value->IsInt32Array()) {
+      type = Column::Type::kInt32;
+    } else if (value->IsUint32Array()) {
+      type = Column::Type::kUint32;
+    } else if (value->IsBigInt64Array()) {
+      type = Column::Type::kBigInt64;
+    } else if (value->IsBigUint64Array()) {
+      type = Column::Type::kBigUint64;
+    } else if (value->IsFloat32Array()) {
+      type = Column::Type::kFloat32;
+    } else if (value->IsFloat64Array()) {
+      type = Column::Type::kFloat64;
+    } else {
+      THROW_ERR_INVALID_ARG_TYPE(
+          isolate,
+          "The \"columns[%d]\" argument must be an integer, BigInt or float "
+          "typed array.",
+          j);
+      return false;
+    }
+    Local<TypedArray> array = value.As<TypedArray>();
+    if (j == 0) {
+      num_rows = array->Length();
+    } else if (array->Length() != num_rows) {
+      THROW_ERR_INVALID_ARG_VALUE(
+          isolate, "The typed arrays of \"columns\" must have equal lengths.");
+      return false;
+    }
+    cols[j].type = type;
+    cols[j].data = static_cast<const uint8_t*>(array->Buffer()->Data()) +
+                   array->ByteOffset();
+  }
+
+  for (size_t i = 0; i < num_rows; i++) {
+    for (size_t j = 0; j < num_params; j++) {
+      int index = (*anonymous_params_)[j];
+      const uint8_t* data = cols[j].data;
+      int r;
+      switch (cols[j].type) {
+#define V(Kind, T)                                                             \
+  case Column::Type::Kind: {                                                   \
+    r = sqlite3_bind_int64(statement_, index, ReadElement<T>(data, i));        \
+    break;                                                                     \
+  }
+        V(kInt8, int8_t)
+        V(kUint8, uint8_t)
+        V(kInt16, int16_t)
+        V(kUint16, uint16_t)
+        V(kInt32, int32_t)
+        V(kUint32, uint32_t)
+        V(kBigInt64, int64_t)
+#undef V
+        case Column::Type::kBigUint64: {
+          uint64_t value = ReadElement<uint64_t>(data, i);
+          if (value > static_cast<uint64_t>(INT64_MAX)) {
+            THROW_ERR_INVALID_ARG_VALUE(env(),
+                                        "BigInt value is too large to bind.");
+            return false;
+          }
+          r = sqlite3_bind_int64(
+              statement_, index, static_cast<sqlite3_int64>(value));
+          break;
+        }
+        case Column::Type::kFloat32: {
+          r = sqlite3_bind_double(
+              statement_, index, ReadElement<float>(data, i));
+          break;
+        }
+        case Column::Type::kFloat64: {
+          r = sqlite3_bind_double(
+              statement_, index, ReadElement<double>(data, i));
+          break;
+        }
+      }
+      CHECK_ERROR_OR_THROW(isolate, db_.get(), r, SQLITE_OK, false);
+    }
+
+    sqlite3_step(statement_);
+    int r = sqlite3_reset(statement_);
+    CHECK_ERROR_OR_THROW(isolate, db_.get(), r, SQLITE_OK, false);
+    *changes += sqlite3_changes64(db_->Connection());
+    *last_insert_rowid = sqlite3_last_insert_rowid(db_->Connection());
+  }
+  return true;
+}
+
+// Runs the statement once for each row of positional parameters, in a
+// single transaction. The rows are either an array of arrays of values, or
+// an array of typed arrays holding the values of each parameter, in which
+// case integers are bound as integers.
+void StatementSync::RunBatch(const FunctionCallbackInfo<Value>& args) {
+  StatementSync* stmt;
+  ASSIGN_OR_RETURN_UNWRAP(&stmt, args.This());
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  THROW_AND_RETURN_ON_BAD_STATE(
+      env, stmt->IsFinalized(), "statement has been finalized");
+  if (!args[0]->IsArray()) {
+    THROW_ERR_INVALID_ARG_TYPE(isolate,
+                               "The \"rows\" argument must be an array.");
+    return;
+  }
+  Local<Array> rows = args[0].As<Array>();
+  bool columnar = false;
+  if (rows->Length() > 0) {
+    Local<Value> first;
+    if (!rows->Get(env->context(), 0).ToLocal(&first)) {
+      return;
+    }
+    columnar = first->IsTypedArray();
+  }
+
+  int r = sqlite3_reset(stmt->statement_);
+  CHECK_ERROR_OR_THROW(isolate, stmt->db_.get(), r, SQLITE_OK, void());
+  r = sqlite3_clear_bindings(stmt->statement_);
+  CHECK_ERROR_OR_THROW(isolate, stmt->db_.get(), r, SQLITE_OK, void());
+  stmt->FindAnonymousParams();
+
+  // A savepoint starts a transaction, or nests in the one that is open.
+  sqlite3* connection = stmt->db_->Connection();
+  r = sqlite3_exec(
+      connection, "SAVEPOINT node_run_batch", nullptr, nullptr, nullptr);
+  CHECK_ERROR_OR_THROW(isolate, stmt->db_.get(), r, SQLITE_OK, void());
+
+  sqlite3_int64 changes = 0;
+  sqlite3_int64 last_insert_rowid = sqlite3_last_insert_rowid(connection);
+  bool ok = columnar
+                ? stmt->BindColumns(rows, &changes, &last_insert_rowid)
+                : stmt->BindRows(rows, &changes, &last_insert_rowid);
+  sqlite3_clear_bindings(stmt->statement_);
+  if (!ok) {
+    sqlite3_exec(connection,
+                 "ROLLBACK TO node_run_batch; RELEASE node_run_batch",
+                 nullptr,
+                 nullptr,
+                 nullptr);
+    return;
+  }
+  r = sqlite3_exec(
+      connection, "RELEASE node_run_batch", nullptr, nullptr, nullptr);
+  CHECK_ERROR_OR_THROW(isolate, stmt->db_.get(), r, SQLITE_OK, void());
+
+  Local<Value> changes_val;
+  Local<Value> last_insert_rowid_val;
+  if (stmt->use_big_ints_) {
+    changes_val = BigInt::New(isolate, changes);
+    last_insert_rowid_val = BigInt::New(isolate, last_insert_rowid);
+  } else {
+    changes_val = Number::New(isolate, changes);
+    last_insert_rowid_val = Number::New(isolate, last_insert_rowid);
+  }
+  Local<Object> result = Object::New(isolate);
+  if (result
+          ->Set(env->context(),
+                env->last_insert_rowid_string(),
+                last_insert_rowid_val)
+          .IsNothing() ||
+      result->Set(env->context(), env->changes_string(), changes_val)
+          .IsNothing()) {
+    return;
+  }
+  args.GetReturnValue().Set(result);
+}
+
 void StatementSync::Columns(const FunctionCallbackInfo<Value>& args) {
   StatementSync* stmt;
   ASSIGN_OR_RETURN_UNWRAP(&stmt, args.This());
@@ -2991,8 +3727,11 @@ Local<FunctionTemplate> StatementSync::GetConstructorTemplate(
         StatementSync::kInternalFieldCount);
     SetProtoMethod(isolate, tmpl, "iterate", StatementSync::Iterate);
     SetProtoMethod(isolate, tmpl, "all", StatementSync::All);
+    SetProtoMethod(
+        isolate, tmpl, "allColumnar", StatementSync::AllColumnar);
     SetProtoMethod(isolate, tmpl, "get", StatementSync::Get);
     SetProtoMethod(isolate, tmpl, "run", StatementSync::Run);
+    SetProtoMethod(isolate, tmpl, "runBatch", StatementSync::RunBatch);
     SetProtoMethodNoSideEffect(
         isolate, tmpl, "columns", StatementSync::Columns);
     SetSideEffectFreeGetter(isolate,
@@ -3272,15 +4011,797 @@ void Session::Delete() {
   session_ = nullptr;
 }
 
-void DefineConstants(Local<Object> target) {
-  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_OMIT);
-  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_REPLACE);
-  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_ABORT);
+constexpr int kMaxDatabaseReaders = 16;
 
-  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_DATA);
-  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_NOTFOUND);
-  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_CONFLICT);
-  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_CONSTRAINT);
+// A value bound to or read from a query of a Database, copied so that it can
+// be used on the threadpool.
+struct DatabaseValue {
+  int type = SQLITE_NULL;
+  sqlite3_int64 integer = 0;
+  double real = 0;
+  // The bytes of a TEXT or BLOB value.
+  std::string bytes;
+};
+
+static bool ToDatabaseValue(Environment* env,
+                            Local<Value> value,
+                            DatabaseValue* out) {
+  if (value->IsNumber()) {
+    out->type = SQLITE_FLOAT;
+    out->real = value.As<Number>()->Value();
+  } else if (value->IsString()) {
+    Utf8Value val(env->isolate(), value.As<String>());
+    out->type = SQLITE_TEXT;
+    out->bytes.assign(*val, val.length());
+  } else if (value->IsNull()) {
+    out->type = SQLITE_NULL;
+  } else if (value->IsArrayBufferView()) {
+    ArrayBufferViewContents<char> buf(value);
+    out->type = SQLITE_BLOB;
+    out->bytes.assign(buf.data(), buf.length());
+  } else if (value->IsBigInt()) {
+    bool lossless;
+    out->type = SQLITE_INTEGER;
+    out->integer = value.As<BigInt>()->Int64Value(&lossless);
+    if (!lossless) {
+      THROW_ERR_INVALID_ARG_VALUE(env, "BigInt value is too large to bind.");
+      return false;
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+class DatabaseJob : public ThreadPoolWork {
+ public:
+  using Kind = Database::QueryKind;
+
+  DatabaseJob(Environment* env,
+              Database* db,
+              Kind kind,
+              std::string&& sql,
+              Local<Promise::Resolver> resolver)
+      : ThreadPoolWork(env, "node_sqlite3.DatabaseJob", Lane::kSlowIo),
+        db_(db),
+        kind_(kind),
+        sql_(std::move(sql)),
+        resolver_(env->isolate(), resolver) {}
+
+  ~DatabaseJob() override {
+    for (const Database::Connection& connection : to_close_) {
+      sqlite3_close_v2(connection.db);
+    }
+  }
+
+  Kind kind() const { return kind_; }
+  Database::Connection* connection() const { return connection_; }
+  bool is_writer() const { return is_writer_; }
+  bool needs_writer() const { return needs_writer_; }
+
+  // Whether the job can run on a reader connection. Queries that turn out
+  // to write when they are prepared on a reader are queued again for the
+  // writer.
+  bool is_read() const {
+    return (kind_ == Kind::kAll || kind_ == Kind::kGet) && !needs_writer_;
+  }
+
+  // Copies the parameters of the query, which are either an array of
+  // positional parameters or an object of named parameters.
+  bool SetParameters(Local<Value> params) {
+    Environment* env = this->env();
+    Local<Context> context = env->context();
+    if (params->IsUndefined()) return true;
+
+    if (params->IsArray()) {
+      Local<Array> array = params.As<Array>();
+      uint32_t len = array->Length();
+      positional_.resize(len);
+      for (uint32_t i = 0; i < len; i++) {
+        Local<Value> value;
+        if (!array->Get(context, i).ToLocal(&value)) return false;
+        if (!ToDatabaseValue(env, value, &positional_[i])) {
+          if (!env->isolate()->HasPendingException()) {
+            THROW_ERR_INVALID_ARG_TYPE(
+                env->isolate(),
+                "Provided value cannot be bound to SQLite parameter %d.",
+                i + 1);
+          }
+          return false;
+        }
+      }
+      return true;
+    }
+
+    if (!params->IsObject() || params->IsArrayBufferView()) {
+      THROW_ERR_INVALID_ARG_TYPE(env->isolate(),
+                                 "The \"parameters\" argument must be an "
+                                 "array or an object.");
+      return false;
+    }
+
+    Local<Object> obj = params.As<Object>();
+    Local<Array> keys;
+    if (!obj->GetOwnPropertyNames(context).ToLocal(&keys)) return false;
+    uint32_t len = keys->Length();
+    named_.resize(len);
+    for (uint32_t i = 0; i < len; i++) {
+      Local<Value> key;
+      Local<Value> value;
+      if (!keys->Get(context, i).ToLocal(&key) ||
+          !obj->Get(context, key).ToLocal(&value)) {
+        return false;
+      }
+      Utf8Value utf8_key(env->isolate(), key);
+      named_[i].first = utf8_key.ToString();
+      if (!ToDatabaseValue(env, value, &named_[i].second)) {
+        if (!env->isolate()->HasPendingException()) {
+          THROW_ERR_INVALID_ARG_TYPE(
+              env->isolate(),
+              "Provided value cannot be bound to SQLite parameter '%s'.",
+              utf8_key);
+        }
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Start(Database::Connection* connection, bool is_writer) {
+    connection_ = connection;
+    is_writer_ = is_writer;
+    needs_writer_ = false;
+    db_ref_.reset(db_);
+    ScheduleWork();
+  }
+
+  // Starts closing the connections of the database, which must not be in
+  // use.
+  void StartClose(std::vector<Database::Connection>&& connections) {
+    to_close_ = std::move(connections);
+    db_ref_.reset(db_);
+    ScheduleWork();
+  }
+
+  void DoThreadPoolWork() override {
+    if (kind_ == Kind::kClose) {
+      for (Database::Connection& connection : to_close_) {
+        int r = sqlite3_close_v2(connection.db);
+        if (r != SQLITE_OK && errcode_ == SQLITE_OK) {
+          errcode_ = r;
+          errmsg_ = sqlite3_errstr(r);
+        }
+      }
+      to_close_.clear();
+      return;
+    }
+
+    sqlite3* connection = connection_->db;
+    if (kind_ == Kind::kExec) {
+      if (sqlite3_exec(connection, sql_.c_str(), nullptr, nullptr, nullptr) !=
+          SQLITE_OK) {
+        SetError(connection);
+      }
+      return;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int r = sqlite3_prepare_v2(
+        connection, sql_.data(), sql_.size(), &stmt, nullptr);
+    auto finalize = OnScopeLeave([&]() { sqlite3_finalize(stmt); });
+    if (r != SQLITE_OK) {
+      SetError(connection);
+      return;
+    }
+    if (stmt == nullptr) {
+      // An empty statement.
+      return;
+    }
+    if (!is_writer_ && !sqlite3_stmt_readonly(stmt)) {
+      needs_writer_ = true;
+      return;
+    }
+    if (!Bind(stmt)) return;
+
+    int num_cols = sqlite3_column_count(stmt);
+    while ((r = sqlite3_step(stmt)) == SQLITE_ROW) {
+      if (kind_ == Kind::kRun) continue;
+      if (rows_ == 0) {
+        column_names_.reserve(num_cols);
+        for (int i = 0; i < num_cols; i++) {
+          const char* name = sqlite3_column_name(stmt, i);
+          column_names_.emplace_back(name != nullptr ? name : "");
+        }
+      }
+      for (int i = 0; i < num_cols; i++) {
+        DatabaseValue& cell = cells_.emplace_back();
+        cell.type = sqlite3_column_type(stmt, i);
+        switch (cell.type) {
+          case SQLITE_INTEGER:
+            cell.integer = sqlite3_column_int64(stmt, i);
+            break;
+          case SQLITE_FLOAT:
+            cell.real = sqlite3_column_double(stmt, i);
+            break;
+          case SQLITE_TEXT:
+          case SQLITE_BLOB: {
+            const void* data = cell.type == SQLITE_TEXT
+                                   ? sqlite3_column_text(stmt, i)
+                                   : sqlite3_column_blob(stmt, i);
+            cell.bytes.assign(static_cast<const char*>(data),
+                              sqlite3_column_bytes(stmt, i));
+            break;
+          }
+        }
+      }
+      rows_++;
+      if (kind_ == Kind::kGet) {
+        r = SQLITE_DONE;
+        break;
+      }
+    }
+    if (r != SQLITE_DONE) {
+      SetError(connection);
+      return;
+    }
+    if (kind_ == Kind::kRun) {
+      changes_ = sqlite3_changes64(connection);
+      last_insert_rowid_ = sqlite3_last_insert_rowid(connection);
+    }
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    CHECK_EQ(status, 0);
+    // Keeps the database alive until the job is settled.
+    BaseObjectPtr<Database> db = std::move(db_ref_);
+    db->OnJobDone(this);
+  }
+
+  // Settles the promise of the job, on the main thread.
+  void Settle() {
+    Environment* env = this->env();
+    Isolate* isolate = env->isolate();
+    HandleScope handle_scope(isolate);
+    Local<Context> context = env->context();
+    Local<Promise::Resolver> resolver = resolver_.Get(isolate);
+
+    TryCatch try_catch(isolate);
+    Local<Value> result;
+    if (ToResult().ToLocal(&result)) {
+      resolver->Resolve(context, result).Check();
+    } else if (try_catch.HasCaught() && try_catch.CanContinue()) {
+      resolver->Reject(context, try_catch.Exception()).Check();
+    }
+  }
+
+ private:
+  bool Bind(sqlite3_stmt* stmt) {
+    for (size_t i = 0; i < positional_.size(); i++) {
+      if (!BindValue(stmt, i + 1, positional_[i])) return false;
+    }
+    for (const auto& [name, value] : named_) {
+      int index = sqlite3_bind_parameter_index(stmt, name.c_str());
+      if (index == 0 && db_->open_config_.get_allow_bare_named_params()) {
+        for (char prefix : {':', '$', '@'}) {
+          std::string full_name = prefix + name;
+          index = sqlite3_bind_parameter_index(stmt, full_name.c_str());
+          if (index != 0) break;
+        }
+      }
+      if (index == 0) {
+        bind_error_ = "Unknown named parameter '" + name + "'";
+        return false;
+      }
+      if (!BindValue(stmt, index, value)) return false;
+    }
+    return true;
+  }
+
+  bool BindValue(sqlite3_stmt* stmt, int index, const DatabaseValue& value) {
+    int r;
+    switch (value.type) {
+      case SQLITE_INTEGER:
+        r = sqlite3_bind_int64(stmt, index, value.integer);
+        break;
+      case SQLITE_FLOAT:
+        r = sqlite3_bind_double(stmt, index, value.real);
+        break;
+      case SQLITE_TEXT:
+        r = sqlite3_bind_text(stmt,
+                              index,
+                              value.bytes.data(),
+                              value.bytes.size(),
+                              SQLITE_STATIC);
+        break;
+      case SQLITE_BLOB:
+        r = sqlite3_bind_blob(stmt,
+                              index,
+                              value.bytes.data(),
+                              value.bytes.size(),
+                              SQLITE_STATIC);
+        break;
+      default:
+        r = sqlite3_bind_null(stmt, index);
+        break;
+    }
+    if (r != SQLITE_OK) {
+      SetError(sqlite3_db_handle(stmt));
+      return false;
+    }
+    return true;
+  }
+
+  void SetError(sqlite3* connection) {
+    errcode_ = sqlite3_extended_errcode(connection);
+    errmsg_ = sqlite3_errmsg(connection);
+  }
+
+  MaybeLocal<Value> ToValue(const DatabaseValue& cell) {
+    Isolate* isolate = env()->isolate();
+    bool use_big_ints = db_->open_config_.get_use_big_ints();
+    switch (cell.type) {
+      case SQLITE_INTEGER:
+        if (use_big_ints) {
+          return BigInt::New(isolate, cell.integer);
+        } else if (std::abs(cell.integer) <= kMaxSafeJsInteger) {
+          return Number::New(isolate, cell.integer);
+        }
+        THROW_ERR_OUT_OF_RANGE(isolate,
+                               "Value is too large to be represented as a "
+                               "JavaScript number: %" PRId64,
+                               cell.integer);
+        return MaybeLocal<Value>();
+      case SQLITE_FLOAT:
+        return Number::New(isolate, cell.real);
+      case SQLITE_TEXT:
+        return String::NewFromUtf8(isolate,
+                                   cell.bytes.data(),
+                                   NewStringType::kNormal,
+                                   cell.bytes.size())
+            .FromMaybe(Local<String>());
+      case SQLITE_BLOB: {
+        auto store = ArrayBuffer::NewBackingStore(
+            isolate,
+            cell.bytes.size(),
+            BackingStoreInitializationMode::kUninitialized);
+        memcpy(store->Data(), cell.bytes.data(), cell.bytes.size());
+        auto ab = ArrayBuffer::New(isolate, std::move(store));
+        return Uint8Array::New(ab, 0, cell.bytes.size());
+      }
+      default:
+        return Null(isolate);
+    }
+  }
+
+  // Converts the rows that were read, creating the column names once.
+  MaybeLocal<Value> ToResult() {
+    Environment* env = this->env();
+    Isolate* isolate = env->isolate();
+    Local<Context> context = env->context();
+
+    if (errcode_ != SQLITE_OK) {
+      Local<Object> e;
+      if (CreateSQLiteError(isolate, errcode_, errmsg_.c_str()).ToLocal(&e)) {
+        isolate->ThrowException(e);
+      }
+      return MaybeLocal<Value>();
+    }
+    if (!bind_error_.empty()) {
+      THROW_ERR_INVALID_STATE(env, "%s", bind_error_);
+      return MaybeLocal<Value>();
+    }
+
+    switch (kind_) {
+      case Kind::kExec:
+      case Kind::kClose:
+        return Undefined(isolate);
+      case Kind::kRun: {
+        bool use_big_ints = db_->open_config_.get_use_big_ints();
+        Local<Value> changes =
+            use_big_ints ? BigInt::New(isolate, changes_).As<Value>()
+                         : Number::New(isolate, changes_).As<Value>();
+        Local<Value> last_insert_rowid =
+            use_big_ints
+                ? BigInt::New(isolate, last_insert_rowid_).As<Value>()
+                : Number::New(isolate, last_insert_rowid_).As<Value>();
+        Local<Object> result = Object::New(isolate);
+        if (result
+                ->Set(context,
+                      env->last_insert_rowid_string(),
+                      last_insert_rowid)
+                .IsNothing() ||
+            result->Set(context, env->changes_string(), changes)
+                .IsNothing()) {
+          return MaybeLocal<Value>();
+        }
+        return result;
+      }
+      case Kind::kAll:
+      case Kind::kGet:
+        break;
+    }
+
+    if (kind_ == Kind::kGet && rows_ == 0) return Undefined(isolate);
+
+    size_t num_cols = column_names_.size();
+    bool return_arrays = db_->open_config_.get_return_arrays();
+    LocalVector<Name> keys(isolate);
+    if (!return_arrays) {
+      keys.reserve(num_cols);
+      for (const std::string& name : column_names_) {
+        Local<String> key;
+        if (!String::NewFromUtf8(isolate,
+                                 name.data(),
+                                 NewStringType::kNormal,
+                                 name.size())
+                 .ToLocal(&key)) {
+          return MaybeLocal<Value>();
+        }
+        keys.push_back(key);
+      }
+    }
+
+    LocalVector<Value> rows(isolate);
+    LocalVector<Value> values(isolate);
+    rows.reserve(rows_);
+    values.reserve(num_cols);
+    for (size_t row = 0; row < rows_; row++) {
+      values.clear();
+      for (size_t i = 0; i < num_cols; i++) {
+        Local<Value> value;
+        if (!ToValue(cells_[row * num_cols + i]).ToLocal(&value)) {
+          return MaybeLocal<Value>();
+        }
+        values.push_back(value);
+      }
+      if (return_arrays) {
+        rows.push_back(Array::New(isolate, values.data(), values.size()));
+      } else {
+        rows.push_back(Object::New(
+            isolate, Null(isolate), keys.data(), values.data(), num_cols));
+      }
+    }
+
+    if (kind_ == Kind::kGet) return rows[0];
+    return Array::New(isolate, rows.data(), rows.size());
+  }
+
+  // The database is kept alive by db_ref_ while the job runs, and by the
+  // job that is running while the job is queued.
+  Database* db_;
+  BaseObjectPtr<Database> db_ref_;
+  Kind kind_;
+  std::string sql_;
+  Global<Promise::Resolver> resolver_;
+  std::vector<DatabaseValue> positional_;
+  std::vector<std::pair<std::string, DatabaseValue>> named_;
+  Database::Connection* connection_ = nullptr;
+  bool is_writer_ = false;
+  bool needs_writer_ = false;
+  std::vector<Database::Connection> to_close_;
+
+  int errcode_ = SQLITE_OK;
+  std::string errmsg_;
+  std::string bind_error_;
+  std::vector<std::string> column_names_;
+  // The values of the rows that were read, row after row.
+  std::vector<DatabaseValue> cells_;
+  size_t rows_ = 0;
+  sqlite3_int64 changes_ = 0;
+  sqlite3_int64 last_insert_rowid_ = 0;
+};
+
+Database::Database(Environment* env,
+                   Local<Object> object,
+                   DatabaseOpenConfiguration&& open_config,
+                   int readers)
+    : BaseObject(env, object),
+      open_config_(std::move(open_config)),
+      connections_(1 + readers) {
+  MakeWeak();
+}
+
+Database::~Database() {
+  queue_.clear();
+  CloseConnections();
+}
+
+void Database::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField(
+      "open_config", sizeof(open_config_), "DatabaseOpenConfiguration");
+  tracker->TrackFieldWithSize(
+      "connections", connections_.size() * sizeof(Connection));
+  tracker->TrackFieldWithSize("queue",
+                              queue_.size() * sizeof(DatabaseJob));
+}
+
+bool Database::Open() {
+  Isolate* isolate = env()->isolate();
+  for (size_t i = 0; i < connections_.size(); i++) {
+    // The writer of a read-only database is opened read-only as well, it
+    // only runs the queries that are not known to be reads.
+    bool is_writer = i == 0 && !open_config_.get_read_only();
+    int flags = SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX |
+                (is_writer ? SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE
+                           : SQLITE_OPEN_READONLY);
+    sqlite3** db = &connections_[i].db;
+    int r = sqlite3_open_v2(
+        open_config_.location().c_str(), db, flags, nullptr);
+    if (r == SQLITE_OK) {
+      r = sqlite3_db_config(*db,
+                            SQLITE_DBCONFIG_DQS_DML,
+                            static_cast<int>(open_config_.get_enable_dqs()),
+                            nullptr);
+    }
+    if (r == SQLITE_OK) {
+      r = sqlite3_db_config(
+          *db,
+          SQLITE_DBCONFIG_ENABLE_FKEY,
+          static_cast<int>(open_config_.get_enable_foreign_keys()),
+          nullptr);
+    }
+    if (r == SQLITE_OK) {
+      sqlite3_busy_timeout(*db, open_config_.get_timeout());
+      // The readers need WAL mode to run concurrently with the writer.
+      if (i == 0 && connections_.size() > 1 && is_writer) {
+        r = sqlite3_exec(
+            *db, "PRAGMA journal_mode = WAL", nullptr, nullptr, nullptr);
+      }
+    }
+    if (r != SQLITE_OK) {
+      Local<Object> e;
+      if (*db == nullptr) {
+        THROW_ERR_SQLITE_ERROR(isolate, r);
+      } else if (CreateSQLiteError(isolate, *db).ToLocal(&e)) {
+        isolate->ThrowException(e);
+      }
+      CloseConnections();
+      closing_ = true;
+      return false;
+    }
+  }
+  return true;
+}
+
+void Database::CloseConnections() {
+  for (Connection& connection : connections_) {
+    sqlite3_close_v2(connection.db);
+  }
+  connections_.clear();
+}
+
+void Database::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  if (!args.IsConstructCall()) {
+    THROW_ERR_CONSTRUCT_CALL_REQUIRED(env);
+    return;
+  }
+
+  std::optional<std::string> location =
+      ValidateDatabasePath(env, args[0], "path");
+  if (!location.has_value()) {
+    return;
+  }
+
+  DatabaseOpenConfiguration open_config(std::move(location.value()));
+  int readers = 0;
+  if (!args[1]->IsUndefined()) {
+    if (!args[1]->IsObject()) {
+      THROW_ERR_INVALID_ARG_TYPE(env->isolate(),
+                                 "The \"options\" argument must be an object.");
+      return;
+    }
+    Local<Object> options = args[1].As<Object>();
+    Local<Context> context = env->context();
+
+    const auto get_boolean = [&](const char* name, bool* out) {
+      Local<Value> value;
+      if (!options->Get(context, OneByteString(env->isolate(), name))
+               .ToLocal(&value)) {
+        return false;
+      }
+      if (value->IsUndefined()) return true;
+      if (!value->IsBoolean()) {
+        THROW_ERR_INVALID_ARG_TYPE(
+            env->isolate(),
+            "The \"options.%s\" argument must be a boolean.",
+            name);
+        return false;
+      }
+      *out = value.As<Boolean>()->Value();
+      return true;
+    };
+
+    bool read_only = false;
+    bool read_big_ints = false;
+    bool return_arrays = false;
+    if (!get_boolean("readOnly", &read_only) ||
+        !get_boolean("readBigInts", &read_big_ints) ||
+        !get_boolean("returnArrays", &return_arrays)) {
+      return;
+    }
+    open_config.set_read_only(read_only);
+    open_config.set_use_big_ints(read_big_ints);
+    open_config.set_return_arrays(return_arrays);
+
+    Local<Value> timeout_v;
+    if (!options->Get(context, env->timeout_string()).ToLocal(&timeout_v)) {
+      return;
+    }
+    if (!timeout_v->IsUndefined()) {
+      if (!timeout_v->IsInt32()) {
+        THROW_ERR_INVALID_ARG_TYPE(
+            env->isolate(),
+            "The \"options.timeout\" argument must be an integer.");
+        return;
+      }
+      open_config.set_timeout(timeout_v.As<Int32>()->Value());
+    }
+
+    Local<Value> readers_v;
+    if (!options->Get(context, FIXED_ONE_BYTE_STRING(env->isolate(), "readers"))
+             .ToLocal(&readers_v)) {
+      return;
+    }
+    if (!readers_v->IsUndefined()) {
+      if (!readers_v->IsInt32() || readers_v.As<Int32>()->Value() < 0 ||
+          readers_v.As<Int32>()->Value() > kMaxDatabaseReaders) {
+        THROW_ERR_OUT_OF_RANGE(
+            env->isolate(),
+            "The \"options.readers\" argument must be an integer from 0 "
+            "to %d.",
+            kMaxDatabaseReaders);
+        return;
+      }
+      readers = readers_v.As<Int32>()->Value();
+    }
+  }
+  Database* db =
+      new Database(env, args.This(), std::move(open_config), readers);
+  db->Open();
+}
+
+void Database::Query(const FunctionCallbackInfo<Value>& args, QueryKind kind) {
+  Database* db;
+  ASSIGN_OR_RETURN_UNWRAP(&db, args.This());
+  Environment* env = Environment::GetCurrent(args);
+  THROW_AND_RETURN_ON_BAD_STATE(env, db->closing_, "database is not open");
+
+  std::string sql;
+  if (kind != QueryKind::kClose) {
+    if (!args[0]->IsString()) {
+      THROW_ERR_INVALID_ARG_TYPE(env->isolate(),
+                                 "The \"sql\" argument must be a string.");
+      return;
+    }
+    sql = Utf8Value(env->isolate(), args[0].As<String>()).ToString();
+  }
+
+  Local<Promise::Resolver> resolver;
+  if (!Promise::Resolver::New(env->context()).ToLocal(&resolver)) {
+    return;
+  }
+  auto job =
+      std::make_unique<DatabaseJob>(env, db, kind, std::move(sql), resolver);
+  if (kind != QueryKind::kExec && kind != QueryKind::kClose &&
+      !job->SetParameters(args[1])) {
+    return;
+  }
+  if (kind == QueryKind::kClose) {
+    db->closing_ = true;
+  }
+
+  args.GetReturnValue().Set(resolver->GetPromise());
+  db->queue_.push_back(std::move(job));
+  db->Dispatch();
+}
+
+void Database::Dispatch() {
+  if (!env()->can_call_into_js()) return;
+  while (!queue_.empty()) {
+    DatabaseJob* job = queue_.front().get();
+    if (job->kind() == QueryKind::kClose) {
+      if (write_in_flight_ || reads_in_flight_ > 0) return;
+      queue_.front().release()->StartClose(std::move(connections_));
+      queue_.pop_front();
+      return;
+    }
+
+    // A query waits for the writes before it, and a write for all of the
+    // queries before it, so that every query sees the same database as if
+    // they ran one after the other.
+    if (write_in_flight_) return;
+    Connection* connection = nullptr;
+    if (job->is_read()) {
+      for (size_t i = connections_.size(); i-- > 0;) {
+        if (!connections_[i].busy) {
+          connection = &connections_[i];
+          break;
+        }
+      }
+      if (connection == nullptr) return;
+      reads_in_flight_++;
+    } else {
+      if (reads_in_flight_ > 0) return;
+      connection = &connections_[0];
+      write_in_flight_ = true;
+    }
+
+    connection->busy = true;
+    queue_.front().release()->Start(connection, connection == &connections_[0]);
+    queue_.pop_front();
+  }
+}
+
+void Database::OnJobDone(DatabaseJob* job) {
+  std::unique_ptr<DatabaseJob> done(job);
+  if (job->kind() != QueryKind::kClose) {
+    job->connection()->busy = false;
+    if (job->is_writer()) {
+      write_in_flight_ = false;
+    } else {
+      reads_in_flight_--;
+    }
+  }
+  if (job->needs_writer()) {
+    queue_.push_front(std::move(done));
+    Dispatch();
+    return;
+  }
+
+  Dispatch();
+  if (!env()->can_call_into_js()) return;
+  HandleScope handle_scope(env()->isolate());
+  InternalCallbackScope callback_scope(env(), object(), {0, 0});
+  job->Settle();
+}
+
+void Database::Exec(const FunctionCallbackInfo<Value>& args) {
+  Query(args, QueryKind::kExec);
+}
+
+void Database::All(const FunctionCallbackInfo<Value>& args) {
+  Query(args, QueryKind::kAll);
+}
+
+void Database::Get(const FunctionCallbackInfo<Value>& args) {
+  Query(args, QueryKind::kGet);
+}
+
+void Database::Run(const FunctionCallbackInfo<Value>& args) {
+  Query(args, QueryKind::kRun);
+}
+
+void Database::Close(const FunctionCallbackInfo<Value>& args) {
+  Query(args, QueryKind::kClose);
+}
+
+void Database::Location(const FunctionCallbackInfo<Value>& args) {
+  Database* db;
+  ASSIGN_OR_RETURN_UNWRAP(&db, args.This());
+  Environment* env = Environment::GetCurrent(args);
+  Local<String> location;
+  if (String::NewFromUtf8(env->isolate(), db->open_config_.location().c_str())
+          .ToLocal(&location)) {
+    args.GetReturnValue().Set(location);
+  }
+}
+
+void Database::IsOpenGetter(const FunctionCallbackInfo<Value>& args) {
+  Database* db;
+  ASSIGN_OR_RETURN_UNWRAP(&db, args.This());
+  args.GetReturnValue().Set(!db->closing_);
+}
+
+void DefineConstants(Local<Object> target) {
+  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_OMIT);
+  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_REPLACE);
+  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_ABORT);
+
+  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_DATA);
+  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_NOTFOUND);
+  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_CONFLICT);
+  NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_CONSTRAINT);
   NODE_DEFINE_CONSTANT(target, SQLITE_CHANGESET_FOREIGN_KEY);
 
   // Authorization result codes
@@ -3388,6 +4909,23 @@ static void Initialize(Local<Object> target,
   SetConstructorFunction(
       context, target, "Session", Session::GetConstructorTemplate(env));
 
+  Local<FunctionTemplate> async_db_tmpl =
+      NewFunctionTemplate(isolate, Database::New);
+  async_db_tmpl->InstanceTemplate()->SetInternalFieldCount(
+      Database::kInternalFieldCount);
+  SetProtoMethod(isolate, async_db_tmpl, "exec", Database::Exec);
+  SetProtoMethod(isolate, async_db_tmpl, "all", Database::All);
+  SetProtoMethod(isolate, async_db_tmpl, "get", Database::Get);
+  SetProtoMethod(isolate, async_db_tmpl, "run", Database::Run);
+  SetProtoMethod(isolate, async_db_tmpl, "close", Database::Close);
+  SetProtoMethodNoSideEffect(
+      isolate, async_db_tmpl, "location", Database::Location);
+  SetSideEffectFreeGetter(isolate,
+                          async_db_tmpl,
+                          FIXED_ONE_BYTE_STRING(isolate, "isOpen"),
+                          Database::IsOpenGetter);
+  SetConstructorFunction(context, target, "Database", async_db_tmpl);
+
   target->Set(context, env->constants_string(), constants).Check();
 
   Local<Function> backup_function;
@@ -9,9 +9,12 @@
 #include "sqlite3.h"
 #include "util.h"
 
+#include <deque>
 #include <list>
 #include <map>
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 namespace node {
 namespace sqlite {
@@ -69,6 +72,25 @@ class DatabaseOpenConfiguration {
 
   inline bool get_enable_defensive() const { return defensive_; }
 
+  inline void set_statement_cache_size(int size) {
+    statement_cache_size_ = size;
+  }
+
+  inline int get_statement_cache_size() const { return statement_cache_size_; }
+
+  // A negative size keeps the default of SQLite.
+  inline void set_mmap_size(int64_t size) { mmap_size_ = size; }
+
+  inline int64_t get_mmap_size() const { return mmap_size_; }
+
+  inline void set_page_cache_size(int64_t size) { page_cache_size_ = size; }
+
+  inline int64_t get_page_cache_size() const { return page_cache_size_; }
+
+  inline void set_shared_cache(bool flag) { shared_cache_ = flag; }
+
+  inline bool get_shared_cache() const { return shared_cache_; }
+
  private:
   std::string location_;
   bool read_only_ = false;
@@ -80,12 +102,17 @@ class DatabaseOpenConfiguration {
   bool allow_bare_named_params_ = true;
   bool allow_unknown_named_params_ = false;
   bool defensive_ = false;
+  int statement_cache_size_ = 0;
+  int64_t mmap_size_ = -1;
+  int64_t page_cache_size_ = -1;
+  bool shared_cache_ = false;
 };
 
 class DatabaseSync;
 class StatementSyncIterator;
 class StatementSync;
 class BackupJob;
+class DatabaseJob;
 
 class StatementExecutionHelper {
  public:
@@ -155,6 +182,9 @@ class DatabaseSync : public BaseObject {
                                 const char* param3,
                                 const char* param4);
   void FinalizeStatements();
+  // Returns a statement of the cache that is compiled from sql and can be
+  // used, or nullptr.
+  std::shared_ptr<sqlite3_stmt> GetCachedStatement(const std::string& sql);
   void RemoveBackup(BackupJob* backup);
   void AddBackup(BackupJob* backup);
   void FinalizeBackups();
@@ -194,6 +224,11 @@ class DatabaseSync : public BaseObject {
   std::set<BackupJob*> backups_;
   std::set<sqlite3_session*> sessions_;
   std::unordered_set<StatementSync*> statements_;
+  // The statements that prepare() and exec() compiled, keyed by their SQL,
+  // when the statementCacheSize option is set. The statements that
+  // prepare() returns share them, so that the SQL is only compiled again
+  // when a statement is evicted or is in use by an iteration.
+  LRUCache<std::string, std::shared_ptr<sqlite3_stmt>> statement_cache_;
 
   friend class Session;
   friend class SQLTagStore;
@@ -213,9 +248,11 @@ class StatementSync : public BaseObject {
                                              BaseObjectPtr<DatabaseSync> db,
                                              sqlite3_stmt* stmt);
   static void All(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void AllColumnar(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Iterate(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Get(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Run(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void RunBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Columns(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SourceSQLGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void ExpandedSQLGetter(
@@ -238,14 +275,41 @@ class StatementSync : public BaseObject {
   ~StatementSync() override;
   BaseObjectPtr<DatabaseSync> db_;
   sqlite3_stmt* statement_;
+  // Set when statement_ is shared with the statement cache of the
+  // database, which finalizes it.
+  std::shared_ptr<sqlite3_stmt> cached_statement_;
   bool return_arrays_ = false;
   bool use_big_ints_;
   bool allow_bare_named_params_;
   bool allow_unknown_named_params_;
   std::optional<std::map<std::string, std::string>> bare_named_params_;
+  // The names of the result columns, created once and reused for as long as
+  // the statement, which SQLite may prepare again after schema changes, has
+  // the same columns.
+  std::vector<std::pair<std::string, v8::Global<v8::Name>>> column_names_;
+  v8::MaybeLocal<v8::Name> CachedColumnName(const int column);
+  v8::MaybeLocal<v8::Object> StepColumnar();
+  // The JavaScript types of the values that were last bound to the
+  // positional parameters, which are checked first on the next bind.
+  enum class BindKind : uint8_t { kUnknown, kNumber, kString, kNull, kBlob };
+  // The indices of the positional parameters, and the kinds of the values
+  // last bound to them, found on the first bind.
+  std::optional<std::vector<int>> anonymous_params_;
+  std::vector<BindKind> bind_kinds_;
+  void FindAnonymousParams();
   bool BindParams(const v8::FunctionCallbackInfo<v8::Value>& args);
+  bool BindRows(v8::Local<v8::Array> rows,
+                sqlite3_int64* changes,
+                sqlite3_int64* last_insert_rowid);
+  bool BindColumns(v8::Local<v8::Array> columns,
+                   sqlite3_int64* changes,
+                   sqlite3_int64* last_insert_rowid);
   bool BindValue(const v8::Local<v8::Value>& value, const int index);
+  bool BindValue(const v8::Local<v8::Value>& value,
+                 const int index,
+                 BindKind* kind);
 
+  friend class DatabaseSync;
   friend class StatementSyncIterator;
   friend class SQLTagStore;
   friend class StatementExecutionHelper;
@@ -335,6 +399,58 @@ class SQLTagStore : public BaseObject {
   friend class StatementExecutionHelper;
 };
 
+// An asynchronous database. Queries run on the threadpool, in the order
+// they were made, and settle promises with their results, so that slow
+// queries do not block the event loop. When readers is not zero, the
+// database is put in WAL mode and that many read-only connections run the
+// consecutive queries that do not write concurrently with each other.
+class Database : public BaseObject {
+ public:
+  Database(Environment* env,
+           v8::Local<v8::Object> object,
+           DatabaseOpenConfiguration&& open_config,
+           int readers);
+  ~Database() override;
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Exec(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void All(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Get(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Run(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Location(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void IsOpenGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  SET_MEMORY_INFO_NAME(Database)
+  SET_SELF_SIZE(Database)
+
+ private:
+  friend class DatabaseJob;
+
+  enum class QueryKind { kExec, kAll, kGet, kRun, kClose };
+
+  struct Connection {
+    sqlite3* db = nullptr;
+    bool busy = false;
+  };
+
+  bool Open();
+  void CloseConnections();
+  static void Query(const v8::FunctionCallbackInfo<v8::Value>& args,
+                    QueryKind kind);
+  // Starts the jobs at the head of the queue that can run now.
+  void Dispatch();
+  void OnJobDone(DatabaseJob* job);
+
+  DatabaseOpenConfiguration open_config_;
+  // The first connection is the writer, the others are readers.
+  std::vector<Connection> connections_;
+  std::deque<std::unique_ptr<DatabaseJob>> queue_;
+  size_t reads_in_flight_ = 0;
+  bool write_in_flight_ = false;
+  bool closing_ = false;
+};
+
 class UserDefinedFunction {
  public:
   UserDefinedFunction(Environment* env,
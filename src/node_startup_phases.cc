@@ -0,0 +1,124 @@
+#include "node_startup_phases.h"
+#include "node_internals.h"
+#include "uv.h"
+
+#include <atomic>
+
+namespace node {
+namespace startup_phases {
+
+namespace {
+
+struct PhaseTimes {
+  uint64_t begin = 0;
+  uint64_t end = 0;
+};
+
+struct CounterTimes {
+  // Built-in modules can also be compiled on worker threads.
+  std::atomic<uint64_t> first{0};
+  std::atomic<uint64_t> total{0};
+  std::atomic<uint64_t> count{0};
+};
+
+constexpr const char* kPhaseNames[] = {
+#define V(_, description) description,
+    STARTUP_PHASES(V)
+#undef V
+};
+
+constexpr const char* kCounterNames[] = {
+#define V(_, description) description,
+    STARTUP_COUNTERS(V)
+#undef V
+};
+
+PhaseTimes phases[static_cast<size_t>(Phase::kCount)];
+CounterTimes counters[static_cast<size_t>(Counter::kCount)];
+std::atomic<bool> enabled{false};
+
+double ToMilliseconds(uint64_t ns) {
+  return static_cast<double>(ns) / 1e6;
+}
+
+// node_start_time is only set after the platform has been initialized.
+uint64_t ProcessStart() {
+  const uint64_t platform_init =
+      phases[static_cast<size_t>(Phase::kPlatformInit)].begin;
+  if (platform_init != 0 && platform_init < per_process::node_start_time) {
+    return platform_init;
+  }
+  return per_process::node_start_time;
+}
+
+}  // namespace
+
+void Enable() {
+  enabled.store(true, std::memory_order_relaxed);
+}
+
+bool IsEnabled() {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+void Begin(Phase phase) {
+  phases[static_cast<size_t>(phase)].begin = uv_hrtime();
+}
+
+void End(Phase phase) {
+  phases[static_cast<size_t>(phase)].end = uv_hrtime();
+}
+
+CounterScope::CounterScope(Counter counter)
+    : counter_(counter), start_(IsEnabled() ? uv_hrtime() : 0) {}
+
+CounterScope::~CounterScope() {
+  if (start_ == 0 || !IsEnabled()) return;
+  CounterTimes& times = counters[static_cast<size_t>(counter_)];
+  uint64_t expected = 0;
+  times.first.compare_exchange_strong(
+      expected, start_, std::memory_order_relaxed);
+  times.total.fetch_add(uv_hrtime() - start_, std::memory_order_relaxed);
+  times.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Print(FILE* file) {
+  if (!enabled.exchange(false)) return;
+  const uint64_t origin = ProcessStart();
+  const uint64_t now = uv_hrtime();
+
+  fprintf(file, "Startup phases (ms since the start of the process):\n");
+  fprintf(file, "%10s %10s  %s\n", "start", "duration", "phase");
+  for (size_t i = 0; i < static_cast<size_t>(Phase::kCount); i++) {
+    const PhaseTimes& times = phases[i];
+    // Phases can be skipped, e.g. without a snapshot or when embedded.
+    if (times.begin == 0 || times.end < times.begin) continue;
+    fprintf(file,
+            "%10.3f %10.3f  %s\n",
+            ToMilliseconds(times.begin - origin),
+            ToMilliseconds(times.end - times.begin),
+            kPhaseNames[i]);
+  }
+  fprintf(file, "%10.3f %10s  total\n", ToMilliseconds(now - origin), "");
+
+  fprintf(file, "\n%10s %10s %8s  %s\n", "first", "total", "count", "work");
+  for (size_t i = 0; i < static_cast<size_t>(Counter::kCount); i++) {
+    const CounterTimes& times = counters[i];
+    const uint64_t count = times.count.load(std::memory_order_relaxed);
+    if (count == 0) {
+      fprintf(file, "%10s %10s %8d  %s\n", "-", "-", 0, kCounterNames[i]);
+      continue;
+    }
+    fprintf(file,
+            "%10.3f %10.3f %8llu  %s\n",
+            ToMilliseconds(times.first.load(std::memory_order_relaxed) -
+                           origin),
+            ToMilliseconds(times.total.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(count),  // NOLINT(runtime/int)
+            kCounterNames[i]);
+  }
+  fflush(file);
+}
+
+}  // namespace startup_phases
+}  // namespace node
@@ -0,0 +1,89 @@
+#ifndef SRC_NODE_STARTUP_PHASES_H_
+#define SRC_NODE_STARTUP_PHASES_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstdint>
+#include <cstdio>
+
+namespace node {
+namespace startup_phases {
+
+// A finer breakdown of process startup than the performance milestones, for
+// --trace-startup-phases. Phases run once, in this order, on the main
+// thread.
+#define STARTUP_PHASES(V)                                                      \
+  V(PlatformInit, "platform initialization")                                   \
+  V(ParseOptions, "option parsing")                                            \
+  V(ICU, "ICU data loading")                                                   \
+  V(OpenSSL, "OpenSSL initialization")                                         \
+  V(V8Platform, "V8 platform initialization")                                  \
+  V(V8Initialize, "V8 initialization")                                         \
+  V(SnapshotLoad, "snapshot loading")                                          \
+  V(IsolateDeserialization, "isolate creation and deserialization")            \
+  V(EnvironmentCreation, "context deserialization and bootstrap")              \
+  V(LoadEnvironment, "main script")
+
+// Work that happens many times, within the phases above. These record their
+// total time, how often they happened and when they first did.
+#define STARTUP_COUNTERS(V)                                                    \
+  V(BuiltinCompile, "built-in module compilation")                             \
+  V(CompileCacheRead, "compile cache reads")                                   \
+  V(PackageJSONRead, "package.json reads (module resolution)")
+
+enum class Phase {
+#define V(name, _) k##name,
+  STARTUP_PHASES(V)
+#undef V
+  kCount
+};
+
+enum class Counter {
+#define V(name, _) k##name,
+  STARTUP_COUNTERS(V)
+#undef V
+  kCount
+};
+
+// Phases are recorded whether or not the timeline is printed, since the
+// first ones run before the options are parsed. Counters are only recorded
+// once Enable() has been called, and until the timeline has been printed.
+void Enable();
+bool IsEnabled();
+
+void Begin(Phase phase);
+void End(Phase phase);
+
+// Prints the timeline, with times relative to the start of the process, and
+// stops recording. Does nothing unless Enable() has been called.
+void Print(FILE* file);
+
+class PhaseScope {
+ public:
+  explicit PhaseScope(Phase phase) : phase_(phase) { Begin(phase); }
+  ~PhaseScope() { End(phase_); }
+  PhaseScope(const PhaseScope&) = delete;
+  PhaseScope& operator=(const PhaseScope&) = delete;
+
+ private:
+  Phase phase_;
+};
+
+class CounterScope {
+ public:
+  explicit CounterScope(Counter counter);
+  ~CounterScope();
+  CounterScope(const CounterScope&) = delete;
+  CounterScope& operator=(const CounterScope&) = delete;
+
+ private:
+  Counter counter_;
+  uint64_t start_;
+};
+
+}  // namespace startup_phases
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_STARTUP_PHASES_H_
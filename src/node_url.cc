@@ -35,6 +35,33 @@ using v8::Value;
 
 void BindingData::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("url_components_buffer", url_components_buffer_);
+  size_t parse_cache_size = 0;
+  for (const auto& [key, parsed] : parse_cache_) {
+    parse_cache_size += key.capacity() + parsed.href.capacity();
+  }
+  tracker->TrackFieldWithSize("parse_cache", parse_cache_size);
+}
+
+std::string BindingData::ParseCacheKey(
+    std::string_view input, const std::optional<std::string>& base) {
+  // The length of the base keeps the boundary between the two unambiguous.
+  std::string key;
+  if (base.has_value()) {
+    key = std::to_string(base->size());
+    key += ':';
+    key += *base;
+  } else {
+    key = '-';
+  }
+  key += input;
+  return key;
+}
+
+const BindingData::ParsedURL* BindingData::LookupParsed(
+    std::string_view input, const std::optional<std::string>& base) {
+  std::string key = ParseCacheKey(input, base);
+  if (!parse_cache_.Exists(key)) return nullptr;
+  return &parse_cache_.Get(key);
 }
 
 BindingData::BindingData(Realm* realm, Local<Object> object)
@@ -271,10 +298,20 @@ void BindingData::CanParse(const FunctionCallbackInfo<Value>& args) {
   Utf8Value input(env->isolate(), args[0]);
   std::string_view input_view = input.ToStringView();
 
-  bool can_parse{};
+  std::optional<std::string> base;
   if (args[1]->IsString()) {
-    Utf8Value base(env->isolate(), args[1]);
-    std::string_view base_view = base.ToStringView();
+    base = Utf8Value(env->isolate(), args[1]).ToString();
+  }
+
+  // Inputs that were parsed before need not be validated again.
+  BindingData* binding_data = Realm::GetBindingData<BindingData>(args);
+  if (const ParsedURL* parsed = binding_data->LookupParsed(input_view, base)) {
+    return args.GetReturnValue().Set(parsed->valid);
+  }
+
+  bool can_parse{};
+  if (base.has_value()) {
+    std::string_view base_view = *base;
     can_parse = ada::can_parse(input_view, &base_view);
   } else {
     can_parse = ada::can_parse(input_view);
@@ -386,11 +423,40 @@ void BindingData::Parse(const FunctionCallbackInfo<Value>& args) {
   std::optional<std::string> base_{};
 
   Utf8Value input(isolate, args[0]);
-  ada::result<ada::url_aggregator> base;
-  ada::url_aggregator* base_pointer = nullptr;
   if (args[1]->IsString()) {
     base_ = Utf8Value(isolate, args[1]).ToString();
+  }
+
+  const bool cacheable = input.length() <= kMaxCachedInputLength &&
+                         (!base_.has_value() ||
+                          base_->size() <= kMaxCachedInputLength);
+  if (cacheable) {
+    if (const ParsedURL* parsed =
+            binding_data->LookupParsed(input.ToStringView(), base_)) {
+      if (!parsed->valid) {
+        if (raise_exception) {
+          ThrowInvalidURL(realm->env(), input.ToStringView(), base_);
+        }
+        return;
+      }
+      binding_data->UpdateComponents(parsed->components, parsed->type);
+      Local<Value> ret;
+      if (ToV8Value(realm->context(), parsed->href, isolate).ToLocal(&ret))
+          [[likely]] {
+        args.GetReturnValue().Set(ret);
+      }
+      return;
+    }
+  }
+
+  ada::result<ada::url_aggregator> base;
+  ada::url_aggregator* base_pointer = nullptr;
+  if (base_.has_value()) {
     base = ada::parse<ada::url_aggregator>(*base_);
+    if (!base && cacheable) {
+      binding_data->parse_cache_.Put(
+          ParseCacheKey(input.ToStringView(), base_), ParsedURL{false});
+    }
     if (!base && raise_exception) {
       return ThrowInvalidURL(realm->env(), input.ToStringView(), base_);
     } else if (!base) {
@@ -401,6 +467,17 @@ void BindingData::Parse(const FunctionCallbackInfo<Value>& args) {
   auto out =
       ada::parse<ada::url_aggregator>(input.ToStringView(), base_pointer);
 
+  if (cacheable) {
+    ParsedURL parsed{static_cast<bool>(out)};
+    if (out) {
+      parsed.href = out->get_href();
+      parsed.components = out->get_components();
+      parsed.type = out->type;
+    }
+    binding_data->parse_cache_.Put(ParseCacheKey(input.ToStringView(), base_),
+                                   std::move(parsed));
+  }
+
   if (!out && raise_exception) {
     return ThrowInvalidURL(realm->env(), input.ToStringView(), base_);
   } else if (!out) {
@@ -6,6 +6,7 @@
 #include <cinttypes>
 #include "ada.h"
 #include "aliased_buffer.h"
+#include "lru_cache-inl.h"
 #include "node.h"
 #include "node_snapshotable.h"
 #include "util.h"
@@ -77,7 +78,28 @@ class BindingData : public SnapshotableObject {
 
  private:
   static constexpr size_t kURLComponentsLength = 9;
+  // Limits on the parse cache. Longer inputs are rarely parsed twice.
+  static constexpr size_t kParseCacheSize = 256;
+  static constexpr size_t kMaxCachedInputLength = 2048;
+
+  // The result of parsing an input against a base.
+  struct ParsedURL {
+    bool valid;
+    std::string href;
+    ada::url_components components;
+    ada::scheme::type type;
+  };
+
+  static std::string ParseCacheKey(std::string_view input,
+                                   const std::optional<std::string>& base);
+  // Returns the cached result of parsing input against base, or nullptr.
+  const ParsedURL* LookupParsed(std::string_view input,
+                                const std::optional<std::string>& base);
+
   AliasedUint32Array url_components_buffer_;
+  // Servers parse the same base URLs and routes over and over, so the
+  // results of Parse() are kept, keyed by the input and the base.
+  LRUCache<std::string, ParsedURL> parse_cache_{kParseCacheSize};
 
   void UpdateComponents(const ada::url_components& components,
                         const ada::scheme::type type);
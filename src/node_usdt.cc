@@ -0,0 +1,54 @@
+#include "node_usdt.h"
+#include "env-inl.h"
+
+#if defined(NODE_HAVE_USDT) && NODE_HAVE_USDT
+extern "C" {
+// The tracer finds the semaphores in the .probes section, through the notes
+// that the probes add.
+#define V(name)                                                                \
+  __attribute__((section(".probes"))) volatile unsigned short                 \
+      node_##name##_semaphore = 0;
+NODE_USDT_PROBES(V)
+#undef V
+}
+#endif  // NODE_HAVE_USDT
+
+namespace node {
+namespace usdt {
+
+#if defined(NODE_HAVE_USDT) && NODE_HAVE_USDT
+namespace {
+
+void GCPrologue(v8::Isolate* isolate,
+                v8::GCType type,
+                v8::GCCallbackFlags flags,
+                void* data) {
+  NODE_USDT2(gc__start, static_cast<int>(type), static_cast<int>(flags));
+}
+
+void GCEpilogue(v8::Isolate* isolate,
+                v8::GCType type,
+                v8::GCCallbackFlags flags,
+                void* data) {
+  NODE_USDT2(gc__done, static_cast<int>(type), static_cast<int>(flags));
+}
+
+void RemoveGCProbes(void* data) {
+  Environment* env = static_cast<Environment*>(data);
+  env->isolate()->RemoveGCPrologueCallback(GCPrologue, data);
+  env->isolate()->RemoveGCEpilogueCallback(GCEpilogue, data);
+}
+
+}  // namespace
+
+void AddGCProbes(Environment* env) {
+  env->isolate()->AddGCPrologueCallback(GCPrologue, env);
+  env->isolate()->AddGCEpilogueCallback(GCEpilogue, env);
+  env->AddCleanupHook(RemoveGCProbes, env);
+}
+#else
+void AddGCProbes(Environment* env) {}
+#endif  // NODE_HAVE_USDT
+
+}  // namespace usdt
+}  // namespace node
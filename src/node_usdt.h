@@ -0,0 +1,81 @@
+#ifndef SRC_NODE_USDT_H_
+#define SRC_NODE_USDT_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+// USDT probes, in the "node" provider, for tracing the hot paths with
+// bpftrace, perf or SystemTap, e.g.
+//
+//   bpftrace -e 'usdt:./node:node:callback__start { @[arg0] = count(); }'
+//
+// They are built in with ./configure --with-usdt, which needs <sys/sdt.h>.
+// Each probe has a semaphore that the tracer sets while it is attached, so
+// when no tracer is attached a probe costs a load and a branch, and its
+// arguments are not computed.
+#define NODE_USDT_PROBES(V)                                                    \
+  V(callback__start)                                                           \
+  V(callback__done)                                                            \
+  V(stream__read)                                                              \
+  V(stream__write__start)                                                      \
+  V(stream__write__done)                                                       \
+  V(http__message__start)                                                      \
+  V(http__message__done)                                                       \
+  V(fs__start)                                                                 \
+  V(fs__done)                                                                  \
+  V(gc__start)                                                                 \
+  V(gc__done)                                                                  \
+  V(module__load)
+
+#if defined(NODE_HAVE_USDT) && NODE_HAVE_USDT
+
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+extern "C" {
+#define V(name) extern volatile unsigned short node_##name##_semaphore;
+NODE_USDT_PROBES(V)
+#undef V
+}
+
+#define NODE_USDT_ENABLED(name) (node_##name##_semaphore != 0)
+#define NODE_USDT1(name, a)                                                    \
+  do {                                                                         \
+    if (NODE_USDT_ENABLED(name)) [[unlikely]]                                  \
+      STAP_PROBE1(node, name, a);                                              \
+  } while (0)
+#define NODE_USDT2(name, a, b)                                                 \
+  do {                                                                         \
+    if (NODE_USDT_ENABLED(name)) [[unlikely]]                                  \
+      STAP_PROBE2(node, name, a, b);                                           \
+  } while (0)
+#define NODE_USDT3(name, a, b, c)                                              \
+  do {                                                                         \
+    if (NODE_USDT_ENABLED(name)) [[unlikely]]                                  \
+      STAP_PROBE3(node, name, a, b, c);                                        \
+  } while (0)
+
+#else  // !NODE_HAVE_USDT
+
+#define NODE_USDT_ENABLED(name) false
+#define NODE_USDT1(name, a) do {} while (0)
+#define NODE_USDT2(name, a, b) do {} while (0)
+#define NODE_USDT3(name, a, b, c) do {} while (0)
+
+#endif  // NODE_HAVE_USDT
+
+namespace node {
+
+class Environment;
+
+namespace usdt {
+
+// Adds the GC callbacks that fire the gc__start and gc__done probes, if the
+// probes are built in.
+void AddGCProbes(Environment* env);
+
+}  // namespace usdt
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_USDT_H_
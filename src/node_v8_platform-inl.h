@@ -126,7 +126,10 @@ struct V8Platform {
           convert_to_set(categories),
           std::unique_ptr<tracing::AsyncTraceWriter>(
               new tracing::NodeTraceWriter(
-                  per_process::cli_options->trace_event_file_pattern)),
+                  per_process::cli_options->trace_event_file_pattern,
+                  per_process::cli_options->trace_event_format == "perfetto"
+                      ? tracing::NodeTraceWriter::Format::kPerfetto
+                      : tracing::NodeTraceWriter::Format::kJSON)),
           tracing::Agent::kUseDefaultCategories);
     }
   }
@@ -423,6 +423,66 @@ static void SetFunction(R (*f)(WASI&, WasmMemory, Args...),
   WASI::WasiFunction<FT, F, R, Args...>::SetFunction(env, name, tmpl);
 }
 
+namespace {
+// Calls usually pass a handful of iovecs, which are kept on the stack.
+constexpr size_t kStackIovecs = 16;
+
+template <typename T>
+using IovecBuffer = MaybeStackBuffer<T, kStackIovecs>;
+
+inline uvwasi_errno_t ReadIovecs(WasmMemory memory,
+                                 uint32_t iovs_ptr,
+                                 uvwasi_iovec_t* iovs,
+                                 uint32_t iovs_len) {
+  return uvwasi_serdes_readv_iovec_t(
+      memory.data, memory.size, iovs_ptr, iovs, iovs_len);
+}
+
+inline uvwasi_errno_t ReadIovecs(WasmMemory memory,
+                                 uint32_t iovs_ptr,
+                                 uvwasi_ciovec_t* iovs,
+                                 uint32_t iovs_len) {
+  return uvwasi_serdes_readv_ciovec_t(
+      memory.data, memory.size, iovs_ptr, iovs, iovs_len);
+}
+
+// Reads the iovecs at iovs_ptr into iovs, leaving out the empty ones and
+// merging the ones that are adjacent in memory, as libc buffered I/O tends to
+// produce them. Fewer iovecs saves uvwasi and libuv from allocating copies
+// of them, and the transfer is the same. *count is set to the number left.
+template <typename T>
+uvwasi_errno_t ReadCompactIovecs(WasmMemory memory,
+                                 uint32_t iovs_ptr,
+                                 uint32_t iovs_len,
+                                 IovecBuffer<T>* iovs,
+                                 uvwasi_size_t* count) {
+  iovs->AllocateSufficientStorage(iovs_len);
+  uvwasi_errno_t err = ReadIovecs(memory, iovs_ptr, iovs->out(), iovs_len);
+  if (err != UVWASI_ESUCCESS) return err;
+
+  T* out = iovs->out();
+  uvwasi_size_t n = 0;
+  for (uint32_t i = 0; i < iovs_len; i++) {
+    const T& iov = out[i];
+    if (iov.buf_len == 0) continue;
+    if (n > 0) {
+      T& last = out[n - 1];
+      if (static_cast<const char*>(last.buf) + last.buf_len == iov.buf &&
+          iov.buf_len <= std::numeric_limits<uvwasi_size_t>::max() -
+                             last.buf_len) {
+        last.buf_len += iov.buf_len;
+        continue;
+      }
+    }
+    out[n++] = iov;
+  }
+  // Only empty iovecs: pass one of them on, so that the call behaves as
+  // it did with all of them.
+  *count = (n == 0 && iovs_len > 0) ? 1 : n;
+  return UVWASI_ESUCCESS;
+}
+}  // namespace
+
 uint32_t WASI::ArgsGet(WASI& wasi,
                        WasmMemory memory,
                        uint32_t argv_offset,
@@ -667,17 +727,17 @@ uint32_t WASI::FdPread(WASI& wasi,
   CHECK_BOUNDS_OR_RETURN(
       memory.size, iovs_ptr, iovs_len * UVWASI_SERDES_SIZE_iovec_t);
   CHECK_BOUNDS_OR_RETURN(memory.size, nread_ptr, UVWASI_SERDES_SIZE_size_t);
-  std::vector<uvwasi_iovec_t> iovs(iovs_len);
-  uvwasi_errno_t err;
-
-  err = uvwasi_serdes_readv_iovec_t(
-      memory.data, memory.size, iovs_ptr, iovs.data(), iovs_len);
+  IovecBuffer<uvwasi_iovec_t> iovs;
+  uvwasi_size_t iovs_count;
+  uvwasi_errno_t err =
+      ReadCompactIovecs(memory, iovs_ptr, iovs_len, &iovs, &iovs_count);
   if (err != UVWASI_ESUCCESS) {
     return err;
   }
 
   uvwasi_size_t nread;
-  err = uvwasi_fd_pread(&wasi.uvw_, fd, iovs.data(), iovs_len, offset, &nread);
+  err = uvwasi_fd_pread(
+      &wasi.uvw_, fd, iovs.out(), iovs_count, offset, &nread);
   if (err == UVWASI_ESUCCESS)
     uvwasi_serdes_write_size_t(memory.data, nread_ptr, nread);
 
@@ -727,18 +787,17 @@ uint32_t WASI::FdPwrite(WASI& wasi,
   CHECK_BOUNDS_OR_RETURN(
       memory.size, iovs_ptr, iovs_len * UVWASI_SERDES_SIZE_ciovec_t);
   CHECK_BOUNDS_OR_RETURN(memory.size, nwritten_ptr, UVWASI_SERDES_SIZE_size_t);
-  std::vector<uvwasi_ciovec_t> iovs(iovs_len);
-  uvwasi_errno_t err;
-
-  err = uvwasi_serdes_readv_ciovec_t(
-      memory.data, memory.size, iovs_ptr, iovs.data(), iovs_len);
+  IovecBuffer<uvwasi_ciovec_t> iovs;
+  uvwasi_size_t iovs_count;
+  uvwasi_errno_t err =
+      ReadCompactIovecs(memory, iovs_ptr, iovs_len, &iovs, &iovs_count);
   if (err != UVWASI_ESUCCESS) {
     return err;
   }
 
   uvwasi_size_t nwritten;
   err = uvwasi_fd_pwrite(
-      &wasi.uvw_, fd, iovs.data(), iovs_len, offset, &nwritten);
+      &wasi.uvw_, fd, iovs.out(), iovs_count, offset, &nwritten);
   if (err == UVWASI_ESUCCESS)
     uvwasi_serdes_write_size_t(memory.data, nwritten_ptr, nwritten);
 
@@ -755,17 +814,16 @@ uint32_t WASI::FdRead(WASI& wasi,
   CHECK_BOUNDS_OR_RETURN(
       memory.size, iovs_ptr, iovs_len * UVWASI_SERDES_SIZE_iovec_t);
   CHECK_BOUNDS_OR_RETURN(memory.size, nread_ptr, UVWASI_SERDES_SIZE_size_t);
-  std::vector<uvwasi_iovec_t> iovs(iovs_len);
-  uvwasi_errno_t err;
-
-  err = uvwasi_serdes_readv_iovec_t(
-      memory.data, memory.size, iovs_ptr, iovs.data(), iovs_len);
+  IovecBuffer<uvwasi_iovec_t> iovs;
+  uvwasi_size_t iovs_count;
+  uvwasi_errno_t err =
+      ReadCompactIovecs(memory, iovs_ptr, iovs_len, &iovs, &iovs_count);
   if (err != UVWASI_ESUCCESS) {
     return err;
   }
 
   uvwasi_size_t nread;
-  err = uvwasi_fd_read(&wasi.uvw_, fd, iovs.data(), iovs_len, &nread);
+  err = uvwasi_fd_read(&wasi.uvw_, fd, iovs.out(), iovs_count, &nread);
   if (err == UVWASI_ESUCCESS)
     uvwasi_serdes_write_size_t(memory.data, nread_ptr, nread);
 
@@ -856,17 +914,16 @@ uint32_t WASI::FdWrite(WASI& wasi,
   CHECK_BOUNDS_OR_RETURN(
       memory.size, iovs_ptr, iovs_len * UVWASI_SERDES_SIZE_ciovec_t);
   CHECK_BOUNDS_OR_RETURN(memory.size, nwritten_ptr, UVWASI_SERDES_SIZE_size_t);
-  std::vector<uvwasi_ciovec_t> iovs(iovs_len);
-  uvwasi_errno_t err;
-
-  err = uvwasi_serdes_readv_ciovec_t(
-      memory.data, memory.size, iovs_ptr, iovs.data(), iovs_len);
+  IovecBuffer<uvwasi_ciovec_t> iovs;
+  uvwasi_size_t iovs_count;
+  uvwasi_errno_t err =
+      ReadCompactIovecs(memory, iovs_ptr, iovs_len, &iovs, &iovs_count);
   if (err != UVWASI_ESUCCESS) {
     return err;
   }
 
   uvwasi_size_t nwritten;
-  err = uvwasi_fd_write(&wasi.uvw_, fd, iovs.data(), iovs_len, &nwritten);
+  err = uvwasi_fd_write(&wasi.uvw_, fd, iovs.out(), iovs_count, &nwritten);
   if (err == UVWASI_ESUCCESS)
     uvwasi_serdes_write_size_t(memory.data, nwritten_ptr, nwritten);
 
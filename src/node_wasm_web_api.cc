@@ -1,5 +1,7 @@
 #include "node_wasm_web_api.h"
 
+#include "compile_cache.h"
+#include "env-inl.h"
 #include "memory_tracker-inl.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
@@ -54,6 +56,7 @@ void WasmStreamingObject::MemoryInfo(MemoryTracker* tracker) const {
   // module that is being compiled is roughly what V8 allocates (as in, off by
   // only a small factor).
   tracker->TrackFieldWithSize("streaming", wasm_size_);
+  tracker->TrackField("cache_filename", cache_filename_);
 }
 
 MaybeLocal<Object> WasmStreamingObject::Create(
@@ -88,6 +91,26 @@ void WasmStreamingObject::SetURL(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsString());
   Utf8Value url(args.GetIsolate(), args[0]);
   obj->streaming_->SetUrl(url.out(), url.length());
+
+  // The compiled module is cached by URL, which is known before any bytes
+  // are pushed, and checked against the module bytes once they are all in.
+  Environment* env = Environment::GetCurrent(args);
+  if (!env->use_compile_cache() || obj->wasm_size_ != 0) return;
+  CompileCacheHandler* handler = env->compile_cache_handler();
+  obj->cache_filename_ = handler->GetWasmCacheFilename(url.ToStringView());
+
+  // Having cached bytes makes V8 wait for the whole module instead of
+  // compiling it as it streams in, so only claim them if the file is there.
+  uv_fs_t req;
+  int err =
+      uv_fs_stat(nullptr, &req, obj->cache_filename_.c_str(), nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err == 0) {
+    obj->streaming_->SetHasCompiledModuleBytes();
+    obj->has_cached_module_ = true;
+  }
+  obj->streaming_->SetMoreFunctionsCanBeSerializedCallback(
+      handler->GetWasmCacheWriter(obj->cache_filename_));
 }
 
 void WasmStreamingObject::Push(const FunctionCallbackInfo<Value>& args) {
@@ -132,7 +155,17 @@ void WasmStreamingObject::Finish(const FunctionCallbackInfo<Value>& args) {
   CHECK(obj->streaming_);
 
   CHECK_EQ(args.Length(), 0);
-  obj->streaming_->Finish();
+  WasmStreaming::ModuleCachingCallback caching_callback;
+  if (obj->has_cached_module_) {
+    // This is called synchronously from Finish(). If the cached module does
+    // not match, V8 compiles the module bytes as usual.
+    CompileCacheHandler* handler = obj->env()->compile_cache_handler();
+    caching_callback = [handler, &filename = obj->cache_filename_](
+                           WasmStreaming::ModuleCachingInterface& caching) {
+      handler->ReadWasmCache(filename, &caching);
+    };
+  }
+  obj->streaming_->Finish(caching_callback);
 }
 
 void WasmStreamingObject::Abort(const FunctionCallbackInfo<Value>& args) {
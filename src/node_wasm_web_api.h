@@ -40,6 +40,10 @@ class WasmStreamingObject final : public BaseObject {
 
   std::shared_ptr<v8::WasmStreaming> streaming_;
   size_t wasm_size_ = 0;
+  // With the compile cache enabled, where the compiled module is kept, and
+  // whether it was there when the URL was set.
+  std::string cache_filename_;
+  bool has_cached_module_ = false;
 };
 
 // This is a v8::WasmStreamingCallback implementation that must be passed to
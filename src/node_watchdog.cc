@@ -29,14 +29,28 @@
 #include "node_watchdog.h"
 #include "util-inl.h"
 
+#if defined(__linux__)
+#include <features.h>
+#endif
+
+// Native stacks of a stalled loop are taken by signalling its thread, which
+// needs real-time signals and a backtrace() that works in a signal handler.
+#if defined(__linux__) && defined(__GLIBC__)
+#define HAVE_STALL_SIGNAL 1
+#include <execinfo.h>
+#include <signal.h>
+#endif
+
 namespace node {
 
 using v8::Context;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::HandleScope;
 using v8::Isolate;
 using v8::Local;
 using v8::Object;
+using v8::StackTrace;
 using v8::Value;
 
 Watchdog::Watchdog(v8::Isolate* isolate, uint64_t ms, bool* timed_out)
@@ -99,6 +113,222 @@ void Watchdog::Timer(uv_timer_t* timer) {
   uv_stop(&w->loop_);
 }
 
+#if HAVE_STALL_SIGNAL
+namespace {
+
+constexpr int kMaxStallFrames = 64;
+// The signal handler and the trampoline that called it.
+constexpr int kSkippedStallFrames = 2;
+
+// Written by the signal handler on the stalled thread.
+void* stall_frames[kMaxStallFrames];
+std::atomic<int> stall_frame_count{-1};
+// The watchdogs of all environments share the buffer above.
+Mutex stall_signal_mutex;
+uv_once_t stall_signal_once = UV_ONCE_INIT;
+
+int StallSignal() {
+  // glibc keeps the first real-time signals for itself; nothing else in
+  // Node.js uses this one.
+  return SIGRTMIN + 3;
+}
+
+void StallSignalHandler(int signal, siginfo_t* info, void* ucontext) {
+  stall_frame_count.store(backtrace(stall_frames, kMaxStallFrames),
+                          std::memory_order_release);
+}
+
+void InstallStallSignalHandler() {
+  // The first call to backtrace() loads libgcc, which is not safe to do in
+  // a signal handler.
+  void* frame;
+  backtrace(&frame, 1);
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = StallSignalHandler;
+  // The stalled thread may well be in a system call.
+  sa.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigfillset(&sa.sa_mask);
+  CHECK_EQ(sigaction(StallSignal(), &sa, nullptr), 0);
+}
+
+}  // namespace
+#endif  // HAVE_STALL_SIGNAL
+
+LoopStallWatchdog::LoopStallWatchdog(Environment* env, uint64_t threshold_ms)
+    : env_(env),
+      threshold_ns_(threshold_ms * 1000 * 1000),
+      last_tick_(uv_hrtime()) {
+#ifdef __POSIX__
+  main_thread_ = pthread_self();
+#endif
+#if HAVE_STALL_SIGNAL
+  uv_once(&stall_signal_once, InstallStallSignalHandler);
+#endif
+
+  CHECK_EQ(0, uv_prepare_init(env->event_loop(), &prepare_));
+  CHECK_EQ(0, uv_prepare_start(&prepare_, [](uv_prepare_t* handle) {
+    LoopStallWatchdog* w = ContainerOf(&LoopStallWatchdog::prepare_, handle);
+    w->Tick();
+  }));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&prepare_));
+
+  // Makes a loop that waits for I/O come round often enough not to look
+  // stalled.
+  const uint64_t heartbeat_ms = std::max<uint64_t>(threshold_ms / 2, 1);
+  CHECK_EQ(0, uv_timer_init(env->event_loop(), &heartbeat_));
+  CHECK_EQ(0,
+           uv_timer_start(
+               &heartbeat_,
+               [](uv_timer_t* handle) {
+                 LoopStallWatchdog* w =
+                     ContainerOf(&LoopStallWatchdog::heartbeat_, handle);
+                 w->Tick();
+               },
+               heartbeat_ms,
+               heartbeat_ms));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&heartbeat_));
+
+  CHECK_EQ(0, uv_loop_init(&loop_));
+  CHECK_EQ(0, uv_async_init(&loop_, &async_, [](uv_async_t* handle) {
+    LoopStallWatchdog* w = ContainerOf(&LoopStallWatchdog::async_, handle);
+    uv_stop(&w->loop_);
+  }));
+  const uint64_t check_ms = std::max<uint64_t>(threshold_ms / 4, 1);
+  CHECK_EQ(0, uv_timer_init(&loop_, &timer_));
+  CHECK_EQ(0, uv_timer_start(&timer_, Check, check_ms, check_ms));
+  CHECK_EQ(0, uv_thread_create(&thread_, Run, this));
+}
+
+LoopStallWatchdog::~LoopStallWatchdog() {
+  CHECK(closed_);
+}
+
+void LoopStallWatchdog::Close() {
+  if (closed_) return;
+  closed_ = true;
+
+  uv_async_send(&async_);
+  uv_thread_join(&thread_);
+  uv_close(reinterpret_cast<uv_handle_t*>(&async_), nullptr);
+  // UV_RUN_DEFAULT so that libuv has a chance to clean up.
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  CheckedUvLoopClose(&loop_);
+
+  env_->CloseHandle(reinterpret_cast<uv_handle_t*>(&prepare_),
+                    [](uv_handle_t* handle) {});
+  env_->CloseHandle(reinterpret_cast<uv_handle_t*>(&heartbeat_),
+                    [](uv_handle_t* handle) {});
+}
+
+void LoopStallWatchdog::Run(void* arg) {
+  uv_thread_setname("StallWatchdog");
+  LoopStallWatchdog* w = static_cast<LoopStallWatchdog*>(arg);
+  uv_run(&w->loop_, UV_RUN_DEFAULT);
+  // Close the timer handle on this side and let Close() close async_.
+  uv_close(reinterpret_cast<uv_handle_t*>(&w->timer_), nullptr);
+}
+
+void LoopStallWatchdog::Check(uv_timer_t* timer) {
+  LoopStallWatchdog* w = ContainerOf(&LoopStallWatchdog::timer_, timer);
+  // A stall is only reported once, when the loop comes round again.
+  if (w->stalled_.load(std::memory_order_acquire)) return;
+  const uint64_t last_tick = w->last_tick_.load(std::memory_order_relaxed);
+  if (uv_hrtime() - last_tick < w->threshold_ns_) return;
+
+  Mutex::ScopedLock lock(w->mutex_);
+  w->stall_start_ = last_tick;
+  w->stall_end_ = 0;
+  w->has_javascript_stack_ = false;
+  w->javascript_stack_.clear();
+  w->native_stack_.clear();
+  w->CaptureNativeStack();
+  w->stalled_.store(true, std::memory_order_release);
+  // This runs as soon as JavaScript checks for interrupts, or otherwise
+  // once the loop comes round.
+  w->env_->RequestInterrupt(
+      [w](Environment* env) { w->CaptureJavaScriptStack(); });
+}
+
+void LoopStallWatchdog::CaptureNativeStack() {
+#if HAVE_STALL_SIGNAL
+  Mutex::ScopedLock lock(stall_signal_mutex);
+  stall_frame_count.store(-1, std::memory_order_relaxed);
+  if (pthread_kill(main_thread_, StallSignal()) != 0) return;
+  for (int i = 0; i < 100; i++) {
+    if (stall_frame_count.load(std::memory_order_acquire) >= 0) break;
+    uv_sleep(1);
+  }
+  const int count = stall_frame_count.load(std::memory_order_acquire);
+  if (count > kSkippedStallFrames) {
+    native_stack_.assign(stall_frames + kSkippedStallFrames,
+                         stall_frames + count);
+  }
+#endif  // HAVE_STALL_SIGNAL
+}
+
+void LoopStallWatchdog::CaptureJavaScriptStack() {
+  Isolate* isolate = env_->isolate();
+  HandleScope handle_scope(isolate);
+  std::string stack = FormatStackTrace(
+      isolate,
+      StackTrace::CurrentStackTrace(
+          isolate, static_cast<int>(env_->stack_trace_limit())));
+  {
+    Mutex::ScopedLock lock(mutex_);
+    javascript_stack_ = std::move(stack);
+    has_javascript_stack_ = true;
+  }
+  MaybeReport();
+}
+
+void LoopStallWatchdog::Tick() {
+  const uint64_t now = uv_hrtime();
+  last_tick_.store(now, std::memory_order_relaxed);
+  if (!stalled_.load(std::memory_order_acquire)) return;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    if (stall_end_ == 0) stall_end_ = now;
+  }
+  MaybeReport();
+}
+
+void LoopStallWatchdog::MaybeReport() {
+  std::string report;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    // Both the end of the stall and its JavaScript stack are needed, and
+    // either can come first.
+    if (!stalled_.load(std::memory_order_relaxed) || stall_end_ == 0 ||
+        !has_javascript_stack_) {
+      return;
+    }
+    report = SPrintF("(node:%d) WARNING: The event loop was blocked for %dms\n",
+                     uv_os_getpid(),
+                     (stall_end_ - stall_start_) / (1000 * 1000));
+    if (javascript_stack_.empty()) {
+      report += "JavaScript stack: none, the loop was blocked in native code\n";
+    } else {
+      report += "JavaScript stack:\n" + javascript_stack_;
+    }
+    if (!native_stack_.empty()) {
+      report += "Native stack:\n";
+      auto sym_ctx = NativeSymbolDebuggingContext::New();
+      for (size_t i = 0; i < native_stack_.size(); i++) {
+        void* frame = native_stack_[i];
+        report += SPrintF("%2d: %p %s\n",
+                          i + 1,
+                          frame,
+                          sym_ctx->LookupSymbol(frame).Display());
+      }
+    }
+    stalled_.store(false, std::memory_order_release);
+  }
+  FPrintF(stderr, "%s", report);
+  fflush(stderr);
+}
+
 
 SigintWatchdog::SigintWatchdog(
   v8::Isolate* isolate, bool* received_signal)
@@ -24,6 +24,8 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include <atomic>
+#include <string>
 #include <vector>
 #include "handle_wrap.h"
 #include "memory_tracker-inl.h"
@@ -67,6 +69,64 @@ class Watchdog {
   bool* timed_out_;
 };
 
+// Reports, for --trace-event-loop-stalls, when the event loop of an
+// Environment has not come round for threshold_ms. A thread of its own
+// notices the stall and takes the JavaScript stack of the main thread through
+// an interrupt and, on Linux, its native stack through a signal. The report
+// is printed once the loop comes round again, when the length of the stall
+// is known.
+class LoopStallWatchdog {
+ public:
+  LoopStallWatchdog(Environment* env, uint64_t threshold_ms);
+  ~LoopStallWatchdog();
+
+  // Stops the thread and closes the handles on the environment's loop.
+  void Close();
+
+ private:
+  LoopStallWatchdog(const LoopStallWatchdog&) = delete;
+  LoopStallWatchdog& operator=(const LoopStallWatchdog&) = delete;
+  LoopStallWatchdog(LoopStallWatchdog&&) = delete;
+  LoopStallWatchdog& operator=(LoopStallWatchdog&&) = delete;
+
+  static void Run(void* arg);
+  static void Check(uv_timer_t* timer);
+  void CaptureNativeStack();
+  void CaptureJavaScriptStack();
+  void Tick();
+  void MaybeReport();
+
+  Environment* env_;
+  const uint64_t threshold_ns_;
+#ifdef __POSIX__
+  pthread_t main_thread_;
+#endif
+  bool closed_ = false;
+
+  // On the loop of env_.
+  uv_prepare_t prepare_;
+  uv_timer_t heartbeat_;
+
+  // On the watchdog thread.
+  uv_thread_t thread_;
+  uv_loop_t loop_;
+  uv_async_t async_;
+  uv_timer_t timer_;
+
+  // uv_hrtime() of the last time the loop came round.
+  std::atomic<uint64_t> last_tick_;
+  // Set by the watchdog thread once it has taken the stacks of a stall.
+  std::atomic<bool> stalled_{false};
+
+  Mutex mutex_;
+  // Protected by mutex_.
+  uint64_t stall_start_ = 0;
+  uint64_t stall_end_ = 0;
+  bool has_javascript_stack_ = false;
+  std::string javascript_stack_;
+  std::vector<void*> native_stack_;
+};
+
 class SigintWatchdogBase {
  public:
   virtual ~SigintWatchdogBase() = default;
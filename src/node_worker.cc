@@ -50,6 +50,7 @@ using v8::ResourceConstraints;
 using v8::SealHandleScope;
 using v8::String;
 using v8::TryCatch;
+using v8::Uint32;
 using v8::Value;
 
 namespace node {
@@ -75,7 +76,8 @@ Worker::Worker(Environment* env,
       env_vars_(env_vars),
       embedder_preload_(env->embedder_preload()),
       snapshot_data_(snapshot_data),
-      is_internal_(is_internal) {
+      is_internal_(is_internal),
+      isolate_pool_(env->worker_isolate_pool()) {
   Debug(this, "Creating new worker instance with thread id %llu",
         thread_id_.id);
 
@@ -157,6 +159,128 @@ void Worker::UpdateResourceConstraints(ResourceConstraints* constraints) {
   }
 }
 
+IsolatePool::IsolatePool(MultiIsolatePlatform* platform,
+                         const SnapshotData* snapshot_data)
+    : platform_(platform), snapshot_data_(snapshot_data) {}
+
+IsolatePool::~IsolatePool() {
+  CHECK(!thread_.has_value());
+  CHECK(ready_.empty());
+}
+
+int IsolatePool::InitLoop(uv_loop_t* loop) {
+  int ret = uv_loop_init(loop);
+  if (ret != 0) return ret;
+  uv_loop_configure(loop, UV_METRICS_IDLE_TIME);
+  Mutex::ScopedLock lock(per_process::cli_options_mutex);
+  if (per_process::cli_options->io_uring)
+    uv_loop_configure(loop, UV_LOOP_USE_IO_URING_SQPOLL);
+  return 0;
+}
+
+void IsolatePool::SetSize(size_t size) {
+  std::deque<std::unique_ptr<Entry>> surplus;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    CHECK(!stopping_);
+    size_ = size;
+    while (ready_.size() > size_) {
+      surplus.push_back(std::move(ready_.back()));
+      ready_.pop_back();
+    }
+    cond_.Signal(lock);
+  }
+  for (std::unique_ptr<Entry>& entry : surplus) DisposeEntry(std::move(entry));
+
+  if (size > 0 && !thread_.has_value()) {
+    uv_thread_t tid;
+    CHECK_EQ(uv_thread_create(&tid, ThreadMain, this), 0);
+    thread_ = tid;
+  }
+}
+
+std::unique_ptr<IsolatePool::Entry> IsolatePool::Take() {
+  Mutex::ScopedLock lock(mutex_);
+  if (ready_.empty()) return nullptr;
+  std::unique_ptr<Entry> entry = std::move(ready_.front());
+  ready_.pop_front();
+  // Let the background thread replace it.
+  cond_.Signal(lock);
+  return entry;
+}
+
+void IsolatePool::Shutdown() {
+  {
+    Mutex::ScopedLock lock(mutex_);
+    stopping_ = true;
+    cond_.Signal(lock);
+  }
+  if (thread_.has_value()) {
+    CHECK_EQ(uv_thread_join(&thread_.value()), 0);
+    thread_.reset();
+  }
+
+  std::deque<std::unique_ptr<Entry>> ready;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    ready.swap(ready_);
+  }
+  for (std::unique_ptr<Entry>& entry : ready) DisposeEntry(std::move(entry));
+}
+
+void IsolatePool::ThreadMain(void* arg) {
+  uv_thread_setname("IsolatePool");
+  IsolatePool* pool = static_cast<IsolatePool*>(arg);
+  Mutex::ScopedLock lock(pool->mutex_);
+  while (!pool->stopping_) {
+    if (pool->ready_.size() >= pool->size_) {
+      pool->cond_.Wait(lock);
+      continue;
+    }
+
+    std::unique_ptr<Entry> entry;
+    {
+      Mutex::ScopedUnlock unlock(lock);
+      entry = pool->CreateEntry();
+    }
+    // Workers fall back to creating their own Isolate. Do not keep retrying
+    // if that is failing anyway.
+    if (!entry) break;
+    pool->ready_.push_back(std::move(entry));
+  }
+}
+
+std::unique_ptr<IsolatePool::Entry> IsolatePool::CreateEntry() {
+  auto entry = std::make_unique<Entry>();
+  if (InitLoop(&entry->loop) != 0) return nullptr;
+
+  // This matches what WorkerThreadData does for a Worker without custom
+  // resourceLimits. The stack limit is set once the Worker thread first
+  // locks the Isolate.
+  entry->allocator = ArrayBufferAllocator::Create();
+  Isolate::CreateParams params;
+  SetIsolateCreateParamsForNode(&params);
+  params.array_buffer_allocator_shared = entry->allocator;
+  entry->isolate = NewIsolate(&params, &entry->loop, platform_, snapshot_data_);
+  if (entry->isolate == nullptr) {
+    CheckedUvLoopClose(&entry->loop);
+    return nullptr;
+  }
+  return entry;
+}
+
+void IsolatePool::DisposeEntry(std::unique_ptr<Entry> entry) {
+  bool platform_finished = false;
+  platform_->AddIsolateFinishedCallback(entry->isolate, [](void* data) {
+    *static_cast<bool*>(data) = true;
+  }, &platform_finished);
+  platform_->DisposeIsolate(entry->isolate);
+  while (!platform_finished) {
+    uv_run(&entry->loop, UV_RUN_ONCE);
+  }
+  CheckedUvLoopClose(&entry->loop);
+}
+
 // This class contains data that is only relevant to the child thread itself,
 // and only while it is running.
 // (Eventually, the Environment instance should probably also be moved here.)
@@ -164,25 +288,38 @@ class WorkerThreadData {
  public:
   explicit WorkerThreadData(Worker* w)
     : w_(w) {
-    int ret = uv_loop_init(&loop_);
-    if (ret != 0) {
-      char err_buf[128];
-      uv_err_name_r(ret, err_buf, sizeof(err_buf));
-      // TODO(joyeecheung): maybe this should be kBootstrapFailure instead?
-      w->Exit(ExitCode::kGenericUserError, "ERR_WORKER_INIT_FAILED", err_buf);
-      return;
+    bool custom_heap_limits =
+        w->resource_limits_[kMaxYoungGenerationSizeMb] > 0 ||
+        w->resource_limits_[kMaxOldGenerationSizeMb] > 0 ||
+        w->resource_limits_[kCodeRangeSizeMb] > 0;
+    if (w->isolate_pool_ && !custom_heap_limits)
+      isolate_entry_ = w->isolate_pool_->Take();
+    bool from_pool = isolate_entry_ != nullptr;
+
+    if (!from_pool) {
+      isolate_entry_ = std::make_unique<IsolatePool::Entry>();
+      int ret = IsolatePool::InitLoop(&isolate_entry_->loop);
+      if (ret != 0) {
+        char err_buf[128];
+        uv_err_name_r(ret, err_buf, sizeof(err_buf));
+        // TODO(joyeecheung): maybe this should be kBootstrapFailure instead?
+        w->Exit(
+            ExitCode::kGenericUserError, "ERR_WORKER_INIT_FAILED", err_buf);
+        return;
+      }
     }
     loop_init_failed_ = false;
-    uv_loop_configure(&loop_, UV_METRICS_IDLE_TIME);
 
-    std::shared_ptr<ArrayBufferAllocator> allocator =
-        ArrayBufferAllocator::Create();
     Isolate::CreateParams params;
     SetIsolateCreateParamsForNode(&params);
     w->UpdateResourceConstraints(&params.constraints);
-    params.array_buffer_allocator_shared = allocator;
-    Isolate* isolate =
-        NewIsolate(&params, &loop_, w->platform_, w->snapshot_data());
+    if (!from_pool) {
+      isolate_entry_->allocator = ArrayBufferAllocator::Create();
+      params.array_buffer_allocator_shared = isolate_entry_->allocator;
+      isolate_entry_->isolate = NewIsolate(
+          &params, &isolate_entry_->loop, w->platform_, w->snapshot_data());
+    }
+    Isolate* isolate = isolate_entry_->isolate;
     if (isolate == nullptr) {
       // TODO(joyeecheung): maybe this should be kBootstrapFailure instead?
       w->Exit(ExitCode::kGenericUserError,
@@ -208,9 +345,9 @@ class WorkerThreadData {
       HandleScope handle_scope(isolate);
       isolate_data_.reset(IsolateData::CreateIsolateData(
           isolate,
-          &loop_,
+          &isolate_entry_->loop,
           w_->platform_,
-          allocator.get(),
+          isolate_entry_->allocator.get(),
           w->snapshot_data()->AsEmbedderWrapper().get(),
           std::move(w_->per_isolate_opts_)));
       CHECK(isolate_data_);
@@ -253,11 +390,11 @@ class WorkerThreadData {
 
       // Wait until the platform has cleaned up all relevant resources.
       while (!platform_finished) {
-        uv_run(&loop_, UV_RUN_ONCE);
+        uv_run(&isolate_entry_->loop, UV_RUN_ONCE);
       }
     }
     if (!loop_init_failed_) {
-      CheckedUvLoopClose(&loop_);
+      CheckedUvLoopClose(&isolate_entry_->loop);
     }
   }
 
@@ -265,7 +402,8 @@ class WorkerThreadData {
 
  private:
   Worker* const w_;
-  uv_loop_t loop_;
+  // Either taken from the parent's IsolatePool or created by the constructor.
+  std::unique_ptr<IsolatePool::Entry> isolate_entry_;
   bool loop_init_failed_ = true;
   DeleteFnPtr<IsolateData, FreeIsolateData> isolate_data_;
   friend class Worker;
@@ -1468,6 +1606,24 @@ void GetEnvMessagePort(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+// Sets how many Isolates are kept ready for new Workers started from this
+// thread. See IsolatePool.
+void SetIsolatePoolSize(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  uint32_t size = args[0].As<Uint32>()->Value();
+  if (env->is_stopping()) return;
+
+  std::shared_ptr<IsolatePool> pool = env->worker_isolate_pool();
+  if (!pool) {
+    if (size == 0) return;
+    pool = std::make_shared<IsolatePool>(env->isolate_data()->platform(),
+                                         env->isolate_data()->snapshot_data());
+    env->set_worker_isolate_pool(pool);
+  }
+  pool->SetSize(size);
+}
+
 void CreateWorkerPerIsolateProperties(IsolateData* isolate_data,
                                       Local<ObjectTemplate> target) {
   Isolate* isolate = isolate_data->isolate();
@@ -1568,6 +1724,7 @@ void CreateWorkerPerIsolateProperties(IsolateData* isolate_data,
   }
 
   SetMethod(isolate, target, "getEnvMessagePort", GetEnvMessagePort);
+  SetMethod(isolate, target, "setIsolatePoolSize", SetIsolatePoolSize);
 }
 
 void CreateWorkerPerContextProperties(Local<Object> target,
@@ -1632,6 +1789,7 @@ void CreateWorkerPerContextProperties(Local<Object> target,
 
 void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(GetEnvMessagePort);
+  registry->Register(SetIsolatePoolSize);
   registry->Register(Worker::New);
   registry->Register(Worker::StartThread);
   registry->Register(Worker::StopThread);
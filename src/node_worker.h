@@ -3,6 +3,7 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include <deque>
 #include <optional>
 #include <unordered_map>
 #include "json_utils.h"
@@ -25,6 +26,61 @@ enum ResourceLimits {
   kTotalResourceLimitCount
 };
 
+// Isolates for the future Workers of one parent thread, deserialized from
+// the parent's startup snapshot ahead of time on a background thread, so that
+// starting a Worker only leaves its Environment to be bootstrapped. Only
+// Workers without custom heap resourceLimits can use them, because heap
+// limits are fixed when an Isolate is created.
+class IsolatePool final {
+ public:
+  // A new Isolate, the event loop that it is registered to with the
+  // platform, and its ArrayBuffer allocator.
+  struct Entry {
+    uv_loop_t loop;
+    std::shared_ptr<ArrayBufferAllocator> allocator;
+    v8::Isolate* isolate = nullptr;
+  };
+
+  IsolatePool(MultiIsolatePlatform* platform,
+              const SnapshotData* snapshot_data);
+  ~IsolatePool();
+
+  IsolatePool(const IsolatePool&) = delete;
+  IsolatePool& operator=(const IsolatePool&) = delete;
+
+  // Keeps up to `size` Isolates ready, starting the background thread that
+  // creates them if necessary. Surplus ready Isolates are disposed.
+  void SetSize(size_t size);
+  size_t size() const;
+
+  // Returns a ready Isolate, or nullptr if there is none. May be called from
+  // any thread.
+  std::unique_ptr<Entry> Take();
+
+  // Stops the background thread and disposes all ready Isolates. Called by
+  // the parent Environment after all of its Workers have stopped.
+  void Shutdown();
+
+  // Sets up a Worker event loop. Returns a libuv error code.
+  static int InitLoop(uv_loop_t* loop);
+
+ private:
+  static void ThreadMain(void* arg);
+  std::unique_ptr<Entry> CreateEntry();
+  void DisposeEntry(std::unique_ptr<Entry> entry);
+
+  MultiIsolatePlatform* const platform_;
+  const SnapshotData* const snapshot_data_;
+  std::optional<uv_thread_t> thread_;
+
+  // This mutex protects access to all variables listed below it.
+  mutable Mutex mutex_;
+  ConditionVariable cond_;
+  std::deque<std::unique_ptr<Entry>> ready_;
+  size_t size_ = 0;
+  bool stopping_ = false;
+};
+
 // A worker thread, as represented in its parent thread.
 class Worker : public AsyncWrap {
  public:
@@ -141,6 +197,8 @@ class Worker : public AsyncWrap {
 
   const SnapshotData* snapshot_data_ = nullptr;
   const bool is_internal_;
+  // The parent Environment's pool of ready Isolates, if it has one.
+  std::shared_ptr<IsolatePool> isolate_pool_;
   friend class WorkerThreadData;
 };
 
@@ -24,7 +24,10 @@
 #include "node_buffer.h"
 
 #include "async_wrap-inl.h"
+#include "dataqueue/queue.h"
 #include "env-inl.h"
+#include "histogram-inl.h"
+#include "node_blob.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
 #include "threadpoolwork-inl.h"
@@ -40,15 +43,25 @@
 #include "zstd.h"
 #include "zstd_errors.h"
 
+#if HAVE_OPENSSL
+#include "ncrypto.h"
+#endif
+
 #include <sys/types.h>
 
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace node {
 
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::CFunction;
 using v8::Context;
@@ -59,8 +72,13 @@ using v8::HandleScope;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
+using v8::LocalVector;
+using v8::Name;
+using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::Uint32Array;
+using v8::Undefined;
 using v8::Value;
 
 namespace {
@@ -172,6 +190,879 @@ struct CompressionError {
   inline bool IsError() const { return code != nullptr; }
 };
 
+// The level() of decompression contexts.
+constexpr int kNoCompressionLevel = std::numeric_limits<int>::min();
+
+// Parameters a closed z_stream must have been created with to be reused.
+// window_bits includes the gzip and raw encodings, so the mode only needs to
+// tell deflate and inflate apart.
+struct ZlibPoolKey {
+  bool deflate;
+  int level;
+  int window_bits;
+  int mem_level;
+  int strategy;
+
+  bool operator==(const ZlibPoolKey& other) const = default;
+};
+
+// A per-process pool of the native state of closed streams, reset for reuse
+// by new streams, so that e.g. a server that compresses every response does
+// not allocate a new deflate window or zstd context for each of them. Shared
+// by all threads, as streams are initialized on the thread pool. Keeps up to
+// --compression-context-pool-size states per parameter set, 0 disables it.
+// Brotli has no way to reset an encoder or decoder instance, so its state is
+// not pooled.
+class CompressionContextPool {
+ public:
+  static size_t capacity();
+
+  // Returns nullptr if there is no pooled z_stream for `key`.
+  static std::unique_ptr<z_stream> TakeZlib(const ZlibPoolKey& key,
+                                            size_t* bytes);
+  // Takes ownership of `*strm`, which has been reset and holds `bytes` of
+  // memory, unless the pool is full.
+  static bool ReleaseZlib(const ZlibPoolKey& key,
+                          std::unique_ptr<z_stream>* strm,
+                          size_t bytes);
+
+  // Return a pooled context or a new one.
+  static ZSTD_CCtx* TakeZstdCompress();
+  static ZSTD_DCtx* TakeZstdDecompress();
+  // Pool or free the context.
+  static void ReleaseZstd(ZSTD_CCtx* cctx);
+  static void ReleaseZstd(ZSTD_DCtx* dctx);
+
+ private:
+  // Caps the memory that pooled states hold on to, in total.
+  static constexpr size_t kMaxPooledBytes = 64 * 1024 * 1024;
+
+  struct ZlibEntry {
+    ZlibPoolKey key;
+    std::unique_ptr<z_stream> strm;
+    size_t bytes;
+  };
+
+  struct State {
+    Mutex mutex;
+    std::vector<ZlibEntry> zlib;
+    std::vector<ZSTD_CCtx*> zstd_compress;
+    std::vector<ZSTD_DCtx*> zstd_decompress;
+    size_t pooled_bytes = 0;
+  };
+
+  static State* state() {
+    // Intentionally leaked, streams may be closed during process teardown.
+    static State* state = new State();
+    return state;
+  }
+
+  template <typename T>
+  static T* Take(std::vector<T*>* pool, size_t (*size)(const T*));
+  template <typename T>
+  static bool Release(std::vector<T*>* pool, T* ctx, size_t bytes);
+};
+
+size_t CompressionContextPool::capacity() {
+  static const size_t capacity = []() {
+    Mutex::ScopedLock lock(per_process::cli_options_mutex);
+    return static_cast<size_t>(
+        per_process::cli_options->compression_context_pool_size);
+  }();
+  return capacity;
+}
+
+std::unique_ptr<z_stream> CompressionContextPool::TakeZlib(
+    const ZlibPoolKey& key, size_t* bytes) {
+  State* pool = state();
+  Mutex::ScopedLock lock(pool->mutex);
+  for (auto it = pool->zlib.rbegin(); it != pool->zlib.rend(); ++it) {
+    if (it->key != key) continue;
+    std::unique_ptr<z_stream> strm = std::move(it->strm);
+    *bytes = it->bytes;
+    pool->pooled_bytes -= it->bytes;
+    pool->zlib.erase(std::next(it).base());
+    return strm;
+  }
+  return nullptr;
+}
+
+bool CompressionContextPool::ReleaseZlib(const ZlibPoolKey& key,
+                                         std::unique_ptr<z_stream>* strm,
+                                         size_t bytes) {
+  State* pool = state();
+  Mutex::ScopedLock lock(pool->mutex);
+  size_t count = 0;
+  for (const ZlibEntry& entry : pool->zlib) {
+    if (entry.key == key) count++;
+  }
+  if (count >= capacity() || pool->pooled_bytes + bytes > kMaxPooledBytes)
+    return false;
+  // Nothing allocates or frees through a pooled z_stream, and the stream
+  // whose functions these are may be gone until it is taken again.
+  (*strm)->zalloc = Z_NULL;
+  (*strm)->zfree = Z_NULL;
+  (*strm)->opaque = Z_NULL;
+  pool->zlib.push_back(ZlibEntry{key, std::move(*strm), bytes});
+  pool->pooled_bytes += bytes;
+  return true;
+}
+
+template <typename T>
+T* CompressionContextPool::Take(std::vector<T*>* contexts,
+                                size_t (*size)(const T*)) {
+  State* pool = state();
+  Mutex::ScopedLock lock(pool->mutex);
+  if (contexts->empty()) return nullptr;
+  T* ctx = contexts->back();
+  contexts->pop_back();
+  pool->pooled_bytes -= size(ctx);
+  return ctx;
+}
+
+template <typename T>
+bool CompressionContextPool::Release(std::vector<T*>* contexts,
+                                     T* ctx,
+                                     size_t bytes) {
+  State* pool = state();
+  Mutex::ScopedLock lock(pool->mutex);
+  if (contexts->size() >= capacity() ||
+      pool->pooled_bytes + bytes > kMaxPooledBytes) {
+    return false;
+  }
+  contexts->push_back(ctx);
+  pool->pooled_bytes += bytes;
+  return true;
+}
+
+ZSTD_CCtx* CompressionContextPool::TakeZstdCompress() {
+  ZSTD_CCtx* cctx = nullptr;
+  if (capacity() != 0)
+    cctx = Take(&state()->zstd_compress, ZSTD_sizeof_CCtx);
+  return cctx != nullptr ? cctx : ZSTD_createCCtx();
+}
+
+ZSTD_DCtx* CompressionContextPool::TakeZstdDecompress() {
+  ZSTD_DCtx* dctx = nullptr;
+  if (capacity() != 0)
+    dctx = Take(&state()->zstd_decompress, ZSTD_sizeof_DCtx);
+  return dctx != nullptr ? dctx : ZSTD_createDCtx();
+}
+
+void CompressionContextPool::ReleaseZstd(ZSTD_CCtx* cctx) {
+  // Resetting the parameters also drops a loaded dictionary.
+  if (capacity() == 0 ||
+      ZSTD_isError(ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters)) ||
+      !Release(&state()->zstd_compress, cctx, ZSTD_sizeof_CCtx(cctx))) {
+    ZSTD_freeCCtx(cctx);
+  }
+}
+
+void CompressionContextPool::ReleaseZstd(ZSTD_DCtx* dctx) {
+  if (capacity() == 0 ||
+      ZSTD_isError(ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters)) ||
+      !Release(&state()->zstd_decompress, dctx, ZSTD_sizeof_DCtx(dctx))) {
+    ZSTD_freeDCtx(dctx);
+  }
+}
+
+// Opt-in statistics of the work compression streams do, per algorithm and
+// level, so that levels can be tuned from production data. Process-wide, as
+// the streams of all threads share the thread pool. Off until
+// setStatsEnabled(true) is called, e.g. by perf_hooks; while off, the only
+// cost is one relaxed load per write.
+class CompressionStats {
+ public:
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Records one DoThreadPoolWork() call that took `time` ns. `new_context` is
+  // set for the first call after a stream was initialized or reset.
+  static void RecordWork(node_zlib_mode mode,
+                         int level,
+                         uint64_t bytes_in,
+                         uint64_t bytes_out,
+                         uint64_t time,
+                         bool new_context);
+
+  static void SetEnabled(const FunctionCallbackInfo<Value>& args);
+  // Returns an array of { mode, level, contexts, calls, bytesIn, bytesOut,
+  // time, timePerMiB }, where timePerMiB is a histogram of the ns per MiB of
+  // uncompressed data, and level is undefined for decompression.
+  static void GetStats(const FunctionCallbackInfo<Value>& args);
+  static void ResetStats(const FunctionCallbackInfo<Value>& args);
+
+ private:
+  // Bounds the memory held by histograms, zstd alone has ~150 levels.
+  static constexpr size_t kMaxEntries = 128;
+
+  struct Entry {
+    node_zlib_mode mode;
+    int level;
+    uint64_t contexts = 0;
+    uint64_t calls = 0;
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;
+    uint64_t time = 0;
+    std::shared_ptr<Histogram> time_per_mib =
+        std::make_shared<Histogram>(Histogram::Options{});
+  };
+
+  struct State {
+    Mutex mutex;
+    std::vector<Entry> entries;
+  };
+
+  static State* state() {
+    // Intentionally leaked, the thread pool may still be running at exit.
+    static State* state = new State();
+    return state;
+  }
+
+  static inline std::atomic<bool> enabled_{false};
+};
+
+void CompressionStats::RecordWork(node_zlib_mode mode,
+                                  int level,
+                                  uint64_t bytes_in,
+                                  uint64_t bytes_out,
+                                  uint64_t time,
+                                  bool new_context) {
+  bool compress = mode == DEFLATE || mode == GZIP || mode == DEFLATERAW ||
+                  mode == BROTLI_ENCODE || mode == ZSTD_COMPRESS;
+  uint64_t uncompressed = compress ? bytes_in : bytes_out;
+
+  State* stats = state();
+  Mutex::ScopedLock lock(stats->mutex);
+  auto it = std::find_if(
+      stats->entries.begin(), stats->entries.end(), [&](const Entry& entry) {
+        return entry.mode == mode && entry.level == level;
+      });
+  if (it == stats->entries.end()) {
+    if (stats->entries.size() >= kMaxEntries) return;
+    stats->entries.push_back(Entry{mode, level});
+    it = stats->entries.end() - 1;
+  }
+  if (new_context) it->contexts++;
+  it->calls++;
+  it->bytes_in += bytes_in;
+  it->bytes_out += bytes_out;
+  it->time += time;
+  // Calls that only flush or finish say nothing about throughput.
+  if (uncompressed > 0)
+    it->time_per_mib->Record((time << 20) / uncompressed + 1);
+}
+
+void CompressionStats::SetEnabled(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsBoolean());
+  enabled_.store(args[0]->IsTrue(), std::memory_order_relaxed);
+}
+
+void CompressionStats::GetStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  std::vector<Entry> entries;
+  {
+    State* stats = state();
+    Mutex::ScopedLock lock(stats->mutex);
+    entries = stats->entries;
+  }
+
+  LocalVector<Value> result(isolate);
+  for (const Entry& entry : entries) {
+    BaseObjectPtr<HistogramBase> histogram =
+        HistogramBase::Create(env, entry.time_per_mib);
+    if (!histogram) return;
+    Local<Value> level = Undefined(isolate);
+    if (entry.level != kNoCompressionLevel)
+      level = Integer::New(isolate, entry.level);
+    Local<Name> names[] = {
+        FIXED_ONE_BYTE_STRING(isolate, "mode"),
+        FIXED_ONE_BYTE_STRING(isolate, "level"),
+        FIXED_ONE_BYTE_STRING(isolate, "contexts"),
+        FIXED_ONE_BYTE_STRING(isolate, "calls"),
+        FIXED_ONE_BYTE_STRING(isolate, "bytesIn"),
+        FIXED_ONE_BYTE_STRING(isolate, "bytesOut"),
+        FIXED_ONE_BYTE_STRING(isolate, "time"),
+        FIXED_ONE_BYTE_STRING(isolate, "timePerMiB"),
+    };
+    Local<Value> values[] = {
+        Integer::New(isolate, entry.mode),
+        level,
+        Number::New(isolate, static_cast<double>(entry.contexts)),
+        Number::New(isolate, static_cast<double>(entry.calls)),
+        Number::New(isolate, static_cast<double>(entry.bytes_in)),
+        Number::New(isolate, static_cast<double>(entry.bytes_out)),
+        Number::New(isolate, static_cast<double>(entry.time)),
+        histogram->object(),
+    };
+    static_assert(arraysize(names) == arraysize(values));
+    result.push_back(Object::New(
+        isolate, Null(isolate), names, values, arraysize(names)));
+  }
+  args.GetReturnValue().Set(Array::New(isolate, result.data(), result.size()));
+}
+
+void CompressionStats::ResetStats(const FunctionCallbackInfo<Value>& args) {
+  State* stats = state();
+  Mutex::ScopedLock lock(stats->mutex);
+  stats->entries.clear();
+}
+
+// A shared compression dictionary, as used by Compression Dictionary
+// Transport, together with the zstd and brotli state prepared from it. One
+// instance exists per dictionary and process: Get() returns the existing one
+// for the same bytes, found by their SHA-256 digest, for as long as a stream
+// or JS object on any thread holds on to it, so that each stream using the
+// dictionary does not digest it again. The prepared state is created on first
+// use, as a dictionary is typically only used for one format and direction.
+class SharedCompressionDictionary {
+ public:
+  static std::shared_ptr<SharedCompressionDictionary> Get(
+      const uint8_t* data, size_t length);
+  ~SharedCompressionDictionary();
+
+  SharedCompressionDictionary(const SharedCompressionDictionary&) = delete;
+  SharedCompressionDictionary& operator=(const SharedCompressionDictionary&) =
+      delete;
+
+  const std::vector<uint8_t>& data() const { return data_; }
+  // The SHA-256 digest of data(), empty in builds without OpenSSL.
+  const std::string& digest() const { return digest_; }
+  // The memory held by the dictionary and its prepared zstd state.
+  size_t size() const;
+
+  // These return nullptr if the dictionary could not be prepared.
+  const ZSTD_CDict* GetZstdCDict(int level);
+  const ZSTD_DDict* GetZstdDDict();
+  const BrotliEncoderPreparedDictionary* GetBrotliDictionary();
+
+ private:
+  SharedCompressionDictionary(std::string key,
+                              std::string digest,
+                              std::vector<uint8_t>&& data)
+      : key_(std::move(key)),
+        digest_(std::move(digest)),
+        data_(std::move(data)) {}
+
+  struct Registry {
+    Mutex mutex;
+    std::unordered_map<std::string, std::weak_ptr<SharedCompressionDictionary>>
+        dictionaries;
+  };
+
+  static Registry* registry() {
+    // Intentionally leaked, streams may be closed during process teardown.
+    static Registry* registry = new Registry();
+    return registry;
+  }
+
+  // The digest, or the data itself without OpenSSL.
+  const std::string key_;
+  const std::string digest_;
+  const std::vector<uint8_t> data_;
+
+  mutable Mutex mutex_;
+  std::vector<std::pair<int, ZSTD_CDict*>> zstd_cdicts_;
+  ZSTD_DDict* zstd_ddict_ = nullptr;
+  BrotliEncoderPreparedDictionary* brotli_dictionary_ = nullptr;
+};
+
+std::shared_ptr<SharedCompressionDictionary> SharedCompressionDictionary::Get(
+    const uint8_t* data, size_t length) {
+  std::string digest;
+#if HAVE_OPENSSL
+  ncrypto::DataPointer hash =
+      ncrypto::hashDigest({data, length}, ncrypto::Digest::SHA256);
+  CHECK(hash);
+  digest.assign(hash.get<char>(), hash.size());
+  std::string key = digest;
+#else
+  std::string key(reinterpret_cast<const char*>(data), length);
+#endif
+
+  Registry* shared = registry();
+  Mutex::ScopedLock lock(shared->mutex);
+  std::weak_ptr<SharedCompressionDictionary>& entry =
+      shared->dictionaries[key];
+  std::shared_ptr<SharedCompressionDictionary> dictionary = entry.lock();
+  if (dictionary && dictionary->data_.size() == length &&
+      memcmp(dictionary->data_.data(), data, length) == 0) {
+    return dictionary;
+  }
+  dictionary.reset(new SharedCompressionDictionary(
+      std::move(key),
+      std::move(digest),
+      std::vector<uint8_t>(data, data + length)));
+  entry = dictionary;
+  return dictionary;
+}
+
+SharedCompressionDictionary::~SharedCompressionDictionary() {
+  {
+    Registry* shared = registry();
+    Mutex::ScopedLock lock(shared->mutex);
+    // Get() may have replaced the entry since the last reference was dropped.
+    auto it = shared->dictionaries.find(key_);
+    if (it != shared->dictionaries.end() && it->second.expired())
+      shared->dictionaries.erase(it);
+  }
+  for (const auto& [level, cdict] : zstd_cdicts_) ZSTD_freeCDict(cdict);
+  ZSTD_freeDDict(zstd_ddict_);
+  if (brotli_dictionary_ != nullptr)
+    BrotliEncoderDestroyPreparedDictionary(brotli_dictionary_);
+}
+
+size_t SharedCompressionDictionary::size() const {
+  Mutex::ScopedLock lock(mutex_);
+  size_t size = data_.size();
+  for (const auto& [level, cdict] : zstd_cdicts_)
+    size += ZSTD_sizeof_CDict(cdict);
+  if (zstd_ddict_ != nullptr) size += ZSTD_sizeof_DDict(zstd_ddict_);
+  return size;
+}
+
+const ZSTD_CDict* SharedCompressionDictionary::GetZstdCDict(int level) {
+  Mutex::ScopedLock lock(mutex_);
+  for (const auto& [cdict_level, cdict] : zstd_cdicts_) {
+    if (cdict_level == level) return cdict;
+  }
+  ZSTD_CDict* cdict = ZSTD_createCDict(data_.data(), data_.size(), level);
+  if (cdict != nullptr) zstd_cdicts_.emplace_back(level, cdict);
+  return cdict;
+}
+
+const ZSTD_DDict* SharedCompressionDictionary::GetZstdDDict() {
+  Mutex::ScopedLock lock(mutex_);
+  if (zstd_ddict_ == nullptr)
+    zstd_ddict_ = ZSTD_createDDict(data_.data(), data_.size());
+  return zstd_ddict_;
+}
+
+const BrotliEncoderPreparedDictionary*
+SharedCompressionDictionary::GetBrotliDictionary() {
+  Mutex::ScopedLock lock(mutex_);
+  // Prepared for the highest quality, which serves all the lower ones. It
+  // refers to data_ rather than copying it.
+  if (brotli_dictionary_ == nullptr) {
+    brotli_dictionary_ =
+        BrotliEncoderPrepareDictionary(BROTLI_SHARED_DICTIONARY_RAW,
+                                       data_.size(),
+                                       data_.data(),
+                                       BROTLI_MAX_QUALITY,
+                                       nullptr,
+                                       nullptr,
+                                       nullptr);
+  }
+  return brotli_dictionary_;
+}
+
+// The JS handle of a SharedCompressionDictionary, which the init() of zstd
+// and brotli streams accept in place of a dictionary buffer.
+class CompressionDictionary final : public BaseObject {
+ public:
+  CompressionDictionary(Environment* env,
+                        Local<Object> wrap,
+                        std::shared_ptr<SharedCompressionDictionary> dictionary)
+      : BaseObject(env, wrap), dictionary_(std::move(dictionary)) {
+    MakeWeak();
+  }
+
+  static Local<FunctionTemplate> GetConstructorTemplate(Environment* env);
+  static bool HasInstance(Environment* env, Local<Value> value) {
+    return GetConstructorTemplate(env)->HasInstance(value);
+  }
+
+  // new CompressionDictionary(data)
+  static void New(const FunctionCallbackInfo<Value>& args);
+  // Returns the SHA-256 digest of the dictionary as a Buffer, or undefined in
+  // builds without OpenSSL.
+  static void GetDigest(const FunctionCallbackInfo<Value>& args);
+
+  const std::shared_ptr<SharedCompressionDictionary>& dictionary() const {
+    return dictionary_;
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("dictionary", dictionary_->size());
+  }
+
+  SET_MEMORY_INFO_NAME(CompressionDictionary)
+  SET_SELF_SIZE(CompressionDictionary)
+
+ private:
+  std::shared_ptr<SharedCompressionDictionary> dictionary_;
+};
+
+Local<FunctionTemplate> CompressionDictionary::GetConstructorTemplate(
+    Environment* env) {
+  Local<FunctionTemplate> tmpl =
+      env->compressiondictionary_constructor_template();
+  if (tmpl.IsEmpty()) {
+    Isolate* isolate = env->isolate();
+    tmpl = NewFunctionTemplate(isolate, New);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(
+        BaseObject::kInternalFieldCount);
+    SetProtoMethodNoSideEffect(isolate, tmpl, "getDigest", GetDigest);
+    env->set_compressiondictionary_constructor_template(tmpl);
+  }
+  return tmpl;
+}
+
+void CompressionDictionary::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  if (!args[0]->IsArrayBufferView()) {
+    THROW_ERR_INVALID_ARG_TYPE(env, "dictionary must be an ArrayBufferView");
+    return;
+  }
+  ArrayBufferViewContents<uint8_t> contents(args[0]);
+  new CompressionDictionary(
+      env,
+      args.This(),
+      SharedCompressionDictionary::Get(contents.data(), contents.length()));
+}
+
+void CompressionDictionary::GetDigest(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CompressionDictionary* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.This());
+  const std::string& digest = wrap->dictionary_->digest();
+  if (digest.empty()) return;
+  Local<Object> buffer;
+  if (Buffer::Copy(env, digest.data(), digest.size()).ToLocal(&buffer))
+    args.GetReturnValue().Set(buffer);
+}
+
+// Compresses deflate, gzip and raw deflate streams pigz-style: the input is
+// collected into batches of kBlockSize blocks per thread, and the blocks of a
+// batch are compressed concurrently. Each block is a raw deflate stream primed
+// with the window of input that precedes it and ends in a sync flush, so that
+// the blocks can simply be concatenated, and their checksums are combined
+// with crc32_combine()/adler32_combine(). The result is a standard stream that
+// is slightly larger than a sequentially compressed one.
+class ParallelDeflate {
+ public:
+  ParallelDeflate(node_zlib_mode mode,
+                  int level,
+                  int window_bits,
+                  int mem_level,
+                  int strategy,
+                  size_t threads);
+  ~ParallelDeflate();
+
+  // Like deflate(), using the buffers of `strm`: consumes input and produces
+  // output until either the output buffer is full, or all of the input has
+  // been consumed and flushed as `flush` asks for.
+  int Process(z_stream* strm, int flush);
+  void Reset();
+  void SetParams(int level, int strategy);
+
+  ParallelDeflate(const ParallelDeflate&) = delete;
+  ParallelDeflate& operator=(const ParallelDeflate&) = delete;
+
+ private:
+  static constexpr size_t kBlockSize = 128 * 1024;
+
+  struct Block {
+    const Bytef* in;
+    size_t in_len;
+    const Bytef* dictionary;
+    size_t dictionary_len;
+    bool last;
+    std::vector<Bytef> out;
+    uLong check;
+    int err;
+  };
+
+  struct Worker {
+    ParallelDeflate* deflate;
+    z_stream strm;
+    bool initialized = false;
+    int level;
+    int strategy;
+  };
+
+  static void WorkerMain(void* arg);
+  void CompressBlock(Worker* worker, Block* block);
+  int CompressBatch(bool finish, bool full_flush);
+  void WriteHeader();
+  void WriteTrailer();
+  void Drain(z_stream* strm);
+
+  const node_zlib_mode mode_;
+  int level_;
+  const int window_bits_;  // Of the raw deflate blocks, 8 to 15.
+  const int mem_level_;
+  int strategy_;
+  const size_t batch_size_;
+
+  std::vector<Worker> workers_;
+  std::vector<Block> blocks_;
+  std::atomic<size_t> next_block_{0};
+
+  std::vector<Bytef> input_;
+  // The end of the input that preceded input_, the dictionary of its first
+  // block.
+  std::vector<Bytef> window_;
+  std::vector<Bytef> output_;
+  size_t output_offset_ = 0;
+  bool header_written_ = false;
+  bool finished_ = false;
+  uLong check_ = 0;
+  uLong total_in_ = 0;
+};
+
+ParallelDeflate::ParallelDeflate(node_zlib_mode mode,
+                                 int level,
+                                 int window_bits,
+                                 int mem_level,
+                                 int strategy,
+                                 size_t threads)
+    : mode_(mode),
+      level_(level),
+      window_bits_(window_bits),
+      mem_level_(mem_level),
+      strategy_(strategy),
+      batch_size_(threads * kBlockSize),
+      workers_(threads) {
+  for (Worker& worker : workers_) worker.deflate = this;
+  Reset();
+}
+
+ParallelDeflate::~ParallelDeflate() {
+  for (Worker& worker : workers_) {
+    if (worker.initialized) deflateEnd(&worker.strm);
+  }
+}
+
+void ParallelDeflate::Reset() {
+  input_.clear();
+  window_.clear();
+  output_.clear();
+  output_offset_ = 0;
+  header_written_ = false;
+  finished_ = false;
+  check_ = mode_ == GZIP ? crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0);
+  total_in_ = 0;
+}
+
+void ParallelDeflate::SetParams(int level, int strategy) {
+  level_ = level;
+  strategy_ = strategy;
+}
+
+void ParallelDeflate::WriteHeader() {
+  if (mode_ == GZIP) {
+    int level = level_ == Z_DEFAULT_COMPRESSION ? 6 : level_;
+    Bytef xfl = level == 9 ? 2 : (level == 1 ? 4 : 0);
+    // No file name and no modification time, OS "unknown", as zlib's
+    // deflate() writes it without a gz_header.
+    const Bytef header[] = {
+        GZIP_HEADER_ID1, GZIP_HEADER_ID2, Z_DEFLATED, 0, 0, 0, 0, 0, xfl, 0xff};
+    output_.insert(output_.end(), std::begin(header), std::end(header));
+  } else if (mode_ == DEFLATE) {
+    int level = level_ == Z_DEFAULT_COMPRESSION ? 6 : level_;
+    unsigned level_flags;
+    if (strategy_ >= Z_HUFFMAN_ONLY || level < 2)
+      level_flags = 0;
+    else if (level < 6)
+      level_flags = 1;
+    else if (level == 6)
+      level_flags = 2;
+    else
+      level_flags = 3;
+    unsigned header = (Z_DEFLATED + ((window_bits_ - 8) << 4)) << 8;
+    header |= level_flags << 6;
+    header += 31 - (header % 31);
+    output_.push_back(static_cast<Bytef>(header >> 8));
+    output_.push_back(static_cast<Bytef>(header & 0xff));
+  }
+  header_written_ = true;
+}
+
+void ParallelDeflate::WriteTrailer() {
+  if (mode_ == GZIP) {
+    // CRC-32 and the input size modulo 2^32, least significant byte first.
+    for (uLong value : {check_, total_in_}) {
+      for (int i = 0; i < 4; i++)
+        output_.push_back(static_cast<Bytef>((value >> (8 * i)) & 0xff));
+    }
+  } else if (mode_ == DEFLATE) {
+    // Adler-32, most significant byte first.
+    for (int i = 3; i >= 0; i--)
+      output_.push_back(static_cast<Bytef>((check_ >> (8 * i)) & 0xff));
+  }
+}
+
+void ParallelDeflate::CompressBlock(Worker* worker, Block* block) {
+  z_stream* strm = &worker->strm;
+  int err = Z_OK;
+  if (!worker->initialized) {
+    *strm = z_stream{};
+    err = deflateInit2(
+        strm, level_, Z_DEFLATED, -window_bits_, mem_level_, strategy_);
+    if (err != Z_OK) {
+      block->err = err;
+      return;
+    }
+    worker->initialized = true;
+    worker->level = level_;
+    worker->strategy = strategy_;
+  } else {
+    err = deflateReset(strm);
+    if (err == Z_OK &&
+        (worker->level != level_ || worker->strategy != strategy_)) {
+      err = deflateParams(strm, level_, strategy_);
+      worker->level = level_;
+      worker->strategy = strategy_;
+    }
+  }
+  if (err == Z_OK && block->dictionary_len > 0) {
+    err = deflateSetDictionary(
+        strm, block->dictionary, static_cast<uInt>(block->dictionary_len));
+  }
+  if (err != Z_OK) {
+    block->err = err;
+    return;
+  }
+
+  // Room for the sync flush marker beyond what deflateBound() reports.
+  block->out.resize(deflateBound(strm, block->in_len) + 16);
+  strm->next_in = const_cast<Bytef*>(block->in);
+  strm->avail_in = static_cast<uInt>(block->in_len);
+  strm->next_out = block->out.data();
+  strm->avail_out = static_cast<uInt>(block->out.size());
+  err = deflate(strm, block->last ? Z_FINISH : Z_SYNC_FLUSH);
+  if (block->last ? err != Z_STREAM_END : (err != Z_OK || strm->avail_in != 0))
+    block->err = err == Z_OK ? Z_BUF_ERROR : err;
+  block->out.resize(block->out.size() - strm->avail_out);
+
+  if (mode_ == GZIP) {
+    block->check = crc32(0, block->in, static_cast<uInt>(block->in_len));
+  } else if (mode_ == DEFLATE) {
+    block->check = adler32(1, block->in, static_cast<uInt>(block->in_len));
+  }
+}
+
+void ParallelDeflate::WorkerMain(void* arg) {
+  Worker* worker = static_cast<Worker*>(arg);
+  ParallelDeflate* deflate = worker->deflate;
+  for (;;) {
+    size_t index = deflate->next_block_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= deflate->blocks_.size()) return;
+    deflate->CompressBlock(worker, &deflate->blocks_[index]);
+  }
+}
+
+int ParallelDeflate::CompressBatch(bool finish, bool full_flush) {
+  const size_t window_size = size_t{1} << window_bits_;
+  size_t count = std::max<size_t>(
+      1, (input_.size() + kBlockSize - 1) / kBlockSize);
+  blocks_.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    Block& block = blocks_[i];
+    size_t start = i * kBlockSize;
+    block.in = input_.data() + start;
+    block.in_len = std::min(kBlockSize, input_.size() - start);
+    if (i == 0) {
+      block.dictionary = window_.data();
+      block.dictionary_len = window_.size();
+    } else {
+      block.dictionary_len = std::min(window_size, start);
+      block.dictionary = block.in - block.dictionary_len;
+    }
+    block.last = finish && i == count - 1;
+    block.err = Z_OK;
+  }
+
+  // This thread compresses blocks too.
+  next_block_.store(0, std::memory_order_relaxed);
+  size_t helpers = std::min(count, workers_.size()) - 1;
+  std::vector<uv_thread_t> threads(helpers);
+  size_t started = 0;
+  for (; started < helpers; started++) {
+    if (uv_thread_create(&threads[started], WorkerMain, &workers_[started + 1]))
+      break;
+  }
+  WorkerMain(&workers_[0]);
+  for (size_t i = 0; i < started; i++) CHECK_EQ(uv_thread_join(&threads[i]), 0);
+
+  if (!header_written_) WriteHeader();
+  for (Block& block : blocks_) {
+    if (block.err != Z_OK) return block.err;
+    output_.insert(output_.end(), block.out.begin(), block.out.end());
+    std::vector<Bytef>().swap(block.out);
+    if (mode_ == GZIP) {
+      check_ = crc32_combine(check_, block.check, block.in_len);
+    } else if (mode_ == DEFLATE) {
+      check_ = adler32_combine(check_, block.check, block.in_len);
+    }
+    total_in_ += block.in_len;
+  }
+
+  if (full_flush) {
+    window_.clear();
+  } else if (input_.size() >= window_size) {
+    window_.assign(input_.end() - window_size, input_.end());
+  } else {
+    window_.insert(window_.end(), input_.begin(), input_.end());
+    if (window_.size() > window_size)
+      window_.erase(window_.begin(), window_.end() - window_size);
+  }
+  input_.clear();
+
+  if (finish) {
+    WriteTrailer();
+    finished_ = true;
+  }
+  return Z_OK;
+}
+
+void ParallelDeflate::Drain(z_stream* strm) {
+  size_t len =
+      std::min<size_t>(strm->avail_out, output_.size() - output_offset_);
+  if (len == 0) return;
+  memcpy(strm->next_out, output_.data() + output_offset_, len);
+  strm->next_out += len;
+  strm->avail_out -= static_cast<uInt>(len);
+  strm->total_out += len;
+  output_offset_ += len;
+  if (output_offset_ == output_.size()) {
+    output_.clear();
+    output_offset_ = 0;
+  }
+}
+
+int ParallelDeflate::Process(z_stream* strm, int flush) {
+  for (;;) {
+    Drain(strm);
+    if (strm->avail_out == 0) return Z_OK;
+    if (finished_) return Z_STREAM_END;
+
+    size_t len = std::min<size_t>(strm->avail_in, batch_size_ - input_.size());
+    input_.insert(input_.end(), strm->next_in, strm->next_in + len);
+    strm->next_in += len;
+    strm->avail_in -= static_cast<uInt>(len);
+    strm->total_in += len;
+
+    int err = Z_OK;
+    if (strm->avail_in > 0 || input_.size() == batch_size_) {
+      // A full batch; the final one if the stream ends with it.
+      err = CompressBatch(flush == Z_FINISH && strm->avail_in == 0, false);
+    } else if (flush == Z_FINISH) {
+      err = CompressBatch(true, false);
+    } else if (flush != Z_NO_FLUSH && !input_.empty()) {
+      err = CompressBatch(false, flush == Z_FULL_FLUSH);
+    } else {
+      if (flush == Z_FULL_FLUSH) window_.clear();
+      return Z_OK;
+    }
+    if (err != Z_OK) return err;
+  }
+}
+
 class ZlibContext final : public MemoryRetainer {
  public:
   ZlibContext() = default;
@@ -184,13 +1075,27 @@ class ZlibContext final : public MemoryRetainer {
   void GetAfterWriteOffsets(uint32_t* avail_in, uint32_t* avail_out) const;
   CompressionError GetErrorInfo() const;
   inline void SetMode(node_zlib_mode mode) { mode_ = mode; }
+  inline node_zlib_mode mode() const { return mode_; }
+  inline int level() const {
+    return mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW
+               ? level_
+               : kNoCompressionLevel;
+  }
   CompressionError ResetStream();
 
   // Zlib-specific:
   void Init(int level, int window_bits, int mem_level, int strategy,
             std::vector<unsigned char>&& dictionary);
   void SetAllocationFunctions(alloc_func alloc, free_func free, void* opaque);
+  // How the memory of a pooled z_stream is moved out of and into the
+  // accounting of the stream that `opaque` belongs to.
+  void SetMemoryAccountingFunctions(size_t (*allocated)(void* opaque),
+                                    void (*account)(void* opaque,
+                                                    ssize_t bytes));
   CompressionError SetParams(int level, int strategy);
+  // Compresses with ParallelDeflate on `threads` threads from now on, if this
+  // is a deflate, gzip or raw deflate stream without a dictionary.
+  void EnableParallelDeflate(size_t threads);
 
   SET_MEMORY_INFO_NAME(ZlibContext)
   SET_SELF_SIZE(ZlibContext)
@@ -206,6 +1111,8 @@ class ZlibContext final : public MemoryRetainer {
   CompressionError ErrorForMessage(const char* message) const;
   CompressionError SetDictionary();
   bool InitZlib();
+  inline ZlibPoolKey pool_key() const;
+  bool ReleaseToPool();
 
   Mutex mutex_;  // Protects zlib_init_done_.
   bool zlib_init_done_ = false;
@@ -218,8 +1125,13 @@ class ZlibContext final : public MemoryRetainer {
   int window_bits_ = 0;
   unsigned int gzip_id_bytes_read_ = 0;
   std::vector<unsigned char> dictionary_;
+  size_t (*allocated_)(void* opaque) = nullptr;
+  void (*account_)(void* opaque, ssize_t bytes) = nullptr;
 
-  z_stream strm_;
+  // Heap allocated, zlib's state points back at it, so that it can be pooled.
+  std::unique_ptr<z_stream> strm_ = std::make_unique<z_stream>();
+  // If set, this compresses instead of strm_, which only holds the buffers.
+  std::unique_ptr<ParallelDeflate> parallel_;
 };
 
 // Brotli has different data types for compression and decompression streams,
@@ -232,12 +1144,19 @@ class BrotliContext : public MemoryRetainer {
   void SetFlush(int flush);
   void GetAfterWriteOffsets(uint32_t* avail_in, uint32_t* avail_out) const;
   inline void SetMode(node_zlib_mode mode) { mode_ = mode; }
+  inline node_zlib_mode mode() const { return mode_; }
+  // Attached to the state by Init() and ResetStream().
+  inline void SetSharedDictionary(
+      std::shared_ptr<SharedCompressionDictionary> dictionary) {
+    shared_dictionary_ = std::move(dictionary);
+  }
 
   BrotliContext(const BrotliContext&) = delete;
   BrotliContext& operator=(const BrotliContext&) = delete;
 
  protected:
   node_zlib_mode mode_ = NONE;
+  std::shared_ptr<SharedCompressionDictionary> shared_dictionary_;
   const uint8_t* next_in_ = nullptr;
   uint8_t* next_out_ = nullptr;
   size_t avail_in_ = 0;
@@ -261,6 +1180,7 @@ class BrotliEncoderContext final : public BrotliContext {
   CompressionError ResetStream();
   CompressionError SetParams(int key, uint32_t value);
   CompressionError GetErrorInfo() const;
+  inline int level() const { return quality_; }
 
   SET_MEMORY_INFO_NAME(BrotliEncoderContext)
   SET_SELF_SIZE(BrotliEncoderContext)
@@ -268,6 +1188,7 @@ class BrotliEncoderContext final : public BrotliContext {
 
  private:
   bool last_result_ = false;
+  int quality_ = BROTLI_DEFAULT_QUALITY;
   DeleteFnPtr<BrotliEncoderState, BrotliEncoderDestroyInstance> state_;
 };
 
@@ -281,6 +1202,7 @@ class BrotliDecoderContext final : public BrotliContext {
   CompressionError ResetStream();
   CompressionError SetParams(int key, uint32_t value);
   CompressionError GetErrorInfo() const;
+  inline int level() const { return kNoCompressionLevel; }
 
   SET_MEMORY_INFO_NAME(BrotliDecoderContext)
   SET_SELF_SIZE(BrotliDecoderContext)
@@ -303,12 +1225,18 @@ class ZstdContext : public MemoryRetainer {
   void SetFlush(int flush);
   void GetAfterWriteOffsets(uint32_t* avail_in, uint32_t* avail_out) const;
   CompressionError GetErrorInfo() const;
+  // Referenced by Init() and ResetStream() in place of a dictionary buffer.
+  inline void SetSharedDictionary(
+      std::shared_ptr<SharedCompressionDictionary> dictionary) {
+    shared_dictionary_ = std::move(dictionary);
+  }
 
   ZstdContext(const ZstdContext&) = delete;
   ZstdContext& operator=(const ZstdContext&) = delete;
 
  protected:
   ZSTD_EndDirective flush_ = ZSTD_e_continue;
+  std::shared_ptr<SharedCompressionDictionary> shared_dictionary_;
 
   ZSTD_inBuffer input_ = {nullptr, 0, 0};
   ZSTD_outBuffer output_ = {nullptr, 0, 0};
@@ -323,6 +1251,7 @@ class ZstdCompressContext final : public ZstdContext {
   ZstdCompressContext() = default;
 
   // Streaming-related, should be available for all compression libraries:
+  void Close();
   void DoThreadPoolWork();
   CompressionError ResetStream();
 
@@ -330,18 +1259,27 @@ class ZstdCompressContext final : public ZstdContext {
   CompressionError Init(uint64_t pledged_src_size,
                         std::string_view dictionary = {});
   CompressionError SetParameter(int key, int value);
+  inline node_zlib_mode mode() const { return ZSTD_COMPRESS; }
+  inline int level() const { return compression_level_; }
 
-  // Wrap ZSTD_freeCCtx to remove the return type.
-  static void FreeZstd(ZSTD_CCtx* cctx) { ZSTD_freeCCtx(cctx); }
+  // Returns the context to the pool, or frees it.
+  static void FreeZstd(ZSTD_CCtx* cctx) {
+    CompressionContextPool::ReleaseZstd(cctx);
+  }
 
   SET_MEMORY_INFO_NAME(ZstdCompressContext)
   SET_SELF_SIZE(ZstdCompressContext)
   SET_NO_MEMORY_INFO()
 
  private:
+  CompressionError RefSharedDictionary();
+
   DeleteFnPtr<ZSTD_CCtx, ZstdCompressContext::FreeZstd> cctx_;
 
   uint64_t pledged_src_size_ = ZSTD_CONTENTSIZE_UNKNOWN;
+  // The parameters of a prepared dictionary take precedence over those of
+  // the context, so its level has to match.
+  int compression_level_ = ZSTD_CLEVEL_DEFAULT;
 };
 
 class ZstdDecompressContext final : public ZstdContext {
@@ -349,6 +1287,7 @@ class ZstdDecompressContext final : public ZstdContext {
   ZstdDecompressContext() = default;
 
   // Streaming-related, should be available for all compression libraries:
+  void Close();
   void DoThreadPoolWork();
   CompressionError ResetStream();
 
@@ -357,9 +1296,13 @@ class ZstdDecompressContext final : public ZstdContext {
                         std::string_view dictionary = {});
 
   CompressionError SetParameter(int key, int value);
+  inline node_zlib_mode mode() const { return ZSTD_DECOMPRESS; }
+  inline int level() const { return kNoCompressionLevel; }
 
-  // Wrap ZSTD_freeDCtx to remove the return type.
-  static void FreeZstd(ZSTD_DCtx* dctx) { ZSTD_freeDCtx(dctx); }
+  // Returns the context to the pool, or frees it.
+  static void FreeZstd(ZSTD_DCtx* dctx) {
+    CompressionContextPool::ReleaseZstd(dctx);
+  }
 
   SET_MEMORY_INFO_NAME(ZstdDecompressContext)
   SET_SELF_SIZE(ZstdDecompressContext)
@@ -509,7 +1452,24 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
   // for a single write() call, until all of the input bytes have
   // been consumed.
   void DoThreadPoolWork() override {
+    if (!CompressionStats::enabled()) [[likely]] {
+      ctx_.DoThreadPoolWork();
+      return;
+    }
+
+    uint32_t avail_in_before, avail_out_before, avail_in, avail_out;
+    ctx_.GetAfterWriteOffsets(&avail_in_before, &avail_out_before);
+    uint64_t start = uv_hrtime();
     ctx_.DoThreadPoolWork();
+    uint64_t time = uv_hrtime() - start;
+    ctx_.GetAfterWriteOffsets(&avail_in, &avail_out);
+    CompressionStats::RecordWork(ctx_.mode(),
+                                 ctx_.level(),
+                                 avail_in_before - avail_in,
+                                 avail_out_before - avail_out,
+                                 time,
+                                 !stats_context_recorded_);
+    stats_context_recorded_ = true;
   }
 
 
@@ -579,6 +1539,7 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
     ASSIGN_OR_RETURN_UNWRAP(&wrap, args.This());
 
     AllocScope alloc_scope(wrap);
+    wrap->stats_context_recorded_ = false;
     const CompressionError err = wrap->context()->ResetStream();
     if (err.IsError())
       wrap->EmitError(err);
@@ -615,6 +1576,18 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
   static constexpr size_t reserveSizeAndAlign =
       std::max(sizeof(size_t), alignof(max_align_t));
 
+  // The memory zlib has allocated through this stream. Main thread only.
+  static size_t AllocatedForZlib(void* data) {
+    CompressionStream* ctx = static_cast<CompressionStream*>(data);
+    return ctx->zlib_memory_ +
+           ctx->unreported_allocations_.load(std::memory_order_relaxed);
+  }
+
+  static void AccountForZlib(void* data, ssize_t bytes) {
+    CompressionStream* ctx = static_cast<CompressionStream*>(data);
+    ctx->unreported_allocations_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
   static void* AllocForBrotli(void* data, size_t size) {
     size += reserveSizeAndAlign;
     CompressionStream* ctx = static_cast<CompressionStream*>(data);
@@ -680,6 +1653,8 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
   uint32_t* write_result_ = nullptr;
   std::atomic<ssize_t> unreported_allocations_{0};
   size_t zlib_memory_ = 0;
+  // Whether CompressionStats has counted the current native context.
+  bool stats_context_recorded_ = false;
 
   CompressionContext ctx_;
 };
@@ -756,8 +1731,12 @@ class ZlibStream final : public CompressionStream<ZlibContext> {
     AllocScope alloc_scope(wrap);
     wrap->context()->SetAllocationFunctions(
         AllocForZlib, FreeForZlib, static_cast<CompressionStream*>(wrap));
+    wrap->context()->SetMemoryAccountingFunctions(AllocatedForZlib,
+                                                  AccountForZlib);
     wrap->context()->Init(level, window_bits, mem_level, strategy,
                           std::move(dictionary));
+    wrap->context()->EnableParallelDeflate(
+        wrap->env()->options()->zlib_parallel_threads);
   }
 
   static void Params(const FunctionCallbackInfo<Value>& args) {
@@ -806,7 +1785,8 @@ class BrotliCompressionStream final :
   static void Init(const FunctionCallbackInfo<Value>& args) {
     BrotliCompressionStream* wrap;
     ASSIGN_OR_RETURN_UNWRAP(&wrap, args.This());
-    CHECK(args.Length() == 3 && "init(params, writeResult, writeCallback)");
+    CHECK((args.Length() == 3 || args.Length() == 4) &&
+          "init(params, writeResult, writeCallback[, dictionary])");
 
     CHECK(args[1]->IsUint32Array());
     uint32_t* write_result = reinterpret_cast<uint32_t*>(Buffer::Data(args[1]));
@@ -815,6 +1795,18 @@ class BrotliCompressionStream final :
     Local<Function> write_js_callback = args[2].As<Function>();
     wrap->InitStream(write_result, write_js_callback);
 
+    if (args.Length() == 4 && !args[3]->IsUndefined()) {
+      if (!CompressionDictionary::HasInstance(wrap->env(), args[3])) {
+        THROW_ERR_INVALID_ARG_TYPE(
+            wrap->env(),
+            "dictionary must be a CompressionDictionary if provided");
+        return;
+      }
+      CompressionDictionary* dictionary;
+      ASSIGN_OR_RETURN_UNWRAP(&dictionary, args[3]);
+      wrap->context()->SetSharedDictionary(dictionary->dictionary());
+    }
+
     AllocScope alloc_scope(wrap);
     CompressionError err =
         wrap->context()->Init(
@@ -916,13 +1908,20 @@ class ZstdStream final : public CompressionStream<CompressionContext> {
     std::string_view dictionary;
     ArrayBufferViewContents<char> contents;
     if (args.Length() == 5 && !args[4]->IsUndefined()) {
-      if (!args[4]->IsArrayBufferView()) {
+      if (CompressionDictionary::HasInstance(wrap->env(), args[4])) {
+        CompressionDictionary* shared;
+        ASSIGN_OR_RETURN_UNWRAP(&shared, args[4]);
+        wrap->context()->SetSharedDictionary(shared->dictionary());
+      } else if (args[4]->IsArrayBufferView()) {
+        contents.ReadValue(args[4]);
+        dictionary = std::string_view(contents.data(), contents.length());
+      } else {
         THROW_ERR_INVALID_ARG_TYPE(
-            wrap->env(), "dictionary must be an ArrayBufferView if provided");
+            wrap->env(),
+            "dictionary must be an ArrayBufferView or a CompressionDictionary "
+            "if provided");
         return;
       }
-      contents.ReadValue(args[4]);
-      dictionary = std::string_view(contents.data(), contents.length());
     }
 
     CompressionError err = wrap->context()->Init(pledged_src_size, dictionary);
@@ -963,6 +1962,7 @@ using ZstdCompressStream = ZstdStream<ZstdCompressContext>;
 using ZstdDecompressStream = ZstdStream<ZstdDecompressContext>;
 
 void ZlibContext::Close() {
+  parallel_.reset();
   {
     Mutex::ScopedLock lock(mutex_);
     if (!zlib_init_done_) {
@@ -974,12 +1974,18 @@ void ZlibContext::Close() {
 
   CHECK_LE(mode_, UNZIP);
 
+  if (ReleaseToPool()) {
+    mode_ = NONE;
+    dictionary_.clear();
+    return;
+  }
+
   int status = Z_OK;
   if (mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW) {
-    status = deflateEnd(&strm_);
+    status = deflateEnd(strm_.get());
   } else if (mode_ == INFLATE || mode_ == GUNZIP || mode_ == INFLATERAW ||
              mode_ == UNZIP) {
-    status = inflateEnd(&strm_);
+    status = inflateEnd(strm_.get());
   }
 
   CHECK(status == Z_OK || status == Z_DATA_ERROR);
@@ -990,6 +1996,11 @@ void ZlibContext::Close() {
 
 
 void ZlibContext::DoThreadPoolWork() {
+  if (parallel_) {
+    err_ = parallel_->Process(strm_.get(), flush_);
+    return;
+  }
+
   bool first_init_call = InitZlib();
   if (first_init_call && err_ != Z_OK) {
     return;
@@ -1004,11 +2015,11 @@ void ZlibContext::DoThreadPoolWork() {
     case DEFLATE:
     case GZIP:
     case DEFLATERAW:
-      err_ = deflate(&strm_, flush_);
+      err_ = deflate(strm_.get(), flush_);
       break;
     case UNZIP:
-      if (strm_.avail_in > 0) {
-        next_expected_header_byte = strm_.next_in;
+      if (strm_->avail_in > 0) {
+        next_expected_header_byte = strm_->next_in;
       }
 
       switch (gzip_id_bytes_read_) {
@@ -1021,7 +2032,7 @@ void ZlibContext::DoThreadPoolWork() {
             gzip_id_bytes_read_ = 1;
             next_expected_header_byte++;
 
-            if (strm_.avail_in == 1) {
+            if (strm_->avail_in == 1) {
               // The only available byte was already read.
               break;
             }
@@ -1054,7 +2065,7 @@ void ZlibContext::DoThreadPoolWork() {
     case INFLATE:
     case GUNZIP:
     case INFLATERAW:
-      err_ = inflate(&strm_, flush_);
+      err_ = inflate(strm_.get(), flush_);
 
       // If data was encoded with dictionary (INFLATERAW will have it set in
       // SetDictionary, don't repeat that here)
@@ -1062,12 +2073,12 @@ void ZlibContext::DoThreadPoolWork() {
           err_ == Z_NEED_DICT &&
           !dictionary_.empty()) {
         // Load it
-        err_ = inflateSetDictionary(&strm_,
+        err_ = inflateSetDictionary(strm_.get(),
                                     dictionary_.data(),
                                     dictionary_.size());
         if (err_ == Z_OK) {
           // And try to decode again
-          err_ = inflate(&strm_, flush_);
+          err_ = inflate(strm_.get(), flush_);
         } else if (err_ == Z_DATA_ERROR) {
           // Both inflateSetDictionary() and inflate() return Z_DATA_ERROR.
           // Make it possible for After() to tell a bad dictionary from bad
@@ -1076,17 +2087,17 @@ void ZlibContext::DoThreadPoolWork() {
         }
       }
 
-      while (strm_.avail_in > 0 &&
+      while (strm_->avail_in > 0 &&
              mode_ == GUNZIP &&
              err_ == Z_STREAM_END &&
-             strm_.next_in[0] != 0x00) {
+             strm_->next_in[0] != 0x00) {
         // Bytes remain in input buffer. Perhaps this is another compressed
         // member in the same archive, or just trailing garbage.
         // Trailing zero bytes are okay, though, since they are frequently
         // used for padding.
 
         ResetStream();
-        err_ = inflate(&strm_, flush_);
+        err_ = inflate(strm_.get(), flush_);
       }
       break;
     default:
@@ -1097,10 +2108,10 @@ void ZlibContext::DoThreadPoolWork() {
 
 void ZlibContext::SetBuffers(const char* in, uint32_t in_len,
                              char* out, uint32_t out_len) {
-  strm_.avail_in = in_len;
-  strm_.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(in));
-  strm_.avail_out = out_len;
-  strm_.next_out = reinterpret_cast<Bytef*>(out);
+  strm_->avail_in = in_len;
+  strm_->next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(in));
+  strm_->avail_out = out_len;
+  strm_->next_out = reinterpret_cast<Bytef*>(out);
 }
 
 
@@ -1111,14 +2122,14 @@ void ZlibContext::SetFlush(int flush) {
 
 void ZlibContext::GetAfterWriteOffsets(uint32_t* avail_in,
                                        uint32_t* avail_out) const {
-  *avail_in = strm_.avail_in;
-  *avail_out = strm_.avail_out;
+  *avail_in = strm_->avail_in;
+  *avail_out = strm_->avail_out;
 }
 
 
 CompressionError ZlibContext::ErrorForMessage(const char* message) const {
-  if (strm_.msg != nullptr)
-    message = strm_.msg;
+  if (strm_->msg != nullptr)
+    message = strm_->msg;
 
   return CompressionError { message, ZlibStrerror(err_), err_ };
 }
@@ -1129,7 +2140,7 @@ CompressionError ZlibContext::GetErrorInfo() const {
   switch (err_) {
   case Z_OK:
   case Z_BUF_ERROR:
-    if (strm_.avail_out != 0 && flush_ == Z_FINISH) {
+    if (strm_->avail_out != 0 && flush_ == Z_FINISH) {
       return ErrorForMessage("unexpected end of file");
     }
   case Z_STREAM_END:
@@ -1150,6 +2161,12 @@ CompressionError ZlibContext::GetErrorInfo() const {
 
 
 CompressionError ZlibContext::ResetStream() {
+  if (parallel_) {
+    parallel_->Reset();
+    err_ = Z_OK;
+    return CompressionError {};
+  }
+
   bool first_init_call = InitZlib();
   if (first_init_call && err_ != Z_OK) {
     return ErrorForMessage("Failed to init stream before reset");
@@ -1161,12 +2178,12 @@ CompressionError ZlibContext::ResetStream() {
     case DEFLATE:
     case DEFLATERAW:
     case GZIP:
-      err_ = deflateReset(&strm_);
+      err_ = deflateReset(strm_.get());
       break;
     case INFLATE:
     case INFLATERAW:
     case GUNZIP:
-      err_ = inflateReset(&strm_);
+      err_ = inflateReset(strm_.get());
       break;
     default:
       break;
@@ -1182,9 +2199,44 @@ CompressionError ZlibContext::ResetStream() {
 void ZlibContext::SetAllocationFunctions(alloc_func alloc,
                                          free_func free,
                                          void* opaque) {
-  strm_.zalloc = alloc;
-  strm_.zfree = free;
-  strm_.opaque = opaque;
+  strm_->zalloc = alloc;
+  strm_->zfree = free;
+  strm_->opaque = opaque;
+}
+
+
+void ZlibContext::SetMemoryAccountingFunctions(
+    size_t (*allocated)(void* opaque),
+    void (*account)(void* opaque, ssize_t bytes)) {
+  allocated_ = allocated;
+  account_ = account;
+}
+
+
+ZlibPoolKey ZlibContext::pool_key() const {
+  if (mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW)
+    return ZlibPoolKey{true, level_, window_bits_, mem_level_, strategy_};
+  // UNZIP may have turned into GUNZIP or INFLATE by now, but window_bits_
+  // still says that the header is auto-detected.
+  return ZlibPoolKey{false, 0, window_bits_, 0, 0};
+}
+
+
+bool ZlibContext::ReleaseToPool() {
+  if (CompressionContextPool::capacity() == 0 || allocated_ == nullptr)
+    return false;
+
+  ZlibPoolKey key = pool_key();
+  int status =
+      key.deflate ? deflateReset(strm_.get()) : inflateReset(strm_.get());
+  if (status != Z_OK) return false;
+
+  void* opaque = strm_->opaque;
+  size_t bytes = allocated_(opaque);
+  if (!CompressionContextPool::ReleaseZlib(key, &strm_, bytes)) return false;
+  account_(opaque, -static_cast<ssize_t>(bytes));
+  strm_ = std::make_unique<z_stream>();
+  return true;
 }
 
 
@@ -1235,17 +2287,64 @@ void ZlibContext::Init(
   dictionary_ = std::move(dictionary);
 }
 
+void ZlibContext::EnableParallelDeflate(size_t threads) {
+  static constexpr size_t kMaxThreads = 64;
+  if (threads < 2 || !dictionary_.empty()) return;
+
+  int raw_window_bits;
+  switch (mode_) {
+    case DEFLATE:
+      raw_window_bits = window_bits_;
+      break;
+    case GZIP:
+      raw_window_bits = window_bits_ - 16;
+      break;
+    case DEFLATERAW:
+      raw_window_bits = -window_bits_;
+      break;
+    default:
+      return;
+  }
+  // zlib itself turns a window of 8 bits into 9 bits for raw deflate.
+  if (raw_window_bits < 9) return;
+
+  parallel_ = std::make_unique<ParallelDeflate>(mode_,
+                                                level_,
+                                                raw_window_bits,
+                                                mem_level_,
+                                                strategy_,
+                                                std::min(threads, kMaxThreads));
+}
+
+
 bool ZlibContext::InitZlib() {
   Mutex::ScopedLock lock(mutex_);
   if (zlib_init_done_) {
     return false;
   }
 
+  if (CompressionContextPool::capacity() != 0 && account_ != nullptr) {
+    size_t bytes;
+    std::unique_ptr<z_stream> pooled =
+        CompressionContextPool::TakeZlib(pool_key(), &bytes);
+    if (pooled) {
+      pooled->zalloc = strm_->zalloc;
+      pooled->zfree = strm_->zfree;
+      pooled->opaque = strm_->opaque;
+      strm_ = std::move(pooled);
+      account_(strm_->opaque, static_cast<ssize_t>(bytes));
+      err_ = Z_OK;
+      SetDictionary();
+      zlib_init_done_ = true;
+      return true;
+    }
+  }
+
   switch (mode_) {
     case DEFLATE:
     case GZIP:
     case DEFLATERAW:
-      err_ = deflateInit2(&strm_,
+      err_ = deflateInit2(strm_.get(),
                           level_,
                           Z_DEFLATED,
                           window_bits_,
@@ -1256,7 +2355,7 @@ bool ZlibContext::InitZlib() {
     case GUNZIP:
     case INFLATERAW:
     case UNZIP:
-      err_ = inflateInit2(&strm_, window_bits_);
+      err_ = inflateInit2(strm_.get(), window_bits_);
       break;
     default:
       UNREACHABLE();
@@ -1283,14 +2382,14 @@ CompressionError ZlibContext::SetDictionary() {
   switch (mode_) {
     case DEFLATE:
     case DEFLATERAW:
-      err_ = deflateSetDictionary(&strm_,
+      err_ = deflateSetDictionary(strm_.get(),
                                   dictionary_.data(),
                                   dictionary_.size());
       break;
     case INFLATERAW:
       // The other inflate cases will have the dictionary set when inflate()
       // returns Z_NEED_DICT in Process()
-      err_ = inflateSetDictionary(&strm_,
+      err_ = inflateSetDictionary(strm_.get(),
                                   dictionary_.data(),
                                   dictionary_.size());
       break;
@@ -1307,6 +2406,14 @@ CompressionError ZlibContext::SetDictionary() {
 
 
 CompressionError ZlibContext::SetParams(int level, int strategy) {
+  if (parallel_) {
+    // Applies from the next block on.
+    parallel_->SetParams(level, strategy);
+    level_ = level;
+    strategy_ = strategy;
+    return CompressionError {};
+  }
+
   bool first_init_call = InitZlib();
   if (first_init_call && err_ != Z_OK) {
     return ErrorForMessage("Failed to init stream before set parameters");
@@ -1317,7 +2424,7 @@ CompressionError ZlibContext::SetParams(int level, int strategy) {
   switch (mode_) {
     case DEFLATE:
     case DEFLATERAW:
-      err_ = deflateParams(&strm_, level, strategy);
+      err_ = deflateParams(strm_.get(), level, strategy);
       break;
     default:
       break;
@@ -1327,6 +2434,9 @@ CompressionError ZlibContext::SetParams(int level, int strategy) {
     return ErrorForMessage("Failed to set parameters");
   }
 
+  // Pooled z_streams are looked up by their current parameters.
+  level_ = level;
+  strategy_ = strategy;
   return CompressionError {};
 }
 
@@ -1369,6 +2479,7 @@ void BrotliEncoderContext::DoThreadPoolWork() {
 
 void BrotliEncoderContext::Close() {
   state_.reset();
+  shared_dictionary_.reset();
   mode_ = NONE;
 }
 
@@ -1383,9 +2494,18 @@ CompressionError BrotliEncoderContext::Init(brotli_alloc_func alloc,
     return CompressionError("Could not initialize Brotli instance",
                             "ERR_ZLIB_INITIALIZATION_FAILED",
                             -1);
-  } else {
-    return CompressionError {};
   }
+  if (shared_dictionary_) {
+    const BrotliEncoderPreparedDictionary* dictionary =
+        shared_dictionary_->GetBrotliDictionary();
+    if (dictionary == nullptr ||
+        !BrotliEncoderAttachPreparedDictionary(state_.get(), dictionary)) {
+      return CompressionError("Failed to load brotli dictionary",
+                              "ERR_ZLIB_DICTIONARY_LOAD_FAILED",
+                              -1);
+    }
+  }
+  return CompressionError {};
 }
 
 CompressionError BrotliEncoderContext::ResetStream() {
@@ -1400,6 +2520,7 @@ CompressionError BrotliEncoderContext::SetParams(int key, uint32_t value) {
                             "ERR_BROTLI_PARAM_SET_FAILED",
                             -1);
   } else {
+    if (key == BROTLI_PARAM_QUALITY) quality_ = value;
     return CompressionError {};
   }
 }
@@ -1417,6 +2538,7 @@ CompressionError BrotliEncoderContext::GetErrorInfo() const {
 
 void BrotliDecoderContext::Close() {
   state_.reset();
+  shared_dictionary_.reset();
   mode_ = NONE;
 }
 
@@ -1448,9 +2570,18 @@ CompressionError BrotliDecoderContext::Init(brotli_alloc_func alloc,
     return CompressionError("Could not initialize Brotli instance",
                             "ERR_ZLIB_INITIALIZATION_FAILED",
                             -1);
-  } else {
-    return CompressionError {};
   }
+  // The decoder only refers to the dictionary, there is nothing to prepare.
+  if (shared_dictionary_ &&
+      !BrotliDecoderAttachDictionary(state_.get(),
+                                     BROTLI_SHARED_DICTIONARY_RAW,
+                                     shared_dictionary_->data().size(),
+                                     shared_dictionary_->data().data())) {
+    return CompressionError("Failed to load brotli dictionary",
+                            "ERR_ZLIB_DICTIONARY_LOAD_FAILED",
+                            -1);
+  }
+  return CompressionError {};
 }
 
 CompressionError BrotliDecoderContext::ResetStream() {
@@ -1527,20 +2658,39 @@ CompressionError ZstdCompressContext::SetParameter(int key, int value) {
     return CompressionError(
         "Setting parameter failed", "ERR_ZSTD_PARAM_SET_FAILED", -1);
   }
+  if (key == ZSTD_c_compressionLevel) {
+    compression_level_ = value;
+    if (shared_dictionary_) return RefSharedDictionary();
+  }
+  return {};
+}
+
+CompressionError ZstdCompressContext::RefSharedDictionary() {
+  const ZSTD_CDict* cdict =
+      shared_dictionary_->GetZstdCDict(compression_level_);
+  if (cdict == nullptr ||
+      ZSTD_isError(ZSTD_CCtx_refCDict(cctx_.get(), cdict))) {
+    return CompressionError("Failed to load zstd dictionary",
+                            "ERR_ZLIB_DICTIONARY_LOAD_FAILED",
+                            -1);
+  }
   return {};
 }
 
 CompressionError ZstdCompressContext::Init(uint64_t pledged_src_size,
                                            std::string_view dictionary) {
   pledged_src_size_ = pledged_src_size;
-  cctx_.reset(ZSTD_createCCtx());
+  cctx_.reset(CompressionContextPool::TakeZstdCompress());
   if (!cctx_) {
     return CompressionError("Could not initialize zstd instance",
                             "ERR_ZLIB_INITIALIZATION_FAILED",
                             -1);
   }
 
-  if (!dictionary.empty()) {
+  if (shared_dictionary_) {
+    CompressionError err = RefSharedDictionary();
+    if (err.IsError()) return err;
+  } else if (!dictionary.empty()) {
     size_t ret = ZSTD_CCtx_loadDictionary(
         cctx_.get(), dictionary.data(), dictionary.size());
     if (ZSTD_isError(ret)) {
@@ -1558,6 +2708,11 @@ CompressionError ZstdCompressContext::Init(uint64_t pledged_src_size,
   return {};
 }
 
+void ZstdCompressContext::Close() {
+  cctx_.reset();
+  shared_dictionary_.reset();
+}
+
 CompressionError ZstdCompressContext::ResetStream() {
   return Init(pledged_src_size_);
 }
@@ -1584,14 +2739,22 @@ CompressionError ZstdDecompressContext::SetParameter(int key, int value) {
 
 CompressionError ZstdDecompressContext::Init(uint64_t pledged_src_size,
                                              std::string_view dictionary) {
-  dctx_.reset(ZSTD_createDCtx());
+  dctx_.reset(CompressionContextPool::TakeZstdDecompress());
   if (!dctx_) {
     return CompressionError("Could not initialize zstd instance",
                             "ERR_ZLIB_INITIALIZATION_FAILED",
                             -1);
   }
 
-  if (!dictionary.empty()) {
+  if (shared_dictionary_) {
+    const ZSTD_DDict* ddict = shared_dictionary_->GetZstdDDict();
+    if (ddict == nullptr ||
+        ZSTD_isError(ZSTD_DCtx_refDDict(dctx_.get(), ddict))) {
+      return CompressionError("Failed to load zstd dictionary",
+                              "ERR_ZLIB_DICTIONARY_LOAD_FAILED",
+                              -1);
+    }
+  } else if (!dictionary.empty()) {
     size_t ret = ZSTD_DCtx_loadDictionary(
         dctx_.get(), dictionary.data(), dictionary.size());
     if (ZSTD_isError(ret)) {
@@ -1603,6 +2766,11 @@ CompressionError ZstdDecompressContext::Init(uint64_t pledged_src_size,
   return {};
 }
 
+void ZstdDecompressContext::Close() {
+  dctx_.reset();
+  shared_dictionary_.reset();
+}
+
 CompressionError ZstdDecompressContext::ResetStream() {
   // We pass ZSTD_CONTENTSIZE_UNKNOWN because the argument is ignored for
   // decompression.
@@ -1690,6 +2858,776 @@ static uint32_t FastCRC32(v8::Local<v8::Value> receiver,
 
 static CFunction fast_crc32_(CFunction::Make(FastCRC32));
 
+// One-shot compression and decompression of small payloads, which would
+// otherwise go through a CompressionStream and a JS loop of writeSync()
+// calls. These run synchronously on the calling thread and reuse the streams
+// of the previous call on the same thread if the parameters match, so that
+// compressing a few KiB does not mean allocating a new deflate window.
+struct OneShotStreams {
+  OneShotStreams() = default;
+  ~OneShotStreams() {
+    if (deflate_initialized) deflateEnd(&deflate);
+    if (inflate_initialized) inflateEnd(&inflate);
+    ZSTD_freeCCtx(zstd_compress);
+    ZSTD_freeDCtx(zstd_decompress);
+  }
+
+  OneShotStreams(const OneShotStreams&) = delete;
+  OneShotStreams& operator=(const OneShotStreams&) = delete;
+
+  z_stream deflate;
+  bool deflate_initialized = false;
+  ZlibPoolKey deflate_key;
+  z_stream inflate;
+  bool inflate_initialized = false;
+  int inflate_window_bits = 0;
+  ZSTD_CCtx* zstd_compress = nullptr;
+  ZSTD_DCtx* zstd_decompress = nullptr;
+};
+
+thread_local OneShotStreams one_shot_streams;
+
+// The result of a one-shot call that did not fit into the output buffer.
+constexpr int64_t kOneShotOutputTooSmall = -1;
+
+// Turns the window bits of the public API into those of deflateInit2() and
+// inflateInit2(), like ZlibContext::Init() does.
+int ZlibWindowBits(node_zlib_mode mode, int window_bits) {
+  switch (mode) {
+    case GZIP:
+    case GUNZIP:
+      return window_bits + 16;
+    case UNZIP:
+      return window_bits + 32;
+    case DEFLATERAW:
+    case INFLATERAW:
+      return -window_bits;
+    default:
+      return window_bits;
+  }
+}
+
+CompressionError ZlibOneShotError(const z_stream& strm,
+                                  int err,
+                                  const char* message) {
+  if (strm.msg != nullptr) message = strm.msg;
+  return CompressionError(message, ZlibStrerror(err), err);
+}
+
+int64_t ZlibCompressInto(node_zlib_mode mode,
+                         const Bytef* in,
+                         uInt in_len,
+                         Bytef* out,
+                         uInt out_len,
+                         int level,
+                         int window_bits,
+                         int mem_level,
+                         int strategy,
+                         CompressionError* error) {
+  OneShotStreams* streams = &one_shot_streams;
+  z_stream* strm = &streams->deflate;
+  ZlibPoolKey key{true, level, ZlibWindowBits(mode, window_bits), mem_level,
+                  strategy};
+  if (streams->deflate_initialized && streams->deflate_key != key) {
+    deflateEnd(strm);
+    streams->deflate_initialized = false;
+  }
+  if (!streams->deflate_initialized) {
+    *strm = z_stream{};
+    int err = deflateInit2(
+        strm, level, Z_DEFLATED, key.window_bits, mem_level, strategy);
+    if (err != Z_OK) {
+      *error = ZlibOneShotError(*strm, err, "Init error");
+      return 0;
+    }
+    streams->deflate_initialized = true;
+    streams->deflate_key = key;
+  }
+
+  strm->next_in = const_cast<Bytef*>(in);
+  strm->avail_in = in_len;
+  strm->next_out = out;
+  strm->avail_out = out_len;
+  int err = deflate(strm, Z_FINISH);
+  int64_t written = out_len - strm->avail_out;
+  if (err != Z_STREAM_END && err != Z_OK && err != Z_BUF_ERROR)
+    *error = ZlibOneShotError(*strm, err, "Zlib error");
+  deflateReset(strm);
+  return err == Z_STREAM_END ? written : kOneShotOutputTooSmall;
+}
+
+int64_t ZlibDecompressInto(node_zlib_mode mode,
+                           const Bytef* in,
+                           uInt in_len,
+                           Bytef* out,
+                           uInt out_len,
+                           int window_bits,
+                           CompressionError* error) {
+  OneShotStreams* streams = &one_shot_streams;
+  z_stream* strm = &streams->inflate;
+  int zlib_window_bits = ZlibWindowBits(mode, window_bits);
+  if (streams->inflate_initialized &&
+      streams->inflate_window_bits != zlib_window_bits) {
+    inflateEnd(strm);
+    streams->inflate_initialized = false;
+  }
+  if (!streams->inflate_initialized) {
+    *strm = z_stream{};
+    int err = inflateInit2(strm, zlib_window_bits);
+    if (err != Z_OK) {
+      *error = ZlibOneShotError(*strm, err, "Init error");
+      return 0;
+    }
+    streams->inflate_initialized = true;
+    streams->inflate_window_bits = zlib_window_bits;
+  }
+
+  strm->next_in = const_cast<Bytef*>(in);
+  strm->avail_in = in_len;
+  strm->next_out = out;
+  strm->avail_out = out_len;
+  int err;
+  for (;;) {
+    err = inflate(strm, Z_FINISH);
+    // Like the streaming API, decode the members of a multi-member gzip
+    // file that follow the first one.
+    if (err == Z_STREAM_END && (mode == GUNZIP || mode == UNZIP) &&
+        strm->avail_in >= 2 && strm->next_in[0] == GZIP_HEADER_ID1 &&
+        strm->next_in[1] == GZIP_HEADER_ID2) {
+      inflateReset(strm);
+      continue;
+    }
+    break;
+  }
+
+  int64_t written = out_len - strm->avail_out;
+  int64_t result = written;
+  if (err == Z_STREAM_END) {
+    result = written;
+  } else if (err == Z_BUF_ERROR && strm->avail_out == 0) {
+    result = kOneShotOutputTooSmall;
+  } else if (err == Z_BUF_ERROR || err == Z_OK) {
+    *error = CompressionError("unexpected end of file", "Z_BUF_ERROR",
+                              Z_BUF_ERROR);
+  } else if (err == Z_NEED_DICT) {
+    *error = CompressionError("Missing dictionary", "Z_NEED_DICT",
+                              Z_NEED_DICT);
+  } else {
+    *error = ZlibOneShotError(*strm, err, "Zlib error");
+  }
+  inflateReset(strm);
+  return result;
+}
+
+CompressionError ZstdOneShotError(size_t result) {
+  ZSTD_ErrorCode code = ZSTD_getErrorCode(result);
+  return CompressionError(
+      ZSTD_getErrorString(code), ZstdStrerror(code), static_cast<int>(code));
+}
+
+void ThrowCompressionError(Environment* env, const CompressionError& err) {
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  Local<Object> exception =
+      v8::Exception::Error(OneByteString(isolate, err.message))
+          ->ToObject(context)
+          .ToLocalChecked();
+  if (exception
+          ->Set(context, env->code_string(), OneByteString(isolate, err.code))
+          .IsNothing() ||
+      exception
+          ->Set(context, env->errno_string(), Integer::New(isolate, err.err))
+          .IsNothing()) {
+    return;
+  }
+  isolate->ThrowException(exception);
+}
+
+struct OneShotBuffers {
+  ArrayBufferViewContents<uint8_t> in;
+  uint8_t* out;
+  size_t out_len;
+};
+
+// Reads the (mode, input, output) arguments shared by the one-shot calls.
+bool GetOneShotBuffers(const FunctionCallbackInfo<Value>& args,
+                       node_zlib_mode* mode,
+                       OneShotBuffers* buffers) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsArrayBufferView());
+  CHECK(args[2]->IsArrayBufferView());
+  *mode = FromV8Value<node_zlib_mode>(args[0]);
+  buffers->in.Read(args[1].As<v8::ArrayBufferView>());
+  SPREAD_BUFFER_ARG(args[2], out);
+  buffers->out = reinterpret_cast<uint8_t*>(out_data);
+  buffers->out_len = out_length;
+  // zlib counts in uInt.
+  if (buffers->in.length() > std::numeric_limits<uInt>::max() ||
+      buffers->out_len > std::numeric_limits<uInt>::max()) {
+    THROW_ERR_OUT_OF_RANGE(env, "Buffer is too large for a one-shot call");
+    return false;
+  }
+  return true;
+}
+
+// compressInto(mode, input, output, level, windowBits, memLevel, strategy)
+// compresses all of `input` into `output` and returns the number of bytes
+// written, or -1 if they do not fit. For brotli, level and windowBits are the
+// quality and lgwin, for zstd only the level is used.
+void CompressInto(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  node_zlib_mode mode;
+  OneShotBuffers buffers;
+  if (!GetOneShotBuffers(args, &mode, &buffers)) return;
+  CHECK(args[3]->IsInt32());
+  CHECK(args[4]->IsInt32());
+  CHECK(args[5]->IsInt32());
+  CHECK(args[6]->IsInt32());
+  int level = args[3].As<v8::Int32>()->Value();
+  int window_bits = args[4].As<v8::Int32>()->Value();
+  int mem_level = args[5].As<v8::Int32>()->Value();
+  int strategy = args[6].As<v8::Int32>()->Value();
+
+  CompressionError error;
+  int64_t written = 0;
+  switch (mode) {
+    case DEFLATE:
+    case GZIP:
+    case DEFLATERAW:
+      CHECK(window_bits >= Z_MIN_WINDOWBITS && window_bits <= Z_MAX_WINDOWBITS);
+      CHECK(level >= Z_MIN_LEVEL && level <= Z_MAX_LEVEL);
+      CHECK(mem_level >= Z_MIN_MEMLEVEL && mem_level <= Z_MAX_MEMLEVEL);
+      written = ZlibCompressInto(mode,
+                                 buffers.in.data(),
+                                 static_cast<uInt>(buffers.in.length()),
+                                 buffers.out,
+                                 static_cast<uInt>(buffers.out_len),
+                                 level,
+                                 window_bits,
+                                 mem_level,
+                                 strategy,
+                                 &error);
+      break;
+    case BROTLI_ENCODE: {
+      size_t encoded_size = buffers.out_len;
+      if (BrotliEncoderCompress(level,
+                                window_bits,
+                                BROTLI_MODE_GENERIC,
+                                buffers.in.length(),
+                                buffers.in.data(),
+                                &encoded_size,
+                                buffers.out)) {
+        written = encoded_size;
+      } else if (buffers.out_len <
+                 BrotliEncoderMaxCompressedSize(buffers.in.length())) {
+        written = kOneShotOutputTooSmall;
+      } else {
+        error = CompressionError(
+            "Compression failed", "ERR_BROTLI_COMPRESSION_FAILED", -1);
+      }
+      break;
+    }
+    case ZSTD_COMPRESS: {
+      OneShotStreams* streams = &one_shot_streams;
+      if (streams->zstd_compress == nullptr)
+        streams->zstd_compress = ZSTD_createCCtx();
+      if (streams->zstd_compress == nullptr) {
+        error = CompressionError("Could not initialize zstd instance",
+                                 "ERR_ZLIB_INITIALIZATION_FAILED",
+                                 -1);
+        break;
+      }
+      size_t result = ZSTD_compressCCtx(streams->zstd_compress,
+                                        buffers.out,
+                                        buffers.out_len,
+                                        buffers.in.data(),
+                                        buffers.in.length(),
+                                        level);
+      if (!ZSTD_isError(result)) {
+        written = result;
+      } else if (ZSTD_getErrorCode(result) == ZSTD_error_dstSize_tooSmall) {
+        written = kOneShotOutputTooSmall;
+      } else {
+        error = ZstdOneShotError(result);
+      }
+      break;
+    }
+    default:
+      UNREACHABLE("Invalid compression mode");
+  }
+
+  if (error.IsError()) return ThrowCompressionError(env, error);
+  args.GetReturnValue().Set(static_cast<double>(written));
+}
+
+// decompressInto(mode, input, output, windowBits) decompresses `input` into
+// `output` and returns the number of bytes written, or -1 if they do not fit.
+// Throws like the streaming API would emit an error if `input` is not valid.
+void DecompressInto(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  node_zlib_mode mode;
+  OneShotBuffers buffers;
+  if (!GetOneShotBuffers(args, &mode, &buffers)) return;
+  CHECK(args[3]->IsInt32());
+  int window_bits = args[3].As<v8::Int32>()->Value();
+
+  CompressionError error;
+  int64_t written = 0;
+  switch (mode) {
+    case INFLATE:
+    case GUNZIP:
+    case INFLATERAW:
+    case UNZIP:
+      // 0 means to use the window size of the stream's header.
+      CHECK(window_bits == 0 || (window_bits >= Z_MIN_WINDOWBITS &&
+                                 window_bits <= Z_MAX_WINDOWBITS));
+      written = ZlibDecompressInto(mode,
+                                   buffers.in.data(),
+                                   static_cast<uInt>(buffers.in.length()),
+                                   buffers.out,
+                                   static_cast<uInt>(buffers.out_len),
+                                   window_bits,
+                                   &error);
+      break;
+    case BROTLI_DECODE: {
+      size_t decoded_size = buffers.out_len;
+      BrotliDecoderResult result = BrotliDecoderDecompress(
+          buffers.in.length(), buffers.in.data(), &decoded_size, buffers.out);
+      if (result == BROTLI_DECODER_RESULT_SUCCESS) {
+        written = decoded_size;
+      } else if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) {
+        written = kOneShotOutputTooSmall;
+      } else if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT) {
+        error = CompressionError("unexpected end of file", "Z_BUF_ERROR",
+                                 Z_BUF_ERROR);
+      } else {
+        error = CompressionError(
+            "Decompression failed", "ERR_BROTLI_DECOMPRESSION_FAILED", -1);
+      }
+      break;
+    }
+    case ZSTD_DECOMPRESS: {
+      OneShotStreams* streams = &one_shot_streams;
+      if (streams->zstd_decompress == nullptr)
+        streams->zstd_decompress = ZSTD_createDCtx();
+      if (streams->zstd_decompress == nullptr) {
+        error = CompressionError("Could not initialize zstd instance",
+                                 "ERR_ZLIB_INITIALIZATION_FAILED",
+                                 -1);
+        break;
+      }
+      size_t result = ZSTD_decompressDCtx(streams->zstd_decompress,
+                                          buffers.out,
+                                          buffers.out_len,
+                                          buffers.in.data(),
+                                          buffers.in.length());
+      if (!ZSTD_isError(result)) {
+        written = result;
+      } else if (ZSTD_getErrorCode(result) == ZSTD_error_dstSize_tooSmall) {
+        written = kOneShotOutputTooSmall;
+      } else {
+        error = ZstdOneShotError(result);
+      }
+      break;
+    }
+    default:
+      UNREACHABLE("Invalid decompression mode");
+  }
+
+  if (error.IsError()) return ThrowCompressionError(env, error);
+  args.GetReturnValue().Set(static_cast<double>(written));
+}
+
+// compressBound(mode, length) returns an output size for compressInto() that
+// is large enough for any input of `length` bytes, or 0 if there is none.
+void CompressBound(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsNumber());
+  node_zlib_mode mode = FromV8Value<node_zlib_mode>(args[0]);
+  double length = args[1].As<v8::Number>()->Value();
+  CHECK_GE(length, 0);
+  size_t len = static_cast<size_t>(length);
+
+  size_t bound = 0;
+  switch (mode) {
+    case DEFLATE:
+    case GZIP:
+    case DEFLATERAW:
+      // compressBound() includes the zlib wrapper, the gzip one is 12 bytes
+      // longer.
+      if (len <= std::numeric_limits<uLong>::max() / 2)
+        bound = compressBound(static_cast<uLong>(len)) + 12;
+      break;
+    case BROTLI_ENCODE:
+      bound = BrotliEncoderMaxCompressedSize(len);
+      break;
+    case ZSTD_COMPRESS:
+      bound = ZSTD_compressBound(len);
+      if (ZSTD_isError(bound)) bound = 0;
+      break;
+    default:
+      UNREACHABLE("Invalid compression mode");
+  }
+  args.GetReturnValue().Set(static_cast<double>(bound));
+}
+
+// Compresses or decompresses the contents of a DataQueue as it is read, so
+// that e.g. a file Blob can be written to a socket gzipped without any of its
+// chunks passing through JS. Uses the default allocators, as the queue may
+// be read on a thread other than the one that created it.
+class CompressionTransform final : public DataQueue::Transform {
+ public:
+  // Returns nullptr and sets *error if the parameters are rejected.
+  static std::unique_ptr<CompressionTransform> Create(node_zlib_mode mode,
+                                                      int level,
+                                                      int window_bits,
+                                                      int mem_level,
+                                                      int strategy,
+                                                      CompressionError* error);
+  ~CompressionTransform() override;
+
+  size_t max_overhead() const override {
+    return compress_ ? kCompressOverhead : kMinOutputRoom;
+  }
+
+  bool Update(const uint8_t* data,
+              size_t len,
+              std::vector<uint8_t>* out) override {
+    // The libraries count in uInt.
+    while (len > 0) {
+      size_t chunk = std::min<size_t>(len, std::numeric_limits<uInt>::max());
+      if (!Run(data, chunk, out, false)) return false;
+      data += chunk;
+      len -= chunk;
+    }
+    return true;
+  }
+
+  bool Finish(std::vector<uint8_t>* out) override {
+    return Run(nullptr, 0, out, true) && (compress_ || ended_);
+  }
+
+  std::optional<uint64_t> size(
+      std::optional<uint64_t> input_size) const override {
+    return std::nullopt;
+  }
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(CompressionTransform)
+  SET_SELF_SIZE(CompressionTransform)
+
+ private:
+  // Enough for the gzip header and trailer and a few block headers.
+  static constexpr size_t kCompressOverhead = 64;
+  // The least room to give the library for each call.
+  static constexpr size_t kMinOutputRoom = 16 * 1024;
+
+  explicit CompressionTransform(node_zlib_mode mode);
+
+  bool Run(const uint8_t* in,
+           size_t len,
+           std::vector<uint8_t>* out,
+           bool finish);
+  // Runs one call of the library with avail_out bytes at next_out.
+  bool Step(const uint8_t** next_in,
+            size_t* avail_in,
+            uint8_t** next_out,
+            size_t* avail_out,
+            bool finish,
+            bool* more);
+
+  const node_zlib_mode mode_;
+  const bool compress_;
+  // Whether the end of the compressed stream has been decoded.
+  bool ended_ = false;
+  // Whether the last zstd frame decoded so far is complete.
+  bool frame_complete_ = false;
+  std::unique_ptr<z_stream> strm_;
+  DeleteFnPtr<BrotliEncoderState, BrotliEncoderDestroyInstance> encoder_;
+  DeleteFnPtr<BrotliDecoderState, BrotliDecoderDestroyInstance> decoder_;
+  DeleteFnPtr<ZSTD_CCtx, ZstdCompressContext::FreeZstd> cctx_;
+  DeleteFnPtr<ZSTD_DCtx, ZstdDecompressContext::FreeZstd> dctx_;
+};
+
+CompressionTransform::CompressionTransform(node_zlib_mode mode)
+    : mode_(mode),
+      compress_(mode == DEFLATE || mode == GZIP || mode == DEFLATERAW ||
+                mode == BROTLI_ENCODE || mode == ZSTD_COMPRESS) {}
+
+CompressionTransform::~CompressionTransform() {
+  if (!strm_) return;
+  if (compress_) {
+    deflateEnd(strm_.get());
+  } else {
+    inflateEnd(strm_.get());
+  }
+}
+
+std::unique_ptr<CompressionTransform> CompressionTransform::Create(
+    node_zlib_mode mode,
+    int level,
+    int window_bits,
+    int mem_level,
+    int strategy,
+    CompressionError* error) {
+  std::unique_ptr<CompressionTransform> transform(
+      new CompressionTransform(mode));
+  switch (mode) {
+    case DEFLATE:
+    case GZIP:
+    case DEFLATERAW:
+    case INFLATE:
+    case GUNZIP:
+    case INFLATERAW:
+    case UNZIP: {
+      auto strm = std::make_unique<z_stream>();
+      int err = transform->compress_
+                    ? deflateInit2(strm.get(),
+                                   level,
+                                   Z_DEFLATED,
+                                   ZlibWindowBits(mode, window_bits),
+                                   mem_level,
+                                   strategy)
+                    : inflateInit2(strm.get(),
+                                   ZlibWindowBits(mode, window_bits));
+      if (err != Z_OK) {
+        *error = ZlibOneShotError(*strm, err, "Init error");
+        return nullptr;
+      }
+      transform->strm_ = std::move(strm);
+      break;
+    }
+    case BROTLI_ENCODE:
+      transform->encoder_.reset(
+          BrotliEncoderCreateInstance(nullptr, nullptr, nullptr));
+      if (!transform->encoder_ ||
+          !BrotliEncoderSetParameter(
+              transform->encoder_.get(), BROTLI_PARAM_QUALITY, level) ||
+          !BrotliEncoderSetParameter(
+              transform->encoder_.get(), BROTLI_PARAM_LGWIN, window_bits)) {
+        *error = CompressionError("Initialization failed",
+                                  "ERR_ZLIB_INITIALIZATION_FAILED",
+                                  -1);
+        return nullptr;
+      }
+      break;
+    case BROTLI_DECODE:
+      transform->decoder_.reset(
+          BrotliDecoderCreateInstance(nullptr, nullptr, nullptr));
+      if (!transform->decoder_) {
+        *error = CompressionError("Initialization failed",
+                                  "ERR_ZLIB_INITIALIZATION_FAILED",
+                                  -1);
+        return nullptr;
+      }
+      break;
+    case ZSTD_COMPRESS:
+      transform->cctx_.reset(CompressionContextPool::TakeZstdCompress());
+      if (!transform->cctx_ ||
+          ZSTD_isError(ZSTD_CCtx_setParameter(
+              transform->cctx_.get(), ZSTD_c_compressionLevel, level))) {
+        *error = CompressionError("Could not initialize zstd instance",
+                                  "ERR_ZLIB_INITIALIZATION_FAILED",
+                                  -1);
+        return nullptr;
+      }
+      break;
+    case ZSTD_DECOMPRESS:
+      transform->dctx_.reset(CompressionContextPool::TakeZstdDecompress());
+      if (!transform->dctx_) {
+        *error = CompressionError("Could not initialize zstd instance",
+                                  "ERR_ZLIB_INITIALIZATION_FAILED",
+                                  -1);
+        return nullptr;
+      }
+      break;
+    default:
+      UNREACHABLE("Invalid compression mode");
+  }
+  return transform;
+}
+
+bool CompressionTransform::Run(const uint8_t* in,
+                               size_t len,
+                               std::vector<uint8_t>* out,
+                               bool finish) {
+  size_t used = out->size();
+  bool ok = true;
+  bool more = true;
+  while (ok && more) {
+    size_t room = std::max(kMinOutputRoom, compress_ ? len : 2 * len);
+    room = std::min<size_t>(room, std::numeric_limits<uInt>::max());
+    out->resize(used + room);
+    uint8_t* next_out = out->data() + used;
+    size_t avail_out = room;
+    size_t avail_in = len;
+    ok = Step(&in, &avail_in, &next_out, &avail_out, finish, &more);
+    used += room - avail_out;
+    len = avail_in;
+  }
+  out->resize(used);
+  return ok;
+}
+
+bool CompressionTransform::Step(const uint8_t** next_in,
+                                size_t* avail_in,
+                                uint8_t** next_out,
+                                size_t* avail_out,
+                                bool finish,
+                                bool* more) {
+  // Input that follows the end of the compressed data is ignored, like the
+  // streaming API does.
+  if (ended_) {
+    *avail_in = 0;
+    *more = false;
+    return true;
+  }
+
+  switch (mode_) {
+    case DEFLATE:
+    case GZIP:
+    case DEFLATERAW:
+    case INFLATE:
+    case GUNZIP:
+    case INFLATERAW:
+    case UNZIP: {
+      z_stream* strm = strm_.get();
+      strm->next_in = const_cast<Bytef*>(*next_in);
+      strm->avail_in = static_cast<uInt>(*avail_in);
+      strm->next_out = *next_out;
+      strm->avail_out = static_cast<uInt>(*avail_out);
+      int err = compress_ ? deflate(strm, finish ? Z_FINISH : Z_NO_FLUSH)
+                          : inflate(strm, Z_NO_FLUSH);
+      *next_in = strm->next_in;
+      *avail_in = strm->avail_in;
+      *next_out = strm->next_out;
+      *avail_out = strm->avail_out;
+      if (err == Z_STREAM_END) {
+        if (compress_) {
+          *more = false;
+          return true;
+        }
+        // Decode the members of a multi-member gzip file that follow the
+        // first one.
+        if ((mode_ == GUNZIP || mode_ == UNZIP) && *avail_in >= 2 &&
+            (*next_in)[0] == GZIP_HEADER_ID1 &&
+            (*next_in)[1] == GZIP_HEADER_ID2) {
+          inflateReset(strm);
+          *more = true;
+          return true;
+        }
+        ended_ = true;
+        *more = *avail_in > 0;
+        return true;
+      }
+      if (err != Z_OK && err != Z_BUF_ERROR) return false;
+      // Finishing a deflate stream goes on until Z_STREAM_END.
+      *more = *avail_in > 0 || *avail_out == 0 || (compress_ && finish);
+      return true;
+    }
+    case BROTLI_ENCODE: {
+      BrotliEncoderState* state = encoder_.get();
+      if (!BrotliEncoderCompressStream(
+              state,
+              finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_PROCESS,
+              avail_in,
+              next_in,
+              avail_out,
+              next_out,
+              nullptr)) {
+        return false;
+      }
+      *more = finish ? !BrotliEncoderIsFinished(state)
+                     : *avail_in > 0 || BrotliEncoderHasMoreOutput(state);
+      return true;
+    }
+    case BROTLI_DECODE: {
+      BrotliDecoderResult result = BrotliDecoderDecompressStream(
+          decoder_.get(), avail_in, next_in, avail_out, next_out, nullptr);
+      if (result == BROTLI_DECODER_RESULT_ERROR) return false;
+      if (result == BROTLI_DECODER_RESULT_SUCCESS) ended_ = true;
+      *more = result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT;
+      return true;
+    }
+    case ZSTD_COMPRESS: {
+      ZSTD_inBuffer input = {*next_in, *avail_in, 0};
+      ZSTD_outBuffer output = {*next_out, *avail_out, 0};
+      size_t remaining = ZSTD_compressStream2(
+          cctx_.get(), &output, &input, finish ? ZSTD_e_end : ZSTD_e_continue);
+      if (ZSTD_isError(remaining)) return false;
+      *next_in += input.pos;
+      *avail_in -= input.pos;
+      *next_out += output.pos;
+      *avail_out -= output.pos;
+      *more = finish ? remaining != 0 : *avail_in > 0;
+      return true;
+    }
+    case ZSTD_DECOMPRESS: {
+      ZSTD_inBuffer input = {*next_in, *avail_in, 0};
+      ZSTD_outBuffer output = {*next_out, *avail_out, 0};
+      size_t ret = ZSTD_decompressStream(dctx_.get(), &output, &input);
+      if (ZSTD_isError(ret)) return false;
+      *next_in += input.pos;
+      *avail_in -= input.pos;
+      *next_out += output.pos;
+      *avail_out -= output.pos;
+      // A return of 0 ends a frame. Unlike the other formats, zstd input may
+      // consist of several frames, so this only marks the input as complete
+      // for Finish().
+      if (input.pos > 0 || output.pos > 0) frame_complete_ = ret == 0;
+      *more = *avail_in > 0 || *avail_out == 0;
+      if (finish && !*more) ended_ = frame_complete_;
+      return true;
+    }
+    default:
+      UNREACHABLE("Invalid compression mode");
+  }
+}
+
+// transformBlob(blob, mode, level, windowBits, memLevel, strategy) returns a
+// Blob with the contents of `blob` compressed or decompressed, produced as
+// the new Blob is read. For brotli, level and windowBits are the quality and
+// lgwin, for zstd only the level is used. A read of the new Blob fails if
+// the data turns out to be invalid.
+void TransformBlob(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(Blob::HasInstance(env, args[0]));
+  Blob* blob;
+  ASSIGN_OR_RETURN_UNWRAP(&blob, args[0]);
+  CHECK(args[1]->IsInt32());
+  CHECK(args[2]->IsInt32());
+  CHECK(args[3]->IsInt32());
+  CHECK(args[4]->IsInt32());
+  CHECK(args[5]->IsInt32());
+  node_zlib_mode mode = FromV8Value<node_zlib_mode>(args[1]);
+  if (mode <= NONE || mode > ZSTD_DECOMPRESS)
+    return THROW_ERR_INVALID_ARG_VALUE(env, "Invalid compression mode");
+
+  std::shared_ptr<DataQueue> source = blob->getDataQueue().slice(0);
+  if (!source) return THROW_ERR_INVALID_STATE(env);
+
+  CompressionError error;
+  std::unique_ptr<CompressionTransform> transform =
+      CompressionTransform::Create(mode,
+                                   args[2].As<v8::Int32>()->Value(),
+                                   args[3].As<v8::Int32>()->Value(),
+                                   args[4].As<v8::Int32>()->Value(),
+                                   args[5].As<v8::Int32>()->Value(),
+                                   &error);
+  if (!transform) return ThrowCompressionError(env, error);
+
+  std::shared_ptr<DataQueue> data_queue = DataQueue::Create();
+  CHECK(data_queue
+            ->append(DataQueue::CreateTransformEntry(std::move(source),
+                                                     std::move(transform)))
+            .value_or(false));
+  data_queue->cap();
+
+  BaseObjectPtr<Blob> result = Blob::Create(env, std::move(data_queue));
+  if (result) args.GetReturnValue().Set(result->object());
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -1701,8 +3639,20 @@ void Initialize(Local<Object> target,
   MakeClass<BrotliDecoderStream>::Make(env, target, "BrotliDecoder");
   MakeClass<ZstdCompressStream>::Make(env, target, "ZstdCompress");
   MakeClass<ZstdDecompressStream>::Make(env, target, "ZstdDecompress");
+  SetConstructorFunction(context,
+                         target,
+                         "CompressionDictionary",
+                         CompressionDictionary::GetConstructorTemplate(env));
 
   SetFastMethodNoSideEffect(context, target, "crc32", CRC32, &fast_crc32_);
+  SetMethod(context, target, "compressInto", CompressInto);
+  SetMethod(context, target, "decompressInto", DecompressInto);
+  SetMethodNoSideEffect(context, target, "compressBound", CompressBound);
+  SetMethod(context, target, "transformBlob", TransformBlob);
+  SetMethod(context, target, "setStatsEnabled", CompressionStats::SetEnabled);
+  SetMethodNoSideEffect(
+      context, target, "getStats", CompressionStats::GetStats);
+  SetMethod(context, target, "resetStats", CompressionStats::ResetStats);
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "ZLIB_VERSION"),
               FIXED_ONE_BYTE_STRING(env->isolate(), ZLIB_VERSION)).Check();
@@ -1714,8 +3664,17 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   MakeClass<BrotliDecoderStream>::Make(registry);
   MakeClass<ZstdCompressStream>::Make(registry);
   MakeClass<ZstdDecompressStream>::Make(registry);
+  registry->Register(CompressionDictionary::New);
+  registry->Register(CompressionDictionary::GetDigest);
   registry->Register(CRC32);
   registry->Register(fast_crc32_);
+  registry->Register(CompressInto);
+  registry->Register(DecompressInto);
+  registry->Register(CompressBound);
+  registry->Register(TransformBlob);
+  registry->Register(CompressionStats::SetEnabled);
+  registry->Register(CompressionStats::GetStats);
+  registry->Register(CompressionStats::ResetStats);
 }
 
 }  // anonymous namespace
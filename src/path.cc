@@ -18,72 +18,71 @@ constexpr bool IsPathSeparator(const char c) noexcept {
 }
 #endif  // _WIN32
 
+// Returns the index of the first path separator in path at or after pos,
+// or std::string_view::npos.
+inline size_t FindPathSeparator(const std::string_view path, size_t pos) {
+#ifdef _WIN32
+  return path.find_first_of("\\/", pos);
+#else
+  // A memchr(), which the C library vectorizes.
+  return path.find('/', pos);
+#endif
+}
+
 std::string NormalizeString(const std::string_view path,
                             bool allowAboveRoot,
                             const std::string_view separator) {
+  // The result is never longer than the path.
   std::string res;
-  int lastSegmentLength = 0;
-  int lastSlash = -1;
-  int dots = 0;
-  char code = 0;
-  for (size_t i = 0; i <= path.size(); ++i) {
-    if (i < path.size()) {
-      code = path[i];
-    } else if (IsPathSeparator(code)) {
-      break;
-    } else {
-      code = '/';
+  res.reserve(path.size());
+  size_t lastSegmentLength = 0;
+  size_t start = 0;
+  while (start <= path.size()) {
+    size_t end = FindPathSeparator(path, start);
+    if (end == std::string_view::npos) end = path.size();
+    const std::string_view segment = path.substr(start, end - start);
+    start = end + 1;
+
+    if (segment.empty() || segment == ".") {
+      continue;
     }
 
-    if (IsPathSeparator(code)) {
-      if (lastSlash == static_cast<int>(i - 1) || dots == 1) {
-        // NOOP
-      } else if (dots == 2) {
-        int len = res.length();
-        if (len < 2 || lastSegmentLength != 2 || res[len - 1] != '.' ||
-            res[len - 2] != '.') {
-          if (len > 2) {
-            auto lastSlashIndex = res.find_last_of(separator);
-            if (lastSlashIndex == std::string::npos) {
-              res = "";
-              lastSegmentLength = 0;
-            } else {
-              res = res.substr(0, lastSlashIndex);
-              len = res.length();
-              lastSegmentLength = len - 1 - res.find_last_of(separator);
-            }
-            lastSlash = i;
-            dots = 0;
-            continue;
-          } else if (len != 0) {
-            res = "";
+    if (segment == "..") {
+      const size_t len = res.size();
+      if (len < 2 || lastSegmentLength != 2 || res[len - 1] != '.' ||
+          res[len - 2] != '.') {
+        if (len > 2) {
+          // Drop the last segment of the result.
+          const size_t lastSlashIndex = res.find_last_of(separator);
+          if (lastSlashIndex == std::string::npos) {
+            res.clear();
             lastSegmentLength = 0;
-            lastSlash = i;
-            dots = 0;
-            continue;
+          } else {
+            res.resize(lastSlashIndex);
+            const size_t previousSlashIndex = res.find_last_of(separator);
+            lastSegmentLength = previousSlashIndex == std::string::npos
+                                    ? res.size()
+                                    : res.size() - 1 - previousSlashIndex;
           }
+          continue;
+        } else if (len != 0) {
+          res.clear();
+          lastSegmentLength = 0;
+          continue;
         }
+      }
 
-        if (allowAboveRoot) {
-          res += res.length() > 0 ? std::string(separator) + ".." : "..";
-          lastSegmentLength = 2;
-        }
-      } else {
-        if (!res.empty()) {
-          res += std::string(separator) +
-                 std::string(path.substr(lastSlash + 1, i - (lastSlash + 1)));
-        } else {
-          res = path.substr(lastSlash + 1, i - (lastSlash + 1));
-        }
-        lastSegmentLength = i - lastSlash - 1;
+      if (allowAboveRoot) {
+        if (!res.empty()) res += separator;
+        res += "..";
+        lastSegmentLength = 2;
       }
-      lastSlash = i;
-      dots = 0;
-    } else if (code == '.' && dots != -1) {
-      ++dots;
-    } else {
-      dots = -1;
+      continue;
     }
+
+    if (!res.empty()) res += separator;
+    res += segment;
+    lastSegmentLength = segment.size();
   }
 
   return res;
@@ -246,21 +245,24 @@ std::string PathResolve(Environment* env,
 #else   // _WIN32
 std::string PathResolve(Environment* env,
                         const std::vector<std::string_view>& paths) {
-  std::string resolvedPath;
+  // Only the paths from the last absolute one on matter, and the working
+  // directory is only needed when none is absolute.
+  size_t first = paths.size();
   bool resolvedAbsolute = false;
-  auto cwd = env->GetCwd(env->exec_path());
-  const size_t numArgs = paths.size();
-
-  for (int i = numArgs - 1; i >= -1 && !resolvedAbsolute; i--) {
-    const std::string& path = (i >= 0) ? std::string(paths[i]) : cwd;
-
-    if (!path.empty()) {
-      resolvedPath = std::string(path) + "/" + resolvedPath;
+  while (first > 0 && !resolvedAbsolute) {
+    first--;
+    resolvedAbsolute = !paths[first].empty() && paths[first].front() == '/';
+  }
 
-      if (path.front() == '/') {
-        resolvedAbsolute = true;
-        break;
-      }
+  std::string resolvedPath;
+  if (!resolvedAbsolute) {
+    resolvedPath = env->GetCwd(env->exec_path());
+    resolvedAbsolute = !resolvedPath.empty() && resolvedPath.front() == '/';
+  }
+  for (size_t i = first; i < paths.size(); i++) {
+    if (!paths[i].empty()) {
+      resolvedPath += '/';
+      resolvedPath += paths[i];
     }
   }
 
@@ -49,34 +49,20 @@ void FreeRecursivelyNode(
   delete node;
 }
 
-bool is_tree_granted(
-    node::Environment* env,
-    const node::permission::FSPermission::RadixTree* granted_tree,
-    const std::string_view& param) {
-  std::string resolved_param = node::PathResolve(env, {param});
-#ifdef _WIN32
-  // Remove leading "\\?\" from UNC path
-  if (resolved_param.starts_with("\\\\?\\")) {
-    resolved_param.erase(0, 4);
-  }
-
-  // Remove leading "UNC\" from UNC path
-  if (resolved_param.starts_with("UNC\\")) {
-    resolved_param.erase(0, 4);
+size_t NodeMemorySize(
+    const node::permission::FSPermission::RadixTree::Node* node) {
+  if (node == nullptr) {
+    return 0;
   }
-  // Remove leading "//" from UNC path
-  if (resolved_param.starts_with("//")) {
-    resolved_param.erase(0, 2);
+  // Each child is also an entry of its parent's map, of about a pointer, a
+  // label and the next pointer of its bucket.
+  size_t size = sizeof(*node) + node->prefix.capacity() +
+                node->children.bucket_count() * sizeof(void*) +
+                node->children.size() * 3 * sizeof(void*);
+  for (const auto& c : node->children) {
+    size += NodeMemorySize(c.second);
   }
-#endif
-  auto _is_granted = granted_tree->Lookup(resolved_param, true);
-  node::Debug(env,
-              node::DebugCategory::PERMISSION_MODEL,
-              "Access %d to %s\n",
-              _is_granted,
-              param);
-
-  return _is_granted;
+  return size + NodeMemorySize(node->wildcard_child);
 }
 
 static const char* kBoxDrawingsLightUpAndRight = "└─ ";
@@ -158,6 +144,10 @@ void FSPermission::Apply(Environment* env,
 
 void FSPermission::GrantAccess(PermissionScope perm, const std::string& res) {
   const std::string path = WildcardIfDir(res);
+  {
+    Mutex::ScopedLock lock(decision_cache_mutex_);
+    decision_cache_.Clear();
+  }
   if (perm == PermissionScope::kFileSystemRead &&
       !granted_in_fs_.Lookup(path)) {
     granted_in_fs_.Insert(path);
@@ -169,6 +159,60 @@ void FSPermission::GrantAccess(PermissionScope perm, const std::string& res) {
   }
 }
 
+bool FSPermission::is_tree_granted(Environment* env,
+                                   PermissionScope perm,
+                                   const std::string_view& param) const {
+  const RadixTree* granted_tree = perm == PermissionScope::kFileSystemRead
+                                      ? &granted_in_fs_
+                                      : &granted_out_fs_;
+#ifdef _WIN32
+  // Windows paths may be relative to the working directory of a drive.
+  const bool cacheable = false;
+#else
+  const bool cacheable =
+      param.front() == kPathSeparator && param.size() <= kMaxCachedPathLength;
+#endif
+  std::string key;
+  if (cacheable) {
+    key.reserve(param.size() + 1);
+    key += perm == PermissionScope::kFileSystemRead ? 'r' : 'w';
+    key += param;
+    Mutex::ScopedLock lock(decision_cache_mutex_);
+    if (decision_cache_.Exists(key)) {
+      return decision_cache_.Get(key);
+    }
+  }
+
+  std::string resolved_param = PathResolve(env, {param});
+#ifdef _WIN32
+  // Remove leading "\\?\" from UNC path
+  if (resolved_param.starts_with("\\\\?\\")) {
+    resolved_param.erase(0, 4);
+  }
+
+  // Remove leading "UNC\" from UNC path
+  if (resolved_param.starts_with("UNC\\")) {
+    resolved_param.erase(0, 4);
+  }
+  // Remove leading "//" from UNC path
+  if (resolved_param.starts_with("//")) {
+    resolved_param.erase(0, 2);
+  }
+#endif
+  auto _is_granted = granted_tree->Lookup(resolved_param, true);
+  Debug(env,
+        DebugCategory::PERMISSION_MODEL,
+        "Access %d to %s\n",
+        _is_granted,
+        param);
+
+  if (cacheable) {
+    Mutex::ScopedLock lock(decision_cache_mutex_);
+    decision_cache_.Put(key, _is_granted);
+  }
+  return _is_granted;
+}
+
 bool FSPermission::is_granted(Environment* env,
                               PermissionScope perm,
                               const std::string_view& param = "") const {
@@ -180,53 +224,157 @@ bool FSPermission::is_granted(Environment* env,
         return allow_all_in_;
       }
       return !deny_all_in_ &&
-             (allow_all_in_ || is_tree_granted(env, &granted_in_fs_, param));
+             (allow_all_in_ || is_tree_granted(env, perm, param));
     case PermissionScope::kFileSystemWrite:
       if (param.empty()) {
         return allow_all_out_;
       }
       return !deny_all_out_ &&
-             (allow_all_out_ || is_tree_granted(env, &granted_out_fs_, param));
+             (allow_all_out_ || is_tree_granted(env, perm, param));
     default:
       return false;
   }
 }
 
-FSPermission::RadixTree::RadixTree() : root_node_(new Node("")) {}
+FSPermission::RadixTree::RadixTree() : root_node_(new Node("")) {
+  Compile();
+}
 
 FSPermission::RadixTree::~RadixTree() {
   FreeRecursivelyNode(root_node_);
 }
 
+void FSPermission::RadixTree::Compile() {
+  nodes_.clear();
+  edges_.clear();
+  prefixes_.clear();
+  CompileNode(root_node_);
+}
+
+uint32_t FSPermission::RadixTree::CompileNode(const Node* node) {
+  const uint32_t index = nodes_.size();
+  nodes_.push_back({static_cast<uint32_t>(prefixes_.size()),
+                    static_cast<uint32_t>(node->prefix.size()),
+                    0,
+                    0,
+                    kNoNode,
+                    node->wildcard_child != nullptr,
+                    node->IsEndNode()});
+  prefixes_ += node->prefix;
+
+  // The edges of a node are reserved before its children are compiled, so
+  // that they stay contiguous.
+  std::vector<std::pair<char, const Node*>> children(node->children.begin(),
+                                                     node->children.end());
+  std::sort(children.begin(), children.end(), [](auto& a, auto& b) {
+    return a.first < b.first;
+  });
+  const uint32_t first_edge = edges_.size();
+  nodes_[index].first_edge = first_edge;
+  nodes_[index].edge_count = children.size();
+  edges_.resize(first_edge + children.size());
+  for (size_t i = 0; i < children.size(); i++) {
+    const uint32_t child = CompileNode(children[i].second);
+    edges_[first_edge + i] = {children[i].first, child};
+    if (children[i].first == '*') {
+      nodes_[index].star_child = child;
+    }
+  }
+  return index;
+}
+
+uint32_t FSPermission::RadixTree::NextNode(const FlatNode& node,
+                                           std::string_view path,
+                                           size_t idx) const {
+  if (idx >= path.length()) {
+    return kNoNode;
+  }
+
+  // wildcard node takes precedence
+  if (node.edge_count > 1 && node.star_child != kNoNode) {
+    return node.star_child;
+  }
+
+  const FlatEdge* first = edges_.data() + node.first_edge;
+  const FlatEdge* last = first + node.edge_count;
+  const FlatEdge* edge =
+      std::lower_bound(first, last, path[idx], [](const FlatEdge& e, char c) {
+        return e.label < c;
+      });
+  if (edge == last || edge->label != path[idx]) {
+    return kNoNode;
+  }
+
+  const FlatNode& child = nodes_[edge->child];
+  const char* prefix = prefixes_.data() + child.prefix_offset;
+  // match prefix
+  for (size_t i = 0; i < path.length(); ++i) {
+    if (i >= child.prefix_length || prefix[i] == '*') {
+      return edge->child;
+    }
+
+    // Handle optional trailing
+    // path = /home/subdirectory
+    // child = subdirectory/*
+    if (idx >= path.length() && prefix[i] == node::kPathSeparator) {
+      continue;
+    }
+
+    // Past the end of the path, nothing else matches.
+    const char c = idx < path.length() ? path[idx] : '\0';
+    idx++;
+    if (c != prefix[i]) {
+      return kNoNode;
+    }
+  }
+  return edge->child;
+}
+
 bool FSPermission::RadixTree::Lookup(const std::string_view& s,
                                      bool when_empty_return) const {
-  FSPermission::RadixTree::Node* current_node = root_node_;
-  if (current_node->children.empty()) {
+  const FlatNode* current_node = &nodes_[0];
+  if (current_node->edge_count == 0) {
     return when_empty_return;
   }
-  size_t parent_node_prefix_len = current_node->prefix.length();
-  const std::string path(s);
-  auto path_len = path.length();
+  size_t parent_node_prefix_len = current_node->prefix_length;
+  auto path_len = s.length();
 
   while (true) {
-    if (parent_node_prefix_len == path_len && current_node->IsEndNode()) {
+    if (parent_node_prefix_len == path_len && current_node->is_end) {
       return true;
     }
 
-    auto node = current_node->NextNode(path, parent_node_prefix_len);
-    if (node == nullptr) {
+    uint32_t node = NextNode(*current_node, s, parent_node_prefix_len);
+    if (node == kNoNode) {
       return false;
     }
 
-    current_node = node;
-    parent_node_prefix_len += current_node->prefix.length();
-    if (current_node->wildcard_child != nullptr &&
+    current_node = &nodes_[node];
+    parent_node_prefix_len += current_node->prefix_length;
+    if (current_node->has_wildcard_child && parent_node_prefix_len >= 2 &&
         path_len >= (parent_node_prefix_len - 2 /* slash* */)) {
       return true;
     }
   }
 }
 
+size_t FSPermission::RadixTree::MemorySize() const {
+  return NodeMemorySize(root_node_) + nodes_.capacity() * sizeof(FlatNode) +
+         edges_.capacity() * sizeof(FlatEdge) + prefixes_.capacity();
+}
+
+size_t FSPermission::MemorySize() const {
+  size_t cached;
+  {
+    Mutex::ScopedLock lock(decision_cache_mutex_);
+    cached = decision_cache_.Size();
+  }
+  // A cached decision keeps its path in both the recency list and the map.
+  return sizeof(*this) + granted_in_fs_.MemorySize() +
+         granted_out_fs_.MemorySize() +
+         cached * (2 * sizeof(std::string) + 4 * sizeof(void*));
+}
+
 void FSPermission::RadixTree::Insert(const std::string& path) {
   FSPermission::RadixTree::Node* current_node = root_node_;
 
@@ -247,6 +395,7 @@ void FSPermission::RadixTree::Insert(const std::string& path) {
       parent_node_prefix_len = i;
     }
   }
+  Compile();
 
   if (per_process::enabled_debug_list.enabled(DebugCategory::PERMISSION_MODEL))
       [[unlikely]] {
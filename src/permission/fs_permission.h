@@ -6,6 +6,9 @@
 #include "v8.h"
 
 #include <unordered_map>
+#include <vector>
+#include "lru_cache-inl.h"
+#include "node_mutex.h"
 #include "permission/permission_base.h"
 #include "util.h"
 
@@ -21,6 +24,7 @@ class FSPermission final : public PermissionBase {
   bool is_granted(Environment* env,
                   PermissionScope perm,
                   const std::string_view& param) const override;
+  size_t MemorySize() const override;
 
   struct RadixTree {
     struct Node {
@@ -141,17 +145,58 @@ class FSPermission final : public PermissionBase {
     void Insert(const std::string& s);
     bool Lookup(const std::string_view& s) const { return Lookup(s, false); }
     bool Lookup(const std::string_view& s, bool when_empty_return) const;
+    size_t MemorySize() const;
 
    private:
+    // The nodes are compiled after every insertion into flat arrays, where
+    // the children of a node are contiguous edges sorted by their label and
+    // the prefixes share one buffer, so that lookups do not chase pointers
+    // through hash maps.
+    struct FlatNode {
+      uint32_t prefix_offset;
+      uint32_t prefix_length;
+      uint32_t first_edge;
+      uint32_t edge_count;
+      // The child labeled '*', or kNoNode.
+      uint32_t star_child;
+      bool has_wildcard_child;
+      bool is_end;
+    };
+    struct FlatEdge {
+      char label;
+      uint32_t child;
+    };
+    static constexpr uint32_t kNoNode = UINT32_MAX;
+
+    void Compile();
+    uint32_t CompileNode(const Node* node);
+    uint32_t NextNode(const FlatNode& node,
+                      std::string_view path,
+                      size_t idx) const;
+
     Node* root_node_;
+    std::vector<FlatNode> nodes_;
+    std::vector<FlatEdge> edges_;
+    std::string prefixes_;
   };
 
  private:
   void GrantAccess(PermissionScope scope, const std::string& param);
+  bool is_tree_granted(Environment* env,
+                       PermissionScope perm,
+                       const std::string_view& param) const;
   // fs granted on startup
   RadixTree granted_in_fs_;
   RadixTree granted_out_fs_;
 
+  // The recent decisions for absolute paths, which do not depend on the
+  // working directory, keyed by the scope and the path. Every Environment
+  // has its own permissions, so this is in effect per thread.
+  static constexpr size_t kDecisionCacheSize = 64;
+  static constexpr size_t kMaxCachedPathLength = 1024;
+  mutable Mutex decision_cache_mutex_;
+  mutable LRUCache<std::string, bool> decision_cache_{kDecisionCacheSize};
+
   bool deny_all_in_ = true;
   bool deny_all_out_ = true;
 
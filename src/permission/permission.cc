@@ -11,6 +11,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace node {
@@ -175,6 +176,19 @@ void Permission::EnablePermissions() {
   }
 }
 
+void Permission::MemoryInfo(MemoryTracker* tracker) const {
+  // Several scopes share one permission, which is named after the first.
+  std::unordered_set<const PermissionBase*> seen;
+  for (int i = 0; i < static_cast<int>(PermissionScope::kPermissionsCount);
+       i++) {
+    const PermissionScope scope = static_cast<PermissionScope>(i);
+    auto it = nodes_.find(scope);
+    if (it == nodes_.end() || !seen.insert(it->second.get()).second) continue;
+    tracker->TrackFieldWithSize(PermissionToString(scope),
+                                it->second->MemorySize());
+  }
+}
+
 void Permission::Apply(Environment* env,
                        const std::vector<std::string>& allow,
                        PermissionScope scope) {
@@ -4,6 +4,7 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include "debug_utils.h"
+#include "memory_tracker.h"
 #include "node_options.h"
 #include "permission/addon_permission.h"
 #include "permission/child_process_permission.h"
@@ -85,10 +86,14 @@ namespace permission {
     MakeCallback(env()->oncomplete_string(), 1, &arg);                         \
   }
 
-class Permission {
+class Permission : public MemoryRetainer {
  public:
   Permission();
 
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(Permission)
+  SET_SELF_SIZE(Permission)
+
   FORCE_INLINE bool is_granted(Environment* env,
                                const PermissionScope permission,
                                const std::string_view& res = "") const {
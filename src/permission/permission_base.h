@@ -59,6 +59,8 @@ class PermissionBase {
   virtual bool is_granted(Environment* env,
                           PermissionScope perm,
                           const std::string_view& param = "") const = 0;
+  // The native memory the permission holds, reported by memory breakdowns.
+  virtual size_t MemorySize() const { return 0; }
 };
 
 }  // namespace permission
@@ -204,11 +204,12 @@ StreamPriority Session::Application::GetStreamPriority(const Stream& stream) {
   return StreamPriority::DEFAULT;
 }
 
-BaseObjectPtr<Packet> Session::Application::CreateStreamDataPacket() {
+BaseObjectPtr<Packet> Session::Application::CreateStreamDataPacket(
+    size_t length) {
   return Packet::Create(env(),
                         session_->endpoint(),
                         session_->remote_address(),
-                        session_->max_packet_size(),
+                        length,
                         "stream data");
 }
 
@@ -261,16 +262,28 @@ void Session::Application::SendPendingData() {
   // The number of packets that have been sent in this call to SendPendingData.
   size_t packet_send_count = 0;
 
+  // Where the endpoint supports GSO, consecutive packets for the same path
+  // are written back to back into one Packet and sent as a single datagram.
+  // Every packet but the last of such a batch must be segment_size long.
+  const size_t max_segments =
+      std::min({session_->endpoint().max_gso_segments(),
+                max_packet_count,
+                kMaxGsoBatchLength / max_packet_size});
+  size_t segments = 0;
+  size_t segment_size = 0;
+  PathStorage batch_path;
+
   BaseObjectPtr<Packet> packet;
   uint8_t* pos = nullptr;
   uint8_t* begin = nullptr;
 
   auto ensure_packet = [&] {
     if (!packet) {
-      packet = CreateStreamDataPacket();
+      packet = CreateStreamDataPacket(max_packet_size * max_segments);
       if (!packet) [[unlikely]]
         return false;
       pos = begin = ngtcp2_vec(*packet).base;
+      segments = 0;
     }
     DCHECK(packet);
     DCHECK_NOT_NULL(pos);
@@ -278,6 +291,17 @@ void Session::Application::SendPendingData() {
     return true;
   };
 
+  auto send_packet = [&] {
+    size_t datalen = pos - begin;
+    Debug(session_,
+          "Sending %zu packet(s) with %zu bytes",
+          segments,
+          datalen);
+    packet->Truncate(datalen);
+    if (segments > 1) packet->set_segment_size(segment_size);
+    session_->Send(packet, batch_path);
+  };
+
   // We're going to enter a loop here to prepare and send no more than
   // max_packet_count packets.
   for (;;) {
@@ -308,9 +332,14 @@ void Session::Application::SendPendingData() {
       Debug(session_, "Application using stream data: %s", stream_data);
     }
 
-    // Awesome, let's write our packet!
-    ssize_t nwrite =
-        WriteVStream(&path, pos, &ndatalen, max_packet_size, stream_data);
+    // Awesome, let's write our packet! Packets after the first of a batch
+    // may be no longer than the first.
+    ssize_t nwrite = WriteVStream(&path,
+                                  pos,
+                                  &ndatalen,
+                                  segments == 0 ? max_packet_size
+                                                : segment_size,
+                                  stream_data);
 
     if (ndatalen > 0) {
       Debug(session_,
@@ -408,12 +437,9 @@ void Session::Application::SendPendingData() {
       // sending again.
       if (stream_data.id >= 0) ResumeStream(stream_data.id);
 
-      // There might be a partial packet already prepared. If so, send it.
-      size_t datalen = pos - begin;
-      if (datalen) {
-        Debug(session_, "Sending packet with %zu bytes", datalen);
-        packet->Truncate(datalen);
-        session_->Send(packet, path);
+      // There might be packets already prepared. If so, send them.
+      if (pos != begin) {
+        send_packet();
       } else {
         packet->CancelPacket();
       }
@@ -421,15 +447,42 @@ void Session::Application::SendPendingData() {
       return;
     }
 
-    // At this point we have a packet prepared to send.
+    // At this point we have a packet prepared. One for another path cannot
+    // join the batch, so send the batch and start a new one with it.
+    if (segments > 0 && path != batch_path) {
+      BaseObjectPtr<Packet> next =
+          CreateStreamDataPacket(max_packet_size * max_segments);
+      if (!next) [[unlikely]] {
+        packet->CancelPacket();
+        session_->SetLastError(QuicError::ForNgtcp2Error(NGTCP2_ERR_INTERNAL));
+        closed = true;
+        return session_->Close(CloseMethod::SILENT);
+      }
+      uint8_t* next_begin = ngtcp2_vec(*next).base;
+      memcpy(next_begin, pos, nwrite);
+      send_packet();
+      packet = std::move(next);
+      pos = begin = next_begin;
+      segments = 0;
+    }
+    if (segments == 0) {
+      segment_size = nwrite;
+      path.CopyTo(&batch_path);
+    }
     pos += nwrite;
-    size_t datalen = pos - begin;
-    Debug(session_, "Sending packet with %zu bytes", datalen);
-    packet->Truncate(datalen);
-    session_->Send(packet, path);
+    segments++;
+    ++packet_send_count;
+
+    // Keep filling the batch while the packets are full sized.
+    if (static_cast<size_t>(nwrite) == segment_size &&
+        segments < max_segments && packet_send_count < max_packet_count) {
+      continue;
+    }
+
+    send_packet();
 
     // If we have sent the maximum number of packets, we're done.
-    if (++packet_send_count == max_packet_count) {
+    if (packet_send_count == max_packet_count) {
       return;
     }
 
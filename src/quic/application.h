@@ -133,7 +133,7 @@ class Session::Application : public MemoryRetainer {
   }
 
  private:
-  BaseObjectPtr<Packet> CreateStreamDataPacket();
+  BaseObjectPtr<Packet> CreateStreamDataPacket(size_t length);
 
   // Write the given stream_data into the buffer.
   ssize_t WriteVStream(PathStorage* path,
@@ -118,6 +118,8 @@ class Packet;
   V(rx_loss, "rxDiagnosticLoss")                                               \
   V(servername, "servername")                                                  \
   V(session, "Session")                                                        \
+  V(shard_count, "shardCount")                                                 \
+  V(shard_index, "shardIndex")                                                 \
   V(stream, "Stream")                                                          \
   V(success, "success")                                                        \
   V(tls_options, "tls")                                                        \
@@ -5,6 +5,8 @@
 #include <memory_tracker-inl.h>
 #include <node_mutex.h>
 #include <string_bytes.h>
+#include <map>
+#include <memory>
 #include "cid.h"
 #include "defs.h"
 #include "nbytes.h"
@@ -142,6 +144,39 @@ class RandomCIDFactory final : public CID::Factory {
   mutable uint8_t pool_[kPoolSize];
   mutable Mutex mutex_;
 };
+
+class ShardedCIDFactory final : public CID::Factory {
+ public:
+  ShardedCIDFactory(uint8_t shard_index, uint8_t shard_count)
+      : shard_index_(shard_index), shard_count_(shard_count) {}
+  DISALLOW_COPY_AND_MOVE(ShardedCIDFactory)
+
+  const CID Generate(size_t length_hint) const override {
+    CID cid = CID::Factory::random().Generate(length_hint);
+    uint8_t data[CID::kMaxLength];
+    memcpy(data, static_cast<const uint8_t*>(cid), cid.length());
+    data[0] = Route(data[0]);
+    return CID(data, cid.length());
+  }
+
+  const CID GenerateInto(ngtcp2_cid* cid,
+                         size_t length_hint = CID::kMaxLength) const override {
+    CID::Factory::random().GenerateInto(cid, length_hint);
+    cid->data[0] = Route(cid->data[0]);
+    return CID(cid);
+  }
+
+ private:
+  // Keeps the random high part of the byte and replaces its residue.
+  uint8_t Route(uint8_t byte) const {
+    unsigned value = byte - byte % shard_count_ + shard_index_;
+    if (value > 0xff) value -= shard_count_;
+    return static_cast<uint8_t>(value);
+  }
+
+  uint8_t shard_index_;
+  uint8_t shard_count_;
+};
 }  // namespace
 
 const CID::Factory& CID::Factory::random() {
@@ -149,6 +184,19 @@ const CID::Factory& CID::Factory::random() {
   return instance;
 }
 
+const CID::Factory& CID::Factory::sharded(uint8_t shard_index,
+                                          uint8_t shard_count) {
+  CHECK_GT(shard_count, 0);
+  CHECK_LT(shard_index, shard_count);
+  static Mutex mutex;
+  static std::map<uint16_t, std::unique_ptr<ShardedCIDFactory>> instances;
+  Mutex::ScopedLock lock(mutex);
+  auto& instance = instances[(shard_count << 8) | shard_index];
+  if (!instance)
+    instance = std::make_unique<ShardedCIDFactory>(shard_index, shard_count);
+  return *instance;
+}
+
 }  // namespace node::quic
 #endif  // OPENSSL_NO_QUIC
 #endif  // HAVE_OPENSS
@@ -118,6 +118,13 @@ class CID::Factory {
   // The default random CID generator instance.
   static const Factory& random();
 
+  // A random CID generator whose CIDs all satisfy
+  // data[0] % shard_count == shard_index, so that the endpoint steering a
+  // reuseport group by the first byte of the destination CID delivers every
+  // packet of a connection to the socket that owns it. The instances live
+  // for the lifetime of the process.
+  static const Factory& sharded(uint8_t shard_index, uint8_t shard_count);
+
   // TODO(@jasnell): This will soon also include additional implementations
   // of CID::Factory that implement the QUIC Load Balancers spec.
 };
@@ -314,6 +314,10 @@ using stream_id = int64_t;
 using datagram_id = uint64_t;
 
 constexpr size_t kDefaultMaxPacketLength = NGTCP2_MAX_UDP_PAYLOAD_SIZE;
+// The largest number of packets batched into one UDP GSO datagram.
+constexpr size_t kMaxGsoSegments = 10;
+// The largest UDP payload, bounding the total length of a GSO batch.
+constexpr size_t kMaxGsoBatchLength = 65507;
 constexpr uint64_t kMaxSizeT = std::numeric_limits<size_t>::max();
 constexpr uint64_t kMaxSafeJsInteger = 9007199254740991;
 constexpr auto kSocketAddressInfoTimeout = 60 * NGTCP2_SECONDS;
@@ -17,6 +17,11 @@
 #include <uv.h>
 #include <v8.h>
 #include <limits>
+#ifdef __linux__
+#include <linux/filter.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#endif
 #include "application.h"
 #include "bindingdata.h"
 #include "defs.h"
@@ -200,7 +205,15 @@ Maybe<Endpoint::Options> Endpoint::Options::From(Environment* env,
       !SET(rx_loss) || !SET(tx_loss) ||
 #endif
       !SET(udp_receive_buffer_size) || !SET(udp_send_buffer_size) ||
-      !SET(udp_ttl) || !SET(reset_token_secret) || !SET(token_secret)) {
+      !SET(udp_ttl) || !SET(reset_token_secret) || !SET(token_secret) ||
+      !SET(shard_count) || !SET(shard_index)) {
+    return Nothing<Options>();
+  }
+
+  if (options.shard_count > 0 && options.shard_index >= options.shard_count) {
+    THROW_ERR_INVALID_ARG_VALUE(env,
+                                "The shardIndex option must be less than "
+                                "shardCount");
     return Nothing<Options>();
   }
 
@@ -271,6 +284,10 @@ std::string Endpoint::Options::ToString() const {
   res +=
       prefix + "udp send buffer size: " + std::to_string(udp_send_buffer_size);
   res += prefix + "udp ttl: " + std::to_string(udp_ttl);
+  if (shard_count > 0) {
+    res += prefix + "shard: " + std::to_string(shard_index) + " of " +
+           std::to_string(shard_count);
+  }
 
   res += indent.Close();
   return res;
@@ -372,11 +389,33 @@ int Endpoint::UDP::Bind(const Options& options) {
   int flags = 0;
   if (options.local_address->family() == AF_INET6 && options.ipv6_only)
     flags |= UV_UDP_IPV6ONLY;
+  if (options.shard_count > 0) {
+#ifdef __linux__
+    flags |= UV_UDP_REUSEPORT;
+#else
+    return UV_ENOTSUP;
+#endif
+  }
   int err = uv_udp_bind(&impl_->handle_, options.local_address->data(), flags);
   int size;
 
   if (!err) {
     is_bound_ = true;
+    if (options.shard_count > 0) {
+      err = AttachShardSteering(options.shard_count);
+      if (err) return err;
+    }
+
+#if defined(__linux__) && defined(UDP_SEGMENT)
+    // The kernel knows UDP_SEGMENT if it can be read back.
+    uv_os_fd_t fd;
+    int segment_size = 0;
+    socklen_t optlen = sizeof(segment_size);
+    is_gso_supported_ =
+        uv_fileno(reinterpret_cast<uv_handle_t*>(&impl_->handle_), &fd) == 0 &&
+        getsockopt(fd, SOL_UDP, UDP_SEGMENT, &segment_size, &optlen) == 0;
+#endif
+
     size = static_cast<int>(options.udp_receive_buffer_size);
     if (size > 0) {
       err = uv_recv_buffer_size(reinterpret_cast<uv_handle_t*>(&impl_->handle_),
@@ -401,6 +440,41 @@ int Endpoint::UDP::Bind(const Options& options) {
   return err;
 }
 
+// Steers the datagrams arriving on the reuseport group this socket belongs to
+// by destination CID: the first byte after the version and DCID length of a
+// long header packet, the first byte after the flags of a short header one.
+// The group is indexed in bind order, so shard i must be the i-th to bind.
+// Packets too short to hold a CID have the loads fail, which delivers them
+// to the first socket.
+int Endpoint::UDP::AttachShardSteering(uint8_t shard_count) {
+#ifdef __linux__
+  sock_filter code[] = {
+      // A = packet[0]; long header packets have the high bit set.
+      BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+      BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x80, 0, 2),
+      BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 6),
+      BPF_JUMP(BPF_JMP | BPF_JA, 1, 0, 0),
+      BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 1),
+      BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, shard_count),
+      BPF_STMT(BPF_RET | BPF_A, 0),
+  };
+  sock_fprog program = {static_cast<unsigned short>(arraysize(code)), code};
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&impl_->handle_), &fd);
+  if (err) return err;
+  if (setsockopt(fd,
+                 SOL_SOCKET,
+                 SO_ATTACH_REUSEPORT_CBPF,
+                 &program,
+                 sizeof(program)) != 0) {
+    return uv_translate_sys_error(errno);
+  }
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
 void Endpoint::UDP::Ref() {
   if (!is_closed_or_closing()) {
     uv_ref(reinterpret_cast<uv_handle_t*>(&impl_->handle_));
@@ -492,6 +566,50 @@ int Endpoint::UDP::Send(const BaseObjectPtr<Packet>& packet) {
   return err;
 }
 
+int Endpoint::UDP::TrySendSegmented(const BaseObjectPtr<Packet>& packet) {
+  DCHECK(packet);
+  DCHECK_GT(packet->segment_size(), 0);
+  if (is_closed_or_closing()) return UV_EBADF;
+#if defined(__linux__) && defined(UDP_SEGMENT)
+  if (!is_gso_supported_) return UV_ENOTSUP;
+  // Datagrams still queued in libuv must go out first.
+  if (uv_udp_get_send_queue_count(&impl_->handle_) > 0) return UV_EAGAIN;
+
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&impl_->handle_), &fd);
+  if (err) return err;
+
+  uv_buf_t buf = *packet;
+  iovec iov = {buf.base, buf.len};
+  char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+  msghdr msg = {};
+  msg.msg_name = const_cast<sockaddr*>(packet->destination().data());
+  msg.msg_namelen = packet->destination().length();
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  uint16_t segment_size = static_cast<uint16_t>(packet->segment_size());
+  memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+
+  ssize_t nsent;
+  do {
+    nsent = sendmsg(fd, &msg, 0);
+  } while (nsent == -1 && errno == EINTR);
+  if (nsent == -1) {
+    err = uv_translate_sys_error(errno);
+    return err == UV_ENOBUFS ? UV_EAGAIN : err;
+  }
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
 void Endpoint::UDP::MemoryInfo(MemoryTracker* tracker) const {
   if (impl_) tracker->TrackField("impl", impl_);
 }
@@ -736,6 +854,36 @@ void Endpoint::Send(const BaseObjectPtr<Packet>& packet) {
     return;
   }
   Debug(this, "Sending %s", packet->ToString());
+
+  if (packet->segment_size() > 0) {
+    int err = udp_.TrySendSegmented(packet);
+    if (err == 0) {
+      // Sent synchronously, so there is no send callback to wait for.
+      STAT_INCREMENT_N(Stats, bytes_sent, packet->length());
+      STAT_INCREMENT_N(Stats, packets_sent, packet->segment_count());
+      packet->Done();
+      return;
+    }
+    if (err != UV_EAGAIN) {
+      // E.g. EIO when the device cannot checksum segmented datagrams.
+      Debug(this, "Disabling GSO after error %d", err);
+      udp_.DisableGso();
+    }
+    // Fall back to one datagram per packet.
+    uv_buf_t buf = *packet;
+    size_t segment_size = packet->segment_size();
+    for (size_t offset = 0; offset < buf.len; offset += segment_size) {
+      size_t len = std::min(segment_size, buf.len - offset);
+      auto segment = Packet::Create(
+          env(), this, packet->destination(), len, "gso segment");
+      if (!segment) break;
+      memcpy(uv_buf_t(*segment).base, buf.base + offset, len);
+      Send(segment);
+    }
+    packet->Done();
+    return;
+  }
+
   state_->pending_callbacks++;
   int err = udp_.Send(packet);
   if (err != 0) {
@@ -747,6 +895,10 @@ void Endpoint::Send(const BaseObjectPtr<Packet>& packet) {
   STAT_INCREMENT(Stats, packets_sent);
 }
 
+size_t Endpoint::max_gso_segments() const {
+  return udp_.is_gso_supported() ? kMaxGsoSegments : 1;
+}
+
 void Endpoint::SendRetry(const PathDescriptor& options) {
   // Generating and sending retry packets does consume some system resources,
   // and it is possible for a malicious peer to trigger sending a large number
@@ -880,6 +1032,16 @@ bool Endpoint::Start() {
   return true;
 }
 
+Session::Options Endpoint::WithShardCIDs(
+    const Session::Options& options) const {
+  Session::Options result = options;
+  if (options_.shard_count > 0) {
+    result.cid_factory =
+        &CID::Factory::sharded(options_.shard_index, options_.shard_count);
+  }
+  return result;
+}
+
 void Endpoint::Listen(const Session::Options& options) {
   if (is_closed() || is_closing() || state_->listening == 1) return;
   DCHECK(!server_state_.has_value());
@@ -903,7 +1065,7 @@ void Endpoint::Listen(const Session::Options& options) {
   }
 
   server_state_ = {
-      options,
+      WithShardCIDs(options),
       std::move(context),
   };
   if (Start()) {
@@ -919,7 +1081,8 @@ BaseObjectPtr<Session> Endpoint::Connect(
   // If starting fails, the endpoint will be destroyed.
   if (!Start()) return {};
 
-  Session::Config config(env(), options, local_address(), remote_address);
+  Session::Config config(
+      env(), WithShardCIDs(options), local_address(), remote_address);
 
   Debug(this,
         "Connecting to %s with options %s and config %s [has 0rtt ticket? %s]",
@@ -133,6 +133,17 @@ class Endpoint final : public AsyncWrap, public Packet::Listener {
     // Setting to 0 uses the default.
     uint8_t udp_ttl = 0;
 
+    // Receive-side sharding across threads. When shard_count is non-zero,
+    // the socket joins a SO_REUSEPORT group with the other shard_count - 1
+    // endpoints bound to the same local_address, one per Worker, in
+    // shard_index order. Incoming datagrams are steered to the socket whose
+    // index matches the first byte of their destination CID modulo
+    // shard_count, and the CIDs this endpoint issues are chosen to match its
+    // own index, so each connection is processed on the thread that owns
+    // it. Only supported on Linux.
+    uint8_t shard_count = 0;
+    uint8_t shard_index = 0;
+
     void MemoryInfo(MemoryTracker* tracker) const override;
     SET_MEMORY_INFO_NAME(Endpoint::Config)
     SET_SELF_SIZE(Options)
@@ -191,6 +202,10 @@ class Endpoint final : public AsyncWrap, public Packet::Listener {
 
   void Send(const BaseObjectPtr<Packet>& packet);
 
+  // The largest number of packets a session may batch into one UDP GSO
+  // datagram on this endpoint, 1 when GSO is not available.
+  size_t max_gso_segments() const;
+
   // Generates and sends a retry packet. This is terminal for the connection.
   // Retry packets are used to force explicit path validation by issuing a token
   // to the peer that it must thereafter include in all subsequent initial
@@ -256,6 +271,12 @@ class Endpoint final : public AsyncWrap, public Packet::Listener {
     void Stop();
     void Close();
     int Send(const BaseObjectPtr<Packet>& packet);
+    // Sends a GSO batch synchronously with a single sendmsg(). Returns
+    // UV_EAGAIN when the batch cannot be sent right now without reordering
+    // it behind queued sends, and UV_ENOTSUP where GSO is unavailable.
+    int TrySendSegmented(const BaseObjectPtr<Packet>& packet);
+    bool is_gso_supported() const { return is_gso_supported_; }
+    void DisableGso() { is_gso_supported_ = false; }
 
     // Returns the local UDP socket address to which we are bound,
     // or fail with an assert if we are not bound.
@@ -276,8 +297,11 @@ class Endpoint final : public AsyncWrap, public Packet::Listener {
    private:
     class Impl;
 
+    int AttachShardSteering(uint8_t shard_count);
+
     BaseObjectWeakPtr<Impl> impl_;
     bool is_bound_ = false;
+    bool is_gso_supported_ = false;
     bool is_started_ = false;
     bool is_closed_ = false;
   };
@@ -288,6 +312,9 @@ class Endpoint final : public AsyncWrap, public Packet::Listener {
 
   bool Start();
 
+  // Sessions of a sharded endpoint issue CIDs that route back to it.
+  Session::Options WithShardCIDs(const Session::Options& options) const;
+
   // Destroy the endpoint if...
   // * There are no sessions,
   // * There are no sent packets with pending done callbacks, and
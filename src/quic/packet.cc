@@ -29,6 +29,7 @@ namespace {
 static constexpr size_t kRandlen = NGTCP2_MIN_STATELESS_RESET_RANDLEN * 5;
 static constexpr size_t kMinStatelessResetLen = 41;
 static constexpr size_t kMaxFreeList = 100;
+static constexpr size_t kMaxRecycledLength = 16 * kDefaultMaxPacketLength;
 }  // namespace
 
 std::string PathDescriptor::ToString() const {
@@ -50,7 +51,7 @@ struct Packet::Data final : public MemoryRetainer {
   // The diagnostic_label_ is used only as a debugging tool when
   // logging debug information about the packet. It identifies
   // the purpose of the packet.
-  const std::string diagnostic_label_;
+  const char* diagnostic_label_;
 
   void MemoryInfo(MemoryTracker* tracker) const override {
     tracker->TrackFieldWithSize("data", data_.length());
@@ -58,11 +59,19 @@ struct Packet::Data final : public MemoryRetainer {
   SET_MEMORY_INFO_NAME(Data)
   SET_SELF_SIZE(Data)
 
-  Data(size_t length, std::string_view diagnostic_label)
+  Data(size_t length, const char* diagnostic_label)
       : diagnostic_label_(diagnostic_label) {
     data_.AllocateSufficientStorage(length);
   }
 
+  // Prepares recycled storage for a new packet. The previous contents are
+  // not preserved.
+  void Reset(size_t length, const char* diagnostic_label) {
+    diagnostic_label_ = diagnostic_label;
+    data_.SetLength(0);
+    data_.AllocateSufficientStorage(length);
+  }
+
   size_t length() const { return data_.length(); }
   operator uv_buf_t() {
     return uv_buf_init(reinterpret_cast<char*>(data_.out()), data_.length());
@@ -70,7 +79,7 @@ struct Packet::Data final : public MemoryRetainer {
   operator ngtcp2_vec() { return ngtcp2_vec{data_.out(), data_.length()}; }
 
   std::string ToString() const {
-    return diagnostic_label_ + ", " + std::to_string(length());
+    return std::string(diagnostic_label_) + ", " + std::to_string(length());
   }
 };
 
@@ -96,6 +105,11 @@ void Packet::Truncate(size_t len) {
   data_->data_.SetLength(len);
 }
 
+size_t Packet::segment_count() const {
+  if (segment_size_ == 0) return 1;
+  return (length() + segment_size_ - 1) / segment_size_;
+}
+
 JS_CONSTRUCTOR_IMPL(Packet, packet_constructor_template, {
   JS_ILLEGAL_CONSTRUCTOR();
   JS_INHERIT(ReqWrap<uv_udp_send_t>);
@@ -113,22 +127,28 @@ BaseObjectPtr<Packet> Packet::Create(Environment* env,
         env, listener, obj, destination, length, diagnostic_label);
   }
 
-  return FromFreeList(env,
-                      std::make_shared<Data>(length, diagnostic_label),
-                      listener,
-                      destination);
+  auto packet = FromFreeList(env, nullptr, listener, destination);
+  if (packet->data_) {
+    packet->data_->Reset(length, diagnostic_label);
+  } else {
+    packet->data_ = std::make_shared<Data>(length, diagnostic_label);
+  }
+  return packet;
 }
 
 BaseObjectPtr<Packet> Packet::Clone() const {
   // Cloning is copy-free. Our data_ is a shared_ptr so we can just
   // share it with the cloned packet.
   auto& binding = BindingData::Get(env());
+  BaseObjectPtr<Packet> packet;
   if (binding.packet_freelist.empty()) {
     JS_NEW_INSTANCE_OR_RETURN(env(), obj, {});
-    return MakeBaseObject<Packet>(env(), listener_, obj, destination_, data_);
+    packet = MakeBaseObject<Packet>(env(), listener_, obj, destination_, data_);
+  } else {
+    packet = FromFreeList(env(), data_, listener_, destination_);
   }
-
-  return FromFreeList(env(), data_, listener_, destination_);
+  packet->segment_size_ = segment_size_;
+  return packet;
 }
 
 BaseObjectPtr<Packet> Packet::FromFreeList(Environment* env,
@@ -143,7 +163,8 @@ BaseObjectPtr<Packet> Packet::FromFreeList(Environment* env,
   CHECK_EQ(env, obj->env());
   auto packet = BaseObjectPtr<Packet>(static_cast<Packet*>(obj.get()));
   Debug(packet.get(), "Reusing packet from freelist");
-  packet->data_ = std::move(data);
+  // A null data keeps the storage recycled with the packet, if any.
+  if (data) packet->data_ = std::move(data);
   packet->destination_ = destination;
   packet->listener_ = listener;
   return packet;
@@ -194,7 +215,11 @@ void Packet::Done(int status) {
 
   Debug(this, "Returning packet to freelist");
   listener_ = nullptr;
-  data_.reset();
+  segment_size_ = 0;
+  // Keep the payload storage for the next user of this packet, unless a
+  // clone still refers to it or it is an unusually large GSO buffer.
+  if (data_.use_count() != 1 || data_->data_.capacity() > kMaxRecycledLength)
+    data_.reset();
   Reset();
   binding.packet_freelist.push_back(std::move(self));
 }
@@ -40,7 +40,12 @@ struct PathDescriptor final {
 // performance optimization to avoid excessive allocation churn when creating
 // lots of packets since each one is ReqWrap and has a fair amount of associated
 // overhead. However, we don't want to accumulate too many of these in the
-// freelist either, so we cap the size.
+// freelist either, so we cap the size. A packet in the freelist keeps its
+// payload storage unless a clone still shares it, so reusing a packet
+// usually does not allocate either.
+//
+// A packet may hold several QUIC packets of segment_size() bytes each (the
+// last one may be shorter) that are sent as one UDP GSO datagram.
 //
 // Packets are always encrypted so their content should be considered opaque
 // to us. We leave it entirely up to ngtcp2 how to encode QUIC frames into
@@ -87,6 +92,12 @@ class Packet final : public ReqWrap<uv_udp_send_t> {
   // tells us how many of the packets bytes were used.
   void Truncate(size_t len);
 
+  // When non-zero, the payload is a GSO batch of packets this long.
+  size_t segment_size() const { return segment_size_; }
+  void set_segment_size(size_t size) { segment_size_ = size; }
+  // The number of QUIC packets in the payload.
+  size_t segment_count() const;
+
   // Create (or acquire from the freelist) a Packet with the given
   // destination and length. The diagnostic_label is used to help
   // identify the packet purpose in debugging output.
@@ -149,6 +160,7 @@ class Packet final : public ReqWrap<uv_udp_send_t> {
   Listener* listener_;
   SocketAddress destination_;
   std::shared_ptr<Data> data_;
+  size_t segment_size_ = 0;
 };
 
 }  // namespace node::quic
@@ -0,0 +1,101 @@
+#include "read_buffer_pool.h"
+#include "util-inl.h"
+
+#include <cstdlib>
+
+namespace node {
+
+using v8::ArrayBuffer;
+using v8::BackingStore;
+using v8::BackingStoreInitializationMode;
+using v8::Isolate;
+
+ReadBufferPool* ReadBufferPool::Create() {
+  return new ReadBufferPool();
+}
+
+void ReadBufferPool::Detach(ReadBufferPool* pool) {
+  {
+    Mutex::ScopedLock lock(pool->mutex_);
+    CHECK(!pool->detached_);
+    pool->detached_ = true;
+    for (std::vector<void*>& free_list : pool->free_lists_) {
+      for (void* chunk : free_list) free(chunk);
+      free_list.clear();
+    }
+  }
+  pool->Unref();
+}
+
+ReadBufferPool::~ReadBufferPool() {
+  for (const std::vector<void*>& free_list : free_lists_)
+    CHECK(free_list.empty());
+}
+
+size_t ReadBufferPool::SizeClassFor(size_t length) {
+  if (length < kMinPooledLength) return kSizeClassCount;
+  size_t index = 0;
+  while (index < kSizeClassCount && kSizeClasses[index] < length) index++;
+  return index;
+}
+
+std::unique_ptr<BackingStore> ReadBufferPool::NewBackingStore(Isolate* isolate,
+                                                              size_t length) {
+  const size_t index = SizeClassFor(length);
+#if defined(V8_ENABLE_SANDBOX)
+  // ArrayBuffer memory has to come from inside the sandbox.
+  const bool pooled = false;
+#else
+  const bool pooled = index < kSizeClassCount;
+#endif
+  void* chunk = nullptr;
+  if (pooled) {
+    {
+      Mutex::ScopedLock lock(mutex_);
+      std::vector<void*>& free_list = free_lists_[index];
+      if (!free_list.empty()) {
+        chunk = free_list.back();
+        free_list.pop_back();
+      }
+    }
+    if (chunk == nullptr) chunk = UncheckedMalloc(kSizeClasses[index]);
+  }
+  if (chunk == nullptr) {
+    return ArrayBuffer::NewBackingStore(
+        isolate, length, BackingStoreInitializationMode::kUninitialized);
+  }
+
+  refs_++;
+  return ArrayBuffer::NewBackingStore(chunk, length, Release, this);
+}
+
+void ReadBufferPool::Release(void* data, size_t length, void* deleter_data) {
+  ReadBufferPool* pool = static_cast<ReadBufferPool*>(deleter_data);
+  const size_t index = SizeClassFor(length);
+  CHECK_LT(index, kSizeClassCount);
+  {
+    Mutex::ScopedLock lock(pool->mutex_);
+    std::vector<void*>& free_list = pool->free_lists_[index];
+    if (!pool->detached_ && (free_list.size() + 1) * kSizeClasses[index] <=
+                                kMaxCachedBytesPerClass) {
+      free_list.push_back(data);
+      data = nullptr;
+    }
+  }
+  free(data);
+  pool->Unref();
+}
+
+void ReadBufferPool::Unref() {
+  if (refs_.fetch_sub(1) == 1) delete this;
+}
+
+size_t ReadBufferPool::CachedChunks() {
+  Mutex::ScopedLock lock(mutex_);
+  size_t count = 0;
+  for (const std::vector<void*>& free_list : free_lists_)
+    count += free_list.size();
+  return count;
+}
+
+}  // namespace node
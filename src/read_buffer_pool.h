@@ -0,0 +1,70 @@
+#ifndef SRC_READ_BUFFER_POOL_H_
+#define SRC_READ_BUFFER_POOL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_mutex.h"
+#include "util.h"
+#include "v8.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace node {
+
+// Recycles the memory behind the ArrayBuffers that streams read into, in a
+// few fixed size classes. A read that fills its chunk is handed to JS as is,
+// a shorter one is copied into the smallest class that holds it. When V8
+// frees such a BackingStore, possibly on a background thread, the chunk goes
+// back onto a free list instead of to the allocator.
+//
+// The owning Environment holds one reference and every chunk in use holds
+// another, so chunks may outlive the Environment that handed them out.
+class ReadBufferPool {
+ public:
+  static constexpr size_t kSizeClasses[] = {8 * 1024, 16 * 1024, 64 * 1024};
+  static constexpr size_t kSizeClassCount = arraysize(kSizeClasses);
+  // Shorter buffers are allocated exactly, so that many small chunks kept
+  // alive by JS do not each pin a whole size class.
+  static constexpr size_t kMinPooledLength = kSizeClasses[0] / 2;
+  // Idle memory each size class keeps around at most.
+  static constexpr size_t kMaxCachedBytesPerClass = 1024 * 1024;
+
+  static ReadBufferPool* Create();
+  // Drops the Environment's reference. Cached chunks are freed right away,
+  // those still in use when their BackingStore is.
+  static void Detach(ReadBufferPool* pool);
+
+  ReadBufferPool(const ReadBufferPool&) = delete;
+  ReadBufferPool& operator=(const ReadBufferPool&) = delete;
+
+  // Returns a BackingStore of exactly `length` bytes. It is backed by a
+  // pooled chunk if `length` lies between kMinPooledLength and the largest
+  // size class, and by a plain allocation otherwise.
+  std::unique_ptr<v8::BackingStore> NewBackingStore(v8::Isolate* isolate,
+                                                    size_t length);
+
+  size_t CachedChunks();
+
+ private:
+  ReadBufferPool() = default;
+  ~ReadBufferPool();
+
+  // Index into kSizeClasses of the chunk for `length` bytes, or
+  // kSizeClassCount if such buffers are not pooled.
+  static size_t SizeClassFor(size_t length);
+  static void Release(void* data, size_t length, void* deleter_data);
+  void Unref();
+
+  Mutex mutex_;
+  std::atomic<size_t> refs_{1};
+  bool detached_ = false;
+  std::vector<void*> free_lists_[kSizeClassCount];
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_READ_BUFFER_POOL_H_
@@ -5,8 +5,11 @@
 
 #include "req_wrap.h"
 #include "async_wrap-inl.h"
+#include "threadpool_metrics.h"
 #include "uv.h"
 
+#include <type_traits>
+
 namespace node {
 
 ReqWrapBase::ReqWrapBase(Environment* env) {
@@ -59,6 +62,13 @@ AsyncWrap* ReqWrap<T>::GetAsyncWrap() {
   return this;
 }
 
+// The libuv requests that run on the threadpool, and so are reported by
+// threadpool_metrics.
+template <typename T>
+constexpr bool kIsThreadpoolRequest = std::is_same_v<T, uv_fs_t> ||
+                                      std::is_same_v<T, uv_getaddrinfo_t> ||
+                                      std::is_same_v<T, uv_getnameinfo_t>;
+
 // Below is dark template magic designed to invoke libuv functions that
 // initialize uv_req_t instances in a unified fashion, to allow easier
 // tracking of active/inactive requests.
@@ -127,6 +137,16 @@ struct MakeLibuvRequestCallback<ReqT, void(*)(ReqT*, Args...)> {
     BaseObjectPtr<ReqWrap<ReqT>> req_wrap{ReqWrap<ReqT>::from_req(req)};
     req_wrap->Detach();
     req_wrap->env()->DecreaseWaitingRequestCounter();
+    if constexpr (kIsThreadpoolRequest<ReqT>) {
+      if (req_wrap->dispatched_at_ != 0) [[unlikely]] {
+        threadpool_metrics::RecordRequest(
+            std::is_same_v<ReqT, uv_fs_t> ? threadpool_metrics::Category::kFs
+                                          : threadpool_metrics::Category::kDns,
+            req_wrap->dispatched_at_,
+            uv_hrtime());
+        req_wrap->dispatched_at_ = 0;
+      }
+    }
     F original_callback = reinterpret_cast<F>(req_wrap->original_callback_);
     original_callback(req, args...);
   }
@@ -143,6 +163,9 @@ template <typename T>
 template <typename LibuvFunction, typename... Args>
 int ReqWrap<T>::Dispatch(LibuvFunction fn, Args... args) {
   Dispatched();
+  if constexpr (kIsThreadpoolRequest<T>) {
+    dispatched_at_ = threadpool_metrics::IsEnabled() ? uv_hrtime() : 0;
+  }
   // This expands as:
   //
   // int err = fn(env()->event_loop(), req(), arg1, arg2, Wrapper, arg3, ...)
@@ -58,6 +58,9 @@ class ReqWrap : public AsyncWrap, public ReqWrapBase {
  public:
   typedef void (*callback_t)();
   callback_t original_callback_ = nullptr;
+  // Set by Dispatch() while threadpool metrics are enabled, for requests
+  // that run on the threadpool.
+  uint64_t dispatched_at_ = 0;
 
  protected:
   // req_wrap_queue_ needs to be at a fixed offset from the start of the class
@@ -1,251 +1,227 @@
-#include "simd_abstraction.h"
-#include <stdint.h>
+#include "simd_kernels.h"
+#include "uv.h"
+
+#include <string.h>
+
+/*
+ * Kernel registry
+ *
+ * Every entry describes the kernels one instruction set provides and the CPU
+ * features it needs. Entries are listed from the most to the least preferred;
+ * for each slot of simd_functions_t the first usable entry that implements
+ * it wins. The scalar entry must stay last and must fill every slot.
+ */
+typedef struct {
+    simd_instruction_set_t isa;
+    unsigned required_features;
+    const simd_functions_t* funcs;
+} simd_kernel_set_t;
+
+static const simd_kernel_set_t simd_kernel_sets[] = {
+#if defined(SIMD_HAVE_SSE2_KERNELS)
+    { SIMD_SSE2, SIMD_FEATURE_SSE2, &simd_sse2_functions },
+#endif
+#if defined(SIMD_HAVE_3DNOW_KERNELS)
+    { SIMD_3DNOW, SIMD_FEATURE_3DNOW, &simd_3dnow_functions },
+#endif
+#if defined(SIMD_HAVE_MMXEXT_KERNELS)
+    { SIMD_MMXEXT, SIMD_FEATURE_MMXEXT, &simd_mmxext_functions },
+#endif
+#if defined(SIMD_HAVE_ALTIVEC_KERNELS)
+    { SIMD_ALTIVEC, SIMD_FEATURE_ALTIVEC, &simd_altivec_functions },
+#endif
+    { SIMD_SCALAR, 0, &simd_scalar_functions },
+};
 
-/* Define SIMD instruction set constants */
+#define SIMD_KERNEL_SET_COUNT \
+    (sizeof(simd_kernel_sets) / sizeof(simd_kernel_sets[0]))
+
+static uv_once_t simd_init_once = UV_ONCE_INIT;
+static unsigned simd_cpu_features = 0;
 static simd_instruction_set_t current_simd_instruction_set = SIMD_NONE;
+static simd_functions_t simd_funcs;
+static simd_kernel_selection_t simd_selection;
+static simd_kernel_thresholds_t simd_thresholds;
 
-/* Function pointers for SIMD operations */
-static simd_functions_t simd_funcs = {0};
+#if defined(SIMD_HAVE_MMXEXT_KERNELS) || defined(SIMD_HAVE_3DNOW_KERNELS)
+__thread int simd_mmx_batch_depth = 0;
+#endif
 
-/* Initialize SIMD function pointers based on runtime detection */
-static void init_simd_functions(void) {
-    /* Initialize function pointers based on detected SIMD capabilities */
+static unsigned detect_simd_cpu_features(void) {
+    unsigned features = 0;
+#if defined(SIMD_ARCH_X86) || defined(SIMD_ARCH_PPC)
     cpu_check_features(); /* Ensure CPU features are detected */
-    
-    #if defined(USE_SSE2)
-        /* Initialize SSE2 function pointers */
-        #ifdef __SSE2__
-        #include <emmintrin.h>
-        simd_funcs.add_ps = sse2_add_ps;
-        simd_funcs.mul_ps = sse2_mul_ps;
-        simd_funcs.sub_ps = sse2_sub_ps;
-        simd_funcs.add_epi32 = sse2_add_epi32;
-        simd_funcs.shuffle_epi32 = sse2_shuffle_epi32;
-        current_simd_instruction_set = SIMD_SSE2;
-        #endif
-    #elif defined(USE_3DNOW)
-        /* Initialize 3DNow! function pointers */
-        #ifdef __3dNOW__
-        #include <mm3dnow.h>
-        simd_funcs.add_ps = d3now_add_ps;
-        simd_funcs.mul_ps = d3now_mul_ps;
-        simd_funcs.sub_ps = d3now_sub_ps;
-        /* Note: 3DNow! has limited integer operations */
-        simd_funcs.add_epi32 = scalar_add_epi32;  /* Fallback to scalar */
-        simd_funcs.shuffle_epi32 = scalar_shuffle_epi32;  /* Fallback to scalar */
-        current_simd_instruction_set = SIMD_3DNOW;
-        #endif
-    #elif defined(USE_ALTIVEC)
-        /* Initialize Altivec function pointers */
-        #ifdef __ALTIVEC__
-        #include <altivec.h>
-        simd_funcs.add_ps = altivec_add_ps;
-        simd_funcs.mul_ps = altivec_mul_ps;
-        simd_funcs.sub_ps = altivec_sub_ps;
-        simd_funcs.add_epi32 = altivec_add_epi32;
-        simd_funcs.shuffle_epi32 = altivec_shuffle_epi32;
-        current_simd_instruction_set = SIMD_ALTIVEC;
-        #endif
-    #else
-        /* Use scalar implementations */
-        simd_funcs.add_ps = scalar_add_ps;
-        simd_funcs.mul_ps = scalar_mul_ps;
-        simd_funcs.sub_ps = scalar_sub_ps;
-        simd_funcs.add_epi32 = scalar_add_epi32;
-        simd_funcs.shuffle_epi32 = scalar_shuffle_epi32;
-        current_simd_instruction_set = SIMD_SCALAR;
-    #endif
-}
-
-/* SSE2 implementations */
-#ifdef __SSE2__
-#include <emmintrin.h>
-
-static void sse2_add_ps(void* a, void* b, void* result) {
-    __m128* va = (__m128*)a;
-    __m128* vb = (__m128*)b;
-    __m128* vr = (__m128*)result;
-    *vr = _mm_add_ps(*va, *vb);
-}
-
-static void sse2_mul_ps(void* a, void* b, void* result) {
-    __m128* va = (__m128*)a;
-    __m128* vb = (__m128*)b;
-    __m128* vr = (__m128*)result;
-    *vr = _mm_mul_ps(*va, *vb);
-}
-
-static void sse2_sub_ps(void* a, void* b, void* result) {
-    __m128* va = (__m128*)a;
-    __m128* vb = (__m128*)b;
-    __m128* vr = (__m128*)result;
-    *vr = _mm_sub_ps(*va, *vb);
-}
-
-static void sse2_add_epi32(void* a, void* b, void* result) {
-    __m128i* va = (__m128i*)a;
-    __m128i* vb = (__m128i*)b;
-    __m128i* vr = (__m128i*)result;
-    *vr = _mm_add_epi32(*va, *vb);
-}
-
-static void sse2_shuffle_epi32(void* a, int mask, void* result) {
-    __m128i* va = (__m128i*)a;
-    __m128i* vr = (__m128i*)result;
-    *vr = _mm_shuffle_epi32(*va, mask);
-}
 #endif
-
-/* 3DNow! implementations */
-#ifdef __3dNOW__
-#include <mm3dnow.h>
-
-static void d3now_add_ps(void* a, void* b, void* result) {
-    __m64* va = (__m64*)a;
-    __m64* vb = (__m64*)b;
-    __m64* vr = (__m64*)result;
-    
-    // 3DNow! operates on 2 floats at a time
-    *vr = _mm_add_pi32(*va, *vb);
-    // Note: This is a simplified example - 3DNow! has specific instructions like pfadd
-    // that need proper usage
-}
-
-static void d3now_mul_ps(void* a, void* b, void* result) {
-    __m64* va = (__m64*)a;
-    __m64* vb = (__m64*)b;
-    __m64* vr = (__m64*)result;
-    
-    // 3DNow! specific multiplication
-    *vr = _mm_mul_pi32(*va, *vb);
-}
-
-static void d3now_sub_ps(void* a, void* b, void* result) {
-    __m64* va = (__m64*)a;
-    __m64* vb = (__m64*)b;
-    __m64* vr = (__m64*)result;
-    
-    *vr = _mm_sub_pi32(*va, *vb);
-}
+#if defined(SIMD_ARCH_X86)
+    if (x86_cpu_enable_sse2) features |= SIMD_FEATURE_SSE2;
+    if (x86_cpu_enable_ssse3) features |= SIMD_FEATURE_SSSE3;
+    if (x86_cpu_enable_simd) features |= SIMD_FEATURE_SSE4_2_PCLMUL;
+    if (x86_cpu_enable_avx512) features |= SIMD_FEATURE_AVX512;
+    if (x86_cpu_enable_3dnow) features |= SIMD_FEATURE_3DNOW;
+    if (x86_cpu_enable_3dnowext) features |= SIMD_FEATURE_3DNOWEXT;
+    if (x86_cpu_enable_mmxext) features |= SIMD_FEATURE_MMXEXT;
+#elif defined(SIMD_ARCH_PPC)
+    if (ppc_cpu_enable_altivec) features |= SIMD_FEATURE_ALTIVEC;
 #endif
-
-/* Altivec implementations */
-#ifdef __ALTIVEC__
-#include <altivec.h>
-
-static void altivec_add_ps(void* a, void* b, void* result) {
-    vector float* va = (vector float*)a;
-    vector float* vb = (vector float*)b;
-    vector float* vr = (vector float*)result;
-    *vr = vec_add(*va, *vb);
+    return features;
 }
 
-static void altivec_mul_ps(void* a, void* b, void* result) {
-    vector float* va = (vector float*)a;
-    vector float* vb = (vector float*)b;
-    vector float* vr = (vector float*)result;
-    *vr = vec_madd(*va, *vb, vec_splat_u32(0));  // For multiply, we use vec_mul or vec_madd
-}
+/* Initialize SIMD function pointers based on runtime detection */
+static void init_simd_functions(void) {
+    size_t best = SIMD_KERNEL_SET_COUNT - 1;
+
+    simd_cpu_features = detect_simd_cpu_features();
+
+    for (size_t i = 0; i < SIMD_KERNEL_SET_COUNT; i++) {
+        const simd_kernel_set_t* set = &simd_kernel_sets[i];
+        if ((set->required_features & simd_cpu_features) !=
+            set->required_features) {
+            continue;
+        }
+#define V(name, ret, args)                                                    \
+        if (simd_funcs.name == NULL && set->funcs->name != NULL) {            \
+            simd_funcs.name = set->funcs->name;                               \
+            simd_selection.name = set->isa;                                   \
+            if (i < best) best = i;                                           \
+        }
+        SIMD_KERNELS(V)
+#undef V
+    }
 
-static void altivec_sub_ps(void* a, void* b, void* result) {
-    vector float* va = (vector float*)a;
-    vector float* vb = (vector float*)b;
-    vector float* vr = (vector float*)result;
-    *vr = vec_sub(*va, *vb);
+    current_simd_instruction_set = simd_kernel_sets[best].isa;
 }
 
-static void altivec_add_epi32(void* a, void* b, void* result) {
-    vector signed int* va = (vector signed int*)a;
-    vector signed int* vb = (vector signed int*)b;
-    vector signed int* vr = (vector signed int*)result;
-    *vr = vec_add(*va, *vb);
+/* Public API functions */
+simd_instruction_set_t get_active_simd_instruction_set(void) {
+    uv_once(&simd_init_once, init_simd_functions);
+    return current_simd_instruction_set;
 }
 
-static void altivec_shuffle_epi32(void* a, int mask, void* result) {
-    vector signed int* va = (vector signed int*)a;
-    vector signed int* vr = (vector signed int*)result;
-    
-    // Use vec_perm for shuffling, which requires a permutation vector
-    // This is a simplified implementation
-    vector unsigned char perm_vec = vec_lvsl(0, (int*)mask);  // This is just an example
-    *vr = vec_perm(*va, *va, (vector unsigned char)perm_vec);
+const simd_functions_t* get_simd_functions(void) {
+    uv_once(&simd_init_once, init_simd_functions);
+    return &simd_funcs;
 }
-#endif
 
-/* Scalar implementations as fallback */
-static void scalar_add_ps(void* a, void* b, void* result) {
-    float* fa = (float*)a;
-    float* fb = (float*)b;
-    float* fr = (float*)result;
-    for (int i = 0; i < 4; i++) {
-        fr[i] = fa[i] + fb[i];
+const simd_functions_t* get_simd_functions_for(simd_instruction_set_t instruction_set) {
+    unsigned features = get_simd_cpu_features();
+    for (size_t i = 0; i < SIMD_KERNEL_SET_COUNT; i++) {
+        const simd_kernel_set_t* set = &simd_kernel_sets[i];
+        if (set->isa == instruction_set &&
+            (set->required_features & features) == set->required_features) {
+            return set->funcs;
+        }
     }
+    return NULL;
 }
 
-static void scalar_mul_ps(void* a, void* b, void* result) {
-    float* fa = (float*)a;
-    float* fb = (float*)b;
-    float* fr = (float*)result;
-    for (int i = 0; i < 4; i++) {
-        fr[i] = fa[i] * fb[i];
-    }
+const simd_kernel_selection_t* get_simd_kernel_selection(void) {
+    uv_once(&simd_init_once, init_simd_functions);
+    return &simd_selection;
 }
 
-static void scalar_sub_ps(void* a, void* b, void* result) {
-    float* fa = (float*)a;
-    float* fb = (float*)b;
-    float* fr = (float*)result;
-    for (int i = 0; i < 4; i++) {
-        fr[i] = fa[i] - fb[i];
-    }
+const simd_kernel_thresholds_t* get_simd_kernel_thresholds(void) {
+    uv_once(&simd_init_once, init_simd_functions);
+    return &simd_thresholds;
 }
 
-static void scalar_add_epi32(void* a, void* b, void* result) {
-    int32_t* ia = (int32_t*)a;
-    int32_t* ib = (int32_t*)b;
-    int32_t* ir = (int32_t*)result;
-    for (int i = 0; i < 4; i++) {
-        ir[i] = ia[i] + ib[i];
+int simd_set_kernel(const char* name, simd_instruction_set_t instruction_set,
+                    size_t threshold) {
+    const simd_functions_t* funcs = get_simd_functions_for(instruction_set);
+    uv_once(&simd_init_once, init_simd_functions);
+    if (funcs == NULL) return -1;
+#define V(kernel, ret, args)                                                  \
+    if (strcmp(name, #kernel) == 0) {                                         \
+        if (funcs->kernel == NULL) return -1;                                 \
+        simd_funcs.kernel = funcs->kernel;                                    \
+        simd_selection.kernel = instruction_set;                              \
+        simd_thresholds.kernel = threshold;                                   \
+        return 0;                                                             \
     }
+    SIMD_KERNELS(V)
+#undef V
+    return -1;
 }
 
-static void scalar_shuffle_epi32(void* a, int mask, void* result) {
-    int32_t* ia = (int32_t*)a;
-    int32_t* ir = (int32_t*)result;
-    
-    // Extract mask components (for SSE2-style shuffle mask)
-    ir[0] = ia[(mask >> 0) & 0x3];
-    ir[1] = ia[(mask >> 2) & 0x3];
-    ir[2] = ia[(mask >> 4) & 0x3];
-    ir[3] = ia[(mask >> 6) & 0x3];
+unsigned get_simd_cpu_features(void) {
+    uv_once(&simd_init_once, init_simd_functions);
+    return simd_cpu_features;
 }
 
-/* Public API functions */
-simd_instruction_set_t get_active_simd_instruction_set(void) {
-    if (current_simd_instruction_set == SIMD_NONE) {
-        init_simd_functions();
-    }
-    return current_simd_instruction_set;
+void simd_batch_begin(void) {
+#if defined(SIMD_HAVE_MMXEXT_KERNELS) || defined(SIMD_HAVE_3DNOW_KERNELS)
+    simd_mmx_batch_depth++;
+#endif
 }
 
-const simd_functions_t* get_simd_functions(void) {
-    if (current_simd_instruction_set == SIMD_NONE) {
-        init_simd_functions();
+void simd_batch_end(void) {
+#if defined(SIMD_HAVE_MMXEXT_KERNELS) || defined(SIMD_HAVE_3DNOW_KERNELS)
+    unsigned features;
+    if (--simd_mmx_batch_depth != 0) return;
+    /* Only the MMX and 3DNow! kernels skip leaving MMX state inside a batch,
+     * and a CPU that can run either of them has at least MMX. */
+    features = get_simd_cpu_features();
+    if (features & (SIMD_FEATURE_3DNOW | SIMD_FEATURE_MMXEXT)) {
+#if defined(SIMD_HAVE_3DNOW_KERNELS)
+        if (features & SIMD_FEATURE_3DNOW) {
+            simd_3dnow_femms();
+            return;
+        }
+#endif
+#if defined(SIMD_HAVE_MMXEXT_KERNELS)
+        simd_mmx_emms();
+#endif
     }
-    return &simd_funcs;
+#endif
 }
 
 int is_simd_available(simd_instruction_set_t instruction_set) {
+    unsigned features = get_simd_cpu_features();
     switch(instruction_set) {
         case SIMD_SSE2:
-            return x86_cpu_enable_sse2;
+            return (features & SIMD_FEATURE_SSE2) != 0;
         case SIMD_3DNOW:
-            return x86_cpu_enable_3dnow;
+            return (features & SIMD_FEATURE_3DNOW) != 0;
+        case SIMD_3DNOWEXT:
+            return (features & SIMD_FEATURE_3DNOWEXT) != 0;
+        case SIMD_MMXEXT:
+            return (features & SIMD_FEATURE_MMXEXT) != 0;
         case SIMD_ALTIVEC:
-            return ppc_cpu_enable_altivec;
+            return (features & SIMD_FEATURE_ALTIVEC) != 0;
         case SIMD_SCALAR:
             return 1;  /* Scalar is always available */
         default:
             return 0;
     }
-}
\ No newline at end of file
+}
+
+simd_instruction_set_t parse_simd_instruction_set_name(const char* name) {
+    static const simd_instruction_set_t sets[] = {
+        SIMD_SCALAR, SIMD_SSE2, SIMD_3DNOW, SIMD_3DNOWEXT, SIMD_MMXEXT,
+        SIMD_ALTIVEC,
+    };
+    for (size_t i = 0; i < sizeof(sets) / sizeof(sets[0]); i++) {
+        if (strcmp(name, get_simd_instruction_set_name(sets[i])) == 0) {
+            return sets[i];
+        }
+    }
+    return SIMD_NONE;
+}
+
+const char* get_simd_instruction_set_name(simd_instruction_set_t instruction_set) {
+    switch(instruction_set) {
+        case SIMD_SCALAR:
+            return "scalar";
+        case SIMD_SSE2:
+            return "sse2";
+        case SIMD_3DNOW:
+            return "3dnow";
+        case SIMD_3DNOWEXT:
+            return "3dnowext";
+        case SIMD_MMXEXT:
+            return "mmxext";
+        case SIMD_ALTIVEC:
+            return "altivec";
+        default:
+            return "none";
+    }
+}
@@ -1,40 +1,52 @@
 #ifndef SIMD_ABSTRACTION_H
 #define SIMD_ABSTRACTION_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "zlib.h"
-#include "cpu_features.h"
 
 /*
  * SIMD Abstraction Layer
  * Provides a unified interface for SIMD operations independent of the actual SIMD instruction set
+ *
+ * Kernels for every instruction set the target architecture can run are
+ * compiled into the same binary (using per-function target attributes), and
+ * the fastest implementation of each kernel is picked at runtime from the
+ * features reported by cpu_check_features(). A single build therefore serves
+ * an Athlon XP, an Athlon 64 and a Pentium 4 alike.
  */
 
-/* Define which SIMD instruction set to use based on runtime detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* zlib's CPU detection, shared with the kernel selection below. The header
+ * has no C++ guards of its own. */
+#include "cpu_features.h"
+
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
-    /* x86/x64 platform - check for available SIMD instruction sets in priority order */
-    #if defined(__SSE2__) && x86_cpu_enable_sse2
-        #define SIMD_INSTRUCTION_SET SIMD_SSE2
-        #define USE_SSE2 1
-    #elif defined(__3dNOW__) && x86_cpu_enable_3dnow
-        #define SIMD_INSTRUCTION_SET SIMD_3DNOW
-        #define USE_3DNOW 1
-    #else
-        #define SIMD_INSTRUCTION_SET SIMD_SCALAR
-        #define USE_SCALAR 1
-    #endif
+    #define SIMD_ARCH_X86 1
 #elif defined(__PPC__) || defined(__powerpc__) || defined(__ppc__) || defined(__PPC64__) || defined(__powerpc64__)
-    /* PowerPC platform - check for Altivec */
-    #if defined(__ALTIVEC__) && ppc_cpu_enable_altivec
-        #define SIMD_INSTRUCTION_SET SIMD_ALTIVEC
-        #define USE_ALTIVEC 1
-    #else
-        #define SIMD_INSTRUCTION_SET SIMD_SCALAR
-        #define USE_SCALAR 1
-    #endif
+    #define SIMD_ARCH_PPC 1
+#endif
+
+/*
+ * Cache prefetch hints, for loops that chase pointers or walk a stream ahead
+ * of its use. These are resolved at compile time, since a hint is not worth
+ * an indirect call: GCC and Clang emit prefetch/prefetchw on 3DNow! builds
+ * without SSE, prefetcht0 with SSE, and dcbt/dcbtst on PowerPC.
+ */
+#if defined(__GNUC__)
+    #define SIMD_PREFETCH(p) __builtin_prefetch((p), 0, 3)
+    #define SIMD_PREFETCH_WRITE(p) __builtin_prefetch((p), 1, 3)
+#elif defined(_M_X64) || defined(_M_IX86)
+    #include <xmmintrin.h>
+    #define SIMD_PREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+    #define SIMD_PREFETCH_WRITE(p) SIMD_PREFETCH(p)
 #else
-    /* Other platforms - use scalar fallback */
-    #define SIMD_INSTRUCTION_SET SIMD_SCALAR
-    #define USE_SCALAR 1
+    #define SIMD_PREFETCH(p) ((void)(p))
+    #define SIMD_PREFETCH_WRITE(p) ((void)(p))
 #endif
 
 /* Enum for SIMD instruction set types */
@@ -43,27 +55,175 @@ typedef enum {
     SIMD_SCALAR = 1,
     SIMD_SSE2 = 2,
     SIMD_3DNOW = 3,
-    SIMD_ALTIVEC = 4
+    SIMD_ALTIVEC = 4,
+    SIMD_3DNOWEXT = 5,
+    SIMD_MMXEXT = 6
 } simd_instruction_set_t;
 
+/*
+ * CPU feature bits, as reported by get_simd_cpu_features(). They come from a
+ * single probe, zlib's cpu_check_features(), and cover every flag zlib
+ * dispatches on, so that zlib and the kernels here never disagree about the
+ * CPU. SSE4_2_PCLMUL mirrors x86_cpu_enable_simd (SSE4.2 and PCLMULQDQ).
+ */
+#define SIMD_FEATURE_SSE2          (1u << 0)
+#define SIMD_FEATURE_3DNOW         (1u << 1)
+#define SIMD_FEATURE_3DNOWEXT      (1u << 2)
+#define SIMD_FEATURE_MMXEXT        (1u << 3)
+#define SIMD_FEATURE_ALTIVEC       (1u << 4)
+#define SIMD_FEATURE_SSSE3         (1u << 5)
+#define SIMD_FEATURE_SSE4_2_PCLMUL (1u << 6)
+#define SIMD_FEATURE_AVX512        (1u << 7)
+
+/*
+ * List of dispatchable kernels: V(name, return type, parameter list).
+ * Adding a kernel here adds a slot to simd_functions_t and to the runtime
+ * selection; every instruction set is free to leave the slot empty, in which
+ * case the next best implementation (ultimately the scalar one) is used.
+ *
+ * The single-vector operations work on one 128-bit value. The span kernels
+ * loop internally over (pointer, length) inputs of any size and alignment, so
+ * callers pay for one indirect call per buffer rather than one per vector:
+ *
+ *   find_byte      pointer to the first byte equal to value, or NULL
+ *   find_last_byte pointer to the last byte equal to value, or NULL
+ *   find_byte_pair pointer to the first data[i], i < length, that equals
+ *                  first while data[i + distance] equals last, or NULL;
+ *                  reads data[0 .. length + distance)
+ *   compare_bytes  memcmp() semantics
+ *   copy_bytes     memcpy() semantics; dst and src must not overlap
+ *   fill_bytes     memset() semantics
+ *   xor_bytes      dst[i] ^= src[i]
+ *   mask_bytes     dst[i] = src[i] ^ mask[i % 4] (WebSocket masking);
+ *                  dst may equal src
+ *   sum_bytes      sum of all bytes
+ *   min_max_bytes  smallest and largest byte; 0xff / 0x00 for empty input
+ *   swap_bytes16/32/64  in-place byte order reversal of count elements
+ *   validate_ascii non-zero if no byte has its high bit set
+ *   hex_encode     dst[0 .. 2 * length) = lowercase hex digits of src
+ */
+#define SIMD_KERNELS(V)                                                       \
+    /* Float operations */                                                    \
+    V(add_ps, void, (void* a, void* b, void* result))                         \
+    V(mul_ps, void, (void* a, void* b, void* result))                         \
+    V(sub_ps, void, (void* a, void* b, void* result))                         \
+    /* Integer operations */                                                  \
+    V(add_epi32, void, (void* a, void* b, void* result))                      \
+    V(shuffle_epi32, void, (void* a, int mask, void* result))                 \
+    /* Span operations */                                                     \
+    V(find_byte, const uint8_t*,                                              \
+      (const uint8_t* data, size_t length, uint8_t value))                    \
+    V(find_last_byte, const uint8_t*,                                         \
+      (const uint8_t* data, size_t length, uint8_t value))                    \
+    V(find_byte_pair, const uint8_t*,                                         \
+      (const uint8_t* data, size_t length, uint8_t first, uint8_t last,       \
+       size_t distance))                                                      \
+    V(compare_bytes, int,                                                     \
+      (const uint8_t* a, const uint8_t* b, size_t length))                    \
+    V(copy_bytes, void, (uint8_t* dst, const uint8_t* src, size_t length))    \
+    V(fill_bytes, void, (uint8_t* dst, uint8_t value, size_t length))         \
+    V(xor_bytes, void, (uint8_t* dst, const uint8_t* src, size_t length))     \
+    V(mask_bytes, void,                                                       \
+      (uint8_t* dst, const uint8_t* src, size_t length,                       \
+       const uint8_t mask[4]))                                                \
+    V(sum_bytes, uint64_t, (const uint8_t* data, size_t length))              \
+    V(min_max_bytes, void,                                                    \
+      (const uint8_t* data, size_t length, uint8_t* min, uint8_t* max))       \
+    V(swap_bytes16, void, (void* data, size_t count))                         \
+    V(swap_bytes32, void, (void* data, size_t count))                         \
+    V(swap_bytes64, void, (void* data, size_t count))                         \
+    V(validate_ascii, int, (const uint8_t* data, size_t length))              \
+    V(hex_encode, void, (char* dst, const uint8_t* src, size_t length))
+
 /* SIMD function declarations */
 typedef struct {
-    /* Float operations */
-    void (*add_ps)(void* a, void* b, void* result);
-    void (*mul_ps)(void* a, void* b, void* result);
-    void (*sub_ps)(void* a, void* b, void* result);
-    /* Integer operations */
-    void (*add_epi32)(void* a, void* b, void* result);
-    void (*shuffle_epi32)(void* a, int mask, void* result);
+#define V(name, ret, args) ret (*name) args;
+    SIMD_KERNELS(V)
+#undef V
 } simd_functions_t;
 
-/* Get the currently active SIMD instruction set */
+/* The instruction set each slot of simd_functions_t was resolved to */
+typedef struct {
+#define V(name, ret, args) simd_instruction_set_t name;
+    SIMD_KERNELS(V)
+#undef V
+} simd_kernel_selection_t;
+
+/* The shortest input, in bytes, from which callers should use each selected
+ * span kernel rather than their own scalar path; 0 until a calibration sets
+ * one (see simd_set_kernel()), in which case callers use their defaults. */
+typedef struct {
+#define V(name, ret, args) size_t name;
+    SIMD_KERNELS(V)
+#undef V
+} simd_kernel_thresholds_t;
+
+/* Get the currently active SIMD instruction set (the best one in use by any kernel) */
 simd_instruction_set_t get_active_simd_instruction_set(void);
 
-/* Get the SIMD function table for the active instruction set */
+/* Get the SIMD function table for the running CPU */
 const simd_functions_t* get_simd_functions(void);
 
+/* Get the kernels a single instruction set implements, or NULL if it is not
+ * compiled in or not supported by the running CPU. Slots the instruction set
+ * does not implement are NULL. Meant for tests and benchmarks that compare
+ * implementations; everything else should use get_simd_functions(). */
+const simd_functions_t* get_simd_functions_for(simd_instruction_set_t instruction_set);
+
+/* Get the instruction set that was selected for every kernel */
+const simd_kernel_selection_t* get_simd_kernel_selection(void);
+
+/* Get the calibrated threshold of every kernel */
+const simd_kernel_thresholds_t* get_simd_kernel_thresholds(void);
+
+/* Use instruction_set's implementation of the kernel called name, from
+ * threshold bytes up, in place of the one picked by the registry; this is how
+ * measured results (node --simd-calibrate) are applied. Returns 0, or -1 if
+ * there is no such kernel or the running CPU has no implementation of it in
+ * that instruction set. The table is read without locking, so this may only
+ * be called during process initialization, before other threads use it. */
+int simd_set_kernel(const char* name, simd_instruction_set_t instruction_set,
+                    size_t threshold);
+
+/* Parse an instruction set name as returned by
+ * get_simd_instruction_set_name(), or return SIMD_NONE. */
+simd_instruction_set_t parse_simd_instruction_set_name(const char* name);
+
+/* Get the SIMD_FEATURE_* bits detected for the running CPU. The first call
+ * (from any thread) runs the detection; later calls are a load. */
+unsigned get_simd_cpu_features(void);
+
 /* Check if specific SIMD instruction set is available at runtime */
 int is_simd_available(simd_instruction_set_t instruction_set);
 
-#endif /* SIMD_ABSTRACTION_H */
\ No newline at end of file
+/* Human readable name of an instruction set, e.g. "3dnow" */
+const char* get_simd_instruction_set_name(simd_instruction_set_t instruction_set);
+
+/*
+ * MMX and 3DNow! kernels share their registers with the x87 FPU, so each of
+ * them ends with (f)emms. Code issuing many kernel calls in a row can bracket
+ * them with simd_batch_begin()/simd_batch_end() to leave MMX state once, at
+ * the end of the batch. No x87 floating point code may run on the thread in
+ * between. Batches nest, and are no-ops on CPUs without MMX kernels.
+ */
+void simd_batch_begin(void);
+void simd_batch_end(void);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+
+namespace node {
+
+/* Scoped simd_batch_begin()/simd_batch_end() pair */
+class SimdBatchScope {
+ public:
+  SimdBatchScope() { simd_batch_begin(); }
+  ~SimdBatchScope() { simd_batch_end(); }
+  SimdBatchScope(const SimdBatchScope&) = delete;
+  SimdBatchScope& operator=(const SimdBatchScope&) = delete;
+};
+
+}  // namespace node
+#endif
+
+#endif /* SIMD_ABSTRACTION_H */
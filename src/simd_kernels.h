@@ -0,0 +1,123 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+/*
+ * Internal interface between the SIMD dispatch registry in
+ * simd_abstraction.c and the per-instruction-set kernel files. Nothing
+ * outside of src/simd_*.c should include this; use simd_abstraction.h.
+ */
+
+#include "simd_abstraction.h"
+
+/*
+ * Kernels for non-baseline instruction sets are compiled with per-function
+ * target attributes so that the rest of the binary keeps running on CPUs
+ * that lack them. They must only be reached through the dispatch table.
+ * Helpers called from such kernels need the same attribute to be inlined.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+/* Index of the lowest set bit; mask must be non-zero */
+static inline int simd_ctz32(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int index = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/* Index of the highest set bit; mask must be non-zero */
+static inline int simd_msb32(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - __builtin_clz(mask);
+#else
+    int index = 31;
+    while ((mask & 0x80000000u) == 0) {
+        mask <<= 1;
+        index--;
+    }
+    return index;
+#endif
+}
+
+/* Which kernel files have something to offer on this compiler and target */
+#if defined(SIMD_ARCH_X86)
+#define SIMD_HAVE_SSE2_KERNELS 1
+#endif
+
+/* MMX Extensions are reached through GCC's builtins, which unlike the
+ * xmmintrin.h wrappers only need the Athlon "3dnowa" target and so never let
+ * the compiler slip SSE instructions into the kernels. */
+#if defined(SIMD_ARCH_X86) && defined(__GNUC__) && !defined(__clang__)
+#define SIMD_HAVE_MMXEXT_KERNELS 1
+#endif
+
+/* 3DNow! float kernels use the mm3dnow.h intrinsics, which clang dropped */
+#if defined(SIMD_ARCH_X86) && defined(__GNUC__) && !defined(__clang__)
+#define SIMD_HAVE_3DNOW_KERNELS 1
+#endif
+
+#if defined(SIMD_ARCH_PPC) && defined(__ALTIVEC__)
+#define SIMD_HAVE_ALTIVEC_KERNELS 1
+#endif
+
+#if defined(SIMD_HAVE_MMXEXT_KERNELS) || defined(SIMD_HAVE_3DNOW_KERNELS)
+/* Nesting depth of simd_batch_begin() on the current thread. MMX kernels
+ * only leave MMX state themselves when it is zero. */
+extern __thread int simd_mmx_batch_depth;
+#endif
+
+/* Per instruction set kernel tables; unimplemented slots are NULL */
+extern const simd_functions_t simd_scalar_functions;
+#if defined(SIMD_HAVE_SSE2_KERNELS)
+extern const simd_functions_t simd_sse2_functions;
+#endif
+#if defined(SIMD_HAVE_3DNOW_KERNELS)
+extern const simd_functions_t simd_3dnow_functions;
+void simd_3dnow_femms(void);
+#endif
+#if defined(SIMD_HAVE_MMXEXT_KERNELS)
+extern const simd_functions_t simd_mmxext_functions;
+void simd_mmx_emms(void);
+#endif
+#if defined(SIMD_HAVE_ALTIVEC_KERNELS)
+extern const simd_functions_t simd_altivec_functions;
+#endif
+
+/*
+ * Scalar span kernels, exported so that vector implementations can hand
+ * them their unaligned heads and short tails.
+ */
+const uint8_t* simd_scalar_find_byte(const uint8_t* data, size_t length,
+                                     uint8_t value);
+const uint8_t* simd_scalar_find_last_byte(const uint8_t* data, size_t length,
+                                          uint8_t value);
+const uint8_t* simd_scalar_find_byte_pair(const uint8_t* data, size_t length,
+                                          uint8_t first, uint8_t last,
+                                          size_t distance);
+int simd_scalar_compare_bytes(const uint8_t* a, const uint8_t* b,
+                              size_t length);
+void simd_scalar_copy_bytes(uint8_t* dst, const uint8_t* src, size_t length);
+void simd_scalar_fill_bytes(uint8_t* dst, uint8_t value, size_t length);
+void simd_scalar_xor_bytes(uint8_t* dst, const uint8_t* src, size_t length);
+void simd_scalar_mask_bytes(uint8_t* dst, const uint8_t* src, size_t length,
+                            const uint8_t mask[4]);
+uint64_t simd_scalar_sum_bytes(const uint8_t* data, size_t length);
+void simd_scalar_min_max_bytes(const uint8_t* data, size_t length,
+                               uint8_t* min, uint8_t* max);
+void simd_scalar_swap_bytes16(void* data, size_t count);
+void simd_scalar_swap_bytes32(void* data, size_t count);
+void simd_scalar_swap_bytes64(void* data, size_t count);
+int simd_scalar_validate_ascii(const uint8_t* data, size_t length);
+void simd_scalar_hex_encode(char* dst, const uint8_t* src, size_t length);
+
+#endif /* SIMD_KERNELS_H */
@@ -0,0 +1,81 @@
+#include "simd_kernels.h"
+
+#if defined(SIMD_HAVE_3DNOW_KERNELS)
+
+#include <mm3dnow.h>
+#include <string.h>
+
+/*
+ * 3DNow! implementations. 3DNow! works on two single precision floats per
+ * 64-bit MMX register, so a 128-bit operation is two pfadd/pfmul/pfsub.
+ * Results follow 3DNow! arithmetic (no denormals, no NaN propagation), which
+ * is good enough for statistics but not a bit-exact SSE replacement.
+ * Every kernel ends with femms unless it runs inside a batch.
+ */
+#define SIMD_3DNOW_TARGET SIMD_TARGET("3dnow")
+
+#define D3NOW_LEAVE()                                                         \
+    do {                                                                      \
+        if (simd_mmx_batch_depth == 0) _m_femms();                            \
+    } while (0)
+
+SIMD_3DNOW_TARGET
+static inline __m64 d3now_load(const uint8_t* p) {
+    __m64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+SIMD_3DNOW_TARGET
+static inline void d3now_store(uint8_t* p, __m64 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+SIMD_3DNOW_TARGET
+static void d3now_add_ps(void* a, void* b, void* result) {
+    const uint8_t* pa = (const uint8_t*)a;
+    const uint8_t* pb = (const uint8_t*)b;
+    uint8_t* pr = (uint8_t*)result;
+    __m64 lo = _m_pfadd(d3now_load(pa), d3now_load(pb));
+    __m64 hi = _m_pfadd(d3now_load(pa + 8), d3now_load(pb + 8));
+    d3now_store(pr, lo);
+    d3now_store(pr + 8, hi);
+    D3NOW_LEAVE();
+}
+
+SIMD_3DNOW_TARGET
+static void d3now_mul_ps(void* a, void* b, void* result) {
+    const uint8_t* pa = (const uint8_t*)a;
+    const uint8_t* pb = (const uint8_t*)b;
+    uint8_t* pr = (uint8_t*)result;
+    __m64 lo = _m_pfmul(d3now_load(pa), d3now_load(pb));
+    __m64 hi = _m_pfmul(d3now_load(pa + 8), d3now_load(pb + 8));
+    d3now_store(pr, lo);
+    d3now_store(pr + 8, hi);
+    D3NOW_LEAVE();
+}
+
+SIMD_3DNOW_TARGET
+static void d3now_sub_ps(void* a, void* b, void* result) {
+    const uint8_t* pa = (const uint8_t*)a;
+    const uint8_t* pb = (const uint8_t*)b;
+    uint8_t* pr = (uint8_t*)result;
+    __m64 lo = _m_pfsub(d3now_load(pa), d3now_load(pb));
+    __m64 hi = _m_pfsub(d3now_load(pa + 8), d3now_load(pb + 8));
+    d3now_store(pr, lo);
+    d3now_store(pr + 8, hi);
+    D3NOW_LEAVE();
+}
+
+SIMD_3DNOW_TARGET
+void simd_3dnow_femms(void) {
+    _m_femms();
+}
+
+const simd_functions_t simd_3dnow_functions = {
+    .add_ps = d3now_add_ps,
+    .mul_ps = d3now_mul_ps,
+    .sub_ps = d3now_sub_ps,
+};
+
+#endif /* SIMD_HAVE_3DNOW_KERNELS */
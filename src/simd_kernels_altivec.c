@@ -0,0 +1,383 @@
+#include "simd_kernels.h"
+
+#if defined(SIMD_HAVE_ALTIVEC_KERNELS)
+
+#include <altivec.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+/* Altivec implementations */
+
+/* The abstraction takes untyped pointers with no alignment guarantee, and
+ * vec_ld silently truncates unaligned addresses, so go through memcpy. */
+static inline vector float altivec_load_ps(const void* p) {
+    vector float v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline vector signed int altivec_load_epi32(const void* p) {
+    vector signed int v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/* Span loads use the classic lvsl/vperm sequence on big endian; the second
+ * lvx touches the aligned block holding p[15], which always belongs to the
+ * same object, so this never reads past the end of the input. */
+static inline vector unsigned char altivec_load_u8(const uint8_t* p) {
+#if defined(__BIG_ENDIAN__)
+    vector unsigned char lo = vec_ld(0, p);
+    vector unsigned char hi = vec_ld(15, p);
+    return vec_perm(lo, hi, vec_lvsl(0, p));
+#else
+    vector unsigned char v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+#endif
+}
+
+static inline void altivec_store_u8(void* p, vector unsigned char v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline vector unsigned char altivec_splat_u8(uint8_t value) {
+    union {
+        uint8_t bytes[16];
+        vector unsigned char v;
+    } splat;
+    memset(splat.bytes, value, sizeof(splat.bytes));
+    return splat.v;
+}
+
+static void altivec_add_ps(void* a, void* b, void* result) {
+    vector float vr = vec_add(altivec_load_ps(a), altivec_load_ps(b));
+    memcpy(result, &vr, sizeof(vr));
+}
+
+static void altivec_mul_ps(void* a, void* b, void* result) {
+    /* AltiVec has no plain float multiply; fused multiply-add with -0.0
+     * keeps the sign of zero products intact. */
+    const vector float neg_zero = (vector float)vec_sl(vec_splat_u32(-1),
+                                                       vec_splat_u32(-1));
+    vector float vr = vec_madd(altivec_load_ps(a), altivec_load_ps(b), neg_zero);
+    memcpy(result, &vr, sizeof(vr));
+}
+
+static void altivec_sub_ps(void* a, void* b, void* result) {
+    vector float vr = vec_sub(altivec_load_ps(a), altivec_load_ps(b));
+    memcpy(result, &vr, sizeof(vr));
+}
+
+static void altivec_add_epi32(void* a, void* b, void* result) {
+    vector signed int vr = vec_add(altivec_load_epi32(a), altivec_load_epi32(b));
+    memcpy(result, &vr, sizeof(vr));
+}
+
+#if defined(__BIG_ENDIAN__)
+static void altivec_shuffle_epi32(void* a, int mask, void* result) {
+    /* Expand the SSE2-style 2-bit lane selectors into a vec_perm byte map. */
+    union {
+        unsigned char bytes[16];
+        vector unsigned char v;
+    } perm;
+    for (int i = 0; i < 4; i++) {
+        int lane = (mask >> (2 * i)) & 0x3;
+        for (int j = 0; j < 4; j++) {
+            perm.bytes[i * 4 + j] = (unsigned char)(lane * 4 + j);
+        }
+    }
+    vector signed int va = altivec_load_epi32(a);
+    vector signed int vr = vec_perm(va, va, perm.v);
+    memcpy(result, &vr, sizeof(vr));
+}
+#endif /* __BIG_ENDIAN__ */
+
+/* Span operations */
+static const uint8_t* altivec_find_byte(const uint8_t* data, size_t length,
+                                        uint8_t value) {
+    const vector unsigned char needle = altivec_splat_u8(value);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        if (vec_any_eq(altivec_load_u8(data + i), needle)) {
+            return simd_scalar_find_byte(data + i, 16, value);
+        }
+    }
+    return simd_scalar_find_byte(data + i, length - i, value);
+}
+
+static const uint8_t* altivec_find_last_byte(const uint8_t* data,
+                                             size_t length, uint8_t value) {
+    const vector unsigned char needle = altivec_splat_u8(value);
+    size_t i = length;
+    for (; i >= 16; i -= 16) {
+        if (vec_any_eq(altivec_load_u8(data + i - 16), needle)) {
+            return simd_scalar_find_last_byte(data + i - 16, 16, value);
+        }
+    }
+    return simd_scalar_find_last_byte(data, i, value);
+}
+
+static const uint8_t* altivec_find_byte_pair(const uint8_t* data,
+                                             size_t length, uint8_t first,
+                                             uint8_t last, size_t distance) {
+    const vector unsigned char vfirst = altivec_splat_u8(first);
+    const vector unsigned char vlast = altivec_splat_u8(last);
+    const vector unsigned char zero = vec_splat_u8(0);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        vector unsigned char candidates = vec_and(
+            (vector unsigned char)vec_cmpeq(altivec_load_u8(data + i), vfirst),
+            (vector unsigned char)vec_cmpeq(
+                altivec_load_u8(data + i + distance), vlast));
+        if (vec_any_ne(candidates, zero)) {
+            return simd_scalar_find_byte_pair(data + i, 16, first, last,
+                                              distance);
+        }
+    }
+    return simd_scalar_find_byte_pair(data + i, length - i, first, last,
+                                      distance);
+}
+
+static int altivec_compare_bytes(const uint8_t* a, const uint8_t* b,
+                                 size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        if (!vec_all_eq(altivec_load_u8(a + i), altivec_load_u8(b + i))) {
+            return simd_scalar_compare_bytes(a + i, b + i, 16);
+        }
+    }
+    return simd_scalar_compare_bytes(a + i, b + i, length - i);
+}
+
+/* Copies and fills of at least this size claim whole destination cache lines
+ * with dcbz first, which saves the G4/G5 from reading lines that are about
+ * to be overwritten anyway. */
+#define ALTIVEC_DCBZ_THRESHOLD 4096
+
+/* The data cache line size that dcbz zeroes, or 0 if it is not known. The
+ * 970 has 128-byte lines and the 74xx 32-byte ones, so it has to come from
+ * the kernel rather than be assumed. */
+static size_t altivec_dcbz_line_size(void) {
+#if defined(__linux__) && defined(AT_DCACHEBSIZE)
+    size_t line = (size_t)getauxval(AT_DCACHEBSIZE);
+    if (line >= 16 && (line & (line - 1)) == 0) return line;
+#endif
+    return 0;
+}
+
+static inline void altivec_dcbz(uint8_t* p) {
+    __asm__ volatile("dcbz 0,%0" : : "r"(p) : "memory");
+}
+
+/* Bytes to the next 16-byte boundary of p, at most length. */
+static inline size_t altivec_align_head(const uint8_t* p, size_t length) {
+    size_t head = (size_t)(-(uintptr_t)p & 15);
+    return head < length ? head : length;
+}
+
+static void altivec_copy_bytes(uint8_t* dst, const uint8_t* src,
+                               size_t length) {
+    size_t i = altivec_align_head(dst, length);
+    simd_scalar_copy_bytes(dst, src, i);
+    const size_t line =
+        length - i >= ALTIVEC_DCBZ_THRESHOLD ? altivec_dcbz_line_size() : 0;
+    if (line != 0) {
+        /* The threshold is far above any line size, so this stays in
+         * bounds. */
+        for (; ((uintptr_t)(dst + i) & (line - 1)) != 0; i += 16) {
+            vec_st(altivec_load_u8(src + i), 0, dst + i);
+        }
+        for (; i + line <= length; i += line) {
+            SIMD_PREFETCH(src + i + 4 * line);
+            altivec_dcbz(dst + i);
+            for (size_t j = 0; j < line; j += 16) {
+                vec_st(altivec_load_u8(src + i + j), 0, dst + i + j);
+            }
+        }
+    }
+    for (; i + 16 <= length; i += 16) {
+        vec_st(altivec_load_u8(src + i), 0, dst + i);
+    }
+    simd_scalar_copy_bytes(dst + i, src + i, length - i);
+}
+
+static void altivec_fill_bytes(uint8_t* dst, uint8_t value, size_t length) {
+    const vector unsigned char splat = altivec_splat_u8(value);
+    size_t i = altivec_align_head(dst, length);
+    simd_scalar_fill_bytes(dst, value, i);
+    const size_t line =
+        length - i >= ALTIVEC_DCBZ_THRESHOLD ? altivec_dcbz_line_size() : 0;
+    if (line != 0) {
+        for (; ((uintptr_t)(dst + i) & (line - 1)) != 0; i += 16) {
+            vec_st(splat, 0, dst + i);
+        }
+        for (; i + line <= length; i += line) {
+            altivec_dcbz(dst + i);
+            if (value == 0) continue;
+            for (size_t j = 0; j < line; j += 16) {
+                vec_st(splat, 0, dst + i + j);
+            }
+        }
+    }
+    for (; i + 16 <= length; i += 16) {
+        vec_st(splat, 0, dst + i);
+    }
+    simd_scalar_fill_bytes(dst + i, value, length - i);
+}
+
+static void altivec_xor_bytes(uint8_t* dst, const uint8_t* src,
+                              size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        altivec_store_u8(dst + i, vec_xor(altivec_load_u8(dst + i),
+                                          altivec_load_u8(src + i)));
+    }
+    simd_scalar_xor_bytes(dst + i, src + i, length - i);
+}
+
+static void altivec_mask_bytes(uint8_t* dst, const uint8_t* src,
+                               size_t length, const uint8_t mask[4]) {
+    union {
+        uint8_t bytes[16];
+        vector unsigned char v;
+    } vmask;
+    for (int j = 0; j < 16; j += 4) memcpy(vmask.bytes + j, mask, 4);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        altivec_store_u8(dst + i, vec_xor(altivec_load_u8(src + i), vmask.v));
+    }
+    /* i is a multiple of 4, so the mask phase is unchanged for the tail */
+    simd_scalar_mask_bytes(dst + i, src + i, length - i, mask);
+}
+
+static uint64_t altivec_sum_bytes(const uint8_t* data, size_t length) {
+    uint64_t sum = 0;
+    size_t i = 0;
+    while (i + 16 <= length) {
+        /* vec_sum4s adds at most 4 * 255 to a 32-bit lane per block, so
+         * flush the lanes every million blocks to stay clear of overflow. */
+        union {
+            uint32_t words[4];
+            vector unsigned int v;
+        } acc;
+        acc.v = vec_splat_u32(0);
+        size_t block_end = length - i > (1u << 24) ? i + (1u << 24) : length;
+        for (; i + 16 <= block_end; i += 16) {
+            acc.v = vec_sum4s(altivec_load_u8(data + i), acc.v);
+        }
+        sum += (uint64_t)acc.words[0] + acc.words[1] + acc.words[2] +
+               acc.words[3];
+    }
+    return sum + simd_scalar_sum_bytes(data + i, length - i);
+}
+
+static void altivec_min_max_bytes(const uint8_t* data, size_t length,
+                                  uint8_t* min, uint8_t* max) {
+    union {
+        uint8_t bytes[16];
+        vector unsigned char v;
+    } vmin, vmax;
+    vmin.v = altivec_splat_u8(0xff);
+    vmax.v = vec_splat_u8(0);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        vector unsigned char v = altivec_load_u8(data + i);
+        vmin.v = vec_min(vmin.v, v);
+        vmax.v = vec_max(vmax.v, v);
+    }
+    simd_scalar_min_max_bytes(data + i, length - i, min, max);
+    for (int j = 0; j < 16; j++) {
+        if (vmin.bytes[j] < *min) *min = vmin.bytes[j];
+        if (vmax.bytes[j] > *max) *max = vmax.bytes[j];
+    }
+}
+
+static void altivec_swap_bytes(uint8_t* p, size_t bytes,
+                               vector unsigned char perm) {
+    for (size_t i = 0; i + 16 <= bytes; i += 16) {
+        vector unsigned char v = altivec_load_u8(p + i);
+        altivec_store_u8(p + i, vec_perm(v, v, perm));
+    }
+}
+
+static void altivec_swap_bytes16(void* data, size_t count) {
+    const vector unsigned char perm = {1, 0, 3, 2, 5, 4, 7, 6,
+                                       9, 8, 11, 10, 13, 12, 15, 14};
+    size_t vectored = count & ~(size_t)7;
+    altivec_swap_bytes((uint8_t*)data, vectored * 2, perm);
+    simd_scalar_swap_bytes16((uint8_t*)data + vectored * 2, count - vectored);
+}
+
+static void altivec_swap_bytes32(void* data, size_t count) {
+    const vector unsigned char perm = {3, 2, 1, 0, 7, 6, 5, 4,
+                                       11, 10, 9, 8, 15, 14, 13, 12};
+    size_t vectored = count & ~(size_t)3;
+    altivec_swap_bytes((uint8_t*)data, vectored * 4, perm);
+    simd_scalar_swap_bytes32((uint8_t*)data + vectored * 4, count - vectored);
+}
+
+static void altivec_swap_bytes64(void* data, size_t count) {
+    const vector unsigned char perm = {7, 6, 5, 4, 3, 2, 1, 0,
+                                       15, 14, 13, 12, 11, 10, 9, 8};
+    size_t vectored = count & ~(size_t)1;
+    altivec_swap_bytes((uint8_t*)data, vectored * 8, perm);
+    simd_scalar_swap_bytes64((uint8_t*)data + vectored * 8, count - vectored);
+}
+
+static int altivec_validate_ascii(const uint8_t* data, size_t length) {
+    vector unsigned char acc = vec_splat_u8(0);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        acc = vec_or(acc, altivec_load_u8(data + i));
+    }
+    if (vec_any_gt(acc, altivec_splat_u8(0x7f))) return 0;
+    return simd_scalar_validate_ascii(data + i, length - i);
+}
+
+static void altivec_hex_encode(char* dst, const uint8_t* src, size_t length) {
+    const vector unsigned char digits = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+    const vector unsigned char four = vec_splat_u8(4);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        vector unsigned char v = altivec_load_u8(src + i);
+        /* vperm indexes digits:digits with the low five bits, so the low
+         * nibble needs no masking. */
+        vector unsigned char hi = vec_perm(digits, digits, vec_sr(v, four));
+        vector unsigned char lo = vec_perm(digits, digits, v);
+        altivec_store_u8(dst + 2 * i, vec_mergeh(hi, lo));
+        altivec_store_u8(dst + 2 * i + 16, vec_mergel(hi, lo));
+    }
+    simd_scalar_hex_encode(dst + 2 * i, src + i, length - i);
+}
+
+const simd_functions_t simd_altivec_functions = {
+    .add_ps = altivec_add_ps,
+    .mul_ps = altivec_mul_ps,
+    .sub_ps = altivec_sub_ps,
+    .add_epi32 = altivec_add_epi32,
+#if defined(__BIG_ENDIAN__)
+    .shuffle_epi32 = altivec_shuffle_epi32,
+#endif
+    .find_byte = altivec_find_byte,
+    .find_last_byte = altivec_find_last_byte,
+    .find_byte_pair = altivec_find_byte_pair,
+    .compare_bytes = altivec_compare_bytes,
+    .copy_bytes = altivec_copy_bytes,
+    .fill_bytes = altivec_fill_bytes,
+    .xor_bytes = altivec_xor_bytes,
+    .mask_bytes = altivec_mask_bytes,
+    .sum_bytes = altivec_sum_bytes,
+    .min_max_bytes = altivec_min_max_bytes,
+    .swap_bytes16 = altivec_swap_bytes16,
+    .swap_bytes32 = altivec_swap_bytes32,
+    .swap_bytes64 = altivec_swap_bytes64,
+    .validate_ascii = altivec_validate_ascii,
+    .hex_encode = altivec_hex_encode,
+};
+
+#endif /* SIMD_HAVE_ALTIVEC_KERNELS */
@@ -0,0 +1,356 @@
+#include "simd_kernels.h"
+
+#if defined(SIMD_HAVE_MMXEXT_KERNELS)
+
+#include <mmintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * MMX + MMX Extensions implementations, for the Athlon (Thunderbird, XP, MP)
+ * and Pentium III class CPUs that have neither SSE2 nor 128-bit integer
+ * vectors. Every kernel leaves the FPU in x87 mode (emms) before returning,
+ * unless it runs inside a simd_batch_begin()/simd_batch_end() pair.
+ */
+#define SIMD_MMXEXT_TARGET SIMD_TARGET("3dnowa")
+
+#define MMX_LEAVE()                                                           \
+    do {                                                                      \
+        if (simd_mmx_batch_depth == 0) _mm_empty();                           \
+    } while (0)
+
+#define mmxext_movemask(v) __builtin_ia32_pmovmskb((__v8qi)(v))
+#define mmxext_min_pu8(a, b)                                                  \
+    ((__m64)__builtin_ia32_pminub((__v8qi)(a), (__v8qi)(b)))
+#define mmxext_max_pu8(a, b)                                                  \
+    ((__m64)__builtin_ia32_pmaxub((__v8qi)(a), (__v8qi)(b)))
+#define mmxext_sad_pu8(a, b)                                                  \
+    ((__m64)__builtin_ia32_psadbw((__v8qi)(a), (__v8qi)(b)))
+#define mmxext_shuffle_pi16(v, imm)                                           \
+    ((__m64)__builtin_ia32_pshufw((__v4hi)(v), (imm)))
+
+SIMD_MMXEXT_TARGET
+static inline __m64 mmx_load(const void* p) {
+    __m64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+SIMD_MMXEXT_TARGET
+static inline void mmx_store(void* p, __m64 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_add_epi32(void* a, void* b, void* result) {
+    uint8_t* pa = (uint8_t*)a;
+    uint8_t* pb = (uint8_t*)b;
+    uint8_t* pr = (uint8_t*)result;
+    __m64 lo = _mm_add_pi32(mmx_load(pa), mmx_load(pb));
+    __m64 hi = _mm_add_pi32(mmx_load(pa + 8), mmx_load(pb + 8));
+    mmx_store(pr, lo);
+    mmx_store(pr + 8, hi);
+    MMX_LEAVE();
+}
+
+/* Span operations */
+SIMD_MMXEXT_TARGET
+static const uint8_t* mmxext_find_byte(const uint8_t* data, size_t length,
+                                       uint8_t value) {
+    const __m64 needle = _mm_set1_pi8((char)value);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        int matches = mmxext_movemask(_mm_cmpeq_pi8(mmx_load(data + i), needle));
+        if (matches != 0) {
+            MMX_LEAVE();
+            return data + i + simd_ctz32(matches);
+        }
+    }
+    MMX_LEAVE();
+    return simd_scalar_find_byte(data + i, length - i, value);
+}
+
+SIMD_MMXEXT_TARGET
+static const uint8_t* mmxext_find_last_byte(const uint8_t* data,
+                                            size_t length, uint8_t value) {
+    const __m64 needle = _mm_set1_pi8((char)value);
+    size_t i = length;
+    for (; i >= 8; i -= 8) {
+        int matches =
+            mmxext_movemask(_mm_cmpeq_pi8(mmx_load(data + i - 8), needle));
+        if (matches != 0) {
+            MMX_LEAVE();
+            return data + i - 8 + simd_msb32(matches);
+        }
+    }
+    MMX_LEAVE();
+    return simd_scalar_find_last_byte(data, i, value);
+}
+
+SIMD_MMXEXT_TARGET
+static const uint8_t* mmxext_find_byte_pair(const uint8_t* data,
+                                            size_t length, uint8_t first,
+                                            uint8_t last, size_t distance) {
+    const __m64 vfirst = _mm_set1_pi8((char)first);
+    const __m64 vlast = _mm_set1_pi8((char)last);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m64 candidates =
+            _mm_and_si64(_mm_cmpeq_pi8(mmx_load(data + i), vfirst),
+                         _mm_cmpeq_pi8(mmx_load(data + i + distance), vlast));
+        int matches = mmxext_movemask(candidates);
+        if (matches != 0) {
+            MMX_LEAVE();
+            return data + i + simd_ctz32(matches);
+        }
+    }
+    MMX_LEAVE();
+    return simd_scalar_find_byte_pair(data + i, length - i, first, last,
+                                      distance);
+}
+
+SIMD_MMXEXT_TARGET
+static int mmxext_compare_bytes(const uint8_t* a, const uint8_t* b,
+                                size_t length) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        int equal = mmxext_movemask(_mm_cmpeq_pi8(mmx_load(a + i),
+                                                  mmx_load(b + i)));
+        if (equal != 0xff) {
+            size_t at = i + simd_ctz32(~equal);
+            MMX_LEAVE();
+            return a[at] < b[at] ? -1 : 1;
+        }
+    }
+    MMX_LEAVE();
+    return simd_scalar_compare_bytes(a + i, b + i, length - i);
+}
+
+/* Copies and fills of at least this size go around the cache with movntq, so
+ * that one large Buffer does not evict the rest of the working set. */
+#define MMXEXT_STREAM_THRESHOLD (256 * 1024)
+
+/* Bytes to the next 8-byte boundary of p, at most length. */
+static inline size_t mmxext_align_head(const uint8_t* p, size_t length) {
+    size_t head = (size_t)(-(uintptr_t)p & 7);
+    return head < length ? head : length;
+}
+
+SIMD_MMXEXT_TARGET
+static inline void mmxext_stream(void* p, __m64 v) {
+    __builtin_ia32_movntq((unsigned long long*)p, (unsigned long long)v);
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_copy_bytes(uint8_t* dst, const uint8_t* src,
+                              size_t length) {
+    size_t i = mmxext_align_head(dst, length);
+    simd_scalar_copy_bytes(dst, src, i);
+    if (length - i >= MMXEXT_STREAM_THRESHOLD) {
+        for (; i + 64 <= length; i += 64) {
+            __builtin_prefetch(src + i + 512, 0, 0);
+            for (size_t j = 0; j < 64; j += 8) {
+                mmxext_stream(dst + i + j, mmx_load(src + i + j));
+            }
+        }
+        __builtin_ia32_sfence();
+    } else {
+        for (; i + 64 <= length; i += 64) {
+            SIMD_PREFETCH(src + i + 256);
+            for (size_t j = 0; j < 64; j += 8) {
+                mmx_store(dst + i + j, mmx_load(src + i + j));
+            }
+        }
+    }
+    for (; i + 8 <= length; i += 8) {
+        mmx_store(dst + i, mmx_load(src + i));
+    }
+    MMX_LEAVE();
+    simd_scalar_copy_bytes(dst + i, src + i, length - i);
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_fill_bytes(uint8_t* dst, uint8_t value, size_t length) {
+    const __m64 splat = _mm_set1_pi8((char)value);
+    size_t i = mmxext_align_head(dst, length);
+    simd_scalar_fill_bytes(dst, value, i);
+    if (length - i >= MMXEXT_STREAM_THRESHOLD) {
+        for (; i + 8 <= length; i += 8) {
+            mmxext_stream(dst + i, splat);
+        }
+        __builtin_ia32_sfence();
+    } else {
+        for (; i + 8 <= length; i += 8) {
+            mmx_store(dst + i, splat);
+        }
+    }
+    MMX_LEAVE();
+    simd_scalar_fill_bytes(dst + i, value, length - i);
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_xor_bytes(uint8_t* dst, const uint8_t* src, size_t length) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        mmx_store(dst + i, _mm_xor_si64(mmx_load(dst + i), mmx_load(src + i)));
+    }
+    MMX_LEAVE();
+    simd_scalar_xor_bytes(dst + i, src + i, length - i);
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_mask_bytes(uint8_t* dst, const uint8_t* src, size_t length,
+                              const uint8_t mask[4]) {
+    uint8_t mask8[8];
+    memcpy(mask8, mask, 4);
+    memcpy(mask8 + 4, mask, 4);
+    const __m64 vmask = mmx_load(mask8);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        mmx_store(dst + i, _mm_xor_si64(mmx_load(src + i), vmask));
+    }
+    MMX_LEAVE();
+    /* i is a multiple of 4, so the mask phase is unchanged for the tail */
+    simd_scalar_mask_bytes(dst + i, src + i, length - i, mask);
+}
+
+SIMD_MMXEXT_TARGET
+static uint64_t mmxext_sum_bytes(const uint8_t* data, size_t length) {
+    const __m64 zero = _mm_setzero_si64();
+    uint64_t sum = 0;
+    size_t i = 0;
+    while (i + 8 <= length) {
+        /* Each psadbw adds at most 8 * 255, so a 32-bit lane holds the sum of
+         * well over a million blocks; flush it long before that. */
+        __m64 acc = _mm_setzero_si64();
+        size_t block_end = length - i > (1u << 20) ? i + (1u << 20) : length;
+        for (; i + 8 <= block_end; i += 8) {
+            acc = _mm_add_pi32(acc, mmxext_sad_pu8(mmx_load(data + i), zero));
+        }
+        sum += (uint32_t)_mm_cvtsi64_si32(acc);
+    }
+    MMX_LEAVE();
+    return sum + simd_scalar_sum_bytes(data + i, length - i);
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_min_max_bytes(const uint8_t* data, size_t length,
+                                 uint8_t* min, uint8_t* max) {
+    __m64 vmin = _mm_set1_pi8((char)0xff);
+    __m64 vmax = _mm_setzero_si64();
+    uint8_t lanes[16];
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m64 v = mmx_load(data + i);
+        vmin = mmxext_min_pu8(vmin, v);
+        vmax = mmxext_max_pu8(vmax, v);
+    }
+    mmx_store(lanes, vmin);
+    mmx_store(lanes + 8, vmax);
+    MMX_LEAVE();
+    simd_scalar_min_max_bytes(data + i, length - i, min, max);
+    for (int j = 0; j < 8; j++) {
+        if (lanes[j] < *min) *min = lanes[j];
+        if (lanes[8 + j] > *max) *max = lanes[8 + j];
+    }
+}
+
+SIMD_MMXEXT_TARGET
+static inline __m64 mmx_swap_bytes_in_words(__m64 v) {
+    return _mm_or_si64(_mm_slli_pi16(v, 8), _mm_srli_pi16(v, 8));
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_swap_bytes16(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, p += 8) {
+        mmx_store(p, mmx_swap_bytes_in_words(mmx_load(p)));
+    }
+    MMX_LEAVE();
+    simd_scalar_swap_bytes16(p, count - i);
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_swap_bytes32(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2, p += 8) {
+        __m64 v = mmxext_shuffle_pi16(mmx_load(p), 0xb1);
+        mmx_store(p, mmx_swap_bytes_in_words(v));
+    }
+    MMX_LEAVE();
+    simd_scalar_swap_bytes32(p, count - i);
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_swap_bytes64(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    for (size_t i = 0; i < count; i++, p += 8) {
+        __m64 v = mmxext_shuffle_pi16(mmx_load(p), 0x1b);
+        mmx_store(p, mmx_swap_bytes_in_words(v));
+    }
+    MMX_LEAVE();
+}
+
+SIMD_MMXEXT_TARGET
+static int mmxext_validate_ascii(const uint8_t* data, size_t length) {
+    __m64 acc = _mm_setzero_si64();
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        acc = _mm_or_si64(acc, mmx_load(data + i));
+    }
+    int high_bits = mmxext_movemask(acc);
+    MMX_LEAVE();
+    if (high_bits != 0) return 0;
+    return simd_scalar_validate_ascii(data + i, length - i);
+}
+
+/* Nibbles 0-15 to '0'-'9', 'a'-'f' */
+SIMD_MMXEXT_TARGET
+static inline __m64 mmx_hex_digits(__m64 nibbles) {
+    __m64 letters = _mm_cmpgt_pi8(nibbles, _mm_set1_pi8(9));
+    return _mm_add_pi8(_mm_add_pi8(nibbles, _mm_set1_pi8('0')),
+                       _mm_and_si64(letters, _mm_set1_pi8('a' - '0' - 10)));
+}
+
+SIMD_MMXEXT_TARGET
+static void mmxext_hex_encode(char* dst, const uint8_t* src, size_t length) {
+    const __m64 low4 = _mm_set1_pi8(0x0f);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m64 v = mmx_load(src + i);
+        __m64 hi = mmx_hex_digits(_mm_and_si64(_mm_srli_pi16(v, 4), low4));
+        __m64 lo = mmx_hex_digits(_mm_and_si64(v, low4));
+        mmx_store(dst + 2 * i, _mm_unpacklo_pi8(hi, lo));
+        mmx_store(dst + 2 * i + 8, _mm_unpackhi_pi8(hi, lo));
+    }
+    MMX_LEAVE();
+    simd_scalar_hex_encode(dst + 2 * i, src + i, length - i);
+}
+
+SIMD_MMXEXT_TARGET
+void simd_mmx_emms(void) {
+    _mm_empty();
+}
+
+const simd_functions_t simd_mmxext_functions = {
+    .add_epi32 = mmxext_add_epi32,
+    .find_byte = mmxext_find_byte,
+    .find_last_byte = mmxext_find_last_byte,
+    .find_byte_pair = mmxext_find_byte_pair,
+    .compare_bytes = mmxext_compare_bytes,
+    .copy_bytes = mmxext_copy_bytes,
+    .fill_bytes = mmxext_fill_bytes,
+    .xor_bytes = mmxext_xor_bytes,
+    .mask_bytes = mmxext_mask_bytes,
+    .sum_bytes = mmxext_sum_bytes,
+    .min_max_bytes = mmxext_min_max_bytes,
+    .swap_bytes16 = mmxext_swap_bytes16,
+    .swap_bytes32 = mmxext_swap_bytes32,
+    .swap_bytes64 = mmxext_swap_bytes64,
+    .validate_ascii = mmxext_validate_ascii,
+    .hex_encode = mmxext_hex_encode,
+};
+
+#endif /* SIMD_HAVE_MMXEXT_KERNELS */
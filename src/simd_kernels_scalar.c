@@ -0,0 +1,199 @@
+#include "simd_kernels.h"
+#include <string.h>
+
+/* Scalar implementations as fallback */
+static void scalar_add_ps(void* a, void* b, void* result) {
+    float* fa = (float*)a;
+    float* fb = (float*)b;
+    float* fr = (float*)result;
+    for (int i = 0; i < 4; i++) {
+        fr[i] = fa[i] + fb[i];
+    }
+}
+
+static void scalar_mul_ps(void* a, void* b, void* result) {
+    float* fa = (float*)a;
+    float* fb = (float*)b;
+    float* fr = (float*)result;
+    for (int i = 0; i < 4; i++) {
+        fr[i] = fa[i] * fb[i];
+    }
+}
+
+static void scalar_sub_ps(void* a, void* b, void* result) {
+    float* fa = (float*)a;
+    float* fb = (float*)b;
+    float* fr = (float*)result;
+    for (int i = 0; i < 4; i++) {
+        fr[i] = fa[i] - fb[i];
+    }
+}
+
+static void scalar_add_epi32(void* a, void* b, void* result) {
+    int32_t* ia = (int32_t*)a;
+    int32_t* ib = (int32_t*)b;
+    int32_t* ir = (int32_t*)result;
+    for (int i = 0; i < 4; i++) {
+        ir[i] = ia[i] + ib[i];
+    }
+}
+
+static void scalar_shuffle_epi32(void* a, int mask, void* result) {
+    int32_t ia[4];
+    int32_t* ir = (int32_t*)result;
+
+    /* Copy first so that a == result works like the SIMD versions */
+    memcpy(ia, a, sizeof(ia));
+
+    // Extract mask components (for SSE2-style shuffle mask)
+    ir[0] = ia[(mask >> 0) & 0x3];
+    ir[1] = ia[(mask >> 2) & 0x3];
+    ir[2] = ia[(mask >> 4) & 0x3];
+    ir[3] = ia[(mask >> 6) & 0x3];
+}
+
+/* Span operations */
+const uint8_t* simd_scalar_find_byte(const uint8_t* data, size_t length,
+                                     uint8_t value) {
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == value) return data + i;
+    }
+    return NULL;
+}
+
+const uint8_t* simd_scalar_find_last_byte(const uint8_t* data, size_t length,
+                                          uint8_t value) {
+    for (size_t i = length; i-- > 0;) {
+        if (data[i] == value) return data + i;
+    }
+    return NULL;
+}
+
+const uint8_t* simd_scalar_find_byte_pair(const uint8_t* data, size_t length,
+                                          uint8_t first, uint8_t last,
+                                          size_t distance) {
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == first && data[i + distance] == last) return data + i;
+    }
+    return NULL;
+}
+
+int simd_scalar_compare_bytes(const uint8_t* a, const uint8_t* b,
+                              size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+void simd_scalar_copy_bytes(uint8_t* dst, const uint8_t* src, size_t length) {
+    if (length > 0) memcpy(dst, src, length);
+}
+
+void simd_scalar_fill_bytes(uint8_t* dst, uint8_t value, size_t length) {
+    if (length > 0) memset(dst, value, length);
+}
+
+void simd_scalar_xor_bytes(uint8_t* dst, const uint8_t* src, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+void simd_scalar_mask_bytes(uint8_t* dst, const uint8_t* src, size_t length,
+                            const uint8_t mask[4]) {
+    for (size_t i = 0; i < length; i++) {
+        dst[i] = src[i] ^ mask[i & 3];
+    }
+}
+
+uint64_t simd_scalar_sum_bytes(const uint8_t* data, size_t length) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+void simd_scalar_min_max_bytes(const uint8_t* data, size_t length,
+                               uint8_t* min, uint8_t* max) {
+    uint8_t lo = 0xff;
+    uint8_t hi = 0x00;
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] < lo) lo = data[i];
+        if (data[i] > hi) hi = data[i];
+    }
+    *min = lo;
+    *max = hi;
+}
+
+void simd_scalar_swap_bytes16(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    for (size_t i = 0; i < count; i++, p += 2) {
+        uint8_t t = p[0];
+        p[0] = p[1];
+        p[1] = t;
+    }
+}
+
+void simd_scalar_swap_bytes32(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    for (size_t i = 0; i < count; i++, p += 4) {
+        uint8_t t0 = p[0];
+        uint8_t t1 = p[1];
+        p[0] = p[3];
+        p[1] = p[2];
+        p[2] = t1;
+        p[3] = t0;
+    }
+}
+
+void simd_scalar_swap_bytes64(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    for (size_t i = 0; i < count; i++, p += 8) {
+        for (int j = 0; j < 4; j++) {
+            uint8_t t = p[j];
+            p[j] = p[7 - j];
+            p[7 - j] = t;
+        }
+    }
+}
+
+int simd_scalar_validate_ascii(const uint8_t* data, size_t length) {
+    uint8_t acc = 0;
+    for (size_t i = 0; i < length; i++) {
+        acc |= data[i];
+    }
+    return (acc & 0x80) == 0;
+}
+
+void simd_scalar_hex_encode(char* dst, const uint8_t* src, size_t length) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < length; i++) {
+        dst[2 * i] = digits[src[i] >> 4];
+        dst[2 * i + 1] = digits[src[i] & 15];
+    }
+}
+
+const simd_functions_t simd_scalar_functions = {
+    .add_ps = scalar_add_ps,
+    .mul_ps = scalar_mul_ps,
+    .sub_ps = scalar_sub_ps,
+    .add_epi32 = scalar_add_epi32,
+    .shuffle_epi32 = scalar_shuffle_epi32,
+    .find_byte = simd_scalar_find_byte,
+    .find_last_byte = simd_scalar_find_last_byte,
+    .find_byte_pair = simd_scalar_find_byte_pair,
+    .compare_bytes = simd_scalar_compare_bytes,
+    .copy_bytes = simd_scalar_copy_bytes,
+    .fill_bytes = simd_scalar_fill_bytes,
+    .xor_bytes = simd_scalar_xor_bytes,
+    .mask_bytes = simd_scalar_mask_bytes,
+    .sum_bytes = simd_scalar_sum_bytes,
+    .min_max_bytes = simd_scalar_min_max_bytes,
+    .swap_bytes16 = simd_scalar_swap_bytes16,
+    .swap_bytes32 = simd_scalar_swap_bytes32,
+    .swap_bytes64 = simd_scalar_swap_bytes64,
+    .validate_ascii = simd_scalar_validate_ascii,
+    .hex_encode = simd_scalar_hex_encode,
+};
@@ -0,0 +1,272 @@
+#include "simd_kernels.h"
+
+#if defined(SIMD_HAVE_SSE2_KERNELS)
+
+#include <emmintrin.h>
+#include <string.h>
+
+/* SSE2 implementations */
+SIMD_TARGET("sse2")
+static void sse2_add_ps(void* a, void* b, void* result) {
+    __m128 va = _mm_loadu_ps((const float*)a);
+    __m128 vb = _mm_loadu_ps((const float*)b);
+    _mm_storeu_ps((float*)result, _mm_add_ps(va, vb));
+}
+
+SIMD_TARGET("sse2")
+static void sse2_mul_ps(void* a, void* b, void* result) {
+    __m128 va = _mm_loadu_ps((const float*)a);
+    __m128 vb = _mm_loadu_ps((const float*)b);
+    _mm_storeu_ps((float*)result, _mm_mul_ps(va, vb));
+}
+
+SIMD_TARGET("sse2")
+static void sse2_sub_ps(void* a, void* b, void* result) {
+    __m128 va = _mm_loadu_ps((const float*)a);
+    __m128 vb = _mm_loadu_ps((const float*)b);
+    _mm_storeu_ps((float*)result, _mm_sub_ps(va, vb));
+}
+
+SIMD_TARGET("sse2")
+static void sse2_add_epi32(void* a, void* b, void* result) {
+    __m128i va = _mm_loadu_si128((const __m128i*)a);
+    __m128i vb = _mm_loadu_si128((const __m128i*)b);
+    _mm_storeu_si128((__m128i*)result, _mm_add_epi32(va, vb));
+}
+
+SIMD_TARGET("sse2")
+static void sse2_shuffle_epi32(void* a, int mask, void* result) {
+    /* _mm_shuffle_epi32 needs an immediate, so shuffle through a permutation
+     * of 32-bit lanes instead. */
+    int32_t lanes[4];
+    __m128i va = _mm_loadu_si128((const __m128i*)a);
+    _mm_storeu_si128((__m128i*)lanes, va);
+    _mm_storeu_si128((__m128i*)result,
+                     _mm_set_epi32(lanes[(mask >> 6) & 0x3],
+                                   lanes[(mask >> 4) & 0x3],
+                                   lanes[(mask >> 2) & 0x3],
+                                   lanes[(mask >> 0) & 0x3]));
+}
+
+/* Span operations */
+SIMD_TARGET("sse2")
+static const uint8_t* sse2_find_byte(const uint8_t* data, size_t length,
+                                     uint8_t value) {
+    const __m128i needle = _mm_set1_epi8((char)value);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        int matches = _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+        if (matches != 0) return data + i + simd_ctz32(matches);
+    }
+    return simd_scalar_find_byte(data + i, length - i, value);
+}
+
+SIMD_TARGET("sse2")
+static const uint8_t* sse2_find_last_byte(const uint8_t* data, size_t length,
+                                          uint8_t value) {
+    const __m128i needle = _mm_set1_epi8((char)value);
+    size_t i = length;
+    for (; i >= 16; i -= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i - 16));
+        int matches = _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+        if (matches != 0) return data + i - 16 + simd_msb32(matches);
+    }
+    return simd_scalar_find_last_byte(data, i, value);
+}
+
+SIMD_TARGET("sse2")
+static const uint8_t* sse2_find_byte_pair(const uint8_t* data, size_t length,
+                                          uint8_t first, uint8_t last,
+                                          size_t distance) {
+    const __m128i vfirst = _mm_set1_epi8((char)first);
+    const __m128i vlast = _mm_set1_epi8((char)last);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(data + i + distance));
+        int matches = _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(a, vfirst), _mm_cmpeq_epi8(b, vlast)));
+        if (matches != 0) return data + i + simd_ctz32(matches);
+    }
+    return simd_scalar_find_byte_pair(data + i, length - i, first, last,
+                                      distance);
+}
+
+SIMD_TARGET("sse2")
+static int sse2_compare_bytes(const uint8_t* a, const uint8_t* b,
+                              size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+        if (equal != 0xffff) {
+            size_t at = i + simd_ctz32(~equal);
+            return a[at] < b[at] ? -1 : 1;
+        }
+    }
+    return simd_scalar_compare_bytes(a + i, b + i, length - i);
+}
+
+SIMD_TARGET("sse2")
+static void sse2_xor_bytes(uint8_t* dst, const uint8_t* src, size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i vd = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i vs = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(vd, vs));
+    }
+    simd_scalar_xor_bytes(dst + i, src + i, length - i);
+}
+
+SIMD_TARGET("sse2")
+static void sse2_mask_bytes(uint8_t* dst, const uint8_t* src, size_t length,
+                            const uint8_t mask[4]) {
+    int32_t mask32;
+    memcpy(&mask32, mask, sizeof(mask32));
+    const __m128i vmask = _mm_set1_epi32(mask32);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i vs = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(vs, vmask));
+    }
+    /* i is a multiple of 4, so the mask phase is unchanged for the tail */
+    simd_scalar_mask_bytes(dst + i, src + i, length - i, mask);
+}
+
+SIMD_TARGET("sse2")
+static uint64_t sse2_sum_bytes(const uint8_t* data, size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+    uint64_t lanes[2];
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+    }
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return lanes[0] + lanes[1] +
+           simd_scalar_sum_bytes(data + i, length - i);
+}
+
+SIMD_TARGET("sse2")
+static void sse2_min_max_bytes(const uint8_t* data, size_t length,
+                               uint8_t* min, uint8_t* max) {
+    __m128i vmin = _mm_set1_epi8((char)0xff);
+    __m128i vmax = _mm_setzero_si128();
+    uint8_t lanes[32];
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        vmin = _mm_min_epu8(vmin, v);
+        vmax = _mm_max_epu8(vmax, v);
+    }
+    _mm_storeu_si128((__m128i*)lanes, vmin);
+    _mm_storeu_si128((__m128i*)(lanes + 16), vmax);
+    simd_scalar_min_max_bytes(data + i, length - i, min, max);
+    for (int j = 0; j < 16; j++) {
+        if (lanes[j] < *min) *min = lanes[j];
+        if (lanes[16 + j] > *max) *max = lanes[16 + j];
+    }
+}
+
+SIMD_TARGET("sse2")
+static inline __m128i sse2_swap_bytes_in_words(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+SIMD_TARGET("sse2")
+static void sse2_swap_bytes16(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        _mm_storeu_si128((__m128i*)p, sse2_swap_bytes_in_words(v));
+    }
+    simd_scalar_swap_bytes16(p, count - i);
+}
+
+SIMD_TARGET("sse2")
+static void sse2_swap_bytes32(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        /* Swap the 16-bit halves of every 32-bit lane, then their bytes */
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xb1), 0xb1);
+        _mm_storeu_si128((__m128i*)p, sse2_swap_bytes_in_words(v));
+    }
+    simd_scalar_swap_bytes32(p, count - i);
+}
+
+SIMD_TARGET("sse2")
+static void sse2_swap_bytes64(void* data, size_t count) {
+    uint8_t* p = (uint8_t*)data;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2, p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        /* Reverse the 16-bit words of every 64-bit lane, then their bytes */
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1b), 0x1b);
+        _mm_storeu_si128((__m128i*)p, sse2_swap_bytes_in_words(v));
+    }
+    simd_scalar_swap_bytes64(p, count - i);
+}
+
+SIMD_TARGET("sse2")
+static int sse2_validate_ascii(const uint8_t* data, size_t length) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        acc = _mm_or_si128(acc,
+                           _mm_loadu_si128((const __m128i*)(data + i)));
+    }
+    if (_mm_movemask_epi8(acc) != 0) return 0;
+    return simd_scalar_validate_ascii(data + i, length - i);
+}
+
+/* Nibbles 0-15 to '0'-'9', 'a'-'f' */
+SIMD_TARGET("sse2")
+static inline __m128i sse2_hex_digits(__m128i nibbles) {
+    __m128i letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')),
+                        _mm_and_si128(letters, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+SIMD_TARGET("sse2")
+static void sse2_hex_encode(char* dst, const uint8_t* src, size_t length) {
+    const __m128i low4 = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i hi = sse2_hex_digits(_mm_and_si128(_mm_srli_epi16(v, 4), low4));
+        __m128i lo = sse2_hex_digits(_mm_and_si128(v, low4));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i + 16),
+                         _mm_unpackhi_epi8(hi, lo));
+    }
+    simd_scalar_hex_encode(dst + 2 * i, src + i, length - i);
+}
+
+const simd_functions_t simd_sse2_functions = {
+    .add_ps = sse2_add_ps,
+    .mul_ps = sse2_mul_ps,
+    .sub_ps = sse2_sub_ps,
+    .add_epi32 = sse2_add_epi32,
+    .shuffle_epi32 = sse2_shuffle_epi32,
+    .find_byte = sse2_find_byte,
+    .find_last_byte = sse2_find_last_byte,
+    .find_byte_pair = sse2_find_byte_pair,
+    .compare_bytes = sse2_compare_bytes,
+    .xor_bytes = sse2_xor_bytes,
+    .mask_bytes = sse2_mask_bytes,
+    .sum_bytes = sse2_sum_bytes,
+    .min_max_bytes = sse2_min_max_bytes,
+    .swap_bytes16 = sse2_swap_bytes16,
+    .swap_bytes32 = sse2_swap_bytes32,
+    .swap_bytes64 = sse2_swap_bytes64,
+    .validate_ascii = sse2_validate_ascii,
+    .hex_encode = sse2_hex_encode,
+};
+
+#endif /* SIMD_HAVE_SSE2_KERNELS */
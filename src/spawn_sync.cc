@@ -28,6 +28,8 @@
 #include "string_bytes.h"
 #include "util-inl.h"
 
+#include <algorithm>
+#include <climits>
 #include <cstring>
 #include "nbytes.h"
 
@@ -53,48 +55,57 @@ using v8::Object;
 using v8::String;
 using v8::Value;
 
-void SyncProcessOutputBuffer::OnAlloc(size_t suggested_size,
-                                      uv_buf_t* buf) const {
-  if (used() == kBufferSize)
-    *buf = uv_buf_init(nullptr, 0);
-  else
-    *buf = uv_buf_init(data_ + used(), available());
+SyncProcessOutputBuffer::~SyncProcessOutputBuffer() {
+  free(data_);
 }
 
 
-void SyncProcessOutputBuffer::OnRead(const uv_buf_t* buf, size_t nread) {
-  // If we hand out the same chunk twice, this should catch it.
-  CHECK_EQ(buf->base, data_ + used());
-  used_ += static_cast<unsigned int>(nread);
+void SyncProcessOutputBuffer::OnAlloc(size_t suggested_size, uv_buf_t* buf) {
+  if (used_ == capacity_) {
+    size_t capacity = capacity_ == 0 ? kInitialSize : capacity_ * 2;
+    char* data = UncheckedRealloc(data_, capacity);
+    if (data == nullptr) {
+      *buf = uv_buf_init(nullptr, 0);
+      return;
+    }
+    data_ = data;
+    capacity_ = capacity;
+  }
+  // uv_buf_init() takes an unsigned int.
+  size_t available = std::min<size_t>(capacity_ - used_, UINT_MAX);
+  *buf = uv_buf_init(data_ + used_, static_cast<unsigned int>(available));
 }
 
 
-size_t SyncProcessOutputBuffer::Copy(char* dest) const {
-  if (dest != nullptr) memcpy(dest, data_, used());
-  return used();
+void SyncProcessOutputBuffer::OnRead(const uv_buf_t* buf, size_t nread) {
+  // If we hand out the same chunk twice, this should catch it.
+  CHECK_EQ(buf->base, data_ + used_);
+  used_ += nread;
 }
 
 
-unsigned int SyncProcessOutputBuffer::available() const {
-  return sizeof data_ - used();
+char* SyncProcessOutputBuffer::Release() {
+  char* data = data_;
+  if (used_ == 0) {
+    free(data);
+    data = nullptr;
+  } else if (used_ < capacity_) {
+    // Shrinking is done in place, or by unmapping the tail.
+    char* trimmed = UncheckedRealloc(data, used_);
+    if (trimmed != nullptr) data = trimmed;
+  }
+  data_ = nullptr;
+  capacity_ = 0;
+  used_ = 0;
+  return data;
 }
 
 
-unsigned int SyncProcessOutputBuffer::used() const {
+size_t SyncProcessOutputBuffer::used() const {
   return used_;
 }
 
 
-SyncProcessOutputBuffer* SyncProcessOutputBuffer::next() const {
-  return next_;
-}
-
-
-void SyncProcessOutputBuffer::set_next(SyncProcessOutputBuffer* next) {
-  next_ = next;
-}
-
-
 SyncProcessStdioPipe::SyncProcessStdioPipe(SyncProcessRunner* process_handler,
                                            bool readable,
                                            bool writable,
@@ -104,9 +115,6 @@ SyncProcessStdioPipe::SyncProcessStdioPipe(SyncProcessRunner* process_handler,
       writable_(writable),
       input_buffer_(input_buffer),
 
-      first_output_buffer_(nullptr),
-      last_output_buffer_(nullptr),
-
       uv_pipe_(),
       write_req_(),
       shutdown_req_(),
@@ -118,14 +126,6 @@ SyncProcessStdioPipe::SyncProcessStdioPipe(SyncProcessRunner* process_handler,
 
 SyncProcessStdioPipe::~SyncProcessStdioPipe() {
   CHECK(lifecycle_ == kUninitialized || lifecycle_ == kClosed);
-
-  SyncProcessOutputBuffer* buf;
-  SyncProcessOutputBuffer* next;
-
-  for (buf = first_output_buffer_; buf != nullptr; buf = next) {
-    next = buf->next();
-    delete buf;
-  }
 }
 
 
@@ -187,14 +187,17 @@ void SyncProcessStdioPipe::Close() {
 }
 
 MaybeLocal<Object> SyncProcessStdioPipe::GetOutputAsBuffer(
-    Environment* env) const {
-  size_t length = OutputLength();
-  Local<Object> js_buffer;
-  if (!Buffer::New(env, length).ToLocal(&js_buffer)) {
-    return MaybeLocal<Object>();
-  }
-  CopyOutput(Buffer::Data(js_buffer));
-  return js_buffer;
+    Environment* env) {
+  size_t length = output_buffer_.used();
+  char* data = output_buffer_.Release();
+  if (data == nullptr) return Buffer::New(env, 0);
+#if defined(V8_ENABLE_SANDBOX)
+  // Memory from outside of the sandbox cannot back an ArrayBuffer.
+  auto free_data = OnScopeLeave([&]() { free(data); });
+  return Buffer::Copy(env, data, length);
+#else
+  return Buffer::New(env, data, length);
+#endif
 }
 
 bool SyncProcessStdioPipe::readable() const {
@@ -236,45 +239,12 @@ uv_handle_t* SyncProcessStdioPipe::uv_handle() const {
 }
 
 
-size_t SyncProcessStdioPipe::OutputLength() const {
-  SyncProcessOutputBuffer* buf;
-  size_t size = 0;
-
-  for (buf = first_output_buffer_; buf != nullptr; buf = buf->next())
-    size += buf->used();
-
-  return size;
-}
-
-
-void SyncProcessStdioPipe::CopyOutput(char* dest) const {
-  SyncProcessOutputBuffer* buf;
-  size_t offset = 0;
-
-  for (buf = first_output_buffer_; buf != nullptr; buf = buf->next())
-    offset += buf->Copy(dest + offset);
-}
-
-
 void SyncProcessStdioPipe::OnAlloc(size_t suggested_size, uv_buf_t* buf) {
   // This function assumes that libuv will never allocate two buffers for the
   // same stream at the same time. There's an assert in
   // SyncProcessOutputBuffer::OnRead that would fail if this assumption was
   // ever violated.
-
-  if (last_output_buffer_ == nullptr) {
-    // Allocate the first capture buffer.
-    first_output_buffer_ = new SyncProcessOutputBuffer();
-    last_output_buffer_ = first_output_buffer_;
-
-  } else if (last_output_buffer_->available() == 0) {
-    // The current capture buffer is full so get us a new one.
-    SyncProcessOutputBuffer* buf = new SyncProcessOutputBuffer();
-    last_output_buffer_->set_next(buf);
-    last_output_buffer_ = buf;
-  }
-
-  last_output_buffer_->OnAlloc(suggested_size, buf);
+  output_buffer_.OnAlloc(suggested_size, buf);
 }
 
 
@@ -288,7 +258,7 @@ void SyncProcessStdioPipe::OnRead(const uv_buf_t* buf, ssize_t nread) {
     uv_read_stop(uv_stream());
 
   } else {
-    last_output_buffer_->OnRead(buf, nread);
+    output_buffer_.OnRead(buf, nread);
     process_handler_->IncrementBufferSizeAndCheckOverflow(nread);
   }
 }
@@ -36,29 +36,35 @@ class SyncProcessStdioPipe;
 class SyncProcessRunner;
 
 
+// Collects the output of a pipe in a single malloc()ed allocation that
+// doubles in size whenever it fills up, so that it can become the result
+// Buffer without being copied. Large allocations are mmap()ed by the C
+// library, and growing those with realloc() usually remaps pages rather
+// than copying them.
 class SyncProcessOutputBuffer {
-  static const unsigned int kBufferSize = 65536;
+  static const size_t kInitialSize = 65536;
 
  public:
   inline SyncProcessOutputBuffer() = default;
+  inline ~SyncProcessOutputBuffer();
+  SyncProcessOutputBuffer(const SyncProcessOutputBuffer&) = delete;
+  SyncProcessOutputBuffer& operator=(const SyncProcessOutputBuffer&) = delete;
 
-  inline void OnAlloc(size_t suggested_size, uv_buf_t* buf) const;
+  // Hands out an empty buffer, so that the read fails with UV_ENOBUFS, if
+  // the allocation cannot grow.
+  inline void OnAlloc(size_t suggested_size, uv_buf_t* buf);
   inline void OnRead(const uv_buf_t* buf, size_t nread);
 
-  inline size_t Copy(char* dest) const;
-
-  inline unsigned int available() const;
-  inline unsigned int used() const;
+  // Passes ownership of the output to the caller, trimmed to its length,
+  // and leaves this buffer empty. Returns nullptr if there is no output.
+  inline char* Release();
 
-  inline SyncProcessOutputBuffer* next() const;
-  inline void set_next(SyncProcessOutputBuffer* next);
+  inline size_t used() const;
 
  private:
-  // Use unsigned int because that's what `uv_buf_init` takes.
-  mutable char data_[kBufferSize];
-  unsigned int used_ = 0;
-
-  SyncProcessOutputBuffer* next_ = nullptr;
+  char* data_ = nullptr;
+  size_t capacity_ = 0;
+  size_t used_ = 0;
 };
 
 
@@ -82,7 +88,8 @@ class SyncProcessStdioPipe {
   int Start();
   void Close();
 
-  v8::MaybeLocal<v8::Object> GetOutputAsBuffer(Environment* env) const;
+  // Moves the output into a Buffer, leaving none in the pipe.
+  v8::MaybeLocal<v8::Object> GetOutputAsBuffer(Environment* env);
 
   inline bool readable() const;
   inline bool writable() const;
@@ -93,9 +100,6 @@ class SyncProcessStdioPipe {
   inline uv_handle_t* uv_handle() const;
 
  private:
-  inline size_t OutputLength() const;
-  inline void CopyOutput(char* dest) const;
-
   inline void OnAlloc(size_t suggested_size, uv_buf_t* buf);
   inline void OnRead(const uv_buf_t* buf, ssize_t nread);
   inline void OnWriteDone(int result);
@@ -120,8 +124,7 @@ class SyncProcessStdioPipe {
   bool writable_;
   uv_buf_t input_buffer_;
 
-  SyncProcessOutputBuffer* first_output_buffer_;
-  SyncProcessOutputBuffer* last_output_buffer_;
+  SyncProcessOutputBuffer output_buffer_;
 
   mutable uv_pipe_t uv_pipe_;
   uv_write_t write_req_;
@@ -6,6 +6,7 @@
 #include "async_wrap-inl.h"
 #include "base_object-inl.h"
 #include "node.h"
+#include "node_usdt.h"
 #include "stream_base.h"
 #include "v8.h"
 
@@ -76,11 +77,13 @@ void StreamResource::EmitRead(ssize_t nread, const uv_buf_t& buf) {
   DebugSealHandleScope seal_handle_scope;
   if (nread > 0)
     bytes_read_ += static_cast<uint64_t>(nread);
+  NODE_USDT2(stream__read, this, static_cast<int64_t>(nread));
   listener_->OnStreamRead(nread, buf);
 }
 
 void StreamResource::EmitAfterWrite(WriteWrap* w, int status) {
   DebugSealHandleScope seal_handle_scope;
+  NODE_USDT2(stream__write__done, this, status);
   listener_->OnStreamAfterWrite(w, status);
 }
 
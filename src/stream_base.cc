@@ -2,9 +2,12 @@
 #include "stream_base-inl.h"
 #include "stream_wrap.h"
 
+#include "dataqueue/queue.h"
 #include "env-inl.h"
 #include "js_stream.h"
 #include "node.h"
+#include "node_blob.h"
+#include "node_bob.h"
 #include "node_buffer.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
@@ -12,7 +15,11 @@
 #include "util-inl.h"
 #include "v8.h"
 
+#include <algorithm>
 #include <climits>  // INT_MAX
+#include <cstdio>
+#include <cstring>
+#include <memory>
 
 namespace node {
 
@@ -39,6 +46,7 @@ using v8::ReadOnly;
 using v8::SideEffectType;
 using v8::Signature;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 int StreamBase::Shutdown(v8::Local<v8::Object> req_wrap_obj) {
@@ -80,6 +88,39 @@ int StreamBase::Shutdown(v8::Local<v8::Object> req_wrap_obj) {
   return err;
 }
 
+namespace {
+
+MaybeLocal<Object> NewWriteWrapObject(Environment* env) {
+  Local<Object> req_wrap_obj;
+  if (!env->write_wrap_template()
+           ->NewInstance(env->context())
+           .ToLocal(&req_wrap_obj)) {
+    return {};
+  }
+  StreamReq::ResetObject(req_wrap_obj);
+  return req_wrap_obj;
+}
+
+// JavaScript can pass undefined instead of a request object to writes, in
+// which case one is only created if the write does not complete
+// synchronously.
+Local<Object> WriteWrapObjectArg(Local<Value> arg) {
+  if (arg->IsUndefined()) return Local<Object>();
+  CHECK(arg->IsObject());
+  return arg.As<Object>();
+}
+
+// Returns the request object that was created for a write that JavaScript
+// passed none to, if the write did not complete synchronously.
+void SetCreatedWriteWrapObject(const FunctionCallbackInfo<Value>& args,
+                               const StreamWriteResult& res) {
+  if (args[0]->IsUndefined() && res.wrap != nullptr) {
+    args.GetReturnValue().Set(res.wrap->GetAsyncWrap()->object());
+  }
+}
+
+}  // namespace
+
 StreamWriteResult StreamBase::Write(uv_buf_t* bufs,
                                     size_t count,
                                     uv_stream_t* send_handle,
@@ -91,6 +132,9 @@ StreamWriteResult StreamBase::Write(uv_buf_t* bufs,
   size_t total_bytes = 0;
   for (size_t i = 0; i < count; ++i) total_bytes += bufs[i].len;
   bytes_written_ += total_bytes;
+  NODE_USDT2(stream__write__start,
+             static_cast<StreamResource*>(this),
+             static_cast<uint64_t>(total_bytes));
 
   if (send_handle == nullptr && HasDoTryWrite() && !skip_try_write) {
     err = DoTryWrite(&bufs, &count);
@@ -101,13 +145,9 @@ StreamWriteResult StreamBase::Write(uv_buf_t* bufs,
 
   v8::HandleScope handle_scope(env->isolate());
 
-  if (req_wrap_obj.IsEmpty()) {
-    if (!env->write_wrap_template()
-             ->NewInstance(env->context())
-             .ToLocal(&req_wrap_obj)) {
-      return StreamWriteResult{false, UV_EBUSY, nullptr, 0, {}};
-    }
-    StreamReq::ResetObject(req_wrap_obj);
+  if (req_wrap_obj.IsEmpty() &&
+      !NewWriteWrapObject(env).ToLocal(&req_wrap_obj)) {
+    return StreamWriteResult{false, UV_EBUSY, nullptr, 0, {}};
   }
 
   AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(GetAsyncWrap());
@@ -182,10 +222,9 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
   Isolate* isolate = env->isolate();
   Local<Context> context = env->context();
 
-  CHECK(args[0]->IsObject());
   CHECK(args[1]->IsArray());
 
-  Local<Object> req_wrap_obj = args[0].As<Object>();
+  Local<Object> req_wrap_obj = WriteWrapObjectArg(args[0]);
   Local<Array> chunks = args[1].As<Array>();
   bool all_buffers = args[2]->IsTrue();
 
@@ -196,6 +235,8 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
     count = chunks->Length() >> 1;
 
   MaybeStackBuffer<uv_buf_t, 16> bufs(count);
+  // A BufferList chunk is written as its own chunks, without flattening it.
+  size_t buf_count = count;
 
   size_t storage_size = 0;
   size_t offset;
@@ -211,6 +252,13 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
         continue;
         // Buffer chunk, no additional storage required
 
+      if (BufferList::HasInstance(env, chunk)) {
+        BufferList* list = BaseObject::Unwrap<BufferList>(chunk);
+        if (list == nullptr) return UV_EINVAL;
+        buf_count = buf_count - 1 + list->chunks().size();
+        continue;
+      }
+
       // String chunk
       Local<String> string;
       if (!chunk->ToString(context).ToLocal(&string))
@@ -250,6 +298,11 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
 
   offset = 0;
   if (!all_buffers) {
+    bufs.AllocateSufficientStorage(buf_count);
+    // Converting string chunks may have run JavaScript that changed the
+    // BufferLists since buf_count was computed, so check that every chunk
+    // still fits.
+    size_t n = 0;
     for (size_t i = 0; i < count; i++) {
       Local<Value> chunk;
       if (!chunks->Get(context, i * 2).ToLocal(&chunk))
@@ -257,8 +310,24 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
 
       // Write buffer
       if (Buffer::HasInstance(chunk)) {
-        bufs[i].base = Buffer::Data(chunk);
-        bufs[i].len = Buffer::Length(chunk);
+        if (n == buf_count) return UV_EINVAL;
+        bufs[n].base = Buffer::Data(chunk);
+        bufs[n].len = Buffer::Length(chunk);
+        n++;
+        continue;
+      }
+
+      // Write the chunks of a BufferList, which the caller keeps alive like
+      // the Buffers until the write is done.
+      if (BufferList::HasInstance(env, chunk)) {
+        BufferList* list = BaseObject::Unwrap<BufferList>(chunk);
+        CHECK_NOT_NULL(list);
+        if (list->chunks().size() > buf_count - n) return UV_EINVAL;
+        for (const BufferList::Chunk& list_chunk : list->chunks()) {
+          bufs[n].base = list_chunk.data();
+          bufs[n].len = list_chunk.length;
+          n++;
+        }
         continue;
       }
 
@@ -280,23 +349,337 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
                                     str_size,
                                     string,
                                     encoding);
-      bufs[i].base = str_storage;
-      bufs[i].len = str_size;
+      if (n == buf_count) return UV_EINVAL;
+      bufs[n].base = str_storage;
+      bufs[n].len = str_size;
+      n++;
       offset += str_size;
     }
+    // A BufferList may also have shrunk, leaving fewer chunks to write.
+    buf_count = n;
   }
 
-  StreamWriteResult res = Write(*bufs, count, nullptr, req_wrap_obj);
+  StreamWriteResult res = Write(*bufs, buf_count, nullptr, req_wrap_obj);
   SetWriteResult(res);
+  SetCreatedWriteWrapObject(args, res);
   if (res.wrap != nullptr && storage_size > 0)
     res.wrap->SetBackingStore(std::move(bs));
   return res.err;
 }
 
 
-int StreamBase::WriteBuffer(const FunctionCallbackInfo<Value>& args) {
+// writeHttpResponse(req, statusCode, statusMessage, headers[, body]) writes
+// an HTTP/1.1 status line and header block, followed by the optional body
+// Buffer, in one writev(). `headers` is a flat [name, value, ...] array of
+// strings that the caller has already validated; they are written as
+// latin1, as by OutgoingMessage. The header block is formatted on the stack
+// and only copied to the heap for the part that could not be written
+// synchronously.
+int StreamBase::WriteHttpResponse(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+
   CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsString());
+  CHECK(args[3]->IsArray());
+
+  Local<Object> req_wrap_obj = args[0].As<Object>();
+  const uint32_t status_code = args[1].As<Uint32>()->Value();
+  CHECK(status_code >= 100 && status_code <= 999);
+  Local<String> status_message = args[2].As<String>();
+  Local<Array> headers = args[3].As<Array>();
+  const uint32_t header_count = headers->Length();
+  CHECK_EQ(header_count % 2, 0);
+
+  Local<Value> body = args[4];
+  const bool has_body = Buffer::HasInstance(body) && Buffer::Length(body) > 0;
+
+  MaybeStackBuffer<Local<String>, 32> header_strings(header_count);
+  // "HTTP/1.1 200 " + message + "\r\n" + headers + "\r\n"
+  size_t storage_size = 13 + status_message->Length() + 2 + 2;
+  for (uint32_t i = 0; i < header_count; i++) {
+    Local<Value> value;
+    if (!headers->Get(context, i).ToLocal(&value)) return -1;
+    CHECK(value->IsString());
+    header_strings[i] = value.As<String>();
+    // ": " after a name, "\r\n" after a value.
+    storage_size += header_strings[i]->Length() + 2;
+  }
+  if (storage_size > INT_MAX) return UV_ENOBUFS;
+
+  MaybeStackBuffer<char, 4096> storage(storage_size);
+  char* out = storage.out();
+  size_t length = snprintf(out, 14, "HTTP/1.1 %03u ", status_code);
+  auto append_string = [&](Local<String> string) {
+    length += StringBytes::Write(
+        isolate, out + length, storage_size - length, string, LATIN1);
+  };
+  auto append = [&](const char* data, size_t size) {
+    memcpy(out + length, data, size);
+    length += size;
+  };
+  append_string(status_message);
+  append("\r\n", 2);
+  for (uint32_t i = 0; i < header_count; i += 2) {
+    append_string(header_strings[i]);
+    append(": ", 2);
+    append_string(header_strings[i + 1]);
+    append("\r\n", 2);
+  }
+  append("\r\n", 2);
+  CHECK_LE(length, storage_size);
+
+  uv_buf_t buffers[2] = {uv_buf_init(out, length), uv_buf_init(nullptr, 0)};
+  if (has_body) {
+    buffers[1] = uv_buf_init(Buffer::Data(body), Buffer::Length(body));
+  }
+  uv_buf_t* bufs = buffers;
+  size_t count = has_body ? 2 : 1;
+  const size_t total_size = length + buffers[1].len;
+
+  size_t synchronously_written = 0;
+  const bool try_write = HasDoTryWrite();
+  if (try_write) {
+    const int err = DoTryWrite(&bufs, &count);
+    size_t remaining = 0;
+    for (size_t i = 0; i < count; i++) remaining += bufs[i].len;
+    synchronously_written = total_size - remaining;
+    bytes_written_ += synchronously_written;
 
+    if (err != 0 || count == 0) {
+      SetWriteResult(StreamWriteResult{false, err, nullptr, total_size, {}});
+      return err;
+    }
+  }
+
+  // Whatever is left of the header block has to outlive this call. The body
+  // is kept alive through the request object.
+  std::unique_ptr<BackingStore> bs;
+  if (bufs == buffers) {
+    bs = ArrayBuffer::NewBackingStore(
+        isolate, bufs[0].len, BackingStoreInitializationMode::kUninitialized);
+    memcpy(bs->Data(), bufs[0].base, bufs[0].len);
+    bufs[0].base = static_cast<char*>(bs->Data());
+  }
+  if (has_body &&
+      req_wrap_obj->Set(context, env->buffer_string(), body).IsNothing()) {
+    return -1;
+  }
+
+  StreamWriteResult res = Write(bufs, count, nullptr, req_wrap_obj, try_write);
+  res.bytes += synchronously_written;
+  SetWriteResult(res);
+  if (res.wrap != nullptr && bs) res.wrap->SetBackingStore(std::move(bs));
+  return res.err;
+}
+
+namespace {
+
+// Writes the contents of a DataQueue to a stream from C++, pulling the next
+// chunk once the previous one has been written. Chunks are written straight
+// from the buffers of the queue's reader, so that e.g. a file that is
+// compressed on its way to a socket never passes through JS. While it runs,
+// the writer is the stream's listener, to learn when its own writes finish;
+// reads and all other writes are passed on to the previous listener.
+// Completes req_wrap, the request that JS passed to writeBlob(), once the
+// whole queue has been written or either side failed.
+class DataQueueWriter final
+    : public StreamListener,
+      public std::enable_shared_from_this<DataQueueWriter> {
+ public:
+  static void Start(StreamBase* stream,
+                    std::shared_ptr<DataQueue::Reader> reader,
+                    WriteWrap* req_wrap) {
+    auto writer = std::shared_ptr<DataQueueWriter>(
+        new DataQueueWriter(std::move(reader), req_wrap));
+    // Owns itself until it finishes, pending pulls hold on to it as well.
+    writer->self_ = writer;
+    stream->PushStreamListener(writer.get());
+    writer->starting_ = true;
+    writer->Pull();
+    writer->starting_ = false;
+  }
+
+  uv_buf_t OnStreamAlloc(size_t suggested_size) override {
+    return previous_listener_->OnStreamAlloc(suggested_size);
+  }
+
+  void OnStreamRead(ssize_t nread, const uv_buf_t& buf) override {
+    previous_listener_->OnStreamRead(nread, buf);
+  }
+
+  void OnStreamAfterWrite(WriteWrap* w, int status) override {
+    if (w != pending_write_)
+      return StreamListener::OnStreamAfterWrite(w, status);
+    pending_write_ = nullptr;
+    if (pending_done_) std::move(pending_done_)(0);
+    if (status < 0 || ended_) return Finish(status);
+    Pull();
+  }
+
+  void OnStreamDestroy() override {
+    // Nothing can complete the request any more. Pending pulls may keep
+    // this alive for a while, without a stream.
+    finished_ = true;
+    if (pending_done_) std::move(pending_done_)(0);
+    stream_->RemoveStreamListener(this);
+    req_wrap_->Dispose();
+    self_.reset();
+  }
+
+ private:
+  DataQueueWriter(std::shared_ptr<DataQueue::Reader> reader,
+                  WriteWrap* req_wrap)
+      : reader_(std::move(reader)), req_wrap_(req_wrap) {}
+
+  void Pull() {
+    // Data that is in memory is delivered and written synchronously, in
+    // which case the next chunk is pulled by this loop, not recursively.
+    if (pulling_) {
+      pull_again_ = true;
+      return;
+    }
+    std::shared_ptr<DataQueueWriter> self = shared_from_this();
+    pulling_ = true;
+    do {
+      pull_again_ = false;
+      reader_->Pull(
+          [self](int status,
+                 const DataQueue::Vec* vecs,
+                 size_t count,
+                 bob::Done done) {
+            self->OnData(status, vecs, count, std::move(done));
+          },
+          bob::OPTIONS_NONE,
+          nullptr,
+          0,
+          bob::kMaxCountHint);
+    } while (pull_again_ && !finished_);
+    pulling_ = false;
+  }
+
+  void OnData(int status,
+              const DataQueue::Vec* vecs,
+              size_t count,
+              bob::Done done) {
+    if (finished_) {
+      if (done) std::move(done)(0);
+      return;
+    }
+    if (status < 0) return Finish(status);
+    if (count == 0) {
+      switch (status) {
+        case bob::STATUS_EOS:
+          return Finish(0);
+        case bob::STATUS_CONTINUE:
+          return Pull();
+        case bob::STATUS_BLOCK:
+          // The queue is not capped and is empty for now, look again later.
+          stream_env()->SetImmediate(
+              [self = shared_from_this()](Environment*) {
+                if (!self->finished_) self->Pull();
+              });
+          return;
+        default:
+          // STATUS_WAIT, the reader calls back once there is data.
+          return;
+      }
+    }
+
+    // uv_buf_t lengths may be as small as 32 bits.
+    size_t nbufs = 0;
+    for (size_t n = 0; n < count; n++)
+      nbufs += std::max<size_t>(1, (vecs[n].len + INT_MAX - 1) / INT_MAX);
+    MaybeStackBuffer<uv_buf_t, bob::kMaxCountHint> bufs(nbufs);
+    size_t i = 0;
+    for (size_t n = 0; n < count; n++) {
+      uint64_t offset = 0;
+      do {
+        size_t len = std::min<uint64_t>(vecs[n].len - offset, INT_MAX);
+        bufs[i++] = uv_buf_init(
+            reinterpret_cast<char*>(vecs[n].base + offset), len);
+        offset += len;
+      } while (offset < vecs[n].len);
+    }
+    CHECK_EQ(i, nbufs);
+
+    Environment* env = stream_env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    ended_ = status == bob::STATUS_EOS;
+    StreamWriteResult res = static_cast<StreamBase*>(stream_)->Write(
+        bufs.out(), nbufs, nullptr, Local<Object>());
+    if (res.async) {
+      // The buffers stay with us until the write has finished.
+      pending_write_ = res.wrap;
+      pending_done_ = std::move(done);
+      return;
+    }
+    if (done) std::move(done)(0);
+    if (res.err != 0 || ended_) return Finish(res.err);
+    Pull();
+  }
+
+  void Finish(int status) {
+    if (finished_) return;
+    finished_ = true;
+    std::shared_ptr<DataQueueWriter> self = std::move(self_);
+    StreamBase* stream = static_cast<StreamBase*>(stream_);
+    stream->RemoveStreamListener(this);
+    if (!starting_) return req_wrap_->Done(status);
+    // Like any other asynchronous write, complete the request only after
+    // writeBlob() has returned to JS.
+    stream->stream_env()->SetImmediate(
+        [req_wrap = req_wrap_,
+         strong_ref = BaseObjectPtr<AsyncWrap>(stream->GetAsyncWrap()),
+         status](Environment*) { req_wrap->Done(status); });
+  }
+
+  Environment* stream_env() const {
+    return static_cast<StreamBase*>(stream_)->stream_env();
+  }
+
+  std::shared_ptr<DataQueue::Reader> reader_;
+  WriteWrap* const req_wrap_;
+  std::shared_ptr<DataQueueWriter> self_;
+  WriteWrap* pending_write_ = nullptr;
+  bob::Done pending_done_;
+  // Set while Start() runs.
+  bool starting_ = false;
+  bool pulling_ = false;
+  bool pull_again_ = false;
+  bool ended_ = false;
+  bool finished_ = false;
+};
+
+}  // namespace
+
+int StreamBase::WriteBlob(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsObject());
+  CHECK(Blob::HasInstance(env, args[1]));
+  Local<Object> req_wrap_obj = args[0].As<Object>();
+  Blob* blob;
+  ASSIGN_OR_RETURN_UNWRAP(&blob, args[1], 0);
+
+  std::shared_ptr<DataQueue::Reader> reader = blob->getDataQueue().get_reader();
+  if (!reader) {
+    SetWriteResult(StreamWriteResult{false, UV_EINVAL, nullptr, 0, {}});
+    return UV_EINVAL;
+  }
+
+  AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(GetAsyncWrap());
+  WriteWrap* req_wrap = CreateWriteWrap(req_wrap_obj);
+  // Always asynchronous, even if the data is written synchronously: the
+  // request completes from DataQueueWriter.
+  SetWriteResult(StreamWriteResult{true, 0, req_wrap, 0, {}});
+  DataQueueWriter::Start(this, std::move(reader), req_wrap);
+  return 0;
+}
+
+int StreamBase::WriteBuffer(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
   if (!args[1]->IsUint8Array()) {
@@ -304,7 +687,7 @@ int StreamBase::WriteBuffer(const FunctionCallbackInfo<Value>& args) {
     return 0;
   }
 
-  Local<Object> req_wrap_obj = args[0].As<Object>();
+  Local<Object> req_wrap_obj = WriteWrapObjectArg(args[0]);
   uv_buf_t buf;
   buf.base = Buffer::Data(args[1]);
   buf.len = Buffer::Length(args[1]);
@@ -319,7 +702,9 @@ int StreamBase::WriteBuffer(const FunctionCallbackInfo<Value>& args) {
     send_handle = reinterpret_cast<uv_stream_t*>(wrap->GetHandle());
     // Reference LibuvStreamWrap instance to prevent it from being garbage
     // collected before `AfterWrite` is called.
-    if (req_wrap_obj->Set(env->context(),
+    if ((req_wrap_obj.IsEmpty() &&
+         !NewWriteWrapObject(env).ToLocal(&req_wrap_obj)) ||
+        req_wrap_obj->Set(env->context(),
                           env->handle_string(),
                           send_handle_obj).IsNothing()) {
       return -1;
@@ -328,6 +713,7 @@ int StreamBase::WriteBuffer(const FunctionCallbackInfo<Value>& args) {
 
   StreamWriteResult res = Write(&buf, 1, send_handle, req_wrap_obj);
   SetWriteResult(res);
+  SetCreatedWriteWrapObject(args, res);
 
   return res.err;
 }
@@ -337,10 +723,9 @@ template <enum encoding enc>
 int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   Isolate* isolate = env->isolate();
-  CHECK(args[0]->IsObject());
   CHECK(args[1]->IsString());
 
-  Local<Object> req_wrap_obj = args[0].As<Object>();
+  Local<Object> req_wrap_obj = WriteWrapObjectArg(args[0]);
   Local<String> string = args[1].As<String>();
   Local<Object> send_handle_obj;
   if (args[2]->IsObject())
@@ -426,7 +811,9 @@ int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
     send_handle = reinterpret_cast<uv_stream_t*>(wrap->GetHandle());
     // Reference LibuvStreamWrap instance to prevent it from being garbage
     // collected before `AfterWrite` is called.
-    if (req_wrap_obj->Set(env->context(),
+    if ((req_wrap_obj.IsEmpty() &&
+         !NewWriteWrapObject(env).ToLocal(&req_wrap_obj)) ||
+        req_wrap_obj->Set(env->context(),
                           env->handle_string(),
                           send_handle_obj).IsNothing()) {
       return -1;
@@ -437,6 +824,7 @@ int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
   res.bytes += synchronously_written;
 
   SetWriteResult(res);
+  SetCreatedWriteWrapObject(args, res);
   if (res.wrap != nullptr)
     res.wrap->SetBackingStore(std::move(bs));
 
@@ -571,6 +959,11 @@ void StreamBase::AddMethods(IsolateData* isolate_data,
       isolate, t, "useUserBuffer", JSMethod<&StreamBase::UseUserBuffer>);
   SetProtoMethod(isolate, t, "writev", JSMethod<&StreamBase::Writev>);
   SetProtoMethod(isolate, t, "writeBuffer", JSMethod<&StreamBase::WriteBuffer>);
+  SetProtoMethod(isolate,
+                 t,
+                 "writeHttpResponse",
+                 JSMethod<&StreamBase::WriteHttpResponse>);
+  SetProtoMethod(isolate, t, "writeBlob", JSMethod<&StreamBase::WriteBlob>);
   SetProtoMethod(isolate,
                  t,
                  "writeAsciiString",
@@ -611,6 +1004,8 @@ void StreamBase::RegisterExternalReferences(
   registry->Register(JSMethod<&StreamBase::UseUserBuffer>);
   registry->Register(JSMethod<&StreamBase::Writev>);
   registry->Register(JSMethod<&StreamBase::WriteBuffer>);
+  registry->Register(JSMethod<&StreamBase::WriteHttpResponse>);
+  registry->Register(JSMethod<&StreamBase::WriteBlob>);
   registry->Register(JSMethod<&StreamBase::WriteString<ASCII>>);
   registry->Register(JSMethod<&StreamBase::WriteString<UTF8>>);
   registry->Register(JSMethod<&StreamBase::WriteString<UCS2>>);
@@ -665,7 +1060,11 @@ void StreamBase::JSMethod(const FunctionCallbackInfo<Value>& args) {
   if (!wrap->IsAlive()) return args.GetReturnValue().Set(UV_EINVAL);
 
   AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(wrap->GetAsyncWrap());
-  args.GetReturnValue().Set((wrap->*Method)(args));
+  const int ret = (wrap->*Method)(args);
+  // Writes return the request object they created instead, if any.
+  if (args.GetReturnValue().Get()->IsUndefined()) {
+    args.GetReturnValue().Set(ret);
+  }
 }
 
 int StreamResource::DoTryWrite(uv_buf_t** bufs, size_t* count) {
@@ -708,8 +1107,12 @@ void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
   CHECK_LE(static_cast<size_t>(nread), bs->ByteLength());
   if (static_cast<size_t>(nread) != bs->ByteLength()) {
     std::unique_ptr<BackingStore> old_bs = std::move(bs);
-    bs = ArrayBuffer::NewBackingStore(
-        isolate, nread, BackingStoreInitializationMode::kUninitialized);
+    if (ReadBufferPool* pool = env->read_buffer_pool()) {
+      bs = pool->NewBackingStore(isolate, nread);
+    } else {
+      bs = ArrayBuffer::NewBackingStore(
+          isolate, nread, BackingStoreInitializationMode::kUninitialized);
+    }
     memcpy(bs->Data(), old_bs->Data(), nread);
   }
 
@@ -380,11 +380,20 @@ class StreamBase : public StreamResource {
   inline explicit StreamBase(Environment* env);
 
   // JS Methods
+  // writev(), writeBuffer() and the write*String() methods take undefined
+  // instead of a request object for writes that are likely to complete
+  // synchronously. Only if one does not is a request object created for it,
+  // which they return instead of the error code, so that JavaScript can set
+  // its oncomplete callback.
   int ReadStartJS(const v8::FunctionCallbackInfo<v8::Value>& args);
   int ReadStopJS(const v8::FunctionCallbackInfo<v8::Value>& args);
   int Shutdown(const v8::FunctionCallbackInfo<v8::Value>& args);
   int Writev(const v8::FunctionCallbackInfo<v8::Value>& args);
   int WriteBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int WriteHttpResponse(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // writeBlob(req, blob) writes the contents of a Blob from C++ and completes
+  // req once all of it has been written.
+  int WriteBlob(const v8::FunctionCallbackInfo<v8::Value>& args);
   template <enum encoding enc>
   int WriteString(const v8::FunctionCallbackInfo<v8::Value>& args);
   int UseUserBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -448,6 +457,7 @@ class SimpleShutdownWrap : public ShutdownWrap, public OtherBase {
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(SimpleShutdownWrap)
   SET_SELF_SIZE(SimpleShutdownWrap)
+  NODE_POOLED_ALLOCATION(SimpleShutdownWrap)
 
   bool IsNotIndicativeOfMemoryLeakAtExit() const override {
     return OtherBase::IsNotIndicativeOfMemoryLeakAtExit();
@@ -465,6 +475,7 @@ class SimpleWriteWrap : public WriteWrap, public OtherBase {
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(SimpleWriteWrap)
   SET_SELF_SIZE(SimpleWriteWrap)
+  NODE_POOLED_ALLOCATION(SimpleWriteWrap)
 
   bool IsNotIndicativeOfMemoryLeakAtExit() const override {
     return OtherBase::IsNotIndicativeOfMemoryLeakAtExit();
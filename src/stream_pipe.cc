@@ -1,6 +1,7 @@
 #include "stream_pipe.h"
 #include "stream_base-inl.h"
 #include "node_buffer.h"
+#include "node_file.h"
 #include "util-inl.h"
 
 namespace node {
@@ -32,6 +33,17 @@ StreamPipe::StreamPipe(StreamBase* source,
   sink->PushStreamListener(&writable_listener_);
 
   uses_wants_write_ = sink->HasWantsWrite();
+
+#ifndef _WIN32
+  // Files can go to plain TCP and pipe handles without passing through
+  // memory. A TLS socket, or anything else that transforms the data, is a
+  // different kind of sink and keeps the copying path.
+  const AsyncWrap::ProviderType sink_type =
+      sink->GetAsyncWrap()->provider_type();
+  uses_sendfile_ =
+      source->GetAsyncWrap()->provider_type() == PROVIDER_FILEHANDLE &&
+      (sink_type == PROVIDER_TCPWRAP || sink_type == PROVIDER_PIPEWRAP);
+#endif
 }
 
 StreamPipe::~StreamPipe() {
@@ -58,6 +70,7 @@ void StreamPipe::Unpipe(bool is_in_deletion) {
 
   is_closed_ = true;
   is_reading_ = false;
+  if (!source_destroyed_) UpdateSendfileTarget();
   source()->RemoveStreamListener(&readable_listener_);
   if (pending_writes_ == 0)
     sink()->RemoveStreamListener(&writable_listener_);
@@ -135,9 +148,27 @@ void StreamPipe::ReadableListener::OnStreamRead(ssize_t nread,
     return;
   }
 
+  if (buf_.base == nullptr) {
+    // The FileHandle has sent these bytes to the sink already.
+    CHECK(pipe->uses_sendfile_);
+    pipe->UpdateSendfileTarget();
+    return;
+  }
+
   pipe->ProcessData(nread, std::move(bs));
 }
 
+void StreamPipe::UpdateSendfileTarget() {
+  if (!uses_sendfile_) return;
+  StreamBase* sink = this->sink();
+  // uv_try_write() support doubles as the check that the sink writes to
+  // its fd directly; it is off while write coalescing holds data back.
+  const bool writable = !is_closed_ && !sink_destroyed_ && sink->IsAlive() &&
+                        !sink->IsClosing() && sink->HasDoTryWrite();
+  static_cast<fs::FileHandle*>(source())->SetSendfileTarget(
+      writable ? sink->GetFD() : -1);
+}
+
 void StreamPipe::ProcessData(size_t nread,
                              std::unique_ptr<BackingStore> bs) {
   CHECK(uses_wants_write_ || pending_writes_ == 0);
@@ -226,6 +257,7 @@ void StreamPipe::WritableListener::OnStreamWantsWrite(size_t suggested_size) {
   InternalCallbackScope callback_scope(pipe,
       InternalCallbackScope::kSkipTaskQueues);
   pipe->is_reading_ = true;
+  pipe->UpdateSendfileTarget();
   pipe->source()->ReadStart();
 }
 
@@ -39,6 +39,8 @@ class StreamPipe : public AsyncWrap {
   bool sink_destroyed_ = false;
   bool source_destroyed_ = false;
   bool uses_wants_write_ = false;
+  // The source is a FileHandle that sends its data to the sink itself.
+  bool uses_sendfile_ = false;
 
   // Set a default value so that when we’re coming from Start(), we know
   // that we don’t want to read just yet.
@@ -47,6 +49,9 @@ class StreamPipe : public AsyncWrap {
   size_t wanted_data_ = 0;
 
   void ProcessData(size_t nread, std::unique_ptr<v8::BackingStore> bs);
+  // Points the FileHandle source at the sink's fd while the sink can still
+  // take data written past it, and clears it otherwise.
+  void UpdateSendfileTarget();
 
   class ReadableListener : public StreamListener {
    public:
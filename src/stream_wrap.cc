@@ -56,6 +56,7 @@ using v8::Object;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::Signature;
+using v8::Uint32;
 using v8::Value;
 
 void IsConstructCallCallback(const FunctionCallbackInfo<Value>& args) {
@@ -115,6 +116,7 @@ void LibuvStreamWrap::RegisterExternalReferences(
   registry->Register(IsConstructCallCallback);
   registry->Register(GetWriteQueueSize);
   registry->Register(SetBlocking);
+  registry->Register(SetWriteCoalescing);
   StreamBase::RegisterExternalReferences(registry);
 }
 
@@ -153,6 +155,7 @@ Local<FunctionTemplate> LibuvStreamWrap::GetConstructorTemplate(
         Local<FunctionTemplate>(),
         static_cast<PropertyAttribute>(ReadOnly | DontDelete));
     SetProtoMethod(isolate, tmpl, "setBlocking", SetBlocking);
+    SetProtoMethod(isolate, tmpl, "setWriteCoalescing", SetWriteCoalescing);
     StreamBase::AddMethods(env, tmpl);
     env->set_libuv_stream_wrap_ctor_template(tmpl);
   }
@@ -303,7 +306,8 @@ void LibuvStreamWrap::GetWriteQueueSize(
     return;
   }
 
-  uint32_t write_queue_size = wrap->stream()->write_queue_size;
+  uint32_t write_queue_size =
+      wrap->stream()->write_queue_size + wrap->coalesced_bytes_;
   info.GetReturnValue().Set(write_queue_size);
 }
 
@@ -320,6 +324,59 @@ void LibuvStreamWrap::SetBlocking(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(uv_stream_set_blocking(wrap->stream(), enable));
 }
 
+// wrap.setWriteCoalescing(enable[, maxBytes[, maxDelayMs]])
+void LibuvStreamWrap::SetWriteCoalescing(
+    const FunctionCallbackInfo<Value>& args) {
+  LibuvStreamWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.This());
+
+  CHECK_GT(args.Length(), 0);
+  if (!wrap->IsAlive())
+    return args.GetReturnValue().Set(UV_EINVAL);
+
+  // Keep the writes queued so far ahead of anything written from now on,
+  // and out of reach of the new limits.
+  wrap->FlushCoalescedWrites();
+  wrap->coalesce_writes_ = args[0]->IsTrue();
+  wrap->coalesce_max_bytes_ =
+      args[1]->IsUint32() ? args[1].As<Uint32>()->Value() : 0;
+  wrap->coalesce_max_delay_ms_ =
+      args[2]->IsUint32() ? args[2].As<Uint32>()->Value() : 0;
+  args.GetReturnValue().Set(0);
+}
+
+void LibuvStreamWrap::Close(Local<Value> close_callback) {
+  // Hand queued writes to libuv, which fails them with UV_ECANCELED if the
+  // handle closes before they are written.
+  FlushCoalescedWrites();
+  if (coalesce_timer_ != nullptr) {
+    env()->CloseHandle(coalesce_timer_, [](uv_timer_t* timer) {
+      delete timer;
+    });
+    coalesce_timer_ = nullptr;
+  }
+  HandleWrap::Close(close_callback);
+}
+
+void LibuvStreamWrap::FlushAllCoalescedWrites(Environment* env) {
+  // Failed flushes complete their writes, which can close other handles.
+  std::vector<BaseObjectPtr<LibuvStreamWrap>> wraps;
+  for (HandleWrap* handle : *env->handle_wrap_queue()) {
+    switch (handle->provider_type()) {
+      case PROVIDER_PIPEWRAP:
+      case PROVIDER_TCPWRAP:
+      case PROVIDER_TTYWRAP: {
+        LibuvStreamWrap* wrap = static_cast<LibuvStreamWrap*>(handle);
+        if (!wrap->coalesced_writes_.empty()) wraps.emplace_back(wrap);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  for (const auto& wrap : wraps) wrap->FlushCoalescedWrites();
+}
+
 typedef SimpleShutdownWrap<ReqWrap<uv_shutdown_t>> LibuvShutdownWrap;
 typedef SimpleWriteWrap<ReqWrap<uv_write_t>> LibuvWriteWrap;
 
@@ -334,6 +391,7 @@ WriteWrap* LibuvStreamWrap::CreateWriteWrap(Local<Object> object) {
 
 int LibuvStreamWrap::DoShutdown(ShutdownWrap* req_wrap_) {
   LibuvShutdownWrap* req_wrap = static_cast<LibuvShutdownWrap*>(req_wrap_);
+  FlushCoalescedWrites();
   return req_wrap->Dispatch(uv_shutdown, stream(), AfterUvShutdown);
 }
 
@@ -392,6 +450,23 @@ int LibuvStreamWrap::DoWrite(WriteWrap* req_wrap,
                              uv_buf_t* bufs,
                              size_t count,
                              uv_stream_t* send_handle) {
+  size_t bytes = 0;
+  for (size_t i = 0; i < count; i++) bytes += bufs[i].len;
+  // A write that would fill the queue up goes out with it, directly, so its
+  // errors are still reported from here.
+  if (coalesce_writes_ && send_handle == nullptr && IsAlive() &&
+      !IsClosing() &&
+      (coalesce_max_bytes_ == 0 ||
+       coalesced_bytes_ + bytes < coalesce_max_bytes_)) {
+    if (coalesced_writes_.empty()) ScheduleCoalescedFlush();
+    coalesced_writes_.push_back(
+        {req_wrap, BaseObjectPtr<AsyncWrap>(req_wrap->GetAsyncWrap())});
+    coalesced_bufs_.insert(coalesced_bufs_.end(), bufs, bufs + count);
+    coalesced_bytes_ += bytes;
+    return 0;
+  }
+
+  FlushCoalescedWrites();
   LibuvWriteWrap* w = static_cast<LibuvWriteWrap*>(req_wrap);
   return w->Dispatch(uv_write2,
                      stream(),
@@ -403,13 +478,80 @@ int LibuvStreamWrap::DoWrite(WriteWrap* req_wrap,
 
 
 
+void LibuvStreamWrap::ScheduleCoalescedFlush() {
+  if (coalesce_max_delay_ms_ == 0) {
+    env()->SetImmediate(
+        [wrap = BaseObjectPtr<LibuvStreamWrap>(this)](Environment* env) {
+          wrap->FlushCoalescedWrites();
+        });
+    return;
+  }
+  if (coalesce_timer_ == nullptr) {
+    coalesce_timer_ = new uv_timer_t();
+    CHECK_EQ(uv_timer_init(env()->event_loop(), coalesce_timer_), 0);
+    coalesce_timer_->data = this;
+  }
+  // Close() closes the timer, so it never outlives the wrap.
+  CHECK_EQ(uv_timer_start(
+               coalesce_timer_,
+               [](uv_timer_t* timer) {
+                 static_cast<LibuvStreamWrap*>(timer->data)
+                     ->FlushCoalescedWrites();
+               },
+               coalesce_max_delay_ms_,
+               0),
+           0);
+}
+
+void LibuvStreamWrap::FlushCoalescedWrites() {
+  if (coalesce_timer_ != nullptr) uv_timer_stop(coalesce_timer_);
+  if (coalesced_writes_.empty()) return;
+
+  std::vector<CoalescedWrite> writes = std::move(coalesced_writes_);
+  std::vector<uv_buf_t> bufs = std::move(coalesced_bufs_);
+  coalesced_writes_.clear();
+  coalesced_bufs_.clear();
+  coalesced_bytes_ = 0;
+
+  HandleScope scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+
+  LibuvWriteWrap* leader = static_cast<LibuvWriteWrap*>(writes[0].req_wrap);
+  int err = leader->Dispatch(uv_write2,
+                             stream(),
+                             bufs.data(),
+                             bufs.size(),
+                             nullptr,
+                             AfterUvWrite);
+  if (err == 0) {
+    // The leader stays referenced by its dispatched request.
+    writes.erase(writes.begin());
+    if (!writes.empty()) coalesced_batches_.emplace(leader, std::move(writes));
+    return;
+  }
+
+  // The writes were already reported as started, so fail them the way
+  // libuv would have.
+  for (CoalescedWrite& write : writes) write.req_wrap->Done(err);
+}
+
 void LibuvStreamWrap::AfterUvWrite(uv_write_t* req, int status) {
   LibuvWriteWrap* req_wrap = static_cast<LibuvWriteWrap*>(
       LibuvWriteWrap::from_req(req));
   CHECK_NOT_NULL(req_wrap);
   HandleScope scope(req_wrap->env()->isolate());
   Context::Scope context_scope(req_wrap->env()->context());
+
+  LibuvStreamWrap* wrap = static_cast<LibuvStreamWrap*>(req_wrap->stream());
+  std::vector<CoalescedWrite> followers;
+  auto it = wrap->coalesced_batches_.find(req_wrap);
+  if (it != wrap->coalesced_batches_.end()) {
+    followers = std::move(it->second);
+    wrap->coalesced_batches_.erase(it);
+  }
+
   req_wrap->Done(status);
+  for (CoalescedWrite& write : followers) write.req_wrap->Done(status);
 }
 
 }  // namespace node
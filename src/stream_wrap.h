@@ -28,6 +28,9 @@
 #include "handle_wrap.h"
 #include "v8.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace node {
 
 class Environment;
@@ -52,7 +55,8 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
   // Resource implementation
   int DoShutdown(ShutdownWrap* req_wrap) override;
   int DoTryWrite(uv_buf_t** bufs, size_t* count) override;
-  inline bool HasDoTryWrite() const override { return true; }
+  // uv_try_write() would defeat holding writes back while coalescing.
+  inline bool HasDoTryWrite() const override { return !coalesce_writes_; }
   int DoWrite(WriteWrap* w,
               uv_buf_t* bufs,
               size_t count,
@@ -80,6 +84,15 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
 
   static LibuvStreamWrap* From(Environment* env, v8::Local<v8::Object> object);
 
+  void Close(
+      v8::Local<v8::Value> close_callback = v8::Local<v8::Value>()) override;
+
+  // Hands the writes that the TCP, pipe and TTY handles of env are holding
+  // back to libuv, before the environment exits or the process aborts.
+  // stdout and stderr pipes and TTYs are blocking, so those writes are done
+  // when this returns.
+  static void FlushAllCoalescedWrites(Environment* env);
+
  protected:
   LibuvStreamWrap(Environment* env,
                   v8::Local<v8::Object> object,
@@ -103,6 +116,14 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
   static void GetWriteQueueSize(
       const v8::FunctionCallbackInfo<v8::Value>& info);
   static void SetBlocking(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetWriteCoalescing(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  // Flushes the queue from a SetImmediate() callback, or when the flush
+  // timer runs out if a maximum delay is set.
+  void ScheduleCoalescedFlush();
+  // Starts one uv_write() for all writes queued since the last flush.
+  void FlushCoalescedWrites();
 
   // Callbacks for libuv
   void OnUvAlloc(size_t suggested_size, uv_buf_t* buf);
@@ -113,6 +134,26 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
 
   uv_stream_t* const stream_;
 
+  // With write coalescing enabled, writes without a handle to send are
+  // queued instead of being started, and flushed as one vectored uv_write()
+  // from a SetImmediate() callback, i.e. before the event loop next polls.
+  // The request of the first write carries the batch; the others complete
+  // with it. Optionally, the queue is held for up to a number of milliseconds
+  // and flushed as soon as it would reach a number of bytes.
+  struct CoalescedWrite {
+    WriteWrap* req_wrap;
+    BaseObjectPtr<AsyncWrap> keep_alive;
+  };
+  bool coalesce_writes_ = false;
+  std::vector<CoalescedWrite> coalesced_writes_;
+  std::vector<uv_buf_t> coalesced_bufs_;
+  size_t coalesced_bytes_ = 0;
+  size_t coalesce_max_bytes_ = 0;
+  uint64_t coalesce_max_delay_ms_ = 0;
+  uv_timer_t* coalesce_timer_ = nullptr;
+  std::unordered_map<WriteWrap*, std::vector<CoalescedWrite>>
+      coalesced_batches_;
+
 #ifdef _WIN32
   // We don't always have an FD that we could look up on the stream_
   // object itself on Windows. However, for some cases, we open handles
@@ -33,6 +33,7 @@
 #include <cstring>  // memcpy
 
 #include <algorithm>
+#include <memory>
 
 // When creating strings >= this length v8's gc spins up and consumes
 // most of the execution time. For these cases it's more performant to
@@ -194,6 +195,28 @@ MaybeLocal<Value> ExternTwoByteString::NewSimpleFromCopy(Isolate* isolate,
   return str;
 }
 
+// Points into memory owned by an ArrayBuffer backing store instead of a
+// private copy. Holding a reference to the backing store keeps the bytes
+// alive for as long as the string is; V8 already accounts for them as part
+// of the ArrayBuffer, so no external memory is reported here.
+class SharedOneByteString : public String::ExternalOneByteStringResource {
+ public:
+  SharedOneByteString(std::shared_ptr<v8::BackingStore> backing_store,
+                      const char* data,
+                      size_t length)
+      : backing_store_(std::move(backing_store)),
+        data_(data),
+        length_(length) {}
+
+  const char* data() const override { return data_; }
+  size_t length() const override { return length_; }
+
+ private:
+  std::shared_ptr<v8::BackingStore> backing_store_;
+  const char* data_;
+  size_t length_;
+};
+
 }  // anonymous namespace
 
 static size_t keep_buflen_in_range(size_t len) {
@@ -277,7 +300,7 @@ size_t StringBytes::Write(Isolate* isolate,
       // the Buffer, so we need to reorder on BE platforms.  See
       // https://nodejs.org/api/buffer.html regarding Node's "ucs2"
       // encoding specification
-      if constexpr (IsBigEndian()) CHECK(nbytes::SwapBytes16(buf, nbytes));
+      if constexpr (IsBigEndian()) CHECK(SwapBytes16(buf, nbytes));
 
       break;
     }
@@ -584,7 +607,7 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
         isolate->ThrowException(node::ERR_MEMORY_ALLOCATION_FAILED(isolate));
         return MaybeLocal<Value>();
       }
-      size_t written = nbytes::HexEncode(buf, buflen, dst, dlen);
+      size_t written = HexEncode(buf, buflen, dst, dlen);
       CHECK_EQ(written, dlen);
 
       return ExternOneByteString::New(isolate, dst, dlen);
@@ -628,6 +651,34 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
   }
 }
 
+MaybeLocal<Value> StringBytes::EncodeExternal(
+    Isolate* isolate,
+    std::shared_ptr<v8::BackingStore> backing_store,
+    const char* buf,
+    size_t buflen,
+    enum encoding encoding) {
+  CHECK_BUFLEN_IN_RANGE(buflen);
+
+  // ASCII and UTF-8 decode to the bytes themselves only if every byte is
+  // ASCII, latin1 always does.
+  bool shareable =
+      buflen > 0 && buflen <= static_cast<size_t>(String::kMaxLength) &&
+      (encoding == LATIN1 ||
+       ((encoding == ASCII || encoding == UTF8) &&
+        simdutf::validate_ascii(buf, buflen)));
+  if (!shareable) return Encode(isolate, buf, buflen, encoding);
+
+  SharedOneByteString* resource =
+      new SharedOneByteString(std::move(backing_store), buf, buflen);
+  Local<String> str;
+  if (!String::NewExternalOneByte(isolate, resource).ToLocal(&str)) {
+    delete resource;
+    isolate->ThrowException(node::ERR_STRING_TOO_LONG(isolate));
+    return MaybeLocal<Value>();
+  }
+  return str;
+}
+
 MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
                                       const uint16_t* buf,
                                       size_t buflen) {
@@ -646,7 +697,7 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
     }
     size_t nbytes = buflen * sizeof(uint16_t);
     memcpy(dst, buf, nbytes);
-    CHECK(nbytes::SwapBytes16(reinterpret_cast<char*>(dst), nbytes));
+    CHECK(SwapBytes16(reinterpret_cast<char*>(dst), nbytes));
     return ExternTwoByteString::New(isolate, dst, buflen);
   } else {
     return ExternTwoByteString::NewFromCopy(isolate, buf, buflen);
@@ -29,6 +29,7 @@
 #include "v8.h"
 #include "env-inl.h"
 
+#include <memory>
 #include <string>
 
 namespace node {
@@ -83,6 +84,18 @@ class StringBytes {
                                           size_t buflen,
                                           enum encoding encoding);
 
+  // Like Encode(), but latin1 data, and ASCII or UTF-8 data that is pure
+  // ASCII, becomes an external string pointing straight into buf, which must
+  // lie inside backing_store. The string keeps backing_store alive; the
+  // caller must ensure the bytes are never modified for as long as the string
+  // may be reachable. Everything else is copied as Encode() does.
+  static v8::MaybeLocal<v8::Value> EncodeExternal(
+      v8::Isolate* isolate,
+      std::shared_ptr<v8::BackingStore> backing_store,
+      const char* buf,
+      size_t buflen,
+      enum encoding encoding);
+
   // Warning: This reverses endianness on BE platforms, even though the
   // signature using uint16_t implies that it should not.
   // However, the brokenness is already public API and can't therefore
@@ -5,6 +5,7 @@
 #include "node_buffer.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
+#include "simdutf.h"
 #include "string_bytes.h"
 #include "util.h"
 
@@ -32,8 +33,19 @@ MaybeLocal<String> MakeString(Isolate* isolate,
   if (encoding == UTF8) {
     MaybeLocal<String> utf8_string;
     if (length <= static_cast<size_t>(v8::String::kMaxLength)) {
-      utf8_string = String::NewFromUtf8(
-          isolate, data, v8::NewStringType::kNormal, length);
+      if (simdutf::validate_ascii(data, length)) {
+        // The bytes of an ASCII chunk are already its one-byte string.
+        utf8_string =
+            String::NewFromOneByte(isolate,
+                                   reinterpret_cast<const uint8_t*>(data),
+                                   v8::NewStringType::kNormal,
+                                   length);
+      } else {
+        // V8 picks the one-byte representation when every code point fits,
+        // e.g. for Latin-1 text, and replaces malformed sequences.
+        utf8_string = String::NewFromUtf8(
+            isolate, data, v8::NewStringType::kNormal, length);
+      }
     }
     if (utf8_string.IsEmpty()) {
       isolate->ThrowException(node::ERR_STRING_TOO_LONG(isolate));
@@ -34,10 +34,23 @@
 #include "util-inl.h"
 
 #include <cstdlib>
+#include <memory>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#include <sys/socket.h>
+#endif
 
 
 namespace node {
 
+using v8::Array;
 using v8::Boolean;
 using v8::Context;
 using v8::EscapableHandleScope;
@@ -45,9 +58,11 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::Int32;
+using v8::HandleScope;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
+using v8::LocalVector;
 using v8::MaybeLocal;
 using v8::Object;
 using v8::String;
@@ -96,6 +111,7 @@ void TCPWrap::Initialize(Local<Object> target,
   SetProtoMethod(isolate, t, "connect", Connect);
   SetProtoMethod(isolate, t, "bind6", Bind6);
   SetProtoMethod(isolate, t, "connect6", Connect6);
+  SetProtoMethod(isolate, t, "connectRace", ConnectRace);
   SetProtoMethod(isolate,
                  t,
                  "getsockname",
@@ -106,6 +122,7 @@ void TCPWrap::Initialize(Local<Object> target,
                  GetSockOrPeerName<TCPWrap, uv_tcp_getpeername>);
   SetProtoMethod(isolate, t, "setNoDelay", SetNoDelay);
   SetProtoMethod(isolate, t, "setKeepAlive", SetKeepAlive);
+  SetProtoMethod(isolate, t, "setReusePortSteering", SetReusePortSteering);
   SetProtoMethod(isolate, t, "reset", Reset);
 
 #ifdef _WIN32
@@ -140,11 +157,13 @@ void TCPWrap::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(Connect);
   registry->Register(Bind6);
   registry->Register(Connect6);
+  registry->Register(ConnectRace);
 
   registry->Register(GetSockOrPeerName<TCPWrap, uv_tcp_getsockname>);
   registry->Register(GetSockOrPeerName<TCPWrap, uv_tcp_getpeername>);
   registry->Register(SetNoDelay);
   registry->Register(SetKeepAlive);
+  registry->Register(SetReusePortSteering);
   registry->Register(Reset);
 #ifdef _WIN32
   registry->Register(SetSimultaneousAccepts);
@@ -196,6 +215,48 @@ void TCPWrap::SetNoDelay(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// setReusePortSteering(groupSize) is for servers sharded across threads,
+// each listening on its own UV_TCP_REUSEPORT socket bound to the same port.
+// By default the kernel hashes each new connection to one of the sockets;
+// this makes it pick socket number (cpu % groupSize), in bind order, where
+// cpu is the one that processed the SYN, so a connection is accepted by the
+// shard whose thread is likely to be running on that CPU. Connections the
+// program cannot place, e.g. while fewer than groupSize sockets are bound,
+// still fall back to the hash. Applies to the whole group and only needs to
+// be called on one of its sockets, after bind().
+void TCPWrap::SetReusePortSteering(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(
+      &wrap, args.This(), args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsUint32());
+  uint32_t group_size = args[0].As<Uint32>()->Value();
+  if (group_size == 0) return args.GetReturnValue().Set(UV_EINVAL);
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd);
+  if (err == 0) {
+    sock_filter code[] = {
+        {BPF_LD | BPF_W | BPF_ABS,
+         0,
+         0,
+         static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, group_size},
+        {BPF_RET | BPF_A, 0, 0, 0},
+    };
+    sock_fprog prog = {arraysize(code), code};
+    if (setsockopt(
+            fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) !=
+        0) {
+      err = uv_translate_sys_error(errno);
+    }
+  }
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
 void TCPWrap::SetKeepAlive(const FunctionCallbackInfo<Value>& args) {
   TCPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(
@@ -370,6 +431,243 @@ void TCPWrap::Connect(const FunctionCallbackInfo<Value>& args,
 
   args.GetReturnValue().Set(err);
 }
+// Races connections to a list of addresses, Happy Eyeballs style (RFC 8305):
+// the attempts start in list order, each one attempt_delay milliseconds
+// after the previous one or as soon as it fails, and the first to connect
+// wins. Attempts use sockets of their own, so the winner's socket is handed
+// to the TCPWrap, and the others are closed, before the request completes
+// with oncomplete(status, handle, req, readable, writable, winner, errors):
+// winner is the index of the address that connected, or -1, and errors has
+// the status of the attempt for each address, 0 for those not tried.
+class TCPConnectRace {
+ public:
+  TCPConnectRace(TCPWrap* wrap, ConnectWrap* req_wrap, uint64_t attempt_delay)
+      : wrap_(wrap), req_wrap_(req_wrap), attempt_delay_(attempt_delay) {
+    CHECK_EQ(uv_timer_init(wrap->env()->event_loop(), &timer_), 0);
+    timer_.data = this;
+    open_handles_ = 1;
+  }
+
+  void AddAddress(const sockaddr_storage& addr) {
+    attempts_.emplace_back(new Attempt());
+    attempts_.back()->race = this;
+    attempts_.back()->addr = addr;
+  }
+
+  void Start() {
+    wrap_->connect_race_ = this;
+    StartNext();
+  }
+
+  // Called when the TCPWrap closes. The request completes with
+  // UV_ECANCELED once the attempts are closed, as a plain connect would.
+  void Cancel() {
+    if (done_) return;
+    status_ = UV_ECANCELED;
+    Finish();
+  }
+
+ private:
+  struct Attempt {
+    TCPConnectRace* race;
+    sockaddr_storage addr;
+    uv_tcp_t handle;
+    uv_connect_t req;
+    int status = 0;
+    bool open = false;
+  };
+
+  void StartNext() {
+    while (next_ < attempts_.size()) {
+      Attempt* attempt = attempts_[next_++].get();
+      int err = uv_tcp_init(wrap_->env()->event_loop(), &attempt->handle);
+      if (err == 0) {
+        attempt->open = true;
+        open_handles_++;
+        err = uv_tcp_connect(&attempt->req,
+                             &attempt->handle,
+                             reinterpret_cast<const sockaddr*>(&attempt->addr),
+                             OnConnect);
+      }
+      if (err == 0) {
+        connecting_++;
+        if (next_ < attempts_.size()) {
+          uv_timer_start(&timer_, OnAttemptDelay, attempt_delay_, 0);
+        }
+        return;
+      }
+      attempt->status = status_ = err;
+      CloseAttempt(attempt);
+    }
+    if (connecting_ == 0) Finish();
+  }
+
+  static void OnAttemptDelay(uv_timer_t* timer) {
+    static_cast<TCPConnectRace*>(timer->data)->StartNext();
+  }
+
+  static void OnConnect(uv_connect_t* req, int status) {
+    Attempt* attempt = ContainerOf(&Attempt::req, req);
+    TCPConnectRace* race = attempt->race;
+    race->connecting_--;
+    if (race->done_) return;  // Closed by Finish().
+    if (status == 0) {
+      for (size_t i = 0; i < race->attempts_.size(); i++) {
+        if (race->attempts_[i].get() == attempt) {
+          race->winner_ = static_cast<int>(i);
+        }
+      }
+      race->status_ = race->Adopt(attempt);
+      race->Finish();
+      return;
+    }
+    attempt->status = race->status_ = status;
+    race->CloseAttempt(attempt);
+    uv_timer_stop(&race->timer_);
+    race->StartNext();
+  }
+
+  // Moves the connected socket of attempt into the TCPWrap.
+  int Adopt(Attempt* attempt) {
+    uv_os_fd_t fd;
+    int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&attempt->handle), &fd);
+    if (err != 0) return err;
+    const int dup_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (dup_fd == -1) return uv_translate_sys_error(errno);
+    err = uv_tcp_open(&wrap_->handle_, dup_fd);
+    if (err != 0) close(dup_fd);
+    return err;
+  }
+
+  void CloseAttempt(Attempt* attempt) {
+    if (!attempt->open) return;
+    attempt->open = false;
+    uv_close(reinterpret_cast<uv_handle_t*>(&attempt->handle), OnClose);
+  }
+
+  void Finish() {
+    done_ = true;
+    wrap_->connect_race_ = nullptr;
+    for (auto& attempt : attempts_) CloseAttempt(attempt.get());
+    uv_close(reinterpret_cast<uv_handle_t*>(&timer_), OnClose);
+  }
+
+  static void OnClose(uv_handle_t* handle) {
+    TCPConnectRace* race;
+    if (handle->type == UV_TIMER) {
+      race = static_cast<TCPConnectRace*>(handle->data);
+    } else {
+      Attempt* attempt =
+          ContainerOf(&Attempt::handle, reinterpret_cast<uv_tcp_t*>(handle));
+      race = attempt->race;
+    }
+    if (--race->open_handles_ == 0) {
+      race->Complete();
+      delete race;
+    }
+  }
+
+  void Complete() {
+    Environment* env = wrap_->env();
+    Isolate* isolate = env->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env->context());
+
+    const bool connected = winner_ != -1 && status_ == 0;
+    LocalVector<Value> errors(isolate);
+    for (const auto& attempt : attempts_) {
+      errors.push_back(Integer::New(isolate, attempt->status));
+    }
+    Local<Value> argv[] = {
+        Integer::New(isolate, connected ? 0 : status_),
+        wrap_->object(),
+        req_wrap_->object(),
+        Boolean::New(isolate, connected && uv_is_readable(wrap_->stream())),
+        Boolean::New(isolate, connected && uv_is_writable(wrap_->stream())),
+        Integer::New(isolate, connected ? winner_ : -1),
+        Array::New(isolate, errors.data(), errors.size()),
+    };
+    req_wrap_->MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
+  }
+
+  BaseObjectPtr<TCPWrap> wrap_;
+  BaseObjectPtr<ConnectWrap> req_wrap_;
+  const uint64_t attempt_delay_;
+  uv_timer_t timer_;
+  std::vector<std::unique_ptr<Attempt>> attempts_;
+  size_t next_ = 0;
+  size_t connecting_ = 0;
+  size_t open_handles_ = 0;
+  int winner_ = -1;
+  // The result of the winning attempt, or else of the last one to fail.
+  int status_ = UV_EINVAL;
+  bool done_ = false;
+};
+
+// handle.connectRace(req, addresses, port, attemptDelay)
+void TCPWrap::ConnectRace(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(
+      &wrap, args.This(), args.GetReturnValue().Set(UV_EBADF));
+
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsUint32());
+  CHECK(args[3]->IsUint32());
+
+#ifdef _WIN32
+  // Connected sockets cannot be handed from one handle to another.
+  return args.GetReturnValue().Set(UV_ENOTSUP);
+#else
+  Local<Array> addresses = args[1].As<Array>();
+  const int port = static_cast<int>(args[2].As<Uint32>()->Value());
+  const uint64_t attempt_delay = args[3].As<Uint32>()->Value();
+
+  // The socket of the winning attempt replaces the handle's, so there must be
+  // none yet, and nothing to race for a connect() that is in progress.
+  uv_os_fd_t fd;
+  if (wrap->connect_race_ != nullptr || addresses->Length() == 0 ||
+      uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd) !=
+          UV_EBADF) {
+    return args.GetReturnValue().Set(UV_EINVAL);
+  }
+
+  std::vector<sockaddr_storage> addrs(addresses->Length());
+  for (uint32_t i = 0; i < addresses->Length(); i++) {
+    Local<Value> address;
+    if (!addresses->Get(env->context(), i).ToLocal(&address)) return;
+    node::Utf8Value ip_address(env->isolate(), address);
+
+    ERR_ACCESS_DENIED_IF_INSUFFICIENT_PERMISSIONS(
+        env, permission::PermissionScope::kNet, ip_address.ToStringView(),
+        args);
+
+    sockaddr_storage* addr = &addrs[i];
+    if (uv_ip4_addr(*ip_address, port, reinterpret_cast<sockaddr_in*>(addr)) !=
+            0 &&
+        uv_ip6_addr(*ip_address, port, reinterpret_cast<sockaddr_in6*>(addr)) !=
+            0) {
+      return args.GetReturnValue().Set(UV_EINVAL);
+    }
+  }
+
+  AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(wrap);
+  ConnectWrap* req_wrap = new ConnectWrap(
+      env, args[0].As<Object>(), AsyncWrap::PROVIDER_TCPCONNECTWRAP);
+  TCPConnectRace* race = new TCPConnectRace(wrap, req_wrap, attempt_delay);
+  for (const sockaddr_storage& addr : addrs) race->AddAddress(addr);
+  race->Start();
+  args.GetReturnValue().Set(0);
+#endif  // _WIN32
+}
+
+void TCPWrap::Close(Local<Value> close_callback) {
+  if (connect_race_ != nullptr) connect_race_->Cancel();
+  ConnectionWrap::Close(close_callback);
+}
+
 void TCPWrap::Reset(const FunctionCallbackInfo<Value>& args) {
   TCPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(
@@ -382,6 +680,7 @@ void TCPWrap::Reset(const FunctionCallbackInfo<Value>& args) {
 
 int TCPWrap::Reset(Local<Value> close_callback) {
   if (state_ != kInitialized) return 0;
+  if (connect_race_ != nullptr) connect_race_->Cancel();
 
   int err = uv_tcp_close_reset(&handle_, OnClose);
   state_ = kClosing;
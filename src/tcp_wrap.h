@@ -31,6 +31,7 @@ namespace node {
 
 class ExternalReferenceRegistry;
 class Environment;
+class TCPConnectRace;
 
 class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
  public:
@@ -48,6 +49,9 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
                          void* priv);
   static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
 
+  void Close(
+      v8::Local<v8::Value> close_callback = v8::Local<v8::Value>()) override;
+
   SET_NO_MEMORY_INFO()
   SET_SELF_SIZE(TCPWrap)
   const char* MemoryInfoName() const override {
@@ -62,6 +66,7 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
   }
 
  private:
+  friend class TCPConnectRace;
   typedef uv_tcp_t HandleType;
 
   template <typename T,
@@ -74,11 +79,14 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetNoDelay(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetKeepAlive(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetReusePortSteering(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Bind(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Listen(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void ConnectRace(const v8::FunctionCallbackInfo<v8::Value>& args);
   template <typename T>
   static void Connect(const v8::FunctionCallbackInfo<v8::Value>& args,
       std::function<int(const char* ip_address, T* addr)> uv_ip_addr);
@@ -91,6 +99,9 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
   static void Reset(const v8::FunctionCallbackInfo<v8::Value>& args);
   int Reset(v8::Local<v8::Value> close_callback = v8::Local<v8::Value>());
 
+  // The connectRace() in progress, if any.
+  TCPConnectRace* connect_race_ = nullptr;
+
 #ifdef _WIN32
   static void SetSimultaneousAccepts(
       const v8::FunctionCallbackInfo<v8::Value>& args);
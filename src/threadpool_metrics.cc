@@ -0,0 +1,84 @@
+#include "threadpool_metrics.h"
+
+#include "histogram-inl.h"
+#include "util-inl.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace node {
+namespace threadpool_metrics {
+
+namespace detail {
+std::atomic<bool> enabled = false;
+}  // namespace detail
+
+namespace {
+
+constexpr size_t kCategoryCount = static_cast<size_t>(Category::kCount);
+constexpr size_t kPhaseCount = static_cast<size_t>(Phase::kCount);
+
+struct Histograms {
+  Histograms() {
+    for (auto& row : histograms) {
+      for (auto& histogram : row) {
+        histogram = std::make_shared<Histogram>(Histogram::Options{});
+      }
+    }
+  }
+
+  std::shared_ptr<Histogram> histograms[kCategoryCount][kPhaseCount];
+};
+
+Histograms& GetHistograms() {
+  static Histograms* histograms = new Histograms();
+  return *histograms;
+}
+
+void Record(Category category, Phase phase, uint64_t value) {
+  GetHistograms()
+      .histograms[static_cast<size_t>(category)][static_cast<size_t>(phase)]
+      ->Record(std::max<int64_t>(static_cast<int64_t>(value), 1));
+}
+
+Category CategoryFromType(const char* type) {
+  if (strcmp(type, "crypto") == 0) return Category::kCrypto;
+  if (strcmp(type, "zlib") == 0) return Category::kZlib;
+  if (strcmp(type, "node_api") == 0) return Category::kAddon;
+  if (strncmp(type, "fs", 2) == 0) return Category::kFs;
+  return Category::kOther;
+}
+
+}  // namespace
+
+void SetEnabled(bool enabled) {
+  // Create the histograms before anything may record into them.
+  GetHistograms();
+  detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::shared_ptr<Histogram> GetHistogram(Category category, Phase phase) {
+  CHECK_LT(static_cast<size_t>(category), kCategoryCount);
+  CHECK_LT(static_cast<size_t>(phase), kPhaseCount);
+  return GetHistograms().histograms[static_cast<size_t>(category)]
+                                   [static_cast<size_t>(phase)];
+}
+
+void RecordWork(const char* type,
+                uint64_t queued_at,
+                uint64_t started_at,
+                uint64_t finished_at) {
+  Category category = CategoryFromType(type);
+  Record(category, Phase::kWait, started_at - queued_at);
+  Record(category, Phase::kRun, finished_at - started_at);
+  Record(category, Phase::kTotal, finished_at - queued_at);
+}
+
+void RecordRequest(Category category,
+                   uint64_t dispatched_at,
+                   uint64_t finished_at) {
+  Record(category, Phase::kTotal, finished_at - dispatched_at);
+}
+
+}  // namespace threadpool_metrics
+}  // namespace node
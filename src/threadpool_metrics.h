@@ -0,0 +1,68 @@
+#ifndef SRC_THREADPOOL_METRICS_H_
+#define SRC_THREADPOOL_METRICS_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+
+namespace node {
+class Histogram;
+
+// Process-wide histograms of how long work waits in the libuv threadpool
+// and how long it then runs, exposed through the perf_hooks binding. They
+// are off by default; while off, instrumented code pays a single branch.
+namespace threadpool_metrics {
+
+#define THREADPOOL_METRICS_CATEGORIES(V)                                      \
+  V(kFs, "fs")                                                                \
+  V(kCrypto, "crypto")                                                        \
+  V(kZlib, "zlib")                                                            \
+  V(kDns, "dns")                                                              \
+  V(kAddon, "addon")                                                          \
+  V(kOther, "other")
+
+enum class Category {
+#define V(name, _) name,
+  THREADPOOL_METRICS_CATEGORIES(V)
+#undef V
+  kCount
+};
+
+// All durations are in nanoseconds. kWait is from queueing the work to a
+// thread picking it up, kRun from then until it is done, kTotal both. Only
+// kTotal is known for requests that libuv itself runs on the threadpool,
+// such as fs operations and getaddrinfo().
+enum class Phase { kWait, kRun, kTotal, kCount };
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}  // namespace detail
+
+inline bool IsEnabled() {
+  return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void SetEnabled(bool enabled);
+
+std::shared_ptr<Histogram> GetHistogram(Category category, Phase phase);
+
+// Records work queued through ThreadPoolWork, whose type string determines
+// the category.
+void RecordWork(const char* type,
+                uint64_t queued_at,
+                uint64_t started_at,
+                uint64_t finished_at);
+
+// Records a libuv request that was dispatched at dispatched_at.
+void RecordRequest(Category category,
+                   uint64_t dispatched_at,
+                   uint64_t finished_at);
+
+}  // namespace threadpool_metrics
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_THREADPOOL_METRICS_H_
@@ -25,6 +25,7 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include "node_internals.h"
+#include "threadpool_metrics.h"
 #include "tracing/trace_event.h"
 #include "util-inl.h"
 
@@ -34,14 +35,41 @@ void ThreadPoolWork::ScheduleWork() {
   env_->IncreaseWaitingRequestCounter();
   TRACE_EVENT_NESTABLE_ASYNC_BEGIN0(
       TRACING_CATEGORY_NODE2(threadpoolwork, async), type_, this);
+  queued_at_ = threadpool_metrics::IsEnabled() ? uv_hrtime() : 0;
+#ifdef UV_HAVE_QUEUE_WORK_EX
+  uv_work_kind kind = UV_WORK_CPU;
+  switch (lane_) {
+    case Lane::kCpu:
+      break;
+    case Lane::kIo:
+      kind = UV_WORK_FAST_IO;
+      break;
+    case Lane::kSlowIo:
+      kind = UV_WORK_SLOW_IO;
+      break;
+  }
+  int status = uv_queue_work_ex(
+      env_->event_loop(),
+      &work_req_,
+      kind,
+#else
+  // Linking against a libuv that has a single lane for everything.
   int status = uv_queue_work(
       env_->event_loop(),
       &work_req_,
+#endif
       [](uv_work_t* req) {
         ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
         TRACE_EVENT_BEGIN0(TRACING_CATEGORY_NODE2(threadpoolwork, sync),
                            self->type_);
-        self->DoThreadPoolWork();
+        if (self->queued_at_ != 0) [[unlikely]] {
+          uint64_t started_at = uv_hrtime();
+          self->DoThreadPoolWork();
+          threadpool_metrics::RecordWork(
+              self->type_, self->queued_at_, started_at, uv_hrtime());
+        } else {
+          self->DoThreadPoolWork();
+        }
         TRACE_EVENT_END0(TRACING_CATEGORY_NODE2(threadpoolwork, sync),
                          self->type_);
       },
@@ -0,0 +1,144 @@
+#include "timer_wheel.h"
+#include "util-inl.h"
+
+#include <algorithm>
+
+namespace node {
+namespace timers {
+
+TimerWheel::TimerWheel(uint64_t now_ms) : current_ms_(now_ms) {}
+
+TimerWheel::~TimerWheel() = default;
+
+void TimerWheel::Add(int64_t id, uint64_t expiry_ms) {
+  auto [it, inserted] = timers_.try_emplace(id);
+  Timer* timer = &it->second;
+  if (inserted) {
+    timer->id = id;
+  } else {
+    timer->slot_link.Remove();
+    counts_[timer->level]--;
+  }
+  timer->expiry_ms = expiry_ms;
+  timer->sequence = next_sequence_++;
+  Insert(timer);
+}
+
+bool TimerWheel::Cancel(int64_t id) {
+  auto it = timers_.find(id);
+  if (it == timers_.end()) return false;
+  counts_[it->second.level]--;
+  // The ListNode destructor unlinks the timer from its slot.
+  timers_.erase(it);
+  return true;
+}
+
+void TimerWheel::Insert(Timer* timer) {
+  // Timers that are already due go into the slot that is expired next.
+  uint64_t expiry_ms = std::max(timer->expiry_ms, current_ms_);
+  const uint64_t delta = expiry_ms - current_ms_;
+  if (delta < kLevel0Slots) {
+    timer->level = 0;
+    counts_[0]++;
+    level0_[expiry_ms & (kLevel0Slots - 1)].PushBack(timer);
+    return;
+  }
+  int level = 1;
+  while (level < kLevels - 1 && delta >= uint64_t{1} << Shift(level + 1)) {
+    level++;
+  }
+  // Timers beyond the last level are put back when they are cascaded.
+  const uint64_t max_delta = (uint64_t{1} << Shift(kLevels)) - 1;
+  if (delta > max_delta) expiry_ms = current_ms_ + max_delta;
+  timer->level = level;
+  counts_[level]++;
+  levels_[level - 1][(expiry_ms >> Shift(level)) & (kLevelSlots - 1)].PushBack(
+      timer);
+}
+
+void TimerWheel::Cascade(int level) {
+  Slot& slot =
+      levels_[level - 1][(current_ms_ >> Shift(level)) & (kLevelSlots - 1)];
+  // Timers that are put back into the last level can land in the same slot,
+  // so take them all out first.
+  Slot timers;
+  while (Timer* timer = slot.PopFront()) timers.PushBack(timer);
+  while (Timer* timer = timers.PopFront()) {
+    counts_[level]--;
+    Insert(timer);
+  }
+}
+
+void TimerWheel::Expire(uint64_t now_ms, std::vector<int64_t>* expired) {
+  std::vector<Timer*> due;
+  while (current_ms_ <= now_ms) {
+    // Entering a new span of a level moves that span's timers closer down,
+    // from the lowest level up, and stops at the first one that does not
+    // start a new span of the level above.
+    for (int level = 1; level < kLevels; level++) {
+      if ((current_ms_ & ((uint64_t{1} << Shift(level)) - 1)) != 0) break;
+      Cascade(level);
+    }
+
+    Slot& slot = level0_[current_ms_ & (kLevel0Slots - 1)];
+    while (Timer* timer = slot.PopFront()) {
+      counts_[0]--;
+      due.push_back(timer);
+    }
+
+    // Skip over the spans of empty levels, they have nothing to cascade.
+    int level = 0;
+    while (level < kLevels && counts_[level] == 0) level++;
+    if (level == kLevels) break;
+    if (level == 0) {
+      current_ms_++;
+    } else {
+      const uint64_t span = uint64_t{1} << Shift(level);
+      current_ms_ = std::min((current_ms_ | (span - 1)) + 1, now_ms + 1);
+    }
+  }
+  current_ms_ = std::max(current_ms_, now_ms + 1);
+
+  // Each slot only holds the timers of one millisecond, but timers that were
+  // cascaded or added in the past reach it in any order.
+  std::sort(due.begin(), due.end(), [](const Timer* a, const Timer* b) {
+    if (a->expiry_ms != b->expiry_ms) return a->expiry_ms < b->expiry_ms;
+    return a->sequence < b->sequence;
+  });
+  expired->reserve(expired->size() + due.size());
+  for (Timer* timer : due) {
+    const int64_t id = timer->id;
+    expired->push_back(id);
+    timers_.erase(id);
+  }
+}
+
+uint64_t TimerWheel::NextExpiry() const {
+  if (timers_.empty()) return kNoExpiry;
+  uint64_t next = kNoExpiry;
+  if (counts_[0] != 0) {
+    for (uint64_t ms = current_ms_; ms < current_ms_ + kLevel0Slots; ms++) {
+      if (!level0_[ms & (kLevel0Slots - 1)].IsEmpty()) {
+        next = ms;
+        break;
+      }
+    }
+  }
+  for (int level = 1; level < kLevels; level++) {
+    if (counts_[level] == 0) continue;
+    const int shift = Shift(level);
+    const uint64_t span = current_ms_ >> shift;
+    // The current span was cascaded already, unless it starts right now.
+    const bool aligned = (current_ms_ & ((uint64_t{1} << shift) - 1)) == 0;
+    for (uint64_t i = aligned ? 0 : 1; i <= kLevelSlots; i++) {
+      if (!levels_[level - 1][(span + i) & (kLevelSlots - 1)].IsEmpty()) {
+        next = std::min(next, std::max((span + i) << shift, current_ms_));
+        break;
+      }
+    }
+  }
+  return next;
+}
+
+}  // namespace timers
+}  // namespace node
@@ -0,0 +1,94 @@
+#ifndef SRC_TIMER_WHEEL_H_
+#define SRC_TIMER_WHEEL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "util.h"
+
+namespace node {
+namespace timers {
+
+// A hierarchical hashed timing wheel with millisecond resolution, for
+// timers that are identified by the integer ids JavaScript gives them. Adding,
+// moving and cancelling a timer take constant time whatever the number of
+// timers, and expiry costs time in the number of timers that expire plus the
+// ones that move one level closer to expiry.
+//
+// Level 0 has one slot for each of the next 256 milliseconds, and each
+// further level has 64 slots 64 times as wide as the previous one's, which
+// covers 2^32 milliseconds. Timers further away are kept in the last level
+// and put back when they come up early.
+class TimerWheel {
+ public:
+  static constexpr uint64_t kNoExpiry = UINT64_MAX;
+
+  // now_ms is the time from which timers may expire.
+  explicit TimerWheel(uint64_t now_ms = 0);
+  ~TimerWheel();
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Schedules the timer id to expire at expiry_ms, moving it if it is
+  // already scheduled. A time in the past expires on the next Expire().
+  void Add(int64_t id, uint64_t expiry_ms);
+  // Returns false if id is not scheduled.
+  bool Cancel(int64_t id);
+  bool Has(int64_t id) const { return timers_.count(id) != 0; }
+
+  // Removes the timers that expire at or before now_ms and appends their ids
+  // to expired, in order of expiry and, for equal expiry times, in the order
+  // in which they were added.
+  void Expire(uint64_t now_ms, std::vector<int64_t>* expired);
+
+  // Returns a time at or before the earliest expiry, at which Expire()
+  // should next be called, or kNoExpiry if there are no timers.
+  uint64_t NextExpiry() const;
+
+  size_t size() const { return timers_.size(); }
+
+ private:
+  static constexpr int kLevels = 5;
+  static constexpr int kLevel0Bits = 8;
+  static constexpr int kLevelBits = 6;
+  static constexpr size_t kLevel0Slots = size_t{1} << kLevel0Bits;
+  static constexpr size_t kLevelSlots = size_t{1} << kLevelBits;
+
+  struct Timer {
+    int64_t id;
+    uint64_t expiry_ms;
+    uint64_t sequence;
+    int level;
+    ListNode<Timer> slot_link;
+  };
+  using Slot = ListHead<Timer, &Timer::slot_link>;
+
+  static int Shift(int level) {
+    return level == 0 ? 0 : kLevel0Bits + (level - 1) * kLevelBits;
+  }
+  static size_t SlotCount(int level) {
+    return level == 0 ? kLevel0Slots : kLevelSlots;
+  }
+
+  void Insert(Timer* timer);
+  void Cascade(int level);
+
+  // All timers that expire before current_ms_ have been expired.
+  uint64_t current_ms_;
+  uint64_t next_sequence_ = 0;
+  Slot level0_[kLevel0Slots];
+  Slot levels_[kLevels - 1][kLevelSlots];
+  size_t counts_[kLevels] = {};
+  std::unordered_map<int64_t, Timer> timers_;
+};
+
+}  // namespace timers
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_TIMER_WHEEL_H_
@@ -6,12 +6,16 @@
 #include "util-inl.h"
 #include "v8.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 namespace node {
 namespace timers {
 
+using v8::ArrayBuffer;
 using v8::Context;
+using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::Isolate;
@@ -92,6 +96,71 @@ void BindingData::ToggleImmediateRefImpl(BindingData* data, bool ref) {
   data->env()->ToggleImmediateRef(ref);
 }
 
+void BindingData::SlowTimerWheelAdd(const FunctionCallbackInfo<Value>& args) {
+  Local<Context> context = args.GetIsolate()->GetCurrentContext();
+  int64_t id;
+  int64_t expiry;
+  if (args[0]->IntegerValue(context).To(&id) &&
+      args[1]->IntegerValue(context).To(&expiry)) {
+    TimerWheelAddImpl(Realm::GetBindingData<BindingData>(args), id, expiry);
+  }
+}
+
+void BindingData::FastTimerWheelAdd(Local<Object> receiver,
+                                    int64_t id,
+                                    int64_t expiry) {
+  TRACK_V8_FAST_API_CALL("timers.timerWheelAdd");
+  TimerWheelAddImpl(FromJSObject<BindingData>(receiver), id, expiry);
+}
+
+void BindingData::TimerWheelAddImpl(BindingData* data,
+                                    int64_t id,
+                                    int64_t expiry) {
+  data->wheel_.Add(id, static_cast<uint64_t>(std::max<int64_t>(expiry, 0)));
+}
+
+void BindingData::SlowTimerWheelCancel(
+    const FunctionCallbackInfo<Value>& args) {
+  int64_t id;
+  if (args[0]->IntegerValue(args.GetIsolate()->GetCurrentContext()).To(&id)) {
+    TimerWheelCancelImpl(Realm::GetBindingData<BindingData>(args), id);
+  }
+}
+
+void BindingData::FastTimerWheelCancel(Local<Object> receiver, int64_t id) {
+  TRACK_V8_FAST_API_CALL("timers.timerWheelCancel");
+  TimerWheelCancelImpl(FromJSObject<BindingData>(receiver), id);
+}
+
+void BindingData::TimerWheelCancelImpl(BindingData* data, int64_t id) {
+  data->wheel_.Cancel(id);
+}
+
+void BindingData::TimerWheelExpire(const FunctionCallbackInfo<Value>& args) {
+  Isolate* isolate = args.GetIsolate();
+  BindingData* data = Realm::GetBindingData<BindingData>(args);
+  int64_t now;
+  if (!args[0]->IntegerValue(isolate->GetCurrentContext()).To(&now)) return;
+
+  std::vector<int64_t> expired;
+  if (now >= 0) data->wheel_.Expire(static_cast<uint64_t>(now), &expired);
+  Local<ArrayBuffer> ab = ArrayBuffer::New(isolate, expired.size() * 8);
+  double* ids = static_cast<double*>(ab->Data());
+  for (size_t i = 0; i < expired.size(); i++) {
+    ids[i] = static_cast<double>(expired[i]);
+  }
+  args.GetReturnValue().Set(Float64Array::New(ab, 0, expired.size()));
+}
+
+void BindingData::TimerWheelNextExpiry(
+    const FunctionCallbackInfo<Value>& args) {
+  const uint64_t next = Realm::GetBindingData<BindingData>(args)
+                            ->wheel_.NextExpiry();
+  args.GetReturnValue().Set(Number::New(
+      args.GetIsolate(),
+      next == TimerWheel::kNoExpiry ? -1 : static_cast<double>(next)));
+}
+
 BindingData::BindingData(Realm* realm, Local<Object> object)
     : SnapshotableObject(realm, object, type_int) {}
 
@@ -129,6 +198,10 @@ v8::CFunction BindingData::fast_toggle_timer_ref_(
     v8::CFunction::Make(FastToggleTimerRef));
 v8::CFunction BindingData::fast_toggle_immediate_ref_(
     v8::CFunction::Make(FastToggleImmediateRef));
+v8::CFunction BindingData::fast_timer_wheel_add_(
+    v8::CFunction::Make(FastTimerWheelAdd));
+v8::CFunction BindingData::fast_timer_wheel_cancel_(
+    v8::CFunction::Make(FastTimerWheelCancel));
 
 void BindingData::CreatePerIsolateProperties(IsolateData* isolate_data,
                                              Local<ObjectTemplate> target) {
@@ -152,6 +225,18 @@ void BindingData::CreatePerIsolateProperties(IsolateData* isolate_data,
                 "toggleImmediateRef",
                 SlowToggleImmediateRef,
                 &fast_toggle_immediate_ref_);
+  SetFastMethod(isolate,
+                target,
+                "timerWheelAdd",
+                SlowTimerWheelAdd,
+                &fast_timer_wheel_add_);
+  SetFastMethod(isolate,
+                target,
+                "timerWheelCancel",
+                SlowTimerWheelCancel,
+                &fast_timer_wheel_cancel_);
+  SetMethod(isolate, target, "timerWheelExpire", TimerWheelExpire);
+  SetMethod(isolate, target, "timerWheelNextExpiry", TimerWheelNextExpiry);
 }
 
 void BindingData::CreatePerContextProperties(Local<Object> target,
@@ -192,6 +277,15 @@ void BindingData::RegisterTimerExternalReferences(
 
   registry->Register(SlowToggleImmediateRef);
   registry->Register(fast_toggle_immediate_ref_);
+
+  registry->Register(SlowTimerWheelAdd);
+  registry->Register(fast_timer_wheel_add_);
+
+  registry->Register(SlowTimerWheelCancel);
+  registry->Register(fast_timer_wheel_cancel_);
+
+  registry->Register(TimerWheelExpire);
+  registry->Register(TimerWheelNextExpiry);
 }
 
 }  // namespace timers
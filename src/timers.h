@@ -5,6 +5,7 @@
 
 #include <cinttypes>
 #include "node_snapshotable.h"
+#include "timer_wheel.h"
 
 namespace node {
 class ExternalReferenceRegistry;
@@ -45,6 +46,29 @@ class BindingData : public SnapshotableObject {
   static void FastToggleImmediateRef(v8::Local<v8::Object> receiver, bool ref);
   static void ToggleImmediateRefImpl(BindingData* data, bool ref);
 
+  // A native timer wheel that JavaScript can keep its timers in, keyed by
+  // their ids, instead of its per-duration lists. Expiry times are in
+  // milliseconds on the getLibuvNow() clock.
+  static void SlowTimerWheelAdd(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void FastTimerWheelAdd(v8::Local<v8::Object> receiver,
+                                int64_t id,
+                                int64_t expiry);
+  static void TimerWheelAddImpl(BindingData* data, int64_t id, int64_t expiry);
+
+  static void SlowTimerWheelCancel(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void FastTimerWheelCancel(v8::Local<v8::Object> receiver, int64_t id);
+  static void TimerWheelCancelImpl(BindingData* data, int64_t id);
+
+  // Returns the ids of all timers that have expired by the given time as a
+  // Float64Array, in the order in which they are to run.
+  static void TimerWheelExpire(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // Returns the earliest time at which timerWheelExpire() can return any
+  // timers, or -1 if the wheel is empty.
+  static void TimerWheelNextExpiry(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+
   static void CreatePerIsolateProperties(IsolateData* isolate_data,
                                          v8::Local<v8::ObjectTemplate> target);
   static void CreatePerContextProperties(v8::Local<v8::Object> target,
@@ -59,6 +83,10 @@ class BindingData : public SnapshotableObject {
   static v8::CFunction fast_schedule_timer_;
   static v8::CFunction fast_toggle_timer_ref_;
   static v8::CFunction fast_toggle_immediate_ref_;
+  static v8::CFunction fast_timer_wheel_add_;
+  static v8::CFunction fast_timer_wheel_cancel_;
+
+  TimerWheel wheel_;
 };
 
 }  // namespace timers
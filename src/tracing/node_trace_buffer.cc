@@ -1,38 +1,92 @@
 #include "tracing/node_trace_buffer.h"
 
 #include <memory>
+#include <thread>
 #include "util-inl.h"
 
 namespace node {
 namespace tracing {
 
+namespace {
+
+// The chunk that the thread adds its events to. The sequence numbers of
+// chunks are unique across buffers, so a chunk that has been flushed, or
+// that belongs to a buffer that was destroyed, is never mistaken for it.
+struct OwnedChunk {
+  const InternalTraceBuffer* buffer = nullptr;
+  size_t index = 0;
+  uint32_t seq = 0;
+};
+
+thread_local OwnedChunk owned_chunk;
+
+}  // namespace
+
+InternalTraceBuffer::ChunkLock::ChunkLock(ChunkSlot* slot) : slot_(slot) {
+  while (slot_->busy.test_and_set(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+}
+
+InternalTraceBuffer::ChunkLock::~ChunkLock() {
+  slot_->busy.clear(std::memory_order_release);
+}
+
+uint32_t InternalTraceBuffer::NextChunkSeq() {
+  static std::atomic<uint32_t> next_seq{1};
+  uint32_t seq;
+  do {
+    seq = next_seq.fetch_add(1, std::memory_order_relaxed);
+  } while (seq == 0);
+  return seq;
+}
+
 InternalTraceBuffer::InternalTraceBuffer(size_t max_chunks, uint32_t id,
                                          Agent* agent)
     : flushing_(false), max_chunks_(max_chunks),
-      agent_(agent), id_(id) {
-  chunks_.resize(max_chunks);
-}
+      agent_(agent), chunks_(new ChunkSlot[max_chunks]), id_(id) {}
 
 TraceObject* InternalTraceBuffer::AddTraceEvent(uint64_t* handle) {
+  size_t event_index;
+  OwnedChunk& owned = owned_chunk;
+  if (owned.buffer == this) {
+    ChunkSlot& slot = chunks_[owned.index];
+    ChunkLock chunk_lock(&slot);
+    if (slot.owner_seq == owned.seq && !slot.chunk->IsFull()) {
+      TraceObject* trace_object = slot.chunk->AddTraceEvent(&event_index);
+      *handle = MakeHandle(owned.index, owned.seq, event_index);
+      return trace_object;
+    }
+  }
+
+  // Claim the next chunk.
   Mutex::ScopedLock scoped_lock(mutex_);
-  // Create new chunk if last chunk is full or there is no chunk.
-  if (total_chunks_ == 0 || chunks_[total_chunks_ - 1]->IsFull()) {
-    auto& chunk = chunks_[total_chunks_++];
-    if (chunk) {
-      chunk->Reset(current_chunk_seq_++);
+  size_t index = total_chunks_.load(std::memory_order_relaxed);
+  if (index == max_chunks_) {
+    // Another thread claimed the last chunk since the caller checked.
+    *handle = 0;
+    return nullptr;
+  }
+  ChunkSlot& slot = chunks_[index];
+  uint32_t seq = NextChunkSeq();
+  TraceObject* trace_object;
+  {
+    ChunkLock chunk_lock(&slot);
+    if (slot.chunk) {
+      slot.chunk->Reset(seq);
     } else {
-      chunk = std::make_unique<TraceBufferChunk>(current_chunk_seq_++);
+      slot.chunk = std::make_unique<TraceBufferChunk>(seq);
     }
+    slot.owner_seq = seq;
+    trace_object = slot.chunk->AddTraceEvent(&event_index);
   }
-  auto& chunk = chunks_[total_chunks_ - 1];
-  size_t event_index;
-  TraceObject* trace_object = chunk->AddTraceEvent(&event_index);
-  *handle = MakeHandle(total_chunks_ - 1, chunk->seq(), event_index);
+  total_chunks_.store(index + 1, std::memory_order_release);
+  owned = {this, index, seq};
+  *handle = MakeHandle(index, seq, event_index);
   return trace_object;
 }
 
 TraceObject* InternalTraceBuffer::GetEventByHandle(uint64_t handle) {
-  Mutex::ScopedLock scoped_lock(mutex_);
   if (handle == 0) {
     // A handle value of zero never has a trace event associated with it.
     return nullptr;
@@ -40,27 +94,34 @@ TraceObject* InternalTraceBuffer::GetEventByHandle(uint64_t handle) {
   size_t chunk_index, event_index;
   uint32_t buffer_id, chunk_seq;
   ExtractHandle(handle, &buffer_id, &chunk_index, &chunk_seq, &event_index);
-  if (buffer_id != id_ || chunk_index >= total_chunks_) {
+  if (buffer_id != id_ ||
+      chunk_index >= total_chunks_.load(std::memory_order_acquire)) {
     // Either the chunk belongs to the other buffer, or is outside the current
     // range of chunks loaded in memory (the latter being true suggests that
     // the chunk has already been flushed and is no longer in memory.)
     return nullptr;
   }
-  auto& chunk = chunks_[chunk_index];
-  if (chunk->seq() != chunk_seq) {
+  ChunkSlot& slot = chunks_[chunk_index];
+  ChunkLock chunk_lock(&slot);
+  if (!slot.chunk || slot.chunk->seq() != chunk_seq) {
     // Chunk is no longer in memory.
     return nullptr;
   }
-  return chunk->GetEventAt(event_index);
+  return slot.chunk->GetEventAt(event_index);
 }
 
 void InternalTraceBuffer::Flush(bool blocking) {
   {
     Mutex::ScopedLock scoped_lock(mutex_);
-    if (total_chunks_ > 0) {
+    size_t total_chunks = total_chunks_.load(std::memory_order_relaxed);
+    if (total_chunks > 0) {
       flushing_ = true;
-      for (size_t i = 0; i < total_chunks_; ++i) {
-        auto& chunk = chunks_[i];
+      for (size_t i = 0; i < total_chunks; ++i) {
+        ChunkSlot& slot = chunks_[i];
+        // Waits for the owner to finish adding an event, and takes the
+        // chunk from it.
+        ChunkLock chunk_lock(&slot);
+        auto& chunk = slot.chunk;
         for (size_t j = 0; j < chunk->size(); ++j) {
           TraceObject* trace_event = chunk->GetEventAt(j);
           // Another thread may have added a trace that is yet to be
@@ -70,8 +131,9 @@ void InternalTraceBuffer::Flush(bool blocking) {
             agent_->AppendTraceEvent(trace_event);
           }
         }
+        slot.owner_seq = 0;
       }
-      total_chunks_ = 0;
+      total_chunks_.store(0, std::memory_order_release);
       flushing_ = false;
     }
   }
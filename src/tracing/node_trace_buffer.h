@@ -24,27 +24,52 @@ class InternalTraceBuffer {
   TraceObject* AddTraceEvent(uint64_t* handle);
   TraceObject* GetEventByHandle(uint64_t handle);
   void Flush(bool blocking);
+  // Full when every chunk has been claimed, even if the threads that own
+  // them could still add to some.
   bool IsFull() const {
-    return total_chunks_ == max_chunks_ && chunks_[total_chunks_ - 1]->IsFull();
+    return total_chunks_.load(std::memory_order_acquire) == max_chunks_;
   }
   bool IsFlushing() const {
-    return flushing_;
+    return flushing_.load(std::memory_order_relaxed);
   }
 
  private:
+  // Every thread adds its events to a chunk that it claimed, so that the
+  // mutex is only taken once per chunk rather than once per event. The
+  // spin lock of a chunk is only contended when a flush or a lookup by
+  // handle catches its owner adding an event.
+  struct ChunkSlot {
+    std::unique_ptr<TraceBufferChunk> chunk;
+    // The sequence number of the chunk while its owner may add to it, or 0
+    // once it has been flushed.
+    uint32_t owner_seq = 0;
+    std::atomic_flag busy = ATOMIC_FLAG_INIT;
+  };
+
+  class ChunkLock {
+   public:
+    explicit ChunkLock(ChunkSlot* slot);
+    ~ChunkLock();
+
+   private:
+    ChunkSlot* slot_;
+  };
+
+  static uint32_t NextChunkSeq();
+
   uint64_t MakeHandle(size_t chunk_index, uint32_t chunk_seq,
                       size_t event_index) const;
   void ExtractHandle(uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
                      uint32_t* chunk_seq, size_t* event_index) const;
   size_t Capacity() const { return max_chunks_ * TraceBufferChunk::kChunkSize; }
 
+  // Guards claiming chunks and flushing them.
   Mutex mutex_;
-  bool flushing_;
+  std::atomic<bool> flushing_;
   size_t max_chunks_;
   Agent* agent_;
-  std::vector<std::unique_ptr<TraceBufferChunk>> chunks_;
-  size_t total_chunks_ = 0;
-  uint32_t current_chunk_seq_ = 1;
+  std::unique_ptr<ChunkSlot[]> chunks_;
+  std::atomic<size_t> total_chunks_{0};
   uint32_t id_;
 };
 
@@ -0,0 +1,440 @@
+#include "tracing/perfetto_trace_writer.h"
+
+#include "tracing/trace_event_common.h"
+
+#include <cstring>
+
+namespace node {
+namespace tracing {
+
+namespace {
+
+// Trace.
+constexpr uint32_t kTracePacket = 1;
+
+// TracePacket.
+constexpr uint32_t kPacketTimestamp = 8;
+constexpr uint32_t kPacketSequenceId = 10;
+constexpr uint32_t kPacketTrackEvent = 11;
+constexpr uint32_t kPacketInternedData = 12;
+constexpr uint32_t kPacketSequenceFlags = 13;
+constexpr uint32_t kPacketTimestampClockId = 58;
+constexpr uint32_t kPacketTrackDescriptor = 60;
+
+constexpr uint64_t kSeqIncrementalStateCleared = 1;
+constexpr uint64_t kSeqNeedsIncrementalState = 2;
+// The builtin CLOCK_MONOTONIC clock, which uv_hrtime() reads.
+constexpr uint64_t kClockMonotonic = 3;
+constexpr uint64_t kSequenceId = 1;
+
+// InternedData, and the iid and name fields of its entries.
+constexpr uint32_t kInternedEventCategories = 1;
+constexpr uint32_t kInternedEventNames = 2;
+constexpr uint32_t kInternedDebugAnnotationNames = 3;
+constexpr uint32_t kInternedIid = 1;
+constexpr uint32_t kInternedName = 2;
+
+// TrackEvent.
+constexpr uint32_t kEventCategoryIids = 3;
+constexpr uint32_t kEventDebugAnnotations = 4;
+constexpr uint32_t kEventType = 9;
+constexpr uint32_t kEventNameIid = 10;
+constexpr uint32_t kEventTrackUuid = 11;
+constexpr uint32_t kEventCounterValue = 30;
+constexpr uint32_t kEventDoubleCounterValue = 44;
+
+constexpr uint64_t kTypeSliceBegin = 1;
+constexpr uint64_t kTypeSliceEnd = 2;
+constexpr uint64_t kTypeInstant = 3;
+constexpr uint64_t kTypeCounter = 4;
+
+// DebugAnnotation.
+constexpr uint32_t kAnnotationNameIid = 1;
+constexpr uint32_t kAnnotationBool = 2;
+constexpr uint32_t kAnnotationUint = 3;
+constexpr uint32_t kAnnotationInt = 4;
+constexpr uint32_t kAnnotationDouble = 5;
+constexpr uint32_t kAnnotationString = 6;
+constexpr uint32_t kAnnotationPointer = 7;
+constexpr uint32_t kAnnotationLegacyJson = 9;
+
+// TrackDescriptor, ProcessDescriptor and ThreadDescriptor.
+constexpr uint32_t kTrackUuid = 1;
+constexpr uint32_t kTrackName = 2;
+constexpr uint32_t kTrackProcess = 3;
+constexpr uint32_t kTrackThread = 4;
+constexpr uint32_t kTrackParentUuid = 5;
+constexpr uint32_t kTrackCounter = 8;
+constexpr uint32_t kProcessPid = 1;
+constexpr uint32_t kProcessName = 6;
+constexpr uint32_t kThreadPid = 1;
+constexpr uint32_t kThreadTid = 2;
+constexpr uint32_t kThreadName = 5;
+
+// The tracks of each kind get uuids from different hashes.
+enum class TrackKind : uint64_t { kProcess = 1, kThread, kAsync, kCounter };
+
+uint64_t Mix(uint64_t hash, uint64_t value) {
+  // splitmix64.
+  hash += value + 0x9e3779b97f4a7c15;
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111eb;
+  return hash ^ (hash >> 31);
+}
+
+uint64_t Mix(uint64_t hash, std::string_view value) {
+  // FNV-1a.
+  uint64_t string_hash = 0xcbf29ce484222325;
+  for (char c : value) {
+    string_hash = (string_hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+  }
+  return Mix(hash, string_hash);
+}
+
+uint64_t NonZero(uint64_t uuid) {
+  return uuid == 0 ? 1 : uuid;
+}
+
+uint64_t TrackUuid(TrackKind kind, int pid) {
+  return NonZero(Mix(static_cast<uint64_t>(kind), static_cast<uint32_t>(pid)));
+}
+
+bool IsAsync(char phase) {
+  switch (phase) {
+    case TRACE_EVENT_PHASE_ASYNC_BEGIN:
+    case TRACE_EVENT_PHASE_ASYNC_STEP_INTO:
+    case TRACE_EVENT_PHASE_ASYNC_STEP_PAST:
+    case TRACE_EVENT_PHASE_ASYNC_END:
+    case TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN:
+    case TRACE_EVENT_PHASE_NESTABLE_ASYNC_END:
+    case TRACE_EVENT_PHASE_NESTABLE_ASYNC_INSTANT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+PerfettoTraceWriter::PerfettoTraceWriter(std::ostream& stream)
+    : stream_(stream) {}
+
+void PerfettoTraceWriter::AppendPacket(const Message& packet) {
+  Message trace;
+  trace.AppendMessage(kTracePacket, packet);
+  stream_.write(trace.data().data(), trace.data().size());
+}
+
+uint64_t PerfettoTraceWriter::Intern(Interned* table,
+                                     std::string_view value,
+                                     uint32_t field,
+                                     Message* interned_data) {
+  auto [it, inserted] =
+      table->iids.emplace(std::string(value), table->next_iid);
+  if (inserted) {
+    table->next_iid++;
+    Message entry;
+    entry.AppendVarint(kInternedIid, it->second);
+    entry.AppendString(kInternedName, value);
+    interned_data->AppendMessage(field, entry);
+  }
+  return it->second;
+}
+
+uint64_t PerfettoTraceWriter::ProcessTrack(int pid) {
+  uint64_t uuid = TrackUuid(TrackKind::kProcess, pid);
+  if (tracks_.insert(uuid).second) {
+    Message process;
+    process.AppendVarint(kProcessPid, pid);
+    Message track;
+    track.AppendVarint(kTrackUuid, uuid);
+    track.AppendMessage(kTrackProcess, process);
+    Message packet;
+    packet.AppendMessage(kPacketTrackDescriptor, track);
+    AppendPacket(packet);
+  }
+  return uuid;
+}
+
+uint64_t PerfettoTraceWriter::ThreadTrack(int pid, int tid) {
+  uint64_t uuid = NonZero(
+      Mix(TrackUuid(TrackKind::kThread, pid), static_cast<uint32_t>(tid)));
+  if (!tracks_.contains(uuid)) {
+    uint64_t parent_uuid = ProcessTrack(pid);
+    tracks_.insert(uuid);
+    Message thread;
+    thread.AppendVarint(kThreadPid, pid);
+    thread.AppendVarint(kThreadTid, tid);
+    Message track;
+    track.AppendVarint(kTrackUuid, uuid);
+    track.AppendVarint(kTrackParentUuid, parent_uuid);
+    track.AppendMessage(kTrackThread, thread);
+    Message packet;
+    packet.AppendMessage(kPacketTrackDescriptor, track);
+    AppendPacket(packet);
+  }
+  return uuid;
+}
+
+uint64_t PerfettoTraceWriter::AsyncTrack(TraceObject* trace_event,
+                                         const char* category) {
+  // Like in the JSON format, nestable async events are matched by category
+  // and id, and the others by name too.
+  char phase = trace_event->phase();
+  bool nestable = phase == TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN ||
+                  phase == TRACE_EVENT_PHASE_NESTABLE_ASYNC_END ||
+                  phase == TRACE_EVENT_PHASE_NESTABLE_ASYNC_INSTANT;
+  uint64_t hash = Mix(TrackUuid(TrackKind::kAsync, trace_event->pid()),
+                      std::string_view(category));
+  hash = Mix(hash, trace_event->id());
+  if (!nestable) hash = Mix(hash, std::string_view(trace_event->name()));
+  if (trace_event->scope() != nullptr) {
+    hash = Mix(hash, std::string_view(trace_event->scope()));
+  }
+  uint64_t uuid = NonZero(hash);
+  if (!tracks_.contains(uuid)) {
+    uint64_t parent_uuid = ProcessTrack(trace_event->pid());
+    tracks_.insert(uuid);
+    Message track;
+    track.AppendVarint(kTrackUuid, uuid);
+    track.AppendVarint(kTrackParentUuid, parent_uuid);
+    track.AppendString(kTrackName, trace_event->name());
+    Message packet;
+    packet.AppendMessage(kPacketTrackDescriptor, track);
+    AppendPacket(packet);
+  }
+  return uuid;
+}
+
+uint64_t PerfettoTraceWriter::CounterTrack(int pid, std::string_view name) {
+  uint64_t uuid = NonZero(Mix(TrackUuid(TrackKind::kCounter, pid), name));
+  if (!tracks_.contains(uuid)) {
+    uint64_t parent_uuid = ProcessTrack(pid);
+    tracks_.insert(uuid);
+    Message track;
+    track.AppendVarint(kTrackUuid, uuid);
+    track.AppendVarint(kTrackParentUuid, parent_uuid);
+    track.AppendString(kTrackName, name);
+    track.AppendMessage(kTrackCounter, Message());
+    Message packet;
+    packet.AppendMessage(kPacketTrackDescriptor, track);
+    AppendPacket(packet);
+  }
+  return uuid;
+}
+
+void PerfettoTraceWriter::AppendTrackEvent(TraceObject* trace_event,
+                                           const char* category,
+                                           uint64_t track_uuid,
+                                           uint64_t type,
+                                           int64_t timestamp_us,
+                                           bool with_args) {
+  Message interned_data;
+  Message event;
+  event.AppendVarint(kEventType, type);
+  event.AppendVarint(kEventTrackUuid, track_uuid);
+  if (type != kTypeSliceEnd) {
+    event.AppendVarint(
+        kEventCategoryIids,
+        Intern(&categories_, category, kInternedEventCategories,
+               &interned_data));
+    event.AppendVarint(
+        kEventNameIid,
+        Intern(&names_, trace_event->name(), kInternedEventNames,
+               &interned_data));
+  }
+
+  for (int i = 0; with_args && i < trace_event->num_args(); i++) {
+    const TraceObject::ArgValue& value = trace_event->arg_values()[i];
+    Message annotation;
+    annotation.AppendVarint(
+        kAnnotationNameIid,
+        Intern(&annotation_names_, trace_event->arg_names()[i],
+               kInternedDebugAnnotationNames, &interned_data));
+    switch (trace_event->arg_types()[i]) {
+      case TRACE_VALUE_TYPE_BOOL:
+        annotation.AppendVarint(kAnnotationBool, value.as_uint ? 1 : 0);
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        annotation.AppendVarint(kAnnotationUint, value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        annotation.AppendVarint(kAnnotationInt,
+                                static_cast<uint64_t>(value.as_int));
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        annotation.AppendDouble(kAnnotationDouble, value.as_double);
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        annotation.AppendVarint(
+            kAnnotationPointer,
+            static_cast<uint64_t>(
+                reinterpret_cast<uintptr_t>(value.as_pointer)));
+        break;
+      case TRACE_VALUE_TYPE_STRING:
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        annotation.AppendString(
+            kAnnotationString,
+            value.as_string != nullptr ? value.as_string : "");
+        break;
+      case TRACE_VALUE_TYPE_CONVERTABLE: {
+        std::string json;
+        trace_event->arg_convertables()[i]->AppendAsTraceFormat(&json);
+        annotation.AppendString(kAnnotationLegacyJson, json);
+        break;
+      }
+      default:
+        continue;
+    }
+    event.AppendMessage(kEventDebugAnnotations, annotation);
+  }
+
+  Message packet;
+  packet.AppendVarint(kPacketTimestamp,
+                      static_cast<uint64_t>(timestamp_us) * 1000);
+  packet.AppendVarint(kPacketTimestampClockId, kClockMonotonic);
+  packet.AppendVarint(kPacketSequenceId, kSequenceId);
+  uint64_t flags = kSeqNeedsIncrementalState;
+  if (!incremental_state_cleared_) {
+    // The first packet of the file starts the interning tables.
+    flags |= kSeqIncrementalStateCleared;
+    incremental_state_cleared_ = true;
+  }
+  packet.AppendVarint(kPacketSequenceFlags, flags);
+  if (!interned_data.empty()) {
+    packet.AppendMessage(kPacketInternedData, interned_data);
+  }
+  packet.AppendMessage(kPacketTrackEvent, event);
+  AppendPacket(packet);
+}
+
+void PerfettoTraceWriter::AppendCounters(TraceObject* trace_event,
+                                         const char* category) {
+  // Every argument of a counter event is a series of its own.
+  for (int i = 0; i < trace_event->num_args(); i++) {
+    const TraceObject::ArgValue& value = trace_event->arg_values()[i];
+    Message event;
+    switch (trace_event->arg_types()[i]) {
+      case TRACE_VALUE_TYPE_BOOL:
+      case TRACE_VALUE_TYPE_UINT:
+        event.AppendVarint(kEventCounterValue, value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        event.AppendVarint(kEventCounterValue,
+                           static_cast<uint64_t>(value.as_int));
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        event.AppendDouble(kEventDoubleCounterValue, value.as_double);
+        break;
+      default:
+        continue;
+    }
+    std::string name = trace_event->name();
+    if (trace_event->num_args() > 1) {
+      name.append(".").append(trace_event->arg_names()[i]);
+    }
+    event.AppendVarint(kEventType, kTypeCounter);
+    event.AppendVarint(kEventTrackUuid,
+                       CounterTrack(trace_event->pid(), name));
+
+    Message packet;
+    packet.AppendVarint(kPacketTimestamp,
+                        static_cast<uint64_t>(trace_event->ts()) * 1000);
+    packet.AppendVarint(kPacketTimestampClockId, kClockMonotonic);
+    packet.AppendVarint(kPacketSequenceId, kSequenceId);
+    packet.AppendMessage(kPacketTrackEvent, event);
+    AppendPacket(packet);
+  }
+}
+
+void PerfettoTraceWriter::AppendMetadata(TraceObject* trace_event) {
+  // Only the names of processes and threads have a track descriptor field.
+  const char* name = nullptr;
+  for (int i = 0; i < trace_event->num_args(); i++) {
+    uint8_t type = trace_event->arg_types()[i];
+    if (strcmp(trace_event->arg_names()[i], "name") == 0 &&
+        (type == TRACE_VALUE_TYPE_STRING ||
+         type == TRACE_VALUE_TYPE_COPY_STRING)) {
+      name = trace_event->arg_values()[i].as_string;
+    }
+  }
+  if (name == nullptr) return;
+
+  int pid = trace_event->pid();
+  Message track;
+  if (strcmp(trace_event->name(), "process_name") == 0) {
+    Message process;
+    process.AppendVarint(kProcessPid, pid);
+    process.AppendString(kProcessName, name);
+    track.AppendVarint(kTrackUuid, ProcessTrack(pid));
+    track.AppendMessage(kTrackProcess, process);
+  } else if (strcmp(trace_event->name(), "thread_name") == 0) {
+    int tid = trace_event->tid();
+    Message thread;
+    thread.AppendVarint(kThreadPid, pid);
+    thread.AppendVarint(kThreadTid, tid);
+    thread.AppendString(kThreadName, name);
+    track.AppendVarint(kTrackUuid, ThreadTrack(pid, tid));
+    track.AppendVarint(kTrackParentUuid, ProcessTrack(pid));
+    track.AppendMessage(kTrackThread, thread);
+  } else {
+    return;
+  }
+  // A descriptor for a track that already has one updates it.
+  Message packet;
+  packet.AppendMessage(kPacketTrackDescriptor, track);
+  AppendPacket(packet);
+}
+
+void PerfettoTraceWriter::AppendTraceEvent(TraceObject* trace_event) {
+  const char* category =
+      v8::platform::tracing::TracingController::GetCategoryGroupName(
+          trace_event->category_enabled_flag());
+  char phase = trace_event->phase();
+  switch (phase) {
+    case TRACE_EVENT_PHASE_METADATA:
+      AppendMetadata(trace_event);
+      return;
+    case TRACE_EVENT_PHASE_COUNTER:
+      AppendCounters(trace_event, category);
+      return;
+    default:
+      break;
+  }
+
+  uint64_t track_uuid =
+      IsAsync(phase)
+          ? AsyncTrack(trace_event, category)
+          : ThreadTrack(trace_event->pid(), trace_event->tid());
+  switch (phase) {
+    case TRACE_EVENT_PHASE_BEGIN:
+    case TRACE_EVENT_PHASE_ASYNC_BEGIN:
+    case TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN:
+      AppendTrackEvent(trace_event, category, track_uuid, kTypeSliceBegin,
+                       trace_event->ts(), true);
+      break;
+    case TRACE_EVENT_PHASE_END:
+    case TRACE_EVENT_PHASE_ASYNC_END:
+    case TRACE_EVENT_PHASE_NESTABLE_ASYNC_END:
+      AppendTrackEvent(trace_event, category, track_uuid, kTypeSliceEnd,
+                       trace_event->ts(), true);
+      break;
+    case TRACE_EVENT_PHASE_COMPLETE:
+      AppendTrackEvent(trace_event, category, track_uuid, kTypeSliceBegin,
+                       trace_event->ts(), true);
+      AppendTrackEvent(trace_event, category, track_uuid, kTypeSliceEnd,
+                       trace_event->ts() + trace_event->duration(), false);
+      break;
+    default:
+      // Instant events, and the phases that have no equivalent, which keep
+      // their name and arguments.
+      AppendTrackEvent(trace_event, category, track_uuid, kTypeInstant,
+                       trace_event->ts(), true);
+      break;
+  }
+}
+
+void PerfettoTraceWriter::Flush() {}
+
+}  // namespace tracing
+}  // namespace node
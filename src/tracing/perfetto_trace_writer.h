@@ -0,0 +1,73 @@
+#ifndef SRC_TRACING_PERFETTO_TRACE_WRITER_H_
+#define SRC_TRACING_PERFETTO_TRACE_WRITER_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "libplatform/v8-tracing.h"
+#include "node_protobuf.h"
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TraceObject;
+using v8::platform::tracing::TraceWriter;
+
+// Serializes trace events as packets of the Perfetto protobuf trace format,
+// https://perfetto.dev/docs/reference/trace-packet-proto, which are much
+// smaller and cheaper to produce than the JSON format. Names, categories
+// and argument names are interned, so a file must be read from its start.
+// The packets can be written as they come: a file is a sequence of them,
+// with no header or footer.
+class PerfettoTraceWriter : public TraceWriter {
+ public:
+  explicit PerfettoTraceWriter(std::ostream& stream);
+
+  void AppendTraceEvent(TraceObject* trace_event) override;
+  void Flush() override;
+
+ private:
+  using Message = ProtobufMessage;
+
+  struct Interned {
+    std::unordered_map<std::string, uint64_t> iids;
+    uint64_t next_iid = 1;
+  };
+
+  // Returns the iid of value in table, adding it to the interned_data of the
+  // packet under field if it is new.
+  uint64_t Intern(Interned* table,
+                  std::string_view value,
+                  uint32_t field,
+                  Message* interned_data);
+  // Returns the uuid of a track, writing its descriptor the first time.
+  uint64_t ProcessTrack(int pid);
+  uint64_t ThreadTrack(int pid, int tid);
+  uint64_t AsyncTrack(TraceObject* trace_event, const char* category);
+  uint64_t CounterTrack(int pid, std::string_view name);
+  void AppendTrackEvent(TraceObject* trace_event,
+                        const char* category,
+                        uint64_t track_uuid,
+                        uint64_t type,
+                        int64_t timestamp_us,
+                        bool with_args);
+  void AppendCounters(TraceObject* trace_event, const char* category);
+  void AppendMetadata(TraceObject* trace_event);
+  void AppendPacket(const Message& packet);
+
+  std::ostream& stream_;
+  bool incremental_state_cleared_ = false;
+  Interned categories_;
+  Interned names_;
+  Interned annotation_names_;
+  std::unordered_set<uint64_t> tracks_;
+};
+
+}  // namespace tracing
+}  // namespace node
+
+#endif  // SRC_TRACING_PERFETTO_TRACE_WRITER_H_
@@ -30,6 +30,13 @@
 #include "req_wrap-inl.h"
 #include "util-inl.h"
 
+#include <cstring>
+
+#if defined(__linux__)
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#endif
+
 namespace node {
 
 using errors::TryCatchScope;
@@ -45,6 +52,7 @@ using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Integer;
 using v8::Isolate;
+using v8::LocalVector;
 using v8::Local;
 using v8::MaybeLocal;
 using v8::Object;
@@ -52,6 +60,7 @@ using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::Signature;
 using v8::Uint32;
+using v8::Uint32Array;
 using v8::Undefined;
 using v8::Value;
 
@@ -142,16 +151,19 @@ void UDPWrapBase::RegisterExternalReferences(
   registry->Register(RecvStop);
 }
 
-UDPWrap::UDPWrap(Environment* env, Local<Object> object)
+UDPWrap::UDPWrap(Environment* env, Local<Object> object, bool recv_batching)
     : HandleWrap(env,
                  object,
                  reinterpret_cast<uv_handle_t*>(&handle_),
-                 AsyncWrap::PROVIDER_UDPWRAP) {
+                 AsyncWrap::PROVIDER_UDPWRAP),
+      recv_batching_(recv_batching) {
   object->SetAlignedPointerInInternalField(UDPWrapBase::kUDPWrapBaseField,
                                            static_cast<UDPWrapBase*>(this),
                                            EmbedderDataTag::kDefault);
 
-  int r = uv_udp_init(env->event_loop(), &handle_);
+  unsigned int flags = AF_UNSPEC;
+  if (recv_batching) flags |= UV_UDP_RECVMMSG;
+  int r = uv_udp_init_ex(env->event_loop(), &handle_, flags);
   CHECK_EQ(r, 0);  // can't fail anyway
 
   set_listener(this);
@@ -190,6 +202,9 @@ void UDPWrap::Initialize(Local<Object> target,
   SetProtoMethod(isolate, t, "bind6", Bind6);
   SetProtoMethod(isolate, t, "connect6", Connect6);
   SetProtoMethod(isolate, t, "send6", Send6);
+  SetProtoMethod(isolate, t, "sendBatch", SendBatch);
+  SetProtoMethod(isolate, t, "sendBatch6", SendBatch6);
+  SetProtoMethod(isolate, t, "setSendSegmentSize", SetSendSegmentSize);
   SetProtoMethod(isolate, t, "disconnect", Disconnect);
   SetProtoMethod(isolate,
                  t,
@@ -252,6 +267,9 @@ void UDPWrap::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(Bind6);
   registry->Register(Connect6);
   registry->Register(Send6);
+  registry->Register(SendBatch);
+  registry->Register(SendBatch6);
+  registry->Register(SetSendSegmentSize);
   registry->Register(Disconnect);
   registry->Register(GetSockOrPeerName<UDPWrap, uv_udp_getpeername>);
   registry->Register(GetSockOrPeerName<UDPWrap, uv_udp_getsockname>);
@@ -272,7 +290,8 @@ void UDPWrap::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
 void UDPWrap::New(const FunctionCallbackInfo<Value>& args) {
   CHECK(args.IsConstructCall());
   Environment* env = Environment::GetCurrent(args);
-  new UDPWrap(env, args.This());
+  // new UDP(recvBatching)
+  new UDPWrap(env, args.This(), args[0]->IsTrue());
 }
 
 
@@ -670,6 +689,96 @@ ReqWrap<uv_udp_send_t>* UDPWrap::CreateSendWrap(size_t msg_size) {
 }
 
 
+// Sends each Buffer in `list` as a datagram of its own, all with one
+// sendmmsg() call where the platform has it. Nothing is queued: the return
+// value is the number of datagrams the kernel took, which may be fewer than
+// `count`, or a negative error code such as UV_EAGAIN if it took none. The
+// socket must be bound or connected already.
+void UDPWrap::DoSendBatch(const FunctionCallbackInfo<Value>& args,
+                          int family) {
+  Environment* env = Environment::GetCurrent(args);
+
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(
+      &wrap, args.This(), args.GetReturnValue().Set(UV_EBADF));
+
+  THROW_IF_INSUFFICIENT_PERMISSIONS(env,
+                                    permission::PermissionScope::kNet,
+                                    "",
+                                    args.GetReturnValue().Set(UV_EACCES));
+
+  CHECK(args.Length() == 2 || args.Length() == 4);
+  CHECK(args[0]->IsArray());
+  CHECK(args[1]->IsUint32());
+
+  if (wrap->IsHandleClosing()) return args.GetReturnValue().Set(UV_EBADF);
+
+  // sendBatch(list, list.length[, port, address])
+  Local<Array> chunks = args[0].As<Array>();
+  size_t count = args[1].As<Uint32>()->Value();
+  if (count == 0) return args.GetReturnValue().Set(0);
+
+  struct sockaddr_storage addr_storage;
+  sockaddr* addr = nullptr;
+  if (args.Length() == 4) {
+    CHECK(args[2]->IsUint32());
+    CHECK(args[3]->IsString());
+    const unsigned short port = args[2].As<Uint32>()->Value();
+    node::Utf8Value address(env->isolate(), args[3]);
+    int err = sockaddr_for_family(family, address.out(), port, &addr_storage);
+    if (err != 0) return args.GetReturnValue().Set(err);
+    addr = reinterpret_cast<sockaddr*>(&addr_storage);
+  }
+
+  MaybeStackBuffer<uv_buf_t, 16> bufs(count);
+  MaybeStackBuffer<uv_buf_t*, 16> buf_ptrs(count);
+  MaybeStackBuffer<unsigned int, 16> nbufs(count);
+  MaybeStackBuffer<sockaddr*, 16> addrs(count);
+  for (size_t i = 0; i < count; i++) {
+    Local<Value> chunk;
+    if (!chunks->Get(env->context(), i).ToLocal(&chunk)) return;
+    bufs[i] = uv_buf_init(Buffer::Data(chunk), Buffer::Length(chunk));
+    buf_ptrs[i] = &bufs[i];
+    nbufs[i] = 1;
+    addrs[i] = addr;
+  }
+
+  args.GetReturnValue().Set(uv_udp_try_send2(
+      &wrap->handle_, count, *buf_ptrs, *nbufs, *addrs, 0));
+}
+
+void UDPWrap::SendBatch(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET);
+}
+
+void UDPWrap::SendBatch6(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET6);
+}
+
+// setSendSegmentSize(size) turns on UDP generic segmentation offload: every
+// send is split by the kernel, or the NIC, into datagrams of `size` bytes,
+// so one large Buffer carries many datagrams through the stack at once.
+// 0 turns it off again. Linux only.
+void UDPWrap::SetSendSegmentSize(const FunctionCallbackInfo<Value>& args) {
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(
+      &wrap, args.This(), args.GetReturnValue().Set(UV_EBADF));
+
+  CHECK(args[0]->IsUint32());
+#if defined(__linux__) && defined(UDP_SEGMENT)
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd);
+  if (err == 0) {
+    int size = static_cast<int>(args[0].As<Uint32>()->Value());
+    if (setsockopt(fd, SOL_UDP, UDP_SEGMENT, &size, sizeof(size)) != 0)
+      err = uv_translate_sys_error(errno);
+  }
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
 void UDPWrap::Send(const FunctionCallbackInfo<Value>& args) {
   DoSend(args, AF_INET);
 }
@@ -742,6 +851,13 @@ void UDPWrap::OnAlloc(uv_handle_t* handle,
 }
 
 uv_buf_t UDPWrap::OnAlloc(size_t suggested_size) {
+  if (recv_batching_) {
+    // Every datagram is copied out before the next read, so one buffer
+    // serves all reads.
+    constexpr size_t kSize = kRecvBatchSlots * kMaxDatagramSize;
+    if (!recv_batch_buffer_) recv_batch_buffer_.reset(new char[kSize]);
+    return uv_buf_init(recv_batch_buffer_.get(), kSize);
+  }
   return env()->allocate_managed_buffer(suggested_size);
 }
 
@@ -758,6 +874,8 @@ void UDPWrap::OnRecv(ssize_t nread,
                      const uv_buf_t& buf_,
                      const sockaddr* addr,
                      unsigned int flags) {
+  if (recv_batching_) return OnRecvBatched(nread, buf_, addr, flags);
+
   Environment* env = this->env();
   Isolate* isolate = env->isolate();
   std::unique_ptr<BackingStore> bs = env->release_managed_buffer(buf_);
@@ -829,6 +947,102 @@ void UDPWrap::OnRecv(ssize_t nread,
   MakeCallback(env->onmessage_string(), arraysize(argv), argv);
 }
 
+void UDPWrap::OnRecvBatched(ssize_t nread,
+                            const uv_buf_t& buf,
+                            const sockaddr* addr,
+                            unsigned int flags) {
+  if (nread >= 0 && addr != nullptr) {
+    batch_offsets_.push_back(static_cast<uint32_t>(batch_data_.size()));
+    batch_data_.insert(batch_data_.end(), buf.base, buf.base + nread);
+    sockaddr_storage& storage = batch_addrs_.emplace_back();
+    memcpy(&storage, addr, SocketAddress::GetLength(addr));
+    // recvmmsg() reports its datagrams one by one, then once more with
+    // UV_UDP_MMSG_FREE; plain reads come alone.
+    if (flags & UV_UDP_MMSG_CHUNK) return;
+  }
+
+  if (!batch_offsets_.empty()) EmitRecvBatch();
+
+  if (nread < 0) {
+    Environment* env = this->env();
+    Isolate* isolate = env->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env->context());
+    Local<Value> argv[] = {
+        Integer::New(isolate, static_cast<int32_t>(nread)),
+        object(),
+        Undefined(isolate),
+        Undefined(isolate)};
+    MakeCallback(env->onmessage_string(), arraysize(argv), argv);
+  }
+}
+
+void UDPWrap::EmitRecvBatch() {
+  Environment* env = this->env();
+  Isolate* isolate = env->isolate();
+  HandleScope handle_scope(isolate);
+  Context::Scope context_scope(env->context());
+
+  const size_t count = batch_offsets_.size();
+  batch_offsets_.push_back(static_cast<uint32_t>(batch_data_.size()));
+
+  Local<Value> argv[] = {Integer::New(isolate, static_cast<int32_t>(count)),
+                         object(),
+                         Undefined(isolate),
+                         Undefined(isolate),
+                         Undefined(isolate)};
+  bool has_caught = false;
+  {
+    TryCatchScope try_catch(env);
+    Local<Object> buffer;
+    LocalVector<Value> addresses(isolate);
+    addresses.reserve(count);
+    bool ok =
+        Buffer::Copy(env, batch_data_.data(), batch_data_.size())
+            .ToLocal(&buffer);
+    // Senders tend to come in runs, so reuse the object for a repeated
+    // address.
+    for (size_t i = 0; ok && i < count; i++) {
+      const sockaddr* addr =
+          reinterpret_cast<const sockaddr*>(&batch_addrs_[i]);
+      if (i > 0 && memcmp(&batch_addrs_[i],
+                          &batch_addrs_[i - 1],
+                          SocketAddress::GetLength(addr)) == 0) {
+        addresses.push_back(addresses.back());
+        continue;
+      }
+      Local<Object> address;
+      ok = AddressToJS(env, addr).ToLocal(&address);
+      if (ok) addresses.push_back(address);
+    }
+    if (ok) {
+      Local<ArrayBuffer> ab =
+          ArrayBuffer::New(isolate, batch_offsets_.size() * sizeof(uint32_t));
+      memcpy(ab->Data(),
+             batch_offsets_.data(),
+             batch_offsets_.size() * sizeof(uint32_t));
+      argv[2] = buffer;
+      argv[3] = Array::New(isolate, addresses.data(), addresses.size());
+      argv[4] = Uint32Array::New(ab, 0, batch_offsets_.size());
+    } else {
+      DCHECK(try_catch.HasCaught() && !try_catch.HasTerminated());
+      argv[2] = try_catch.Exception();
+      has_caught = true;
+    }
+  }
+
+  batch_data_.clear();
+  batch_offsets_.clear();
+  batch_addrs_.clear();
+
+  if (has_caught) {
+    DCHECK(!argv[2].IsEmpty());
+    MakeCallback(env->onerror_string(), 4, argv);
+    return;
+  }
+  MakeCallback(env->onmessagebatch_string(), arraysize(argv), argv);
+}
+
 MaybeLocal<Object> UDPWrap::Instantiate(Environment* env,
                                         AsyncWrap* parent,
                                         UDPWrap::SocketType type) {
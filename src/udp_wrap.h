@@ -30,6 +30,9 @@
 #include "uv.h"
 #include "v8.h"
 
+#include <memory>
+#include <vector>
+
 namespace node {
 
 class ExternalReferenceRegistry;
@@ -138,6 +141,10 @@ class UDPWrap final : public HandleWrap,
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Send6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetSendSegmentSize(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Disconnect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void AddMembership(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DropMembership(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -189,7 +196,9 @@ class UDPWrap final : public HandleWrap,
             int (*F)(const typename T::HandleType*, sockaddr*, int*)>
   friend void GetSockOrPeerName(const v8::FunctionCallbackInfo<v8::Value>&);
 
-  UDPWrap(Environment* env, v8::Local<v8::Object> object);
+  UDPWrap(Environment* env,
+          v8::Local<v8::Object> object,
+          bool recv_batching = false);
 
   static void DoBind(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
@@ -197,6 +206,8 @@ class UDPWrap final : public HandleWrap,
                      int family);
   static void DoSend(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
+  static void DoSendBatch(const v8::FunctionCallbackInfo<v8::Value>& args,
+                          int family);
   static void SetMembership(const v8::FunctionCallbackInfo<v8::Value>& args,
                             uv_membership membership);
   static void SetSourceMembership(
@@ -212,10 +223,29 @@ class UDPWrap final : public HandleWrap,
                      const struct sockaddr* addr,
                      unsigned int flags);
 
+  void OnRecvBatched(ssize_t nread,
+                     const uv_buf_t& buf,
+                     const sockaddr* addr,
+                     unsigned int flags);
+  void EmitRecvBatch();
+
   uv_udp_t handle_;
 
   bool current_send_has_callback_;
   v8::Local<v8::Object> current_send_req_wrap_;
+
+  // With batched receives, the handle reads with recvmmsg() into one
+  // long-lived buffer, and the datagrams of each call reach JS together
+  // through onmessagebatch(count, handle, buffer, addresses, offsets):
+  // datagram i is buffer[offsets[i], offsets[i + 1]), from addresses[i].
+  // libuv reads at most this many datagrams per recvmmsg() call.
+  static constexpr size_t kRecvBatchSlots = 20;
+  static constexpr size_t kMaxDatagramSize = 64 * 1024;
+  const bool recv_batching_;
+  std::unique_ptr<char[]> recv_batch_buffer_;
+  std::vector<char> batch_data_;
+  std::vector<uint32_t> batch_offsets_;
+  std::vector<sockaddr_storage> batch_addrs_;
 };
 
 int sockaddr_for_family(int address_family,
@@ -31,6 +31,7 @@
 #include "node_internals.h"
 #include "node_snapshot_builder.h"
 #include "node_v8_platform-inl.h"
+#include "simd_abstraction.h"
 #include "string_bytes.h"
 #include "v8-value.h"
 
@@ -48,6 +49,7 @@
 #include <sys/types.h>
 #endif
 
+#include <nbytes.h>
 #include <simdutf.h>
 
 #include <atomic>
@@ -225,6 +227,167 @@ double GetCurrentTimeInMicroseconds() {
   return kMicrosecondsPerSecond * tv.tv_sec + tv.tv_usec;
 }
 
+// The input size from which a kernel is used: the threshold measured by
+// node --simd-calibrate, if a calibration file was loaded, or else the
+// call site's default.
+static size_t KernelThreshold(size_t calibrated, size_t default_threshold) {
+  return calibrated != 0 ? calibrated : default_threshold;
+}
+
+// Below this many bytes nbytes' loop, which compilers turn into bswap or
+// lhbrx/lwbrx sequences, beats an indirect call into the SIMD kernels.
+static constexpr size_t kSimdSwapBytesThreshold = 64;
+
+#define V(bits)                                                                \
+  bool SwapBytes##bits(char* data, size_t nbytes) {                            \
+    constexpr size_t kWidth = (bits) / 8;                                      \
+    if (nbytes >= KernelThreshold(                                             \
+                      get_simd_kernel_thresholds()->swap_bytes##bits,          \
+                      kSimdSwapBytesThreshold) &&                              \
+        nbytes % kWidth == 0 &&                                                \
+        get_simd_kernel_selection()->swap_bytes##bits != SIMD_SCALAR) {        \
+      get_simd_functions()->swap_bytes##bits(data, nbytes / kWidth);           \
+      return true;                                                             \
+    }                                                                          \
+    return nbytes::SwapBytes##bits(data, nbytes);                              \
+  }
+V(16)
+V(32)
+V(64)
+#undef V
+
+// Below this many bytes the indirect call into the SIMD kernels costs more
+// than it saves over nbytes' table loop.
+static constexpr size_t kSimdHexEncodeThreshold = 16;
+
+size_t HexEncode(const char* src, size_t slen, char* dst, size_t dlen) {
+  CHECK_GE(dlen / 2, slen);
+  if (slen >= KernelThreshold(get_simd_kernel_thresholds()->hex_encode,
+                              kSimdHexEncodeThreshold) &&
+      get_simd_kernel_selection()->hex_encode != SIMD_SCALAR) {
+    get_simd_functions()->hex_encode(
+        dst, reinterpret_cast<const uint8_t*>(src), slen);
+    return slen * 2;
+  }
+  return nbytes::HexEncode(src, slen, dst, dlen);
+}
+
+// The pair filter compares the first and the last byte of the needle at every
+// position; past this length Boyer-Moore's skips in nbytes win.
+static constexpr size_t kSimdSearchMaxNeedleLength = 32;
+
+// libc's memchr, memrchr, memcpy, memset and memcmp are already vectorized
+// wherever SSE2 is, so only MMX and AltiVec CPUs gain from the kernels that
+// replace them. This goes by the CPU rather than the selected kernel, since a
+// slot without an SSE2 kernel falls back to the MMX one even on SSE2 CPUs.
+static bool BeatsLibc(simd_instruction_set_t isa) {
+  return isa != SIMD_SCALAR &&
+         (get_simd_cpu_features() & SIMD_FEATURE_SSE2) == 0;
+}
+
+size_t SearchString(const uint8_t* haystack,
+                    size_t haystack_length,
+                    const uint8_t* needle,
+                    size_t needle_length,
+                    size_t start_index,
+                    bool is_forward) {
+  auto fallback = [&]() {
+    return nbytes::SearchString(haystack,
+                                haystack_length,
+                                needle,
+                                needle_length,
+                                start_index,
+                                is_forward);
+  };
+  if (needle_length == 0 || needle_length > kSimdSearchMaxNeedleLength ||
+      haystack_length < needle_length) {
+    return fallback();
+  }
+  const simd_kernel_selection_t* selection = get_simd_kernel_selection();
+  const simd_functions_t* simd = get_simd_functions();
+  const size_t last_start = haystack_length - needle_length;
+
+  if (!is_forward) {
+    if (!BeatsLibc(selection->find_last_byte)) return fallback();
+    // Find candidates by their first byte, from the last possible start down.
+    size_t end = std::min(start_index, last_start) + 1;
+    while (end > 0) {
+      const uint8_t* match = simd->find_last_byte(haystack, end, needle[0]);
+      if (match == nullptr) break;
+      if (memcmp(match + 1, needle + 1, needle_length - 1) == 0) {
+        return match - haystack;
+      }
+      end = match - haystack;
+    }
+    return haystack_length;
+  }
+
+  if (start_index > last_start) return haystack_length;
+  if (needle_length == 1) {
+    if (!BeatsLibc(selection->find_byte)) return fallback();
+    const uint8_t* match = simd->find_byte(
+        haystack + start_index, haystack_length - start_index, needle[0]);
+    return match != nullptr ? match - haystack : haystack_length;
+  }
+
+  if (selection->find_byte_pair == SIMD_SCALAR) return fallback();
+  const size_t distance = needle_length - 1;
+  for (size_t pos = start_index; pos <= last_start; pos++) {
+    const uint8_t* match = simd->find_byte_pair(haystack + pos,
+                                                last_start - pos + 1,
+                                                needle[0],
+                                                needle[distance],
+                                                distance);
+    if (match == nullptr) break;
+    pos = match - haystack;
+    if (memcmp(match + 1, needle + 1, needle_length - 2) == 0) return pos;
+  }
+  return haystack_length;
+}
+
+// Below these many bytes libc's inlined or unrolled small-size paths beat an
+// indirect call and the alignment prologue of the SIMD kernels.
+static constexpr size_t kSimdCopyBytesThreshold = 512;
+static constexpr size_t kSimdCompareBytesThreshold = 64;
+
+void CopyBytes(char* dst, const char* src, size_t nbytes) {
+  const uintptr_t d = reinterpret_cast<uintptr_t>(dst);
+  const uintptr_t s = reinterpret_cast<uintptr_t>(src);
+  if (nbytes >= KernelThreshold(get_simd_kernel_thresholds()->copy_bytes,
+                                kSimdCopyBytesThreshold) &&
+      (d + nbytes <= s || s + nbytes <= d) &&
+      BeatsLibc(get_simd_kernel_selection()->copy_bytes)) {
+    get_simd_functions()->copy_bytes(reinterpret_cast<uint8_t*>(dst),
+                                     reinterpret_cast<const uint8_t*>(src),
+                                     nbytes);
+    return;
+  }
+  if (nbytes > 0) memmove(dst, src, nbytes);
+}
+
+void FillBytes(char* dst, uint8_t value, size_t nbytes) {
+  if (nbytes >= KernelThreshold(get_simd_kernel_thresholds()->fill_bytes,
+                                kSimdCopyBytesThreshold) &&
+      BeatsLibc(get_simd_kernel_selection()->fill_bytes)) {
+    get_simd_functions()->fill_bytes(
+        reinterpret_cast<uint8_t*>(dst), value, nbytes);
+    return;
+  }
+  if (nbytes > 0) memset(dst, value, nbytes);
+}
+
+int CompareBytes(const char* a, const char* b, size_t nbytes) {
+  if (nbytes >= KernelThreshold(get_simd_kernel_thresholds()->compare_bytes,
+                                kSimdCompareBytesThreshold) &&
+      BeatsLibc(get_simd_kernel_selection()->compare_bytes)) {
+    return get_simd_functions()->compare_bytes(
+        reinterpret_cast<const uint8_t*>(a),
+        reinterpret_cast<const uint8_t*>(b),
+        nbytes);
+  }
+  return nbytes > 0 ? memcmp(a, b, nbytes) : 0;
+}
+
 int WriteFileSync(const char* path, uv_buf_t buf) {
   return WriteFileSync(path, &buf, 1);
 }
@@ -553,6 +553,58 @@ class ArrayBufferViewContents {
   bool was_detached_ = false;
 };
 
+// Keeps freed blocks of kSize bytes for reuse on the same thread, for objects
+// that are allocated and freed at high rates, such as request wraps. Classes
+// opt in with NODE_POOLED_ALLOCATION(), which allocates blocks of any other
+// size, for example those of subclasses, with the global operator new.
+template <size_t kSize>
+class ThreadLocalFreeList {
+ public:
+#if defined(__SANITIZE_ADDRESS__)
+  // Let the sanitizer see every use after free.
+  static constexpr size_t kMaxFree = 0;
+#else
+  static constexpr size_t kMaxFree = 1024;
+#endif
+
+  static void* Allocate(size_t size) {
+    std::vector<void*>& blocks = Blocks();
+    if (size != kSize || blocks.empty()) return ::operator new(size);
+    void* block = blocks.back();
+    blocks.pop_back();
+    return block;
+  }
+
+  static void Free(void* block, size_t size) {
+    std::vector<void*>& blocks = Blocks();
+    if (size != kSize || blocks.size() >= kMaxFree) {
+      return ::operator delete(block);
+    }
+    blocks.push_back(block);
+  }
+
+ private:
+  struct BlockList {
+    ~BlockList() {
+      for (void* block : blocks) ::operator delete(block);
+    }
+    std::vector<void*> blocks;
+  };
+
+  static std::vector<void*>& Blocks() {
+    thread_local BlockList list;
+    return list.blocks;
+  }
+};
+
+#define NODE_POOLED_ALLOCATION(Klass)                                          \
+  static void* operator new(size_t size) {                                     \
+    return node::ThreadLocalFreeList<sizeof(Klass)>::Allocate(size);           \
+  }                                                                            \
+  static void operator delete(void* block, size_t size) {                      \
+    node::ThreadLocalFreeList<sizeof(Klass)>::Free(block, size);               \
+  }
+
 class Utf8Value : public MaybeStackBuffer<char> {
  public:
   explicit Utf8Value(v8::Isolate* isolate, v8::Local<v8::Value> value);
@@ -779,6 +831,41 @@ constexpr inline bool IsBigEndian() {
 static_assert(IsLittleEndian() || IsBigEndian(),
               "Node.js does not support mixed-endian systems");
 
+// Drop-in replacements for nbytes::SwapBytes16/32/64: reverse the byte order
+// of every element of data in place, or return false if nbytes is not a
+// multiple of the element size. Large inputs go through the SIMD kernels
+// (SSE2, MMX, AltiVec) when the CPU has them.
+bool SwapBytes16(char* data, size_t nbytes);
+bool SwapBytes32(char* data, size_t nbytes);
+bool SwapBytes64(char* data, size_t nbytes);
+
+// Drop-in replacement for nbytes::HexEncode: writes the lowercase hex digits
+// of src to dst, which must have room for 2 * slen bytes, and returns
+// 2 * slen. Goes through the hex_encode SIMD kernel when the CPU has a vector
+// implementation of it.
+size_t HexEncode(const char* src, size_t slen, char* dst, size_t dlen);
+
+// Drop-in replacement for nbytes::SearchString on one-byte strings: the
+// position of the first (is_forward) or last match of needle in haystack that
+// starts at or after (before) start_index, or haystack_length if there is
+// none. Needles of up to 32 bytes are searched with the find_byte_pair and
+// find_last_byte SIMD kernels when the CPU has vector versions of them.
+size_t SearchString(const uint8_t* haystack,
+                    size_t haystack_length,
+                    const uint8_t* needle,
+                    size_t needle_length,
+                    size_t start_index,
+                    bool is_forward);
+
+// Drop-in replacements for memmove, memset and memcmp on Buffer contents.
+// Large inputs go through the copy_bytes, fill_bytes and compare_bytes SIMD
+// kernels on MMX and AltiVec CPUs, where libc is not vectorized; ranges that
+// overlap are always copied by memmove. Any of the pointers may be null
+// when nbytes is 0.
+void CopyBytes(char* dst, const char* src, size_t nbytes);
+void FillBytes(char* dst, uint8_t value, size_t nbytes);
+int CompareBytes(const char* a, const char* b, size_t nbytes);
+
 class SlicedArguments : public MaybeStackBuffer<v8::Local<v8::Value>> {
  public:
   inline explicit SlicedArguments(
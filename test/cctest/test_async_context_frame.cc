@@ -0,0 +1,67 @@
+#include "async_context_frame.h"
+#include "gtest/gtest.h"
+#include "node_test_fixture.h"
+
+#include <vector>
+
+using node::async_context_frame::DeleteStore;
+using node::async_context_frame::GetStore;
+using node::async_context_frame::SetStore;
+using v8::Context;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Local;
+using v8::Object;
+using v8::Undefined;
+using v8::Value;
+
+class AsyncContextFrameTest : public EnvironmentTestFixture {
+ protected:
+  // Returns the store of key in frame as an integer, or -1 if there is none.
+  int64_t Get(Local<Context> context, Local<Value> frame, Local<Object> key) {
+    Local<Value> value = GetStore(context, frame, key).ToLocalChecked();
+    if (value->IsUndefined()) return -1;
+    return value.As<Integer>()->Value();
+  }
+};
+
+TEST_F(AsyncContextFrameTest, Stores) {
+  const HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  Local<Context> context = isolate_->GetCurrentContext();
+
+  // Enough keys that some of them share slots in the first levels.
+  constexpr int kKeys = 2000;
+  std::vector<Local<Object>> keys;
+  Local<Value> frame = Undefined(isolate_);
+  for (int i = 0; i < kKeys; i++) {
+    keys.push_back(Object::New(isolate_));
+    frame = SetStore(context, frame, keys[i], Integer::New(isolate_, i))
+                .ToLocalChecked();
+  }
+  for (int i = 0; i < kKeys; i++) EXPECT_EQ(Get(context, frame, keys[i]), i);
+  EXPECT_EQ(Get(context, frame, Object::New(isolate_)), -1);
+
+  // Older frames are not changed by setting or deleting stores.
+  Local<Value> old_frame = frame;
+  frame = SetStore(context, frame, keys[0], Integer::New(isolate_, -2))
+              .ToLocalChecked();
+  EXPECT_EQ(Get(context, frame, keys[0]), -2);
+  EXPECT_EQ(Get(context, old_frame, keys[0]), 0);
+
+  for (int i = 0; i < kKeys; i += 2) {
+    frame = DeleteStore(context, frame, keys[i]).ToLocalChecked();
+  }
+  for (int i = 0; i < kKeys; i++) {
+    EXPECT_EQ(Get(context, frame, keys[i]), i % 2 == 0 ? -1 : i);
+    EXPECT_EQ(Get(context, old_frame, keys[i]), i);
+  }
+
+  // Deleting a key that is not there returns the same frame.
+  EXPECT_EQ(DeleteStore(context, frame, keys[0]).ToLocalChecked(), frame);
+  for (int i = 1; i < kKeys; i += 2) {
+    frame = DeleteStore(context, frame, keys[i]).ToLocalChecked();
+  }
+  EXPECT_TRUE(frame->IsUndefined());
+}
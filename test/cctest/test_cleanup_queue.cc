@@ -0,0 +1,65 @@
+#include <vector>
+#include "cleanup_queue-inl.h"
+#include "gtest/gtest.h"
+
+using node::CleanupQueue;
+
+namespace {
+
+struct Hook {
+  std::vector<int>* calls;
+  int id;
+};
+
+void RunHook(void* arg) {
+  Hook* hook = static_cast<Hook*>(arg);
+  hook->calls->push_back(hook->id);
+}
+
+}  // namespace
+
+// Test that Drain() runs every hook, the most recently added one first
+TEST(CleanupQueue, DrainRunsAllInReverseOrder) {
+  std::vector<int> calls;
+  Hook a{&calls, 1}, b{&calls, 2}, c{&calls, 3};
+  CleanupQueue queue;
+  queue.Add(RunHook, &a);
+  queue.Add(RunHook, &b, true);
+  queue.Add(RunHook, &c);
+
+  queue.Drain();
+  EXPECT_EQ(calls, (std::vector<int>{3, 2, 1}));
+  EXPECT_TRUE(queue.empty());
+}
+
+// Test that DrainEssential() only runs and removes the essential hooks
+TEST(CleanupQueue, DrainEssentialSkipsOthers) {
+  std::vector<int> calls;
+  Hook a{&calls, 1}, b{&calls, 2}, c{&calls, 3}, d{&calls, 4};
+  CleanupQueue queue;
+  queue.Add(RunHook, &a, true);
+  queue.Add(RunHook, &b);
+  queue.Add(RunHook, &c, true);
+  queue.Add(RunHook, &d);
+
+  queue.DrainEssential();
+  EXPECT_EQ(calls, (std::vector<int>{3, 1}));
+  EXPECT_FALSE(queue.empty());
+
+  calls.clear();
+  queue.Drain();
+  EXPECT_EQ(calls, (std::vector<int>{4, 2}));
+}
+
+// Test that a removed essential hook does not run
+TEST(CleanupQueue, DrainEssentialSkipsRemoved) {
+  std::vector<int> calls;
+  Hook a{&calls, 1};
+  CleanupQueue queue;
+  queue.Add(RunHook, &a, true);
+  queue.Remove(RunHook, &a);
+
+  queue.DrainEssential();
+  EXPECT_TRUE(calls.empty());
+  EXPECT_TRUE(queue.empty());
+}
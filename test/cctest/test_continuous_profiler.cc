@@ -0,0 +1,187 @@
+#include "node_continuous_profiler.h"
+#include "node_test_fixture.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "v8-profiler.h"
+
+using node::profiler::ContinuousCpuProfiler;
+using node::profiler::ContinuousHeapProfiler;
+
+namespace {
+
+struct Field {
+  uint32_t number;
+  uint64_t varint = 0;
+  std::string bytes;
+};
+
+uint64_t ReadVarint(const std::string& data, size_t* pos) {
+  uint64_t value = 0;
+  for (int shift = 0; *pos < data.size(); shift += 7) {
+    uint8_t byte = data[(*pos)++];
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) break;
+  }
+  return value;
+}
+
+// Decodes the varint and length-delimited fields of a message, the only
+// wire types of a pprof profile.
+std::vector<Field> Parse(const std::string& data) {
+  std::vector<Field> fields;
+  size_t pos = 0;
+  while (pos < data.size()) {
+    uint64_t tag = ReadVarint(data, &pos);
+    Field field{static_cast<uint32_t>(tag >> 3)};
+    if ((tag & 7) == 0) {
+      field.varint = ReadVarint(data, &pos);
+    } else if ((tag & 7) == 2) {
+      size_t size = ReadVarint(data, &pos);
+      EXPECT_LE(pos + size, data.size());
+      field.bytes = data.substr(pos, size);
+      pos += size;
+    } else {
+      ADD_FAILURE() << "unexpected wire type " << (tag & 7);
+      break;
+    }
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+}  // namespace
+
+class ContinuousProfilerTest : public NodeTestFixture {};
+
+TEST_F(ContinuousProfilerTest, Serialize) {
+  const v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = v8::Context::New(isolate_);
+  v8::Context::Scope context_scope(context);
+
+  v8::CpuProfiler* profiler = v8::CpuProfiler::New(isolate_);
+  v8::CpuProfilingResult result = profiler->Start(v8::CpuProfilingOptions(
+      v8::kLeafNodeLineNumbers, v8::CpuProfilingOptions::kNoSampleLimit, 100));
+  ASSERT_EQ(result.status, v8::CpuProfilingStatus::kStarted);
+  const char* source = "function spin() {\n"
+                       "  let x = 0;\n"
+                       "  const end = Date.now() + 100;\n"
+                       "  while (Date.now() < end) x++;\n"
+                       "  return x;\n"
+                       "}\n"
+                       "spin();\n";
+  v8::Local<v8::Script> script =
+      v8::Script::Compile(
+          context,
+          v8::String::NewFromUtf8(isolate_, source).ToLocalChecked())
+          .ToLocalChecked();
+  script->Run(context).ToLocalChecked();
+  v8::CpuProfile* profile = profiler->Stop(result.id);
+  ASSERT_NE(profile, nullptr);
+
+  std::vector<Field> fields =
+      Parse(ContinuousCpuProfiler::Serialize(profile, 123, 100));
+  profile->Delete();
+  profiler->Dispose();
+
+  std::vector<std::string> strings;
+  size_t sample_types = 0, samples = 0, functions = 0;
+  for (const Field& field : fields) {
+    switch (field.number) {
+      case 1:
+        sample_types++;
+        break;
+      case 2:
+        samples++;
+        break;
+      case 5:
+        functions++;
+        break;
+      case 6:
+        strings.push_back(field.bytes);
+        break;
+      case 9:
+        EXPECT_EQ(field.varint, 123u);
+        break;
+      case 12:
+        EXPECT_EQ(field.varint, 100000u);
+        break;
+    }
+  }
+  EXPECT_EQ(sample_types, 2u);
+  EXPECT_GT(samples, 0u);
+  EXPECT_GT(functions, 0u);
+  ASSERT_FALSE(strings.empty());
+  EXPECT_EQ(strings[0], "");
+  for (const char* string :
+       {"samples", "count", "cpu", "nanoseconds", "spin"}) {
+    EXPECT_NE(std::find(strings.begin(), strings.end(), string), strings.end())
+        << string;
+  }
+}
+
+TEST_F(ContinuousProfilerTest, SerializeHeap) {
+  const v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = v8::Context::New(isolate_);
+  v8::Context::Scope context_scope(context);
+
+  v8::HeapProfiler* heap_profiler = isolate_->GetHeapProfiler();
+  ASSERT_TRUE(heap_profiler->StartSamplingHeapProfiler(64, 16));
+  const char* source = "function allocate() {\n"
+                       "  const arrays = [];\n"
+                       "  for (let i = 0; i < 1000; i++)\n"
+                       "    arrays.push(new Array(100).fill(i));\n"
+                       "  return arrays;\n"
+                       "}\n"
+                       "globalThis.kept = allocate();\n";
+  v8::Local<v8::Script> script =
+      v8::Script::Compile(
+          context,
+          v8::String::NewFromUtf8(isolate_, source).ToLocalChecked())
+          .ToLocalChecked();
+  script->Run(context).ToLocalChecked();
+  std::unique_ptr<v8::AllocationProfile> profile(
+      heap_profiler->GetAllocationProfile());
+  ASSERT_TRUE(profile);
+
+  std::vector<Field> fields = Parse(ContinuousHeapProfiler::Serialize(
+      isolate_, profile.get(), false, 2000, 1000, 64));
+  profile.reset();
+  heap_profiler->StopSamplingHeapProfiler();
+
+  std::vector<std::string> strings;
+  size_t sample_types = 0, samples = 0;
+  for (const Field& field : fields) {
+    switch (field.number) {
+      case 1:
+        sample_types++;
+        break;
+      case 2:
+        samples++;
+        break;
+      case 6:
+        strings.push_back(field.bytes);
+        break;
+      case 9:
+        EXPECT_EQ(field.varint, 1000u);
+        break;
+      case 10:
+        EXPECT_EQ(field.varint, 1000u);
+        break;
+      case 12:
+        EXPECT_EQ(field.varint, 64u);
+        break;
+    }
+  }
+  EXPECT_EQ(sample_types, 2u);
+  EXPECT_GT(samples, 0u);
+  for (const char* string :
+       {"inuse_objects", "inuse_space", "space", "bytes", "allocate"}) {
+    EXPECT_NE(std::find(strings.begin(), strings.end(), string), strings.end())
+        << string;
+  }
+}
@@ -4,8 +4,14 @@
 #include <util-inl.h>
 #include <v8.h>
 #include <memory>
+#include <string>
 #include <vector>
 
+#ifndef _WIN32
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
 using node::DataQueue;
 using v8::ArrayBuffer;
 using v8::BackingStore;
@@ -658,3 +664,212 @@ TEST(DataQueue, DataQueueEntry) {
   CHECK(!pullIsPending);
   CHECK_EQ(status, node::bob::STATUS_CONTINUE);
 }
+
+TEST(DataQueue, TransformEntry) {
+  // Inverts every byte and appends a single trailer byte at the end.
+  class InvertTransform final : public DataQueue::Transform {
+   public:
+    size_t max_overhead() const override { return 1; }
+
+    bool Update(const uint8_t* data,
+                size_t len,
+                std::vector<uint8_t>* out) override {
+      for (size_t n = 0; n < len; n++) out->push_back(~data[n]);
+      return true;
+    }
+
+    bool Finish(std::vector<uint8_t>* out) override {
+      out->push_back('!');
+      return true;
+    }
+
+    std::optional<uint64_t> size(
+        std::optional<uint64_t> input_size) const override {
+      if (!input_size.has_value()) return std::nullopt;
+      return input_size.value() + 1;
+    }
+
+    SET_NO_MEMORY_INFO()
+    SET_MEMORY_INFO_NAME(InvertTransform)
+    SET_SELF_SIZE(InvertTransform)
+  };
+
+  char buffer1[] = "hello world";
+  char buffer2[] = "what fun this is";
+  size_t len1 = strlen(buffer1);
+  size_t len2 = strlen(buffer2);
+
+  std::shared_ptr<BackingStore> store1 = ArrayBuffer::NewBackingStore(
+      &buffer1, len1, [](void*, size_t, void*) {}, nullptr);
+
+  std::shared_ptr<BackingStore> store2 = ArrayBuffer::NewBackingStore(
+      &buffer2, len2, [](void*, size_t, void*) {}, nullptr);
+
+  std::vector<std::unique_ptr<DataQueue::Entry>> list;
+  list.push_back(
+      DataQueue::CreateInMemoryEntryFromBackingStore(store1, 0, len1));
+  list.push_back(
+      DataQueue::CreateInMemoryEntryFromBackingStore(store2, 0, len2));
+
+  std::shared_ptr<DataQueue> data_queue =
+      DataQueue::CreateIdempotent(std::move(list));
+  CHECK_NOT_NULL(data_queue);
+
+  std::unique_ptr<DataQueue::Entry> entry = DataQueue::CreateTransformEntry(
+      data_queue, std::make_unique<InvertTransform>());
+
+  // The entry can only be read once, so it is not idempotent and cannot be
+  // sliced, but it knows its size.
+  CHECK(!entry->is_idempotent());
+  CHECK_NULL(entry->slice(1));
+  CHECK_EQ(entry->size().value(), len1 + len2 + 1);
+
+  std::shared_ptr<DataQueue> data_queue2 = DataQueue::Create();
+  CHECK(data_queue2->append(std::move(entry)).value());
+  data_queue2->cap();
+
+  std::shared_ptr<DataQueue::Reader> reader = data_queue2->get_reader();
+  CHECK_NOT_NULL(reader);
+
+  std::string expected = std::string(buffer1) + buffer2;
+  for (char& c : expected) c = ~c;
+  expected += '!';
+
+  std::string output;
+  int status = node::bob::STATUS_CONTINUE;
+  while (status != node::bob::STATUS_EOS) {
+    status = reader->Pull(
+        [&](int status, const DataQueue::Vec* vecs, size_t count, auto done) {
+          for (size_t n = 0; n < count; n++) {
+            output.append(reinterpret_cast<char*>(vecs[n].base), vecs[n].len);
+          }
+          if (done) std::move(done)(0);
+        },
+        node::bob::OPTIONS_SYNC,
+        nullptr,
+        0);
+    CHECK_GE(status, 0);
+  }
+
+  CHECK_EQ(output, expected);
+
+  // The source data queue is untouched.
+  std::shared_ptr<DataQueue::Reader> reader2 = data_queue->get_reader();
+  CHECK_NOT_NULL(reader2);
+  status = reader2->Pull(
+      [&](int status, const DataQueue::Vec* vecs, size_t count, auto done) {
+        CHECK_EQ(count, 1);
+        CHECK_EQ(memcmp(vecs[0].base, buffer1, len1), 0);
+      },
+      node::bob::OPTIONS_SYNC,
+      nullptr,
+      0);
+  CHECK_EQ(status, node::bob::STATUS_CONTINUE);
+}
+
+#ifndef _WIN32
+TEST(DataQueue, MappedFileEntry) {
+  char path[] = "/tmp/node-dataqueue-XXXXXX";
+  int fd = mkstemp(path);
+  CHECK_GE(fd, 0);
+  const std::string contents = "hello world, what fun this is";
+  CHECK_EQ(write(fd, contents.data(), contents.size()),
+           static_cast<ssize_t>(contents.size()));
+  close(fd);
+  auto unlink_file = node::OnScopeLeave([&] { unlink(path); });
+
+  std::unique_ptr<DataQueue::Entry> entry =
+      DataQueue::CreateMappedFileEntry(path);
+  CHECK_NOT_NULL(entry);
+  CHECK(entry->is_idempotent());
+  CHECK_EQ(entry->size().value(), contents.size());
+
+  // Slices share the mapping, and further slices are relative to them.
+  std::unique_ptr<DataQueue::Entry> slice = entry->slice(6, 20);
+  CHECK_EQ(slice->size().value(), 14);
+  std::unique_ptr<DataQueue::Entry> slice2 = slice->slice(6);
+  CHECK_EQ(slice2->size().value(), 8);
+
+  std::vector<std::unique_ptr<DataQueue::Entry>> list;
+  list.push_back(std::move(slice));
+  std::shared_ptr<DataQueue> data_queue =
+      DataQueue::CreateIdempotent(std::move(list));
+  CHECK_NOT_NULL(data_queue);
+
+  const auto read_all = [](std::shared_ptr<DataQueue::Reader> reader) {
+    std::string output;
+    int status = node::bob::STATUS_CONTINUE;
+    while (status != node::bob::STATUS_EOS) {
+      status = reader->Pull(
+          [&](int status, const DataQueue::Vec* vecs, size_t count, auto done) {
+            for (size_t n = 0; n < count; n++) {
+              output.append(reinterpret_cast<char*>(vecs[n].base),
+                            vecs[n].len);
+            }
+            if (done) std::move(done)(0);
+          },
+          node::bob::OPTIONS_SYNC,
+          nullptr,
+          0);
+      CHECK_GE(status, 0);
+    }
+    return output;
+  };
+
+  CHECK_EQ(read_all(data_queue->get_reader()), contents.substr(6, 14));
+  CHECK_EQ(read_all(data_queue->get_reader()), contents.substr(6, 14));
+
+  // The backing store is a private view: writing to it changes neither the
+  // queue nor the file.
+  std::unique_ptr<BackingStore> store = data_queue->ToBackingStore();
+  CHECK_NOT_NULL(store);
+  CHECK_EQ(store->ByteLength(), 14);
+  char* data = static_cast<char*>(store->Data());
+  CHECK_EQ(std::string(data, 14), contents.substr(6, 14));
+  data[0] = 'W';
+  CHECK_EQ(read_all(data_queue->get_reader()), contents.substr(6, 14));
+
+  // Files that cannot be mapped are left to CreateFdEntry().
+  CHECK_NULL(DataQueue::CreateMappedFileEntry("/tmp"));
+  CHECK_NULL(DataQueue::CreateMappedFileEntry("/nonexistent/file"));
+}
+
+TEST(DataQueue, TempFileEntry) {
+  std::string contents(3 * 1024 * 1024 + 17, 'x');
+  for (size_t n = 0; n < contents.size(); n++) contents[n] = 'a' + n % 26;
+
+  std::unique_ptr<DataQueue::Entry> entry = DataQueue::CreateTempFileEntry(
+      reinterpret_cast<const uint8_t*>(contents.data()), contents.size());
+  CHECK_NOT_NULL(entry);
+  CHECK(entry->is_idempotent());
+  CHECK_EQ(entry->size().value(), contents.size());
+
+  std::vector<std::unique_ptr<DataQueue::Entry>> list;
+  list.push_back(entry->slice(5));
+  entry.reset();
+  std::shared_ptr<DataQueue> data_queue =
+      DataQueue::CreateIdempotent(std::move(list));
+  CHECK_NOT_NULL(data_queue);
+
+  // The data outlives the original entry and is read back in chunks.
+  std::shared_ptr<DataQueue::Reader> reader = data_queue->get_reader();
+  std::string output;
+  int status = node::bob::STATUS_CONTINUE;
+  while (status != node::bob::STATUS_EOS) {
+    status = reader->Pull(
+        [&](int status, const DataQueue::Vec* vecs, size_t count, auto done) {
+          for (size_t n = 0; n < count; n++) {
+            output.append(reinterpret_cast<char*>(vecs[n].base), vecs[n].len);
+          }
+          if (done) std::move(done)(0);
+        },
+        node::bob::OPTIONS_SYNC,
+        nullptr,
+        0);
+    CHECK_GE(status, 0);
+  }
+  CHECK_EQ(output, contents.substr(5));
+
+  CHECK_NULL(DataQueue::CreateTempFileEntry(nullptr, 0));
+}
+#endif  // _WIN32
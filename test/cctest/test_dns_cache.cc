@@ -0,0 +1,102 @@
+#include "node_dns_cache.h"
+#include "uv.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using node::cares_wrap::DnsCache;
+
+namespace {
+
+DnsCache::Result Addresses(const char* ip) {
+  DnsCache::Result result;
+  result.addresses.push_back({AF_INET, ip});
+  return result;
+}
+
+DnsCache::Result Failure(int status) {
+  DnsCache::Result result;
+  result.status = status;
+  return result;
+}
+
+}  // namespace
+
+TEST(DnsCacheTest, Expiry) {
+  DnsCache cache({1000, 100, 0});
+  const std::string key = DnsCache::Key("example.com", 0, 0);
+  DnsCache::Result result;
+
+  EXPECT_EQ(cache.Find(key, &result, 0), DnsCache::Lookup::kMiss);
+  cache.Store(key, Addresses("192.0.2.1"), 0);
+  ASSERT_EQ(cache.Find(key, &result, 999), DnsCache::Lookup::kHit);
+  ASSERT_EQ(result.addresses.size(), 1u);
+  EXPECT_EQ(result.addresses[0].ip, "192.0.2.1");
+  EXPECT_EQ(cache.Find(key, &result, 1000), DnsCache::Lookup::kMiss);
+  EXPECT_EQ(cache.size(), 0u);
+
+  // The family and flags are part of the key.
+  cache.Store(key, Addresses("192.0.2.1"), 0);
+  EXPECT_EQ(cache.Find(DnsCache::Key("example.com", 4, 0), &result, 0),
+            DnsCache::Lookup::kMiss);
+  EXPECT_EQ(cache.Find(DnsCache::Key("example.com", 0, 1), &result, 0),
+            DnsCache::Lookup::kMiss);
+}
+
+TEST(DnsCacheTest, NegativeAnswers) {
+  DnsCache cache({1000, 100, 5000});
+  const std::string key = DnsCache::Key("nonexistent.invalid", 0, 0);
+  DnsCache::Result result;
+
+  cache.Store(key, Failure(UV_EAI_NONAME), 0);
+  ASSERT_EQ(cache.Find(key, &result, 99), DnsCache::Lookup::kHit);
+  EXPECT_EQ(result.status, UV_EAI_NONAME);
+  // Failures are never served stale.
+  EXPECT_EQ(cache.Find(key, &result, 100), DnsCache::Lookup::kMiss);
+
+  // Transient failures are not cached.
+  cache.Store(key, Failure(UV_EAI_AGAIN), 0);
+  EXPECT_EQ(cache.Find(key, &result, 0), DnsCache::Lookup::kMiss);
+}
+
+TEST(DnsCacheTest, StaleWhileRevalidate) {
+  DnsCache cache({1000, 100, 500});
+  const std::string key = DnsCache::Key("example.com", 0, 0);
+  DnsCache::Result result;
+
+  cache.Store(key, Addresses("192.0.2.1"), 0);
+  // Only the first caller after expiry is asked to refresh.
+  EXPECT_EQ(cache.Find(key, &result, 1000), DnsCache::Lookup::kRefresh);
+  EXPECT_EQ(result.addresses[0].ip, "192.0.2.1");
+  EXPECT_EQ(cache.Find(key, &result, 1001), DnsCache::Lookup::kHit);
+
+  // A failed refresh keeps the stale entry and lets the next caller retry.
+  cache.Store(key, Failure(UV_EAI_AGAIN), 1002);
+  EXPECT_EQ(cache.Find(key, &result, 1003), DnsCache::Lookup::kRefresh);
+  EXPECT_EQ(result.addresses[0].ip, "192.0.2.1");
+
+  cache.Store(key, Addresses("192.0.2.2"), 1004);
+  ASSERT_EQ(cache.Find(key, &result, 1005), DnsCache::Lookup::kHit);
+  EXPECT_EQ(result.addresses[0].ip, "192.0.2.2");
+
+  EXPECT_EQ(cache.Find(key, &result, 2004 + 500), DnsCache::Lookup::kMiss);
+}
+
+TEST(DnsCacheTest, Eviction) {
+  DnsCache cache({1000, 100, 0});
+  DnsCache::Result result;
+  for (size_t i = 0; i < DnsCache::kMaxEntries; i++) {
+    cache.Store(DnsCache::Key(std::to_string(i), 0, 0), Addresses("::1"), i);
+  }
+  EXPECT_EQ(cache.size(), DnsCache::kMaxEntries);
+
+  cache.Store(DnsCache::Key("new", 0, 0), Addresses("::1"), 10);
+  EXPECT_EQ(cache.size(), DnsCache::kMaxEntries);
+  EXPECT_EQ(cache.Find(DnsCache::Key("0", 0, 0), &result, 10),
+            DnsCache::Lookup::kMiss);
+  EXPECT_EQ(cache.Find(DnsCache::Key("1", 0, 0), &result, 10),
+            DnsCache::Lookup::kHit);
+  EXPECT_EQ(cache.Find(DnsCache::Key("new", 0, 0), &result, 10),
+            DnsCache::Lookup::kHit);
+}
@@ -619,6 +619,41 @@ TEST_F(EnvironmentTest, SetImmediateMicrotasks) {
   EXPECT_EQ(called, 1);
 }
 
+TEST_F(EnvironmentTest, SetImmediateBudget) {
+  int called = 0;
+
+  {
+    const v8::HandleScope handle_scope(isolate_);
+    const Argv argv;
+    Env env {handle_scope, argv};
+
+    node::LoadEnvironment(*env,
+                          [&](const node::StartExecutionCallbackInfo& info)
+                              -> v8::MaybeLocal<v8::Value> {
+      return v8::Object::New(isolate_);
+    });
+
+    (*env)->options()->native_immediate_budget = 1;
+    for (int i = 0; i < 3; i++) {
+      (*env)->SetImmediate([&](node::Environment* env_arg) {
+        called++;
+      }, node::CallbackFlags::kRefed);
+    }
+
+    // One callback per iteration, the rest is carried over.
+    uv_run(&current_loop, UV_RUN_ONCE);
+    EXPECT_EQ(called, 1);
+    EXPECT_EQ((*env)->native_immediate_budget_stats().exhausted, 1u);
+    EXPECT_EQ((*env)->native_immediate_budget_stats().deferred, 2u);
+
+    uv_run(&current_loop, UV_RUN_DEFAULT);
+    EXPECT_EQ(called, 3);
+    EXPECT_EQ((*env)->native_immediate_budget_stats().exhausted, 2u);
+  }
+
+  EXPECT_EQ(called, 3);
+}
+
 #ifndef _WIN32  // No SIGINT on Windows.
 TEST_F(NodeZeroIsolateTestFixture, CtrlCWithOnlySafeTerminationTest) {
   // Allocate and initialize Isolate.
@@ -0,0 +1,38 @@
+#include "histogram-inl.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::Histogram;
+
+TEST(HistogramTest, ConcurrentRecord) {
+  constexpr int kThreads = 4;
+  constexpr int kValues = 10000;
+  Histogram histogram(Histogram::Options{1, 1000000});
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.emplace_back([&histogram] {
+      for (int value = 1; value <= kValues; value++) {
+        histogram.Record(value);
+      }
+      histogram.Record(2000000);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  EXPECT_EQ(histogram.Count(), static_cast<size_t>(kThreads * kValues));
+  EXPECT_EQ(histogram.Exceeds(), static_cast<size_t>(kThreads));
+  EXPECT_EQ(histogram.Min(), 1);
+  EXPECT_EQ(histogram.Max(), histogram.Percentile(100));
+  EXPECT_GE(histogram.Max(), kValues);
+
+  Histogram sum(Histogram::Options{1, 1000000});
+  sum.Record(1);
+  EXPECT_EQ(sum.Add(histogram), 0);
+  EXPECT_EQ(sum.Count(), static_cast<size_t>(kThreads * kValues + 1));
+  EXPECT_EQ(sum.Exceeds(), static_cast<size_t>(kThreads));
+  EXPECT_EQ(sum.Max(), histogram.Max());
+}
@@ -121,6 +121,11 @@ class TestInspectorDelegate : public InspectorSocket::Delegate {
     frames.push(buffer);
   }
 
+  void OnWsBinaryFrame(const std::vector<char>& buffer) override {
+    binary_frames++;
+    OnWsFrame(buffer);
+  }
+
   void SetDelegate(delegate_fn d) {
     handshake_delegate_ = d;
   }
@@ -129,8 +134,8 @@ class TestInspectorDelegate : public InspectorSocket::Delegate {
     socket_ = std::move(inspector);
   }
 
-  void Write(const char* buf, size_t len) {
-    socket_->Write(buf, len);
+  void Write(const char* buf, size_t len, bool binary = false) {
+    socket_->Write(buf, len, binary);
   }
 
   void ExpectReadError() {
@@ -170,6 +175,7 @@ class TestInspectorDelegate : public InspectorSocket::Delegate {
   std::string last_path;  // NOLINT(runtime/string)
   inspector_handshake_event last_event;
   int handshake_events;
+  int binary_frames = 0;
   std::queue<std::vector<char>> frames;
 
  private:
@@ -409,6 +415,31 @@ TEST_F(InspectorSocketTest, ReadsAndWritesInspectorMessage) {
                          reinterpret_cast<uv_handle_t*>(&client_socket)));
 }
 
+TEST_F(InspectorSocketTest, ReadsAndWritesBinaryMessage) {
+  ASSERT_TRUE(connected);
+  do_write(const_cast<char*>(HANDSHAKE_REQ), sizeof(HANDSHAKE_REQ) - 1);
+  SPIN_WHILE(!delegate->inspector_ready);
+  expect_handshake();
+
+  const char SERVER_MESSAGE[] = "abcd";
+  const char CLIENT_FRAME[] = {'\x82', '\x04', 'a', 'b', 'c', 'd'};
+  delegate->Write(SERVER_MESSAGE, sizeof(SERVER_MESSAGE) - 1, true);
+  expect_on_client(CLIENT_FRAME, sizeof(CLIENT_FRAME));
+
+  const char SERVER_FRAME[] = {'\x82', '\x84', '\x7F', '\xC2', '\x66',
+                               '\x31', '\x4E', '\xF0', '\x55', '\x05'};
+  const char CLIENT_MESSAGE[] = "1234";
+  do_write(SERVER_FRAME, sizeof(SERVER_FRAME));
+  delegate->ExpectData(CLIENT_MESSAGE, sizeof(CLIENT_MESSAGE) - 1);
+  EXPECT_EQ(1, delegate->binary_frames);
+
+  const char CLIENT_CLOSE_FRAME[] = {'\x88', '\x80', '\x2D',
+                                     '\x0E', '\x1E', '\xFA'};
+  const char SERVER_CLOSE_FRAME[] = {'\x88', '\x00'};
+  do_write(CLIENT_CLOSE_FRAME, sizeof(CLIENT_CLOSE_FRAME));
+  expect_on_client(SERVER_CLOSE_FRAME, sizeof(SERVER_CLOSE_FRAME));
+}
+
 TEST_F(InspectorSocketTest, BufferEdgeCases) {
   do_write(const_cast<char*>(HANDSHAKE_REQ), sizeof(HANDSHAKE_REQ) - 1);
   expect_handshake();
@@ -0,0 +1,83 @@
+#include "module_prefetch.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using node::loader::ScanModuleImports;
+using node::loader::ScanRequireCalls;
+using Specifiers = std::vector<std::string>;
+
+TEST(ModulePrefetchTest, ScanImports) {
+  EXPECT_EQ(ScanModuleImports("import a from './a.js';\n"
+                              "import * as b from \"./b.mjs\";\n"
+                              "import { c, d as e } from '../c.js';\n"
+                              "import f, { g } from 'g';\n"
+                              "import './side-effect.js';\n"
+                              "import { \"h-i\" as hi } from './h.js';\n"
+                              "export * from './j.js';\n"
+                              "export * as k from './k.js';\n"
+                              "export { l } from './l.js';\n"
+                              "const m = await import('./m.js');\n"
+                              "import('./n.js', { with: {} });\n"),
+            (Specifiers{"./a.js",
+                        "./b.mjs",
+                        "../c.js",
+                        "g",
+                        "./side-effect.js",
+                        "./h.js",
+                        "./j.js",
+                        "./k.js",
+                        "./l.js",
+                        "./m.js",
+                        "./n.js"}));
+
+  // Bindings and no specifier.
+  EXPECT_EQ(ScanModuleImports("export const from = 'x';\n"
+                              "export { a, b };\n"
+                              "export default function f() {}\n"
+                              "const url = import.meta.url;\n"
+                              "import(specifier);\n"
+                              "obj.import('./no.js');\n"),
+            Specifiers{});
+}
+
+TEST(ModulePrefetchTest, ScanSkipsNonCode) {
+  EXPECT_EQ(ScanModuleImports("// import a from './comment.js';\n"
+                              "/* import b from './block.js'; */\n"
+                              "const s = \"import c from './string.js'\";\n"
+                              "const t = `import d from './template.js'"
+                              " ${ `${'}'}` } import e from './e.js'`;\n"
+                              "const r = /import f from '.\\/regexp.js'/g;\n"
+                              "const q = a / 2; import g from './g.js';\n"
+                              "const esc = import('./\\u0061.js');\n"),
+            Specifiers{"./g.js"});
+
+  // Unterminated constructs do not read past the end.
+  EXPECT_EQ(ScanModuleImports("import a from './a.js'; `${"),
+            Specifiers{"./a.js"});
+  EXPECT_EQ(ScanModuleImports("import a from '"), Specifiers{});
+  EXPECT_EQ(ScanModuleImports("/* import"), Specifiers{});
+}
+
+TEST(ModulePrefetchTest, ScanRequireCalls) {
+  bool balanced;
+  EXPECT_EQ(ScanRequireCalls("const a = require('./a');\n"
+                             "const { b } = require(\"../b.js\");\n"
+                             "function f() { return require('c'); }\n"
+                             "require(name);\n"
+                             "obj.require('./no');\n"
+                             "import('./no.mjs');\n"
+                             "const s = `${require('./in-template')}`;\n",
+                             &balanced),
+            (Specifiers{"./a", "../b.js", "c"}));
+  EXPECT_TRUE(balanced);
+
+  ScanRequireCalls("const o = { s: '}', t: `}${'{'}`, r: /}/ }; // }\n",
+                   &balanced);
+  EXPECT_TRUE(balanced);
+  ScanRequireCalls("}); (function () {", &balanced);
+  EXPECT_FALSE(balanced);
+  ScanRequireCalls("function f() {", &balanced);
+  EXPECT_FALSE(balanced);
+}
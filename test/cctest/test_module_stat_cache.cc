@@ -0,0 +1,104 @@
+#include "module_stat_cache.h"
+
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uv.h"
+
+using node::InternalModuleStatUncached;
+using node::ModuleStatCache;
+
+class ModuleStatCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char buf[1024];
+    size_t size = sizeof(buf);
+    ASSERT_EQ(uv_os_tmpdir(buf, &size), 0);
+    uv_fs_t req;
+    std::string tmpl = std::string(buf) + "/module_stat_cache_XXXXXX";
+    ASSERT_EQ(uv_fs_mkdtemp(nullptr, &req, tmpl.c_str(), nullptr), 0);
+    dir_ = req.path;
+    uv_fs_req_cleanup(&req);
+  }
+
+  void TearDown() override {
+    uv_fs_t req;
+    uv_fs_unlink(nullptr, &req, (dir_ + "/a.js").c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+    uv_fs_rmdir(nullptr, &req, (dir_ + "/sub").c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+    uv_fs_rmdir(nullptr, &req, dir_.c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+  }
+
+  // Moves the directory's mtime out of the racy interval.
+  void Settle() {
+    uv_fs_t req;
+    double past = static_cast<double>(time(nullptr) - 60);
+    ASSERT_EQ(uv_fs_utime(nullptr, &req, dir_.c_str(), past, past, nullptr),
+              0);
+    uv_fs_req_cleanup(&req);
+  }
+
+  std::string dir_;
+};
+
+TEST_F(ModuleStatCacheTest, MatchesUncachedStat) {
+  ModuleStatCache cache;
+  uv_loop_t* loop = uv_default_loop();
+  uv_fs_t req;
+  ASSERT_EQ(uv_fs_mkdir(loop, &req, (dir_ + "/sub").c_str(), 0700, nullptr),
+            0);
+  uv_fs_req_cleanup(&req);
+  std::ofstream(dir_ + "/a.js") << "x";
+  Settle();
+
+  const std::vector<std::string> paths = {dir_ + "/a.js",
+                                          dir_ + "/a.json",
+                                          dir_ + "/sub",
+                                          dir_ + "/a.js/index.js",
+                                          dir_};
+  std::vector<int32_t> results(paths.size());
+  cache.StatBatch(loop, paths, results.data());
+  for (size_t i = 0; i < paths.size(); i++) {
+    EXPECT_EQ(results[i], InternalModuleStatUncached(loop, paths[i].c_str()))
+        << paths[i];
+    // The second round is served from the cache.
+    EXPECT_EQ(cache.Stat(loop, paths[i]), results[i]) << paths[i];
+  }
+  EXPECT_EQ(results[0], 0);
+  EXPECT_EQ(results[1], UV_ENOENT);
+  EXPECT_EQ(results[2], 1);
+  EXPECT_GT(cache.size(), 0u);
+}
+
+TEST_F(ModuleStatCacheTest, DirectoryChangeInvalidates) {
+  ModuleStatCache cache;
+  uv_loop_t* loop = uv_default_loop();
+  const std::string path = dir_ + "/a.js";
+  Settle();
+
+  EXPECT_EQ(cache.Stat(loop, path), UV_ENOENT);
+  EXPECT_EQ(cache.size(), 1u);
+
+  std::ofstream(path) << "x";
+  EXPECT_EQ(cache.Stat(loop, path), 0);
+
+  uv_fs_t req;
+  ASSERT_EQ(uv_fs_unlink(loop, &req, path.c_str(), nullptr), 0);
+  uv_fs_req_cleanup(&req);
+  EXPECT_EQ(cache.Stat(loop, path), UV_ENOENT);
+
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(ModuleStatCacheTest, RecentlyChangedDirectoryIsNotCached) {
+  ModuleStatCache cache;
+  uv_loop_t* loop = uv_default_loop();
+  EXPECT_EQ(cache.Stat(loop, dir_ + "/a.js"), UV_ENOENT);
+  EXPECT_EQ(cache.size(), 0u);
+}
@@ -0,0 +1,92 @@
+#include "node_multipart.h"
+#include "gtest/gtest.h"
+
+#include <string>
+
+using node::multipart::MultipartParser;
+
+namespace {
+
+const MultipartParser::Part& GetPart(const MultipartParser& parser,
+                                     size_t index) {
+  EXPECT_LT(index, parser.parts().size());
+  return parser.parts()[index];
+}
+
+std::string Body(const std::string& input, const MultipartParser::Part& part) {
+  return input.substr(part.body_start, part.body_end - part.body_start);
+}
+
+bool Parse(MultipartParser* parser, const std::string& input, size_t chunk) {
+  for (size_t offset = 0; offset < input.size(); offset += chunk) {
+    size_t len = std::min(chunk, input.size() - offset);
+    if (!parser->Write(
+            reinterpret_cast<const uint8_t*>(input.data()) + offset, len)) {
+      return false;
+    }
+  }
+  return parser->Finish();
+}
+
+}  // namespace
+
+TEST(MultipartParserTest, Parts) {
+  const std::string input =
+      "preamble\r\n"
+      "--XyZ\r\n"
+      "Content-Disposition: form-data; name=\"a\"\r\n"
+      "\r\n"
+      "hello\r\n"
+      "--XyZ \t\r\n"
+      "\r\n"
+      "\r\n"
+      "--XyZ\r\n"
+      "H: 1\r\n"
+      "J: 2\r\n"
+      "\r\n"
+      "not a \r\n-- XyZ delimiter\r\n"
+      "--XyZ--\r\n"
+      "epilogue";
+
+  // Every chunk size, so that delimiters and header blocks are split at
+  // every possible point.
+  for (size_t chunk = 1; chunk <= input.size(); chunk++) {
+    MultipartParser parser("XyZ");
+    EXPECT_TRUE(Parse(&parser, input, chunk)) << chunk;
+    ASSERT_EQ(parser.parts().size(), 3u) << chunk;
+    EXPECT_EQ(GetPart(parser, 0).headers,
+              "Content-Disposition: form-data; name=\"a\"");
+    EXPECT_EQ(Body(input, GetPart(parser, 0)), "hello");
+    EXPECT_EQ(GetPart(parser, 1).headers, "");
+    EXPECT_EQ(Body(input, GetPart(parser, 1)), "");
+    EXPECT_EQ(GetPart(parser, 2).headers, "H: 1\r\nJ: 2");
+    EXPECT_EQ(Body(input, GetPart(parser, 2)), "not a \r\n-- XyZ delimiter");
+  }
+}
+
+TEST(MultipartParserTest, Malformed) {
+  {
+    // The close delimiter is missing.
+    MultipartParser parser("b");
+    EXPECT_FALSE(Parse(&parser, "--b\r\n\r\nbody\r\n--b", 4));
+    EXPECT_FALSE(parser.failed());
+    EXPECT_EQ(parser.parts().size(), 1u);
+  }
+  {
+    // The boundary appears in a body.
+    MultipartParser parser("b");
+    EXPECT_FALSE(Parse(&parser, "--b\r\n\r\nbody\r\n--bb\r\n--b--", 64));
+    EXPECT_TRUE(parser.failed());
+  }
+  {
+    std::string input = "--b\r\n" + std::string(
+        MultipartParser::kMaxHeaderSize + 1, 'h') + "\r\n\r\n\r\n--b--";
+    MultipartParser parser("b");
+    EXPECT_FALSE(Parse(&parser, input, 1024));
+    EXPECT_TRUE(parser.failed());
+  }
+
+  EXPECT_FALSE(MultipartParser::IsValidBoundary(""));
+  EXPECT_FALSE(MultipartParser::IsValidBoundary(std::string(71, 'b')));
+  EXPECT_TRUE(MultipartParser::IsValidBoundary(std::string(70, 'b')));
+}
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "node_json.h"
+#include "node_test_fixture.h"
+#include "util-inl.h"
+
+#include <cstring>
+#include <string>
+
+using v8::ArrayBuffer;
+using v8::Context;
+using v8::Function;
+using v8::HandleScope;
+using v8::JSON;
+using v8::Local;
+using v8::Object;
+using v8::String;
+using v8::TryCatch;
+using v8::Uint8Array;
+using v8::Value;
+
+class JsonTest : public EnvironmentTestFixture {
+ protected:
+  // Returns JSON.stringify(node::json::Parse(json)), or "error" if it threw.
+  std::string RoundTrip(Local<Context> context, std::string_view json) {
+    TryCatch try_catch(isolate_);
+    Local<Value> value;
+    if (!node::json::Parse(context, json).ToLocal(&value)) {
+      EXPECT_TRUE(try_catch.HasCaught());
+      return "error";
+    }
+    Local<String> string = JSON::Stringify(context, value).ToLocalChecked();
+    return *node::Utf8Value(isolate_, string);
+  }
+};
+
+TEST_F(JsonTest, Parse) {
+  const HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  Local<Context> context = isolate_->GetCurrentContext();
+
+  EXPECT_EQ(RoundTrip(context, "null"), "null");
+  EXPECT_EQ(RoundTrip(context, " [1, -2, 3.5, 1e2, true, false, null] "),
+            "[1,-2,3.5,100,true,false,null]");
+  EXPECT_EQ(RoundTrip(context, R"({"a":"é😀","b":{}})"),
+            "{\"a\":\"\xc3\xa9\xf0\x9f\x98\x80\",\"b\":{}}");
+  // Shapes are shared, but each object keeps its own values.
+  EXPECT_EQ(RoundTrip(context, R"([{"x":1,"y":2},{"x":3,"y":4}])"),
+            R"([{"x":1,"y":2},{"x":3,"y":4}])");
+  // As with JSON.parse(), the last of repeated names wins, and indices come
+  // first.
+  EXPECT_EQ(RoundTrip(context, R"({"a":1,"a":2})"), R"({"a":2})");
+  EXPECT_EQ(RoundTrip(context, R"({"b":1,"1":2})"), R"({"1":2,"b":1})");
+  // Out of range for simdjson, but not for JSON.parse().
+  EXPECT_EQ(RoundTrip(context, "[1e400, 18446744073709551616]"),
+            "[null,18446744073709552000]");
+
+  EXPECT_EQ(RoundTrip(context, ""), "error");
+  EXPECT_EQ(RoundTrip(context, "{\"a\":}"), "error");
+  EXPECT_EQ(RoundTrip(context, "[1,]"), "error");
+}
+
+TEST_F(JsonTest, ProtoIsOwnProperty) {
+  const HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  Local<Context> context = isolate_->GetCurrentContext();
+
+  Local<Value> value =
+      node::json::Parse(context, R"({"__proto__":{"polluted":true}})")
+          .ToLocalChecked();
+  Local<Object> object = value.As<Object>();
+  EXPECT_TRUE(object
+                  ->HasOwnProperty(context,
+                                   String::NewFromUtf8Literal(isolate_,
+                                                              "__proto__"))
+                  .FromJust());
+  EXPECT_TRUE(object->GetPrototypeV2()->StrictEquals(
+      Object::New(isolate_)->GetPrototypeV2()));
+}
+
+TEST_F(JsonTest, View) {
+  const HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+  Local<Context> context = isolate_->GetCurrentContext();
+
+  Local<Object> binding = Object::New(isolate_);
+  node::json::Initialize(binding, Local<Value>(), context, nullptr);
+  Local<Function> constructor =
+      binding->Get(context, String::NewFromUtf8Literal(isolate_, "JSONView"))
+          .ToLocalChecked()
+          .As<Function>();
+
+  const std::string json =
+      R"({"type":"push","repo":{"name":"node","a/b":[1,{"c":null}]}})";
+  Local<ArrayBuffer> ab = ArrayBuffer::New(isolate_, json.size());
+  memcpy(ab->Data(), json.data(), json.size());
+  Local<Value> view_arg = Uint8Array::New(ab, 0, json.size());
+  Local<Object> view =
+      constructor->NewInstance(context, 1, &view_arg).ToLocalChecked();
+
+  auto call = [&](const char* method, const char* pointer) -> std::string {
+    TryCatch try_catch(isolate_);
+    Local<Value> function =
+        view->Get(context, String::NewFromUtf8(isolate_, method)
+                               .ToLocalChecked())
+            .ToLocalChecked();
+    Local<Value> arg = String::NewFromUtf8(isolate_, pointer).ToLocalChecked();
+    Local<Value> result;
+    if (!function.As<Function>()->Call(context, view, 1, &arg).ToLocal(
+            &result)) {
+      return "error";
+    }
+    if (result->IsUndefined()) return "undefined";
+    return *node::Utf8Value(
+        isolate_, JSON::Stringify(context, result).ToLocalChecked());
+  };
+
+  EXPECT_EQ(call("get", "/type"), "\"push\"");
+  EXPECT_EQ(call("get", "/repo/a~1b/1"), R"({"c":null})");
+  EXPECT_EQ(call("get", ""), json);
+  EXPECT_EQ(call("get", "/missing"), "undefined");
+  EXPECT_EQ(call("get", "/repo/a~1b/5"), "undefined");
+  EXPECT_EQ(call("has", "/repo/name"), "true");
+  EXPECT_EQ(call("has", "/repo/nope"), "false");
+  EXPECT_EQ(call("get", "type"), "error");
+}
@@ -0,0 +1,95 @@
+#include <string>
+#include "gtest/gtest.h"
+#include "node_test_fixture.h"
+
+class LockManagerTest : public EnvironmentTestFixture {
+ protected:
+  // Runs `source` in a new Environment until its event loop is empty and
+  // returns `globalThis.log`, joined with commas.
+  std::string RunAndGetLog(const char* source) {
+    const v8::HandleScope handle_scope(isolate_);
+    const Argv argv;
+    Env env{handle_scope, argv};
+
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+    node::LoadEnvironment(*env, source).ToLocalChecked();
+    EXPECT_EQ(node::SpinEventLoop(*env).FromJust(), 0);
+
+    v8::Local<v8::Value> log =
+        context->Global()
+            ->Get(context, v8::String::NewFromUtf8Literal(isolate_, "log"))
+            .ToLocalChecked();
+    node::Utf8Value log_string(isolate_, log);
+    return log_string.ToString();
+  }
+};
+
+// Test that an uncontended request is granted right away, and that its
+// promise resolves with the value returned by the callback
+TEST_F(LockManagerTest, UncontendedRequest) {
+  EXPECT_EQ(RunAndGetLog(
+                "globalThis.log = [];\n"
+                "navigator.locks.request('a', (lock) => {\n"
+                "  log.push(`${lock.name}:${lock.mode}`);\n"
+                "  return 42;\n"
+                "}).then((value) => log.push(value));\n"
+                "log.push('sync');\n"),
+            "a:exclusive,sync,42");
+}
+
+// Test that all shared requests queued behind an exclusive lock are granted
+// together once it is released
+TEST_F(LockManagerTest, SharedRequestsAreGrantedTogether) {
+  EXPECT_EQ(RunAndGetLog(
+                "globalThis.log = [];\n"
+                "let release;\n"
+                "navigator.locks.request('a', () => new Promise((r) => {\n"
+                "  release = r;\n"
+                "}));\n"
+                "const shared = [];\n"
+                "for (let i = 0; i < 3; i++) {\n"
+                "  shared.push(navigator.locks.request('a', {mode: 'shared'},\n"
+                "    async () => {\n"
+                "      const { held } = await navigator.locks.query();\n"
+                "      log.push(held.length);\n"
+                "    }));\n"
+                "}\n"
+                "log.push('queued');\n"
+                "release();\n"
+                "Promise.all(shared).then(() => log.push('done'));\n"),
+            "queued,3,3,3,done");
+}
+
+// Test that a callback throwing synchronously releases its lock, and that
+// the requests queued behind it (here, from inside the callback) are granted
+TEST_F(LockManagerTest, SynchronousThrowReleasesLock) {
+  EXPECT_EQ(RunAndGetLog(
+                "globalThis.log = [];\n"
+                "navigator.locks.request('a', () => {\n"
+                "  navigator.locks.request('a', () => log.push('second'));\n"
+                "  throw new Error('first');\n"
+                "}).catch((err) => log.push(err.message));\n"),
+            "second,first");
+}
+
+// Test that releasing a lock wakes up a request waiting for it in a Worker
+TEST_F(LockManagerTest, ContentionAcrossWorkers) {
+  EXPECT_EQ(RunAndGetLog(
+                "'use strict';\n"
+                "const { Worker } = require('worker_threads');\n"
+                "globalThis.log = [];\n"
+                "navigator.locks.request('a', () => new Promise((r) => {\n"
+                "  const worker = new Worker(`\n"
+                "    const { parentPort } = require('worker_threads');\n"
+                "    navigator.locks.request('a', () => {\n"
+                "      parentPort.postMessage('worker');\n"
+                "    });\n"
+                "    parentPort.postMessage('queued');\n"
+                "  `, { eval: true });\n"
+                "  worker.on('message', (message) => {\n"
+                "    log.push(message);\n"
+                "    if (message === 'queued') r();\n"
+                "  });\n"
+                "}));\n"),
+            "queued,worker");
+}
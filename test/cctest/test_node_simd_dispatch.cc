@@ -0,0 +1,57 @@
+#include "node_simd_dispatch.h"
+#include "simd_abstraction.h"
+
+#include <algorithm>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using node::simd_dispatch::GetSelection;
+
+namespace {
+
+std::string Lookup(const std::string& subsystem) {
+  for (const auto& [name, implementation] : GetSelection()) {
+    if (name == subsystem) return implementation;
+  }
+  return "";
+}
+
+}  // namespace
+
+TEST(SimdDispatchTest, ReportsEverySubsystem) {
+  auto selection = GetSelection();
+  for (const char* subsystem :
+       {"cpu", "simd", "zlib.adler32", "zlib.crc32", "zlib.slide_hash",
+        "zlib.inflate_chunk", "simdjson.ondemand", "simdjson.dom", "simdutf",
+        "v8.string_hasher", "v8.swiss_table"}) {
+    EXPECT_NE(Lookup(subsystem), "") << subsystem;
+  }
+  for (const auto& [name, implementation] : selection) {
+    EXPECT_EQ(std::count_if(selection.begin(),
+                            selection.end(),
+                            [&](const auto& entry) {
+                              return entry.first == name;
+                            }),
+              1)
+        << name;
+  }
+}
+
+TEST(SimdDispatchTest, MatchesKernelSelection) {
+  const simd_kernel_selection_t* selection = get_simd_kernel_selection();
+#define V(name, ret, args)                                                     \
+  EXPECT_EQ(Lookup("simd." #name),                                             \
+            get_simd_instruction_set_name(selection->name));
+  SIMD_KERNELS(V)
+#undef V
+  EXPECT_EQ(Lookup("simd"),
+            get_simd_instruction_set_name(get_active_simd_instruction_set()));
+}
+
+TEST(SimdDispatchTest, ToString) {
+  std::string report = node::simd_dispatch::ToString();
+  EXPECT_EQ(static_cast<size_t>(std::count(report.begin(), report.end(), '\n')),
+            GetSelection().size());
+  EXPECT_NE(report.find("simdutf: "), std::string::npos);
+}
@@ -8,6 +8,7 @@
 #include "v8.h"
 
 using node::BufferValue;
+using node::NormalizeString;
 using node::PathResolve;
 using node::ToNamespacedPath;
 
@@ -54,6 +55,18 @@ TEST_F(PathTest, PathResolve) {
 #endif
 }
 
+TEST(PathNormalizeTest, NormalizeString) {
+  EXPECT_EQ(NormalizeString("", false, "/"), "");
+  EXPECT_EQ(NormalizeString("a//b/./c/", false, "/"), "a/b/c");
+  EXPECT_EQ(NormalizeString("a/b/../../c", false, "/"), "c");
+  EXPECT_EQ(NormalizeString("a/../../b", false, "/"), "b");
+  EXPECT_EQ(NormalizeString("a/../../b", true, "/"), "../b");
+  EXPECT_EQ(NormalizeString("../../a/..", true, "/"), "../..");
+  EXPECT_EQ(NormalizeString("ab/cd/../..", true, "/"), "");
+  EXPECT_EQ(NormalizeString(".../..a/a../.b", false, "/"), ".../..a/a../.b");
+  EXPECT_EQ(NormalizeString("x/yz/..", false, "/"), "x");
+}
+
 TEST_F(PathTest, ToNamespacedPath) {
   const v8::HandleScope handle_scope(isolate_);
   Argv argv;
@@ -14,6 +14,11 @@ class PerProcessTest : public ::testing::Test {
   static const BuiltinSourceMap get_sources_for_test() {
     return *BuiltinLoader().source_.read();
   }
+
+  static bool loaders_share_sources_for_test() {
+    BuiltinLoader a, b;
+    return &*a.source_.read() == &*b.source_.read();
+  }
 };
 
 namespace {
@@ -29,4 +34,9 @@ TEST_F(PerProcessTest, EmbeddedSources) {
   })) << "BuiltinLoader::source_ should have some 16bit items";
 }
 
+TEST_F(PerProcessTest, SourcesAreSharedBetweenLoaders) {
+  ASSERT_TRUE(PerProcessTest::loaders_share_sources_for_test())
+      << "BuiltinLoader::source_ should not be copied for every loader";
+}
+
 }  // end namespace
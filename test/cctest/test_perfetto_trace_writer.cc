@@ -0,0 +1,133 @@
+#include "tracing/perfetto_trace_writer.h"
+#include "tracing/trace_event_common.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::tracing::PerfettoTraceWriter;
+using v8::platform::tracing::TraceObject;
+
+namespace {
+
+struct Field {
+  uint32_t number;
+  uint64_t varint = 0;
+  std::string bytes;
+};
+
+uint64_t ReadVarint(const std::string& data, size_t* pos) {
+  uint64_t value = 0;
+  for (int shift = 0; *pos < data.size(); shift += 7) {
+    uint8_t byte = data[(*pos)++];
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) break;
+  }
+  return value;
+}
+
+// Decodes the varint and length-delimited fields of a message, the only
+// wire types that the tests need.
+std::vector<Field> Parse(const std::string& data) {
+  std::vector<Field> fields;
+  size_t pos = 0;
+  while (pos < data.size()) {
+    uint64_t tag = ReadVarint(data, &pos);
+    Field field{static_cast<uint32_t>(tag >> 3)};
+    switch (tag & 7) {
+      case 0:
+        field.varint = ReadVarint(data, &pos);
+        break;
+      case 2: {
+        size_t size = ReadVarint(data, &pos);
+        EXPECT_LE(pos + size, data.size());
+        field.bytes = data.substr(pos, size);
+        pos += size;
+        break;
+      }
+      default:
+        ADD_FAILURE() << "unexpected wire type " << (tag & 7);
+        return fields;
+    }
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+const Field* Find(const std::vector<Field>& fields, uint32_t number) {
+  for (const Field& field : fields) {
+    if (field.number == number) return &field;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(PerfettoTraceWriterTest, TrackEvents) {
+  v8::platform::tracing::TracingController controller;
+  const uint8_t* category = controller.GetCategoryGroupEnabled("node");
+  const char* arg_names[] = {"x"};
+  const uint8_t arg_types[] = {TRACE_VALUE_TYPE_INT};
+  const uint64_t arg_values[] = {static_cast<uint64_t>(-2)};
+
+  std::ostringstream stream;
+  {
+    PerfettoTraceWriter writer(stream);
+    TraceObject begin;
+    begin.InitializeForTesting(TRACE_EVENT_PHASE_BEGIN, category, "task",
+                               nullptr, 0, 0, 1, arg_names, arg_types,
+                               arg_values, nullptr, 0, 10, 11, 5, 0, 0, 0);
+    writer.AppendTraceEvent(&begin);
+    TraceObject complete;
+    complete.InitializeForTesting(TRACE_EVENT_PHASE_COMPLETE, category, "task",
+                                  nullptr, 0, 0, 0, nullptr, nullptr, nullptr,
+                                  nullptr, 0, 10, 11, 7, 0, 3, 0);
+    writer.AppendTraceEvent(&complete);
+  }
+
+  // A process and a thread descriptor, then the begin event and the begin
+  // and end of the complete event.
+  std::vector<Field> packets = Parse(stream.str());
+  ASSERT_EQ(packets.size(), 5u);
+  for (const Field& packet : packets) EXPECT_EQ(packet.number, 1u);
+
+  std::vector<Field> thread_track = Parse(packets[1].bytes);
+  const Field* descriptor = Find(thread_track, 60);
+  ASSERT_NE(descriptor, nullptr);
+  std::vector<Field> track = Parse(descriptor->bytes);
+  uint64_t thread_uuid = Find(track, 1)->varint;
+  std::vector<Field> thread = Parse(Find(track, 4)->bytes);
+  EXPECT_EQ(Find(thread, 1)->varint, 10u);
+  EXPECT_EQ(Find(thread, 2)->varint, 11u);
+
+  uint64_t expected_timestamps[] = {5000, 7000, 10000};
+  uint64_t expected_types[] = {1, 1, 2};
+  for (size_t i = 0; i < 3; i++) {
+    std::vector<Field> packet = Parse(packets[i + 2].bytes);
+    EXPECT_EQ(Find(packet, 8)->varint, expected_timestamps[i]);
+    EXPECT_EQ(Find(packet, 10)->varint, 1u);
+    ASSERT_NE(Find(packet, 11), nullptr);
+    std::vector<Field> event = Parse(Find(packet, 11)->bytes);
+    EXPECT_EQ(Find(event, 9)->varint, expected_types[i]);
+    EXPECT_EQ(Find(event, 11)->varint, thread_uuid);
+    if (expected_types[i] == 1) {
+      EXPECT_EQ(Find(event, 10)->varint, 1u);
+      EXPECT_EQ(Find(event, 3)->varint, 1u);
+    }
+    // Only the first event interns the name and the category.
+    EXPECT_EQ(Find(packet, 12) != nullptr, i == 0);
+    EXPECT_EQ(Find(packet, 13)->varint, i == 0 ? 3u : 2u);
+  }
+
+  std::vector<Field> interned = Parse(Find(Parse(packets[2].bytes), 12)->bytes);
+  EXPECT_EQ(Find(Parse(Find(interned, 1)->bytes), 2)->bytes, "node");
+  EXPECT_EQ(Find(Parse(Find(interned, 2)->bytes), 2)->bytes, "task");
+  EXPECT_EQ(Find(Parse(Find(interned, 3)->bytes), 2)->bytes, "x");
+
+  std::vector<Field> event = Parse(Find(Parse(packets[2].bytes), 11)->bytes);
+  std::vector<Field> annotation = Parse(Find(event, 4)->bytes);
+  EXPECT_EQ(Find(annotation, 1)->varint, 1u);
+  EXPECT_EQ(static_cast<int64_t>(Find(annotation, 4)->varint), -2);
+}
@@ -1,6 +1,7 @@
 #include "node_internals.h"
 #include "libplatform/libplatform.h"
 
+#include <atomic>
 #include <string>
 #include "gtest/gtest.h"
 #include "node_test_fixture.h"
@@ -38,6 +39,36 @@ class RepostingTask : public v8::Task {
   node::NodePlatform* platform_;
 };
 
+// This task increments the given run counter and, until depth reaches zero,
+// posts several copies of itself to the worker threads. Apart from the
+// first one, the tasks are therefore posted from the worker threads
+// themselves and spread between them by stealing.
+class FanOutTask : public v8::Task {
+ public:
+  FanOutTask(int depth,
+             std::atomic<int>* run_count,
+             node::NodePlatform* platform)
+      : depth_(depth), run_count_(run_count), platform_(platform) {}
+
+  // v8::Task implementation
+  void Run() final {
+    ++*run_count_;
+    if (depth_ == 0) return;
+    for (int i = 0; i < kFanOut; i++) {
+      platform_->PostTaskOnWorkerThread(
+          v8::TaskPriority::kUserBlocking,
+          std::make_unique<FanOutTask>(depth_ - 1, run_count_, platform_));
+    }
+  }
+
+  static constexpr int kFanOut = 4;
+
+ private:
+  int depth_;
+  std::atomic<int>* run_count_;
+  node::NodePlatform* platform_;
+};
+
 class PlatformTest : public EnvironmentTestFixture {};
 
 TEST_F(PlatformTest, SkipNewTasksInFlushForegroundTasks) {
@@ -60,6 +91,25 @@ TEST_F(PlatformTest, SkipNewTasksInFlushForegroundTasks) {
   EXPECT_FALSE(platform->FlushForegroundTasks(isolate_));
 }
 
+TEST_F(PlatformTest, DrainTasksWaitsForTasksPostedByWorkers) {
+  v8::Isolate::Scope isolate_scope(isolate_);
+  const v8::HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env {handle_scope, argv};
+  std::atomic<int> run_count = 0;
+  constexpr int kDepth = 5;
+  platform->PostTaskOnWorkerThread(
+      v8::TaskPriority::kUserBlocking,
+      std::make_unique<FanOutTask>(kDepth, &run_count, platform.get()));
+  platform->DrainTasks(isolate_);
+  // 1 + 4 + 16 + ... + 4^kDepth tasks.
+  int expected = 0;
+  for (int i = 0, n = 1; i <= kDepth; i++, n *= FanOutTask::kFanOut) {
+    expected += n;
+  }
+  EXPECT_EQ(expected, run_count);
+}
+
 // Tests the registration of an abstract `IsolatePlatformDelegate` instance as
 // opposed to the more common `uv_loop_s*` version of `RegisterIsolate`.
 TEST_F(NodeZeroIsolateTestFixture, IsolatePlatformDelegateTest) {
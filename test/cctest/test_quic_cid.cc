@@ -116,5 +116,23 @@ TEST(CID, Basic) {
     }
   }
 }
+
+TEST(CID, Sharded) {
+  for (uint8_t count : {1, 3, 4, 7, 255}) {
+    for (uint8_t index : {0, count / 2, count - 1}) {
+      auto& sharded = CID::Factory::sharded(index, count);
+      CHECK_EQ(&sharded, &CID::Factory::sharded(index, count));
+      ngtcp2_cid cid_;
+      for (int n = 0; n < 500; n++) {
+        const auto cid = sharded.Generate();
+        CHECK_EQ(cid.length(), CID::kMaxLength);
+        CHECK_EQ(static_cast<const uint8_t*>(cid)[0] % count, index);
+        CHECK(sharded.GenerateInto(&cid_, 8));
+        CHECK_EQ(cid_.datalen, 8);
+        CHECK_EQ(cid_.data[0] % count, index);
+      }
+    }
+  }
+}
 #endif  // OPENSSL_NO_QUIC
 #endif  // HAVE_OPENSSL
@@ -0,0 +1,65 @@
+#include "node_test_fixture.h"
+#include "read_buffer_pool.h"
+#include "v8.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using node::ReadBufferPool;
+using v8::BackingStore;
+
+class ReadBufferPoolTest : public NodeTestFixture {};
+
+TEST_F(ReadBufferPoolTest, RecyclesChunksBySizeClass) {
+  ReadBufferPool* pool = ReadBufferPool::Create();
+
+  std::unique_ptr<BackingStore> bs = pool->NewBackingStore(isolate_, 5000);
+  EXPECT_EQ(bs->ByteLength(), 5000u);
+  void* chunk = bs->Data();
+  bs.reset();
+#if !defined(V8_ENABLE_SANDBOX)
+  EXPECT_EQ(pool->CachedChunks(), 1u);
+
+  // Anything up to 8 KiB lands in the same size class.
+  bs = pool->NewBackingStore(isolate_, 8 * 1024);
+  EXPECT_EQ(bs->Data(), chunk);
+  EXPECT_EQ(pool->CachedChunks(), 0u);
+
+  // A 16 KiB buffer needs a chunk of its own.
+  std::unique_ptr<BackingStore> bs16 =
+      pool->NewBackingStore(isolate_, 16 * 1024);
+  EXPECT_NE(bs16->Data(), chunk);
+  bs16.reset();
+  EXPECT_EQ(pool->CachedChunks(), 1u);
+#endif
+
+  // Short and oversized buffers are never cached.
+  std::unique_ptr<BackingStore> small = pool->NewBackingStore(isolate_, 100);
+  std::unique_ptr<BackingStore> big =
+      pool->NewBackingStore(isolate_, 64 * 1024 + 1);
+  EXPECT_EQ(small->ByteLength(), 100u);
+  EXPECT_EQ(big->ByteLength(), 64u * 1024 + 1);
+  const size_t cached = pool->CachedChunks();
+  small.reset();
+  big.reset();
+  EXPECT_EQ(pool->CachedChunks(), cached);
+
+  // Chunks still in use keep the pool alive past Detach().
+  ReadBufferPool::Detach(pool);
+  memset(bs->Data(), 0, bs->ByteLength());
+  bs.reset();
+}
+
+TEST_F(ReadBufferPoolTest, BoundsIdleMemory) {
+  ReadBufferPool* pool = ReadBufferPool::Create();
+  std::vector<std::unique_ptr<BackingStore>> stores;
+  for (size_t i = 0; i < 32; i++)
+    stores.push_back(pool->NewBackingStore(isolate_, 64 * 1024));
+  stores.clear();
+#if !defined(V8_ENABLE_SANDBOX)
+  EXPECT_EQ(pool->CachedChunks(),
+            ReadBufferPool::kMaxCachedBytesPerClass / (64 * 1024));
+#endif
+  ReadBufferPool::Detach(pool);
+}
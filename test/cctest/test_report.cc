@@ -1,4 +1,6 @@
 #include "node.h"
+#include "env-inl.h"
+#include "node_report.h"
 
 #include <string>
 #include "gtest/gtest.h"
@@ -123,3 +125,55 @@ TEST_F(ReportTest, ReportWithEnv) {
 
   EXPECT_TRUE(report_callback_called);
 }
+
+TEST_F(ReportTest, ReportSections) {
+  const HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env{handle_scope, argv};
+
+  Local<Context> context = isolate_->GetCurrentContext();
+  Local<Function> fn =
+      Function::New(context, [](const FunctionCallbackInfo<Value>& args) {
+        Isolate* isolate = args.GetIsolate();
+        HandleScope scope(isolate);
+        Environment* env =
+            node::GetCurrentEnvironment(isolate->GetCurrentContext());
+        env->options()->report_sections = "libuv,heap";
+        env->options()->report_summarize_handles = true;
+
+        std::ostringstream oss;
+        node::GetNodeReport(env, "FooMessage", "BarTrigger", args[0], oss);
+
+        std::string actual = oss.str();
+        EXPECT_NE(actual.find("\"header\""), std::string::npos);
+        EXPECT_NE(actual.find("\"javascriptHeap\""), std::string::npos);
+        EXPECT_NE(actual.find("\"libuv\""), std::string::npos);
+        EXPECT_NE(actual.find("\"count\""), std::string::npos);
+        EXPECT_EQ(actual.find("\"javascriptStack\""), std::string::npos);
+        EXPECT_EQ(actual.find("\"nativeStack\""), std::string::npos);
+        EXPECT_EQ(actual.find("\"workers\""), std::string::npos);
+        EXPECT_EQ(actual.find("\"sharedObjects\""), std::string::npos);
+
+        report_callback_called = true;
+      }).ToLocalChecked();
+
+  context->Global()
+      ->Set(context, String::NewFromUtf8(isolate_, "foo").ToLocalChecked(), fn)
+      .FromJust();
+
+  node::LoadEnvironment(*env, "foo()").ToLocalChecked();
+
+  EXPECT_TRUE(report_callback_called);
+}
+
+TEST(ReportSectionsTest, Parse) {
+  uint32_t sections = 0;
+  EXPECT_TRUE(node::report::ParseReportSections("", &sections));
+  EXPECT_EQ(sections, node::report::kReportAllSections);
+  EXPECT_TRUE(node::report::ParseReportSections("js,native", &sections));
+  EXPECT_EQ(sections,
+            node::report::kReportJavaScriptStack |
+                node::report::kReportNativeStack);
+  EXPECT_FALSE(node::report::ParseReportSections("js,", &sections));
+  EXPECT_FALSE(node::report::ParseReportSections("stack", &sections));
+}
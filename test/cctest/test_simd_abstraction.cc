@@ -0,0 +1,365 @@
+#include "simd_abstraction.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(SimdAbstractionTest, EveryKernelIsResolved) {
+  const simd_functions_t* funcs = get_simd_functions();
+  const simd_kernel_selection_t* selection = get_simd_kernel_selection();
+  ASSERT_NE(funcs, nullptr);
+  ASSERT_NE(selection, nullptr);
+#define V(name, ret, args)                                                     \
+  EXPECT_NE(funcs->name, nullptr) << #name;                                    \
+  EXPECT_TRUE(is_simd_available(selection->name))                              \
+      << #name << " uses " << get_simd_instruction_set_name(selection->name);
+  SIMD_KERNELS(V)
+#undef V
+  EXPECT_TRUE(is_simd_available(get_active_simd_instruction_set()));
+  EXPECT_TRUE(is_simd_available(SIMD_SCALAR));
+  EXPECT_FALSE(is_simd_available(SIMD_NONE));
+}
+
+TEST(SimdAbstractionTest, FeaturesMirrorZlib) {
+  unsigned features = get_simd_cpu_features();
+  auto has = [&](unsigned bit) { return (features & bit) != 0; };
+#if defined(SIMD_ARCH_X86)
+  EXPECT_EQ(has(SIMD_FEATURE_SSE2), x86_cpu_enable_sse2 != 0);
+  EXPECT_EQ(has(SIMD_FEATURE_SSSE3), x86_cpu_enable_ssse3 != 0);
+  EXPECT_EQ(has(SIMD_FEATURE_SSE4_2_PCLMUL), x86_cpu_enable_simd != 0);
+  EXPECT_EQ(has(SIMD_FEATURE_AVX512), x86_cpu_enable_avx512 != 0);
+  EXPECT_EQ(has(SIMD_FEATURE_3DNOW), x86_cpu_enable_3dnow != 0);
+  EXPECT_EQ(has(SIMD_FEATURE_3DNOWEXT), x86_cpu_enable_3dnowext != 0);
+  EXPECT_EQ(has(SIMD_FEATURE_MMXEXT), x86_cpu_enable_mmxext != 0);
+  EXPECT_FALSE(has(SIMD_FEATURE_ALTIVEC));
+#elif defined(SIMD_ARCH_PPC)
+  EXPECT_EQ(features, ppc_cpu_enable_altivec ? SIMD_FEATURE_ALTIVEC : 0u);
+#else
+  EXPECT_EQ(features, 0u);
+#endif
+}
+
+TEST(SimdAbstractionTest, FloatKernels) {
+  const simd_functions_t* funcs = get_simd_functions();
+  float a[4] = {1.5f, -2.0f, 0.25f, 8.0f};
+  float b[4] = {2.0f, 4.0f, -0.5f, 0.125f};
+  float r[4];
+
+  funcs->add_ps(a, b, r);
+  EXPECT_FLOAT_EQ(r[0], 3.5f);
+  EXPECT_FLOAT_EQ(r[1], 2.0f);
+  EXPECT_FLOAT_EQ(r[2], -0.25f);
+  EXPECT_FLOAT_EQ(r[3], 8.125f);
+
+  funcs->sub_ps(a, b, r);
+  EXPECT_FLOAT_EQ(r[0], -0.5f);
+  EXPECT_FLOAT_EQ(r[1], -6.0f);
+  EXPECT_FLOAT_EQ(r[2], 0.75f);
+  EXPECT_FLOAT_EQ(r[3], 7.875f);
+
+  funcs->mul_ps(a, b, r);
+  EXPECT_FLOAT_EQ(r[0], 3.0f);
+  EXPECT_FLOAT_EQ(r[1], -8.0f);
+  EXPECT_FLOAT_EQ(r[2], -0.125f);
+  EXPECT_FLOAT_EQ(r[3], 1.0f);
+}
+
+TEST(SimdAbstractionTest, IntegerKernels) {
+  const simd_functions_t* funcs = get_simd_functions();
+  int32_t a[4] = {1, -2, 0x7fffffff, 40};
+  int32_t b[4] = {10, 20, 0, -40};
+  int32_t r[4];
+
+  funcs->add_epi32(a, b, r);
+  EXPECT_EQ(r[0], 11);
+  EXPECT_EQ(r[1], 18);
+  EXPECT_EQ(r[2], 0x7fffffff);
+  EXPECT_EQ(r[3], 0);
+
+  // Reverse the lanes: 0b00011011.
+  funcs->shuffle_epi32(a, 0x1b, r);
+  EXPECT_EQ(r[0], 40);
+  EXPECT_EQ(r[1], 0x7fffffff);
+  EXPECT_EQ(r[2], -2);
+  EXPECT_EQ(r[3], 1);
+
+  // In-place broadcast of lane 2.
+  funcs->shuffle_epi32(a, 0xaa, a);
+  for (int i = 0; i < 4; i++) EXPECT_EQ(a[i], 0x7fffffff);
+}
+
+namespace {
+
+// Every instruction set compiled in and supported by this CPU, scalar last.
+std::vector<std::pair<simd_instruction_set_t, const simd_functions_t*>>
+AvailableImplementations() {
+  std::vector<std::pair<simd_instruction_set_t, const simd_functions_t*>> ret;
+  for (simd_instruction_set_t isa :
+       {SIMD_SSE2, SIMD_3DNOWEXT, SIMD_3DNOW, SIMD_MMXEXT, SIMD_ALTIVEC,
+        SIMD_SCALAR}) {
+    const simd_functions_t* funcs = get_simd_functions_for(isa);
+    if (funcs != nullptr) ret.emplace_back(isa, funcs);
+  }
+  return ret;
+}
+
+std::vector<uint8_t> Pattern(size_t length, uint32_t seed) {
+  std::vector<uint8_t> data(length);
+  for (size_t i = 0; i < length; i++) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = static_cast<uint8_t>(seed >> 16);
+  }
+  return data;
+}
+
+constexpr size_t kLengths[] = {0, 1, 3, 7, 8, 15, 16, 17, 31, 64, 100, 1027};
+
+}  // namespace
+
+TEST(SimdAbstractionTest, ScalarImplementsEverySlot) {
+  const simd_functions_t* scalar = get_simd_functions_for(SIMD_SCALAR);
+  ASSERT_NE(scalar, nullptr);
+#define V(name, ret, args) EXPECT_NE(scalar->name, nullptr) << #name;
+  SIMD_KERNELS(V)
+#undef V
+}
+
+TEST(SimdAbstractionTest, SpanKernelsMatchScalar) {
+  const simd_functions_t* scalar = get_simd_functions_for(SIMD_SCALAR);
+  auto implementations = AvailableImplementations();
+  implementations.emplace_back(SIMD_NONE, get_simd_functions());
+
+  for (const auto& [isa, funcs] : implementations) {
+    SCOPED_TRACE(get_simd_instruction_set_name(isa));
+    for (size_t length : kLengths) {
+      for (size_t offset : {0, 1, 3}) {
+        SCOPED_TRACE(length);
+        SCOPED_TRACE(offset);
+        std::vector<uint8_t> storage = Pattern(length + offset, 7 + length);
+        const uint8_t* data = storage.data() + offset;
+
+        if (funcs->find_byte != nullptr) {
+          for (uint8_t value : {uint8_t{0}, uint8_t{0x41}, uint8_t{0xff}}) {
+            EXPECT_EQ(funcs->find_byte(data, length, value),
+                      scalar->find_byte(data, length, value));
+          }
+          if (length > 0) {
+            EXPECT_EQ(funcs->find_byte(data, length, data[length - 1]),
+                      scalar->find_byte(data, length, data[length - 1]));
+          }
+        }
+
+        if (funcs->find_last_byte != nullptr) {
+          for (uint8_t value : {uint8_t{0}, uint8_t{0x41}, uint8_t{0xff}}) {
+            EXPECT_EQ(funcs->find_last_byte(data, length, value),
+                      scalar->find_last_byte(data, length, value));
+          }
+          if (length > 0) {
+            EXPECT_EQ(funcs->find_last_byte(data, length, data[0]),
+                      scalar->find_last_byte(data, length, data[0]));
+          }
+        }
+
+        if (funcs->find_byte_pair != nullptr) {
+          for (size_t distance : {1, 2, 7, 31}) {
+            if (distance >= length) continue;
+            // Candidate starts, so that data[i + distance] stays in bounds.
+            size_t count = length - distance;
+            const uint8_t first = data[count - 1];
+            const uint8_t last = data[length - 1];
+            EXPECT_EQ(
+                funcs->find_byte_pair(data, count, first, last, distance),
+                scalar->find_byte_pair(data, count, first, last, distance));
+            EXPECT_EQ(
+                funcs->find_byte_pair(data, count, first, 0xff, distance),
+                scalar->find_byte_pair(data, count, first, 0xff, distance));
+          }
+        }
+
+        if (funcs->compare_bytes != nullptr) {
+          std::vector<uint8_t> other(data, data + length);
+          EXPECT_EQ(funcs->compare_bytes(data, other.data(), length), 0);
+          if (length > 0) {
+            other[length - 1] ^= 0x80;
+            EXPECT_EQ(funcs->compare_bytes(data, other.data(), length),
+                      scalar->compare_bytes(data, other.data(), length));
+            EXPECT_EQ(funcs->compare_bytes(other.data(), data, length),
+                      -scalar->compare_bytes(data, other.data(), length));
+          }
+        }
+
+        if (funcs->copy_bytes != nullptr) {
+          std::vector<uint8_t> actual = Pattern(length + 2, 99);
+          std::vector<uint8_t> expected = actual;
+          memcpy(expected.data() + 1, data, length);
+          funcs->copy_bytes(actual.data() + 1, data, length);
+          EXPECT_EQ(actual, expected);
+        }
+
+        if (funcs->fill_bytes != nullptr) {
+          for (uint8_t value : {uint8_t{0}, uint8_t{0x41}}) {
+            std::vector<uint8_t> actual(storage);
+            std::vector<uint8_t> expected(storage);
+            memset(expected.data() + offset, value, length);
+            funcs->fill_bytes(actual.data() + offset, value, length);
+            EXPECT_EQ(actual, expected);
+          }
+        }
+
+        if (funcs->xor_bytes != nullptr) {
+          std::vector<uint8_t> expected = Pattern(length, 99);
+          std::vector<uint8_t> actual = expected;
+          scalar->xor_bytes(expected.data(), data, length);
+          funcs->xor_bytes(actual.data(), data, length);
+          EXPECT_EQ(actual, expected);
+        }
+
+        if (funcs->mask_bytes != nullptr) {
+          const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+          std::vector<uint8_t> expected(length);
+          std::vector<uint8_t> actual(length);
+          scalar->mask_bytes(expected.data(), data, length, mask);
+          funcs->mask_bytes(actual.data(), data, length, mask);
+          EXPECT_EQ(actual, expected);
+          // In place.
+          std::vector<uint8_t> in_place(data, data + length);
+          funcs->mask_bytes(in_place.data(), in_place.data(), length, mask);
+          EXPECT_EQ(in_place, expected);
+        }
+
+        if (funcs->sum_bytes != nullptr) {
+          EXPECT_EQ(funcs->sum_bytes(data, length),
+                    scalar->sum_bytes(data, length));
+        }
+
+        if (funcs->min_max_bytes != nullptr) {
+          uint8_t min, max, expected_min, expected_max;
+          funcs->min_max_bytes(data, length, &min, &max);
+          scalar->min_max_bytes(data, length, &expected_min, &expected_max);
+          EXPECT_EQ(min, expected_min);
+          EXPECT_EQ(max, expected_max);
+        }
+
+        if (funcs->validate_ascii != nullptr) {
+          std::vector<uint8_t> ascii(length);
+          for (size_t i = 0; i < length; i++) ascii[i] = data[i] & 0x7f;
+          EXPECT_TRUE(funcs->validate_ascii(ascii.data(), length));
+          if (length > 0) {
+            ascii[length / 2] |= 0x80;
+            EXPECT_FALSE(funcs->validate_ascii(ascii.data(), length));
+          }
+        }
+
+        if (funcs->hex_encode != nullptr) {
+          std::string expected(2 * length, '\0');
+          std::string actual(2 * length, '\0');
+          scalar->hex_encode(expected.data(), data, length);
+          funcs->hex_encode(actual.data(), data, length);
+          EXPECT_EQ(actual, expected);
+        }
+
+        auto check_swap = [&](auto kernel, auto reference, size_t size) {
+          if (kernel == nullptr) return;
+          size_t count = length / size;
+          std::vector<uint8_t> expected(storage);
+          std::vector<uint8_t> actual(storage);
+          reference(expected.data() + offset, count);
+          kernel(actual.data() + offset, count);
+          EXPECT_EQ(actual, expected) << "swap" << size * 8;
+        };
+        check_swap(funcs->swap_bytes16, scalar->swap_bytes16, 2);
+        check_swap(funcs->swap_bytes32, scalar->swap_bytes32, 4);
+        check_swap(funcs->swap_bytes64, scalar->swap_bytes64, 8);
+      }
+    }
+  }
+}
+
+TEST(SimdAbstractionTest, LargeCopyAndFill) {
+  // Long enough for the dcbz (AltiVec) and movntq (MMXEXT) paths.
+  for (const auto& [isa, funcs] : AvailableImplementations()) {
+    SCOPED_TRACE(get_simd_instruction_set_name(isa));
+    for (size_t length : {4096 + 37, 256 * 1024 + 13}) {
+      SCOPED_TRACE(length);
+      std::vector<uint8_t> src = Pattern(length + 5, 3);
+      if (funcs->copy_bytes != nullptr) {
+        std::vector<uint8_t> dst(length + 2);
+        funcs->copy_bytes(dst.data() + 1, src.data() + 5, length);
+        EXPECT_EQ(dst[0], 0);
+        EXPECT_EQ(dst[length + 1], 0);
+        EXPECT_EQ(memcmp(dst.data() + 1, src.data() + 5, length), 0);
+      }
+      if (funcs->fill_bytes != nullptr) {
+        for (uint8_t value : {uint8_t{0}, uint8_t{0xa5}}) {
+          std::vector<uint8_t> actual(src);
+          std::vector<uint8_t> expected(src);
+          memset(expected.data() + 3, value, length);
+          funcs->fill_bytes(actual.data() + 3, value, length);
+          EXPECT_EQ(actual, expected);
+        }
+      }
+    }
+  }
+}
+
+TEST(SimdAbstractionTest, ScalarSpanKernels) {
+  const simd_functions_t* scalar = get_simd_functions_for(SIMD_SCALAR);
+  const uint8_t data[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+
+  EXPECT_EQ(scalar->find_byte(data, sizeof(data), 0x05), data + 4);
+  EXPECT_EQ(scalar->find_byte(data, sizeof(data), 0x09), nullptr);
+  EXPECT_EQ(scalar->find_last_byte(data, sizeof(data), 0x05), data + 4);
+  EXPECT_EQ(scalar->find_last_byte(data, sizeof(data), 0x09), nullptr);
+  EXPECT_EQ(scalar->find_byte_pair(data, 5, 0x02, 0x05, 3), data + 1);
+  EXPECT_EQ(scalar->find_byte_pair(data, 5, 0x02, 0x06, 3), nullptr);
+  EXPECT_EQ(scalar->sum_bytes(data, sizeof(data)), 36u);
+
+  uint8_t min, max;
+  scalar->min_max_bytes(data, 0, &min, &max);
+  EXPECT_EQ(min, 0xff);
+  EXPECT_EQ(max, 0x00);
+
+  uint8_t swapped[8];
+  memcpy(swapped, data, sizeof(swapped));
+  scalar->swap_bytes64(swapped, 1);
+  EXPECT_EQ(swapped[0], 0x08);
+  EXPECT_EQ(swapped[7], 0x01);
+  memcpy(swapped, data, sizeof(swapped));
+  scalar->swap_bytes32(swapped, 2);
+  EXPECT_EQ(swapped[0], 0x04);
+  EXPECT_EQ(swapped[4], 0x08);
+
+  const uint8_t bytes[] = {0x00, 0x09, 0x0a, 0x7f, 0x80, 0xf0, 0xff};
+  char hex[2 * sizeof(bytes)];
+  scalar->hex_encode(hex, bytes, sizeof(bytes));
+  EXPECT_EQ(std::string(hex, sizeof(hex)), "00090a7f80f0ff");
+}
+
+TEST(SimdAbstractionTest, BatchScope) {
+  const simd_functions_t* funcs = get_simd_functions();
+  float a[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  float r[4];
+  uint8_t bytes[32] = {};
+  bytes[17] = 0x80;
+  int ascii;
+  {
+    node::SimdBatchScope outer;
+    {
+      node::SimdBatchScope inner;
+      funcs->add_ps(a, a, r);
+      ascii = funcs->validate_ascii(bytes, sizeof(bytes));
+    }
+    funcs->mul_ps(r, a, r);
+  }
+  // x87 (or SSE) math must be usable again once the batch is over.
+  volatile double check = 0.5;
+  check = check * 3.0;
+  EXPECT_EQ(check, 1.5);
+  EXPECT_FALSE(ascii);
+  EXPECT_FLOAT_EQ(r[0], 2.0f);
+  EXPECT_FLOAT_EQ(r[3], 32.0f);
+}
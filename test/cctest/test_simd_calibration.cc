@@ -0,0 +1,74 @@
+#include "node_simd_calibration.h"
+#include "simd_abstraction.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using node::simd_calibration::Load;
+
+namespace {
+
+std::string CpuLine() {
+  return "cpu " + std::to_string(get_simd_cpu_features()) + "\n";
+}
+
+}  // namespace
+
+TEST(SimdCalibrationTest, SetKernel) {
+  const simd_kernel_selection_t* selection = get_simd_kernel_selection();
+  const simd_kernel_thresholds_t* thresholds = get_simd_kernel_thresholds();
+  const simd_instruction_set_t isa = selection->sum_bytes;
+  const size_t threshold = thresholds->sum_bytes;
+
+  EXPECT_EQ(simd_set_kernel("no_such_kernel", SIMD_SCALAR, 0), -1);
+  EXPECT_EQ(simd_set_kernel("sum_bytes", SIMD_NONE, 0), -1);
+  ASSERT_EQ(simd_set_kernel("sum_bytes", SIMD_SCALAR, 128), 0);
+  EXPECT_EQ(selection->sum_bytes, SIMD_SCALAR);
+  EXPECT_EQ(thresholds->sum_bytes, 128u);
+  EXPECT_EQ(get_simd_functions()->sum_bytes,
+            get_simd_functions_for(SIMD_SCALAR)->sum_bytes);
+
+  ASSERT_EQ(simd_set_kernel("sum_bytes", isa, threshold), 0);
+  EXPECT_EQ(get_simd_functions()->sum_bytes,
+            get_simd_functions_for(isa)->sum_bytes);
+}
+
+TEST(SimdCalibrationTest, ParseInstructionSetName) {
+  for (simd_instruction_set_t isa :
+       {SIMD_SCALAR, SIMD_SSE2, SIMD_MMXEXT, SIMD_ALTIVEC}) {
+    EXPECT_EQ(parse_simd_instruction_set_name(
+                  get_simd_instruction_set_name(isa)),
+              isa);
+  }
+  EXPECT_EQ(parse_simd_instruction_set_name("avx512"), SIMD_NONE);
+}
+
+TEST(SimdCalibrationTest, Load) {
+  const simd_kernel_selection_t* selection = get_simd_kernel_selection();
+  const simd_instruction_set_t isa = selection->sum_bytes;
+  const size_t threshold = get_simd_kernel_thresholds()->sum_bytes;
+  std::string error;
+
+  EXPECT_FALSE(Load("", &error));
+  EXPECT_FALSE(Load("# comment only\n", &error));
+  EXPECT_FALSE(Load(CpuLine() + "bogus\n", &error));
+  EXPECT_EQ(error, "line 2: unknown entry 'bogus'");
+  EXPECT_FALSE(Load(CpuLine() + "kernel sum_bytes\n", &error));
+  EXPECT_FALSE(Load(CpuLine() + "kernel sum_bytes avx512 0\n", &error));
+  EXPECT_FALSE(Load(CpuLine() + "kernel no_such_kernel scalar 0\n", &error));
+  const std::string other_cpu =
+      "cpu " + std::to_string(get_simd_cpu_features() ^ 1) + "\n";
+  EXPECT_FALSE(Load(other_cpu + "kernel sum_bytes scalar 0\n", &error));
+
+  // Nothing is applied unless every line is valid.
+  EXPECT_FALSE(Load(CpuLine() + "kernel sum_bytes scalar 64\nbogus\n", &error));
+  EXPECT_EQ(selection->sum_bytes, isa);
+
+  ASSERT_TRUE(Load(CpuLine() + "kernel sum_bytes scalar 64\n", &error))
+      << error;
+  EXPECT_EQ(selection->sum_bytes, SIMD_SCALAR);
+  EXPECT_EQ(get_simd_kernel_thresholds()->sum_bytes, 64u);
+
+  ASSERT_EQ(simd_set_kernel("sum_bytes", isa, threshold), 0);
+}
@@ -0,0 +1,66 @@
+#include "node_internals.h"
+#include "node_test_fixture.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::SlabArrayBufferAllocator;
+
+class SlabArrayBufferAllocatorTest : public NodeZeroIsolateTestFixture {};
+
+TEST_F(SlabArrayBufferAllocatorTest, ZeroFillsAndReusesBlocks) {
+  SlabArrayBufferAllocator slab_allocator;
+
+  // Dirty a block, free it, and check that it comes back zeroed.
+  char* data = static_cast<char*>(slab_allocator.AllocateUninitialized(100));
+  ASSERT_NE(data, nullptr);
+  memset(data, 0xff, 100);
+  slab_allocator.Free(data, 100);
+  char* zeroed = static_cast<char*>(slab_allocator.Allocate(100));
+  EXPECT_EQ(zeroed, data);
+  for (size_t i = 0; i < 100; i++) EXPECT_EQ(zeroed[i], 0) << i;
+  EXPECT_EQ(slab_allocator.total_mem_usage(), 100u);
+  slab_allocator.Free(zeroed, 100);
+
+  EXPECT_EQ(slab_allocator.total_mem_usage(), 0u);
+  EXPECT_EQ(slab_allocator.slab_count(), 1u);
+}
+
+TEST_F(SlabArrayBufferAllocatorTest, ReleasesEmptySlabs) {
+  SlabArrayBufferAllocator slab_allocator;
+  constexpr size_t kSize = 1024;
+  constexpr size_t kCount =
+      4 * SlabArrayBufferAllocator::kSlabSize / kSize + 1;
+
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < kCount; i++) {
+    void* block = slab_allocator.AllocateUninitialized(kSize);
+    ASSERT_NE(block, nullptr);
+    memset(block, static_cast<int>(i), kSize);
+    blocks.push_back(block);
+  }
+  EXPECT_EQ(slab_allocator.slab_count(), 5u);
+  for (size_t i = 0; i < kCount; i++) {
+    EXPECT_EQ(static_cast<unsigned char*>(blocks[i])[kSize - 1],
+              static_cast<unsigned char>(i));
+  }
+
+  for (void* block : blocks) slab_allocator.Free(block, kSize);
+  // Only the last slab is kept.
+  EXPECT_EQ(slab_allocator.slab_count(), 1u);
+  EXPECT_EQ(slab_allocator.total_mem_usage(), 0u);
+}
+
+TEST_F(SlabArrayBufferAllocatorTest, LargeAllocationsBypassSlabs) {
+  SlabArrayBufferAllocator slab_allocator;
+  constexpr size_t kLarge = SlabArrayBufferAllocator::kMaxBlockSize + 1;
+
+  void* large = slab_allocator.Allocate(kLarge);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(slab_allocator.slab_count(), 0u);
+  EXPECT_EQ(slab_allocator.total_mem_usage(), kLarge);
+  slab_allocator.Free(large, kLarge);
+  EXPECT_EQ(slab_allocator.total_mem_usage(), 0u);
+}
@@ -0,0 +1,103 @@
+#include <string>
+#include "gtest/gtest.h"
+#include "node_test_fixture.h"
+
+class StreamBaseTest : public EnvironmentTestFixture {
+ protected:
+  // Calls the function that `source` evaluates to with internalBinding(),
+  // spins the event loop and returns the function's result as a string.
+  std::string RunWithInternalBinding(const char* source) {
+    const v8::HandleScope handle_scope(isolate_);
+    const Argv argv;
+    Env env{handle_scope, argv};
+
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+    v8::Local<v8::Value> internal_binding;
+    node::LoadEnvironment(
+        *env,
+        [&](const node::StartExecutionCallbackInfo& info)
+            -> v8::MaybeLocal<v8::Value> {
+          v8::Local<v8::Value> id =
+              v8::String::NewFromUtf8Literal(isolate_, "internal/test/binding");
+          v8::Local<v8::Value> binding =
+              info.native_require->Call(context, v8::Null(isolate_), 1, &id)
+                  .ToLocalChecked();
+          internal_binding =
+              binding.As<v8::Object>()
+                  ->Get(context,
+                        v8::String::NewFromUtf8Literal(isolate_,
+                                                       "internalBinding"))
+                  .ToLocalChecked();
+          return v8::Null(isolate_);
+        });
+    CHECK(internal_binding->IsFunction());
+
+    v8::Local<v8::Value> fn =
+        v8::Script::Compile(
+            context,
+            v8::String::NewFromUtf8(isolate_, source).ToLocalChecked())
+            .ToLocalChecked()
+            ->Run(context)
+            .ToLocalChecked();
+    v8::Local<v8::Value> result =
+        fn.As<v8::Function>()
+            ->Call(context, v8::Null(isolate_), 1, &internal_binding)
+            .ToLocalChecked();
+    EXPECT_EQ(node::SpinEventLoop(*env).FromJust(), 0);
+
+    node::Utf8Value result_string(isolate_, result);
+    return result_string.ToString();
+  }
+};
+
+static const char* kWritevPrelude =
+    "const { JSStream } = internalBinding('js_stream');\n"
+    "const { WriteWrap } = internalBinding('stream_wrap');\n"
+    "const { createBufferList } = internalBinding('blob');\n"
+    "const { UV_EINVAL } = internalBinding('uv');\n"
+    "const stream = new JSStream();\n"
+    "const written = [];\n"
+    "stream.onwrite = (req, bufs) => {\n"
+    "  written.push(Buffer.concat(bufs).toString());\n"
+    "  setImmediate(() => stream.finishWrite(req, 0));\n"
+    "  return 0;\n"
+    "};\n"
+    "function writev(chunks) {\n"
+    "  const req = new WriteWrap();\n"
+    "  req.oncomplete = () => {};\n"
+    "  return stream.writev(req, chunks, false);\n"
+    "}\n";
+
+// Test that the chunks of a BufferList are written in place of the list
+TEST_F(StreamBaseTest, WritevWritesBufferListChunks) {
+  std::string source = std::string("(internalBinding) => {\n") +
+                       kWritevPrelude +
+                       "const list = createBufferList();\n"
+                       "list.append(Buffer.from('b'));\n"
+                       "list.append(Buffer.from('c'));\n"
+                       "writev([Buffer.from('a'), 'buffer',\n"
+                       "        list, 'buffer',\n"
+                       "        'd', 'latin1']);\n"
+                       "return written.join('|');\n"
+                       "}";
+  EXPECT_EQ(RunWithInternalBinding(source.c_str()), "abcd");
+}
+
+// Test that a BufferList that grows while later chunks are converted to
+// strings makes the write fail instead of overflowing the uv_buf_t array
+TEST_F(StreamBaseTest, WritevRejectsBufferListGrownByToString) {
+  std::string source =
+      std::string("(internalBinding) => {\n") + kWritevPrelude +
+      "const list = createBufferList();\n"
+      "list.append(Buffer.from('x'));\n"
+      "const grow = {\n"
+      "  toString() {\n"
+      "    list.append(Buffer.from('y'));\n"
+      "    return 'z';\n"
+      "  },\n"
+      "};\n"
+      "const err = writev([list, 'buffer', grow, 'latin1']);\n"
+      "return `${err === UV_EINVAL}:${written.length}`;\n"
+      "}";
+  EXPECT_EQ(RunWithInternalBinding(source.c_str()), "true:0");
+}
@@ -4,8 +4,12 @@
 #include "string_bytes.h"
 #include "util-inl.h"
 
+#include <cstring>
+
 using node::MaybeStackBuffer;
 using node::StringBytes;
+using v8::ArrayBuffer;
+using v8::BackingStore;
 using v8::HandleScope;
 using v8::Local;
 using v8::Maybe;
@@ -98,3 +102,40 @@ TEST_F(StringBytesTest, WriteLatin1WithInvalidChar) {
   buf[9] = '\0';
   ASSERT_STREQ("Hello, \x16\x4C", buf.out());
 }
+
+// Latin1 and pure ASCII data share the backing store, which the string keeps
+// alive; UTF-8 with non-ASCII bytes is copied.
+TEST_F(StringBytesTest, EncodeExternalSharesBackingStore) {
+  const HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env_{handle_scope, argv};
+
+  auto check = [&](const char* data, node::encoding enc, bool shared) {
+    const size_t length = strlen(data);
+    std::shared_ptr<BackingStore> store =
+        ArrayBuffer::NewBackingStore(isolate_, length);
+    memcpy(store->Data(), data, length);
+    const char* bytes = static_cast<const char*>(store->Data());
+
+    Local<String> str = StringBytes::EncodeExternal(
+                            isolate_, store, bytes, length, enc)
+                            .ToLocalChecked()
+                            .As<String>();
+    EXPECT_EQ(str->IsExternalOneByte(), shared);
+    if (shared) {
+      EXPECT_EQ(str->GetExternalOneByteStringResource()->data(), bytes);
+      EXPECT_GT(store.use_count(), 1);
+    }
+    node::Utf8Value expected(
+        isolate_,
+        StringBytes::Encode(isolate_, data, length, enc).ToLocalChecked());
+    node::Utf8Value actual(isolate_, str);
+    EXPECT_STREQ(*actual, *expected);
+  };
+
+  check(latin1_data, node::LATIN1, true);
+  check("Hello, world", node::ASCII, true);
+  check("Hello, world", node::UTF8, true);
+  check(utf8_data, node::UTF8, false);
+  check("48656c6c6f", node::HEX, false);
+}
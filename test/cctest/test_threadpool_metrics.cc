@@ -0,0 +1,51 @@
+#include "histogram-inl.h"
+#include "threadpool_metrics.h"
+
+#include "gtest/gtest.h"
+
+using node::threadpool_metrics::Category;
+using node::threadpool_metrics::GetHistogram;
+using node::threadpool_metrics::Phase;
+using node::threadpool_metrics::RecordRequest;
+using node::threadpool_metrics::RecordWork;
+
+TEST(ThreadpoolMetricsTest, EnabledFlag) {
+  EXPECT_FALSE(node::threadpool_metrics::IsEnabled());
+  node::threadpool_metrics::SetEnabled(true);
+  EXPECT_TRUE(node::threadpool_metrics::IsEnabled());
+  node::threadpool_metrics::SetEnabled(false);
+  EXPECT_FALSE(node::threadpool_metrics::IsEnabled());
+}
+
+TEST(ThreadpoolMetricsTest, RecordWork) {
+  for (Phase phase : {Phase::kWait, Phase::kRun, Phase::kTotal}) {
+    GetHistogram(Category::kCrypto, phase)->Reset();
+    GetHistogram(Category::kFs, phase)->Reset();
+    GetHistogram(Category::kOther, phase)->Reset();
+  }
+
+  RecordWork("crypto", 1000, 1500, 3500);
+  EXPECT_EQ(GetHistogram(Category::kCrypto, Phase::kWait)->Count(), 1u);
+  EXPECT_EQ(GetHistogram(Category::kCrypto, Phase::kWait)->Max(), 500);
+  EXPECT_EQ(GetHistogram(Category::kCrypto, Phase::kRun)->Max(), 2000);
+  EXPECT_EQ(GetHistogram(Category::kCrypto, Phase::kTotal)->Max(), 2500);
+
+  // The category comes from the ThreadPoolWork type.
+  RecordWork("fs_dir.walk", 0, 10, 20);
+  EXPECT_EQ(GetHistogram(Category::kFs, Phase::kRun)->Count(), 1u);
+  RecordWork("node_sqlite3.BackupJob", 0, 10, 20);
+  EXPECT_EQ(GetHistogram(Category::kOther, Phase::kRun)->Count(), 1u);
+}
+
+TEST(ThreadpoolMetricsTest, RecordRequest) {
+  for (Phase phase : {Phase::kWait, Phase::kRun, Phase::kTotal}) {
+    GetHistogram(Category::kDns, phase)->Reset();
+  }
+
+  // Only the total is known for requests that libuv runs itself.
+  RecordRequest(Category::kDns, 100, 400);
+  EXPECT_EQ(GetHistogram(Category::kDns, Phase::kTotal)->Count(), 1u);
+  EXPECT_EQ(GetHistogram(Category::kDns, Phase::kTotal)->Max(), 300);
+  EXPECT_EQ(GetHistogram(Category::kDns, Phase::kWait)->Count(), 0u);
+  EXPECT_EQ(GetHistogram(Category::kDns, Phase::kRun)->Count(), 0u);
+}
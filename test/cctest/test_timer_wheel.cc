@@ -0,0 +1,91 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::timers::TimerWheel;
+
+TEST(TimerWheelTest, ExpiresInOrder) {
+  TimerWheel wheel;
+  std::vector<int64_t> expired;
+
+  wheel.Add(1, 300);
+  wheel.Add(2, 10);
+  wheel.Add(3, 20000);
+  wheel.Add(4, 10);
+  wheel.Add(5, 300);
+  EXPECT_EQ(wheel.size(), 5u);
+  EXPECT_EQ(wheel.NextExpiry(), 10u);
+
+  wheel.Expire(9, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Expire(10, &expired);
+  EXPECT_EQ(expired, (std::vector<int64_t>{2, 4}));
+
+  // Timers that expire in the same call come out by expiry, then by the order
+  // in which they were added.
+  expired.clear();
+  wheel.Expire(100000, &expired);
+  EXPECT_EQ(expired, (std::vector<int64_t>{1, 5, 3}));
+  EXPECT_EQ(wheel.size(), 0u);
+  EXPECT_EQ(wheel.NextExpiry(), TimerWheel::kNoExpiry);
+}
+
+TEST(TimerWheelTest, RescheduleAndCancel) {
+  TimerWheel wheel(1000);
+  std::vector<int64_t> expired;
+
+  wheel.Add(1, 1100);
+  wheel.Add(2, 1100);
+  wheel.Add(1, 5000);
+  EXPECT_TRUE(wheel.Cancel(2));
+  EXPECT_FALSE(wheel.Cancel(2));
+  EXPECT_FALSE(wheel.Has(2));
+  wheel.Expire(4999, &expired);
+  EXPECT_TRUE(expired.empty());
+  EXPECT_TRUE(wheel.Has(1));
+  wheel.Expire(5000, &expired);
+  EXPECT_EQ(expired, (std::vector<int64_t>{1}));
+
+  // Timers in the past expire on the next call.
+  expired.clear();
+  wheel.Add(3, 10);
+  EXPECT_EQ(wheel.NextExpiry(), 5001u);
+  wheel.Expire(5001, &expired);
+  EXPECT_EQ(expired, (std::vector<int64_t>{3}));
+}
+
+TEST(TimerWheelTest, MatchesSortedOrder) {
+  TimerWheel wheel;
+  std::vector<int64_t> expired;
+  std::vector<std::pair<uint64_t, int64_t>> expected;
+  uint64_t seed = 42;
+  for (int64_t id = 0; id < 10000; id++) {
+    seed = seed * 6364136223846793005 + 1442695040888963407;
+    // Spread the timers over all levels, past the end of the wheel.
+    const uint64_t expiry = (seed >> 20) % (uint64_t{1} << (id % 34 + 1));
+    wheel.Add(id, expiry);
+    expected.emplace_back(expiry, id);
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.first < b.first;
+                   });
+
+  uint64_t now = 0;
+  size_t next = 0;
+  while (wheel.size() != 0) {
+    const uint64_t next_expiry = wheel.NextExpiry();
+    ASSERT_LE(next_expiry, expected[next].first);
+    now = std::max(now + 1, next_expiry);
+    wheel.Expire(now, &expired);
+    for (; next < expired.size(); next++) {
+      ASSERT_EQ(expired[next], expected[next].second);
+      ASSERT_LE(expected[next].first, now);
+    }
+    ASSERT_TRUE(next == expected.size() || expected[next].first > now);
+  }
+  EXPECT_EQ(expired.size(), expected.size());
+}
@@ -1,6 +1,7 @@
 #include "debug_utils-inl.h"
 #include "env-inl.h"
 #include "gtest/gtest.h"
+#include "nbytes.h"
 #include "node_options-inl.h"
 #include "node_test_fixture.h"
 #include "simdutf.h"
@@ -308,6 +309,163 @@ TEST_F(UtilTest, SPrintF) {
   EXPECT_EQ(SPrintF("%s", with_zero), with_zero);
 }
 
+TEST_F(UtilTest, SwapBytes) {
+  // Cover lengths on both sides of the SIMD threshold, vector tails and
+  // unaligned starts, and check against nbytes' scalar loops.
+  std::vector<char> data(512 + 8);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<char>(i * 7 + 1);
+
+  using SwapFn = bool (*)(char*, size_t);
+  auto check = [](char* start, size_t nbytes, SwapFn swap, SwapFn reference) {
+    const std::vector<char> original(start, start + nbytes);
+    std::vector<char> expected(original);
+    bool ok = reference(expected.data(), nbytes);
+    EXPECT_EQ(swap(start, nbytes), ok);
+    EXPECT_EQ(std::vector<char>(start, start + nbytes), expected);
+    std::copy(original.begin(), original.end(), start);
+  };
+
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t nbytes = 0; nbytes <= 512; nbytes++) {
+      char* start = data.data() + offset;
+      check(start, nbytes, node::SwapBytes16, nbytes::SwapBytes16);
+      check(start, nbytes, node::SwapBytes32, nbytes::SwapBytes32);
+      check(start, nbytes, node::SwapBytes64, nbytes::SwapBytes64);
+    }
+  }
+}
+
+TEST_F(UtilTest, HexEncode) {
+  std::vector<char> data(256 + 8);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<char>(i * 13 + 5);
+
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t slen = 0; slen <= 256; slen++) {
+      const char* src = data.data() + offset;
+      std::string expected(2 * slen, '\0');
+      std::string actual(2 * slen, '\0');
+      EXPECT_EQ(nbytes::HexEncode(src, slen, expected.data(), expected.size()),
+                2 * slen);
+      EXPECT_EQ(node::HexEncode(src, slen, actual.data(), actual.size()),
+                2 * slen);
+      EXPECT_EQ(actual, expected);
+    }
+  }
+}
+
+TEST_F(UtilTest, CopyFillCompareBytes) {
+  std::vector<char> data(8192);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<char>(i * 31 + 3);
+
+  for (size_t nbytes : {0, 1, 63, 64, 511, 512, 1000, 4096}) {
+    SCOPED_TRACE(nbytes);
+    // Overlapping ranges, in either direction, keep memmove semantics.
+    for (size_t to : {3, 8, 13, 4100}) {
+      SCOPED_TRACE(to);
+      std::vector<char> expected(data);
+      std::vector<char> actual(data);
+      memmove(expected.data() + to, expected.data() + 8, nbytes);
+      node::CopyBytes(actual.data() + to, actual.data() + 8, nbytes);
+      EXPECT_EQ(actual, expected);
+    }
+
+    std::vector<char> expected(data);
+    std::vector<char> actual(data);
+    memset(expected.data() + 3, 0x5a, nbytes);
+    node::FillBytes(actual.data() + 3, 0x5a, nbytes);
+    EXPECT_EQ(actual, expected);
+
+    std::vector<char> other(data);
+    EXPECT_EQ(node::CompareBytes(data.data(), other.data(), nbytes), 0);
+    if (nbytes > 0) {
+      other[nbytes - 1] ^= 0x40;
+      EXPECT_EQ(node::CompareBytes(data.data(), other.data(), nbytes) < 0,
+                memcmp(data.data(), other.data(), nbytes) < 0);
+      EXPECT_NE(node::CompareBytes(data.data(), other.data(), nbytes), 0);
+    }
+  }
+}
+
+namespace {
+
+struct PooledObject {
+  NODE_POOLED_ALLOCATION(PooledObject)
+  char data[40];
+};
+
+struct LargerPooledObject : PooledObject {
+  char more_data[40];
+};
+
+}  // namespace
+
+TEST_F(UtilTest, ThreadLocalFreeList) {
+  auto* object = new PooledObject();
+  delete object;
+  auto* reused = new PooledObject();
+  if (node::ThreadLocalFreeList<sizeof(PooledObject)>::kMaxFree > 0) {
+    EXPECT_EQ(reused, object);
+  }
+
+  // Objects of other sizes are not mixed up with the pooled ones.
+  auto* larger = new LargerPooledObject();
+  EXPECT_NE(static_cast<PooledObject*>(larger), reused);
+  memset(larger->more_data, 0, sizeof(larger->more_data));
+  delete larger;
+  delete reused;
+}
+
+TEST_F(UtilTest, SearchString) {
+  // A small alphabet makes partial matches of the first and last byte
+  // common, which is what the SIMD pair filter has to get right.
+  std::vector<uint8_t> haystack(300);
+  uint32_t seed = 1;
+  for (uint8_t& c : haystack) {
+    seed = seed * 1103515245 + 12345;
+    c = "abc"[(seed >> 16) % 3];
+  }
+
+  for (size_t needle_length : {1, 2, 3, 5, 16, 32, 33}) {
+    for (size_t needle_start : {0, 17, 150, 299}) {
+      if (needle_start + needle_length > haystack.size()) continue;
+      const uint8_t* needle = haystack.data() + needle_start;
+      for (size_t start_index : {0, 1, 100, 267, 299}) {
+        for (bool is_forward : {true, false}) {
+          if (is_forward && start_index + needle_length > haystack.size())
+            continue;
+          SCOPED_TRACE(needle_length);
+          SCOPED_TRACE(needle_start);
+          SCOPED_TRACE(start_index);
+          SCOPED_TRACE(is_forward);
+          EXPECT_EQ(node::SearchString(haystack.data(),
+                                       haystack.size(),
+                                       needle,
+                                       needle_length,
+                                       start_index,
+                                       is_forward),
+                    nbytes::SearchString(haystack.data(),
+                                         haystack.size(),
+                                         needle,
+                                         needle_length,
+                                         start_index,
+                                         is_forward));
+        }
+      }
+    }
+  }
+
+  const uint8_t missing[] = {'a', 'b', 'd'};
+  EXPECT_EQ(node::SearchString(
+                haystack.data(), haystack.size(), missing, 3, 0, true),
+            haystack.size());
+  EXPECT_EQ(node::SearchString(
+                haystack.data(), haystack.size(), missing, 3, 299, false),
+            haystack.size());
+}
+
 TEST_F(UtilTest, DumpJavaScriptStackWithNoIsolate) {
   node::DumpJavaScriptBacktrace(stderr);
 }
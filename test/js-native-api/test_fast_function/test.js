@@ -0,0 +1,30 @@
+'use strict';
+// Flags: --allow-natives-syntax
+
+const common = require('../../common');
+const assert = require('assert');
+
+// Testing api calls for fast functions
+const test_fast_function =
+  require(`./build/${common.buildType}/test_fast_function`);
+
+const { add } = test_fast_function;
+assert.strictEqual(add.name, 'add');
+assert.strictEqual(add.length, 2);
+assert.throws(() => new add(1, 2), TypeError);
+
+function callAdd(a, b) {
+  return add(a, b);
+}
+
+%PrepareFunctionForOptimization(callAdd);
+assert.strictEqual(callAdd(1, 2), 3);
+%OptimizeFunctionOnNextCall(callAdd);
+assert.strictEqual(callAdd(1.5, 2), 3.5);
+
+// Whichever of the two paths ran, each call ran exactly one of them.
+const { fast, slow } = test_fast_function.getCallCounts();
+assert.strictEqual(fast + slow, 2);
+assert(slow >= 1);
+
+assert.strictEqual(test_fast_function.testInvalidSignature(), true);
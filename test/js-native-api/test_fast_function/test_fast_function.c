@@ -0,0 +1,75 @@
+#include <js_native_api.h>
+#include "../common.h"
+#include "../entry_point.h"
+
+static uint32_t fast_calls = 0;
+static uint32_t slow_calls = 0;
+
+static double FastAdd(void* receiver, double a, double b) {
+  fast_calls++;
+  return a + b;
+}
+
+static napi_value SlowAdd(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 2, "Wrong number of arguments");
+
+  double a, b;
+  NODE_API_CALL(env, napi_get_value_double(env, args[0], &a));
+  NODE_API_CALL(env, napi_get_value_double(env, args[1], &b));
+  slow_calls++;
+
+  napi_value result;
+  NODE_API_CALL(env, napi_create_double(env, a + b, &result));
+  return result;
+}
+
+static napi_value GetCallCounts(napi_env env, napi_callback_info info) {
+  napi_value result, fast, slow;
+  NODE_API_CALL(env, napi_create_object(env, &result));
+  NODE_API_CALL(env, napi_create_uint32(env, fast_calls, &fast));
+  NODE_API_CALL(env, napi_create_uint32(env, slow_calls, &slow));
+  NODE_API_CALL(env, napi_set_named_property(env, result, "fast", fast));
+  NODE_API_CALL(env, napi_set_named_property(env, result, "slow", slow));
+  return result;
+}
+
+static napi_value TestInvalidSignature(napi_env env, napi_callback_info info) {
+  static const node_api_fast_type arg_types[] = {node_api_fast_void};
+  node_api_fast_signature signature = {node_api_fast_void, 1, arg_types};
+  napi_value fn;
+  napi_status status = node_api_create_fast_function(
+      env, "invalid", NAPI_AUTO_LENGTH, SlowAdd, NULL, &signature,
+      (const void*)FastAdd, &fn);
+
+  napi_value result;
+  NODE_API_CALL(env,
+      napi_get_boolean(env, status == napi_invalid_arg, &result));
+  return result;
+}
+
+EXTERN_C_START
+napi_value Init(napi_env env, napi_value exports) {
+  static const node_api_fast_type arg_types[] = {
+      node_api_fast_float64, node_api_fast_float64};
+  node_api_fast_signature signature = {node_api_fast_float64, 2, arg_types};
+
+  napi_value add;
+  NODE_API_CALL(env,
+      node_api_create_fast_function(
+          env, "add", NAPI_AUTO_LENGTH, SlowAdd, NULL, &signature,
+          (const void*)FastAdd, &add));
+  NODE_API_CALL(env, napi_set_named_property(env, exports, "add", add));
+
+  napi_property_descriptor descriptors[] = {
+    DECLARE_NODE_API_PROPERTY("getCallCounts", GetCallCounts),
+    DECLARE_NODE_API_PROPERTY("testInvalidSignature", TestInvalidSignature),
+  };
+  NODE_API_CALL(env, napi_define_properties(
+      env, exports, sizeof(descriptors) / sizeof(*descriptors), descriptors));
+
+  return exports;
+}
+EXTERN_C_END
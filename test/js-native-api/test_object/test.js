@@ -408,3 +408,30 @@ assert.deepStrictEqual(test_object.TestGetProperty(), {
   assert.strictEqual(objectWithCustomPrototype.value, 42);
   assert.strictEqual(typeof objectWithCustomPrototype.test, 'function');
 }
+
+{
+  // Test bulk property access.
+  const sym = Symbol('sym');
+  const obj = { a: 1, [sym]: 'symbol', get b() { return 2; } };
+  assert.deepStrictEqual(
+    test_object.TestGetProperties(obj, ['a', 'b', sym, 'missing']),
+    [1, 2, 'symbol', undefined]);
+  assert.deepStrictEqual(test_object.TestGetProperties(obj, []), []);
+
+  const target = test_object.TestSetProperties({}, ['x', sym], [1, 'y']);
+  assert.strictEqual(target.x, 1);
+  assert.strictEqual(target[sym], 'y');
+}
+
+{
+  // Test objects created from a template.
+  const rows = test_object.TestObjectTemplate(
+    ['id', 'name'], [[1, 'one'], [2, 'two'], [3, undefined]]);
+  assert.deepStrictEqual(rows, [
+    { id: 1, name: 'one' },
+    { id: 2, name: 'two' },
+    { id: 3, name: undefined },
+  ]);
+  assert.deepStrictEqual(Object.keys(rows[0]), ['id', 'name']);
+  assert.deepStrictEqual(test_object.TestObjectTemplate([], [[]]), [{}]);
+}
@@ -783,6 +783,91 @@ static napi_value TestCreateObjectWithCustomPrototype(napi_env env,
   return result;
 }
 
+#define MAX_BULK_PROPERTIES 8
+
+// Copies the elements of a JavaScript array into elements.
+static napi_status GetArrayElements(napi_env env, napi_value array,
+                                    napi_value* elements, uint32_t* length) {
+  NODE_API_CHECK_STATUS(napi_get_array_length(env, array, length));
+  NODE_API_ASSERT_STATUS(env, *length <= MAX_BULK_PROPERTIES,
+                         "Too many elements");
+  for (uint32_t i = 0; i < *length; i++) {
+    NODE_API_CHECK_STATUS(napi_get_element(env, array, i, &elements[i]));
+  }
+  return napi_ok;
+}
+
+static napi_value TestGetProperties(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 2, "Wrong number of arguments");
+
+  napi_value names[MAX_BULK_PROPERTIES], values[MAX_BULK_PROPERTIES];
+  uint32_t count;
+  NODE_API_CALL(env, GetArrayElements(env, args[1], names, &count));
+  NODE_API_CALL(env,
+                node_api_get_properties(env, args[0], count, names, values));
+
+  napi_value result;
+  NODE_API_CALL(env, napi_create_array_with_length(env, count, &result));
+  for (uint32_t i = 0; i < count; i++) {
+    NODE_API_CALL(env, napi_set_element(env, result, i, values[i]));
+  }
+  return result;
+}
+
+static napi_value TestSetProperties(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value args[3];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 3, "Wrong number of arguments");
+
+  napi_value names[MAX_BULK_PROPERTIES], values[MAX_BULK_PROPERTIES];
+  uint32_t name_count, value_count;
+  NODE_API_CALL(env, GetArrayElements(env, args[1], names, &name_count));
+  NODE_API_CALL(env, GetArrayElements(env, args[2], values, &value_count));
+  NODE_API_ASSERT(env, name_count == value_count, "Mismatched lengths");
+  NODE_API_CALL(env,
+      node_api_set_properties(env, args[0], name_count, names, values));
+
+  return args[0];
+}
+
+// Creates one object per element of rows, each an array of property values,
+// from a template with the given property names.
+static napi_value TestObjectTemplate(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 2, "Wrong number of arguments");
+
+  napi_value names[MAX_BULK_PROPERTIES];
+  uint32_t count, row_count;
+  NODE_API_CALL(env, GetArrayElements(env, args[0], names, &count));
+  NODE_API_CALL(env, napi_get_array_length(env, args[1], &row_count));
+
+  node_api_object_template object_template;
+  NODE_API_CALL(env, node_api_create_object_template(
+      env, count, names, &object_template));
+
+  napi_value result;
+  NODE_API_CALL(env, napi_create_array_with_length(env, row_count, &result));
+  for (uint32_t i = 0; i < row_count; i++) {
+    napi_value row, object, values[MAX_BULK_PROPERTIES];
+    uint32_t value_count;
+    NODE_API_CALL(env, napi_get_element(env, args[1], i, &row));
+    NODE_API_CALL(env, GetArrayElements(env, row, values, &value_count));
+    NODE_API_ASSERT(env, value_count == count, "Mismatched lengths");
+    NODE_API_CALL(env, node_api_new_object_from_template(
+        env, object_template, values, &object));
+    NODE_API_CALL(env, napi_set_element(env, result, i, object));
+  }
+
+  NODE_API_CALL(env, node_api_delete_object_template(env, object_template));
+  return result;
+}
+
 EXTERN_C_START
 napi_value Init(napi_env env, napi_value exports) {
   napi_property_descriptor descriptors[] = {
@@ -822,6 +907,9 @@ napi_value Init(napi_env env, napi_value exports) {
                                 TestCreateObjectWithPropertiesEmpty),
       DECLARE_NODE_API_PROPERTY("TestCreateObjectWithCustomPrototype",
                                 TestCreateObjectWithCustomPrototype),
+      DECLARE_NODE_API_PROPERTY("TestGetProperties", TestGetProperties),
+      DECLARE_NODE_API_PROPERTY("TestSetProperties", TestSetProperties),
+      DECLARE_NODE_API_PROPERTY("TestObjectTemplate", TestObjectTemplate),
   };
 
   init_test_null(env, exports);
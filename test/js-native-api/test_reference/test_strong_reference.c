@@ -0,0 +1,106 @@
+#define NAPI_EXPERIMENTAL
+#include <js_native_api.h>
+#include "../common.h"
+#include "../entry_point.h"
+
+#define REFERENCE_COUNT 1000
+
+static int test_value = 1;
+static int finalize_count = 0;
+static napi_ref test_reference = NULL;
+
+static void FinalizeExternal(node_api_basic_env env, void* data, void* hint) {
+  finalize_count++;
+}
+
+static napi_value GetFinalizeCount(napi_env env, napi_callback_info info) {
+  napi_value result;
+  NODE_API_CALL(env, napi_create_int32(env, finalize_count, &result));
+  return result;
+}
+
+// Creates an external with a finalizer, held only by a strong reference that
+// is then released down to a refcount of 0.
+static napi_value CreateStrongReference(napi_env env,
+                                        napi_callback_info info) {
+  NODE_API_ASSERT(env, test_reference == NULL,
+      "The test allows only one reference at a time.");
+
+  napi_value external;
+  NODE_API_CALL(env, napi_create_external(
+      env, &test_value, FinalizeExternal, NULL, &external));
+  NODE_API_CALL(env,
+      node_api_create_strong_reference(env, external, &test_reference));
+
+  uint32_t refcount;
+  NODE_API_CALL(env, napi_reference_unref(env, test_reference, &refcount));
+  NODE_API_ASSERT(env, refcount == 0, "The refcount should drop to 0.");
+
+  finalize_count = 0;
+  return NULL;
+}
+
+static napi_value DeleteReference(napi_env env, napi_callback_info info) {
+  NODE_API_ASSERT(env, test_reference != NULL,
+      "A reference must have been created.");
+
+  NODE_API_CALL(env, napi_delete_reference(env, test_reference));
+  test_reference = NULL;
+  return NULL;
+}
+
+static napi_value GetReferenceValue(napi_env env, napi_callback_info info) {
+  NODE_API_ASSERT(env, test_reference != NULL,
+      "A reference must have been created.");
+
+  napi_value result;
+  NODE_API_CALL(env, napi_get_reference_value(env, test_reference, &result));
+  return result;
+}
+
+// Creates and deletes enough references, interleaved, to span several slabs
+// of the env's reference allocator.
+static napi_value CreateAndDeleteMany(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value value;
+  napi_ref refs[REFERENCE_COUNT];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, &value, NULL, NULL));
+
+  for (int i = 0; i < REFERENCE_COUNT; i++) {
+    NODE_API_CALL(env, napi_create_reference(env, value, i % 2, &refs[i]));
+  }
+  for (int i = 0; i < REFERENCE_COUNT; i += 2) {
+    NODE_API_CALL(env, napi_delete_reference(env, refs[i]));
+  }
+  for (int i = 0; i < REFERENCE_COUNT; i += 2) {
+    NODE_API_CALL(env, node_api_create_strong_reference(env, value,
+        &refs[i]));
+  }
+  for (int i = 0; i < REFERENCE_COUNT; i++) {
+    napi_value result;
+    bool equal;
+    NODE_API_CALL(env, napi_get_reference_value(env, refs[i], &result));
+    NODE_API_CALL(env, napi_strict_equals(env, result, value, &equal));
+    NODE_API_ASSERT(env, equal, "The reference should hold the value.");
+    NODE_API_CALL(env, napi_delete_reference(env, refs[i]));
+  }
+  return NULL;
+}
+
+EXTERN_C_START
+napi_value Init(napi_env env, napi_value exports) {
+  napi_property_descriptor descriptors[] = {
+      DECLARE_NODE_API_GETTER("finalizeCount", GetFinalizeCount),
+      DECLARE_NODE_API_PROPERTY("createStrongReference",
+                                CreateStrongReference),
+      DECLARE_NODE_API_PROPERTY("deleteReference", DeleteReference),
+      DECLARE_NODE_API_GETTER("referenceValue", GetReferenceValue),
+      DECLARE_NODE_API_PROPERTY("createAndDeleteMany", CreateAndDeleteMany),
+  };
+
+  NODE_API_CALL(env, napi_define_properties(
+      env, exports, sizeof(descriptors) / sizeof(*descriptors), descriptors));
+
+  return exports;
+}
+EXTERN_C_END
@@ -0,0 +1,24 @@
+'use strict';
+// Flags: --expose-gc
+
+const { buildType } = require('../../common');
+const { gcUntil } = require('../../common/gc');
+const assert = require('assert');
+
+const test_reference =
+  require(`./build/${buildType}/test_strong_reference`);
+
+async function runTests() {
+  test_reference.createStrongReference();
+  // Value should NOT be GC'd, because a strong reference is never weak.
+  await gcUntil('Strong reference at a refcount of 0',
+                () => (test_reference.finalizeCount === 0));
+  assert.strictEqual(typeof test_reference.referenceValue, 'object');
+  test_reference.deleteReference();
+  await gcUntil('Strong reference at a refcount of 0 (cont.d)',
+                () => (test_reference.finalizeCount === 1));
+
+  test_reference.createAndDeleteMany({});
+  test_reference.createAndDeleteMany(Symbol('sym'));
+}
+runTests();
@@ -10,5 +10,14 @@
         "NAPI_VERSION=10",
       ],
     },
+    {
+      "target_name": "test_string_view",
+      "sources": [
+        "test_string_view.c",
+      ],
+      "defines": [
+        "NAPI_EXPERIMENTAL",
+      ],
+    },
   ],
 }
@@ -0,0 +1,72 @@
+#include <js_native_api.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common.h"
+#include "../entry_point.h"
+
+typedef struct {
+  char* latin1;
+  char16_t* utf16;
+  size_t length;
+} StringCopy;
+
+// Copies the borrowed contents, since no Node-API call may be made here.
+static void CopyView(const char* latin1,
+                     const char16_t* utf16,
+                     size_t length,
+                     void* hint) {
+  StringCopy* copy = (StringCopy*)hint;
+  copy->length = length;
+  if (latin1 != NULL) {
+    copy->latin1 = malloc(length + 1);
+    memcpy(copy->latin1, latin1, length);
+  } else {
+    copy->utf16 = malloc((length + 1) * sizeof(char16_t));
+    memcpy(copy->utf16, utf16, length * sizeof(char16_t));
+  }
+}
+
+// Returns [encoding, string] for the string argument.
+static napi_value TestStringView(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value arg;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, &arg, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 1, "Wrong number of arguments");
+
+  StringCopy copy = {NULL, NULL, 0};
+  NODE_API_CALL(env, node_api_get_value_string_view(env, arg, CopyView,
+      &copy));
+
+  napi_value encoding, string, result;
+  if (copy.latin1 != NULL) {
+    NODE_API_CALL(env, napi_create_string_utf8(env, "latin1",
+        NAPI_AUTO_LENGTH, &encoding));
+    NODE_API_CALL(env, napi_create_string_latin1(env, copy.latin1,
+        copy.length, &string));
+  } else {
+    NODE_API_CALL(env, napi_create_string_utf8(env, "utf16",
+        NAPI_AUTO_LENGTH, &encoding));
+    NODE_API_CALL(env, napi_create_string_utf16(env, copy.utf16,
+        copy.length, &string));
+  }
+  free(copy.latin1);
+  free(copy.utf16);
+
+  NODE_API_CALL(env, napi_create_array_with_length(env, 2, &result));
+  NODE_API_CALL(env, napi_set_element(env, result, 0, encoding));
+  NODE_API_CALL(env, napi_set_element(env, result, 1, string));
+  return result;
+}
+
+EXTERN_C_START
+napi_value Init(napi_env env, napi_value exports) {
+  napi_property_descriptor properties[] = {
+    DECLARE_NODE_API_PROPERTY("TestStringView", TestStringView),
+  };
+
+  NODE_API_CALL(env, napi_define_properties(
+      env, exports, sizeof(properties) / sizeof(*properties), properties));
+
+  return exports;
+}
+EXTERN_C_END
@@ -0,0 +1,23 @@
+'use strict';
+const common = require('../../common');
+const assert = require('assert');
+
+// Testing the borrowed view of a string's contents
+const test_string_view =
+  require(`./build/${common.buildType}/test_string_view`);
+const { TestStringView } = test_string_view;
+
+assert.deepStrictEqual(TestStringView(''), ['latin1', '']);
+assert.deepStrictEqual(TestStringView('hello world'),
+                       ['latin1', 'hello world']);
+assert.deepStrictEqual(TestStringView('¡¿ÿ'), ['latin1', '¡¿ÿ']);
+assert.deepStrictEqual(TestStringView('ℤℍ💩'), ['utf16', 'ℤℍ💩']);
+
+// Cons strings are flattened before they are viewed.
+const long = 'x'.repeat(100);
+const cons = long + 'y'.repeat(100);
+assert.deepStrictEqual(TestStringView(cons), ['latin1', cons]);
+
+assert.throws(() => TestStringView(1), {
+  message: 'A string was expected',
+});
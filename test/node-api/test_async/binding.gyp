@@ -3,6 +3,10 @@
     {
       "target_name": "test_async",
       "sources": [ "test_async.c" ]
+    },
+    {
+      "target_name": "test_async_batch",
+      "sources": [ "test_async_batch.c" ]
     }
   ]
 }
@@ -0,0 +1,24 @@
+'use strict';
+const common = require('../../common');
+const assert = require('assert');
+const test_async_batch =
+  require(`./build/${common.buildType}/test_async_batch`);
+
+const inputs = Array.from({ length: 64 }, (_, i) => i - 32);
+const kIoLane = 1;
+
+assert.strictEqual(test_async_batch.TestEmpty(), true);
+
+test_async_batch.Test(inputs, kIoLane, common.mustCall((ok, outputs) => {
+  assert.strictEqual(ok, true);
+  assert.deepStrictEqual(outputs, inputs.map((x) => x * 2));
+
+  // The callback runs once for the whole batch. Once it has returned, the
+  // next batch can be started, here on the CPU lane.
+  setImmediate(() => {
+    test_async_batch.Test([1, 2, 3], 0, common.mustCall((ok, outputs) => {
+      assert.strictEqual(ok, true);
+      assert.deepStrictEqual(outputs, [2, 4, 6]);
+    }));
+  });
+}));
@@ -0,0 +1,106 @@
+#define NAPI_EXPERIMENTAL
+#include <node_api.h>
+#include "../../js-native-api/common.h"
+
+#define MAX_ITEMS 64
+
+typedef struct {
+  int32_t input[MAX_ITEMS];
+  int32_t output[MAX_ITEMS];
+  size_t count;
+  napi_ref callback;
+  napi_async_work work;
+} BatchData;
+
+static BatchData the_batch;
+
+static void Execute(napi_env env, void* data, size_t index) {
+  BatchData* batch = (BatchData*)data;
+  batch->output[index] = batch->input[index] * 2;
+}
+
+static void Complete(napi_env env, napi_status status, void* data) {
+  BatchData* batch = (BatchData*)data;
+
+  napi_value argv[2], callback, global;
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_create_array_with_length(env, batch->count, &argv[1]));
+  for (size_t i = 0; i < batch->count; i++) {
+    napi_value value;
+    NODE_API_CALL_RETURN_VOID(env,
+        napi_create_int32(env, batch->output[i], &value));
+    NODE_API_CALL_RETURN_VOID(env,
+        napi_set_element(env, argv[1], (uint32_t)i, value));
+  }
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_get_boolean(env, status == napi_ok, &argv[0]));
+
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_get_reference_value(env, batch->callback, &callback));
+  NODE_API_CALL_RETURN_VOID(env, napi_get_global(env, &global));
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_call_function(env, global, callback, 2, argv, NULL));
+
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_delete_reference(env, batch->callback));
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_async_work(env, batch->work));
+}
+
+// Test(inputs, lane, callback) doubles each of the inputs on the threadpool
+// and calls callback(ok, outputs) once they are all done.
+static napi_value Test(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3], resource_name;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 3, "Wrong number of arguments");
+
+  uint32_t count, lane;
+  NODE_API_CALL(env, napi_get_array_length(env, argv[0], &count));
+  NODE_API_ASSERT(env, count <= MAX_ITEMS, "Too many inputs");
+  for (uint32_t i = 0; i < count; i++) {
+    napi_value value;
+    NODE_API_CALL(env, napi_get_element(env, argv[0], i, &value));
+    NODE_API_CALL(env, napi_get_value_int32(env, value,
+        &the_batch.input[i]));
+  }
+  the_batch.count = count;
+  NODE_API_CALL(env, napi_get_value_uint32(env, argv[1], &lane));
+  NODE_API_CALL(env,
+      napi_create_reference(env, argv[2], 1, &the_batch.callback));
+
+  NODE_API_CALL(env, napi_create_string_utf8(
+      env, "TestBatchResource", NAPI_AUTO_LENGTH, &resource_name));
+  NODE_API_CALL(env, node_api_create_async_work_batch(env, NULL,
+      resource_name, count, Execute, Complete, &the_batch, &the_batch.work));
+  NODE_API_CALL(env, node_api_set_async_work_lane(env, the_batch.work,
+      (node_api_async_work_lane)lane));
+  NODE_API_CALL(env, napi_queue_async_work(env, the_batch.work));
+
+  return NULL;
+}
+
+static napi_value TestEmpty(napi_env env, napi_callback_info info) {
+  napi_value resource_name, result;
+  napi_async_work work;
+  NODE_API_CALL(env, napi_create_string_utf8(
+      env, "TestBatchResource", NAPI_AUTO_LENGTH, &resource_name));
+  napi_status status = node_api_create_async_work_batch(
+      env, NULL, resource_name, 0, Execute, Complete, &the_batch, &work);
+  NODE_API_CALL(env,
+      napi_get_boolean(env, status == napi_invalid_arg, &result));
+  return result;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_property_descriptor properties[] = {
+    DECLARE_NODE_API_PROPERTY("Test", Test),
+    DECLARE_NODE_API_PROPERTY("TestEmpty", TestEmpty),
+  };
+
+  NODE_API_CALL(env, napi_define_properties(
+      env, exports, sizeof(properties) / sizeof(*properties), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -17,6 +17,10 @@
         'NAPI_EXPERIMENTAL'
       ],
       'sources': ['test_uncaught_exception.c']
+    },
+    {
+      'target_name': 'test_batching',
+      'sources': ['test_batching.c']
     }
   ]
 }
@@ -0,0 +1,118 @@
+#define NAPI_EXPERIMENTAL
+#include <stdlib.h>
+#include <uv.h>
+#include <node_api.h>
+#include "../../js-native-api/common.h"
+
+#define ITEM_COUNT 1000
+#define MAX_BATCH_SIZE 16
+
+static uv_thread_t uv_thread;
+
+typedef struct {
+  napi_threadsafe_function tsfn;
+  napi_ref js_finalize_cb;
+} BatchingContext;
+
+static void ProducerThread(void* data) {
+  napi_threadsafe_function tsfn = (napi_threadsafe_function)data;
+  for (intptr_t i = 0; i < ITEM_COUNT; i++) {
+    if (napi_call_threadsafe_function(tsfn, (void*)i, napi_tsfn_blocking) !=
+        napi_ok) {
+      napi_fatal_error("ProducerThread", NAPI_AUTO_LENGTH,
+          "napi_call_threadsafe_function failed", NAPI_AUTO_LENGTH);
+    }
+  }
+  if (napi_release_threadsafe_function(tsfn, napi_tsfn_release) != napi_ok) {
+    napi_fatal_error("ProducerThread", NAPI_AUTO_LENGTH,
+        "napi_release_threadsafe_function failed", NAPI_AUTO_LENGTH);
+  }
+}
+
+// Passes each batch to JavaScript as an array of the queued numbers.
+static void CallJsBatch(napi_env env,
+                        napi_value cb,
+                        void* context,
+                        void** data,
+                        size_t count) {
+  if (env == NULL || cb == NULL) return;
+
+  napi_value batch, undefined;
+  NODE_API_CALL_RETURN_VOID(env, napi_create_array_with_length(env, count,
+      &batch));
+  for (size_t i = 0; i < count; i++) {
+    napi_value item;
+    NODE_API_CALL_RETURN_VOID(env,
+        napi_create_int32(env, (int32_t)(intptr_t)data[i], &item));
+    NODE_API_CALL_RETURN_VOID(env,
+        napi_set_element(env, batch, (uint32_t)i, item));
+  }
+  NODE_API_CALL_RETURN_VOID(env, napi_get_undefined(env, &undefined));
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_call_function(env, undefined, cb, 1, &batch, NULL));
+}
+
+static void Finalize(napi_env env, void* data, void* hint) {
+  BatchingContext* context = (BatchingContext*)data;
+  napi_value js_finalize_cb, undefined;
+
+  if (uv_thread_join(&uv_thread) != 0) {
+    napi_fatal_error("Finalize", NAPI_AUTO_LENGTH,
+        "uv_thread_join failed", NAPI_AUTO_LENGTH);
+  }
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_get_reference_value(env, context->js_finalize_cb, &js_finalize_cb));
+  NODE_API_CALL_RETURN_VOID(env, napi_get_undefined(env, &undefined));
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_call_function(env, undefined, js_finalize_cb, 0, NULL, NULL));
+  NODE_API_CALL_RETURN_VOID(env,
+      napi_delete_reference(env, context->js_finalize_cb));
+  free(context);
+}
+
+// StartThread(onBatch, onFinalize)
+static napi_value StartThread(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2], async_name;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 2, "Wrong number of arguments");
+
+  BatchingContext* context = malloc(sizeof(*context));
+  NODE_API_ASSERT(env, context != NULL, "Failed to allocate the context");
+  NODE_API_CALL(env,
+      napi_create_reference(env, argv[1], 1, &context->js_finalize_cb));
+  NODE_API_CALL(env, napi_create_string_utf8(env,
+      "N-API Thread-safe Function Batching Test", NAPI_AUTO_LENGTH,
+      &async_name));
+  NODE_API_CALL(env, napi_create_threadsafe_function(env, argv[0], NULL,
+      async_name, MAX_BATCH_SIZE * 4, 1, context, Finalize, NULL, NULL,
+      &context->tsfn));
+  NODE_API_CALL(env, node_api_set_threadsafe_function_batching(env,
+      context->tsfn, MAX_BATCH_SIZE, CallJsBatch));
+
+  NODE_API_ASSERT(env,
+      uv_thread_create(&uv_thread, ProducerThread, context->tsfn) == 0,
+      "Thread creation");
+
+  return NULL;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value max_batch_size, item_count;
+  NODE_API_CALL(env,
+      napi_create_uint32(env, MAX_BATCH_SIZE, &max_batch_size));
+  NODE_API_CALL(env, napi_create_uint32(env, ITEM_COUNT, &item_count));
+
+  napi_property_descriptor properties[] = {
+    DECLARE_NODE_API_PROPERTY("StartThread", StartThread),
+    DECLARE_NODE_API_PROPERTY_VALUE("MAX_BATCH_SIZE", max_batch_size),
+    DECLARE_NODE_API_PROPERTY_VALUE("ITEM_COUNT", item_count),
+  };
+
+  NODE_API_CALL(env, napi_define_properties(env, exports,
+      sizeof(properties) / sizeof(properties[0]), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,18 @@
+'use strict';
+
+const common = require('../../common');
+const assert = require('assert');
+const binding = require(`./build/${common.buildType}/test_batching`);
+
+// Each call receives the queued items in order, at most MAX_BATCH_SIZE at a
+// time, until all of them have been delivered.
+const received = [];
+binding.StartThread(common.mustCallAtLeast((batch) => {
+  assert(Array.isArray(batch));
+  assert(batch.length > 0);
+  assert(batch.length <= binding.MAX_BATCH_SIZE);
+  received.push(...batch);
+}), common.mustCall(() => {
+  assert.deepStrictEqual(
+    received, Array.from({ length: binding.ITEM_COUNT }, (_, i) => i));
+}));
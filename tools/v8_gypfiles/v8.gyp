@@ -406,6 +406,13 @@
             '<(V8_ROOT)/src/builtins/ppc/builtins-ppc.cc',
           ],
         }],
+        ['v8_target_arch=="ppc64" and clang==0', {
+          # The CSA builtin generators only run in mksnapshot, so their
+          # speed does not matter, but at -O3 GCC needs more memory to
+          # compile them than a PowerPC Mac has.
+          'cflags!': ['-O3'],
+          'cflags': ['-O1'],
+        }],
         ['v8_target_arch=="s390x"', {
           'sources': [
             '<(V8_ROOT)/src/builtins/s390/builtins-s390.cc',
@@ -2282,6 +2289,17 @@
             }]
           ]
         }],
+        # Saturating-subtract window slides for --with-simd-support builds.
+        ['OS!="win" and v8_target_arch=="ia32" and node_enable_3dnow=="true" and _toolset=="target"', {
+          'defines': ['X86_NOT_WINDOWS', 'DEFLATE_SLIDE_HASH_3DNOW'],
+          'cflags': ['-mmmx'],
+          'sources': ['<(V8_ROOT)/third_party/zlib/slide_hash_simd.h'],
+        }],
+        ['v8_target_arch in "ppc ppc64" and node_enable_altivec=="true" and _toolset=="target"', {
+          'defines': ['DEFLATE_SLIDE_HASH_ALTIVEC'],
+          'cflags': ['-maltivec'],
+          'sources': ['<(V8_ROOT)/third_party/zlib/slide_hash_simd.h'],
+        }],
       ],
       'direct_dependent_settings': {
         'include_dirs': [